@@ -21,6 +21,8 @@ endif ()
 ###### General features ######
 set(KATANA_ENABLE_PAPI OFF CACHE BOOL "Use PAPI counters for profiling")
 set(KATANA_ENABLE_VTUNE OFF CACHE BOOL "Use VTune for profiling")
+set(KATANA_ENABLE_MPI OFF CACHE BOOL "Build the MPI communication backend")
+set(KATANA_ENABLE_CUDA OFF CACHE BOOL "Build the CUDA backend of the analytics")
 set(KATANA_STRICT_CONFIG OFF CACHE BOOL "Instead of falling back gracefully, fail")
 set(KATANA_GRAPH_LOCATION "" CACHE PATH "Location of inputs for tests if downloaded/stored separately.")
 set(KATANA_ENABLE_COVERAGE OFF CACHE BOOL "Add instrumentation (used for code coverage collection) to binaries.")
@@ -248,8 +250,29 @@ if (KATANA_ENABLE_PAPI)
   add_definitions(-DKATANA_ENABLE_PAPI)
 endif ()
 
+if (KATANA_ENABLE_MPI)
+  find_package(MPI REQUIRED COMPONENTS C)
+endif ()
+
+if (KATANA_ENABLE_CUDA)
+  if (NOT DEFINED CMAKE_CUDA_ARCHITECTURES)
+    set(CMAKE_CUDA_ARCHITECTURES 70)
+  endif ()
+  set(CMAKE_CUDA_STANDARD 17)
+  set(CMAKE_CUDA_STANDARD_REQUIRED ON)
+  enable_language(CUDA)
+  find_package(CUDAToolkit REQUIRED)
+endif ()
+
 find_package(NUMA)
 
+if (${CMAKE_SYSTEM_NAME} MATCHES "Linux")
+  find_package(URING)
+  if (NOT URING_FOUND)
+    message(STATUS "Library liburing not found, not building io_uring storage")
+  endif ()
+endif ()
+
 find_package(Threads REQUIRED)
 
 include(CheckMmap)
@@ -0,0 +1,234 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ADAPTIVECHUNK_H_
+#define KATANA_LIBGALOIS_KATANA_ADAPTIVECHUNK_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "katana/Chunk.h"
+#include "katana/FixedSizeRing.h"
+#include "katana/Mem.h"
+#include "katana/ThreadPool.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/WorkListHelpers.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+/// A chunked worklist like ChunkMaster whose chunks are filled with a number
+/// of items chosen at runtime rather than with ChunkSize items. Each thread
+/// times the chunks it pops, and sets the number of items of the chunks it
+/// pushes so that a chunk takes about kTargetChunkNanos to process: cheap
+/// items get large chunks, which amortize the shared queues, and expensive
+/// items get small ones, which balance load. A chunk taken from the queue
+/// of another socket is a sign that work is short, so it halves the chunks
+/// of the thread that takes it.
+template <
+    typename T, template <typename, bool> class QT, bool IsStack,
+    int MaxChunkSize, bool Concurrent>
+class AdaptiveChunkMaster {
+public:
+  template <typename _T>
+  using retype =
+      AdaptiveChunkMaster<_T, QT, IsStack, MaxChunkSize, Concurrent>;
+
+  template <int _chunk_size>
+  using with_chunk_size =
+      AdaptiveChunkMaster<T, QT, IsStack, _chunk_size, Concurrent>;
+
+  template <bool _Concurrent>
+  using rethread =
+      AdaptiveChunkMaster<T, QT, IsStack, MaxChunkSize, _Concurrent>;
+
+  typedef T value_type;
+
+  static constexpr unsigned kMinChunkSize = std::min(4, MaxChunkSize);
+  static constexpr unsigned kInitialChunkSize = std::min(64, MaxChunkSize);
+  static constexpr double kTargetChunkNanos = 20000;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  class Chunk : public FixedSizeRing<T, MaxChunkSize>,
+                public QT<Chunk, Concurrent>::ListNode {};
+
+  typedef QT<Chunk, Concurrent> LevelItem;
+
+  struct ThreadData {
+    Chunk* cur{nullptr};
+    Chunk* next{nullptr};
+    /// the number of items of the chunks this thread pushes
+    unsigned chunk_size{kInitialChunkSize};
+    /// items popped from cur since it was taken, and when it was taken
+    unsigned popped{0};
+    Clock::time_point taken;
+    /// moving average of the time to process an item
+    double item_nanos{0};
+  };
+
+  FixedSizeAllocator<Chunk> alloc_;
+  squeue<Concurrent, PerThreadStorage, ThreadData> data_;
+  squeue<true, PerSocketStorage, LevelItem> queues_;
+
+  Chunk* MakeChunk() {
+    Chunk* ptr = alloc_.allocate(1);
+    alloc_.construct(ptr);
+    return ptr;
+  }
+
+  void DeleteChunk(Chunk* ptr) {
+    alloc_.destroy(ptr);
+    alloc_.deallocate(ptr, 1);
+  }
+
+  void PushChunk(Chunk* c) { queues_.get().push(c); }
+
+  /// Pop a chunk, preferring the queue of this socket; stolen is set if the
+  /// chunk is from the queue of another socket
+  Chunk* PopChunk(bool* stolen) {
+    int id = queues_.myEffectiveID();
+    if (Chunk* c = queues_.get(id).pop()) {
+      return c;
+    }
+    for (int i = 1; i < queues_.size(); ++i) {
+      int victim = (id + i) % queues_.size();
+      if (Chunk* c = queues_.get(victim).pop()) {
+        // threads of a socket share its queue
+        *stolen = GetThreadPool().getSocket(victim) != ThreadPool::getSocket();
+        return c;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Adapt the chunk size of this thread to the chunk that it finished
+  void Adapt(ThreadData& me, bool stolen) {
+    Clock::time_point now = Clock::now();
+    if (me.popped > 0) {
+      double nanos = std::chrono::duration<double, std::nano>(now - me.taken)
+                         .count() /
+                     me.popped;
+      me.item_nanos =
+          me.item_nanos == 0 ? nanos : (3 * me.item_nanos + nanos) / 4;
+      double wanted = kTargetChunkNanos / std::max(me.item_nanos, 1.0);
+      unsigned target = static_cast<unsigned>(std::clamp(
+          wanted, double{kMinChunkSize}, double{MaxChunkSize}));
+      // move halfway so that one slow chunk does not swing the size
+      me.chunk_size = (me.chunk_size + target + 1) / 2;
+    }
+    if (stolen) {
+      me.chunk_size = std::max(me.chunk_size / 2, kMinChunkSize);
+    }
+    me.popped = 0;
+    me.taken = now;
+  }
+
+  /// Take the next chunk to pop from into me.cur
+  Chunk* NextChunk(ThreadData& me) {
+    if (me.cur) {
+      DeleteChunk(me.cur);
+    }
+    bool stolen = false;
+    me.cur = PopChunk(&stolen);
+    if (!me.cur) {
+      me.cur = me.next;
+      me.next = nullptr;
+    }
+    Adapt(me, stolen);
+    return me.cur;
+  }
+
+  template <typename... Args>
+  void EmplaceInternal(ThreadData& me, Args&&... args) {
+    if (me.next && me.next->size() < me.chunk_size &&
+        me.next->emplace_back(std::forward<Args>(args)...)) {
+      return;
+    }
+    if (me.next) {
+      PushChunk(me.next);
+    }
+    me.next = MakeChunk();
+    me.next->emplace_back(std::forward<Args>(args)...);
+  }
+
+public:
+  AdaptiveChunkMaster() = default;
+  AdaptiveChunkMaster(const AdaptiveChunkMaster&) = delete;
+  AdaptiveChunkMaster& operator=(const AdaptiveChunkMaster&) = delete;
+
+  /// The number of items of the chunks the calling thread pushes
+  unsigned chunk_size() { return data_.get().chunk_size; }
+
+  void push(const value_type& val) { EmplaceInternal(data_.get(), val); }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    ThreadData& me = data_.get();
+    while (b != e) {
+      EmplaceInternal(me, *b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    ThreadData& me = data_.get();
+    while (true) {
+      Chunk* c = IsStack ? me.next : me.cur;
+      if (c) {
+        std::optional<value_type> retval =
+            IsStack ? c->extract_back() : c->extract_front();
+        if (retval) {
+          ++me.popped;
+          return retval;
+        }
+      }
+      if (IsStack) {
+        // a stack pops its newest chunk, which is the one it fills
+        if (me.next) {
+          DeleteChunk(me.next);
+        }
+        bool stolen = false;
+        me.next = PopChunk(&stolen);
+        Adapt(me, stolen);
+        if (!me.next) {
+          return std::nullopt;
+        }
+      } else if (!NextChunk(me)) {
+        return std::nullopt;
+      }
+    }
+  }
+};
+
+}  // namespace internal
+
+/// Distributed chunked FIFO whose chunk size adapts at runtime to the cost of
+/// items and to steals, up to MaxChunkSize items; see
+/// internal::AdaptiveChunkMaster. Use it instead of PerSocketChunkFIFO when
+/// the best chunk size depends on the input, e.g., road versus social graphs.
+///
+/// @tparam MaxChunkSize the largest chunk size
+template <int MaxChunkSize = 512, typename T = int, bool Concurrent = true>
+using PerSocketAdaptiveChunkFIFO = internal::AdaptiveChunkMaster<
+    T, ConExtLinkedQueue, false, MaxChunkSize, Concurrent>;
+KATANA_WLCOMPILECHECK(PerSocketAdaptiveChunkFIFO)
+
+/// Distributed chunked LIFO whose chunk size adapts at runtime; see
+/// PerSocketAdaptiveChunkFIFO
+///
+/// @tparam MaxChunkSize the largest chunk size
+template <int MaxChunkSize = 512, typename T = int, bool Concurrent = true>
+using PerSocketAdaptiveChunkLIFO = internal::AdaptiveChunkMaster<
+    T, ConExtLinkedStack, true, MaxChunkSize, Concurrent>;
+KATANA_WLCOMPILECHECK(PerSocketAdaptiveChunkLIFO)
+
+}  // end namespace katana
+
+#endif
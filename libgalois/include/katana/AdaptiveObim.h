@@ -0,0 +1,289 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ADAPTIVEOBIM_H_
+#define KATANA_LIBGALOIS_KATANA_ADAPTIVEOBIM_H_
+
+#include <atomic>
+#include <climits>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+#include "katana/Chunk.h"
+#include "katana/CompilerSpecific.h"
+#include "katana/FlatMap.h"
+#include "katana/PaddedLock.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/WorkListHelpers.h"
+
+namespace katana {
+
+/**
+ * Approximate priority scheduling like \ref OrderedByIntegerMetric, but
+ * without a fixed bucket width. Items with priority p go to the bucket
+ * (p >> shift) << shift, and the shift is adapted at runtime from the work
+ * found in the buckets: if threads drain buckets after a few items, the
+ * buckets are merged by increasing the shift; if they pop many items from a
+ * bucket, the buckets are split by decreasing it (PMOD, Yesil et al.,
+ * "Understanding Priority-Based Scheduling of Graph Algorithms on a
+ * Shared-Memory Platform", SC 2019).
+ *
+ * Buckets are keyed by their lowest priority, so buckets created before and
+ * after a change of shift are still visited in priority order.
+ *
+ * Indexer is like the one of \ref OrderedByIntegerMetric but returns the
+ * unshifted priority of an item, which must be a non-negative integer.
+ *
+ * \code
+ * typedef katana::AdaptiveOrderedByIntegerMetric<Indexer> WL;
+ * katana::for_each(
+ *     katana::iterate(items), Fn, katana::wl<WL>(Indexer(), initial_shift));
+ * \endcode
+ *
+ * @tparam Indexer        Indexer class
+ * @tparam Container      Scheduler for each bucket
+ */
+template <
+    class Indexer = DummyIndexer<int>,
+    typename Container = PerSocketChunkFIFO<>, typename T = int,
+    typename Index = int, bool Concurrent = true>
+struct AdaptiveOrderedByIntegerMetric : private boost::noncopyable {
+  template <typename _T>
+  using retype = AdaptiveOrderedByIntegerMetric<
+      Indexer, typename Container::template retype<_T>, _T,
+      typename std::result_of<Indexer(_T)>::type, Concurrent>;
+
+  template <bool _b>
+  using rethread =
+      AdaptiveOrderedByIntegerMetric<Indexer, Container, T, Index, _b>;
+
+  template <typename _container>
+  struct with_container {
+    typedef AdaptiveOrderedByIntegerMetric<
+        Indexer, _container, T, Index, Concurrent>
+        type;
+  };
+
+  template <typename _indexer>
+  struct with_indexer {
+    typedef AdaptiveOrderedByIntegerMetric<
+        _indexer, Container, T, Index, Concurrent>
+        type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+  /// Bucket visits of a thread between reconsidering the shift
+  static constexpr unsigned kAdaptPeriod = 32;
+  /// Merge buckets if visits pop fewer items than this on average
+  static constexpr uint64_t kMinPopsPerVisit = 64;
+  /// Split buckets if visits pop more items than this on average
+  static constexpr uint64_t kMaxPopsPerVisit = 4096;
+  static constexpr unsigned kMaxShift = sizeof(Index) * CHAR_BIT - 2;
+
+private:
+  typedef typename Container::template rethread<Concurrent> CTy;
+  typedef katana::flat_map<Index, CTy*, std::less<Index>> LMapTy;
+
+  struct ThreadData {
+    LMapTy local;
+    Index cur_index{std::numeric_limits<Index>::min()};
+    Index scan_start{std::numeric_limits<Index>::min()};
+    CTy* current{nullptr};
+    unsigned last_master_version{0};
+    /// items popped from current since it became current
+    uint64_t pops_in_visit{0};
+    /// items popped in the visits since the last adaptation
+    uint64_t sampled_pops{0};
+    unsigned sampled_visits{0};
+  };
+
+  PerThreadStorage<ThreadData> data_;
+  PaddedLock<Concurrent> master_lock_;
+  std::deque<std::pair<Index, CTy*>> master_log_;
+  std::atomic<unsigned> master_version_{0};
+  std::atomic<unsigned> shift_;
+  Indexer indexer_;
+
+  Index BucketOf(const value_type& val) {
+    unsigned shift = shift_.load(std::memory_order_relaxed);
+    return (indexer_(val) >> shift) << shift;
+  }
+
+  /// Record the visit of the current bucket and merge or split buckets if
+  /// the recent visits found too little or too much work
+  void EndVisit(ThreadData& p) {
+    if (p.pops_in_visit == 0) {
+      return;
+    }
+    p.sampled_pops += p.pops_in_visit;
+    p.pops_in_visit = 0;
+    if (++p.sampled_visits < kAdaptPeriod) {
+      return;
+    }
+
+    uint64_t average = p.sampled_pops / p.sampled_visits;
+    p.sampled_pops = 0;
+    p.sampled_visits = 0;
+
+    // Concurrent adaptations of the same shift change it only once
+    unsigned shift = shift_.load(std::memory_order_relaxed);
+    if (average < kMinPopsPerVisit && shift < kMaxShift) {
+      shift_.compare_exchange_strong(shift, shift + 1);
+    } else if (average > kMaxPopsPerVisit && shift > 0) {
+      shift_.compare_exchange_strong(shift, shift - 1);
+    }
+  }
+
+  void SwitchTo(ThreadData& p, Index index, CTy* bucket) {
+    if (bucket != p.current) {
+      EndVisit(p);
+    }
+    p.current = bucket;
+    p.cur_index = index;
+  }
+
+  bool UpdateLocal(ThreadData& p) {
+    unsigned version = master_version_.load(std::memory_order_relaxed);
+    if (p.last_master_version == version) {
+      return false;
+    }
+    for (; p.last_master_version < version; ++p.last_master_version) {
+      std::pair<Index, CTy*> log_entry = master_log_[p.last_master_version];
+      p.local[log_entry.first] = log_entry.second;
+      KATANA_LOG_DEBUG_ASSERT(log_entry.second);
+    }
+    return true;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  std::optional<T> SlowPop(ThreadData& p) {
+    UpdateLocal(p);
+
+    // back-scan prevention: start from the earliest bucket threads pushed to
+    Index scan_start = p.scan_start;
+    if (ThreadPool::isLeader()) {
+      for (unsigned i = 0; i < activeThreads; ++i) {
+        scan_start = std::min(scan_start, data_.getRemote(i)->scan_start);
+      }
+    } else {
+      scan_start = std::min(
+          scan_start, data_.getRemote(ThreadPool::getLeader())->scan_start);
+    }
+
+    for (auto ii = p.local.lower_bound(scan_start), ei = p.local.end();
+         ii != ei; ++ii) {
+      if (std::optional<T> item = ii->second->pop()) {
+        SwitchTo(p, ii->first, ii->second);
+        p.scan_start = ii->first;
+        ++p.pops_in_visit;
+        return item;
+      }
+    }
+    return std::nullopt;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  CTy* SlowUpdateLocalOrCreate(ThreadData& p, Index i) {
+    // update local until we find it or we get the write lock
+    do {
+      UpdateLocal(p);
+      auto it = p.local.find(i);
+      if (it != p.local.end()) {
+        return it->second;
+      }
+    } while (!master_lock_.try_lock());
+    // we have the write lock, update again then create
+    UpdateLocal(p);
+    auto it = p.local.find(i);
+    CTy* bucket = (it != p.local.end()) ? it->second : nullptr;
+    if (!bucket) {
+      bucket = new CTy();
+      p.local[i] = bucket;
+      p.last_master_version =
+          master_version_.load(std::memory_order_relaxed) + 1;
+      master_log_.push_back(std::make_pair(i, bucket));
+      master_version_.fetch_add(1);
+    }
+    master_lock_.unlock();
+    return bucket;
+  }
+
+  CTy* UpdateLocalOrCreate(ThreadData& p, Index i) {
+    auto it = p.local.find(i);
+    if (it != p.local.end()) {
+      return it->second;
+    }
+    return SlowUpdateLocalOrCreate(p, i);
+  }
+
+public:
+  AdaptiveOrderedByIntegerMetric(
+      const Indexer& x = Indexer(), unsigned initial_shift = 0)
+      : shift_(std::min(initial_shift, kMaxShift)), indexer_(x) {}
+
+  ~AdaptiveOrderedByIntegerMetric() {
+    // Deallocate in LIFO order to give opportunity for simple garbage
+    // collection
+    for (auto ii = master_log_.rbegin(), ei = master_log_.rend(); ii != ei;
+         ++ii) {
+      delete ii->second;
+    }
+  }
+
+  /// The current shift; the buckets are 2^shift priorities wide
+  unsigned shift() const { return shift_.load(std::memory_order_relaxed); }
+
+  void push(const value_type& val) {
+    Index index = BucketOf(val);
+    ThreadData& p = *data_.getLocal();
+
+    // Fast path
+    if (index == p.cur_index && p.current) {
+      p.current->push(val);
+      return;
+    }
+
+    // Slow path
+    CTy* bucket = UpdateLocalOrCreate(p, index);
+    if (index < p.scan_start) {
+      p.scan_start = index;
+    }
+    // Opportunistically move to higher priority work
+    if (index < p.cur_index) {
+      SwitchTo(p, index, bucket);
+    }
+    bucket->push(val);
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e) {
+      push(*b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    ThreadData& p = *data_.getLocal();
+    if (p.current) {
+      if (std::optional<value_type> item = p.current->pop()) {
+        ++p.pops_in_visit;
+        return item;
+      }
+    }
+    return SlowPop(p);
+  }
+};
+KATANA_WLCOMPILECHECK(AdaptiveOrderedByIntegerMetric)
+
+}  // end namespace katana
+
+#endif
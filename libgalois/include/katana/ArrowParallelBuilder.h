@@ -0,0 +1,273 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ARROWPARALLELBUILDER_H_
+#define KATANA_LIBGALOIS_KATANA_ARROWPARALLELBUILDER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/util/bit_util.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyMemoryPool.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/ThreadPool.h"
+
+namespace katana {
+
+namespace internal {
+
+/// The buffers of a variable-length arrow::Array: value i is
+/// values[offsets[i], offsets[i + 1]) if bit i of validity is set
+struct VarLengthBuffers {
+  std::shared_ptr<arrow::Buffer> validity;
+  std::shared_ptr<arrow::Buffer> offsets;
+  std::shared_ptr<arrow::Buffer> values;
+  int64_t null_count{0};
+  int64_t num_values{0};
+};
+
+/// ChunkedVarLengthBuilder holds the values set by each thread in a chunk of
+/// that thread and, for each index, where in which chunk its value is
+template <typename Element, typename OffsetType>
+class ChunkedVarLengthBuilder {
+public:
+  ChunkedVarLengthBuilder(size_t length) {
+    slots_.allocateBlocked(length);
+    katana::do_all(
+        katana::iterate(size_t{0}, length), [&](size_t i) { slots_[i] = {}; },
+        katana::no_stats());
+  }
+
+  void SetValue(size_t index, const Element* data, size_t n) {
+    KATANA_LOG_DEBUG_VASSERT(
+        index < size(), "index: {}, size: {}", index, size());
+    KATANA_LOG_DEBUG_ASSERT(n <= std::numeric_limits<uint32_t>::max());
+    std::vector<Element>& chunk = *chunks_.getLocal();
+    slots_[index] = Slot{
+        chunk.size(), static_cast<uint32_t>(n), katana::ThreadPool::getTID()};
+    chunk.insert(chunk.end(), data, data + n);
+  }
+
+  void UnsetValue(size_t index) {
+    KATANA_LOG_DEBUG_ASSERT(index < size());
+    slots_[index] = {};
+  }
+
+  bool IsValid(size_t index) const { return slots_[index].thread != kNull; }
+
+  size_t size() const { return slots_.size(); }
+
+  katana::Result<VarLengthBuffers> Finalize() {
+    arrow::MemoryPool* pool = katana::PropertyMemoryPool();
+    const size_t length = size();
+
+    // Bounds the offsets even if some values were set more than once
+    uint64_t chunked_values = 0;
+    for (unsigned t = 0; t < chunks_.size(); ++t) {
+      chunked_values += chunks_.getRemote(t)->size();
+    }
+    if (chunked_values >
+        static_cast<uint64_t>(std::numeric_limits<OffsetType>::max())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "{} values do not fit in {} byte offsets; use a large type",
+          chunked_values, sizeof(OffsetType));
+    }
+
+    VarLengthBuffers out;
+    auto offsets_buffer = KATANA_CHECKED(
+        arrow::AllocateBuffer((length + 1) * sizeof(OffsetType), pool));
+    auto* offsets =
+        reinterpret_cast<OffsetType*>(offsets_buffer->mutable_data());
+    offsets[0] = 0;
+    katana::do_all(
+        katana::iterate(size_t{0}, length),
+        [&](size_t i) { offsets[i + 1] = slots_[i].length; },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        offsets + 1, offsets + length + 1, offsets + 1);
+    out.num_values = offsets[length];
+
+    auto values_buffer = KATANA_CHECKED(
+        arrow::AllocateBuffer(out.num_values * sizeof(Element), pool));
+    auto* values = reinterpret_cast<Element*>(values_buffer->mutable_data());
+    katana::do_all(
+        katana::iterate(size_t{0}, length),
+        [&](size_t i) {
+          const Slot& slot = slots_[i];
+          if (slot.length > 0) {
+            std::memcpy(
+                values + offsets[i],
+                chunks_.getRemote(slot.thread)->data() + slot.begin,
+                slot.length * sizeof(Element));
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    // Each iteration writes a whole byte of the bitmap, so no two threads
+    // write to the same byte
+    const int64_t num_bytes = arrow::BitUtil::BytesForBits(length);
+    auto validity_buffer =
+        KATANA_CHECKED(arrow::AllocateBuffer(num_bytes, pool));
+    uint8_t* validity = validity_buffer->mutable_data();
+    katana::GAccumulator<int64_t> num_valid;
+    katana::do_all(
+        katana::iterate(int64_t{0}, num_bytes),
+        [&](int64_t b) {
+          uint8_t byte = 0;
+          size_t end = std::min<size_t>(length, (b + 1) * 8);
+          for (size_t i = b * 8; i < end; ++i) {
+            if (IsValid(i)) {
+              byte |= uint8_t{1} << (i % 8);
+            }
+          }
+          validity[b] = byte;
+          num_valid += arrow::BitUtil::PopCount(byte);
+        },
+        katana::no_stats());
+    out.null_count = length - num_valid.reduce();
+    if (out.null_count > 0) {
+      out.validity = std::move(validity_buffer);
+    }
+
+    out.offsets = std::move(offsets_buffer);
+    out.values = std::move(values_buffer);
+    return out;
+  }
+
+private:
+  static constexpr uint32_t kNull = std::numeric_limits<uint32_t>::max();
+
+  struct Slot {
+    uint64_t begin{0};
+    uint32_t length{0};
+    uint32_t thread{kNull};
+  };
+
+  katana::NUMAArray<Slot> slots_;
+  katana::PerThreadStorage<std::vector<Element>> chunks_;
+};
+
+}  // namespace internal
+
+/// ArrowParallelStringBuilder builds an arrow::Array of strings or binaries
+/// (ArrowType is arrow::StringType, arrow::LargeStringType, arrow::BinaryType
+/// or arrow::LargeBinaryType) from <index, value> pairs arriving in unknown
+/// order from the threads of a parallel loop, where ArrowRandomAccessBuilder
+/// would append the strings one by one to an arrow builder.
+///
+/// SetValue copies the value to a chunk of the calling thread, so it takes no
+/// locks. Finalize prefix-sums the lengths of the values into the offsets of
+/// the array and copies the chunks into its data in parallel. Indices which
+/// are not set are null. An index must not be set by two threads, and
+/// Finalize must not run concurrently with SetValue.
+template <typename ArrowType>
+class ArrowParallelStringBuilder {
+public:
+  using offset_type = typename ArrowType::offset_type;
+
+  ArrowParallelStringBuilder(size_t length) : builder_(length) {}
+
+  void SetValue(size_t index, std::string_view value) {
+    builder_.SetValue(index, value.data(), value.size());
+  }
+
+  void UnsetValue(size_t index) { builder_.UnsetValue(index); }
+
+  bool IsValid(size_t index) const { return builder_.IsValid(index); }
+
+  size_t size() const { return builder_.size(); }
+
+  katana::Result<std::shared_ptr<arrow::Array>> Finalize() {
+    using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+    auto buffers = KATANA_CHECKED(builder_.Finalize());
+    std::shared_ptr<arrow::Array> array = std::make_shared<ArrayType>(
+        size(), buffers.offsets, buffers.values, buffers.validity,
+        buffers.null_count);
+    return array;
+  }
+
+  katana::Result<void> Finalize(std::shared_ptr<arrow::Array>* array) {
+    *array = KATANA_CHECKED(Finalize());
+    return katana::ResultSuccess();
+  }
+
+private:
+  internal::ChunkedVarLengthBuilder<char, offset_type> builder_;
+};
+
+/// ArrowParallelListBuilder builds an arrow::Array of lists
+/// (ListArrowType is arrow::ListType or arrow::LargeListType) of numbers
+/// (ValueArrowType is a numeric arrow type, e.g., arrow::UInt32Type) such as
+/// paths or walks, from <index, value> pairs arriving in unknown order from
+/// the threads of a parallel loop, like ArrowParallelStringBuilder does for
+/// strings.
+template <typename ValueArrowType, typename ListArrowType = arrow::ListType>
+class ArrowParallelListBuilder {
+public:
+  static_assert(
+      arrow::is_number_type<ValueArrowType>::value,
+      "lists of numbers only");
+
+  using value_type = typename arrow::TypeTraits<ValueArrowType>::CType;
+  using offset_type = typename ListArrowType::offset_type;
+
+  ArrowParallelListBuilder(size_t length) : builder_(length) {}
+
+  void SetValue(size_t index, const value_type* values, size_t n) {
+    builder_.SetValue(index, values, n);
+  }
+
+  /// Set the list at index to the elements of a contiguous container of
+  /// value_type, e.g., a std::vector
+  template <typename Container>
+  void SetValue(size_t index, const Container& values) {
+    builder_.SetValue(index, std::data(values), std::size(values));
+  }
+
+  void UnsetValue(size_t index) { builder_.UnsetValue(index); }
+
+  bool IsValid(size_t index) const { return builder_.IsValid(index); }
+
+  size_t size() const { return builder_.size(); }
+
+  katana::Result<std::shared_ptr<arrow::Array>> Finalize() {
+    using ValueArrayType =
+        typename arrow::TypeTraits<ValueArrowType>::ArrayType;
+    using ListArrayType = typename arrow::TypeTraits<ListArrowType>::ArrayType;
+    auto buffers = KATANA_CHECKED(builder_.Finalize());
+    auto values =
+        std::make_shared<ValueArrayType>(buffers.num_values, buffers.values);
+    auto type = std::make_shared<ListArrowType>(
+        arrow::TypeTraits<ValueArrowType>::type_singleton());
+    std::shared_ptr<arrow::Array> array = std::make_shared<ListArrayType>(
+        type, size(), buffers.offsets, values, buffers.validity,
+        buffers.null_count);
+    return array;
+  }
+
+  katana::Result<void> Finalize(std::shared_ptr<arrow::Array>* array) {
+    *array = KATANA_CHECKED(Finalize());
+    return katana::ResultSuccess();
+  }
+
+private:
+  internal::ChunkedVarLengthBuilder<value_type, offset_type> builder_;
+};
+
+}  // namespace katana
+
+#endif
@@ -4,6 +4,7 @@
 #include "katana/Logging.h"
 #include "katana/NUMAArray.h"
 #include "katana/Properties.h"
+#include "katana/PropertyMemoryPool.h"
 #include "katana/Result.h"
 
 namespace katana {
@@ -35,7 +36,7 @@ public:
 
   katana::Result<std::shared_ptr<arrow::Array>> Finalize() const {
     using ArrowBuilder = typename arrow::TypeTraits<ArrowType>::BuilderType;
-    ArrowBuilder builder;
+    ArrowBuilder builder(katana::PropertyMemoryPool());
     if (data_.size() > 0) {
       if (auto r = builder.AppendValues(data_); !r.ok()) {
         KATANA_LOG_DEBUG("arrow error: {}", r);
@@ -88,7 +89,7 @@ public:
 
   katana::Result<void> Finalize(std::shared_ptr<arrow::Array>* array) const {
     using ArrowBuilder = typename arrow::TypeTraits<ArrowType>::BuilderType;
-    ArrowBuilder builder;
+    ArrowBuilder builder(katana::PropertyMemoryPool());
     if (data_.size() > 0) {
       if constexpr (std::is_scalar_v<value_type>) {
         // TODO(danielmawhirter) find a better way to handle this
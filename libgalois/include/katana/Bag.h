@@ -21,7 +21,9 @@
 #define KATANA_LIBGALOIS_KATANA_BAG_H_
 
 #include <algorithm>
+#include <iterator>
 #include <stdexcept>
+#include <vector>
 
 #include <boost/iterator/iterator_facade.hpp>
 
@@ -36,7 +38,8 @@ namespace katana {
 
 /**
  * Unordered collection of elements. This data structure supports scalable
- * concurrent pushes but reading the bag can only be done serially.
+ * concurrent pushes but iterating over the bag is done serially or by the
+ * threads which inserted the elements; see compact for a parallel copy.
  */
 template <typename T, unsigned int BlockSize = 0>
 class InsertBag {
@@ -156,6 +159,14 @@ private:
     }
   }
 
+  size_t size_of_thread(unsigned x) const {
+    size_t count = 0;
+    for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+      count += std::distance(h->dbegin, h->dend);
+    }
+    return count;
+  }
+
   void destruct_serial() {
     for (unsigned x = 0; x < heads.size(); ++x) {
       PerThread& hpair = *heads.getRemote(x);
@@ -252,6 +263,57 @@ public:
     }
     return true;
   }
+
+  //! Number of elements in the bag. Not thread safe with insertions.
+  size_t size() const {
+    size_t count = 0;
+    for (unsigned x = 0; x < heads.size(); ++x) {
+      count += size_of_thread(x);
+    }
+    return count;
+  }
+
+  /**
+   * Copies the elements of the bag, in the order of iterating over it, into
+   * out, a NUMAArray<T> which is reallocated to hold exactly them. Unlike
+   * iterating, this is parallel: a prefix sum of the number of elements
+   * inserted by each thread gives where its elements go, and each thread
+   * copies its own elements there, so the pages of out are first touched by
+   * the threads which filled the bag. A do_all over out then splits its
+   * range evenly and cheaply however unevenly threads inserted elements.
+   *
+   * Not thread safe with insertions.
+   */
+  template <typename ArrayTy>
+  void compact(ArrayTy* out) const {
+    std::vector<size_t> offsets(heads.size() + 1, 0);
+    katana::on_each_gen(
+        [&](const unsigned int tid, const unsigned int total) {
+          for (unsigned x = tid; x < heads.size(); x += total) {
+            offsets[x + 1] = size_of_thread(x);
+          }
+        },
+        std::make_tuple(katana::no_stats()));
+    for (size_t x = 0; x < heads.size(); ++x) {
+      offsets[x + 1] += offsets[x];
+    }
+
+    out->destroy();
+    out->deallocate();
+    out->allocateFloating(offsets.back());
+    katana::on_each_gen(
+        [&](const unsigned int tid, const unsigned int total) {
+          for (unsigned x = tid; x < heads.size(); x += total) {
+            size_t n = offsets[x];
+            for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+              for (T* ii = h->dbegin; ii != h->dend; ++ii) {
+                out->constructAt(n++, *ii);
+              }
+            }
+          }
+        },
+        std::make_tuple(katana::no_stats()));
+  }
   //! Thread safe bag insertion
   template <typename... Args>
   reference emplace(Args&&... args) {
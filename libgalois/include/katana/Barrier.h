@@ -61,6 +61,11 @@ public:
  */
 KATANA_EXPORT Barrier& GetBarrier(unsigned active_threads);
 
+/// Creates a barrier that picks one of the barriers below depending on the
+/// number of threads and the sockets they span. This is the barrier
+/// GetBarrier returns.
+KATANA_EXPORT std::unique_ptr<Barrier> CreateAutoBarrier(unsigned);
+
 /**
  * Create specific types of barriers.  For benchmarking only.  Use
  * GetBarrier() for all production code
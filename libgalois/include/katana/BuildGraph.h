@@ -5,6 +5,7 @@
 ///
 /// \file
 
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <string>
@@ -28,7 +29,7 @@ using NullMaps = std::pair<
     std::unordered_map<int, std::shared_ptr<arrow::Array>>,
     std::unordered_map<int, std::shared_ptr<arrow::Array>>>;
 
-enum SourceType { kGraphml, kKatana };
+enum SourceType { kGraphml, kKatana, kTables };
 enum SourceDatabase { kNone, kNeo4j, kMongodb, kMysql };
 enum ImportDataType {
   kString,
@@ -231,6 +232,108 @@ private:
   GraphComponent BuildFinalEdges(bool verbose);
 };
 
+/// The values of one property, or the elements with one label, staged in a
+/// shard of a ShardedPropertyGraphBuilder
+struct StagedColumn {
+  std::string name;
+  ImportDataType type;
+  bool is_list;
+  /// shard indexes of the elements that have a value
+  std::vector<uint64_t> indexes;
+  /// values parallel to indexes; empty for labels
+  std::vector<ImportData> values;
+};
+
+struct StagedColumns {
+  // maps property or label names to column indexes
+  std::unordered_map<std::string, size_t> keys;
+  std::vector<StagedColumn> columns;
+};
+
+/// Builds GraphComponents from nodes and edges added by many threads at once,
+/// for bulk ingestion. Each thread adds to its own Shard, so adding takes no
+/// locks, and Finish merges the shards in parallel.
+///
+/// Unlike PropertyGraphBuilder, elements may be added in any order: an edge
+/// may name nodes that are added later, by any shard, or never, in which case
+/// Finish adds a node without properties or labels for each missing ID.
+/// Nodes are numbered in the order of their shards and then of their
+/// addition, and placeholder nodes come after all added nodes; the edges of a
+/// node keep that order too. As in PropertyGraphBuilder, an ID added twice
+/// makes two nodes and edges refer to the first one.
+///
+/// \code
+/// katana::ShardedPropertyGraphBuilder builder;
+/// katana::do_all(katana::iterate(records), [&](const Record& r) {
+///   auto* shard = builder.GetLocalShard();
+///   shard->AddEdge(r.from, r.to);
+///   shard->AddEdgeType(r.type);
+/// });
+/// auto components = KATANA_CHECKED(builder.Finish());
+/// \endcode
+class KATANA_EXPORT ShardedPropertyGraphBuilder {
+public:
+  /// The elements added by one thread. Labels, types and values apply to the
+  /// last node or edge added to the shard.
+  class KATANA_EXPORT Shard {
+  public:
+    void AddNode(std::string id);
+    Result<void> AddNodeLabel(const std::string& label);
+    Result<void> AddNodeValue(const std::string& property, ImportData value);
+
+    void AddEdge(std::string source, std::string target);
+    Result<void> AddEdgeType(const std::string& type);
+    Result<void> AddEdgeValue(const std::string& property, ImportData value);
+
+    /// Declare a property of values of type, so that its column exists even
+    /// if no element has a value for it
+    Result<void> DeclareNodeProperty(
+        const std::string& property, ImportDataType type, bool is_list);
+    Result<void> DeclareEdgeProperty(
+        const std::string& property, ImportDataType type, bool is_list);
+
+    size_t num_nodes() const { return node_ids_.size(); }
+    size_t num_edges() const { return edge_sources_.size(); }
+
+  private:
+    friend class ShardedPropertyGraphBuilder;
+
+    std::vector<std::string> node_ids_;
+    std::vector<std::string> edge_sources_;
+    std::vector<std::string> edge_targets_;
+    StagedColumns node_properties_;
+    StagedColumns node_labels_;
+    StagedColumns edge_properties_;
+    StagedColumns edge_types_;
+  };
+
+  /// \param num_shards is the number of threads that add elements; by default
+  /// katana::getActiveThreads()
+  /// \param chunk_size is the length of the Arrow arrays of the tables, each
+  /// of which is built by one thread
+  explicit ShardedPropertyGraphBuilder(
+      size_t num_shards = 0, size_t chunk_size = 1 << 20);
+
+  size_t num_shards() const { return shards_.size(); }
+  Shard* GetShard(size_t index) { return &shards_[index]; }
+  /// Add num_shards shards after the existing ones, for inputs that are
+  /// split into more parts than there are threads; shards already returned
+  /// stay valid. Must not be called while shards are being added to.
+  /// \returns the index of the first new shard
+  size_t AddShards(size_t num_shards);
+  /// \returns the shard of the calling thread of the katana thread pool
+  Shard* GetLocalShard();
+
+  /// Resolve node IDs, sort the edges by source and build the topology and
+  /// the tables. The shards must not change during the call, which uses
+  /// katana::do_all and so must not be called in a parallel region.
+  Result<GraphComponents> Finish(bool verbose = true);
+
+private:
+  std::deque<Shard> shards_;
+  size_t chunk_size_;
+};
+
 KATANA_EXPORT Result<std::unique_ptr<katana::PropertyGraph>>
 ConvertToPropertyGraph(GraphComponents&& graph_comps);
 
@@ -0,0 +1,73 @@
+#ifndef KATANA_LIBGALOIS_KATANA_CANCELLATION_H_
+#define KATANA_LIBGALOIS_KATANA_CANCELLATION_H_
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+namespace katana {
+
+/// A request to stop parallel loops early, either explicitly with Cancel or
+/// once a deadline passes.
+///
+/// Loops given the token with katana::cancellation() check it at chunk
+/// boundaries and return early, leaving the remaining work undone, once the
+/// token is cancelled. Callers must check IsCancelled after such loops to
+/// know whether their results are complete.
+///
+/// Any thread may cancel the token or change its deadline while loops run.
+class CancellationToken {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  CancellationToken() = default;
+
+  explicit CancellationToken(Clock::time_point deadline) {
+    SetDeadline(deadline);
+  }
+
+  CancellationToken(const CancellationToken&) = delete;
+  CancellationToken& operator=(const CancellationToken&) = delete;
+  CancellationToken(CancellationToken&&) = delete;
+  CancellationToken& operator=(CancellationToken&&) = delete;
+
+  /// Cancel the loops that use this token
+  void Cancel() noexcept { cancelled_.store(true, std::memory_order_relaxed); }
+
+  /// Cancel the loops that use this token once \param deadline passes
+  void SetDeadline(Clock::time_point deadline) noexcept {
+    deadline_.store(
+        deadline.time_since_epoch().count(), std::memory_order_relaxed);
+  }
+
+  /// Cancel the loops that use this token after \param timeout from now
+  void SetTimeout(Clock::duration timeout) noexcept {
+    SetDeadline(Clock::now() + timeout);
+  }
+
+  /// \returns true if Cancel was called or the deadline passed
+  bool IsCancelled() const noexcept {
+    if (cancelled_.load(std::memory_order_relaxed)) {
+      return true;
+    }
+    Clock::rep deadline = deadline_.load(std::memory_order_relaxed);
+    if (deadline == kNoDeadline ||
+        Clock::now().time_since_epoch().count() < deadline) {
+      return false;
+    }
+    // save later callers the clock read
+    cancelled_.store(true, std::memory_order_relaxed);
+    return true;
+  }
+
+private:
+  static constexpr Clock::rep kNoDeadline =
+      std::numeric_limits<Clock::rep>::max();
+
+  mutable std::atomic<bool> cancelled_{false};
+  std::atomic<Clock::rep> deadline_{kNoDeadline};
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,291 @@
+#ifndef KATANA_LIBGALOIS_KATANA_CHASELEVDEQUE_H_
+#define KATANA_LIBGALOIS_KATANA_CHASELEVDEQUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/FixedSizeRing.h"
+#include "katana/Mem.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+
+namespace katana {
+
+/// A lock-free work-stealing deque of pointers (Chase and Lev, "Dynamic
+/// Circular Work-Stealing Deque", SPAA 2005, with the memory orders of Le et
+/// al., PPoPP 2013).
+///
+/// Only the owning thread may call Push and Take, which work on the bottom
+/// of the deque; any thread may call Steal, which takes from the top. The
+/// buffer grows as needed; buffers that were replaced are kept until the
+/// deque is destroyed because thieves may still read them.
+template <typename T>
+class ChaseLevDeque : private boost::noncopyable {
+  struct Buffer {
+    explicit Buffer(int64_t log_size)
+        : mask((int64_t{1} << log_size) - 1),
+          slots(std::make_unique<std::atomic<T*>[]>(mask + 1)) {}
+
+    int64_t size() const { return mask + 1; }
+
+    T* Get(int64_t i) const {
+      return slots[i & mask].load(std::memory_order_relaxed);
+    }
+    void Put(int64_t i, T* item) {
+      slots[i & mask].store(item, std::memory_order_relaxed);
+    }
+
+    int64_t mask;
+    std::unique_ptr<std::atomic<T*>[]> slots;
+  };
+
+  static constexpr int64_t kInitialLogSize = 6;
+
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<int64_t> top_{0};
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<int64_t> bottom_{0};
+  std::atomic<Buffer*> buffer_;
+  /// owns the current buffer and all buffers it replaced
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+
+  KATANA_ATTRIBUTE_NOINLINE Buffer* Grow(
+      Buffer* old, int64_t top, int64_t bottom) {
+    int64_t log_size = 0;
+    while ((int64_t{1} << log_size) < 2 * old->size()) {
+      ++log_size;
+    }
+    buffers_.emplace_back(std::make_unique<Buffer>(log_size));
+    Buffer* grown = buffers_.back().get();
+    for (int64_t i = top; i < bottom; ++i) {
+      grown->Put(i, old->Get(i));
+    }
+    buffer_.store(grown, std::memory_order_release);
+    return grown;
+  }
+
+public:
+  ChaseLevDeque() {
+    buffers_.emplace_back(std::make_unique<Buffer>(kInitialLogSize));
+    buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+  }
+
+  /// A racy check, e.g., to skip empty victims without a CAS
+  bool empty() const {
+    return bottom_.load(std::memory_order_relaxed) <=
+           top_.load(std::memory_order_relaxed);
+  }
+
+  /// Owner only
+  void Push(T* item) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+    if (bottom - top > buffer->size() - 1) {
+      buffer = Grow(buffer, top, bottom);
+    }
+    buffer->Put(bottom, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  /// Owner only. \returns the most recently pushed item or null if the deque
+  /// is empty.
+  T* Take() {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T* item = buffer->Get(bottom);
+    if (top == bottom) {
+      // last item; race with thieves for it
+      if (!top_.compare_exchange_strong(
+              top, top + 1, std::memory_order_seq_cst,
+              std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  /// Any thread. \returns the least recently pushed item, or null if the
+  /// deque is empty or another thread took the item first.
+  T* Steal() {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+    T* item = buffer_.load(std::memory_order_acquire)->Get(top);
+    if (!top_.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst,
+            std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return item;
+  }
+};
+
+/// A worklist of per-thread Chase-Lev deques of chunks. Each thread fills a
+/// private chunk and pushes it onto its own deque when full. A thread pops
+/// from its current chunk and then takes the most recent chunk of its deque
+/// (LIFO), so the owner never contends with the other threads except for
+/// the last chunk. Idle threads steal the oldest chunk (FIFO) of another
+/// thread, first from threads of the same socket and then from the other
+/// sockets, without taking any locks.
+///
+/// Suited to irregular operators that generate a lot of work recursively,
+/// where the shared queues of PerSocketChunkLIFO become contended.
+template <int ChunkSize = 64, typename T = int>
+class ChunkDequeLIFO : private boost::noncopyable {
+public:
+  template <typename _T>
+  using retype = ChunkDequeLIFO<ChunkSize, _T>;
+
+  template <bool _concurrent>
+  using rethread = ChunkDequeLIFO<ChunkSize, T>;
+
+  template <int _chunk_size>
+  using with_chunk_size = ChunkDequeLIFO<_chunk_size, T>;
+
+  typedef T value_type;
+
+private:
+  class Chunk : public katana::FixedSizeRing<T, ChunkSize> {};
+
+  struct ThreadData {
+    /// private to the thread; not in deque
+    Chunk* current{nullptr};
+    ChaseLevDeque<Chunk> deque;
+    /// where the search of the other sockets starts
+    unsigned last_victim{0};
+  };
+
+  FixedSizeAllocator<Chunk> alloc_;
+  PerThreadStorage<ThreadData> data_;
+
+  Chunk* MakeChunk() {
+    Chunk* ptr = alloc_.allocate(1);
+    alloc_.construct(ptr);
+    return ptr;
+  }
+
+  void DeleteChunk(Chunk* ptr) {
+    alloc_.destroy(ptr);
+    alloc_.deallocate(ptr, 1);
+  }
+
+  void PushInternal(ThreadData& me, const value_type& val) {
+    if (me.current && me.current->push_back(val)) {
+      return;
+    }
+    if (me.current) {
+      me.deque.Push(me.current);
+    }
+    me.current = MakeChunk();
+    me.current->push_back(val);
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE Chunk* Steal(ThreadData& me) {
+    auto& tp = GetThreadPool();
+    unsigned id = ThreadPool::getTID();
+    unsigned socket = ThreadPool::getSocket();
+    unsigned num = katana::getActiveThreads();
+
+    auto try_steal = [&](unsigned victim) -> Chunk* {
+      ThreadData& other = *data_.getRemote(victim);
+      return other.deque.empty() ? nullptr : other.deque.Steal();
+    };
+
+    // First steal from this socket
+    for (unsigned i = 1; i < num; ++i) {
+      unsigned victim = (id + i) % num;
+      if (tp.getSocket(victim) == socket) {
+        if (Chunk* c = try_steal(victim)) {
+          return c;
+        }
+      }
+    }
+
+    // Then from the other sockets
+    for (unsigned i = 0; i < num; ++i) {
+      unsigned victim = (me.last_victim + i) % num;
+      if (tp.getSocket(victim) != socket) {
+        if (Chunk* c = try_steal(victim)) {
+          me.last_victim = victim;
+          return c;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+public:
+  ChunkDequeLIFO() = default;
+
+  ~ChunkDequeLIFO() {
+    for (unsigned i = 0; i < data_.size(); ++i) {
+      ThreadData& td = *data_.getRemote(i);
+      if (td.current) {
+        DeleteChunk(td.current);
+      }
+      while (Chunk* c = td.deque.Take()) {
+        DeleteChunk(c);
+      }
+    }
+  }
+
+  void push(const value_type& val) { PushInternal(*data_.getLocal(), val); }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    ThreadData& me = *data_.getLocal();
+    while (b != e) {
+      PushInternal(me, *b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    ThreadData& me = *data_.getLocal();
+    while (true) {
+      if (me.current) {
+        if (std::optional<value_type> retval = me.current->extract_back()) {
+          return retval;
+        }
+        DeleteChunk(me.current);
+        me.current = nullptr;
+      }
+      me.current = me.deque.Take();
+      if (!me.current) {
+        me.current = Steal(me);
+      }
+      if (!me.current) {
+        return std::nullopt;
+      }
+    }
+  }
+};
+KATANA_WLCOMPILECHECK(ChunkDequeLIFO)
+
+}  // namespace katana
+
+#endif
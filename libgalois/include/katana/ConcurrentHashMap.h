@@ -0,0 +1,145 @@
+#ifndef KATANA_LIBGALOIS_KATANA_CONCURRENTHASHMAP_H_
+#define KATANA_LIBGALOIS_KATANA_CONCURRENTHASHMAP_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#include <boost/noncopyable.hpp>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/ScratchHashMap.h"
+
+namespace katana {
+
+/// A lock-free linear probing hash map from integers to atomic values, for
+/// aggregating into a map shared by all threads, e.g., counting or summing
+/// values by key.
+///
+/// The capacity is fixed at construction and entries cannot be removed
+/// except all at once with Clear. One key value, max() by default, marks
+/// empty slots and cannot be inserted.
+///
+/// \code
+/// katana::ConcurrentHashMap<uint64_t, uint64_t> counts(num_keys);
+/// katana::do_all(katana::iterate(items), [&](const Item& item) {
+///   counts.FindOrInsert(item.key).fetch_add(1, std::memory_order_relaxed);
+/// });
+/// \endcode
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ConcurrentHashMap : private boost::noncopyable {
+  static_assert(std::is_integral_v<Key>, "keys must be integers");
+
+  struct Slot {
+    std::atomic<Key> key;
+    std::atomic<Value> value;
+  };
+
+public:
+  /// \param max_entries is the number of distinct keys the map must hold
+  explicit ConcurrentHashMap(
+      size_t max_entries, Key empty_key = std::numeric_limits<Key>::max())
+      : empty_key_(empty_key) {
+    // keep the load factor at most 1/2 so that probes stay short
+    while ((size_t{1} << log_slots_) < 2 * max_entries) {
+      ++log_slots_;
+    }
+    slots_.allocateInterleaved(size_t{1} << log_slots_);
+    Clear();
+  }
+
+  /// \returns the number of keys in the map
+  size_t size() const { return size_.load(std::memory_order_relaxed); }
+  bool empty() const { return size() == 0; }
+
+  /// \returns the number of slots, which bounds the number of keys
+  size_t capacity() const { return slots_.size(); }
+
+  /// \returns the value of \param key, inserting a value-initialized one if
+  /// the key is absent. Thread safe.
+  std::atomic<Value>& FindOrInsert(Key key) {
+    KATANA_LOG_DEBUG_ASSERT(key != empty_key_);
+    size_t mask = slots_.size() - 1;
+    size_t slot = internal::HashToSlot(hash_(key), log_slots_);
+    for (size_t probes = 0;; ++probes, slot = (slot + 1) & mask) {
+      KATANA_LOG_VASSERT(
+          probes < slots_.size(), "concurrent hash map of {} slots is full",
+          slots_.size());
+      Slot& s = slots_[slot];
+      Key found = s.key.load(std::memory_order_acquire);
+      if (found == empty_key_) {
+        if (s.key.compare_exchange_strong(
+                found, key, std::memory_order_acq_rel)) {
+          size_.fetch_add(1, std::memory_order_relaxed);
+          return s.value;
+        }
+        // found is now the key another thread put in the slot
+      }
+      if (found == key) {
+        return s.value;
+      }
+    }
+  }
+
+  /// \returns the value of \param key or null if the key is absent. Thread
+  /// safe.
+  const std::atomic<Value>* Find(Key key) const {
+    size_t mask = slots_.size() - 1;
+    size_t slot = internal::HashToSlot(hash_(key), log_slots_);
+    for (size_t probes = 0; probes < slots_.size();
+         ++probes, slot = (slot + 1) & mask) {
+      const Slot& s = slots_[slot];
+      Key found = s.key.load(std::memory_order_acquire);
+      if (found == key) {
+        return &s.value;
+      }
+      if (found == empty_key_) {
+        return nullptr;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Calls \param fn with every key and its value in parallel. Do NOT call
+  /// in a parallel region as it uses katana::do_all.
+  template <typename Fn>
+  void ForEach(const Fn& fn) const {
+    katana::do_all(
+        katana::iterate(size_t{0}, slots_.size()),
+        [&](size_t slot) {
+          const Slot& s = slots_[slot];
+          Key key = s.key.load(std::memory_order_relaxed);
+          if (key != empty_key_) {
+            fn(key, s.value.load(std::memory_order_relaxed));
+          }
+        },
+        katana::no_stats());
+  }
+
+  /// Removes all entries. Not thread safe.
+  void Clear() {
+    katana::do_all(
+        katana::iterate(size_t{0}, slots_.size()),
+        [&](size_t slot) {
+          slots_[slot].key.store(empty_key_, std::memory_order_relaxed);
+          slots_[slot].value.store(Value{}, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    size_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  katana::NUMAArray<Slot> slots_;
+  std::atomic<size_t> size_{0};
+  Key empty_key_;
+  uint32_t log_slots_{1};
+  Hash hash_;
+};
+
+}  // namespace katana
+
+#endif
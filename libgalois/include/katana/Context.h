@@ -133,6 +133,8 @@ protected:
 class KATANA_EXPORT SimpleRuntimeContext : public LockManagerBase {
   //! The locks we hold
   Lockable* locks;
+  //! The lock of the last conflict, if not yet taken by the executor
+  Lockable* conflictLock;
   bool customAcquire;
 
 protected:
@@ -160,6 +162,7 @@ protected:
         addToNhood(lockable);
       }
     } else {
+      conflictLock = lockable;
       signalConflict(lockable);
     }
   }
@@ -167,13 +170,22 @@ protected:
   void release(Lockable* lockable);
 
 public:
-  SimpleRuntimeContext(bool child = false) : locks(0), customAcquire(child) {}
+  SimpleRuntimeContext(bool child = false)
+      : locks(0), conflictLock(0), customAcquire(child) {}
   virtual ~SimpleRuntimeContext() {}
 
   void startIteration() { KATANA_LOG_DEBUG_ASSERT(!locks); }
 
   unsigned cancelIteration();
   unsigned commitIteration();
+
+  //! \returns the lock that the last aborted iteration failed to acquire,
+  //! or null if the conflict was signalled otherwise, and forgets it
+  Lockable* takeConflictLock() {
+    Lockable* lockable = conflictLock;
+    conflictLock = 0;
+    return lockable;
+  }
 };
 
 //! get the current conflict detection class, may be null if not in parallel
@@ -0,0 +1,234 @@
+#ifndef KATANA_LIBGALOIS_KATANA_DELTATOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_DELTATOPOLOGY_H_
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A mutable overlay of edge insertions and deletions on an immutable
+/// GraphTopology, so that a stream of small updates does not rebuild the CSR
+/// each time.
+///
+/// Each node that was updated has a buffer of appended edge destinations and
+/// a list of its base edges that were removed. OutEdges returns the surviving
+/// base edges followed by the appended ones. The overlay is folded into a new
+/// CSR by Merge, or in the background by StartCompaction and
+/// FinishCompaction while updates continue.
+///
+/// AddEdge and RemoveEdge may be called concurrently with each other, also
+/// while a compaction runs. Reads (OutEdges, OutDegree) must not run
+/// concurrently with updates of the same node, nor with FinishCompaction,
+/// which replaces the base topology.
+class KATANA_EXPORT DeltaTopology : public GraphTopologyTypes {
+  /// The updates of one node
+  struct NodeDelta {
+    std::vector<Node> added;
+    /// removed edges of the base topology
+    std::vector<Edge> removed;
+
+    bool IsRemoved(Edge e) const noexcept {
+      return std::find(removed.begin(), removed.end(), e) != removed.end();
+    }
+  };
+
+public:
+  /// The destinations of the out edges of a node
+  class OutEdgeIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Node;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Node*;
+    using reference = Node;
+
+    OutEdgeIterator() = default;
+
+    Node operator*() const noexcept {
+      return edge_ < base_end_ ? base_->edge_dest(edge_)
+                               : delta_->added[added_index_];
+    }
+
+    OutEdgeIterator& operator++() noexcept {
+      if (edge_ < base_end_) {
+        ++edge_;
+        SkipRemoved();
+      } else {
+        ++added_index_;
+      }
+      return *this;
+    }
+
+    OutEdgeIterator operator++(int) noexcept {
+      OutEdgeIterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const OutEdgeIterator& that) const noexcept {
+      return edge_ == that.edge_ && added_index_ == that.added_index_;
+    }
+    bool operator!=(const OutEdgeIterator& that) const noexcept {
+      return !(*this == that);
+    }
+
+  private:
+    friend class DeltaTopology;
+
+    OutEdgeIterator(
+        const GraphTopology* base, const NodeDelta* delta, Edge edge,
+        Edge base_end, size_t added_index) noexcept
+        : base_(base),
+          delta_(delta),
+          edge_(edge),
+          base_end_(base_end),
+          added_index_(added_index) {
+      SkipRemoved();
+    }
+
+    void SkipRemoved() noexcept {
+      while (delta_ && edge_ < base_end_ && delta_->IsRemoved(edge_)) {
+        ++edge_;
+      }
+    }
+
+    const GraphTopology* base_{nullptr};
+    const NodeDelta* delta_{nullptr};
+    Edge edge_{0};
+    Edge base_end_{0};
+    size_t added_index_{0};
+  };
+
+  using OutEdgeRange = StandardRange<OutEdgeIterator>;
+
+  explicit DeltaTopology(std::shared_ptr<const GraphTopology> base) noexcept;
+  ~DeltaTopology();
+
+  DeltaTopology(const DeltaTopology&) = delete;
+  DeltaTopology& operator=(const DeltaTopology&) = delete;
+  DeltaTopology(DeltaTopology&&) = delete;
+  DeltaTopology& operator=(DeltaTopology&&) = delete;
+
+  const GraphTopology& base() const noexcept { return *base_; }
+
+  uint64_t num_nodes() const noexcept { return base_->num_nodes(); }
+
+  /// The number of edges of the base topology and the overlay together
+  uint64_t num_edges() const noexcept {
+    return base_->num_edges() + num_added_ - num_removed_;
+  }
+
+  /// The number of appended and removed edges, e.g., to decide when to
+  /// compact
+  uint64_t num_delta_edges() const noexcept {
+    return num_added_ + num_removed_;
+  }
+
+  /// Append an edge from \param src to \param dst
+  void AddEdge(Node src, Node dst) noexcept;
+
+  /// Remove one edge from \param src to \param dst, preferring appended
+  /// edges over base edges. \returns false if there is no such edge.
+  bool RemoveEdge(Node src, Node dst) noexcept;
+
+  OutEdgeRange OutEdges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < num_nodes());
+    const NodeDelta* delta = deltas_[node].get();
+    auto base_edges = base_->edges(node);
+    Edge first = *base_edges.begin();
+    Edge last = *base_edges.end();
+    return OutEdgeRange(
+        OutEdgeIterator(base_.get(), delta, first, last, 0),
+        OutEdgeIterator(
+            base_.get(), delta, last, last, delta ? delta->added.size() : 0));
+  }
+
+  uint64_t OutDegree(Node node) const noexcept {
+    const NodeDelta* delta = deltas_[node].get();
+    uint64_t degree = base_->degree(node);
+    if (delta) {
+      degree += delta->added.size();
+      degree -= delta->removed.size();
+    }
+    return degree;
+  }
+
+  /// Build a CSR of the base topology with the overlay applied, in parallel.
+  /// Must not run concurrently with updates.
+  GraphTopology Merge() const noexcept;
+
+  /// Start building a CSR of the current state in a background thread.
+  /// Later updates are applied to the overlay as usual and recorded so that
+  /// FinishCompaction can apply them again on top of the new CSR.
+  Result<void> StartCompaction() noexcept;
+
+  /// true if StartCompaction was called without a matching FinishCompaction
+  bool is_compacting() const noexcept;
+
+  /// Wait for the compaction started by StartCompaction, make its CSR the
+  /// base topology and keep only the updates made since StartCompaction in
+  /// the overlay.
+  Result<void> FinishCompaction() noexcept;
+
+private:
+  static constexpr size_t kNumLockStripes = 1024;
+
+  /// An update made during a compaction
+  struct LoggedUpdate {
+    bool is_add;
+    Node src;
+    Node dst;
+  };
+
+  using Snapshot = std::vector<std::pair<Node, NodeDelta>>;
+
+  static GraphTopology BuildFromSnapshot(
+      const GraphTopology& base, const Snapshot& snapshot) noexcept;
+
+  std::mutex& LockFor(Node node) const noexcept {
+    return lock_stripes_[node % kNumLockStripes];
+  }
+
+  /// Call with the lock of \param node held
+  NodeDelta* GetOrMakeDelta(Node node) noexcept;
+  /// Call with the lock of \param src held
+  void AddEdgeLocked(Node src, Node dst) noexcept;
+  /// Call with the lock of \param src held
+  bool RemoveEdgeLocked(Node src, Node dst) noexcept;
+  /// Call with the lock of \param src held
+  void LogUpdate(bool is_add, Node src, Node dst) noexcept;
+
+  std::shared_ptr<const GraphTopology> base_;
+  /// null for nodes without updates
+  std::vector<std::unique_ptr<NodeDelta>> deltas_;
+  /// nodes with a non-null entry in deltas_
+  std::vector<Node> touched_;
+  std::mutex touched_mutex_;
+  std::atomic<uint64_t> num_added_{0};
+  std::atomic<uint64_t> num_removed_{0};
+
+  mutable std::vector<std::mutex> lock_stripes_;
+  /// updates hold it shared; taking a snapshot and replacing the base hold
+  /// it exclusively
+  mutable std::shared_mutex seal_mutex_;
+
+  bool compacting_{false};
+  std::future<GraphTopology> compaction_;
+  std::vector<LoggedUpdate> log_;
+  std::mutex log_mutex_;
+};
+
+}  // namespace katana
+
+#endif
@@ -21,6 +21,8 @@
 #define KATANA_LIBGALOIS_KATANA_DETAILS_H_
 
 #include <algorithm>
+#include <tuple>
+#include <utility>
 
 #include <boost/mpl/if.hpp>
 
@@ -290,6 +292,62 @@ struct NodeInfoBase<void, HasLockable>
   typename NodeInfoBase::const_reference getData() const { return 0; }
 };
 
+//! Node data which also stores each of NodeFields (a std::tuple of types) in
+//! an array of its own, i.e., as a struct of arrays, so that loops which use
+//! one field of every node only stream the bytes of that field. Allocating,
+//! constructing and destroying the node data does the same to the fields.
+template <typename NodeInfo, typename NodeFields>
+class NodeDataArrays;
+
+template <typename NodeInfo, typename... Fields>
+class NodeDataArrays<NodeInfo, std::tuple<Fields...>>
+    : public NUMAArray<NodeInfo> {
+  using Base = NUMAArray<NodeInfo>;
+  std::tuple<NUMAArray<Fields>...> fields;
+
+  template <typename FnTy>
+  void forEachField(const FnTy& fn) {
+    std::apply([&](auto&... arrays) { (fn(arrays), ...); }, fields);
+  }
+
+public:
+  void allocateBlocked(size_t n) {
+    Base::allocateBlocked(n);
+    forEachField([&](auto& array) { array.allocateBlocked(n); });
+  }
+
+  void allocateInterleaved(size_t n) {
+    Base::allocateInterleaved(n);
+    forEachField([&](auto& array) { array.allocateInterleaved(n); });
+  }
+
+  template <typename... Args>
+  void constructAt(size_t n, Args&&... args) {
+    Base::constructAt(n, std::forward<Args>(args)...);
+    forEachField([&](auto& array) { array.constructAt(n); });
+  }
+
+  void destroy() {
+    Base::destroy();
+    forEachField([](auto& array) { array.destroy(); });
+  }
+
+  void deallocate() {
+    Base::deallocate();
+    forEachField([](auto& array) { array.deallocate(); });
+  }
+
+  template <size_t I>
+  auto& field() {
+    return std::get<I>(fields);
+  }
+
+  template <size_t I>
+  const auto& field() const {
+    return std::get<I>(fields);
+  }
+};
+
 template <bool Enable>
 class OutOfLineLockableFeature {
   typedef NodeInfoBase<void, true> OutOfLineLock;
@@ -0,0 +1,305 @@
+#ifndef KATANA_LIBGALOIS_KATANA_DISTRIBUTION_H_
+#define KATANA_LIBGALOIS_KATANA_DISTRIBUTION_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/GraphTopology.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+/// How Distribution reads and writes the values it syncs: arrays of atomics,
+/// which the relaxation loops of analytics need, are synced like arrays of
+/// their values
+template <typename T>
+struct SyncValue {
+  using type = T;
+  static T Load(const T& v) { return v; }
+  static void Store(T* dst, T v) { *dst = v; }
+};
+
+template <typename T>
+struct SyncValue<std::atomic<T>> {
+  using type = T;
+  static T Load(const std::atomic<T>& v) {
+    return v.load(std::memory_order_relaxed);
+  }
+  static void Store(std::atomic<T>* dst, T v) {
+    dst->store(v, std::memory_order_relaxed);
+  }
+};
+
+}  // namespace internal
+
+/// The partition of a graph across the hosts (tasks of a CommBackend) that
+/// run a distributed analytic, and the syncs of per-node values between the
+/// proxies of a node.
+///
+/// Each host loads one partition of a partitioned RDG, e.g., with
+/// RDGLoadOptions::partition_id_to_load equal to its CommBackend::ID. The
+/// local nodes of a partition are its masters, [0, num_owned()), followed by
+/// mirrors of nodes that are owned by other hosts. masters(h) are the masters
+/// that host h has mirrors of, in the order of mirrors(host_id()) of host h.
+///
+/// A sync exchanges only the values of the proxies marked in a bitset. Each
+/// message is a bitmap over the positions of the list it is for, followed by
+/// the packed values of the marked positions, so a sync costs a bit per
+/// boundary node plus the values that changed.
+class KATANA_EXPORT Distribution {
+public:
+  using Node = GraphTopologyTypes::Node;
+  using ReduceOp = CommBackend::ReduceOp;
+
+  /// Read the partition of pg for the task comm->ID of comm->Num. A graph
+  /// that is not partitioned is the only partition of a single task.
+  static Result<Distribution> Make(const PropertyGraph* pg, CommBackend* comm);
+
+  /// Record in pg, a partition built in memory, e.g., by a partitioner, what
+  /// Make reads from a loaded partition: the global id of each local node,
+  /// the number of masters, which come first, and the lists of masters and
+  /// mirrors per host that masters() and mirrors() return.
+  static Result<void> SetPartition(
+      PropertyGraph* pg, uint64_t num_global_nodes, size_t num_owned,
+      const std::vector<uint64_t>& local_to_global,
+      const std::vector<std::vector<Node>>& masters,
+      const std::vector<std::vector<Node>>& mirrors);
+
+  CommBackend* comm() const { return comm_; }
+  uint32_t num_hosts() const { return comm_->Num; }
+  uint32_t host_id() const { return comm_->ID; }
+
+  uint64_t num_global_nodes() const { return num_global_nodes_; }
+  /// the number of local nodes, masters and mirrors
+  size_t num_nodes() const { return local_to_global_.size(); }
+  size_t num_owned() const { return num_owned_; }
+  bool is_owned(Node n) const { return n < num_owned_; }
+  uint64_t local_to_global(Node n) const { return local_to_global_[n]; }
+
+  /// the masters of this host that host has mirrors of
+  const std::vector<Node>& masters(uint32_t host) const {
+    return masters_[host];
+  }
+  /// the mirrors of this host of masters of host
+  const std::vector<Node>& mirrors(uint32_t host) const {
+    return mirrors_[host];
+  }
+
+  /// Combine the values of the mirrors of every host marked in updated into
+  /// their masters with op. A null updated sends every mirror. The bit of a
+  /// master is set if its value changed or a mirror sent a different value,
+  /// i.e., if its mirrors are stale.
+  template <typename T>
+  Result<void> ReduceToMasters(
+      ReduceOp op, NUMAArray<T>* values, DynamicBitset* updated) const {
+    using Value = internal::SyncValue<T>;
+    auto received = KATANA_CHECKED(
+        comm_->AllToAll(Pack<T>(mirrors_, *values, updated)));
+    for (uint32_t host = 0; host < num_hosts(); ++host) {
+      // masters(host) has each master once, so positions can be combined in
+      // parallel; messages of different hosts must not be
+      KATANA_CHECKED(Unpack<typename Value::type>(
+          masters_[host], received[host], [&](Node n, auto v) {
+            auto old = Value::Load((*values)[n]);
+            auto combined = Combine(op, old, v);
+            Value::Store(&(*values)[n], combined);
+            if (updated && (combined != old || combined != v)) {
+              updated->set(n);
+            }
+          }));
+    }
+    return ResultSuccess();
+  }
+
+  /// Copy the values of the masters of every host marked in updated to their
+  /// mirrors. A null updated sends every master. The bit of a mirror is set
+  /// if its value changed.
+  template <typename T>
+  Result<void> BroadcastToMirrors(
+      NUMAArray<T>* values, DynamicBitset* updated) const {
+    using Value = internal::SyncValue<T>;
+    auto received = KATANA_CHECKED(
+        comm_->AllToAll(Pack<T>(masters_, *values, updated)));
+    for (uint32_t host = 0; host < num_hosts(); ++host) {
+      KATANA_CHECKED(Unpack<typename Value::type>(
+          mirrors_[host], received[host], [&](Node n, auto v) {
+            if (Value::Load((*values)[n]) != v) {
+              Value::Store(&(*values)[n], v);
+              if (updated) {
+                updated->set(n);
+              }
+            }
+          }));
+    }
+    return ResultSuccess();
+  }
+
+private:
+  static constexpr size_t kBitsPerWord = 64;
+
+  Distribution(
+      CommBackend* comm, uint64_t num_global_nodes, size_t num_owned,
+      std::vector<uint64_t>&& local_to_global,
+      std::vector<std::vector<Node>>&& masters,
+      std::vector<std::vector<Node>>&& mirrors)
+      : comm_(comm),
+        num_global_nodes_(num_global_nodes),
+        num_owned_(num_owned),
+        local_to_global_(std::move(local_to_global)),
+        masters_(std::move(masters)),
+        mirrors_(std::move(mirrors)) {}
+
+  template <typename V>
+  static V Combine(ReduceOp op, V a, V b) {
+    switch (op) {
+    case ReduceOp::kSum:
+      return a + b;
+    case ReduceOp::kMin:
+      return std::min(a, b);
+    case ReduceOp::kMax:
+      return std::max(a, b);
+    }
+    KATANA_LOG_FATAL("unknown reduce op");
+  }
+
+  static size_t NumWords(size_t num_positions) {
+    return (num_positions + kBitsPerWord - 1) / kBitsPerWord;
+  }
+
+  /// Make the message to each host h of the values of the nodes of lists[h]
+  /// that are marked in updated; the message is empty if none are
+  template <typename T>
+  std::vector<std::vector<uint8_t>> Pack(
+      const std::vector<std::vector<Node>>& lists, const NUMAArray<T>& values,
+      const DynamicBitset* updated) const {
+    using Value = internal::SyncValue<T>;
+    using V = typename Value::type;
+    static_assert(std::is_trivially_copyable_v<V>);
+
+    std::vector<std::vector<uint8_t>> messages(num_hosts());
+    for (uint32_t host = 0; host < num_hosts(); ++host) {
+      const std::vector<Node>& list = lists[host];
+      size_t num_words = NumWords(list.size());
+      std::vector<uint64_t> bits(num_words);
+      // offsets[w] is the number of marked positions before word w
+      std::vector<uint64_t> offsets(num_words + 1);
+      katana::do_all(
+          katana::iterate(size_t{0}, num_words),
+          [&](size_t w) {
+            uint64_t word = 0;
+            size_t end = std::min(list.size(), (w + 1) * kBitsPerWord);
+            for (size_t i = w * kBitsPerWord; i < end; ++i) {
+              if (!updated || updated->test(list[i])) {
+                word |= uint64_t{1} << (i % kBitsPerWord);
+              }
+            }
+            bits[w] = word;
+            offsets[w + 1] = __builtin_popcountll(word);
+          },
+          katana::no_stats());
+      for (size_t w = 0; w < num_words; ++w) {
+        offsets[w + 1] += offsets[w];
+      }
+      if (offsets[num_words] == 0) {
+        continue;
+      }
+
+      std::vector<uint8_t>& message = messages[host];
+      size_t header = num_words * sizeof(uint64_t);
+      message.resize(header + offsets[num_words] * sizeof(V));
+      std::memcpy(message.data(), bits.data(), header);
+      uint8_t* packed = message.data() + header;
+      katana::do_all(
+          katana::iterate(size_t{0}, num_words),
+          [&](size_t w) {
+            uint64_t word = bits[w];
+            size_t slot = offsets[w];
+            while (word != 0) {
+              size_t i = w * kBitsPerWord + __builtin_ctzll(word);
+              V v = Value::Load(values[list[i]]);
+              std::memcpy(packed + slot * sizeof(V), &v, sizeof(V));
+              ++slot;
+              word &= word - 1;
+            }
+          },
+          katana::no_stats());
+    }
+    return messages;
+  }
+
+  /// Call fn(list[i], value) for every position i marked in message, which
+  /// was made by Pack for list
+  template <typename V, typename Fn>
+  static Result<void> Unpack(
+      const std::vector<Node>& list, const std::vector<uint8_t>& message,
+      const Fn& fn) {
+    if (message.empty()) {
+      return ResultSuccess();
+    }
+    size_t num_words = NumWords(list.size());
+    size_t header = num_words * sizeof(uint64_t);
+    if (message.size() < header) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "sync message of {} bytes is too short for {} proxies",
+          message.size(), list.size());
+    }
+    std::vector<uint64_t> bits(num_words);
+    std::memcpy(bits.data(), message.data(), header);
+    std::vector<uint64_t> offsets(num_words + 1);
+    for (size_t w = 0; w < num_words; ++w) {
+      offsets[w + 1] = offsets[w] + __builtin_popcountll(bits[w]);
+    }
+    if (message.size() != header + offsets[num_words] * sizeof(V) ||
+        (list.size() % kBitsPerWord != 0 &&
+         (bits[num_words - 1] >> (list.size() % kBitsPerWord)) != 0)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "sync message of {} bytes does not match {} proxies",
+          message.size(), list.size());
+    }
+
+    const uint8_t* packed = message.data() + header;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_words),
+        [&](size_t w) {
+          uint64_t word = bits[w];
+          size_t slot = offsets[w];
+          while (word != 0) {
+            size_t i = w * kBitsPerWord + __builtin_ctzll(word);
+            V v;
+            std::memcpy(&v, packed + slot * sizeof(V), sizeof(V));
+            fn(list[i], v);
+            ++slot;
+            word &= word - 1;
+          }
+        },
+        katana::no_stats());
+    return ResultSuccess();
+  }
+
+  CommBackend* comm_{nullptr};
+  uint64_t num_global_nodes_{0};
+  size_t num_owned_{0};
+  std::vector<uint64_t> local_to_global_;
+  // per host
+  std::vector<std::vector<Node>> masters_;
+  std::vector<std::vector<Node>> mirrors_;
+};
+
+}  // namespace katana
+
+#endif
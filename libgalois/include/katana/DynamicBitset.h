@@ -28,6 +28,7 @@
 
 #include <cassert>
 #include <climits>
+#include <utility>
 #include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
@@ -83,6 +84,42 @@ public:
    */
   auto& get_vec() { return bitvec_; }
 
+  /**
+   * Returns a word of the bitset with the bits past the size of the bitset
+   * unset
+   *
+   * @param word_index Index of the word in the vector returned by get_vec
+   * @returns the bits word_index * 64 to word_index * 64 + 63
+   */
+  uint64_t GetWord(size_t word_index) const {
+    KATANA_LOG_DEBUG_ASSERT(word_index < bitvec_.size());
+    uint64_t word = bitvec_[word_index].load(std::memory_order_relaxed);
+    size_t tail_bits = num_bits_ % kNumBitsInUint64;
+    if (tail_bits != 0 && word_index == bitvec_.size() - 1) {
+      word &= (uint64_t{1} << tail_bits) - 1;
+    }
+    return word;
+  }
+
+  /**
+   * Returns the index of the least significant set bit of a word
+   *
+   * @param word Word with at least one set bit
+   */
+  static uint32_t CountTrailingZeros(uint64_t word) {
+    KATANA_LOG_DEBUG_ASSERT(word != 0);
+#ifdef __GNUC__
+    return __builtin_ctzll(word);
+#else
+    uint32_t n = 0;
+    while ((word & 1) == 0) {
+      word >>= 1;
+      ++n;
+    }
+    return n;
+#endif
+  }
+
   /**
    * Resizes the bitset.
    *
@@ -308,6 +345,14 @@ public:
    */
   void bitwise_xor(const DynamicBitset& other1, const DynamicBitset& other2);
 
+  /**
+   * Does an IN-PLACE bitwise and of this bitset and the complement of
+   * another bitset, i.e., unsets the bits that are set in the other bitset
+   *
+   * @param other Other bitset whose set bits to unset in this bitset
+   */
+  void bitwise_andnot(const DynamicBitset& other);
+
   /**
    * Count how many bits are set in the bitset
    *
@@ -315,6 +360,39 @@ public:
    */
   size_t count() const;
 
+  /**
+   * Finds the first set bit at or after an index. Unset words are skipped
+   * whole, so this is cheap on sparse bitsets.
+   *
+   * @param index Bit to start the search at
+   * @returns the first set bit at or after index or size() if there is none
+   */
+  size_t FindNextSet(size_t index) const;
+
+  /**
+   * Calls a function with the index of every set bit, in parallel. Threads
+   * get whole words and skip the unset ones, which is much cheaper than
+   * testing every bit when the bitset is sparse, e.g., a BFS frontier.
+   * Do NOT call in a parallel region as it uses katana::do_all.
+   *
+   * @param fn Function to call with the index of each set bit
+   * @param args Options of the do_all over the words, e.g., a loopname
+   */
+  template <typename Fn, typename... Args>
+  void ForEachSetBit(const Fn& fn, Args&&... args) const {
+    katana::do_all(
+        katana::iterate(size_t{0}, bitvec_.size()),
+        [&](size_t word_index) {
+          uint64_t word = GetWord(word_index);
+          while (word != 0) {
+            fn(word_index * kNumBitsInUint64 + CountTrailingZeros(word));
+            // unset the least significant set bit
+            word &= word - 1;
+          }
+        },
+        std::forward<Args>(args)...);
+  }
+
   /**
    * Returns a vector containing the set bits in this bitset in order
    * from left to right.
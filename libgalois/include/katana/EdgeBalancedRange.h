@@ -0,0 +1,178 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EDGEBALANCEDRANGE_H_
+#define KATANA_LIBGALOIS_KATANA_EDGEBALANCEDRANGE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include "katana/GraphTopology.h"
+#include "katana/Loops.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The nodes of a topology split into tiles of about the same amount of
+/// work, for node-parallel loops over graphs with skewed degrees. Loops over
+/// katana::iterate(graph) split nodes into chunks of the same number of
+/// nodes, so even with katana::steal() the threads that get the chunks of
+/// high degree nodes do most of the work.
+///
+/// A tile is a range of nodes whose edges and nodes together make about
+/// tile_size items, found with binary searches over the edge offsets of the
+/// topology; counting nodes too keeps ranges of nodes without edges from
+/// becoming one tile. Tiles are scheduled with katana::steal() one at a time.
+///
+/// With split_hubs, a tile ends after exactly tile_size items even within the
+/// edges of a node, so the edges of a high degree node (hub) are spread over
+/// several tiles, which may run concurrently; see ForEachEdgeRange.
+///
+/// Replacing
+///
+///   katana::do_all(katana::iterate(topo), fn, katana::steal());
+///
+/// with
+///
+///   katana::EdgeBalancedRange::Make(topo).ForEachNode(topo, fn);
+///
+/// gives a loop the same amount of work per tile.
+class EdgeBalancedRange {
+public:
+  using Node = GraphTopologyTypes::Node;
+  using Edge = GraphTopologyTypes::Edge;
+
+  /// The number of nodes and edges of a tile by default
+  static constexpr uint64_t kDefaultTileSize = 1024;
+
+  EdgeBalancedRange() = default;
+
+  /// Split the nodes of topo into tiles of about tile_size nodes and edges;
+  /// if split_hubs, the edges of a node may be split among tiles
+  template <typename Topo>
+  static EdgeBalancedRange Make(
+      const Topo& topo, uint64_t tile_size = kDefaultTileSize,
+      bool split_hubs = false) {
+    EdgeBalancedRange range;
+    if (topo.num_nodes() == 0) {
+      return range;
+    }
+    // In the sequence of nodes each followed by its edges, node n is item
+    // n + EdgeBegin(n) and its edge e is item n + e + 1
+    const uint64_t num_items = topo.num_nodes() + topo.num_edges();
+    tile_size = std::max<uint64_t>(tile_size, 1);
+    const size_t num_tiles = (num_items + tile_size - 1) / tile_size;
+    auto item_of = [&](Node n) {
+      return n == topo.num_nodes() ? num_items : n + EdgeBegin(topo, n);
+    };
+
+    std::vector<Tile> tiles(num_tiles);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_tiles),
+        [&](size_t i) {
+          // the first node that is not before item i * tile_size
+          Node begin = *std::partition_point(
+              boost::counting_iterator<Node>(0),
+              boost::counting_iterator<Node>(topo.num_nodes()),
+              [&](Node n) { return item_of(n) < i * tile_size; });
+          Tile& tile = tiles[i];
+          tile.first = begin;
+          tile.begin = begin;
+          tile.item_begin = i * tile_size;
+          if (!split_hubs) {
+            return;
+          }
+          // the node before begin continues into the tile if its edges do
+          if (begin > 0 && item_of(begin - 1) + topo.degree(begin - 1) >=
+                               tile.item_begin) {
+            tile.first = begin - 1;
+          }
+        },
+        katana::no_stats());
+
+    for (size_t i = 0; i < num_tiles; ++i) {
+      bool last = i + 1 == num_tiles;
+      tiles[i].end = last ? topo.num_nodes() : tiles[i + 1].begin;
+      if (!split_hubs) {
+        // tiles end at the first edge of a node
+        tiles[i].item_begin = item_of(tiles[i].begin);
+      }
+    }
+    for (size_t i = 0; i < num_tiles; ++i) {
+      bool last = i + 1 == num_tiles;
+      tiles[i].item_end = last ? num_items : tiles[i + 1].item_begin;
+      if (tiles[i].first != tiles[i].end) {
+        range.tiles_.emplace_back(tiles[i]);
+      }
+    }
+    return range;
+  }
+
+  size_t num_tiles() const { return tiles_.size(); }
+
+  /// Call fn(n) for every node n of topo, which this was made from, in
+  /// parallel by tile. args are further arguments of katana::do_all, e.g.,
+  /// katana::loopname.
+  template <typename Topo, typename F, typename... Args>
+  void ForEachNode(const Topo&, const F& fn, const Args&... args) const {
+    katana::do_all(
+        katana::iterate(tiles_),
+        [&](const Tile& tile) {
+          for (Node n = tile.begin; n < tile.end; ++n) {
+            fn(n);
+          }
+        },
+        args..., katana::steal(), katana::chunk_size<1>());
+  }
+
+  /// Call fn(n, begin, end) for the edges [begin, end) of every node n of
+  /// topo in a tile, in parallel by tile. A node without edges is called
+  /// with an empty range once. If made with split_hubs, the edges of a node
+  /// may be split among several calls, which may be concurrent, so fn must
+  /// not assume it sees every edge of n.
+  template <typename Topo, typename F, typename... Args>
+  void ForEachEdgeRange(
+      const Topo& topo, const F& fn, const Args&... args) const {
+    katana::do_all(
+        katana::iterate(tiles_),
+        [&](const Tile& tile) {
+          for (Node n = tile.first; n < tile.end; ++n) {
+            // edge e of n is item n + e + 1
+            Edge begin = EdgeBegin(topo, n);
+            Edge end = begin + topo.degree(n);
+            if (tile.item_begin > n + begin + 1) {
+              begin = tile.item_begin - n - 1;
+            }
+            if (tile.item_end < n + end + 1) {
+              end = tile.item_end - n - 1;
+            }
+            fn(n, begin, std::max(begin, end));
+          }
+        },
+        args..., katana::steal(), katana::chunk_size<1>());
+  }
+
+private:
+  struct Tile {
+    /// nodes [first, end) have edges in the tile, and the tile owns nodes
+    /// [begin, end); first is begin - 1 if a split node continues into it
+    Node first;
+    Node begin;
+    Node end;
+    /// the tile is the items [item_begin, item_end) of the sequence of nodes
+    /// each followed by its edges
+    uint64_t item_begin;
+    uint64_t item_end;
+  };
+
+  template <typename Topo>
+  static Edge EdgeBegin(const Topo& topo, Node n) {
+    return *topo.edges(n).begin();
+  }
+
+  std::vector<Tile> tiles_;
+};
+
+}  // namespace katana
+
+#endif
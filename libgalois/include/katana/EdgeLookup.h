@@ -0,0 +1,249 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EDGELOOKUP_H_
+#define KATANA_LIBGALOIS_KATANA_EDGELOOKUP_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/GraphTopology.h"
+#include "katana/HubAdjacency.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Batched edge queries: for many (src, dst) pairs at once, an edge from src
+/// to dst, e.g., to check the candidate pairs of link prediction. The
+/// topology must have the edges of each node sorted by destination, e.g., a
+/// view of PropertyGraphViews::EdgesSortedByDestID or a graph after
+/// SortAllEdgesByDest.
+///
+/// A batch is sorted by source and then destination, so the queries of a
+/// source are answered together: each search of its edges starts where the
+/// last one ended and gallops forward, and its edges are read once per block
+/// of queries rather than once per query. Blocks are answered in parallel.
+///
+/// The highest degree nodes (hubs) get a hash table from destination to edge
+/// next to the topology, so a query of a hub is one probe instead of a
+/// search of its long edge list. A hub takes 2 to 4 entries of 16 bytes per
+/// edge; HubAdjacency is smaller when only existence is asked of hubs.
+class EdgeLookup {
+public:
+  using Node = GraphTopologyTypes::Node;
+  using Edge = GraphTopologyTypes::Edge;
+  using Query = std::pair<Node, Node>;
+
+  /// The answer to a query of a pair without an edge
+  static constexpr Edge kNotFound = std::numeric_limits<Edge>::max();
+  static constexpr size_t kDefaultMinHubDegree = 1024;
+
+  EdgeLookup() = default;
+
+  /// Make hash tables for the num_hubs nodes of topo of highest out-degree
+  /// among those of degree at least min_hub_degree; see
+  /// HubAdjacency::ChooseHubs
+  template <typename Topo>
+  static EdgeLookup Make(
+      const Topo& topo, size_t num_hubs,
+      size_t min_hub_degree = kDefaultMinHubDegree) {
+    EdgeLookup lookup;
+    std::vector<Node> hubs =
+        HubAdjacency::ChooseHubs(topo, num_hubs, min_hub_degree);
+    if (hubs.empty()) {
+      return lookup;
+    }
+
+    lookup.hub_index_.allocateInterleaved(topo.num_nodes());
+    katana::do_all(
+        katana::iterate(size_t{0}, topo.num_nodes()),
+        [&](size_t n) { lookup.hub_index_[n] = kNotHub; },
+        katana::no_stats());
+
+    // tables of a power of two of at least twice the degree of their hub,
+    // so probes are short
+    lookup.tables_.resize(hubs.size() + 1);
+    for (size_t i = 0; i < hubs.size(); ++i) {
+      lookup.hub_index_[hubs[i]] = i;
+      uint64_t size = 1;
+      while (size < 2 * topo.degree(hubs[i])) {
+        size *= 2;
+      }
+      lookup.tables_[i + 1] = lookup.tables_[i] + size;
+    }
+
+    lookup.entries_.allocateInterleaved(lookup.tables_.back());
+    katana::do_all(
+        katana::iterate(size_t{0}, hubs.size()),
+        [&](size_t i) {
+          Entry* table = &lookup.entries_[lookup.tables_[i]];
+          uint64_t mask = lookup.tables_[i + 1] - lookup.tables_[i] - 1;
+          std::fill(table, table + mask + 1, Entry{kNoNode, kNotFound});
+          for (auto e : topo.edges(hubs[i])) {
+            Node dst = topo.edge_dest(e);
+            uint64_t slot = Hash(dst) & mask;
+            while (table[slot].dst != kNoNode && table[slot].dst != dst) {
+              slot = (slot + 1) & mask;
+            }
+            // the first of parallel edges, as for nodes that are not hubs
+            if (table[slot].dst == kNoNode) {
+              table[slot] = Entry{dst, e};
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    lookup.hubs_ = std::move(hubs);
+    return lookup;
+  }
+
+  /// the hubs by decreasing degree
+  const std::vector<Node>& hubs() const { return hubs_; }
+
+  size_t num_hubs() const { return hubs_.size(); }
+
+  bool is_hub(Node n) const {
+    return !hub_index_.empty() && hub_index_[n] != kNotHub;
+  }
+
+  /// \returns the bytes of the hash tables
+  size_t size_bytes() const { return entries_.size() * sizeof(Entry); }
+
+  /// \returns the first edge from src to dst in topo, which this was made
+  /// from, or kNotFound
+  template <typename Topo>
+  Edge FindEdge(const Topo& topo, Node src, Node dst) const {
+    if (is_hub(src)) {
+      return ProbeHub(src, dst);
+    }
+    Edge last = *topo.edges(src).end();
+    Edge e = LowerBound(topo, *topo.edges(src).begin(), last, dst);
+    return e != last && topo.edge_dest(e) == dst ? e : kNotFound;
+  }
+
+  /// Set (*edges)[i] to FindEdge(topo, queries[i].first, queries[i].second)
+  template <typename Topo>
+  void FindEdges(
+      const Topo& topo, const std::vector<Query>& queries,
+      std::vector<Edge>* edges) const {
+    edges->resize(queries.size());
+    ForEachAnswer(topo, queries, [&](uint64_t i, Edge e) { (*edges)[i] = e; });
+  }
+
+  /// \returns the queries that have an edge, a bit per query
+  template <typename Topo>
+  DynamicBitset HasEdges(
+      const Topo& topo, const std::vector<Query>& queries) const {
+    DynamicBitset found;
+    found.resize(queries.size());
+    ForEachAnswer(topo, queries, [&](uint64_t i, Edge e) {
+      if (e != kNotFound) {
+        found.set(i);
+      }
+    });
+    return found;
+  }
+
+private:
+  static constexpr uint32_t kNotHub = std::numeric_limits<uint32_t>::max();
+  static constexpr Node kNoNode = std::numeric_limits<Node>::max();
+  /// queries answered by a task, in order of source
+  static constexpr size_t kBlockSize = 1024;
+
+  struct Entry {
+    Node dst;
+    Edge edge;
+  };
+
+  static uint64_t Hash(Node n) {
+    return (uint64_t{n} * UINT64_C(0x9E3779B97F4A7C15)) >> 32;
+  }
+
+  Edge ProbeHub(Node hub, Node dst) const {
+    uint64_t begin = tables_[hub_index_[hub]];
+    uint64_t mask = tables_[hub_index_[hub] + 1] - begin - 1;
+    const Entry* table = &entries_[begin];
+    for (uint64_t slot = Hash(dst) & mask; table[slot].dst != kNoNode;
+         slot = (slot + 1) & mask) {
+      if (table[slot].dst == dst) {
+        return table[slot].edge;
+      }
+    }
+    return kNotFound;
+  }
+
+  /// \returns the first edge of [first, last) whose destination is not less
+  /// than dst, searching forward with doubling steps from first
+  template <typename Topo>
+  static Edge LowerBound(const Topo& topo, Edge first, Edge last, Node dst) {
+    Edge step = 1;
+    while (first + step < last && topo.edge_dest(first + step) < dst) {
+      first += step;
+      step *= 2;
+    }
+    last = std::min(last, first + step + 1);
+    while (first < last) {
+      Edge mid = first + (last - first) / 2;
+      if (topo.edge_dest(mid) < dst) {
+        first = mid + 1;
+      } else {
+        last = mid;
+      }
+    }
+    return first;
+  }
+
+  /// Call answer(i, e) with the answer e to every query i, in parallel
+  template <typename Topo, typename Answer>
+  void ForEachAnswer(
+      const Topo& topo, const std::vector<Query>& queries,
+      const Answer& answer) const {
+    std::vector<uint64_t> order(queries.size());
+    katana::ParallelSTL::iota(order.begin(), order.end(), uint64_t{0});
+    katana::ParallelSTL::sort(
+        order.begin(), order.end(),
+        [&](uint64_t a, uint64_t b) { return queries[a] < queries[b]; });
+
+    const size_t num_blocks = (queries.size() + kBlockSize - 1) / kBlockSize;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_blocks),
+        [&](size_t block) {
+          size_t end = std::min(queries.size(), (block + 1) * kBlockSize);
+          Node src = kNoNode;
+          Edge cursor = 0;
+          Edge last = 0;
+          for (size_t i = block * kBlockSize; i < end; ++i) {
+            const auto& [query_src, dst] = queries[order[i]];
+            if (is_hub(query_src)) {
+              answer(order[i], ProbeHub(query_src, dst));
+              continue;
+            }
+            if (query_src != src) {
+              src = query_src;
+              cursor = *topo.edges(src).begin();
+              last = *topo.edges(src).end();
+            }
+            cursor = LowerBound(topo, cursor, last, dst);
+            answer(
+                order[i], cursor != last && topo.edge_dest(cursor) == dst
+                              ? cursor
+                              : kNotFound);
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  std::vector<Node> hubs_;
+  katana::NUMAArray<uint32_t> hub_index_;
+  /// the hash table of hub i is entries_[tables_[i], tables_[i + 1])
+  std::vector<uint64_t> tables_;
+  katana::NUMAArray<Entry> entries_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ENTITYTYPEINDEX_H_
+#define KATANA_LIBGALOIS_KATANA_ENTITYTYPEINDEX_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/NUMAArray.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// An index of the entities (nodes or edges) of each entity type, built from
+/// the most specific type of every entity.
+///
+/// Each atomic type has a bitset of the entities that have the type, so
+/// testing whether an entity has an atomic type is a single bit lookup. The
+/// number of entities of every entity type, atomic or not, is precomputed.
+class KATANA_EXPORT EntityTypeIndex {
+public:
+  EntityTypeIndex() = default;
+  EntityTypeIndex(EntityTypeIndex&&) = default;
+  EntityTypeIndex& operator=(EntityTypeIndex&&) = default;
+
+  EntityTypeIndex(const EntityTypeIndex&) = delete;
+  EntityTypeIndex& operator=(const EntityTypeIndex&) = delete;
+
+  /// Build the index of \param entity_types, the most specific type of each
+  /// entity, whose types are defined by \param manager
+  static EntityTypeIndex Make(
+      const EntityTypeManager& manager,
+      const NUMAArray<EntityTypeID>& entity_types) noexcept;
+
+  /// \returns the bitset of the entities that have the atomic type
+  /// \param entity_type_id, or null if the type is not atomic or unknown to
+  /// the index
+  const DynamicBitset* GetAtomicTypeBitset(
+      EntityTypeID entity_type_id) const noexcept {
+    if (entity_type_id >= atomic_type_bitsets_.size() ||
+        atomic_type_bitsets_[entity_type_id].size() == 0) {
+      return nullptr;
+    }
+    return &atomic_type_bitsets_[entity_type_id];
+  }
+
+  /// \returns the number of entities that have the type \param entity_type_id
+  /// (need not be the most specific type)
+  uint64_t GetNumEntitiesOfType(EntityTypeID entity_type_id) const noexcept {
+    return entity_type_id < num_entities_of_type_.size()
+               ? num_entities_of_type_[entity_type_id]
+               : 0;
+  }
+
+  /// \returns the ids of the entities that have the type \param
+  /// entity_type_id in ascending order, e.g., to iterate over them with
+  /// do_all. Types that are not atomic intersect the bitsets of their atomic
+  /// types.
+  template <typename Id>
+  std::vector<Id> GetEntitiesOfType(EntityTypeID entity_type_id) const;
+
+private:
+  /// indexed by EntityTypeID; empty for types that are not atomic
+  std::vector<DynamicBitset> atomic_type_bitsets_;
+  /// indexed by EntityTypeID
+  std::vector<uint64_t> num_entities_of_type_;
+  /// the atomic types of each entity type, indexed by EntityTypeID
+  std::vector<std::vector<EntityTypeID>> atomic_types_;
+  uint64_t num_entities_{0};
+};
+
+}  // namespace katana
+
+#endif
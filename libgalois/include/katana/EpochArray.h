@@ -0,0 +1,65 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EPOCHARRAY_H_
+#define KATANA_LIBGALOIS_KATANA_EPOCHARRAY_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace katana {
+
+/// An array whose elements can all be reset to a default value in constant
+/// time. Each element carries the epoch in which it was last set; an element
+/// of an older epoch reads as the default value, so Reset only starts a new
+/// epoch rather than writing every element.
+///
+/// Elements may be set concurrently as long as no two threads access the
+/// same element. Reset and Resize may not run concurrently with other
+/// operations.
+template <typename T>
+class EpochArray {
+public:
+  EpochArray() = default;
+  explicit EpochArray(size_t size, T default_value = T{}) {
+    Resize(size, default_value);
+  }
+
+  /// Resize to size elements that all read as default_value
+  void Resize(size_t size, T default_value = T{}) {
+    stamps_.assign(size, 0);
+    values_.resize(size);
+    epoch_ = 1;
+    default_value_ = default_value;
+  }
+
+  /// Make every element read as default_value
+  void Reset(T default_value = T{}) {
+    if (++epoch_ == 0) {
+      std::fill(stamps_.begin(), stamps_.end(), 0);
+      epoch_ = 1;
+    }
+    default_value_ = default_value;
+  }
+
+  bool IsSet(size_t i) const { return stamps_[i] == epoch_; }
+
+  const T& Get(size_t i) const {
+    return IsSet(i) ? values_[i] : default_value_;
+  }
+
+  void Set(size_t i, const T& value) {
+    stamps_[i] = epoch_;
+    values_[i] = value;
+  }
+
+  size_t size() const { return stamps_.size(); }
+
+private:
+  std::vector<uint32_t> stamps_;
+  std::vector<T> values_;
+  uint32_t epoch_{1};
+  T default_value_{};
+};
+
+}  // namespace katana
+
+#endif
@@ -20,9 +20,15 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORDOALL_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORDOALL_H_
 
+#include <iterator>
+#include <optional>
+#include <type_traits>
+
 #include "katana/Barrier.h"
 #include "katana/CompilerSpecific.h"
 #include "katana/Executor_OnEach.h"
+#include "katana/LoopStatistics.h"
+#include "katana/NestedParallel.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/PaddedLock.h"
 #include "katana/PerThreadStorage.h"
@@ -49,6 +55,10 @@ class DoAllStealingExec {
   constexpr static const bool MORE_STATS =
       NEED_STATS && has_trait<more_stats_tag, ArgsTuple>();
   constexpr static const bool USE_TERM = false;
+  constexpr static const bool SOCKET_ONLY =
+      has_trait<socket_steal_tag, ArgsTuple>();
+  constexpr static const bool HIERARCHICAL =
+      has_trait<hierarchical_steal_tag, ArgsTuple>();
 
   struct ThreadContext {
     alignas(KATANA_CACHE_LINE_SIZE) SimpleLock work_mutex;
@@ -80,7 +90,9 @@ class DoAllStealingExec {
           m_size(std::distance(beg, end)),
           num_iter(0) {}
 
-    bool doWork(F func, const unsigned chunk_size) {
+    bool doWork(
+        F func, const unsigned chunk_size,
+        const CancellationToken* cancellation) {
       Iter beg(shared_beg);
       Iter end(shared_end);
 
@@ -89,6 +101,11 @@ class DoAllStealingExec {
       while (getWork(beg, end, chunk_size)) {
         didwork = true;
 
+        if (katana::internal::IsCancelled(cancellation)) {
+          dropWork();
+          break;
+        }
+
         for (; beg != end; ++beg) {
           if (NEED_STATS) {
             ++num_iter;
@@ -119,6 +136,13 @@ class DoAllStealingExec {
     }
 
   private:
+    void dropWork() {
+      work_mutex.lock();
+      shared_beg = shared_end;
+      m_size = 0;
+      work_mutex.unlock();
+    }
+
     bool getWork(Iter& priv_beg, Iter& priv_end, const unsigned chunk_size) {
       bool succ = false;
 
@@ -259,6 +283,35 @@ private:
     return succ;
   }
 
+  KATANA_ATTRIBUTE_NOINLINE bool stealWithinCore(ThreadContext& poor) {
+    bool sawWork = false;
+    bool stoleWork = false;
+
+    auto& tp = GetThreadPool();
+
+    const unsigned maxT = katana::getActiveThreads();
+    const unsigned my_core = ThreadPool::getCore();
+
+    for (unsigned i = 1; i < maxT; ++i) {
+      // go around the threads in circle starting from the next thread
+      unsigned t = (poor.id + i) % maxT;
+
+      if (tp.getCore(t) == my_core) {
+        if (workers.getRemote(t)->hasWorkWeak()) {
+          sawWork = true;
+
+          stoleWork = transferWork(*workers.getRemote(t), poor, HALF);
+
+          if (stoleWork) {
+            break;
+          }
+        }
+      }
+    }
+
+    return sawWork || stoleWork;
+  }
+
   KATANA_ATTRIBUTE_NOINLINE bool stealWithinSocket(ThreadContext& poor) {
     bool sawWork = false;
     bool stoleWork = false;
@@ -326,10 +379,18 @@ private:
   KATANA_ATTRIBUTE_NOINLINE bool trySteal(ThreadContext& poor) {
     bool ret = false;
 
+    if (HIERARCHICAL) {
+      ret = stealWithinCore(poor);
+
+      if (ret) {
+        return true;
+      }
+    }
+
     ret = stealWithinSocket(poor);
 
-    if (ret) {
-      return true;
+    if (ret || SOCKET_ONLY) {
+      return ret;
     }
 
     asmPause();
@@ -357,9 +418,11 @@ private:
   F func;
   const char* loopname;
   Diff_ty chunk_size;
+  const CancellationToken* cancellation;
   PerThreadStorage<ThreadContext> workers;
 
   TerminationDetection& term;
+  NestedLoopHelpers& helpers;
 
   // for stats
   PerThreadTimer<MORE_STATS> totalTime;
@@ -367,20 +430,28 @@ private:
   PerThreadTimer<MORE_STATS> execTime;
   PerThreadTimer<MORE_STATS> stealTime;
   PerThreadTimer<MORE_STATS> termTime;
+  std::optional<StatHandle> iterations;
 
 public:
-  DoAllStealingExec(const R& _range, F _func, const ArgsTuple& argsTuple)
+  DoAllStealingExec(
+      const R& _range, F _func, const ArgsTuple& argsTuple,
+      NestedLoopHelpers& _helpers)
       : range(_range),
         func(_func),
         loopname(katana::internal::getLoopName(argsTuple)),
         chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
+        cancellation(katana::internal::getCancellation(argsTuple)),
         term(GetTerminationDetection(activeThreads)),
+        helpers(_helpers),
         totalTime(loopname, "Total"),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute"),
         stealTime(loopname, "Steal"),
         termTime(loopname, "Term") {
     KATANA_LOG_DEBUG_ASSERT(chunk_size > 0);
+    if (NEED_STATS) {
+      iterations.emplace(loopname, "Iterations");
+    }
   }
 
   // parallel call
@@ -411,6 +482,8 @@ public:
 
   void operator()(void) {
     ThreadContext& ctx = *workers.getLocal();
+    LoopCounters<NEED_STATS> counters(loopname);
+    NestedLoopScope nested;
     totalTime.start();
 
     while (true) {
@@ -418,7 +491,7 @@ public:
 
       execTime.start();
 
-      if (ctx.doWork(func, chunk_size)) {
+      if (ctx.doWork(func, chunk_size, cancellation)) {
         workHappened = true;
       }
 
@@ -426,6 +499,11 @@ public:
 
       KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
 
+      // the other threads drop their own work
+      if (katana::internal::IsCancelled(cancellation)) {
+        break;
+      }
+
       stealTime.start();
       bool stole = trySteal(ctx);
       stealTime.stop();
@@ -451,11 +529,13 @@ public:
       }
     }
 
+    helpers.FinishAndHelp();
+
     totalTime.stop();
     KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
 
     if (NEED_STATS) {
-      katana::ReportStatSum(loopname, "Iterations", ctx.num_iter);
+      iterations->Add(ctx.num_iter);
     }
   }
 };
@@ -464,9 +544,10 @@ template <bool _STEAL>
 struct ChooseDoAllImpl {
   template <typename R, typename F, typename ArgsT>
   static void call(const R& range, F&& func, const ArgsT& argsTuple) {
+    NestedLoopHelpers helpers(activeThreads);
     internal::DoAllStealingExec<
         R, OperatorReferenceType<decltype(std::forward<F>(func))>, ArgsT>
-        exec(range, std::forward<F>(func), argsTuple);
+        exec(range, std::forward<F>(func), argsTuple, helpers);
 
     Barrier& barrier = GetBarrier(activeThreads);
 
@@ -480,15 +561,25 @@ template <>
 struct ChooseDoAllImpl<false> {
   template <typename R, typename F, typename ArgsT>
   static void call(const R& range, F func, const ArgsT& argsTuple) {
-    on_each_gen(
-        [&](const unsigned int, const unsigned int) {
-          static constexpr bool NEED_STATS =
-              katana::internal::NeedStats<ArgsT>::value;
-          static constexpr bool MORE_STATS =
-              NEED_STATS && has_trait<more_stats_tag, ArgsT>();
+    static constexpr bool NEED_STATS =
+        katana::internal::NeedStats<ArgsT>::value;
+    static constexpr bool MORE_STATS =
+        NEED_STATS && has_trait<more_stats_tag, ArgsT>();
+
+    const char* const loopname = katana::internal::getLoopName(argsTuple);
 
-          const char* const loopname = katana::internal::getLoopName(argsTuple);
+    // registered here so that threads report without looking up names
+    std::optional<StatHandle> iterations;
+    if (NEED_STATS) {
+      iterations.emplace(loopname, "Iterations");
+    }
 
+    NestedLoopHelpers helpers(activeThreads);
+
+    on_each_gen(
+        [&](const unsigned int, const unsigned int) {
+          LoopCounters<NEED_STATS> counters(loopname);
+          NestedLoopScope nested;
           PerThreadTimer<MORE_STATS> totalTime(loopname, "Total");
           PerThreadTimer<MORE_STATS> initTime(loopname, "Init");
           PerThreadTimer<MORE_STATS> execTime(loopname, "Work");
@@ -499,6 +590,12 @@ struct ChooseDoAllImpl<false> {
           auto begin = range.local_begin();
           const auto end = range.local_end();
 
+          const CancellationToken* cancellation =
+              katana::internal::getCancellation(argsTuple);
+          const size_t chunk_size =
+              get_trait_value<chunk_size_tag>(argsTuple).value;
+          size_t until_check = 0;
+
           initTime.stop();
 
           execTime.start();
@@ -506,6 +603,12 @@ struct ChooseDoAllImpl<false> {
           size_t iter = 0;
 
           while (begin != end) {
+            if (cancellation && until_check-- == 0) {
+              if (cancellation->IsCancelled()) {
+                break;
+              }
+              until_check = chunk_size - 1;
+            }
             func(*begin++);
             if (NEED_STATS) {
               ++iter;
@@ -513,16 +616,69 @@ struct ChooseDoAllImpl<false> {
           }
           execTime.stop();
 
+          helpers.FinishAndHelp();
+
           totalTime.stop();
 
           if (NEED_STATS) {
-            katana::ReportStatSum(loopname, "Iterations", iter);
+            iterations->Add(iter);
           }
         },
         std::make_tuple());
   }
 };
 
+/// Runs a do_all called from the operator of another do_all. Other threads
+/// of the outer do_all can run chunks of ranges longer than the chunk size;
+/// the rest run serially, as do loops nested more deeply. Statistics of
+/// nested loops are not reported.
+template <typename R, typename F, typename ArgsT>
+void
+DoAllNested(const R& range, F& func, const ArgsT& argsTuple) {
+  using Iter = decltype(range.begin());
+  constexpr bool kRandomAccess = std::is_base_of_v<
+      std::random_access_iterator_tag,
+      typename std::iterator_traits<Iter>::iterator_category>;
+
+  const CancellationToken* cancellation =
+      katana::internal::getCancellation(argsTuple);
+  const size_t chunk_size = get_trait_value<chunk_size_tag>(argsTuple).value;
+  Iter begin = range.begin();
+  const Iter end = range.end();
+
+  if constexpr (kRandomAccess) {
+    size_t size = std::distance(begin, end);
+    if (size > chunk_size && ForkNestedLoops()) {
+      struct State {
+        Iter begin;
+        F& func;
+      } state{begin, func};
+      NestedTask task(
+          &state,
+          [](void* s, size_t chunk_begin, size_t chunk_end) {
+            auto* st = static_cast<State*>(s);
+            for (size_t i = chunk_begin; i < chunk_end; ++i) {
+              st->func(*(st->begin + i));
+            }
+          },
+          size, chunk_size, cancellation);
+      RunNestedTask(&task);
+      return;
+    }
+  }
+
+  size_t until_check = 0;
+  while (begin != end) {
+    if (cancellation && until_check-- == 0) {
+      if (cancellation->IsCancelled()) {
+        break;
+      }
+      until_check = chunk_size - 1;
+    }
+    func(*begin++);
+  }
+}
+
 }  // end namespace internal
 
 template <typename R, typename F, typename ArgsTuple>
@@ -539,14 +695,22 @@ do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
 
   using ArgsT = decltype(argsT);
 
+  OperatorReferenceType<decltype(std::forward<F>(func))> func_ref = func;
+
+  if (internal::InDoAllOperator()) {
+    internal::DoAllNested(range, func_ref, argsT);
+    return;
+  }
+
   constexpr bool TIME_IT = has_trait<loopname_tag, ArgsT>();
   CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(argsT));
 
   timer.start();
 
-  constexpr bool STEAL = has_trait<steal_tag, ArgsT>();
+  constexpr bool STEAL = has_trait<steal_tag, ArgsT>() ||
+                        has_trait<socket_steal_tag, ArgsT>() ||
+                        has_trait<hierarchical_steal_tag, ArgsT>();
 
-  OperatorReferenceType<decltype(std::forward<F>(func))> func_ref = func;
   internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
 
   timer.stop();
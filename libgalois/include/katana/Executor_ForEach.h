@@ -122,6 +122,12 @@ public:
 
   value_type& value(Item& item) const { return item.val; }
   value_type& value(value_type& val) const { return val; }
+  const value_type& value(const Item& item) const { return item.val; }
+  const value_type& value(const value_type& val) const { return val; }
+
+  //! \returns how often an item has been aborted
+  int retries(const Item& item) const { return item.retries; }
+  int retries(const value_type&) const { return 0; }
 
   void push(const value_type& val) {
     Item item = {val, 1};
@@ -150,6 +156,9 @@ public:
       !has_trait<disable_conflict_detection_tag, ArgsTy>();
   static constexpr bool needsPia = has_trait<per_iter_alloc_tag, ArgsTy>();
   static constexpr bool needsBreak = has_trait<parallel_break_tag, ArgsTy>();
+  static constexpr bool needsCancel = has_trait<cancellation_tag, ArgsTy>();
+  //! whether the loop may stop before the worklist is empty
+  static constexpr bool canStop = needsBreak || needsCancel;
   static constexpr bool MORE_STATS =
       needStats && has_trait<more_stats_tag, ArgsTy>();
 
@@ -165,10 +174,13 @@ protected:
   };
 
   using LoopStat = LoopStatistics<needStats>;
+  using ConflictStats = ConflictStatistics<needStats && needsAborts>;
 
   struct ThreadLocalData : public ThreadLocalBasics, public LoopStat {
+    ConflictStats conflictStats;
+
     ThreadLocalData(FunctionTy fn, const char* ln)
-        : ThreadLocalBasics(fn), LoopStat(ln) {}
+        : ThreadLocalBasics(fn), LoopStat(ln), conflictStats(ln) {}
   };
 
   // RunQueueState factors out state within runQueue iterations to protect it
@@ -189,6 +201,7 @@ protected:
   WorkListTy wl;
   FunctionTy origFunction;
   const char* loopname;
+  const CancellationToken* cancellation;
   bool broke;
 
   PerThreadTimer<MORE_STATS> initTime;
@@ -219,6 +232,8 @@ protected:
     KATANA_LOG_DEBUG_ASSERT(needsAborts);
     tld.ctx.cancelIteration();
     tld.inc_conflicts();
+    tld.conflictStats.OnConflict(
+        tld.ctx.takeConflictLock(), aborted.value(item));
     aborted.push(item);
     // clear push buffer
     if (needsPush)
@@ -254,6 +269,7 @@ protected:
       while ((!limit || s.num < limit) && (s.item = lwl.pop())) {
         ++s.num;
         doProcess(aborted.value(*s.item), tld);
+        tld.conflictStats.OnCommit(aborted.retries(*s.item));
       }
     } else {
       clearConflictLock();
@@ -264,6 +280,7 @@ protected:
       while ((!limit || s.num < limit) && (s.item = lwl.pop())) {
         ++s.num;
         doProcess(aborted.value(*s.item), tld);
+        tld.conflictStats.OnCommit(aborted.retries(*s.item));
       }
     } catch (ConflictFlag const& flag) {
       clearConflictLock();
@@ -316,8 +333,8 @@ protected:
         bool didWork = false;
 
         // Run some iterations
-        if (couldAbort || needsBreak) {
-          constexpr int __NUM = (needsBreak || isLeader) ? 64 : 0;
+        if (couldAbort || canStop) {
+          constexpr int __NUM = (canStop || isLeader) ? 64 : 0;
           bool b = runQueue<__NUM>(tld, wl);
           didWork = b || didWork;
           // Check for abort
@@ -325,6 +342,9 @@ protected:
             b = handleAborts(tld);
             didWork = b || didWork;
           }
+          if (needsCancel && katana::internal::IsCancelled(cancellation)) {
+            broke = true;
+          }
         } else {  // No try/catch
           bool b = runQueueSimple(tld);
           didWork = b || didWork;
@@ -333,14 +353,14 @@ protected:
         // Update node color and prop token
         term.SignalWorked(didWork);
         asmPause();  // Let token propagate
-      } while (term.Working() && (!needsBreak || !broke));
+      } while (term.Working() && (!canStop || !broke));
 
       if (checkEmpty(wl, tld, 0)) {
         execTime.stop();
         break;
       }
 
-      if (needsBreak && broke) {
+      if (canStop && broke) {
         execTime.stop();
         break;
       }
@@ -363,6 +383,7 @@ protected:
         wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f),
         loopname(katana::internal::getLoopName(args)),
+        cancellation(katana::internal::getCancellation(args)),
         broke(false),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute") {}
@@ -177,6 +177,15 @@ private:
 
   void fromFileInterleaved(const std::string& filename, size_t sizeofEdgeData);
 
+  /**
+   * mmap the entire file into memory like fromFile.
+   *
+   * @param filename Graph file to load
+   * @param populate if true, read the whole file in now (MAP_POPULATE);
+   * otherwise, pages are read when first touched
+   */
+  void mapFile(const std::string& filename, bool populate);
+
   /**
    * Page in a portion of the loaded graph data based based on division of labor
    * by nodes.
@@ -621,9 +630,29 @@ public:
       const std::string& filename, NodeRange nrange, EdgeRange erange,
       bool numaMap = false);
 
+  /**
+   * Loads/mmaps part "part" of "numParts" parts of a graph, e.g., the part
+   * of one host of a distributed job, like partFromFile. The parts are
+   * contiguous ranges of nodes balanced by their number of edges. Only the
+   * header and the edge indices needed to find the range are read from the
+   * rest of the file.
+   *
+   * @param filename File to load
+   * @param part Part to load, in [0, numParts)
+   * @param numParts Number of parts to divide the graph into
+   * @param numaMap if true, does interleaved numa allocation for data
+   * structures
+   */
+  void partFromFile(
+      const std::string& filename, size_t part, size_t numParts,
+      bool numaMap = false);
+
   /**
    * Reads graph connectivity information from file. Tries to balance memory
-   * evenly across system.  Cannot be called during parallel execution.
+   * evenly across system: each active thread reads in the part of the file
+   * which it will later construct with divideByNode, so that the file is
+   * read in parallel and its pages are placed on the NUMA node of the thread
+   * which uses them. Cannot be called during parallel execution.
    *
    * Edge data version.
    */
@@ -0,0 +1,56 @@
+#ifndef KATANA_LIBGALOIS_KATANA_FINGERPRINT_H_
+#define KATANA_LIBGALOIS_KATANA_FINGERPRINT_H_
+
+#include <cstdint>
+#include <functional>
+
+#include <arrow/api.h>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Fingerprints are 64-bit hashes of graph data. Graphs with different
+/// fingerprints differ, so comparing fingerprints, e.g., of a graph before it
+/// is stored and after it is loaded, or of graphs in different processes,
+/// is a cheap check that avoids a full comparison in the common case.
+/// Graphs with the same fingerprint are very likely but not certainly equal.
+
+/// The number of items hashed by each task of FingerprintBlocks
+constexpr uint64_t kFingerprintBlockSize = uint64_t{1} << 16;
+
+/// Mix value into the fingerprint hash
+inline uint64_t
+FingerprintCombine(uint64_t hash, uint64_t value) {
+  // finalizer of MurmurHash3 applied to the combination of Boost
+  hash ^= value + UINT64_C(0x9e3779b97f4a7c15) + (hash << 6) + (hash >> 2);
+  hash ^= hash >> 33;
+  hash *= UINT64_C(0xff51afd7ed558ccd);
+  hash ^= hash >> 33;
+  hash *= UINT64_C(0xc4ceb9fe1a85ec53);
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/// The fingerprint of num_items items, of which each block of
+/// kFingerprintBlockSize items is hashed in parallel by
+/// hash_block(begin, end, seed). The blocks do not depend on the number of
+/// threads, so neither does the fingerprint.
+KATANA_EXPORT uint64_t FingerprintBlocks(
+    uint64_t num_items,
+    const std::function<uint64_t(uint64_t begin, uint64_t end, uint64_t seed)>&
+        hash_block);
+
+/// The fingerprint of the type and values of array. It does not depend on
+/// how the array is split into chunks, like arrow::ChunkedArray::Equals.
+KATANA_EXPORT Result<uint64_t> Fingerprint(const arrow::ChunkedArray& array);
+
+/// The fingerprint of the names, types and values of the columns of table.
+/// It does not depend on the order of the columns, like
+/// PropertyGraph::Equals.
+KATANA_EXPORT Result<uint64_t> Fingerprint(const arrow::Table& table);
+
+}  // namespace katana
+
+#endif
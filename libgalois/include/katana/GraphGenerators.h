@@ -0,0 +1,83 @@
+#ifndef KATANA_LIBGALOIS_KATANA_GRAPHGENERATORS_H_
+#define KATANA_LIBGALOIS_KATANA_GRAPHGENERATORS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/GraphTopology.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Synthetic graphs for benchmarking at scale. Topologies are generated and
+/// stored as CSR in parallel, without edge lists, and the edges of each node
+/// are sorted by destination. Every generator draws its numbers from the
+/// streams of katana::MakeStreamGenerator, so the same seed gives the same
+/// graph for any number of threads.
+
+/// A recursive matrix (R-MAT) graph (Chakrabarti et al., "R-MAT: A Recursive
+/// Model for Graph Mining", SDM 2004): each edge falls in a quadrant of the
+/// adjacency matrix with probability a, b, c or 1 - a - b - c, recursively,
+/// which gives a skewed, social-network-like degree distribution. The
+/// defaults are the Kronecker graphs of Graph500.
+struct RMATParams {
+  /// the graph has 2^scale nodes
+  uint32_t scale{20};
+  /// and edge_factor * 2^scale edges
+  uint32_t edge_factor{16};
+  double a{0.57};
+  double b{0.19};
+  double c{0.19};
+  /// renumber the nodes randomly so that ids do not correlate with degrees,
+  /// as Graph500 does
+  bool permute{true};
+  /// drop self loops and repeated edges, which leaves fewer edges
+  bool remove_duplicates{false};
+};
+
+KATANA_EXPORT Result<GraphTopology> GenerateRMAT(
+    const RMATParams& params, uint64_t seed);
+
+/// A stochastic block model: the nodes are split into num_blocks blocks of
+/// consecutive ids of about the same size, and there is an edge from a node
+/// to each other node of its block with probability p_in and to each node of
+/// another block with probability p_out, which gives graphs with planted
+/// communities. Destinations are drawn with replacement and repeated ones
+/// are dropped, so degrees are slightly lower than expected for dense blocks.
+struct SBMParams {
+  uint32_t num_nodes{1 << 20};
+  uint32_t num_blocks{64};
+  double p_in{0.001};
+  double p_out{0.00001};
+};
+
+KATANA_EXPORT Result<GraphTopology> GenerateSBM(
+    const SBMParams& params, uint64_t seed);
+
+/// A random geometric graph: the nodes are points of the unit square and
+/// each pair of nodes closer than the radius that gives avg_degree is
+/// connected in both directions. Like road networks, the graph is planar-ish
+/// with low degrees and a large diameter, and nodes are numbered along a
+/// grid so that neighbors have close ids.
+struct RandomGeometricParams {
+  uint32_t num_nodes{1 << 20};
+  double avg_degree{4};
+};
+
+KATANA_EXPORT Result<GraphTopology> GenerateRandomGeometric(
+    const RandomGeometricParams& params, uint64_t seed);
+
+/// A table of num_columns columns named prefix0, prefix1, ... of num_rows
+/// random values each: int64 values uniform in [1, 100], e.g., edge weights,
+/// or double values uniform in [0, 1).
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> GenerateRandomProperties(
+    uint64_t num_rows, int num_columns, const std::string& prefix,
+    const std::shared_ptr<arrow::DataType>& type, uint64_t seed);
+
+}  // namespace katana
+
+#endif
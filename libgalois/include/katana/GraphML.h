@@ -19,6 +19,28 @@ KATANA_EXPORT katana::Result<katana::GraphComponents> ConvertGraphML(
     const std::string& infilename, size_t chunk_size = 25000,
     bool verbose = false);
 
+/// ConvertGraphMLParallel converts a GraphML file into katana form like
+/// ConvertGraphML, but parses it with all active threads. The file is read in
+/// windows of window_size bytes, each cut at node and edge elements into a
+/// chunk per thread, so only a window of the file is in memory at a time
+/// besides the graph being built. Each chunk is parsed into a shard of a
+/// ShardedPropertyGraphBuilder, so nodes and edges keep the order of the file.
+///
+/// The file must be UTF-8 and must not have node or edge start tags in
+/// comments or CDATA sections, which would be taken for element boundaries.
+///
+/// \param infilename Path to source graphml file
+/// \param window_size Number of bytes of the file to parse at a time. An
+///     element larger than this grows its window to fit.
+/// \param chunk_size Length of the Arrow arrays of the result
+/// \param verbose If true, print graph data to the standard out while
+///     converting.
+/// \returns A collection of Arrow tables of node properties/labels, edge
+///     properties/types, and CSR topology
+KATANA_EXPORT katana::Result<katana::GraphComponents> ConvertGraphMLParallel(
+    const std::string& infilename, size_t window_size = 64 << 20,
+    size_t chunk_size = 25000, bool verbose = false);
+
 }  // end namespace katana
 
 #endif
@@ -1,6 +1,14 @@
 #ifndef KATANA_LIBGALOIS_KATANA_GRAPHTOPOLOGY_H_
 #define KATANA_LIBGALOIS_KATANA_GRAPHTOPOLOGY_H_
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -8,6 +16,10 @@
 
 #include "katana/Iterators.h"
 #include "katana/NUMAArray.h"
+#include "katana/Prefetch.h"
+#include "katana/Range.h"
+#include "katana/Result.h"
+#include "katana/TopologyStatistics.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -40,6 +52,7 @@ struct KATANA_EXPORT GraphTopologyTypes {
 
 class KATANA_EXPORT EdgeShuffleTopology;
 class KATANA_EXPORT EdgeTypeAwareTopology;
+class KATANA_EXPORT PGViewCache;
 
 /// A graph topology represents the adjacency information for a graph in CSR
 /// format.
@@ -61,11 +74,86 @@ public:
 
   static GraphTopology Copy(const GraphTopology& that) noexcept;
 
-  uint64_t num_nodes() const noexcept { return adj_indices_.size(); }
+  /// A topology that refers to the arrays of \param that and shares their
+  /// storage if it is out of core, and a Copy of it otherwise
+  static GraphTopology ShareOrCopy(const GraphTopology& that) noexcept;
+
+  /// Move the arrays of \param that into shared storage and refer to them,
+  /// so that ShareOrCopy shares the topology returned instead of copying it.
+  /// Topologies that are out of core are returned as they are.
+  static GraphTopology MakeShareable(GraphTopology&& that) noexcept;
+
+  /// Refer to topology arrays in memory owned by \param storage, e.g., a
+  /// mapping of a topology file, instead of copying them. The arrays must
+  /// not change while the topology exists.
+  static GraphTopology MakeOutOfCore(
+      const Edge* adj_indices, size_t num_nodes, const Node* dests,
+      size_t num_edges, std::shared_ptr<const void> storage) noexcept;
+
+  /// true if this topology refers to memory it does not own; see
+  /// MakeOutOfCore and MakeShareable
+  bool is_out_of_core() const noexcept { return storage_ != nullptr; }
+
+  enum class AccessPattern { kNormal, kSequential, kRandom };
+
+  /// Hint how an out-of-core topology will be read so that its pages are
+  /// read ahead (or not) accordingly. Does nothing for topologies in memory.
+  void AdviseAccess(AccessPattern pattern) const noexcept;
+
+  /// Start reading the edges of nodes [begin, end) of an out-of-core
+  /// topology in the background, e.g., for the next tile of a traversal.
+  /// Does nothing for topologies in memory.
+  void PrefetchEdges(Node begin, Node end) const noexcept;
+
+  /// Store edge offsets as 32-bit values if the number of edges fits,
+  /// halving the offset array read by every edges() lookup. Topologies
+  /// loaded from storage are compacted unless KATANA_COMPACT_TOPOLOGY is set
+  /// to false. Does nothing for out-of-core topologies.
+  void Compact() noexcept;
+
+  /// true if edge offsets are stored as 32-bit values; see Compact.
+  /// adj_data() is not available for compact topologies; use
+  /// compact_adj_data() instead.
+  bool is_compact() const noexcept { return !compact_adj_indices_.empty(); }
+
+  /// Copy the topology arrays so that each thread owns a contiguous range of
+  /// nodes with about the same number of edges, and the pages of those nodes
+  /// and of their edges are on the socket of the thread. Loops over
+  /// local_nodes() with katana::socket_steal() then keep each thread on the
+  /// memory of its socket. Topologies loaded from storage are partitioned if
+  /// KATANA_NUMA_TOPOLOGY is set to true. Does nothing for out-of-core
+  /// topologies.
+  void PartitionForNUMA() noexcept;
+
+  /// true if PartitionForNUMA placed the topology arrays
+  bool is_numa_partitioned() const noexcept { return !thread_ranges_.empty(); }
+
+  /// The first node of each thread followed by num_nodes(), as used by
+  /// PartitionForNUMA, or empty if the topology is not partitioned
+  const std::vector<uint32_t>& thread_ranges() const noexcept {
+    return thread_ranges_;
+  }
+
+  /// All nodes, split among threads by thread_ranges() if the topology is
+  /// partitioned for the current number of threads and by an even split of
+  /// nodes and edges otherwise
+  SpecificRange<node_iterator> local_nodes() const noexcept;
+
+  uint64_t num_nodes() const noexcept {
+    return is_compact() ? compact_adj_indices_.size() : adj_indices_.size();
+  }
 
   uint64_t num_edges() const noexcept { return dests_.size(); }
 
-  const Edge* adj_data() const noexcept { return adj_indices_.data(); }
+  const Edge* adj_data() const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(!is_compact());
+    return adj_indices_.data();
+  }
+
+  const uint32_t* compact_adj_data() const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(is_compact() || num_nodes() == 0);
+    return compact_adj_indices_.data();
+  }
 
   const Node* dest_data() const noexcept { return dests_.data(); }
 
@@ -84,15 +172,36 @@ public:
       return false;
     }
 
-    return adj_indices_ == that.adj_indices_ && dests_ == that.dests_;
+    if (is_compact() != that.is_compact()) {
+      return EqualAdjIndices(that) && dests_ == that.dests_;
+    }
+
+    return adj_indices_ == that.adj_indices_ &&
+           compact_adj_indices_ == that.compact_adj_indices_ &&
+           dests_ == that.dests_;
   }
 
+  /// Checks in parallel that the edge offsets do not decrease and end at
+  /// num_edges(), and that every destination is a node
+  /// @returns an error that names the first node or edge that is wrong
+  Result<void> Validate() const;
+
+  /// A hash of the edge offsets and destinations, computed in parallel,
+  /// which does not depend on whether the topology is compact; see
+  /// katana::Fingerprint
+  uint64_t Fingerprint() const noexcept;
+
   /// Gets the edge range of some node.
   ///
   /// \param node node to get the edge range of
   /// \returns iterable edge range for node.
   edges_range edges(Node node) const noexcept {
-    KATANA_LOG_DEBUG_ASSERT(node <= adj_indices_.size());
+    KATANA_LOG_DEBUG_ASSERT(node <= num_nodes());
+    if (is_compact()) {
+      edge_iterator e_beg{node > 0 ? compact_adj_indices_[node - 1] : 0};
+      edge_iterator e_end{compact_adj_indices_[node]};
+      return MakeStandardRange(e_beg, e_end);
+    }
     edge_iterator e_beg{node > 0 ? adj_indices_[node - 1] : 0};
     edge_iterator e_end{adj_indices_[node]};
 
@@ -104,6 +213,18 @@ public:
     return dests_[edge_id];
   }
 
+  /// Call fn(e, dst) for the edges e of node with their destinations dst,
+  /// and prefetch(dst') before each with the destination dst' of the edge
+  /// distance edges ahead; see katana::ForEachEdgePrefetched
+  template <typename Fn, typename Prefetch>
+  void ForEachEdgePrefetched(
+      Node node, const Fn& fn, const Prefetch& prefetch,
+      size_t distance = kDefaultPrefetchDistance) const {
+    auto range = edges(node);
+    katana::ForEachEdgePrefetched(
+        *range.begin(), *range.end(), dest_data(), fn, prefetch, distance);
+  }
+
   nodes_range nodes(Node begin, Node end) const noexcept {
     return MakeStandardRange<node_iterator>(begin, end);
   }
@@ -145,12 +266,30 @@ private:
   friend class EdgeShuffleTopology;
   friend class EdgeTypeAwareTopology;
 
-  NUMAArray<Edge>& GetAdjIndices() noexcept { return adj_indices_; }
+  /// Widens the edge offsets of a compact topology
+  NUMAArray<Edge>& GetAdjIndices() noexcept;
   NUMAArray<Node>& GetDests() noexcept { return dests_; }
 
+  bool EqualAdjIndices(const GraphTopology& that) const noexcept;
+
+  /// Split the nodes among the active threads so that each thread gets about
+  /// the same number of nodes and edges
+  std::vector<uint32_t> ComputeThreadRanges() const noexcept;
+
+  /// A topology that refers to the arrays of \param that, which are owned by
+  /// \param storage
+  static GraphTopology Share(
+      const GraphTopology& that, std::shared_ptr<const void> storage) noexcept;
+
 private:
   NUMAArray<Edge> adj_indices_;
+  /// replaces adj_indices_ in a compact topology
+  NUMAArray<uint32_t> compact_adj_indices_;
   NUMAArray<Node> dests_;
+  /// set by PartitionForNUMA
+  std::vector<uint32_t> thread_ranges_;
+  /// owner of the arrays of an out-of-core topology
+  std::shared_ptr<const void> storage_;
 };
 
 // TODO(amber): In the future, when we group properties e.g., by node or edge type,
@@ -176,6 +315,13 @@ public:
     kSortedByNodeType
   };
 
+  /// How MakeTransposeCopy builds the transpose
+  enum class TransposeAlgorithm : int {
+    kAuto = 0,  // kRadix if its scratch memory is available, else kLowMemory
+    kRadix,
+    kLowMemory
+  };
+
   bool is_transposed() const noexcept {
     return has_transpose_state(TransposeKind::kYes);
   }
@@ -203,8 +349,28 @@ public:
     return edge_prop_indices_[eid];
   }
 
+  /// the edge_property_index() of all edges, indexed by edge id
+  const PropertyIndex* edge_property_index_data() const noexcept {
+    return edge_prop_indices_.data();
+  }
+
+  /// \returns the transpose of the topology of pg. The in-edges of each
+  /// node are ordered by the id of the edge they transpose, so the result
+  /// does not depend on the number of threads.
+  ///
+  /// kRadix splits the sources into chunks of about the same number of
+  /// edges and the destinations into blocks whose counters fit in cache.
+  /// Each chunk counts its edges per block, then scatters them to its
+  /// slice of each block, and each block is finally sorted by destination
+  /// with a counting sort. No atomics are needed and every pass writes to
+  /// few places at a time. It needs scratch memory for the largest block.
+  ///
+  /// kLowMemory needs only a counter per node beyond the transpose: edges
+  /// are scattered by atomic increments of the counters, then the in-edges
+  /// of each node are sorted in place.
   static std::unique_ptr<EdgeShuffleTopology> MakeTransposeCopy(
-      const PropertyGraph* pg);
+      const PropertyGraph* pg,
+      TransposeAlgorithm algo = TransposeAlgorithm::kAuto);
   static std::unique_ptr<EdgeShuffleTopology> MakeOriginalCopy(
       const PropertyGraph* pg);
 
@@ -238,6 +404,10 @@ protected:
 
   void SortEdgesByTypeThenDest(const PropertyGraph* pg) noexcept;
 
+  /// Sort the edges of \param node as SortEdgesByTypeThenDest does
+  void SortNodeEdgesByTypeThenDest(
+      const PropertyGraph* pg, Node node) noexcept;
+
   void SortEdgesByDestType(
       const PropertyGraph* pg, const PropIndexVec& node_prop_indices) noexcept;
 
@@ -274,6 +444,9 @@ protected:
   }
 
 private:
+  // reads and writes the arrays of topologies stored with the RDG
+  friend class PGViewCache;
+
   bool is_valid_ = true;
   TransposeKind tpose_state_ = TransposeKind::kNo;
   EdgeSortKind edge_sort_state_ = EdgeSortKind::kAny;
@@ -294,6 +467,10 @@ public:
     kAny = 0,
     kSortedByDegree,
     kSortedByNodeType,
+    /// locality-improving orders; see katana/NodeOrdering.h
+    kReverseCuthillMcKee,
+    kGorder,
+    kRabbitOrder,
   };
 
   PropertyIndex node_property_index(const Node& nid) const noexcept {
@@ -317,6 +494,13 @@ public:
   static std::unique_ptr<ShuffleTopology> MakeSortedByNodeType(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
 
+  /// Renumber the nodes of \param seed_topo in the locality-improving order
+  /// \param node_sort_todo, one of kReverseCuthillMcKee, kGorder or
+  /// kRabbitOrder
+  static std::unique_ptr<ShuffleTopology> MakeReordered(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo,
+      const NodeSortKind& node_sort_todo) noexcept;
+
   static std::unique_ptr<ShuffleTopology> MakeFromTopo(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo,
       const NodeSortKind& node_sort_todo,
@@ -333,6 +517,11 @@ public:
     case NodeSortKind::kSortedByNodeType:
       ret = MakeSortedByNodeType(pg, seed_topo);
       break;
+    case NodeSortKind::kReverseCuthillMcKee:
+    case NodeSortKind::kGorder:
+    case NodeSortKind::kRabbitOrder:
+      ret = MakeReordered(pg, seed_topo, node_sort_todo);
+      break;
     default:
       KATANA_LOG_FATAL("switch case fell through");
     }
@@ -358,61 +547,16 @@ private:
         node_prop_indices.begin(), node_prop_indices.end(),
         [&](const auto& i1, const auto& i2) { return cmp(i1, i2); });
 
-    GraphTopology::AdjIndexVec degrees;
-    degrees.allocateInterleaved(seed_topo.num_nodes());
-
-    katana::NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
-    old_to_new_map.allocateInterleaved(seed_topo.num_nodes());
-    // TODO(amber): given 32-bit node ids, put a check here that
-    // node_prop_indices.size() < 2^32
-    katana::do_all(
-        katana::iterate(size_t{0}, node_prop_indices.size()),
-        [&](auto i) {
-          // node_prop_indices[i] gives old node id
-          old_to_new_map[node_prop_indices[i]] = i;
-          degrees[i] = seed_topo.degree(node_prop_indices[i]);
-        },
-        katana::no_stats());
-
-    KATANA_LOG_DEBUG_ASSERT(std::is_sorted(degrees.begin(), degrees.end()));
-
-    katana::ParallelSTL::partial_sum(
-        degrees.begin(), degrees.end(), degrees.begin());
-
-    GraphTopologyTypes::EdgeDestVec new_dest_vec;
-    new_dest_vec.allocateInterleaved(seed_topo.num_edges());
-
-    GraphTopologyTypes::PropIndexVec edge_prop_indices;
-    edge_prop_indices.allocateInterleaved(seed_topo.num_edges());
-
-    katana::do_all(
-        katana::iterate(seed_topo.all_nodes()),
-        [&](auto old_srd_id) {
-          auto new_srd_id = old_to_new_map[old_srd_id];
-          auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
-
-          for (auto e : seed_topo.edges(old_srd_id)) {
-            auto new_edge_dest = old_to_new_map[seed_topo.edge_dest(e)];
-
-            auto new_edge_id = new_out_index;
-            ++new_out_index;
-            KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
-
-            new_dest_vec[new_edge_id] = new_edge_dest;
-
-            // copy over edge_property_index mapping from old edge to new edge
-            edge_prop_indices[new_edge_id] = seed_topo.edge_property_index(e);
-          }
-        },
-        katana::steal(), katana::no_stats());
-
-    return std::make_unique<ShuffleTopology>(ShuffleTopology{
-        seed_topo.transpose_state(), node_sort_todo,
-        seed_topo.edge_sort_state(), std::move(degrees),
-        std::move(node_prop_indices), std::move(new_dest_vec),
-        std::move(edge_prop_indices)});
+    return MakeFromNodeOrder(
+        seed_topo, std::move(node_prop_indices), node_sort_todo);
   }
 
+  /// Renumber the nodes of \param seed_topo so that node i of the result is
+  /// node node_prop_indices[i] of seed_topo, see \param node_prop_indices
+  static std::unique_ptr<ShuffleTopology> MakeFromNodeOrder(
+      const EdgeShuffleTopology& seed_topo, PropIndexVec&& node_prop_indices,
+      const NodeSortKind& node_sort_todo) noexcept;
+
   ShuffleTopology(
       const TransposeKind& tpose_todo, const NodeSortKind& node_sort_todo,
       const EdgeSortKind& edge_sort_todo, AdjIndexVec&& adj_indices,
@@ -428,6 +572,9 @@ private:
     KATANA_LOG_DEBUG_ASSERT(node_prop_indices_.size() == num_nodes());
   }
 
+  // reads and writes the arrays of topologies stored with the RDG
+  friend class PGViewCache;
+
   NodeSortKind node_sort_state_ = NodeSortKind::kAny;
 
   // TODO(amber): In the future, we may need to keep a copy of node_type_ids in
@@ -522,6 +669,18 @@ public:
 
   auto edge_dest(Edge eid) const noexcept { return topo().edge_dest(eid); }
 
+  /// the destinations of all edges, indexed by edge id; the destinations of
+  /// the edges of a node are contiguous
+  const Node* dest_data() const noexcept { return topo().dest_data(); }
+
+  /// \see GraphTopology::ForEachEdgePrefetched
+  template <typename Fn, typename Prefetch>
+  void ForEachEdgePrefetched(
+      Node node, const Fn& fn, const Prefetch& prefetch,
+      size_t distance = kDefaultPrefetchDistance) const {
+    topo().ForEachEdgePrefetched(node, fn, prefetch, distance);
+  }
+
   /// @param node node to get degree for
   /// @returns Degree of node N
   auto degree(Node node) const noexcept { return topo().degree(node); }
@@ -579,10 +738,25 @@ struct EdgeDestComparator {
 
 /// store adjacency indices per each node such that they are divided by edge edge_type type.
 /// Requires sorting the graph by edge edge_type type
+///
+/// The index is dense, an entry per node and edge type, when that is small;
+/// otherwise it is sparse: a directory of the runs of edges of the same type
+/// of each node, which is searched for the type. Graphs with many edge types
+/// most nodes have no edges of get the sparse index, which takes space in
+/// proportion to the edges rather than to the nodes times the types.
 class KATANA_EXPORT EdgeTypeAwareTopology
     : public BasicTopologyWrapper<EdgeShuffleTopology> {
   using Base = BasicTopologyWrapper<EdgeShuffleTopology>;
 
+  /// The runs of the edges of a node with the same type: the runs of node N
+  /// are [node_runs[N - 1], node_runs[N]), and run r holds the edges of type
+  /// index run_types[r] up to run_ends[r]
+  struct SparseTypeIndex {
+    AdjIndexVec node_runs;
+    NUMAArray<uint32_t> run_types;
+    AdjIndexVec run_ends;
+  };
+
 public:
   EdgeTypeAwareTopology(EdgeTypeAwareTopology&&) = default;
   EdgeTypeAwareTopology& operator=(EdgeTypeAwareTopology&&) = default;
@@ -602,6 +776,9 @@ public:
     // P == edge_type_index_->num_unique_types()
     // We pick the prefix sum based on the index of the edge_type provided
     KATANA_LOG_DEBUG_ASSERT(edge_type_index_->num_unique_types() > 0);
+    if (is_sparse()) {
+      return SparseEdges(N, edge_type_index_->GetIndex(edge_type));
+    }
     auto beg_idx = (N * edge_type_index_->num_unique_types()) +
                    edge_type_index_->GetIndex(edge_type);
     edge_iterator e_beg{
@@ -742,34 +919,92 @@ public:
     const_cast<EdgeShuffleTopology*>(edge_shuff_topo_)->invalidate();
   }
 
+  /// true if the per type index is the sparse run directory
+  bool is_sparse() const noexcept { return sparse_; }
+
+  /// @returns the size in bytes of the per type index
+  size_t type_index_bytes() const noexcept {
+    if (is_sparse()) {
+      return sparse_index_.node_runs.size() * sizeof(Edge) +
+             sparse_index_.run_types.size() * sizeof(uint32_t) +
+             sparse_index_.run_ends.size() * sizeof(Edge);
+    }
+    return per_type_adj_indices_.size() * sizeof(Edge);
+  }
+
 private:
+  edges_range SparseEdges(Node N, uint32_t type_index) const noexcept {
+    uint64_t runs_begin = (N == 0) ? 0 : sparse_index_.node_runs[N - 1];
+    uint64_t runs_end = sparse_index_.node_runs[N];
+    const uint32_t* types = sparse_index_.run_types.data();
+    const uint32_t* run =
+        std::lower_bound(types + runs_begin, types + runs_end, type_index);
+    uint64_t r = run - types;
+    if (r == runs_end || *run != type_index) {
+      auto e_end = Base::edges(N).end();
+      return katana::MakeStandardRange(e_end, e_end);
+    }
+    edge_iterator e_beg{
+        (r == runs_begin) ? *Base::edges(N).begin()
+                          : sparse_index_.run_ends[r - 1]};
+    edge_iterator e_end{sparse_index_.run_ends[r]};
+    return katana::MakeStandardRange(e_beg, e_end);
+  }
+
+  /// Build the dense or the sparse per type index, whichever is smaller
+  /// by enough to matter, into \param dense or \param sparse
+  /// @returns true if the index is sparse
+  static bool BuildTypeIndex(
+      const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
+      const EdgeShuffleTopology* topo, AdjIndexVec* dense,
+      SparseTypeIndex* sparse) noexcept;
+
+  static SparseTypeIndex CreateSparseTypeIndex(
+      const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
+      const EdgeShuffleTopology* topo, AdjIndexVec&& node_runs) noexcept;
+
   // Must invoke SortAllEdgesByDataThenDst() before
   // calling this function
   static AdjIndexVec CreatePerEdgeTypeAdjacencyIndex(
       const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
       const EdgeShuffleTopology* topo) noexcept;
 
+  /// Fill the entries of \param adj_indices for node \param N
+  static void FillPerEdgeTypeAdjacencyIndex(
+      const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
+      const EdgeShuffleTopology* topo, Node N,
+      AdjIndexVec* adj_indices) noexcept;
+
+  // patches per_type_adj_indices_ when edge types change
+  friend class PGViewCache;
+
   EdgeTypeAwareTopology(
       const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
-      const EdgeShuffleTopology* e_topo,
-      AdjIndexVec&& per_type_adj_indices) noexcept
+      const EdgeShuffleTopology* e_topo, AdjIndexVec&& per_type_adj_indices,
+      bool sparse, SparseTypeIndex&& sparse_index) noexcept
       :
 
         Base(e_topo),
         edge_type_index_(edge_type_index),
         edge_shuff_topo_(e_topo),
-        per_type_adj_indices_(std::move(per_type_adj_indices)) {
+        per_type_adj_indices_(std::move(per_type_adj_indices)),
+        sparse_(sparse),
+        sparse_index_(std::move(sparse_index)) {
     KATANA_LOG_ASSERT(pg);
     KATANA_LOG_DEBUG_ASSERT(edge_type_index);
 
     KATANA_LOG_DEBUG_ASSERT(
+        sparse_ ||
         per_type_adj_indices_.size() ==
-        edge_shuff_topo_->num_nodes() * edge_type_index_->num_unique_types());
+            edge_shuff_topo_->num_nodes() *
+                edge_type_index_->num_unique_types());
   }
 
   const CondensedTypeIDMap* edge_type_index_;
   const EdgeShuffleTopology* edge_shuff_topo_;
   AdjIndexVec per_type_adj_indices_;
+  bool sparse_{false};
+  SparseTypeIndex sparse_index_;
 };
 
 template <typename OutTopo, typename InTopo>
@@ -801,6 +1036,16 @@ public:
     return in().edge_dest(edge_id);
   }
 
+  /// GraphTopology::ForEachEdgePrefetched over the in edges of node, e.g.,
+  /// for pull-style kernels
+  template <typename Fn, typename Prefetch>
+  void ForEachInEdgePrefetched(
+      const GraphTopologyTypes::Node& node, const Fn& fn,
+      const Prefetch& prefetch,
+      size_t distance = kDefaultPrefetchDistance) const {
+    in().ForEachEdgePrefetched(node, fn, prefetch, distance);
+  }
+
   auto in_edge_property_index(
       const GraphTopologyTypes::Edge& eid) const noexcept {
     return in().edge_property_index(eid);
@@ -847,6 +1092,26 @@ using EdgesSortedByDestTopology = SortedTopologyWrapper<EdgeShuffleTopology>;
 using NodesSortedByDegreeEdgesSortedByDestIDTopology =
     SortedTopologyWrapper<ShuffleTopology>;
 
+/// A ShuffleTopology with its nodes in the locality-improving order
+/// kNodeOrder and its edges sorted by destination. Each order is a distinct
+/// type so that each has its own PGViewBuilder.
+template <ShuffleTopology::NodeSortKind kNodeOrder>
+class ReorderedTopology : public SortedTopologyWrapper<ShuffleTopology> {
+  using Base = SortedTopologyWrapper<ShuffleTopology>;
+
+public:
+  explicit ReorderedTopology(const ShuffleTopology* t) noexcept : Base(t) {
+    KATANA_LOG_DEBUG_ASSERT(Base::topo().has_nodes_sorted_by(kNodeOrder));
+  }
+};
+
+using NodesInRCMOrderEdgesSortedByDestIDTopology =
+    ReorderedTopology<ShuffleTopology::NodeSortKind::kReverseCuthillMcKee>;
+using NodesInGorderEdgesSortedByDestIDTopology =
+    ReorderedTopology<ShuffleTopology::NodeSortKind::kGorder>;
+using NodesInRabbitOrderEdgesSortedByDestIDTopology =
+    ReorderedTopology<ShuffleTopology::NodeSortKind::kRabbitOrder>;
+
 class KATANA_EXPORT EdgeTypeAwareBiDirTopology
     : public BasicBiDirTopoWrapper<
           EdgeTypeAwareTopology, EdgeTypeAwareTopology> {
@@ -955,6 +1220,224 @@ public:
   }
 };
 
+/// Iterates over the out edges of a node, then over its in edges. In edges
+/// are numbered after all of the out edges, so that an edge ID tells which
+/// kind of edge it is; see UndirectedTopology.
+class UndirectedEdgeIterator {
+public:
+  using Edge = GraphTopologyTypes::Edge;
+
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = Edge;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Edge*;
+  using reference = Edge;
+
+  UndirectedEdgeIterator() = default;
+  UndirectedEdgeIterator(Edge cur, Edge out_end, Edge in_begin) noexcept
+      : cur_(cur), out_end_(out_end), in_begin_(in_begin) {
+    if (cur_ == out_end_) {
+      cur_ = in_begin_;
+    }
+  }
+
+  Edge operator*() const noexcept { return cur_; }
+
+  UndirectedEdgeIterator& operator++() noexcept {
+    ++cur_;
+    if (cur_ == out_end_) {
+      cur_ = in_begin_;
+    }
+    return *this;
+  }
+
+  UndirectedEdgeIterator operator++(int) noexcept {
+    UndirectedEdgeIterator old = *this;
+    ++*this;
+    return old;
+  }
+
+  bool operator==(const UndirectedEdgeIterator& other) const noexcept {
+    return cur_ == other.cur_;
+  }
+  bool operator!=(const UndirectedEdgeIterator& other) const noexcept {
+    return cur_ != other.cur_;
+  }
+
+private:
+  Edge cur_{0};
+  Edge out_end_{0};
+  Edge in_begin_{0};
+};
+
+/// The undirected form of a directed topology: the edges of a node are its
+/// out edges followed by its in edges, which come from the transpose the
+/// views share, so nothing is copied. Edges [0, num_out_edges()) are the out
+/// edges and the edges from num_out_edges() are the in edges; edge_dest is
+/// the other end of an edge either way. An edge (a, b) is seen from both a
+/// and b, and an edge that is there in both directions is seen twice from
+/// each end.
+template <typename OutTopo, typename InTopo>
+class KATANA_EXPORT UndirectedTopology : public GraphTopologyTypes {
+public:
+  using undirected_edges_range = StandardRange<UndirectedEdgeIterator>;
+
+  UndirectedTopology(const OutTopo* out_topo, const InTopo* in_topo) noexcept
+      : out_topo_(out_topo), in_topo_(in_topo) {
+    KATANA_LOG_DEBUG_ASSERT(out_topo_);
+    KATANA_LOG_DEBUG_ASSERT(in_topo_);
+    KATANA_LOG_DEBUG_ASSERT(in_topo_->is_transposed());
+    KATANA_LOG_DEBUG_ASSERT(out_topo_->num_nodes() == in_topo_->num_nodes());
+    KATANA_LOG_DEBUG_ASSERT(out_topo_->num_edges() == in_topo_->num_edges());
+  }
+
+  auto num_nodes() const noexcept { return out().num_nodes(); }
+
+  /// each directed edge counts twice, once from each end
+  auto num_edges() const noexcept { return 2 * out().num_edges(); }
+
+  Edge num_out_edges() const noexcept { return out().num_edges(); }
+
+  undirected_edges_range edges(Node node) const noexcept {
+    auto out_edges = out().edges(node);
+    auto in_edges = in().edges(node);
+    Edge out_end = *out_edges.end();
+    Edge in_begin = num_out_edges() + *in_edges.begin();
+    Edge in_end = num_out_edges() + *in_edges.end();
+    return MakeStandardRange(
+        UndirectedEdgeIterator{*out_edges.begin(), out_end, in_begin},
+        UndirectedEdgeIterator{in_end, out_end, in_begin});
+  }
+
+  size_t degree(Node node) const noexcept {
+    return out().degree(node) + in().degree(node);
+  }
+
+  bool is_out_edge(Edge eid) const noexcept { return eid < num_out_edges(); }
+
+  Node edge_dest(Edge eid) const noexcept {
+    return is_out_edge(eid) ? out().edge_dest(eid)
+                            : in().edge_dest(eid - num_out_edges());
+  }
+
+  /// The property index of the directed edge that \param eid is one
+  /// direction of
+  PropertyIndex edge_property_index(Edge eid) const noexcept {
+    return is_out_edge(eid) ? out().edge_property_index(eid)
+                            : in().edge_property_index(eid - num_out_edges());
+  }
+
+  auto node_property_index(const Node& nid) const noexcept {
+    return out().node_property_index(nid);
+  }
+
+  auto nodes(Node begin, Node end) const noexcept {
+    return out().nodes(begin, end);
+  }
+
+  auto all_nodes() const noexcept { return out().all_nodes(); }
+
+  // Standard container concepts
+
+  auto begin() const noexcept { return out().begin(); }
+
+  auto end() const noexcept { return out().end(); }
+
+  auto size() const noexcept { return out().size(); }
+
+  auto empty() const noexcept { return out().empty(); }
+
+protected:
+  const OutTopo& out() const noexcept { return *out_topo_; }
+  const InTopo& in() const noexcept { return *in_topo_; }
+
+private:
+  const OutTopo* out_topo_;
+  const InTopo* in_topo_;
+};
+
+using SimpleUndirectedTopology =
+    UndirectedTopology<GraphTopology, EdgeShuffleTopology>;
+
+/// An UndirectedTopology whose out and in edges are both sorted by
+/// destination, so that the distinct neighbors of a node can be merged in
+/// order, as undirected algorithms such as triangle counting need, without
+/// building a symmetric copy of the graph.
+class KATANA_EXPORT SortedUndirectedTopology
+    : public UndirectedTopology<EdgeShuffleTopology, EdgeShuffleTopology> {
+  using Base = UndirectedTopology<EdgeShuffleTopology, EdgeShuffleTopology>;
+
+public:
+  SortedUndirectedTopology(
+      const EdgeShuffleTopology* out_topo,
+      const EdgeShuffleTopology* in_topo) noexcept
+      : Base(out_topo, in_topo) {
+    KATANA_LOG_DEBUG_ASSERT(out().has_edges_sorted_by(
+        EdgeShuffleTopology::EdgeSortKind::kSortedByDestID));
+    KATANA_LOG_DEBUG_ASSERT(in().has_edges_sorted_by(
+        EdgeShuffleTopology::EdgeSortKind::kSortedByDestID));
+  }
+
+  /// Call \param fn on each distinct neighbor of \param node, either end of
+  /// its edges, in ascending order
+  template <typename F>
+  void ForEachUniqueNeighbor(Node node, F fn) const {
+    auto out_edges = out().edges(node);
+    auto in_edges = in().edges(node);
+    auto o = out_edges.begin();
+    auto i = in_edges.begin();
+    bool any = false;
+    Node last = 0;
+    auto visit = [&](Node n) {
+      if (!any || n != last) {
+        fn(n);
+        last = n;
+        any = true;
+      }
+    };
+    while (o != out_edges.end() && i != in_edges.end()) {
+      Node out_dest = out().edge_dest(*o);
+      Node in_dest = in().edge_dest(*i);
+      if (out_dest <= in_dest) {
+        visit(out_dest);
+        ++o;
+      } else {
+        visit(in_dest);
+        ++i;
+      }
+    }
+    for (; o != out_edges.end(); ++o) {
+      visit(out().edge_dest(*o));
+    }
+    for (; i != in_edges.end(); ++i) {
+      visit(in().edge_dest(*i));
+    }
+  }
+
+  /// @returns the number of distinct neighbors of \param node
+  size_t unique_degree(Node node) const {
+    size_t count = 0;
+    ForEachUniqueNeighbor(node, [&](Node) { ++count; });
+    return count;
+  }
+
+  /// @returns true iff there is an edge from \param a to \param b or from
+  /// \param b to \param a
+  bool IsConnected(Node a, Node b) const noexcept {
+    if (out().degree(a) <= in().degree(b)) {
+      if (out().has_edge(a, b)) {
+        return true;
+      }
+    } else if (in().has_edge(b, a)) {
+      return true;
+    }
+    if (in().degree(a) <= out().degree(b)) {
+      return in().has_edge(a, b);
+    }
+    return out().has_edge(b, a);
+  }
+};
+
 template <typename Topo>
 class BasicPropGraphViewWrapper : public Topo {
   using Base = Topo;
@@ -976,8 +1459,17 @@ using PGViewEdgesSortedByDestID =
 using PGViewNodesSortedByDegreeEdgesSortedByDestID =
     BasicPropGraphViewWrapper<NodesSortedByDegreeEdgesSortedByDestIDTopology>;
 using PGViewBiDirectional = BasicPropGraphViewWrapper<SimpleBiDirTopology>;
+using PGViewNodesInRCMOrderEdgesSortedByDestID =
+    BasicPropGraphViewWrapper<NodesInRCMOrderEdgesSortedByDestIDTopology>;
+using PGViewNodesInGorderEdgesSortedByDestID =
+    BasicPropGraphViewWrapper<NodesInGorderEdgesSortedByDestIDTopology>;
+using PGViewNodesInRabbitOrderEdgesSortedByDestID =
+    BasicPropGraphViewWrapper<NodesInRabbitOrderEdgesSortedByDestIDTopology>;
 using PGViewEdgeTypeAwareBiDir =
     BasicPropGraphViewWrapper<EdgeTypeAwareBiDirTopology>;
+using PGViewUndirected = BasicPropGraphViewWrapper<SimpleUndirectedTopology>;
+using PGViewUndirectedEdgesSortedByDestID =
+    BasicPropGraphViewWrapper<SortedUndirectedTopology>;
 
 template <typename PGView>
 struct PGViewBuilder {};
@@ -1026,6 +1518,20 @@ struct PGViewBuilder<PGViewNodesSortedByDegreeEdgesSortedByDestID> {
   }
 };
 
+template <ShuffleTopology::NodeSortKind kNodeOrder>
+struct PGViewBuilder<BasicPropGraphViewWrapper<ReorderedTopology<kNodeOrder>>> {
+  template <typename ViewCache>
+  static BasicPropGraphViewWrapper<ReorderedTopology<kNodeOrder>> BuildView(
+      const PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetShuffTopo(
+        pg, EdgeShuffleTopology::TransposeKind::kNo, kNodeOrder,
+        EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
+
+    return BasicPropGraphViewWrapper<ReorderedTopology<kNodeOrder>>{
+        pg, ReorderedTopology<kNodeOrder>{sorted_topo}};
+  }
+};
+
 template <>
 struct PGViewBuilder<PGViewEdgeTypeAwareBiDir> {
   template <typename ViewCache>
@@ -1041,6 +1547,38 @@ struct PGViewBuilder<PGViewEdgeTypeAwareBiDir> {
   }
 };
 
+template <>
+struct PGViewBuilder<PGViewUndirected> {
+  template <typename ViewCache>
+  static PGViewUndirected BuildView(
+      const PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto tpose_topo = viewCache.BuildOrGetEdgeShuffTopo(
+        pg, EdgeShuffleTopology::TransposeKind::kYes,
+        EdgeShuffleTopology::EdgeSortKind::kAny);
+
+    return PGViewUndirected{
+        pg, SimpleUndirectedTopology{
+                viewCache.GetOriginalTopology(pg), tpose_topo}};
+  }
+};
+
+template <>
+struct PGViewBuilder<PGViewUndirectedEdgesSortedByDestID> {
+  template <typename ViewCache>
+  static PGViewUndirectedEdgesSortedByDestID BuildView(
+      const PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto out_topo = viewCache.BuildOrGetEdgeShuffTopo(
+        pg, EdgeShuffleTopology::TransposeKind::kNo,
+        EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
+    auto in_topo = viewCache.BuildOrGetEdgeShuffTopo(
+        pg, EdgeShuffleTopology::TransposeKind::kYes,
+        EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
+
+    return PGViewUndirectedEdgesSortedByDestID{
+        pg, SortedUndirectedTopology{out_topo, in_topo}};
+  }
+};
+
 }  // end namespace internal
 
 struct PropertyGraphViews {
@@ -1049,6 +1587,15 @@ struct PropertyGraphViews {
   using EdgeTypeAwareBiDir = internal::PGViewEdgeTypeAwareBiDir;
   using NodesSortedByDegreeEdgesSortedByDestID =
       internal::PGViewNodesSortedByDegreeEdgesSortedByDestID;
+  using NodesInRCMOrderEdgesSortedByDestID =
+      internal::PGViewNodesInRCMOrderEdgesSortedByDestID;
+  using NodesInGorderEdgesSortedByDestID =
+      internal::PGViewNodesInGorderEdgesSortedByDestID;
+  using NodesInRabbitOrderEdgesSortedByDestID =
+      internal::PGViewNodesInRabbitOrderEdgesSortedByDestID;
+  using Undirected = internal::PGViewUndirected;
+  using UndirectedEdgesSortedByDestID =
+      internal::PGViewUndirectedEdgesSortedByDestID;
 };
 
 class KATANA_EXPORT PGViewCache {
@@ -1057,6 +1604,13 @@ class KATANA_EXPORT PGViewCache {
   std::vector<std::unique_ptr<EdgeTypeAwareTopology>> edge_type_aware_topos_;
   std::unique_ptr<CondensedTypeIDMap> edge_type_id_map_;
   // TODO(amber): define a node_type_id_map_;
+  std::optional<TopologyStatistics> topology_statistics_;
+  /// guards topology_statistics_, which const accessors of PropertyGraph
+  /// fill; held through a pointer so that the cache stays movable
+  std::unique_ptr<std::mutex> topology_statistics_mutex_{
+      std::make_unique<std::mutex>()};
+  /// keys of the topologies that were read from storage; see Persist
+  std::unordered_set<std::string> loaded_keys_;
 
   template <typename>
   friend struct internal::PGViewBuilder;
@@ -1074,7 +1628,61 @@ public:
     return internal::PGViewBuilder<PGView>::BuildView(pg, *this);
   }
 
+  /// The topology of \param pg with its edges transposed if \param tpose_kind
+  /// is kYes and sorted by \param sort_kind, as shared by the views built
+  /// from it. It is built if needed and owned by this cache.
+  const EdgeShuffleTopology& GetEdgeShuffTopo(
+      const PropertyGraph* pg,
+      const EdgeShuffleTopology::TransposeKind& tpose_kind,
+      const EdgeShuffleTopology::EdgeSortKind& sort_kind) noexcept {
+    return *BuildOrGetEdgeShuffTopo(pg, tpose_kind, sort_kind);
+  }
+
+  /// The statistics of the topology of \param pg, computed on the first call
+  /// and kept until the topology is replaced; see TopologyStatistics. Safe to
+  /// call from several threads at once.
+  const TopologyStatistics& GetTopologyStatistics(
+      const PropertyGraph* pg) noexcept;
+
+  /// Have \param pg store the shuffled topologies built so far with its RDG
+  /// on its next Write or Commit. Later loads of the graph read them back
+  /// instead of building them, as long as the topology and the entity types
+  /// they depend on have not changed. EdgeTypeAwareTopology is not stored;
+  /// it is derived from the stored edges sorted by type in one pass.
+  Result<void> Persist(PropertyGraph* pg) noexcept;
+
+  /// Bring the views built so far up to date after the entity types of \param
+  /// pg changed from \param old_node_types and \param old_edge_types, e.g.,
+  /// because the type properties were replaced. The views depend on the
+  /// topology and the entity types only, so property updates that leave the
+  /// types alone need no call.
+  ///
+  /// Views are patched in place, so views handed out earlier stay usable:
+  /// topologies with edges sorted by type re-sort the edges of the nodes with
+  /// an edge whose type changed, and the per type adjacency indices of
+  /// EdgeTypeAwareTopology are refilled for those nodes. Only when the set of
+  /// distinct edge types changes are the adjacency indices rebuilt entirely.
+  /// Topologies with nodes sorted by type are invalidated if any node type
+  /// changed and built again when next requested.
+  void UpdateEntityTypes(
+      const PropertyGraph* pg,
+      const GraphTopologyTypes::EntityTypeVec& old_node_types,
+      const GraphTopologyTypes::EntityTypeVec& old_edge_types) noexcept;
+
 private:
+  /// \returns the topology stored with the RDG if there is a usable one,
+  /// nullptr otherwise
+  std::unique_ptr<EdgeShuffleTopology> LoadEdgeShuffTopo(
+      const PropertyGraph* pg,
+      const EdgeShuffleTopology::TransposeKind& tpose_kind,
+      const EdgeShuffleTopology::EdgeSortKind& sort_kind) noexcept;
+
+  std::unique_ptr<ShuffleTopology> LoadShuffTopo(
+      const PropertyGraph* pg,
+      const EdgeShuffleTopology::TransposeKind& tpose_kind,
+      const ShuffleTopology::NodeSortKind& node_sort_todo,
+      const EdgeShuffleTopology::EdgeSortKind& edge_sort_todo) noexcept;
+
   const GraphTopology* GetOriginalTopology(
       const PropertyGraph* pg) const noexcept;
 
@@ -31,6 +31,7 @@ struct KATANA_EXPORT ThreadTopoInfo {
   unsigned tid;                  // this thread (galois id)
   unsigned socketLeader;         // first thread id in tid's socket
   unsigned socket;               // socket (L3 normally) of thread
+  unsigned core;                 // physical core of thread; shared by SMT
   unsigned numaNode;             // memory bank.  may be different than socket.
   unsigned cumulativeMaxSocket;  // max socket id seen from [0, tid]
   unsigned osContext;            // OS ID to use for thread binding
@@ -52,6 +53,18 @@ struct KATANA_EXPORT HWTopoInfo {
 /**
  * getHWTopo determines the machine topology from the process information
  * exposed in /proc and /dev filesystems.
+ *
+ * Since probing takes a while, a description made by formatHWTopo may be
+ * given instead: the value of the environment variable KATANA_HWTOPO, or the
+ * file named by KATANA_HWTOPO_CACHE, which is written after probing if it
+ * does not hold a valid description. Descriptions made for another set of
+ * allowed CPUs are ignored.
+ *
+ * Only the CPUs of the cpuset of the process are included, and in containers,
+ * only as many of them as the CPU quota of its cgroup (v1 or v2) lets it use,
+ * so that default thread counts and bindings follow the actual allocation
+ * rather than the host. CPUs on NUMA nodes that the memory policy of the
+ * process does not allow are left out as long as others remain.
  */
 KATANA_EXPORT HWTopoInfo getHWTopo();
 
@@ -61,11 +74,41 @@ KATANA_EXPORT HWTopoInfo getHWTopo();
  */
 KATANA_EXPORT std::vector<int> parseCPUList(const std::string& in);
 
+/**
+ * parseCPUQuota parses a CFS bandwidth limit given as "quota period", the
+ * format of cpu.max in cgroup v2, and returns the number of CPUs it amounts
+ * to, rounded up. It returns 0 if there is no limit, i.e., the quota is
+ * "max" or negative as in cpu.cfs_quota_us of cgroup v1, or in is malformed.
+ */
+KATANA_EXPORT unsigned parseCPUQuota(const std::string& in);
+
+/**
+ * formatHWTopo writes info as text that parseHWTopo reads back. cpus names
+ * the CPUs the description is valid for, e.g., the CPUs the process may run
+ * on, and has no whitespace.
+ */
+KATANA_EXPORT std::string formatHWTopo(
+    const HWTopoInfo& info, const std::string& cpus);
+
+/**
+ * parseHWTopo reads a description made by formatHWTopo into info. It returns
+ * false if in is not one or was made for other cpus. Any whitespace may
+ * separate the fields.
+ */
+KATANA_EXPORT bool parseHWTopo(
+    const std::string& in, const std::string& cpus, HWTopoInfo* info);
+
 /**
  * bindThreadSelf binds a thread to an osContext as returned by getHWTopo.
  */
 KATANA_EXPORT bool bindThreadSelf([[maybe_unused]] unsigned osContext);
 
+/**
+ * bindThreadSelfToSocket binds a thread to all the OS contexts of a socket as
+ * returned by getHWTopo. Threads it creates afterwards inherit the binding.
+ */
+KATANA_EXPORT bool bindThreadSelfToSocket([[maybe_unused]] unsigned socket);
+
 }  // namespace katana
 
 #endif
@@ -0,0 +1,156 @@
+#ifndef KATANA_LIBGALOIS_KATANA_HUBADJACENCY_H_
+#define KATANA_LIBGALOIS_KATANA_HUBADJACENCY_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/SetIntersection.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A hybrid adjacency for power-law graphs: the out-neighbors of the highest
+/// degree nodes (hubs) of a topology are kept as bitmaps next to the CSR of
+/// the topology. Whether a hub has an edge to a node is then one bitmap probe
+/// instead of a search of its long edge list, which is where the random
+/// accesses of edge queries, e.g., in triangle counting, miss the most.
+///
+/// HasEdge hides the split. The edges of a hub are still iterated through
+/// the topology since scanning a bitmap only beats a list of more than
+/// num_nodes / 64 edges. Each hub takes num_nodes / 8 bytes, so the number of
+/// hubs is given explicitly or by a memory budget (NumHubsForBudget).
+class HubAdjacency {
+public:
+  using Node = GraphTopologyTypes::Node;
+
+  HubAdjacency() = default;
+
+  /// Make bitmaps for the num_hubs nodes of topo of highest out-degree, ties
+  /// broken by id, among those of degree at least min_degree
+  template <typename Topo>
+  static HubAdjacency Make(
+      const Topo& topo, size_t num_hubs, size_t min_degree = kBitmapMinSize) {
+    HubAdjacency adjacency;
+    const size_t num_nodes = topo.num_nodes();
+    std::vector<Node> hubs = ChooseHubs(topo, num_hubs, min_degree);
+    if (hubs.empty()) {
+      return adjacency;
+    }
+
+    adjacency.hub_index_.allocateInterleaved(num_nodes);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) { adjacency.hub_index_[n] = kNotHub; },
+        katana::no_stats());
+    for (size_t i = 0; i < hubs.size(); ++i) {
+      adjacency.hub_index_[hubs[i]] = i;
+    }
+
+    adjacency.bitmaps_.resize(hubs.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, hubs.size()),
+        [&](size_t i) {
+          SetBitmap& bitmap = adjacency.bitmaps_[i];
+          bitmap.Resize(num_nodes);
+          for (auto e : topo.edges(hubs[i])) {
+            bitmap.Insert(topo.edge_dest(e));
+          }
+        },
+        katana::steal(), katana::no_stats());
+    adjacency.hubs_ = std::move(hubs);
+    return adjacency;
+  }
+
+  /// \returns the num_hubs nodes of topo of highest out-degree, ties broken
+  /// by id, among those of degree at least min_degree, by decreasing degree
+  template <typename Topo>
+  static std::vector<Node> ChooseHubs(
+      const Topo& topo, size_t num_hubs, size_t min_degree) {
+    if (num_hubs == 0 || topo.num_nodes() == 0) {
+      return {};
+    }
+
+    katana::InsertBag<Node> candidates;
+    katana::do_all(
+        katana::iterate(topo),
+        [&](Node n) {
+          if (topo.degree(n) >= min_degree) {
+            candidates.push(n);
+          }
+        },
+        katana::no_stats());
+    std::vector<Node> hubs(candidates.begin(), candidates.end());
+    auto by_degree = [&](Node a, Node b) {
+      auto da = topo.degree(a);
+      auto db = topo.degree(b);
+      return da > db || (da == db && a < b);
+    };
+    if (hubs.size() > num_hubs) {
+      std::nth_element(
+          hubs.begin(), hubs.begin() + num_hubs, hubs.end(), by_degree);
+      hubs.resize(num_hubs);
+    }
+    std::sort(hubs.begin(), hubs.end(), by_degree);
+
+    return hubs;
+  }
+
+  /// \returns how many hubs of a graph of num_nodes nodes fit in bytes
+  static size_t NumHubsForBudget(size_t num_nodes, size_t bytes) {
+    size_t bytes_per_hub = (num_nodes + 63) / 64 * sizeof(uint64_t);
+    return bytes_per_hub == 0 ? 0 : bytes / bytes_per_hub;
+  }
+
+  /// the hubs by decreasing degree
+  const std::vector<Node>& hubs() const { return hubs_; }
+
+  size_t num_hubs() const { return hubs_.size(); }
+
+  bool is_hub(Node n) const {
+    return !hub_index_.empty() && hub_index_[n] != kNotHub;
+  }
+
+  /// The out-neighbors of hub, e.g., to intersect with other sets
+  const SetBitmap& neighbors(Node hub) const {
+    KATANA_LOG_DEBUG_ASSERT(is_hub(hub));
+    return bitmaps_[hub_index_[hub]];
+  }
+
+  /// \returns whether hub has an edge to dst
+  bool HubHasEdge(Node hub, Node dst) const {
+    return neighbors(hub).Contains(dst);
+  }
+
+  /// \returns whether topo, which this was made from, has an edge from src
+  /// to dst: a probe if src is a hub and a scan of its edges otherwise
+  template <typename Topo>
+  bool HasEdge(const Topo& topo, Node src, Node dst) const {
+    if (is_hub(src)) {
+      return HubHasEdge(src, dst);
+    }
+    for (auto e : topo.edges(src)) {
+      if (topo.edge_dest(e) == dst) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  static constexpr uint32_t kNotHub = std::numeric_limits<uint32_t>::max();
+
+  std::vector<Node> hubs_;
+  katana::NUMAArray<uint32_t> hub_index_;
+  std::vector<SetBitmap> bitmaps_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef KATANA_LIBGALOIS_KATANA_HYPERLOGLOG_H_
+#define KATANA_LIBGALOIS_KATANA_HYPERLOGLOG_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "katana/NUMAArray.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// An array of HyperLogLog counters (Flajolet et al., "HyperLogLog: the
+/// analysis of a near-optimal cardinality estimation algorithm", AofA 2007),
+/// each of which estimates the number of distinct values added to it with a
+/// relative standard error of about 1.04 / sqrt(num_registers).
+///
+/// The registers of a counter are bytes, contiguous and after those of the
+/// previous counter, so the union of two counters is a register-wise maximum
+/// a vector of registers at a time with SIMD instructions if the CPU has
+/// them.
+class KATANA_EXPORT HyperLogLogArray {
+public:
+  /// The fewest and most registers a counter may have
+  static constexpr uint32_t kMinLog2NumRegisters = 4;
+  static constexpr uint32_t kMaxLog2NumRegisters = 16;
+
+  HyperLogLogArray() = default;
+
+  /// Make num_counters empty counters of 2^log2_num_registers registers each,
+  /// which must be between kMinLog2NumRegisters and kMaxLog2NumRegisters
+  HyperLogLogArray(size_t num_counters, uint32_t log2_num_registers);
+
+  size_t num_counters() const { return num_counters_; }
+  size_t num_registers() const { return size_t{1} << log2_num_registers_; }
+
+  /// Add a value, given by a 64-bit hash of it, to counter i
+  void Add(size_t i, uint64_t hash) {
+    uint8_t* registers = counter(i);
+    uint64_t index = hash >> (64 - log2_num_registers_);
+    uint64_t rest = hash << log2_num_registers_;
+    uint8_t rank = rest == 0 ? 65 - log2_num_registers_
+                             : __builtin_clzll(rest) + 1;
+    if (registers[index] < rank) {
+      registers[index] = rank;
+    }
+  }
+
+  /// Make counter i the union of itself and counter j of from, which has as
+  /// many registers
+  /// \returns whether counter i changed
+  bool Merge(size_t i, const HyperLogLogArray& from, size_t j);
+
+  /// Make counter i a copy of counter j of from, which has as many registers
+  void Copy(size_t i, const HyperLogLogArray& from, size_t j);
+
+  /// \returns the number of distinct values added to counter i
+  double Estimate(size_t i) const;
+
+  uint8_t* counter(size_t i) {
+    return registers_.data() + i * num_registers();
+  }
+  const uint8_t* counter(size_t i) const {
+    return registers_.data() + i * num_registers();
+  }
+
+private:
+  size_t num_counters_{0};
+  uint32_t log2_num_registers_{kMinLog2NumRegisters};
+  NUMAArray<uint8_t> registers_;
+};
+
+/// Set to[i] to the larger of to[i] and from[i] for each i < size
+/// \returns whether any of to changed
+KATANA_EXPORT bool MaxMerge(uint8_t* to, const uint8_t* from, size_t size);
+
+}  // namespace katana
+
+#endif
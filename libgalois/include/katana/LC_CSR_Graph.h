@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_LCCSRGRAPH_H_
 
 #include <fstream>
+#include <tuple>
 #include <type_traits>
 
 #include "katana/Details.h"
@@ -48,12 +49,14 @@ namespace katana {
  *
  * @tparam NodeTy data on nodes
  * @tparam EdgeTy data on out edges
+ * @tparam NodeFieldsTy a std::tuple of additional data on nodes, each stored
+ * in an array of its own rather than with NodeTy; see with_node_fields
  */
 //! [doxygennuma]
 template <
     typename NodeTy, typename EdgeTy, bool HasNoLockable = false,
     bool UseNumaAlloc = false, bool HasOutOfLineLockable = false,
-    typename FileEdgeTy = EdgeTy>
+    typename FileEdgeTy = EdgeTy, typename NodeFieldsTy = std::tuple<>>
 class LC_CSR_Graph :
     //! [doxygennuma]
     private internal::LocalIteratorFeature<UseNumaAlloc>,
@@ -72,7 +75,7 @@ public:
   struct with_node_data {
     typedef LC_CSR_Graph<
         _node_data, EdgeTy, HasNoLockable, UseNumaAlloc, HasOutOfLineLockable,
-        FileEdgeTy>
+        FileEdgeTy, NodeFieldsTy>
         type;
   };
 
@@ -80,7 +83,7 @@ public:
   struct with_edge_data {
     typedef LC_CSR_Graph<
         NodeTy, _edge_data, HasNoLockable, UseNumaAlloc, HasOutOfLineLockable,
-        FileEdgeTy>
+        FileEdgeTy, NodeFieldsTy>
         type;
   };
 
@@ -88,7 +91,7 @@ public:
   struct with_file_edge_data {
     typedef LC_CSR_Graph<
         NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc, HasOutOfLineLockable,
-        _file_edge_data>
+        _file_edge_data, NodeFieldsTy>
         type;
   };
 
@@ -97,13 +100,13 @@ public:
   struct with_no_lockable {
     typedef LC_CSR_Graph<
         NodeTy, EdgeTy, _has_no_lockable, UseNumaAlloc, HasOutOfLineLockable,
-        FileEdgeTy>
+        FileEdgeTy, NodeFieldsTy>
         type;
   };
   template <bool _has_no_lockable>
   using _with_no_lockable = LC_CSR_Graph<
       NodeTy, EdgeTy, _has_no_lockable, UseNumaAlloc, HasOutOfLineLockable,
-      FileEdgeTy>;
+      FileEdgeTy, NodeFieldsTy>;
 
   //! If true, use NUMA-aware graph allocation; otherwise, use NUMA interleaved
   //! allocation.
@@ -111,20 +114,32 @@ public:
   struct with_numa_alloc {
     typedef LC_CSR_Graph<
         NodeTy, EdgeTy, HasNoLockable, _use_numa_alloc, HasOutOfLineLockable,
-        FileEdgeTy>
+        FileEdgeTy, NodeFieldsTy>
         type;
   };
   template <bool _use_numa_alloc>
   using _with_numa_alloc = LC_CSR_Graph<
       NodeTy, EdgeTy, HasNoLockable, _use_numa_alloc, HasOutOfLineLockable,
-      FileEdgeTy>;
+      FileEdgeTy, NodeFieldsTy>;
 
   //! If true, store abstract locks separate from nodes
   template <bool _has_out_of_line_lockable>
   struct with_out_of_line_lockable {
     typedef LC_CSR_Graph<
         NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc, _has_out_of_line_lockable,
-        FileEdgeTy>
+        FileEdgeTy, NodeFieldsTy>
+        type;
+  };
+
+  //! Store each of the types of _node_fields, a std::tuple, in an array of
+  //! its own (struct of arrays) and access them with getField<I>; e.g.,
+  //! with_node_fields<std::tuple<uint32_t, float>> for a graph whose loops
+  //! mostly use either the uint32_t or the float of each node.
+  template <typename _node_fields>
+  struct with_node_fields {
+    typedef LC_CSR_Graph<
+        NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc, HasOutOfLineLockable,
+        FileEdgeTy, _node_fields>
         type;
   };
 
@@ -140,7 +155,10 @@ protected:
       NodeTy, !HasNoLockable && !HasOutOfLineLockable>
       NodeInfo;
   typedef NUMAArray<uint64_t> EdgeIndData;
-  typedef NUMAArray<NodeInfo> NodeData;
+  typedef std::conditional_t<
+      std::tuple_size_v<NodeFieldsTy> == 0, NUMAArray<NodeInfo>,
+      internal::NodeDataArrays<NodeInfo, NodeFieldsTy>>
+      NodeData;
 
 public:
   typedef uint32_t GraphNode;
@@ -291,6 +309,20 @@ public:
     return NI.getData();
   }
 
+  //! The I-th field of with_node_fields of node N
+  template <size_t I>
+  std::tuple_element_t<I, NodeFieldsTy>& getField(
+      GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    acquireNode(N, mflag);
+    return nodeData.template field<I>()[N];
+  }
+
+  //! The array of the I-th field of with_node_fields, indexed by node
+  template <size_t I>
+  NUMAArray<std::tuple_element_t<I, NodeFieldsTy>>& getFieldArray() {
+    return nodeData.template field<I>();
+  }
+
   edge_data_reference getEdgeData(
       edge_iterator ni,
       [[maybe_unused]] MethodFlag mflag = MethodFlag::UNPROTECTED) {
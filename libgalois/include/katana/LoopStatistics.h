@@ -20,11 +20,73 @@
 #ifndef KATANA_LIBGALOIS_KATANA_LOOPSTATISTICS_H_
 #define KATANA_LIBGALOIS_KATANA_LOOPSTATISTICS_H_
 
+#include <array>
+#include <cstdint>
+#include <map>
+#include <type_traits>
+#include <utility>
+
 #include "katana/Statistics.h"
 #include "katana/config.h"
 
 namespace katana {
 
+namespace internal {
+
+/// Cycles, LLC misses, branch misses and reads served by remote NUMA nodes
+constexpr size_t kNumLoopCounters = 4;
+
+/// \returns true if the KATANA_LOOP_COUNTERS environment variable is set
+KATANA_EXPORT bool LoopCountersEnabled();
+
+/// Reads the hardware counters of the calling thread into \param values;
+/// counters the machine does not support read as zero
+KATANA_EXPORT void ReadLoopCounters(uint64_t* values);
+
+/// Reports the hardware counters of the calling thread since they were
+/// \param start as statistics of \param loopname
+KATANA_EXPORT void ReportLoopCounters(
+    const char* loopname, const uint64_t* start);
+
+}  // namespace internal
+
+/// Counts hardware events, e.g., cycles and LLC misses, of a thread in a
+/// parallel loop from construction to destruction and reports them as
+/// statistics of the loop, if enabled at runtime with KATANA_LOOP_COUNTERS.
+/// Counters are read with perf_event_open on Linux and are unavailable
+/// elsewhere.
+///
+/// Usually instantiated per thread
+template <bool Enabled>
+class LoopCounters {
+  std::array<uint64_t, internal::kNumLoopCounters> start_;
+  const char* loopname_;
+  bool active_;
+
+public:
+  explicit LoopCounters(const char* ln)
+      : loopname_(ln), active_(internal::LoopCountersEnabled()) {
+    if (active_) {
+      internal::ReadLoopCounters(start_.data());
+    }
+  }
+
+  ~LoopCounters() {
+    if (active_) {
+      internal::ReportLoopCounters(loopname_, start_.data());
+    }
+  }
+
+  LoopCounters(const LoopCounters&) = delete;
+  LoopCounters& operator=(const LoopCounters&) = delete;
+};
+
+template <>
+class LoopCounters<false> {
+public:
+  explicit LoopCounters(const char*) {}
+};
+
 // Usually instantiated per thread
 template <bool Enabled>
 class LoopStatistics {
@@ -33,10 +95,15 @@ protected:
   size_t m_pushes;
   size_t m_conflicts;
   const char* loopname;
+  LoopCounters<true> m_counters;
 
 public:
   explicit LoopStatistics(const char* ln)
-      : m_iterations(0), m_pushes(0), m_conflicts(0), loopname(ln) {}
+      : m_iterations(0),
+        m_pushes(0),
+        m_conflicts(0),
+        loopname(ln),
+        m_counters(ln) {}
 
   ~LoopStatistics() {
     ReportStatSum(loopname, "Iterations", m_iterations);
@@ -70,5 +137,81 @@ public:
   inline void inc_conflicts() const {}
 };
 
+namespace internal {
+
+/// \returns N if every Nth conflict of a thread in a loop should be sampled,
+/// from the KATANA_CONFLICT_SAMPLING environment variable, or 0 if conflicts
+/// are not sampled
+KATANA_EXPORT uint32_t ConflictSamplingPeriod();
+
+}  // namespace internal
+
+/// Shows where a loop with conflict detection aborts. Counts the items that
+/// commit after being retried by number of retries, and, if enabled at
+/// runtime with KATANA_CONFLICT_SAMPLING, samples the sites of conflicts:
+/// the item of the iteration if it is an integer, e.g., a node, or else the
+/// lock it failed to acquire. Both are reported as statistics of the loop
+/// per thread, the sites as the categories "ConflictSamples node <id>" and
+/// "ConflictSamples lock <address>" for the most sampled sites of a thread.
+///
+/// Usually instantiated per thread
+template <bool Enabled>
+class ConflictStatistics {
+public:
+  explicit ConflictStatistics(const char*) {}
+
+  template <typename T>
+  void OnConflict(const void*, const T&) const {}
+  void OnCommit(int) const {}
+};
+
+template <>
+class KATANA_EXPORT ConflictStatistics<true> {
+public:
+  /// Most sampled sites that a thread reports
+  static constexpr size_t kMaxReportedSites = 16;
+  /// Commits are counted by retries in [1, 2), [2, 4), ..., [16, inf)
+  static constexpr size_t kNumRetryBuckets = 5;
+
+  explicit ConflictStatistics(const char* loopname);
+  ~ConflictStatistics();
+
+  ConflictStatistics(const ConflictStatistics&) = delete;
+  ConflictStatistics& operator=(const ConflictStatistics&) = delete;
+
+  /// Called when the iteration of \param item aborts because it failed to
+  /// acquire \param lock, which may be null if not known
+  template <typename T>
+  void OnConflict(const void* lock, const T& item) {
+    if (period_ == 0 || --until_sample_ != 0) {
+      return;
+    }
+    until_sample_ = period_;
+    if constexpr (std::is_integral_v<T>) {
+      Sample(true, static_cast<uint64_t>(item));
+    } else {
+      Sample(false, reinterpret_cast<uintptr_t>(lock));
+    }
+  }
+
+  /// Called when an item commits after \param retries aborts
+  void OnCommit(int retries) {
+    if (retries > 0) {
+      CountRetries(retries);
+    }
+  }
+
+private:
+  void Sample(bool is_node, uint64_t site);
+  void CountRetries(int retries);
+
+  const char* loopname_;
+  uint32_t period_;
+  uint32_t until_sample_;
+  std::array<uint64_t, kNumRetryBuckets> retried_commits_{};
+  /// samples by (is_node, node or lock address)
+  std::map<std::pair<bool, uint64_t>, uint64_t> sites_;
+};
+
 }  // namespace katana
 #endif
@@ -0,0 +1,189 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MEMORYBUDGET_H_
+#define KATANA_LIBGALOIS_KATANA_MEMORYBUDGET_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+/// Charge \param bytes of pages mapped from the OS to the current budgets
+/// and phases
+KATANA_EXPORT void ChargeMemoryBudget(size_t bytes);
+/// Return \param bytes of pages unmapped to the OS to the current budgets
+/// and phases
+KATANA_EXPORT void UnchargeMemoryBudget(size_t bytes);
+
+}  // namespace internal
+
+/// A scope that accounts for the memory Galois maps from the OS, i.e., the
+/// pages behind PagePool, NUMAArray, the other largeMalloc users and the
+/// large property buffers of NUMAMemoryPool, while it is alive, and enforces
+/// a budget on it. std::vector and other malloc based allocations are not
+/// accounted.
+///
+/// Budgets nest; an allocation is charged to every budget that is alive.
+/// Memory freed while a budget is alive is returned to it, even if it was
+/// allocated before the budget, so the used bytes may underestimate what the
+/// scope really holds.
+///
+/// Allocations are not refused when the budget is exceeded, because the
+/// allocators cannot fail. Instead, the first allocation that exceeds the
+/// budget calls the exceeded callback, e.g., to spill data or to cancel the
+/// CancellationToken of the loops that allocate, and Check returns an error
+/// from then on.
+///
+/// The accounting is process-wide: loops issued by other threads while a
+/// budget is alive are charged to it too, so a query server should hold a
+/// ThreadPoolLease for as long as the budget of each query is alive.
+///
+/// \code
+/// katana::CancellationToken token;
+/// katana::MemoryBudget budget("query", 8UL << 30, [&](const auto&) {
+///   token.Cancel();
+/// });
+/// auto res = katana::analytics::Bfs(pg, 0, "bfs", {}, &token);
+/// KATANA_CHECKED(budget.Check());
+/// \endcode
+class KATANA_EXPORT MemoryBudget {
+public:
+  using ExceededCallback = std::function<void(const MemoryBudget&)>;
+
+  MemoryBudget(
+      std::string name, size_t budget_bytes,
+      ExceededCallback on_exceeded = nullptr);
+  ~MemoryBudget();
+
+  MemoryBudget(const MemoryBudget&) = delete;
+  MemoryBudget& operator=(const MemoryBudget&) = delete;
+  MemoryBudget(MemoryBudget&&) = delete;
+  MemoryBudget& operator=(MemoryBudget&&) = delete;
+
+  const std::string& name() const { return name_; }
+  size_t budget_bytes() const { return budget_bytes_; }
+
+  /// \returns the bytes allocated and not freed since the budget was created
+  size_t used_bytes() const {
+    int64_t used = used_bytes_.load(std::memory_order_relaxed);
+    return used > 0 ? used : 0;
+  }
+
+  /// \returns the maximum of used_bytes() over the life of the budget
+  size_t peak_bytes() const {
+    return peak_bytes_.load(std::memory_order_relaxed);
+  }
+
+  /// \returns true if the used bytes ever exceeded the budget
+  bool exceeded() const { return exceeded_.load(std::memory_order_relaxed); }
+
+  /// \returns an ErrorCode::OutOfMemory error if the budget was exceeded
+  Result<void> Check() const;
+
+  /// Report the used, peak and budget bytes as MemoryBudget statistics whose
+  /// names start with \param prefix and the name of the budget
+  void Report(const std::string& prefix) const;
+
+  /// \returns the innermost budget that is alive, or null
+  static const MemoryBudget* current() {
+    return current_.load(std::memory_order_acquire);
+  }
+
+private:
+  friend void internal::ChargeMemoryBudget(size_t bytes);
+  friend void internal::UnchargeMemoryBudget(size_t bytes);
+
+  void Charge(int64_t bytes);
+
+  static std::atomic<MemoryBudget*> current_;
+
+  std::string name_;
+  size_t budget_bytes_;
+  ExceededCallback on_exceeded_;
+  MemoryBudget* parent_;
+  std::atomic<int64_t> used_bytes_{0};
+  std::atomic<size_t> peak_bytes_{0};
+  std::atomic<bool> exceeded_{false};
+};
+
+/// A scope that attributes memory to a phase of a computation, e.g., the
+/// region of a StatTimer, to find out which phase needs the memory of a run.
+/// Pages mapped by Galois are accounted like in a MemoryBudget without a
+/// limit: an allocation is charged to every phase that is alive, so the peak
+/// of a phase includes the allocations of the phases inside it, and the
+/// accounting is process-wide. Unlike budgets, phases may end in any order,
+/// so that algorithms called concurrently can each have their phases.
+///
+/// Arrow allocations, e.g., of properties, cannot be attributed to threads
+/// or phases; a phase only records how much the allocations of the default
+/// Arrow memory pool grew while it was alive.
+///
+/// When it is destroyed, a phase reports its peak bytes and Arrow bytes as
+/// the statistics <name>PeakBytes and <name>ArrowBytes of its region.
+///
+/// \code
+/// katana::StatTimer exec_time("BFS");
+/// katana::MemoryPhase memory("BFS");
+/// \endcode
+class KATANA_EXPORT MemoryPhase {
+public:
+  MemoryPhase(const char* name, const char* region = nullptr);
+  ~MemoryPhase();
+
+  MemoryPhase(const MemoryPhase&) = delete;
+  MemoryPhase& operator=(const MemoryPhase&) = delete;
+  MemoryPhase(MemoryPhase&&) = delete;
+  MemoryPhase& operator=(MemoryPhase&&) = delete;
+
+  const std::string& name() const { return name_; }
+  const std::string& region() const { return region_; }
+
+  /// \returns the bytes of pages mapped and not unmapped since the phase
+  /// started
+  size_t used_bytes() const {
+    int64_t used = used_bytes_.load(std::memory_order_relaxed);
+    return used > 0 ? used : 0;
+  }
+
+  /// \returns the maximum of used_bytes() over the life of the phase
+  size_t peak_bytes() const {
+    return peak_bytes_.load(std::memory_order_relaxed);
+  }
+
+  /// \returns the growth of the bytes allocated by the default Arrow memory
+  /// pool since the phase started, which is negative if the phase freed more
+  /// than it allocated
+  int64_t arrow_bytes() const;
+
+  /// \returns the newest phase that is alive, or null
+  static const MemoryPhase* current() {
+    return current_.load(std::memory_order_acquire);
+  }
+
+private:
+  friend void internal::ChargeMemoryBudget(size_t bytes);
+  friend void internal::UnchargeMemoryBudget(size_t bytes);
+
+  void Charge(int64_t bytes);
+
+  static std::atomic<MemoryPhase*> current_;
+
+  std::string name_;
+  std::string region_;
+  /// neighbors in the list of phases that are alive, ordered by creation
+  MemoryPhase* older_;
+  MemoryPhase* newer_{nullptr};
+  int64_t arrow_start_bytes_;
+  std::atomic<int64_t> used_bytes_{0};
+  std::atomic<size_t> peak_bytes_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef KATANA_LIBGALOIS_KATANA_METAPATH_H_
+#define KATANA_LIBGALOIS_KATANA_METAPATH_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "katana/EntityTypeManager.h"
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// One hop of a metapath: follow the edges of edge_type out of or into the
+/// current node
+struct KATANA_EXPORT MetapathStep {
+  enum class Direction { kOut, kIn };
+
+  EntityTypeID edge_type;
+  Direction direction{Direction::kOut};
+};
+
+/// A metapath of a heterogeneous graph, e.g., author -writes-> paper
+/// <-writes- author is {{writes, kOut}, {writes, kIn}}
+using Metapath = std::vector<MetapathStep>;
+
+/// Metapath traversals expand one step at a time from a frontier of nodes, in
+/// parallel over the frontier. Each hop only visits the edges of the type of
+/// its step through the per-type adjacency ranges of the view, so its cost is
+/// that of the edges which match. A node reached more than once in a hop is
+/// put only once in the next frontier.
+///
+/// Steps whose edge type is not in the graph match no edges. It is an error
+/// for a source to not be a node of the view.
+
+/// The sorted nodes reachable from some node of sources by an instance of
+/// path. An empty path reaches the sources.
+KATANA_EXPORT katana::Result<std::vector<GraphTopologyTypes::Node>>
+MetapathEndpoints(
+    const PropertyGraphViews::EdgeTypeAwareBiDir& view,
+    const std::vector<GraphTopologyTypes::Node>& sources,
+    const Metapath& path);
+
+/// Element n of the result is the number of instances of path from some
+/// node of sources to node n, i.e., of walks which follow the steps of path
+/// in order. A source which appears more than once counts more than once.
+KATANA_EXPORT katana::Result<katana::NUMAArray<uint64_t>>
+CountMetapathInstances(
+    const PropertyGraphViews::EdgeTypeAwareBiDir& view,
+    const std::vector<GraphTopologyTypes::Node>& sources,
+    const Metapath& path);
+
+/// PathSim (Sun et al., "PathSim: Meta Path-Based Top-K Similarity Search in
+/// Heterogeneous Information Networks", VLDB 2011) of source to each node y
+/// reachable from it by path: 2 c(source, y) / (c(source, source) + c(y, y)),
+/// where c counts the instances of path. path must be symmetric, i.e., of
+/// even length with step i the reverse of step path.size() - 1 - i. The
+/// result is sorted by node.
+KATANA_EXPORT katana::Result<
+    std::vector<std::pair<GraphTopologyTypes::Node, double>>>
+PathSim(
+    const PropertyGraphViews::EdgeTypeAwareBiDir& view,
+    GraphTopologyTypes::Node source, const Metapath& path);
+
+}  // namespace katana
+
+#endif
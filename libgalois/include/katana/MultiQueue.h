@@ -0,0 +1,215 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+#define KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/PaddedLock.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A relaxed concurrent priority queue (Rihani et al., "MultiQueues: Simpler,
+/// Faster, and Better Relaxed Concurrent Priority Queues", SPAA 2015) for
+/// priorities of any type ordered by Compare.
+///
+/// Items are kept in QueuesPerThread binary heaps per active thread, each
+/// with its own lock. push adds an item to a random heap; pop takes the
+/// least item of the better of two random heaps, so it returns one of the
+/// O(number of heaps) least items rather than the least one. Unlike \ref
+/// OrderedByIntegerMetric, priorities need not be mapped to integer buckets,
+/// e.g., Dijkstra-style algorithms can order their work by floating-point
+/// distances.
+///
+/// pop returns nothing only when every heap was found empty. Without
+/// concurrency (rethread<false>) there is a single heap, so pop returns the
+/// least item.
+template <
+    typename Compare = std::less<int>, typename T = int,
+    int QueuesPerThread = 2, bool Concurrent = true>
+class MultiQueue : private boost::noncopyable {
+public:
+  template <typename _T>
+  using retype = MultiQueue<Compare, _T, QueuesPerThread, Concurrent>;
+
+  template <bool _concurrent>
+  using rethread = MultiQueue<Compare, T, QueuesPerThread, _concurrent>;
+
+  template <int _queues_per_thread>
+  using with_queues_per_thread =
+      MultiQueue<Compare, T, _queues_per_thread, Concurrent>;
+
+  typedef T value_type;
+
+private:
+  static_assert(QueuesPerThread > 0, "at least one queue per thread");
+
+  /// the number of times pop samples two heaps before it scans all of them
+  static constexpr int kPopAttempts = 8;
+
+  struct alignas(KATANA_CACHE_LINE_SIZE) Queue {
+    PaddedLock<Concurrent> lock;
+    /// a heap ordered by Greater so that its front is the least item
+    std::vector<T> heap;
+    /// written under the lock; read without it to skip empty heaps
+    std::atomic<size_t> size{0};
+  };
+
+  struct Greater {
+    Compare cmp;
+    bool operator()(const T& a, const T& b) const { return cmp(b, a); }
+  };
+
+  Compare cmp_;
+  Greater greater_;
+  size_t num_queues_;
+  std::unique_ptr<Queue[]> queues_;
+  PerThreadStorage<std::minstd_rand> rngs_;
+
+  size_t RandomQueue() {
+    std::minstd_rand& rng = *rngs_.getLocal();
+    return rng() % num_queues_;
+  }
+
+  void PushLocked(Queue& q, const value_type& val) {
+    q.heap.push_back(val);
+    std::push_heap(q.heap.begin(), q.heap.end(), greater_);
+    q.size.store(q.heap.size(), std::memory_order_relaxed);
+  }
+
+  value_type PopLocked(Queue& q) {
+    std::pop_heap(q.heap.begin(), q.heap.end(), greater_);
+    value_type val = std::move(q.heap.back());
+    q.heap.pop_back();
+    q.size.store(q.heap.size(), std::memory_order_relaxed);
+    return val;
+  }
+
+  static bool IsEmpty(const Queue& q) {
+    return q.size.load(std::memory_order_relaxed) == 0;
+  }
+
+  /// Pop from the better of two random heaps if both can be locked
+  std::optional<value_type> TryPopTwoChoices() {
+    size_t a = RandomQueue();
+    size_t b = RandomQueue();
+    if (a > b) {
+      std::swap(a, b);
+    }
+    Queue& qa = queues_[a];
+    Queue& qb = queues_[b];
+    if (IsEmpty(qa) && IsEmpty(qb)) {
+      return std::nullopt;
+    }
+    if (!qa.lock.try_lock()) {
+      return std::nullopt;
+    }
+    if (a != b && !qb.lock.try_lock()) {
+      qa.lock.unlock();
+      return std::nullopt;
+    }
+
+    std::optional<value_type> retval;
+    Queue* best = nullptr;
+    if (!qa.heap.empty()) {
+      best = &qa;
+    }
+    if (!qb.heap.empty() &&
+        (!best || cmp_(qb.heap.front(), best->heap.front()))) {
+      best = &qb;
+    }
+    if (best) {
+      retval = PopLocked(*best);
+    }
+
+    if (a != b) {
+      qb.lock.unlock();
+    }
+    qa.lock.unlock();
+    return retval;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE std::optional<value_type> PopAny() {
+    size_t start = RandomQueue();
+    for (size_t i = 0; i < num_queues_; ++i) {
+      Queue& q = queues_[(start + i) % num_queues_];
+      if (IsEmpty(q)) {
+        continue;
+      }
+      q.lock.lock();
+      std::optional<value_type> retval;
+      if (!q.heap.empty()) {
+        retval = PopLocked(q);
+      }
+      q.lock.unlock();
+      if (retval) {
+        return retval;
+      }
+    }
+    return std::nullopt;
+  }
+
+public:
+  MultiQueue(const Compare& cmp = Compare())
+      : cmp_(cmp),
+        greater_{cmp},
+        num_queues_(
+            Concurrent ? QueuesPerThread *
+                             std::max(1U, katana::getActiveThreads())
+                       : 1),
+        queues_(std::make_unique<Queue[]>(num_queues_)) {
+    for (unsigned i = 0; i < rngs_.size(); ++i) {
+      rngs_.getRemote(i)->seed(i + 1);
+    }
+  }
+
+  void push(const value_type& val) {
+    while (true) {
+      Queue& q = queues_[RandomQueue()];
+      if (q.lock.try_lock()) {
+        PushLocked(q, val);
+        q.lock.unlock();
+        return;
+      }
+    }
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e) {
+      push(*b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    for (int i = 0; i < kPopAttempts; ++i) {
+      if (std::optional<value_type> retval = TryPopTwoChoices()) {
+        return retval;
+      }
+    }
+    return PopAny();
+  }
+};
+KATANA_WLCOMPILECHECK(MultiQueue)
+
+}  // namespace katana
+
+#endif
@@ -237,13 +237,7 @@ public:
       return true;
     }
 
-    for (size_t i = 0, sz = left.size(); i < sz; ++i) {
-      if (left[i] != right[i]) {
-        return false;
-      }
-    }
-
-    return true;
+    return katana::ParallelSTL::equal(left.begin(), left.end(), right.begin());
   }
 };
 
@@ -0,0 +1,70 @@
+#ifndef KATANA_LIBGALOIS_KATANA_NUMAMEMORYPOOL_H_
+#define KATANA_LIBGALOIS_KATANA_NUMAMEMORYPOOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <arrow/memory_pool.h>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// An Arrow memory pool which allocates large buffers from the pages Galois
+/// maps from the OS, so that property columns are charged to MemoryBudget
+/// and MemoryPhase like NUMAArray, use huge pages when they are available,
+/// and are placed on the NUMA node of the thread that first writes each
+/// page, e.g., the thread that decodes it or fills it in a parallel loop.
+///
+/// Buffers smaller than a threshold are allocated from a fallback pool
+/// (arrow::default_memory_pool() by default), since rounding them up to
+/// whole pages would waste memory.
+///
+/// The pages are mapped without touching them and without the Galois thread
+/// pool, so the pool can be used from any thread, including Arrow's own.
+class KATANA_EXPORT NUMAMemoryPool : public arrow::MemoryPool {
+public:
+  /// Buffers of at least this many bytes are allocated from pages by default
+  static constexpr int64_t kDefaultMinPageBytes = 16 << 20;
+
+  explicit NUMAMemoryPool(
+      int64_t min_page_bytes = kDefaultMinPageBytes,
+      arrow::MemoryPool* fallback = arrow::default_memory_pool());
+
+  arrow::Status Allocate(int64_t size, uint8_t** out) override;
+  arrow::Status Reallocate(
+      int64_t old_size, int64_t new_size, uint8_t** ptr) override;
+  void Free(uint8_t* buffer, int64_t size) override;
+
+  int64_t bytes_allocated() const override {
+    return bytes_allocated_.load(std::memory_order_relaxed);
+  }
+  int64_t max_memory() const override {
+    return max_memory_.load(std::memory_order_relaxed);
+  }
+  std::string backend_name() const override { return "katana"; }
+
+  /// \returns the bytes of the buffers allocated from pages
+  int64_t page_bytes_allocated() const {
+    return page_bytes_allocated_.load(std::memory_order_relaxed);
+  }
+
+  /// \returns the process-wide pool. It is never destroyed, so that buffers
+  /// may outlive SharedMemSys.
+  static NUMAMemoryPool* Get();
+
+private:
+  bool UsesPages(int64_t size) const { return size >= min_page_bytes_; }
+  void Charge(int64_t bytes);
+
+  int64_t min_page_bytes_;
+  arrow::MemoryPool* fallback_;
+  std::atomic<int64_t> bytes_allocated_{0};
+  std::atomic<int64_t> max_memory_{0};
+  std::atomic<int64_t> page_bytes_allocated_{0};
+};
+
+}  // namespace katana
+
+#endif
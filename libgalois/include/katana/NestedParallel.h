@@ -0,0 +1,109 @@
+#ifndef KATANA_LIBGALOIS_KATANA_NESTEDPARALLEL_H_
+#define KATANA_LIBGALOIS_KATANA_NESTEDPARALLEL_H_
+
+#include <atomic>
+#include <cstddef>
+
+#include "katana/Cancellation.h"
+#include "katana/CompilerSpecific.h"
+#include "katana/config.h"
+
+namespace katana::internal {
+
+/// Iterations [0, size) of a loop nested in the operator of a do_all, e.g.,
+/// over the edges of a high-degree node, that other threads of the do_all
+/// can run in chunks while the thread that reached the loop waits for them.
+class KATANA_EXPORT NestedTask {
+public:
+  using RunFn = void (*)(void* state, size_t begin, size_t end);
+
+  NestedTask(
+      void* state, RunFn run, size_t size, size_t chunk_size,
+      const CancellationToken* cancellation)
+      : state_(state),
+        run_(run),
+        size_(size),
+        chunk_size_(chunk_size),
+        cancellation_(cancellation),
+        unfinished_(size) {}
+
+  NestedTask(const NestedTask&) = delete;
+  NestedTask& operator=(const NestedTask&) = delete;
+  NestedTask(NestedTask&&) = delete;
+  NestedTask& operator=(NestedTask&&) = delete;
+
+  /// Claim and run chunks until none are left. Once the cancellation token
+  /// is cancelled, claimed chunks are dropped instead of run.
+  ///
+  /// \returns true if any chunk was claimed
+  bool RunChunks();
+
+  /// \returns true once every claimed chunk has been run or dropped
+  bool Finished() const { return unfinished_.load() == 0; }
+
+private:
+  void* state_;
+  RunFn run_;
+  size_t size_;
+  size_t chunk_size_;
+  const CancellationToken* cancellation_;
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<size_t> next_{0};
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<size_t> unfinished_;
+};
+
+/// Marks the calling thread as running the operator of a do_all while alive.
+/// A do_all nested in such an operator becomes a NestedTask, and a do_all
+/// nested in the chunks of a NestedTask runs serially.
+class KATANA_EXPORT NestedLoopScope {
+public:
+  NestedLoopScope();
+  ~NestedLoopScope();
+
+  NestedLoopScope(const NestedLoopScope&) = delete;
+  NestedLoopScope& operator=(const NestedLoopScope&) = delete;
+  NestedLoopScope(NestedLoopScope&&) = delete;
+  NestedLoopScope& operator=(NestedLoopScope&&) = delete;
+};
+
+/// \returns true if the calling thread runs the operator of a do_all or the
+/// chunk of a NestedTask, so a do_all it calls must not start the thread pool
+KATANA_EXPORT bool InDoAllOperator();
+
+/// \returns true if a do_all called by this thread can become a NestedTask,
+/// i.e., it is not nested in a NestedTask and other threads can help
+KATANA_EXPORT bool ForkNestedLoops();
+
+/// Let the other threads of the do_all run chunks of \param task, run the
+/// chunks that are left and wait until all of them are finished
+KATANA_EXPORT void RunNestedTask(NestedTask* task);
+
+/// Run chunks of the tasks that other threads are waiting for
+///
+/// \returns true if any chunk was claimed
+KATANA_EXPORT bool HelpNestedTasks();
+
+/// Counts the threads of a do_all that have not finished their share of the
+/// iterations. Threads that have finished help the others with their nested
+/// tasks until all have finished, since only unfinished threads can create
+/// more tasks.
+class NestedLoopHelpers {
+public:
+  explicit NestedLoopHelpers(unsigned num_threads) : working_(num_threads) {}
+
+  /// Called once by every thread of the do_all after its last iteration
+  void FinishAndHelp() {
+    working_.fetch_sub(1);
+    while (working_.load() != 0) {
+      if (!HelpNestedTasks()) {
+        asmPause();
+      }
+    }
+  }
+
+private:
+  std::atomic<unsigned> working_;
+};
+
+}  // namespace katana::internal
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef KATANA_LIBGALOIS_KATANA_NODEORDERING_H_
+#define KATANA_LIBGALOIS_KATANA_NODEORDERING_H_
+
+#include <cstdint>
+
+#include "katana/GraphTopology.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Node orders that place nodes that are accessed together close to each
+/// other so that traversals have better cache behavior.
+///
+/// Each function returns the order as a permutation of the nodes of \param
+/// topo: element i is the (old) id of the node placed at position i. Edges
+/// are treated as undirected and self loops are ignored.
+
+/// Reverse Cuthill-McKee: a breadth-first order from a low degree node of
+/// each component, visiting the children of a node by increasing degree,
+/// reversed at the end. Reduces the bandwidth of the adjacency matrix. Each
+/// BFS level is expanded in parallel and the result does not depend on the
+/// number of threads.
+KATANA_EXPORT GraphTopologyTypes::PropIndexVec ReverseCuthillMcKeeOrder(
+    const GraphTopology& topo) noexcept;
+
+/// A breadth-first order that starts each component at its lowest id node
+/// and visits the children of a node by id. Each BFS level is expanded in
+/// parallel and the result does not depend on the number of threads.
+KATANA_EXPORT GraphTopologyTypes::PropIndexVec BreadthFirstOrder(
+    const GraphTopology& topo) noexcept;
+
+/// The nodes by decreasing out-degree, ties broken by id, which places the
+/// hubs of skewed graphs together
+KATANA_EXPORT GraphTopologyTypes::PropIndexVec DegreeOrder(
+    const GraphTopology& topo) noexcept;
+
+/// Gorder (Wei et al., SIGMOD 2016): greedily places next the node that
+/// shares the most neighbors with, or is a neighbor of, the last \param
+/// window nodes placed. Neighbors of very high degree nodes are not counted
+/// as sharing a neighbor to bound the cost of each step.
+KATANA_EXPORT GraphTopologyTypes::PropIndexVec GorderOrder(
+    const GraphTopology& topo, uint32_t window = 5) noexcept;
+
+/// Rabbit order (Arai et al., IPDPS 2016): merges nodes into communities
+/// by modularity gain, visiting nodes by increasing degree, and numbers the
+/// nodes of each community consecutively by a depth-first traversal of the
+/// merges.
+KATANA_EXPORT GraphTopologyTypes::PropIndexVec RabbitOrder(
+    const GraphTopology& topo) noexcept;
+
+}  // namespace katana
+
+#endif
@@ -20,6 +20,8 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PARALLELSTL_H_
 #define KATANA_LIBGALOIS_KATANA_PARALLELSTL_H_
 
+#include <algorithm>
+#include <atomic>
 #include <iterator>
 
 #include "katana/Chunk.h"
@@ -479,6 +481,41 @@ copy(InputIt first, InputIt last, OutputIt d_first) {
   return d_first + std::distance(first, last);
 }
 
+/**
+ * Checks that [first1, last1) and the range of the same length from first2
+ * are element-wise equal. Each thread compares a block and stops at the first
+ * difference it finds or once another thread has found one.
+ */
+template <class InputIt1, class InputIt2>
+bool
+equal(InputIt1 first1, InputIt1 last1, InputIt2 first2) {
+  using input_category =
+      typename std::iterator_traits<InputIt1>::iterator_category;
+  static_assert(
+      std::is_base_of_v<std::random_access_iterator_tag, input_category>,
+      "parallel equal is only supported for random access iterators");
+
+  using diff_type = typename std::iterator_traits<InputIt1>::difference_type;
+  // blocks are compared in pieces so that a difference ends all threads soon
+  constexpr diff_type kPiece = 1 << 16;
+
+  std::atomic<bool> differ{false};
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(first1, last1, tid, total);
+    auto other = first2 + std::distance(first1, begin);
+    while (begin != end && !differ.load(std::memory_order_relaxed)) {
+      diff_type length = std::min(kPiece, std::distance(begin, end));
+      if (!std::equal(begin, begin + length, other)) {
+        differ.store(true, std::memory_order_relaxed);
+      }
+      begin += length;
+      other += length;
+    }
+  });
+
+  return !differ.load();
+}
+
 template <class InputIt, class OutputIt, class UnaryPredicate>
 OutputIt
 copy_if(InputIt first, InputIt last, OutputIt d_first, UnaryPredicate pred) {
@@ -85,6 +85,10 @@ KATANA_EXPORT PerBackend& getPPSBackend();
 
 KATANA_EXPORT void initPTS(unsigned maxT);
 
+/// Make the calling thread, which is not a thread of the pool, share the
+/// per-thread and per-socket storage of thread \param tid of the pool
+KATANA_EXPORT void AdoptPTS(unsigned tid);
+
 template <typename T>
 class PerThreadStorage {
   PerBackend* b;
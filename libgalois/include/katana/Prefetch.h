@@ -0,0 +1,55 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PREFETCH_H_
+#define KATANA_LIBGALOIS_KATANA_PREFETCH_H_
+
+#include <cstddef>
+#include <type_traits>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// The number of edges ahead of the current one whose destinations are
+/// prefetched by ForEachEdgePrefetched by default, enough to cover the
+/// latency of DRAM with a few cycles of work per edge
+constexpr size_t kDefaultPrefetchDistance = 16;
+
+/// Hint that the cache line of addr will be read soon
+inline void
+PrefetchForRead(const void* addr) {
+  __builtin_prefetch(addr, 0, 3);
+}
+
+/// Call fn(e, dests[e]) for the edges e of [begin, end) in order, and
+/// prefetch(dests[e + distance]) before each, e.g., PrefetchForRead of the
+/// property of that destination. The reads of dests are sequential and
+/// prefetched by hardware, but the reads of the properties of destinations
+/// by pull-style kernels are random and are not. If fn returns bool, the
+/// loop stops after a call that returns false, e.g., once a parent is found.
+template <typename Edge, typename Node, typename Fn, typename Prefetch>
+void
+ForEachEdgePrefetched(
+    Edge begin, Edge end, const Node* dests, const Fn& fn,
+    const Prefetch& prefetch, size_t distance = kDefaultPrefetchDistance) {
+  // the first edges are prefetched together so that their misses overlap
+  Edge ahead = begin + distance < end ? begin + distance : end;
+  for (Edge e = begin; e < ahead; ++e) {
+    prefetch(dests[e]);
+  }
+  for (Edge e = begin; e < end; ++e) {
+    if (e + distance < end) {
+      prefetch(dests[e + distance]);
+    }
+    if constexpr (std::is_same_v<
+                      std::invoke_result_t<const Fn&, Edge, Node>, bool>) {
+      if (!fn(e, dests[e])) {
+        return;
+      }
+    } else {
+      fn(e, dests[e]);
+    }
+  }
+}
+
+}  // namespace katana
+
+#endif
@@ -2,8 +2,12 @@
 #define KATANA_LIBGALOIS_KATANA_PROPERTIES_H_
 
 #include <cassert>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <arrow/array.h>
 #include <arrow/stl.h>
@@ -112,6 +116,33 @@ GetMutableValuesWorkAround(
   return data->template GetMutableValues<T>(i, absolute_offset);
 }
 
+/// Check that the values of a fixed-width array can be viewed in place, i.e.,
+/// that its offset is not negative and its values buffer is mutable.
+inline Result<void>
+CheckViewableValues(const arrow::Array& array) {
+  if (array.offset() < 0) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "offset must be positive, given {}",
+        array.offset());
+  }
+  if (array.data()->buffers.size() <= 1 ||
+      !array.data()->buffers[1]->is_mutable()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "immutable buffers not supported");
+  }
+  return ResultSuccess();
+}
+
+/// Get the null bitmap of an array, or nullptr if the array has no nulls even
+/// though it has a bitmap, so that views of it never load the bitmap.
+inline const uint8_t*
+NullBitmapIfNulls(const arrow::Array& array) {
+  if (array.null_count() == 0) {
+    return nullptr;
+  }
+  return array.data()->GetValues<uint8_t>(0, 0);
+}
+
 template <typename>
 struct PropertyViewTuple;
 
@@ -266,20 +297,10 @@ public:
     static_assert(
         sizeof(typename arrow::NumericArray<U>::value_type) == sizeof(T),
         "incompatible types");
-    if (array.offset() < 0) {
-      return KATANA_ERROR(
-          ErrorCode::ArrowError, "offset must be positive, given {}",
-          array.offset());
-    }
-    if (array.data()->buffers.size() <= 1 ||
-        !array.data()->buffers[1]->is_mutable()) {
-      return KATANA_ERROR(
-          ErrorCode::ArrowError, "immutable buffers not supported");
-    }
+    KATANA_CHECKED(internal::CheckViewableValues(array));
     return PODPropertyView(
         internal::GetMutableValuesWorkAround<T>(array.data(), 1, 0),
-        array.data()->template GetValues<uint8_t>(0, 0), array.length(),
-        array.offset());
+        internal::NullBitmapIfNulls(array), array.length(), array.offset());
   }
 
   static Result<PODPropertyView> Make(
@@ -289,20 +310,10 @@ public:
           ErrorCode::ArrowError, "bad byte width of data: {} != {}",
           array.byte_width(), sizeof(T));
     }
-    if (array.offset() < 0) {
-      return KATANA_ERROR(
-          ErrorCode::ArrowError, "offset must be positive, given {}",
-          array.offset());
-    }
-    if (array.data()->buffers.size() <= 1 ||
-        !array.data()->buffers[1]->is_mutable()) {
-      return KATANA_ERROR(
-          ErrorCode::ArrowError, "immutable buffers not supported");
-    }
+    KATANA_CHECKED(internal::CheckViewableValues(array));
     return PODPropertyView(
         internal::GetMutableValuesWorkAround<T>(array.data(), 1, 0),
-        array.data()->template GetValues<uint8_t>(0, 0), array.length(),
-        array.offset());
+        internal::NullBitmapIfNulls(array), array.length(), array.offset());
   }
 
   bool IsValid(size_t i) const {
@@ -332,6 +343,68 @@ private:
   size_t length_, offset_;
 };
 
+/// NoNullsPODPropertyView is a PODPropertyView over arrow::Arrays without
+/// null values. IsValid is true at compile time, so loops which check it
+/// compile down to indexing the values. Make returns an error if the array
+/// has nulls, so a property which has them fails when the view is made
+/// rather than reading the unspecified values of its null elements.
+///
+/// \tparam T A plain old C datatype type like double or int32_t
+template <typename T>
+class NoNullsPODPropertyView {
+public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+
+  template <typename U>
+  static Result<NoNullsPODPropertyView> Make(
+      const arrow::NumericArray<U>& array) {
+    static_assert(
+        sizeof(typename arrow::NumericArray<U>::value_type) == sizeof(T),
+        "incompatible types");
+    return MakeFromArray(array);
+  }
+
+  static Result<NoNullsPODPropertyView> Make(
+      const arrow::FixedSizeBinaryArray& array) {
+    if (array.byte_width() != sizeof(T)) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "bad byte width of data: {} != {}",
+          array.byte_width(), sizeof(T));
+    }
+    return MakeFromArray(array);
+  }
+
+  constexpr bool IsValid(size_t) const { return true; }
+
+  reference GetValue(size_t i) { return values_[i]; }
+
+  const_reference GetValue(size_t i) const { return values_[i]; }
+
+  reference operator[](size_t i) { return GetValue(i); }
+
+  const_reference operator[](size_t i) const { return GetValue(i); }
+
+private:
+  NoNullsPODPropertyView(T* values) : values_(values) {}
+
+  static Result<NoNullsPODPropertyView> MakeFromArray(
+      const arrow::Array& array) {
+    if (array.null_count() != 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "array has {} null values",
+          array.null_count());
+    }
+    KATANA_CHECKED(internal::CheckViewableValues(array));
+    return NoNullsPODPropertyView(
+        internal::GetMutableValuesWorkAround<T>(
+            array.data(), 1, array.offset()));
+  }
+
+  T* values_;
+};
+
 /// BooleanPropertyReadOnlyView provides a read-only property view over
 /// arrow::Arrays of boolean elements.
 class KATANA_EXPORT BooleanPropertyReadOnlyView {
@@ -400,6 +473,137 @@ private:
   const ArrowArrayType& array_;
 };
 
+namespace internal {
+/// The C type of the values of a dictionary of ArrowType values: strings for
+/// binary-like values, and c_type for arrow::NumericTypes
+template <typename ArrowType, typename = void>
+struct DictionaryValueType {
+  static constexpr bool kIsBinary = false;
+  using type = typename ArrowType::c_type;
+};
+
+template <typename ArrowType>
+struct DictionaryValueType<
+    ArrowType, std::enable_if_t<arrow::is_base_binary_type<ArrowType>::value>> {
+  static constexpr bool kIsBinary = true;
+  using type = std::string;
+};
+}  // namespace internal
+
+/// DictionaryPropertyReadOnlyView provides a read-only property view over
+/// dictionary-encoded arrow::DictionaryArrays, e.g., of categorical strings
+/// loaded from dictionary-encoded parquet columns, that works on the codes
+/// (indices into the dictionary) of elements without decoding them. Filters
+/// compare codes with the code of a constant from FindCode, and group-bys
+/// index arrays of num_codes() entries by code, e.g., CountByCode.
+///
+/// Codes of equal values are equal when the dictionary has no duplicates,
+/// which is the case for dictionaries read from parquet files. Codes are not
+/// ordered like their values.
+///
+/// \tparam CodeT the C type of the indices, e.g., int32_t
+/// \tparam ValueArrayType the arrow::Array type of the dictionary, e.g.,
+///   arrow::LargeStringArray
+template <typename CodeT, typename ValueArrayType>
+class DictionaryPropertyReadOnlyView {
+  static constexpr bool kIsBinary = internal::DictionaryValueType<
+      typename ValueArrayType::TypeClass>::kIsBinary;
+
+public:
+  using code_type = CodeT;
+  using value_type = typename internal::DictionaryValueType<
+      typename ValueArrayType::TypeClass>::type;
+
+  static Result<DictionaryPropertyReadOnlyView> Make(
+      const arrow::DictionaryArray& array) {
+    using CodeArrowType = typename arrow::CTypeTraits<CodeT>::ArrowType;
+    if (array.indices()->type_id() != CodeArrowType::type_id) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError, "dictionary indices are {}, not {}",
+          array.indices()->type()->ToString(),
+          CodeArrowType::type_singleton()->ToString());
+    }
+    auto* dictionary = dynamic_cast<ValueArrayType*>(array.dictionary().get());
+    if (!dictionary) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError, "unexpected dictionary values of type {}",
+          array.dictionary()->type()->ToString());
+    }
+    return DictionaryPropertyReadOnlyView(
+        array, array.indices()->data()->template GetValues<CodeT>(1),
+        *dictionary);
+  }
+
+  bool IsValid(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(i < (size_t)array_.length());
+    return array_.IsValid(i);
+  }
+
+  /// \returns the code of element i, which must be valid
+  code_type GetCode(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(IsValid(i));
+    return codes_[i];
+  }
+
+  /// \returns whether element i is valid and has the value of code, e.g.,
+  /// one from FindCode
+  bool HasCode(size_t i, code_type code) const {
+    return IsValid(i) && codes_[i] == code;
+  }
+
+  /// The number of values in the dictionary; codes are in [0, num_codes())
+  size_t num_codes() const { return dictionary_.length(); }
+
+  /// \returns the code of value, or nullopt if no element has it
+  std::optional<code_type> FindCode(const value_type& value) const {
+    for (int64_t code = 0; code < dictionary_.length(); ++code) {
+      if (dictionary_.IsValid(code) && Decode(code) == value) {
+        return static_cast<code_type>(code);
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// \returns the value of code
+  value_type Decode(code_type code) const {
+    if constexpr (kIsBinary) {
+      return dictionary_.GetString(code);
+    } else {
+      return dictionary_.Value(code);
+    }
+  }
+
+  /// \returns for every code the number of valid elements that have it
+  std::vector<uint64_t> CountByCode() const {
+    std::vector<uint64_t> counts(num_codes());
+    for (int64_t i = 0, length = array_.length(); i < length; ++i) {
+      if (IsValid(i)) {
+        ++counts[codes_[i]];
+      }
+    }
+    return counts;
+  }
+
+  value_type GetValue(size_t i) const { return Decode(GetCode(i)); }
+
+  value_type operator[](size_t i) const {
+    if (!IsValid(i)) {
+      return value_type{};
+    }
+    return GetValue(i);
+  }
+
+private:
+  DictionaryPropertyReadOnlyView(
+      const arrow::DictionaryArray& array, const CodeT* codes,
+      const ValueArrayType& dictionary)
+      : array_(array), codes_(codes), dictionary_(dictionary) {}
+
+  const arrow::DictionaryArray& array_;
+  const CodeT* codes_;
+  const ValueArrayType& dictionary_;
+};
+
 template <typename ArrowT, typename ViewT>
 struct Property {
   using ArrowType = ArrowT;
@@ -442,6 +646,18 @@ struct PODProperty
     : public Property<
           typename arrow::CTypeTraits<T>::ArrowType, PODPropertyView<U>> {};
 
+/// A NoNullsPODProperty is a PODProperty whose values are never null, e.g.,
+/// the output properties of an algorithm, viewed with a
+/// NoNullsPODPropertyView.
+///
+/// \tparam T the C type of the backing Arrow property
+/// \tparam U (optional) the C type of the viewed value
+template <typename T, typename U = T>
+struct NoNullsPODProperty
+    : public Property<
+          typename arrow::CTypeTraits<T>::ArrowType,
+          NoNullsPODPropertyView<U>> {};
+
 struct UInt8Property : public PODProperty<uint8_t> {};
 
 struct UInt16Property : public PODProperty<uint16_t> {};
@@ -469,6 +685,16 @@ struct LargeStringReadOnlyProperty
           arrow::LargeStringType,
           StringPropertyReadOnlyView<arrow::LargeStringArray>> {};
 
+/// A DictionaryReadOnlyProperty is a dictionary-encoded property viewed with
+/// a DictionaryPropertyReadOnlyView. Dictionary-encoded string columns of
+/// parquet files are read with the default types.
+template <
+    typename CodeT = int32_t, typename ValueArrayType = arrow::LargeStringArray>
+struct DictionaryReadOnlyProperty
+    : public Property<
+          arrow::DictionaryType,
+          DictionaryPropertyReadOnlyView<CodeT, ValueArrayType>> {};
+
 template <typename T>
 struct StructProperty
     : public Property<arrow::FixedSizeBinaryType, katana::PODPropertyView<T>> {
@@ -1,6 +1,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 
+#include <optional>
 #include <utility>
 
 #include <arrow/api.h>
@@ -9,6 +10,7 @@
 
 #include "katana/ArrowInterchange.h"
 #include "katana/Details.h"
+#include "katana/EntityTypeIndex.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
 #include "katana/GraphTopology.h"
@@ -54,9 +56,6 @@ public:
   using Edge = GraphTopology::Edge;
 
 private:
-  /// Validate performs a sanity check on the the graph after loading
-  Result<void> Validate();
-
   Result<void> DoWrite(
       tsuba::RDGHandle handle, const std::string& command_line,
       tsuba::RDG::RDGVersioningPolicy versioning_action);
@@ -71,11 +70,18 @@ private:
   Result<void> WriteView(
       const std::string& uri, const std::string& command_line);
 
+  /// In lazy mode, load the properties that entity types are derived from
+  Result<void> LoadLazyTypeProperties();
+
   tsuba::RDG rdg_;
   std::unique_ptr<tsuba::RDGFile> file_;
   GraphTopology topology_;
   PGViewCache pg_view_cache_;
 
+  /// Load properties on first access by name
+  /// (tsuba::RDGLoadOptions::lazy_properties)
+  bool lazy_properties_{false};
+
   /// Manages the relations between the node entity types
   EntityTypeManager node_entity_type_manager_;
 
@@ -86,16 +92,36 @@ private:
   katana::NUMAArray<EntityTypeID> node_entity_type_id_;
   /// The edge EntityTypeID for each edge's most specific type
   katana::NUMAArray<EntityTypeID> edge_entity_type_id_;
+  /// The nodes of each node entity type
+  EntityTypeIndex node_type_index_;
+  /// The edges of each edge entity type
+  EntityTypeIndex edge_type_index_;
 
   // List of node and edge indexes on this graph.
   std::vector<std::unique_ptr<PropertyIndex<GraphTopology::Node>>>
       node_indexes_;
   std::vector<std::unique_ptr<PropertyIndex<GraphTopology::Edge>>>
       edge_indexes_;
+  std::vector<std::unique_ptr<CompositePropertyIndex<GraphTopology::Node>>>
+      node_composite_indexes_;
+  std::vector<std::unique_ptr<CompositePropertyIndex<GraphTopology::Edge>>>
+      edge_composite_indexes_;
+
+  /// Make an index of `kind`, or of the stored kind if unset, using the
+  /// stored index if there is one for the current property
+  Result<void> DoMakeNodeIndex(
+      const std::string& column_name, std::optional<PropertyIndexKind> kind);
+  Result<void> DoMakeEdgeIndex(
+      const std::string& column_name, std::optional<PropertyIndexKind> kind);
+
+  /// Map the indexes stored with the graph
+  Result<void> LoadIndexes();
 
   // Keep partition_metadata, master_nodes, mirror_nodes out of the public interface,
   // while allowing Distribution to read/write it for RDG
   friend class Distribution;
+  // stores and loads view topologies with rdg_
+  friend class PGViewCache;
   const tsuba::PartitionMetadata& partition_metadata() const {
     return rdg_.part_metadata();
   }
@@ -255,6 +281,31 @@ public:
     return pg_view_cache_.BuildView<PGView>(this);
   }
 
+  /// The topology of this graph with its edges transposed and sorted as
+  /// given, built if needed and kept with the views of this graph; see
+  /// PGViewCache::GetEdgeShuffTopo. Its node ids are those of this graph,
+  /// its edge_property_index() maps its edges to edge properties.
+  const EdgeShuffleTopology& GetEdgeShuffleTopology(
+      const EdgeShuffleTopology::TransposeKind& tpose_kind,
+      const EdgeShuffleTopology::EdgeSortKind& sort_kind) noexcept {
+    return pg_view_cache_.GetEdgeShuffTopo(this, tpose_kind, sort_kind);
+  }
+
+  /// The statistics of the topology of this graph, computed on the first call
+  /// and kept with the views of this graph; see TopologyStatistics. This is
+  /// logically const since it only changes what is cached, and filling the
+  /// cache is locked so that concurrent callers are safe.
+  const TopologyStatistics& GetTopologyStatistics() const noexcept {
+    auto* self = const_cast<PropertyGraph*>(this);
+    return self->pg_view_cache_.GetTopologyStatistics(this);
+  }
+
+  /// Store the view topologies built so far with the next Write or Commit of
+  /// this graph; see PGViewCache::Persist
+  Result<void> PersistViewTopologies() noexcept {
+    return pg_view_cache_.Persist(this);
+  }
+
   PropertyGraph(
       katana::GraphTopology&& topo_to_assign,
       NUMAArray<EntityTypeID>&& node_entity_type_id,
@@ -267,7 +318,11 @@ public:
         node_entity_type_manager_(std::move(node_type_manager)),
         edge_entity_type_manager_(std::move(edge_type_manager)),
         node_entity_type_id_(std::move(node_entity_type_id)),
-        edge_entity_type_id_(std::move(edge_entity_type_id)) {}
+        edge_entity_type_id_(std::move(edge_entity_type_id)),
+        node_type_index_(EntityTypeIndex::Make(
+            node_entity_type_manager_, node_entity_type_id_)),
+        edge_type_index_(EntityTypeIndex::Make(
+            edge_entity_type_manager_, edge_entity_type_id_)) {}
 
   /// Make a property graph from a constructed RDG. Take ownership of the RDG
   /// and its underlying resources.
@@ -279,6 +334,16 @@ public:
       const std::string& rdg_name,
       const tsuba::RDGLoadOptions& opts = tsuba::RDGLoadOptions());
 
+  /// Make property graphs for several partitions of an RDG, reading up to
+  /// \param max_concurrent of them from storage at once (0 means all of
+  /// them). The i-th partition of \param partition_ids is read by threads
+  /// bound to socket i modulo the number of sockets so that its memory is
+  /// first touched there. opts.partition_id_to_load is ignored.
+  static Result<std::vector<std::unique_ptr<PropertyGraph>>> MakePartitions(
+      const std::string& rdg_name, const std::vector<uint32_t>& partition_ids,
+      const tsuba::RDGLoadOptions& opts = tsuba::RDGLoadOptions(),
+      uint32_t max_concurrent = 0);
+
   /// Make a property graph from topology
   static Result<std::unique_ptr<PropertyGraph>> Make(
       GraphTopology&& topo_to_assign);
@@ -303,9 +368,35 @@ public:
       const std::vector<std::string>& node_properties,
       const std::vector<std::string>& edge_properties) const;
 
+  /// \return A copy of this with the same set of loaded properties, which
+  ///       shares their Arrow columns with this; see the overload below.
+  Result<std::unique_ptr<PropertyGraph>> ShallowCopy() const;
+
+  /// A copy of this with a subset of its loaded properties that shares the
+  /// Arrow columns of the properties instead of copying them, and the
+  /// storage of an out-of-core topology; a topology in memory is copied.
+  /// Columns are replaced rather than changed by UpsertNodeProperties and
+  /// the like, so updates made that way to either graph do not reach the
+  /// other, and forking a graph costs about as much as its topology and
+  /// entity types. Writes through property views that change column buffers
+  /// in place, e.g., of TypedPropertyGraph, are seen by both graphs. The
+  /// copy is not backed by storage until it is written. Indexes and views
+  /// are not copied.
+  ///
+  /// \param node_properties The node properties to share; must be loaded.
+  /// \param edge_properties The edge properties to share; must be loaded.
+  Result<std::unique_ptr<PropertyGraph>> ShallowCopy(
+      const std::vector<std::string>& node_properties,
+      const std::vector<std::string>& edge_properties) const;
+
   /// Construct node & edge EntityTypeIDs from node & edge properties
   /// Also constructs metadata to convert between atomic types and EntityTypeIDs
   /// Assumes all boolean or uint8 properties are atomic types
+  /// Views built so far are patched for the entities whose types changed;
+  /// see PGViewCache::UpdateEntityTypes
+  /// Also builds the indexes read by DoesNodeHaveType, GetNumNodesOfType,
+  /// GetNodesOfType and their edge counterparts
+  /// Make already calls this for tsuba::RDGLoadOptions::pipelined loads
   /// TODO(roshan) move this to be a part of Make()
   Result<void> ConstructEntityTypeIDs();
 
@@ -334,6 +425,12 @@ public:
 
   const std::string& rdg_dir() const { return rdg_.rdg_dir().string(); }
 
+  /// The version of the RDG in rdg_dir() that has the topology of this
+  /// graph: the version it was loaded from or last stored as. Empty for
+  /// graphs that were never stored and after ReplaceTopology until the next
+  /// Commit, since no version has their topology.
+  std::optional<uint64_t> rdg_version() const;
+
   uint32_t partition_id() const { return rdg_.partition_id(); }
 
   // TODO(witchel): ChunkedArray is inherited from arrow::Table interface but this is
@@ -391,11 +488,23 @@ public:
   /// Tell the RDG where it's data is coming from
   Result<void> InformPath(const std::string& input_path);
 
-  /// Determine if two PropertyGraphs are Equal
+  /// Validate performs a sanity check on the the graph, e.g., after loading
+  /// or importing it: the numbers of rows of the property tables match the
+  /// numbers of nodes and edges and the topology is well formed; see
+  /// GraphTopology::Validate. The topology is checked in parallel.
+  Result<void> Validate() const;
+
+  /// Determine if two PropertyGraphs are Equal. Topologies and pieces of
+  /// property columns are compared in parallel.
   bool Equals(const PropertyGraph* other) const;
   /// Report the differences between two graphs
   std::string ReportDiff(const PropertyGraph* other) const;
 
+  /// A hash of the topology and of the node and edge properties, computed
+  /// in parallel. Graphs with different fingerprints are not Equals; see
+  /// katana::Fingerprint.
+  Result<uint64_t> Fingerprint() const;
+
   /// get the schema for loaded node properties
   std::shared_ptr<arrow::Schema> loaded_node_schema() const {
     return node_properties()->schema();
@@ -554,6 +663,10 @@ public:
   /// @param node_entity_type_id (need not be the most specific type)
   /// (assumes that the node entity type exists)
   bool DoesNodeHaveType(Node node, EntityTypeID node_entity_type_id) const {
+    if (const DynamicBitset* nodes =
+            node_type_index_.GetAtomicTypeBitset(node_entity_type_id)) {
+      return nodes->test(node);
+    }
     return IsNodeSubtypeOf(node_entity_type_id, GetTypeOfNode(node));
   }
 
@@ -561,9 +674,39 @@ public:
   /// @param edge_entity_type_id (need not be the most specific type)
   /// (assumes that the edge entity type exists)
   bool DoesEdgeHaveType(Edge edge, EntityTypeID edge_entity_type_id) const {
+    if (const DynamicBitset* edges =
+            edge_type_index_.GetAtomicTypeBitset(edge_entity_type_id)) {
+      return edges->test(edge);
+    }
     return IsEdgeSubtypeOf(edge_entity_type_id, GetTypeOfEdge(edge));
   }
 
+  /// \return the number of nodes that have the given entity type
+  /// @param node_entity_type_id (need not be the most specific type)
+  uint64_t GetNumNodesOfType(EntityTypeID node_entity_type_id) const {
+    return node_type_index_.GetNumEntitiesOfType(node_entity_type_id);
+  }
+
+  /// \return the number of edges that have the given entity type
+  /// @param edge_entity_type_id (need not be the most specific type)
+  uint64_t GetNumEdgesOfType(EntityTypeID edge_entity_type_id) const {
+    return edge_type_index_.GetNumEntitiesOfType(edge_entity_type_id);
+  }
+
+  /// \return the nodes that have the given entity type
+  /// @param node_entity_type_id in ascending order, e.g., for a do_all over
+  /// the nodes of a type
+  std::vector<Node> GetNodesOfType(EntityTypeID node_entity_type_id) const {
+    return node_type_index_.GetEntitiesOfType<Node>(node_entity_type_id);
+  }
+
+  /// \return the edges that have the given entity type
+  /// @param edge_entity_type_id in ascending order, e.g., for a do_all over
+  /// the edges of a type
+  std::vector<Edge> GetEdgesOfType(EntityTypeID edge_entity_type_id) const {
+    return edge_type_index_.GetEntitiesOfType<Edge>(edge_entity_type_id);
+  }
+
   // Return type dictated by arrow
   /// Returns the number of node properties
   int32_t GetNumNodeProperties() const {
@@ -601,7 +744,9 @@ public:
     return loaded_edge_schema()->GetFieldIndex(name) != -1;
   }
 
-  /// Get a node property by name.
+  /// Get a node property by name. If the graph was loaded with
+  /// tsuba::RDGLoadOptions::lazy_properties, only properties that are in
+  /// memory are found; see LoadLazyNodeProperties.
   ///
   /// \param name The name of the property to get.
   /// \return The property data or NULL if the property is not found.
@@ -631,6 +776,7 @@ public:
   template <typename T>
   Result<std::shared_ptr<typename arrow::CTypeTraits<T>::ArrayType>>
   GetNodePropertyTyped(const std::string& name) {
+    KATANA_CHECKED(LoadLazyNodeProperties({name}));
     auto chunked_array = GetNodeProperty(name);
     if (!chunked_array) {
       return ErrorCode::PropertyNotFound;
@@ -653,6 +799,7 @@ public:
   template <typename T>
   Result<std::shared_ptr<typename arrow::CTypeTraits<T>::ArrayType>>
   GetEdgePropertyTyped(const std::string& name) {
+    KATANA_CHECKED(LoadLazyEdgeProperties({name}));
     auto chunked_array = GetEdgeProperty(name);
     if (!chunked_array) {
       return ErrorCode::PropertyNotFound;
@@ -669,6 +816,31 @@ public:
 
   const GraphTopology& topology() const noexcept { return topology_; }
 
+  /// Place the topology for NUMA traversals; see
+  /// GraphTopology::PartitionForNUMA. Must not run concurrently with reads of
+  /// the topology.
+  void PartitionTopologyForNUMA() noexcept { topology_.PartitionForNUMA(); }
+
+  /// Move the topology into shared storage so that ShallowCopy shares it with
+  /// the copies instead of copying it; see GraphTopology::MakeShareable. Must
+  /// not run concurrently with reads of the topology.
+  void MakeTopologyShareable() noexcept {
+    topology_ = GraphTopology::MakeShareable(std::move(topology_));
+  }
+
+  /// Replace the topology, e.g., to apply a batch of updates to the graph,
+  /// along with the node and edge properties whose rows it renumbers.
+  /// \p node_properties and \p edge_properties replace the properties of the
+  /// same names, like UpsertNodeProperties; if the number of nodes (edges)
+  /// changes they must have every node (edge) property, otherwise they may be
+  /// null. Entity types are rebuilt from the properties and views and
+  /// indexes built so far are dropped. The next Commit writes the topology
+  /// and only the properties that were replaced.
+  Result<void> ReplaceTopology(
+      GraphTopology&& topology,
+      const std::shared_ptr<arrow::Table>& node_properties,
+      const std::shared_ptr<arrow::Table>& edge_properties);
+
   /// Add Node properties that do not exist in the current graph
   Result<void> AddNodeProperties(const std::shared_ptr<arrow::Table>& props);
   /// Add Edge properties that do not exist in the current graph
@@ -710,9 +882,58 @@ public:
   /// the table do nothing otherwise
   Result<void> EnsureEdgePropertyLoaded(const std::string& name);
 
+  /// If the graph was loaded with tsuba::RDGLoadOptions::lazy_properties,
+  /// load those of the named node properties that are in storage but not in
+  /// memory; do nothing otherwise. Names that are not properties of the
+  /// graph are skipped. The const accessors only see properties in memory,
+  /// so call this before them; the typed getters and TypedPropertyGraph::Make
+  /// call it themselves. Like the other loads it must not run concurrently
+  /// with reads of the property table.
+  Result<void> LoadLazyNodeProperties(const std::vector<std::string>& names);
+
+  /// The edge version of LoadLazyNodeProperties
+  Result<void> LoadLazyEdgeProperties(const std::vector<std::string>& names);
+
+  /// \returns true if the column of node property \param name is backed by
+  /// a local file rather than memory; see tsuba::RDG::IsNodePropertySpilled.
+  /// EnsureNodePropertyLoaded records a use of a loaded property, so
+  /// properties that are ensured before each use are spilled last.
+  bool IsNodePropertySpilled(const std::string& name) const {
+    return rdg_.IsNodePropertySpilled(name);
+  }
+
+  /// \returns true if the column of edge property \param name is backed by
+  /// a local file rather than memory
+  bool IsEdgePropertySpilled(const std::string& name) const {
+    return rdg_.IsEdgePropertySpilled(name);
+  }
+
+  /// Hint that the named node properties will be used soon. Those not in
+  /// memory are read from storage in the background and added to the node
+  /// property table by LoadLazyNodeProperties or EnsureNodePropertyLoaded.
+  Result<void> PrefetchNodeProperties(const std::vector<std::string>& names);
+
+  /// Hint that the named edge properties will be used soon; see
+  /// PrefetchNodeProperties
+  Result<void> PrefetchEdgeProperties(const std::vector<std::string>& names);
+
   std::vector<std::string> ListNodeProperties() const;
   std::vector<std::string> ListEdgeProperties() const;
 
+  /// \returns the statistics recorded when the node property \param name
+  /// was last stored; see tsuba::RDG::GetNodePropertyStats
+  Result<tsuba::ColumnStats> GetNodePropertyStats(
+      const std::string& name) const {
+    return rdg_.GetNodePropertyStats(name);
+  }
+
+  /// \returns the statistics recorded when the edge property \param name
+  /// was last stored
+  Result<tsuba::ColumnStats> GetEdgePropertyStats(
+      const std::string& name) const {
+    return rdg_.GetEdgePropertyStats(name);
+  }
+
   /// Remove all node properties
   void DropNodeProperties() { rdg_.DropNodeProperties(); }
   /// Remove all edge properties
@@ -808,11 +1029,37 @@ public:
     return node_iterator(node_id);
   }
 
-  // Creates an index over a node property.
-  Result<void> MakeNodeIndex(const std::string& column_name);
+  // Creates an index over a node property. If the graph was loaded with an
+  // index of this kind over the current property, the stored index is used.
+  Result<void> MakeNodeIndex(
+      const std::string& column_name,
+      PropertyIndexKind kind = PropertyIndexKind::kSorted) {
+    return DoMakeNodeIndex(column_name, kind);
+  }
+
+  // Creates an index over an edge property; see MakeNodeIndex.
+  Result<void> MakeEdgeIndex(
+      const std::string& column_name,
+      PropertyIndexKind kind = PropertyIndexKind::kSorted) {
+    return DoMakeEdgeIndex(column_name, kind);
+  }
+
+  // Store the node and edge indexes with the next Write or Commit of this
+  // graph so that loading the graph maps them instead of building them.
+  // Call after the last change to the indexed properties; stored indexes are
+  // dropped when their properties are replaced by later stores.
+  Result<void> PersistIndexes();
 
-  // Creates an index over an edge property.
-  Result<void> MakeEdgeIndex(const std::string& column_name);
+  // Creates an index over several node properties for lookups on a prefix
+  // of the columns and range scans; see CompositePropertyIndex. Composite
+  // indexes are not stored with the graph.
+  Result<void> MakeNodeCompositeIndex(
+      const std::vector<std::string>& column_names);
+
+  // Creates an index over several edge properties; see
+  // MakeNodeCompositeIndex.
+  Result<void> MakeEdgeCompositeIndex(
+      const std::vector<std::string>& column_names);
 
   // Returns the list of node indexes.
   const std::vector<std::unique_ptr<PropertyIndex<GraphTopology::Node>>>&
@@ -825,16 +1072,36 @@ public:
   edge_indexes() const {
     return edge_indexes_;
   }
+
+  // Returns the list of node composite indexes.
+  const std::vector<
+      std::unique_ptr<CompositePropertyIndex<GraphTopology::Node>>>&
+  node_composite_indexes() const {
+    return node_composite_indexes_;
+  }
+
+  // Returns the list of edge composite indexes.
+  const std::vector<
+      std::unique_ptr<CompositePropertyIndex<GraphTopology::Edge>>>&
+  edge_composite_indexes() const {
+    return edge_composite_indexes_;
+  }
 };
 
 /// SortAllEdgesByDest sorts edges for each node by destination
 /// IDs (ascending order).
 ///
 /// Returns the permutation vector (mapping from old
-/// indices to the new indices) which results due to  sorting.
+/// indices to the new indices) which results due to  sorting. An out-of-core
+/// or shared topology is first copied into memory of the graph's own.
 KATANA_EXPORT Result<std::unique_ptr<katana::NUMAArray<uint64_t>>>
 SortAllEdgesByDest(PropertyGraph* pg);
 
+/// SortAllEdgesAndPropertiesByDest sorts the edges of each node by
+/// destination like SortAllEdgesByDest and permutes every edge property to
+/// match. Unloaded edge properties are loaded first.
+KATANA_EXPORT Result<void> SortAllEdgesAndPropertiesByDest(PropertyGraph* pg);
+
 /// FindEdgeSortedByDest finds the "node_to_find" id in the
 /// sorted edgelist of the "node" using binary search.
 ///
@@ -847,10 +1114,24 @@ KATANA_EXPORT GraphTopology::Edge FindEdgeSortedByDest(
     GraphTopology::Node node_to_find);
 
 /// Renumber all nodes in the graph by sorting in the descending
-/// order by node degree.
+/// order by node degree. Like SortAllEdgesByDest, an out-of-core or shared
+/// topology is first copied into memory of the graph's own.
 // TODO(amber): this method should return a new sorted topology
 KATANA_EXPORT Result<void> SortNodesByDegree(PropertyGraph* pg);
 
+/// Renumber the nodes like SortNodesByDegree and permute every node and edge
+/// property to match, as ReorderNodes does.
+KATANA_EXPORT Result<void> SortNodesAndPropertiesByDegree(PropertyGraph* pg);
+
+/// Renumber the nodes of \p pg so that node i is node \p order[i] of the
+/// original graph, e.g., an order from katana/NodeOrdering.h, and permute
+/// every node and edge property to match; the edges of each node keep their
+/// order. Unloaded properties are loaded first. Properties are gathered in
+/// parallel one at a time, so at most one column is copied at once. The next
+/// Commit writes the topology and all of the properties.
+KATANA_EXPORT Result<void> ReorderNodes(
+    PropertyGraph* pg, const GraphTopologyTypes::PropIndexVec& order);
+
 /// Creates in-memory symmetric (or undirected) graph.
 ///
 /// This function creates an symmetric or undirected version of the
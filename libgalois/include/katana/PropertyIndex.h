@@ -1,49 +1,50 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTYINDEX_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTYINDEX_H_
 
-#include <set>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <string>
-#include <variant>
+#include <string_view>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/array.h>
 #include <arrow/type_traits.h>
-#include <boost/iterator/iterator_categories.hpp>
-#include <boost/iterator/iterator_facade.hpp>
 
+#include "katana/NUMAArray.h"
+#include "katana/Range.h"
 #include "katana/Result.h"
 #include "katana/config.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/FileView.h"
 
 namespace katana {
 
+enum class PropertyIndexKind {
+  // Entities sorted by property value: ordered searches in O(log n).
+  kSorted,
+  // kSorted plus an open addressing hash table over the distinct values, so
+  // that Find takes expected constant time.
+  kHash,
+};
+
 // PropertyIndex provides an interface similar to an ordered container
 // over a single property.
+//
+// The index is a flat array of the node or edge ids with a valid property
+// value sorted by (value, id), which takes a few bytes per entry and is built
+// with a parallel sort. Indexes can be stored with the graph (see
+// PropertyGraph::PersistIndexes) and mapped back instead of rebuilt.
 template <typename node_or_edge>
 class KATANA_EXPORT PropertyIndex {
 public:
-  // Type-safe container for node and edge ids to avoid overlap with the
-  // primitive types we are indexing.
-  struct IndexId {
-    node_or_edge id;
-  };
-
-  // The set key type is either a node/edge id (all the keys in the actual set)
-  // or a value representing the search key.
-  using set_key_type = typename std::variant<
-      IndexId, bool, int64_t, double_t, std::string_view*>;
-
-  // PropertyIndex::iterator returns a sequence of node or edge ids.
-  using base_iterator = typename std::multiset<set_key_type>::iterator;
-  class iterator : public base_iterator {
-  public:
-    explicit iterator(const base_iterator& base) : base_iterator(base) {}
-    const node_or_edge& operator*() const {
-      return std::get<IndexId>(base_iterator::operator*()).id;
-    }
-  };
+  // PropertyIndex::iterator returns a sequence of node or edge ids in
+  // increasing order of their property value.
+  using iterator = const node_or_edge*;
 
-  PropertyIndex(std::string column_name)
-      : column_name_(std::move(column_name)) {}
+  PropertyIndex(std::string column_name, PropertyIndexKind kind)
+      : column_name_(std::move(column_name)), kind_(kind) {}
 
   PropertyIndex(const PropertyIndex&) = delete;
   PropertyIndex& operator=(const PropertyIndex&) = delete;
@@ -55,14 +56,93 @@ public:
   // The name of the indexed property.
   std::string column_name() { return column_name_; }
 
-  virtual iterator begin() = 0;
-  virtual iterator end() = 0;
+  PropertyIndexKind kind() const { return kind_; }
+
+  iterator begin() const { return ids_.data(); }
+  iterator end() const { return ids_.data() + ids_.size(); }
+
+  // The number of entities with a valid property value.
+  size_t size() const { return ids_.size(); }
 
   virtual Result<void> BuildFromProperty() = 0;
-  // virtual Result<void> BuildFromFile() = 0;
+
+  // Uses the arrays of an index written by ToFile in `file_view`, which is
+  // usually a mapping of the file, instead of building the index. Fails if
+  // the file is not an index of this kind over a property of this type and
+  // length, in which case the index is unchanged.
+  Result<void> BuildFromFile(tsuba::FileView&& file_view);
+
+  // Serializes the index for BuildFromFile.
+  Result<std::unique_ptr<tsuba::FileFrame>> ToFile() const;
+
+  // true if the index refers to a file read by BuildFromFile
+  bool is_from_file() const { return storage_ != nullptr; }
+
+protected:
+  static constexpr uint64_t kEmptySlot = ~uint64_t{0};
+
+  static uint64_t MixHash(uint64_t hash) {
+    // finalizer of MurmurHash3; std::hash of integers is often the identity
+    hash ^= hash >> 33;
+    hash *= UINT64_C(0xff51afd7ed558ccd);
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  // Returns the first id of the run of ids at the offset in the hash table
+  // for which `matches(offset)`, or end().
+  template <typename Matches>
+  iterator FindSlot(uint64_t hash, Matches matches) const {
+    if (slots_.empty()) {
+      return end();
+    }
+    uint64_t mask = slots_.size() - 1;
+    for (uint64_t s = MixHash(hash) & mask;; s = (s + 1) & mask) {
+      uint64_t offset = slots_[s];
+      if (offset == kEmptySlot) {
+        return end();
+      }
+      if (matches(offset)) {
+        return begin() + offset;
+      }
+    }
+  }
+
+  // Builds ids_ from the ids in [0, num_entities) for which `is_valid`
+  // holds, ordered by `less` and then by id.
+  template <typename IsValid, typename Less>
+  void BuildIds(size_t num_entities, IsValid is_valid, Less less);
+
+  // For kHash, builds slots_ with the offset in ids_ of the first id of each
+  // run of `equal` ids, hashed by `hash`.
+  template <typename Hash, typename Equal>
+  void BuildSlots(Hash hash, Equal equal);
+
+  // The number of entities the index was built over.
+  virtual size_t num_entities() const = 0;
+  // The arrow type of the indexed property.
+  virtual arrow::Type::type property_type() const = 0;
+
+  // The values that subclasses keep for each element of ids_, if any, which
+  // are stored with the index.
+  virtual size_t value_size() const { return 0; }
+  virtual const void* values_data() const { return nullptr; }
+  // Refer to stored values read by BuildFromFile.
+  virtual void WrapValues(void* data, size_t num_values) {
+    (void)data;
+    (void)num_values;
+  }
+
+  NUMAArray<node_or_edge> ids_;
+  // power of two sized open addressing table; entries are offsets into ids_
+  // or kEmptySlot
+  NUMAArray<uint64_t> slots_;
+  // owner of the arrays of an index read by BuildFromFile
+  std::shared_ptr<const void> storage_;
 
 private:
   std::string column_name_;
+  PropertyIndexKind kind_;
 };
 
 // PrimitivePropertyIndex provides a PropertyIndex for primitive types.
@@ -71,163 +151,214 @@ class KATANA_EXPORT PrimitivePropertyIndex
     : public PropertyIndex<node_or_edge> {
 public:
   using ArrowArrayType = typename arrow::CTypeTraits<c_type>::ArrayType;
-  using IndexId = typename PropertyIndex<node_or_edge>::IndexId;
   using iterator = typename PropertyIndex<node_or_edge>::iterator;
-  using set_key_type = typename PropertyIndex<node_or_edge>::set_key_type;
 
   PrimitivePropertyIndex(
       const std::string& column, size_t num_entities,
-      std::shared_ptr<arrow::Array> property)
-      : PropertyIndex<node_or_edge>(column),
+      std::shared_ptr<arrow::Array> property,
+      PropertyIndexKind kind = PropertyIndexKind::kSorted)
+      : PropertyIndex<node_or_edge>(column, kind),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<ArrowArrayType>(property)),
-        set_(PropertyCompare(property_)) {}
-
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
-
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not seem to specify that
-  // multiset::find returns the first value, though it appears so in practice.
-  iterator Find(c_type key) {
-    auto it = set_.lower_bound(key);
-    if (it == set_.end() ||
-        property_->Value(std::get<IndexId>(*it).id) != key) {
-      return end();
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
+  iterator Find(c_type key) const {
+    if (this->kind() == PropertyIndexKind::kHash) {
+      return this->FindSlot(
+          std::hash<c_type>{}(key),
+          [&](uint64_t offset) { return values_[offset] == key; });
+    }
+    iterator it = LowerBound(key);
+    if (it == this->end() || values_[it - this->begin()] != key) {
+      return this->end();
     }
-    return iterator(it);
+    return it;
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(c_type key) { return iterator(set_.lower_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater
+  // than or equal to `key`.
+  iterator LowerBound(c_type key) const {
+    return this->begin() +
+           (std::lower_bound(values_.begin(), values_.end(), key) -
+            values_.begin());
+  }
 
-  // Returns an iterator to the first element in the set that is greater than
-  // `key`.
-  iterator UpperBound(c_type key) { return iterator(set_.upper_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater
+  // than `key`.
+  iterator UpperBound(c_type key) const {
+    return this->begin() +
+           (std::upper_bound(values_.begin(), values_.end(), key) -
+            values_.begin());
+  }
 
 private:
-  class PropertyCompare {
-  public:
-    PropertyCompare(std::shared_ptr<ArrowArrayType> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a literal key_type or a node/edge.
-      c_type val_a = GetValue(a);
-      c_type val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<c_type>{}(val_a, val_b);
-    }
-
-  private:
-    c_type GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexId>(a)) {
-        node_or_edge id = std::get<IndexId>(a).id;
-        c_type val = property_->Value(id);
-        return val;
-      }
-      return std::get<c_type>(a);
-    }
-
-    std::shared_ptr<ArrowArrayType> property_;
-  };
-
   Result<void> BuildFromProperty() override;
-  // Result<void> BuildFromFile(...) override;
+
+  size_t num_entities() const override { return num_entities_; }
+  arrow::Type::type property_type() const override {
+    return arrow::CTypeTraits<c_type>::ArrowType::type_id;
+  }
+  size_t value_size() const override { return sizeof(c_type); }
+  const void* values_data() const override { return values_.data(); }
+  void WrapValues(void* data, size_t num_values) override {
+    values_ = NUMAArray<c_type>(data, num_values);
+  }
 
   size_t num_entities_;
   std::shared_ptr<ArrowArrayType> property_;
-  std::multiset<set_key_type, PropertyCompare> set_;
+  // the property value of each element of ids_, so that searches scan one
+  // contiguous array rather than the property through ids_
+  NUMAArray<c_type> values_;
 };
 
 // StringPropertyIndex provides a PropertyIndex for strings.
 template <typename node_or_edge>
 class KATANA_EXPORT StringPropertyIndex : public PropertyIndex<node_or_edge> {
 public:
-  using IndexId = typename PropertyIndex<node_or_edge>::IndexId;
   using iterator = typename PropertyIndex<node_or_edge>::iterator;
-  using set_key_type = typename PropertyIndex<node_or_edge>::set_key_type;
 
   StringPropertyIndex(
       const std::string& column_name, size_t num_entities,
-      const std::shared_ptr<arrow::Array>& property)
-      : PropertyIndex<node_or_edge>(column_name),
+      const std::shared_ptr<arrow::Array>& property,
+      PropertyIndexKind kind = PropertyIndexKind::kSorted)
+      : PropertyIndex<node_or_edge>(column_name, kind),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<arrow::LargeStringArray>(property)),
-        set_(StringCompare(property_)) {}
-
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
-
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not appear to specify that
-  // multiset::find returns the first value, though it appears so in practice.
-  iterator Find(std::string_view key) {
-    auto it = set_.lower_bound(&key);
-    if (it != set_.end()) {
-      arrow::util::string_view arrow_view =
-          property_->GetView(std::get<IndexId>(*it).id);
-      if (std::string_view(arrow_view.data(), arrow_view.length()) != key) {
-        return end();
-      }
+        property_(
+            std::static_pointer_cast<arrow::LargeStringArray>(property)) {}
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
+  iterator Find(std::string_view key) const {
+    if (this->kind() == PropertyIndexKind::kHash) {
+      return this->FindSlot(
+          std::hash<std::string_view>{}(key), [&](uint64_t offset) {
+            return GetValue(this->ids_[offset]) == key;
+          });
     }
-    return iterator(it);
+    iterator it = LowerBound(key);
+    if (it == this->end() || GetValue(*it) != key) {
+      return this->end();
+    }
+    return it;
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(std::string_view key) {
-    return iterator(set_.lower_bound(&key));
+  // Returns an iterator to the first element in the index that is greater
+  // than or equal to `key`.
+  iterator LowerBound(std::string_view key) const {
+    return std::lower_bound(
+        this->begin(), this->end(), key,
+        [&](node_or_edge id, std::string_view k) { return GetValue(id) < k; });
   }
 
-  // Returns an iterator to the first element in the set that is greater than
-  // `key`.
-  iterator UpperBound(std::string_view key) {
-    return iterator(set_.upper_bound(&key));
+  // Returns an iterator to the first element in the index that is greater
+  // than `key`.
+  iterator UpperBound(std::string_view key) const {
+    return std::upper_bound(
+        this->begin(), this->end(), key,
+        [&](std::string_view k, node_or_edge id) { return k < GetValue(id); });
   }
 
 private:
-  class StringCompare {
-  public:
-    StringCompare(std::shared_ptr<arrow::LargeStringArray> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a pointer to a string_view or a node/edge.
-      std::string_view val_a = GetValue(a);
-      std::string_view val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<std::string_view>{}(val_a, val_b);
-    }
+  std::string_view GetValue(node_or_edge id) const {
+    arrow::util::string_view arrow_view = property_->GetView(id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  }
 
-  private:
-    std::string_view GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexId>(a)) {
-        arrow::util::string_view arrow_view =
-            property_->GetView(std::get<IndexId>(a).id);
-        return std::string_view(arrow_view.data(), arrow_view.length());
-      }
-      return *std::get<std::string_view*>(a);
-    }
+  Result<void> BuildFromProperty() override;
+
+  size_t num_entities() const override { return num_entities_; }
+  arrow::Type::type property_type() const override {
+    return arrow::Type::LARGE_STRING;
+  }
+
+  size_t num_entities_;
+  std::shared_ptr<arrow::LargeStringArray> property_;
+};
+
+namespace internal {
+// Compares the values of one column of a CompositePropertyIndex
+class IndexKeyColumn;
+}  // namespace internal
+
+// CompositePropertyIndex orders entities by the values of several properties
+// compared lexicographically, so that lookups on a prefix of the columns and
+// range scans on the column after the prefix return contiguous runs of ids.
+//
+// Keys are given as arrow scalars, which are cast to the type of their
+// column. Entities with a null value in any of the columns are not indexed.
+// Supported column types are booleans, integers, floating point numbers and
+// strings.
+template <typename node_or_edge>
+class KATANA_EXPORT CompositePropertyIndex
+    : public PropertyIndex<node_or_edge> {
+public:
+  using iterator = typename PropertyIndex<node_or_edge>::iterator;
+  using Key = std::vector<std::shared_ptr<arrow::Scalar>>;
+
+  // A run of ids in the order of the index
+  using IdRange = StandardRange<iterator>;
+
+  CompositePropertyIndex(
+      const std::vector<std::string>& column_names, size_t num_entities,
+      std::vector<std::shared_ptr<arrow::Array>> properties);
 
-    std::shared_ptr<arrow::LargeStringArray> property_;
-  };
+  ~CompositePropertyIndex() override;
+
+  const std::vector<std::string>& column_names() const {
+    return column_names_;
+  }
 
   Result<void> BuildFromProperty() override;
-  // virtual Result<void> BuildFromFile(...) override;
 
+  // Returns the entities whose first prefix.size() properties are equal to
+  // `prefix`. An empty prefix matches every indexed entity.
+  Result<IdRange> EqualRange(const Key& prefix) const;
+
+  // Returns the entities whose first prefix.size() properties are equal to
+  // `prefix` and whose next property is in [lower, upper]. A null bound is
+  // unbounded on that side.
+  Result<IdRange> Range(
+      const Key& prefix, const std::shared_ptr<arrow::Scalar>& lower,
+      const std::shared_ptr<arrow::Scalar>& upper) const;
+
+  // Returns the comma separated names of the columns of an index over
+  // `column_names`, which is also its column_name().
+  static std::string JoinColumnNames(
+      const std::vector<std::string>& column_names);
+
+private:
+  size_t num_entities() const override { return num_entities_; }
+  arrow::Type::type property_type() const override {
+    return arrow::Type::STRUCT;
+  }
+
+  // Cast the scalars of `key` to the types of the first key.size() columns.
+  Result<Key> CastKey(const Key& key) const;
+  // Returns <0, 0 or >0 as the first key.size() properties of `id` are less
+  // than, equal to or greater than `key`.
+  int CompareToKey(node_or_edge id, const Key& key) const;
+  iterator LowerBound(const Key& key) const;
+  iterator UpperBound(const Key& key) const;
+
+  std::vector<std::string> column_names_;
   size_t num_entities_;
-  std::shared_ptr<arrow::LargeStringArray> property_;
-  std::multiset<set_key_type, StringCompare> set_;
-};  // namespace katana
+  std::vector<std::shared_ptr<arrow::Array>> properties_;
+  std::vector<std::unique_ptr<internal::IndexKeyColumn>> columns_;
+};
+
+// Returns the kind of the index stored in `file_view` by
+// PropertyIndex::ToFile.
+KATANA_EXPORT Result<PropertyIndexKind> StoredIndexKind(
+    const tsuba::FileView& file_view);
 
 // Create a PropertyIndex with the apropriate type for 'property'. Does not
 // build the index.
 template <typename node_or_edge>
 Result<std::unique_ptr<PropertyIndex<node_or_edge>>> MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property,
+    PropertyIndexKind kind = PropertyIndexKind::kSorted);
 
 }  // namespace katana
 
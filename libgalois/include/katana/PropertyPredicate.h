@@ -0,0 +1,68 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PROPERTYPREDICATE_H_
+#define KATANA_LIBGALOIS_KATANA_PROPERTYPREDICATE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+enum class CompareOp {
+  kEqual,
+  kNotEqual,
+  kLess,
+  kLessEqual,
+  kGreater,
+  kGreaterEqual,
+};
+
+/// A comparison of the values of a property with a constant, e.g.,
+/// {"age", CompareOp::kGreaterEqual, arrow::MakeScalar(int64_t{18})}. The
+/// value is compared as arrow::compute compares it, so it may have another
+/// numeric type than the property. Null rows never satisfy it.
+/// Dictionary-encoded properties are compared through their dictionaries,
+/// so their rows are not decoded.
+struct KATANA_EXPORT PropertyPredicate {
+  std::string property;
+  CompareOp op;
+  std::shared_ptr<arrow::Scalar> value;
+};
+
+/// \returns the selection of the nodes of \param pg whose properties satisfy
+/// every one of \param predicates, a bitset with a bit per node
+///
+/// Predicates are evaluated with the comparison kernels of arrow::compute,
+/// on blocks of rows in parallel, and their results are intersected a word
+/// at a time, so there are no checks per node. The selection can be used
+/// directly by SubGraphSelect and SubGraphExtraction, be intersected with
+/// other selections, e.g., through DynamicBitset::bitwise_and, or give the
+/// sources of analytics with DynamicBitset::GetOffsets.
+KATANA_EXPORT Result<DynamicBitset> SelectNodes(
+    const PropertyGraph& pg, const std::vector<PropertyPredicate>& predicates);
+
+/// \returns the selection of the edges of \param pg whose properties
+/// satisfy every one of \param predicates; see SelectNodes
+KATANA_EXPORT Result<DynamicBitset> SelectEdges(
+    const PropertyGraph& pg, const std::vector<PropertyPredicate>& predicates);
+
+/// \returns the selection of the nodes of \param pg that have the entity
+/// type \param type_id (need not be the most specific type), e.g., to
+/// intersect with a selection by properties
+KATANA_EXPORT DynamicBitset SelectNodesOfType(
+    const PropertyGraph& pg, EntityTypeID type_id);
+
+/// \returns the selection of the edges of \param pg that have the entity
+/// type \param type_id; see SelectNodesOfType
+KATANA_EXPORT DynamicBitset SelectEdgesOfType(
+    const PropertyGraph& pg, EntityTypeID type_id);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SCRATCHARENA_H_
+#define KATANA_LIBGALOIS_KATANA_SCRATCHARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// A bump allocator for the temporaries of loop iterations, e.g., the list of
+/// neighbors an operator collects for one node. Allocating is a pointer
+/// bump, freeing an allocation does nothing, and Release frees everything
+/// allocated since a Mark at once. Released blocks are kept for later
+/// allocations, so once an arena has grown to the largest working set of an
+/// iteration, iterations no longer call malloc.
+///
+/// Each thread has its own arena, Local(), so operators of any loop (do_all,
+/// for_each, on_each) can use it without synchronization. Use a ScratchScope
+/// to release what an iteration allocated and ScratchAllocator or
+/// ScratchVector for containers:
+///
+/// \code
+/// katana::do_all(katana::iterate(graph), [&](auto n) {
+///   katana::ScratchScope scope;
+///   katana::ScratchVector<Node> neighbors;
+///   ...
+/// });
+/// \endcode
+///
+/// Unlike PerIterAllocTy, which the for_each executor resets between
+/// iterations, the arena is only released by its users. Memory must not be
+/// used after it is released, and an arena must only be used by its thread.
+class KATANA_EXPORT ScratchArena {
+public:
+  /// A position of the arena; see Release
+  struct Mark {
+    size_t block{0};
+    size_t offset{0};
+  };
+
+  /// Bytes of the blocks allocated for small requests; larger requests get
+  /// blocks of their own, which are kept like the others
+  static constexpr size_t kBlockSize = 64 << 10;
+
+  ScratchArena() = default;
+  ~ScratchArena();
+
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  /// \returns the arena of the calling thread
+  static ScratchArena& Local();
+
+  /// \returns \param bytes of memory aligned to \param alignment, a power of
+  /// two, valid until the arena is released past the current mark
+  void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+    if (current_ > 0) {
+      const Block& block = blocks_[current_ - 1];
+      uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+      uintptr_t begin = (base + offset_ + alignment - 1) & ~(alignment - 1);
+      if (begin + bytes <= base + block.size) {
+        offset_ = begin + bytes - base;
+        return reinterpret_cast<void*>(begin);
+      }
+    }
+    return AllocateSlow(bytes, alignment);
+  }
+
+  /// \returns the current position, to Release back to
+  Mark GetMark() const { return Mark{current_, offset_}; }
+
+  /// Free everything allocated since \param mark was taken. Marks taken
+  /// after it become invalid.
+  void Release(const Mark& mark) {
+    current_ = mark.block;
+    offset_ = mark.offset;
+  }
+
+  /// Free everything allocated from the arena
+  void Reset() { Release(Mark{}); }
+
+  /// \returns the bytes of the blocks held by the arena
+  size_t bytes_reserved() const;
+
+private:
+  struct Block {
+    char* data;
+    size_t size;
+  };
+
+  void* AllocateSlow(size_t bytes, size_t alignment);
+
+  /// blocks_[0, current_) are in use; later blocks are free
+  std::vector<Block> blocks_;
+  size_t current_{0};
+  /// bytes used of blocks_[current_ - 1]
+  size_t offset_{0};
+};
+
+/// Releases what the arena of a thread allocated while the scope was alive.
+/// Containers using the arena must be declared after the scope so that they
+/// are destroyed before it.
+class ScratchScope {
+public:
+  explicit ScratchScope(ScratchArena* arena = &ScratchArena::Local())
+      : arena_(arena), mark_(arena->GetMark()) {}
+  ~ScratchScope() { arena_->Release(mark_); }
+
+  ScratchScope(const ScratchScope&) = delete;
+  ScratchScope& operator=(const ScratchScope&) = delete;
+
+  ScratchArena* arena() const { return arena_; }
+
+private:
+  ScratchArena* arena_;
+  ScratchArena::Mark mark_;
+};
+
+/// An STL allocator from a ScratchArena: the arena of the constructing
+/// thread unless one is given. Deallocation does nothing, so containers that
+/// grow leave their old buffers in the arena until it is released; reserve
+/// sizes that are known up front.
+template <typename T>
+class ScratchAllocator {
+public:
+  using value_type = T;
+
+  ScratchAllocator() noexcept : arena_(&ScratchArena::Local()) {}
+  explicit ScratchAllocator(ScratchArena* arena) noexcept : arena_(arena) {}
+
+  template <typename U>
+  ScratchAllocator(const ScratchAllocator<U>& other) noexcept
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t) noexcept {}
+
+  ScratchArena* arena() const { return arena_; }
+
+  template <typename U>
+  bool operator==(const ScratchAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+
+  template <typename U>
+  bool operator!=(const ScratchAllocator<U>& other) const {
+    return arena_ != other.arena();
+  }
+
+private:
+  ScratchArena* arena_;
+};
+
+/// A std::vector whose buffers are allocated from a ScratchArena
+template <typename T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>;
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SCRATCHHASHMAP_H_
+#define KATANA_LIBGALOIS_KATANA_SCRATCHHASHMAP_H_
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+
+namespace katana {
+
+namespace internal {
+
+/// Fibonacci hashing: spreads consecutive hashes, e.g., of integers under
+/// std::hash, over the top \param log_slots bits
+inline size_t
+HashToSlot(size_t hash, uint32_t log_slots) {
+  KATANA_LOG_DEBUG_ASSERT(log_slots > 0 && log_slots < 64);
+  return (static_cast<uint64_t>(hash) * UINT64_C(0x9E3779B97F4A7C15)) >>
+         (64 - log_slots);
+}
+
+}  // namespace internal
+
+/// A linear probing hash map meant to be cleared and refilled many times,
+/// e.g., a per-thread map from the clusters of the neighbors of a node to
+/// their edge weights, rebuilt for every node of a loop. Its storage only
+/// grows, so once warmed up the map does not allocate, and Clear takes time
+/// proportional to the number of entries rather than to the capacity.
+///
+/// Entries are kept contiguously in insertion order, which is the order of
+/// iteration. Keys must not be changed through iterators.
+///
+/// The allocator may be a per-iteration allocator, e.g., PerIterAllocTy,
+/// for maps that live for one iteration of a for_each. Not thread safe; see
+/// ConcurrentHashMap for a shared map.
+template <
+    typename Key, typename Value, typename Hash = std::hash<Key>,
+    typename Alloc = std::allocator<char>>
+class ScratchHashMap {
+  template <typename T>
+  using Rebind =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+public:
+  using value_type = std::pair<Key, Value>;
+  using Entries = std::vector<value_type, Rebind<value_type>>;
+  using iterator = typename Entries::iterator;
+  using const_iterator = typename Entries::const_iterator;
+
+  explicit ScratchHashMap(const Alloc& alloc = Alloc())
+      : entries_(Rebind<value_type>(alloc)),
+        slots_(Rebind<uint32_t>(alloc)),
+        entry_slots_(Rebind<uint32_t>(alloc)) {}
+
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  iterator begin() { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+
+  /// \returns the value of \param key, inserting a value-initialized one if
+  /// the key is absent
+  Value& operator[](const Key& key) {
+    if (2 * (entries_.size() + 1) > slots_.size()) {
+      Grow();
+    }
+    size_t slot = FindSlot(key);
+    if (slots_[slot] == kEmpty) {
+      slots_[slot] = entries_.size();
+      entry_slots_.push_back(slot);
+      entries_.emplace_back(key, Value{});
+    }
+    return entries_[slots_[slot]].second;
+  }
+
+  /// \returns the value of \param key or null if the key is absent
+  Value* Find(const Key& key) {
+    if (slots_.empty()) {
+      return nullptr;
+    }
+    uint32_t entry = slots_[FindSlot(key)];
+    return entry == kEmpty ? nullptr : &entries_[entry].second;
+  }
+
+  const Value* Find(const Key& key) const {
+    return const_cast<ScratchHashMap*>(this)->Find(key);
+  }
+
+  /// Removes all entries but keeps the storage
+  void Clear() {
+    for (uint32_t slot : entry_slots_) {
+      slots_[slot] = kEmpty;
+    }
+    entries_.clear();
+    entry_slots_.clear();
+  }
+
+private:
+  static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+  static constexpr uint32_t kInitialLogSlots = 4;
+
+  /// \returns the slot of \param key or the empty slot where it would go
+  size_t FindSlot(const Key& key) const {
+    size_t mask = slots_.size() - 1;
+    for (size_t slot = internal::HashToSlot(hash_(key), log_slots_);;
+         slot = (slot + 1) & mask) {
+      uint32_t entry = slots_[slot];
+      if (entry == kEmpty || entries_[entry].first == key) {
+        return slot;
+      }
+    }
+  }
+
+  void Grow() {
+    log_slots_ = slots_.empty() ? kInitialLogSlots : log_slots_ + 1;
+    slots_.assign(size_t{1} << log_slots_, kEmpty);
+    for (uint32_t entry = 0; entry < entries_.size(); ++entry) {
+      size_t slot = FindSlot(entries_[entry].first);
+      slots_[slot] = entry;
+      entry_slots_[entry] = slot;
+    }
+  }
+
+  Entries entries_;
+  /// index in entries_ of the entry in each slot, or kEmpty
+  std::vector<uint32_t, Rebind<uint32_t>> slots_;
+  /// slot of each entry, so that Clear only visits the used slots
+  std::vector<uint32_t, Rebind<uint32_t>> entry_slots_;
+  uint32_t log_slots_{0};
+  Hash hash_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SETINTERSECTION_H_
+#define KATANA_LIBGALOIS_KATANA_SETINTERSECTION_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Intersections of sets of node ids, e.g., the destinations of the edges
+/// of a node in a topology with edges sorted by destination. Sorted sets
+/// are arrays of strictly increasing values.
+///
+/// When one set is much larger than the other, the elements of the smaller
+/// one are found in the larger one by galloping (exponential search), so
+/// the intersection takes time in the size of the smaller set rather than
+/// in the sum of the sizes. Sets of similar sizes are merged, a block of
+/// elements at a time with SIMD instructions if the CPU has them.
+
+/// Sets whose sizes differ by at least this factor are intersected by
+/// galloping rather than by merging
+constexpr size_t kGallopRatio = 32;
+
+/// A set at least this large that is intersected with many others, like the
+/// neighbors of a hub node, is worth putting in a SetBitmap
+constexpr size_t kBitmapMinSize = 1024;
+
+/// \returns the number of values in both of the sorted sets a and b
+KATANA_EXPORT uint64_t IntersectionSize(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size);
+
+namespace internal {
+
+/// \returns the first index in [lo, size) of the sorted set b whose value is
+/// no less than value, or size if there is none
+inline size_t
+GallopTo(const uint32_t* b, size_t lo, size_t size, uint32_t value) {
+  size_t hi = lo;
+  size_t step = 1;
+  while (hi < size && b[hi] < value) {
+    lo = hi + 1;
+    hi += step;
+    step *= 2;
+  }
+  hi = std::min(hi, size);
+  return std::lower_bound(b + lo, b + hi, value) - b;
+}
+
+/// Call fn(i, j) for each a[i] == b[j] of the sorted set a, which is the
+/// smaller one, and the sorted set b; stops once fn returns false
+template <typename F>
+void
+GallopForEach(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    F& fn) {
+  size_t j = 0;
+  for (size_t i = 0; i < a_size; ++i) {
+    j = GallopTo(b, j, b_size, a[i]);
+    if (j == b_size) {
+      return;
+    }
+    if (b[j] == a[i]) {
+      if (!fn(i, j)) {
+        return;
+      }
+      ++j;
+    }
+  }
+}
+
+}  // namespace internal
+
+/// Call fn(i, j), which returns whether to continue, for each a[i] == b[j]
+/// of the sorted sets a and b in increasing order of value. Unlike
+/// IntersectionSize, this gives the positions of the common values, e.g.,
+/// to look up the edges that lead to them.
+template <typename F>
+void
+ForEachIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    F fn) {
+  if (a_size == 0 || b_size == 0) {
+    return;
+  }
+  if (a_size * kGallopRatio <= b_size) {
+    internal::GallopForEach(a, a_size, b, b_size, fn);
+    return;
+  }
+  if (b_size * kGallopRatio <= a_size) {
+    auto swapped = [&fn](size_t j, size_t i) { return fn(i, j); };
+    internal::GallopForEach(b, b_size, a, a_size, swapped);
+    return;
+  }
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a_size && j < b_size) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      if (!fn(i, j)) {
+        return;
+      }
+      ++i;
+      ++j;
+    }
+  }
+}
+
+/// A set of node ids as a bitmap. Intersecting a set in a bitmap with
+/// another set takes one lookup per element of the other set, which need
+/// not be sorted, so the neighbors of a hub node go in a bitmap once rather
+/// than being merged with the neighbors of each of its neighbors.
+///
+/// Insert and Erase touch only the words of their elements, so erasing what
+/// was inserted readies the bitmap for the next set in time in the size of
+/// the set rather than of the universe.
+class SetBitmap {
+public:
+  SetBitmap() = default;
+  explicit SetBitmap(size_t universe) { Resize(universe); }
+
+  /// Make the bitmap an empty set of values less than universe
+  void Resize(size_t universe) { words_.assign((universe + 63) / 64, 0); }
+
+  /// the number of values the bitmap can hold
+  size_t universe() const { return words_.size() * 64; }
+
+  void Insert(uint32_t value) {
+    words_[value / 64] |= uint64_t{1} << (value % 64);
+  }
+
+  void Insert(const uint32_t* a, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      words_[a[i] / 64] |= uint64_t{1} << (a[i] % 64);
+    }
+  }
+
+  void Erase(const uint32_t* a, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      words_[a[i] / 64] &= ~(uint64_t{1} << (a[i] % 64));
+    }
+  }
+
+  bool Contains(uint32_t value) const {
+    return (words_[value / 64] >> (value % 64)) & 1;
+  }
+
+  /// \returns the number of elements of b in the bitmap
+  uint64_t IntersectionSize(const uint32_t* b, size_t size) const {
+    uint64_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+      count += Contains(b[i]);
+    }
+    return count;
+  }
+
+private:
+  std::vector<uint64_t> words_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SHAREDGRAPH_H_
+#define KATANA_LIBGALOIS_KATANA_SHAREDGRAPH_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+/// \file SharedGraph.h
+///
+/// Graphs published in shared memory so that the processes of a host use one
+/// copy of them instead of loading one copy each.
+///
+/// PublishSharedGraph copies the topology, entity types and loaded
+/// properties of a graph into a new version of a named shared graph: files
+/// in KATANA_SHARED_GRAPH_DIR/name/version, where KATANA_SHARED_GRAPH_DIR
+/// defaults to /dev/shm/katana-graphs, so the files are memory. Properties
+/// are stored as Arrow IPC files. AttachSharedGraph makes a graph that maps
+/// the files read-only: its topology is out of core (see
+/// GraphTopology::MakeOutOfCore) and its columns are slices of the mappings,
+/// so every attached process reads the same pages. Only the entity type
+/// arrays of the graph, one byte per node and edge, are copied.
+///
+/// An attached graph pins its version with a shared lock on it until the
+/// graph and the views that share its topology are freed. Locks of processes
+/// that exit are released by the kernel, so the holders of the locks are the
+/// reference count of a version. Publishing a version removes the older
+/// versions that no process has attached; processes attached to one keep it
+/// while new processes attach to the latest.
+///
+/// Attached graphs must not be changed in place, e.g., by writing to the
+/// buffers of their columns; adding, upserting and removing properties
+/// changes only the graph of the calling process.
+
+namespace katana {
+
+/// Copy \param pg into a new version of the shared graph \param name and
+/// remove the versions of it that are not attached
+///
+/// \returns the new version, which is greater than those before it
+KATANA_EXPORT Result<uint64_t> PublishSharedGraph(
+    const PropertyGraph& pg, const std::string& name);
+
+/// \returns a read-only graph of \param version of the shared graph
+/// \param name, or of its latest version if not given
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> AttachSharedGraph(
+    const std::string& name,
+    std::optional<uint64_t> version = std::nullopt);
+
+/// \returns the published versions of the shared graph \param name in
+/// increasing order, which is empty if there are none
+KATANA_EXPORT Result<std::vector<uint64_t>> SharedGraphVersions(
+    const std::string& name);
+
+/// Remove the versions of the shared graph \param name that no process has
+/// attached, except the latest one if \param keep_latest
+///
+/// \returns the number of versions removed
+KATANA_EXPORT Result<uint64_t> RemoveUnusedSharedGraphs(
+    const std::string& name, bool keep_latest = true);
+
+}  // namespace katana
+
+#endif
@@ -33,6 +33,11 @@ namespace katana {
 /// Data structures that require per-thread allocation typically ask for the
 /// thread pool. If their construction is not guaranteed to happen after the
 /// construction of a SharedMem, initialization races can occur.
+///
+/// If the environment variable KATANA_LAZY_THREAD_POOL is set, the thread
+/// pool and the classes that depend on it are made on the first call of
+/// GetThreadPool() instead, so programs that run no parallel loop do not pay
+/// for starting threads. The thread that makes that call becomes thread 0.
 class KATANA_EXPORT SharedMem {
   struct Impl;
   std::unique_ptr<Impl> impl_;
@@ -0,0 +1,152 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SPECULATIVEFOR_H_
+#define KATANA_LIBGALOIS_KATANA_SPECULATIVEFOR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Statistics.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A Reservation is held by the least index that reserved it in a round of
+/// \ref speculative_for. Reserve may be called concurrently; Check and Reset
+/// are called in the commit phase by the index that holds it.
+class Reservation {
+public:
+  static constexpr size_t kFree = std::numeric_limits<size_t>::max();
+
+  Reservation() = default;
+  Reservation(const Reservation& other) : holder_(other.holder_.load()) {}
+  Reservation& operator=(const Reservation& other) {
+    holder_.store(other.holder_.load());
+    return *this;
+  }
+
+  void Reserve(size_t index) { katana::atomicMin(holder_, index); }
+
+  bool Check(size_t index) const {
+    return holder_.load(std::memory_order_relaxed) == index;
+  }
+
+  /// Free the reservation if index holds it; returns true if it did
+  bool CheckReset(size_t index) {
+    if (!Check(index)) {
+      return false;
+    }
+    Reset();
+    return true;
+  }
+
+  void Reset() { holder_.store(kFree, std::memory_order_relaxed); }
+
+private:
+  std::atomic<size_t> holder_{kFree};
+};
+
+/// Run step on the indices [begin, end) as if they ran one after another in
+/// order, by deterministic reservations (Blelloch et al., "Internally
+/// Deterministic Parallel Algorithms Can Be Fast", PPoPP 2012).
+///
+/// Each round takes a prefix of the indices not yet done and runs two
+/// parallel phases over it: first <code>bool step.Reserve(i)</code>, which
+/// reserves what index i would write, e.g., with Reservation::Reserve, and
+/// returns false if i has nothing to do; then <code>bool step.Commit(i)</code>
+/// for the indices that reserved, which applies index i if it holds its
+/// reservations and returns false if it must be retried. Indices which are
+/// retried come first in the next round, so the lesser index always wins a
+/// conflict. The size of the rounds grows while few indices are retried and
+/// shrinks when many are; it depends only on the number of retries, so the
+/// result does not depend on the number of threads or their schedule.
+///
+/// Unlike the deterministic for_each executor, no neighborhoods are locked or
+/// tracked: the operator states what it needs through its reservations.
+///
+/// @param granularity the largest round is (end - begin) / granularity
+/// @param loopname if not null, the rounds and retries are reported as
+/// statistics of this loop
+/// @returns the number of rounds
+template <typename Step>
+size_t
+speculative_for(
+    Step& step, size_t begin, size_t end, size_t granularity = 1,
+    const char* loopname = nullptr) {
+  if (begin >= end) {
+    return 0;
+  }
+  granularity = std::max<size_t>(granularity, 1);
+  const size_t max_round_size = (end - begin) / granularity + 1;
+  size_t round_size = std::max<size_t>(max_round_size / 4, 1);
+
+  std::vector<size_t> indices(max_round_size);
+  std::vector<size_t> kept(max_round_size);
+  std::vector<uint8_t> retry(max_round_size);
+  std::vector<size_t> offsets(max_round_size);
+
+  size_t next = begin;
+  size_t num_kept = 0;
+  size_t rounds = 0;
+  uint64_t retries = 0;
+  while (next < end || num_kept > 0) {
+    // Retried indices are already at the front of indices
+    size_t size =
+        std::min(std::max(round_size, num_kept), num_kept + (end - next));
+    for (size_t i = num_kept; i < size; ++i) {
+      indices[i] = next++;
+    }
+
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) { retry[i] = step.Reserve(indices[i]); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) {
+          if (retry[i]) {
+            retry[i] = !step.Commit(indices[i]);
+          }
+        },
+        katana::no_stats());
+
+    // Keep the retried indices in order at the front of the next round
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) { offsets[i] = retry[i]; }, katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        offsets.begin(), offsets.begin() + size, offsets.begin());
+    num_kept = offsets[size - 1];
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) {
+          if (retry[i]) {
+            kept[offsets[i] - 1] = indices[i];
+          }
+        },
+        katana::no_stats());
+    std::swap(indices, kept);
+
+    retries += num_kept;
+    rounds += 1;
+    if (num_kept * 5 > size) {
+      round_size = std::max(round_size / 2, max_round_size / 64 + 1);
+    } else if (num_kept * 10 < size) {
+      round_size = std::min(round_size * 2, max_round_size);
+    }
+  }
+
+  if (loopname) {
+    katana::ReportStatSingle(loopname, "Rounds", rounds);
+    katana::ReportStatSingle(loopname, "Retries", retries);
+  }
+  return rounds;
+}
+
+}  // namespace katana
+
+#endif
@@ -20,9 +20,12 @@
 #ifndef KATANA_LIBGALOIS_KATANA_STATISTICS_H_
 #define KATANA_LIBGALOIS_KATANA_STATISTICS_H_
 
+#include <atomic>
+#include <cstdint>
 #include <limits>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "katana/config.h"
 #include "katana/gIO.h"
@@ -286,6 +289,25 @@ using ScalarStatManager = BasicStatMap<ScalarStat<T>>;
 
 }  // end namespace internal
 
+class StatHandle;
+
+/// A statistic as read by StatManager::Snapshot: the values reported by each
+/// thread and their total, combined by \p type as they are when printed
+template <typename T>
+struct StatRecord {
+  std::string region;
+  std::string category;
+  StatTotal::Type type;
+  T total;
+  std::vector<T> thread_values;
+};
+
+struct StatSnapshot {
+  std::vector<StatRecord<int64_t>> ints;
+  std::vector<StatRecord<double>> fps;
+  std::vector<StatRecord<std::string>> params;
+};
+
 class KATANA_EXPORT StatManager {
   class Impl;
 
@@ -359,7 +381,72 @@ public:
   void AddParam(
       const std::string& region, const std::string& category, const Str& val);
 
+  /// Add \param val to the statistic of \param handle for the calling
+  /// thread; see StatHandle
+  void AddToHandle(const StatHandle& handle, int64_t val);
+
   void Print();
+
+  /// Read the statistics reported so far without printing them, so that they
+  /// can be inspected while the program runs, e.g., around a call to an
+  /// algorithm. Later statistics are still printed by Print. Must not be
+  /// called while a parallel loop is running.
+  StatSnapshot Snapshot();
+
+private:
+  friend class StatHandle;
+
+  /// \returns the slot of the statistic (region, category), the same for
+  /// every registration of it, or kNoStatSlot if all slots are taken
+  uint32_t RegisterHandle(
+      const std::string& region, const std::string& category,
+      StatTotal::Type type);
+
+  void MergeHandles();
+};
+
+/// A statistic that is registered once and then reported to without string
+/// lookups or allocation, e.g., a counter or timer reported by every thread
+/// of a loop that runs many times.
+///
+/// Values go to a slot of the calling thread, which is merged with the other
+/// statistics of the thread when statistics are printed. As with ReportStat,
+/// the values a thread reports are summed and \p type combines the totals of
+/// threads.
+///
+/// \code
+/// katana::StatHandle pushes("KCore", "Pushes");
+/// katana::do_all(katana::iterate(nodes), [&](auto n) {
+///   ...
+///   pushes.Add(1);
+/// });
+/// \endcode
+class KATANA_EXPORT StatHandle {
+public:
+  StatHandle(
+      const std::string& region, const std::string& category,
+      StatTotal::Type type = StatTotal::TSUM);
+
+  StatHandle(const StatHandle&) = delete;
+  StatHandle& operator=(const StatHandle&) = delete;
+
+  /// Add \param val to the statistic for the calling thread. Thread safe.
+  void Add(int64_t val) const;
+
+  const std::string& region() const { return region_; }
+  const std::string& category() const { return category_; }
+  StatTotal::Type type() const { return type_; }
+
+private:
+  friend class StatManager;
+
+  std::string region_;
+  std::string category_;
+  StatTotal::Type type_;
+  /// the StatManager that registered the handle, in the upper half, and the
+  /// slot of the handle in it, so that handles outliving a StatManager
+  /// register again with the next one
+  mutable std::atomic<uint64_t> registration_{0};
 };
 
 namespace internal {
@@ -453,7 +540,8 @@ ReportStatAvg(
 //! @param id Identifier to prefix stat with in statistics output
 KATANA_EXPORT void reportRUsage(const std::string& id);
 
-//! Reports system memory stats for all threads
+//! Reports system memory stats for all threads and the usage of the current
+//! MemoryBudget, if any
 KATANA_EXPORT void reportPageAlloc(const char* category);
 
 class [[nodiscard]] ReportPageAllocGuard {
@@ -483,6 +571,10 @@ KATANA_EXPORT void PrintStats();
 
 KATANA_EXPORT void SetStatFile(const std::string& f);
 
+/// \returns StatManager::Snapshot of the statistics manager, or an empty
+/// snapshot if there is none
+KATANA_EXPORT StatSnapshot GetStatSnapshot();
+
 }  // end namespace katana
 
 #endif
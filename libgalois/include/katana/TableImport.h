@@ -0,0 +1,88 @@
+#ifndef KATANA_LIBGALOIS_KATANA_TABLEIMPORT_H_
+#define KATANA_LIBGALOIS_KATANA_TABLEIMPORT_H_
+
+/// Import property graphs from node and edge tables stored as CSV or Parquet
+/// files.
+///
+/// \file
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/BuildGraph.h"
+
+namespace katana {
+
+/// A node or edge table, whose rows may be split among many files. The
+/// columns of a table are the union of the columns of its files.
+struct KATANA_EXPORT TableSource {
+  /// label of the nodes, or type of the edges, of the table; none if empty
+  std::string label;
+  /// CSV (.csv) or Parquet (.parquet) files, whose rows are taken in order
+  std::vector<std::string> files;
+};
+
+struct KATANA_EXPORT TableImportOptions {
+  /// column of the node tables with the unique IDs of their nodes
+  std::string id_column{"id"};
+  /// columns of the edge tables with the IDs of the source and target nodes
+  std::string source_column{"source"};
+  std::string target_column{"target"};
+};
+
+/// List the tables in dir, which has a subdirectory per table holding the
+/// files of the table, as data lakes partition tables. The name of the
+/// subdirectory is the label of the table. A CSV or Parquet file in dir is a
+/// table without a label.
+KATANA_EXPORT Result<std::vector<TableSource>> ListTableSources(
+    const std::string& dir);
+
+/// ConvertTables builds a graph from node and edge tables.
+///
+/// The files are read in parallel. The nodes are the rows of the node tables,
+/// in order, and their properties are the columns of the tables, including
+/// the ID column. IDs must be unique and are compared as strings, so node and
+/// edge tables may store them as integers or strings. The edges are the rows of the
+/// edge tables, sorted by source and otherwise in order, and their properties
+/// are the columns of the tables besides the source and target columns. A
+/// column that a table lacks is null for its rows. Each non-empty table label
+/// becomes a label (or type) column.
+///
+/// Properties are moved from the files to the result as Arrow arrays, which
+/// are only copied to sort the edges.
+///
+/// \returns A collection of Arrow tables of node properties/labels, edge
+///     properties/types, and CSR topology
+KATANA_EXPORT Result<GraphComponents> ConvertTables(
+    const std::vector<TableSource>& node_tables,
+    const std::vector<TableSource>& edge_tables,
+    const TableImportOptions& options = TableImportOptions(),
+    bool verbose = false);
+
+/// ConvertEdgeArrays builds a graph from an edge list of node IDs, edge e
+/// going from sources[e] to destinations[e].
+///
+/// IDs may be of any integer type and must not be null or negative. The graph
+/// has num_nodes nodes; if num_nodes is 0, it has as many nodes as there are
+/// rows of node_properties or, without them, one more than the largest ID.
+/// The edges are sorted by source with a parallel counting sort and otherwise
+/// kept in order, and their properties, the rows of edge_properties, are
+/// gathered to match only if the edges were not already sorted. Either table
+/// may be null.
+///
+/// \returns A collection of Arrow tables of node and edge properties, without
+///     labels or types, and CSR topology
+KATANA_EXPORT Result<GraphComponents> ConvertEdgeArrays(
+    const std::shared_ptr<arrow::ChunkedArray>& sources,
+    const std::shared_ptr<arrow::ChunkedArray>& destinations,
+    uint64_t num_nodes = 0,
+    std::shared_ptr<arrow::Table> node_properties = nullptr,
+    std::shared_ptr<arrow::Table> edge_properties = nullptr);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef KATANA_LIBGALOIS_KATANA_TEMPORALTOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_TEMPORALTOPOLOGY_H_
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The times t with begin <= t < end
+struct TimeWindow {
+  int64_t begin;
+  int64_t end;
+
+  bool Contains(int64_t time) const noexcept {
+    return begin <= time && time < end;
+  }
+};
+
+/// A topology whose edges each have a time, read from an integer, timestamp
+/// or date edge property, with the edges of each node sorted by time, so the
+/// edges of a node in a TimeWindow are a contiguous range of them.
+///
+/// Times are the integer values of the property, e.g., the units since the
+/// epoch of a timestamp. Edges whose time is null are kept last and are in
+/// no window.
+class KATANA_EXPORT TemporalTopology : public GraphTopologyTypes {
+public:
+  /// The time of edges whose time is null
+  static constexpr int64_t kNoTime = std::numeric_limits<int64_t>::max();
+
+  TemporalTopology() = default;
+  TemporalTopology(TemporalTopology&&) = default;
+  TemporalTopology& operator=(TemporalTopology&&) = default;
+
+  TemporalTopology(const TemporalTopology&) = delete;
+  TemporalTopology& operator=(const TemporalTopology&) = delete;
+
+  /// \returns the out-edges of the topology of pg, or its in-edges if
+  /// \param transpose, sorted by the edge property
+  /// \param timestamp_property_name
+  static Result<TemporalTopology> Make(
+      const PropertyGraph* pg, const std::string& timestamp_property_name,
+      bool transpose = false);
+
+  uint64_t num_nodes() const noexcept { return topology_.num_nodes(); }
+  uint64_t num_edges() const noexcept { return topology_.num_edges(); }
+
+  edges_range edges(Node node) const noexcept { return topology_.edges(node); }
+  Node edge_dest(Edge edge) const noexcept { return topology_.edge_dest(edge); }
+  uint64_t degree(Node node) const noexcept { return topology_.degree(node); }
+
+  int64_t edge_time(Edge edge) const noexcept { return times_[edge]; }
+
+  /// The property index of the edge in the property graph
+  PropertyIndex edge_property_index(Edge edge) const noexcept {
+    return property_indices_[edge];
+  }
+
+  /// \returns the edges of \param node with times in \param window, by
+  /// binary search
+  edges_range window_edges(Node node, const TimeWindow& window) const noexcept;
+
+  /// The first edge of node at or after \param from whose time is not less
+  /// than \param time. The search gallops from \param from, so it takes time
+  /// logarithmic in the number of edges skipped.
+  Edge Seek(Node node, Edge from, int64_t time) const noexcept;
+
+  /// The least and greatest non-null times, or kNoTime and
+  /// numeric_limits<int64_t>::min() if there are none
+  int64_t min_time() const noexcept { return min_time_; }
+  int64_t max_time() const noexcept { return max_time_; }
+
+  const GraphTopology& topology() const noexcept { return topology_; }
+
+private:
+  GraphTopology topology_;
+  NUMAArray<int64_t> times_;
+  NUMAArray<PropertyIndex> property_indices_;
+  int64_t min_time_{kNoTime};
+  int64_t max_time_{std::numeric_limits<int64_t>::min()};
+};
+
+/// The edges of a TemporalTopology in a TimeWindow, without copying: each
+/// node keeps the range of its edges in the window. It is a topology for
+/// EdgeMap, SpMVPull and the like.
+///
+/// Moving the window forward, as sliding windows do, moves the ends of each
+/// range forward from where they were, so consecutive windows cost time
+/// logarithmic in the edges that enter and leave them rather than in the
+/// degree. Other moves search the edges of each node again.
+class KATANA_EXPORT TimeWindowTopology : public GraphTopologyTypes {
+public:
+  /// An empty window of \param temporal, which must outlive it
+  explicit TimeWindowTopology(const TemporalTopology* temporal);
+
+  TimeWindowTopology(const TimeWindowTopology&) = delete;
+  TimeWindowTopology& operator=(const TimeWindowTopology&) = delete;
+
+  void SetWindow(const TimeWindow& window);
+
+  const TimeWindow& window() const noexcept { return window_; }
+
+  const TemporalTopology& temporal() const noexcept { return *temporal_; }
+
+  uint64_t num_nodes() const noexcept { return temporal_->num_nodes(); }
+
+  /// The number of edges in the window
+  uint64_t num_edges() const noexcept { return num_edges_; }
+
+  edges_range edges(Node node) const noexcept {
+    return MakeStandardRange(
+        edge_iterator{first_[node]}, edge_iterator{last_[node]});
+  }
+
+  Node edge_dest(Edge edge) const noexcept {
+    return temporal_->edge_dest(edge);
+  }
+
+  uint64_t degree(Node node) const noexcept {
+    return last_[node] - first_[node];
+  }
+
+private:
+  const TemporalTopology* temporal_;
+  TimeWindow window_{0, 0};
+  /// The edges of node n in the window are first_[n] to last_[n]
+  NUMAArray<Edge> first_;
+  NUMAArray<Edge> last_;
+  uint64_t num_edges_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -23,6 +23,7 @@
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <thread>
@@ -63,6 +64,9 @@ protected:
     std::function<void(void)> fn;
   };  //! type to switch to dedicated mode
 
+  //! spin time of threads that never park
+  static constexpr uint32_t kSpinForever = UINT32_MAX;
+
   //! Per-thread mailboxes for notification
   struct per_signal {
     std::condition_variable cv;
@@ -70,6 +74,8 @@ protected:
     unsigned wbegin, wend;
     std::atomic<int> done;
     std::atomic<int> fastRelease;
+    //! set by a thread before it checks done for the last time and sleeps
+    std::atomic<bool> parked{false};
     ThreadTopoInfo topo;
 
     void wakeup(bool fastmode) {
@@ -77,25 +83,22 @@ protected:
         done = 0;
         fastRelease = 1;
       } else {
-        std::lock_guard<std::mutex> lg(m);
+        // A spinning thread sees done. A parking thread either sees done or
+        // has set parked before we read it, so it gets the notification.
         done = 0;
-        cv.notify_one();
-        // start.release();
-      }
-    }
-
-    void wait(bool fastmode) {
-      if (fastmode) {
-        while (!fastRelease.load(std::memory_order_relaxed)) {
-          asmPause();
+        if (parked) {
+          std::lock_guard<std::mutex> lg(m);
+          cv.notify_one();
         }
-        fastRelease = 0;
-      } else {
-        std::unique_lock<std::mutex> lg(m);
-        cv.wait(lg, [=] { return !done; });
-        // start.acquire();
       }
     }
+
+    //! wait for wakeup, spinning for \param spin_us microseconds before
+    //! parking if not in fastmode
+    void wait(bool fastmode, uint32_t spin_us);
+
+    //! \returns true if woken up within \param spin_us microseconds
+    bool spin(uint32_t spin_us);
   };
 
   thread_local static per_signal my_box;
@@ -107,6 +110,10 @@ protected:
   unsigned masterFastmode;
   bool running;
   std::function<void(void)> work;
+  std::atomic<uint32_t> idle_spin_us_{0};
+  std::atomic<uint32_t> warm_threads_{0};
+  //! the thread holding the current ThreadPoolLease, if any
+  std::atomic<std::thread::id> lease_holder_{};
 
   //! destroy all threads
   void destroyCommon();
@@ -117,6 +124,9 @@ protected:
   //! main thread loop
   void threadLoop(unsigned tid);
 
+  //! \returns how long thread \param tid spins when idle before it parks
+  uint32_t IdleSpinUs(unsigned tid) const;
+
   //! spin up for run
   void cascade(bool fastmode);
 
@@ -129,6 +139,19 @@ protected:
   ThreadPool();
 
 public:
+  //! How threads wait for work between parallel sections when the pool does
+  //! not burn power. Spinning makes back-to-back sections start sooner;
+  //! parking frees the core for other processes but waking a parked thread
+  //! takes a system call.
+  struct IdlePolicy {
+    //! microseconds an idle thread spins for work before it parks
+    uint32_t spin_us{0};
+    //! number of threads, from thread 1 up, that spin until the next
+    //! parallel section instead of parking; since sections with few threads
+    //! use the lowest thread ids, these keep small sections fast
+    uint32_t warm_threads{0};
+  };
+
   ~ThreadPool();
 
   ThreadPool(const ThreadPool&) = delete;
@@ -162,6 +185,17 @@ public:
     runInternal(num);
   }
 
+  //! Let the calling thread, which need not be the thread that created the
+  //! pool, execute work as thread 0. The thread shares the per-thread storage
+  //! of thread 0, so at most one thread may execute work at a time, e.g., by
+  //! holding a ThreadPoolLease.
+  void AdoptMaster();
+
+  //! Record that the calling thread took (\p held) or released a
+  //! ThreadPoolLease. While a lease is held, run asserts that its caller is
+  //! the holder.
+  void SetLeaseHolder(bool held);
+
   //! run function in a dedicated thread until the threadpool exits
   void runDedicated(std::function<void(void)>& f);
 
@@ -170,6 +204,13 @@ public:
   // experimental: leave busy wait
   void beKind();
 
+  //! Set how threads wait for work. Threads that are already waiting keep
+  //! the old policy until they are next woken up. The initial policy comes
+  //! from the environment variables KATANA_IDLE_SPIN_US and
+  //! KATANA_WARM_THREADS, and is to park right away if they are not set.
+  void SetIdlePolicy(const IdlePolicy& policy);
+  IdlePolicy GetIdlePolicy() const;
+
   bool isRunning() const { return running; }
 
   //! return the number of non-reserved threads in the pool
@@ -192,6 +233,7 @@ public:
     return signals[tid]->topo.socketLeader == tid;
   }
   unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
+  unsigned getCore(unsigned tid) const { return signals[tid]->topo.core; }
   unsigned getLeader(unsigned tid) const {
     return signals[tid]->topo.socketLeader;
   }
@@ -206,6 +248,7 @@ public:
   static bool isLeader() { return my_box.topo.tid == my_box.topo.socketLeader; }
   static unsigned getLeader() { return my_box.topo.socketLeader; }
   static unsigned getSocket() { return my_box.topo.socket; }
+  static unsigned getCore() { return my_box.topo.core; }
   static unsigned getCumulativeMaxSocket() {
     return my_box.topo.cumulativeMaxSocket;
   }
@@ -223,6 +266,11 @@ namespace katana::internal {
 
 KATANA_EXPORT void SetThreadPool(ThreadPool* tp);
 
+/// Make GetThreadPool call starter, which must call SetThreadPool, if no
+/// thread pool is set; this lets SharedMem start the pool on first use. The
+/// thread that first uses the pool becomes its thread 0.
+KATANA_EXPORT void SetThreadPoolStarter(std::function<void()> starter);
+
 }  // namespace katana::internal
 
 #endif
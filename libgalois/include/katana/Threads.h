@@ -37,5 +37,44 @@ KATANA_EXPORT unsigned int setActiveThreads(unsigned int num) noexcept;
  */
 KATANA_EXPORT unsigned int getActiveThreads() noexcept;
 
+/**
+ * Exclusive use of the thread pool by the calling thread, which need not be
+ * the thread that created the pool. While the lease is held, the calling
+ * thread may run Galois iterators on the number of threads given to the
+ * lease; other threads taking a lease wait until it is released, at which
+ * point the previous number of active threads is restored.
+ *
+ * This lets several client threads, e.g., of a query server, issue parallel
+ * loops without coordinating among themselves. Loops from different leases
+ * run one after the other; the pool is not split among them. Once any
+ * thread uses leases, every thread that runs Galois iterators, including the
+ * one that created the pool, must hold a lease; ThreadPool::run aborts when
+ * called by another thread while a lease is held.
+ *
+ * \code
+ * std::thread query([&] {
+ *   katana::ThreadPoolLease lease(16);
+ *   katana::do_all(katana::iterate(items), fn);
+ * });
+ * \endcode
+ */
+class KATANA_EXPORT ThreadPoolLease {
+public:
+  explicit ThreadPoolLease(unsigned int num_threads);
+  ~ThreadPoolLease();
+
+  ThreadPoolLease(const ThreadPoolLease&) = delete;
+  ThreadPoolLease& operator=(const ThreadPoolLease&) = delete;
+  ThreadPoolLease(ThreadPoolLease&&) = delete;
+  ThreadPoolLease& operator=(ThreadPoolLease&&) = delete;
+
+  /// \returns the number of threads loops use while the lease is held
+  unsigned int num_threads() const noexcept { return num_threads_; }
+
+private:
+  unsigned int num_threads_;
+  unsigned int previous_threads_;
+};
+
 }  // namespace katana
 #endif
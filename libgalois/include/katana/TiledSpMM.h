@@ -0,0 +1,182 @@
+#ifndef KATANA_LIBGALOIS_KATANA_TILEDSPMM_H_
+#define KATANA_LIBGALOIS_KATANA_TILEDSPMM_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Edge-centric aggregation of dense node features, i.e., the product of the
+/// sparse adjacency matrix of a topology and a dense matrix with width
+/// features per node (SpMM), as in the neighbor aggregation of graph neural
+/// networks or the least squares steps of matrix completion:
+///
+///   out[n] = sum over edges e of n of weight[e] * in[edge_dest(e)]
+///
+/// Features are float and stored row-major, width values per node.
+///
+/// Looping over nodes reads the features of destinations all over the
+/// input, so for wide features nearly every edge misses the cache. Instead,
+/// the adjacency matrix is split into 2D tiles of rows_per_block() sources
+/// by cols_per_block() destinations whose input and output features each
+/// fit in half of the L2 cache by default. A block of rows is owned by one
+/// thread at a time and its tiles are processed in column order, so tiles
+/// that write the same outputs never run concurrently and no locks are
+/// needed, while the input features of a tile stay in cache for all of its
+/// edges. Only non-empty tiles are kept, so sparse graphs cost nothing for
+/// the empty ones.
+///
+/// The inner kernel is a multiply-add over the features of an edge that the
+/// compiler vectorizes; widths that are multiples of the vector width are
+/// fastest.
+class KATANA_EXPORT TiledSpMM {
+public:
+  using Node = GraphTopologyTypes::Node;
+  using Edge = GraphTopologyTypes::Edge;
+
+  TiledSpMM() = default;
+
+  /// \returns half of the L2 cache size of this machine, the default size
+  /// of the input or output features of a tile
+  static size_t DefaultTileBytes();
+
+  /// Split the edges of topo into tiles for features of width values; a
+  /// block of rows or columns has at most tile_bytes of features, or
+  /// DefaultTileBytes() if 0
+  template <typename Topo>
+  static TiledSpMM Make(
+      const Topo& topo, uint32_t width, size_t tile_bytes = 0) {
+    TiledSpMM spmm;
+    spmm.width_ = std::max<uint32_t>(width, 1);
+    spmm.num_nodes_ = topo.num_nodes();
+    if (tile_bytes == 0) {
+      tile_bytes = DefaultTileBytes();
+    }
+    uint64_t nodes_per_block =
+        std::max<uint64_t>(1, tile_bytes / (spmm.width_ * sizeof(float)));
+    spmm.rows_per_block_ = nodes_per_block;
+    spmm.cols_per_block_ = nodes_per_block;
+    uint64_t num_row_blocks =
+        (spmm.num_nodes_ + nodes_per_block - 1) / nodes_per_block;
+
+    spmm.rows_.allocateBlocked(topo.num_edges());
+    spmm.cols_.allocateBlocked(topo.num_edges());
+    spmm.edge_ids_.allocateBlocked(topo.num_edges());
+
+    // The edges of a block of rows are contiguous in the topology, so each
+    // block sorts its own edges by column block in place
+    std::vector<std::vector<Tile>> block_tiles(num_row_blocks);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_row_blocks),
+        [&](uint64_t block) {
+          Node row_begin = block * nodes_per_block;
+          Node row_end = std::min<uint64_t>(
+              spmm.num_nodes_, row_begin + nodes_per_block);
+          Edge edge_begin = *topo.edges(row_begin).begin();
+          Edge edge_end = *topo.edges(row_end - 1).end();
+
+          struct Entry {
+            uint64_t col_block;
+            Node row;
+            Node col;
+            Edge edge;
+          };
+          std::vector<Entry> entries;
+          entries.reserve(edge_end - edge_begin);
+          for (Node n = row_begin; n < row_end; ++n) {
+            for (auto e : topo.edges(n)) {
+              Node dst = topo.edge_dest(e);
+              entries.emplace_back(Entry{dst / nodes_per_block, n, dst, e});
+            }
+          }
+          // stable, so that the edges of a tile stay in row order
+          std::stable_sort(
+              entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) {
+                return a.col_block < b.col_block;
+              });
+
+          std::vector<Tile>& tiles = block_tiles[block];
+          for (size_t i = 0; i < entries.size(); ++i) {
+            Edge pos = edge_begin + i;
+            spmm.rows_[pos] = entries[i].row;
+            spmm.cols_[pos] = entries[i].col;
+            spmm.edge_ids_[pos] = entries[i].edge;
+            if (tiles.empty() ||
+                tiles.back().col_block != entries[i].col_block) {
+              tiles.emplace_back(Tile{entries[i].col_block, pos, pos});
+            }
+            tiles.back().end = pos + 1;
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    spmm.block_offsets_.resize(num_row_blocks + 1);
+    spmm.block_offsets_[0] = 0;
+    for (uint64_t block = 0; block < num_row_blocks; ++block) {
+      spmm.block_offsets_[block + 1] =
+          spmm.block_offsets_[block] + block_tiles[block].size();
+    }
+    spmm.tiles_.resize(spmm.block_offsets_.back());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_row_blocks),
+        [&](uint64_t block) {
+          std::copy(
+              block_tiles[block].begin(), block_tiles[block].end(),
+              spmm.tiles_.begin() + spmm.block_offsets_[block]);
+        },
+        katana::no_stats());
+    return spmm;
+  }
+
+  /// out[n] = sum over edges e of n of w(e) * in[edge_dest(e)] for every
+  /// node n, where w(e) is edge_weights[e] or 1 if edge_weights is null.
+  /// in and out hold width() features per node of the topology this was
+  /// made from and must not overlap; out is overwritten.
+  void Aggregate(
+      const float* in, float* out,
+      const float* edge_weights = nullptr) const;
+
+  uint32_t width() const { return width_; }
+  uint64_t rows_per_block() const { return rows_per_block_; }
+  uint64_t cols_per_block() const { return cols_per_block_; }
+  uint64_t num_row_blocks() const {
+    return block_offsets_.empty() ? 0 : block_offsets_.size() - 1;
+  }
+  /// The number of non-empty tiles
+  uint64_t num_tiles() const { return tiles_.size(); }
+
+private:
+  struct Tile {
+    uint64_t col_block;
+    /// the tile is the edges [begin, end) of rows_, cols_ and edge_ids_
+    Edge begin;
+    Edge end;
+  };
+
+  uint32_t width_{1};
+  uint64_t num_nodes_{0};
+  uint64_t rows_per_block_{1};
+  uint64_t cols_per_block_{1};
+
+  /// the tiles of row block b are [block_offsets_[b], block_offsets_[b + 1])
+  std::vector<uint64_t> block_offsets_;
+  std::vector<Tile> tiles_;
+
+  /// the source, destination and edge id of each edge, grouped by tile and
+  /// by row within a tile
+  NUMAArray<Node> rows_;
+  NUMAArray<Node> cols_;
+  NUMAArray<Edge> edge_ids_;
+};
+
+}  // namespace katana
+
+#endif
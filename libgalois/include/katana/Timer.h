@@ -27,6 +27,8 @@
 
 namespace katana {
 
+class StatHandle;
+
 //! A simple timer
 class KATANA_EXPORT Timer {
   typedef std::chrono::steady_clock clockTy;
@@ -63,11 +65,16 @@ public:
 class KATANA_EXPORT StatTimer : public TimeAccumulator {
   gstl::Str name_;
   gstl::Str region_;
+  const StatHandle* handle_{nullptr};
   bool valid_;
 
 public:
   StatTimer(const char* name, const char* region);
 
+  /// A timer that reports to \param handle, for timers created many times,
+  /// e.g., in every round of an algorithm
+  explicit StatTimer(const StatHandle& handle);
+
   StatTimer(const char* const n) : StatTimer(n, nullptr) {}
 
   StatTimer() : StatTimer(nullptr, nullptr) {}
@@ -0,0 +1,56 @@
+#ifndef KATANA_LIBGALOIS_KATANA_TOPOLOGYSTATISTICS_H_
+#define KATANA_LIBGALOIS_KATANA_TOPOLOGYSTATISTICS_H_
+
+#include <cstdint>
+
+#include "katana/config.h"
+
+namespace katana {
+
+class KATANA_EXPORT GraphTopology;
+
+/// Cheap statistics of the shape of a topology. The analytics choose their
+/// automatic plans from them (see katana::analytics::Planner), so a
+/// PropertyGraph computes them once and keeps them with its views; see
+/// PropertyGraph::GetTopologyStatistics.
+///
+/// Computing them takes two BFS traversals and a pass over the nodes; the
+/// samples are taken with a fixed seed so the same topology always gets the
+/// same statistics, and the same plans.
+struct KATANA_EXPORT TopologyStatistics {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  uint64_t max_degree{0};
+  /// The mean and median out-degree of a sample of the nodes with edges
+  double sampled_mean_degree{0};
+  double sampled_median_degree{0};
+  /// A lower bound on the diameter: the larger number of BFS levels of a
+  /// double sweep that starts at a node of highest degree and continues from
+  /// a node of its last level
+  uint32_t estimated_diameter{0};
+
+  double average_degree() const {
+    return num_nodes == 0 ? 0 : static_cast<double>(num_edges) / num_nodes;
+  }
+
+  /// The sampled mean over the sampled median degree; the mean of a power
+  /// law degree distribution is well above its median
+  double degree_skew() const {
+    return sampled_median_degree == 0
+               ? 0
+               : sampled_mean_degree / sampled_median_degree;
+  }
+
+  /// true if the degrees look like a power law. This is the test of
+  /// katana::analytics::IsApproximateDegreeDistributionPowerLaw, from the
+  /// GAP benchmark suite, on the sampled degrees.
+  bool is_power_law() const {
+    return num_nodes >= 10 && average_degree() >= 10 && degree_skew() > 1.3;
+  }
+
+  static TopologyStatistics Compute(const GraphTopology& topo) noexcept;
+};
+
+}  // namespace katana
+
+#endif
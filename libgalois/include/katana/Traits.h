@@ -23,6 +23,7 @@
 #include <tuple>
 #include <type_traits>
 
+#include "katana/Cancellation.h"
 #include "katana/WorkList.h"
 #include "katana/config.h"
 
@@ -219,6 +220,40 @@ struct loopname : public trait_has_value<const char*>, loopname_tag {
 struct steal_tag {};
 struct steal : public trait_has_type<bool>, steal_tag {};
 
+/**
+ * Indicate that {@link do_all()} loops should perform work-stealing only
+ * between threads of the same socket, so that each thread stays on the
+ * memory of its socket, e.g., when iterating over
+ * GraphTopology::local_nodes() of a NUMA partitioned topology. Optional
+ * argument to {@link do_all()} loops.
+ */
+struct socket_steal_tag {};
+struct socket_steal : public trait_has_type<bool>, socket_steal_tag {};
+
+/**
+ * Indicate that {@link do_all()} loops should perform work-stealing along
+ * the machine hierarchy: first from the SMT siblings of the same core, then
+ * from the threads of the same socket and only then from the other sockets,
+ * so that stolen work tends to stay in shared caches. Optional argument to
+ * {@link do_all()} loops.
+ */
+struct hierarchical_steal_tag {};
+struct hierarchical_steal : public trait_has_type<bool>,
+                            hierarchical_steal_tag {};
+
+/**
+ * Indicate that {@link do_all()} and {@link for_each()} loops should stop
+ * early, leaving the remaining work undone, once the token is cancelled. The
+ * token is checked at chunk boundaries. A null token is never cancelled.
+ * Optional argument to {@link do_all()} and {@link for_each()} loops.
+ */
+struct cancellation_tag {};
+struct cancellation : public trait_has_value<const CancellationToken*>,
+                      cancellation_tag {
+  cancellation(const CancellationToken* token)
+      : trait_has_value<const CancellationToken*>(token) {}
+};
+
 /**
  * Indicates worklist to use. Optional argument to {@link for_each()} loops.
  */
@@ -404,6 +439,24 @@ std::enable_if_t<!has_trait<loopname_tag, Tup>(), const char*>
 getLoopName(const Tup&) {
   return "ANON_LOOP";
 }
+
+template <typename Tup>
+std::enable_if_t<has_trait<cancellation_tag, Tup>(), const CancellationToken*>
+getCancellation(const Tup& t) {
+  return get_trait_value<cancellation_tag>(t).value;
+}
+
+template <typename Tup>
+std::enable_if_t<!has_trait<cancellation_tag, Tup>(), const CancellationToken*>
+getCancellation(const Tup&) {
+  return nullptr;
+}
+
+/// \returns true if \param token is not null and cancelled
+inline bool
+IsCancelled(const CancellationToken* token) {
+  return token && token->IsCancelled();
+}
 }  // namespace internal
 
 }  // namespace katana
@@ -154,6 +154,29 @@ public:
   edges_range edges(node_iterator node) const { return pfg_->edges(*node); }
   // TODO(amp): [[deprecated("use edges(Node node)")]]
 
+  /**
+   * Calls fn(e, dst) for the edges of node, prefetching ahead the data of
+   * their destinations with prefetch.
+   *
+   * @see GraphTopology::ForEachEdgePrefetched
+   */
+  template <typename Fn, typename Prefetch>
+  void ForEachEdgePrefetched(
+      Node node, const Fn& fn, const Prefetch& prefetch,
+      size_t distance = kDefaultPrefetchDistance) const {
+    pfg_->topology().ForEachEdgePrefetched(node, fn, prefetch, distance);
+  }
+
+  /**
+   * Starts reading the edges of nodes [begin, end) in the background if the
+   * topology is out of core, e.g., for the next tile of a traversal.
+   *
+   * @see GraphTopology::PrefetchEdges
+   */
+  void PrefetchEdges(Node begin, Node end) const {
+    pfg_->topology().PrefetchEdges(begin, end);
+  }
+
   /**
    * Gets the first edge of some node.
    *
@@ -296,6 +319,8 @@ Result<TypedPropertyGraph<NodeProps, EdgeProps>>
 TypedPropertyGraph<NodeProps, EdgeProps>::Make(
     PropertyGraph* pg, const std::vector<std::string>& node_properties,
     const std::vector<std::string>& edge_properties) {
+  KATANA_CHECKED(pg->LoadLazyNodeProperties(node_properties));
+  KATANA_CHECKED(pg->LoadLazyEdgeProperties(edge_properties));
   auto node_view_result =
       internal::MakeNodePropertyViews<NodeProps>(pg, node_properties);
   if (!node_view_result) {
@@ -328,6 +353,8 @@ TypedPropertyGraphView<PGView, NodeProps, EdgeProps>::Make(
     const std::vector<std::string>& edge_properties) {
   auto pg_view = pg->BuildView<PGView>();
   KATANA_LOG_DEBUG_ASSERT(pg);
+  KATANA_CHECKED(pg->LoadLazyNodeProperties(node_properties));
+  KATANA_CHECKED(pg->LoadLazyEdgeProperties(edge_properties));
   auto node_view_result =
       internal::MakeNodePropertyViews<NodeProps>(pg, node_properties);
   if (!node_view_result) {
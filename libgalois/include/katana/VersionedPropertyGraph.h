@@ -0,0 +1,87 @@
+#ifndef KATANA_LIBGALOIS_KATANA_VERSIONEDPROPERTYGRAPH_H_
+#define KATANA_LIBGALOIS_KATANA_VERSIONEDPROPERTYGRAPH_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A graph that readers read consistent versions of while a writer changes,
+/// writes and commits it, so that neither waits for the other.
+///
+/// The writer changes a private head graph with Update, which publishes a
+/// new version when the update succeeds. A version is a ShallowCopy of the
+/// head: it shares the topology and the property columns of the head when
+/// it is published, and since updates replace columns and topologies rather
+/// than change them, later updates are not seen by it. Readers Pin the
+/// latest version and keep it for as long as they read it; the columns of a
+/// version are freed once no version or head refers to them.
+///
+/// Pinning copies a pointer and never waits for Update, Write or Commit.
+/// Publishing copies the entity type arrays of the head, one byte per node
+/// and edge; the topology is moved into shared storage on the first publish
+/// after it is replaced (see PropertyGraph::MakeTopologyShareable).
+///
+/// Versions only have the properties loaded in the head. They are read-only;
+/// to add properties, e.g., the outputs of analytics, make a ShallowCopy of
+/// the pinned graph. Neither versions nor the head may be changed in place,
+/// e.g., by writing to the buffers of their columns.
+class KATANA_EXPORT VersionedPropertyGraph {
+public:
+  struct Snapshot {
+    /// increases with every version published
+    uint64_t version;
+    std::shared_ptr<const PropertyGraph> graph;
+  };
+
+  /// Publish \param head as the first version
+  static Result<std::unique_ptr<VersionedPropertyGraph>> Make(
+      std::unique_ptr<PropertyGraph> head);
+
+  VersionedPropertyGraph(const VersionedPropertyGraph&) = delete;
+  VersionedPropertyGraph& operator=(const VersionedPropertyGraph&) = delete;
+
+  /// \returns the latest version
+  Snapshot Pin() const;
+
+  /// Call \param update with the head graph and publish the head as a new
+  /// version if update succeeds. Updates run one at a time. The changes of
+  /// an update that fails are not published, but they stay in the head and
+  /// are published by the next update that succeeds.
+  ///
+  /// \returns the new version
+  Result<uint64_t> Update(
+      const std::function<Result<void>(PropertyGraph*)>& update);
+
+  /// Commit the head; see PropertyGraph::Commit
+  Result<void> Commit(const std::string& command_line);
+
+  /// Write the head; see PropertyGraph::Write
+  Result<void> Write(
+      const std::string& rdg_name, const std::string& command_line);
+
+private:
+  explicit VersionedPropertyGraph(std::unique_ptr<PropertyGraph> head)
+      : head_(std::move(head)) {}
+
+  /// Call with writer_mutex_ held
+  Result<uint64_t> Publish();
+
+  std::unique_ptr<PropertyGraph> head_;
+  Snapshot latest_{0, nullptr};
+  /// serializes the users of head_
+  std::mutex writer_mutex_;
+  /// guards latest_
+  mutable std::mutex latest_mutex_;
+};
+
+}  // namespace katana
+
+#endif
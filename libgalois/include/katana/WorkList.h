@@ -22,9 +22,13 @@
 
 #include <optional>
 
+#include "katana/AdaptiveChunk.h"
+#include "katana/AdaptiveObim.h"
 #include "katana/BulkSynchronous.h"
+#include "katana/ChaseLevDeque.h"
 #include "katana/Chunk.h"
 #include "katana/LocalQueue.h"
+#include "katana/MultiQueue.h"
 #include "katana/Obim.h"
 #include "katana/OrderedList.h"
 #include "katana/OwnerComputes.h"
@@ -37,9 +41,16 @@ namespace katana {
 /**
  * Scheduling policies for Galois iterators. Unless you have very specific
  * scheduling requirement, \ref PerSocketChunkLIFO or \ref PerSocketChunkFIFO is
- * a reasonable scheduling policy. If you need approximate priority scheduling,
- * use \ref OrderedByIntegerMetric. For debugging, you may be interested in
- * \ref FIFO or \ref LIFO, which try to follow serial order exactly.
+ * a reasonable scheduling policy; \ref PerSocketAdaptiveChunkFIFO chooses its
+ * chunk size at runtime instead. For irregular operators that generate a lot
+ * of work recursively, \ref ChunkDequeLIFO avoids contention on shared queues
+ * by stealing lock-free. If you need approximate priority scheduling,
+ * use \ref OrderedByIntegerMetric, or \ref AdaptiveOrderedByIntegerMetric to
+ * have the bucket width chosen at runtime. For priorities which are not
+ * integers, e.g., floating-point distances, \ref MultiQueue orders the work
+ * by a comparison instead of buckets. For debugging, you may be
+ * interested in \ref FIFO or \ref LIFO, which try to follow serial order
+ * exactly.
  *
  * The way to use a worklist is to pass it as a template parameter to
  * \ref for_each(). For example,
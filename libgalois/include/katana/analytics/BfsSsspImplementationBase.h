@@ -115,6 +115,10 @@ struct BfsSsspImplementationBase {
     auto beg = graph->edge_begin(src);
     const auto end = graph->edge_end(src);
 
+    if ((end - beg) > edge_tile_size) {
+      // read an out-of-core node's edges ahead of its tiles
+      graph->PrefetchEdges(src, src + 1);
+    }
     PushEdgeTiles(wl, beg, end, f);
   }
 
@@ -134,6 +138,7 @@ struct BfsSsspImplementationBase {
     const auto end = graph->edge_end(src);
 
     if ((end - beg) > edge_tile_size) {
+      graph->PrefetchEdges(src, src + 1);
       katana::on_each(
           [&](const unsigned tid, const unsigned numT) {
             auto p = katana::block_range(beg, end, tid, numT);
@@ -20,13 +20,20 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/Galois.h"
+#include "katana/MemoryBudget.h"
 #include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/ScratchHashMap.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -48,40 +55,182 @@ using DegreeWeight = katana::PODProperty<EdgeWeightType>;
 template <typename EdgeWeightType>
 using EdgeWeight = katana::PODProperty<EdgeWeightType>;
 
+//! A node joining or leaving a cluster
+struct ClusterMove {
+  uint64_t cluster;
+  uint64_t node;
+  bool joins;
+
+  bool operator<(const ClusterMove& other) const {
+    return std::tie(cluster, node, joins) <
+           std::tie(other.cluster, other.node, other.joins);
+  }
+};
+
 template <typename _Graph, typename _EdgeType, typename _CommunityType>
 struct ClusteringImplementationBase {
   using Graph = _Graph;
   using GNode = typename Graph::Node;
   using EdgeTy = _EdgeType;
   using CommunityType = _CommunityType;
+  //! Maps each cluster to the total weight of the edges of a node to it
+  using ClusterWeightMap = katana::ScratchHashMap<uint64_t, EdgeTy>;
 
   constexpr static const uint64_t UNASSIGNED =
       std::numeric_limits<uint64_t>::max();
 
   using CommunityArray = katana::NUMAArray<CommunityType>;
 
+  //! Clusters with at least this many edges have them sorted in parallel
+  //! during coarsening
+  constexpr static const uint64_t kParallelSortMinEdges = 1 << 16;
+
+  //! Number of values that BlockSum adds up serially
+  constexpr static const uint64_t kSumBlockSize = 1024;
+
+  //! Nodes are moved in this many rounds by deterministic algorithms;
+  //! round r holds the nodes r, r + kNumRounds, r + 2 * kNumRounds, ...
+  constexpr static const uint64_t kNumRounds = 16;
+
+  /**
+   * Sums up fn(i) for i in [0, size) in blocks of a fixed size, so that
+   * the sum of floating point values does not depend on the number of
+   * threads.
+   */
+  template <typename F>
+  static double BlockSum(uint64_t size, F fn) {
+    const uint64_t num_blocks = (size + kSumBlockSize - 1) / kSumBlockSize;
+    katana::NUMAArray<double> block_sums;
+    block_sums.allocateInterleaved(num_blocks);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_blocks),
+        [&](uint64_t b) {
+          double sum = 0;
+          uint64_t end = std::min(size, (b + 1) * kSumBlockSize);
+          for (uint64_t i = b * kSumBlockSize; i < end; ++i) {
+            sum += fn(i);
+          }
+          block_sums[b] = sum;
+        },
+        katana::no_stats());
+
+    double sum = 0;
+    for (uint64_t b = 0; b < num_blocks; ++b) {
+      sum += block_sums[b];
+    }
+    return sum;
+  }
+
+  /** \returns the number of nodes in round of kNumRounds rounds */
+  static uint64_t RoundSize(uint64_t num_nodes, uint64_t round) {
+    return (num_nodes + kNumRounds - 1 - round) / kNumRounds;
+  }
+
+  /**
+   * Fills moves with the moves of each node n of round whose local_target
+   * is a cluster other than current(n): a move out of current(n) at
+   * [0, k) and into local_target[n] at [k, 2k), both in node order.
+   * move_offsets and moves must have room for the largest round, and
+   * twice that, respectively.
+   *
+   * \returns the number of moves, 2k
+   */
+  template <typename CurrentFn>
+  static uint64_t GatherMoves(
+      uint64_t num_nodes, uint64_t round,
+      const katana::NUMAArray<uint64_t>& local_target, CurrentFn current,
+      katana::NUMAArray<uint64_t>& move_offsets,
+      katana::NUMAArray<ClusterMove>& moves) {
+    const uint64_t round_size = RoundSize(num_nodes, round);
+    if (round_size == 0) {
+      return 0;
+    }
+    auto moved = [&](uint64_t n) {
+      return local_target[n] != UNASSIGNED && local_target[n] != current(n);
+    };
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, round_size),
+        [&](uint64_t i) {
+          move_offsets[i] = moved(round + i * kNumRounds) ? 1 : 0;
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        move_offsets.begin(), move_offsets.begin() + round_size,
+        move_offsets.begin());
+    const uint64_t num_moved = move_offsets[round_size - 1];
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, round_size),
+        [&](uint64_t i) {
+          uint64_t n = round + i * kNumRounds;
+          if (moved(n)) {
+            uint64_t k = move_offsets[i] - 1;
+            moves[k] = ClusterMove{current(n), n, false};
+            moves[num_moved + k] = ClusterMove{local_target[n], n, true};
+          }
+        },
+        katana::no_stats());
+    return 2 * num_moved;
+  }
+
+  /**
+   * Applies moves[0, num_moves) to the size and degree weight of the
+   * clusters in c_info, where weight(n) is the degree weight of node n.
+   * The moves are sorted and the changes to each cluster are summed up in
+   * order, so that c_info does not depend on the number of threads even
+   * for floating point weights. Moves to UNASSIGNED are ignored.
+   */
+  template <typename WeightFn>
+  static void ApplyClusterMoves(
+      katana::NUMAArray<ClusterMove>& moves, uint64_t num_moves,
+      CommunityArray& c_info, WeightFn weight) {
+    katana::ParallelSTL::sort(moves.begin(), moves.begin() + num_moves);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_moves),
+        [&](uint64_t j) {
+          uint64_t c = moves[j].cluster;
+          if (c == UNASSIGNED || (j > 0 && moves[j - 1].cluster == c)) {
+            return;
+          }
+          EdgeTy joined_wt = 0;
+          EdgeTy left_wt = 0;
+          uint64_t joined = 0;
+          uint64_t left = 0;
+          for (uint64_t k = j; k < num_moves && moves[k].cluster == c; ++k) {
+            if (moves[k].joins) {
+              joined_wt += weight(moves[k].node);
+              ++joined;
+            } else {
+              left_wt += weight(moves[k].node);
+              ++left;
+            }
+          }
+          c_info[c].degree_wt = c_info[c].degree_wt + joined_wt - left_wt;
+          c_info[c].size = c_info[c].size + joined - left;
+        },
+        katana::steal(), katana::no_stats());
+  }
+
   /**
    * Algorithm to find the best cluster for the node
    * to move to among its neighbors in the graph and moves.
    *
-   * It updates the mapping of neighboring nodes clusters
-   * in cluster_local_map, total unique cluster edge weights
-   * in counter as well as total weight of self edges in self_loop_wt.
+   * It fills cluster_local_map, which must be empty, with the clusters of
+   * the neighboring nodes and the total weight of the edges to each, with
+   * the node's own cluster first, and adds the total weight of self edges
+   * to self_loop_wt. Callers should reuse a per-thread map across nodes so
+   * that this does not allocate.
    */
   template <typename EdgeWeightType>
   void FindNeighboringClusters(
-      const Graph& graph, GNode& n,
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, EdgeTy& self_loop_wt) {
-    uint64_t num_unique_clusters = 0;
+      const Graph& graph, GNode& n, ClusterWeightMap& cluster_local_map,
+      EdgeTy& self_loop_wt) {
+    KATANA_LOG_DEBUG_ASSERT(cluster_local_map.empty());
 
     // Add the node's current cluster to be considered
-    // for movement as well
-    cluster_local_map[graph.template GetData<CurrentCommunityId>(n)] =
-        0;                 // Add n's current cluster
-    counter.push_back(0);  // Initialize the counter to zero (no edges incident
-                           // yet)
-    num_unique_clusters++;
+    // for movement as well, with no edges incident yet
+    cluster_local_map[graph.template GetData<CurrentCommunityId>(n)] = 0;
 
     // Assuming we have grabbed lock on all the neighbors
     for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
@@ -91,17 +240,8 @@ struct ClusteringImplementationBase {
       if (*dst == n) {
         self_loop_wt += edge_wt;  // Self loop weights is recorded
       }
-      auto stored_already =
-          cluster_local_map.find(graph.template GetData<CurrentCommunityId>(
-              dst));  // Check if it already exists
-      if (stored_already != cluster_local_map.end()) {
-        counter[stored_already->second] += edge_wt;
-      } else {
-        cluster_local_map[graph.template GetData<CurrentCommunityId>(dst)] =
-            num_unique_clusters;
-        counter.push_back(edge_wt);
-        num_unique_clusters++;
-      }
+      cluster_local_map[graph.template GetData<CurrentCommunityId>(dst)] +=
+          edge_wt;
     }  // End edge loop
     return;
   }
@@ -166,6 +306,26 @@ struct ClusteringImplementationBase {
     return;
   }
 
+  /**
+   * Sums up the degree weight and the size of each cluster
+   * given by the CurrentCommunityId of the nodes, which
+   * need not be their own clusters.
+   */
+  template <typename EdgeWeightType>
+  void SumClusterDegreeWeight(const Graph& graph, CommunityArray& c_info) {
+    katana::NUMAArray<ClusterMove> moves;
+    moves.allocateInterleaved(graph.num_nodes());
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      c_info[n].degree_wt = 0;
+      c_info[n].size = 0;
+      moves[n] = ClusterMove{
+          graph.template GetData<CurrentCommunityId>(n), n, true};
+    });
+    ApplyClusterMoves(moves, graph.num_nodes(), c_info, [&](uint64_t n) {
+      return graph.template GetData<DegreeWeight<EdgeWeightType>>(n);
+    });
+  }
+
   /**
    * Computes the constant term 1/(2 * total internal edge weight)
    * of the current coarsened graph.
@@ -173,12 +333,11 @@ struct ClusteringImplementationBase {
   template <typename EdgeWeightType>
   double CalConstantForSecondTerm(const Graph& graph) {
     //Using double to avoid overflow
-    katana::GAccumulator<double> local_weight;
-    katana::do_all(katana::iterate(graph), [&graph, &local_weight](GNode n) {
-      local_weight += graph.template GetData<DegreeWeight<EdgeWeightType>>(n);
-    });
     //This is twice since graph is symmetric
-    double total_edge_weight_twice = local_weight.reduce();
+    double total_edge_weight_twice =
+        BlockSum(graph.num_nodes(), [&graph](uint64_t n) -> double {
+          return graph.template GetData<DegreeWeight<EdgeWeightType>>(n);
+        });
     return 1 / total_edge_weight_twice;
   }
 
@@ -193,12 +352,11 @@ struct ClusteringImplementationBase {
       const Graph& graph,
       katana::NUMAArray<EdgeWeightType>& degree_weight_array) {
     // Using double to avoid overflow
-    katana::GAccumulator<double> local_weight;
-    katana::do_all(katana::iterate(graph), [&](GNode n) {
-      local_weight += degree_weight_array[n];
-    });
     // This is twice since graph is symmetric
-    double total_edge_weight_twice = local_weight.reduce();
+    double total_edge_weight_twice =
+        BlockSum(graph.num_nodes(), [&](uint64_t n) -> double {
+          return degree_weight_array[n];
+        });
     return 1 / total_edge_weight_twice;
   }
 
@@ -207,13 +365,12 @@ struct ClusteringImplementationBase {
    * without swapping the cluster assignment.
    */
   uint64_t MaxModularityWithoutSwaps(
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, uint64_t self_loop_wt,
+      const ClusterWeightMap& cluster_local_map, uint64_t self_loop_wt,
       CommunityArray& c_info, EdgeTy degree_wt, uint64_t sc, double constant) {
     uint64_t max_index = sc;  // Assign the intial value as self community
     double cur_gain = 0;
     double max_gain = 0;
-    double eix = counter[0] - self_loop_wt;
+    double eix = cluster_local_map.begin()->second - self_loop_wt;
     double ax = c_info[sc].degree_wt - degree_wt;
     double eiy = 0;
     double ay = 0;
@@ -231,8 +388,7 @@ struct ClusteringImplementationBase {
           continue;
         }
 
-        eiy = counter[stored_already
-                          ->second];  // Total edges incident on cluster y
+        eiy = stored_already->second;  // Total edges incident on cluster y
         cur_gain = 2 * constant * (eiy - eix) +
                    2 * degree_wt * ((ax - ay) * constant * constant);
 
@@ -255,6 +411,129 @@ struct ClusteringImplementationBase {
     return max_index;
   }
 
+  /**
+   * Leiden-style refinement of the clusters found by moving nodes.
+   * Each node starts in a refined cluster of its own. A node that is
+   * still alone in its refined cluster and well connected to the rest of
+   * its cluster joins the refined cluster, within its cluster, of the
+   * neighbor that gains the most modularity, if any move gains. The nodes
+   * are visited in kNumRounds rounds with the moves of a round applied
+   * after it, so the refinement is deterministic.
+   *
+   * Afterwards, PreviousCommunityId holds the cluster of each node and
+   * CurrentCommunityId its refined cluster. Coarsening by the refined
+   * clusters keeps the loosely connected parts of a cluster apart in the
+   * coarsened graph, where the local moving phase starts from the
+   * clusters in PreviousCommunityId and may still separate them.
+   */
+  template <typename EdgeWeightType>
+  void RefineClusters(Graph* graph) {
+    const uint64_t num_nodes = graph->num_nodes();
+
+    CommunityArray c_info;  // Community info
+    CommunityArray r_info;  // Refined community info
+    katana::NUMAArray<uint64_t> refined;
+    katana::NUMAArray<uint64_t> local_target;
+    katana::NUMAArray<uint64_t> move_offsets;
+    katana::NUMAArray<ClusterMove> moves;
+    c_info.allocateBlocked(num_nodes);
+    r_info.allocateBlocked(num_nodes);
+    refined.allocateBlocked(num_nodes);
+    local_target.allocateBlocked(num_nodes);
+    move_offsets.allocateInterleaved(RoundSize(num_nodes, 0));
+    moves.allocateInterleaved(2 * RoundSize(num_nodes, 0));
+
+    SumClusterDegreeWeight<EdgeWeightType>(*graph, c_info);
+    const double constant =
+        CalConstantForSecondTerm<EdgeWeightType>(*graph);
+
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      refined[n] = n;
+      local_target[n] = UNASSIGNED;
+      r_info[n].degree_wt =
+          graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+      r_info[n].size = 1;
+    });
+
+    // Map each neighbor's refined cluster to the weight of the edges to it
+    katana::PerThreadStorage<ClusterWeightMap> cluster_local_maps;
+
+    for (uint64_t round = 0; round < kNumRounds; ++round) {
+      katana::do_all(
+          katana::iterate(uint64_t{0}, RoundSize(num_nodes, round)),
+          [&](uint64_t i) {
+            GNode n = round + i * kNumRounds;
+            auto n_data_curr_comm_id =
+                graph->template GetData<CurrentCommunityId>(n);
+            if (n_data_curr_comm_id == UNASSIGNED || r_info[n].size != 1) {
+              return;
+            }
+
+            auto& cluster_local_map = *cluster_local_maps.getLocal();
+            cluster_local_map.Clear();
+            EdgeTy cluster_wt = 0;
+            for (auto ii = graph->edge_begin(n); ii != graph->edge_end(n);
+                 ++ii) {
+              auto dst = graph->GetEdgeDest(ii);
+              if (*dst == n || graph->template GetData<CurrentCommunityId>(
+                                   dst) != n_data_curr_comm_id) {
+                continue;
+              }
+              auto edge_wt =
+                  graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
+              cluster_local_map[refined[*dst]] += edge_wt;
+              cluster_wt += edge_wt;
+            }
+
+            // A node is well connected to the rest of its cluster if its
+            // edges to the rest are no lighter than expected at random
+            double degree_wt =
+                graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+            double rest_wt =
+                c_info[n_data_curr_comm_id].degree_wt - degree_wt;
+            if (cluster_wt == 0 ||
+                cluster_wt < degree_wt * rest_wt * constant) {
+              return;
+            }
+
+            double max_gain = 0;
+            uint64_t max_index = UNASSIGNED;
+            for (const auto& [r, edge_wt] : cluster_local_map) {
+              double gain =
+                  edge_wt - degree_wt * r_info[r].degree_wt * constant;
+              if (gain > max_gain ||
+                  (gain == max_gain && gain > 0 && r < max_index)) {
+                max_gain = gain;
+                max_index = r;
+              }
+            }
+            local_target[n] = max_index;
+          },
+          katana::steal(), katana::loopname("Refine clusters"));
+
+      uint64_t num_moves = GatherMoves(
+          num_nodes, round, local_target,
+          [&](uint64_t n) { return refined[n]; }, move_offsets, moves);
+      ApplyClusterMoves(moves, num_moves, r_info, [&](uint64_t n) {
+        return graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+      });
+      katana::do_all(katana::iterate(uint64_t{0}, num_moves), [&](uint64_t j) {
+        if (moves[j].joins) {
+          refined[moves[j].node] = moves[j].cluster;
+        }
+      });
+    }
+
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      auto& n_data_curr_comm_id =
+          graph->template GetData<CurrentCommunityId>(n);
+      graph->template GetData<PreviousCommunityId>(n) = n_data_curr_comm_id;
+      if (n_data_curr_comm_id != UNASSIGNED) {
+        n_data_curr_comm_id = refined[n];
+      }
+    });
+  }
+
   /**
    * Computes the modularity gain of the current cluster assignment.
    */
@@ -271,9 +550,6 @@ struct ClusteringImplementationBase {
     cluster_wt_internal.allocateBlocked(graph.num_nodes());
 
     /* Calculate the overall modularity */
-    katana::GAccumulator<double> acc_e_xx;
-    katana::GAccumulator<double> acc_a2_x;
-
     katana::do_all(
         katana::iterate(graph), [&](GNode n) { cluster_wt_internal[n] = 0; });
 
@@ -289,15 +565,14 @@ struct ClusteringImplementationBase {
       }
     });
 
-    katana::do_all(katana::iterate(graph), [&](GNode n) {
-      acc_e_xx += cluster_wt_internal[n];
-      acc_a2_x +=
-          (double)(c_info[n].degree_wt) *
-          ((double)(c_info[n].degree_wt) * (double)constant_for_second_term);
+    e_xx = BlockSum(graph.num_nodes(), [&](uint64_t n) -> double {
+      return cluster_wt_internal[n];
+    });
+    a2_x = BlockSum(graph.num_nodes(), [&](uint64_t n) {
+      return (double)(c_info[n].degree_wt) *
+             ((double)(c_info[n].degree_wt) *
+              (double)constant_for_second_term);
     });
-
-    e_xx = acc_e_xx.reduce();
-    a2_x = acc_a2_x.reduce();
 
     mod = e_xx * (double)constant_for_second_term -
           a2_x * (double)constant_for_second_term;
@@ -318,14 +593,17 @@ struct ClusteringImplementationBase {
       }
       degree_weight_array[n] = total_weight;
       c_info[n].degree_wt = 0;
+      c_info[n].size = 0;
     });
 
+    katana::NUMAArray<ClusterMove> moves;
+    moves.allocateInterleaved(graph.num_nodes());
     katana::do_all(katana::iterate(graph), [&](GNode n) {
-      auto& n_data_comm_id = graph.template GetData<NodePropType>(n);
-      if (n_data_comm_id != UNASSIGNED)
-        katana::atomicAdd(
-            c_info[n_data_comm_id].degree_wt, degree_weight_array[n]);
+      moves[n] = ClusterMove{graph.template GetData<NodePropType>(n), n, true};
     });
+    ApplyClusterMoves(
+        moves, graph.num_nodes(), c_info,
+        [&](uint64_t n) { return degree_weight_array[n]; });
   }
 
   /**
@@ -361,9 +639,7 @@ struct ClusteringImplementationBase {
 
     /* Calculate the overall modularity */
     double e_xx = 0;
-    katana::GAccumulator<double> acc_e_xx;
     double a2_x = 0;
-    katana::GAccumulator<double> acc_a2_x;
 
     katana::do_all(
         katana::iterate(graph), [&](GNode n) { cluster_wt_internal[n] = 0; });
@@ -381,15 +657,14 @@ struct ClusteringImplementationBase {
       }
     });
 
-    katana::do_all(katana::iterate(graph), [&](GNode n) {
-      acc_e_xx += cluster_wt_internal[n];
-      acc_a2_x +=
-          (double)(c_info[n].degree_wt) *
-          ((double)(c_info[n].degree_wt) * (double)constant_for_second_term);
+    e_xx = BlockSum(graph.num_nodes(), [&](uint64_t n) -> double {
+      return cluster_wt_internal[n];
+    });
+    a2_x = BlockSum(graph.num_nodes(), [&](uint64_t n) {
+      return (double)(c_info[n].degree_wt) *
+             ((double)(c_info[n].degree_wt) *
+              (double)constant_for_second_term);
     });
-
-    e_xx = acc_e_xx.reduce();
-    a2_x = acc_a2_x.reduce();
 
     mod = e_xx * (double)constant_for_second_term -
           a2_x * (double)constant_for_second_term;
@@ -399,26 +674,36 @@ struct ClusteringImplementationBase {
   /**
  * Renumbers the cluster to contiguous cluster ids
  * to fill the holes in the cluster id assignments.
+ * The clusters keep the order of their ids.
  */
   uint64_t RenumberClustersContiguously(Graph* graph) {
-    std::map<uint64_t, uint64_t> cluster_local_map;
-    uint64_t num_unique_clusters = 0;
+    const uint64_t num_nodes = graph->num_nodes();
+    if (num_nodes == 0) {
+      return 0;
+    }
+
+    // Mark the ids in use; their prefix sum is one more than their new ids
+    katana::NUMAArray<uint64_t> new_ids;
+    new_ids.allocateBlocked(num_nodes);
+    katana::do_all(katana::iterate(*graph), [&](GNode n) { new_ids[n] = 0; });
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      auto n_data_curr_comm_id = graph->template GetData<CurrentCommunityId>(n);
+      if (n_data_curr_comm_id != UNASSIGNED) {
+        KATANA_LOG_DEBUG_ASSERT(n_data_curr_comm_id < num_nodes);
+        new_ids[n_data_curr_comm_id] = 1;
+      }
+    });
+    katana::ParallelSTL::partial_sum(
+        new_ids.begin(), new_ids.end(), new_ids.begin());
+    const uint64_t num_unique_clusters = new_ids[num_nodes - 1];
 
-    for (GNode n = 0; n < graph->num_nodes(); ++n) {
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
       auto& n_data_curr_comm_id =
           graph->template GetData<CurrentCommunityId>(n);
       if (n_data_curr_comm_id != UNASSIGNED) {
-        KATANA_LOG_DEBUG_ASSERT(n_data_curr_comm_id < graph->num_nodes());
-        auto stored_already = cluster_local_map.find(n_data_curr_comm_id);
-        if (stored_already != cluster_local_map.end()) {
-          n_data_curr_comm_id = stored_already->second;
-        } else {
-          cluster_local_map[n_data_curr_comm_id] = num_unique_clusters;
-          n_data_curr_comm_id = num_unique_clusters;
-          num_unique_clusters++;
-        }
+        n_data_curr_comm_id = new_ids[n_data_curr_comm_id] - 1;
       }
-    }
+    });
     return num_unique_clusters;
   }
 
@@ -498,6 +783,13 @@ struct ClusteringImplementationBase {
  * the number of unique clusters in the previous level of the graph.
  * All the edges inside a cluster are merged (edge weights are summed
  * up) to form the edges within super nodes.
+ *
+ * The edges of each cluster are gathered into a bucket of a single pair
+ * of arrays and sorted by destination cluster, so that the edges to the
+ * same cluster are adjacent and are merged in place. The buckets are
+ * filled before the properties of the finer graph are removed from
+ * pfg_mutable, so the finer edge weights and the merged edges are not
+ * held at the same time as the coarsened graph.
  */
   template <typename NodeData, typename EdgeData, typename EdgeWeightType>
   katana::Result<std::unique_ptr<katana::PropertyGraph>> GraphCoarsening(
@@ -506,79 +798,75 @@ struct ClusteringImplementationBase {
       const std::vector<std::string>& temp_node_property_names,
       const std::vector<std::string>& temp_edge_property_names) {
     using GNode = typename Graph::Node;
+    using Node = katana::GraphTopology::Node;
+    using Edge = katana::GraphTopology::Edge;
 
     katana::StatTimer TimerGraphBuild("Timer_Graph_build");
     TimerGraphBuild.start();
+    katana::MemoryPhase graph_build_memory("Timer_Graph_build");
 
     const uint64_t num_nodes_next = num_unique_clusters;
 
-    std::vector<katana::InsertBag<GNode>> cluster_bags(num_unique_clusters);
+    /* First pass to find the number of edges of each cluster */
+    katana::NUMAArray<std::atomic<uint64_t>> bucket_cursors;
+    bucket_cursors.allocateBlocked(num_nodes_next);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t c) { bucket_cursors[c] = 0; });
 
     katana::do_all(katana::iterate(graph), [&](GNode n) {
       auto n_data_curr_comm_id = graph.template GetData<CurrentCommunityId>(n);
       if (n_data_curr_comm_id != UNASSIGNED) {
-        cluster_bags[n_data_curr_comm_id].push_back(n);
+        bucket_cursors[n_data_curr_comm_id].fetch_add(
+            std::distance(graph.edge_begin(n), graph.edge_end(n)),
+            std::memory_order_relaxed);
       }
     });
 
-    std::vector<katana::gstl::Vector<uint32_t>> edges_id(num_unique_clusters);
-    std::vector<katana::gstl::Vector<EdgeTy>> edges_data(num_unique_clusters);
-
-    /* First pass to find the number of edges */
+    katana::NUMAArray<uint64_t> bucket_offsets;
+    bucket_offsets.allocateBlocked(num_nodes_next + 1);
+    bucket_offsets[0] = 0;
     katana::do_all(
-        katana::iterate(uint64_t{0}, num_unique_clusters),
-        [&](uint64_t c) {
-          katana::gstl::Map<uint64_t, uint64_t> cluster_local_map;
-          uint64_t num_unique_clusters = 0;
-          for (auto node : cluster_bags[c]) {
-            KATANA_LOG_DEBUG_ASSERT(
-                graph.template GetData<CurrentCommunityId>(node) ==
-                c);  // All nodes in this bag must have same cluster id
-
-            for (auto ii = graph.edge_begin(node); ii != graph.edge_end(node);
-                 ++ii) {
-              auto dst = graph.GetEdgeDest(ii);
-              auto dst_data_curr_comm_id =
-                  graph.template GetData<CurrentCommunityId>(dst);
-              KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
-              auto stored_already = cluster_local_map.find(
-                  dst_data_curr_comm_id);  // Check if it already exists
-              if (stored_already != cluster_local_map.end()) {
-                edges_data[c][stored_already->second] +=
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
-              } else {
-                cluster_local_map[dst_data_curr_comm_id] = num_unique_clusters;
-                edges_id[c].push_back(dst_data_curr_comm_id);
-                edges_data[c].push_back(
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii));
-                num_unique_clusters++;
-              }
-            }  // End edge loop
-          }
-        },
-        katana::steal(), katana::loopname("BuildGraph: Find edges"));
-
-    /* Serial loop to reduce all the edge counts */
-    katana::NUMAArray<uint64_t> prefix_edges_count;
-    prefix_edges_count.allocateInterleaved(num_unique_clusters);
-
-    katana::GAccumulator<uint64_t> num_edges_acc;
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t c) { bucket_offsets[c + 1] = bucket_cursors[c]; });
+    katana::ParallelSTL::partial_sum(
+        bucket_offsets.begin(), bucket_offsets.end(), bucket_offsets.begin());
     katana::do_all(
-        katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t c) {
-          prefix_edges_count[c] = edges_id[c].size();
-          num_edges_acc += prefix_edges_count[c];
-        });
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t c) { bucket_cursors[c] = bucket_offsets[c]; });
 
-    const uint64_t num_edges_next = num_edges_acc.reduce();
+    /* Second pass to gather the edges of each cluster into its bucket */
+    const uint64_t num_bucket_edges = bucket_offsets[num_nodes_next];
+    katana::NUMAArray<Node> bucket_dests;
+    katana::NUMAArray<EdgeTy> bucket_data;
+    bucket_dests.allocateInterleaved(num_bucket_edges);
+    bucket_data.allocateInterleaved(num_bucket_edges);
 
-    katana::ParallelSTL::partial_sum(
-        prefix_edges_count.begin(), prefix_edges_count.end(),
-        prefix_edges_count.begin());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto n_data_curr_comm_id =
+              graph.template GetData<CurrentCommunityId>(n);
+          if (n_data_curr_comm_id == UNASSIGNED) {
+            return;
+          }
+          uint64_t k = bucket_cursors[n_data_curr_comm_id].fetch_add(
+              std::distance(graph.edge_begin(n), graph.edge_end(n)),
+              std::memory_order_relaxed);
+          for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
+            auto dst_data_curr_comm_id =
+                graph.template GetData<CurrentCommunityId>(
+                    graph.GetEdgeDest(ii));
+            KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
+            bucket_dests[k] = dst_data_curr_comm_id;
+            bucket_data[k] =
+                graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
+            ++k;
+          }
+        },
+        katana::steal(), katana::loopname("BuildGraph: Gather edges"));
 
-    KATANA_LOG_DEBUG_ASSERT(
-        prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
-    katana::StatTimer TimerConstructFrom("Timer_Construct_From");
-    TimerConstructFrom.start();
+    bucket_cursors.deallocate();
 
     // Remove all the existing node/edge properties
     for (auto property : temp_node_property_names) {
@@ -596,8 +884,70 @@ struct ClusteringImplementationBase {
       }
     }
 
-    using Node = katana::GraphTopology::Node;
-    using Edge = katana::GraphTopology::Edge;
+    /* Sort each bucket and merge the edges to the same cluster */
+    katana::NUMAArray<uint64_t> prefix_edges_count;
+    prefix_edges_count.allocateInterleaved(num_unique_clusters);
+
+    using BucketEdge = std::pair<Node, EdgeTy>;
+    // Sorting by weight as well fixes the order in which the weights of
+    // merged edges are summed
+    auto merge_bucket = [&](uint64_t c, std::vector<BucketEdge>* buffer,
+                            auto sort) {
+      const uint64_t begin = bucket_offsets[c];
+      const uint64_t end = bucket_offsets[c + 1];
+      buffer->clear();
+      for (uint64_t k = begin; k < end; ++k) {
+        buffer->emplace_back(bucket_dests[k], bucket_data[k]);
+      }
+      sort(buffer->begin(), buffer->end());
+
+      uint64_t num_merged = 0;
+      for (const auto& [dest, data] : *buffer) {
+        if (num_merged > 0 && bucket_dests[begin + num_merged - 1] == dest) {
+          bucket_data[begin + num_merged - 1] += data;
+        } else {
+          bucket_dests[begin + num_merged] = dest;
+          bucket_data[begin + num_merged] = data;
+          ++num_merged;
+        }
+      }
+      prefix_edges_count[c] = num_merged;
+    };
+
+    // Buckets of clusters with many edges, like one that takes up most of
+    // the graph, are sorted one at a time with a parallel sort
+    katana::InsertBag<uint64_t> large_buckets;
+    katana::PerThreadStorage<std::vector<BucketEdge>> buffers;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t c) {
+          if (bucket_offsets[c + 1] - bucket_offsets[c] >=
+              kParallelSortMinEdges) {
+            large_buckets.push(c);
+            return;
+          }
+          merge_bucket(c, buffers.getLocal(), [](auto first, auto last) {
+            std::sort(first, last);
+          });
+        },
+        katana::steal(), katana::loopname("BuildGraph: Merge edges"));
+
+    std::vector<BucketEdge> large_buffer;
+    for (uint64_t c : large_buckets) {
+      merge_bucket(c, &large_buffer, [](auto first, auto last) {
+        katana::ParallelSTL::sort(first, last);
+      });
+    }
+    large_buffer = std::vector<BucketEdge>();
+
+    katana::ParallelSTL::partial_sum(
+        prefix_edges_count.begin(), prefix_edges_count.end(),
+        prefix_edges_count.begin());
+    const uint64_t num_edges_next =
+        num_nodes_next == 0 ? 0 : prefix_edges_count[num_nodes_next - 1];
+
+    katana::StatTimer TimerConstructFrom("Timer_Construct_From");
+    TimerConstructFrom.start();
 
     katana::NUMAArray<Node> out_dests_next;
     out_dests_next.allocateInterleaved(num_edges_next);
@@ -607,16 +957,19 @@ struct ClusteringImplementationBase {
 
     katana::do_all(
         katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t n) {
-          uint64_t number_of_edges =
-              (n == 0) ? prefix_edges_count[0]
-                       : (prefix_edges_count[n] - prefix_edges_count[n - 1]);
           uint64_t start_index = (n == 0) ? 0 : prefix_edges_count[n - 1];
+          uint64_t number_of_edges = prefix_edges_count[n] - start_index;
           for (uint64_t k = 0; k < number_of_edges; ++k) {
-            out_dests_next[start_index + k] = edges_id[n][k];
-            edge_data_next[start_index + k] = edges_data[n][k];
+            out_dests_next[start_index + k] =
+                bucket_dests[bucket_offsets[n] + k];
+            edge_data_next[start_index + k] =
+                bucket_data[bucket_offsets[n] + k];
           }
         });
 
+    bucket_dests.deallocate();
+    bucket_data.deallocate();
+
     TimerConstructFrom.stop();
 
     GraphTopology topo_next{
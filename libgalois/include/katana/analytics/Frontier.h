@@ -0,0 +1,192 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_FRONTIER_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_FRONTIER_H_
+
+#include <cstdint>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/Reduction.h"
+
+namespace katana::analytics {
+
+/// A set of nodes of a graph, e.g., the active nodes of a round of a
+/// bulk-synchronous algorithm (a vertex subset in Ligra, Shun and Blelloch,
+/// "Ligra: A Lightweight Graph Processing Framework for Shared Memory",
+/// PPoPP 2013).
+///
+/// A frontier is either sparse, a bag of its nodes, or dense, a bitset over
+/// all nodes. Membership is always tracked in the bitset, so nodes added
+/// twice are kept once and Contains works in both representations.
+/// EdgeMap switches between them depending on the size of the frontier.
+class Frontier {
+public:
+  using Node = GraphTopologyTypes::Node;
+
+  explicit Frontier(size_t num_nodes) { members_.resize(num_nodes); }
+
+  Frontier(const Frontier&) = delete;
+  Frontier& operator=(const Frontier&) = delete;
+
+  size_t num_nodes() const { return members_.size(); }
+
+  /// \returns the number of nodes in the frontier
+  size_t size() const { return size_.reduce(); }
+
+  bool empty() const { return size() == 0; }
+
+  bool is_dense() const { return dense_; }
+
+  /// Adds a node to the frontier. Thread safe.
+  ///
+  /// \returns true if the node was not in the frontier
+  bool Add(Node node) {
+    if (members_.set(node)) {
+      return false;
+    }
+    size_ += 1;
+    if (!dense_) {
+      sparse_.push(node);
+    }
+    return true;
+  }
+
+  bool Contains(Node node) const { return members_.test(node); }
+
+  /// Removes all nodes; the representation is kept
+  void Clear() {
+    if (dense_) {
+      members_.reset();
+    } else {
+      katana::do_all(
+          katana::iterate(sparse_), [&](Node node) { members_.reset(node); },
+          katana::no_stats());
+      sparse_.clear();
+    }
+    size_.reset();
+  }
+
+  /// Switches to the bitset representation
+  void ToDense() {
+    if (!dense_) {
+      sparse_.clear();
+      dense_ = true;
+    }
+  }
+
+  /// Switches to the bag representation
+  void ToSparse() {
+    if (dense_) {
+      members_.ForEachSetBit(
+          [&](size_t node) { sparse_.push(static_cast<Node>(node)); },
+          katana::no_stats());
+      dense_ = false;
+    }
+  }
+
+  /// Calls \param fn with every node of the frontier in parallel. \param args
+  /// are options of the underlying do_all, e.g., a loopname.
+  template <typename Fn, typename... Args>
+  void ForEach(const Fn& fn, Args&&... args) const {
+    if (dense_) {
+      members_.ForEachSetBit(
+          [&](size_t node) { fn(static_cast<Node>(node)); },
+          std::forward<Args>(args)...);
+    } else {
+      katana::do_all(
+          katana::iterate(sparse_), fn, std::forward<Args>(args)...);
+    }
+  }
+
+  /// \returns the nodes of a sparse frontier
+  const katana::InsertBag<Node>& sparse() const {
+    KATANA_LOG_DEBUG_ASSERT(!dense_);
+    return sparse_;
+  }
+
+  /// \returns the membership bitset, valid in both representations
+  const katana::DynamicBitset& dense() const { return members_; }
+
+private:
+  katana::DynamicBitset members_;
+  katana::InsertBag<Node> sparse_;
+  mutable katana::GAccumulator<size_t> size_;
+  bool dense_{false};
+};
+
+/// Edges pulled into a dense frontier per edge of a sparse frontier before
+/// EdgeMap pulls rather than pushes; the value of Ligra
+constexpr uint64_t kDefaultEdgeMapDenseFraction = 20;
+
+/// Applies \param update to the edges (src, dst) whose src is in
+/// \param frontier and adds dst to \param next when update returns true
+/// (edgeMap in Ligra). \param cond(dst) returns false once dst needs no more
+/// updates in this round.
+///
+/// If the frontier and its out-edges are more than 1/dense_fraction of the
+/// edges, EdgeMap pulls: every node dst for which cond holds scans its
+/// in-edges in \param in for sources in the frontier, until cond fails, and
+/// next is dense. Otherwise it pushes along the out-edges in \param out of
+/// the nodes of the frontier, and next is sparse. Topologies are anything
+/// with edges(node), edge_dest(edge) and degree(node), e.g., a
+/// GraphTopology; for symmetric graphs out and in may be the same.
+///
+/// When pushing, update may be called concurrently for the same dst and
+/// must be atomic; when pulling, it is called by one thread per dst.
+template <
+    typename OutTopo, typename InTopo, typename UpdateFn, typename CondFn>
+void
+EdgeMap(
+    const OutTopo& out, const InTopo& in, Frontier* frontier, Frontier* next,
+    const UpdateFn& update, const CondFn& cond, const char* loopname,
+    uint64_t dense_fraction = kDefaultEdgeMapDenseFraction) {
+  using Node = Frontier::Node;
+
+  katana::GAccumulator<uint64_t> out_degrees;
+  frontier->ForEach(
+      [&](Node src) { out_degrees += out.degree(src); }, katana::no_stats());
+  uint64_t work = frontier->size() + out_degrees.reduce();
+
+  next->Clear();
+  if (work > out.num_edges() / dense_fraction) {
+    frontier->ToDense();
+    next->ToDense();
+    katana::do_all(
+        katana::iterate(Node{0}, static_cast<Node>(frontier->num_nodes())),
+        [&](Node dst) {
+          if (!cond(dst)) {
+            return;
+          }
+          for (auto e : in.edges(dst)) {
+            Node src = in.edge_dest(e);
+            if (frontier->Contains(src) && update(src, dst)) {
+              next->Add(dst);
+            }
+            if (!cond(dst)) {
+              break;
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<64>(), katana::loopname(loopname));
+  } else {
+    frontier->ToSparse();
+    next->ToSparse();
+    katana::do_all(
+        katana::iterate(frontier->sparse()),
+        [&](Node src) {
+          for (auto e : out.edges(src)) {
+            Node dst = out.edge_dest(e);
+            if (cond(dst) && update(src, dst)) {
+              next->Add(dst);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<64>(), katana::loopname(loopname));
+  }
+}
+
+}  // namespace katana::analytics
+
+#endif
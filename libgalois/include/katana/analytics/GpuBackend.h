@@ -0,0 +1,42 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_GPUBACKEND_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_GPUBACKEND_H_
+
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+// Plans with the architecture kGPU, e.g., BfsPlan::Gpu(), run Bfs, Sssp,
+// ConnectedComponents and Pagerank on a CUDA device. Each call uploads the
+// topology and edge weights it uses and copies the results back into node
+// properties like those of the CPU plans; within a GpuBackendCache scope
+// the device copy is kept between calls instead. A library built without
+// KATANA_ENABLE_CUDA fails kGPU plans with ErrorCode::FeatureNotEnabled.
+
+/// \returns true if kGPU plans can run: the library was built with
+///     KATANA_ENABLE_CUDA and a device is visible
+KATANA_EXPORT bool GpuBackendAvailable();
+
+/// While a GpuBackendCache is alive, kGPU plans keep the topology and edge
+/// weights of the last graph on the device, so a batch of analytics on one
+/// graph uploads it once. The copy is found again by the addresses and
+/// sizes of the host arrays, which cannot tell that they were modified in
+/// place or that another graph was loaded where a freed one was: the owner
+/// of the scope promises that neither happens to the graphs it runs on, or
+/// calls ReleaseGpuBackendCache when it does. The copy is freed when the
+/// last scope ends.
+class KATANA_EXPORT GpuBackendCache {
+public:
+  GpuBackendCache();
+  ~GpuBackendCache();
+
+  GpuBackendCache(const GpuBackendCache&) = delete;
+  GpuBackendCache& operator=(const GpuBackendCache&) = delete;
+};
+
+/// Free the device copy of the graph kept within a GpuBackendCache scope,
+/// e.g., after the graph is modified
+KATANA_EXPORT void ReleaseGpuBackendCache();
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_PLANNER_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_PLANNER_H_
+
+#include <cstdint>
+
+#include "katana/TopologyStatistics.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/config.h"
+
+// The automatic plans (BfsPlan::Automatic(), SsspPlan::kAutomatic,
+// ConnectedComponentsPlan::Automatic() and TriangleCountPlan::kAutoRelabel)
+// are resolved by the analytics with the functions below, from the
+// TopologyStatistics that the graph computes once and keeps with its views.
+// The functions only compare costs, so they can also be called with the
+// statistics of a sample of a graph to plan for the whole one.
+
+namespace katana::analytics {
+
+/// The constants of the cost model of the automatic plans. Costs are in edge
+/// visits by one thread. The defaults are rough figures for a multicore
+/// server; set them for other machines, e.g., from timings of the explicit
+/// plans on a few graphs of the kind that will be analyzed.
+struct PlanCostModel {
+  /// The cost of one round of a level synchronous or bucketed traversal: the
+  /// barrier and the exchange of the worklists
+  double round_cost{4096};
+  /// The fraction of the edges that a direction optimizing BFS visits on a
+  /// power law graph, where a few pull rounds cover most of the graph
+  double direction_opt_edge_fraction{0.25};
+  /// The number of times an unordered traversal visits an edge on average,
+  /// since nodes are visited again when a shorter path to them is found
+  double asynchronous_rework{1.5};
+  /// Graphs of at most this many edges are analyzed serially, where the
+  /// parallel algorithms cannot pay for starting their rounds
+  uint64_t serial_max_edges{uint64_t{1} << 14};
+  /// The number of threads that share the edge visits; 0 for the active
+  /// threads
+  unsigned num_threads{0};
+};
+
+/// The weights of the edges of a graph, as the SSSP plans see them
+struct EdgeWeightStatistics {
+  double min{0};
+  double max{0};
+  double mean{0};
+};
+
+/// A level synchronous direction optimizing BFS costs a round per level, an
+/// asynchronous one visits edges again when it finds a shorter path; the
+/// cheaper one by model is chosen. High diameter graphs, e.g., road
+/// networks, run asynchronously.
+KATANA_EXPORT BfsPlan ChooseBfsPlan(
+    const TopologyStatistics& stats, const PlanCostModel& model = {});
+
+/// The delta of delta stepping for weights: the largest weight divided by
+/// the average degree (Meyer and Sanders), but no less than the mean weight.
+/// \returns the exponent of delta rounded down to a power of two
+KATANA_EXPORT unsigned ChooseDeltaShift(
+    const EdgeWeightStatistics& weights, double average_degree);
+
+/// Small graphs use Dijkstra. Otherwise delta stepping with the delta of
+/// ChooseDeltaShift, which is adapted at run time if the buckets along the
+/// estimated diameter would cost more rounds than edge visits, and tiled if
+/// a power law graph has nodes of more edges than a tile.
+KATANA_EXPORT SsspPlan ChooseSsspPlan(
+    const TopologyStatistics& stats, const EdgeWeightStatistics& weights,
+    const PlanCostModel& model = {});
+
+/// Small graphs use serial union-find, others Afforest
+KATANA_EXPORT ConnectedComponentsPlan ChooseConnectedComponentsPlan(
+    const TopologyStatistics& stats, const PlanCostModel& model = {});
+
+/// \returns true if sorting the nodes by degree pays for itself in triangle
+/// counting, which is the case for power law graphs
+KATANA_EXPORT bool ChooseRelabeling(const TopologyStatistics& stats);
+
+}  // namespace katana::analytics
+
+#endif
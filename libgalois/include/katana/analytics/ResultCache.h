@@ -0,0 +1,101 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_RESULTCACHE_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_RESULTCACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <arrow/api.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// The output properties of analytics, kept in memory and keyed by what
+/// determines them: the RDG directory and version of the graph (see
+/// PropertyGraph::rdg_version), the algorithm and the parameters of its
+/// plan. A service that runs the same routine on the same committed graph
+/// for many users computes it once; a new version is a new key, so stale
+/// results are never returned and age out of the cache by LRU.
+///
+/// Only routines whose output depends on the topology alone may be cached,
+/// since properties can change without a new version. Graphs without a
+/// version are computed every time.
+///
+/// The cached arrays are shared with the graphs they are added to, which
+/// must not modify them in place. A cache may be used from several threads
+/// at once.
+class KATANA_EXPORT AnalyticsResultCache {
+public:
+  static constexpr uint64_t kDefaultCapacityBytes = uint64_t{1} << 30;
+
+  explicit AnalyticsResultCache(
+      uint64_t capacity_bytes = kDefaultCapacityBytes)
+      : capacity_bytes_(capacity_bytes) {}
+
+  AnalyticsResultCache(const AnalyticsResultCache&) = delete;
+  AnalyticsResultCache& operator=(const AnalyticsResultCache&) = delete;
+
+  /// \returns the key of the result of algorithm with parameters on pg, or
+  /// nothing if pg has no version
+  static std::optional<std::string> MakeKey(
+      const PropertyGraph* pg, const std::string& algorithm,
+      const std::string& parameters);
+
+  /// \returns the values stored for key, or null, and marks them as most
+  /// recently used
+  std::shared_ptr<arrow::ChunkedArray> Find(const std::string& key);
+
+  /// Store values for key, evicting the least recently used values until
+  /// they fit. Values larger than the capacity are not stored.
+  void Insert(
+      const std::string& key, std::shared_ptr<arrow::ChunkedArray> values);
+
+  /// Add the cached result of algorithm with parameters on pg as the node
+  /// property output_property_name, which must not exist. On a miss call
+  /// compute, which must create the property, and cache the property if pg
+  /// has a version.
+  Result<void> GetOrCompute(
+      PropertyGraph* pg, const std::string& algorithm,
+      const std::string& parameters, const std::string& output_property_name,
+      const std::function<Result<void>()>& compute);
+
+  void Clear();
+
+  uint64_t capacity_bytes() const { return capacity_bytes_; }
+  uint64_t size_bytes() const;
+  uint64_t num_entries() const;
+  uint64_t num_hits() const;
+  uint64_t num_misses() const;
+
+private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<arrow::ChunkedArray> values;
+    uint64_t size_bytes;
+  };
+
+  /// Call with mutex_ held
+  void EvictUntil(uint64_t size_bytes);
+
+  uint64_t capacity_bytes_;
+  /// The entries from the most to the least recently used
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  uint64_t size_bytes_{0};
+  uint64_t num_hits_{0};
+  uint64_t num_misses_{0};
+  mutable std::mutex mutex_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,315 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SPMV_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_SPMV_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "katana/Cancellation.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Timer.h"
+#include "katana/gstl.h"
+
+namespace katana::analytics {
+
+// Products of the adjacency matrix A of a topology with a vector, where
+// A[n][m] is the number of edges from n to m. Topologies are anything with
+// num_nodes(), num_edges(), edges(node) and edge_dest(edge), e.g., a
+// GraphTopology; InEdgeTopology turns the in-edges of a bidirectional view
+// into one, whose matrix is the transpose of that of the view.
+//
+// Iterative algorithms over the links of a graph (PageRank, HITS,
+// eigenvector and Katz centrality) are sequences of these products with
+// scaling and normalization in between.
+
+/// The in-edges of a bidirectional view as a topology
+template <typename View>
+class InEdgeTopology {
+public:
+  using Node = GraphTopologyTypes::Node;
+
+  explicit InEdgeTopology(const View* view) : view_(view) {}
+
+  uint64_t num_nodes() const { return view_->num_nodes(); }
+  uint64_t num_edges() const { return view_->num_edges(); }
+  auto edges(Node node) const { return view_->in_edges(node); }
+  auto edge_dest(GraphTopologyTypes::Edge edge) const {
+    return view_->in_edge_dest(edge);
+  }
+  auto degree(Node node) const { return view_->in_degree(node); }
+
+private:
+  const View* view_;
+};
+
+constexpr unsigned kSpMVChunkSize = 64U;
+
+/// y = A x by rows: y[n] is the sum of x[m] over the edges n -> m. Each row
+/// is summed by one thread, so no atomics are needed, but the reads of x are
+/// random; see BlockedMatrix for a cache friendly order.
+template <typename Topo, typename T>
+void
+SpMVPull(
+    const Topo& topo, const katana::NUMAArray<T>& x, katana::NUMAArray<T>* y,
+    const char* loopname,
+    const katana::CancellationToken* cancellation = nullptr) {
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topo.num_nodes()),
+      [&](uint64_t n) {
+        T sum = 0;
+        for (auto e : topo.edges(n)) {
+          sum += x[topo.edge_dest(e)];
+        }
+        (*y)[n] = sum;
+      },
+      katana::steal(), katana::chunk_size<kSpMVChunkSize>(),
+      katana::loopname(loopname), katana::cancellation(cancellation));
+}
+
+/// Add value to *target atomically
+template <typename T>
+void
+SpMVAtomicAdd(T* target, T value) {
+  T old;
+  __atomic_load(target, &old, __ATOMIC_RELAXED);
+  T desired;
+  do {
+    desired = old + value;
+  } while (!__atomic_compare_exchange(
+      target, &old, &desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/// y = A^T x by scattering x[n] along the edges n -> m, with atomic adds.
+/// Rows with x[n] == 0 are skipped, so for a sparse x only the edges of its
+/// nonzeros are read (SpMSpV). This needs no transposed topology.
+template <typename Topo, typename T>
+void
+SpMVPush(
+    const Topo& topo, const katana::NUMAArray<T>& x, katana::NUMAArray<T>* y,
+    const char* loopname,
+    const katana::CancellationToken* cancellation = nullptr) {
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topo.num_nodes()),
+      [&](uint64_t n) { (*y)[n] = 0; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topo.num_nodes()),
+      [&](uint64_t n) {
+        T value = x[n];
+        if (value == 0) {
+          return;
+        }
+        for (auto e : topo.edges(n)) {
+          SpMVAtomicAdd(&(*y)[topo.edge_dest(e)], value);
+        }
+      },
+      katana::steal(), katana::chunk_size<kSpMVChunkSize>(),
+      katana::loopname(loopname), katana::cancellation(cancellation));
+}
+
+/// The nonzeros of A grouped by the block of their column, the element of x
+/// they read, and ordered by row within a block. The products over the
+/// nonzeros of one block touch only the elements of x of that block, which
+/// fit in the last level cache (propagation blocking, Beamer et al.,
+/// "Reducing PageRank Communication via Propagation Blocking", IPDPS 2017).
+/// Building the blocks costs about two passes over the edges, which pays
+/// off over the iterations of an algorithm.
+class BlockedMatrix {
+public:
+  /// 2^kBlockShift elements of x, 4 MB of floats, per block
+  static constexpr uint32_t kBlockShift = 20;
+  /// The number of nonzeros of a unit of work, rounded up to whole rows
+  static constexpr uint64_t kChunkEdges = 4096;
+
+  template <typename Topo>
+  static BlockedMatrix Make(const Topo& topo) {
+    katana::StatTimer timer("SpMV-MakeBlocks");
+    timer.start();
+
+    uint64_t num_nodes = topo.num_nodes();
+    uint64_t num_blocks = (num_nodes >> kBlockShift) + 1;
+    unsigned num_threads = katana::getActiveThreads();
+
+    // Each thread takes a contiguous range of nodes, so the edges of a block
+    // are ordered by node if placed by thread and then by node
+    auto for_each_edge = [&](auto fn) {
+      katana::on_each([&](unsigned tid, unsigned total) {
+        auto [begin, end] = katana::block_range(
+            uint32_t{0}, static_cast<uint32_t>(num_nodes), tid, total);
+        for (uint32_t n = begin; n < end; ++n) {
+          for (auto e : topo.edges(n)) {
+            uint32_t nbr = topo.edge_dest(e);
+            fn(tid, n, nbr, nbr >> kBlockShift);
+          }
+        }
+      });
+    };
+
+    // counts[t * num_blocks + b] counts the edges of thread t in block b
+    std::vector<uint64_t> counts(num_threads * num_blocks, 0);
+    for_each_edge([&](unsigned tid, uint32_t, uint32_t, uint64_t block) {
+      counts[tid * num_blocks + block] += 1;
+    });
+
+    std::vector<uint64_t> offsets(num_threads * num_blocks);
+    std::vector<uint64_t> block_begin(num_blocks + 1);
+    uint64_t offset = 0;
+    for (uint64_t b = 0; b < num_blocks; ++b) {
+      block_begin[b] = offset;
+      for (unsigned t = 0; t < num_threads; ++t) {
+        offsets[t * num_blocks + b] = offset;
+        offset += counts[t * num_blocks + b];
+      }
+    }
+    block_begin[num_blocks] = offset;
+
+    BlockedMatrix blocked;
+    blocked.num_rows_ = num_nodes;
+    blocked.edges_.allocateInterleaved(topo.num_edges());
+    for_each_edge([&](unsigned tid, uint32_t n, uint32_t nbr, uint64_t block) {
+      blocked.edges_[offsets[tid * num_blocks + block]++] = {n, nbr};
+    });
+
+    for (uint64_t b = 0; b < num_blocks; ++b) {
+      blocked.block_chunks_.push_back(blocked.chunks_.size());
+      uint64_t e = block_begin[b];
+      while (e < block_begin[b + 1]) {
+        blocked.chunks_.push_back(e);
+        e = std::min(e + kChunkEdges, block_begin[b + 1]);
+        while (e < block_begin[b + 1] &&
+               blocked.edges_[e].node == blocked.edges_[e - 1].node) {
+          ++e;
+        }
+      }
+    }
+    blocked.block_chunks_.push_back(blocked.chunks_.size());
+    blocked.chunks_.push_back(block_begin[num_blocks]);
+
+    timer.stop();
+    return blocked;
+  }
+
+  uint64_t num_rows() const { return num_rows_; }
+
+  /// y = A x, block by block
+  template <typename T>
+  void Multiply(
+      const katana::NUMAArray<T>& x, katana::NUMAArray<T>* y,
+      const char* loopname,
+      const katana::CancellationToken* cancellation = nullptr) const {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_rows_),
+        [&](uint64_t n) { (*y)[n] = 0; }, katana::no_stats());
+
+    // a chunk holds whole rows of its block, so no two threads add to the
+    // same row at the same time
+    for (size_t b = 0; b + 1 < block_chunks_.size(); ++b) {
+      katana::do_all(
+          katana::iterate(block_chunks_[b], block_chunks_[b + 1]),
+          [&](uint64_t c) {
+            uint64_t begin = chunks_[c];
+            uint64_t end = chunks_[c + 1];
+            uint32_t node = edges_[begin].node;
+            T node_sum = 0;
+            for (uint64_t e = begin; e < end; ++e) {
+              const auto& edge = edges_[e];
+              if (edge.node != node) {
+                (*y)[node] += node_sum;
+                node = edge.node;
+                node_sum = 0;
+              }
+              node_sum += x[edge.nbr];
+            }
+            (*y)[node] += node_sum;
+          },
+          katana::steal(), katana::loopname(loopname),
+          katana::cancellation(cancellation));
+    }
+  }
+
+private:
+  struct Edge {
+    uint32_t node;
+    uint32_t nbr;
+  };
+
+  uint64_t num_rows_{0};
+  katana::NUMAArray<Edge> edges_;
+  /// chunk c covers edges [chunks[c], chunks[c + 1]) and only whole nodes
+  std::vector<uint64_t> chunks_;
+  /// block b covers chunks [block_chunks[b], block_chunks[b + 1])
+  std::vector<uint64_t> block_chunks_;
+};
+
+/// The products of the adjacency matrix A of a graph, and of its transpose,
+/// with vectors, by one of three kernels:
+///
+///  - kPull sums the rows of A over the out-edges and the rows of A^T over
+///    the in-edges of a bidirectional view, with no atomics.
+///  - kBlocked does the same sums with a BlockedMatrix of each, built on
+///    first use.
+///  - kPush scatters along the out-edges for A^T, so no transposed topology
+///    is built, at the cost of atomic adds.
+class AdjacencyProducts {
+public:
+  enum Kernel { kPull, kBlocked, kPush };
+
+  AdjacencyProducts(PropertyGraph* pg, Kernel kernel)
+      : pg_(pg), kernel_(kernel) {
+    if (kernel_ != kPush) {
+      view_.emplace(pg_->BuildView<PropertyGraphViews::BiDirectional>());
+    }
+  }
+
+  /// y = A x
+  template <typename T>
+  void Multiply(
+      const katana::NUMAArray<T>& x, katana::NUMAArray<T>* y,
+      const char* loopname,
+      const katana::CancellationToken* cancellation = nullptr) {
+    if (kernel_ == kBlocked) {
+      if (!out_blocks_) {
+        out_blocks_.emplace(BlockedMatrix::Make(pg_->topology()));
+      }
+      out_blocks_->Multiply(x, y, loopname, cancellation);
+    } else {
+      SpMVPull(pg_->topology(), x, y, loopname, cancellation);
+    }
+  }
+
+  /// y = A^T x
+  template <typename T>
+  void MultiplyTransposed(
+      const katana::NUMAArray<T>& x, katana::NUMAArray<T>* y,
+      const char* loopname,
+      const katana::CancellationToken* cancellation = nullptr) {
+    switch (kernel_) {
+    case kPull:
+      SpMVPull(InEdgeTopology(&*view_), x, y, loopname, cancellation);
+      break;
+    case kBlocked:
+      if (!in_blocks_) {
+        in_blocks_.emplace(BlockedMatrix::Make(InEdgeTopology(&*view_)));
+      }
+      in_blocks_->Multiply(x, y, loopname, cancellation);
+      break;
+    case kPush:
+      SpMVPush(pg_->topology(), x, y, loopname, cancellation);
+      break;
+    }
+  }
+
+private:
+  PropertyGraph* pg_;
+  Kernel kernel_;
+  std::optional<PropertyGraphViews::BiDirectional> view_;
+  std::optional<BlockedMatrix> out_blocks_;
+  std::optional<BlockedMatrix> in_blocks_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_TRIANGLEENUMERATION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_TRIANGLEENUMERATION_H_
+
+#include <algorithm>
+#include <cstdint>
+
+#include "katana/SetIntersection.h"
+
+namespace katana::analytics {
+
+/// Calls fn(nv, nw, vw) for each triangle n > v > w of graph, with the edges
+/// nv from n to v, nw from n to w and vw from v to w, so that calling it for
+/// every node n enumerates every triangle once (the ordered count of the GAP
+/// benchmark suite). Self loops are in no triangle.
+///
+/// The edges of graph must be sorted by destination, e.g., a view with
+/// EdgesSortedByDestID; graph is anything with dest_data(), edges(node),
+/// degree(node) and num_nodes(). The neighbors of n below it are intersected
+/// with those of each v below v, which is a pass over the neighbors of v if
+/// n has so many neighbors that they go in bitmap, a per-thread SetBitmap.
+template <typename Graph, typename Fn>
+void
+ForEachOrderedTriangle(
+    const Graph& graph, typename Graph::Node n, katana::SetBitmap* bitmap,
+    const Fn& fn) {
+  using Node = typename Graph::Node;
+  using Edge = typename Graph::Edge;
+
+  const Node* dests = graph.dest_data();
+  Edge n_begin = *graph.edges(n).begin();
+  const Node* n_dests = dests + n_begin;
+  size_t n_lower =
+      std::lower_bound(n_dests, n_dests + graph.degree(n), n) - n_dests;
+
+  bool use_bitmap = n_lower >= katana::kBitmapMinSize;
+  if (use_bitmap) {
+    if (bitmap->universe() < graph.num_nodes()) {
+      bitmap->Resize(graph.num_nodes());
+    }
+    bitmap->Insert(n_dests, n_lower);
+  }
+
+  for (size_t i = 0; i < n_lower; ++i) {
+    Node v = n_dests[i];
+    Edge v_begin = *graph.edges(v).begin();
+    const Node* v_dests = dests + v_begin;
+    size_t v_lower =
+        std::lower_bound(v_dests, v_dests + graph.degree(v), v) - v_dests;
+    if (use_bitmap) {
+      for (size_t k = 0; k < v_lower; ++k) {
+        if (bitmap->Contains(v_dests[k])) {
+          // the neighbors of n below v are n_dests[0, i)
+          size_t j = std::lower_bound(n_dests, n_dests + i, v_dests[k]) -
+                     n_dests;
+          fn(n_begin + i, n_begin + j, v_begin + k);
+        }
+      }
+      continue;
+    }
+    katana::ForEachIntersection(
+        n_dests, i, v_dests, v_lower, [&](size_t j, size_t k) {
+          fn(n_begin + i, n_begin + j, v_begin + k);
+          return true;
+        });
+  }
+
+  if (use_bitmap) {
+    bitmap->Erase(n_dests, n_lower);
+  }
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -72,6 +72,13 @@ ConstructEdgeProperties(
   return pg->AddEdgeProperties(res_table.value());
 }
 
+/// \returns a copy of the values of the node property name of pg, which must
+/// have a fixed width type, such as the output of a routine run on a
+/// temporary property that is reused for another run; the batch entry points
+/// (e.g., BfsBatch) use this to collect one column per run
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> CopyNodeProperty(
+    PropertyGraph* pg, const std::string& name);
+
 class KATANA_EXPORT TemporaryPropertyGuard {
   static thread_local int temporary_property_counter;
 
@@ -134,6 +141,27 @@ public:
   ~TemporaryPropertyGuard() { Deinit(); }
 };
 
+/// Advises the topology of a graph, if it is out of core, of how an algorithm
+/// is about to read it and restores the default advice when the algorithm is
+/// done
+class KATANA_EXPORT TopologyAccessGuard {
+  const PropertyGraph* pg_;
+
+public:
+  TopologyAccessGuard(
+      const PropertyGraph* pg, GraphTopology::AccessPattern pattern)
+      : pg_(pg) {
+    pg_->topology().AdviseAccess(pattern);
+  }
+
+  const TopologyAccessGuard& operator=(const TopologyAccessGuard&) = delete;
+  TopologyAccessGuard(const TopologyAccessGuard&) = delete;
+
+  ~TopologyAccessGuard() {
+    pg_->topology().AdviseAccess(GraphTopology::AccessPattern::kNormal);
+  }
+};
+
 }  // namespace katana::analytics
 
 #endif
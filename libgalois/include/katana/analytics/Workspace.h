@@ -0,0 +1,103 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_WORKSPACE_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_WORKSPACE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <typeindex>
+#include <utility>
+
+#include "katana/DynamicBitset.h"
+#include "katana/EpochArray.h"
+#include "katana/NUMAArray.h"
+
+namespace katana::analytics {
+
+/// Memory that analytics routines reuse across calls instead of allocating
+/// (and having the operating system zero) it on each call. A caller that
+/// runs many small queries keeps one workspace and passes it to each call;
+/// routines that take a null workspace allocate as before.
+///
+/// A routine asks for its per-node and per-edge arrays, bitsets and worklists
+/// by slot, a small number that tells apart the objects of the same type that
+/// the routine uses at the same time. A slot keeps its object, and its memory,
+/// until the workspace is destroyed or Clear is called.
+///
+/// A workspace may be used by one routine at a time, from the thread that
+/// runs the routine.
+class AnalyticsWorkspace {
+public:
+  /// \returns an array of size elements for slot. The array is reallocated
+  /// only if size differs from the last call for the slot; otherwise its
+  /// elements hold what the last user left in them.
+  template <typename T>
+  NUMAArray<T>* Array(uint32_t slot, size_t size) {
+    auto* array = Get<NUMAArray<T>>(slot);
+    if (array->size() != size) {
+      array->deallocate();
+      array->allocateInterleaved(size);
+    }
+    return array;
+  }
+
+  /// \returns a bitset of size bits for slot with no bit set
+  DynamicBitset* Bitset(uint32_t slot, size_t size) {
+    auto* bitset = Get<DynamicBitset>(slot);
+    if (bitset->size() != size) {
+      bitset->resize(size);
+    }
+    bitset->reset();
+    return bitset;
+  }
+
+  /// \returns an array of size elements for slot where every element reads
+  /// as default_value; unlike Array, reusing the array costs constant
+  /// time rather than a pass over it
+  template <typename T>
+  EpochArray<T>* ClearedArray(
+      uint32_t slot, size_t size, T default_value = T{}) {
+    auto* array = Get<EpochArray<T>>(slot);
+    if (array->size() != size) {
+      array->Resize(size, default_value);
+    } else {
+      array->Reset(default_value);
+    }
+    return array;
+  }
+
+  /// \returns a default constructed object of type C for slot, e.g., a
+  /// worklist, which the caller clears before use
+  template <typename C>
+  C* Get(uint32_t slot) {
+    auto& entry = entries_[std::make_pair(std::type_index(typeid(C)), slot)];
+    if (!entry) {
+      entry = std::make_shared<C>();
+    }
+    return static_cast<C*>(entry.get());
+  }
+
+  /// Free all the memory of the workspace
+  void Clear() { entries_.clear(); }
+
+private:
+  std::map<std::pair<std::type_index, uint32_t>, std::shared_ptr<void>>
+      entries_;
+};
+
+/// \returns the array for slot of workspace or, if workspace is null,
+/// allocates local to size elements and returns it
+template <typename T>
+NUMAArray<T>*
+ArrayOrLocal(
+    AnalyticsWorkspace* workspace, uint32_t slot, size_t size,
+    NUMAArray<T>* local) {
+  if (workspace) {
+    return workspace->Array<T>(slot, size);
+  }
+  local->allocateInterleaved(size);
+  return local;
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -18,16 +18,32 @@ public:
   enum Algorithm {
     kLevel,
     kOuter,
-    // TODO(gill): Reinstate async and auto once we have bidirectional graphs.
-    // kAsynchronous,
+    kApproximate,
+    kAsynchronous,
+    // TODO(gill): Reinstate auto once we have bidirectional graphs.
     // kAutomatic,
   };
 
+  static constexpr double kDefaultErrorBound = 0.01;
+  static constexpr double kDefaultConfidence = 0.9;
+  static constexpr uint32_t kDefaultConcurrentSources = 4;
+
 private:
   Algorithm algorithm_;
-
-  BetweennessCentralityPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+  double error_bound_;
+  double confidence_;
+  uint32_t concurrent_sources_;
+
+  BetweennessCentralityPlan(
+      Architecture architecture, Algorithm algorithm,
+      double error_bound = kDefaultErrorBound,
+      double confidence = kDefaultConfidence,
+      uint32_t concurrent_sources = kDefaultConcurrentSources)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        error_bound_(error_bound),
+        confidence_(confidence),
+        concurrent_sources_(concurrent_sources) {}
 
 public:
   BetweennessCentralityPlan() : BetweennessCentralityPlan{kCPU, kLevel} {}
@@ -51,10 +67,57 @@ public:
 
   Algorithm algorithm() const { return algorithm_; }
 
+  /// The largest error of the centralities of kApproximate, as a fraction of
+  /// the number of ordered pairs of distinct nodes
+  double error_bound() const { return error_bound_; }
+
+  /// The probability that every centrality of kApproximate is within
+  /// error_bound()
+  double confidence() const { return confidence_; }
+
+  /// The number of sources kAsynchronous processes at once
+  uint32_t concurrent_sources() const { return concurrent_sources_; }
+
   static BetweennessCentralityPlan Level() { return {kCPU, kLevel}; }
 
   static BetweennessCentralityPlan Outer() { return {kCPU, kOuter}; }
 
+  /// Asynchronous Brandes: the shortest path DAG of a source is built and
+  /// its dependencies are propagated without barriers between levels.
+  /// Several sources run in the same parallel loops, each with its own copy
+  /// of the node and edge state, which keeps the threads busy on
+  /// high-diameter graphs where a single level has little work.
+  ///
+  /// @param concurrent_sources The number of sources processed at once
+  static BetweennessCentralityPlan Asynchronous(
+      uint32_t concurrent_sources = kDefaultConcurrentSources) {
+    return {
+        kCPU, kAsynchronous, kDefaultErrorBound, kDefaultConfidence,
+        concurrent_sources};
+  }
+
+  /// Estimate the centralities from the shortest paths between random pairs
+  /// of nodes (Riondato and Kornaropoulos, "Fast approximation of
+  /// betweenness centrality through sampling", WSDM 2014). The number of
+  /// pairs follows from the error bound and confidence and the vertex
+  /// diameter of the graph; the sampling stops earlier once an
+  /// empirical-Bernstein bound shows that every estimate is within the
+  /// error bound.
+  ///
+  /// The sources argument of BetweennessCentrality is ignored. The
+  /// estimates are in the units of the exact algorithms, i.e., scaled by
+  /// the number of ordered pairs of distinct nodes.
+  ///
+  /// @param error_bound The largest error of a normalized centrality, in
+  ///     (0, 1)
+  /// @param confidence The probability that no estimate exceeds the error
+  ///     bound, in (0, 1)
+  static BetweennessCentralityPlan Approximate(
+      double error_bound = kDefaultErrorBound,
+      double confidence = kDefaultConfidence) {
+    return {kCPU, kApproximate, error_bound, confidence};
+  }
+
   static BetweennessCentralityPlan FromAlgorithm(Algorithm algo) {
     return BetweennessCentralityPlan(kCPU, algo);
   }
@@ -1,10 +1,19 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_BFS_BFS_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_BFS_BFS_H_
 
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
 
+#include <arrow/api.h>
+
+#include "katana/Cancellation.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
+#include "katana/analytics/Workspace.h"
 
 namespace katana::analytics {
 
@@ -17,7 +26,8 @@ public:
     kAsynchronous,
     kSynchronousTile,
     kSynchronous,
-    kSynchronousDirectOpt
+    kSynchronousDirectOpt,
+    kAutomatic,
   };
 
   static const int kDefaultEdgeTileSize = 256;
@@ -42,7 +52,7 @@ private:
 public:
   BfsPlan()
       : BfsPlan{
-            kCPU, kSynchronousDirectOpt, kDefaultEdgeTileSize, kDefaultAlpha,
+            kCPU, kAutomatic, kDefaultEdgeTileSize, kDefaultAlpha,
             kDefaultBeta} {}
 
   Algorithm algorithm() const { return algorithm_; }
@@ -68,6 +78,14 @@ public:
       uint32_t alpha = kDefaultAlpha, uint32_t beta = kDefaultBeta) {
     return {kCPU, kSynchronousDirectOpt, 0, alpha, beta};
   }
+
+  /// Choose the algorithm from the statistics of the graph when the BFS
+  /// runs; see ChooseBfsPlan in Planner.h
+  static BfsPlan Automatic() { return {}; }
+
+  /// Level synchronous BFS on a GPU; see GpuBackend.h. Only Bfs runs it on
+  /// the GPU.
+  static BfsPlan Gpu() { return {kGPU, kSynchronous, 0, 0, 0}; }
 };
 
 /// Compute BFS parent of nodes in the graph pg starting from start_node. The
@@ -75,9 +93,25 @@ public:
 /// controls the algorithm and parameters used to compute the BFS.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
+/// If cancellation is not null and is cancelled before the BFS completes, the
+/// BFS stops early and returns ErrorCode::Cancelled.
+/// If workspace is not null, the BFS takes its temporary arrays from it.
 KATANA_EXPORT Result<void> Bfs(
     PropertyGraph* pg, uint32_t start_node,
-    const std::string& output_property_name, BfsPlan algo = {});
+    const std::string& output_property_name, BfsPlan algo = {},
+    const CancellationToken* cancellation = nullptr,
+    AnalyticsWorkspace* workspace = nullptr);
+
+/// Compute the BFS parents of nodes in the graph pg from each of sources, as
+/// Bfs does, in one call. The graph views and the output property are built
+/// once and the temporary arrays of the traversals are reused, so many small
+/// queries do not pay for them on each query; pg is left unchanged.
+/// @return a table with a uint32 column of the parents from each of sources,
+///     in order, named by the source
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> BfsBatch(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources, BfsPlan algo = {},
+    const CancellationToken* cancellation = nullptr,
+    AnalyticsWorkspace* workspace = nullptr);
 
 /// Do a quick validation of the results of a BFS computation where the results
 /// are stored in property_name. This function does do an exhaustive check.
@@ -86,6 +120,66 @@ KATANA_EXPORT Result<void> Bfs(
 KATANA_EXPORT Result<void> BfsAssertValid(
     PropertyGraph* pg, uint32_t source, const std::string& property_name);
 
+/// A computational plan for multi-source BFS, specifying how many sources
+/// are traversed together and the parameter of direction optimization.
+class MultiSourceBfsPlan : public Plan {
+public:
+  static const uint32_t kDefaultBatchSize = 256;
+  static const uint32_t kDefaultAlpha = 15;
+
+private:
+  uint32_t batch_size_;
+  uint32_t alpha_;
+
+  MultiSourceBfsPlan(
+      Architecture architecture, uint32_t batch_size, uint32_t alpha)
+      : Plan(architecture), batch_size_(batch_size), alpha_(alpha) {}
+
+public:
+  MultiSourceBfsPlan()
+      : MultiSourceBfsPlan{kCPU, kDefaultBatchSize, kDefaultAlpha} {}
+
+  /// Sources are traversed in batches of batch_size, which is 64, 256 or 512
+  uint32_t batch_size() const { return batch_size_; }
+  uint32_t alpha() const { return alpha_; }
+
+  static MultiSourceBfsPlan Batched(
+      uint32_t batch_size = kDefaultBatchSize,
+      uint32_t alpha = kDefaultAlpha) {
+    return {kCPU, batch_size, alpha};
+  }
+};
+
+/// The level of nodes that a source of MultiSourceBfs does not reach
+constexpr uint16_t kMultiSourceBfsUnreachable =
+    std::numeric_limits<uint16_t>::max();
+
+/// Compute the BFS level of nodes in the graph pg from each of sources.
+/// Each batch of sources is traversed together with one bit per source in
+/// the frontier of a node, so the edges of a node are scanned once for the
+/// whole batch rather than once per source.
+///
+/// The result is stored in a property named by output_property_name, which
+/// is created by this function and may not exist before the call. The
+/// property has a fixed size binary value of sources.size() uint16_t per
+/// node: value i of node n is the level of n from sources[i] or
+/// kMultiSourceBfsUnreachable. Levels must be less than
+/// kMultiSourceBfsUnreachable.
+/// If cancellation is not null and is cancelled before the BFS completes, the
+/// BFS stops early and returns ErrorCode::Cancelled.
+KATANA_EXPORT Result<void> MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& output_property_name, MultiSourceBfsPlan plan = {},
+    const CancellationToken* cancellation = nullptr);
+
+/// Check the levels computed by MultiSourceBfs against a BFS from each of
+/// sources. This function does an exhaustive check.
+/// @return a failure if the levels do not pass validation or if there is a
+///     failure during checking.
+KATANA_EXPORT Result<void> MultiSourceBfsAssertValid(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& property_name);
+
 /// Statistics about a graph that can be extracted from the results of BFS.
 struct KATANA_EXPORT BfsStatistics {
   /// The number of nodes reachable from the source node.
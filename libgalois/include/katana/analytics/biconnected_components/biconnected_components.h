@@ -0,0 +1,101 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_BICONNECTEDCOMPONENTS_BICONNECTEDCOMPONENTS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_BICONNECTEDCOMPONENTS_BICONNECTEDCOMPONENTS_H_
+
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for BiconnectedComponents, specifying the
+/// algorithm and any parameters associated with it.
+class BiconnectedComponentsPlan : public Plan {
+public:
+  /// Algorithm selectors for BiconnectedComponents
+  enum Algorithm { kTarjanVishkin, kSerial };
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+
+  BiconnectedComponentsPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  BiconnectedComponentsPlan()
+      : BiconnectedComponentsPlan{kCPU, kTarjanVishkin} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Tarjan and Vishkin's algorithm ("An Efficient Parallel Biconnectivity
+  /// Algorithm", SIAM J. Comput. 1985) on breadth-first spanning trees, as in
+  /// GBBS. A parallel union-find picks a root for each connected component,
+  /// a direction optimizing search from all of them builds the trees, and
+  /// subtree sizes, preorder numbers and the lowest and highest preorder
+  /// number adjacent to each subtree are computed level by level. Two tree
+  /// edges are then merged into a component by the union-find if a subtree
+  /// reaches out of its parent's subtree, or if a non-tree edge joins them.
+  static BiconnectedComponentsPlan TarjanVishkin() {
+    return {kCPU, kTarjanVishkin};
+  }
+
+  /// Hopcroft and Tarjan's depth-first search
+  static BiconnectedComponentsPlan Serial() { return {kCPU, kSerial}; }
+};
+
+/// The component of self loops, which are in no biconnected component
+constexpr uint64_t kNoBiconnectedComponent =
+    std::numeric_limits<uint64_t>::max();
+
+/// Compute the biconnected components of pg, the maximal sets of edges any
+/// two of which lie on a common simple cycle, and its articulation points,
+/// the nodes whose removal disconnects their connected component. pg must be
+/// symmetric. An edge is a bridge if it is the only edge of its component,
+/// counting both of its directions as one edge.
+///
+/// The component of each edge is the smallest edge of the component, or
+/// kNoBiconnectedComponent for self loops, so every plan gives the same
+/// result. It is stored in the edge property named
+/// edge_component_property_name (as uint64), and whether each node is an
+/// articulation point in the node property named
+/// articulation_point_property_name (as uint8). Both are created by this
+/// function and may not exist before the call.
+KATANA_EXPORT Result<void> BiconnectedComponents(
+    PropertyGraph* pg, const std::string& edge_component_property_name,
+    const std::string& articulation_point_property_name,
+    BiconnectedComponentsPlan plan = {});
+
+/// Check the components and articulation points computed by
+/// BiconnectedComponents against those of the serial algorithm.
+/// @return a failure if they differ or if there is a failure during
+///     checking.
+KATANA_EXPORT Result<void> BiconnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& edge_component_property_name,
+    const std::string& articulation_point_property_name);
+
+struct KATANA_EXPORT BiconnectedComponentsStatistics {
+  /// Total number of biconnected components in the graph.
+  uint64_t total_components;
+  /// The number of articulation points.
+  uint64_t num_articulation_points;
+  /// The number of bridges, the components of one edge.
+  uint64_t num_bridges;
+  /// The number of edges of the largest component, counting both directions
+  /// of an edge as one.
+  uint64_t largest_component_edges;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<BiconnectedComponentsStatistics> Compute(
+      PropertyGraph* pg, const std::string& edge_component_property_name,
+      const std::string& articulation_point_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
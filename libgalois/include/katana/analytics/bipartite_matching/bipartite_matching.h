@@ -0,0 +1,143 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for BipartiteMatching, specifying the algorithm
+/// and any parameters associated with it.
+class BipartiteMatchingPlan : public Plan {
+public:
+  /// Algorithm selectors for BipartiteMatching
+  enum Algorithm { kHopcroftKarp, kPushRelabel };
+
+  /// Select the global relabel interval from the size of the graph
+  static const uint64_t kDefaultGlobalRelabelInterval = 0;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint64_t global_relabel_interval_;
+
+  BipartiteMatchingPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint64_t global_relabel_interval)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        global_relabel_interval_(global_relabel_interval) {}
+
+public:
+  BipartiteMatchingPlan()
+      : BipartiteMatchingPlan{
+            kCPU, kHopcroftKarp, kDefaultGlobalRelabelInterval} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  uint64_t global_relabel_interval() const { return global_relabel_interval_; }
+
+  /// Hopcroft and Karp's algorithm, after a greedy initial matching. Each
+  /// phase finds the length of the shortest augmenting paths with a parallel
+  /// breadth-first search from the unmatched left nodes, and then searches
+  /// depth-first from all of them in parallel along the layers it found. A
+  /// right node is claimed by the first search to reach it in a phase, so
+  /// the paths found are disjoint and are augmented as soon as found.
+  static BipartiteMatchingPlan HopcroftKarp() {
+    return {kCPU, kHopcroftKarp, kDefaultGlobalRelabelInterval};
+  }
+
+  /// Goldberg and Kennedy's push-relabel algorithm for matching, with double
+  /// pushes, after a greedy initial matching. The unmatched left nodes are
+  /// discharged in parallel: each takes its right neighbor of the lowest
+  /// label, displacing the node matched to it, which is discharged next by
+  /// the same thread. After every global_relabel_interval edges scanned, the
+  /// labels are set to the distances from the unmatched right nodes by a
+  /// parallel breadth-first search. Labels read during concurrent discharges
+  /// may be stale, so the matching is finished by Hopcroft-Karp phases, which
+  /// usually find nothing left to augment.
+  static BipartiteMatchingPlan PushRelabel(
+      uint64_t global_relabel_interval = kDefaultGlobalRelabelInterval) {
+    return {kCPU, kPushRelabel, global_relabel_interval};
+  }
+};
+
+/// The sides of a bipartite graph: the nodes of the left side are either the
+/// nodes of a node type or the nodes for which a node property (a bool or an
+/// integer) is true or non-zero. The rest of the nodes are the right side.
+class BipartiteSide {
+public:
+  enum Kind { kNodeType, kNodeProperty };
+
+  /// A side of no name, which no graph has; assign it one of the sides below.
+  BipartiteSide() : BipartiteSide{kNodeType, ""} {}
+
+  /// The left side is the nodes of the node type named type_name.
+  static BipartiteSide NodeType(const std::string& type_name) {
+    return {kNodeType, type_name};
+  }
+
+  /// The left side is the nodes for which the node property named
+  /// property_name is true or non-zero.
+  static BipartiteSide NodeProperty(const std::string& property_name) {
+    return {kNodeProperty, property_name};
+  }
+
+  Kind kind() const { return kind_; }
+  const std::string& name() const { return name_; }
+
+private:
+  Kind kind_;
+  std::string name_;
+
+  BipartiteSide(Kind kind, const std::string& name)
+      : kind_(kind), name_(name) {}
+};
+
+/// The match of a node that has none
+constexpr uint32_t kBipartiteMatchingUnmatched =
+    std::numeric_limits<uint32_t>::max();
+
+/// Compute a maximum cardinality matching of the bipartite graph pg, whose
+/// sides are given by side. Edges are taken as undirected, in either
+/// direction, and edges between two nodes of the same side are ignored.
+///
+/// The node matched to each node is stored in the property named
+/// output_property_name (as a uint32_t), or kBipartiteMatchingUnmatched for
+/// the nodes left unmatched. The property named output_property_name is
+/// created by this function and may not exist before the call.
+KATANA_EXPORT Result<void> BipartiteMatching(
+    PropertyGraph* pg, const BipartiteSide& side,
+    const std::string& output_property_name, BipartiteMatchingPlan plan = {});
+
+/// Check that the property named property_name is a matching along edges of
+/// pg between its two sides, and that no augmenting path is left: no path
+/// whose edges alternate between unmatched and matched joins two unmatched
+/// nodes.
+KATANA_EXPORT Result<void> BipartiteMatchingAssertValid(
+    PropertyGraph* pg, const BipartiteSide& side,
+    const std::string& property_name);
+
+struct KATANA_EXPORT BipartiteMatchingStatistics {
+  /// The number of matched pairs of nodes.
+  uint64_t matching_size;
+  /// The number of nodes on the left side.
+  uint64_t num_left_nodes;
+  /// The number of nodes on the right side.
+  uint64_t num_right_nodes;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<BipartiteMatchingStatistics> Compute(
+      PropertyGraph* pg, const BipartiteSide& side,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CLOSENESSCENTRALITY_CLOSENESSCENTRALITY_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_CLOSENESSCENTRALITY_CLOSENESSCENTRALITY_H_
+
+#include <iostream>
+#include <string>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for ClosenessCentrality and HarmonicCentrality,
+/// specifying the algorithm and any parameters associated with it.
+///
+/// Both take the distance from every source to every node from a
+/// multi-source BFS, which traverses batch_size sources together and scans
+/// the edges of a node once per batch rather than once per source.
+class ClosenessCentralityPlan : public Plan {
+public:
+  /// Algorithm selectors for ClosenessCentrality
+  enum Algorithm { kExact, kSampled };
+
+  static const uint32_t kDefaultNumSources = 1024;
+  static const uint32_t kDefaultBatchSize = 256;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint32_t num_sources_;
+  uint32_t batch_size_;
+
+  ClosenessCentralityPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t num_sources,
+      uint32_t batch_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        num_sources_(num_sources),
+        batch_size_(batch_size) {}
+
+public:
+  ClosenessCentralityPlan()
+      : ClosenessCentralityPlan{
+            kCPU, kExact, kDefaultNumSources, kDefaultBatchSize} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of sources of kSampled
+  uint32_t num_sources() const { return num_sources_; }
+  /// The number of sources traversed together, which is 64, 256 or 512
+  uint32_t batch_size() const { return batch_size_; }
+
+  /// Every node is a source, so the centralities are exact. This takes
+  /// time proportional to the number of nodes times the number of edges,
+  /// so it is meant for small graphs.
+  static ClosenessCentralityPlan Exact(
+      uint32_t batch_size = kDefaultBatchSize) {
+    return {kCPU, kExact, kDefaultNumSources, batch_size};
+  }
+
+  /// Estimate the centralities from the distances from num_sources pivots
+  /// picked uniformly at random (Eppstein and Wang, "Fast approximation of
+  /// centrality", SODA 2001): the sums over the pivots are scaled by the
+  /// number of nodes over num_sources. The pivots are picked with a fixed
+  /// seed, so the estimates do not change between runs. A graph with at
+  /// most num_sources nodes gets the exact centralities.
+  static ClosenessCentralityPlan Sampled(
+      uint32_t num_sources = kDefaultNumSources,
+      uint32_t batch_size = kDefaultBatchSize) {
+    return {kCPU, kSampled, num_sources, batch_size};
+  }
+};
+
+/// Compute the closeness centrality of each node v of pg,
+///
+///     (r - 1) / (sum of d(u, v)) * (r - 1) / (n - 1),
+///
+/// where d(u, v) is the number of edges of a shortest path from u to v, the
+/// sum is over the r nodes u (v included) that reach v, and n is the number
+/// of nodes. The second factor (Wasserman and Faust) keeps nodes that only
+/// few nodes reach from getting a high centrality. A node that no other
+/// node reaches has centrality 0.
+///
+/// The centralities are stored in the property named output_property_name
+/// (as double), which is created by this function and may not exist before
+/// the call.
+KATANA_EXPORT Result<void> ClosenessCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan = {});
+
+/// Compute the harmonic centrality of each node v of pg, the sum of
+/// 1 / d(u, v) over the nodes u other than v that reach v. Unlike
+/// closeness, unreachable nodes simply add nothing, which suits graphs
+/// that are not connected.
+///
+/// The centralities are stored in the property named output_property_name
+/// (as double), which is created by this function and may not exist before
+/// the call.
+KATANA_EXPORT Result<void> HarmonicCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan = {});
+
+/// Statistics of the closeness or harmonic centralities in a property.
+struct KATANA_EXPORT ClosenessCentralityStatistics {
+  /// The maximum centrality across all nodes.
+  double max_centrality;
+  /// The minimum centrality across all nodes.
+  double min_centrality;
+  /// The average centrality across all nodes.
+  double average_centrality;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<ClosenessCentralityStatistics> Compute(
+      PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -2,9 +2,13 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_CONNECTEDCOMPONENTS_CONNECTEDCOMPONENTS_H_
 
 #include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/ResultCache.h"
 #include "katana/analytics/Utils.h"
 
 // API
@@ -26,7 +30,8 @@ public:
     kBlockedAsynchronous,
     kAfforest,
     kEdgeAfforest,
-    kEdgeTiledAfforest
+    kEdgeTiledAfforest,
+    kAutomatic,
   };
 
   static const ptrdiff_t kDefaultEdgeTileSize = 512;
@@ -56,7 +61,7 @@ public:
 
   ConnectedComponentsPlan()
       : ConnectedComponentsPlan{
-            kCPU, kAfforest, 0, kDefaultNeighborSampleSize,
+            kCPU, kAutomatic, 0, kDefaultNeighborSampleSize,
             kDefaultComponentSampleFrequency} {}
 
   Algorithm algorithm() const { return algorithm_; }
@@ -148,6 +153,19 @@ public:
         kCPU, kEdgeAfforest, edge_tile_size, neighbor_sample_size,
         component_sample_frequency};
   }
+
+  /// Choose the algorithm from the statistics of the graph when the
+  /// components are computed; see ChooseConnectedComponentsPlan in Planner.h
+  static ConnectedComponentsPlan Automatic() { return {}; }
+
+  /// Connected-components using Afforest sampling on a GPU; see
+  /// GpuBackend.h.
+  static ConnectedComponentsPlan Gpu(
+      uint32_t neighbor_sample_size = kDefaultNeighborSampleSize,
+      uint32_t component_sample_frequency = kDefaultComponentSampleFrequency) {
+    return {
+        kGPU, kAfforest, 0, neighbor_sample_size, component_sample_frequency};
+  }
 };
 
 /// Compute the Connected-components for pg. The pg is expected to be
@@ -157,9 +175,13 @@ public:
 /// are used by the algorithms.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
+/// If cache is not null, the components of the same version of the graph with
+/// the same plan come from it when they are there and are stored in it when
+/// not.
 KATANA_EXPORT Result<void> ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
-    ConnectedComponentsPlan plan = ConnectedComponentsPlan());
+    ConnectedComponentsPlan plan = ConnectedComponentsPlan(),
+    AnalyticsResultCache* cache = nullptr);
 
 KATANA_EXPORT Result<void> ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name);
@@ -181,5 +203,52 @@ struct KATANA_EXPORT ConnectedComponentsStatistics {
       katana::PropertyGraph* pg, const std::string& property_name);
 };
 
+/// Connected components of a graph that grows by batches of edges. The
+/// union-find forest is kept between batches, so absorbing a batch takes
+/// time proportional to the batch rather than to the graph. The component
+/// of a node is the smallest node of the component.
+///
+/// Edges are taken as undirected. Batches are absorbed in parallel with
+/// lock-free merges; Component may be called from any thread while no batch
+/// is being absorbed.
+class KATANA_EXPORT IncrementalConnectedComponents {
+public:
+  /// Start from num_nodes nodes without edges
+  explicit IncrementalConnectedComponents(uint64_t num_nodes);
+  ~IncrementalConnectedComponents();
+  IncrementalConnectedComponents(const IncrementalConnectedComponents&) =
+      delete;
+  IncrementalConnectedComponents& operator=(
+      const IncrementalConnectedComponents&) = delete;
+
+  /// Absorb every edge of pg, e.g., the graph the stream starts from. pg may
+  /// not have more nodes than this.
+  Result<void> AddGraph(const PropertyGraph* pg);
+
+  /// Absorb a batch of (source, destination) edges
+  Result<void> AddEdges(
+      const std::vector<std::pair<uint32_t, uint32_t>>& edges);
+
+  /// Add count nodes without edges after the existing ones
+  void AddNodes(uint64_t count);
+
+  /// \returns the component of node
+  uint32_t Component(uint32_t node) const;
+
+  /// Store the component of every node as uint64_t in the property named
+  /// output_property_name, which is created by this function and may not
+  /// exist before the call. pg must have as many nodes as this.
+  Result<void> WriteComponents(
+      PropertyGraph* pg, const std::string& output_property_name) const;
+
+  uint64_t num_nodes() const;
+  uint64_t num_components() const;
+
+private:
+  struct Impl;
+
+  std::unique_ptr<Impl> impl_;
+};
+
 }  // namespace katana::analytics
 #endif
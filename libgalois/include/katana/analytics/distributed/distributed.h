@@ -0,0 +1,50 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_DISTRIBUTED_DISTRIBUTED_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_DISTRIBUTED_DISTRIBUTED_H_
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "katana/Distribution.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+// API
+
+namespace katana::analytics {
+
+/// The level DistributedBfs gives nodes that the source does not reach
+constexpr uint32_t kDistributedBfsUnreachable =
+    std::numeric_limits<uint32_t>::max();
+
+// The distributed analytics run in bulk synchronous rounds on every host of
+// dist at once, each on the partition pg of that host: a round relaxes the
+// local edges and then syncs the proxies that changed. The output property
+// is created for all local nodes, mirrors included, and has the same value
+// at every proxy of a node. They are collective: every host must make the
+// same calls in the same order.
+
+/// Compute the BFS level of each node from the node with global id
+/// global_source into the uint32 property output_property_name
+KATANA_EXPORT Result<void> DistributedBfs(
+    PropertyGraph* pg, const Distribution& dist, uint64_t global_source,
+    const std::string& output_property_name);
+
+/// Label the nodes of an undirected graph, i.e., one with symmetric edges,
+/// with the smallest global id of their component in the uint64 property
+/// output_property_name
+KATANA_EXPORT Result<void> DistributedConnectedComponents(
+    PropertyGraph* pg, const Distribution& dist,
+    const std::string& output_property_name);
+
+/// Compute the Page Rank of each node like the synchronous push algorithm
+/// of Pagerank, with plan.alpha(), plan.tolerance() and
+/// plan.max_iterations(), into the float property output_property_name. The
+/// algorithm of plan is not used.
+KATANA_EXPORT Result<void> DistributedPagerank(
+    PropertyGraph* pg, const Distribution& dist,
+    const std::string& output_property_name, PagerankPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_EIGENVECTORCENTRALITY_EIGENVECTORCENTRALITY_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_EIGENVECTORCENTRALITY_EIGENVECTORCENTRALITY_H_
+
+#include <iostream>
+#include <string>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for EigenvectorCentrality, specifying the
+/// algorithm and any parameters associated with it.
+///
+/// The algorithms choose how the products with the transposed adjacency
+/// matrix are computed; they give the same centralities.
+class EigenvectorCentralityPlan : public Plan {
+public:
+  /// Algorithm selectors for EigenvectorCentrality
+  enum Algorithm { kPull, kBlocked, kPush };
+
+  static constexpr double kDefaultTolerance = 1.0e-6;
+  static const uint32_t kDefaultMaxIterations = 100;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  double tolerance_;
+  uint32_t max_iterations_;
+
+  EigenvectorCentralityPlan(
+      Architecture architecture, Algorithm algorithm, double tolerance,
+      uint32_t max_iterations)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        tolerance_(tolerance),
+        max_iterations_(max_iterations) {}
+
+public:
+  EigenvectorCentralityPlan()
+      : EigenvectorCentralityPlan{
+            kCPU, kPull, kDefaultTolerance, kDefaultMaxIterations} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Stop once the centralities change by at most tolerance in total
+  double tolerance() const { return tolerance_; }
+  /// Maximum number of iterations to execute.
+  uint32_t max_iterations() const { return max_iterations_; }
+
+  /// Gather over the in-edges of each node; no atomics, but the in-edges are
+  /// built if the graph does not have them yet.
+  static EigenvectorCentralityPlan Pull(
+      double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kPull, tolerance, max_iterations};
+  }
+
+  /// Pull with propagation blocking: the in-edges are grouped by blocks of
+  /// the centralities they read so that the reads of a block stay in the
+  /// cache. Faster on graphs much larger than the last level cache, at the
+  /// cost of 8 bytes per edge to hold the groups.
+  static EigenvectorCentralityPlan Blocked(
+      double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kBlocked, tolerance, max_iterations};
+  }
+
+  /// Centralities are pushed along the out-edges with atomic adds, so only
+  /// the out-edges are needed.
+  static EigenvectorCentralityPlan Push(
+      double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kPush, tolerance, max_iterations};
+  }
+};
+
+/// A computational plan to for KatzCentrality, specifying the algorithm and
+/// any parameters associated with it.
+class KatzCentralityPlan : public Plan {
+public:
+  /// Algorithm selectors for KatzCentrality, as for EigenvectorCentrality
+  enum Algorithm { kPull, kBlocked, kPush };
+
+  static constexpr double kDefaultAlpha = 0.1;
+  static constexpr double kDefaultBeta = 1.0;
+  static constexpr double kDefaultTolerance = 1.0e-6;
+  static const uint32_t kDefaultMaxIterations = 1000;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  double alpha_;
+  double beta_;
+  double tolerance_;
+  uint32_t max_iterations_;
+
+  KatzCentralityPlan(
+      Architecture architecture, Algorithm algorithm, double alpha,
+      double beta, double tolerance, uint32_t max_iterations)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        alpha_(alpha),
+        beta_(beta),
+        tolerance_(tolerance),
+        max_iterations_(max_iterations) {}
+
+public:
+  KatzCentralityPlan()
+      : KatzCentralityPlan{
+            kCPU, kPull, kDefaultAlpha, kDefaultBeta, kDefaultTolerance,
+            kDefaultMaxIterations} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The weight of each edge of a walk
+  double alpha() const { return alpha_; }
+  /// The centrality every node starts with
+  double beta() const { return beta_; }
+  /// Stop once the centralities change by at most tolerance in total
+  double tolerance() const { return tolerance_; }
+  /// Maximum number of iterations to execute.
+  uint32_t max_iterations() const { return max_iterations_; }
+
+  static KatzCentralityPlan Pull(
+      double alpha = kDefaultAlpha, double beta = kDefaultBeta,
+      double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kPull, alpha, beta, tolerance, max_iterations};
+  }
+
+  static KatzCentralityPlan Blocked(
+      double alpha = kDefaultAlpha, double beta = kDefaultBeta,
+      double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kBlocked, alpha, beta, tolerance, max_iterations};
+  }
+
+  static KatzCentralityPlan Push(
+      double alpha = kDefaultAlpha, double beta = kDefaultBeta,
+      double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kPush, alpha, beta, tolerance, max_iterations};
+  }
+};
+
+/// Compute the eigenvector centrality of each node of pg: the entries of
+/// the principal eigenvector of the transposed adjacency matrix, so that the
+/// centrality of a node is proportional to the sum of the centralities of
+/// the nodes with an edge to it. Found by power iteration on A^T + I, which
+/// has the same eigenvectors and does not oscillate on bipartite graphs;
+/// the centralities are scaled to a Euclidean norm of 1.
+///
+/// The centralities are stored in the property named output_property_name
+/// (as double), which is created by this function and may not exist before
+/// the call.
+KATANA_EXPORT Result<void> EigenvectorCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    EigenvectorCentralityPlan plan = {});
+
+/// Compute the Katz centrality of each node of pg, the solution x of
+/// x = alpha A^T x + beta: every walk that ends at a node adds alpha to the
+/// power of its length, times beta, to its centrality. The iterations only
+/// converge if alpha is less than 1 over the largest eigenvalue of A. The
+/// centralities are scaled to a Euclidean norm of 1.
+///
+/// The centralities are stored in the property named output_property_name
+/// (as double), which is created by this function and may not exist before
+/// the call.
+KATANA_EXPORT Result<void> KatzCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    KatzCentralityPlan plan = {});
+
+/// Check that the centralities in the property named property_name are
+/// non-negative and have a Euclidean norm of 1, or 0 for a graph without
+/// nodes.
+KATANA_EXPORT Result<void> EigenvectorCentralityAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+/// Statistics of the eigenvector or Katz centralities in a property.
+struct KATANA_EXPORT EigenvectorCentralityStatistics {
+  /// The maximum centrality across all nodes.
+  double max_centrality;
+  /// The minimum centrality across all nodes.
+  double min_centrality;
+  /// The average centrality across all nodes.
+  double average_centrality;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<EigenvectorCentralityStatistics> Compute(
+      PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+
+#include <iostream>
+#include <string>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for GraphColoring, specifying the algorithm and any
+/// parameters associated with it.
+class GraphColoringPlan : public Plan {
+public:
+  /// Algorithm selectors for GraphColoring
+  enum Algorithm { kJonesPlassmann, kLargestDegreeFirst };
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+
+  GraphColoringPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  GraphColoringPlan() : GraphColoringPlan{kCPU, kLargestDegreeFirst} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Jones and Plassmann's algorithm. In each round, the uncolored nodes
+  /// whose priority beats that of all their uncolored neighbors take, in
+  /// parallel, the smallest color none of their neighbors has. Priorities
+  /// are a hash of the node ids, so the coloring only depends on the graph.
+  static GraphColoringPlan JonesPlassmann() {
+    return {kCPU, kJonesPlassmann};
+  }
+
+  /// The rounds of JonesPlassmann, with the nodes of higher degree first and
+  /// ties broken by the hash. This usually takes fewer colors.
+  static GraphColoringPlan LargestDegreeFirst() {
+    return {kCPU, kLargestDegreeFirst};
+  }
+};
+
+/// Color the nodes of pg so that no two neighbors have the same color, using
+/// at most one more color than the largest degree. The graph must be
+/// symmetric; self loops are ignored.
+///
+/// The color of each node is stored in the property named
+/// output_property_name (as a uint32_t); the colors used are 0, 1, ...
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> GraphColoring(
+    PropertyGraph* pg, const std::string& output_property_name,
+    GraphColoringPlan plan = {});
+
+/// Check that no edge of pg, other than a self loop, joins two nodes of the
+/// same color in the property named property_name.
+KATANA_EXPORT Result<void> GraphColoringAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT GraphColoringStatistics {
+  /// The number of colors used.
+  uint32_t num_colors;
+  /// The number of nodes of the most common color.
+  uint64_t largest_color_class_size;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<GraphColoringStatistics> Compute(
+      PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHLETCENSUS_GRAPHLETCENSUS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHLETCENSUS_GRAPHLETCENSUS_H_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// The number of sets of 4 nodes of a graph whose induced subgraph is each of
+/// the connected graphs of 4 nodes (graphlets). pg must be symmetric, without
+/// self loops or parallel edges.
+///
+/// Only the 4-cycles and 4-cliques are listed; the rest follow from the
+/// degrees and the triangles on every edge by counting the copies of each
+/// graphlet in the others (Ahmed et al., "Efficient Graphlet Counting for
+/// Large Networks", ICDM 2015). The 4-cycles are counted at their node of
+/// highest degree (Chiba and Nishizeki, "Arboricity and Subgraph Listing
+/// Algorithms", SIAM J. Comput. 1985) and the 4-cliques by KCliqueCount.
+struct KATANA_EXPORT FourNodeGraphletCensus {
+  /// The number of paths of 3 edges.
+  uint64_t paths;
+  /// The number of stars of 3 edges.
+  uint64_t stars;
+  /// The number of cycles of 4 edges.
+  uint64_t cycles;
+  /// The number of triangles with an edge to a fourth node.
+  uint64_t tailed_triangles;
+  /// The number of 4-cliques less one edge.
+  uint64_t diamonds;
+  /// The number of 4-cliques.
+  uint64_t cliques;
+
+  /// Print the census in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<FourNodeGraphletCensus> Compute(PropertyGraph* pg);
+};
+
+/// Count, for every node of pg, the cycles of 4 edges through it, which need
+/// not be induced. pg must be symmetric, without self loops or parallel edges.
+///
+/// The count of each node is stored in the property named
+/// output_property_name (as uint64), which is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> FourCycleCountPerNode(
+    PropertyGraph* pg, const std::string& output_property_name);
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_HITS_HITS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_HITS_HITS_H_
+
+#include <iostream>
+#include <string>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for Hits, specifying the algorithm and any
+/// parameters associated with it.
+///
+/// The algorithms choose how the products with the adjacency matrix, and
+/// its transpose, are computed; they give the same scores.
+class HitsPlan : public Plan {
+public:
+  /// Algorithm selectors for Hits
+  enum Algorithm { kPull, kBlocked, kPush };
+
+  static constexpr double kDefaultTolerance = 1.0e-6;
+  static const uint32_t kDefaultMaxIterations = 100;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  double tolerance_;
+  uint32_t max_iterations_;
+
+  HitsPlan(
+      Architecture architecture, Algorithm algorithm, double tolerance,
+      uint32_t max_iterations)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        tolerance_(tolerance),
+        max_iterations_(max_iterations) {}
+
+public:
+  HitsPlan()
+      : HitsPlan{kCPU, kPull, kDefaultTolerance, kDefaultMaxIterations} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Stop once the scores change by at most tolerance in total
+  double tolerance() const { return tolerance_; }
+  /// Maximum number of iterations to execute.
+  uint32_t max_iterations() const { return max_iterations_; }
+
+  /// Gather over the out-edges and the in-edges of each node; no atomics,
+  /// but the in-edges are built if the graph does not have them yet.
+  static HitsPlan Pull(
+      double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kPull, tolerance, max_iterations};
+  }
+
+  /// Pull with propagation blocking: the edges are grouped by blocks of the
+  /// scores they read so that the reads of a block stay in the cache.
+  /// Faster on graphs much larger than the last level cache, at the cost of
+  /// 16 bytes per edge to hold the groups.
+  static HitsPlan Blocked(
+      double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kBlocked, tolerance, max_iterations};
+  }
+
+  /// Authority scores are pushed along the out-edges with atomic adds, so
+  /// only the out-edges are needed.
+  static HitsPlan Push(
+      double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kPush, tolerance, max_iterations};
+  }
+};
+
+/// Compute the hub and authority scores of each node of pg (Kleinberg,
+/// "Authoritative sources in a hyperlinked environment", JACM 1999). The
+/// authority of a node is the sum of the hub scores of the nodes with an edge
+/// to it, and the hub score of a node is the sum of the authorities of the
+/// nodes it has an edge to; both are scaled to sum to 1 after each
+/// iteration. Iterations stop once the hub scores change by at most
+/// plan.tolerance() in total, or after plan.max_iterations().
+///
+/// The scores are stored in the properties named hub_property_name and
+/// authority_property_name (as double), which are created by this function
+/// and may not exist before the call.
+KATANA_EXPORT Result<void> Hits(
+    PropertyGraph* pg, const std::string& hub_property_name,
+    const std::string& authority_property_name, HitsPlan plan = {});
+
+/// Check that the scores in the properties named hub_property_name and
+/// authority_property_name are non-negative and each sum to 1, or to 0 for a
+/// graph without edges.
+KATANA_EXPORT Result<void> HitsAssertValid(
+    PropertyGraph* pg, const std::string& hub_property_name,
+    const std::string& authority_property_name);
+
+struct KATANA_EXPORT HitsStatistics {
+  /// The largest hub score.
+  double max_hub_score;
+  /// The largest authority score.
+  double max_authority_score;
+  /// The number of nodes with a hub score above 0.
+  uint64_t num_hubs;
+  /// The number of nodes with an authority score above 0.
+  uint64_t num_authorities;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<HitsStatistics> Compute(
+      PropertyGraph* pg, const std::string& hub_property_name,
+      const std::string& authority_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
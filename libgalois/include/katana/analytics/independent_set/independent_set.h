@@ -16,11 +16,9 @@ public:
   enum Algorithm {
     kSerial,
     kPull,
-    // TODO(gill): These algorithms need locks and cautious operator.
-    // kNondeterministic,
-    // kDeterministicBase,
     kPriority,
-    kEdgeTiledPriority
+    kEdgeTiledPriority,
+    kDeterministicPriority
   };
 
 private:
@@ -46,6 +44,15 @@ public:
     return {kCPU, kEdgeTiledPriority};
   }
 
+  /// Rounds that add to the set the undecided nodes which beat all of their
+  /// undecided neighbors, nodes of lower degree first and ties broken by a
+  /// hash of the node ids. The picks of a round only read the flags of the
+  /// previous round, so the set does not depend on the number of threads
+  /// or on their schedule.
+  static IndependentSetPlan DeterministicPriority() {
+    return {kCPU, kDeterministicPriority};
+  }
+
   static IndependentSetPlan FromAlgorithm(Algorithm algorithm) {
     return {kCPU, algorithm};
   }
@@ -2,6 +2,8 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_JACCARD_JACCARD_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
@@ -26,11 +28,33 @@ public:
     kUnsorted,
   };
 
+  /// Algorithm selectors for JaccardTopK
+  enum Algorithm {
+    /// Compute the exact similarity to every node within two hops.
+    kExact,
+    /// Estimate similarities from MinHash signatures, comparing only nodes
+    /// that collide in a locality-sensitive hash table.
+    kMinHash,
+  };
+
+  static constexpr uint32_t kDefaultNumHashes = 64;
+  static constexpr uint32_t kDefaultRowsPerBand = 2;
+
 private:
   EdgeSorting edge_sorting_;
-
-  JaccardPlan(Architecture architecture, EdgeSorting edge_sorting)
-      : Plan(architecture), edge_sorting_(edge_sorting) {}
+  Algorithm algorithm_;
+  uint32_t num_hashes_;
+  uint32_t rows_per_band_;
+
+  JaccardPlan(
+      Architecture architecture, EdgeSorting edge_sorting,
+      Algorithm algorithm = kExact, uint32_t num_hashes = kDefaultNumHashes,
+      uint32_t rows_per_band = kDefaultRowsPerBand)
+      : Plan(architecture),
+        edge_sorting_(edge_sorting),
+        algorithm_(algorithm),
+        num_hashes_(num_hashes),
+        rows_per_band_(rows_per_band) {}
 
 public:
   /// Automatically choose an algorithm.
@@ -42,11 +66,36 @@ public:
 
   EdgeSorting edge_sorting() const { return edge_sorting_; }
 
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The number of hash functions in the signature of a node (kMinHash).
+  uint32_t num_hashes() const { return num_hashes_; }
+
+  /// The number of hashes that must all agree for two nodes to collide in
+  /// one band of the hash table (kMinHash).
+  uint32_t rows_per_band() const { return rows_per_band_; }
+
   /// The graph's edge lists are not sorted; use an algorithm that handles that.
   static JaccardPlan Unsorted() { return {kCPU, kUnsorted}; }
 
   /// The graph's edge lists are sorted; optimize based on this.
   static JaccardPlan Sorted() { return {kCPU, kSorted}; }
+
+  /// Approximate JaccardTopK with MinHash signatures (Broder, "On the
+  /// resemblance and containment of documents", 1997) and locality-sensitive
+  /// hashing. The signature of a node holds the minimum over its neighbors
+  /// of each of num_hashes hash functions, and the fraction of equal entries
+  /// of two signatures estimates their similarity. The signatures are split
+  /// into bands of rows_per_band hashes, and only nodes whose signatures are
+  /// equal in some band are compared; nodes of similarity s are compared
+  /// with probability 1 - (1 - s^r)^b for b bands of r rows. Its cost does
+  /// not depend on the size of 2-hop neighborhoods, so it suits graphs with
+  /// nodes of very high degree. Jaccard does not use this.
+  static JaccardPlan MinHash(
+      uint32_t num_hashes = kDefaultNumHashes,
+      uint32_t rows_per_band = kDefaultRowsPerBand) {
+    return {kCPU, kUnknown, kMinHash, num_hashes, rows_per_band};
+  }
 };
 
 /// The tag for the output property of Jaccard in PropertyGraphs.
@@ -61,6 +110,20 @@ KATANA_EXPORT Result<void> Jaccard(
     PropertyGraph* pg, uint32_t compare_node,
     const std::string& output_property_name, JaccardPlan plan = {});
 
+/// Compute, for every node n, the k other nodes most similar to n, by
+/// decreasing similarity and then by increasing node id. With the kExact
+/// algorithm of plan (the default), the candidates for n are the nodes that
+/// share a neighbor with n, found by walking in-edges of the neighbors of n,
+/// and their similarities are the ones Jaccard computes; a node may have
+/// fewer than k nodes of positive similarity. Each thread keeps the counts
+/// of shared neighbors for one node at a time and a heap of at most k
+/// candidates. With kMinHash, similarities are estimated; see
+/// JaccardPlan::MinHash.
+///
+/// \returns, for each node, (node, similarity) pairs
+KATANA_EXPORT Result<std::vector<std::vector<std::pair<uint32_t, double>>>>
+JaccardTopK(PropertyGraph* pg, size_t k, JaccardPlan plan = {});
+
 KATANA_EXPORT Result<void> JaccardAssertValid(
     PropertyGraph* pg, uint32_t compare_node, const std::string& property_name);
 
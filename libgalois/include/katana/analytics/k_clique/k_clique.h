@@ -0,0 +1,71 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_KCLIQUE_KCLIQUE_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_KCLIQUE_KCLIQUE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for KCliqueCount, specifying the algorithm and any
+/// parameters associated with it.
+///
+/// Both algorithms direct every edge from one end to the other by an order
+/// of the nodes, so that each clique is found once, from its highest node,
+/// and list cliques by intersecting the sorted destinations of the directed
+/// edges (kClist: Danisch, Balalau and Sozio, "Listing k-cliques in Sparse
+/// Real-World Graphs", WWW 2018). The destinations of a node with many of
+/// them go in a per-thread bitmap, as in the ordered count of TriangleCount.
+class KCliquePlan : public Plan {
+public:
+  /// Algorithm selectors for KCliqueCount
+  enum Algorithm { kDegreeOrdered, kColorOrdered };
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+
+  KCliquePlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  KCliquePlan() : KCliquePlan{kCPU, kDegreeOrdered} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Edges go from higher to lower degree, as in the ordered count of
+  /// TriangleCount, which bounds the number of edges out of every node by
+  /// the square root of twice the number of edges.
+  static KCliquePlan DegreeOrdered() { return {kCPU, kDegreeOrdered}; }
+
+  /// Edges go from higher to lower color of a graph coloring (Li et al.,
+  /// "Ordering Heuristics for k-clique Listing", VLDB 2020). The colors
+  /// along a clique then strictly decrease, so a node of color c starts no
+  /// clique of more than c + 1 nodes, which prunes most of the search for
+  /// large k. The coloring costs a run of GraphColoring.
+  static KCliquePlan ColorOrdered() { return {kCPU, kColorOrdered}; }
+};
+
+/// Count the cliques of k nodes of pg, which must be symmetric; self loops
+/// and parallel edges are ignored. The cliques of 1 node are the nodes, of 2
+/// nodes the edges (counting both directions as one) and of 3 nodes the
+/// triangles.
+KATANA_EXPORT Result<uint64_t> KCliqueCount(
+    PropertyGraph* pg, uint32_t k, KCliquePlan plan = {});
+
+/// Count, for every node of pg, the cliques of k nodes that contain it, as
+/// KCliqueCount counts them, so the counts sum to k times the cliques.
+///
+/// The count of each node is stored in the property named
+/// output_property_name (as uint64), which is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> KCliqueCountPerNode(
+    PropertyGraph* pg, uint32_t k, const std::string& output_property_name,
+    KCliquePlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -2,6 +2,10 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_KCORE_KCORE_H_
 
 #include <iostream>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
 
 #include <katana/analytics/Plan.h>
 
@@ -55,6 +59,32 @@ KATANA_EXPORT Result<void> KCoreAssertValid(
     PropertyGraph* pg, uint32_t k_core_number,
     const std::string& property_name);
 
+/// Compute the core number of every node of pg, the largest k such that the
+/// node is in the k-core. The pg must be symmetric.
+///
+/// Nodes are peeled in increasing order of degree from buckets of nodes by
+/// degree (Dhulipala, Blelloch and Shun, "Julienne: a framework for parallel
+/// graph algorithms using work-efficient bucketing", SPAA 2017): all nodes of
+/// the lowest non-empty bucket are peeled in parallel, and neighbors whose
+/// degree drops move to lower buckets, down to the bucket being peeled. Only
+/// a range of low buckets is materialized at a time. This takes work linear
+/// in the size of the graph, unlike running KCore for every k.
+///
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> KCoreDecomposition(
+    PropertyGraph* pg, const std::string& output_property_name);
+
+/// Compute the k-core of pg for each of k_core_numbers in one call: the core
+/// numbers are computed once, as KCoreDecomposition does, and a node is in the
+/// k-core if its core number is at least k. The pg must be symmetric and is
+/// left unchanged.
+/// @return a table with a uint32 column for each of k_core_numbers, in order,
+///     named by the k, holding 1 for the nodes in the k-core and 0 otherwise,
+///     as KCore does
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> KCoreBatch(
+    PropertyGraph* pg, const std::vector<uint32_t>& k_core_numbers);
+
 struct KATANA_EXPORT KCoreStatistics {
   /// Total number of node left in the core.
   uint64_t number_of_nodes_in_kcore;
@@ -67,5 +97,19 @@ struct KATANA_EXPORT KCoreStatistics {
       const std::string& property_name);
 };
 
+struct KATANA_EXPORT KCoreDecompositionStatistics {
+  /// The largest core number, the degeneracy of the graph.
+  uint32_t max_core_number;
+
+  /// Number of nodes in the core with the largest core number.
+  uint64_t number_of_nodes_in_max_core;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<KCoreDecompositionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
 }  // namespace katana::analytics
 #endif
@@ -0,0 +1,109 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_KSHORTESTPATHS_KSHORTESTPATHS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_KSHORTESTPATHS_KSHORTESTPATHS_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for KShortestPaths, specifying the algorithm and
+/// any parameters associated with it.
+class KShortestPathsPlan : public Plan {
+public:
+  /// Algorithm selectors for KShortestPaths
+  enum Algorithm { kYen, kLabelSetting };
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+
+  KShortestPathsPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  KShortestPathsPlan() : KShortestPathsPlan{kCPU, kYen} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The k shortest simple paths, which visit no node twice, by Yen's
+  /// algorithm (Yen, "Finding the k shortest loopless paths in a network",
+  /// Management Science 1971) with Lawler's rule of only deviating from a
+  /// path after the node where it deviated from its parent. The spur
+  /// searches from the nodes of a path run in parallel, as A* searches
+  /// guided by the distances to the target.
+  static KShortestPathsPlan Yen() { return {kCPU, kYen}; }
+
+  /// The k shortest paths, which may visit nodes more than once, by a
+  /// label-setting search that settles each node at most k times, guided by
+  /// the distances to the target.
+  static KShortestPathsPlan LabelSetting() { return {kCPU, kLabelSetting}; }
+};
+
+/// A path found by KShortestPathsQuery
+struct KATANA_EXPORT WeightedPath {
+  /// The nodes of the path, from the source to the target
+  std::vector<uint32_t> nodes;
+  /// The sum of the weights of the edges of the path
+  double weight;
+};
+
+/// Answers queries for the k shortest paths between two nodes of a graph.
+/// Paths are sequences of nodes, so of parallel edges only the lightest is
+/// used. A query first computes the distances to the target along in-edges
+/// and then searches from the source; the paths of a query are stored in a
+/// pool in which a path shares its nodes with the paths it deviates from.
+///
+/// A query runs on the calling thread and reuses the search state of that
+/// thread from earlier queries, except that the spur searches of Yen's
+/// algorithm run in parallel. Queries may run concurrently from the threads
+/// of a parallel loop and from one thread outside of the thread pool.
+///
+/// The graph must outlive the query object and its topology and edge weights
+/// may not change while it is used.
+class KATANA_EXPORT KShortestPathsQuery {
+public:
+  /// Prepare to answer queries on pg. If edge_weight_property_name is empty,
+  /// the weight of a path is its number of edges. Otherwise, it is the sum of
+  /// the weights from the property named edge_weight_property_name (which may
+  /// be a 32- or 64-bit sign or unsigned int, a float or a double) along the
+  /// path; weights may not be negative.
+  static Result<std::unique_ptr<KShortestPathsQuery>> Make(
+      PropertyGraph* pg, const std::string& edge_weight_property_name = "",
+      KShortestPathsPlan plan = {});
+
+  ~KShortestPathsQuery();
+
+  KShortestPathsQuery(const KShortestPathsQuery&) = delete;
+  KShortestPathsQuery& operator=(const KShortestPathsQuery&) = delete;
+  KShortestPathsQuery(KShortestPathsQuery&&) = delete;
+  KShortestPathsQuery& operator=(KShortestPathsQuery&&) = delete;
+
+  /// \returns up to k shortest paths from source to target, in order of
+  /// weight; fewer if there are not k paths
+  Result<std::vector<WeightedPath>> Paths(
+      uint32_t source, uint32_t target, size_t k) const;
+
+private:
+  struct Impl;
+
+  explicit KShortestPathsQuery(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+/// Compute up to k shortest paths from source to target in pg, in order of
+/// weight; see KShortestPathsQuery. To answer several queries on the same
+/// graph, make a KShortestPathsQuery once instead.
+KATANA_EXPORT Result<std::vector<WeightedPath>> KShortestPaths(
+    PropertyGraph* pg, uint32_t source, uint32_t target, size_t k,
+    const std::string& edge_weight_property_name = "",
+    KShortestPathsPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
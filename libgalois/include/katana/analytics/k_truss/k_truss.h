@@ -57,6 +57,24 @@ KATANA_EXPORT Result<void> KTrussAssertValid(
     PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& property_name);
 
+/// Compute the trussness of every edge of pg, the largest k such that the
+/// edge is in the k-truss. The pg is expected to be symmetric. Both
+/// directions of an edge get the same trussness; an edge in no triangle has
+/// trussness 2 and a self loop has trussness 0.
+///
+/// The support of each edge, the number of triangles it is in, is counted by
+/// intersecting the sorted neighbor lists of its endpoints. Edges are then
+/// peeled in increasing order of support from buckets of edges by support:
+/// all edges of the lowest non-empty bucket are peeled in parallel, and the
+/// other edges of their triangles move to lower buckets, down to the bucket
+/// being peeled. Only a range of low buckets is materialized at a time. This
+/// gives the k-truss for every k in one run, unlike running KTruss for each k.
+///
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> KTrussDecomposition(
+    PropertyGraph* pg, const std::string& output_property_name);
+
 struct KATANA_EXPORT KTrussStatistics {
   /// Total number of edges left in the truss.
   uint64_t number_of_edges_left;
@@ -69,5 +87,19 @@ struct KATANA_EXPORT KTrussStatistics {
       const std::string& property_name);
 };
 
+struct KATANA_EXPORT KTrussDecompositionStatistics {
+  /// The largest trussness of an edge.
+  uint32_t max_trussness;
+
+  /// Number of edges in the truss with the largest trussness.
+  uint64_t number_of_edges_in_max_truss;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<KTrussDecompositionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
 }  // namespace katana::analytics
 #endif
@@ -0,0 +1,105 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_LABELPROPAGATION_LABELPROPAGATION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_LABELPROPAGATION_LABELPROPAGATION_H_
+
+#include <iostream>
+#include <string>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for LabelPropagation, specifying the algorithm
+/// and any parameters associated with it.
+class LabelPropagationPlan : public Plan {
+public:
+  /// Algorithm selectors for LabelPropagation
+  enum Algorithm { kSynchronous, kAsynchronous };
+
+  static const uint32_t kDefaultMaxIterations = 20;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint32_t max_iterations_;
+
+  LabelPropagationPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t max_iterations)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        max_iterations_(max_iterations) {}
+
+public:
+  LabelPropagationPlan()
+      : LabelPropagationPlan{kCPU, kAsynchronous, kDefaultMaxIterations} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Maximum number of iterations to execute.
+  uint32_t max_iterations() const { return max_iterations_; }
+
+  /// In each iteration, every node takes, in parallel, the label of the
+  /// largest total edge weight among its neighbors in the previous
+  /// iteration. A node keeps its label when that is among the heaviest, and
+  /// otherwise takes the smallest of them, so the labels only depend on the
+  /// graph. Stops after an iteration in which no label changes; labels may
+  /// also swap back and forth between the two sides of a bipartite part of
+  /// the graph until max_iterations.
+  static LabelPropagationPlan Synchronous(
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kSynchronous, max_iterations};
+  }
+
+  /// The same choice of labels, but every node reads the labels of its
+  /// neighbors as they are updated, and only the neighbors of the nodes
+  /// whose label changed are visited in the next iteration. Usually takes
+  /// fewer and faster iterations, but the labels depend on the schedule of
+  /// the threads.
+  static LabelPropagationPlan Asynchronous(
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kAsynchronous, max_iterations};
+  }
+};
+
+/// Find communities in pg by label propagation: every node starts with its own
+/// id as a label and repeatedly takes the label most of its neighbors have.
+/// The graph must be symmetric, and self loops are ignored.
+/// The edge weights are taken from the property named
+/// edge_weight_property_name (which may be a 32- or 64-bit sign or unsigned
+/// int, or a float or a double). The nodes of a label form a community, whose
+/// ID is the smallest id of a node in it; the community IDs are stored in the
+/// property named output_property_name (as uint64_t). The property named
+/// output_property_name is created by this function and may not exist before
+/// the call.
+KATANA_EXPORT Result<void> LabelPropagation(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, LabelPropagationPlan plan = {});
+
+/// Check that every community ID in the property named property_name is the
+/// smallest id of a node of that community.
+KATANA_EXPORT Result<void> LabelPropagationAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT LabelPropagationStatistics {
+  /// Total number of unique communities in the graph.
+  uint64_t n_communities;
+  /// Total number of communities with more than 1 node.
+  uint64_t n_non_trivial_communities;
+  /// The number of nodes present in the largest community.
+  uint64_t largest_community_size;
+  /// The proportion of nodes present in the largest community.
+  double largest_community_proportion;
+  /// Modularity of the communities
+  double modularity;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<LabelPropagationStatistics> Compute(
+      PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
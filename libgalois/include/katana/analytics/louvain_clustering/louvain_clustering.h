@@ -23,6 +23,7 @@ public:
   static constexpr double kDefaultModularityThresholdTotal = 0.01;
   static const uint32_t kDefaultMaxIterations = 10;
   static const uint32_t kDefaultMinGraphSize = 100;
+  static const bool kDefaultEnableRefinement = false;
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -33,18 +34,20 @@ private:
   double modularity_threshold_total_;
   uint32_t max_iterations_;
   uint32_t min_graph_size_;
+  bool enable_refinement_;
 
   LouvainClusteringPlan(
       Architecture architecture, Algorithm algorithm, bool enable_vf,
       double modularity_threshold_per_round, double modularity_threshold_total,
-      uint32_t max_iterations, uint32_t min_graph_size)
+      uint32_t max_iterations, uint32_t min_graph_size, bool enable_refinement)
       : Plan(architecture),
         algorithm_(algorithm),
         enable_vf_(enable_vf),
         modularity_threshold_per_round_(modularity_threshold_per_round),
         modularity_threshold_total_(modularity_threshold_total),
         max_iterations_(max_iterations),
-        min_graph_size_(min_graph_size) {}
+        min_graph_size_(min_graph_size),
+        enable_refinement_(enable_refinement) {}
 
 public:
   LouvainClusteringPlan()
@@ -55,7 +58,8 @@ public:
             kDefaultModularityThresholdPerRound,
             kDefaultModularityThresholdTotal,
             kDefaultMaxIterations,
-            kDefaultMinGraphSize} {}
+            kDefaultMinGraphSize,
+            kDefaultEnableRefinement} {}
 
   Algorithm algorithm() const { return algorithm_; }
   /// Enable vertex following optimization
@@ -72,6 +76,11 @@ public:
   uint32_t max_iterations() const { return max_iterations_; }
   /// Minimum coarsened graph size
   uint32_t min_graph_size() const { return min_graph_size_; }
+  /// Refine the clusters of each level before coarsening, as in the Leiden
+  /// algorithm, so that the clusters of the coarsened graph are well
+  /// connected and the next level can still split loosely attached nodes
+  /// off of them
+  bool enable_refinement() const { return enable_refinement_; }
 
   /// Nondeterministic algorithm for louvain clustering
   /// usign katana do_all
@@ -81,7 +90,8 @@ public:
           kDefaultModularityThresholdPerRound,
       double modularity_threshold_total = kDefaultModularityThresholdTotal,
       uint32_t max_iterations = kDefaultMaxIterations,
-      uint32_t min_graph_size = kDefaultMinGraphSize) {
+      uint32_t min_graph_size = kDefaultMinGraphSize,
+      bool enable_refinement = kDefaultEnableRefinement) {
     return {
         kCPU,
         kDoAll,
@@ -89,18 +99,22 @@ public:
         modularity_threshold_per_round,
         modularity_threshold_total,
         max_iterations,
-        min_graph_size};
+        min_graph_size,
+        enable_refinement};
   }
 
   /// Deterministic algorithm for louvain clustering
-  /// using delayed updates
+  /// using delayed updates. The nodes move in rounds by node id and the
+  /// moves of a round are applied in sorted order, so the clusters are the
+  /// same for any number of threads.
   static LouvainClusteringPlan Deterministic(
       bool enable_vf = kDefaultEnableVF,
       double modularity_threshold_per_round =
           kDefaultModularityThresholdPerRound,
       double modularity_threshold_total = kDefaultModularityThresholdTotal,
       uint32_t max_iterations = kDefaultMaxIterations,
-      uint32_t min_graph_size = kDefaultMinGraphSize) {
+      uint32_t min_graph_size = kDefaultMinGraphSize,
+      bool enable_refinement = kDefaultEnableRefinement) {
     return {
         kCPU,
         kDeterministic,
@@ -108,7 +122,8 @@ public:
         modularity_threshold_per_round,
         modularity_threshold_total,
         max_iterations,
-        min_graph_size};
+        min_graph_size,
+        enable_refinement};
   }
 };
 
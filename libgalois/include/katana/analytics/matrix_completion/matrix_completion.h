@@ -0,0 +1,143 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MATRIXCOMPLETION_MATRIXCOMPLETION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MATRIXCOMPLETION_MATRIXCOMPLETION_H_
+
+#include <iostream>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for MatrixCompletion, specifying the algorithm and
+/// any parameters associated with it.
+class MatrixCompletionPlan : public Plan {
+public:
+  /// Algorithm selectors for MatrixCompletion
+  enum Algorithm { kSgd, kAls };
+
+  static const uint32_t kDefaultLatentVectorSize = 20;
+  static constexpr double kDefaultLambda = 0.05;
+  static constexpr double kDefaultLearningRate = 0.012;
+  static constexpr double kDefaultDecayRate = 0.015;
+  static const uint32_t kDefaultMaxRounds = 20;
+  static constexpr double kDefaultTolerance = 0.001;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint32_t latent_vector_size_;
+  double lambda_;
+  double learning_rate_;
+  double decay_rate_;
+  uint32_t max_rounds_;
+  double tolerance_;
+
+  MatrixCompletionPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t latent_vector_size, double lambda, double learning_rate,
+      double decay_rate, uint32_t max_rounds, double tolerance)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        latent_vector_size_(latent_vector_size),
+        lambda_(lambda),
+        learning_rate_(learning_rate),
+        decay_rate_(decay_rate),
+        max_rounds_(max_rounds),
+        tolerance_(tolerance) {}
+
+public:
+  MatrixCompletionPlan()
+      : MatrixCompletionPlan{
+            kCPU,
+            kSgd,
+            kDefaultLatentVectorSize,
+            kDefaultLambda,
+            kDefaultLearningRate,
+            kDefaultDecayRate,
+            kDefaultMaxRounds,
+            kDefaultTolerance} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  uint32_t latent_vector_size() const { return latent_vector_size_; }
+  double lambda() const { return lambda_; }
+  double learning_rate() const { return learning_rate_; }
+  double decay_rate() const { return decay_rate_; }
+  uint32_t max_rounds() const { return max_rounds_; }
+  double tolerance() const { return tolerance_; }
+
+  /// Stochastic gradient descent, Hogwild style: the ratings of different
+  /// users are applied in parallel, and the latent vectors they share are
+  /// updated without locks. Round r takes steps of learning_rate * 1.5 /
+  /// (1 + decay_rate * (r + 1)^1.5) against the gradient of the squared
+  /// error of a rating plus lambda times the squared norms of its latent
+  /// vectors.
+  static MatrixCompletionPlan Sgd(
+      uint32_t latent_vector_size = kDefaultLatentVectorSize,
+      double lambda = kDefaultLambda,
+      double learning_rate = kDefaultLearningRate,
+      double decay_rate = kDefaultDecayRate,
+      uint32_t max_rounds = kDefaultMaxRounds,
+      double tolerance = kDefaultTolerance) {
+    return {
+        kCPU,       kSgd,       latent_vector_size, lambda, learning_rate,
+        decay_rate, max_rounds, tolerance};
+  }
+
+  /// Alternating least squares: each round solves, in parallel, the
+  /// regularized least squares problem of every user with the item vectors
+  /// fixed, and then that of every item with the user vectors fixed.
+  static MatrixCompletionPlan Als(
+      uint32_t latent_vector_size = kDefaultLatentVectorSize,
+      double lambda = kDefaultLambda, uint32_t max_rounds = kDefaultMaxRounds,
+      double tolerance = kDefaultTolerance) {
+    return {
+        kCPU,
+        kAls,
+        latent_vector_size,
+        lambda,
+        kDefaultLearningRate,
+        kDefaultDecayRate,
+        max_rounds,
+        tolerance};
+  }
+};
+
+/// Factor the sparse matrix of ratings held by the bipartite graph pg: every
+/// edge goes from a user to an item, with its rating in the edge property
+/// named edge_rating_property_name (which may be a float, a double or a 32-
+/// or 64-bit signed or unsigned int). A latent vector is found for each
+/// node, so that the dot product of the vectors of a user and an item
+/// predicts the rating. Rounds are run until the root mean squared error
+/// improves by less than tolerance (relative to its value), or for
+/// max_rounds. The vectors are stored in the property named
+/// output_property_name as fixed size lists of latent_vector_size floats;
+/// nodes without edges keep their random initial vector. The property named
+/// output_property_name is created by this function and may not exist
+/// before the call.
+KATANA_EXPORT Result<void> MatrixCompletion(
+    PropertyGraph* pg, const std::string& edge_rating_property_name,
+    const std::string& output_property_name, MatrixCompletionPlan plan = {});
+
+/// Check that the property named property_name holds a finite latent vector
+/// of the same size for every node.
+KATANA_EXPORT Result<void> MatrixCompletionAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT MatrixCompletionStatistics {
+  /// The root mean squared error of the predicted ratings.
+  double root_mean_squared_error;
+  /// The size of the latent vectors.
+  uint32_t latent_vector_size;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MatrixCompletionStatistics> Compute(
+      PropertyGraph* pg, const std::string& edge_rating_property_name,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+
+#include <iostream>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for MaxFlow, specifying the algorithm and any
+/// parameters associated with it.
+class MaxFlowPlan : public Plan {
+public:
+  /// Algorithm selectors for MaxFlow
+  enum Algorithm { kPreflowPush };
+
+  /// Select the global relabel interval from the size of the graph
+  static const uint64_t kDefaultGlobalRelabelInterval = 0;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint64_t global_relabel_interval_;
+
+  MaxFlowPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint64_t global_relabel_interval)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        global_relabel_interval_(global_relabel_interval) {}
+
+public:
+  MaxFlowPlan()
+      : MaxFlowPlan{kCPU, kPreflowPush, kDefaultGlobalRelabelInterval} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  uint64_t global_relabel_interval() const { return global_relabel_interval_; }
+
+  /// Goldberg and Tarjan's preflow push algorithm, discharging active nodes
+  /// in parallel. After every global_relabel_interval units of work (a
+  /// discharge counts 1 and a relabel 12), a global relabel starts: a
+  /// breadth-first search from the sink along the residual edges runs in the
+  /// same parallel loop as the discharges, which keep pushing flow with the
+  /// old heights. When it finishes, the heights are raised to the distances
+  /// it found, corrected where pushes made new residual edges during the
+  /// search, and the nodes above an empty height (a gap) are lifted out of
+  /// reach of the sink. The excess that cannot reach the sink is then
+  /// returned to the source the same way.
+  static MaxFlowPlan PreflowPush(
+      uint64_t global_relabel_interval = kDefaultGlobalRelabelInterval) {
+    return {kCPU, kPreflowPush, global_relabel_interval};
+  }
+};
+
+/// Compute a maximum flow from source to sink in pg. The capacities are taken
+/// from the edge property named edge_capacity_property_name (which may be a
+/// 32- or 64-bit sign or unsigned int); they may not be negative and their
+/// sum out of the source must fit in an int64_t. The flow along each edge is
+/// stored in the property named output_property_name (with the type of the
+/// capacities). The property named output_property_name is created by this
+/// function and may not exist before the call.
+KATANA_EXPORT Result<void> MaxFlow(
+    PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& edge_capacity_property_name,
+    const std::string& output_property_name, MaxFlowPlan plan = {});
+
+/// Check that the property named property_name is a flow from source to sink
+/// within the capacities, and that no path of residual capacity is left from
+/// the source to the sink.
+KATANA_EXPORT Result<void> MaxFlowAssertValid(
+    PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& edge_capacity_property_name,
+    const std::string& property_name);
+
+struct KATANA_EXPORT MaxFlowStatistics {
+  /// The flow out of the source, less the flow into it.
+  uint64_t total_flow;
+  /// The number of nodes on the source side of the minimum cut, which can be
+  /// reached from the source along edges with residual capacity.
+  uint64_t source_side_size;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MaxFlowStatistics> Compute(
+      PropertyGraph* pg, size_t source,
+      const std::string& edge_capacity_property_name,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+
+#include <iostream>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for MinimumSpanningForest, specifying the algorithm
+/// and any parameters associated with it.
+class MinimumSpanningForestPlan : public Plan {
+public:
+  /// Algorithm selectors for MinimumSpanningForest
+  enum Algorithm { kBoruvka, kFilterKruskal };
+
+  static const uint32_t kDefaultBaseCaseSize = 1 << 16;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint32_t base_case_size_;
+
+  MinimumSpanningForestPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t base_case_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        base_case_size_(base_case_size) {}
+
+public:
+  MinimumSpanningForestPlan() : MinimumSpanningForestPlan{kCPU, kBoruvka, 0} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  uint32_t base_case_size() const { return base_case_size_; }
+
+  /// Boruvka's algorithm. In each round, every component picks its lightest
+  /// edge to another component, the components are merged along these
+  /// edges in the concurrent union-find, and the edges that became internal
+  /// to a component are filtered out in parallel.
+  static MinimumSpanningForestPlan Boruvka() { return {kCPU, kBoruvka, 0}; }
+
+  /// Filter-Kruskal (Osipov, Sanders and Singler, "The filter-Kruskal
+  /// minimum spanning tree algorithm", ALENEX 2009). The edges are
+  /// partitioned around a pivot weight in parallel; the lighter part is
+  /// solved first, then the edges of the heavier part within one component
+  /// are filtered out in parallel before it is solved. Ranges of at most
+  /// base_case_size edges are sorted and scanned as in Kruskal's algorithm.
+  static MinimumSpanningForestPlan FilterKruskal(
+      uint32_t base_case_size = kDefaultBaseCaseSize) {
+    return {kCPU, kFilterKruskal, base_case_size};
+  }
+};
+
+/// Compute a minimum spanning forest of pg, taking the edges as undirected.
+/// The edge weights are taken from the property named
+/// edge_weight_property_name (which may be a 32- or 64-bit sign or unsigned
+/// int, or a float or double). Ties between equal weights are broken by edge
+/// id, so the forest does not depend on the algorithm or the number of
+/// threads. The edges in the forest are marked with 1 in the property named
+/// output_property_name (as uint8_t), and the other edges with 0; of the two
+/// directions of an edge of a symmetric graph, only one is marked.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    MinimumSpanningForestPlan plan = {});
+
+/// Check that the edges marked in the property named property_name form a
+/// spanning forest of pg, with as many trees as pg has connected components,
+/// of minimum weight.
+KATANA_EXPORT Result<void> MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name);
+
+struct KATANA_EXPORT MinimumSpanningForestStatistics {
+  /// The number of edges in the forest.
+  uint64_t number_of_edges;
+  /// The number of trees in the forest, including the single nodes.
+  uint64_t number_of_trees;
+  /// The sum of the weights of the edges in the forest.
+  double total_weight;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MinimumSpanningForestStatistics> Compute(
+      PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
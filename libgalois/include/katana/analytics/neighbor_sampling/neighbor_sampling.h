@@ -0,0 +1,172 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORSAMPLING_NEIGHBORSAMPLING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORSAMPLING_NEIGHBORSAMPLING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/NUMAArray.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for NeighborSampler, specifying the algorithm and
+/// any parameters associated with it.
+class NeighborSamplingPlan : public Plan {
+public:
+  /// Algorithm selectors for NeighborSampler
+  enum Algorithm { kUniform };
+
+  static const uint64_t kDefaultSeed = 0x9e3779b97f4a7c15;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  bool with_replacement_;
+  uint64_t seed_;
+
+  NeighborSamplingPlan(
+      Architecture architecture, Algorithm algorithm, bool with_replacement,
+      uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        with_replacement_(with_replacement),
+        seed_(seed) {}
+
+public:
+  NeighborSamplingPlan()
+      : NeighborSamplingPlan{kCPU, kUniform, false, kDefaultSeed} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Whether a neighbor may be sampled more than once
+  bool with_replacement() const { return with_replacement_; }
+  uint64_t seed() const { return seed_; }
+
+  /// Sample the fanout neighbors of each node uniformly at random, as in
+  /// GraphSAGE (Hamilton et al., "Inductive Representation Learning on
+  /// Large Graphs", NeurIPS 2017). Without replacement, a node with at most
+  /// fanout neighbors keeps all of them. The neighbors of a node are drawn
+  /// from a generator seeded by the seed, the batch, the hop and the node,
+  /// so a batch is sampled the same way whatever the number of threads.
+  static NeighborSamplingPlan Uniform(
+      bool with_replacement = false, uint64_t seed = kDefaultSeed) {
+    return {kCPU, kUniform, with_replacement, seed};
+  }
+};
+
+/// One hop of a sampled mini-batch: the sampled edges from the destination
+/// nodes to their neighbors, the source nodes, in CSR by destination. The
+/// source nodes start with the destination nodes, so the output of a GNN
+/// layer for the destinations is a prefix of its input.
+struct KATANA_EXPORT SampledBlock {
+  /// The nodes of the graph whose neighbors were sampled
+  std::vector<uint32_t> dst_nodes;
+  /// The destination nodes followed by the other sampled neighbors, each
+  /// once, in the order they were first sampled
+  std::vector<uint32_t> src_nodes;
+  /// The sampled edges of destination i are indptr[i] to indptr[i + 1]
+  std::vector<uint64_t> indptr;
+  /// The index in src_nodes of the neighbor of each sampled edge
+  std::vector<uint32_t> indices;
+  /// The id in the graph of each sampled edge
+  std::vector<uint64_t> edge_ids;
+
+  uint64_t num_edges() const { return indices.size(); }
+};
+
+/// The sampled subgraphs of a batch of seed nodes and the features of the
+/// nodes they reach.
+struct KATANA_EXPORT SampledMiniBatch {
+  /// One for each fanout: blocks[0] samples the neighbors of the seeds and
+  /// blocks[h] those of the source nodes of blocks[h - 1]
+  std::vector<SampledBlock> blocks;
+  /// The source nodes of the last block, or the seeds if there are no
+  /// fanouts: the nodes whose features are the input of a GNN
+  std::vector<uint32_t> input_nodes;
+  /// The feature properties of the input nodes, a row for each in the order
+  /// of input_nodes
+  std::shared_ptr<arrow::Table> features;
+};
+
+/// Samples GNN mini-batches from pg, layer by layer: the neighbors of each
+/// seed along its out-edges, up to fanouts[0] of them, then the neighbors of
+/// those, up to fanouts[1], and so on. Each hop is a parallel loop over the
+/// destinations, which draw their neighbors into slots laid out by a prefix
+/// sum; the new nodes are numbered in the order they were first sampled and
+/// the features of the input nodes are gathered with arrow::compute::Take.
+///
+/// Sampling a batch while the model trains on the previous one keeps the
+/// trainer busy: Prefetch starts sampling on a background thread and
+/// TakePrefetched waits for it.
+class KATANA_EXPORT NeighborSampler {
+public:
+  /// A fanout that keeps every neighbor
+  static constexpr uint32_t kAllNeighbors =
+      std::numeric_limits<uint32_t>::max();
+
+  /// \returns a sampler of pg, which must outlive it, with the given fanout
+  /// of each hop and feature_properties gathered for the input nodes
+  static Result<std::unique_ptr<NeighborSampler>> Make(
+      PropertyGraph* pg, std::vector<uint32_t> fanouts,
+      std::vector<std::string> feature_properties,
+      NeighborSamplingPlan plan = {});
+
+  ~NeighborSampler();
+
+  NeighborSampler(const NeighborSampler&) = delete;
+  NeighborSampler& operator=(const NeighborSampler&) = delete;
+  NeighborSampler(NeighborSampler&&) = delete;
+  NeighborSampler& operator=(NeighborSampler&&) = delete;
+
+  /// \returns the sampled subgraphs of distinct seeds; batch_index picks the
+  /// random choices, so the same seeds and batch_index give the same batch
+  Result<SampledMiniBatch> Sample(
+      const std::vector<uint32_t>& seeds, uint64_t batch_index);
+
+  /// Start Sample(seeds, batch_index) on a background thread, which holds a
+  /// ThreadPoolLease of the current number of active threads while it
+  /// samples, so other threads must hold a lease to run parallel loops
+  /// until TakePrefetched returns. One batch is prefetched at a time.
+  Result<void> Prefetch(std::vector<uint32_t> seeds, uint64_t batch_index);
+
+  /// Wait for the batch that Prefetch started and \returns it
+  Result<SampledMiniBatch> TakePrefetched();
+
+  bool is_prefetching() const { return prefetched_.valid(); }
+
+  const std::vector<uint32_t>& fanouts() const { return fanouts_; }
+
+private:
+  NeighborSampler(
+      PropertyGraph* pg, std::vector<uint32_t> fanouts,
+      std::vector<std::string> feature_properties, NeighborSamplingPlan plan);
+
+  Result<SampledMiniBatch> SampleBatch(
+      const std::vector<uint32_t>& seeds, uint64_t batch_index);
+  SampledBlock SampleHop(
+      const std::vector<uint32_t>& dst_nodes, uint64_t batch_index,
+      uint32_t hop);
+  Result<std::shared_ptr<arrow::Table>> GatherFeatures(
+      const std::vector<uint32_t>& nodes) const;
+
+  PropertyGraph* pg_;
+  std::vector<uint32_t> fanouts_;
+  std::vector<std::string> feature_properties_;
+  NeighborSamplingPlan plan_;
+  /// For each node, kNone, or while a hop numbers its source nodes the
+  /// first slot that sampled it and then its index among them
+  NUMAArray<std::atomic<uint64_t>> slot_;
+  std::future<Result<SampledMiniBatch>> prefetched_;
+};
+
+}  // namespace katana::analytics
+
+#endif
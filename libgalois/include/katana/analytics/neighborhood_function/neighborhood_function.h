@@ -0,0 +1,100 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORHOODFUNCTION_NEIGHBORHOODFUNCTION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORHOODFUNCTION_NEIGHBORHOODFUNCTION_H_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for EstimateNeighborhoodFunction, specifying the
+/// algorithm and any parameters associated with it.
+class NeighborhoodFunctionPlan : public Plan {
+public:
+  /// Algorithm selectors for EstimateNeighborhoodFunction
+  enum Algorithm { kHyperAnf };
+
+  static const uint32_t kDefaultLog2NumRegisters = 7;
+  static const uint32_t kDefaultMaxIterations = 1000;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint32_t log2_num_registers_;
+  uint32_t max_iterations_;
+
+  NeighborhoodFunctionPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t log2_num_registers, uint32_t max_iterations)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        log2_num_registers_(log2_num_registers),
+        max_iterations_(max_iterations) {}
+
+public:
+  NeighborhoodFunctionPlan()
+      : NeighborhoodFunctionPlan{
+            kCPU, kHyperAnf, kDefaultLog2NumRegisters,
+            kDefaultMaxIterations} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The log2 of the number of registers of the counter of each node
+  uint32_t log2_num_registers() const { return log2_num_registers_; }
+  /// The most distances the neighborhood function is estimated for
+  uint32_t max_iterations() const { return max_iterations_; }
+
+  /// Keep for each node a HyperLogLog counter of the nodes within distance t
+  /// of it, for t = 0, 1, ..., until no counter changes (Boldi et al.,
+  /// "HyperANF: Approximating the Neighbourhood Function of Very Large
+  /// Graphs on a Budget", WWW 2011). Step t pulls the counters of step t - 1
+  /// over the in-edges of each node, a register-wise maximum, and only pulls
+  /// those that changed in step t - 1. The relative standard error of each
+  /// counter is about 1.04 / sqrt(2^log2_num_registers) and each node takes
+  /// 2 * 2^log2_num_registers bytes.
+  static NeighborhoodFunctionPlan HyperAnf(
+      uint32_t log2_num_registers = kDefaultLog2NumRegisters,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kHyperAnf, log2_num_registers, max_iterations};
+  }
+};
+
+/// An estimate of the neighborhood function of a graph, the number of pairs
+/// of nodes (u, v) such that v is within distance t of u, for each t.
+struct KATANA_EXPORT NeighborhoodFunctionEstimate {
+  /// The estimated number of pairs within distance t for each t, from t = 0
+  /// (the number of nodes) to the distance at which the estimates stop
+  /// growing or the plan's max_iterations.
+  std::vector<double> neighborhood_function;
+
+  /// \returns the distance within which fraction of the pairs of connected
+  /// nodes are, interpolated linearly between distances
+  double EffectiveDiameter(double fraction = 0.9) const;
+
+  /// Print the estimate in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/// Estimate the neighborhood function of pg and, if
+/// harmonic_centrality_property_name is not empty, the harmonic centrality
+/// of each node v, the sum of 1 / d(u, v) over the nodes u other than v that
+/// reach v (see HarmonicCentrality), as the sum over t of the estimated
+/// number of nodes at distance t over t. Both take one pass over the edges
+/// per distance, far fewer than a BFS from every node.
+///
+/// The centralities are stored in the property named
+/// harmonic_centrality_property_name (as double), which is created by this
+/// function and may not exist before the call.
+KATANA_EXPORT Result<NeighborhoodFunctionEstimate>
+EstimateNeighborhoodFunction(
+    PropertyGraph* pg,
+    const std::string& harmonic_centrality_property_name = "",
+    NeighborhoodFunctionPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
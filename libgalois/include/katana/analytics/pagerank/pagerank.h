@@ -2,10 +2,15 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_PAGERANK_PAGERANK_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
+#include "katana/Cancellation.h"
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/ResultCache.h"
+#include "katana/analytics/Workspace.h"
 
 namespace katana::analytics {
 
@@ -18,6 +23,7 @@ public:
     kPullResidual,
     kPushSynchronous,
     kPushAsynchronous,
+    kPullBlocked,
   };
 
   static constexpr double kDefaultTolerance = 1.0e-3;
@@ -76,6 +82,20 @@ public:
     return {kCPU, kPullResidual, tolerance, max_iterations, alpha};
   }
 
+  /// Topological pull algorithm with propagation blocking: the in edges are
+  /// grouped by blocks of the neighbors they read so that the reads of a
+  /// block stay in the cache. Faster than PullTopological on graphs much
+  /// larger than the last level cache, at the cost of 8 bytes per edge to
+  /// hold the groups.
+  ///
+  /// The graph must be transposed to use this algorithm.
+  static PagerankPlan PullBlocked(
+      float tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha) {
+    return {kCPU, kPullBlocked, tolerance, max_iterations, alpha};
+  }
+
   /// Asynchronous push algorithm
   ///
   /// This implementation is based on the Push-based PageRank computation
@@ -103,13 +123,65 @@ public:
       float alpha = kDefaultAlpha) {
     return {kCPU, kPushSynchronous, tolerance, max_iterations, alpha};
   }
+
+  /// Topology driven algorithm on a GPU; see GpuBackend.h. Every iteration
+  /// pushes the rank of each node to its neighbors, until no rank changes
+  /// by more than tolerance.
+  static PagerankPlan Gpu(
+      float tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha) {
+    return {kGPU, kPushSynchronous, tolerance, max_iterations, alpha};
+  }
 };
 
 /// Compute the Page Rank of each node in the graph.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
+/// If cancellation is not null and is cancelled before the computation
+/// completes, it stops early and returns ErrorCode::Cancelled.
+/// If workspace is not null, the pull algorithms take their temporary arrays
+/// from it.
+/// If cache is not null, the ranks of the same version of the graph with the
+/// same plan come from it when they are there and are stored in it when not.
 KATANA_EXPORT Result<void> Pagerank(
     PropertyGraph* pg, const std::string& output_property_name,
+    PagerankPlan plan = {}, const CancellationToken* cancellation = nullptr,
+    AnalyticsWorkspace* workspace = nullptr,
+    AnalyticsResultCache* cache = nullptr);
+
+/// Update the ranks in the property named rank_property_name after edges of
+/// pg were added or removed. The ranks must have been computed with a push
+/// or residual algorithm and the same alpha, e.g., by Pagerank with
+/// kPushAsynchronous. The ranks are the starting state of the asynchronous
+/// push algorithm, which then propagates only the residuals caused by the
+/// changes; finding them takes one pass over the edges.
+/// If cancellation is not null and is cancelled before the computation
+/// completes, it stops early and returns ErrorCode::Cancelled.
+KATANA_EXPORT Result<void> PagerankUpdate(
+    PropertyGraph* pg, const std::string& rank_property_name,
+    PagerankPlan plan = {}, const CancellationToken* cancellation = nullptr);
+
+/// Compute the k nodes with the highest personalized Page Rank for the
+/// seed nodes: the probability that a random walk that starts at a seed,
+/// and returns to a seed with probability 1 - plan.alpha() at each step,
+/// is at a node. Walks at nodes without out edges return to a seed.
+///
+/// The ranks are approximated by forward push, which touches only the nodes
+/// near the seeds; the rank of a node is underestimated by at most
+/// plan.tolerance() times its out degree. The algorithm of plan is not used.
+///
+/// \returns (node, rank) pairs by decreasing rank
+KATANA_EXPORT Result<std::vector<std::pair<uint32_t, double>>>
+PersonalizedPagerank(
+    const PropertyGraph* pg, const std::vector<uint32_t>& seeds, size_t k,
+    PagerankPlan plan = {});
+
+/// Compute PersonalizedPagerank for each of seed_sets, in parallel
+KATANA_EXPORT Result<std::vector<std::vector<std::pair<uint32_t, double>>>>
+PersonalizedPagerankBatch(
+    const PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets, size_t k,
     PagerankPlan plan = {});
 
 KATANA_EXPORT Result<void> PagerankAssertValid(
@@ -0,0 +1,154 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_PARTITION_PARTITION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_PARTITION_PARTITION_H_
+
+#include <iostream>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for Partition, specifying the algorithm and any
+/// parameters associated with it.
+class PartitionPlan : public Plan {
+public:
+  /// Algorithm selectors for Partition
+  enum Algorithm { kMultilevel };
+
+  static const uint32_t kDefaultCoarsestNodesPerPartition = 20;
+  static constexpr double kDefaultMaxImbalance = 0.03;
+  static const uint32_t kDefaultRefinementRounds = 8;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint32_t coarsest_nodes_per_partition_;
+  double max_imbalance_;
+  uint32_t refinement_rounds_;
+
+  PartitionPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t coarsest_nodes_per_partition, double max_imbalance,
+      uint32_t refinement_rounds)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        coarsest_nodes_per_partition_(coarsest_nodes_per_partition),
+        max_imbalance_(max_imbalance),
+        refinement_rounds_(refinement_rounds) {}
+
+public:
+  PartitionPlan()
+      : PartitionPlan{
+            kCPU, kMultilevel, kDefaultCoarsestNodesPerPartition,
+            kDefaultMaxImbalance, kDefaultRefinementRounds} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  uint32_t coarsest_nodes_per_partition() const {
+    return coarsest_nodes_per_partition_;
+  }
+  double max_imbalance() const { return max_imbalance_; }
+  uint32_t refinement_rounds() const { return refinement_rounds_; }
+
+  /// Multilevel k-way partitioning, as in METIS. The graph, taken as
+  /// undirected, is coarsened by parallel heavy edge matching until it has
+  /// about coarsest_nodes_per_partition nodes per partition, the coarsest
+  /// graph is partitioned by greedy graph growing, and the partition is
+  /// projected back level by level, improving it at each level with up to
+  /// refinement_rounds rounds of parallel label propagation. A node moves to
+  /// the partition it has the most edges to, as long as that partition stays
+  /// within (1 + max_imbalance) times the average partition size, and nodes
+  /// in partitions above that size move even if the edge cut grows.
+  static PartitionPlan Multilevel(
+      uint32_t coarsest_nodes_per_partition = kDefaultCoarsestNodesPerPartition,
+      double max_imbalance = kDefaultMaxImbalance,
+      uint32_t refinement_rounds = kDefaultRefinementRounds) {
+    return {
+        kCPU, kMultilevel, coarsest_nodes_per_partition, max_imbalance,
+        refinement_rounds};
+  }
+};
+
+/// Partition the nodes of pg into num_partitions parts of about the same
+/// number of nodes, with few edges between nodes of different parts. The
+/// partition of each node (a uint32_t less than num_partitions) is stored in
+/// the property named output_property_name. The property named
+/// output_property_name is created by this function and may not exist before
+/// the call.
+KATANA_EXPORT Result<void> Partition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, PartitionPlan plan = {});
+
+/// Partition the nodes of a hypergraph stored in pg into num_partitions parts
+/// of about the same number of nodes, with few hyperedges spanning several
+/// parts. The first num_hyperedges nodes of pg are the hyperedges, with an
+/// edge to each of their pins among the other nodes, as in the bipart app;
+/// edges out of the other nodes are ignored, so the hypergraph may also be
+/// stored with edges both ways.
+///
+/// The plan is followed as in Partition, with the hypergraph kept as such
+/// at every level: coarsening rates a pair of nodes by the sum of
+/// 1 / (|h| - 1) over the hyperedges h they share, the coarsest level is
+/// grown on its clique expansion, and refinement moves a node to the
+/// partition that most reduces the connectivity, the sum over hyperedges of
+/// the number of parts they have pins in, less 1. Unlike recursive
+/// bisection, all num_partitions parts come out of a single hierarchy.
+///
+/// The partition of each node is stored in the property named
+/// output_property_name, which may not exist before the call; a hyperedge
+/// gets the partition that most of its pins are in.
+KATANA_EXPORT Result<void> PartitionHypergraph(
+    PropertyGraph* pg, uint64_t num_hyperedges, uint32_t num_partitions,
+    const std::string& output_property_name, PartitionPlan plan = {});
+
+/// Check that the property named property_name assigns every node a
+/// partition less than num_partitions.
+KATANA_EXPORT Result<void> PartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name);
+
+struct KATANA_EXPORT PartitionStatistics {
+  /// The number of edges between nodes of different partitions.
+  uint64_t edge_cut;
+  /// The number of nodes in the largest partition.
+  uint64_t max_partition_size;
+  /// The number of nodes in the smallest partition.
+  uint64_t min_partition_size;
+  /// The size of the largest partition over the average partition size,
+  /// less 1.
+  double imbalance;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<PartitionStatistics> Compute(
+      PropertyGraph* pg, uint32_t num_partitions,
+      const std::string& property_name);
+};
+
+struct KATANA_EXPORT HypergraphPartitionStatistics {
+  /// The number of hyperedges with pins in more than one partition.
+  uint64_t cut_hyperedges;
+  /// The sum over hyperedges of the number of partitions they have pins in,
+  /// less 1.
+  uint64_t connectivity;
+  /// The number of nodes, not counting hyperedges, in the largest partition.
+  uint64_t max_partition_size;
+  /// The number of nodes, not counting hyperedges, in the smallest
+  /// partition.
+  uint64_t min_partition_size;
+  /// The size of the largest partition over the average partition size,
+  /// less 1.
+  double imbalance;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<HypergraphPartitionStatistics> Compute(
+      PropertyGraph* pg, uint64_t num_hyperedges, uint32_t num_partitions,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_POINTTOPOINT_POINTTOPOINT_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_POINTTOPOINT_POINTTOPOINT_H_
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+
+namespace katana::analytics {
+
+/// Answers queries for the distance between two nodes of a graph without
+/// computing the distances from the source to every node. A query searches
+/// both from the source along out-edges and from the target along in-edges
+/// and stops once the two searches meet: with BFS if the graph has no edge
+/// weights and with Dijkstra's algorithm otherwise.
+///
+/// A query runs on the calling thread and reuses the search state of that
+/// thread from earlier queries, so a thread allocates O(num_nodes) memory
+/// the first time it answers a query and not afterwards. Queries may run
+/// concurrently from the threads of a parallel loop, e.g., Distances, and
+/// from one thread outside of the thread pool.
+///
+/// The graph must outlive the query object and its topology and edge weights
+/// may not change while it is used.
+class KATANA_EXPORT PointToPointQuery {
+public:
+  /// The distance between nodes that are not connected
+  static constexpr double kUnreachable =
+      std::numeric_limits<double>::infinity();
+
+  /// Prepare to answer queries on pg. If edge_weight_property_name is empty,
+  /// the distance is the number of edges on a shortest path. Otherwise, it is
+  /// the sum of the weights from the property named edge_weight_property_name
+  /// (which may be a 32- or 64-bit sign or unsigned int, a float or a double)
+  /// along a shortest path; weights may not be negative.
+  static Result<std::unique_ptr<PointToPointQuery>> Make(
+      PropertyGraph* pg, const std::string& edge_weight_property_name = "");
+
+  ~PointToPointQuery();
+
+  PointToPointQuery(const PointToPointQuery&) = delete;
+  PointToPointQuery& operator=(const PointToPointQuery&) = delete;
+  PointToPointQuery(PointToPointQuery&&) = delete;
+  PointToPointQuery& operator=(PointToPointQuery&&) = delete;
+
+  /// \returns the distance from source to target or kUnreachable
+  Result<double> Distance(uint32_t source, uint32_t target) const;
+
+  /// Answer queries, each a pair of source and target, in parallel and store
+  /// the distance of queries[i] in (*distances)[i]
+  Result<void> Distances(
+      const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+      std::vector<double>* distances) const;
+
+private:
+  struct Impl;
+
+  explicit PointToPointQuery(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -1,7 +1,9 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 
+#include <functional>
 #include <iostream>
+#include <vector>
 
 #include <katana/analytics/Plan.h>
 
@@ -137,9 +139,36 @@ public:
 /// parameters can be specified, but have reasonable defaults. Not all
 /// parameters are used by the algorithms. The generated random-walks generated
 /// are returned as a vector of vectors.
+///
+/// The second-order transitions are sampled in constant time from alias
+/// tables over the edges of each edge's destination if those tables are not
+/// too large, and by rejection otherwise.
 KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
     PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
 
+/// Walks stored back to back: walk i is nodes[offsets[i], offsets[i + 1])
+struct RandomWalksBatch {
+  std::vector<uint32_t> nodes;
+  std::vector<uint64_t> offsets{0};
+
+  uint64_t num_walks() const { return offsets.size() - 1; }
+};
+
+using RandomWalksCallback =
+    std::function<Result<void>(const RandomWalksBatch&)>;
+
+constexpr uint64_t kDefaultRandomWalksBatchSize = uint64_t{1} << 16;
+
+/// Compute the random-walks for pg like RandomWalks, but hand them to
+/// callback in batches of at most batch_size walks as they are generated
+/// rather than returning them all, so that the walks need not fit in memory.
+/// The batch is reused once callback returns. An error of callback stops the
+/// walks and is returned.
+KATANA_EXPORT Result<void> RandomWalksInBatches(
+    PropertyGraph* pg, const RandomWalksCallback& callback,
+    RandomWalksPlan plan = RandomWalksPlan(),
+    uint64_t batch_size = kDefaultRandomWalksBatchSize);
+
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
 }  // namespace katana::analytics
@@ -2,10 +2,17 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_SSSP_SSSP_H_
 
 #include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/Cancellation.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
+#include "katana/analytics/Workspace.h"
 
 namespace katana::analytics {
 
@@ -19,6 +26,8 @@ public:
     kDeltaStep,
     kDeltaStepBarrier,
     kDeltaStepFusion,
+    kDeltaStepAdaptive,
+    kDeltaStepAutoDelta,
     // TODO(gill): Do we want to expose serial implementations at all?
     kSerialDeltaTile,
     kSerialDelta,
@@ -53,15 +62,17 @@ private:
         edge_tile_size_(edge_tile_size) {}
 
 public:
+  /// The automatic plan: the algorithm and delta are chosen from the
+  /// statistics of the graph and its weights when the SSSP runs; see
+  /// ChooseSsspPlan in Planner.h
   SsspPlan() : SsspPlan{kCPU, kAutomatic, 0, 0} {}
 
-  SsspPlan(const katana::PropertyGraph* pg) : Plan(kCPU) {
-    bool isPowerLaw = IsApproximateDegreeDistributionPowerLaw(*pg);
-    if (isPowerLaw) {
-      *this = DeltaStep();
-    } else {
-      *this = DeltaStepBarrier();
-    }
+  /// A plan for any graph. Delta stepping with an adaptive delta performs well
+  /// on both power law graphs and high diameter graphs like road networks
+  /// once the initial delta is close to the right one, which depends on the
+  /// edge weights rather than the shape of the graph.
+  SsspPlan(const katana::PropertyGraph*) : Plan(kCPU) {
+    *this = DeltaStepAutoDelta();
   }
 
   Algorithm algorithm() const { return algorithm_; }
@@ -88,6 +99,21 @@ public:
     return {kCPU, kDeltaStepFusion, delta, 0};
   }
 
+  /// Delta stepping where the delta starts at \param initial_delta and is
+  /// then adapted to the work found in each bucket; see
+  /// katana::AdaptiveOrderedByIntegerMetric
+  static SsspPlan DeltaStepAdaptive(unsigned initial_delta = kDefaultDelta) {
+    return {kCPU, kDeltaStepAdaptive, initial_delta, 0};
+  }
+
+  /// Adaptive delta stepping whose initial delta is chosen from the edge
+  /// weights: the largest weight divided by the average degree (Meyer and
+  /// Sanders), but no less than the mean weight, rounded down to a power of
+  /// two
+  static SsspPlan DeltaStepAutoDelta() {
+    return {kCPU, kDeltaStepAutoDelta, 0, 0};
+  }
+
   static SsspPlan SerialDeltaTile(
       unsigned delta = kDefaultDelta,
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
@@ -111,6 +137,12 @@ public:
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
     return {kCPU, kTopologicalTile, 0, edge_tile_size};
   }
+
+  /// Near-far delta stepping on a GPU with buckets of 2^delta; see
+  /// GpuBackend.h. Only Sssp runs it on the GPU.
+  static SsspPlan Gpu(unsigned delta = kDefaultDelta) {
+    return {kGPU, kDeltaStep, delta, 0};
+  }
 };
 
 /// Compute the Single-Source Shortest Path for pg starting from start_node.
@@ -121,10 +153,46 @@ public:
 /// parameter can be specified, but have reasonable defaults.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
+/// If cancellation is not null and is cancelled before the computation
+/// completes, it stops early and returns ErrorCode::Cancelled.
+/// If workspace is not null, the computation takes its temporary arrays from
+/// it.
 KATANA_EXPORT Result<void> Sssp(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
-    const std::string& output_property_name, SsspPlan plan = {});
+    const std::string& output_property_name, SsspPlan plan = {},
+    const CancellationToken* cancellation = nullptr,
+    AnalyticsWorkspace* workspace = nullptr);
+
+/// Compute the path lengths from each of sources, as Sssp does, in one call.
+/// The graph view and the output property are built once and the temporary
+/// arrays of the computations are reused, so many small queries do not pay
+/// for them on each query; pg is left unchanged.
+/// @return a table with a column of the path lengths from each of sources,
+///     in order, named by the source; the columns have the type of the edge
+///     weights
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> SsspBatch(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name, SsspPlan plan = {},
+    const CancellationToken* cancellation = nullptr,
+    AnalyticsWorkspace* workspace = nullptr);
+
+/// Update the path lengths in the property named distance_property_name,
+/// computed by Sssp, after edges were added to pg or the weights of edges
+/// decreased. changed_edges holds the (source, destination) nodes of those
+/// edges. Only the nodes whose path length decreases are visited, so the
+/// cost is proportional to the change rather than to the graph.
+/// The repair runs adaptive delta stepping starting from plan.delta(), or
+/// from the default delta if the plan has none.
+/// Removed edges and weight increases need a full Sssp.
+/// If cancellation is not null and is cancelled before the computation
+/// completes, it stops early and returns ErrorCode::Cancelled; the path
+/// lengths are then upper bounds of the correct ones.
+KATANA_EXPORT Result<void> SsspRepair(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& distance_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& changed_edges,
+    SsspPlan plan = {}, const CancellationToken* cancellation = nullptr);
 
 KATANA_EXPORT Result<void> SsspAssertValid(
     PropertyGraph* pg, size_t start_node,
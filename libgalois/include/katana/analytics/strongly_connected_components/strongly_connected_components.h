@@ -0,0 +1,116 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+
+#include <iostream>
+#include <string>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for StronglyConnectedComponents, specifying the
+/// algorithm and any parameters associated with it.
+///
+/// The parallel algorithms first trim the nodes without an in-edge or an
+/// out-edge from the other remaining nodes, which are components of their
+/// own, and finish with Tarjan's algorithm once at most serial_threshold
+/// nodes are left, where the rounds of the parallel searches cost more than
+/// they save.
+class StronglyConnectedComponentsPlan : public Plan {
+public:
+  /// Algorithm selectors for StronglyConnectedComponents
+  enum Algorithm { kMultistep, kColoring, kSerial };
+
+  static const uint32_t kDefaultSerialThreshold = 100000;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint32_t serial_threshold_;
+
+  StronglyConnectedComponentsPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t serial_threshold)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        serial_threshold_(serial_threshold) {}
+
+public:
+  StronglyConnectedComponentsPlan()
+      : StronglyConnectedComponentsPlan{
+            kCPU, kMultistep, kDefaultSerialThreshold} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of remaining nodes below which Tarjan's algorithm finishes
+  uint32_t serial_threshold() const { return serial_threshold_; }
+
+  /// Multistep (Slota, Rajamanickam and Madduri, "BFS and Coloring-based
+  /// Parallel Algorithms for Strongly Connected Components and Related
+  /// Problems", IPDPS 2014): after trimming, a forward and a backward search
+  /// from the node with the largest product of in- and out-degree find the
+  /// giant component of web and social graphs in two direction optimizing
+  /// searches; coloring then finds the many small components left.
+  static StronglyConnectedComponentsPlan Multistep(
+      uint32_t serial_threshold = kDefaultSerialThreshold) {
+    return {kCPU, kMultistep, serial_threshold};
+  }
+
+  /// Coloring (Orzan, "On Distributed Verification and Verified
+  /// Distribution", 2004) without the forward-backward search: every round,
+  /// the largest node id that reaches each remaining node is propagated
+  /// forward, and the nodes whose own id is the largest start backward
+  /// searches over the nodes of their color, each of which is a component.
+  /// Better than Multistep on graphs without a giant component.
+  static StronglyConnectedComponentsPlan Coloring(
+      uint32_t serial_threshold = kDefaultSerialThreshold) {
+    return {kCPU, kColoring, serial_threshold};
+  }
+
+  /// Tarjan's algorithm
+  static StronglyConnectedComponentsPlan Serial() {
+    return {kCPU, kSerial, 0};
+  }
+};
+
+/// Compute the strongly connected components of pg, the maximal sets of nodes
+/// that all reach each other along the edges. The component of a node is the
+/// smallest node of its component, so every plan gives the same result.
+/// The in-edges are taken from the bidirectional view of pg, which is built if
+/// pg does not have it yet.
+/// The property named output_property_name (as uint64) is created by this
+/// function and may not exist before the call.
+KATANA_EXPORT Result<void> StronglyConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    StronglyConnectedComponentsPlan plan = {});
+
+/// Check that the components in property_name are the strongly connected
+/// components of pg: each is labeled with its smallest node, every node of a
+/// component reaches and is reached by the others within the component, and
+/// the graph of the edges between components has no cycle.
+/// @return a failure if the components do not pass validation or if there is
+///     a failure during checking.
+KATANA_EXPORT Result<void> StronglyConnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT StronglyConnectedComponentsStatistics {
+  /// Total number of strongly connected components in the graph.
+  uint64_t total_components;
+  /// Total number of components with more than 1 node.
+  uint64_t total_non_trivial_components;
+  /// The number of nodes present in the largest component.
+  uint64_t largest_component_size;
+  /// The ratio of nodes present in the largest component.
+  double largest_component_ratio;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<StronglyConnectedComponentsStatistics> Compute(
+      PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -1,6 +1,10 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 
+#include <string>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Plan.h"
 
@@ -42,6 +46,58 @@ public:
   static SubGraphExtractionPlan NodeSet() { return {kCPU, kNodeSet}; }
 };
 
+/// The nodes and edges of a sub-graph of a graph, as ids in that graph. This
+/// is a view of the sub-graph: properties are read from the original graph
+/// through the ids, and nothing else is materialized.
+struct KATANA_EXPORT SubGraphSelection {
+  /// Node i of the sub-graph is nodes[i] of the graph.
+  std::vector<katana::PropertyGraph::Node> nodes;
+  /// The edges of node i of the sub-graph are at positions edge_offsets[i]
+  /// up to edge_offsets[i + 1] of edges and edge_dests.
+  std::vector<uint64_t> edge_offsets;
+  /// The ids in the graph of the edges of the sub-graph.
+  std::vector<katana::PropertyGraph::Edge> edges;
+  /// The destinations of the edges of the sub-graph, as sub-graph node ids.
+  std::vector<katana::PropertyGraph::Node> edge_dests;
+
+  uint64_t num_nodes() const { return nodes.size(); }
+  uint64_t num_edges() const { return edges.size(); }
+};
+
+/**
+ * Select the sub-graph of the original graph induced by a set of nodes,
+ * without constructing a graph.
+ *
+ * Node i of the sub-graph is the i-th distinct node of node_vec. The edges
+ * of each node are found in parallel, by binary search of the smaller of
+ * its edges and the node set in the larger, counted, and laid out by a
+ * prefix sum; they are ordered by destination in the sub-graph.
+ *
+ * @param pg The graph to process.
+ * @param node_vec Set of node IDs
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<SubGraphSelection> SubGraphSelect(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& node_vec,
+    SubGraphExtractionPlan plan = {});
+
+/**
+ * Select the sub-graph of the original graph induced by the nodes set in a
+ * selection, e.g., by SelectNodes, as SubGraphSelect does for a set of node
+ * IDs. Node i of the sub-graph is the i-th node set in nodes.
+ *
+ * @param pg The graph to process.
+ * @param nodes Selection with a bit for every node of pg
+ * @param edges Selection with a bit for every edge of pg, e.g., by
+ *    SelectEdges; only the selected edges are in the sub-graph. If null,
+ *    every edge between selected nodes is.
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<SubGraphSelection> SubGraphSelect(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& nodes,
+    const katana::DynamicBitset* edges, SubGraphExtractionPlan plan = {});
+
 /**
  * Construct a new sub-graph from the original graph.
  *
@@ -57,7 +113,47 @@ SubGraphExtraction(
     katana::PropertyGraph* pg,
     const std::vector<katana::PropertyGraph::Node>& node_vec,
     SubGraphExtractionPlan plan = {});
-// const std::vector<std::string>& node_properties_to_copy, const std::vector<std::string>& edge_properties_to_copy);
+
+/**
+ * Construct a new sub-graph from the original graph, as SubGraphSelect
+ * selects it, with the named node and edge properties of the original
+ * graph. The rows of the properties for the sub-graph are gathered with
+ * arrow::compute::Take.
+ *
+ * @param pg The graph to process.
+ * @param node_vec Set of node IDs
+ * @param node_properties Names of the node properties to project
+ * @param edge_properties Names of the edge properties to project
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtraction(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& node_vec,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties,
+    SubGraphExtractionPlan plan = {});
+
+/**
+ * Construct a new sub-graph from the original graph, as the SubGraphSelect
+ * of node and edge selections selects it, with the named node and edge
+ * properties of the original graph. Analytics filtered by properties run on
+ * this sub-graph.
+ *
+ * @param pg The graph to process.
+ * @param nodes Selection with a bit for every node of pg
+ * @param edges Selection with a bit for every edge of pg, or null
+ * @param node_properties Names of the node properties to project
+ * @param edge_properties Names of the edge properties to project
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtraction(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& nodes,
+    const katana::DynamicBitset* edges,
+    const std::vector<std::string>& node_properties = {},
+    const std::vector<std::string>& edge_properties = {},
+    SubGraphExtractionPlan plan = {});
 
 }  // namespace katana::analytics
 
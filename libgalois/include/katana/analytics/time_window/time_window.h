@@ -0,0 +1,81 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_TIMEWINDOW_TIMEWINDOW_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_TIMEWINDOW_TIMEWINDOW_H_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/TemporalTopology.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+namespace katana::analytics {
+
+/// BFS, connected components and PageRank of the subgraph of the edges of a
+/// property graph whose times are in a window, e.g., an hour of a year of
+/// timestamped events. The edges are sorted by time within each node once,
+/// by TemporalTopology, and each window is a TimeWindowTopology over them,
+/// so choosing a window copies no edges.
+///
+/// Sliding windows reuse work: moving the window forward moves the ends of
+/// the edge range of each node from where they were, connected components
+/// of a window that contains the last one merge only the edges added to it,
+/// and PageRank starts from the ranks of the last window, which are close
+/// to those of the next when windows overlap.
+class KATANA_EXPORT TimeWindowedGraph {
+public:
+  /// The distance of nodes that BFS does not reach
+  static constexpr uint32_t kUnreachable =
+      std::numeric_limits<uint32_t>::max();
+
+  /// \returns the windowed graph of pg, which must outlive it and not
+  /// change, with the times of the integer, timestamp or date edge property
+  /// timestamp_property_name. The window starts as all times.
+  static Result<std::unique_ptr<TimeWindowedGraph>> Make(
+      const PropertyGraph* pg, const std::string& timestamp_property_name);
+
+  ~TimeWindowedGraph();
+  TimeWindowedGraph(const TimeWindowedGraph&) = delete;
+  TimeWindowedGraph& operator=(const TimeWindowedGraph&) = delete;
+
+  /// Keep only the edges with times in window
+  Result<void> SetWindow(const TimeWindow& window);
+
+  const TimeWindow& window() const;
+
+  uint64_t num_nodes() const;
+  /// The number of edges in the window
+  uint64_t num_edges() const;
+
+  /// The least and greatest times of the edges, see TemporalTopology
+  int64_t min_time() const;
+  int64_t max_time() const;
+
+  /// \returns the number of edges on a shortest path in the window from
+  /// source to each node, or kUnreachable
+  Result<std::vector<uint32_t>> Bfs(uint32_t source);
+
+  /// \returns the weakly connected component of each node in the window,
+  /// named by its smallest node
+  std::vector<uint32_t> ConnectedComponents();
+
+  /// \returns the PageRank of each node in the window, computed by pulling
+  /// like PagerankPlan::PullTopological with the tolerance, maximum
+  /// iterations and alpha of plan, whose algorithm is not used. The ranks of
+  /// the previous call are the starting point.
+  std::vector<double> Pagerank(PagerankPlan plan = {});
+
+private:
+  struct Impl;
+
+  explicit TimeWindowedGraph(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -1,6 +1,10 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNT_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNT_H_
 
+#include <cstddef>
+#include <functional>
+#include <string>
+
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Plan.h"
 
@@ -20,6 +24,8 @@ public:
   enum Relabeling {
     kRelabel,
     kNoRelabel,
+    /// Relabel if the graph looks like a power law; see ChooseRelabeling in
+    /// Planner.h
     kAutoRelabel,
   };
 
@@ -104,6 +110,52 @@ public:
 KATANA_EXPORT katana::Result<uint64_t> TriangleCount(
     PropertyGraph* pg, TriangleCountPlan plan = {});
 
+/// A triangle of nodes a > b > c, with the edges ab from a to b, ac from a to
+/// c and bc from b to c (edge ids of the graph, which index its edge
+/// properties). The edges in the other directions are not looked up.
+struct Triangle {
+  GraphTopology::Node a;
+  GraphTopology::Node b;
+  GraphTopology::Node c;
+  GraphTopology::Edge ab;
+  GraphTopology::Edge ac;
+  GraphTopology::Edge bc;
+};
+
+/// The largest number of triangles passed to a TriangleBatchFn at a time
+constexpr size_t kTriangleBatchSize = 1024;
+
+/// Consumes a batch of size triangles. It is called from all threads at
+/// once, each with the triangles it found, so it must be thread safe.
+using TriangleBatchFn =
+    std::function<void(const Triangle* triangles, size_t size)>;
+
+/// Pass every triangle of pg, once, to fn in batches of at most
+/// kTriangleBatchSize, so that many consumers share one enumeration: each
+/// thread collects the triangles it finds in a buffer of its own and calls fn
+/// when it is full. pg must be symmetric; self loops are in no triangle.
+///
+/// Triangles are enumerated as the ordered count of TriangleCount does, on a
+/// view of pg with edges sorted by destination.
+///
+/// @return the number of triangles
+KATANA_EXPORT katana::Result<uint64_t> EnumerateTriangles(
+    PropertyGraph* pg, const TriangleBatchFn& fn);
+
+/// Count, in one enumeration of the triangles of pg, the triangles on every
+/// node and on every edge (the support of the edge in KTruss). pg must be
+/// symmetric, without parallel edges; both directions of an edge get its
+/// count and self loops get 0.
+///
+/// The counts are stored (as uint64) in the node property named
+/// node_output_property_name and the edge property named
+/// edge_output_property_name, either of which is skipped if its name is
+/// empty. They are created by this function and may not exist before the
+/// call.
+KATANA_EXPORT katana::Result<void> LocalTriangleCount(
+    PropertyGraph* pg, const std::string& node_output_property_name,
+    const std::string& edge_output_property_name);
+
 }  // namespace katana::analytics
 
 #endif
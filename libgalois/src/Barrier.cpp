@@ -43,9 +43,10 @@ katana::internal::SetBarrier(katana::Barrier* barrier) {
 
 katana::Barrier&
 katana::GetBarrier(unsigned active_threads) {
+  // GetThreadPool starts a lazily started SharedMem, which sets the barrier
+  unsigned max_threads = GetThreadPool().getMaxUsableThreads();
   KATANA_LOG_VASSERT(kBarrier, "Barrier not initialized");
-  active_threads =
-      std::min(active_threads, GetThreadPool().getMaxUsableThreads());
+  active_threads = std::min(active_threads, max_threads);
   active_threads = std::max(active_threads, 1U);
 
   if (active_threads != kBarrierThreads) {
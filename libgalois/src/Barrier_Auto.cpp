@@ -0,0 +1,104 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <string>
+
+#include "katana/Barrier.h"
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+/// Delegates to the barrier expected to be the fastest for the number of
+/// threads it is initialized with:
+///
+/// - a centralized counting barrier for a few threads, where one shared
+///   cache line is cheaper than several rounds of signals;
+/// - a dissemination barrier when the threads share one socket, where its
+///   log(n) rounds of pairwise signals avoid a central hot spot;
+/// - the topology-aware barrier when the threads span sockets, which keeps
+///   most signals within a socket.
+///
+/// Setting KATANA_BARRIER to counting, dissemination, mcs or topo forces a
+/// barrier instead.
+class AutoBarrier : public katana::Barrier {
+  static constexpr unsigned kMaxCountingThreads = 8;
+
+  std::unique_ptr<katana::Barrier> counting_;
+  std::unique_ptr<katana::Barrier> dissemination_;
+  std::unique_ptr<katana::Barrier> topo_;
+  std::unique_ptr<katana::Barrier> forced_;
+  katana::Barrier* current_{nullptr};
+
+  katana::Barrier* Choose(unsigned active_threads) const {
+    if (forced_) {
+      return forced_.get();
+    }
+    if (active_threads <= kMaxCountingThreads) {
+      return counting_.get();
+    }
+    unsigned sockets =
+        katana::GetThreadPool().getCumulativeMaxSocket(active_threads - 1) + 1;
+    if (sockets == 1) {
+      return dissemination_.get();
+    }
+    return topo_.get();
+  }
+
+public:
+  AutoBarrier(unsigned active_threads) {
+    std::string forced;
+    if (katana::GetEnv("KATANA_BARRIER", &forced)) {
+      if (forced == "counting") {
+        forced_ = katana::CreateCountingBarrier(active_threads);
+      } else if (forced == "dissemination") {
+        forced_ = katana::CreateDisseminationBarrier(active_threads);
+      } else if (forced == "mcs") {
+        forced_ = katana::CreateMCSBarrier(active_threads);
+      } else if (forced == "topo") {
+        forced_ = katana::CreateTopoBarrier(active_threads);
+      } else {
+        KATANA_LOG_WARN("unknown KATANA_BARRIER: {}", forced);
+      }
+    }
+    if (!forced_) {
+      counting_ = katana::CreateCountingBarrier(active_threads);
+      dissemination_ = katana::CreateDisseminationBarrier(active_threads);
+      topo_ = katana::CreateTopoBarrier(active_threads);
+    }
+    Reinit(active_threads);
+  }
+
+  void Reinit(unsigned val) override {
+    current_ = Choose(val);
+    current_->Reinit(val);
+  }
+
+  void Wait() override { current_->Wait(); }
+
+  const char* name() const override { return current_->name(); }
+};
+
+}  // namespace
+
+std::unique_ptr<katana::Barrier>
+katana::CreateAutoBarrier(unsigned active_threads) {
+  return std::make_unique<AutoBarrier>(active_threads);
+}
@@ -0,0 +1,245 @@
+#include "katana/DeltaTopology.h"
+
+#include <numeric>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+using Edge = katana::GraphTopologyTypes::Edge;
+
+/// Build a CSR from \param base where the edges of each node are the
+/// surviving base edges followed by the appended ones. \param get_delta
+/// returns the updates of a node or null, and \param for_each_node runs a
+/// function for every node, serially or in parallel.
+template <typename GetDelta, typename ForEachNode>
+katana::GraphTopology
+BuildTopology(
+    const katana::GraphTopology& base, bool parallel, GetDelta get_delta,
+    ForEachNode for_each_node) {
+  uint64_t num_nodes = base.num_nodes();
+
+  katana::NUMAArray<Edge> adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  for_each_node([&](Node n) {
+    uint64_t degree = base.degree(n);
+    if (const auto* delta = get_delta(n)) {
+      degree += delta->added.size();
+      degree -= delta->removed.size();
+    }
+    adj_indices[n] = degree;
+  });
+  if (parallel) {
+    katana::ParallelSTL::partial_sum(
+        adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+  } else {
+    std::partial_sum(
+        adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+  }
+
+  katana::NUMAArray<Node> dests;
+  dests.allocateInterleaved(num_nodes > 0 ? adj_indices[num_nodes - 1] : 0);
+  for_each_node([&](Node n) {
+    Edge out = n > 0 ? adj_indices[n - 1] : 0;
+    const auto* delta = get_delta(n);
+    for (auto e : base.edges(n)) {
+      if (!delta || !delta->IsRemoved(e)) {
+        dests[out++] = base.edge_dest(e);
+      }
+    }
+    if (delta) {
+      for (Node dst : delta->added) {
+        dests[out++] = dst;
+      }
+    }
+    KATANA_LOG_DEBUG_ASSERT(out == adj_indices[n]);
+  });
+
+  katana::GraphTopology merged(std::move(adj_indices), std::move(dests));
+  if (base.is_compact()) {
+    merged.Compact();
+  }
+  return merged;
+}
+
+}  // namespace
+
+katana::DeltaTopology::DeltaTopology(
+    std::shared_ptr<const GraphTopology> base) noexcept
+    : base_(std::move(base)),
+      deltas_(base_->num_nodes()),
+      lock_stripes_(kNumLockStripes) {}
+
+katana::DeltaTopology::~DeltaTopology() {
+  if (compaction_.valid()) {
+    compaction_.wait();
+  }
+}
+
+katana::DeltaTopology::NodeDelta*
+katana::DeltaTopology::GetOrMakeDelta(Node node) noexcept {
+  std::unique_ptr<NodeDelta>& delta = deltas_[node];
+  if (!delta) {
+    delta = std::make_unique<NodeDelta>();
+    std::lock_guard<std::mutex> lock(touched_mutex_);
+    touched_.emplace_back(node);
+  }
+  return delta.get();
+}
+
+void
+katana::DeltaTopology::AddEdgeLocked(Node src, Node dst) noexcept {
+  GetOrMakeDelta(src)->added.emplace_back(dst);
+  ++num_added_;
+}
+
+bool
+katana::DeltaTopology::RemoveEdgeLocked(Node src, Node dst) noexcept {
+  NodeDelta* delta = deltas_[src].get();
+  if (delta) {
+    auto it = std::find(delta->added.rbegin(), delta->added.rend(), dst);
+    if (it != delta->added.rend()) {
+      delta->added.erase(std::next(it).base());
+      --num_added_;
+      return true;
+    }
+  }
+
+  for (auto e : base_->edges(src)) {
+    if (base_->edge_dest(e) == dst && (!delta || !delta->IsRemoved(e))) {
+      GetOrMakeDelta(src)->removed.emplace_back(e);
+      ++num_removed_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+katana::DeltaTopology::LogUpdate(bool is_add, Node src, Node dst) noexcept {
+  std::lock_guard<std::mutex> lock(log_mutex_);
+  log_.emplace_back(LoggedUpdate{is_add, src, dst});
+}
+
+void
+katana::DeltaTopology::AddEdge(Node src, Node dst) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(src < num_nodes() && dst < num_nodes());
+  std::shared_lock<std::shared_mutex> seal_lock(seal_mutex_);
+  std::lock_guard<std::mutex> lock(LockFor(src));
+  AddEdgeLocked(src, dst);
+  if (compacting_) {
+    LogUpdate(true, src, dst);
+  }
+}
+
+bool
+katana::DeltaTopology::RemoveEdge(Node src, Node dst) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(src < num_nodes());
+  std::shared_lock<std::shared_mutex> seal_lock(seal_mutex_);
+  std::lock_guard<std::mutex> lock(LockFor(src));
+  bool removed = RemoveEdgeLocked(src, dst);
+  if (removed && compacting_) {
+    LogUpdate(false, src, dst);
+  }
+  return removed;
+}
+
+katana::GraphTopology
+katana::DeltaTopology::Merge() const noexcept {
+  return BuildTopology(
+      *base_, true, [&](Node n) { return deltas_[n].get(); },
+      [&](const auto& fn) {
+        katana::do_all(
+            katana::iterate(Node{0}, static_cast<Node>(num_nodes())), fn,
+            katana::steal(), katana::no_stats());
+      });
+}
+
+katana::GraphTopology
+katana::DeltaTopology::BuildFromSnapshot(
+    const GraphTopology& base, const Snapshot& snapshot) noexcept {
+  // The thread pool only runs loops started by the main thread, so the
+  // background build is serial
+  auto get_delta = [&](Node n) -> const NodeDelta* {
+    auto it = std::lower_bound(
+        snapshot.begin(), snapshot.end(), n,
+        [](const auto& entry, Node node) { return entry.first < node; });
+    if (it == snapshot.end() || it->first != n) {
+      return nullptr;
+    }
+    return &it->second;
+  };
+  return BuildTopology(base, false, get_delta, [&](const auto& fn) {
+    for (Node n = 0; n < base.num_nodes(); ++n) {
+      fn(n);
+    }
+  });
+}
+
+katana::Result<void>
+katana::DeltaTopology::StartCompaction() noexcept {
+  std::unique_lock<std::shared_mutex> seal_lock(seal_mutex_);
+  if (compacting_) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "a compaction is already running");
+  }
+
+  Snapshot snapshot;
+  snapshot.reserve(touched_.size());
+  for (Node n : touched_) {
+    snapshot.emplace_back(n, *deltas_[n]);
+  }
+  std::sort(
+      snapshot.begin(), snapshot.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  compacting_ = true;
+  compaction_ = std::async(
+      std::launch::async,
+      [base = base_, snapshot = std::move(snapshot)]() noexcept {
+        return BuildFromSnapshot(*base, snapshot);
+      });
+  return katana::ResultSuccess();
+}
+
+bool
+katana::DeltaTopology::is_compacting() const noexcept {
+  std::shared_lock<std::shared_mutex> seal_lock(seal_mutex_);
+  return compacting_;
+}
+
+katana::Result<void>
+katana::DeltaTopology::FinishCompaction() noexcept {
+  if (!compaction_.valid()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "no compaction is running");
+  }
+  // wait without blocking updates
+  GraphTopology merged = compaction_.get();
+
+  std::unique_lock<std::shared_mutex> seal_lock(seal_mutex_);
+  base_ = std::make_shared<const GraphTopology>(std::move(merged));
+  for (Node n : touched_) {
+    deltas_[n].reset();
+  }
+  touched_.clear();
+  num_added_ = 0;
+  num_removed_ = 0;
+  compacting_ = false;
+
+  // The updates since the snapshot were made against the old base; the new
+  // base holds the state at the snapshot, so apply them again
+  for (const LoggedUpdate& update : log_) {
+    if (update.is_add) {
+      AddEdgeLocked(update.src, update.dst);
+    } else {
+      [[maybe_unused]] bool removed = RemoveEdgeLocked(update.src, update.dst);
+      KATANA_LOG_DEBUG_ASSERT(removed);
+    }
+  }
+  log_.clear();
+
+  return katana::ResultSuccess();
+}
@@ -0,0 +1,137 @@
+#include "katana/Distribution.h"
+
+#include <numeric>
+
+#include "katana/ArrowInterchange.h"
+
+namespace {
+
+using Node = katana::Distribution::Node;
+
+katana::Result<std::vector<std::vector<Node>>>
+ReadProxyLists(
+    const std::vector<std::shared_ptr<arrow::ChunkedArray>>& lists,
+    uint32_t num_hosts, size_t begin, size_t end, const char* kind) {
+  std::vector<std::vector<Node>> proxies(num_hosts);
+  if (lists.empty()) {
+    return proxies;
+  }
+  if (lists.size() != num_hosts) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "partition has {} lists of {} for {} hosts", lists.size(), kind,
+        num_hosts);
+  }
+  for (uint32_t host = 0; host < num_hosts; ++host) {
+    if (lists[host] == nullptr) {
+      continue;
+    }
+    proxies[host] = KATANA_CHECKED_CONTEXT(
+        katana::UnmarshalVector<Node>(lists[host]), "reading {} of host {}",
+        kind, host);
+    for (Node n : proxies[host]) {
+      if (n < begin || n >= end) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "{} of host {} has node {} outside of [{}, {})", kind, host, n,
+            begin, end);
+      }
+    }
+  }
+  return proxies;
+}
+
+}  // namespace
+
+katana::Result<katana::Distribution>
+katana::Distribution::Make(const PropertyGraph* pg, CommBackend* comm) {
+  const size_t num_nodes = pg->num_nodes();
+  const uint32_t num_hosts = comm->Num;
+  const std::shared_ptr<arrow::ChunkedArray>& global_ids =
+      pg->local_to_global_id();
+
+  if (global_ids == nullptr || global_ids->length() == 0) {
+    if (num_hosts != 1 || !pg->master_nodes().empty() ||
+        !pg->mirror_nodes().empty()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "graph has no global node ids but is run on {} hosts", num_hosts);
+    }
+    std::vector<uint64_t> local_to_global(num_nodes);
+    std::iota(local_to_global.begin(), local_to_global.end(), uint64_t{0});
+    return Distribution(
+        comm, num_nodes, num_nodes, std::move(local_to_global),
+        std::vector<std::vector<Node>>(1), std::vector<std::vector<Node>>(1));
+  }
+
+  const tsuba::PartitionMetadata& meta = pg->partition_metadata();
+  if (static_cast<size_t>(global_ids->length()) != num_nodes ||
+      meta.num_owned_ > num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "partition with {} nodes has {} global ids and {} owned nodes",
+        num_nodes, global_ids->length(), meta.num_owned_);
+  }
+  auto local_to_global = KATANA_CHECKED_CONTEXT(
+      UnmarshalVector<uint64_t>(global_ids), "reading global node ids");
+
+  auto masters = KATANA_CHECKED(ReadProxyLists(
+      pg->master_nodes(), num_hosts, 0, meta.num_owned_, "masters"));
+  auto mirrors = KATANA_CHECKED(ReadProxyLists(
+      pg->mirror_nodes(), num_hosts, meta.num_owned_, num_nodes, "mirrors"));
+
+  // The masters this host has for host h must line up with the mirrors h
+  // has of this host; check that at least their numbers agree.
+  std::vector<std::vector<uint8_t>> sizes(num_hosts);
+  for (uint32_t host = 0; host < num_hosts; ++host) {
+    uint64_t size = masters[host].size();
+    sizes[host].resize(sizeof(size));
+    std::memcpy(sizes[host].data(), &size, sizeof(size));
+  }
+  auto received = KATANA_CHECKED(comm->AllToAll(sizes));
+  for (uint32_t host = 0; host < num_hosts; ++host) {
+    uint64_t size = 0;
+    if (received[host].size() == sizeof(size)) {
+      std::memcpy(&size, received[host].data(), sizeof(size));
+    }
+    if (received[host].size() != sizeof(size) ||
+        size != mirrors[host].size()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "host {} has {} mirrors of host {}, which has {} masters for it",
+          comm->ID, mirrors[host].size(), host, size);
+    }
+  }
+
+  return Distribution(
+      comm, meta.num_global_nodes_, meta.num_owned_,
+      std::move(local_to_global), std::move(masters), std::move(mirrors));
+}
+
+katana::Result<void>
+katana::Distribution::SetPartition(
+    PropertyGraph* pg, uint64_t num_global_nodes, size_t num_owned,
+    const std::vector<uint64_t>& local_to_global,
+    const std::vector<std::vector<Node>>& masters,
+    const std::vector<std::vector<Node>>& mirrors) {
+  if (local_to_global.size() != pg->num_nodes() ||
+      num_owned > pg->num_nodes() || masters.size() != mirrors.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "partition with {} nodes has {} global ids, {} owned nodes and "
+        "proxies of {} and {} hosts",
+        pg->num_nodes(), local_to_global.size(), num_owned, masters.size(),
+        mirrors.size());
+  }
+
+  tsuba::PartitionMetadata meta = pg->partition_metadata();
+  meta.num_global_nodes_ = num_global_nodes;
+  meta.num_nodes_ = pg->num_nodes();
+  meta.num_owned_ = num_owned;
+  meta.num_edges_ = pg->num_edges();
+  pg->set_partition_metadata(meta);
+  pg->set_local_to_global_id(KATANA_CHECKED(MarshalVector(local_to_global)));
+  pg->set_master_nodes(KATANA_CHECKED(MarshalVectorOfVectors(masters)));
+  pg->set_mirror_nodes(KATANA_CHECKED(MarshalVectorOfVectors(mirrors)));
+  return ResultSuccess();
+}
@@ -27,6 +27,19 @@
 
 KATANA_EXPORT katana::DynamicBitset katana::EmptyBitset;
 
+namespace {
+size_t
+PopCount(uint64_t n) {
+#ifdef __GNUC__
+  return __builtin_popcountll(n);
+#else
+  n = n - ((n >> 1) & 0x5555555555555555UL);
+  n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
+  return (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
+#endif
+}
+}  // namespace
+
 void
 katana::DynamicBitset::bitwise_or(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
@@ -89,25 +102,49 @@ katana::DynamicBitset::bitwise_xor(
       katana::no_stats());
 }
 
+void
+katana::DynamicBitset::bitwise_andnot(const DynamicBitset& other) {
+  KATANA_LOG_DEBUG_ASSERT(size() == other.size());
+  const auto& other_bitvec = other.get_vec();
+  katana::do_all(
+      katana::iterate(size_t{0}, bitvec_.size()),
+      [&](size_t i) { bitvec_[i] &= ~other_bitvec[i]; }, katana::no_stats());
+}
+
 size_t
 katana::DynamicBitset::count() const {
+  // popcount whole blocks of words per thread rather than one word per
+  // iteration so that the loop can be vectorized
   katana::GAccumulator<size_t> ret;
-  katana::do_all(
-      katana::iterate(bitvec_.begin(), bitvec_.end()),
-      [&](uint64_t n) {
-#ifdef __GNUC__
-        ret += __builtin_popcountll(n);
-#else
-        n = n - ((n >> 1) & 0x5555555555555555UL);
-        n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-        ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-               56;
-#endif
-      },
-      katana::no_stats());
+  katana::on_each([&](unsigned tid, unsigned nthreads) {
+    auto [start, end] =
+        katana::block_range(size_t{0}, bitvec_.size(), tid, nthreads);
+    size_t count = 0;
+    for (size_t i = start; i < end; ++i) {
+      count += PopCount(GetWord(i));
+    }
+    ret += count;
+  });
   return ret.reduce();
 }
 
+size_t
+katana::DynamicBitset::FindNextSet(size_t index) const {
+  if (index >= num_bits_) {
+    return num_bits_;
+  }
+  size_t word_index = index / kNumBitsInUint64;
+  uint64_t word =
+      GetWord(word_index) & (~uint64_t{0} << (index % kNumBitsInUint64));
+  while (word == 0) {
+    if (++word_index == bitvec_.size()) {
+      return num_bits_;
+    }
+    word = GetWord(word_index);
+  }
+  return word_index * kNumBitsInUint64 + CountTrailingZeros(word);
+}
+
 namespace {
 template <typename Integer>
 void
@@ -117,16 +154,18 @@ ComputeOffsets(
   uint32_t activeThreads = katana::getActiveThreads();
   std::vector<Integer> tPrefixBitCounts(activeThreads);
 
+  // threads work on whole words so that they can count and extract the set
+  // bits a word at a time and skip the unset words
+  size_t num_words = bitset.get_vec().size();
+
   // count how many bits are set on each thread
   katana::on_each([&](unsigned tid, unsigned nthreads) {
     auto [start, end] =
-        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+        katana::block_range(size_t{0}, num_words, tid, nthreads);
 
     Integer count = 0;
-    for (Integer i = start; i < end; ++i) {
-      if (bitset.test(i)) {
-        ++count;
-      }
+    for (size_t w = start; w < end; ++w) {
+      count += PopCount(bitset.GetWord(w));
     }
 
     tPrefixBitCounts[tid] = count;
@@ -147,16 +186,20 @@ ComputeOffsets(
     offsets->resize(cur_size + bitsetCount);
     katana::on_each([&](unsigned tid, unsigned nthreads) {
       auto [start, end] =
-          katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+          katana::block_range(size_t{0}, num_words, tid, nthreads);
       Integer index = cur_size;
       if (tid != 0) {
         index += tPrefixBitCounts[tid - 1];
       }
 
-      for (Integer i = start; i < end; ++i) {
-        if (bitset.test(i)) {
-          offsets->at(index) = i;
+      for (size_t w = start; w < end; ++w) {
+        uint64_t word = bitset.GetWord(w);
+        while (word != 0) {
+          (*offsets)[index] =
+              w * katana::DynamicBitset::kNumBitsInUint64 +
+              katana::DynamicBitset::CountTrailingZeros(word);
           ++index;
+          word &= word - 1;
         }
       }
     });
@@ -0,0 +1,98 @@
+#include "katana/EntityTypeIndex.h"
+
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+
+katana::EntityTypeIndex
+katana::EntityTypeIndex::Make(
+    const EntityTypeManager& manager,
+    const NUMAArray<EntityTypeID>& entity_types) noexcept {
+  EntityTypeIndex index;
+  size_t num_types = manager.GetNumEntityTypes();
+  index.num_entities_ = entity_types.size();
+
+  index.atomic_types_.resize(num_types);
+  index.atomic_type_bitsets_.resize(num_types);
+  for (size_t type = 0; type < num_types; ++type) {
+    const SetOfEntityTypeIDs& atomic = manager.GetAtomicSubtypes(type);
+    for (size_t a = 0; a < num_types; ++a) {
+      if (atomic.test(a)) {
+        index.atomic_types_[type].emplace_back(a);
+      }
+    }
+    if (manager.GetAtomicTypeName(type)) {
+      index.atomic_type_bitsets_[type].resize(index.num_entities_);
+    }
+  }
+
+  // the number of entities whose most specific type is each type
+  katana::PerThreadStorage<std::vector<uint64_t>> local_counts;
+  katana::on_each([&](unsigned tid, unsigned total) {
+    std::vector<uint64_t>& counts = *local_counts.getLocal();
+    counts.assign(num_types, 0);
+    auto [begin, end] =
+        katana::block_range(size_t{0}, index.num_entities_, tid, total);
+    for (size_t i = begin; i < end; ++i) {
+      EntityTypeID type = entity_types[i];
+      ++counts[type];
+      for (EntityTypeID a : index.atomic_types_[type]) {
+        index.atomic_type_bitsets_[a].set(i);
+      }
+    }
+  });
+
+  std::vector<uint64_t> most_specific(num_types, 0);
+  for (unsigned i = 0; i < local_counts.size(); ++i) {
+    const std::vector<uint64_t>& counts = *local_counts.getRemote(i);
+    for (size_t type = 0; type < counts.size(); ++type) {
+      most_specific[type] += counts[type];
+    }
+  }
+
+  index.num_entities_of_type_.resize(num_types, 0);
+  for (size_t type = 0; type < num_types; ++type) {
+    for (size_t super = 0; super < num_types; ++super) {
+      if (manager.IsSubtypeOf(type, super)) {
+        index.num_entities_of_type_[type] += most_specific[super];
+      }
+    }
+  }
+
+  return index;
+}
+
+template <typename Id>
+std::vector<Id>
+katana::EntityTypeIndex::GetEntitiesOfType(EntityTypeID entity_type_id) const {
+  if (const DynamicBitset* bitset = GetAtomicTypeBitset(entity_type_id)) {
+    return bitset->GetOffsets<Id>();
+  }
+  if (entity_type_id >= atomic_types_.size()) {
+    return std::vector<Id>();
+  }
+
+  const std::vector<EntityTypeID>& atomic = atomic_types_[entity_type_id];
+  if (atomic.empty()) {
+    // kUnknownEntityType; every entity has it
+    std::vector<Id> ids(num_entities_);
+    katana::do_all(
+        katana::iterate(size_t{0}, ids.size()), [&](size_t i) { ids[i] = i; },
+        katana::no_stats());
+    return ids;
+  }
+
+  DynamicBitset intersection;
+  intersection.resize(num_entities_);
+  intersection.bitwise_and(
+      atomic_type_bitsets_[atomic[0]],
+      atomic_type_bitsets_[atomic.size() > 1 ? atomic[1] : atomic[0]]);
+  for (size_t i = 2; i < atomic.size(); ++i) {
+    intersection.bitwise_and(atomic_type_bitsets_[atomic[i]]);
+  }
+  return intersection.GetOffsets<Id>();
+}
+
+template std::vector<uint32_t>
+katana::EntityTypeIndex::GetEntitiesOfType<uint32_t>(EntityTypeID) const;
+template std::vector<uint64_t>
+katana::EntityTypeIndex::GetEntitiesOfType<uint64_t>(EntityTypeID) const;
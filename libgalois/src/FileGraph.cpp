@@ -326,6 +326,11 @@ FileGraph::fromArrays(
 
 void
 FileGraph::fromFile(const std::string& filename) {
+  mapFile(filename, true);
+}
+
+void
+FileGraph::mapFile(const std::string& filename, bool populate) {
   int fd = open(filename.c_str(), O_RDONLY);
   if (fd == -1)
     KATANA_SYS_DIE("failed opening ", "'", filename, "'");
@@ -338,7 +343,9 @@ FileGraph::fromFile(const std::string& filename) {
   // mmap file, then load from mem using fromMem function
   int _MAP_BASE = MAP_PRIVATE;
 #ifdef MAP_POPULATE
-  _MAP_BASE |= MAP_POPULATE;
+  if (populate) {
+    _MAP_BASE |= MAP_POPULATE;
+  }
 #endif
   void* base = mmap_big(nullptr, buf.st_size, PROT_READ, _MAP_BASE, fd, 0);
   if (base == MAP_FAILED)
@@ -491,6 +498,24 @@ FileGraph::partFromFile(
   }
 }
 
+void
+FileGraph::partFromFile(
+    const std::string& filename, size_t part, size_t numParts, bool numaMap) {
+  KATANA_LOG_ASSERT(part < numParts);
+  GraphRange range;
+  {
+    // Mapping the file without populating it only reads the pages of the
+    // edge indices which divideByNode searches
+    FileGraph whole;
+    whole.mapFile(filename, false);
+    size_t edgeSize = whole.graphVersion == 1 ? sizeof(uint32_t)
+                                              : sizeof(uint64_t);
+    range = whole.divideByNode(
+        sizeof(uint64_t), edgeSize + whole.sizeofEdge, part, numParts);
+  }
+  partFromFile(filename, range.first, range.second, numaMap);
+}
+
 size_t
 FileGraph::findIndex(
     size_t nodeSize, size_t edgeSize, size_t targetSize, size_t lb, size_t ub) {
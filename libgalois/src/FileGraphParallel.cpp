@@ -17,36 +17,25 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#include <condition_variable>
-#include <mutex>
-
 #include "katana/FileGraph.h"
-#include "katana/HWTopo.h"
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 
 namespace katana {
 
 void
 FileGraph::fromFileInterleaved(
     const std::string& filename, size_t sizeofEdgeData) {
-  fromFile(filename);
+  // Rather than reading the whole file on this thread with MAP_POPULATE,
+  // have every thread read the part it will construct: the file is read in
+  // parallel and its pages are first touched on the NUMA node of the thread
+  // which later copies them
+  mapFile(filename, false);
 
-  std::mutex lock;
-  std::condition_variable cond;
   auto& tp = GetThreadPool();
-  unsigned maxSockets = tp.getMaxSockets();
-  unsigned count = maxSockets;
-
-  // Interleave across all NUMA nodes
-  tp.run(tp.getMaxThreads(), [&]() {
-    std::unique_lock<std::mutex> lk(lock);
-    if (ThreadPool::isLeader()) {
-      pageInByNode(ThreadPool::getSocket(), maxSockets, sizeofEdgeData);
-      if (--count == 0)
-        cond.notify_all();
-    } else {
-      cond.wait(lk, [&]() { return count == 0; });
-    }
+  unsigned numThreads = katana::getActiveThreads();
+  tp.run(numThreads, [&]() {
+    pageInByNode(ThreadPool::getTID(), numThreads, sizeofEdgeData);
   });
 }
 
@@ -0,0 +1,175 @@
+#include "katana/Fingerprint.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+
+namespace {
+
+/// The value hashed for a null
+constexpr uint64_t kNullHash = UINT64_C(0x6e756c6c);
+
+template <typename T>
+uint64_t
+ValueBits(const T& value) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(T));
+    return bits;
+  } else {
+    // a view of a binary value
+    return std::hash<std::string_view>{}(
+        std::string_view(value.data(), value.size()));
+  }
+}
+
+template <typename ArrowType>
+uint64_t
+HashValues(const arrow::Array& array, uint64_t hash) {
+  using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+  const auto& typed = static_cast<const ArrayType&>(array);
+  for (int64_t i = 0, length = typed.length(); i < length; ++i) {
+    hash = katana::FingerprintCombine(
+        hash, typed.IsNull(i) ? kNullHash : ValueBits(typed.GetView(i)));
+  }
+  return hash;
+}
+
+/// Hash the values of types without a fast path, e.g., lists, through
+/// scalars, which is much slower
+arrow::Result<uint64_t>
+HashScalars(const arrow::Array& array, uint64_t hash) {
+  for (int64_t i = 0, length = array.length(); i < length; ++i) {
+    if (array.IsNull(i)) {
+      hash = katana::FingerprintCombine(hash, kNullHash);
+      continue;
+    }
+    ARROW_ASSIGN_OR_RAISE(auto scalar, array.GetScalar(i));
+    hash = katana::FingerprintCombine(hash, scalar->hash());
+  }
+  return hash;
+}
+
+arrow::Result<uint64_t>
+HashChunk(const arrow::Array& array, uint64_t hash) {
+  switch (array.type_id()) {
+  case arrow::Type::BOOL:
+    return HashValues<arrow::BooleanType>(array, hash);
+  case arrow::Type::INT8:
+    return HashValues<arrow::Int8Type>(array, hash);
+  case arrow::Type::INT16:
+    return HashValues<arrow::Int16Type>(array, hash);
+  case arrow::Type::INT32:
+    return HashValues<arrow::Int32Type>(array, hash);
+  case arrow::Type::INT64:
+    return HashValues<arrow::Int64Type>(array, hash);
+  case arrow::Type::UINT8:
+    return HashValues<arrow::UInt8Type>(array, hash);
+  case arrow::Type::UINT16:
+    return HashValues<arrow::UInt16Type>(array, hash);
+  case arrow::Type::UINT32:
+    return HashValues<arrow::UInt32Type>(array, hash);
+  case arrow::Type::UINT64:
+    return HashValues<arrow::UInt64Type>(array, hash);
+  case arrow::Type::FLOAT:
+    return HashValues<arrow::FloatType>(array, hash);
+  case arrow::Type::DOUBLE:
+    return HashValues<arrow::DoubleType>(array, hash);
+  case arrow::Type::TIMESTAMP:
+    return HashValues<arrow::TimestampType>(array, hash);
+  case arrow::Type::STRING:
+    return HashValues<arrow::StringType>(array, hash);
+  case arrow::Type::LARGE_STRING:
+    return HashValues<arrow::LargeStringType>(array, hash);
+  case arrow::Type::BINARY:
+    return HashValues<arrow::BinaryType>(array, hash);
+  case arrow::Type::LARGE_BINARY:
+    return HashValues<arrow::LargeBinaryType>(array, hash);
+  default:
+    return HashScalars(array, hash);
+  }
+}
+
+}  // namespace
+
+uint64_t
+katana::FingerprintBlocks(
+    uint64_t num_items,
+    const std::function<uint64_t(uint64_t begin, uint64_t end, uint64_t seed)>&
+        hash_block) {
+  uint64_t num_blocks =
+      (num_items + kFingerprintBlockSize - 1) / kFingerprintBlockSize;
+  std::vector<uint64_t> hashes(num_blocks);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        uint64_t begin = block * kFingerprintBlockSize;
+        uint64_t end = std::min(begin + kFingerprintBlockSize, num_items);
+        hashes[block] = hash_block(begin, end, FingerprintCombine(0, block));
+      },
+      katana::steal(), katana::no_stats());
+
+  uint64_t hash = FingerprintCombine(0, num_items);
+  for (uint64_t block_hash : hashes) {
+    hash = FingerprintCombine(hash, block_hash);
+  }
+  return hash;
+}
+
+katana::Result<uint64_t>
+katana::Fingerprint(const arrow::ChunkedArray& array) {
+  uint64_t num_rows = array.length();
+  uint64_t num_blocks =
+      (num_rows + kFingerprintBlockSize - 1) / kFingerprintBlockSize;
+  std::vector<katana::CopyableResult<void>> results(
+      num_blocks, katana::CopyableResultSuccess());
+
+  uint64_t values_hash = FingerprintBlocks(
+      num_rows, [&](uint64_t begin, uint64_t end, uint64_t seed) {
+        // blocks are rows rather than chunks so that the hash does not
+        // depend on the chunks
+        uint64_t hash = seed;
+        auto slice = array.Slice(begin, end - begin);
+        for (const auto& chunk : slice->chunks()) {
+          auto res = HashChunk(*chunk, hash);
+          if (!res.ok()) {
+            results[begin / kFingerprintBlockSize] =
+                katana::CopyableErrorInfo(katana::ErrorCode::ArrowError)
+                    .WithContext("hashing rows {}: {}", begin, res.status());
+            return hash;
+          }
+          hash = res.ValueOrDie();
+        }
+        return hash;
+      });
+
+  for (const auto& result : results) {
+    if (!result) {
+      return katana::ErrorInfo(result.error());
+    }
+  }
+  return FingerprintCombine(
+      std::hash<std::string>{}(array.type()->ToString()), values_hash);
+}
+
+katana::Result<uint64_t>
+katana::Fingerprint(const arrow::Table& table) {
+  // the hashes of columns are summed so that their order does not matter
+  uint64_t columns_hash = 0;
+  for (int i = 0, num_columns = table.num_columns(); i < num_columns; ++i) {
+    const std::string& name = table.field(i)->name();
+    uint64_t column_hash = KATANA_CHECKED_CONTEXT(
+        Fingerprint(*table.column(i)), "column {}", std::quoted(name));
+    columns_hash +=
+        FingerprintCombine(std::hash<std::string>{}(name), column_hash);
+  }
+  return FingerprintCombine(
+      FingerprintCombine(0, table.num_rows()), columns_hash);
+}
@@ -0,0 +1,473 @@
+#include "katana/GraphGenerators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Random.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// The number of items, e.g., edges of R-MAT graphs or nodes of SBM graphs,
+/// generated from each random stream
+constexpr uint64_t kBlockSize = uint64_t{1} << 16;
+
+/// The stream of numbers that are not drawn by blocks
+constexpr uint64_t kKeyStream = std::numeric_limits<uint64_t>::max();
+
+constexpr double kPi = 3.14159265358979323846;
+
+uint64_t
+NumBlocks(uint64_t num_items) {
+  return (num_items + kBlockSize - 1) / kBlockSize;
+}
+
+/// The items [begin, end) of block of num_items items
+std::pair<uint64_t, uint64_t>
+BlockRange(uint64_t block, uint64_t num_items) {
+  uint64_t begin = block * kBlockSize;
+  return {begin, std::min(begin + kBlockSize, num_items)};
+}
+
+/// Sort the edges of each node by destination and, if remove_duplicates,
+/// drop self loops and repeated edges
+katana::GraphTopology
+SortEdges(
+    katana::NUMAArray<Edge>&& adj_indices, katana::NUMAArray<Node>&& dests,
+    bool remove_duplicates) {
+  uint64_t num_nodes = adj_indices.size();
+  katana::NUMAArray<Edge> degrees;
+  degrees.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Node* first = dests.data() + (n == 0 ? 0 : adj_indices[n - 1]);
+        Node* last = dests.data() + adj_indices[n];
+        std::sort(first, last);
+        if (remove_duplicates) {
+          last = std::unique(first, last);
+          last = std::remove(first, last, static_cast<Node>(n));
+        }
+        degrees[n] = last - first;
+      },
+      katana::steal(), katana::no_stats());
+  if (!remove_duplicates) {
+    return katana::GraphTopology(std::move(adj_indices), std::move(dests));
+  }
+
+  katana::NUMAArray<Edge> kept_indices;
+  kept_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::partial_sum(
+      degrees.begin(), degrees.end(), kept_indices.begin());
+  katana::NUMAArray<Node> kept_dests;
+  kept_dests.allocateInterleaved(
+      num_nodes == 0 ? 0 : kept_indices[num_nodes - 1]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        const Node* first = dests.data() + (n == 0 ? 0 : adj_indices[n - 1]);
+        std::copy(
+            first, first + degrees[n],
+            kept_dests.data() + kept_indices[n] - degrees[n]);
+      },
+      katana::steal(), katana::no_stats());
+  return katana::GraphTopology(std::move(kept_indices), std::move(kept_dests));
+}
+
+/// The CSR topology of the edges (srcs[e], dsts[e]) among num_nodes nodes
+katana::GraphTopology
+BuildTopology(
+    uint64_t num_nodes, const katana::NUMAArray<Node>& srcs,
+    const katana::NUMAArray<Node>& dsts, bool remove_duplicates) {
+  uint64_t num_edges = srcs.size();
+  katana::NUMAArray<Edge> adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(adj_indices.begin(), adj_indices.end(), Edge{0});
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { __sync_add_and_fetch(&adj_indices[srcs[e]], 1); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  // the position of the next edge of each node
+  katana::NUMAArray<Edge> cursors;
+  cursors.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { cursors[n] = n == 0 ? 0 : adj_indices[n - 1]; },
+      katana::no_stats());
+  katana::NUMAArray<Node> dests;
+  dests.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        dests[__sync_fetch_and_add(&cursors[srcs[e]], 1)] = dsts[e];
+      },
+      katana::no_stats());
+
+  // the scatter leaves the edges of a node in any order; sorting them makes
+  // the topology deterministic
+  return SortEdges(std::move(adj_indices), std::move(dests), remove_duplicates);
+}
+
+/// A bijection of the ids [0, 2^scale) picked by key: multiplications by odd
+/// numbers, additions and right xor shifts are all invertible modulo 2^scale
+uint64_t
+PermuteID(uint64_t id, uint32_t scale, uint64_t key) {
+  uint64_t mask = (uint64_t{1} << scale) - 1;
+  uint32_t shift = scale / 2 + 1;
+  id = (id * (key | 1) + (key >> 32)) & mask;
+  id ^= id >> shift;
+  id = (id * UINT64_C(0x9e3779b97f4a7c15)) & mask;
+  id ^= id >> shift;
+  return id;
+}
+
+template <typename ArrowType, typename Distribution>
+katana::Result<std::shared_ptr<arrow::Array>>
+RandomColumn(
+    uint64_t num_rows, uint64_t seed, uint64_t first_stream,
+    const Distribution& dist) {
+  katana::ArrowRandomAccessBuilder<ArrowType> builder(num_rows);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, NumBlocks(num_rows)),
+      [&](uint64_t block) {
+        katana::RandGenerator gen =
+            katana::MakeStreamGenerator(seed, first_stream + block);
+        Distribution block_dist = dist;
+        auto [begin, end] = BlockRange(block, num_rows);
+        for (uint64_t row = begin; row < end; ++row) {
+          builder[row] = block_dist(gen);
+        }
+      },
+      katana::no_stats());
+  return builder.Finalize();
+}
+
+}  // namespace
+
+katana::Result<katana::GraphTopology>
+katana::GenerateRMAT(const RMATParams& params, uint64_t seed) {
+  // node ids and counts must fit in 32 bits
+  if (params.scale < 1 || params.scale > 31) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "scale {} is not in [1, 31]",
+        params.scale);
+  }
+  double a = params.a;
+  double ab = a + params.b;
+  double abc = ab + params.c;
+  if (params.a < 0 || params.b < 0 || params.c < 0 || abc > 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "quadrant probabilities {}, {}, {} and {} are not all in [0, 1]",
+        params.a, params.b, params.c, 1 - abc);
+  }
+
+  uint64_t num_nodes = uint64_t{1} << params.scale;
+  uint64_t num_edges = num_nodes * params.edge_factor;
+  RandGenerator key_gen = MakeStreamGenerator(seed, kKeyStream);
+  uint64_t key = (static_cast<uint64_t>(key_gen()) << 32) | key_gen();
+
+  NUMAArray<Node> srcs;
+  NUMAArray<Node> dsts;
+  srcs.allocateInterleaved(num_edges);
+  dsts.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, NumBlocks(num_edges)),
+      [&](uint64_t block) {
+        RandGenerator gen = MakeStreamGenerator(seed, block);
+        std::uniform_real_distribution<double> dist;
+        auto [begin, end] = BlockRange(block, num_edges);
+        for (uint64_t e = begin; e < end; ++e) {
+          // pick a quadrant at each level: a is (0, 0), b is (0, 1), c is
+          // (1, 0) and the rest is (1, 1)
+          uint64_t src = 0;
+          uint64_t dst = 0;
+          for (uint32_t level = 0; level < params.scale; ++level) {
+            double r = dist(gen);
+            src = (src << 1) | (r >= ab);
+            dst = (dst << 1) | ((r >= a && r < ab) || r >= abc);
+          }
+          if (params.permute) {
+            src = PermuteID(src, params.scale, key);
+            dst = PermuteID(dst, params.scale, key);
+          }
+          srcs[e] = src;
+          dsts[e] = dst;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return BuildTopology(num_nodes, srcs, dsts, params.remove_duplicates);
+}
+
+katana::Result<katana::GraphTopology>
+katana::GenerateSBM(const SBMParams& params, uint64_t seed) {
+  if (params.num_blocks == 0 || params.num_blocks > params.num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "number of blocks {} is not in [1, {}]",
+        params.num_blocks, params.num_nodes);
+  }
+  if (params.p_in < 0 || params.p_in > 1 || params.p_out < 0 ||
+      params.p_out > 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edge probabilities {} and {} are not both in [0, 1]", params.p_in,
+        params.p_out);
+  }
+
+  uint64_t num_nodes = params.num_nodes;
+  uint64_t num_blocks = params.num_blocks;
+  auto block_begin = [&](uint64_t b) {
+    return (b * num_nodes + num_blocks - 1) / num_blocks;
+  };
+
+  // the number of edges of a node is binomial, so the edges of each block of
+  // nodes are generated into vectors and then gathered
+  uint64_t num_gen_blocks = NumBlocks(num_nodes);
+  std::vector<std::vector<Node>> block_srcs(num_gen_blocks);
+  std::vector<std::vector<Node>> block_dsts(num_gen_blocks);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_gen_blocks),
+      [&](uint64_t gen_block) {
+        RandGenerator gen = MakeStreamGenerator(seed, gen_block);
+        auto& srcs = block_srcs[gen_block];
+        auto& dsts = block_dsts[gen_block];
+        auto [begin, end] = BlockRange(gen_block, num_nodes);
+        for (uint64_t n = begin; n < end; ++n) {
+          uint64_t b = n * num_blocks / num_nodes;
+          uint64_t first = block_begin(b);
+          uint64_t size = block_begin(b + 1) - first;
+          uint64_t others = num_nodes - size;
+
+          if (size > 1) {
+            std::binomial_distribution<uint64_t> num_in_dist(
+                size - 1, params.p_in);
+            uint64_t num_in = num_in_dist(gen);
+            // the other nodes of the block, skipping n
+            std::uniform_int_distribution<uint64_t> in_dist(0, size - 2);
+            for (uint64_t i = 0; i < num_in; ++i) {
+              uint64_t dst = first + in_dist(gen);
+              srcs.emplace_back(n);
+              dsts.emplace_back(dst >= n ? dst + 1 : dst);
+            }
+          }
+          if (others > 0) {
+            std::binomial_distribution<uint64_t> num_out_dist(
+                others, params.p_out);
+            uint64_t num_out = num_out_dist(gen);
+            // the nodes of other blocks, skipping this block
+            std::uniform_int_distribution<uint64_t> out_dist(0, others - 1);
+            for (uint64_t i = 0; i < num_out; ++i) {
+              uint64_t dst = out_dist(gen);
+              srcs.emplace_back(n);
+              dsts.emplace_back(dst >= first ? dst + size : dst);
+            }
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<uint64_t> offsets(num_gen_blocks + 1);
+  for (uint64_t i = 0; i < num_gen_blocks; ++i) {
+    offsets[i + 1] = offsets[i] + block_srcs[i].size();
+  }
+  NUMAArray<Node> srcs;
+  NUMAArray<Node> dsts;
+  srcs.allocateInterleaved(offsets.back());
+  dsts.allocateInterleaved(offsets.back());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_gen_blocks),
+      [&](uint64_t i) {
+        std::copy(
+            block_srcs[i].begin(), block_srcs[i].end(),
+            srcs.data() + offsets[i]);
+        std::copy(
+            block_dsts[i].begin(), block_dsts[i].end(),
+            dsts.data() + offsets[i]);
+        std::vector<Node>().swap(block_srcs[i]);
+        std::vector<Node>().swap(block_dsts[i]);
+      },
+      katana::no_stats());
+
+  return BuildTopology(num_nodes, srcs, dsts, true);
+}
+
+katana::Result<katana::GraphTopology>
+katana::GenerateRandomGeometric(
+    const RandomGeometricParams& params, uint64_t seed) {
+  if (params.num_nodes == 0 || params.avg_degree <= 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "{} nodes of average degree {} are not a geometric graph",
+        params.num_nodes, params.avg_degree);
+  }
+
+  uint64_t num_nodes = params.num_nodes;
+  // a node has avg_degree neighbors in the expected pi * r^2 * num_nodes
+  double radius = std::sqrt(params.avg_degree / (kPi * num_nodes));
+  double radius_squared = radius * radius;
+  // cells are at least as wide as the radius so that the neighbors of a node
+  // are in its cell and the adjacent ones
+  uint64_t side = std::max<uint64_t>(1, static_cast<uint64_t>(1 / radius));
+  uint64_t num_cells = side * side;
+  auto cell_of = [&](double coordinate) {
+    return std::min(side - 1, static_cast<uint64_t>(coordinate * side));
+  };
+
+  NUMAArray<double> xs;
+  NUMAArray<double> ys;
+  xs.allocateInterleaved(num_nodes);
+  ys.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, NumBlocks(num_nodes)),
+      [&](uint64_t block) {
+        RandGenerator gen = MakeStreamGenerator(seed, block);
+        std::uniform_real_distribution<double> dist;
+        auto [begin, end] = BlockRange(block, num_nodes);
+        for (uint64_t n = begin; n < end; ++n) {
+          xs[n] = dist(gen);
+          ys[n] = dist(gen);
+        }
+      },
+      katana::no_stats());
+
+  // number the nodes by cell, row by row, and then by the order they were
+  // drawn in, so that near nodes get near ids
+  NUMAArray<uint64_t> cell_ends;
+  cell_ends.allocateInterleaved(num_cells);
+  katana::ParallelSTL::fill(cell_ends.begin(), cell_ends.end(), uint64_t{0});
+  auto cell_of_node = [&](const NUMAArray<double>& x,
+                          const NUMAArray<double>& y, uint64_t n) {
+    return cell_of(y[n]) * side + cell_of(x[n]);
+  };
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        __sync_add_and_fetch(&cell_ends[cell_of_node(xs, ys, n)], 1);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      cell_ends.begin(), cell_ends.end(), cell_ends.begin());
+  auto cell_begin = [&](uint64_t c) { return c == 0 ? 0 : cell_ends[c - 1]; };
+
+  NUMAArray<uint64_t> cursors;
+  cursors.allocateInterleaved(num_cells);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_cells),
+      [&](uint64_t c) { cursors[c] = cell_begin(c); }, katana::no_stats());
+  NUMAArray<uint64_t> order;
+  order.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        order[__sync_fetch_and_add(&cursors[cell_of_node(xs, ys, n)], 1)] = n;
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_cells),
+      [&](uint64_t c) {
+        std::sort(
+            order.data() + cell_begin(c), order.data() + cell_ends[c]);
+      },
+      katana::steal(), katana::no_stats());
+
+  NUMAArray<double> px;
+  NUMAArray<double> py;
+  px.allocateInterleaved(num_nodes);
+  py.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        px[i] = xs[order[i]];
+        py[i] = ys[order[i]];
+      },
+      katana::no_stats());
+
+  auto for_each_neighbor = [&](uint64_t i, auto fn) {
+    uint64_t cx = cell_of(px[i]);
+    uint64_t cy = cell_of(py[i]);
+    for (uint64_t y = cy == 0 ? 0 : cy - 1; y <= std::min(cy + 1, side - 1);
+         ++y) {
+      for (uint64_t x = cx == 0 ? 0 : cx - 1; x <= std::min(cx + 1, side - 1);
+           ++x) {
+        uint64_t c = y * side + x;
+        for (uint64_t j = cell_begin(c); j < cell_ends[c]; ++j) {
+          double dx = px[j] - px[i];
+          double dy = py[j] - py[i];
+          if (j != i && dx * dx + dy * dy <= radius_squared) {
+            fn(j);
+          }
+        }
+      }
+    }
+  };
+
+  NUMAArray<Edge> adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        Edge degree = 0;
+        for_each_neighbor(i, [&](uint64_t) { ++degree; });
+        adj_indices[i] = degree;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  NUMAArray<Node> dests;
+  dests.allocateInterleaved(adj_indices[num_nodes - 1]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        Edge e = i == 0 ? 0 : adj_indices[i - 1];
+        for_each_neighbor(i, [&](uint64_t j) { dests[e++] = j; });
+      },
+      katana::steal(), katana::no_stats());
+
+  return SortEdges(std::move(adj_indices), std::move(dests), false);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::GenerateRandomProperties(
+    uint64_t num_rows, int num_columns, const std::string& prefix,
+    const std::shared_ptr<arrow::DataType>& type, uint64_t seed) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (int i = 0; i < num_columns; ++i) {
+    // each column has its own streams
+    uint64_t first_stream = i * NumBlocks(num_rows);
+    switch (type->id()) {
+    case arrow::Type::INT64:
+      columns.emplace_back(KATANA_CHECKED(RandomColumn<arrow::Int64Type>(
+          num_rows, seed, first_stream,
+          std::uniform_int_distribution<int64_t>(1, 100))));
+      break;
+    case arrow::Type::DOUBLE:
+      columns.emplace_back(KATANA_CHECKED(RandomColumn<arrow::DoubleType>(
+          num_rows, seed, first_stream,
+          std::uniform_real_distribution<double>(0, 1))));
+      break;
+    default:
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "random properties of type {} are not supported", type->ToString());
+    }
+    fields.emplace_back(arrow::field(prefix + std::to_string(i), type));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
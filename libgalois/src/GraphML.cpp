@@ -1,8 +1,10 @@
 #include "katana/GraphML.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
@@ -11,8 +13,10 @@
 #include <optional>
 #include <random>
 #include <sstream>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
@@ -329,20 +333,34 @@ ProcessData(xmlTextReaderPtr reader) {
   return make_pair(key, propertyData);
 }
 
+/// The attributes and data of a node element
+struct ParsedNode {
+  std::string id;
+  std::vector<std::string> labels;
+  std::vector<std::pair<std::string, std::string>> properties;
+};
+
+/// The attributes and data of an edge element
+struct ParsedEdge {
+  std::string source;
+  std::string target;
+  std::string type;
+  std::vector<std::pair<std::string, std::string>> properties;
+};
+
 /*
  * reader should be pointing at the node element before calling
  *
  * parses the node from a GraphML file into readable form
  */
-void
-ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+ParsedNode
+ParseNode(xmlTextReaderPtr reader) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
   xmlChar *name, *value;
 
-  std::string id;
-  std::vector<std::string> labels;
+  ParsedNode node;
 
   bool extractedLabels = false;  // neo4j includes these twice so only parse 1
 
@@ -353,7 +371,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
 
     if (name != NULL) {
       if (xmlStrEqual(name, BAD_CAST "id")) {
-        id = std::string((const char*)value);
+        node.id = std::string((const char*)value);
       } else if (
           xmlStrEqual(name, BAD_CAST "labels") ||
           xmlStrEqual(name, BAD_CAST "label")) {
@@ -362,7 +380,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
         if (data.front() == ':') {
           data.erase(0, 1);
         }
-        boost::split(labels, data, boost::is_any_of(":"));
+        boost::split(node.labels, data, boost::is_any_of(":"));
         extractedLabels = true;
       } else {
         KATANA_LOG_ERROR(
@@ -376,11 +394,6 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderMoveToNextAttribute(reader);
   }
 
-  bool validNode = !id.empty();
-  if (validNode) {
-    builder->StartNode(id);
-  }
-
   // parse "data" xml nodes for properties
   ret = xmlTextReaderRead(reader);
   // will terminate when </node> reached or an improper read
@@ -404,22 +417,11 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
               if (data.front() == ':') {
                 data.erase(0, 1);
               }
-              boost::split(labels, data, boost::is_any_of(":"));
+              boost::split(node.labels, data, boost::is_any_of(":"));
               extractedLabels = true;
             }
           } else if (property.first != std::string("IGNORE")) {
-            if (validNode) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
-            }
+            node.properties.emplace_back(std::move(property));
           }
         }
       } else {
@@ -432,16 +434,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     xmlFree(name);
     ret = xmlTextReaderRead(reader);
   }
-
-  // add labels if they exists
-  if (validNode) {
-    if (!labels.empty()) {
-      for (std::string label : labels) {
-        builder->AddLabel(label);
-      }
-    }
-    builder->FinishNode();
-  }
+  return node;
 }
 
 /*
@@ -449,16 +442,14 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
  *
  * parses the edge from a GraphML file into readable form
  */
-void
-ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+ParsedEdge
+ParseEdge(xmlTextReaderPtr reader) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
   xmlChar *name, *value;
 
-  std::string source;
-  std::string target;
-  std::string type;
+  ParsedEdge edge;
   bool extracted_type = false;  // neo4j includes these twice so only parse 1
 
   // parse node attributes for id (required) and label(s) (optional)
@@ -469,13 +460,13 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     if (name != NULL) {
       if (xmlStrEqual(name, BAD_CAST "id")) {
       } else if (xmlStrEqual(name, BAD_CAST "source")) {
-        source = std::string((const char*)value);
+        edge.source = std::string((const char*)value);
       } else if (xmlStrEqual(name, BAD_CAST "target")) {
-        target = std::string((const char*)value);
+        edge.target = std::string((const char*)value);
       } else if (
           xmlStrEqual(name, BAD_CAST "labels") ||
           xmlStrEqual(name, BAD_CAST "label")) {
-        type = std::string((const char*)value);
+        edge.type = std::string((const char*)value);
         extracted_type = true;
       } else {
         KATANA_LOG_ERROR(
@@ -489,11 +480,6 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderMoveToNextAttribute(reader);
   }
 
-  bool valid_edge = !source.empty() && !target.empty();
-  if (valid_edge) {
-    valid_edge = builder->StartEdge(source, target);
-  }
-
   // parse "data" xml edges for properties
   ret = xmlTextReaderRead(reader);
   // will terminate when </edge> reached or an improper read
@@ -512,22 +498,11 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
           if (property.first == std::string("label") ||
               property.first == std::string("labels")) {
             if (!extracted_type) {
-              type = property.second;
+              edge.type = property.second;
               extracted_type = true;
             }
           } else if (property.first != std::string("IGNORE")) {
-            if (valid_edge) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
-            }
+            edge.properties.emplace_back(std::move(property));
           }
         }
       } else {
@@ -539,14 +514,154 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     xmlFree(name);
     ret = xmlTextReaderRead(reader);
   }
+  return edge;
+}
+
+void
+ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+  ParsedNode node = ParseNode(reader);
+  if (node.id.empty()) {
+    return;
+  }
 
+  builder->StartNode(node.id);
+  for (const auto& property : node.properties) {
+    const std::string& value = property.second;
+    builder->AddValue(
+        property.first,
+        [&]() {
+          return PropertyKey{property.first, ImportDataType::kString, false};
+        },
+        [&value](ImportDataType type, bool is_list) {
+          return ResolveValue(value, type, is_list);
+        });
+  }
+  // add labels if they exists
+  for (const std::string& label : node.labels) {
+    builder->AddLabel(label);
+  }
+  builder->FinishNode();
+}
+
+void
+ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+  ParsedEdge edge = ParseEdge(reader);
+  if (edge.source.empty() || edge.target.empty() ||
+      !builder->StartEdge(edge.source, edge.target)) {
+    return;
+  }
+
+  for (const auto& property : edge.properties) {
+    const std::string& value = property.second;
+    builder->AddValue(
+        property.first,
+        [&]() {
+          return PropertyKey{property.first, ImportDataType::kString, false};
+        },
+        [&value](ImportDataType type, bool is_list) {
+          return ResolveValue(value, type, is_list);
+        });
+  }
   // add type if it exists
-  if (valid_edge) {
-    if (type.length() > 0) {
-      builder->AddLabel(type);
+  if (edge.type.length() > 0) {
+    builder->AddLabel(edge.type);
+  }
+  builder->FinishEdge();
+}
+
+/// The keys of one kind of element, in the order of the file
+struct KeySet {
+  std::vector<PropertyKey> keys;
+  std::unordered_map<std::string, size_t> indexes;
+
+  void Add(PropertyKey key) {
+    if (indexes.emplace(key.id, keys.size()).second) {
+      keys.emplace_back(std::move(key));
     }
-    builder->FinishEdge();
   }
+
+  /// \returns the key with id, or nullptr for undeclared keys, which
+  /// PropertyGraphBuilder treats as strings
+  const PropertyKey* Find(const std::string& id) const {
+    auto it = indexes.find(id);
+    return it == indexes.end() ? nullptr : &keys[it->second];
+  }
+};
+
+struct GraphMLKeys {
+  KeySet nodes;
+  KeySet edges;
+};
+
+/// Parses the elements of a chunk of a GraphML file into a shard
+struct ShardSink {
+  const GraphMLKeys* keys;
+  katana::ShardedPropertyGraphBuilder::Shard* shard;
+  katana::Result<void> result;
+};
+
+using AddValueFn = katana::Result<void> (
+    katana::ShardedPropertyGraphBuilder::Shard::*)(
+    const std::string&, ImportData);
+
+katana::Result<void>
+AddProperties(
+    katana::ShardedPropertyGraphBuilder::Shard* shard, AddValueFn add_value,
+    const KeySet& keys,
+    const std::vector<std::pair<std::string, std::string>>& properties) {
+  for (const auto& [id, value] : properties) {
+    const PropertyKey* key = keys.Find(id);
+    if (key == nullptr) {
+      KATANA_CHECKED((shard->*add_value)(
+          id, ResolveValue(value, ImportDataType::kString, false)));
+    } else {
+      KATANA_CHECKED((shard->*add_value)(
+          key->name, ResolveValue(value, key->type, key->is_list)));
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+AddNode(ParsedNode&& node, ShardSink* sink) {
+  using Shard = katana::ShardedPropertyGraphBuilder::Shard;
+  sink->shard->AddNode(std::move(node.id));
+  KATANA_CHECKED(AddProperties(
+      sink->shard, &Shard::AddNodeValue, sink->keys->nodes, node.properties));
+  for (const std::string& label : node.labels) {
+    KATANA_CHECKED(sink->shard->AddNodeLabel(label));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+AddEdge(ParsedEdge&& edge, ShardSink* sink) {
+  using Shard = katana::ShardedPropertyGraphBuilder::Shard;
+  sink->shard->AddEdge(std::move(edge.source), std::move(edge.target));
+  KATANA_CHECKED(AddProperties(
+      sink->shard, &Shard::AddEdgeValue, sink->keys->edges, edge.properties));
+  if (edge.type.length() > 0) {
+    KATANA_CHECKED(sink->shard->AddEdgeType(edge.type));
+  }
+  return katana::ResultSuccess();
+}
+
+void
+ProcessNode(xmlTextReaderPtr reader, ShardSink* sink) {
+  ParsedNode node = ParseNode(reader);
+  if (node.id.empty() || !sink->result) {
+    return;
+  }
+  sink->result = AddNode(std::move(node), sink);
+}
+
+void
+ProcessEdge(xmlTextReaderPtr reader, ShardSink* sink) {
+  ParsedEdge edge = ParseEdge(reader);
+  if (edge.source.empty() || edge.target.empty() || !sink->result) {
+    return;
+  }
+  sink->result = AddEdge(std::move(edge), sink);
 }
 
 /*
@@ -554,10 +669,9 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
  *
  * parses the graph structure from a GraphML file into Galois format
  */
+template <typename Builder>
 void
-ProcessGraph(
-    xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder,
-    bool verbose) {
+ProcessGraph(xmlTextReaderPtr reader, Builder* builder, bool verbose) {
   auto minimum_depth = xmlTextReaderDepth(reader);
   int ret = xmlTextReaderRead(reader);
 
@@ -599,6 +713,239 @@ ProcessGraph(
   }
 }
 
+/*
+ * reads the keys of a GraphML file, stopping at its graph element
+ */
+katana::Result<GraphMLKeys>
+ReadKeys(const std::string& infilename) {
+  xmlTextReaderPtr reader = xmlNewTextReaderFilename(infilename.c_str());
+  if (reader == NULL) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Unable to open {}", infilename);
+  }
+
+  GraphMLKeys keys;
+  bool found_graph = false;
+  int ret = xmlTextReaderRead(reader);
+  while (ret == 1 && !found_graph) {
+    xmlChar* name;
+    name = xmlTextReaderName(reader);
+    if (name == NULL) {
+      name = xmlStrdup(BAD_CAST "--");
+    }
+    // if elt is an xml node
+    if (xmlTextReaderNodeType(reader) == 1) {
+      if (xmlStrEqual(name, BAD_CAST "key")) {
+        PropertyKey key = katana::graphml::ProcessKey(reader);
+        if (!key.id.empty() && key.id != std::string("label") &&
+            key.id != std::string("IGNORE")) {
+          if (key.for_node) {
+            keys.nodes.Add(std::move(key));
+          } else if (key.for_edge) {
+            keys.edges.Add(std::move(key));
+          }
+        }
+      } else if (xmlStrEqual(name, BAD_CAST "graph")) {
+        found_graph = true;
+      }
+    }
+
+    xmlFree(name);
+    if (!found_graph) {
+      ret = xmlTextReaderRead(reader);
+    }
+  }
+  xmlFreeTextReader(reader);
+  if (ret < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "Failed to parse {}, incorrect xml format", infilename);
+  }
+  if (!found_graph) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} has no graph element",
+        infilename);
+  }
+  return keys;
+}
+
+bool
+IsTagEnd(std::string_view text, size_t pos) {
+  return pos < text.size() && std::strchr(" \t\r\n/>", text[pos]) != nullptr;
+}
+
+/// \returns if text has the start tag of a node or an edge element at pos.
+/// Text and attribute values cannot contain '<', so outside of comments and
+/// CDATA sections this is the start of an element.
+bool
+IsElementStart(std::string_view text, size_t pos) {
+  return (text.compare(pos, 5, "<node") == 0 ||
+          text.compare(pos, 5, "<edge") == 0) &&
+         IsTagEnd(text, pos + 5);
+}
+
+/// \returns the first node or edge element in text at or after pos, or npos
+size_t
+FindElementStart(std::string_view text, size_t pos) {
+  for (pos = text.find('<', pos); pos != std::string_view::npos;
+       pos = text.find('<', pos + 1)) {
+    if (IsElementStart(text, pos)) {
+      return pos;
+    }
+  }
+  return std::string_view::npos;
+}
+
+/// \returns the last node or edge element in text after its start, or npos
+size_t
+FindLastElementStart(std::string_view text) {
+  for (size_t pos = text.rfind('<'); pos != std::string_view::npos && pos > 0;
+       pos = text.rfind('<', pos - 1)) {
+    if (IsElementStart(text, pos)) {
+      return pos;
+    }
+  }
+  return std::string_view::npos;
+}
+
+/// \returns the position after the start tag of the graph element, or npos if
+/// text does not contain all of it
+size_t
+FindGraphBody(std::string_view text) {
+  size_t pos = text.find("<graph");
+  // skip the graphml element
+  while (pos != std::string_view::npos && !IsTagEnd(text, pos + 6)) {
+    pos = text.find("<graph", pos + 1);
+  }
+  if (pos == std::string_view::npos) {
+    return pos;
+  }
+  // attribute values may contain '>'
+  char quote = '\0';
+  for (pos += 6; pos < text.size(); ++pos) {
+    if (quote != '\0') {
+      if (text[pos] == quote) {
+        quote = '\0';
+      }
+    } else if (text[pos] == '"' || text[pos] == '\'') {
+      quote = text[pos];
+    } else if (text[pos] == '>') {
+      return pos + 1;
+    }
+  }
+  return std::string_view::npos;
+}
+
+/// Append up to size bytes of in to window
+/// \returns false at the end of the file
+bool
+ReadMore(std::ifstream* in, std::string* window, size_t size) {
+  size_t old_size = window->size();
+  window->resize(old_size + size);
+  in->read(&(*window)[old_size], size);
+  window->resize(old_size + in->gcount());
+  return in->gcount() > 0;
+}
+
+/// A chunk of the elements of a graph, read by libxml as a graph element of
+/// its own without copying the chunk
+struct ChunkInput {
+  std::array<std::string_view, 3> parts;
+  size_t part{0};
+  size_t offset{0};
+};
+
+int
+ReadChunk(void* context, char* buffer, int len) {
+  auto* input = static_cast<ChunkInput*>(context);
+  int read = 0;
+  while (read < len && input->part < input->parts.size()) {
+    std::string_view part = input->parts[input->part];
+    size_t n = std::min<size_t>(len - read, part.size() - input->offset);
+    std::memcpy(buffer + read, part.data() + input->offset, n);
+    read += n;
+    input->offset += n;
+    if (input->offset == part.size()) {
+      input->part += 1;
+      input->offset = 0;
+    }
+  }
+  return read;
+}
+
+katana::Result<void>
+ParseChunk(
+    std::string_view chunk, const GraphMLKeys& keys,
+    katana::ShardedPropertyGraphBuilder::Shard* shard, size_t file_offset,
+    const std::string& infilename) {
+  ChunkInput input{{"<graph>", chunk, "</graph>"}};
+  xmlTextReaderPtr reader =
+      xmlReaderForIO(ReadChunk, nullptr, &input, nullptr, nullptr, 0);
+  if (reader == NULL) {
+    return KATANA_ERROR(
+        katana::ErrorCode::OutOfMemory, "Unable to create an xml reader");
+  }
+
+  ShardSink sink{&keys, shard, katana::ResultSuccess()};
+  int ret = xmlTextReaderRead(reader);
+  if (ret == 1) {
+    ProcessGraph(reader, &sink, false);
+    ret = xmlTextReaderRead(reader);
+  }
+  while (ret == 1) {
+    ret = xmlTextReaderRead(reader);
+  }
+  xmlFreeTextReader(reader);
+  if (ret < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "Failed to parse {} in bytes [{}, {}), incorrect xml format",
+        infilename, file_offset, file_offset + chunk.size());
+  }
+  return sink.result;
+}
+
+/// Split the elements in window into a chunk per thread and parse the chunks
+/// into new shards of builder
+katana::Result<void>
+ParseWindow(
+    std::string_view window, const GraphMLKeys& keys,
+    katana::ShardedPropertyGraphBuilder* builder, size_t file_offset,
+    const std::string& infilename) {
+  size_t num_threads = katana::getActiveThreads();
+  std::vector<size_t> bounds{0};
+  for (size_t t = 1; t < num_threads; ++t) {
+    size_t pos = FindElementStart(
+        window, std::max(window.size() * t / num_threads, bounds.back() + 1));
+    if (pos == std::string_view::npos) {
+      break;
+    }
+    bounds.emplace_back(pos);
+  }
+  bounds.emplace_back(window.size());
+
+  size_t num_chunks = bounds.size() - 1;
+  size_t first_shard = builder->AddShards(num_chunks);
+  std::vector<katana::Result<void>> results(
+      num_chunks, katana::ResultSuccess());
+  katana::do_all(
+      katana::iterate(size_t{0}, num_chunks),
+      [&](size_t c) {
+        results[c] = ParseChunk(
+            window.substr(bounds[c], bounds[c + 1] - bounds[c]), keys,
+            builder->GetShard(first_shard + c), file_offset + bounds[c],
+            infilename);
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+  for (auto& res : results) {
+    if (!res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 }  // end of unnamed namespace
 
 katana::Result<katana::GraphComponents>
@@ -668,3 +1015,91 @@ katana::ConvertGraphML(
   }
   return builder.Finish(verbose);
 }
+
+katana::Result<katana::GraphComponents>
+katana::ConvertGraphMLParallel(
+    const std::string& infilename, size_t window_size, size_t chunk_size,
+    bool verbose) {
+  if (verbose) {
+    std::cout << "Start converting GraphML file in parallel: " << infilename
+              << "\n";
+  }
+  window_size = std::max<size_t>(window_size, 1);
+
+  GraphMLKeys keys = KATANA_CHECKED(ReadKeys(infilename));
+  if (verbose) {
+    std::cout << "Finished processing property headers\n";
+  }
+
+  // declare the keys in a shard before all others so that their columns
+  // exist, in order, as with ConvertGraphML
+  katana::ShardedPropertyGraphBuilder builder{1, chunk_size};
+  auto* keys_shard = builder.GetShard(0);
+  for (const PropertyKey& key : keys.nodes.keys) {
+    if (auto res =
+            keys_shard->DeclareNodeProperty(key.name, key.type, key.is_list);
+        !res) {
+      KATANA_LOG_WARN("ignoring key {}: {}", key.id, res.error());
+    }
+  }
+  for (const PropertyKey& key : keys.edges.keys) {
+    if (auto res =
+            keys_shard->DeclareEdgeProperty(key.name, key.type, key.is_list);
+        !res) {
+      KATANA_LOG_WARN("ignoring key {}: {}", key.id, res.error());
+    }
+  }
+
+  std::ifstream in(infilename, std::ios::binary);
+  if (!in) {
+    return KATANA_ERROR(ErrorCode::NotFound, "Unable to open {}", infilename);
+  }
+
+  // window holds file bytes [file_offset, file_offset + window.size())
+  std::string window;
+  size_t file_offset = 0;
+  size_t body;
+  while ((body = FindGraphBody(window)) == std::string::npos) {
+    if (!ReadMore(&in, &window, window_size)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "{} has no graph element", infilename);
+    }
+  }
+  window.erase(0, body);
+  file_offset += body;
+
+  // Cut the window before its last node or edge element, which may not have
+  // been read completely, and carry the rest over to the next window.
+  // Windows that hold a single element are grown until the element fits.
+  xmlInitParser();
+  size_t num_windows = 0;
+  bool finished_graph = false;
+  while (!finished_graph) {
+    bool more = ReadMore(&in, &window, window_size);
+    size_t end = window.find("</graph>");
+    if (end != std::string::npos) {
+      finished_graph = true;
+    } else if (!more) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Failed to parse {}, the graph element does not end", infilename);
+    } else {
+      end = FindLastElementStart(window);
+      if (end == std::string::npos) {
+        continue;
+      }
+    }
+
+    KATANA_CHECKED(ParseWindow(
+        std::string_view(window).substr(0, end), keys, &builder, file_offset,
+        infilename));
+    window.erase(0, end);
+    file_offset += end;
+    num_windows += 1;
+  }
+  if (verbose) {
+    std::cout << "Finished processing " << num_windows << " windows in "
+              << builder.num_shards() - 1 << " chunks\n";
+  }
+  return builder.Finish(verbose);
+}
@@ -1,9 +1,30 @@
 #include "katana/GraphTopology.h"
 
-#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <bitset>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Fingerprint.h"
+#include "katana/GraphHelpers.h"
 #include "katana/Logging.h"
+#include "katana/NodeOrdering.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+#include "katana/Threads.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/FileView.h"
 
 void
 katana::GraphTopology::Print() noexcept {
@@ -15,7 +36,11 @@ katana::GraphTopology::Print() noexcept {
     std::cout << "]" << std::endl;
   };
 
-  print_array(adj_indices_, "adj_indices_");
+  if (is_compact()) {
+    print_array(compact_adj_indices_, "compact_adj_indices_");
+  } else {
+    print_array(adj_indices_, "adj_indices_");
+  }
   print_array(dests_, "dests_");
 }
 
@@ -32,9 +57,291 @@ katana::GraphTopology::GraphTopology(
 
 katana::GraphTopology
 katana::GraphTopology::Copy(const GraphTopology& that) noexcept {
-  return katana::GraphTopology(
-      that.adj_indices_.data(), that.adj_indices_.size(), that.dests_.data(),
-      that.dests_.size());
+  if (!that.is_compact()) {
+    return katana::GraphTopology(
+        that.adj_indices_.data(), that.adj_indices_.size(), that.dests_.data(),
+        that.dests_.size());
+  }
+
+  GraphTopology ret;
+  ret.compact_adj_indices_.allocateInterleaved(that.num_nodes());
+  ret.dests_.allocateInterleaved(that.num_edges());
+  katana::ParallelSTL::copy(
+      that.compact_adj_indices_.begin(), that.compact_adj_indices_.end(),
+      ret.compact_adj_indices_.begin());
+  katana::ParallelSTL::copy(
+      that.dests_.begin(), that.dests_.end(), ret.dests_.begin());
+  return ret;
+}
+
+katana::GraphTopology
+katana::GraphTopology::ShareOrCopy(const GraphTopology& that) noexcept {
+  if (!that.is_out_of_core()) {
+    return Copy(that);
+  }
+  return Share(that, that.storage_);
+}
+
+katana::GraphTopology
+katana::GraphTopology::MakeShareable(GraphTopology&& that) noexcept {
+  if (that.is_out_of_core()) {
+    return std::move(that);
+  }
+  auto owner = std::make_shared<const GraphTopology>(std::move(that));
+  return Share(*owner, owner);
+}
+
+katana::GraphTopology
+katana::GraphTopology::Share(
+    const GraphTopology& that, std::shared_ptr<const void> storage) noexcept {
+  // As in MakeOutOfCore, the wrapping arrays neither free nor write the
+  // memory
+  GraphTopology topo;
+  if (that.is_compact()) {
+    topo.compact_adj_indices_ = NUMAArray<uint32_t>(
+        const_cast<uint32_t*>(that.compact_adj_indices_.data()),
+        that.compact_adj_indices_.size());
+  } else {
+    topo.adj_indices_ = NUMAArray<Edge>(
+        const_cast<Edge*>(that.adj_indices_.data()), that.adj_indices_.size());
+  }
+  topo.dests_ = NUMAArray<Node>(
+      const_cast<Node*>(that.dests_.data()), that.dests_.size());
+  topo.thread_ranges_ = that.thread_ranges_;
+  topo.storage_ = std::move(storage);
+  return topo;
+}
+
+void
+katana::GraphTopology::Compact() noexcept {
+  if (is_compact() || is_out_of_core() || adj_indices_.empty() ||
+      num_edges() > std::numeric_limits<uint32_t>::max()) {
+    return;
+  }
+
+  compact_adj_indices_.allocateInterleaved(adj_indices_.size());
+  katana::ParallelSTL::copy(
+      adj_indices_.begin(), adj_indices_.end(), compact_adj_indices_.begin());
+  adj_indices_ = NUMAArray<Edge>();
+  if (is_numa_partitioned()) {
+    PartitionForNUMA();
+  }
+}
+
+std::vector<uint32_t>
+katana::GraphTopology::ComputeThreadRanges() const noexcept {
+  uint32_t num_threads = katana::getActiveThreads();
+  std::vector<uint32_t> ranges(num_threads + 1, num_nodes());
+
+  auto divide = [&](const auto& adj_indices) {
+    for (uint32_t i = 0; i < num_threads; ++i) {
+      auto range = katana::divideNodesBinarySearch(
+          num_nodes(), num_edges(), 1, 1, i, num_threads, adj_indices);
+      ranges[i] = *range.first.first;
+    }
+  };
+  if (is_compact()) {
+    divide(compact_adj_indices_);
+  } else {
+    divide(adj_indices_);
+  }
+  return ranges;
+}
+
+void
+katana::GraphTopology::PartitionForNUMA() noexcept {
+  if (is_out_of_core() || num_nodes() == 0) {
+    return;
+  }
+
+  // allocateSpecified pages in each range from the thread that owns it, so
+  // the pages of a range are on the socket of its thread
+  std::vector<uint32_t> node_ranges = ComputeThreadRanges();
+  std::vector<uint64_t> edge_ranges(node_ranges.size());
+  for (size_t i = 0; i < node_ranges.size(); ++i) {
+    edge_ranges[i] = node_ranges[i] > 0 ? *edges(node_ranges[i] - 1).end() : 0;
+  }
+
+  auto place = [&](auto* array, auto& ranges) {
+    using Array = std::decay_t<decltype(*array)>;
+    if (array->empty()) {
+      return;
+    }
+    Array placed;
+    placed.allocateSpecified(array->size(), ranges);
+    katana::ParallelSTL::copy(array->begin(), array->end(), placed.begin());
+    *array = std::move(placed);
+  };
+  place(&adj_indices_, node_ranges);
+  place(&compact_adj_indices_, node_ranges);
+  place(&dests_, edge_ranges);
+
+  thread_ranges_ = std::move(node_ranges);
+}
+
+katana::SpecificRange<katana::GraphTopology::node_iterator>
+katana::GraphTopology::local_nodes() const noexcept {
+  if (thread_ranges_.size() == katana::getActiveThreads() + 1) {
+    return katana::MakeSpecificRange(begin(), end(), thread_ranges_);
+  }
+  return katana::MakeSpecificRange(begin(), end(), ComputeThreadRanges());
+}
+
+katana::NUMAArray<katana::GraphTopology::Edge>&
+katana::GraphTopology::GetAdjIndices() noexcept {
+  if (is_compact()) {
+    adj_indices_.allocateInterleaved(compact_adj_indices_.size());
+    katana::ParallelSTL::copy(
+        compact_adj_indices_.begin(), compact_adj_indices_.end(),
+        adj_indices_.begin());
+    compact_adj_indices_ = NUMAArray<uint32_t>();
+  }
+  return adj_indices_;
+}
+
+bool
+katana::GraphTopology::EqualAdjIndices(
+    const GraphTopology& that) const noexcept {
+  if (num_nodes() != that.num_nodes()) {
+    return false;
+  }
+  const GraphTopology& compact = is_compact() ? *this : that;
+  const GraphTopology& wide = is_compact() ? that : *this;
+  return katana::ParallelSTL::equal(
+      compact.compact_adj_indices_.begin(), compact.compact_adj_indices_.end(),
+      wide.adj_indices_.begin());
+}
+
+katana::Result<void>
+katana::GraphTopology::Validate() const {
+  constexpr uint64_t kNone = std::numeric_limits<uint64_t>::max();
+
+  katana::GReduceMin<uint64_t> bad_node;
+  katana::do_all(
+      katana::iterate(all_nodes()),
+      [&](Node n) {
+        Edge begin = *edges(n).begin();
+        Edge end = *edges(n).end();
+        if (end < begin || end > num_edges()) {
+          bad_node.update(n);
+        }
+      },
+      katana::no_stats());
+  if (uint64_t n = bad_node.reduce(); n != kNone) {
+    return KATANA_ERROR(
+        ErrorCode::AssertionFailed, "edges of node {} are [{}, {}) of {} edges",
+        n, *edges(n).begin(), *edges(n).end(), num_edges());
+  }
+  Edge last = num_nodes() == 0 ? 0 : *edges(num_nodes() - 1).end();
+  if (last != num_edges()) {
+    return KATANA_ERROR(
+        ErrorCode::AssertionFailed,
+        "edges of the nodes end at {} but there are {} edges", last,
+        num_edges());
+  }
+
+  katana::GReduceMin<uint64_t> bad_edge;
+  katana::do_all(
+      katana::iterate(all_edges()),
+      [&](Edge e) {
+        if (dests_[e] >= num_nodes()) {
+          bad_edge.update(e);
+        }
+      },
+      katana::no_stats());
+  if (uint64_t e = bad_edge.reduce(); e != kNone) {
+    return KATANA_ERROR(
+        ErrorCode::AssertionFailed,
+        "destination {} of edge {} is not one of the {} nodes", dests_[e], e,
+        num_nodes());
+  }
+
+  return katana::ResultSuccess();
+}
+
+uint64_t
+katana::GraphTopology::Fingerprint() const noexcept {
+  uint64_t offsets_hash = FingerprintBlocks(
+      num_nodes(), [&](uint64_t begin, uint64_t end, uint64_t seed) {
+        uint64_t hash = seed;
+        for (uint64_t n = begin; n < end; ++n) {
+          hash = FingerprintCombine(hash, *edges(n).end());
+        }
+        return hash;
+      });
+  uint64_t dests_hash = FingerprintBlocks(
+      num_edges(), [&](uint64_t begin, uint64_t end, uint64_t seed) {
+        uint64_t hash = seed;
+        for (uint64_t e = begin; e < end; ++e) {
+          hash = FingerprintCombine(hash, dests_[e]);
+        }
+        return hash;
+      });
+  return FingerprintCombine(offsets_hash, dests_hash);
+}
+
+katana::GraphTopology
+katana::GraphTopology::MakeOutOfCore(
+    const Edge* adj_indices, size_t num_nodes, const Node* dests,
+    size_t num_edges, std::shared_ptr<const void> storage) noexcept {
+  // The wrapping arrays neither free nor write the memory; topologies only
+  // hand out const references to their arrays
+  GraphTopology topo(
+      NUMAArray<Edge>(const_cast<Edge*>(adj_indices), num_nodes),
+      NUMAArray<Node>(const_cast<Node*>(dests), num_edges));
+  topo.storage_ = std::move(storage);
+  return topo;
+}
+
+namespace {
+
+void
+Advise(const void* begin, const void* end, int advice) {
+  if (begin >= end) {
+    return;
+  }
+  // madvise wants page aligned addresses
+  auto page_mask = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)) - 1;
+  auto aligned = reinterpret_cast<uintptr_t>(begin) & ~page_mask;
+  size_t size = reinterpret_cast<uintptr_t>(end) - aligned;
+  if (madvise(reinterpret_cast<void*>(aligned), size, advice) != 0) {
+    KATANA_LOG_DEBUG("madvise: {}", katana::ResultErrno().message());
+  }
+}
+
+}  // namespace
+
+void
+katana::GraphTopology::AdviseAccess(AccessPattern pattern) const noexcept {
+  // only wide topologies are mapped from files
+  if (!is_out_of_core() || is_compact()) {
+    return;
+  }
+  int advice = MADV_NORMAL;
+  switch (pattern) {
+  case AccessPattern::kSequential:
+    advice = MADV_SEQUENTIAL;
+    break;
+  case AccessPattern::kRandom:
+    advice = MADV_RANDOM;
+    break;
+  case AccessPattern::kNormal:
+    break;
+  }
+  Advise(adj_data(), adj_data() + num_nodes(), advice);
+  Advise(dest_data(), dest_data() + num_edges(), advice);
+}
+
+void
+katana::GraphTopology::PrefetchEdges(Node begin, Node end) const noexcept {
+  if (!is_out_of_core() || is_compact() || begin >= end) {
+    return;
+  }
+  KATANA_LOG_DEBUG_ASSERT(end <= num_nodes());
+  Advise(adj_data() + begin, adj_data() + end, MADV_WILLNEED);
+  Edge e_beg = begin > 0 ? adj_data()[begin - 1] : 0;
+  Edge e_end = adj_data()[end - 1];
+  Advise(dest_data() + e_beg, dest_data() + e_end, MADV_WILLNEED);
 }
 
 std::unique_ptr<katana::ShuffleTopology>
@@ -45,35 +352,238 @@ katana::ShuffleTopology::MakeFrom(
   return ret;
 }
 
-std::unique_ptr<katana::EdgeShuffleTopology>
-katana::EdgeShuffleTopology::MakeTransposeCopy(
-    const katana::PropertyGraph* pg) {
-  KATANA_LOG_DEBUG_ASSERT(pg);
+namespace {
+
+using TopoNode = katana::GraphTopologyTypes::Node;
+using TopoEdge = katana::GraphTopologyTypes::Edge;
+using TopoPropertyIndex = katana::GraphTopologyTypes::PropertyIndex;
+
+/// Destination blocks of a radix transpose have at least 2^14 nodes, whose
+/// counters fit in the L2 cache...
+constexpr uint32_t kTransposeMinBlockBits = 14;
+/// ...and there are at most this many, so that a chunk of sources scatters
+/// its edges to few places at a time
+constexpr uint64_t kTransposeMaxBlocks = 4096;
+/// Chunks of sources per thread, for load balance
+constexpr uint64_t kTransposeChunksPerThread = 4;
+
+/// \returns the source of edge e of topo, the first node whose edges end
+/// after e
+TopoNode
+EdgeSource(const katana::GraphTopology& topo, TopoEdge e) {
+  TopoNode lo = 0;
+  TopoNode hi = topo.num_nodes() - 1;
+  while (lo < hi) {
+    TopoNode mid = lo + (hi - lo) / 2;
+    if (*topo.edges(mid).end() > e) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
 
-  const auto& topology = pg->topology();
-  if (topology.empty()) {
-    EdgeShuffleTopology et;
-    et.tpose_state_ = TransposeKind::kYes;
-    return std::make_unique<EdgeShuffleTopology>(std::move(et));
+/// \returns the bytes of memory that are free, or the maximum if unknown
+uint64_t
+AvailableMemory() {
+#ifdef _SC_AVPHYS_PAGES
+  long pages = sysconf(_SC_AVPHYS_PAGES);
+  long page_size = sysconf(_SC_PAGESIZE);
+  if (pages > 0 && page_size > 0) {
+    return static_cast<uint64_t>(pages) * static_cast<uint64_t>(page_size);
   }
+#endif
+  return std::numeric_limits<uint64_t>::max();
+}
 
-  GraphTopologyTypes::AdjIndexVec out_indices;
-  GraphTopologyTypes::EdgeDestVec out_dests;
-  GraphTopologyTypes::PropIndexVec edge_prop_indices;
-  GraphTopologyTypes::AdjIndexVec out_dests_offset;
+/// EdgeShuffleTopology::TransposeAlgorithm::kRadix for a non-empty topology
+class RadixTranspose {
+public:
+  explicit RadixTranspose(const katana::GraphTopology& topo) : topo_(topo) {
+    uint64_t max_node = topo.num_nodes() - 1;
+    block_bits_ = kTransposeMinBlockBits;
+    while ((max_node >> block_bits_) + 1 > kTransposeMaxBlocks) {
+      ++block_bits_;
+    }
+    num_blocks_ = (max_node >> block_bits_) + 1;
+
+    // chunks of about the same number of edges
+    uint64_t num_edges = topo.num_edges();
+    num_chunks_ = std::max<uint64_t>(
+        1, std::min<uint64_t>(
+               num_edges,
+               katana::getActiveThreads() * kTransposeChunksPerThread));
+    chunk_begins_.resize(num_chunks_ + 1);
+    chunk_begins_[0] = 0;
+    chunk_begins_[num_chunks_] = topo.num_nodes();
+    for (uint64_t c = 1; c < num_chunks_; ++c) {
+      chunk_begins_[c] = EdgeSource(topo, c * num_edges / num_chunks_);
+    }
+  }
 
-  out_indices.allocateInterleaved(topology.num_nodes());
-  out_dests.allocateInterleaved(topology.num_edges());
-  edge_prop_indices.allocateInterleaved(topology.num_edges());
+  /// Count the edges of each chunk by destination block and turn the
+  /// counts into where each chunk scatters to in each block: block b holds
+  /// the edges into it of chunk 0, then those of chunk 1 and so on
+  void Count() {
+    counts_.assign(num_chunks_ * num_blocks_, 0);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_chunks_),
+        [&](uint64_t c) {
+          TopoEdge* counts = &counts_[c * num_blocks_];
+          for (TopoNode n = chunk_begins_[c]; n < chunk_begins_[c + 1]; ++n) {
+            for (TopoEdge e : topo_.edges(n)) {
+              ++counts[topo_.edge_dest(e) >> block_bits_];
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+    block_begins_.resize(num_blocks_ + 1);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_blocks_),
+        [&](uint64_t b) {
+          TopoEdge size = 0;
+          for (uint64_t c = 0; c < num_chunks_; ++c) {
+            std::swap(size, counts_[c * num_blocks_ + b]);
+            size += counts_[c * num_blocks_ + b];
+          }
+          block_begins_[b + 1] = size;
+        },
+        katana::no_stats());
+
+    block_begins_[0] = 0;
+    max_block_edges_ = 0;
+    for (uint64_t b = 0; b < num_blocks_; ++b) {
+      max_block_edges_ = std::max(max_block_edges_, block_begins_[b + 1]);
+      block_begins_[b + 1] += block_begins_[b];
+    }
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_blocks_),
+        [&](uint64_t b) {
+          for (uint64_t c = 0; c < num_chunks_; ++c) {
+            counts_[c * num_blocks_ + b] += block_begins_[b];
+          }
+        },
+        katana::no_stats());
+  }
+
+  /// The bytes of scratch memory Scatter needs beyond the transpose
+  uint64_t ScratchBytes() const {
+    uint64_t per_thread =
+        max_block_edges_ *
+            (2 * sizeof(TopoNode) + sizeof(TopoPropertyIndex)) +
+        (uint64_t{1} << block_bits_) * sizeof(TopoEdge);
+    return std::min<uint64_t>(katana::getActiveThreads(), num_blocks_) *
+           per_thread;
+  }
+
+  /// Write the transpose, after Count
+  void Scatter(
+      katana::GraphTopologyTypes::AdjIndexVec* out_indices,
+      katana::GraphTopologyTypes::EdgeDestVec* out_dests,
+      katana::GraphTopologyTypes::PropIndexVec* edge_prop_indices) {
+    // to the slice of each chunk in their block, in the order of the edges
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_chunks_),
+        [&](uint64_t c) {
+          TopoEdge* cursors = &counts_[c * num_blocks_];
+          for (TopoNode n = chunk_begins_[c]; n < chunk_begins_[c + 1]; ++n) {
+            for (TopoEdge e : topo_.edges(n)) {
+              TopoEdge pos = cursors[topo_.edge_dest(e) >> block_bits_]++;
+              (*out_dests)[pos] = n;
+              (*edge_prop_indices)[pos] = e;
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+    // a stable counting sort of each block by destination, whose counters
+    // stay in cache
+    struct Scratch {
+      std::vector<TopoNode> srcs;
+      std::vector<TopoNode> dests;
+      std::vector<TopoPropertyIndex> props;
+      std::vector<TopoEdge> cursors;
+    };
+    katana::PerThreadStorage<Scratch> scratch;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_blocks_),
+        [&](uint64_t b) {
+          Scratch& local = *scratch.getLocal();
+          TopoEdge begin = block_begins_[b];
+          TopoEdge end = block_begins_[b + 1];
+          TopoNode node_begin = b << block_bits_;
+          TopoNode node_end = std::min<uint64_t>(
+              topo_.num_nodes(), (b + 1) << block_bits_);
+
+          local.srcs.assign(
+              out_dests->begin() + begin, out_dests->begin() + end);
+          local.props.assign(
+              edge_prop_indices->begin() + begin,
+              edge_prop_indices->begin() + end);
+          local.dests.resize(end - begin);
+          local.cursors.assign(node_end - node_begin, 0);
+          for (size_t i = 0; i < local.props.size(); ++i) {
+            TopoNode dest = topo_.edge_dest(local.props[i]) - node_begin;
+            local.dests[i] = dest;
+            ++local.cursors[dest];
+          }
+          TopoEdge pos = begin;
+          for (TopoEdge& cursor : local.cursors) {
+            std::swap(pos, cursor);
+            pos += cursor;
+          }
+          for (size_t i = 0; i < local.props.size(); ++i) {
+            TopoEdge e_new = local.cursors[local.dests[i]]++;
+            (*out_dests)[e_new] = local.srcs[i];
+            (*edge_prop_indices)[e_new] = local.props[i];
+          }
+          // each cursor is now at the end of the in-edges of its node
+          std::copy(
+              local.cursors.begin(), local.cursors.end(),
+              out_indices->begin() + node_begin);
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+  }
+
+private:
+  const katana::GraphTopology& topo_;
+  uint32_t block_bits_{0};
+  uint64_t num_blocks_{0};
+  uint64_t num_chunks_{0};
+  /// chunk c is the sources [chunk_begins_[c], chunk_begins_[c + 1])
+  std::vector<TopoNode> chunk_begins_;
+  /// counts_[c * num_blocks_ + b] is for chunk c and block b
+  std::vector<TopoEdge> counts_;
+  /// the in-edges of block b are [block_begins_[b], block_begins_[b + 1])
+  std::vector<TopoEdge> block_begins_;
+  TopoEdge max_block_edges_{0};
+};
+
+/// EdgeShuffleTopology::TransposeAlgorithm::kLowMemory for a non-empty
+/// topology
+void
+LowMemoryTranspose(
+    const katana::GraphTopology& topology,
+    katana::GraphTopologyTypes::AdjIndexVec* out_indices_ptr,
+    katana::GraphTopologyTypes::EdgeDestVec* out_dests_ptr,
+    katana::GraphTopologyTypes::PropIndexVec* edge_prop_indices_ptr) {
+  auto& out_indices = *out_indices_ptr;
+  auto& out_dests = *out_dests_ptr;
+  auto& edge_prop_indices = *edge_prop_indices_ptr;
+
+  katana::GraphTopologyTypes::AdjIndexVec out_dests_offset;
   out_dests_offset.allocateInterleaved(topology.num_nodes());
 
-  katana::ParallelSTL::fill(out_indices.begin(), out_indices.end(), Edge{0});
+  katana::ParallelSTL::fill(
+      out_indices.begin(), out_indices.end(), TopoEdge{0});
 
   // Keep a copy of old destinaton ids and compute number of
   // in-coming edges for the new prefix sum of out_indices.
   katana::do_all(
       katana::iterate(topology.all_edges()),
-      [&](Edge e) {
+      [&](TopoEdge e) {
         // Counting outgoing edges in the tranpose graph by
         // counting incoming edges in the original graph
         auto dest = topology.edge_dest(e);
@@ -89,8 +599,8 @@ katana::EdgeShuffleTopology::MakeTransposeCopy(
   // adjacency
   out_dests_offset[0] = 0;
   katana::do_all(
-      katana::iterate(Edge{1}, Edge{topology.num_nodes()}),
-      [&](Edge n) { out_dests_offset[n] = out_indices[n - 1]; },
+      katana::iterate(TopoEdge{1}, TopoEdge{topology.num_nodes()}),
+      [&](TopoEdge n) { out_dests_offset[n] = out_indices[n - 1]; },
       katana::no_stats());
 
   // Update out_dests with the new destination ids
@@ -100,7 +610,7 @@ katana::EdgeShuffleTopology::MakeTransposeCopy(
       [&](auto src) {
         // get all outgoing edges of a particular
         // node and reverse the edges.
-        for (GraphTopology::Edge e : topology.edges(src)) {
+        for (TopoEdge e : topology.edges(src)) {
           // e = start index into edge array for a particular node
           // Destination node
           auto dest = topology.edge_dest(e);
@@ -114,6 +624,62 @@ katana::EdgeShuffleTopology::MakeTransposeCopy(
       },
       katana::steal(), katana::no_stats());
 
+  // Put the in-edges of each node in the order of the edges they transpose,
+  // as the radix transpose does, without scratch memory
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](TopoNode n) {
+        TopoEdge first = n > 0 ? out_indices[n - 1] : 0;
+        auto begin = edge_prop_indices.begin() + first;
+        auto end = edge_prop_indices.begin() + out_indices[n];
+        if (std::is_sorted(begin, end)) {
+          return;
+        }
+        std::sort(begin, end);
+        for (TopoEdge e_new = first; e_new < out_indices[n]; ++e_new) {
+          out_dests[e_new] = EdgeSource(topology, edge_prop_indices[e_new]);
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+}  // namespace
+
+std::unique_ptr<katana::EdgeShuffleTopology>
+katana::EdgeShuffleTopology::MakeTransposeCopy(
+    const katana::PropertyGraph* pg, TransposeAlgorithm algo) {
+  KATANA_LOG_DEBUG_ASSERT(pg);
+
+  const auto& topology = pg->topology();
+  if (topology.empty()) {
+    EdgeShuffleTopology et;
+    et.tpose_state_ = TransposeKind::kYes;
+    return std::make_unique<EdgeShuffleTopology>(std::move(et));
+  }
+
+  GraphTopologyTypes::AdjIndexVec out_indices;
+  GraphTopologyTypes::EdgeDestVec out_dests;
+  GraphTopologyTypes::PropIndexVec edge_prop_indices;
+
+  out_indices.allocateInterleaved(topology.num_nodes());
+  out_dests.allocateInterleaved(topology.num_edges());
+  edge_prop_indices.allocateInterleaved(topology.num_edges());
+
+  bool done = false;
+  if (algo != TransposeAlgorithm::kLowMemory) {
+    RadixTranspose radix(topology);
+    radix.Count();
+    // leave half of the free memory for whatever runs next
+    if (algo == TransposeAlgorithm::kRadix ||
+        radix.ScratchBytes() <= AvailableMemory() / 2) {
+      radix.Scatter(&out_indices, &out_dests, &edge_prop_indices);
+      done = true;
+    }
+  }
+  if (!done) {
+    LowMemoryTranspose(topology, &out_indices, &out_dests, &edge_prop_indices);
+  }
+
   return std::make_unique<EdgeShuffleTopology>(EdgeShuffleTopology{
       TransposeKind::kYes, EdgeSortKind::kAny, std::move(out_indices),
       std::move(out_dests), std::move(edge_prop_indices)});
@@ -231,54 +797,53 @@ katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
   edge_sort_state_ = EdgeSortKind::kSortedByDestID;
 }
 
+void
+katana::EdgeShuffleTopology::SortNodeEdgesByTypeThenDest(
+    const PropertyGraph* pg, Node node) noexcept {
+  // get this node's first and last edge
+  auto e_beg = *Base::edges(node).begin();
+  auto e_end = *Base::edges(node).end();
+
+  // get iterators to locations to sort in the vector
+  auto begin_sort_iter = katana::make_zip_iterator(
+      edge_prop_indices_.begin() + e_beg, Base::GetDests().begin() + e_beg);
+
+  auto end_sort_iter = katana::make_zip_iterator(
+      edge_prop_indices_.begin() + e_end, Base::GetDests().begin() + e_end);
+
+  // rearrange vector indices based on how the destinations of this
+  // graph will eventually be sorted sort function not based on vector
+  // being passed, but rather the type and destination of the graph
+  std::sort(
+      begin_sort_iter, end_sort_iter, [&](const auto& tup1, const auto& tup2) {
+        // get edge type and destinations
+        auto e1 = std::get<0>(tup1);
+        auto e2 = std::get<0>(tup2);
+        static_assert(
+            std::is_same_v<decltype(e1), GraphTopology::PropertyIndex>);
+        static_assert(
+            std::is_same_v<decltype(e2), GraphTopology::PropertyIndex>);
+
+        EntityType data1 = pg->GetTypeOfEdge(e1);
+        EntityType data2 = pg->GetTypeOfEdge(e2);
+        if (data1 != data2) {
+          return data1 < data2;
+        }
+
+        auto dst1 = std::get<1>(tup1);
+        auto dst2 = std::get<1>(tup2);
+        static_assert(std::is_same_v<decltype(dst1), GraphTopology::Node>);
+        static_assert(std::is_same_v<decltype(dst2), GraphTopology::Node>);
+        return dst1 < dst2;
+      });
+}
+
 void
 katana::EdgeShuffleTopology::SortEdgesByTypeThenDest(
     const PropertyGraph* pg) noexcept {
   katana::do_all(
       katana::iterate(Base::all_nodes()),
-      [&](Node node) {
-        // get this node's first and last edge
-        auto e_beg = *Base::edges(node).begin();
-        auto e_end = *Base::edges(node).end();
-
-        // get iterators to locations to sort in the vector
-        auto begin_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_beg,
-            Base::GetDests().begin() + e_beg);
-
-        auto end_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_end,
-            Base::GetDests().begin() + e_end);
-
-        // rearrange vector indices based on how the destinations of this
-        // graph will eventually be sorted sort function not based on vector
-        // being passed, but rather the type and destination of the graph
-        std::sort(
-            begin_sort_iter, end_sort_iter,
-            [&](const auto& tup1, const auto& tup2) {
-              // get edge type and destinations
-              auto e1 = std::get<0>(tup1);
-              auto e2 = std::get<0>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(e1), GraphTopology::PropertyIndex>);
-              static_assert(
-                  std::is_same_v<decltype(e2), GraphTopology::PropertyIndex>);
-
-              EntityType data1 = pg->GetTypeOfEdge(e1);
-              EntityType data2 = pg->GetTypeOfEdge(e2);
-              if (data1 != data2) {
-                return data1 < data2;
-              }
-
-              auto dst1 = std::get<1>(tup1);
-              auto dst2 = std::get<1>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(dst1), GraphTopology::Node>);
-              static_assert(
-                  std::is_same_v<decltype(dst2), GraphTopology::Node>);
-              return dst1 < dst2;
-            });
-      },
+      [&](Node node) { SortNodeEdgesByTypeThenDest(pg, node); },
       katana::steal(), katana::no_stats());
 
   // remember to update sort state
@@ -292,6 +857,92 @@ katana::EdgeShuffleTopology::SortEdgesByDestType(
   KATANA_LOG_FATAL("Not implemented yet");
 }
 
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeFromNodeOrder(
+    const katana::EdgeShuffleTopology& seed_topo,
+    PropIndexVec&& node_prop_indices,
+    const NodeSortKind& node_sort_todo) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(node_prop_indices.size() == seed_topo.num_nodes());
+
+  GraphTopology::AdjIndexVec degrees;
+  degrees.allocateInterleaved(seed_topo.num_nodes());
+
+  katana::NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
+  old_to_new_map.allocateInterleaved(seed_topo.num_nodes());
+  // TODO(amber): given 32-bit node ids, put a check here that
+  // node_prop_indices.size() < 2^32
+  katana::do_all(
+      katana::iterate(size_t{0}, node_prop_indices.size()),
+      [&](auto i) {
+        // node_prop_indices[i] gives old node id
+        old_to_new_map[node_prop_indices[i]] = i;
+        degrees[i] = seed_topo.degree(node_prop_indices[i]);
+      },
+      katana::no_stats());
+
+  KATANA_LOG_DEBUG_ASSERT(
+      node_sort_todo != NodeSortKind::kSortedByDegree ||
+      std::is_sorted(degrees.begin(), degrees.end()));
+
+  katana::ParallelSTL::partial_sum(
+      degrees.begin(), degrees.end(), degrees.begin());
+
+  GraphTopologyTypes::EdgeDestVec new_dest_vec;
+  new_dest_vec.allocateInterleaved(seed_topo.num_edges());
+
+  GraphTopologyTypes::PropIndexVec edge_prop_indices;
+  edge_prop_indices.allocateInterleaved(seed_topo.num_edges());
+
+  katana::do_all(
+      katana::iterate(seed_topo.all_nodes()),
+      [&](auto old_srd_id) {
+        auto new_srd_id = old_to_new_map[old_srd_id];
+        auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
+
+        for (auto e : seed_topo.edges(old_srd_id)) {
+          auto new_edge_dest = old_to_new_map[seed_topo.edge_dest(e)];
+
+          auto new_edge_id = new_out_index;
+          ++new_out_index;
+          KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
+
+          new_dest_vec[new_edge_id] = new_edge_dest;
+
+          // copy over edge_property_index mapping from old edge to new edge
+          edge_prop_indices[new_edge_id] = seed_topo.edge_property_index(e);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return std::make_unique<ShuffleTopology>(ShuffleTopology{
+      seed_topo.transpose_state(), node_sort_todo,
+      seed_topo.edge_sort_state(), std::move(degrees),
+      std::move(node_prop_indices), std::move(new_dest_vec),
+      std::move(edge_prop_indices)});
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeReordered(
+    const PropertyGraph*, const katana::EdgeShuffleTopology& seed_topo,
+    const NodeSortKind& node_sort_todo) noexcept {
+  PropIndexVec node_prop_indices;
+  switch (node_sort_todo) {
+  case NodeSortKind::kReverseCuthillMcKee:
+    node_prop_indices = ReverseCuthillMcKeeOrder(seed_topo);
+    break;
+  case NodeSortKind::kGorder:
+    node_prop_indices = GorderOrder(seed_topo);
+    break;
+  case NodeSortKind::kRabbitOrder:
+    node_prop_indices = RabbitOrder(seed_topo);
+    break;
+  default:
+    KATANA_LOG_FATAL("not a reordering: {}", static_cast<int>(node_sort_todo));
+  }
+  return MakeFromNodeOrder(
+      seed_topo, std::move(node_prop_indices), node_sort_todo);
+}
+
 std::unique_ptr<katana::ShuffleTopology>
 katana::ShuffleTopology::MakeSortedByDegree(
     const PropertyGraph*,
@@ -330,41 +981,33 @@ katana::CondensedTypeIDMap::MakeFromEdgeTypes(
   TypeIDToIndexMap edge_type_to_index;
   IndexToTypeIDMap edge_index_to_type;
 
-  katana::PerThreadStorage<katana::gstl::Set<EntityType>> edgeTypes;
+  // EntityType has 8 bits, so a bitset of all of its values records the
+  // types that occur without allocating or hashing per edge
+  using EntityTypeSet =
+      std::bitset<size_t{std::numeric_limits<EntityType>::max()} + 1>;
+  katana::PerThreadStorage<EntityTypeSet> edge_types;
 
   const auto& topo = pg->topology();
 
   katana::do_all(
       katana::iterate(Edge{0}, topo.num_edges()),
-      [&](const Edge& e) {
-        EntityType type = pg->GetTypeOfEdge(e);
-        edgeTypes.getLocal()->insert(type);
-      },
+      [&](const Edge& e) { edge_types.getLocal()->set(pg->GetTypeOfEdge(e)); },
       katana::no_stats());
 
-  // ordered map
-  std::set<EntityType> mergedSet;
-  for (uint32_t i = 0; i < katana::activeThreads; ++i) {
-    auto& edgeTypesSet = *edgeTypes.getRemote(i);
-    for (auto edgeType : edgeTypesSet) {
-      mergedSet.insert(edgeType);
-    }
+  EntityTypeSet merged;
+  for (unsigned i = 0; i < edge_types.size(); ++i) {
+    merged |= *edge_types.getRemote(i);
   }
 
-  // unordered map
+  // indices in increasing order of type
   uint32_t num_edge_types = 0u;
-  for (const auto& edgeType : mergedSet) {
-    edge_type_to_index[edgeType] = num_edge_types++;
-    edge_index_to_type.emplace_back(edgeType);
+  for (size_t type = 0; type < merged.size(); ++type) {
+    if (merged.test(type)) {
+      edge_type_to_index[type] = num_edge_types++;
+      edge_index_to_type.emplace_back(type);
+    }
   }
 
-  // TODO(amber): introduce a per-thread-container type that frees memory
-  // correctly
-  katana::on_each([&](unsigned, unsigned) {
-    // free up memory by resetting
-    *edgeTypes.getLocal() = gstl::Set<EntityType>();
-  });
-
   return std::make_unique<CondensedTypeIDMap>(CondensedTypeIDMap{
       std::move(edge_type_to_index), std::move(edge_index_to_type)});
 }
@@ -393,28 +1036,135 @@ katana::EdgeTypeAwareTopology::CreatePerEdgeTypeAdjacencyIndex(
   katana::do_all(
       katana::iterate(e_topo->all_nodes()),
       [&](Node N) {
-        auto offset = N * edge_type_index->num_unique_types();
-        uint32_t index = 0;
+        FillPerEdgeTypeAdjacencyIndex(
+            pg, edge_type_index, e_topo, N, &adj_indices);
+      },
+      katana::no_stats(), katana::steal());
+
+  return adj_indices;
+}
+
+void
+katana::EdgeTypeAwareTopology::FillPerEdgeTypeAdjacencyIndex(
+    const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
+    const EdgeShuffleTopology* e_topo, Node N,
+    AdjIndexVec* adj_indices) noexcept {
+  auto offset = N * edge_type_index->num_unique_types();
+  uint32_t index = 0;
+  for (auto e : e_topo->edges(N)) {
+    // Since we sort the edges, we must use the
+    // edge_property_index because EdgeShuffleTopology rearranges the edges
+    const auto type = pg->GetTypeOfEdge(e_topo->edge_property_index(e));
+    while (type != edge_type_index->GetType(index)) {
+      (*adj_indices)[offset + index] = e;
+      index++;
+      KATANA_LOG_DEBUG_ASSERT(index < edge_type_index->num_unique_types());
+    }
+  }
+  auto e = *e_topo->edges(N).end();
+  while (index < edge_type_index->num_unique_types()) {
+    (*adj_indices)[offset + index] = e;
+    index++;
+  }
+}
+
+namespace {
+
+/// With this few edge types the dense per type index is always used
+constexpr size_t kDenseTypeIndexMaxTypes = 2;
+
+}  // namespace
+
+bool
+katana::EdgeTypeAwareTopology::BuildTypeIndex(
+    const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
+    const EdgeShuffleTopology* e_topo, AdjIndexVec* dense,
+    SparseTypeIndex* sparse) noexcept {
+  const size_t num_nodes = e_topo->num_nodes();
+  const size_t num_types = edge_type_index->num_unique_types();
+  if (num_nodes == 0 || num_types <= kDenseTypeIndexMaxTypes) {
+    *dense = CreatePerEdgeTypeAdjacencyIndex(pg, edge_type_index, e_topo);
+    return false;
+  }
+
+  // count the runs of edges of the same type of each node
+  AdjIndexVec node_runs;
+  node_runs.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(e_topo->all_nodes()),
+      [&](Node N) {
+        uint64_t num_runs = 0;
+        EntityType prev = 0;
         for (auto e : e_topo->edges(N)) {
-          // Since we sort the edges, we must use the
-          // edge_property_index because EdgeShuffleTopology rearranges the edges
           const auto type = pg->GetTypeOfEdge(e_topo->edge_property_index(e));
-          while (type != edge_type_index->GetType(index)) {
-            adj_indices[offset + index] = e;
-            index++;
-            KATANA_LOG_DEBUG_ASSERT(
-                index < edge_type_index->num_unique_types());
+          if (num_runs == 0 || type != prev) {
+            ++num_runs;
+            prev = type;
           }
         }
-        auto e = *e_topo->edges(N).end();
-        while (index < edge_type_index->num_unique_types()) {
-          adj_indices[offset + index] = e;
-          index++;
+        node_runs[N] = num_runs;
+      },
+      katana::no_stats(), katana::steal());
+  katana::ParallelSTL::partial_sum(
+      node_runs.begin(), node_runs.end(), node_runs.begin());
+
+  // Searching the runs of a node is slower than looking up an entry, so the
+  // sparse index has to save most of the space to be used
+  const uint64_t num_runs = node_runs[num_nodes - 1];
+  const size_t dense_bytes = num_nodes * num_types * sizeof(Edge);
+  const size_t sparse_bytes = num_nodes * sizeof(Edge) +
+                              num_runs * (sizeof(uint32_t) + sizeof(Edge));
+  if (2 * sparse_bytes > dense_bytes) {
+    *dense = CreatePerEdgeTypeAdjacencyIndex(pg, edge_type_index, e_topo);
+    return false;
+  }
+
+  *sparse = CreateSparseTypeIndex(
+      pg, edge_type_index, e_topo, std::move(node_runs));
+  return true;
+}
+
+katana::EdgeTypeAwareTopology::SparseTypeIndex
+katana::EdgeTypeAwareTopology::CreateSparseTypeIndex(
+    const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
+    const EdgeShuffleTopology* e_topo, AdjIndexVec&& node_runs) noexcept {
+  SparseTypeIndex index;
+  index.node_runs = std::move(node_runs);
+  const uint64_t num_runs =
+      index.node_runs.empty() ? 0 : index.node_runs[e_topo->num_nodes() - 1];
+  index.run_types.allocateInterleaved(num_runs);
+  index.run_ends.allocateInterleaved(num_runs);
+
+  katana::do_all(
+      katana::iterate(e_topo->all_nodes()),
+      [&](Node N) {
+        uint64_t r = (N == 0) ? 0 : index.node_runs[N - 1];
+        bool in_run = false;
+        uint32_t type_index = 0;
+        for (auto e : e_topo->edges(N)) {
+          // Since we sort the edges, we must use the
+          // edge_property_index because EdgeShuffleTopology rearranges the
+          // edges
+          const uint32_t idx = edge_type_index->GetIndex(
+              pg->GetTypeOfEdge(e_topo->edge_property_index(e)));
+          if (in_run && idx == type_index) {
+            continue;
+          }
+          if (in_run) {
+            index.run_ends[r++] = e;
+          }
+          index.run_types[r] = idx;
+          type_index = idx;
+          in_run = true;
+        }
+        if (in_run) {
+          index.run_ends[r++] = *e_topo->edges(N).end();
         }
+        KATANA_LOG_DEBUG_ASSERT(r == index.node_runs[N]);
       },
       katana::no_stats(), katana::steal());
 
-  return adj_indices;
+  return index;
 }
 
 std::unique_ptr<katana::EdgeTypeAwareTopology>
@@ -427,11 +1177,14 @@ katana::EdgeTypeAwareTopology::MakeFrom(
 
   KATANA_LOG_DEBUG_ASSERT(e_topo->num_edges() == pg->topology().num_edges());
 
-  AdjIndexVec per_type_adj_indices =
-      CreatePerEdgeTypeAdjacencyIndex(pg, edge_type_index, e_topo);
+  AdjIndexVec per_type_adj_indices;
+  SparseTypeIndex sparse_index;
+  bool sparse = BuildTypeIndex(
+      pg, edge_type_index, e_topo, &per_type_adj_indices, &sparse_index);
 
   return std::make_unique<EdgeTypeAwareTopology>(EdgeTypeAwareTopology{
-      pg, edge_type_index, e_topo, std::move(per_type_adj_indices)});
+      pg, edge_type_index, e_topo, std::move(per_type_adj_indices), sparse,
+      std::move(sparse_index)});
 }
 
 const katana::GraphTopology*
@@ -440,6 +1193,16 @@ katana::PGViewCache::GetOriginalTopology(
   return &pg->topology();
 }
 
+const katana::TopologyStatistics&
+katana::PGViewCache::GetTopologyStatistics(const PropertyGraph* pg) noexcept {
+  std::lock_guard<std::mutex> lock(*topology_statistics_mutex_);
+  if (!topology_statistics_) {
+    topology_statistics_ =
+        TopologyStatistics::Compute(*GetOriginalTopology(pg));
+  }
+  return *topology_statistics_;
+}
+
 katana::CondensedTypeIDMap*
 katana::PGViewCache::BuildOrGetEdgeTypeIndex(
     const katana::PropertyGraph* pg) noexcept {
@@ -459,6 +1222,251 @@ CheckTopology(const katana::PropertyGraph* pg, const Topo* t) noexcept {
          (pg->num_edges() == t->num_edges());
 }
 
+namespace {
+
+constexpr uint64_t kViewTopologyMagic = UINT64_C(0x4b41544156494557);
+/// Stored topologies of other versions are ignored and built again
+constexpr uint32_t kViewTopologyFormatVersion = 1;
+/// node_sort_state of an EdgeShuffleTopology, which keeps the node order
+constexpr int32_t kNoNodeSort = -1;
+
+/// Header of a view topology stored with the RDG. It is followed by the
+/// adjacency indices, the edge destinations padded to a multiple of 8 bytes,
+/// the edge property indices and, for a ShuffleTopology, the node property
+/// indices.
+struct ViewTopologyHeader {
+  uint64_t magic{kViewTopologyMagic};
+  uint32_t format_version{kViewTopologyFormatVersion};
+  int32_t transpose_state{0};
+  int32_t edge_sort_state{0};
+  int32_t node_sort_state{kNoNodeSort};
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  /// TypeFingerprint of the graph the topology was built from
+  uint64_t type_fingerprint{0};
+
+  bool operator==(const ViewTopologyHeader& other) const {
+    return magic == other.magic && format_version == other.format_version &&
+           transpose_state == other.transpose_state &&
+           edge_sort_state == other.edge_sort_state &&
+           node_sort_state == other.node_sort_state &&
+           num_nodes == other.num_nodes && num_edges == other.num_edges &&
+           type_fingerprint == other.type_fingerprint;
+  }
+};
+
+uint64_t
+Mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+/// \returns a hash of the entity types that a topology sorted by
+/// \param edge_sort and \param node_sort depends on, or 0 if it depends on
+/// none; topologies stored for other types are stale
+uint64_t
+TypeFingerprint(
+    const katana::PropertyGraph* pg,
+    katana::EdgeShuffleTopology::EdgeSortKind edge_sort,
+    int32_t node_sort) {
+  using katana::EdgeShuffleTopology;
+  using katana::ShuffleTopology;
+
+  katana::GAccumulator<uint64_t> hash;
+  if (edge_sort == EdgeShuffleTopology::EdgeSortKind::kSortedByEdgeType) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, pg->num_edges()),
+        [&](uint64_t e) { hash += Mix((e << 8) ^ pg->GetTypeOfEdge(e)); },
+        katana::no_stats());
+  }
+  if (node_sort ==
+      static_cast<int32_t>(ShuffleTopology::NodeSortKind::kSortedByNodeType)) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, pg->num_nodes()),
+        [&](uint64_t n) {
+          hash += Mix(~((n << 8) ^ pg->GetTypeOfNode(n)));
+        },
+        katana::no_stats());
+  }
+  return hash.reduce();
+}
+
+/// \returns the header of a view topology of \param pg without its
+/// type_fingerprint, which is expensive to compute
+ViewTopologyHeader
+MakeViewTopologyHeader(
+    const katana::PropertyGraph* pg,
+    katana::EdgeShuffleTopology::TransposeKind tpose_kind,
+    katana::EdgeShuffleTopology::EdgeSortKind edge_sort, int32_t node_sort) {
+  return ViewTopologyHeader{
+      .transpose_state = static_cast<int32_t>(tpose_kind),
+      .edge_sort_state = static_cast<int32_t>(edge_sort),
+      .node_sort_state = node_sort,
+      .num_nodes = pg->num_nodes(),
+      .num_edges = pg->num_edges(),
+  };
+}
+
+void
+SetTypeFingerprint(
+    const katana::PropertyGraph* pg, ViewTopologyHeader* header) {
+  header->type_fingerprint = TypeFingerprint(
+      pg,
+      static_cast<katana::EdgeShuffleTopology::EdgeSortKind>(
+          header->edge_sort_state),
+      header->node_sort_state);
+}
+
+std::string
+ViewTopologyKey(const ViewTopologyHeader& header) {
+  if (header.node_sort_state == kNoNodeSort) {
+    return fmt::format(
+        "edge_shuffle-t{}-e{}", header.transpose_state,
+        header.edge_sort_state);
+  }
+  return fmt::format(
+      "shuffle-t{}-n{}-e{}", header.transpose_state, header.node_sort_state,
+      header.edge_sort_state);
+}
+
+uint64_t
+DestsBytes(uint64_t num_edges) {
+  uint64_t bytes = num_edges * sizeof(katana::GraphTopologyTypes::Node);
+  return (bytes + 7) & ~UINT64_C(7);
+}
+
+katana::Result<void>
+WriteBytes(tsuba::FileFrame* ff, const void* data, uint64_t size) {
+  if (size == 0) {
+    return katana::ResultSuccess();
+  }
+  if (auto aro_sts = ff->Write(data, size); !aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteViewTopology(
+    const ViewTopologyHeader& header, const katana::GraphTopology& topo,
+    const katana::GraphTopologyTypes::PropIndexVec& edge_prop_indices,
+    const katana::GraphTopologyTypes::PropIndexVec* node_prop_indices) {
+  using PropertyIndex = katana::GraphTopologyTypes::PropertyIndex;
+
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  KATANA_CHECKED(ff->Init());
+  KATANA_CHECKED(WriteBytes(ff.get(), &header, sizeof(header)));
+  KATANA_CHECKED(WriteBytes(
+      ff.get(), topo.adj_data(),
+      topo.num_nodes() * sizeof(katana::GraphTopologyTypes::Edge)));
+  uint64_t dests_size =
+      topo.num_edges() * sizeof(katana::GraphTopologyTypes::Node);
+  KATANA_CHECKED(WriteBytes(ff.get(), topo.dest_data(), dests_size));
+  uint64_t padding = 0;
+  KATANA_CHECKED(WriteBytes(
+      ff.get(), &padding, DestsBytes(topo.num_edges()) - dests_size));
+  KATANA_CHECKED(WriteBytes(
+      ff.get(), edge_prop_indices.data(),
+      edge_prop_indices.size() * sizeof(PropertyIndex)));
+  if (node_prop_indices != nullptr) {
+    KATANA_CHECKED(WriteBytes(
+        ff.get(), node_prop_indices->data(),
+        node_prop_indices->size() * sizeof(PropertyIndex)));
+  }
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+/// The arrays of a stored view topology, which point into its FileView
+struct ViewTopologyArrays {
+  const katana::GraphTopologyTypes::Edge* adj_indices;
+  const katana::GraphTopologyTypes::Node* dests;
+  const katana::GraphTopologyTypes::PropertyIndex* edge_prop_indices;
+  const katana::GraphTopologyTypes::PropertyIndex* node_prop_indices;
+};
+
+katana::Result<ViewTopologyArrays>
+ParseViewTopology(
+    const tsuba::FileView& fv, const ViewTopologyHeader& expected) {
+  using Edge = katana::GraphTopologyTypes::Edge;
+  using Node = katana::GraphTopologyTypes::Node;
+  using PropertyIndex = katana::GraphTopologyTypes::PropertyIndex;
+
+  if (fv.size() < sizeof(ViewTopologyHeader)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "view topology size: {}",
+        fv.size());
+  }
+  if (!(*fv.ptr<ViewTopologyHeader>() == expected)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "view topology is for a different graph or format version");
+  }
+
+  uint64_t adj_offset = sizeof(ViewTopologyHeader);
+  uint64_t dests_offset = adj_offset + expected.num_nodes * sizeof(Edge);
+  uint64_t edge_prop_offset = dests_offset + DestsBytes(expected.num_edges);
+  uint64_t node_prop_offset =
+      edge_prop_offset + expected.num_edges * sizeof(PropertyIndex);
+  uint64_t expected_size = node_prop_offset;
+  if (expected.node_sort_state != kNoNodeSort) {
+    expected_size += expected.num_nodes * sizeof(PropertyIndex);
+  }
+  if (fv.size() < expected_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "view topology size: {} expected {}", fv.size(), expected_size);
+  }
+
+  return ViewTopologyArrays{
+      .adj_indices = fv.ptr<Edge>(adj_offset),
+      .dests = fv.ptr<Node>(dests_offset),
+      .edge_prop_indices = fv.ptr<PropertyIndex>(edge_prop_offset),
+      .node_prop_indices = expected.node_sort_state == kNoNodeSort
+                               ? nullptr
+                               : fv.ptr<PropertyIndex>(node_prop_offset),
+  };
+}
+
+template <typename T>
+katana::NUMAArray<T>
+CopyToNUMAArray(const T* data, size_t size) {
+  katana::NUMAArray<T> array;
+  array.allocateInterleaved(size);
+  katana::ParallelSTL::copy(data, data + size, array.begin());
+  return array;
+}
+
+/// Map the view topology described by \param expected from the derived
+/// topologies of \param rdg into \param fv. Stale or missing topologies are
+/// reported as std::nullopt so that callers build them instead.
+std::optional<ViewTopologyArrays>
+LoadViewTopology(
+    const tsuba::RDG& rdg, const katana::PropertyGraph* pg,
+    ViewTopologyHeader expected, tsuba::FileView* fv) {
+  std::string key = ViewTopologyKey(expected);
+  // A topology that did not come from storage, or was replaced since, has
+  // no stored views. Checked first so that graphs without stored topologies
+  // do not pay for the fingerprint.
+  if (!rdg.topology_file_storage().Valid() || !rdg.HasDerivedTopology(key)) {
+    return std::nullopt;
+  }
+  SetTypeFingerprint(pg, &expected);
+
+  if (auto res = rdg.LoadDerivedTopology(key, fv); !res) {
+    KATANA_LOG_DEBUG("rebuilding view topology {}: {}", key, res.error());
+    return std::nullopt;
+  }
+  auto arrays = ParseViewTopology(*fv, expected);
+  if (!arrays) {
+    KATANA_LOG_DEBUG("rebuilding view topology {}: {}", key, arrays.error());
+    return std::nullopt;
+  }
+  return arrays.value();
+}
+
+}  // namespace
+
 katana::EdgeShuffleTopology*
 katana::PGViewCache::BuildOrGetEdgeShuffTopo(
     const katana::PropertyGraph* pg,
@@ -474,6 +1482,9 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopo(
   if (it != edge_shuff_topos_.end()) {
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
     return it->get();
+  } else if (auto loaded = LoadEdgeShuffTopo(pg, tpose_kind, sort_kind)) {
+    edge_shuff_topos_.emplace_back(std::move(loaded));
+    return edge_shuff_topos_.back().get();
   } else {
     edge_shuff_topos_.emplace_back(
         EdgeShuffleTopology::Make(pg, tpose_kind, sort_kind));
@@ -500,6 +1511,10 @@ katana::PGViewCache::BuildOrGetShuffTopo(
   if (it != fully_shuff_topos_.end()) {
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
     return it->get();
+  } else if (auto loaded = LoadShuffTopo(
+                 pg, tpose_kind, node_sort_todo, edge_sort_todo)) {
+    fully_shuff_topos_.emplace_back(std::move(loaded));
+    return fully_shuff_topos_.back().get();
   } else {
     auto e_topo = BuildOrGetEdgeShuffTopo(pg, tpose_kind, edge_sort_todo);
     KATANA_LOG_DEBUG_ASSERT(e_topo->has_transpose_state(tpose_kind));
@@ -537,3 +1552,223 @@ katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
     return edge_type_aware_topos_.back().get();
   }
 }
+
+std::unique_ptr<katana::EdgeShuffleTopology>
+katana::PGViewCache::LoadEdgeShuffTopo(
+    const katana::PropertyGraph* pg,
+    const katana::EdgeShuffleTopology::TransposeKind& tpose_kind,
+    const katana::EdgeShuffleTopology::EdgeSortKind& sort_kind) noexcept {
+  ViewTopologyHeader expected =
+      MakeViewTopologyHeader(pg, tpose_kind, sort_kind, kNoNodeSort);
+  tsuba::FileView fv;
+  auto arrays = LoadViewTopology(pg->rdg_, pg, expected, &fv);
+  if (!arrays) {
+    return nullptr;
+  }
+  loaded_keys_.emplace(ViewTopologyKey(expected));
+
+  return std::make_unique<EdgeShuffleTopology>(EdgeShuffleTopology{
+      tpose_kind, sort_kind,
+      CopyToNUMAArray(arrays->adj_indices, pg->num_nodes()),
+      CopyToNUMAArray(arrays->dests, pg->num_edges()),
+      CopyToNUMAArray(arrays->edge_prop_indices, pg->num_edges())});
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::PGViewCache::LoadShuffTopo(
+    const katana::PropertyGraph* pg,
+    const katana::EdgeShuffleTopology::TransposeKind& tpose_kind,
+    const katana::ShuffleTopology::NodeSortKind& node_sort_todo,
+    const katana::EdgeShuffleTopology::EdgeSortKind& edge_sort_todo) noexcept {
+  ViewTopologyHeader expected = MakeViewTopologyHeader(
+      pg, tpose_kind, edge_sort_todo, static_cast<int32_t>(node_sort_todo));
+  tsuba::FileView fv;
+  auto arrays = LoadViewTopology(pg->rdg_, pg, expected, &fv);
+  if (!arrays) {
+    return nullptr;
+  }
+  loaded_keys_.emplace(ViewTopologyKey(expected));
+
+  return std::make_unique<ShuffleTopology>(ShuffleTopology{
+      tpose_kind, node_sort_todo, edge_sort_todo,
+      CopyToNUMAArray(arrays->adj_indices, pg->num_nodes()),
+      CopyToNUMAArray(arrays->node_prop_indices, pg->num_nodes()),
+      CopyToNUMAArray(arrays->dests, pg->num_edges()),
+      CopyToNUMAArray(arrays->edge_prop_indices, pg->num_edges())});
+}
+
+katana::Result<void>
+katana::PGViewCache::Persist(katana::PropertyGraph* pg) noexcept {
+  auto persist = [&](const EdgeShuffleTopology& topo, int32_t node_sort,
+                     const GraphTopologyTypes::PropIndexVec* node_prop_indices)
+      -> Result<void> {
+    ViewTopologyHeader header = MakeViewTopologyHeader(
+        pg, topo.transpose_state(), topo.edge_sort_state(), node_sort);
+    std::string key = ViewTopologyKey(header);
+    // Stored topologies that were not loaded may be stale, e.g., built for
+    // different edge types, so only skip the ones that were
+    if (loaded_keys_.count(key) > 0 && pg->rdg_.HasDerivedTopology(key)) {
+      return ResultSuccess();
+    }
+    SetTypeFingerprint(pg, &header);
+    auto ff = KATANA_CHECKED(WriteViewTopology(
+        header, topo, topo.edge_prop_indices_, node_prop_indices));
+    pg->rdg_.AddDerivedTopology(key, std::move(ff));
+    return ResultSuccess();
+  };
+
+  for (const auto& topo : edge_shuff_topos_) {
+    if (topo->is_valid()) {
+      KATANA_CHECKED(persist(*topo, kNoNodeSort, nullptr));
+    }
+  }
+  for (const auto& topo : fully_shuff_topos_) {
+    if (topo->is_valid()) {
+      KATANA_CHECKED(persist(
+          *topo, static_cast<int32_t>(topo->node_sort_state_),
+          &topo->node_prop_indices_));
+    }
+  }
+  return ResultSuccess();
+}
+
+void
+katana::PGViewCache::UpdateEntityTypes(
+    const katana::PropertyGraph* pg,
+    const GraphTopologyTypes::EntityTypeVec& old_node_types,
+    const GraphTopologyTypes::EntityTypeVec& old_edge_types) noexcept {
+  if (edge_shuff_topos_.empty() && fully_shuff_topos_.empty() &&
+      !edge_type_id_map_) {
+    return;
+  }
+
+  const GraphTopology& topo = pg->topology();
+  if (old_node_types.size() != topo.num_nodes() ||
+      old_edge_types.size() != topo.num_edges()) {
+    // the old types are unknown, e.g., lazily loaded type properties
+    for (const auto& t : edge_shuff_topos_) {
+      t->invalidate();
+    }
+    for (const auto& t : fully_shuff_topos_) {
+      t->invalidate();
+    }
+    if (edge_type_id_map_) {
+      edge_type_id_map_->invalidate();
+    }
+    loaded_keys_.clear();
+    return;
+  }
+
+  // sources and destinations of the edges whose type changed; the nodes
+  // whose edges change in the original and in the transposed topologies
+  katana::DynamicBitset changed_srcs;
+  katana::DynamicBitset changed_dests;
+  changed_srcs.resize(topo.num_nodes());
+  changed_dests.resize(topo.num_nodes());
+  katana::GReduceLogicalOr edges_changed_reduce;
+  katana::GReduceLogicalOr nodes_changed_reduce;
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](GraphTopologyTypes::Node n) {
+        if (old_node_types[n] != pg->GetTypeOfNode(n)) {
+          nodes_changed_reduce.update(true);
+        }
+        for (auto e : topo.edges(n)) {
+          if (old_edge_types[e] != pg->GetTypeOfEdge(e)) {
+            edges_changed_reduce.update(true);
+            changed_srcs.set(n);
+            changed_dests.set(topo.edge_dest(e));
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  bool edges_changed = edges_changed_reduce.reduce();
+  bool nodes_changed = nodes_changed_reduce.reduce();
+  if (!edges_changed && !nodes_changed) {
+    return;
+  }
+  // the stored topologies were built for the old types
+  loaded_keys_.clear();
+
+  if (nodes_changed) {
+    for (const auto& t : fully_shuff_topos_) {
+      if (t->node_sort_state_ ==
+          ShuffleTopology::NodeSortKind::kSortedByNodeType) {
+        t->invalidate();
+      }
+    }
+  }
+  if (!edges_changed) {
+    return;
+  }
+
+  constexpr auto kSortedByEdgeType =
+      EdgeShuffleTopology::EdgeSortKind::kSortedByEdgeType;
+  // node_prop_indices maps the nodes of t to nodes of the original topology,
+  // or is null if t keeps the original node ids
+  auto resort = [&](EdgeShuffleTopology* t,
+                    const GraphTopologyTypes::PropIndexVec* node_prop_indices) {
+    if (!t->is_valid() || !t->has_edges_sorted_by(kSortedByEdgeType)) {
+      return;
+    }
+    const katana::DynamicBitset& changed =
+        t->is_transposed() ? changed_dests : changed_srcs;
+    katana::do_all(
+        katana::iterate(t->all_nodes()),
+        [&](GraphTopologyTypes::Node n) {
+          if (changed.test(
+                  node_prop_indices ? (*node_prop_indices)[n] : n)) {
+            t->SortNodeEdgesByTypeThenDest(pg, n);
+          }
+        },
+        katana::steal(), katana::no_stats());
+  };
+  for (const auto& t : edge_shuff_topos_) {
+    resort(t.get(), nullptr);
+  }
+  for (const auto& t : fully_shuff_topos_) {
+    resort(t.get(), &t->node_prop_indices_);
+  }
+
+  if (!edge_type_id_map_ || !edge_type_id_map_->is_valid()) {
+    return;
+  }
+  std::unique_ptr<CondensedTypeIDMap> new_map =
+      CondensedTypeIDMap::MakeFromEdgeTypes(pg);
+  auto old_types = edge_type_id_map_->distinct_edge_type_ids();
+  auto new_types = new_map->distinct_edge_type_ids();
+  bool same_types = std::equal(
+      old_types.begin(), old_types.end(), new_types.begin(), new_types.end());
+  if (!same_types) {
+    // assign in place; the edge type aware topologies refer to the map
+    *edge_type_id_map_ = std::move(*new_map);
+  }
+
+  for (const auto& t : edge_type_aware_topos_) {
+    if (!t->is_valid()) {
+      continue;
+    }
+    // the runs of the sparse index change in number, so it is rebuilt
+    if (!same_types || t->is_sparse()) {
+      t->per_type_adj_indices_ = GraphTopologyTypes::AdjIndexVec();
+      t->sparse_index_ = EdgeTypeAwareTopology::SparseTypeIndex();
+      t->sparse_ = EdgeTypeAwareTopology::BuildTypeIndex(
+          pg, t->edge_type_index_, t->edge_shuff_topo_,
+          &t->per_type_adj_indices_, &t->sparse_index_);
+      continue;
+    }
+    const katana::DynamicBitset& changed =
+        t->is_transposed() ? changed_dests : changed_srcs;
+    katana::do_all(
+        katana::iterate(t->all_nodes()),
+        [&](GraphTopologyTypes::Node n) {
+          if (changed.test(n)) {
+            EdgeTypeAwareTopology::FillPerEdgeTypeAdjacencyIndex(
+                pg, t->edge_type_index_, t->edge_shuff_topo_, n,
+                &t->per_type_adj_indices_);
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+}
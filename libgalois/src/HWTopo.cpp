@@ -1,6 +1,9 @@
 #include "katana/HWTopo.h"
 
+#include <cstdint>
+#include <sstream>
 #include <stdexcept>
+#include <utility>
 
 std::vector<int>
 katana::parseCPUList(const std::string& line) {
@@ -36,3 +39,88 @@ katana::parseCPUList(const std::string& line) {
 
   return vals;
 }
+
+unsigned
+katana::parseCPUQuota(const std::string& in) {
+  std::istringstream is(in);
+  std::string quota;
+  int64_t period = 0;
+  if (!(is >> quota >> period) || quota == "max" || period <= 0) {
+    return 0;
+  }
+  int64_t quota_us = 0;
+  try {
+    quota_us = std::stoll(quota);
+  } catch (const std::invalid_argument&) {
+    return 0;
+  } catch (const std::out_of_range&) {
+    return 0;
+  }
+  if (quota_us <= 0) {
+    return 0;
+  }
+  return (quota_us + period - 1) / period;
+}
+
+namespace {
+
+constexpr const char* kHWTopoMagic = "katana-hwtopo";
+constexpr unsigned kHWTopoVersion = 1;
+
+}  // namespace
+
+std::string
+katana::formatHWTopo(const HWTopoInfo& info, const std::string& cpus) {
+  std::ostringstream out;
+  const MachineTopoInfo& m = info.machineTopoInfo;
+  out << kHWTopoMagic << " " << kHWTopoVersion << "\n"
+      << "cpus " << (cpus.empty() ? "-" : cpus) << "\n"
+      << "machine " << m.maxThreads << " " << m.maxCores << " "
+      << m.maxSockets << " " << m.maxNumaNodes << "\n";
+  for (const ThreadTopoInfo& t : info.threadTopoInfo) {
+    out << "thread " << t.tid << " " << t.socketLeader << " " << t.socket
+        << " " << t.core << " " << t.numaNode << " " << t.cumulativeMaxSocket
+        << " " << t.osContext << " " << t.osNumaNode << "\n";
+  }
+  return out.str();
+}
+
+bool
+katana::parseHWTopo(
+    const std::string& in, const std::string& cpus, HWTopoInfo* info) {
+  std::istringstream is(in);
+  std::string magic;
+  unsigned version = 0;
+  std::string tag;
+  std::string found_cpus;
+  if (!(is >> magic >> version >> tag >> found_cpus) ||
+      magic != kHWTopoMagic || version != kHWTopoVersion || tag != "cpus" ||
+      found_cpus != (cpus.empty() ? "-" : cpus)) {
+    return false;
+  }
+
+  HWTopoInfo parsed;
+  MachineTopoInfo& m = parsed.machineTopoInfo;
+  if (!(is >> tag >> m.maxThreads >> m.maxCores >> m.maxSockets >>
+        m.maxNumaNodes) ||
+      tag != "machine" || m.maxThreads == 0) {
+    return false;
+  }
+  parsed.threadTopoInfo.resize(m.maxThreads);
+  for (unsigned i = 0; i < m.maxThreads; ++i) {
+    ThreadTopoInfo& t = parsed.threadTopoInfo[i];
+    if (!(is >> tag >> t.tid >> t.socketLeader >> t.socket >> t.core >>
+          t.numaNode >> t.cumulativeMaxSocket >> t.osContext >>
+          t.osNumaNode) ||
+        tag != "thread" || t.tid != i || t.socketLeader > i ||
+        t.socket >= m.maxSockets || t.core >= m.maxCores ||
+        t.numaNode >= m.maxNumaNodes) {
+      return false;
+    }
+  }
+  if (is >> tag) {
+    return false;
+  }
+  *info = std::move(parsed);
+  return true;
+}
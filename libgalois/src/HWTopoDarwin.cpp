@@ -72,6 +72,8 @@ makeHWTopo() {
 
   const unsigned threadsPerSocket =
       (mti.maxThreads + mti.maxThreads - 1) / mti.maxSockets;
+  const unsigned logicalPerPhysical =
+      (mti.maxThreads + mti.maxThreads - 1) / mti.maxCores;
 
   // Describe dense configuration first; then, sort logical threads to the
   // back.
@@ -81,15 +83,13 @@ makeHWTopo() {
     tti.push_back(ThreadTopoInfo{
         .socketLeader = leader,
         .socket = socket,
+        .core = i / logicalPerPhysical,
         .numaNode = socket,
         .osContext = i,
         .osNumaNode = socket,
     });
   }
 
-  const unsigned logicalPerPhysical =
-      (mti.maxThreads + mti.maxThreads - 1) / mti.maxCores;
-
   std::sort(
       tti.begin(), tti.end(),
       [&](const ThreadTopoInfo& a, const ThreadTopoInfo& b) {
@@ -133,6 +133,25 @@ katana::bindThreadSelf([[maybe_unused]] unsigned osContext) {
   return true;
 }
 
+//! hints that the current thread should share caches with others on "socket"
+bool
+katana::bindThreadSelfToSocket([[maybe_unused]] unsigned socket) {
+  pthread_t thread = pthread_self();
+  // tag 0 means no affinity
+  thread_affinity_policy policy = {int(socket) + 1};
+  thread_t machThread = pthread_mach_thread_np(thread);
+  if (thread_policy_set(
+          machThread, THREAD_AFFINITY_POLICY, thread_policy_t(&policy),
+          THREAD_AFFINITY_POLICY_COUNT)) {
+    katana::gWarn(
+        "Could not set CPU affinity to socket ", socket, " (",
+        strerror(errno), ")");
+    return false;
+  }
+
+  return true;
+}
+
 HWTopoInfo
 katana::getHWTopo() {
   static SimpleLock lock;
@@ -18,19 +18,27 @@
  */
 
 #include <dlfcn.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cctype>
 #include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <sstream>
+#include <string>
+#include <utility>
 
+#include "katana/Env.h"
 #include "katana/HWTopo.h"
+#include "katana/Logging.h"
 #include "katana/SimpleLock.h"
 #include "katana/gIO.h"
 
@@ -202,38 +210,143 @@ markSMT(std::vector<cpuinfo>& info) {
   }
 }
 
+//! \returns a list of /proc/self/status, e.g., "0-3,8" for \param prefix
+//! "Cpus_allowed_list:", or nothing if it has none
+std::string
+readStatusList(const std::string& prefix) {
+  std::ifstream data("/proc/self/status");
+  if (!data) {
+    return {};
+  }
+
+  std::string line;
+  while (std::getline(data, line)) {
+    if (line.compare(0, prefix.size(), prefix) == 0) {
+      line = line.substr(prefix.size());
+      line.erase(
+          std::remove_if(
+              line.begin(), line.end(),
+              [](unsigned char c) { return std::isspace(c); }),
+          line.end());
+      return line;
+    }
+  }
+  return {};
+}
+
+//! \returns the allowed CPU list of the process, e.g., "0-3,8", or nothing
+//! if it has none
+std::string
+readCPUSet() {
+  return readStatusList("Cpus_allowed_list:");
+}
+
+//! \returns the NUMA nodes the process may allocate memory from
+std::string
+readMemSet() {
+  return readStatusList("Mems_allowed_list:");
+}
+
 std::vector<int>
 parseCPUSet() {
-  std::vector<int> vals;
+  return katana::parseCPUList(readCPUSet());
+}
 
-  std::ifstream data("/proc/self/status");
+//! \returns the first line of a file without surrounding whitespace, or
+//! nothing if it cannot be read
+std::string
+readLine(const std::string& path) {
+  std::ifstream data(path);
+  std::string line;
+  if (!data || !std::getline(data, line)) {
+    return {};
+  }
+  auto not_space = [](unsigned char c) { return !std::isspace(c); };
+  line.erase(line.begin(), std::find_if(line.begin(), line.end(), not_space));
+  line.erase(
+      std::find_if(line.rbegin(), line.rend(), not_space).base(), line.end());
+  return line;
+}
+
+//! Call fn with the directory of cgroup \param path under \param mount and
+//! those of its ancestors. Inside a cgroup namespace, path is often "/"
+//! and the cgroup of the container is mounted as the root.
+void
+visitCgroupDirs(
+    const std::string& mount, std::string path,
+    const std::function<void(const std::string&)>& fn) {
+  while (!path.empty() && path != "/") {
+    fn(mount + path);
+    path = path.substr(0, path.rfind('/'));
+  }
+  fn(mount);
+}
 
+//! \returns the number of CPUs that the CPU quotas of the cgroup of the
+//! process and its ancestors let it use, or 0 if there is no quota
+unsigned
+readCPUQuota() {
+  std::ifstream data("/proc/self/cgroup");
   if (!data) {
-    return vals;
+    return 0;
   }
 
+  unsigned limit = 0;
+  auto tighten = [&limit](unsigned cpus) {
+    if (cpus > 0 && (limit == 0 || cpus < limit)) {
+      limit = cpus;
+    }
+  };
+
+  // lines are hierarchy-ID:controller-list:cgroup-path
   std::string line;
-  std::string prefix("Cpus_allowed_list:");
-  bool found = false;
-  while (true) {
-    std::getline(data, line);
-    if (!data) {
-      return vals;
+  while (std::getline(data, line)) {
+    size_t first = line.find(':');
+    size_t second = line.find(':', first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+      continue;
+    }
+    std::string controllers = line.substr(first + 1, second - first - 1);
+    std::string path = line.substr(second + 1);
+
+    if (controllers.empty()) {
+      // cgroup v2
+      visitCgroupDirs("/sys/fs/cgroup", path, [&](const std::string& dir) {
+        tighten(katana::parseCPUQuota(readLine(dir + "/cpu.max")));
+      });
+      continue;
     }
 
-    if (line.compare(0, prefix.size(), prefix) == 0) {
-      found = true;
-      break;
+    std::istringstream names(controllers);
+    std::string name;
+    bool has_cpu = false;
+    while (std::getline(names, name, ',')) {
+      has_cpu |= name == "cpu";
+    }
+    if (!has_cpu) {
+      continue;
+    }
+    // cgroup v1, where cpu is usually mounted together with cpuacct
+    for (const char* mount :
+         {"/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct"}) {
+      visitCgroupDirs(mount, path, [&](const std::string& dir) {
+        tighten(katana::parseCPUQuota(
+            readLine(dir + "/cpu.cfs_quota_us") + " " +
+            readLine(dir + "/cpu.cfs_period_us")));
+      });
     }
   }
+  return limit;
+}
 
-  if (!found) {
-    return vals;
+//! \returns the number of CPUs the process may use at once, or 0 if there
+//! is no quota or KATANA_IGNORE_CPU_QUOTA is set
+unsigned
+getCPUQuota() {
+  if (katana::GetEnv("KATANA_IGNORE_CPU_QUOTA")) {
+    return 0;
   }
-
-  line = line.substr(prefix.size());
-
-  return katana::parseCPUList(line);
+  return readCPUQuota();
 }
 
 void
@@ -249,6 +362,40 @@ markValid(std::vector<cpuinfo>& info) {
       c.valid = std::binary_search(v.begin(), v.end(), c.proc);
     }
   }
+
+  // Threads allocate memory on their own node, so skip CPUs whose node the
+  // memory policy does not allow unless no other CPU is left
+  auto mems = katana::parseCPUList(readMemSet());
+  if (mems.empty()) {
+    return;
+  }
+  std::sort(mems.begin(), mems.end());
+  auto local = [&mems](const cpuinfo& c) {
+    return c.valid && std::binary_search(
+                          mems.begin(), mems.end(),
+                          static_cast<int>(c.numaNode));
+  };
+  if (std::any_of(info.begin(), info.end(), local)) {
+    for (auto& c : info) {
+      c.valid = local(c);
+    }
+  }
+}
+
+//! \returns what the topology of the process depends on besides the
+//! machine: its allowed CPUs, its CPU quota if any and its allowed memory
+//! nodes if they are not all of them, without whitespace
+std::string
+topologyKey() {
+  std::string key = readCPUSet();
+  if (unsigned quota = getCPUQuota(); quota > 0) {
+    key += fmt::format(";quota={}", quota);
+  }
+  std::string mems = readMemSet();
+  if (!mems.empty() && mems != readLine("/sys/devices/system/node/online")) {
+    key += ";mems=" + mems;
+  }
+  return key;
 }
 
 katana::HWTopoInfo
@@ -267,6 +414,15 @@ makeHWTopo() {
 
   std::sort(info.begin(), info.end());
   markSMT(info);
+
+  // Sorting puts one thread of each core first, socket by socket, so the
+  // threads kept run on distinct cores of as few sockets as possible
+  if (unsigned quota = getCPUQuota(); quota > 0 && quota < info.size()) {
+    info.resize(quota);
+    std::sort(info.begin(), info.end());
+    markSMT(info);
+  }
+
   retMTI.maxSockets = countSockets(info);
   retMTI.maxThreads = info.size();
   retMTI.maxCores = countCores(info);
@@ -276,9 +432,11 @@ makeHWTopo() {
   retTTI.reserve(retMTI.maxThreads);
   // compute renumberings
   std::set<unsigned> sockets;
+  std::set<std::pair<unsigned, unsigned>> cores;
   std::set<unsigned> numaNodes;
   for (auto& i : info) {
     sockets.insert(i.physid);
+    cores.emplace(i.physid, i.coreid);
     numaNodes.insert(i.numaNode);
   }
   unsigned mid = 0;  // max socket id
@@ -292,8 +450,10 @@ makeHWTopo() {
         std::find_if(info.begin(), info.end(), [pid](const cpuinfo& c) {
           return c.physid == pid;
         }));
+    unsigned recore = std::distance(
+        cores.begin(), cores.find({info[i].physid, info[i].coreid}));
     retTTI.push_back(katana::ThreadTopoInfo{
-        i, leader, repid,
+        i, leader, repid, recore,
         (unsigned)std::distance(
             numaNodes.begin(), numaNodes.find(info[i].numaNode)),
         mid, info[i].proc, info[i].numaNode});
@@ -305,6 +465,56 @@ makeHWTopo() {
   };
 }
 
+//! Use a description from the environment or the cache file if there is a
+//! valid one, and probe the machine otherwise
+katana::HWTopoInfo
+loadHWTopo() {
+  std::string cpus = topologyKey();
+  katana::HWTopoInfo info;
+
+  std::string description;
+  if (katana::GetEnv("KATANA_HWTOPO", &description)) {
+    if (katana::parseHWTopo(description, cpus, &info)) {
+      return info;
+    }
+    KATANA_LOG_WARN(
+        "ignoring KATANA_HWTOPO: not a description for CPUs {}", cpus);
+  }
+
+  std::string cache_path;
+  if (!katana::GetEnv("KATANA_HWTOPO_CACHE", &cache_path) ||
+      cache_path.empty()) {
+    return makeHWTopo();
+  }
+  if (std::ifstream cache(cache_path); cache) {
+    std::stringstream contents;
+    contents << cache.rdbuf();
+    if (katana::parseHWTopo(contents.str(), cpus, &info)) {
+      return info;
+    }
+  }
+
+  info = makeHWTopo();
+  // Write a temporary file and rename it so that processes starting at the
+  // same time never read a partial description
+  std::string tmp_path = fmt::format("{}.{}", cache_path, getpid());
+  {
+    std::ofstream out(tmp_path);
+    out << katana::formatHWTopo(info, cpus);
+    if (!out) {
+      KATANA_LOG_WARN("could not write {}", tmp_path);
+      unlink(tmp_path.c_str());
+      return info;
+    }
+  }
+  if (rename(tmp_path.c_str(), cache_path.c_str()) != 0) {
+    KATANA_LOG_WARN(
+        "could not write {}: {}", cache_path, std::strerror(errno));
+    unlink(tmp_path.c_str());
+  }
+  return info;
+}
+
 }  // namespace
 
 katana::HWTopoInfo
@@ -314,7 +524,7 @@ katana::getHWTopo() {
 
   std::lock_guard<SimpleLock> guard(lock);
   if (!data) {
-    data = std::make_unique<HWTopoInfo>(makeHWTopo());
+    data = std::make_unique<HWTopoInfo>(loadHWTopo());
   }
   return *data;
 }
@@ -344,3 +554,35 @@ katana::bindThreadSelf([[maybe_unused]] unsigned osContext) {
   return false;
 #endif
 }
+
+//! binds current thread to every OS HW context of "socket"
+bool
+katana::bindThreadSelfToSocket([[maybe_unused]] unsigned socket) {
+#ifdef KATANA_USE_SCHED_SETAFFINITY
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+
+  bool found = false;
+  for (const ThreadTopoInfo& tti : getHWTopo().threadTopoInfo) {
+    if (tti.socket == socket) {
+      (void)CPU_SET(tti.osContext, &mask);
+      found = true;
+    }
+  }
+  if (!found) {
+    return false;
+  }
+
+  if (sched_setaffinity(0, sizeof(mask), &mask) == -1) {
+    katana::gWarn(
+        "Could not set CPU affinity to socket ", socket, "(", strerror(errno),
+        ")");
+    return false;
+  }
+  return true;
+#else
+  KATANA_WARN_ONCE(
+      "Cannot set cpu affinity on this platform.  Performance will be bad.");
+  return false;
+#endif
+}
@@ -0,0 +1,132 @@
+#include "katana/HyperLogLog.h"
+
+#include <cmath>
+
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+bool
+MaxMergeScalar(uint8_t* to, const uint8_t* from, size_t size) {
+  uint8_t changed = 0;
+  for (size_t i = 0; i < size; ++i) {
+    uint8_t merged = std::max(to[i], from[i]);
+    changed |= merged ^ to[i];
+    to[i] = merged;
+  }
+  return changed != 0;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("avx512bw"))) bool
+MaxMergeAvx512(uint8_t* to, const uint8_t* from, size_t size) {
+  __mmask64 changed = 0;
+  size_t i = 0;
+  for (; i + 64 <= size; i += 64) {
+    __m512i a = _mm512_loadu_si512(to + i);
+    __m512i merged = _mm512_max_epu8(a, _mm512_loadu_si512(from + i));
+    changed |= _mm512_cmpneq_epi8_mask(a, merged);
+    _mm512_storeu_si512(to + i, merged);
+  }
+  bool rest_changed = MaxMergeScalar(to + i, from + i, size - i);
+  return changed != 0 || rest_changed;
+}
+
+__attribute__((target("avx2"))) bool
+MaxMergeAvx2(uint8_t* to, const uint8_t* from, size_t size) {
+  __m256i changed = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(to + i));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i));
+    __m256i merged = _mm256_max_epu8(a, b);
+    changed = _mm256_or_si256(changed, _mm256_xor_si256(a, merged));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(to + i), merged);
+  }
+  bool rest_changed = MaxMergeScalar(to + i, from + i, size - i);
+  return !_mm256_testz_si256(changed, changed) || rest_changed;
+}
+
+const bool kHaveAvx512 = __builtin_cpu_supports("avx512bw");
+const bool kHaveAvx2 = __builtin_cpu_supports("avx2");
+
+#endif
+
+/// The bias correction of the harmonic mean of the registers
+double
+Alpha(size_t num_registers) {
+  switch (num_registers) {
+  case 16:
+    return 0.673;
+  case 32:
+    return 0.697;
+  case 64:
+    return 0.709;
+  default:
+    return 0.7213 / (1.0 + 1.079 / num_registers);
+  }
+}
+
+}  // namespace
+
+bool
+katana::MaxMerge(uint8_t* to, const uint8_t* from, size_t size) {
+#if defined(__x86_64__)
+  if (kHaveAvx512) {
+    return MaxMergeAvx512(to, from, size);
+  }
+  if (kHaveAvx2) {
+    return MaxMergeAvx2(to, from, size);
+  }
+#endif
+  return MaxMergeScalar(to, from, size);
+}
+
+katana::HyperLogLogArray::HyperLogLogArray(
+    size_t num_counters, uint32_t log2_num_registers)
+    : num_counters_(num_counters), log2_num_registers_(log2_num_registers) {
+  KATANA_LOG_VASSERT(
+      log2_num_registers >= kMinLog2NumRegisters &&
+          log2_num_registers <= kMaxLog2NumRegisters,
+      "{} is not a valid log2 of the number of registers", log2_num_registers);
+  registers_.allocateBlocked(num_counters * num_registers());
+  katana::ParallelSTL::fill(registers_.begin(), registers_.end(), uint8_t{0});
+}
+
+bool
+katana::HyperLogLogArray::Merge(
+    size_t i, const HyperLogLogArray& from, size_t j) {
+  KATANA_LOG_DEBUG_ASSERT(from.num_registers() == num_registers());
+  return MaxMerge(counter(i), from.counter(j), num_registers());
+}
+
+void
+katana::HyperLogLogArray::Copy(
+    size_t i, const HyperLogLogArray& from, size_t j) {
+  KATANA_LOG_DEBUG_ASSERT(from.num_registers() == num_registers());
+  std::copy(from.counter(j), from.counter(j) + num_registers(), counter(i));
+}
+
+double
+katana::HyperLogLogArray::Estimate(size_t i) const {
+  const uint8_t* registers = counter(i);
+  size_t m = num_registers();
+  double sum = 0;
+  size_t zeros = 0;
+  for (size_t r = 0; r < m; ++r) {
+    sum += std::ldexp(1.0, -registers[r]);
+    zeros += registers[r] == 0;
+  }
+  double estimate = Alpha(m) * m * m / sum;
+  // Few values leave registers empty; count them as in linear counting
+  if (estimate <= 2.5 * m && zeros != 0) {
+    return m * std::log(static_cast<double>(m) / zeros);
+  }
+  return estimate;
+}
@@ -0,0 +1,196 @@
+#include "katana/LoopStatistics.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// Statistic categories of ConflictStatistics<true>::retried_commits_
+constexpr const char*
+    kRetryBucketNames[katana::ConflictStatistics<true>::kNumRetryBuckets] = {
+        "RetriedCommits1",    "RetriedCommits2-3",  "RetriedCommits4-7",
+        "RetriedCommits8-15", "RetriedCommits16+",
+};
+
+/// Statistic categories of the counters, in the order of the values
+constexpr const char* kCounterNames[katana::internal::kNumLoopCounters] = {
+    "Cycles",
+    "LLCMisses",
+    "BranchMisses",
+    "RemoteMemoryReads",
+};
+
+#ifdef __linux__
+
+struct CounterEvent {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr CounterEvent kCounterEvents[katana::internal::kNumLoopCounters] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    // reads that miss in the caches of the local NUMA node
+    {PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_NODE | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+
+/// The counters of the thread that created it; opened once per thread
+class ThreadCounters {
+  int fds_[katana::internal::kNumLoopCounters];
+
+public:
+  ThreadCounters() {
+    bool any_open = false;
+    for (size_t i = 0; i < katana::internal::kNumLoopCounters; ++i) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = kCounterEvents[i].type;
+      attr.config = kCounterEvents[i].config;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      // pid 0 and cpu -1: this thread on any CPU
+      fds_[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+      any_open |= fds_[i] >= 0;
+    }
+
+    static std::atomic<bool> warned{false};
+    if (!any_open && !warned.exchange(true)) {
+      KATANA_LOG_WARN(
+          "KATANA_LOOP_COUNTERS is set but hardware counters are not "
+          "available: {}",
+          std::strerror(errno));
+    }
+  }
+
+  ~ThreadCounters() {
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  ThreadCounters(const ThreadCounters&) = delete;
+  ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+  void Read(uint64_t* values) const {
+    for (size_t i = 0; i < katana::internal::kNumLoopCounters; ++i) {
+      if (fds_[i] < 0 ||
+          read(fds_[i], &values[i], sizeof(values[i])) != sizeof(values[i])) {
+        values[i] = 0;
+      }
+    }
+  }
+};
+
+#endif
+
+}  // namespace
+
+bool
+katana::internal::LoopCountersEnabled() {
+  static const bool enabled = GetEnv("KATANA_LOOP_COUNTERS");
+  return enabled;
+}
+
+void
+katana::internal::ReadLoopCounters(uint64_t* values) {
+#ifdef __linux__
+  static thread_local ThreadCounters counters;
+  counters.Read(values);
+#else
+  std::memset(values, 0, kNumLoopCounters * sizeof(*values));
+#endif
+}
+
+void
+katana::internal::ReportLoopCounters(
+    const char* loopname, const uint64_t* start) {
+  uint64_t now[kNumLoopCounters];
+  ReadLoopCounters(now);
+  for (size_t i = 0; i < kNumLoopCounters; ++i) {
+    if (now[i] != 0) {
+      ReportStatSum(loopname, kCounterNames[i], now[i] - start[i]);
+    }
+  }
+}
+
+uint32_t
+katana::internal::ConflictSamplingPeriod() {
+  static const uint32_t period = [] {
+    int value = 0;
+    if (!GetEnv("KATANA_CONFLICT_SAMPLING", &value) || value < 0) {
+      return 0U;
+    }
+    return static_cast<uint32_t>(value);
+  }();
+  return period;
+}
+
+katana::ConflictStatistics<true>::ConflictStatistics(const char* loopname)
+    : loopname_(loopname),
+      period_(internal::ConflictSamplingPeriod()),
+      until_sample_(period_) {}
+
+katana::ConflictStatistics<true>::~ConflictStatistics() {
+  for (size_t i = 0; i < kNumRetryBuckets; ++i) {
+    if (retried_commits_[i] != 0) {
+      ReportStatSum(loopname_, kRetryBucketNames[i], retried_commits_[i]);
+    }
+  }
+
+  if (sites_.empty()) {
+    return;
+  }
+
+  uint64_t num_samples = 0;
+  std::vector<std::pair<uint64_t, std::pair<bool, uint64_t>>> hottest;
+  for (const auto& [site, count] : sites_) {
+    num_samples += count;
+    hottest.emplace_back(count, site);
+  }
+  ReportStatSum(loopname_, "ConflictSamples", num_samples);
+
+  size_t num_reported = std::min(kMaxReportedSites, hottest.size());
+  std::partial_sort(
+      hottest.begin(), hottest.begin() + num_reported, hottest.end(),
+      [](const auto& a, const auto& b) { return a.first > b.first; });
+  for (size_t i = 0; i < num_reported; ++i) {
+    const auto& [count, site] = hottest[i];
+    std::string category =
+        site.first ? fmt::format("ConflictSamples node {}", site.second)
+                   : fmt::format("ConflictSamples lock {:#x}", site.second);
+    ReportStatSum(loopname_, category, count);
+  }
+}
+
+void
+katana::ConflictStatistics<true>::Sample(bool is_node, uint64_t site) {
+  sites_[std::make_pair(is_node, site)] += 1;
+}
+
+void
+katana::ConflictStatistics<true>::CountRetries(int retries) {
+  size_t bucket = 0;
+  while (bucket + 1 < kNumRetryBuckets && retries >= (2 << bucket)) {
+    ++bucket;
+  }
+  retried_commits_[bucket] += 1;
+}
@@ -0,0 +1,163 @@
+#include "katana/MemoryBudget.h"
+
+#include <mutex>
+#include <utility>
+
+#include <arrow/memory_pool.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Statistics.h"
+
+std::atomic<katana::MemoryBudget*> katana::MemoryBudget::current_{nullptr};
+std::atomic<katana::MemoryPhase*> katana::MemoryPhase::current_{nullptr};
+
+namespace {
+
+/// Guards the chains of budgets and phases against them going away while
+/// allocations are charged to them. Recursive because exceeded callbacks may
+/// allocate.
+std::recursive_mutex&
+BudgetMutex() {
+  static std::recursive_mutex mutex;
+  return mutex;
+}
+
+/// Raise \param peak to \param used if it is larger
+void
+UpdatePeak(std::atomic<size_t>* peak, int64_t used) {
+  size_t p = peak->load(std::memory_order_relaxed);
+  while (used > 0 && static_cast<size_t>(used) > p &&
+         !peak->compare_exchange_weak(p, used)) {
+  }
+}
+
+bool
+Accounting() {
+  return katana::MemoryBudget::current() || katana::MemoryPhase::current();
+}
+
+}  // namespace
+
+katana::MemoryBudget::MemoryBudget(
+    std::string name, size_t budget_bytes, ExceededCallback on_exceeded)
+    : name_(std::move(name)),
+      budget_bytes_(budget_bytes),
+      on_exceeded_(std::move(on_exceeded)) {
+  std::lock_guard<std::recursive_mutex> lock(BudgetMutex());
+  parent_ = current_.load(std::memory_order_relaxed);
+  current_.store(this, std::memory_order_release);
+}
+
+katana::MemoryBudget::~MemoryBudget() {
+  std::lock_guard<std::recursive_mutex> lock(BudgetMutex());
+  KATANA_LOG_VASSERT(
+      current_.load(std::memory_order_relaxed) == this,
+      "memory budgets must be destroyed in reverse order of creation");
+  current_.store(parent_, std::memory_order_release);
+}
+
+void
+katana::MemoryBudget::Charge(int64_t bytes) {
+  int64_t used = used_bytes_.fetch_add(bytes) + bytes;
+  if (bytes <= 0) {
+    return;
+  }
+
+  UpdatePeak(&peak_bytes_, used);
+
+  if (static_cast<size_t>(used) > budget_bytes_ && !exceeded_.exchange(true)) {
+    KATANA_LOG_DEBUG(
+        "memory budget {} exceeded: {} bytes used of {}", name_, used,
+        budget_bytes_);
+    if (on_exceeded_) {
+      on_exceeded_(*this);
+    }
+  }
+}
+
+katana::Result<void>
+katana::MemoryBudget::Check() const {
+  if (!exceeded()) {
+    return ResultSuccess();
+  }
+  return KATANA_ERROR(
+      ErrorCode::OutOfMemory,
+      "memory budget {} exceeded: peak of {} bytes for a budget of {}", name_,
+      peak_bytes(), budget_bytes_);
+}
+
+void
+katana::MemoryBudget::Report(const std::string& prefix) const {
+  ReportStatSingle("MemoryBudget", prefix + name_ + "UsedBytes", used_bytes());
+  ReportStatSingle("MemoryBudget", prefix + name_ + "PeakBytes", peak_bytes());
+  ReportStatSingle("MemoryBudget", prefix + name_ + "Bytes", budget_bytes_);
+}
+
+katana::MemoryPhase::MemoryPhase(const char* name, const char* region)
+    : name_(name ? name : "Time"),
+      region_(region ? region : "(NULL)"),
+      arrow_start_bytes_(arrow::default_memory_pool()->bytes_allocated()) {
+  std::lock_guard<std::recursive_mutex> lock(BudgetMutex());
+  older_ = current_.load(std::memory_order_relaxed);
+  if (older_) {
+    older_->newer_ = this;
+  }
+  current_.store(this, std::memory_order_release);
+}
+
+katana::MemoryPhase::~MemoryPhase() {
+  {
+    std::lock_guard<std::recursive_mutex> lock(BudgetMutex());
+    if (older_) {
+      older_->newer_ = newer_;
+    }
+    if (newer_) {
+      newer_->older_ = older_;
+    } else {
+      current_.store(older_, std::memory_order_release);
+    }
+  }
+
+  ReportStatMax(region_, name_ + "PeakBytes", peak_bytes());
+  ReportStatMax(region_, name_ + "ArrowBytes", arrow_bytes());
+}
+
+int64_t
+katana::MemoryPhase::arrow_bytes() const {
+  return arrow::default_memory_pool()->bytes_allocated() - arrow_start_bytes_;
+}
+
+void
+katana::MemoryPhase::Charge(int64_t bytes) {
+  int64_t used = used_bytes_.fetch_add(bytes) + bytes;
+  UpdatePeak(&peak_bytes_, used);
+}
+
+void
+katana::internal::ChargeMemoryBudget(size_t bytes) {
+  if (!Accounting()) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(BudgetMutex());
+  for (MemoryPhase* p = MemoryPhase::current_.load(); p; p = p->older_) {
+    p->Charge(bytes);
+  }
+  for (MemoryBudget* b = MemoryBudget::current_.load(); b; b = b->parent_) {
+    b->Charge(bytes);
+  }
+}
+
+void
+katana::internal::UnchargeMemoryBudget(size_t bytes) {
+  if (!Accounting()) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(BudgetMutex());
+  for (MemoryPhase* p = MemoryPhase::current_.load(); p; p = p->older_) {
+    p->Charge(-static_cast<int64_t>(bytes));
+  }
+  for (MemoryBudget* b = MemoryBudget::current_.load(); b; b = b->parent_) {
+    b->Charge(-static_cast<int64_t>(bytes));
+  }
+}
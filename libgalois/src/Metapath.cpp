@@ -0,0 +1,262 @@
+#include "katana/Metapath.h"
+
+#include <atomic>
+#include <unordered_map>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PropertyGraph.h"
+
+namespace {
+
+using View = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
+using Node = katana::GraphTopologyTypes::Node;
+
+katana::Result<void>
+CheckSources(const View& view, const std::vector<Node>& sources) {
+  for (Node source : sources) {
+    if (source >= view.num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "source {} is not a node; the graph has {} nodes", source,
+          view.num_nodes());
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Call fn on the other end of each edge of n which matches step
+template <typename Fn>
+void
+ForEachStepNeighbor(
+    const View& view, Node n, const katana::MetapathStep& step, const Fn& fn) {
+  if (step.direction == katana::MetapathStep::Direction::kOut) {
+    for (auto e : view.edges(n, step.edge_type)) {
+      fn(view.edge_dest(e));
+    }
+  } else {
+    for (auto e : view.in_edges(n, step.edge_type)) {
+      fn(view.in_edge_dest(e));
+    }
+  }
+}
+
+/// Gather the nodes of bag into frontier and clear their bits in seen, so
+/// that seen needs no reset of all of its bits before the next hop
+void
+FinishFrontier(
+    const katana::InsertBag<Node>& bag, katana::DynamicBitset* seen,
+    katana::NUMAArray<Node>* frontier) {
+  bag.compact(frontier);
+  katana::do_all(
+      katana::iterate(size_t{0}, frontier->size()),
+      [&](size_t i) { seen->reset((*frontier)[i]); }, katana::no_stats());
+}
+
+void
+InitFrontier(
+    const std::vector<Node>& sources, katana::DynamicBitset* seen,
+    katana::NUMAArray<Node>* frontier) {
+  katana::InsertBag<Node> bag;
+  katana::do_all(
+      katana::iterate(sources),
+      [&](Node source) {
+        if (!seen->set(source)) {
+          bag.push(source);
+        }
+      },
+      katana::no_stats());
+  FinishFrontier(bag, seen, frontier);
+}
+
+/// Put in next the distinct nodes one step away from frontier; visit is
+/// called with the ends of every edge which matches step
+template <typename VisitFn>
+void
+ExpandFrontier(
+    const View& view, const katana::MetapathStep& step,
+    const katana::NUMAArray<Node>& frontier, katana::DynamicBitset* seen,
+    katana::NUMAArray<Node>* next, const VisitFn& visit) {
+  katana::InsertBag<Node> bag;
+  if (view.DoesEdgeTypeExist(step.edge_type)) {
+    katana::do_all(
+        katana::iterate(size_t{0}, frontier.size()),
+        [&](size_t i) {
+          Node n = frontier[i];
+          ForEachStepNeighbor(view, n, step, [&](Node dst) {
+            visit(n, dst);
+            if (!seen->set(dst)) {
+              bag.push(dst);
+            }
+          });
+        },
+        katana::steal(), katana::no_stats());
+  }
+  FinishFrontier(bag, seen, next);
+}
+
+/// The number of instances of half followed by its reverse from node back
+/// to itself: the sum over the ends m of half of the square of the number of
+/// instances of half from node to m
+uint64_t
+CountSelfInstances(
+    const View& view, Node node, const katana::Metapath& half) {
+  std::unordered_map<Node, uint64_t> counts{{node, 1}};
+  for (const katana::MetapathStep& step : half) {
+    if (!view.DoesEdgeTypeExist(step.edge_type)) {
+      return 0;
+    }
+    std::unordered_map<Node, uint64_t> next;
+    for (const auto& [n, count] : counts) {
+      ForEachStepNeighbor(
+          view, n, step, [&, c = count](Node dst) { next[dst] += c; });
+    }
+    counts = std::move(next);
+  }
+
+  uint64_t total = 0;
+  for (const auto& [m, count] : counts) {
+    total += count * count;
+  }
+  return total;
+}
+
+bool
+IsSymmetric(const katana::Metapath& path) {
+  if (path.size() % 2 != 0) {
+    return false;
+  }
+  for (size_t i = 0; i < path.size() / 2; ++i) {
+    const katana::MetapathStep& a = path[i];
+    const katana::MetapathStep& b = path[path.size() - 1 - i];
+    if (a.edge_type != b.edge_type || a.direction == b.direction) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+katana::Result<std::vector<katana::GraphTopologyTypes::Node>>
+katana::MetapathEndpoints(
+    const PropertyGraphViews::EdgeTypeAwareBiDir& view,
+    const std::vector<GraphTopologyTypes::Node>& sources,
+    const Metapath& path) {
+  KATANA_CHECKED(CheckSources(view, sources));
+
+  katana::DynamicBitset seen;
+  seen.resize(view.num_nodes());
+  katana::NUMAArray<Node> frontier;
+  katana::NUMAArray<Node> next;
+  InitFrontier(sources, &seen, &frontier);
+  for (const MetapathStep& step : path) {
+    if (frontier.empty()) {
+      break;
+    }
+    ExpandFrontier(view, step, frontier, &seen, &next, [](Node, Node) {});
+    std::swap(frontier, next);
+  }
+
+  std::vector<Node> endpoints(frontier.begin(), frontier.end());
+  katana::ParallelSTL::sort(endpoints.begin(), endpoints.end());
+  return endpoints;
+}
+
+katana::Result<katana::NUMAArray<uint64_t>>
+katana::CountMetapathInstances(
+    const PropertyGraphViews::EdgeTypeAwareBiDir& view,
+    const std::vector<GraphTopologyTypes::Node>& sources,
+    const Metapath& path) {
+  KATANA_CHECKED(CheckSources(view, sources));
+
+  const size_t num_nodes = view.num_nodes();
+  katana::NUMAArray<std::atomic<uint64_t>> counts;
+  katana::NUMAArray<std::atomic<uint64_t>> next_counts;
+  counts.allocateBlocked(num_nodes);
+  next_counts.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        counts[n].store(0, std::memory_order_relaxed);
+        next_counts[n].store(0, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  for (Node source : sources) {
+    counts[source].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  katana::DynamicBitset seen;
+  seen.resize(num_nodes);
+  katana::NUMAArray<Node> frontier;
+  katana::NUMAArray<Node> next;
+  InitFrontier(sources, &seen, &frontier);
+  for (const MetapathStep& step : path) {
+    ExpandFrontier(view, step, frontier, &seen, &next, [&](Node n, Node dst) {
+      next_counts[dst].fetch_add(
+          counts[n].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    });
+    // Only the counts of the frontier can be nonzero
+    katana::do_all(
+        katana::iterate(size_t{0}, frontier.size()),
+        [&](size_t i) {
+          counts[frontier[i]].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    std::swap(counts, next_counts);
+    std::swap(frontier, next);
+  }
+
+  katana::NUMAArray<uint64_t> result;
+  result.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { result[n] = counts[n].load(std::memory_order_relaxed); },
+      katana::no_stats());
+  return katana::Result<katana::NUMAArray<uint64_t>>(std::move(result));
+}
+
+katana::Result<
+    std::vector<std::pair<katana::GraphTopologyTypes::Node, double>>>
+katana::PathSim(
+    const PropertyGraphViews::EdgeTypeAwareBiDir& view,
+    GraphTopologyTypes::Node source, const Metapath& path) {
+  if (!IsSymmetric(path)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "PathSim needs a symmetric metapath");
+  }
+  auto counts = KATANA_CHECKED(CountMetapathInstances(view, {source}, path));
+
+  katana::InsertBag<Node> reached;
+  katana::do_all(
+      katana::iterate(size_t{0}, counts.size()),
+      [&](size_t n) {
+        if (counts[n] > 0) {
+          reached.push(n);
+        }
+      },
+      katana::no_stats());
+  std::vector<Node> endpoints(reached.begin(), reached.end());
+  katana::ParallelSTL::sort(endpoints.begin(), endpoints.end());
+
+  const Metapath half(path.begin(), path.begin() + path.size() / 2);
+  // Going from source to some y and back the way it came is an instance
+  // from source to itself, so source_count > 0
+  const double source_count = counts[source];
+  std::vector<std::pair<Node, double>> scores(endpoints.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, endpoints.size()),
+      [&](size_t i) {
+        Node y = endpoints[i];
+        double self_count = CountSelfInstances(view, y, half);
+        scores[i] = {y, 2.0 * counts[y] / (source_count + self_count)};
+      },
+      katana::steal(), katana::no_stats());
+  return scores;
+}
@@ -0,0 +1,104 @@
+#include "katana/NUMAMemoryPool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "katana/PageAlloc.h"
+
+namespace {
+
+uint64_t
+NumPages(int64_t size) {
+  size_t page_size = katana::allocSize();
+  return (static_cast<size_t>(size) + page_size - 1) / page_size;
+}
+
+}  // namespace
+
+katana::NUMAMemoryPool::NUMAMemoryPool(
+    int64_t min_page_bytes, arrow::MemoryPool* fallback)
+    : min_page_bytes_(std::max<int64_t>(min_page_bytes, 1)),
+      fallback_(fallback) {}
+
+void
+katana::NUMAMemoryPool::Charge(int64_t bytes) {
+  int64_t allocated =
+      bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  int64_t max = max_memory_.load(std::memory_order_relaxed);
+  while (allocated > max &&
+         !max_memory_.compare_exchange_weak(
+             max, allocated, std::memory_order_relaxed)) {
+  }
+}
+
+arrow::Status
+katana::NUMAMemoryPool::Allocate(int64_t size, uint8_t** out) {
+  if (size < 0) {
+    return arrow::Status::Invalid("negative allocation size");
+  }
+  if (!UsesPages(size)) {
+    ARROW_RETURN_NOT_OK(fallback_->Allocate(size, out));
+    Charge(size);
+    return arrow::Status::OK();
+  }
+  uint64_t num_pages = NumPages(size);
+  // Pages are not faulted in here so that the threads which write them
+  // decide their NUMA nodes. Page alignment satisfies Arrow's alignment.
+  void* pages = num_pages <= std::numeric_limits<unsigned>::max()
+                    ? tryAllocPages(static_cast<unsigned>(num_pages), false)
+                    : nullptr;
+  if (!pages) {
+    return arrow::Status::OutOfMemory(
+        "failed to allocate ", size, " bytes of pages");
+  }
+  *out = static_cast<uint8_t*>(pages);
+  page_bytes_allocated_.fetch_add(size, std::memory_order_relaxed);
+  Charge(size);
+  return arrow::Status::OK();
+}
+
+void
+katana::NUMAMemoryPool::Free(uint8_t* buffer, int64_t size) {
+  if (!UsesPages(size)) {
+    fallback_->Free(buffer, size);
+  } else {
+    freePages(buffer, NumPages(size));
+    page_bytes_allocated_.fetch_sub(size, std::memory_order_relaxed);
+  }
+  bytes_allocated_.fetch_sub(size, std::memory_order_relaxed);
+}
+
+arrow::Status
+katana::NUMAMemoryPool::Reallocate(
+    int64_t old_size, int64_t new_size, uint8_t** ptr) {
+  if (new_size < 0) {
+    return arrow::Status::Invalid("negative reallocation size");
+  }
+  if (!UsesPages(old_size) && !UsesPages(new_size)) {
+    ARROW_RETURN_NOT_OK(fallback_->Reallocate(old_size, new_size, ptr));
+    Charge(new_size - old_size);
+    return arrow::Status::OK();
+  }
+  if (UsesPages(old_size) && UsesPages(new_size) &&
+      NumPages(old_size) == NumPages(new_size)) {
+    // The pages already hold new_size bytes
+    page_bytes_allocated_.fetch_add(
+        new_size - old_size, std::memory_order_relaxed);
+    Charge(new_size - old_size);
+    return arrow::Status::OK();
+  }
+
+  uint8_t* buffer = nullptr;
+  ARROW_RETURN_NOT_OK(Allocate(new_size, &buffer));
+  std::memcpy(buffer, *ptr, std::min(old_size, new_size));
+  Free(*ptr, old_size);
+  *ptr = buffer;
+  return arrow::Status::OK();
+}
+
+katana::NUMAMemoryPool*
+katana::NUMAMemoryPool::Get() {
+  static NUMAMemoryPool* pool = new NUMAMemoryPool();
+  return pool;
+}
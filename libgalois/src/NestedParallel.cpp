@@ -0,0 +1,126 @@
+#include "katana/NestedParallel.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "katana/CacheLineStorage.h"
+#include "katana/Logging.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+/// Where a thread publishes the task it is waiting for. Helpers announce
+/// themselves in visitors before they read task, so once the owner has
+/// cleared task and seen no visitors, no helper can reach the task anymore.
+struct Slot {
+  std::atomic<katana::internal::NestedTask*> task{nullptr};
+  std::atomic<unsigned> visitors{0};
+};
+
+struct Slots {
+  explicit Slots(unsigned n)
+      : size(n), slots(std::make_unique<katana::CacheLineStorage<Slot>[]>(n)) {}
+
+  unsigned size;
+  std::unique_ptr<katana::CacheLineStorage<Slot>[]> slots;
+  //! number of tasks that are published, to skip the scan of slots
+  std::atomic<unsigned> num_published{0};
+};
+
+Slots&
+GetSlots() {
+  static Slots slots(katana::GetThreadPool().getMaxThreads());
+  return slots;
+}
+
+/// 0 outside of do_all, 1 in the operator of a do_all and 2 or more in the
+/// chunk of a NestedTask
+thread_local unsigned gLoopDepth = 0;
+
+/// Runs the chunks of a task one level deeper, so that the loops nested in
+/// them run serially
+bool
+RunChunksNested(katana::internal::NestedTask* task) {
+  katana::internal::NestedLoopScope scope;
+  return task->RunChunks();
+}
+
+}  // namespace
+
+bool
+katana::internal::NestedTask::RunChunks() {
+  bool claimed = false;
+  while (true) {
+    size_t begin = next_.fetch_add(chunk_size_, std::memory_order_relaxed);
+    if (begin >= size_) {
+      return claimed;
+    }
+    claimed = true;
+    size_t end = std::min(size_, begin + chunk_size_);
+    if (!cancellation_ || !cancellation_->IsCancelled()) {
+      run_(state_, begin, end);
+    }
+    unfinished_.fetch_sub(end - begin);
+  }
+}
+
+katana::internal::NestedLoopScope::NestedLoopScope() { ++gLoopDepth; }
+
+katana::internal::NestedLoopScope::~NestedLoopScope() {
+  KATANA_LOG_DEBUG_ASSERT(gLoopDepth > 0);
+  --gLoopDepth;
+}
+
+bool
+katana::internal::InDoAllOperator() {
+  return gLoopDepth > 0;
+}
+
+bool
+katana::internal::ForkNestedLoops() {
+  return gLoopDepth == 1 && getActiveThreads() > 1;
+}
+
+void
+katana::internal::RunNestedTask(NestedTask* task) {
+  Slots& slots = GetSlots();
+  Slot& slot = slots.slots[ThreadPool::getTID()].get();
+  KATANA_LOG_DEBUG_ASSERT(!slot.task.load());
+
+  slot.task.store(task);
+  slots.num_published.fetch_add(1);
+
+  RunChunksNested(task);
+
+  slot.task.store(nullptr);
+  slots.num_published.fetch_sub(1);
+  // helpers leave once they have finished the chunks they claimed
+  while (slot.visitors.load() != 0) {
+    asmPause();
+  }
+  KATANA_LOG_DEBUG_ASSERT(task->Finished());
+}
+
+bool
+katana::internal::HelpNestedTasks() {
+  Slots& slots = GetSlots();
+  if (slots.num_published.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+
+  bool claimed = false;
+  unsigned tid = ThreadPool::getTID();
+  for (unsigned i = 1; i < slots.size; ++i) {
+    Slot& slot = slots.slots[(tid + i) % slots.size].get();
+    if (!slot.task.load(std::memory_order_relaxed)) {
+      continue;
+    }
+    slot.visitors.fetch_add(1);
+    if (NestedTask* task = slot.task.load(); task) {
+      claimed |= RunChunksNested(task);
+    }
+    slot.visitors.fetch_sub(1);
+  }
+  return claimed;
+}
@@ -0,0 +1,491 @@
+#include "katana/NodeOrdering.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+using PropIndexVec = katana::GraphTopologyTypes::PropIndexVec;
+
+constexpr Node kNoNode = std::numeric_limits<Node>::max();
+
+/// The neighbors of each node of a topology in either direction, sorted and
+/// without duplicates or self loops
+class UndirectedGraph {
+public:
+  explicit UndirectedGraph(const katana::GraphTopology& topo) {
+    const uint64_t num_nodes = topo.num_nodes();
+    std::vector<std::atomic<uint64_t>> cursor(num_nodes);
+
+    katana::do_all(
+        katana::iterate(topo.all_nodes()),
+        [&](Node src) {
+          for (auto e : topo.edges(src)) {
+            Node dst = topo.edge_dest(e);
+            if (dst != src) {
+              katana::atomicAdd(cursor[src], uint64_t{1});
+              katana::atomicAdd(cursor[dst], uint64_t{1});
+            }
+          }
+        },
+        katana::no_stats());
+
+    std::vector<uint64_t> offsets(num_nodes + 1, 0);
+    for (uint64_t i = 0; i < num_nodes; ++i) {
+      offsets[i + 1] = offsets[i] + cursor[i].load(std::memory_order_relaxed);
+      cursor[i].store(offsets[i], std::memory_order_relaxed);
+    }
+
+    std::vector<Node> neighbors(offsets[num_nodes]);
+    katana::do_all(
+        katana::iterate(topo.all_nodes()),
+        [&](Node src) {
+          for (auto e : topo.edges(src)) {
+            Node dst = topo.edge_dest(e);
+            if (dst != src) {
+              neighbors[katana::atomicAdd(cursor[src], uint64_t{1})] = dst;
+              neighbors[katana::atomicAdd(cursor[dst], uint64_t{1})] = src;
+            }
+          }
+        },
+        katana::no_stats());
+
+    // Sorting makes the result independent of the order of the atomic
+    // increments above
+    std::vector<uint64_t> sizes(num_nodes + 1, 0);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          auto begin = neighbors.begin() + offsets[n];
+          auto end = neighbors.begin() + offsets[n + 1];
+          std::sort(begin, end);
+          sizes[n + 1] = std::distance(begin, std::unique(begin, end));
+        },
+        katana::steal(), katana::no_stats());
+
+    offsets_.resize(num_nodes + 1);
+    std::partial_sum(sizes.begin(), sizes.end(), offsets_.begin());
+    neighbors_.resize(offsets_[num_nodes]);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          std::copy(
+              neighbors.begin() + offsets[n],
+              neighbors.begin() + offsets[n] + degree(n),
+              neighbors_.begin() + offsets_[n]);
+        },
+        katana::no_stats());
+  }
+
+  uint64_t num_nodes() const { return offsets_.size() - 1; }
+
+  uint64_t degree(uint64_t n) const { return offsets_[n + 1] - offsets_[n]; }
+
+  const Node* begin(uint64_t n) const {
+    return neighbors_.data() + offsets_[n];
+  }
+  const Node* end(uint64_t n) const {
+    return neighbors_.data() + offsets_[n + 1];
+  }
+
+  /// \returns the nodes by increasing degree, ties broken by id
+  std::vector<Node> NodesByDegree() const {
+    std::vector<Node> nodes(num_nodes());
+    katana::ParallelSTL::iota(nodes.begin(), nodes.end(), Node{0});
+    katana::ParallelSTL::sort(nodes.begin(), nodes.end(), [&](Node a, Node b) {
+      return std::make_pair(degree(a), a) < std::make_pair(degree(b), b);
+    });
+    return nodes;
+  }
+
+private:
+  std::vector<uint64_t> offsets_;
+  std::vector<Node> neighbors_;
+};
+
+PropIndexVec
+ToPropIndexVec(const std::vector<Node>& order) {
+  PropIndexVec ret;
+  ret.allocateInterleaved(order.size());
+  katana::ParallelSTL::copy(order.begin(), order.end(), ret.begin());
+  return ret;
+}
+
+/// A max priority queue of nodes whose keys change by small steps; see the
+/// Gorder paper. Nodes with the same key are kept in a linked list.
+class UnitHeap {
+public:
+  explicit UnitHeap(uint64_t num_nodes)
+      : key_(num_nodes, 0),
+        prev_(num_nodes, kNoNode),
+        next_(num_nodes, kNoNode),
+        in_heap_(num_nodes, true),
+        heads_(1, kNoNode) {
+    // lower ids first among equal keys
+    for (uint64_t i = num_nodes; i > 0; --i) {
+      Link(i - 1);
+    }
+  }
+
+  void Add(Node n, int64_t delta) {
+    if (!in_heap_[n]) {
+      return;
+    }
+    Unlink(n);
+    key_[n] += delta;
+    Link(n);
+  }
+
+  void Remove(Node n) {
+    Unlink(n);
+    in_heap_[n] = false;
+  }
+
+  Node PopMax() {
+    while (heads_[max_key_] == kNoNode) {
+      KATANA_LOG_DEBUG_ASSERT(max_key_ > 0);
+      --max_key_;
+    }
+    Node n = heads_[max_key_];
+    Remove(n);
+    return n;
+  }
+
+private:
+  void Link(Node n) {
+    uint64_t key = key_[n];
+    if (key >= heads_.size()) {
+      heads_.resize(key + 1, kNoNode);
+    }
+    prev_[n] = kNoNode;
+    next_[n] = heads_[key];
+    if (next_[n] != kNoNode) {
+      prev_[next_[n]] = n;
+    }
+    heads_[key] = n;
+    max_key_ = std::max(max_key_, key);
+  }
+
+  void Unlink(Node n) {
+    if (prev_[n] != kNoNode) {
+      next_[prev_[n]] = next_[n];
+    } else {
+      heads_[key_[n]] = next_[n];
+    }
+    if (next_[n] != kNoNode) {
+      prev_[next_[n]] = prev_[n];
+    }
+  }
+
+  std::vector<int64_t> key_;
+  std::vector<Node> prev_;
+  std::vector<Node> next_;
+  std::vector<bool> in_heap_;
+  std::vector<Node> heads_;
+  uint64_t max_key_{0};
+};
+
+/// A breadth-first order of graph that starts each component at the first
+/// node of starts not yet visited and visits the children of a node by
+/// increasing degree if children_by_degree is set and by id otherwise
+std::vector<Node>
+BreadthFirst(
+    const UndirectedGraph& graph, const std::vector<Node>& starts,
+    bool children_by_degree) {
+  // levels smaller than this are expanded serially
+  constexpr uint64_t kParallelLevelSize = 1024;
+  constexpr uint64_t kUnclaimed = std::numeric_limits<uint64_t>::max();
+
+  const uint64_t num_nodes = graph.num_nodes();
+  std::vector<uint8_t> visited(num_nodes, 0);
+  // position in order of the first node of the current level to reach a node
+  std::vector<std::atomic<uint64_t>> parent(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { parent[n].store(kUnclaimed); }, katana::no_stats());
+
+  std::vector<Node> order;
+  order.reserve(num_nodes);
+  std::vector<std::vector<Node>> children;
+
+  auto for_level = [&](uint64_t begin, uint64_t end, const auto& fn) {
+    if (end - begin < kParallelLevelSize) {
+      for (uint64_t p = begin; p < end; ++p) {
+        fn(p);
+      }
+    } else {
+      katana::do_all(
+          katana::iterate(begin, end), fn, katana::steal(), katana::no_stats());
+    }
+  };
+
+  for (Node start : starts) {
+    if (visited[start]) {
+      continue;
+    }
+    visited[start] = 1;
+    uint64_t level_begin = order.size();
+    order.emplace_back(start);
+
+    while (level_begin < order.size()) {
+      uint64_t level_end = order.size();
+
+      // Each unvisited neighbor becomes the child of its first parent in the
+      // level, which is what a serial BFS would pick
+      for_level(level_begin, level_end, [&](uint64_t p) {
+        Node node = order[p];
+        for (const Node* u = graph.begin(node); u != graph.end(node); ++u) {
+          if (!visited[*u]) {
+            katana::atomicMin(parent[*u], p);
+          }
+        }
+      });
+
+      children.clear();
+      children.resize(level_end - level_begin);
+      for_level(level_begin, level_end, [&](uint64_t p) {
+        Node node = order[p];
+        std::vector<Node>& mine = children[p - level_begin];
+        for (const Node* u = graph.begin(node); u != graph.end(node); ++u) {
+          if (!visited[*u] && parent[*u].load() == p) {
+            mine.emplace_back(*u);
+          }
+        }
+        // neighbors, and so children, are sorted by id
+        if (children_by_degree) {
+          std::sort(mine.begin(), mine.end(), [&](Node a, Node b) {
+            return std::make_pair(graph.degree(a), a) <
+                   std::make_pair(graph.degree(b), b);
+          });
+        }
+      });
+
+      for (const auto& mine : children) {
+        for (Node u : mine) {
+          visited[u] = 1;
+          order.emplace_back(u);
+        }
+      }
+      level_begin = level_end;
+    }
+  }
+
+  return order;
+}
+
+}  // namespace
+
+katana::GraphTopologyTypes::PropIndexVec
+katana::ReverseCuthillMcKeeOrder(const GraphTopology& topo) noexcept {
+  UndirectedGraph graph(topo);
+  // Starting each component at a lowest degree node approximates starting it
+  // at a peripheral node
+  std::vector<Node> order =
+      BreadthFirst(graph, graph.NodesByDegree(), /*children_by_degree=*/true);
+  std::reverse(order.begin(), order.end());
+  return ToPropIndexVec(order);
+}
+
+katana::GraphTopologyTypes::PropIndexVec
+katana::BreadthFirstOrder(const GraphTopology& topo) noexcept {
+  UndirectedGraph graph(topo);
+  std::vector<Node> starts(graph.num_nodes());
+  katana::ParallelSTL::iota(starts.begin(), starts.end(), Node{0});
+  return ToPropIndexVec(
+      BreadthFirst(graph, starts, /*children_by_degree=*/false));
+}
+
+katana::GraphTopologyTypes::PropIndexVec
+katana::DegreeOrder(const GraphTopology& topo) noexcept {
+  PropIndexVec order;
+  order.allocateInterleaved(topo.num_nodes());
+  katana::ParallelSTL::iota(
+      order.begin(), order.end(), GraphTopologyTypes::PropertyIndex{0});
+  katana::ParallelSTL::sort(order.begin(), order.end(), [&](auto a, auto b) {
+    auto da = topo.degree(a);
+    auto db = topo.degree(b);
+    return da > db || (da == db && a < b);
+  });
+  return order;
+}
+
+katana::GraphTopologyTypes::PropIndexVec
+katana::GorderOrder(const GraphTopology& topo, uint32_t window) noexcept {
+  constexpr uint64_t kMinHubDegree = 256;
+
+  UndirectedGraph graph(topo);
+  const uint64_t num_nodes = graph.num_nodes();
+  if (num_nodes == 0) {
+    return PropIndexVec{};
+  }
+  const uint64_t hub_degree = std::max<uint64_t>(
+      kMinHubDegree, static_cast<uint64_t>(std::sqrt(num_nodes)));
+
+  UnitHeap heap(num_nodes);
+
+  // Score unplaced nodes by their relation to v: one for being a neighbor
+  // and one for each neighbor they share with it
+  auto update = [&](Node v, int64_t delta) {
+    for (const Node* u = graph.begin(v); u != graph.end(v); ++u) {
+      heap.Add(*u, delta);
+      if (graph.degree(*u) > hub_degree) {
+        continue;
+      }
+      for (const Node* x = graph.begin(*u); x != graph.end(*u); ++x) {
+        if (*x != v) {
+          heap.Add(*x, delta);
+        }
+      }
+    }
+  };
+
+  std::vector<Node> order;
+  order.reserve(num_nodes);
+
+  Node next = 0;
+  for (Node n = 1; n < num_nodes; ++n) {
+    if (graph.degree(n) > graph.degree(next)) {
+      next = n;
+    }
+  }
+  heap.Remove(next);
+
+  for (uint64_t i = 0; i < num_nodes; ++i) {
+    order.emplace_back(next);
+    update(next, 1);
+    if (order.size() > window) {
+      update(order[order.size() - 1 - window], -1);
+    }
+    if (i + 1 < num_nodes) {
+      next = heap.PopMax();
+    }
+  }
+
+  return ToPropIndexVec(order);
+}
+
+katana::GraphTopologyTypes::PropIndexVec
+katana::RabbitOrder(const GraphTopology& topo) noexcept {
+  UndirectedGraph graph(topo);
+  const uint64_t num_nodes = graph.num_nodes();
+
+  // Edges of each community to other nodes, which may since have been
+  // merged into other communities, with their multiplicity
+  std::vector<std::vector<std::pair<Node, uint64_t>>> edges(num_nodes);
+  std::vector<uint64_t> compacted_size(num_nodes);
+  std::vector<uint64_t> strength(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        for (const Node* u = graph.begin(n); u != graph.end(n); ++u) {
+          edges[n].emplace_back(*u, 1);
+        }
+        compacted_size[n] = edges[n].size();
+        strength[n] = graph.degree(n);
+      },
+      katana::steal(), katana::no_stats());
+
+  const double total_strength = static_cast<double>(
+      std::accumulate(strength.begin(), strength.end(), uint64_t{0}));
+
+  // union-find of the merges, and the dendrogram as lists of children
+  std::vector<Node> merged_into(num_nodes);
+  std::vector<Node> first_child(num_nodes, kNoNode);
+  std::vector<Node> next_sibling(num_nodes, kNoNode);
+  katana::ParallelSTL::iota(merged_into.begin(), merged_into.end(), Node{0});
+
+  auto find = [&](Node n) {
+    while (merged_into[n] != n) {
+      merged_into[n] = merged_into[merged_into[n]];
+      n = merged_into[n];
+    }
+    return n;
+  };
+
+  // Combine the edges of community c by the community at their other end
+  std::vector<uint64_t> weight_to(num_nodes, 0);
+  std::vector<Node> touched;
+  auto compact = [&](Node c) {
+    touched.clear();
+    for (const auto& [v, w] : edges[c]) {
+      Node r = find(v);
+      if (r == c) {
+        continue;
+      }
+      if (weight_to[r] == 0) {
+        touched.emplace_back(r);
+      }
+      weight_to[r] += w;
+    }
+    edges[c].clear();
+    for (Node r : touched) {
+      edges[c].emplace_back(r, weight_to[r]);
+      weight_to[r] = 0;
+    }
+    compacted_size[c] = edges[c].size();
+  };
+
+  for (Node u : graph.NodesByDegree()) {
+    if (total_strength == 0) {
+      break;
+    }
+    compact(u);
+
+    // merge into the neighbor with the largest modularity gain, if any gains
+    Node best = kNoNode;
+    double best_gain = 0;
+    for (const auto& [v, w] : edges[u]) {
+      double gain =
+          w / total_strength - static_cast<double>(strength[u]) * strength[v] /
+                                   (total_strength * total_strength);
+      if (gain > best_gain) {
+        best = v;
+        best_gain = gain;
+      }
+    }
+    if (best == kNoNode) {
+      continue;
+    }
+
+    merged_into[u] = best;
+    strength[best] += strength[u];
+    edges[best].insert(edges[best].end(), edges[u].begin(), edges[u].end());
+    std::vector<std::pair<Node, uint64_t>>().swap(edges[u]);
+    // keep the edges of large communities from growing without bound
+    if (edges[best].size() > 2 * compacted_size[best]) {
+      compact(best);
+    }
+    next_sibling[u] = first_child[best];
+    first_child[best] = u;
+  }
+
+  std::vector<Node> order;
+  order.reserve(num_nodes);
+  std::vector<Node> stack;
+  for (Node root = 0; root < num_nodes; ++root) {
+    if (merged_into[root] != root) {
+      continue;
+    }
+    stack.emplace_back(root);
+    while (!stack.empty()) {
+      Node n = stack.back();
+      stack.pop_back();
+      order.emplace_back(n);
+      for (Node c = first_child[n]; c != kNoNode; c = next_sibling[c]) {
+        stack.emplace_back(c);
+      }
+    }
+  }
+
+  return ToPropIndexVec(order);
+}
@@ -22,6 +22,7 @@
 #include <mutex>
 
 #include "katana/Logging.h"
+#include "katana/MemoryBudget.h"
 #include "katana/SimpleLock.h"
 
 #ifdef __linux__
@@ -76,7 +77,7 @@ katana::allocSize() {
 }
 
 void*
-katana::allocPages(unsigned num, bool preFault) {
+katana::tryAllocPages(unsigned num, bool preFault) {
   if (num == 0) {
     return nullptr;
   }
@@ -89,8 +90,9 @@ katana::allocPages(unsigned num, bool preFault) {
   }
 
   if (!ptr) {
-    KATANA_LOG_FATAL("failed to allocate: {}", errno);
+    return nullptr;
   }
+  internal::ChargeMemoryBudget(num * hugePageSize);
 
   if (preFault && doHandMap) {
     for (size_t x = 0; x < num * hugePageSize; x += 4096) {
@@ -101,10 +103,25 @@ katana::allocPages(unsigned num, bool preFault) {
   return ptr;
 }
 
+void*
+katana::allocPages(unsigned num, bool preFault) {
+  if (num == 0) {
+    return nullptr;
+  }
+  void* ptr = tryAllocPages(num, preFault);
+  if (!ptr) {
+    KATANA_LOG_FATAL("failed to allocate: {}", errno);
+  }
+  return ptr;
+}
+
 void
 katana::freePages(void* ptr, unsigned num) {
-  std::lock_guard<SimpleLock> lg(allocLock);
-  if (munmap(ptr, num * hugePageSize) != 0) {
-    KATANA_LOG_FATAL("munmap failed: {}", errno);
+  {
+    std::lock_guard<SimpleLock> lg(allocLock);
+    if (munmap(ptr, num * hugePageSize) != 0) {
+      KATANA_LOG_FATAL("munmap failed: {}", errno);
+    }
   }
+  internal::UnchargeMemoryBudget(num * hugePageSize);
 }
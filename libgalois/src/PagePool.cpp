@@ -23,6 +23,15 @@
 
 static katana::internal::PageAllocState<>* PA;
 
+//! \returns PA, starting a lazily started SharedMem, which sets it, first
+static katana::internal::PageAllocState<>*
+State() {
+  if (!PA) {
+    katana::GetThreadPool();
+  }
+  return PA;
+}
+
 void
 katana::internal::setPagePoolState(PageAllocState<>* pa) {
   KATANA_LOG_VASSERT(!(PA && pa), "double Initialization of PageAllocState");
@@ -31,31 +40,31 @@ katana::internal::setPagePoolState(PageAllocState<>* pa) {
 
 int
 katana::numPagePoolAllocTotal() {
-  return PA->countAll();
+  return State()->countAll();
 }
 
 int
 katana::numPagePoolAllocForThread(unsigned tid) {
-  return PA->count(tid);
+  return State()->count(tid);
 }
 
 void*
 katana::pagePoolAlloc() {
-  return PA->pageAlloc();
+  return State()->pageAlloc();
 }
 
 void
 katana::pagePoolPreAlloc(unsigned num) {
   while (num--) {
-    PA->pagePreAlloc();
+    State()->pagePreAlloc();
   }
 }
 
 void
 katana::pagePoolEnsurePreallocated(unsigned num) {
   auto tid = katana::ThreadPool::getTID();
-  while (PA->freeCount(tid) < num) {
-    PA->pagePreAlloc();
+  while (State()->freeCount(tid) < num) {
+    State()->pagePreAlloc();
   }
 }
 
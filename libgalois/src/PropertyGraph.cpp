@@ -2,9 +2,29 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <future>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
+
+#include <arrow/compute/api.h>
 
 #include "katana/ArrowInterchange.h"
+#include "katana/Bag.h"
+#include "katana/BitMath.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Env.h"
+#include "katana/Fingerprint.h"
+#include "katana/HWTopo.h"
 #include "katana/Iterators.h"
 #include "katana/Logging.h"
 #include "katana/Loops.h"
@@ -13,6 +33,7 @@
 #include "katana/Platform.h"
 #include "katana/Properties.h"
 #include "katana/Result.h"
+#include "tsuba/CSRTopology.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/RDG.h"
@@ -57,12 +78,105 @@ CheckTopology(
   return !has_bad_adj && !has_bad_dest;
 }
 
+/// MapCompressedTopology decodes a version 3 topology file (see
+/// tsuba/CSRTopology.h) into a GraphTopology, one block of nodes per task.
+/// The whole file is decoded up front: the result is as large in memory as
+/// one loaded from an uncompressed file.
+katana::Result<katana::GraphTopology>
+MapCompressedTopology(const tsuba::FileView& file_view) {
+  const auto* header = file_view.ptr<tsuba::CSRTopologyHeader>();
+  const uint64_t num_nodes = header->num_nodes;
+  const uint64_t num_edges = header->num_edges;
+  const uint64_t num_blocks = tsuba::CSRCompressedNumBlocks(num_nodes);
+  const uint64_t edges_offset = tsuba::CSRCompressedEdgesOffset(*header);
+
+  if (file_view.size() < edges_offset) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "file_view size: {} expected {}",
+        file_view.size(), edges_offset);
+  }
+
+  const uint64_t* out_indices =
+      file_view.ptr<uint64_t>(sizeof(tsuba::CSRTopologyHeader));
+  const uint64_t* block_offsets =
+      file_view.ptr<uint64_t>(tsuba::CSRCompressedBlockOffsetsOffset(*header));
+  const uint8_t* encoded = file_view.ptr<uint8_t>(edges_offset);
+
+  if (file_view.size() < edges_offset + block_offsets[num_blocks]) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "file_view size: {} expected {}",
+        file_view.size(), edges_offset + block_offsets[num_blocks]);
+  }
+  if (num_nodes > 0 && out_indices[num_nodes - 1] != num_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "last out index {} does not match number of edges {}",
+        out_indices[num_nodes - 1], num_edges);
+  }
+
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::copy(
+      &out_indices[0], &out_indices[num_nodes], adj_indices.begin());
+
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+
+  std::atomic<bool> is_corrupt = false;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        if (block_offsets[block] > block_offsets[block + 1] ||
+            block_offsets[block + 1] > block_offsets[num_blocks]) {
+          is_corrupt = true;
+          return;
+        }
+        const uint8_t* pos = encoded + block_offsets[block];
+        const uint8_t* block_end = encoded + block_offsets[block + 1];
+        uint64_t first_node = block * tsuba::kCSRCompressedBlockNodes;
+        uint64_t last_node = std::min(
+            first_node + tsuba::kCSRCompressedBlockNodes, num_nodes);
+
+        for (uint64_t n = first_node; n < last_node; ++n) {
+          uint64_t e = n > 0 ? out_indices[n - 1] : 0;
+          uint64_t e_end = out_indices[n];
+          if (e_end < e || e_end > num_edges) {
+            is_corrupt = true;
+            return;
+          }
+          // Unsigned so that a corrupt delta wraps rather than overflows
+          uint64_t prev = n;
+          for (; e < e_end; ++e) {
+            uint64_t delta = 0;
+            size_t size = katana::DecodeVarint(pos, block_end, &delta);
+            prev += static_cast<uint64_t>(katana::ZigZagDecode(delta));
+            if (size == 0 || prev >= num_nodes) {
+              is_corrupt = true;
+              return;
+            }
+            pos += size;
+            dests[e] = static_cast<katana::GraphTopology::Node>(prev);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (is_corrupt) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "compressed topology is corrupt");
+  }
+
+  KATANA_LOG_DEBUG_ASSERT(
+      CheckTopology(adj_indices.data(), num_nodes, dests.data(), num_edges));
+  return katana::GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
 /// MapTopology takes a file buffer of a topology file and extracts the
 /// topology files.
 ///
 /// Format of a topology file (borrowed from the original FileGraph.cpp:
 ///
-///   uint64_t version: 1
+///   uint64_t version: 1 (version 3 is handled by MapCompressedTopology)
 ///   uint64_t sizeof_edge_data: size of edge data element
 ///   uint64_t num_nodes: number of nodes
 ///   uint64_t num_edges: number of edges
@@ -73,13 +187,20 @@ CheckTopology(
 ///
 /// Since property graphs store their edge data separately, we will
 /// ignore the size_of_edge_data (data[1]).
+///
+/// If \param out_of_core, the topology refers to the file in place (see
+/// GraphTopology::MakeOutOfCore) rather than copying it.
 katana::Result<katana::GraphTopology>
-MapTopology(const tsuba::FileView& file_view) {
+MapTopology(const tsuba::FileView& file_view, bool out_of_core) {
   const auto* data = file_view.ptr<uint64_t>();
   if (file_view.size() < 4) {
     return katana::ErrorCode::InvalidArgument;
   }
 
+  if (data[0] == tsuba::kCSRTopologyCompressedVersion) {
+    return MapCompressedTopology(file_view);
+  }
+
   if (data[0] != 1) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -99,13 +220,124 @@ MapTopology(const tsuba::FileView& file_view) {
   const uint32_t* out_dests =
       reinterpret_cast<const uint32_t*>(out_indices + num_nodes);
 
+  if (out_of_core) {
+    return katana::GraphTopology::MakeOutOfCore(
+        out_indices, num_nodes, out_dests, num_edges, file_view.mapping());
+  }
+
   KATANA_LOG_DEBUG_ASSERT(
       CheckTopology(out_indices, num_nodes, out_dests, num_edges));
   return katana::GraphTopology(out_indices, num_nodes, out_dests, num_edges);
 }
 
+/// WideAdjData returns the 64-bit edge offsets of \param topology, widening
+/// them into \param storage if the topology is compact
+const uint64_t*
+WideAdjData(
+    const katana::GraphTopology& topology,
+    katana::NUMAArray<uint64_t>* storage) {
+  if (!topology.is_compact()) {
+    return topology.adj_data();
+  }
+  const uint32_t* compact = topology.compact_adj_data();
+  storage->allocateInterleaved(topology.num_nodes());
+  katana::ParallelSTL::copy(
+      compact, compact + topology.num_nodes(), storage->begin());
+  return storage->data();
+}
+
+/// WriteCompressedTopology produces a version 3 topology file (see
+/// tsuba/CSRTopology.h). Blocks are sized and then encoded in parallel.
+katana::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteCompressedTopology(const katana::GraphTopology& topology) {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error();
+  }
+  const uint64_t num_nodes = topology.num_nodes();
+  const uint64_t num_edges = topology.num_edges();
+  const uint64_t num_blocks = tsuba::CSRCompressedNumBlocks(num_nodes);
+  katana::NUMAArray<uint64_t> wide_adj;
+  const auto* adj = WideAdjData(topology, &wide_adj);
+  const auto* dests = topology.dest_data();
+
+  // visit(pos, delta) for every edge of every node in block
+  auto for_each_delta = [&](uint64_t block, auto visit) {
+    uint64_t first_node = block * tsuba::kCSRCompressedBlockNodes;
+    uint64_t last_node =
+        std::min(first_node + tsuba::kCSRCompressedBlockNodes, num_nodes);
+    for (uint64_t n = first_node; n < last_node; ++n) {
+      int64_t prev = static_cast<int64_t>(n);
+      for (uint64_t e = n > 0 ? adj[n - 1] : 0; e < adj[n]; ++e) {
+        int64_t dest = static_cast<int64_t>(dests[e]);
+        visit(katana::ZigZagEncode(dest - prev));
+        prev = dest;
+      }
+    }
+  };
+
+  std::vector<uint64_t> block_offsets(num_blocks + 1, 0);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        uint64_t size = 0;
+        for_each_delta(
+            block, [&](uint64_t delta) { size += katana::VarintSize(delta); });
+        block_offsets[block + 1] = size;
+      },
+      katana::steal(), katana::no_stats());
+  std::partial_sum(
+      block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+
+  std::vector<uint8_t> encoded(block_offsets[num_blocks]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        uint8_t* pos = encoded.data() + block_offsets[block];
+        for_each_delta(block, [&](uint64_t delta) {
+          pos += katana::EncodeVarint(delta, pos);
+        });
+      },
+      katana::steal(), katana::no_stats());
+
+  uint64_t data[4] = {
+      tsuba::kCSRTopologyCompressedVersion, 0, num_nodes, num_edges};
+  arrow::Status aro_sts = ff->Write(&data, 4 * sizeof(uint64_t));
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+
+  if (num_nodes) {
+    aro_sts = ff->Write(arrow::Buffer::Wrap(adj, num_nodes));
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+
+  aro_sts = ff->Write(arrow::Buffer::Wrap(block_offsets));
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+
+  if (!encoded.empty()) {
+    aro_sts = ff->Write(arrow::Buffer::Wrap(encoded));
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
 katana::Result<std::unique_ptr<tsuba::FileFrame>>
 WriteTopology(const katana::GraphTopology& topology) {
+  // Set KATANA_COMPRESS_TOPOLOGY to store topologies in the compressed
+  // format; both formats are read transparently. Only the file is smaller:
+  // loading decompresses it in full.
+  if (bool compress = false;
+      katana::GetEnv("KATANA_COMPRESS_TOPOLOGY", &compress) && compress) {
+    return WriteCompressedTopology(topology);
+  }
+
   auto ff = std::make_unique<tsuba::FileFrame>();
   if (auto res = ff->Init(); !res) {
     return res.error();
@@ -119,8 +351,9 @@ WriteTopology(const katana::GraphTopology& topology) {
     return tsuba::ArrowToTsuba(aro_sts.code());
   }
 
+  katana::NUMAArray<uint64_t> wide_adj;
   if (num_nodes) {
-    const auto* raw = topology.adj_data();
+    const auto* raw = WideAdjData(topology, &wide_adj);
     static_assert(std::is_same_v<std::decay_t<decltype(*raw)>, uint64_t>);
     auto buf = arrow::Buffer::Wrap(raw, num_nodes);
     aro_sts = ff->Write(buf);
@@ -167,7 +400,6 @@ GetEntityTypeIDsFromProperties(
   }
 
   // collect the list of types
-  std::vector<int> type_field_indices;
   using BoolPropertyColumn = PropertyColumn<arrow::BooleanArray>;
   std::vector<BoolPropertyColumn> bool_properties;
   using UInt8PropertyColumn = PropertyColumn<arrow::UInt8Array>;
@@ -180,13 +412,11 @@ GetEntityTypeIDsFromProperties(
     // a bool or uint8 property is (always) considered a type
     // TODO(roshan) make this customizable by the user
     if (current_field->type()->Equals(arrow::boolean())) {
-      type_field_indices.push_back(i);
       std::shared_ptr<arrow::Array> property = properties->column(i)->chunk(0);
       auto bool_property =
           std::static_pointer_cast<arrow::BooleanArray>(property);
       bool_properties.emplace_back(i, bool_property);
     } else if (current_field->type()->Equals(arrow::uint8())) {
-      type_field_indices.push_back(i);
       std::shared_ptr<arrow::Array> property = properties->column(i)->chunk(0);
       auto uint8_property =
           std::static_pointer_cast<arrow::UInt8Array>(property);
@@ -194,65 +424,107 @@ GetEntityTypeIDsFromProperties(
     }
   }
 
-  // assign a new ID to each type
-  // NB: cannot use unordered_map without defining a hash function for vectors;
-  // performance is not affected here because the map is very small (<=256)
-  std::map<katana::gstl::Vector<int>, katana::EntityTypeID>
-      type_field_indices_to_id;
-  for (int i : type_field_indices) {
-    const std::shared_ptr<arrow::Field>& current_field = schema->field(i);
+  // type column p is field type_field_indices[p]; the bool columns come
+  // first, which is the order of the names of combinations of types
+  std::vector<int> type_field_indices;
+  for (const auto& bool_property : bool_properties) {
+    type_field_indices.push_back(bool_property.field_index);
+  }
+  for (const auto& uint8_property : uint8_properties) {
+    type_field_indices.push_back(uint8_property.field_index);
+  }
+
+  // exclude kUnknownEntityType and kInvalidEntityType
+  constexpr size_t kMaxEntityTypes =
+      std::numeric_limits<katana::EntityTypeID>::max() - size_t{2};
+  // each type column is an atomic type, which also bounds the size of the
+  // sets of type columns below
+  if (type_field_indices.size() > kMaxEntityTypes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "number of type properties is {} "
+        "but only up to {} types are supported currently",
+        type_field_indices.size(), kMaxEntityTypes);
+  }
+
+  // The type columns that are true in a row, as a set of positions in
+  // type_field_indices. Unlike a vector of field indices, it takes no
+  // allocation per row and is cheap to hash.
+  using TypeColumnSet =
+      std::bitset<size_t{std::numeric_limits<katana::EntityTypeID>::max()} + 1>;
+  auto get_type_columns = [&](int64_t row) {
+    TypeColumnSet type_columns;
+    size_t p = 0;
+    for (const auto& bool_property : bool_properties) {
+      if (bool_property.array->IsValid(row) &&
+          bool_property.array->Value(row)) {
+        type_columns.set(p);
+      }
+      ++p;
+    }
+    for (const auto& uint8_property : uint8_properties) {
+      if (uint8_property.array->IsValid(row) &&
+          uint8_property.array->Value(row)) {
+        type_columns.set(p);
+      }
+      ++p;
+    }
+    return type_columns;
+  };
+
+  // assign a new ID to each type, in the order of the fields
+  std::vector<size_t> positions(type_field_indices.size());
+  std::iota(positions.begin(), positions.end(), size_t{0});
+  std::sort(positions.begin(), positions.end(), [&](size_t a, size_t b) {
+    return type_field_indices[a] < type_field_indices[b];
+  });
+  std::unordered_map<TypeColumnSet, katana::EntityTypeID> type_columns_to_id;
+  for (size_t p : positions) {
+    const std::shared_ptr<arrow::Field>& current_field =
+        schema->field(type_field_indices[p]);
     const std::string& field_name = current_field->name();
     katana::EntityTypeID new_entity_type_id =
         entity_type_manager->AddAtomicEntityType(field_name);
-    katana::gstl::Vector<int> field_indices = {i};
-    type_field_indices_to_id.emplace(
-        std::make_pair(field_indices, new_entity_type_id));
-  }
-
-  // collect the list of unique combination of types
-  using FieldEntityType = katana::gstl::Vector<int>;
-  // NB: cannot use unordered_set without defining a hash function for vectors;
-  // performance is not affected here because the set is very small (<=256)
-  using FieldEntityTypeSet = katana::gstl::Set<FieldEntityType>;
-  FieldEntityTypeSet type_combinations;
-  katana::PerThreadStorage<FieldEntityTypeSet> type_combinations_pts;
+    TypeColumnSet type_columns;
+    type_columns.set(p);
+    type_columns_to_id.emplace(type_columns, new_entity_type_id);
+  }
+
+  // collect the list of unique combination of types in per-thread hash sets
+  using TypeColumnSetSet = std::unordered_set<TypeColumnSet>;
+  katana::PerThreadStorage<TypeColumnSetSet> type_combinations_pts;
   katana::do_all(
-      katana::iterate(int64_t{0}, properties->num_rows()), [&](int64_t row) {
-        FieldEntityType field_indices;
-        for (auto bool_property : bool_properties) {
-          if (bool_property.array->IsValid(row) &&
-              bool_property.array->Value(row)) {
-            field_indices.emplace_back(bool_property.field_index);
-          }
+      katana::iterate(int64_t{0}, properties->num_rows()),
+      [&](int64_t row) {
+        TypeColumnSet type_columns = get_type_columns(row);
+        if (type_columns.count() > 1) {
+          type_combinations_pts.getLocal()->emplace(type_columns);
         }
-        for (auto uint8_property : uint8_properties) {
-          if (uint8_property.array->IsValid(row) &&
-              uint8_property.array->Value(row)) {
-            field_indices.emplace_back(uint8_property.field_index);
-          }
-        }
-        if (field_indices.size() > 1) {
-          FieldEntityTypeSet& local_type_combinations =
-              *type_combinations_pts.getLocal();
-          local_type_combinations.emplace(field_indices);
+      },
+      katana::steal());
+
+  // merge them ordered by the field indices of the combinations so that the
+  // IDs do not depend on the number of threads
+  std::map<std::vector<int>, TypeColumnSet> type_combinations;
+  for (unsigned t = 0, n = type_combinations_pts.size(); t < n; t++) {
+    for (const TypeColumnSet& type_columns :
+         *type_combinations_pts.getRemote(t)) {
+      std::vector<int> field_indices;
+      for (size_t p = 0; p < type_field_indices.size(); ++p) {
+        if (type_columns.test(p)) {
+          field_indices.emplace_back(type_field_indices[p]);
         }
-      });
-  for (unsigned t = 0, n = katana::activeThreads; t < n; t++) {
-    FieldEntityTypeSet& remote_type_combinations =
-        *type_combinations_pts.getRemote(t);
-    for (auto& type_combination : remote_type_combinations) {
-      type_combinations.emplace(type_combination);
+      }
+      type_combinations.emplace(std::move(field_indices), type_columns);
     }
   }
   // deallocate PerThreadStorage in parallel
   katana::on_each([&](unsigned, unsigned) {
-    FieldEntityTypeSet& local_type_combinations =
-        *type_combinations_pts.getLocal();
-    local_type_combinations = FieldEntityTypeSet();
+    *type_combinations_pts.getLocal() = TypeColumnSetSet();
   });
 
   // assign a new ID to each unique combination of types
-  for (const FieldEntityType& field_indices : type_combinations) {
+  for (const auto& [field_indices, type_columns] : type_combinations) {
     std::vector<std::string> field_names;
     for (int i : field_indices) {
       const std::shared_ptr<arrow::Field>& current_field = schema->field(i);
@@ -261,8 +533,7 @@ GetEntityTypeIDsFromProperties(
     }
     katana::EntityTypeID new_entity_type_id =
         entity_type_manager->AddNonAtomicEntityType(field_names);
-    type_field_indices_to_id.emplace(
-        std::make_pair(field_indices, new_entity_type_id));
+    type_columns_to_id.emplace(type_columns, new_entity_type_id);
   }
 
   // assert that all type IDs (including kUnknownEntityType) and
@@ -275,9 +546,7 @@ GetEntityTypeIDsFromProperties(
         "number of unique combination of types is {} "
         "but only up to {} is supported currently",
         // exclude kUnknownEntityType
-        entity_type_manager->GetNumEntityTypes() - 1,
-        // exclude kUnknownEntityType and kInvalidEntityType
-        std::numeric_limits<katana::EntityTypeID>::max() - 2);
+        entity_type_manager->GetNumEntityTypes() - 1, kMaxEntityTypes);
   }
 
   // allocate type IDs array
@@ -285,27 +554,13 @@ GetEntityTypeIDsFromProperties(
   int64_t num_rows = properties->num_rows();
   entity_type_ids.allocateInterleaved(num_rows);
 
-  // assign the type ID for each row
+  // assign the type ID for each row; the map is only read here
   katana::do_all(katana::iterate(int64_t{0}, num_rows), [&](int64_t row) {
-    FieldEntityType field_indices;
-    for (auto bool_property : bool_properties) {
-      if (bool_property.array->IsValid(row) &&
-          bool_property.array->Value(row)) {
-        field_indices.emplace_back(bool_property.field_index);
-      }
-    }
-    for (auto uint8_property : uint8_properties) {
-      if (uint8_property.array->IsValid(row) &&
-          uint8_property.array->Value(row)) {
-        field_indices.emplace_back(uint8_property.field_index);
-      }
-    }
-    if (field_indices.empty()) {
+    TypeColumnSet type_columns = get_type_columns(row);
+    if (type_columns.none()) {
       entity_type_ids[row] = katana::kUnknownEntityType;
     } else {
-      katana::EntityTypeID entity_type_id =
-          type_field_indices_to_id.at(field_indices);
-      entity_type_ids[row] = entity_type_id;
+      entity_type_ids[row] = type_columns_to_id.at(type_columns);
     }
   });
 
@@ -323,16 +578,91 @@ GetUnknownEntityTypeIDs(uint64_t num_rows) {
   return entity_type_ids;
 }
 
+/// A bool or uint8 property is (always) considered a type; matches
+/// GetEntityTypeIDsFromProperties
+bool
+IsTypeField(const arrow::Field& field) {
+  return field.type()->Equals(arrow::boolean()) ||
+         field.type()->Equals(arrow::uint8());
+}
+
+/// The stages of a tsuba::RDGLoadOptions::pipelined load after the topology
+/// has been mapped, while the selected properties are still being read
+katana::Result<void>
+LoadPipelinedProperties(
+    katana::PropertyGraph* pg, const tsuba::RDGLoadOptions& opts) {
+  // a lazy graph loads the type properties as it constructs the types and
+  // the others as they are accessed, each waiting only for its own read
+  if (opts.lazy_properties) {
+    return pg->ConstructEntityTypeIDs();
+  }
+
+  std::vector<std::string> node_names =
+      opts.node_properties.value_or(pg->ListNodeProperties());
+  std::vector<std::string> edge_names =
+      opts.edge_properties.value_or(pg->ListEdgeProperties());
+  auto is_type = [](const std::shared_ptr<arrow::Schema>& schema,
+                    const std::string& name) {
+    std::shared_ptr<arrow::Field> field = schema->GetFieldByName(name);
+    return field != nullptr && IsTypeField(*field);
+  };
+
+  // Types first, in the order they are loaded in, so that the entity type
+  // IDs are the same as if all properties were loaded first. Properties
+  // that are already loaded were not pipelined (see RDG::Make).
+  for (const std::string& name : node_names) {
+    if (is_type(pg->full_node_schema(), name) && !pg->HasNodeProperty(name)) {
+      KATANA_CHECKED_CONTEXT(
+          pg->LoadNodeProperty(name), "loading node property {}", name);
+    }
+  }
+  for (const std::string& name : edge_names) {
+    if (is_type(pg->full_edge_schema(), name) && !pg->HasEdgeProperty(name)) {
+      KATANA_CHECKED_CONTEXT(
+          pg->LoadEdgeProperty(name), "loading edge property {}", name);
+    }
+  }
+  KATANA_CHECKED(pg->ConstructEntityTypeIDs());
+
+  // Every property before a position is loaded by the time a property is
+  // inserted there, so the columns end up in the order they were selected in
+  for (size_t i = 0; i < node_names.size(); ++i) {
+    if (!pg->HasNodeProperty(node_names[i])) {
+      KATANA_CHECKED_CONTEXT(
+          pg->LoadNodeProperty(node_names[i], static_cast<int>(i)),
+          "loading node property {}", node_names[i]);
+    }
+  }
+  for (size_t i = 0; i < edge_names.size(); ++i) {
+    if (!pg->HasEdgeProperty(edge_names[i])) {
+      KATANA_CHECKED_CONTEXT(
+          pg->LoadEdgeProperty(edge_names[i], static_cast<int>(i)),
+          "loading edge property {}", edge_names[i]);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Make(
     std::unique_ptr<tsuba::RDGFile> rdg_file, tsuba::RDG&& rdg) {
-  auto topo_result = MapTopology(rdg.topology_file_storage());
+  auto topo_result =
+      MapTopology(rdg.topology_file_storage(), rdg.out_of_core_topology());
   if (!topo_result) {
     return topo_result.error();
   }
 
+  if (bool compact = true;
+      !katana::GetEnv("KATANA_COMPACT_TOPOLOGY", &compact) || compact) {
+    topo_result.value().Compact();
+  }
+  if (bool numa = false;
+      katana::GetEnv("KATANA_NUMA_TOPOLOGY", &numa) && numa) {
+    topo_result.value().PartitionForNUMA();
+  }
+
   return std::make_unique<PropertyGraph>(
       std::move(rdg_file), std::move(rdg), std::move(topo_result.value()));
 }
@@ -358,8 +688,87 @@ katana::PropertyGraph::Make(
     return handle.error();
   }
 
-  return MakePropertyGraph(
-      std::make_unique<tsuba::RDGFile>(handle.value()), opts);
+  std::unique_ptr<PropertyGraph> pg = KATANA_CHECKED(MakePropertyGraph(
+      std::make_unique<tsuba::RDGFile>(handle.value()), opts));
+  pg->lazy_properties_ = opts.lazy_properties;
+  if (opts.pipelined) {
+    KATANA_CHECKED(LoadPipelinedProperties(pg.get(), opts));
+  }
+  // Lazily loaded graphs map stored indexes when they are asked for
+  if (!opts.lazy_properties) {
+    KATANA_CHECKED(pg->LoadIndexes());
+  }
+  return std::unique_ptr<PropertyGraph>(std::move(pg));
+}
+
+katana::Result<std::vector<std::unique_ptr<katana::PropertyGraph>>>
+katana::PropertyGraph::MakePartitions(
+    const std::string& rdg_name, const std::vector<uint32_t>& partition_ids,
+    const tsuba::RDGLoadOptions& opts, uint32_t max_concurrent) {
+  // Every partition is read from the same version of the RDG even if another
+  // version is committed while they load
+  tsuba::RDGFile first_file(
+      KATANA_CHECKED(tsuba::Open(rdg_name, tsuba::kReadWrite)));
+
+  uint64_t num_partitions = partition_ids.size();
+  std::vector<std::unique_ptr<tsuba::RDGFile>> files(num_partitions);
+  for (uint64_t i = 0; i < num_partitions; ++i) {
+    files[i] = std::make_unique<tsuba::RDGFile>(tsuba::Duplicate(first_file));
+  }
+
+  // Reading from storage dominates, so do that concurrently. Mapping the
+  // topology uses the thread pool, so that is done afterwards on this thread.
+  std::vector<std::optional<tsuba::RDG>> rdgs(num_partitions);
+  std::vector<katana::Result<void>> results(
+      num_partitions, katana::ResultSuccess());
+  std::atomic<uint64_t> next{0};
+  uint32_t num_sockets =
+      std::max(1U, katana::getHWTopo().machineTopoInfo.maxSockets);
+
+  auto load = [&]() {
+    for (uint64_t i = next++; i < num_partitions; i = next++) {
+      // threads started by the load inherit this binding
+      katana::bindThreadSelfToSocket(i % num_sockets);
+
+      tsuba::RDGLoadOptions part_opts = opts;
+      part_opts.partition_id_to_load = partition_ids[i];
+      auto rdg_res = tsuba::RDG::Make(*files[i], part_opts);
+      if (!rdg_res) {
+        results[i] = rdg_res.error().WithContext(
+            "loading partition {}", partition_ids[i]);
+        continue;
+      }
+      rdgs[i] = std::move(rdg_res.value());
+    }
+  };
+
+  uint64_t num_workers = num_partitions;
+  if (max_concurrent > 0) {
+    num_workers = std::min<uint64_t>(num_workers, max_concurrent);
+  }
+  std::vector<std::future<void>> workers;
+  for (uint64_t i = 0; i < num_workers; ++i) {
+    workers.emplace_back(std::async(std::launch::async, load));
+  }
+  for (auto& worker : workers) {
+    worker.get();
+  }
+
+  std::vector<std::unique_ptr<PropertyGraph>> graphs;
+  for (uint64_t i = 0; i < num_partitions; ++i) {
+    KATANA_CHECKED(results[i]);
+    std::unique_ptr<PropertyGraph> pg = KATANA_CHECKED_CONTEXT(
+        Make(std::move(files[i]), std::move(rdgs[i].value())),
+        "making graph for partition {}", partition_ids[i]);
+    pg->lazy_properties_ = opts.lazy_properties;
+    if (opts.pipelined) {
+      KATANA_CHECKED_CONTEXT(
+          LoadPipelinedProperties(pg.get(), opts),
+          "loading properties of partition {}", partition_ids[i]);
+    }
+    graphs.emplace_back(std::move(pg));
+  }
+  return graphs;
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -399,8 +808,111 @@ katana::PropertyGraph::Copy(
   return Make(rdg_dir(), opts);
 }
 
+namespace {
+
+katana::NUMAArray<katana::EntityTypeID>
+CopyEntityTypeIDs(const katana::NUMAArray<katana::EntityTypeID>& ids) {
+  katana::NUMAArray<katana::EntityTypeID> copy;
+  copy.allocateInterleaved(ids.size());
+  katana::ParallelSTL::copy(ids.begin(), ids.end(), copy.begin());
+  return copy;
+}
+
+/// A table of the columns \p names of the loaded properties \p schema,
+/// which shares them with the graph \p get looks them up in
+template <typename Get>
+katana::Result<std::shared_ptr<arrow::Table>>
+ShareProperties(
+    const std::shared_ptr<arrow::Schema>& schema,
+    const std::vector<std::string>& names, uint64_t num_rows, Get get) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : names) {
+    auto field = schema->GetFieldByName(name);
+    if (!field) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "property {} is not loaded",
+          name);
+    }
+    fields.emplace_back(std::move(field));
+    columns.emplace_back(get(name));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+/// The number of rows of the pieces of columns compared by each task of
+/// ColumnsEqual
+constexpr int64_t kCompareRows = int64_t{1} << 16;
+
+/// Like a->Equals(b), but pieces of the columns are compared in parallel and
+/// the comparison stops soon after a piece differs
+bool
+ColumnsEqual(
+    const std::shared_ptr<arrow::ChunkedArray>& a,
+    const std::shared_ptr<arrow::ChunkedArray>& b) {
+  if (a == b) {
+    return true;
+  }
+  if (!a || !b || a->length() != b->length() ||
+      a->null_count() != b->null_count() || !a->type()->Equals(b->type())) {
+    return false;
+  }
+
+  int64_t num_rows = a->length();
+  int64_t num_pieces = (num_rows + kCompareRows - 1) / kCompareRows;
+  std::atomic<bool> differ{false};
+  katana::do_all(
+      katana::iterate(int64_t{0}, num_pieces),
+      [&](int64_t piece) {
+        if (differ.load(std::memory_order_relaxed)) {
+          return;
+        }
+        int64_t begin = piece * kCompareRows;
+        int64_t length = std::min(kCompareRows, num_rows - begin);
+        if (!a->Slice(begin, length)->Equals(b->Slice(begin, length))) {
+          differ.store(true, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return !differ.load();
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::ShallowCopy() const {
+  return ShallowCopy(
+      loaded_node_schema()->field_names(), loaded_edge_schema()->field_names());
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::ShallowCopy(
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties) const {
+  auto node_props = KATANA_CHECKED_CONTEXT(
+      ShareProperties(
+          loaded_node_schema(), node_properties, num_nodes(),
+          [&](const std::string& name) { return GetNodeProperty(name); }),
+      "node properties");
+  auto edge_props = KATANA_CHECKED_CONTEXT(
+      ShareProperties(
+          loaded_edge_schema(), edge_properties, num_edges(),
+          [&](const std::string& name) { return GetEdgeProperty(name); }),
+      "edge properties");
+
+  auto copy = KATANA_CHECKED(Make(
+      GraphTopology::ShareOrCopy(topology()),
+      CopyEntityTypeIDs(node_entity_type_id_),
+      CopyEntityTypeIDs(edge_entity_type_id_),
+      EntityTypeManager(node_entity_type_manager_),
+      EntityTypeManager(edge_entity_type_manager_)));
+  KATANA_CHECKED(copy->AddNodeProperties(node_props));
+  KATANA_CHECKED(copy->AddEdgeProperties(edge_props));
+  return std::unique_ptr<PropertyGraph>(std::move(copy));
+}
+
 katana::Result<void>
-katana::PropertyGraph::Validate() {
+katana::PropertyGraph::Validate() const {
   // TODO (thunt) check that arrow table sizes match topology
   // if (topology_.out_dests &&
   //    topology_.out_dests->length() != table->num_rows()) {
@@ -445,11 +957,21 @@ katana::PropertyGraph::Validate() {
         edge_properties()->num_rows(), num_edges());
   }
 
+  KATANA_CHECKED_CONTEXT(topology().Validate(), "topology");
+
   return katana::ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::ConstructEntityTypeIDs() {
+  if (lazy_properties_) {
+    KATANA_CHECKED(LoadLazyTypeProperties());
+  }
+
+  // kept to patch the views built for them
+  NUMAArray<EntityTypeID> old_node_types = std::move(node_entity_type_id_);
+  NUMAArray<EntityTypeID> old_edge_types = std::move(edge_entity_type_id_);
+
   node_entity_type_manager_.Reset();
   uint64_t num_node_rows = static_cast<uint64_t>(node_properties()->num_rows());
   if (num_node_rows == 0) {
@@ -476,6 +998,13 @@ katana::PropertyGraph::ConstructEntityTypeIDs() {
     edge_entity_type_id_ = std::move(edge_types_res.value());
   }
 
+  node_type_index_ =
+      EntityTypeIndex::Make(node_entity_type_manager_, node_entity_type_id_);
+  edge_type_index_ =
+      EntityTypeIndex::Make(edge_entity_type_manager_, edge_entity_type_id_);
+
+  pg_view_cache_.UpdateEntityTypes(this, old_node_types, old_edge_types);
+
   return katana::ResultSuccess();
 }
 
@@ -541,6 +1070,14 @@ katana::PropertyGraph::Commit(const std::string& command_line) {
       *file_, command_line, tsuba::RDG::RDGVersioningPolicy::IncrementVersion);
 }
 
+std::optional<uint64_t>
+katana::PropertyGraph::rdg_version() const {
+  if (file_ == nullptr || !rdg_.topology_file_storage().Valid()) {
+    return std::nullopt;
+  }
+  return tsuba::GetRDGVersion(*file_);
+}
+
 katana::Result<void>
 katana::PropertyGraph::WriteView(const std::string& command_line) {
   // WriteView occurs once, and only before any Commit/Write operation
@@ -564,13 +1101,15 @@ katana::PropertyGraph::Equals(const PropertyGraph* other) const {
     return false;
   }
   for (const auto& prop_name : node_props->ColumnNames()) {
-    if (!node_props->GetColumnByName(prop_name)->Equals(
+    if (!ColumnsEqual(
+            node_props->GetColumnByName(prop_name),
             other_node_props->GetColumnByName(prop_name))) {
       return false;
     }
   }
   for (const auto& prop_name : edge_props->ColumnNames()) {
-    if (!edge_props->GetColumnByName(prop_name)->Equals(
+    if (!ColumnsEqual(
+            edge_props->GetColumnByName(prop_name),
             other_edge_props->GetColumnByName(prop_name))) {
       return false;
     }
@@ -611,7 +1150,7 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
       fmt::format_to(
           std::back_inserter(buf), "Only first has node property {}\n",
           prop_name);
-    } else if (!my_col->Equals(other_col)) {
+    } else if (!ColumnsEqual(my_col, other_col)) {
       fmt::format_to(
           std::back_inserter(buf), "Node property {:15} {:12} differs\n",
           prop_name, fmt::format("({})", my_col->type()->name()));
@@ -635,8 +1174,7 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
       fmt::format_to(
           std::back_inserter(buf), "Only first has edge property {}\n",
           prop_name);
-    } else if (!edge_props->GetColumnByName(prop_name)->Equals(
-                   other_edge_props->GetColumnByName(prop_name))) {
+    } else if (!ColumnsEqual(my_col, other_col)) {
       fmt::format_to(
           std::back_inserter(buf), "Edge property {:15} {:12} differs\n",
           prop_name, fmt::format("({})", my_col->type()->name()));
@@ -656,6 +1194,16 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
   return std::string(buf.begin(), buf.end());
 }
 
+katana::Result<uint64_t>
+katana::PropertyGraph::Fingerprint() const {
+  uint64_t node_hash = KATANA_CHECKED_CONTEXT(
+      katana::Fingerprint(*node_properties()), "node properties");
+  uint64_t edge_hash = KATANA_CHECKED_CONTEXT(
+      katana::Fingerprint(*edge_properties()), "edge properties");
+  return FingerprintCombine(
+      FingerprintCombine(topology().Fingerprint(), node_hash), edge_hash);
+}
+
 katana::Result<void>
 katana::PropertyGraph::Write(
     const std::string& rdg_name, const std::string& command_line) {
@@ -724,11 +1272,85 @@ katana::PropertyGraph::LoadNodeProperty(const std::string& name, int i) {
 katana::Result<void>
 katana::PropertyGraph::EnsureNodePropertyLoaded(const std::string& name) {
   if (HasNodeProperty(name)) {
+    rdg_.MarkNodePropertyUsed(name);
     return katana::ResultSuccess();
   }
   return LoadNodeProperty(name);
 }
 
+katana::Result<void>
+katana::PropertyGraph::PrefetchNodeProperties(
+    const std::vector<std::string>& names) {
+  return rdg_.PrefetchNodeProperties(names);
+}
+
+katana::Result<void>
+katana::PropertyGraph::PrefetchEdgeProperties(
+    const std::vector<std::string>& names) {
+  return rdg_.PrefetchEdgeProperties(names);
+}
+
+katana::Result<void>
+katana::PropertyGraph::LoadLazyNodeProperties(
+    const std::vector<std::string>& names) {
+  if (!lazy_properties_) {
+    return katana::ResultSuccess();
+  }
+  for (const std::string& name : names) {
+    if (HasNodeProperty(name) ||
+        full_node_schema()->GetFieldIndex(name) == -1) {
+      continue;
+    }
+    KATANA_CHECKED_CONTEXT(
+        LoadNodeProperty(name), "loading node property {}",
+        std::quoted(name));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::LoadLazyEdgeProperties(
+    const std::vector<std::string>& names) {
+  if (!lazy_properties_) {
+    return katana::ResultSuccess();
+  }
+  for (const std::string& name : names) {
+    if (HasEdgeProperty(name) ||
+        full_edge_schema()->GetFieldIndex(name) == -1) {
+      continue;
+    }
+    KATANA_CHECKED_CONTEXT(
+        LoadEdgeProperty(name), "loading edge property {}",
+        std::quoted(name));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::LoadLazyTypeProperties() {
+  auto type_properties = [](const std::shared_ptr<arrow::Schema>& schema) {
+    std::vector<std::string> names;
+    for (const auto& field : schema->fields()) {
+      if (IsTypeField(*field)) {
+        names.emplace_back(field->name());
+      }
+    }
+    return names;
+  };
+  std::vector<std::string> node_names = type_properties(full_node_schema());
+  std::vector<std::string> edge_names = type_properties(full_edge_schema());
+
+  KATANA_CHECKED(PrefetchNodeProperties(node_names));
+  KATANA_CHECKED(PrefetchEdgeProperties(edge_names));
+  for (const std::string& name : node_names) {
+    KATANA_CHECKED(EnsureNodePropertyLoaded(name));
+  }
+  for (const std::string& name : edge_names) {
+    KATANA_CHECKED(EnsureEdgePropertyLoaded(name));
+  }
+  return katana::ResultSuccess();
+}
+
 std::vector<std::string>
 katana::PropertyGraph::ListNodeProperties() const {
   return rdg_.ListNodeProperties();
@@ -779,6 +1401,84 @@ katana::PropertyGraph::UpsertEdgeProperties(
   return rdg_.UpsertEdgeProperties(props);
 }
 
+namespace {
+
+/// Check that \p props can replace properties of \p schema when the number of
+/// rows changes from \p old_rows to \p new_rows
+katana::Result<void>
+CheckReplacement(
+    const std::shared_ptr<arrow::Schema>& schema,
+    const std::shared_ptr<arrow::Table>& props, uint64_t old_rows,
+    uint64_t new_rows) {
+  if (props != nullptr && props->num_columns() > 0 &&
+      static_cast<uint64_t>(props->num_rows()) != new_rows) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "expected {} rows found {} instead",
+        new_rows, props->num_rows());
+  }
+  if (old_rows == new_rows) {
+    return katana::ResultSuccess();
+  }
+  for (const auto& field : schema->fields()) {
+    if (props == nullptr || props->GetColumnByName(field->name()) == nullptr) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "property {} has {} rows instead of {}", field->name(), old_rows,
+          new_rows);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::PropertyGraph::ReplaceTopology(
+    GraphTopology&& topology,
+    const std::shared_ptr<arrow::Table>& node_properties,
+    const std::shared_ptr<arrow::Table>& edge_properties) {
+  uint64_t old_nodes = num_nodes();
+  uint64_t old_edges = num_edges();
+  KATANA_CHECKED_CONTEXT(
+      CheckReplacement(
+          full_node_schema(), node_properties, old_nodes,
+          topology.num_nodes()),
+      "node properties");
+  KATANA_CHECKED_CONTEXT(
+      CheckReplacement(
+          full_edge_schema(), edge_properties, old_edges,
+          topology.num_edges()),
+      "edge properties");
+
+  topology_ = std::move(topology);
+  // without a topology file, the next commit stores topology_
+  KATANA_CHECKED(rdg_.UnbindTopologyFileStorage());
+  pg_view_cache_ = PGViewCache();
+  node_indexes_.clear();
+  edge_indexes_.clear();
+  node_composite_indexes_.clear();
+  edge_composite_indexes_.clear();
+
+  // properties of a different number of rows are replaced as a whole
+  if (old_nodes != num_nodes()) {
+    while (this->node_properties()->num_columns() > 0) {
+      KATANA_CHECKED(RemoveNodeProperty(0));
+    }
+  }
+  if (old_edges != num_edges()) {
+    while (this->edge_properties()->num_columns() > 0) {
+      KATANA_CHECKED(RemoveEdgeProperty(0));
+    }
+  }
+  if (node_properties != nullptr) {
+    KATANA_CHECKED(UpsertNodeProperties(node_properties));
+  }
+  if (edge_properties != nullptr) {
+    KATANA_CHECKED(UpsertEdgeProperties(edge_properties));
+  }
+  return ConstructEntityTypeIDs();
+}
+
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(int i) {
   return rdg_.RemoveEdgeProperty(i);
@@ -809,6 +1509,7 @@ katana::PropertyGraph::LoadEdgeProperty(const std::string& name, int i) {
 katana::Result<void>
 katana::PropertyGraph::EnsureEdgePropertyLoaded(const std::string& name) {
   if (HasEdgeProperty(name)) {
+    rdg_.MarkEdgePropertyUsed(name);
     return katana::ResultSuccess();
   }
   return LoadEdgeProperty(name);
@@ -838,9 +1539,78 @@ katana::PropertyGraph::InformPath(const std::string& input_path) {
   return ResultSuccess();
 }
 
+namespace {
+
+/// Make an index of \param kind over \param property, or of the kind of
+/// \param stored if \param kind is unset. \param stored, if valid, holds an
+/// index stored for the current property, which is used instead of building
+/// the index when it matches.
+template <typename node_or_edge>
+katana::Result<std::unique_ptr<katana::PropertyIndex<node_or_edge>>>
+MakeIndex(
+    const std::string& column_name, size_t num_entities,
+    const std::shared_ptr<arrow::Array>& property,
+    std::optional<katana::PropertyIndexKind> kind, tsuba::FileView&& stored) {
+  std::optional<katana::PropertyIndexKind> stored_kind;
+  if (stored.Valid()) {
+    if (auto res = katana::StoredIndexKind(stored); res) {
+      stored_kind = res.value();
+    } else {
+      KATANA_LOG_DEBUG("rebuilding index of {}: {}", column_name, res.error());
+    }
+  }
+
+  std::unique_ptr<katana::PropertyIndex<node_or_edge>> index =
+      KATANA_CHECKED(katana::MakeTypedIndex<node_or_edge>(
+          column_name, num_entities, property,
+          kind.value_or(
+              stored_kind.value_or(katana::PropertyIndexKind::kSorted))));
+
+  if (stored_kind && (!kind || kind == stored_kind)) {
+    if (auto res = index->BuildFromFile(std::move(stored)); res) {
+      return std::unique_ptr<katana::PropertyIndex<node_or_edge>>(
+          std::move(index));
+    } else {
+      KATANA_LOG_DEBUG("rebuilding index of {}: {}", column_name, res.error());
+    }
+  }
+
+  KATANA_CHECKED(index->BuildFromProperty());
+  return std::unique_ptr<katana::PropertyIndex<node_or_edge>>(std::move(index));
+}
+
+/// Build a composite index over the properties named \param column_names as
+/// returned by \param get_property
+template <typename node_or_edge, typename GetProperty>
+katana::Result<std::unique_ptr<katana::CompositePropertyIndex<node_or_edge>>>
+MakeCompositeIndex(
+    const std::vector<std::string>& column_names, size_t num_entities,
+    GetProperty get_property) {
+  std::vector<std::shared_ptr<arrow::Array>> properties;
+  for (const auto& column_name : column_names) {
+    std::shared_ptr<arrow::ChunkedArray> chunked_property =
+        get_property(column_name);
+    if (!chunked_property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "No such property: {}", column_name);
+    }
+    KATANA_LOG_ASSERT(chunked_property->num_chunks() == 1);
+    properties.emplace_back(chunked_property->chunk(0));
+  }
+
+  auto index = std::make_unique<katana::CompositePropertyIndex<node_or_edge>>(
+      column_names, num_entities, std::move(properties));
+  KATANA_CHECKED(index->BuildFromProperty());
+  return std::unique_ptr<katana::CompositePropertyIndex<node_or_edge>>(
+      std::move(index));
+}
+
+}  // namespace
+
 // Build an index over nodes.
 katana::Result<void>
-katana::PropertyGraph::MakeNodeIndex(const std::string& column_name) {
+katana::PropertyGraph::DoMakeNodeIndex(
+    const std::string& column_name, std::optional<PropertyIndexKind> kind) {
   for (const auto& existing_index : node_indexes_) {
     if (existing_index->column_name() == column_name) {
       return KATANA_ERROR(
@@ -859,12 +1629,17 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& column_name) {
   KATANA_LOG_ASSERT(chunked_property->num_chunks() == 1);
   std::shared_ptr<arrow::Array> property = chunked_property->chunk(0);
 
+  // stored stays invalid if there is no stored index for the property
+  tsuba::FileView stored;
+  if (auto res = rdg_.LoadNodePropertyIndex(column_name, &stored);
+      !res && res.error() != tsuba::ErrorCode::NotFound) {
+    KATANA_LOG_DEBUG("rebuilding index of {}: {}", column_name, res.error());
+  }
+
   // Create an index based on the type of the field.
   std::unique_ptr<katana::PropertyIndex<GraphTopology::Node>> index =
-      KATANA_CHECKED(katana::MakeTypedIndex<katana::GraphTopology::Node>(
-          column_name, num_nodes(), property));
-
-  KATANA_CHECKED(index->BuildFromProperty());
+      KATANA_CHECKED(MakeIndex<katana::GraphTopology::Node>(
+          column_name, num_nodes(), property, kind, std::move(stored)));
 
   node_indexes_.push_back(std::move(index));
 
@@ -873,7 +1648,8 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& column_name) {
 
 // Build an index over edges.
 katana::Result<void>
-katana::PropertyGraph::MakeEdgeIndex(const std::string& column_name) {
+katana::PropertyGraph::DoMakeEdgeIndex(
+    const std::string& column_name, std::optional<PropertyIndexKind> kind) {
   for (const auto& existing_index : edge_indexes_) {
     if (existing_index->column_name() == column_name) {
       return KATANA_ERROR(
@@ -892,22 +1668,199 @@ katana::PropertyGraph::MakeEdgeIndex(const std::string& column_name) {
   KATANA_LOG_ASSERT(chunked_property->num_chunks() == 1);
   std::shared_ptr<arrow::Array> property = chunked_property->chunk(0);
 
+  // stored stays invalid if there is no stored index for the property
+  tsuba::FileView stored;
+  if (auto res = rdg_.LoadEdgePropertyIndex(column_name, &stored);
+      !res && res.error() != tsuba::ErrorCode::NotFound) {
+    KATANA_LOG_DEBUG("rebuilding index of {}: {}", column_name, res.error());
+  }
+
   // Create an index based on the type of the field.
   std::unique_ptr<katana::PropertyIndex<katana::GraphTopology::Edge>> index =
-      KATANA_CHECKED(katana::MakeTypedIndex<katana::GraphTopology::Edge>(
-          column_name, num_edges(), property));
-
-  KATANA_CHECKED(index->BuildFromProperty());
+      KATANA_CHECKED(MakeIndex<katana::GraphTopology::Edge>(
+          column_name, num_edges(), property, kind, std::move(stored)));
 
   edge_indexes_.push_back(std::move(index));
 
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::PropertyGraph::MakeNodeCompositeIndex(
+    const std::vector<std::string>& column_names) {
+  std::string name =
+      CompositePropertyIndex<GraphTopology::Node>::JoinColumnNames(
+          column_names);
+  for (const auto& existing_index : node_composite_indexes_) {
+    if (existing_index->column_name() == name) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AlreadyExists,
+          "Index already exists for columns {}", name);
+    }
+  }
+
+  auto index = KATANA_CHECKED(MakeCompositeIndex<GraphTopology::Node>(
+      column_names, num_nodes(),
+      [&](const std::string& column_name) {
+        return GetNodeProperty(column_name);
+      }));
+  node_composite_indexes_.push_back(std::move(index));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::MakeEdgeCompositeIndex(
+    const std::vector<std::string>& column_names) {
+  std::string name =
+      CompositePropertyIndex<GraphTopology::Edge>::JoinColumnNames(
+          column_names);
+  for (const auto& existing_index : edge_composite_indexes_) {
+    if (existing_index->column_name() == name) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AlreadyExists,
+          "Index already exists for columns {}", name);
+    }
+  }
+
+  auto index = KATANA_CHECKED(MakeCompositeIndex<GraphTopology::Edge>(
+      column_names, num_edges(),
+      [&](const std::string& column_name) {
+        return GetEdgeProperty(column_name);
+      }));
+  edge_composite_indexes_.push_back(std::move(index));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::LoadIndexes() {
+  // Indexes of properties that were not loaded are left in storage
+  for (const auto& name : rdg_.ListNodePropertyIndexes()) {
+    if (HasNodeProperty(name)) {
+      KATANA_CHECKED_CONTEXT(
+          DoMakeNodeIndex(name, std::nullopt), "loading index of {}", name);
+    }
+  }
+  for (const auto& name : rdg_.ListEdgePropertyIndexes()) {
+    if (HasEdgeProperty(name)) {
+      KATANA_CHECKED_CONTEXT(
+          DoMakeEdgeIndex(name, std::nullopt), "loading index of {}", name);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::PersistIndexes() {
+  // Indexes mapped from storage are still stored unless their property
+  // changed since, in which case they were rebuilt
+  for (const auto& index : node_indexes_) {
+    if (!index->is_from_file()) {
+      rdg_.AddNodePropertyIndex(
+          index->column_name(), KATANA_CHECKED(index->ToFile()));
+    }
+  }
+  for (const auto& index : edge_indexes_) {
+    if (!index->is_from_file()) {
+      rdg_.AddEdgePropertyIndex(
+          index->column_name(), KATANA_CHECKED(index->ToFile()));
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+namespace {
+
+/// Edge lists up to this long are sorted by insertion
+constexpr uint64_t kInsertionSortEdges = 32;
+/// Edge lists longer than this are each sorted by a parallel loop
+constexpr uint64_t kParallelSortEdges = uint64_t{1} << 16;
+
+/// Sort the destinations [\p begin, \p end) and the permutation alongside
+/// them by destination
+void
+SortEdgeRange(
+    katana::GraphTopology::Node* dests, uint64_t* permutation, uint64_t begin,
+    uint64_t end) {
+  if (std::is_sorted(dests + begin, dests + end)) {
+    return;
+  }
+
+  if (end - begin <= kInsertionSortEdges) {
+    for (uint64_t i = begin + 1; i < end; ++i) {
+      auto dest = dests[i];
+      uint64_t perm = permutation[i];
+      uint64_t j = i;
+      for (; j > begin && dests[j - 1] > dest; --j) {
+        dests[j] = dests[j - 1];
+        permutation[j] = permutation[j - 1];
+      }
+      dests[j] = dest;
+      permutation[j] = perm;
+    }
+    return;
+  }
+
+  auto sort_iter_beg =
+      katana::make_zip_iterator(dests + begin, permutation + begin);
+  auto sort_iter_end =
+      katana::make_zip_iterator(dests + end, permutation + end);
+  std::sort(
+      sort_iter_beg, sort_iter_end, [&](const auto& tup1, const auto& tup2) {
+        return std::get<0>(tup1) < std::get<0>(tup2);
+      });
+}
+
+/// Sort the edges of a node with a huge degree with a parallel sort
+void
+SortHubEdges(
+    katana::GraphTopology::Node* dests, uint64_t* permutation, uint64_t begin,
+    uint64_t end) {
+  if (std::is_sorted(dests + begin, dests + end)) {
+    return;
+  }
+
+  using DestEdgePair = std::pair<katana::GraphTopology::Node, uint64_t>;
+  katana::NUMAArray<DestEdgePair> pairs;
+  pairs.allocateInterleaved(end - begin);
+  katana::do_all(
+      katana::iterate(begin, end),
+      [&](uint64_t e) {
+        pairs[e - begin] = DestEdgePair(dests[e], permutation[e]);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::sort(pairs.begin(), pairs.end());
+  katana::do_all(
+      katana::iterate(begin, end),
+      [&](uint64_t e) {
+        dests[e] = pairs[e - begin].first;
+        permutation[e] = pairs[e - begin].second;
+      },
+      katana::no_stats());
+}
+
+/// The sorts below write the topology in place. Give \p pg a copy in its
+/// own memory first if its topology is a read-only mapping or is shared with
+/// other graphs, e.g., an attached shared graph or a ShallowCopy, so that the
+/// writes neither fault nor change the topology those see.
+katana::Result<void>
+EnsureTopologyOwned(katana::PropertyGraph* pg) {
+  if (!pg->topology().is_out_of_core()) {
+    return katana::ResultSuccess();
+  }
+  return pg->ReplaceTopology(
+      katana::GraphTopology::Copy(pg->topology()), nullptr, nullptr);
+}
+
+}  // namespace
+
 katana::Result<std::unique_ptr<katana::NUMAArray<uint64_t>>>
 katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
   // TODO(amber): This function will soon change so that it produces a new sorted
-  // topology instead of modifying an existing one. The const_cast will go away
+  // topology instead of modifying an existing one. Until then the const_cast
+  // is safe only because EnsureTopologyOwned leaves pg the sole owner.
+  KATANA_CHECKED(EnsureTopologyOwned(pg));
   const auto& topo = pg->topology();
 
   auto permutation_vec = std::make_unique<katana::NUMAArray<uint64_t>>();
@@ -916,30 +1869,30 @@ katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
       permutation_vec->begin(), permutation_vec->end(), uint64_t{0});
 
   auto* out_dests_data = const_cast<GraphTopology::Node*>(topo.dest_data());
+  uint64_t* permutation = permutation_vec->data();
 
+  // Nodes of huge degree would hold up a thread each, so they are left for
+  // a parallel sort each
+  katana::InsertBag<GraphTopology::Node> hubs;
   katana::do_all(
       katana::iterate(pg->topology().all_nodes()),
       [&](GraphTopology::Node n) {
         const auto e_beg = *pg->topology().edges(n).begin();
         const auto e_end = *pg->topology().edges(n).end();
-
-        auto sort_iter_beg = katana::make_zip_iterator(
-            out_dests_data + e_beg, permutation_vec->begin() + e_beg);
-        auto sort_iter_end = katana::make_zip_iterator(
-            out_dests_data + e_end, permutation_vec->begin() + e_end);
-
-        std::sort(
-            sort_iter_beg, sort_iter_end,
-            [&](const auto& tup1, const auto& tup2) {
-              auto d1 = std::get<0>(tup1);
-              auto d2 = std::get<0>(tup2);
-              static_assert(std::is_same_v<decltype(d1), GraphTopology::Node>);
-              static_assert(std::is_same_v<decltype(d1), GraphTopology::Node>);
-              return d1 < d2;
-            });
+        if (e_end - e_beg > kParallelSortEdges) {
+          hubs.push(n);
+          return;
+        }
+        SortEdgeRange(out_dests_data, permutation, e_beg, e_end);
       },
       katana::steal());
 
+  for (GraphTopology::Node n : hubs) {
+    SortHubEdges(
+        out_dests_data, permutation, *topo.edges(n).begin(),
+        *topo.edges(n).end());
+  }
+
   return std::unique_ptr<katana::NUMAArray<uint64_t>>(
       std::move(permutation_vec));
 }
@@ -974,6 +1927,7 @@ katana::FindEdgeSortedByDest(
 // TODO(amber): this method should return a new sorted topology
 katana::Result<void>
 katana::SortNodesByDegree(katana::PropertyGraph* pg) {
+  KATANA_CHECKED(EnsureTopologyOwned(pg));
   const auto& topo = pg->topology();
 
   uint64_t num_nodes = topo.num_nodes();
@@ -1013,7 +1967,6 @@ katana::SortNodesByDegree(katana::PropertyGraph* pg) {
   new_out_dest.allocateInterleaved(num_edges);
 
   auto* out_dests_data = const_cast<GraphTopology::Node*>(topo.dest_data());
-  auto* out_indices_data = const_cast<GraphTopology::Edge*>(topo.adj_data());
 
   katana::do_all(
       katana::iterate(topo.all_nodes()),
@@ -1042,9 +1995,17 @@ katana::SortNodesByDegree(katana::PropertyGraph* pg) {
 
   //Update the underlying PropertyGraph topology
   // TODO(amber): eliminate these copies since we will be returning a new topology
-  katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](auto node_id) {
-    out_indices_data[node_id] = new_prefix_sum[node_id];
-  });
+  if (topo.is_compact()) {
+    auto* out_indices_data = const_cast<uint32_t*>(topo.compact_adj_data());
+    katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](auto node_id) {
+      out_indices_data[node_id] = new_prefix_sum[node_id];
+    });
+  } else {
+    auto* out_indices_data = const_cast<GraphTopology::Edge*>(topo.adj_data());
+    katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](auto node_id) {
+      out_indices_data[node_id] = new_prefix_sum[node_id];
+    });
+  }
 
   katana::do_all(katana::iterate(uint64_t{0}, num_edges), [&](auto edge_id) {
     out_dests_data[edge_id] = new_out_dest[edge_id];
@@ -1053,6 +2014,199 @@ katana::SortNodesByDegree(katana::PropertyGraph* pg) {
   return katana::ResultSuccess();
 }
 
+namespace {
+
+/// The number of rows that ReorderNodes gathers in a task
+constexpr uint64_t kGatherRows = uint64_t{1} << 20;
+
+/// Gather rows \p order of \p column in parallel, kGatherRows at a time
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+GatherRows(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const katana::NUMAArray<uint64_t>& order) {
+  uint64_t num_blocks = (order.size() + kGatherRows - 1) / kGatherRows;
+  std::vector<std::vector<std::shared_ptr<arrow::Array>>> blocks(num_blocks);
+  std::vector<katana::Result<void>> results(
+      num_blocks, katana::ResultSuccess());
+  auto gather = [&](uint64_t b) -> katana::Result<void> {
+    uint64_t begin = b * kGatherRows;
+    uint64_t length = std::min(kGatherRows, order.size() - begin);
+    auto indices = std::make_shared<arrow::UInt64Array>(
+        length, arrow::Buffer::Wrap(order.data() + begin, length));
+    blocks[b] = KATANA_CHECKED(arrow::compute::Take(column, indices))
+                    .chunked_array()
+                    ->chunks();
+    return katana::ResultSuccess();
+  };
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t b) { results[b] = gather(b); }, katana::steal(),
+      katana::chunk_size<1>(), katana::no_stats());
+
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  for (uint64_t b = 0; b < num_blocks; ++b) {
+    if (!results[b]) {
+      return results[b].error();
+    }
+    chunks.insert(chunks.end(), blocks[b].begin(), blocks[b].end());
+  }
+  return KATANA_CHECKED(arrow::ChunkedArray::Make(chunks, column->type()));
+}
+
+/// Replace each property in \p schema with its rows \p order, one at a
+/// time; \p get looks up the properties so that each original is released
+/// once it is replaced
+template <typename Get, typename Upsert>
+katana::Result<void>
+PermuteProperties(
+    std::shared_ptr<arrow::Schema> schema,
+    const katana::NUMAArray<uint64_t>& order, Get get, Upsert upsert) {
+  for (const auto& field : schema->fields()) {
+    auto column = KATANA_CHECKED_CONTEXT(
+        GatherRows(get(field->name()), order), "property {}", field->name());
+    KATANA_CHECKED(upsert(
+        arrow::Table::Make(arrow::schema({field}), {column}, order.size())));
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::ReorderNodes(
+    katana::PropertyGraph* pg,
+    const GraphTopologyTypes::PropIndexVec& order) {
+  using Node = GraphTopology::Node;
+  const GraphTopology& topo = pg->topology();
+  uint64_t num_nodes = topo.num_nodes();
+  if (order.size() != num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "order has {} nodes instead of {}",
+        order.size(), num_nodes);
+  }
+
+  katana::DynamicBitset placed;
+  placed.resize(num_nodes);
+  katana::NUMAArray<Node> new_ids;
+  new_ids.allocateInterleaved(num_nodes);
+  std::atomic<bool> is_permutation{true};
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        if (order[i] >= num_nodes || placed.set(order[i])) {
+          is_permutation = false;
+        } else {
+          new_ids[order[i]] = i;
+        }
+      },
+      katana::no_stats());
+  if (!is_permutation) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "order is not a permutation of the nodes");
+  }
+
+  for (const auto& field : pg->full_node_schema()->fields()) {
+    KATANA_CHECKED(pg->EnsureNodePropertyLoaded(field->name()));
+  }
+  for (const auto& field : pg->full_edge_schema()->fields()) {
+    KATANA_CHECKED(pg->EnsureEdgePropertyLoaded(field->name()));
+  }
+
+  GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) { adj_indices[i] = topo.degree(order[i]); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  // edge e of the result is edge edge_order[e] of the original graph
+  GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(topo.num_edges());
+  katana::NUMAArray<uint64_t> edge_order;
+  edge_order.allocateInterleaved(topo.num_edges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        uint64_t out = i == 0 ? 0 : adj_indices[i - 1];
+        for (auto e : topo.edges(order[i])) {
+          dests[out] = new_ids[topo.edge_dest(e)];
+          edge_order[out] = e;
+          ++out;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  KATANA_CHECKED_CONTEXT(
+      PermuteProperties(
+          pg->loaded_node_schema(), order,
+          [&](const std::string& name) { return pg->GetNodeProperty(name); },
+          [&](const std::shared_ptr<arrow::Table>& props) {
+            return pg->UpsertNodeProperties(props);
+          }),
+      "node properties");
+  KATANA_CHECKED_CONTEXT(
+      PermuteProperties(
+          pg->loaded_edge_schema(), edge_order,
+          [&](const std::string& name) { return pg->GetEdgeProperty(name); },
+          [&](const std::shared_ptr<arrow::Table>& props) {
+            return pg->UpsertEdgeProperties(props);
+          }),
+      "edge properties");
+
+  // also rebuilds the entity types from the permuted properties
+  return pg->ReplaceTopology(
+      GraphTopology(std::move(adj_indices), std::move(dests)), nullptr,
+      nullptr);
+}
+
+katana::Result<void>
+katana::SortAllEdgesAndPropertiesByDest(katana::PropertyGraph* pg) {
+  for (const auto& field : pg->full_edge_schema()->fields()) {
+    KATANA_CHECKED(pg->EnsureEdgePropertyLoaded(field->name()));
+  }
+
+  auto permutation = KATANA_CHECKED(SortAllEdgesByDest(pg));
+  KATANA_CHECKED_CONTEXT(
+      PermuteProperties(
+          pg->loaded_edge_schema(), *permutation,
+          [&](const std::string& name) { return pg->GetEdgeProperty(name); },
+          [&](const std::shared_ptr<arrow::Table>& props) {
+            return pg->UpsertEdgeProperties(props);
+          }),
+      "edge properties");
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::SortNodesAndPropertiesByDegree(katana::PropertyGraph* pg) {
+  const GraphTopology& topo = pg->topology();
+  uint64_t num_nodes = topo.num_nodes();
+
+  using DegreeNodePair = std::pair<uint64_t, uint32_t>;
+  katana::NUMAArray<DegreeNodePair> dn_pairs;
+  dn_pairs.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](auto node) {
+        dn_pairs[node] = DegreeNodePair(topo.degree(node), node);
+      },
+      katana::no_stats());
+
+  // the same order as SortNodesByDegree
+  katana::ParallelSTL::sort(
+      dn_pairs.begin(), dn_pairs.end(), std::greater<DegreeNodePair>());
+
+  GraphTopologyTypes::PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) { order[i] = dn_pairs[i].second; }, katana::no_stats());
+
+  return ReorderNodes(pg, order);
+}
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::CreateSymmetricGraph(katana::PropertyGraph* pg) {
   const GraphTopology& topology = pg->topology();
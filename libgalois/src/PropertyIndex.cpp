@@ -1,33 +1,99 @@
 #include "katana/PropertyIndex.h"
 
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
+#include "tsuba/Errors.h"
+
+namespace {
+
+constexpr uint64_t kIndexMagic = 0x4b4154414e494458;  // "KATANIDX"
+constexpr uint32_t kIndexFormatVersion = 1;
+
+/// Layout of a stored index: this header, then the ids, the values and the
+/// hash slots, each padded to a multiple of 8 bytes
+struct IndexFileHeader {
+  uint64_t magic{kIndexMagic};
+  uint32_t format_version{kIndexFormatVersion};
+  int32_t kind{0};
+  int32_t property_type{0};
+  uint32_t id_size{0};
+  uint64_t value_size{0};
+  uint64_t num_entities{0};
+  uint64_t num_ids{0};
+  uint64_t num_slots{0};
+};
+
+uint64_t
+Padded(uint64_t bytes) {
+  return (bytes + 7) & ~UINT64_C(7);
+}
+
+katana::Result<void>
+WritePadded(tsuba::FileFrame* ff, const void* data, uint64_t size) {
+  static const uint8_t kZeros[8] = {};
+  if (size > 0) {
+    if (auto aro_sts = ff->Write(data, size); !aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+  if (uint64_t pad = Padded(size) - size; pad > 0) {
+    if (auto aro_sts = ff->Write(kZeros, pad); !aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
 
 namespace katana {
 
+Result<PropertyIndexKind>
+StoredIndexKind(const tsuba::FileView& file_view) {
+  if (file_view.size() < sizeof(IndexFileHeader)) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "index file too short");
+  }
+  const auto* header = file_view.ptr<IndexFileHeader>();
+  if (header->magic != kIndexMagic ||
+      header->format_version != kIndexFormatVersion) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not an index file");
+  }
+  switch (static_cast<PropertyIndexKind>(header->kind)) {
+  case PropertyIndexKind::kSorted:
+  case PropertyIndexKind::kHash:
+    return static_cast<PropertyIndexKind>(header->kind);
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unknown index kind {}", header->kind);
+  }
+}
+
 // Switch statement over creation of per-type indexes.
 template <typename node_or_edge>
 Result<std::unique_ptr<PropertyIndex<node_or_edge>>>
 MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property) {
+    std::shared_ptr<arrow::Array> property, PropertyIndexKind kind) {
   std::unique_ptr<PropertyIndex<node_or_edge>> index;
 
   switch (property->type_id()) {
   case arrow::Type::BOOL:
     index = std::make_unique<PrimitivePropertyIndex<node_or_edge, bool>>(
-        column_name, num_entities, property);
+        column_name, num_entities, property, kind);
     break;
   case arrow::Type::INT64:
     index = std::make_unique<PrimitivePropertyIndex<node_or_edge, int64_t>>(
-        column_name, num_entities, property);
+        column_name, num_entities, property, kind);
     break;
   case arrow::Type::DOUBLE:
     index = std::make_unique<PrimitivePropertyIndex<node_or_edge, double_t>>(
-        column_name, num_entities, property);
+        column_name, num_entities, property, kind);
     break;
   case arrow::Type::LARGE_STRING:
     index = std::make_unique<StringPropertyIndex<node_or_edge>>(
-        column_name, num_entities, property);
+        column_name, num_entities, property, kind);
     break;
   default:
     return KATANA_ERROR(
@@ -39,6 +105,154 @@ MakeTypedIndex(
   return Result<std::unique_ptr<PropertyIndex<node_or_edge>>>(std::move(index));
 }
 
+template <typename node_or_edge>
+template <typename IsValid, typename Less>
+void
+PropertyIndex<node_or_edge>::BuildIds(
+    size_t num_entities, IsValid is_valid, Less less) {
+  // position of each valid id in ids_, plus one
+  NUMAArray<uint64_t> positions;
+  positions.allocateInterleaved(num_entities);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_entities),
+      [&](size_t i) { positions[i] = is_valid(i) ? 1 : 0; },
+      katana::no_stats());
+  ParallelSTL::partial_sum(
+      positions.begin(), positions.end(), positions.begin());
+
+  ids_.allocateInterleaved(num_entities > 0 ? positions[num_entities - 1] : 0);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_entities),
+      [&](size_t i) {
+        if (is_valid(i)) {
+          ids_[positions[i] - 1] = i;
+        }
+      },
+      katana::no_stats());
+
+  ParallelSTL::sort(
+      ids_.begin(), ids_.end(), [&](node_or_edge a, node_or_edge b) {
+        if (less(a, b)) {
+          return true;
+        }
+        if (less(b, a)) {
+          return false;
+        }
+        return a < b;
+      });
+}
+
+template <typename node_or_edge>
+template <typename Hash, typename Equal>
+void
+PropertyIndex<node_or_edge>::BuildSlots(Hash hash, Equal equal) {
+  if (kind_ != PropertyIndexKind::kHash || ids_.empty()) {
+    return;
+  }
+
+  auto is_run_start = [&](uint64_t i) {
+    return i == 0 || !equal(ids_[i - 1], ids_[i]);
+  };
+  uint64_t num_runs =
+      ParallelSTL::count_if(uint64_t{0}, uint64_t{ids_.size()}, is_run_start);
+
+  // at most half full
+  uint64_t num_slots = 16;
+  while (num_slots < 2 * num_runs) {
+    num_slots *= 2;
+  }
+  slots_.allocateInterleaved(num_slots);
+  ParallelSTL::fill(slots_.begin(), slots_.end(), kEmptySlot);
+
+  uint64_t mask = num_slots - 1;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{ids_.size()}),
+      [&](uint64_t i) {
+        if (!is_run_start(i)) {
+          return;
+        }
+        // each distinct value is inserted once so claiming an empty slot is
+        // enough
+        for (uint64_t s = MixHash(hash(ids_[i])) & mask;; s = (s + 1) & mask) {
+          uint64_t expected = kEmptySlot;
+          if (__atomic_compare_exchange_n(
+                  &slots_[s], &expected, i, false, __ATOMIC_RELAXED,
+                  __ATOMIC_RELAXED)) {
+            return;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+template <typename node_or_edge>
+Result<std::unique_ptr<tsuba::FileFrame>>
+PropertyIndex<node_or_edge>::ToFile() const {
+  IndexFileHeader header{
+      .kind = static_cast<int32_t>(kind_),
+      .property_type = static_cast<int32_t>(property_type()),
+      .id_size = sizeof(node_or_edge),
+      .value_size = value_size(),
+      .num_entities = num_entities(),
+      .num_ids = ids_.size(),
+      .num_slots = slots_.size(),
+  };
+
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  KATANA_CHECKED(ff->Init());
+  KATANA_CHECKED(WritePadded(ff.get(), &header, sizeof(header)));
+  KATANA_CHECKED(
+      WritePadded(ff.get(), ids_.data(), ids_.size() * sizeof(node_or_edge)));
+  KATANA_CHECKED(
+      WritePadded(ff.get(), values_data(), ids_.size() * value_size()));
+  KATANA_CHECKED(
+      WritePadded(ff.get(), slots_.data(), slots_.size() * sizeof(uint64_t)));
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+template <typename node_or_edge>
+Result<void>
+PropertyIndex<node_or_edge>::BuildFromFile(tsuba::FileView&& file_view) {
+  auto storage = std::make_shared<tsuba::FileView>(std::move(file_view));
+  KATANA_CHECKED(StoredIndexKind(*storage));
+  IndexFileHeader header = *storage->ptr<IndexFileHeader>();
+  if (header.kind != static_cast<int32_t>(kind_) ||
+      header.property_type != static_cast<int32_t>(property_type()) ||
+      header.id_size != sizeof(node_or_edge) ||
+      header.value_size != value_size() ||
+      header.num_entities != num_entities()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "index file does not match the property");
+  }
+
+  uint64_t ids_bytes = Padded(header.num_ids * sizeof(node_or_edge));
+  uint64_t values_bytes = Padded(header.num_ids * header.value_size);
+  uint64_t slots_bytes = header.num_slots * sizeof(uint64_t);
+  uint64_t expected_size =
+      Padded(sizeof(IndexFileHeader)) + ids_bytes + values_bytes + slots_bytes;
+  if (header.num_ids > header.num_entities ||
+      storage->size() != expected_size ||
+      (header.num_slots & (header.num_slots - 1)) != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "index file size {} expected {}",
+        storage->size(), expected_size);
+  }
+
+  // The wrapping arrays neither free nor write the memory; indexes only
+  // hand out const pointers into their arrays
+  auto* data =
+      const_cast<uint8_t*>(storage->ptr<uint8_t>()) +
+      Padded(sizeof(IndexFileHeader));
+  ids_ = NUMAArray<node_or_edge>(data, header.num_ids);
+  data += ids_bytes;
+  WrapValues(data, header.num_ids);
+  data += values_bytes;
+  slots_ = NUMAArray<uint64_t>(data, header.num_slots);
+  storage_ = std::move(storage);
+
+  return katana::ResultSuccess();
+}
+
 template <typename node_or_edge, typename c_type>
 Result<void>
 PrimitivePropertyIndex<node_or_edge, c_type>::BuildFromProperty() {
@@ -47,14 +261,25 @@ PrimitivePropertyIndex<node_or_edge, c_type>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexId{i});
-    }
-  }
+  const ArrowArrayType& property = *property_;
+  this->BuildIds(
+      num_entities_, [&](node_or_edge id) { return property.IsValid(id); },
+      [&](node_or_edge a, node_or_edge b) {
+        return std::less<c_type>{}(property.Value(a), property.Value(b));
+      });
+
+  const auto& ids = this->ids_;
+  values_.allocateInterleaved(ids.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, ids.size()),
+      [&](size_t i) { values_[i] = property.Value(ids[i]); },
+      katana::no_stats());
+
+  this->BuildSlots(
+      [&](node_or_edge id) { return std::hash<c_type>{}(property.Value(id)); },
+      [&](node_or_edge a, node_or_edge b) {
+        return property.Value(a) == property.Value(b);
+      });
 
   return katana::ResultSuccess();
 }
@@ -67,19 +292,303 @@ StringPropertyIndex<node_or_edge>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexId{i});
+  this->BuildIds(
+      num_entities_, [&](node_or_edge id) { return property_->IsValid(id); },
+      [&](node_or_edge a, node_or_edge b) {
+        return GetValue(a) < GetValue(b);
+      });
+
+  this->BuildSlots(
+      [&](node_or_edge id) {
+        return std::hash<std::string_view>{}(GetValue(id));
+      },
+      [&](node_or_edge a, node_or_edge b) {
+        return GetValue(a) == GetValue(b);
+      });
+
+  return katana::ResultSuccess();
+}
+
+namespace internal {
+
+class IndexKeyColumn {
+public:
+  virtual ~IndexKeyColumn() = default;
+
+  virtual bool IsValid(uint64_t id) const = 0;
+  // Returns <0, 0 or >0 as the value of `a` is less than, equal to or greater
+  // than the value of `b`.
+  virtual int Compare(uint64_t a, uint64_t b) const = 0;
+  // Like Compare(a, b) for a key of the type of the column
+  virtual int Compare(uint64_t id, const arrow::Scalar& key) const = 0;
+};
+
+}  // namespace internal
+
+namespace {
+
+template <typename T>
+int
+ThreeWay(const T& a, const T& b) {
+  return (b < a) - (a < b);
+}
+
+template <typename ArrowType>
+class TypedKeyColumn final : public internal::IndexKeyColumn {
+public:
+  using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+  using ScalarType = typename arrow::TypeTraits<ArrowType>::ScalarType;
+
+  explicit TypedKeyColumn(const std::shared_ptr<arrow::Array>& array)
+      : array_(std::static_pointer_cast<ArrayType>(array)) {}
+
+  bool IsValid(uint64_t id) const override { return array_->IsValid(id); }
+
+  int Compare(uint64_t a, uint64_t b) const override {
+    return ThreeWay(array_->GetView(a), array_->GetView(b));
+  }
+
+  int Compare(uint64_t id, const arrow::Scalar& key) const override {
+    const auto& typed_key = static_cast<const ScalarType&>(key);
+    if constexpr (arrow::is_base_binary_type<ArrowType>::value) {
+      return ThreeWay(
+          array_->GetView(id), arrow::util::string_view(*typed_key.value));
+    } else {
+      return ThreeWay(array_->GetView(id), typed_key.value);
+    }
+  }
+
+private:
+  std::shared_ptr<ArrayType> array_;
+};
+
+Result<std::unique_ptr<internal::IndexKeyColumn>>
+MakeKeyColumn(const std::shared_ptr<arrow::Array>& array) {
+  std::unique_ptr<internal::IndexKeyColumn> column;
+
+  switch (array->type_id()) {
+  case arrow::Type::BOOL:
+    column = std::make_unique<TypedKeyColumn<arrow::BooleanType>>(array);
+    break;
+  case arrow::Type::INT8:
+    column = std::make_unique<TypedKeyColumn<arrow::Int8Type>>(array);
+    break;
+  case arrow::Type::INT16:
+    column = std::make_unique<TypedKeyColumn<arrow::Int16Type>>(array);
+    break;
+  case arrow::Type::INT32:
+    column = std::make_unique<TypedKeyColumn<arrow::Int32Type>>(array);
+    break;
+  case arrow::Type::INT64:
+    column = std::make_unique<TypedKeyColumn<arrow::Int64Type>>(array);
+    break;
+  case arrow::Type::UINT8:
+    column = std::make_unique<TypedKeyColumn<arrow::UInt8Type>>(array);
+    break;
+  case arrow::Type::UINT16:
+    column = std::make_unique<TypedKeyColumn<arrow::UInt16Type>>(array);
+    break;
+  case arrow::Type::UINT32:
+    column = std::make_unique<TypedKeyColumn<arrow::UInt32Type>>(array);
+    break;
+  case arrow::Type::UINT64:
+    column = std::make_unique<TypedKeyColumn<arrow::UInt64Type>>(array);
+    break;
+  case arrow::Type::FLOAT:
+    column = std::make_unique<TypedKeyColumn<arrow::FloatType>>(array);
+    break;
+  case arrow::Type::DOUBLE:
+    column = std::make_unique<TypedKeyColumn<arrow::DoubleType>>(array);
+    break;
+  case arrow::Type::STRING:
+    column = std::make_unique<TypedKeyColumn<arrow::StringType>>(array);
+    break;
+  case arrow::Type::LARGE_STRING:
+    column = std::make_unique<TypedKeyColumn<arrow::LargeStringType>>(array);
+    break;
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Column has type unknown for indexing: {}",
+        array->type()->ToString());
+  }
+
+  return Result<std::unique_ptr<internal::IndexKeyColumn>>(std::move(column));
+}
+
+}  // namespace
+
+template <typename node_or_edge>
+CompositePropertyIndex<node_or_edge>::CompositePropertyIndex(
+    const std::vector<std::string>& column_names, size_t num_entities,
+    std::vector<std::shared_ptr<arrow::Array>> properties)
+    : PropertyIndex<node_or_edge>(
+          JoinColumnNames(column_names), PropertyIndexKind::kSorted),
+      column_names_(column_names),
+      num_entities_(num_entities),
+      properties_(std::move(properties)) {}
+
+template <typename node_or_edge>
+CompositePropertyIndex<node_or_edge>::~CompositePropertyIndex() = default;
+
+template <typename node_or_edge>
+std::string
+CompositePropertyIndex<node_or_edge>::JoinColumnNames(
+    const std::vector<std::string>& column_names) {
+  std::string joined;
+  for (const auto& name : column_names) {
+    if (!joined.empty()) {
+      joined += ",";
+    }
+    joined += name;
+  }
+  return joined;
+}
+
+template <typename node_or_edge>
+Result<void>
+CompositePropertyIndex<node_or_edge>::BuildFromProperty() {
+  if (properties_.empty() || properties_.size() != column_names_.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "composite index needs one property per column");
+  }
+
+  columns_.clear();
+  for (size_t i = 0; i < properties_.size(); ++i) {
+    if (static_cast<uint64_t>(properties_[i]->length()) < num_entities_) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Property {} does not contain all entities", column_names_[i]);
     }
+    columns_.emplace_back(KATANA_CHECKED_CONTEXT(
+        MakeKeyColumn(properties_[i]), "column {}", column_names_[i]));
   }
 
+  this->BuildIds(
+      num_entities_,
+      [&](node_or_edge id) {
+        for (const auto& column : columns_) {
+          if (!column->IsValid(id)) {
+            return false;
+          }
+        }
+        return true;
+      },
+      [&](node_or_edge a, node_or_edge b) {
+        for (const auto& column : columns_) {
+          if (int cmp = column->Compare(a, b); cmp != 0) {
+            return cmp < 0;
+          }
+        }
+        return false;
+      });
+
   return katana::ResultSuccess();
 }
 
+template <typename node_or_edge>
+Result<typename CompositePropertyIndex<node_or_edge>::Key>
+CompositePropertyIndex<node_or_edge>::CastKey(const Key& key) const {
+  if (key.size() > columns_.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "key has {} values but the index has {}",
+        key.size(), columns_.size());
+  }
+
+  Key cast_key;
+  cast_key.reserve(key.size());
+  for (size_t i = 0; i < key.size(); ++i) {
+    if (!key[i] || !key[i]->is_valid) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "key value for {} is null",
+          column_names_[i]);
+    }
+    const std::shared_ptr<arrow::DataType>& type = properties_[i]->type();
+    if (key[i]->type->Equals(*type)) {
+      cast_key.emplace_back(key[i]);
+      continue;
+    }
+    auto cast_res = key[i]->CastTo(type);
+    if (!cast_res.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "casting key value for {} to {}: {}",
+          column_names_[i], type->ToString(), cast_res.status().ToString());
+    }
+    cast_key.emplace_back(cast_res.ValueOrDie());
+  }
+  return cast_key;
+}
+
+template <typename node_or_edge>
+int
+CompositePropertyIndex<node_or_edge>::CompareToKey(
+    node_or_edge id, const Key& key) const {
+  for (size_t i = 0; i < key.size(); ++i) {
+    if (int cmp = columns_[i]->Compare(id, *key[i]); cmp != 0) {
+      return cmp;
+    }
+  }
+  return 0;
+}
+
+template <typename node_or_edge>
+typename CompositePropertyIndex<node_or_edge>::iterator
+CompositePropertyIndex<node_or_edge>::LowerBound(const Key& key) const {
+  return std::partition_point(
+      this->begin(), this->end(),
+      [&](node_or_edge id) { return CompareToKey(id, key) < 0; });
+}
+
+template <typename node_or_edge>
+typename CompositePropertyIndex<node_or_edge>::iterator
+CompositePropertyIndex<node_or_edge>::UpperBound(const Key& key) const {
+  return std::partition_point(
+      this->begin(), this->end(),
+      [&](node_or_edge id) { return CompareToKey(id, key) <= 0; });
+}
+
+template <typename node_or_edge>
+Result<typename CompositePropertyIndex<node_or_edge>::IdRange>
+CompositePropertyIndex<node_or_edge>::EqualRange(const Key& prefix) const {
+  Key key = KATANA_CHECKED(CastKey(prefix));
+  return IdRange(LowerBound(key), UpperBound(key));
+}
+
+template <typename node_or_edge>
+Result<typename CompositePropertyIndex<node_or_edge>::IdRange>
+CompositePropertyIndex<node_or_edge>::Range(
+    const Key& prefix, const std::shared_ptr<arrow::Scalar>& lower,
+    const std::shared_ptr<arrow::Scalar>& upper) const {
+  if (prefix.size() >= columns_.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "range prefix has {} values but the index has {} columns",
+        prefix.size(), columns_.size());
+  }
+
+  Key key = prefix;
+  if (lower) {
+    key.emplace_back(lower);
+  }
+  iterator first = LowerBound(KATANA_CHECKED(CastKey(key)));
+
+  key.resize(prefix.size());
+  if (upper) {
+    key.emplace_back(upper);
+  }
+  iterator last = UpperBound(KATANA_CHECKED(CastKey(key)));
+
+  // lower > upper
+  if (last < first) {
+    last = first;
+  }
+  return IdRange(first, last);
+}
+
 // Forward declare template types to allow implementation in .cpp.
+template class PropertyIndex<GraphTopology::Node>;
+template class PropertyIndex<GraphTopology::Edge>;
+
 template class PrimitivePropertyIndex<GraphTopology::Node, bool>;
 template class PrimitivePropertyIndex<GraphTopology::Edge, bool>;
 template class PrimitivePropertyIndex<GraphTopology::Node, int64_t>;
@@ -90,13 +599,16 @@ template class PrimitivePropertyIndex<GraphTopology::Edge, double_t>;
 template class StringPropertyIndex<GraphTopology::Node>;
 template class StringPropertyIndex<GraphTopology::Edge>;
 
+template class CompositePropertyIndex<GraphTopology::Node>;
+template class CompositePropertyIndex<GraphTopology::Edge>;
+
 template Result<std::unique_ptr<PropertyIndex<GraphTopology::Node>>>
 MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, PropertyIndexKind kind);
 template Result<std::unique_ptr<PropertyIndex<GraphTopology::Edge>>>
 MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, PropertyIndexKind kind);
 
 }  // namespace katana
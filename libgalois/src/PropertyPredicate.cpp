@@ -0,0 +1,237 @@
+#include "katana/PropertyPredicate.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <arrow/compute/api.h>
+#include <arrow/util/bitmap_ops.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+
+namespace {
+
+/// Rows evaluated together; a multiple of the bits of a word so that blocks
+/// fill whole words of the selection
+constexpr int64_t kBlockRows = int64_t{1} << 16;
+constexpr int64_t kWordBits = 64;
+
+const char*
+CompareFunction(katana::CompareOp op) {
+  switch (op) {
+  case katana::CompareOp::kEqual:
+    return "equal";
+  case katana::CompareOp::kNotEqual:
+    return "not_equal";
+  case katana::CompareOp::kLess:
+    return "less";
+  case katana::CompareOp::kLessEqual:
+    return "less_equal";
+  case katana::CompareOp::kGreater:
+    return "greater";
+  case katana::CompareOp::kGreaterEqual:
+    return "greater_equal";
+  }
+  return "";
+}
+
+struct Comparison {
+  const katana::PropertyPredicate* predicate;
+  std::shared_ptr<arrow::ChunkedArray> column;
+
+  arrow::Result<arrow::Datum> Evaluate(int64_t begin, int64_t length) const {
+    auto rows = column->Slice(begin, length);
+    if (rows->type()->id() != arrow::Type::type::DICTIONARY) {
+      return Compare(arrow::Datum(rows));
+    }
+
+    // Dictionary-encoded rows are not decoded: the values of the dictionary
+    // are compared and the results are taken at the codes of the rows
+    std::vector<std::shared_ptr<arrow::Array>> chunks;
+    for (const auto& chunk : rows->chunks()) {
+      const auto& dict_array =
+          static_cast<const arrow::DictionaryArray&>(*chunk);
+      ARROW_ASSIGN_OR_RAISE(
+          arrow::Datum matches, Compare(arrow::Datum(dict_array.dictionary())));
+      ARROW_ASSIGN_OR_RAISE(
+          arrow::Datum taken,
+          arrow::compute::Take(matches, arrow::Datum(dict_array.indices())));
+      chunks.emplace_back(taken.make_array());
+    }
+    return arrow::Datum(
+        std::make_shared<arrow::ChunkedArray>(chunks, arrow::boolean()));
+  }
+
+private:
+  arrow::Result<arrow::Datum> Compare(const arrow::Datum& values) const {
+    return arrow::compute::CallFunction(
+        CompareFunction(predicate->op),
+        {values, arrow::Datum(predicate->value)});
+  }
+};
+
+/// Copy the rows of booleans that are true and not null to the bits of
+/// words, starting at bit 0
+void
+CopyTrueBits(const arrow::Datum& booleans, std::vector<uint64_t>* words) {
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  if (booleans.is_array()) {
+    chunks.emplace_back(booleans.make_array());
+  } else {
+    chunks = booleans.chunked_array()->chunks();
+  }
+
+  std::vector<uint64_t> valid;
+  auto* out = reinterpret_cast<uint8_t*>(words->data());
+  int64_t offset = 0;
+  for (const auto& chunk : chunks) {
+    const arrow::ArrayData& data = *chunk->data();
+    if (data.length == 0) {
+      continue;
+    }
+    arrow::internal::CopyBitmap(
+        data.buffers[1]->data(), data.offset, data.length, out, offset);
+    if (data.GetNullCount() > 0) {
+      valid.assign(words->size(), ~uint64_t{0});
+      arrow::internal::CopyBitmap(
+          data.buffers[0]->data(), data.offset, data.length,
+          reinterpret_cast<uint8_t*>(valid.data()), offset);
+      for (size_t i = 0; i < words->size(); ++i) {
+        (*words)[i] &= valid[i];
+      }
+    }
+    offset += data.length;
+  }
+}
+
+katana::Result<katana::DynamicBitset>
+Select(
+    const std::vector<katana::PropertyPredicate>& predicates, int64_t num_rows,
+    const std::function<std::shared_ptr<arrow::ChunkedArray>(
+        const std::string&)>& get_property) {
+  std::vector<Comparison> comparisons;
+  for (const auto& predicate : predicates) {
+    auto column = get_property(predicate.property);
+    if (!column) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no property named {}",
+          predicate.property);
+    }
+    if (!predicate.value || !predicate.value->is_valid) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "the value compared with {} is null", predicate.property);
+    }
+    Comparison comparison{&predicate, std::move(column)};
+    // Check that the types are comparable before evaluating blocks
+    KATANA_CHECKED_CONTEXT(
+        comparison.Evaluate(0, 0), "comparing {}", predicate.property);
+    comparisons.emplace_back(std::move(comparison));
+  }
+
+  katana::DynamicBitset selection;
+  selection.resize(num_rows);
+  auto& selection_words = selection.get_vec();
+
+  int64_t num_blocks = (num_rows + kBlockRows - 1) / kBlockRows;
+  std::vector<katana::CopyableResult<void>> results(
+      num_blocks, katana::CopyableResultSuccess());
+  katana::do_all(
+      katana::iterate(int64_t{0}, num_blocks),
+      [&](int64_t block) {
+        int64_t begin = block * kBlockRows;
+        int64_t length = std::min(kBlockRows, num_rows - begin);
+        size_t num_words = (length + kWordBits - 1) / kWordBits;
+
+        std::vector<uint64_t> words(num_words, ~uint64_t{0});
+        std::vector<uint64_t> satisfied(num_words);
+        for (const auto& comparison : comparisons) {
+          auto booleans = comparison.Evaluate(begin, length);
+          if (!booleans.ok()) {
+            results[block] =
+                katana::CopyableErrorInfo(katana::ErrorCode::ArrowError)
+                    .WithContext(
+                        "comparing {}: {}", comparison.predicate->property,
+                        booleans.status());
+            return;
+          }
+          CopyTrueBits(booleans.ValueOrDie(), &satisfied);
+          for (size_t i = 0; i < num_words; ++i) {
+            words[i] &= satisfied[i];
+          }
+        }
+        if (int64_t tail_bits = length % kWordBits; tail_bits != 0) {
+          words[num_words - 1] &= (uint64_t{1} << tail_bits) - 1;
+        }
+
+        size_t first_word = begin / kWordBits;
+        for (size_t i = 0; i < num_words; ++i) {
+          selection_words[first_word + i].store(
+              words[i], std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  for (const auto& result : results) {
+    if (!result) {
+      return katana::ErrorInfo(result.error());
+    }
+  }
+  return katana::DynamicBitset(std::move(selection));
+}
+
+template <typename HasType>
+katana::DynamicBitset
+SelectOfType(size_t num_entities, const HasType& has_type) {
+  constexpr size_t kBits = kWordBits;
+  katana::DynamicBitset selection;
+  selection.resize(num_entities);
+  auto& words = selection.get_vec();
+  katana::do_all(
+      katana::iterate(size_t{0}, words.size()),
+      [&](size_t i) {
+        uint64_t word = 0;
+        size_t end = std::min(num_entities, (i + 1) * kBits);
+        for (size_t id = i * kBits; id < end; ++id) {
+          word |= uint64_t{has_type(id)} << (id % kBits);
+        }
+        words[i].store(word, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  return selection;
+}
+
+}  // namespace
+
+katana::Result<katana::DynamicBitset>
+katana::SelectNodes(
+    const PropertyGraph& pg, const std::vector<PropertyPredicate>& predicates) {
+  return Select(predicates, pg.num_nodes(), [&](const std::string& name) {
+    return pg.GetNodeProperty(name);
+  });
+}
+
+katana::Result<katana::DynamicBitset>
+katana::SelectEdges(
+    const PropertyGraph& pg, const std::vector<PropertyPredicate>& predicates) {
+  return Select(predicates, pg.num_edges(), [&](const std::string& name) {
+    return pg.GetEdgeProperty(name);
+  });
+}
+
+katana::DynamicBitset
+katana::SelectNodesOfType(const PropertyGraph& pg, EntityTypeID type_id) {
+  return SelectOfType(pg.num_nodes(), [&](size_t node) {
+    return pg.DoesNodeHaveType(node, type_id);
+  });
+}
+
+katana::DynamicBitset
+katana::SelectEdgesOfType(const PropertyGraph& pg, EntityTypeID type_id) {
+  return SelectOfType(pg.num_edges(), [&](size_t edge) {
+    return pg.DoesEdgeHaveType(edge, type_id);
+  });
+}
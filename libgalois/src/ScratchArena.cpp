@@ -0,0 +1,52 @@
+#include "katana/ScratchArena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+katana::ScratchArena::~ScratchArena() {
+  for (const Block& block : blocks_) {
+    std::free(block.data);
+  }
+}
+
+katana::ScratchArena&
+katana::ScratchArena::Local() {
+  static thread_local ScratchArena arena;
+  return arena;
+}
+
+void*
+katana::ScratchArena::AllocateSlow(size_t bytes, size_t alignment) {
+  // malloc aligns to max_align_t; stricter alignments need slack
+  size_t needed =
+      bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+
+  // Take the first free block that fits, moving it to the end of those in
+  // use so that the free blocks it skips are kept for later
+  auto it = std::find_if(
+      blocks_.begin() + current_, blocks_.end(),
+      [&](const Block& block) { return block.size >= needed; });
+  if (it == blocks_.end()) {
+    size_t size = std::max(needed, kBlockSize);
+    char* data = static_cast<char*>(std::malloc(size));
+    if (data == nullptr) {
+      throw std::bad_alloc();
+    }
+    blocks_.emplace_back(Block{data, size});
+    it = blocks_.end() - 1;
+  }
+  std::rotate(blocks_.begin() + current_, it, it + 1);
+  ++current_;
+  offset_ = 0;
+
+  return Allocate(bytes, alignment);
+}
+
+size_t
+katana::ScratchArena::bytes_reserved() const {
+  size_t bytes = 0;
+  for (const Block& block : blocks_) {
+    bytes += block.size;
+  }
+  return bytes;
+}
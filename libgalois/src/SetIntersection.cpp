@@ -0,0 +1,134 @@
+#include "katana/SetIntersection.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+uint64_t
+MergeCount(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    size_t i, size_t j) {
+  uint64_t count = 0;
+  while (i < a_size && j < b_size) {
+    uint32_t x = a[i];
+    uint32_t y = b[j];
+    count += x == y;
+    i += x <= y;
+    j += y <= x;
+  }
+  return count;
+}
+
+uint64_t
+GallopCount(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  uint64_t count = 0;
+  auto fn = [&count](size_t, size_t) {
+    ++count;
+    return true;
+  };
+  katana::internal::GallopForEach(a, a_size, b, b_size, fn);
+  return count;
+}
+
+#if defined(__x86_64__)
+
+// The block kernels compare a block of a with each element of a block of b,
+// as broadcasts or rotations of the block, which finds every element of the
+// block of a that is in the block of b, and then move past the block with
+// the smaller last element, or both.
+// The elements left over after the last full blocks are merged one at a
+// time.
+
+__attribute__((target("avx512f"))) uint64_t
+MergeCountAvx512(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  uint64_t count = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i + 16 <= a_size && j + 16 <= b_size) {
+    __m512i va = _mm512_loadu_si512(a + i);
+    __mmask16 match = 0;
+    for (int r = 0; r < 16; ++r) {
+      match |= _mm512_cmpeq_epi32_mask(va, _mm512_set1_epi32(b[j + r]));
+    }
+    count += __builtin_popcount(match);
+
+    uint32_t a_last = a[i + 15];
+    uint32_t b_last = b[j + 15];
+    i += a_last <= b_last ? 16 : 0;
+    j += b_last <= a_last ? 16 : 0;
+  }
+  return count + MergeCount(a, a_size, b, b_size, i, j);
+}
+
+__attribute__((target("avx2"))) uint64_t
+MergeCountAvx2(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+  uint64_t count = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i + 8 <= a_size && j + 8 <= b_size) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+    __m256i match = _mm256_cmpeq_epi32(va, vb);
+    for (int r = 1; r < 8; ++r) {
+      vb = _mm256_permutevar8x32_epi32(vb, rotate);
+      match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+    }
+    count += __builtin_popcount(
+        _mm256_movemask_ps(_mm256_castsi256_ps(match)));
+
+    uint32_t a_last = a[i + 7];
+    uint32_t b_last = b[j + 7];
+    i += a_last <= b_last ? 8 : 0;
+    j += b_last <= a_last ? 8 : 0;
+  }
+  return count + MergeCount(a, a_size, b, b_size, i, j);
+}
+
+const bool kHaveAvx512 = __builtin_cpu_supports("avx512f");
+const bool kHaveAvx2 = __builtin_cpu_supports("avx2");
+
+uint64_t
+BlockMergeCount(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  if (kHaveAvx512) {
+    return MergeCountAvx512(a, a_size, b, b_size);
+  }
+  if (kHaveAvx2) {
+    return MergeCountAvx2(a, a_size, b, b_size);
+  }
+  return MergeCount(a, a_size, b, b_size, 0, 0);
+}
+
+#else
+
+uint64_t
+BlockMergeCount(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  return MergeCount(a, a_size, b, b_size, 0, 0);
+}
+
+#endif
+
+}  // namespace
+
+uint64_t
+katana::IntersectionSize(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  if (a_size == 0 || b_size == 0 || a[a_size - 1] < b[0] ||
+      b[b_size - 1] < a[0]) {
+    return 0;
+  }
+  if (a_size * kGallopRatio <= b_size) {
+    return GallopCount(a, a_size, b, b_size);
+  }
+  if (b_size * kGallopRatio <= a_size) {
+    return GallopCount(b, b_size, a, a_size);
+  }
+  return BlockMergeCount(a, a_size, b, b_size);
+}
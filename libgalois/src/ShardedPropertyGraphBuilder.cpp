@@ -0,0 +1,696 @@
+#include "katana/BuildGraph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Result.h"
+#include "katana/ThreadPool.h"
+
+using katana::ImportData;
+using katana::ImportDataType;
+using katana::StagedColumn;
+using katana::StagedColumns;
+
+namespace {
+
+/// IDs are resolved by partitions of their hashes, each by one thread. The
+/// number is fixed so that the numbering of placeholder nodes does not depend
+/// on the number of threads.
+constexpr size_t kNumIdPartitions = 256;
+
+/// Marks an endpoint resolved to the index of a placeholder node within its
+/// partition rather than to a node
+constexpr uint64_t kPlaceholder = uint64_t{1} << 63;
+
+constexpr size_t kNoColumn = std::numeric_limits<size_t>::max();
+
+size_t
+PartitionOf(std::string_view id) {
+  return std::hash<std::string_view>{}(id) % kNumIdPartitions;
+}
+
+/// The Arrow type of a column of values of type, as
+/// PropertyGraphBuilder::AddBuilder picks it
+katana::Result<std::shared_ptr<arrow::DataType>>
+ArrowTypeOf(ImportDataType type, bool is_list) {
+  std::shared_ptr<arrow::DataType> value_type;
+  switch (type) {
+  case ImportDataType::kString:
+    value_type = arrow::utf8();
+    break;
+  case ImportDataType::kInt64:
+    value_type = arrow::int64();
+    break;
+  case ImportDataType::kInt32:
+    value_type = arrow::int32();
+    break;
+  case ImportDataType::kDouble:
+    value_type = arrow::float64();
+    break;
+  case ImportDataType::kFloat:
+    value_type = arrow::float32();
+    break;
+  case ImportDataType::kBoolean:
+    value_type = arrow::boolean();
+    break;
+  case ImportDataType::kUInt32:
+    if (!is_list) {
+      return arrow::uint32();
+    }
+    break;
+  case ImportDataType::kTimestampMilli:
+    if (!is_list) {
+      return arrow::timestamp(arrow::TimeUnit::MILLI, "UTC");
+    }
+    break;
+  // for now uint8_t is an alias for a struct
+  case ImportDataType::kStruct:
+    if (!is_list) {
+      return arrow::uint8();
+    }
+    break;
+  default:
+    break;
+  }
+  if (!value_type) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "unsupported property type {} (list: {})", type, is_list);
+  }
+  if (is_list) {
+    return arrow::list(value_type);
+  }
+  return value_type;
+}
+
+template <typename Builder, typename T>
+katana::Result<void>
+AppendAs(arrow::ArrayBuilder* builder, const ImportData& data) {
+  const T* value = std::get_if<T>(&data.value);
+  if (value == nullptr) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "value does not hold its type {}",
+        data.type);
+  }
+  KATANA_CHECKED(static_cast<Builder*>(builder)->Append(*value));
+  return katana::ResultSuccess();
+}
+
+template <typename Builder, typename T>
+katana::Result<void>
+AppendListAs(arrow::ArrayBuilder* builder, const ImportData& data) {
+  const auto* values = std::get_if<std::vector<T>>(&data.value);
+  if (values == nullptr) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "value does not hold a list of {}",
+        data.type);
+  }
+  auto* list_builder = static_cast<arrow::ListBuilder*>(builder);
+  KATANA_CHECKED(list_builder->Append());
+  auto* value_builder = static_cast<Builder*>(list_builder->value_builder());
+  for (const auto& value : *values) {
+    KATANA_CHECKED(value_builder->Append(value));
+  }
+  return katana::ResultSuccess();
+}
+
+/// Append data to a builder of ArrowTypeOf(data.type, data.is_list)
+katana::Result<void>
+AppendImportData(arrow::ArrayBuilder* builder, const ImportData& data) {
+  if (data.is_list) {
+    switch (data.type) {
+    case ImportDataType::kString:
+      return AppendListAs<arrow::StringBuilder, std::string>(builder, data);
+    case ImportDataType::kInt64:
+      return AppendListAs<arrow::Int64Builder, int64_t>(builder, data);
+    case ImportDataType::kInt32:
+      return AppendListAs<arrow::Int32Builder, int32_t>(builder, data);
+    case ImportDataType::kDouble:
+      return AppendListAs<arrow::DoubleBuilder, double>(builder, data);
+    case ImportDataType::kFloat:
+      return AppendListAs<arrow::FloatBuilder, float>(builder, data);
+    case ImportDataType::kBoolean:
+      return AppendListAs<arrow::BooleanBuilder, bool>(builder, data);
+    default:
+      break;
+    }
+  } else {
+    switch (data.type) {
+    case ImportDataType::kString:
+      return AppendAs<arrow::StringBuilder, std::string>(builder, data);
+    case ImportDataType::kInt64:
+      return AppendAs<arrow::Int64Builder, int64_t>(builder, data);
+    case ImportDataType::kInt32:
+      return AppendAs<arrow::Int32Builder, int32_t>(builder, data);
+    case ImportDataType::kUInt32:
+      return AppendAs<arrow::UInt32Builder, uint32_t>(builder, data);
+    case ImportDataType::kDouble:
+      return AppendAs<arrow::DoubleBuilder, double>(builder, data);
+    case ImportDataType::kFloat:
+      return AppendAs<arrow::FloatBuilder, float>(builder, data);
+    case ImportDataType::kBoolean:
+      return AppendAs<arrow::BooleanBuilder, bool>(builder, data);
+    case ImportDataType::kTimestampMilli:
+      return AppendAs<arrow::TimestampBuilder, int64_t>(builder, data);
+    case ImportDataType::kStruct:
+      return AppendAs<arrow::UInt8Builder, uint8_t>(builder, data);
+    default:
+      break;
+    }
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::InvalidArgument, "unsupported property type {}",
+      data.type);
+}
+
+katana::Result<void>
+StageLabel(
+    StagedColumns* labels, uint64_t index, const std::string& label) {
+  auto [it, inserted] = labels->keys.emplace(label, labels->columns.size());
+  if (inserted) {
+    labels->columns.emplace_back(
+        StagedColumn{label, ImportDataType::kBoolean, false, {}, {}});
+  }
+  labels->columns[it->second].indexes.emplace_back(index);
+  return katana::ResultSuccess();
+}
+
+/// \returns the column of property, which is added if it does not exist yet
+katana::Result<StagedColumn*>
+DeclareColumn(
+    StagedColumns* properties, const std::string& property,
+    ImportDataType type, bool is_list) {
+  auto key = properties->keys.find(property);
+  if (key == properties->keys.end()) {
+    KATANA_CHECKED_CONTEXT(ArrowTypeOf(type, is_list), "property {}", property);
+    key = properties->keys.emplace(property, properties->columns.size()).first;
+    properties->columns.emplace_back(
+        StagedColumn{property, type, is_list, {}, {}});
+  }
+  StagedColumn& column = properties->columns[key->second];
+  if (column.type != type || column.is_list != is_list) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "property {} has values of types {} and {}", property, column.type,
+        type);
+  }
+  return &column;
+}
+
+katana::Result<void>
+StageValue(
+    StagedColumns* properties, uint64_t index, const std::string& property,
+    ImportData value) {
+  // unsupported values are nulls
+  if (value.type == ImportDataType::kUnsupported) {
+    return katana::ResultSuccess();
+  }
+  StagedColumn* column = KATANA_CHECKED(
+      DeclareColumn(properties, property, value.type, value.is_list));
+  column->indexes.emplace_back(index);
+  column->values.emplace_back(std::move(value));
+  return katana::ResultSuccess();
+}
+
+/// A column merged across shards
+struct MergedColumn {
+  std::string name;
+  ImportDataType type;
+  bool is_list;
+  /// the index of the column in each shard, or kNoColumn
+  std::vector<size_t> shard_columns;
+};
+
+katana::Result<std::vector<MergedColumn>>
+MergeColumns(const std::vector<const StagedColumns*>& shards) {
+  std::vector<MergedColumn> merged;
+  std::unordered_map<std::string, size_t> keys;
+  for (size_t s = 0; s < shards.size(); ++s) {
+    for (size_t c = 0; c < shards[s]->columns.size(); ++c) {
+      const StagedColumn& column = shards[s]->columns[c];
+      auto [it, inserted] = keys.emplace(column.name, merged.size());
+      if (inserted) {
+        merged.emplace_back(MergedColumn{
+            column.name, column.type, column.is_list,
+            std::vector<size_t>(shards.size(), kNoColumn)});
+      }
+      MergedColumn& m = merged[it->second];
+      if (m.type != column.type || m.is_list != column.is_list) {
+        return KATANA_ERROR(
+            katana::ErrorCode::TypeError,
+            "property {} has values of types {} and {} in different shards",
+            column.name, m.type, column.type);
+      }
+      m.shard_columns[s] = c;
+    }
+  }
+  return merged;
+}
+
+/// Build the chunks of a column, each by one thread. The append function
+/// appends rows [begin, end) to a builder of type.
+template <typename AppendFn>
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+BuildColumn(
+    const std::shared_ptr<arrow::DataType>& type, size_t num_rows,
+    size_t chunk_size, const AppendFn& append) {
+  size_t num_chunks = (num_rows + chunk_size - 1) / chunk_size;
+  katana::ArrowArrays chunks(num_chunks);
+  std::vector<katana::Result<void>> results(
+      num_chunks, katana::ResultSuccess());
+
+  auto build_chunk = [&](size_t c) -> katana::Result<void> {
+    size_t begin = c * chunk_size;
+    size_t end = std::min(num_rows, begin + chunk_size);
+    std::unique_ptr<arrow::ArrayBuilder> builder;
+    KATANA_CHECKED(
+        arrow::MakeBuilder(arrow::default_memory_pool(), type, &builder));
+    KATANA_CHECKED(builder->Reserve(end - begin));
+    KATANA_CHECKED(append(builder.get(), begin, end));
+    chunks[c] = KATANA_CHECKED(builder->Finish());
+    return katana::ResultSuccess();
+  };
+  katana::do_all(
+      katana::iterate(size_t{0}, num_chunks),
+      [&](size_t c) { results[c] = build_chunk(c); }, katana::steal(),
+      katana::chunk_size<1>(), katana::no_stats());
+
+  for (auto& res : results) {
+    if (!res) {
+      return res.error();
+    }
+  }
+  return std::make_shared<arrow::ChunkedArray>(chunks, type);
+}
+
+/// Build the property table of the columns of the shards, where row(s, i) is
+/// the row of element i of shard s
+template <typename RowFn>
+katana::Result<std::shared_ptr<arrow::Table>>
+BuildPropertyTable(
+    const std::vector<const StagedColumns*>& shards, size_t num_rows,
+    size_t chunk_size, const RowFn& row) {
+  auto merged = KATANA_CHECKED(MergeColumns(shards));
+
+  // values[r] is the value of row r or null
+  katana::NUMAArray<const ImportData*> values;
+  values.allocateInterleaved(num_rows);
+
+  katana::ArrowFields fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const MergedColumn& column : merged) {
+    auto type = KATANA_CHECKED(ArrowTypeOf(column.type, column.is_list));
+
+    katana::ParallelSTL::fill(values.begin(), values.end(), nullptr);
+    katana::do_all(
+        katana::iterate(size_t{0}, shards.size()),
+        [&](size_t s) {
+          if (column.shard_columns[s] == kNoColumn) {
+            return;
+          }
+          const StagedColumn& staged =
+              shards[s]->columns[column.shard_columns[s]];
+          for (size_t k = 0; k < staged.indexes.size(); ++k) {
+            values[row(s, staged.indexes[k])] = &staged.values[k];
+          }
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+    auto append = [&](arrow::ArrayBuilder* builder, size_t begin,
+                      size_t end) -> katana::Result<void> {
+      for (size_t r = begin; r < end; ++r) {
+        if (values[r] == nullptr) {
+          KATANA_CHECKED(builder->AppendNull());
+        } else {
+          KATANA_CHECKED_CONTEXT(
+              AppendImportData(builder, *values[r]), "property {}",
+              column.name);
+        }
+      }
+      return katana::ResultSuccess();
+    };
+    columns.emplace_back(
+        KATANA_CHECKED(BuildColumn(type, num_rows, chunk_size, append)));
+    fields.emplace_back(arrow::field(column.name, type));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+/// Build the label (or type) table of the shards, where row(s, i) is the row
+/// of element i of shard s
+template <typename RowFn>
+katana::Result<std::shared_ptr<arrow::Table>>
+BuildLabelTable(
+    const std::vector<const StagedColumns*>& shards, size_t num_rows,
+    size_t chunk_size, const RowFn& row) {
+  auto merged = KATANA_CHECKED(MergeColumns(shards));
+
+  katana::NUMAArray<uint8_t> flags;
+  flags.allocateInterleaved(num_rows);
+
+  katana::ArrowFields fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const MergedColumn& column : merged) {
+    katana::ParallelSTL::fill(flags.begin(), flags.end(), uint8_t{0});
+    katana::do_all(
+        katana::iterate(size_t{0}, shards.size()),
+        [&](size_t s) {
+          if (column.shard_columns[s] == kNoColumn) {
+            return;
+          }
+          for (uint64_t index :
+               shards[s]->columns[column.shard_columns[s]].indexes) {
+            flags[row(s, index)] = 1;
+          }
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+    auto append = [&](arrow::ArrayBuilder* builder, size_t begin,
+                      size_t end) -> katana::Result<void> {
+      KATANA_CHECKED(static_cast<arrow::BooleanBuilder*>(builder)->AppendValues(
+          &flags[begin], end - begin));
+      return katana::ResultSuccess();
+    };
+    columns.emplace_back(KATANA_CHECKED(
+        BuildColumn(arrow::boolean(), num_rows, chunk_size, append)));
+    fields.emplace_back(arrow::field(column.name, arrow::boolean()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+}  // namespace
+
+/*************************************/
+/* Functions for adding to one shard */
+/*************************************/
+
+void
+katana::ShardedPropertyGraphBuilder::Shard::AddNode(std::string id) {
+  node_ids_.emplace_back(std::move(id));
+}
+
+katana::Result<void>
+katana::ShardedPropertyGraphBuilder::Shard::AddNodeLabel(
+    const std::string& label) {
+  if (node_ids_.empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "no node to label");
+  }
+  return StageLabel(&node_labels_, node_ids_.size() - 1, label);
+}
+
+katana::Result<void>
+katana::ShardedPropertyGraphBuilder::Shard::AddNodeValue(
+    const std::string& property, ImportData value) {
+  if (node_ids_.empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "no node for the value");
+  }
+  return StageValue(
+      &node_properties_, node_ids_.size() - 1, property, std::move(value));
+}
+
+void
+katana::ShardedPropertyGraphBuilder::Shard::AddEdge(
+    std::string source, std::string target) {
+  edge_sources_.emplace_back(std::move(source));
+  edge_targets_.emplace_back(std::move(target));
+}
+
+katana::Result<void>
+katana::ShardedPropertyGraphBuilder::Shard::AddEdgeType(
+    const std::string& type) {
+  if (edge_sources_.empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "no edge for the type");
+  }
+  return StageLabel(&edge_types_, edge_sources_.size() - 1, type);
+}
+
+katana::Result<void>
+katana::ShardedPropertyGraphBuilder::Shard::AddEdgeValue(
+    const std::string& property, ImportData value) {
+  if (edge_sources_.empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "no edge for the value");
+  }
+  return StageValue(
+      &edge_properties_, edge_sources_.size() - 1, property, std::move(value));
+}
+
+katana::Result<void>
+katana::ShardedPropertyGraphBuilder::Shard::DeclareNodeProperty(
+    const std::string& property, ImportDataType type, bool is_list) {
+  KATANA_CHECKED(DeclareColumn(&node_properties_, property, type, is_list));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::ShardedPropertyGraphBuilder::Shard::DeclareEdgeProperty(
+    const std::string& property, ImportDataType type, bool is_list) {
+  KATANA_CHECKED(DeclareColumn(&edge_properties_, property, type, is_list));
+  return katana::ResultSuccess();
+}
+
+/*********************************/
+/* Functions for building Graphs */
+/*********************************/
+
+katana::ShardedPropertyGraphBuilder::ShardedPropertyGraphBuilder(
+    size_t num_shards, size_t chunk_size)
+    : shards_(num_shards > 0 ? num_shards : katana::getActiveThreads()),
+      chunk_size_(std::max<size_t>(chunk_size, 1)) {}
+
+size_t
+katana::ShardedPropertyGraphBuilder::AddShards(size_t num_shards) {
+  size_t first = shards_.size();
+  shards_.resize(first + num_shards);
+  return first;
+}
+
+katana::ShardedPropertyGraphBuilder::Shard*
+katana::ShardedPropertyGraphBuilder::GetLocalShard() {
+  unsigned tid = katana::ThreadPool::getTID();
+  KATANA_LOG_VASSERT(
+      tid < shards_.size(), "thread {} has no shard of {}", tid,
+      shards_.size());
+  return &shards_[tid];
+}
+
+katana::Result<katana::GraphComponents>
+katana::ShardedPropertyGraphBuilder::Finish(bool verbose) {
+  size_t num_shards = shards_.size();
+
+  // shard s adds nodes [node_base[s], node_base[s + 1]) and likewise edges
+  std::vector<uint64_t> node_base(num_shards + 1, 0);
+  std::vector<uint64_t> edge_base(num_shards + 1, 0);
+  for (size_t s = 0; s < num_shards; ++s) {
+    node_base[s + 1] = node_base[s] + shards_[s].num_nodes();
+    edge_base[s + 1] = edge_base[s] + shards_[s].num_edges();
+  }
+  uint64_t num_added_nodes = node_base[num_shards];
+  uint64_t num_edges = edge_base[num_shards];
+
+  // Group the IDs of each shard by partition, so that each partition is
+  // resolved by one thread without locks. An endpoint 2 * e is the source of
+  // edge e and 2 * e + 1 its target.
+  struct NodeRef {
+    std::string_view id;
+    uint64_t node;
+  };
+  struct EndpointRef {
+    std::string_view id;
+    uint64_t endpoint;
+  };
+  std::vector<std::vector<std::vector<NodeRef>>> node_refs(
+      num_shards, std::vector<std::vector<NodeRef>>(kNumIdPartitions));
+  std::vector<std::vector<std::vector<EndpointRef>>> endpoint_refs(
+      num_shards, std::vector<std::vector<EndpointRef>>(kNumIdPartitions));
+  katana::do_all(
+      katana::iterate(size_t{0}, num_shards),
+      [&](size_t s) {
+        const Shard& shard = shards_[s];
+        for (size_t i = 0; i < shard.node_ids_.size(); ++i) {
+          std::string_view id = shard.node_ids_[i];
+          node_refs[s][PartitionOf(id)].emplace_back(
+              NodeRef{id, node_base[s] + i});
+        }
+        for (size_t i = 0; i < shard.edge_sources_.size(); ++i) {
+          uint64_t edge = edge_base[s] + i;
+          std::string_view source = shard.edge_sources_[i];
+          std::string_view target = shard.edge_targets_[i];
+          endpoint_refs[s][PartitionOf(source)].emplace_back(
+              EndpointRef{source, 2 * edge});
+          endpoint_refs[s][PartitionOf(target)].emplace_back(
+              EndpointRef{target, 2 * edge + 1});
+        }
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+  // the first node added with an ID wins, as in PropertyGraphBuilder; IDs
+  // without a node get a placeholder node, numbered within their partition
+  // until the number of placeholders of each partition is known
+  katana::NUMAArray<uint64_t> endpoints;
+  endpoints.allocateInterleaved(2 * num_edges);
+  std::vector<uint64_t> num_placeholders(kNumIdPartitions, 0);
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumIdPartitions),
+      [&](size_t p) {
+        std::unordered_map<std::string_view, uint64_t> nodes;
+        for (size_t s = 0; s < num_shards; ++s) {
+          for (const NodeRef& ref : node_refs[s][p]) {
+            nodes.emplace(ref.id, ref.node);
+          }
+        }
+        for (size_t s = 0; s < num_shards; ++s) {
+          for (const EndpointRef& ref : endpoint_refs[s][p]) {
+            auto [it, inserted] =
+                nodes.emplace(ref.id, kPlaceholder | num_placeholders[p]);
+            if (inserted) {
+              num_placeholders[p] += 1;
+            }
+            endpoints[ref.endpoint] = it->second;
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+  // placeholders of partition p are nodes [placeholder_base[p], ...)
+  std::vector<uint64_t> placeholder_base(kNumIdPartitions + 1);
+  placeholder_base[0] = num_added_nodes;
+  for (size_t p = 0; p < kNumIdPartitions; ++p) {
+    placeholder_base[p + 1] = placeholder_base[p] + num_placeholders[p];
+  }
+  uint64_t num_nodes = placeholder_base[kNumIdPartitions];
+  if (num_nodes > std::numeric_limits<GraphTopology::Node>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} nodes do not fit node IDs", num_nodes);
+  }
+
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumIdPartitions),
+      [&](size_t p) {
+        for (size_t s = 0; s < num_shards; ++s) {
+          for (const EndpointRef& ref : endpoint_refs[s][p]) {
+            uint64_t node = endpoints[ref.endpoint];
+            if (node & kPlaceholder) {
+              endpoints[ref.endpoint] =
+                  placeholder_base[p] + (node & ~kPlaceholder);
+            }
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+  node_refs.clear();
+  endpoint_refs.clear();
+
+  // Counting sort of the edges by source: count the out-degrees, place the
+  // edges of each node with atomic cursors and then restore the order in
+  // which the edges of a node were added
+  katana::NUMAArray<GraphTopology::Edge> adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(
+      adj_indices.begin(), adj_indices.end(), GraphTopology::Edge{0});
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        __atomic_fetch_add(&adj_indices[endpoints[2 * e]], 1, __ATOMIC_RELAXED);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  katana::NUMAArray<uint64_t> cursors;
+  cursors.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { cursors[n] = n > 0 ? adj_indices[n - 1] : 0; },
+      katana::no_stats());
+
+  katana::NUMAArray<uint64_t> order;
+  order.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        uint64_t position =
+            __atomic_fetch_add(&cursors[endpoints[2 * e]], 1, __ATOMIC_RELAXED);
+        order[position] = e;
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n > 0 ? adj_indices[n - 1] : 0;
+        std::sort(order.begin() + begin, order.begin() + adj_indices[n]);
+      },
+      katana::steal(), katana::no_stats());
+
+  // edge_rows[e] is the position of edge e in the topology and its tables
+  katana::NUMAArray<GraphTopology::Node> dests;
+  dests.allocateInterleaved(num_edges);
+  katana::NUMAArray<uint64_t> edge_rows;
+  edge_rows.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t position) {
+        uint64_t e = order[position];
+        dests[position] =
+            static_cast<GraphTopology::Node>(endpoints[2 * e + 1]);
+        edge_rows[e] = position;
+      },
+      katana::no_stats());
+
+  std::vector<const StagedColumns*> node_properties;
+  std::vector<const StagedColumns*> node_labels;
+  std::vector<const StagedColumns*> edge_properties;
+  std::vector<const StagedColumns*> edge_types;
+  for (const Shard& shard : shards_) {
+    node_properties.emplace_back(&shard.node_properties_);
+    node_labels.emplace_back(&shard.node_labels_);
+    edge_properties.emplace_back(&shard.edge_properties_);
+    edge_types.emplace_back(&shard.edge_types_);
+  }
+  auto node_row = [&](size_t s, uint64_t i) { return node_base[s] + i; };
+  auto edge_row = [&](size_t s, uint64_t i) {
+    return edge_rows[edge_base[s] + i];
+  };
+
+  GraphComponent nodes{
+      KATANA_CHECKED(BuildPropertyTable(
+          node_properties, num_nodes, chunk_size_, node_row)),
+      KATANA_CHECKED(
+          BuildLabelTable(node_labels, num_nodes, chunk_size_, node_row))};
+  GraphComponent edges{
+      KATANA_CHECKED(BuildPropertyTable(
+          edge_properties, num_edges, chunk_size_, edge_row)),
+      KATANA_CHECKED(
+          BuildLabelTable(edge_types, num_edges, chunk_size_, edge_row))};
+
+  if (verbose) {
+    std::cout << "Nodes: " << num_nodes << "\n";
+    std::cout << "Placeholder Nodes: " << num_nodes - num_added_nodes << "\n";
+    std::cout << "Node Properties: " << nodes.properties->num_columns()
+              << "\n";
+    std::cout << "Node Labels: " << nodes.labels->num_columns() << "\n";
+    std::cout << "Edges: " << num_edges << "\n";
+    std::cout << "Edge Properties: " << edges.properties->num_columns()
+              << "\n";
+    std::cout << "Edge Types: " << edges.labels->num_columns() << "\n";
+  }
+
+  return katana::GraphComponents{
+      nodes, edges,
+      GraphTopology(std::move(adj_indices), std::move(dests))};
+}
@@ -0,0 +1,637 @@
+#include "katana/SharedGraph.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr uint64_t kTopologyFormat = 1;
+constexpr std::string_view kTempPrefix = ".tmp.";
+constexpr const char* kVersionCounterFile = "last_version";
+constexpr const char* kLockFile = "lock";
+constexpr const char* kTopologyFile = "topology";
+constexpr const char* kMetadataFile = "metadata.json";
+constexpr const char* kNodePropertiesFile = "node_properties.arrow";
+constexpr const char* kEdgePropertiesFile = "edge_properties.arrow";
+
+std::atomic<uint64_t> temp_count{0};
+
+/// The header of a topology file, which is followed by the 64-bit edge
+/// offsets, the destinations padded to 8 bytes, and the node and edge entity
+/// type IDs
+struct TopologyHeader {
+  uint64_t format;
+  uint64_t num_nodes;
+  uint64_t num_edges;
+  uint64_t num_node_type_ids;
+  uint64_t num_edge_type_ids;
+};
+
+struct TopologyLayout {
+  explicit TopologyLayout(const TopologyHeader& header)
+      : adj_offset(sizeof(TopologyHeader)),
+        dests_offset(adj_offset + header.num_nodes * sizeof(Edge)),
+        node_types_offset(
+            dests_offset + (header.num_edges * sizeof(Node) + 7) / 8 * 8),
+        edge_types_offset(node_types_offset + header.num_node_type_ids),
+        size(edge_types_offset + header.num_edge_type_ids) {}
+
+  uint64_t adj_offset;
+  uint64_t dests_offset;
+  uint64_t node_types_offset;
+  uint64_t edge_types_offset;
+  uint64_t size;
+};
+
+std::error_code
+SystemError(const boost::system::error_code& ec) {
+  return std::error_code(ec.value(), std::system_category());
+}
+
+katana::Result<std::string>
+GraphDir(const std::string& name) {
+  if (name.empty() || name[0] == '.' || name.find('/') != std::string::npos) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "invalid shared graph name: \"{}\"",
+        name);
+  }
+  std::string dir = "/dev/shm/katana-graphs";
+  katana::GetEnv("KATANA_SHARED_GRAPH_DIR", &dir);
+  return dir + "/" + name;
+}
+
+std::string
+VersionDir(const std::string& graph_dir, uint64_t version) {
+  return fmt::format("{}/{}", graph_dir, version);
+}
+
+/// A path in graph_dir for a version being written or removed; the pid in it
+/// tells which are left over from processes that exited
+std::string
+TempPath(const std::string& graph_dir) {
+  return fmt::format(
+      "{}/{}{}-{}", graph_dir, kTempPrefix, getpid(),
+      temp_count.fetch_add(1, std::memory_order_relaxed));
+}
+
+void
+RemoveAll(const std::string& path) {
+  boost::system::error_code ec;
+  boost::filesystem::remove_all(path, ec);
+  if (ec) {
+    KATANA_LOG_WARN("removing {}: {}", path, ec.message());
+  }
+}
+
+katana::Result<std::string>
+ReadFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", path);
+  }
+  std::string contents;
+  char buf[4096];
+  ssize_t num_read = 0;
+  while ((num_read = read(fd, buf, sizeof(buf))) > 0) {
+    contents.append(buf, num_read);
+  }
+  auto error = num_read < 0 ? katana::ResultErrno() : std::error_code();
+  close(fd);
+  if (error) {
+    return KATANA_ERROR(error, "reading {}", path);
+  }
+  return contents;
+}
+
+katana::Result<void>
+WriteFile(const std::string& path, std::string_view contents) {
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "creating {}", path);
+  }
+  while (!contents.empty()) {
+    ssize_t num_written = write(fd, contents.data(), contents.size());
+    if (num_written < 0) {
+      auto error = katana::ResultErrno();
+      close(fd);
+      return KATANA_ERROR(error, "writing {}", path);
+    }
+    contents.remove_prefix(num_written);
+  }
+  if (close(fd) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "closing {}", path);
+  }
+  return katana::ResultSuccess();
+}
+
+nlohmann::json
+EntityTypesToJson(const katana::EntityTypeManager& manager) {
+  nlohmann::json types = nlohmann::json::array();
+  for (size_t i = 0, n = manager.GetNumEntityTypes(); i < n; ++i) {
+    auto id = static_cast<katana::EntityTypeID>(i);
+    const katana::SetOfEntityTypeIDs& subtypes = manager.GetAtomicSubtypes(id);
+    nlohmann::json atomic_types = nlohmann::json::array();
+    for (size_t j = 0; j < subtypes.size(); ++j) {
+      if (subtypes.test(j)) {
+        atomic_types.push_back(j);
+      }
+    }
+    nlohmann::json type{{"atomic_types", atomic_types}};
+    if (auto name = manager.GetAtomicTypeName(id)) {
+      type["name"] = name.value();
+    }
+    types.push_back(type);
+  }
+  return types;
+}
+
+/// Throws if types is malformed
+katana::EntityTypeManager
+EntityTypesFromJson(const nlohmann::json& types) {
+  katana::EntityTypeIDToAtomicTypeNameMap names;
+  katana::EntityTypeIDToSetOfEntityTypeIDsMap atomic_types;
+  for (const auto& type : types) {
+    auto id = static_cast<katana::EntityTypeID>(atomic_types.size());
+    katana::SetOfEntityTypeIDs subtypes;
+    for (const auto& j : type.at("atomic_types")) {
+      subtypes.set(j.get<size_t>());
+    }
+    atomic_types.emplace_back(subtypes);
+    if (type.contains("name")) {
+      names.emplace(id, type.at("name").get<std::string>());
+    }
+  }
+  return katana::EntityTypeManager(std::move(names), std::move(atomic_types));
+}
+
+struct Metadata {
+  katana::EntityTypeManager node_types;
+  katana::EntityTypeManager edge_types;
+};
+
+katana::Result<void>
+WriteMetadata(const katana::PropertyGraph& pg, const std::string& path) {
+  nlohmann::json metadata{
+      {"node_entity_types", EntityTypesToJson(pg.GetNodeTypeManager())},
+      {"edge_entity_types", EntityTypesToJson(pg.GetEdgeTypeManager())}};
+  return WriteFile(path, KATANA_CHECKED(katana::JsonDump(metadata)));
+}
+
+katana::Result<Metadata>
+ReadMetadata(const std::string& path) {
+  std::string text = KATANA_CHECKED(ReadFile(path));
+  try {
+    auto metadata = nlohmann::json::parse(text);
+    return Metadata{
+        EntityTypesFromJson(metadata.at("node_entity_types")),
+        EntityTypesFromJson(metadata.at("edge_entity_types"))};
+  } catch (const std::exception& exp) {
+    return KATANA_ERROR(
+        katana::ErrorCode::JSONParseFailed, "{}: {}", path, exp.what());
+  }
+}
+
+katana::Result<void>
+WriteTopology(const katana::PropertyGraph& pg, const std::string& path) {
+  const katana::GraphTopology& topology = pg.topology();
+  TopologyHeader header{
+      kTopologyFormat,
+      topology.num_nodes(),
+      topology.num_edges(),
+      pg.node_type_data() != nullptr ? topology.num_nodes() : 0,
+      pg.edge_type_data() != nullptr ? topology.num_edges() : 0,
+  };
+  TopologyLayout layout(header);
+
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "creating {}", path);
+  }
+  void* data = MAP_FAILED;
+  if (ftruncate(fd, layout.size) == 0) {
+    data = mmap(
+        nullptr, layout.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  auto error = data == MAP_FAILED ? katana::ResultErrno() : std::error_code();
+  close(fd);
+  if (error) {
+    return KATANA_ERROR(error, "mapping {}", path);
+  }
+
+  auto* bytes = static_cast<uint8_t*>(data);
+  std::memcpy(bytes, &header, sizeof(header));
+  auto* adj_indices = reinterpret_cast<Edge*>(bytes + layout.adj_offset);
+  auto* dests = reinterpret_cast<Node*>(bytes + layout.dests_offset);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, header.num_nodes),
+      [&](uint64_t n) { adj_indices[n] = *topology.edges(n).end(); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, header.num_edges),
+      [&](uint64_t e) { dests[e] = topology.edge_dest(e); },
+      katana::no_stats());
+  if (header.num_node_type_ids > 0) {
+    std::memcpy(
+        bytes + layout.node_types_offset, pg.node_type_data(),
+        header.num_node_type_ids);
+  }
+  if (header.num_edge_type_ids > 0) {
+    std::memcpy(
+        bytes + layout.edge_types_offset, pg.edge_type_data(),
+        header.num_edge_type_ids);
+  }
+
+  if (munmap(data, layout.size) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "unmapping {}", path);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+WriteTable(
+    const std::shared_ptr<arrow::Table>& table, const std::string& path) {
+  std::shared_ptr<arrow::io::FileOutputStream> out =
+      KATANA_CHECKED(arrow::io::FileOutputStream::Open(path));
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer =
+      KATANA_CHECKED(arrow::ipc::MakeFileWriter(out, table->schema()));
+  KATANA_CHECKED(writer->WriteTable(*table));
+  KATANA_CHECKED(writer->Close());
+  KATANA_CHECKED(out->Close());
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+MapTable(const std::string& path) {
+  std::shared_ptr<arrow::io::MemoryMappedFile> file = KATANA_CHECKED(
+      arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ));
+  // Reading a mapped file is zero-copy: the arrays are slices of the mapping
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader =
+      KATANA_CHECKED(arrow::ipc::RecordBatchFileReader::Open(file));
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0, n = reader->num_record_batches(); i < n; ++i) {
+    batches.emplace_back(KATANA_CHECKED(reader->ReadRecordBatch(i)));
+  }
+  return KATANA_CHECKED(
+      arrow::Table::FromRecordBatches(reader->schema(), batches));
+}
+
+/// Write the files of a version of pg to dir; the lock is the file that
+/// attached processes hold a shared lock on
+katana::Result<void>
+WriteVersion(const katana::PropertyGraph& pg, const std::string& dir) {
+  KATANA_CHECKED(WriteFile(dir + "/" + kLockFile, ""));
+  KATANA_CHECKED(WriteTopology(pg, dir + "/" + kTopologyFile));
+  KATANA_CHECKED(
+      WriteTable(pg.node_properties(), dir + "/" + kNodePropertiesFile));
+  KATANA_CHECKED(
+      WriteTable(pg.edge_properties(), dir + "/" + kEdgePropertiesFile));
+  // written last, since Attach takes a version without it as removed
+  KATANA_CHECKED(WriteMetadata(pg, dir + "/" + kMetadataFile));
+  return katana::ResultSuccess();
+}
+
+/// \returns a version greater than all those taken before, counted in a file
+/// of graph_dir so that versions are not reused once they are removed
+katana::Result<uint64_t>
+NextVersion(const std::string& graph_dir) {
+  std::string path = graph_dir + "/" + kVersionCounterFile;
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", path);
+  }
+  uint64_t version = 0;
+  auto res = [&]() -> katana::Result<void> {
+    if (flock(fd, LOCK_EX) != 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "locking {}", path);
+    }
+    ssize_t num_read = pread(fd, &version, sizeof(version), 0);
+    if (num_read < 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "reading {}", path);
+    }
+    if (num_read != sizeof(version)) {
+      version = 0;
+    }
+    version += 1;
+    ssize_t num_written = pwrite(fd, &version, sizeof(version), 0);
+    if (num_written < 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "writing {}", path);
+    }
+    if (num_written != sizeof(version)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed, "short write to {}", path);
+    }
+    return katana::ResultSuccess();
+  }();
+  // closing releases the lock
+  close(fd);
+  KATANA_CHECKED(res);
+  return version;
+}
+
+katana::Result<std::vector<uint64_t>>
+ListVersions(const std::string& graph_dir) {
+  std::vector<uint64_t> versions;
+  boost::system::error_code ec;
+  boost::filesystem::directory_iterator it(graph_dir, ec);
+  if (ec == boost::system::errc::no_such_file_or_directory) {
+    return versions;
+  }
+  for (boost::filesystem::directory_iterator end; !ec && it != end;
+       it.increment(ec)) {
+    std::string entry = it->path().filename().string();
+    if (!entry.empty() &&
+        std::all_of(entry.begin(), entry.end(), [](char c) {
+          return c >= '0' && c <= '9';
+        })) {
+      versions.emplace_back(std::stoull(entry));
+    }
+  }
+  if (ec) {
+    return KATANA_ERROR(SystemError(ec), "listing {}", graph_dir);
+  }
+  std::sort(versions.begin(), versions.end());
+  return versions;
+}
+
+/// \returns true if the version in dir was not attached and is removed
+bool
+RemoveIfUnused(const std::string& graph_dir, const std::string& dir) {
+  std::string lock_path = dir + "/" + kLockFile;
+  int fd = open(lock_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    // removed by another process
+    return false;
+  }
+  bool removed = false;
+  if (flock(fd, LOCK_EX | LOCK_NB) == 0) {
+    // Attach checks that a version is still in place once it holds the lock
+    // of the version, so moving the version away first keeps processes from
+    // attaching to it while it is removed
+    std::string doomed = TempPath(graph_dir);
+    if (rename(dir.c_str(), doomed.c_str()) == 0) {
+      RemoveAll(doomed);
+      removed = true;
+    }
+  }
+  close(fd);
+  return removed;
+}
+
+/// Remove versions that processes that exited were writing or removing
+void
+RemoveStaleTemporaries(const std::string& graph_dir) {
+  boost::system::error_code ec;
+  for (boost::filesystem::directory_iterator it(graph_dir, ec), end;
+       !ec && it != end; it.increment(ec)) {
+    std::string entry = it->path().filename().string();
+    if (entry.compare(0, kTempPrefix.size(), kTempPrefix) != 0) {
+      continue;
+    }
+    pid_t pid = std::atoi(entry.c_str() + kTempPrefix.size());
+    if (pid > 0 && kill(pid, 0) != 0 && errno == ESRCH) {
+      RemoveAll(it->path().string());
+    }
+  }
+}
+
+/// The lock on an attached version and the mapping of its topology, owned by
+/// the topologies that refer to them
+class Segment {
+public:
+  Segment() = default;
+  Segment(const Segment&) = delete;
+  Segment& operator=(const Segment&) = delete;
+
+  ~Segment() {
+    if (data_ != nullptr && munmap(data_, size_) != 0) {
+      KATANA_LOG_WARN("munmap: {}", katana::ResultErrno().message());
+    }
+    if (lock_fd_ >= 0) {
+      close(lock_fd_);
+    }
+  }
+
+  /// Take a shared lock on the version in dir, which keeps it from being
+  /// removed
+  katana::Result<void> Lock(const std::string& dir) {
+    std::string path = dir + "/" + kLockFile;
+    lock_fd_ = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (lock_fd_ < 0) {
+      if (errno == ENOENT) {
+        return KATANA_ERROR(
+            katana::ErrorCode::NotFound, "no shared graph in {}", dir);
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "opening {}", path);
+    }
+    if (flock(lock_fd_, LOCK_SH) != 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "locking {}", path);
+    }
+    // A version is moved away under an exclusive lock before it is removed,
+    // and its metadata is written last when it is published
+    std::string metadata_path = dir + "/" + kMetadataFile;
+    if (access(metadata_path.c_str(), F_OK) != 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "no shared graph in {}", dir);
+    }
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> MapTopology(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "opening {}", path);
+    }
+    struct stat stat_buf;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &stat_buf) == 0) {
+      data = mmap(nullptr, stat_buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    auto error = data == MAP_FAILED ? katana::ResultErrno() : std::error_code();
+    close(fd);
+    if (error) {
+      return KATANA_ERROR(error, "mapping {}", path);
+    }
+    data_ = data;
+    size_ = stat_buf.st_size;
+
+    if (size_ < sizeof(TopologyHeader) || header().format != kTopologyFormat ||
+        size_ < TopologyLayout(header()).size) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "{} is not a topology", path);
+    }
+    return katana::ResultSuccess();
+  }
+
+  const TopologyHeader& header() const {
+    return *static_cast<const TopologyHeader*>(data_);
+  }
+
+  template <typename T>
+  const T* at(uint64_t offset) const {
+    return reinterpret_cast<const T*>(static_cast<uint8_t*>(data_) + offset);
+  }
+
+private:
+  int lock_fd_{-1};
+  void* data_{nullptr};
+  uint64_t size_{0};
+};
+
+katana::NUMAArray<katana::EntityTypeID>
+CopyTypeIDs(const katana::EntityTypeID* ids, uint64_t num_ids) {
+  katana::NUMAArray<katana::EntityTypeID> copy;
+  if (num_ids > 0) {
+    copy.allocateInterleaved(num_ids);
+    katana::ParallelSTL::copy(ids, ids + num_ids, copy.begin());
+  }
+  return copy;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+AttachVersion(const std::string& dir) {
+  auto segment = std::make_shared<Segment>();
+  KATANA_CHECKED(segment->Lock(dir));
+  KATANA_CHECKED(segment->MapTopology(dir + "/" + kTopologyFile));
+  Metadata metadata = KATANA_CHECKED(ReadMetadata(dir + "/" + kMetadataFile));
+
+  const TopologyHeader& header = segment->header();
+  TopologyLayout layout(header);
+  auto node_type_ids = CopyTypeIDs(
+      segment->at<katana::EntityTypeID>(layout.node_types_offset),
+      header.num_node_type_ids);
+  auto edge_type_ids = CopyTypeIDs(
+      segment->at<katana::EntityTypeID>(layout.edge_types_offset),
+      header.num_edge_type_ids);
+  auto topology = katana::GraphTopology::MakeOutOfCore(
+      segment->at<Edge>(layout.adj_offset), header.num_nodes,
+      segment->at<Node>(layout.dests_offset), header.num_edges, segment);
+
+  auto pg = KATANA_CHECKED(katana::PropertyGraph::Make(
+      std::move(topology), std::move(node_type_ids), std::move(edge_type_ids),
+      std::move(metadata.node_types), std::move(metadata.edge_types)));
+  auto node_properties =
+      KATANA_CHECKED(MapTable(dir + "/" + kNodePropertiesFile));
+  if (node_properties->num_columns() > 0) {
+    KATANA_CHECKED(pg->AddNodeProperties(node_properties));
+  }
+  auto edge_properties =
+      KATANA_CHECKED(MapTable(dir + "/" + kEdgePropertiesFile));
+  if (edge_properties->num_columns() > 0) {
+    KATANA_CHECKED(pg->AddEdgeProperties(edge_properties));
+  }
+  return std::unique_ptr<katana::PropertyGraph>(std::move(pg));
+}
+
+}  // namespace
+
+katana::Result<uint64_t>
+katana::PublishSharedGraph(const PropertyGraph& pg, const std::string& name) {
+  std::string graph_dir = KATANA_CHECKED(GraphDir(name));
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(graph_dir, ec);
+  if (ec) {
+    return KATANA_ERROR(SystemError(ec), "creating {}", graph_dir);
+  }
+
+  std::string temp_dir = TempPath(graph_dir);
+  boost::filesystem::create_directory(temp_dir, ec);
+  if (ec) {
+    return KATANA_ERROR(SystemError(ec), "creating {}", temp_dir);
+  }
+  if (auto res = WriteVersion(pg, temp_dir); !res) {
+    RemoveAll(temp_dir);
+    return res.error().WithContext("publishing shared graph {}", name);
+  }
+  auto version = NextVersion(graph_dir);
+  if (!version) {
+    RemoveAll(temp_dir);
+    return version.error().WithContext("publishing shared graph {}", name);
+  }
+  // The version appears whole, with a single rename
+  std::string dir = VersionDir(graph_dir, version.value());
+  if (rename(temp_dir.c_str(), dir.c_str()) != 0) {
+    auto error = katana::ResultErrno();
+    RemoveAll(temp_dir);
+    return KATANA_ERROR(error, "moving {} to {}", temp_dir, dir);
+  }
+
+  KATANA_CHECKED(RemoveUnusedSharedGraphs(name));
+  return version.value();
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::AttachSharedGraph(
+    const std::string& name, std::optional<uint64_t> version) {
+  std::string graph_dir = KATANA_CHECKED(GraphDir(name));
+  if (version) {
+    return KATANA_CHECKED_CONTEXT(
+        AttachVersion(VersionDir(graph_dir, version.value())),
+        "attaching version {} of shared graph {}", version.value(), name);
+  }
+
+  // The latest version can be removed after a newer one is published and
+  // before it is locked; attach to the newer one then
+  while (true) {
+    auto versions = KATANA_CHECKED(ListVersions(graph_dir));
+    if (versions.empty()) {
+      return KATANA_ERROR(
+          ErrorCode::NotFound, "shared graph {} has no versions", name);
+    }
+    auto res = AttachVersion(VersionDir(graph_dir, versions.back()));
+    if (res || res.error() != ErrorCode::NotFound) {
+      return KATANA_CHECKED_CONTEXT(
+          std::move(res), "attaching version {} of shared graph {}",
+          versions.back(), name);
+    }
+  }
+}
+
+katana::Result<std::vector<uint64_t>>
+katana::SharedGraphVersions(const std::string& name) {
+  return ListVersions(KATANA_CHECKED(GraphDir(name)));
+}
+
+katana::Result<uint64_t>
+katana::RemoveUnusedSharedGraphs(const std::string& name, bool keep_latest) {
+  std::string graph_dir = KATANA_CHECKED(GraphDir(name));
+  auto versions = KATANA_CHECKED(ListVersions(graph_dir));
+  if (keep_latest && !versions.empty()) {
+    versions.pop_back();
+  }
+  uint64_t num_removed = 0;
+  for (uint64_t version : versions) {
+    if (RemoveIfUnused(graph_dir, VersionDir(graph_dir, version))) {
+      num_removed += 1;
+    }
+  }
+  RemoveStaleTemporaries(graph_dir);
+  return num_removed;
+}
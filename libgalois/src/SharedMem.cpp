@@ -22,6 +22,7 @@
 #include <memory>
 
 #include "katana/Barrier.h"
+#include "katana/Env.h"
 #include "katana/PagePool.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
@@ -211,25 +212,41 @@ struct katana::SharedMem::Impl {
     internal::PageAllocState<> page_pool;
   };
 
-  ThreadPool thread_pool;
+  std::unique_ptr<ThreadPool> thread_pool;
   std::unique_ptr<Dependents> deps;
-};
 
-katana::SharedMem::SharedMem() : impl_(std::make_unique<Impl>()) {
-  internal::SetThreadPool(&impl_->thread_pool);
+  void Start() {
+    thread_pool.reset(new ThreadPool());
+    internal::SetThreadPool(thread_pool.get());
+
+    // The thread pool must be initialized first because other substrate
+    // classes may call GetThreadPool() in their constructors
+    deps = std::make_unique<Dependents>();
+    deps->barrier =
+        katana::CreateAutoBarrier(thread_pool->getMaxUsableThreads());
 
-  // The thread pool must be initialized first because other substrate classes
-  // may call GetThreadPool() in their constructors
-  impl_->deps = std::make_unique<Impl::Dependents>();
-  impl_->deps->barrier =
-      katana::CreateTopoBarrier(impl_->thread_pool.getMaxUsableThreads());
+    internal::SetBarrier(deps->barrier.get());
+    internal::SetTerminationDetection(&deps->term);
+    internal::setPagePoolState(&deps->page_pool);
+  }
+};
 
-  internal::SetBarrier(impl_->deps->barrier.get());
-  internal::SetTerminationDetection(&impl_->deps->term);
-  internal::setPagePoolState(&impl_->deps->page_pool);
+katana::SharedMem::SharedMem() : impl_(std::make_unique<Impl>()) {
+  // Starting the threads and probing the machine for them takes a while;
+  // short programs that may not run any parallel loop can defer it
+  if (GetEnv("KATANA_LAZY_THREAD_POOL")) {
+    internal::SetThreadPoolStarter([impl = impl_.get()]() { impl->Start(); });
+  } else {
+    impl_->Start();
+  }
 }
 
 katana::SharedMem::~SharedMem() {
+  internal::SetThreadPoolStarter(nullptr);
+  if (!impl_->thread_pool) {
+    return;
+  }
+
   internal::setPagePoolState(nullptr);
   internal::SetTerminationDetection(nullptr);
   internal::SetBarrier(nullptr);
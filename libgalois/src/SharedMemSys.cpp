@@ -21,7 +21,9 @@
 
 #include "katana/CommBackend.h"
 #include "katana/Logging.h"
+#include "katana/NUMAMemoryPool.h"
 #include "katana/Plugin.h"
+#include "katana/PropertyMemoryPool.h"
 #include "katana/SharedMem.h"
 #include "katana/Statistics.h"
 #include "katana/TextTracer.h"
@@ -48,9 +50,12 @@ katana::SharedMemSys::SharedMemSys(std::unique_ptr<ProgressTracer> tracer)
   katana::ProgressTracer::Set(std::move(tracer));
 
   katana::internal::setSysStatManager(&impl_->stat_manager);
+  katana::SetPropertyMemoryPool(katana::NUMAMemoryPool::Get());
 }
 
 katana::SharedMemSys::~SharedMemSys() {
+  // Buffers already allocated keep the pool, which is never destroyed
+  katana::SetPropertyMemoryPool(nullptr);
   katana::PrintStats();
   katana::internal::setSysStatManager(nullptr);
 
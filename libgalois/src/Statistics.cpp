@@ -22,13 +22,19 @@
 #include <sys/resource.h>
 #include <sys/time.h>
 
+#include <array>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "katana/Env.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Logging.h"
+#include "katana/MemoryBudget.h"
 #include "katana/PerThreadStorage.h"
 #include "tsuba/file.h"
 
@@ -46,6 +52,17 @@ PrintHeader(std::ostream& out, const char* sep) {
   out << "\n";
 }
 
+template <typename T>
+T
+ToRecordValue(const T& v) {
+  return v;
+}
+
+std::string
+ToRecordValue(const katana::gstl::Str& s) {
+  return std::string(s.begin(), s.end());
+}
+
 template <typename T>
 struct StatImpl {
   using MergedStats = katana::internal::VecStatManager<T>;
@@ -67,25 +84,52 @@ struct StatImpl {
     perThreadManagers_.getLocal()->addToStat(region, category, val, type);
   }
 
-  void Merge() {
-    if (merged_) {
-      return;
-    }
-
+  void MergeInto(MergedStats* stats) const {
     for (unsigned t = 0; t < perThreadManagers_.size(); ++t) {
       const auto* manager = perThreadManagers_.getRemote(t);
 
       for (auto i = manager->cbegin(), end_i = manager->cend(); i != end_i;
            ++i) {
-        result_.addToStat(
+        stats->addToStat(
             manager->region(i), manager->category(i), T(manager->stat(i)),
             manager->stat(i).totalTy());
       }
     }
+  }
 
+  void Merge() {
+    if (merged_) {
+      return;
+    }
+    MergeInto(&result_);
     merged_ = true;
   }
 
+  template <typename R>
+  void Snapshot(std::vector<katana::StatRecord<R>>* records) const {
+    auto append = [records](const MergedStats& stats) {
+      for (auto i = stats.cbegin(), end_i = stats.cend(); i != end_i; ++i) {
+        const auto& s = stats.stat(i);
+        std::vector<R> values;
+        for (const auto& v : s.values()) {
+          values.emplace_back(ToRecordValue(v));
+        }
+        records->emplace_back(katana::StatRecord<R>{
+            ToRecordValue(stats.region(i)), ToRecordValue(stats.category(i)),
+            s.totalTy(), ToRecordValue(s.total()), std::move(values)});
+      }
+    };
+
+    // Once merged, statistics reported later are not printed either
+    if (merged_) {
+      append(result_);
+      return;
+    }
+    MergedStats stats;
+    MergeInto(&stats);
+    append(stats);
+  }
+
   void Read(
       const_iterator i, katana::gstl::Str& region, katana::gstl::Str& category,
       T& total, katana::StatTotal::Type& type,
@@ -127,6 +171,31 @@ struct StatImpl {
   }
 };
 
+constexpr uint32_t kNoStatSlot = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t kMaxStatSlots = 512;
+
+struct StatSlot {
+  int64_t value{};
+  bool used{};
+};
+
+/// The slots of StatHandles of a thread. PerThreadStorage keeps the slots of
+/// different threads on different cache lines.
+using StatSlots = std::array<StatSlot, kMaxStatSlots>;
+
+struct StatHandleInfo {
+  katana::gstl::Str region;
+  katana::gstl::Str category;
+  katana::StatTotal::Type type;
+};
+
+/// Distinguishes StatManagers for the registrations cached in StatHandles
+uint32_t
+NextStatManagerSerial() {
+  static std::atomic<uint32_t> next_serial{1};
+  return next_serial.fetch_add(1, std::memory_order_relaxed);
+}
+
 }  // end unnamed namespace
 
 class katana::StatManager::Impl {
@@ -135,6 +204,14 @@ public:
   StatImpl<double> fp_stats_;
   StatImpl<Str> str_stats_;
   std::string outfile_;
+
+  const uint32_t serial_{NextStatManagerSerial()};
+  katana::PerThreadStorage<StatSlots> handle_slots_;
+  /// guards handles_ and handle_slots_by_name_, only taken to register
+  std::mutex handle_mutex_;
+  std::vector<StatHandleInfo> handles_;
+  std::map<std::pair<std::string, std::string>, uint32_t>
+      handle_slots_by_name_;
 };
 
 katana::StatManager::StatManager() { impl_ = std::make_unique<Impl>(); }
@@ -196,13 +273,89 @@ katana::StatManager::param_cend() const -> param_const_iterator {
   return impl_->str_stats_.result_.cend();
 }
 
+uint32_t
+katana::StatManager::RegisterHandle(
+    const std::string& region, const std::string& category,
+    StatTotal::Type type) {
+  std::lock_guard<std::mutex> lock(impl_->handle_mutex_);
+  auto [it, inserted] = impl_->handle_slots_by_name_.emplace(
+      std::make_pair(region, category), kNoStatSlot);
+  if (!inserted) {
+    return it->second;
+  }
+  if (impl_->handles_.size() == kMaxStatSlots) {
+    KATANA_WARN_ONCE(
+        "more than {} statistics handles; reporting {}, {} by name",
+        kMaxStatSlots, region, category);
+    return kNoStatSlot;
+  }
+  it->second = impl_->handles_.size();
+  impl_->handles_.emplace_back(StatHandleInfo{
+      gstl::makeStr(region), gstl::makeStr(category), type});
+  return it->second;
+}
+
+void
+katana::StatManager::AddToHandle(const StatHandle& handle, int64_t val) {
+  uint64_t registration = handle.registration_.load(std::memory_order_relaxed);
+  uint32_t slot = registration;
+  if ((registration >> 32) != impl_->serial_) {
+    slot = RegisterHandle(handle.region_, handle.category_, handle.type_);
+    handle.registration_.store(
+        (uint64_t{impl_->serial_} << 32) | slot, std::memory_order_relaxed);
+  }
+
+  if (slot == kNoStatSlot) {
+    AddInt(handle.region_, handle.category_, val, handle.type_);
+    return;
+  }
+  StatSlot& s = (*impl_->handle_slots_.getLocal())[slot];
+  s.value += val;
+  s.used = true;
+}
+
+void
+katana::StatManager::MergeHandles() {
+  std::lock_guard<std::mutex> lock(impl_->handle_mutex_);
+  auto& per_thread = impl_->int_stats_.perThreadManagers_;
+  for (unsigned t = 0; t < impl_->handle_slots_.size(); ++t) {
+    StatSlots& slots = *impl_->handle_slots_.getRemote(t);
+    for (uint32_t i = 0; i < impl_->handles_.size(); ++i) {
+      if (!slots[i].used) {
+        continue;
+      }
+      const StatHandleInfo& info = impl_->handles_[i];
+      per_thread.getRemote(t)->addToStat(
+          info.region, info.category, slots[i].value, info.type);
+      slots[i] = StatSlot{};
+    }
+  }
+}
+
 void
 katana::StatManager::MergeStats() {
+  if (!impl_->int_stats_.merged_) {
+    MergeHandles();
+  }
   impl_->int_stats_.Merge();
   impl_->fp_stats_.Merge();
   impl_->str_stats_.Merge();
 }
 
+katana::StatSnapshot
+katana::StatManager::Snapshot() {
+  // moves the values of handles to the statistics of their threads, which
+  // does not change what is printed
+  if (!impl_->int_stats_.merged_) {
+    MergeHandles();
+  }
+  StatSnapshot snapshot;
+  impl_->int_stats_.Snapshot(&snapshot.ints);
+  impl_->fp_stats_.Snapshot(&snapshot.fps);
+  impl_->str_stats_.Snapshot(&snapshot.params);
+  return snapshot;
+}
+
 void
 katana::StatManager::ReadInt(
     int_const_iterator i, Str& region, Str& category, int64_t& total,
@@ -265,6 +418,29 @@ katana::StatManager::Print() {
   }
 }
 
+katana::StatHandle::StatHandle(
+    const std::string& region, const std::string& category,
+    StatTotal::Type type)
+    : region_(region), category_(category), type_(type) {
+  // register now rather than in the first Add, which is likely in a loop
+  if (StatManager* sm = internal::sysStatManager()) {
+    uint32_t slot = sm->RegisterHandle(region_, category_, type_);
+    registration_.store(
+        (uint64_t{sm->impl_->serial_} << 32) | slot, std::memory_order_relaxed);
+  }
+}
+
+void
+katana::StatHandle::Add(int64_t val) const {
+  if (StatManager* sm = internal::sysStatManager()) {
+    sm->AddToHandle(*this, val);
+  } else {
+    KATANA_LOG_WARN(
+        "StatManager already shutdown: {}, {}, {}, {}", region_, category_,
+        StatTotal::str(type_), val);
+  }
+}
+
 static katana::StatManager* stat_manager_singleton;
 
 void
@@ -290,6 +466,14 @@ katana::PrintStats() {
   internal::sysStatManager()->Print();
 }
 
+katana::StatSnapshot
+katana::GetStatSnapshot() {
+  if (StatManager* sm = internal::sysStatManager()) {
+    return sm->Snapshot();
+  }
+  return StatSnapshot{};
+}
+
 void
 katana::reportPageAlloc(const char* category) {
   katana::on_each_gen(
@@ -297,6 +481,9 @@ katana::reportPageAlloc(const char* category) {
         ReportStatSum("PageAlloc", category, numPagePoolAllocForThread(tid));
       },
       std::make_tuple());
+  if (const MemoryBudget* budget = MemoryBudget::current()) {
+    budget->Report(category);
+  }
 }
 
 void
@@ -0,0 +1,728 @@
+#include "katana/TableImport.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+#include <arrow/csv/api.h>
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/FileView.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/file.h"
+
+namespace {
+
+/// IDs are joined by partitions of their hashes, each by one thread
+constexpr size_t kNumIdPartitions = 256;
+
+/// Rows of ID columns are bucketed by blocks of this many rows, each by one
+/// thread
+constexpr int64_t kBlockSize = 1 << 16;
+
+constexpr uint64_t kNoNode = std::numeric_limits<uint64_t>::max();
+
+/// A file of a table, with the label of its table
+struct LoadedFile {
+  const std::string* label;
+  std::shared_ptr<arrow::Table> table;
+};
+
+bool
+IsTableFile(const std::string& file) {
+  return boost::algorithm::ends_with(file, ".csv") ||
+         boost::algorithm::ends_with(file, ".parquet");
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadCsv(const std::string& file, bool use_threads) {
+  auto fv = std::make_shared<tsuba::FileView>();
+  KATANA_CHECKED_CONTEXT(fv->Bind(file, false), "opening {}", file);
+
+  auto read_options = arrow::csv::ReadOptions::Defaults();
+  read_options.use_threads = use_threads;
+  auto reader = KATANA_CHECKED_CONTEXT(
+      arrow::csv::TableReader::Make(
+          arrow::io::default_io_context(), fv, read_options,
+          arrow::csv::ParseOptions::Defaults(),
+          arrow::csv::ConvertOptions::Defaults()),
+      "reading {}", file);
+  return KATANA_CHECKED_CONTEXT(reader->Read(), "reading {}", file);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadParquet(const std::string& file, bool use_threads) {
+  auto opts = tsuba::ParquetReader::ReadOpts::Defaults();
+  opts.use_threads = use_threads;
+  auto reader = KATANA_CHECKED(tsuba::ParquetReader::Make(opts));
+  auto uri = KATANA_CHECKED(katana::Uri::Make(file));
+  return KATANA_CHECKED_CONTEXT(reader->ReadTable(uri), "reading {}", file);
+}
+
+/// Read the files of tables, a file per thread. Arrow's threads decode
+/// each file when there are fewer files than threads.
+katana::Result<std::vector<LoadedFile>>
+ReadTables(const std::vector<katana::TableSource>& tables) {
+  std::vector<std::pair<const katana::TableSource*, const std::string*>> files;
+  for (const auto& table : tables) {
+    for (const auto& file : table.files) {
+      files.emplace_back(&table, &file);
+    }
+  }
+  bool use_threads = files.size() < katana::getActiveThreads();
+
+  std::vector<LoadedFile> loaded(files.size());
+  std::vector<katana::Result<void>> results(
+      files.size(), katana::ResultSuccess());
+  auto read_file = [&](size_t i) -> katana::Result<void> {
+    const std::string& file = *files[i].second;
+    loaded[i].label = &files[i].first->label;
+    if (boost::algorithm::ends_with(file, ".csv")) {
+      loaded[i].table = KATANA_CHECKED(ReadCsv(file, use_threads));
+    } else if (boost::algorithm::ends_with(file, ".parquet")) {
+      loaded[i].table = KATANA_CHECKED(ReadParquet(file, use_threads));
+    } else {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "{} is neither a CSV nor a Parquet file", file);
+    }
+    return katana::ResultSuccess();
+  };
+  katana::do_all(
+      katana::iterate(size_t{0}, files.size()),
+      [&](size_t i) { results[i] = read_file(i); }, katana::steal(),
+      katana::chunk_size<1>(), katana::no_stats());
+
+  for (auto& res : results) {
+    if (!res) {
+      return res.error();
+    }
+  }
+  return loaded;
+}
+
+/// Rows [begin, end) of a chunk of an ID column, whose first row is row base
+/// of the graph
+struct IdBlock {
+  std::shared_ptr<arrow::Array> ids;
+  int64_t begin;
+  int64_t end;
+  uint64_t base;
+};
+
+struct IdRef {
+  std::string_view id;
+  uint64_t row;
+};
+
+size_t
+PartitionOf(std::string_view id) {
+  return std::hash<std::string_view>{}(id) % kNumIdPartitions;
+}
+
+std::string_view
+IdAt(const arrow::Array& ids, int64_t i) {
+  if (ids.type_id() == arrow::Type::LARGE_STRING) {
+    return static_cast<const arrow::LargeStringArray&>(ids).GetView(i);
+  }
+  return static_cast<const arrow::StringArray&>(ids).GetView(i);
+}
+
+/// Append the blocks of the ID column of files, which are compared as
+/// strings, offset by the rows of the files before them
+katana::Result<void>
+AppendIdBlocks(
+    const std::vector<LoadedFile>& files, const std::string& column,
+    std::vector<IdBlock>* blocks) {
+  uint64_t base = 0;
+  for (const LoadedFile& file : files) {
+    auto ids = file.table->GetColumnByName(column);
+    if (!ids) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "a table with label \"{}\" has no column {}", *file.label, column);
+    }
+    if (ids->type()->id() != arrow::Type::STRING &&
+        ids->type()->id() != arrow::Type::LARGE_STRING) {
+      ids = KATANA_CHECKED_CONTEXT(
+                arrow::compute::Cast(ids, arrow::utf8()),
+                "casting column {} to strings", column)
+                .chunked_array();
+    }
+    if (ids->null_count() > 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "a table with label \"{}\" has null IDs in column {}", *file.label,
+          column);
+    }
+    for (const auto& chunk : ids->chunks()) {
+      for (int64_t begin = 0; begin < chunk->length(); begin += kBlockSize) {
+        blocks->emplace_back(IdBlock{
+            chunk, begin, std::min(chunk->length(), begin + kBlockSize),
+            base + begin});
+      }
+      base += chunk->length();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Group the IDs of each block by partition, so that each partition is
+/// joined by one thread without locks. Row r of a block becomes row
+/// stride * r + offset.
+std::vector<std::vector<std::vector<IdRef>>>
+PartitionIds(
+    const std::vector<IdBlock>& blocks, uint64_t stride, uint64_t offset) {
+  std::vector<std::vector<std::vector<IdRef>>> refs(
+      blocks.size(), std::vector<std::vector<IdRef>>(kNumIdPartitions));
+  katana::do_all(
+      katana::iterate(size_t{0}, blocks.size()),
+      [&](size_t b) {
+        const IdBlock& block = blocks[b];
+        for (int64_t i = block.begin; i < block.end; ++i) {
+          std::string_view id = IdAt(*block.ids, i);
+          refs[b][PartitionOf(id)].emplace_back(IdRef{
+              id, stride * (block.base + i - block.begin) + offset});
+        }
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+  return refs;
+}
+
+/// Resolve the source and target of each edge to its node with a hash join
+/// of the endpoint IDs with the node IDs. Endpoint 2 * e is the source of
+/// edge e and 2 * e + 1 its target.
+katana::Result<katana::NUMAArray<uint64_t>>
+JoinIds(
+    const std::vector<IdBlock>& node_blocks,
+    const std::vector<IdBlock>& source_blocks,
+    const std::vector<IdBlock>& target_blocks, uint64_t num_edges) {
+  auto node_refs = PartitionIds(node_blocks, 1, 0);
+  auto source_refs = PartitionIds(source_blocks, 2, 0);
+  auto target_refs = PartitionIds(target_blocks, 2, 1);
+
+  katana::NUMAArray<uint64_t> endpoints;
+  endpoints.allocateInterleaved(2 * num_edges);
+  std::vector<katana::Result<void>> results(
+      kNumIdPartitions, katana::ResultSuccess());
+  auto join = [&](size_t p) -> katana::Result<void> {
+    size_t num_ids = 0;
+    for (const auto& block : node_refs) {
+      num_ids += block[p].size();
+    }
+    std::unordered_map<std::string_view, uint64_t> nodes;
+    nodes.reserve(num_ids);
+    for (const auto& block : node_refs) {
+      for (const IdRef& ref : block[p]) {
+        if (!nodes.emplace(ref.id, ref.row).second) {
+          return KATANA_ERROR(
+              katana::ErrorCode::AlreadyExists,
+              "nodes {} and {} have the same ID {}", nodes[ref.id], ref.row,
+              ref.id);
+        }
+      }
+    }
+    for (const auto* refs : {&source_refs, &target_refs}) {
+      for (const auto& block : *refs) {
+        for (const IdRef& ref : block[p]) {
+          auto it = nodes.find(ref.id);
+          if (it == nodes.end()) {
+            return KATANA_ERROR(
+                katana::ErrorCode::NotFound, "edge {} refers to no node {}",
+                ref.row / 2, ref.id);
+          }
+          endpoints[ref.row] = it->second;
+        }
+      }
+    }
+    return katana::ResultSuccess();
+  };
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumIdPartitions),
+      [&](size_t p) { results[p] = join(p); }, katana::steal(),
+      katana::chunk_size<1>(), katana::no_stats());
+
+  for (auto& res : results) {
+    if (!res) {
+      return res.error();
+    }
+  }
+  return endpoints;
+}
+
+/// Merge the columns of files, besides those in skip, into a table. A column
+/// that a file lacks is null for its rows.
+katana::Result<std::shared_ptr<arrow::Table>>
+MergeProperties(
+    const std::vector<LoadedFile>& files,
+    const std::unordered_set<std::string>& skip, int64_t num_rows) {
+  katana::ArrowFields fields;
+  std::unordered_map<std::string, size_t> indexes;
+  for (const LoadedFile& file : files) {
+    for (const auto& field : file.table->schema()->fields()) {
+      if (skip.count(field->name()) > 0) {
+        continue;
+      }
+      auto [it, inserted] = indexes.emplace(field->name(), fields.size());
+      if (inserted) {
+        fields.emplace_back(arrow::field(field->name(), field->type()));
+      } else if (!fields[it->second]->type()->Equals(field->type())) {
+        return KATANA_ERROR(
+            katana::ErrorCode::TypeError,
+            "column {} has values of types {} and {}", field->name(),
+            fields[it->second]->type()->ToString(), field->type()->ToString());
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& field : fields) {
+    katana::ArrowArrays chunks;
+    for (const LoadedFile& file : files) {
+      if (file.table->num_rows() == 0) {
+        continue;
+      }
+      auto column = file.table->GetColumnByName(field->name());
+      if (column) {
+        chunks.insert(
+            chunks.end(), column->chunks().begin(), column->chunks().end());
+      } else {
+        chunks.emplace_back(KATANA_CHECKED(
+            arrow::MakeArrayOfNull(field->type(), file.table->num_rows())));
+      }
+    }
+    columns.emplace_back(
+        std::make_shared<arrow::ChunkedArray>(chunks, field->type()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+/// A column per distinct non-empty label of files, true for the rows of the
+/// files with the label
+katana::Result<std::shared_ptr<arrow::Table>>
+MakeLabels(const std::vector<LoadedFile>& files, int64_t num_rows) {
+  std::vector<std::string> labels;
+  std::unordered_set<std::string> seen;
+  for (const LoadedFile& file : files) {
+    if (!file.label->empty() && seen.emplace(*file.label).second) {
+      labels.emplace_back(*file.label);
+    }
+  }
+
+  katana::ArrowFields fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const std::string& label : labels) {
+    katana::ArrowArrays chunks;
+    for (const LoadedFile& file : files) {
+      if (file.table->num_rows() == 0) {
+        continue;
+      }
+      chunks.emplace_back(KATANA_CHECKED(arrow::MakeArrayFromScalar(
+          arrow::BooleanScalar(*file.label == label),
+          file.table->num_rows())));
+    }
+    fields.emplace_back(arrow::field(label, arrow::boolean()));
+    columns.emplace_back(
+        std::make_shared<arrow::ChunkedArray>(chunks, arrow::boolean()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+/// Gather the rows of table in order, a column per thread
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::shared_ptr<arrow::Table>& table,
+    const katana::NUMAArray<uint64_t>& order) {
+  auto indices = std::make_shared<arrow::UInt64Array>(
+      order.size(), arrow::Buffer::Wrap(order.data(), order.size()));
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns(
+      table->num_columns());
+  std::vector<katana::Result<void>> results(
+      table->num_columns(), katana::ResultSuccess());
+  auto take = [&](int c) -> katana::Result<void> {
+    columns[c] = KATANA_CHECKED_CONTEXT(
+                     arrow::compute::Take(table->column(c), indices),
+                     "sorting column {}", table->field(c)->name())
+                     .chunked_array();
+    return katana::ResultSuccess();
+  };
+  katana::do_all(
+      katana::iterate(0, table->num_columns()),
+      [&](int c) { results[c] = take(c); }, katana::steal(),
+      katana::chunk_size<1>(), katana::no_stats());
+
+  for (auto& res : results) {
+    if (!res) {
+      return res.error();
+    }
+  }
+  return arrow::Table::Make(table->schema(), columns, order.size());
+}
+
+/// Copy the IDs of chunk, whose first row is edge begin, to
+/// endpoints[2 * e + side], reducing the largest ID into max_id and whether
+/// an ID is negative into negative
+template <typename ArrowType>
+void
+CopyIds(
+    const arrow::Array& chunk, uint64_t begin, uint64_t side,
+    katana::NUMAArray<uint64_t>* endpoints,
+    katana::GReduceMax<uint64_t>* max_id,
+    katana::GReduceLogicalOr* negative) {
+  using CType = typename ArrowType::c_type;
+  const CType* ids =
+      static_cast<const arrow::NumericArray<ArrowType>&>(chunk).raw_values();
+  katana::do_all(
+      katana::iterate(int64_t{0}, chunk.length()),
+      [&](int64_t i) {
+        CType id = ids[i];
+        if constexpr (std::is_signed_v<CType>) {
+          if (id < 0) {
+            negative->update(true);
+            return;
+          }
+        }
+        (*endpoints)[2 * (begin + i) + side] = static_cast<uint64_t>(id);
+        max_id->update(static_cast<uint64_t>(id));
+      },
+      katana::no_stats());
+}
+
+katana::Result<void>
+CopyIds(
+    const arrow::ChunkedArray& ids, uint64_t side,
+    katana::NUMAArray<uint64_t>* endpoints,
+    katana::GReduceMax<uint64_t>* max_id,
+    katana::GReduceLogicalOr* negative) {
+  if (ids.null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "IDs must not be null");
+  }
+  uint64_t begin = 0;
+  for (const auto& chunk : ids.chunks()) {
+    switch (chunk->type_id()) {
+    case arrow::Type::INT8:
+      CopyIds<arrow::Int8Type>(
+          *chunk, begin, side, endpoints, max_id, negative);
+      break;
+    case arrow::Type::UINT8:
+      CopyIds<arrow::UInt8Type>(
+          *chunk, begin, side, endpoints, max_id, negative);
+      break;
+    case arrow::Type::INT16:
+      CopyIds<arrow::Int16Type>(
+          *chunk, begin, side, endpoints, max_id, negative);
+      break;
+    case arrow::Type::UINT16:
+      CopyIds<arrow::UInt16Type>(
+          *chunk, begin, side, endpoints, max_id, negative);
+      break;
+    case arrow::Type::INT32:
+      CopyIds<arrow::Int32Type>(
+          *chunk, begin, side, endpoints, max_id, negative);
+      break;
+    case arrow::Type::UINT32:
+      CopyIds<arrow::UInt32Type>(
+          *chunk, begin, side, endpoints, max_id, negative);
+      break;
+    case arrow::Type::INT64:
+      CopyIds<arrow::Int64Type>(
+          *chunk, begin, side, endpoints, max_id, negative);
+      break;
+    case arrow::Type::UINT64:
+      CopyIds<arrow::UInt64Type>(
+          *chunk, begin, side, endpoints, max_id, negative);
+      break;
+    default:
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "IDs must be integers, not {}",
+          chunk->type()->ToString());
+    }
+    begin += chunk->length();
+  }
+  return katana::ResultSuccess();
+}
+
+/// Counting sort of the edges (endpoints[2 * e], endpoints[2 * e + 1]) by
+/// source: count the out-degrees, place the edges of each node with atomic
+/// cursors and then restore the order of the edges of a node. order[position]
+/// is the edge at position of the topology.
+void
+SortEdgesBySource(
+    const katana::NUMAArray<uint64_t>& endpoints, uint64_t num_nodes,
+    katana::NUMAArray<katana::GraphTopology::Edge>* adj_indices,
+    katana::NUMAArray<katana::GraphTopology::Node>* dests,
+    katana::NUMAArray<uint64_t>* order) {
+  uint64_t num_edges = endpoints.size() / 2;
+  adj_indices->allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(
+      adj_indices->begin(), adj_indices->end(), katana::GraphTopology::Edge{0});
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        __atomic_fetch_add(
+            &(*adj_indices)[endpoints[2 * e]], 1, __ATOMIC_RELAXED);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices->begin(), adj_indices->end(), adj_indices->begin());
+
+  katana::NUMAArray<uint64_t> cursors;
+  cursors.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { cursors[n] = n > 0 ? (*adj_indices)[n - 1] : 0; },
+      katana::no_stats());
+
+  order->allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        uint64_t position =
+            __atomic_fetch_add(&cursors[endpoints[2 * e]], 1, __ATOMIC_RELAXED);
+        (*order)[position] = e;
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n > 0 ? (*adj_indices)[n - 1] : 0;
+        std::sort(order->begin() + begin, order->begin() + (*adj_indices)[n]);
+      },
+      katana::steal(), katana::no_stats());
+
+  dests->allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t position) {
+        (*dests)[position] = static_cast<katana::GraphTopology::Node>(
+            endpoints[2 * (*order)[position] + 1]);
+      },
+      katana::no_stats());
+}
+
+std::shared_ptr<arrow::Table>
+EmptyTable(int64_t num_rows) {
+  return arrow::Table::Make(
+      arrow::schema(katana::ArrowFields()),
+      std::vector<std::shared_ptr<arrow::ChunkedArray>>(), num_rows);
+}
+
+int64_t
+NumRows(const std::vector<LoadedFile>& files) {
+  int64_t num_rows = 0;
+  for (const LoadedFile& file : files) {
+    num_rows += file.table->num_rows();
+  }
+  return num_rows;
+}
+
+}  // namespace
+
+katana::Result<std::vector<katana::TableSource>>
+katana::ListTableSources(const std::string& dir) {
+  std::vector<std::string> names;
+  if (auto res = tsuba::FileListAsync(dir, &names).get(); !res) {
+    return res.error().WithContext("listing {}", dir);
+  }
+  std::sort(names.begin(), names.end());
+
+  std::vector<TableSource> tables;
+  for (const std::string& name : names) {
+    if (IsTableFile(name)) {
+      tables.emplace_back(TableSource{"", {katana::Uri::JoinPath(dir, name)}});
+      continue;
+    }
+    std::string table_dir = katana::Uri::JoinPath(dir, name);
+    std::vector<std::string> files;
+    if (auto res = tsuba::FileListAsync(table_dir, &files).get(); !res) {
+      return res.error().WithContext("listing {}", table_dir);
+    }
+    std::sort(files.begin(), files.end());
+
+    TableSource table{name, {}};
+    for (const std::string& file : files) {
+      if (IsTableFile(file)) {
+        table.files.emplace_back(katana::Uri::JoinPath(table_dir, file));
+      }
+    }
+    if (!table.files.empty()) {
+      tables.emplace_back(std::move(table));
+    }
+  }
+  return tables;
+}
+
+katana::Result<katana::GraphComponents>
+katana::ConvertTables(
+    const std::vector<TableSource>& node_tables,
+    const std::vector<TableSource>& edge_tables,
+    const TableImportOptions& options, bool verbose) {
+  auto node_files = KATANA_CHECKED_CONTEXT(
+      ReadTables(node_tables), "reading node tables");
+  auto edge_files = KATANA_CHECKED_CONTEXT(
+      ReadTables(edge_tables), "reading edge tables");
+  uint64_t num_nodes = NumRows(node_files);
+  uint64_t num_edges = NumRows(edge_files);
+  if (verbose) {
+    std::cout << "Finished reading " << node_files.size() << " node files and "
+              << edge_files.size() << " edge files\n";
+  }
+  if (num_nodes > std::numeric_limits<GraphTopology::Node>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} nodes do not fit node IDs", num_nodes);
+  }
+
+  std::vector<IdBlock> node_blocks;
+  std::vector<IdBlock> source_blocks;
+  std::vector<IdBlock> target_blocks;
+  KATANA_CHECKED(AppendIdBlocks(node_files, options.id_column, &node_blocks));
+  KATANA_CHECKED(
+      AppendIdBlocks(edge_files, options.source_column, &source_blocks));
+  KATANA_CHECKED(
+      AppendIdBlocks(edge_files, options.target_column, &target_blocks));
+  katana::NUMAArray<uint64_t> endpoints = KATANA_CHECKED(
+      JoinIds(node_blocks, source_blocks, target_blocks, num_edges));
+  if (verbose) {
+    std::cout << "Finished resolving node IDs\n";
+  }
+
+  katana::NUMAArray<GraphTopology::Edge> adj_indices;
+  katana::NUMAArray<GraphTopology::Node> dests;
+  katana::NUMAArray<uint64_t> order;
+  SortEdgesBySource(endpoints, num_nodes, &adj_indices, &dests, &order);
+  endpoints.destroy();
+  if (verbose) {
+    std::cout << "Finished topology\n";
+  }
+
+  GraphComponent nodes{
+      KATANA_CHECKED(MergeProperties(node_files, {}, num_nodes)),
+      KATANA_CHECKED(MakeLabels(node_files, num_nodes))};
+  auto edge_properties = KATANA_CHECKED(MergeProperties(
+      edge_files, {options.source_column, options.target_column}, num_edges));
+  auto edge_types = KATANA_CHECKED(MakeLabels(edge_files, num_edges));
+  GraphComponent edges{
+      KATANA_CHECKED(TakeRows(edge_properties, order)),
+      KATANA_CHECKED(TakeRows(edge_types, order))};
+
+  if (verbose) {
+    std::cout << "Nodes: " << num_nodes << "\n";
+    std::cout << "Node Properties: " << nodes.properties->num_columns()
+              << "\n";
+    std::cout << "Node Labels: " << nodes.labels->num_columns() << "\n";
+    std::cout << "Edges: " << num_edges << "\n";
+    std::cout << "Edge Properties: " << edges.properties->num_columns()
+              << "\n";
+    std::cout << "Edge Types: " << edges.labels->num_columns() << "\n";
+  }
+
+  return katana::GraphComponents{
+      nodes, edges,
+      GraphTopology(std::move(adj_indices), std::move(dests))};
+}
+
+katana::Result<katana::GraphComponents>
+katana::ConvertEdgeArrays(
+    const std::shared_ptr<arrow::ChunkedArray>& sources,
+    const std::shared_ptr<arrow::ChunkedArray>& destinations,
+    uint64_t num_nodes, std::shared_ptr<arrow::Table> node_properties,
+    std::shared_ptr<arrow::Table> edge_properties) {
+  if (sources->length() != destinations->length()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "{} sources and {} destinations do not make edges", sources->length(),
+        destinations->length());
+  }
+  uint64_t num_edges = sources->length();
+
+  katana::NUMAArray<uint64_t> endpoints;
+  endpoints.allocateInterleaved(2 * num_edges);
+  katana::GReduceMax<uint64_t> max_id;
+  katana::GReduceLogicalOr negative;
+  KATANA_CHECKED_CONTEXT(
+      CopyIds(*sources, 0, &endpoints, &max_id, &negative), "sources");
+  KATANA_CHECKED_CONTEXT(
+      CopyIds(*destinations, 1, &endpoints, &max_id, &negative),
+      "destinations");
+  if (negative.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "node IDs must not be negative");
+  }
+  uint64_t largest_id = max_id.reduce();
+  if (num_nodes == 0 && node_properties) {
+    num_nodes = node_properties->num_rows();
+  }
+  if (num_nodes == 0 && num_edges > 0) {
+    num_nodes = largest_id + 1;
+  }
+  if (num_edges > 0 && largest_id >= num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "node ID {} is not less than {} nodes",
+        largest_id, num_nodes);
+  }
+  if (num_nodes > std::numeric_limits<GraphTopology::Node>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} nodes do not fit node IDs", num_nodes);
+  }
+
+  if (!node_properties) {
+    node_properties = EmptyTable(num_nodes);
+  } else if (static_cast<uint64_t>(node_properties->num_rows()) != num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} node properties for {} nodes",
+        node_properties->num_rows(), num_nodes);
+  }
+  if (!edge_properties) {
+    edge_properties = EmptyTable(num_edges);
+  } else if (static_cast<uint64_t>(edge_properties->num_rows()) != num_edges) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} edge properties for {} edges",
+        edge_properties->num_rows(), num_edges);
+  }
+
+  katana::NUMAArray<GraphTopology::Edge> adj_indices;
+  katana::NUMAArray<GraphTopology::Node> dests;
+  katana::NUMAArray<uint64_t> order;
+  SortEdgesBySource(endpoints, num_nodes, &adj_indices, &dests, &order);
+  endpoints.destroy();
+
+  // Only gather the edge properties if the edges were not already sorted
+  katana::GReduceLogicalOr moved;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t position) {
+        if (order[position] != position) {
+          moved.update(true);
+        }
+      },
+      katana::no_stats());
+  if (moved.reduce() && edge_properties->num_columns() > 0) {
+    edge_properties = KATANA_CHECKED(TakeRows(edge_properties, order));
+  }
+
+  return katana::GraphComponents{
+      GraphComponent{std::move(node_properties), EmptyTable(num_nodes)},
+      GraphComponent{std::move(edge_properties), EmptyTable(num_edges)},
+      GraphTopology(std::move(adj_indices), std::move(dests))};
+}
@@ -0,0 +1,245 @@
+#include "katana/TemporalTopology.h"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <arrow/compute/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+using Edge = katana::GraphTopologyTypes::Edge;
+
+bool
+IsTimeType(arrow::Type::type id) {
+  switch (id) {
+  case arrow::Type::INT8:
+  case arrow::Type::UINT8:
+  case arrow::Type::INT16:
+  case arrow::Type::UINT16:
+  case arrow::Type::INT32:
+  case arrow::Type::UINT32:
+  case arrow::Type::INT64:
+  case arrow::Type::UINT64:
+  case arrow::Type::TIMESTAMP:
+  case arrow::Type::DATE32:
+  case arrow::Type::DATE64:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// \returns the times of the edge property \param name, indexed by property
+/// index, with kNoTime for nulls
+katana::Result<katana::NUMAArray<int64_t>>
+ReadTimes(const katana::PropertyGraph* pg, const std::string& name) {
+  std::shared_ptr<arrow::ChunkedArray> property = pg->GetEdgeProperty(name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property named {}",
+        name);
+  }
+  auto type_id = property->type()->id();
+  if (!IsTimeType(type_id)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "edge property {} has type {}, not an integer, timestamp or date",
+        name, property->type()->ToString());
+  }
+
+  arrow::Datum datum(property);
+  if (type_id == arrow::Type::DATE32) {
+    // dates cast only to integers of their width
+    auto days = arrow::compute::Cast(datum, arrow::int32());
+    if (!days.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "failed to cast {}: {}", name,
+          days.status());
+    }
+    datum = days.ValueOrDie();
+  }
+  auto cast = arrow::compute::Cast(datum, arrow::int64());
+  if (!cast.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "failed to cast {}: {}", name,
+        cast.status());
+  }
+  std::shared_ptr<arrow::ChunkedArray> values =
+      cast.ValueOrDie().chunked_array();
+
+  std::vector<int64_t> offsets(values->num_chunks() + 1, 0);
+  for (int c = 0; c < values->num_chunks(); ++c) {
+    offsets[c + 1] = offsets[c] + values->chunk(c)->length();
+  }
+  katana::NUMAArray<int64_t> times;
+  times.allocateInterleaved(values->length());
+  katana::do_all(
+      katana::iterate(0, values->num_chunks()),
+      [&](int c) {
+        auto chunk =
+            std::static_pointer_cast<arrow::Int64Array>(values->chunk(c));
+        for (int64_t i = 0; i < chunk->length(); ++i) {
+          times[offsets[c] + i] = chunk->IsNull(i)
+                                      ? katana::TemporalTopology::kNoTime
+                                      : chunk->Value(i);
+        }
+      },
+      katana::no_stats());
+  return times;
+}
+
+}  // namespace
+
+katana::Result<katana::TemporalTopology>
+katana::TemporalTopology::Make(
+    const PropertyGraph* pg, const std::string& timestamp_property_name,
+    bool transpose) {
+  auto times = KATANA_CHECKED(ReadTimes(pg, timestamp_property_name));
+
+  std::unique_ptr<EdgeShuffleTopology> transposed;
+  const GraphTopology* topology = &pg->topology();
+  if (transpose) {
+    transposed = EdgeShuffleTopology::MakeTransposeCopy(pg);
+    topology = transposed.get();
+  }
+  const GraphTopology& base = *topology;
+  auto property_index = [&](Edge e) {
+    return transposed ? transposed->edge_property_index(e)
+                      : base.edge_property_index(e);
+  };
+
+  uint64_t num_nodes = base.num_nodes();
+  uint64_t num_edges = base.num_edges();
+  NUMAArray<Edge> adj_indices;
+  NUMAArray<Node> dests;
+  NUMAArray<Edge> order;
+  adj_indices.allocateInterleaved(num_nodes);
+  dests.allocateInterleaved(num_edges);
+  order.allocateInterleaved(num_edges);
+
+  TemporalTopology temporal;
+  temporal.times_.allocateInterleaved(num_edges);
+  temporal.property_indices_.allocateInterleaved(num_edges);
+
+  katana::GReduceMin<int64_t> min_time;
+  katana::GReduceMax<int64_t> max_time;
+  katana::do_all(
+      katana::iterate(base),
+      [&](Node n) {
+        auto range = base.edges(n);
+        Edge first = *range.begin();
+        Edge last = *range.end();
+        adj_indices[n] = last;
+        std::iota(order.begin() + first, order.begin() + last, first);
+        // ties are broken by property index so the order is deterministic
+        std::sort(
+            order.begin() + first, order.begin() + last,
+            [&](Edge a, Edge b) {
+              auto pa = property_index(a);
+              auto pb = property_index(b);
+              return times[pa] < times[pb] ||
+                     (times[pa] == times[pb] && pa < pb);
+            });
+        for (Edge e = first; e < last; ++e) {
+          Edge old = order[e];
+          auto prop = property_index(old);
+          int64_t time = times[prop];
+          dests[e] = base.edge_dest(old);
+          temporal.times_[e] = time;
+          temporal.property_indices_[e] = prop;
+          if (time != kNoTime) {
+            min_time.update(time);
+            max_time.update(time);
+          }
+        }
+      },
+      katana::steal(), katana::loopname("TemporalTopology-Sort"));
+
+  temporal.topology_ = GraphTopology(std::move(adj_indices), std::move(dests));
+  temporal.min_time_ = min_time.reduce();
+  temporal.max_time_ = max_time.reduce();
+  return temporal;
+}
+
+katana::GraphTopologyTypes::edges_range
+katana::TemporalTopology::window_edges(
+    Node node, const TimeWindow& window) const noexcept {
+  auto range = edges(node);
+  auto begin = times_.begin() + *range.begin();
+  auto end = times_.begin() + *range.end();
+  auto first = std::lower_bound(begin, end, window.begin);
+  auto last = std::lower_bound(first, end, window.end);
+  return MakeStandardRange(
+      edge_iterator{static_cast<Edge>(first - times_.begin())},
+      edge_iterator{static_cast<Edge>(last - times_.begin())});
+}
+
+katana::GraphTopologyTypes::Edge
+katana::TemporalTopology::Seek(
+    Node node, Edge from, int64_t time) const noexcept {
+  Edge end = *edges(node).end();
+  if (from == end || times_[from] >= time) {
+    return from;
+  }
+  // times_[low] < time <= times_[high] or high is past the end
+  Edge low = from;
+  uint64_t step = 1;
+  Edge high = low + step;
+  while (high < end && times_[high] < time) {
+    low = high;
+    step *= 2;
+    high = low + step;
+  }
+  high = std::min(high, end);
+  return std::lower_bound(
+             times_.begin() + low + 1, times_.begin() + high, time) -
+         times_.begin();
+}
+
+katana::TimeWindowTopology::TimeWindowTopology(
+    const TemporalTopology* temporal)
+    : temporal_(temporal) {
+  first_.allocateInterleaved(temporal_->num_nodes());
+  last_.allocateInterleaved(temporal_->num_nodes());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, temporal_->num_nodes()),
+      [&](Node n) {
+        first_[n] = *temporal_->edges(n).begin();
+        last_[n] = first_[n];
+      },
+      katana::no_stats());
+}
+
+void
+katana::TimeWindowTopology::SetWindow(const TimeWindow& window) {
+  KATANA_LOG_DEBUG_ASSERT(window.begin <= window.end);
+  // The edges before first_[n] and last_[n] are before the old begin and end
+  // (or there are none), so when both ends move forward the new ends are at
+  // or after the old ones
+  bool forward = window.begin >= window_.begin && window.end >= window_.end;
+  katana::GAccumulator<uint64_t> num_edges;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, temporal_->num_nodes()),
+      [&](Node n) {
+        if (forward) {
+          first_[n] = temporal_->Seek(n, first_[n], window.begin);
+          last_[n] = temporal_->Seek(
+              n, std::max(first_[n], last_[n]), window.end);
+        } else {
+          auto range = temporal_->window_edges(n, window);
+          first_[n] = *range.begin();
+          last_[n] = *range.end();
+        }
+        num_edges += last_[n] - first_[n];
+      },
+      katana::steal(), katana::loopname("TimeWindowTopology-SetWindow"));
+  window_ = window;
+  num_edges_ = num_edges.reduce();
+}
@@ -20,7 +20,12 @@
 #include "katana/ThreadPool.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <utility>
 
 #include "katana/Env.h"
 #include "katana/HWTopo.h"
@@ -31,6 +36,7 @@
 namespace katana {
 
 extern void initPTS(unsigned);
+extern void AdoptPTS(unsigned);
 
 }
 
@@ -43,6 +49,14 @@ ThreadPool::ThreadPool()
       reserved(0),
       masterFastmode(false),
       running(false) {
+  int env_value = 0;
+  if (GetEnv("KATANA_IDLE_SPIN_US", &env_value) && env_value > 0) {
+    idle_spin_us_ = env_value;
+  }
+  if (GetEnv("KATANA_WARM_THREADS", &env_value) && env_value > 0) {
+    warm_threads_ = env_value;
+  }
+
   signals.resize(mi.maxThreads);
   initThread(0);
 
@@ -94,6 +108,65 @@ ThreadPool::beKind() {
   }
 }
 
+void
+ThreadPool::SetIdlePolicy(const IdlePolicy& policy) {
+  idle_spin_us_ = policy.spin_us;
+  warm_threads_ = policy.warm_threads;
+}
+
+ThreadPool::IdlePolicy
+ThreadPool::GetIdlePolicy() const {
+  return IdlePolicy{idle_spin_us_.load(), warm_threads_.load()};
+}
+
+uint32_t
+ThreadPool::IdleSpinUs(unsigned tid) const {
+  if (tid <= warm_threads_.load(std::memory_order_relaxed)) {
+    return kSpinForever;
+  }
+  return idle_spin_us_.load(std::memory_order_relaxed);
+}
+
+bool
+ThreadPool::per_signal::spin(uint32_t spin_us) {
+  if (spin_us == 0) {
+    return false;
+  }
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::microseconds(spin_us);
+  // reading the clock costs more than a pause, so only check it sometimes
+  constexpr unsigned kPausesPerClockCheck = 64;
+  for (unsigned i = 1;; ++i) {
+    if (!done) {
+      return true;
+    }
+    asmPause();
+    if (spin_us != kSpinForever && i % kPausesPerClockCheck == 0 &&
+        std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+  }
+}
+
+void
+ThreadPool::per_signal::wait(bool fastmode, uint32_t spin_us) {
+  if (fastmode) {
+    while (!fastRelease.load(std::memory_order_relaxed)) {
+      asmPause();
+    }
+    fastRelease = 0;
+    return;
+  }
+
+  if (spin(spin_us)) {
+    return;
+  }
+  std::unique_lock<std::mutex> lg(m);
+  parked = true;
+  cv.wait(lg, [=] { return !done; });
+  parked = false;
+}
+
 // inefficient append
 template <typename T>
 static void
@@ -158,7 +231,7 @@ ThreadPool::threadLoop(unsigned tid) {
   bool fastmode = false;
   auto& me = my_box;
   do {
-    me.wait(fastmode);
+    me.wait(fastmode, IdleSpinUs(tid));
     cascade(fastmode);
     try {
       work();
@@ -230,6 +303,12 @@ void
 ThreadPool::runInternal(unsigned num) {
   // sanitize num
   // seq write to starting should make work safe
+  if (std::thread::id holder = lease_holder_.load(std::memory_order_relaxed);
+      holder != std::thread::id{}) {
+    KATANA_LOG_VASSERT(
+        holder == std::this_thread::get_id(),
+        "parallel loops must hold the ThreadPoolLease while one is held");
+  }
   KATANA_LOG_VASSERT(!running, "Recursive thread pool execution not supported");
   running = true;
   num = std::min(std::max(1U, num), getMaxUsableThreads());
@@ -255,6 +334,18 @@ ThreadPool::runInternal(unsigned num) {
   running = false;
 }
 
+void
+ThreadPool::AdoptMaster() {
+  KATANA_LOG_VASSERT(!running, "cannot adopt a running thread pool");
+  my_box.topo = getHWTopo().threadTopoInfo[0];
+  AdoptPTS(0);
+}
+
+void
+ThreadPool::SetLeaseHolder(bool held) {
+  lease_holder_ = held ? std::this_thread::get_id() : std::thread::id{};
+}
+
 void
 ThreadPool::runDedicated(std::function<void(void)>& f) {
   // TODO(ddn): update katana::activeThreads to reflect the dedicated
@@ -277,16 +368,33 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   work = nullptr;
 }
 
-static katana::ThreadPool* TPOOL = nullptr;
+static std::atomic<katana::ThreadPool*> TPOOL{nullptr};
+static std::mutex TPOOL_STARTER_LOCK;
+static std::function<void()> TPOOL_STARTER;
 
 void
 katana::internal::SetThreadPool(ThreadPool* tp) {
   KATANA_LOG_VASSERT(!(TPOOL && tp), "Double initialization of ThreadPool");
-  TPOOL = tp;
+  TPOOL.store(tp, std::memory_order_release);
+}
+
+void
+katana::internal::SetThreadPoolStarter(std::function<void()> starter) {
+  std::lock_guard<std::mutex> guard(TPOOL_STARTER_LOCK);
+  TPOOL_STARTER = std::move(starter);
 }
 
 katana::ThreadPool&
 katana::GetThreadPool() {
-  KATANA_LOG_VASSERT(TPOOL, "ThreadPool not initialized");
-  return *TPOOL;
+  ThreadPool* tp = TPOOL.load(std::memory_order_acquire);
+  if (!tp) {
+    std::lock_guard<std::mutex> guard(TPOOL_STARTER_LOCK);
+    tp = TPOOL.load(std::memory_order_acquire);
+    if (!tp && TPOOL_STARTER) {
+      TPOOL_STARTER();
+      tp = TPOOL.load(std::memory_order_acquire);
+    }
+  }
+  KATANA_LOG_VASSERT(tp, "ThreadPool not initialized");
+  return *tp;
 }
@@ -20,12 +20,23 @@
 #include "katana/Threads.h"
 
 #include <algorithm>
+#include <mutex>
 
 #include "katana/ThreadPool.h"
 namespace katana {
 KATANA_EXPORT unsigned int activeThreads = 1;
 }  // namespace katana
 
+namespace {
+
+std::mutex&
+LeaseMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+}  // namespace
+
 unsigned int
 katana::setActiveThreads(unsigned int num) noexcept {
   num = std::min(num, katana::GetThreadPool().getMaxUsableThreads());
@@ -38,3 +49,17 @@ unsigned int
 katana::getActiveThreads() noexcept {
   return katana::activeThreads;
 }
+
+katana::ThreadPoolLease::ThreadPoolLease(unsigned int num_threads) {
+  LeaseMutex().lock();
+  GetThreadPool().AdoptMaster();
+  GetThreadPool().SetLeaseHolder(true);
+  previous_threads_ = getActiveThreads();
+  num_threads_ = setActiveThreads(num_threads);
+}
+
+katana::ThreadPoolLease::~ThreadPoolLease() {
+  setActiveThreads(previous_threads_);
+  GetThreadPool().SetLeaseHolder(false);
+  LeaseMutex().unlock();
+}
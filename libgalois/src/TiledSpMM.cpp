@@ -0,0 +1,61 @@
+#include "katana/TiledSpMM.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+constexpr size_t kFallbackL2Bytes = size_t{1} << 20;
+
+/// y += w * x over width values; written so that the compiler vectorizes it
+inline void
+MultiplyAdd(
+    float w, const float* __restrict__ x, float* __restrict__ y,
+    uint32_t width) {
+  for (uint32_t j = 0; j < width; ++j) {
+    y[j] += w * x[j];
+  }
+}
+
+}  // namespace
+
+size_t
+katana::TiledSpMM::DefaultTileBytes() {
+  static const size_t bytes = [] {
+    long l2 = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    return (l2 > 0 ? static_cast<size_t>(l2) : kFallbackL2Bytes) / 2;
+  }();
+  return bytes;
+}
+
+void
+katana::TiledSpMM::Aggregate(
+    const float* in, float* out, const float* edge_weights) const {
+  const uint32_t width = width_;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_row_blocks()),
+      [&](uint64_t block) {
+        // the thread that owns a row block is the only writer of its rows
+        uint64_t row_begin = block * rows_per_block_;
+        uint64_t row_end = std::min(num_nodes_, row_begin + rows_per_block_);
+        std::fill(out + row_begin * width, out + row_end * width, 0.0f);
+
+        for (uint64_t t = block_offsets_[block]; t < block_offsets_[block + 1];
+             ++t) {
+          const Tile& tile = tiles_[t];
+          for (Edge i = tile.begin; i < tile.end; ++i) {
+            float w = edge_weights == nullptr ? 1.0f
+                                              : edge_weights[edge_ids_[i]];
+            MultiplyAdd(
+                w, in + uint64_t{cols_[i]} * width,
+                out + uint64_t{rows_[i]} * width, width);
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+}
@@ -89,13 +89,21 @@ StatTimer::StatTimer(const char* const name, const char* const region) {
   valid_ = false;
 }
 
+StatTimer::StatTimer(const StatHandle& handle)
+    : handle_(&handle), valid_(false) {}
+
 StatTimer::~StatTimer() {
   if (valid_) {
     stop();
   }
 
   // only report non-zero stat
-  if (TimeAccumulator::get()) {
+  if (!TimeAccumulator::get()) {
+    return;
+  }
+  if (handle_) {
+    handle_->Add(TimeAccumulator::get());
+  } else {
     katana::ReportStatMax(
         region_.c_str(), name_.c_str(), TimeAccumulator::get());
   }
@@ -0,0 +1,117 @@
+#include "katana/TopologyStatistics.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/GraphTopology.h"
+#include "katana/Loops.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+
+constexpr uint32_t kNumDegreeSamples = 1000;
+constexpr uint32_t kSampleSeed = 27491095;
+
+/// A BFS over the out-edges of topo from source.
+/// \returns the number of levels after the first and a node of the last one
+std::pair<uint32_t, Node>
+Sweep(const katana::GraphTopology& topo, Node source) {
+  katana::DynamicBitset visited;
+  visited.resize(topo.num_nodes());
+  visited.set(source);
+
+  auto curr = std::make_unique<katana::InsertBag<Node>>();
+  auto next = std::make_unique<katana::InsertBag<Node>>();
+  curr->push(source);
+
+  uint32_t levels = 0;
+  Node last = source;
+  while (true) {
+    katana::do_all(
+        katana::iterate(*curr),
+        [&](Node n) {
+          for (auto e : topo.edges(n)) {
+            Node dst = topo.edge_dest(e);
+            if (!visited.test(dst) && !visited.set(dst)) {
+              next->push(dst);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    if (next->empty()) {
+      return {levels, last};
+    }
+    ++levels;
+    last = *next->begin();
+    std::swap(curr, next);
+    next->clear();
+  }
+}
+
+}  // namespace
+
+katana::TopologyStatistics
+katana::TopologyStatistics::Compute(const GraphTopology& topo) noexcept {
+  katana::StatTimer timer("TopologyStatistics");
+  timer.start();
+
+  TopologyStatistics stats;
+  stats.num_nodes = topo.num_nodes();
+  stats.num_edges = topo.num_edges();
+  if (stats.num_nodes == 0) {
+    timer.stop();
+    return stats;
+  }
+
+  katana::GReduceMax<uint64_t> max_degree;
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) { max_degree.update(topo.degree(n)); }, katana::no_stats());
+  stats.max_degree = max_degree.reduce();
+  if (stats.num_edges == 0) {
+    timer.stop();
+    return stats;
+  }
+
+  // Sample like analytics::SourcePicker, which draws until it finds a node
+  // with edges, but with a bounded number of draws
+  std::mt19937 gen(kSampleSeed);
+  std::uniform_int_distribution<Node> dist(0, stats.num_nodes - 1);
+  std::vector<uint64_t> samples;
+  samples.reserve(kNumDegreeSamples);
+  uint64_t sample_total = 0;
+  for (uint32_t draw = 0;
+       draw < 16 * kNumDegreeSamples && samples.size() < kNumDegreeSamples;
+       ++draw) {
+    uint64_t degree = topo.degree(dist(gen));
+    if (degree > 0) {
+      samples.push_back(degree);
+      sample_total += degree;
+    }
+  }
+  if (!samples.empty()) {
+    std::nth_element(
+        samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    stats.sampled_mean_degree =
+        static_cast<double>(sample_total) / samples.size();
+    stats.sampled_median_degree = samples[samples.size() / 2];
+  }
+
+  Node hub = 0;
+  while (topo.degree(hub) != stats.max_degree) {
+    ++hub;
+  }
+  auto [first_levels, far] = Sweep(topo, hub);
+  stats.estimated_diameter = std::max(first_levels, Sweep(topo, far).first);
+
+  timer.stop();
+  return stats;
+}
@@ -0,0 +1,60 @@
+#include "katana/VersionedPropertyGraph.h"
+
+#include "katana/ErrorCode.h"
+
+katana::Result<std::unique_ptr<katana::VersionedPropertyGraph>>
+katana::VersionedPropertyGraph::Make(std::unique_ptr<PropertyGraph> head) {
+  if (!head) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "head is null");
+  }
+  std::unique_ptr<VersionedPropertyGraph> graph(
+      new VersionedPropertyGraph(std::move(head)));
+  std::lock_guard<std::mutex> lock(graph->writer_mutex_);
+  KATANA_CHECKED_CONTEXT(graph->Publish(), "publishing the first version");
+  return std::unique_ptr<VersionedPropertyGraph>(std::move(graph));
+}
+
+katana::VersionedPropertyGraph::Snapshot
+katana::VersionedPropertyGraph::Pin() const {
+  std::lock_guard<std::mutex> lock(latest_mutex_);
+  return latest_;
+}
+
+katana::Result<uint64_t>
+katana::VersionedPropertyGraph::Update(
+    const std::function<Result<void>(PropertyGraph*)>& update) {
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  KATANA_CHECKED(update(head_.get()));
+  return Publish();
+}
+
+katana::Result<void>
+katana::VersionedPropertyGraph::Commit(const std::string& command_line) {
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  return head_->Commit(command_line);
+}
+
+katana::Result<void>
+katana::VersionedPropertyGraph::Write(
+    const std::string& rdg_name, const std::string& command_line) {
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  return head_->Write(rdg_name, command_line);
+}
+
+katana::Result<uint64_t>
+katana::VersionedPropertyGraph::Publish() {
+  head_->MakeTopologyShareable();
+  std::shared_ptr<const PropertyGraph> graph =
+      KATANA_CHECKED(head_->ShallowCopy());
+
+  // Only the writer changes latest_, so it can be read without the lock
+  uint64_t version = latest_.version + 1;
+  Snapshot snapshot{version, std::move(graph)};
+  {
+    std::lock_guard<std::mutex> lock(latest_mutex_);
+    std::swap(latest_, snapshot);
+  }
+  // the previous version is released here, outside of the lock, in case this
+  // was its last reference
+  return version;
+}
@@ -0,0 +1,96 @@
+#include "katana/analytics/Planner.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "katana/Threads.h"
+
+namespace {
+
+/// Distances are shifted by the delta exponent; 32 bits is the narrowest
+/// distance type
+constexpr int kMaxDeltaShift = 31;
+
+double
+NumThreads(const katana::analytics::PlanCostModel& model) {
+  return model.num_threads != 0 ? model.num_threads
+                                : std::max(1U, katana::getActiveThreads());
+}
+
+/// The cost of visiting every edge once, spread over the threads
+double
+EdgeCost(
+    const katana::TopologyStatistics& stats,
+    const katana::analytics::PlanCostModel& model) {
+  return stats.num_edges / NumThreads(model);
+}
+
+}  // namespace
+
+katana::analytics::BfsPlan
+katana::analytics::ChooseBfsPlan(
+    const TopologyStatistics& stats, const PlanCostModel& model) {
+  double edge_fraction =
+      stats.is_power_law() ? model.direction_opt_edge_fraction : 1.0;
+  double synchronous_cost =
+      (stats.estimated_diameter + 1) * model.round_cost +
+      edge_fraction * EdgeCost(stats, model);
+  double asynchronous_cost =
+      model.round_cost + model.asynchronous_rework * EdgeCost(stats, model);
+
+  if (asynchronous_cost < synchronous_cost) {
+    return BfsPlan::Asynchronous();
+  }
+  return BfsPlan::SynchronousDirectOpt();
+}
+
+unsigned
+katana::analytics::ChooseDeltaShift(
+    const EdgeWeightStatistics& weights, double average_degree) {
+  double delta =
+      std::max(weights.mean, weights.max / std::max(1.0, average_degree));
+  if (!(delta >= 2)) {
+    return 0;
+  }
+  return std::min(std::ilogb(delta), kMaxDeltaShift);
+}
+
+katana::analytics::SsspPlan
+katana::analytics::ChooseSsspPlan(
+    const TopologyStatistics& stats, const EdgeWeightStatistics& weights,
+    const PlanCostModel& model) {
+  if (stats.num_edges <= model.serial_max_edges) {
+    return SsspPlan::Dijkstra();
+  }
+
+  unsigned shift = ChooseDeltaShift(weights, stats.average_degree());
+  // A path along the diameter crosses a bucket every 2^shift of distance
+  double buckets_per_level =
+      std::max(1.0, weights.mean / std::ldexp(1.0, shift));
+  double round_cost =
+      stats.estimated_diameter * buckets_per_level * model.round_cost;
+
+  if (round_cost > model.asynchronous_rework * EdgeCost(stats, model)) {
+    return SsspPlan::DeltaStepAdaptive(shift);
+  }
+  // Tiles split the edges of hubs among threads
+  uint64_t tile_size = SsspPlan::kDefaultEdgeTileSize;
+  if (stats.is_power_law() && stats.max_degree > tile_size) {
+    return SsspPlan::DeltaTile(shift, tile_size);
+  }
+  return SsspPlan::DeltaStep(shift);
+}
+
+katana::analytics::ConnectedComponentsPlan
+katana::analytics::ChooseConnectedComponentsPlan(
+    const TopologyStatistics& stats, const PlanCostModel& model) {
+  if (stats.num_edges <= model.serial_max_edges) {
+    return ConnectedComponentsPlan::Serial();
+  }
+  return ConnectedComponentsPlan::Afforest();
+}
+
+bool
+katana::analytics::ChooseRelabeling(const TopologyStatistics& stats) {
+  return stats.is_power_law();
+}
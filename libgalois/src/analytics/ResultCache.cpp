@@ -0,0 +1,145 @@
+#include "katana/analytics/ResultCache.h"
+
+#include "katana/ErrorCode.h"
+
+namespace {
+
+/// The bytes of the buffers of array, including those of its children
+uint64_t
+ArrayDataBytes(const arrow::ArrayData& data) {
+  uint64_t bytes = 0;
+  for (const auto& buffer : data.buffers) {
+    if (buffer) {
+      bytes += buffer->size();
+    }
+  }
+  for (const auto& child : data.child_data) {
+    bytes += ArrayDataBytes(*child);
+  }
+  return bytes;
+}
+
+uint64_t
+ChunkedArrayBytes(const arrow::ChunkedArray& values) {
+  uint64_t bytes = 0;
+  for (const auto& chunk : values.chunks()) {
+    bytes += ArrayDataBytes(*chunk->data());
+  }
+  return bytes;
+}
+
+}  // namespace
+
+std::optional<std::string>
+katana::analytics::AnalyticsResultCache::MakeKey(
+    const PropertyGraph* pg, const std::string& algorithm,
+    const std::string& parameters) {
+  auto version = pg->rdg_version();
+  if (!version) {
+    return std::nullopt;
+  }
+  return fmt::format(
+      "{}\n{}\n{}\n{}\n{}", pg->rdg_dir(), version.value(),
+      pg->partition_id(), algorithm, parameters);
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+katana::analytics::AnalyticsResultCache::Find(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    num_misses_ += 1;
+    return nullptr;
+  }
+  num_hits_ += 1;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->values;
+}
+
+void
+katana::analytics::AnalyticsResultCache::Insert(
+    const std::string& key, std::shared_ptr<arrow::ChunkedArray> values) {
+  uint64_t bytes = ChunkedArrayBytes(*values);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = index_.find(key); it != index_.end()) {
+    size_bytes_ -= it->second->size_bytes;
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+  if (bytes > capacity_bytes_) {
+    return;
+  }
+  EvictUntil(capacity_bytes_ - bytes);
+  entries_.push_front(Entry{key, std::move(values), bytes});
+  index_.emplace(key, entries_.begin());
+  size_bytes_ += bytes;
+}
+
+katana::Result<void>
+katana::analytics::AnalyticsResultCache::GetOrCompute(
+    PropertyGraph* pg, const std::string& algorithm,
+    const std::string& parameters, const std::string& output_property_name,
+    const std::function<Result<void>()>& compute) {
+  auto key = MakeKey(pg, algorithm, parameters);
+  if (!key) {
+    return compute();
+  }
+
+  if (auto values = Find(key.value())) {
+    return pg->AddNodeProperties(arrow::Table::Make(
+        arrow::schema({arrow::field(output_property_name, values->type())}),
+        {values}));
+  }
+
+  KATANA_CHECKED(compute());
+  auto values = pg->GetNodeProperty(output_property_name);
+  if (!values) {
+    return KATANA_ERROR(
+        ErrorCode::AssertionFailed, "{} did not create the property {}",
+        algorithm, output_property_name);
+  }
+  Insert(key.value(), std::move(values));
+  return ResultSuccess();
+}
+
+void
+katana::analytics::AnalyticsResultCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+  size_bytes_ = 0;
+}
+
+uint64_t
+katana::analytics::AnalyticsResultCache::size_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_bytes_;
+}
+
+uint64_t
+katana::analytics::AnalyticsResultCache::num_entries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+uint64_t
+katana::analytics::AnalyticsResultCache::num_hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_hits_;
+}
+
+uint64_t
+katana::analytics::AnalyticsResultCache::num_misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_misses_;
+}
+
+void
+katana::analytics::AnalyticsResultCache::EvictUntil(uint64_t size_bytes) {
+  while (size_bytes_ > size_bytes && !entries_.empty()) {
+    const Entry& last = entries_.back();
+    size_bytes_ -= last.size_bytes;
+    index_.erase(last.key);
+    entries_.pop_back();
+  }
+}
@@ -19,6 +19,9 @@
 
 #include "katana/analytics/Utils.h"
 
+#include <arrow/api.h>
+
+#include "katana/PropertyMemoryPool.h"
 #include "katana/Random.h"
 
 uint32_t
@@ -66,3 +69,30 @@ katana::analytics::IsApproximateDegreeDistributionPowerLaw(
 
 thread_local int
     katana::analytics::TemporaryPropertyGuard::temporary_property_counter = 0;
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::analytics::CopyNodeProperty(
+    PropertyGraph* pg, const std::string& name) {
+  auto column = pg->GetNodeProperty(name);
+  if (!column) {
+    return KATANA_ERROR(ErrorCode::PropertyNotFound, "no property {}", name);
+  }
+  const auto* type =
+      dynamic_cast<const arrow::FixedWidthType*>(column->type().get());
+  if (!type || type->bit_width() % 8 != 0 || column->num_chunks() != 1 ||
+      column->null_count() != 0) {
+    // Concatenate copies the (null) values of any other property
+    return KATANA_CHECKED_CONTEXT(
+        arrow::Concatenate(column->chunks(), katana::PropertyMemoryPool()),
+        "copying property {}", name);
+  }
+  int64_t width = type->bit_width() / 8;
+  const auto& data = column->chunk(0)->data();
+  auto values = KATANA_CHECKED_CONTEXT(
+      data->buffers[1]->CopySlice(
+          data->offset * width, data->length * width,
+          katana::PropertyMemoryPool()),
+      "copying property {}", name);
+  return arrow::MakeArray(
+      arrow::ArrayData::Make(data->type, data->length, {nullptr, values}, 0));
+}
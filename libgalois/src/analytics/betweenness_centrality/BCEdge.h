@@ -20,51 +20,23 @@
 #ifndef KATANA_LIBGALOIS_ANALYTICS_BETWEENNESSCENTRALITY_BCEDGE_H_
 #define KATANA_LIBGALOIS_ANALYTICS_BETWEENNESSCENTRALITY_BCEDGE_H_
 
-#include "BCNode.h"
+#include <sstream>
+#include <string>
+
 #include "control.h"
 
+/// The state of an edge for one source of asynchronous betweenness
+/// centrality
 struct BCEdge {
-  using NodeType = BCNode<BC_USE_MARKING, BC_CONCURRENT>;
-  NodeType* src;
-  NodeType* dst;
+  /// sigma of the source of the edge when it was last pushed along the edge
   ShortPathType val;
+  /// distance of the source of the edge when the edge joined the shortest
+  /// path DAG, or kInfinity if it is not in the DAG
   unsigned level;
 
-  BCEdge(NodeType* _src, NodeType* _dst)
-      : src(_src), dst(_dst), val(0), level(kInfinity) {}
-  BCEdge() : src(0), dst(0), val(0), level(kInfinity) {}
-
-  BCEdge& operator=(BCEdge const& from) {
-    if (this != &from) {
-      src = from.src;
-      dst = from.dst;
-      val = from.val;
-      level = from.level;
-    }
-    return *this;
-  }
-
-  inline void reset() {
-    if (level != kInfinity) {
-      level = kInfinity;
-    }
-  }
-
-  void checkClear(int j) {
-    if (level != kInfinity) {
-      katana::gError(j, " PROBLEM WITH LEVEL OF ", toString());
-    }
-    if (val != 0) {
-      katana::gError(j, " PROBLEM WITH VAL OF ", toString());
-    }
-  }
+  BCEdge() : val(0), level(kInfinity) {}
 
-  /**
-   * TODO actually implement this if needed
-   */
-  // char isAlreadyIn() {
-  //  return 0;
-  //}
+  inline void reset() { level = kInfinity; }
 
   std::string toString() const {
     std::ostringstream s;
@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "betweenness_centrality_impl.h"
+#include "katana/EpochArray.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using Node = BiDirView::Node;
+
+struct NodeBC : public katana::PODProperty<float> {};
+
+/// The number of pairs sampled before the first check for convergence; the
+/// number of pairs doubles between checks
+constexpr uint64_t kFirstCheck = 1024;
+
+/// Pair i is drawn from a generator seeded with kSeed + i, so the estimates
+/// do not depend on the number of threads
+constexpr uint64_t kSeed = 0x9e3779b97f4a7c15;
+
+/// The state of a search, kept by each thread across samples. The distances
+/// are an EpochArray, so starting a search does not touch them, and the
+/// path counts are only read for nodes with a distance.
+struct Scratch {
+  katana::EpochArray<uint32_t> dist;
+  std::vector<double> sigma;
+  std::vector<Node> frontier;
+  std::vector<Node> next;
+
+  void Begin(size_t num_nodes) {
+    if (dist.size() != num_nodes) {
+      dist.Resize(num_nodes);
+      sigma.resize(num_nodes);
+    } else {
+      dist.Reset();
+    }
+    frontier.clear();
+  }
+};
+
+class PathSampler {
+public:
+  explicit PathSampler(BiDirView view) : view_(std::move(view)) {}
+
+  /// Pick one of the shortest paths from source to target, which are
+  /// different nodes, uniformly at random and call fn(v) for each node v
+  /// strictly inside it; does nothing if target is unreachable
+  template <typename F>
+  void SamplePath(Node source, Node target, std::mt19937_64* gen, F fn) {
+    Scratch& sc = *scratch_.getLocal();
+    sc.Begin(view_.num_nodes());
+
+    // BFS by levels that counts shortest paths and stops after the level
+    // of target, whose predecessors then have their final counts
+    sc.dist.Set(source, 0);
+    sc.sigma[source] = 1;
+    sc.frontier.push_back(source);
+    for (uint32_t level = 1; !sc.frontier.empty() && !sc.dist.IsSet(target);
+         ++level) {
+      sc.next.clear();
+      for (Node u : sc.frontier) {
+        for (auto e : view_.edges(u)) {
+          Node v = view_.edge_dest(e);
+          if (!sc.dist.IsSet(v)) {
+            sc.dist.Set(v, level);
+            sc.sigma[v] = 0;
+            sc.next.push_back(v);
+          }
+          if (sc.dist.Get(v) == level) {
+            sc.sigma[v] += sc.sigma[u];
+          }
+        }
+      }
+      std::swap(sc.frontier, sc.next);
+    }
+    if (!sc.dist.IsSet(target)) {
+      return;
+    }
+
+    // walk back from target, choosing each predecessor with probability
+    // proportional to the number of shortest paths through it
+    Node w = target;
+    while (true) {
+      uint32_t pred_dist = sc.dist.Get(w) - 1;
+      double x =
+          std::uniform_real_distribution<double>(0, sc.sigma[w])(*gen);
+      Node pred = w;
+      for (auto e : view_.in_edges(w)) {
+        Node u = view_.in_edge_dest(e);
+        if (sc.dist.IsSet(u) && sc.dist.Get(u) == pred_dist) {
+          pred = u;
+          x -= sc.sigma[u];
+          if (x < 0) {
+            break;
+          }
+        }
+      }
+      if (pred == source) {
+        return;
+      }
+      fn(pred);
+      w = pred;
+    }
+  }
+
+private:
+  BiDirView view_;
+  katana::PerThreadStorage<Scratch> scratch_;
+};
+
+/// \returns the number of pairs after which, with probability at least
+/// 1 - delta, every estimate is within error_bound. The vertex diameter
+/// of the graph, the largest number of nodes on a shortest path, is at
+/// most num_nodes.
+uint64_t
+MaxSamples(uint64_t num_nodes, double error_bound, double delta) {
+  double vertex_diameter = static_cast<double>(num_nodes);
+  double samples =
+      0.5 / (error_bound * error_bound) *
+      (std::floor(std::log2(vertex_diameter - 2)) + 1 + std::log(1 / delta));
+  return static_cast<uint64_t>(std::ceil(samples));
+}
+
+/// \returns the largest empirical-Bernstein bound (Maurer and Pontil,
+/// "Empirical Bernstein bounds and sample variance penalization", COLT
+/// 2009) on the error of the estimates after num_samples pairs. log_term
+/// is ln(4 / delta) for the probability delta with which any of the bounds
+/// fails.
+double
+MaxDeviation(
+    const katana::NUMAArray<std::atomic<uint64_t>>& counts,
+    uint64_t num_samples, double log_term) {
+  double m = static_cast<double>(num_samples);
+  katana::GReduceMax<double> max_deviation;
+  katana::do_all(
+      katana::iterate(size_t{0}, counts.size()),
+      [&](size_t n) {
+        double p = counts[n].load(std::memory_order_relaxed) / m;
+        // sample variance of the indicator of n being on the sampled path
+        double variance = p * (1 - p) * m / (m - 1);
+        max_deviation.update(
+            std::sqrt(2 * variance * log_term / m) +
+            7 * log_term / (3 * (m - 1)));
+      },
+      katana::no_stats());
+  return max_deviation.reduce();
+}
+
+}  // namespace
+
+katana::Result<void>
+BetweennessCentralityApproximate(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    BetweennessCentralityPlan plan) {
+  double error_bound = plan.error_bound();
+  double confidence = plan.confidence();
+  if (!(error_bound > 0 && error_bound < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "error bound must be in (0, 1), not {}", error_bound);
+  }
+  if (!(confidence > 0 && confidence < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "confidence must be in (0, 1), not {}", confidence);
+  }
+
+  uint64_t num_nodes = pg->num_nodes();
+  katana::NUMAArray<std::atomic<uint64_t>> counts;
+  counts.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { counts.constructAt(n, 0ul); }, katana::no_stats());
+
+  katana::StatTimer exec_time("Betweenness Centrality Approximate");
+  exec_time.start();
+
+  // Half of the failure probability goes to the bound on the number of
+  // pairs and half to the checks for convergence, split evenly over every
+  // node at every check.
+  uint64_t num_samples = 0;
+  if (num_nodes > 2) {
+    double delta = 1 - confidence;
+    uint64_t max_samples = MaxSamples(num_nodes, error_bound, delta / 2);
+    uint64_t num_checks = 1;
+    for (uint64_t m = 2 * kFirstCheck; m < max_samples; m *= 2) {
+      ++num_checks;
+    }
+    double log_term =
+        std::log(4 * static_cast<double>(num_nodes * num_checks) / (delta / 2));
+
+    PathSampler sampler(pg->BuildView<BiDirView>());
+    uint64_t next_check = std::min(kFirstCheck, max_samples);
+    while (true) {
+      katana::do_all(
+          katana::iterate(num_samples, next_check),
+          [&](uint64_t i) {
+            std::mt19937_64 gen(kSeed + i);
+            Node source =
+                std::uniform_int_distribution<Node>(0, num_nodes - 1)(gen);
+            Node target =
+                std::uniform_int_distribution<Node>(0, num_nodes - 2)(gen);
+            if (target >= source) {
+              ++target;
+            }
+            sampler.SamplePath(source, target, &gen, [&](Node v) {
+              counts[v].fetch_add(1, std::memory_order_relaxed);
+            });
+          },
+          katana::steal(), katana::loopname("BetweennessCentralitySample"));
+      num_samples = next_check;
+
+      if (num_samples == max_samples ||
+          MaxDeviation(counts, num_samples, log_term) <= error_bound) {
+        break;
+      }
+      next_check = std::min(2 * num_samples, max_samples);
+    }
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle(
+      "BetweennessCentrality", "ApproximateSamples", num_samples);
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeBC>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED(
+      (katana::TypedPropertyGraph<std::tuple<NodeBC>, std::tuple<>>::Make(
+          pg, {output_property_name}, {})));
+
+  // estimates of normalized centralities are scaled back by the number of
+  // ordered pairs
+  double scale = num_samples == 0 ? 0
+                                  : static_cast<double>(num_nodes) *
+                                        (num_nodes - 1) / num_samples;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t count = counts[n].load(std::memory_order_relaxed);
+        graph.GetData<NodeBC>(n) = static_cast<float>(count * scale);
+      },
+      katana::loopname("ExtractBC"), katana::no_stats());
+
+  return katana::ResultSuccess();
+}
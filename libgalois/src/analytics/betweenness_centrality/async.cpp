@@ -1,24 +1,35 @@
-#include <iomanip>
-#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
 
 #include "BCEdge.h"
 #include "BCNode.h"
+#include "betweenness_centrality_impl.h"
 #include "katana/Bag.h"
-#include "katana/BufferedGraph.h"
-#include "katana/LC_CSR_CSC_Graph.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/TypedPropertyGraph.h"
 
-// WARNING: optimal chunk size may differ depending on input graph
-constexpr static const unsigned ASYNC_CHUNK_SIZE = 64U;
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using Node = BiDirView::Node;
 using NodeType = BCNode<BC_USE_MARKING, BC_CONCURRENT>;
-using AsynchronousGraph =
-    katana::LC_CSR_CSC_Graph<NodeType, BCEdge, false, true>;
 
-// Work items for the forward phase
+struct NodeBC : public katana::PODProperty<float> {};
+
+// WARNING: optimal chunk size may differ depending on input graph
+constexpr static const unsigned kAsyncChunkSize = 64U;
+
+/// Work items for the forward phase of the source in slot
 struct ForwardPhaseWorkItem {
-  uint32_t nodeID;
+  uint32_t node_id;
   uint32_t distance;
-  ForwardPhaseWorkItem() : nodeID(kInfinity), distance(kInfinity){};
-  ForwardPhaseWorkItem(uint32_t _n, uint32_t _d) : nodeID(_n), distance(_d){};
+  uint32_t slot;
 };
 
 // grabs distance from a forward phase work item
@@ -28,8 +39,14 @@ struct FPWorkItemIndexer {
   }
 };
 
+/// Work items for the backward phase of the source in slot
+struct BackwardPhaseWorkItem {
+  uint32_t node_id;
+  uint32_t slot;
+};
+
 // obim worklist type declaration
-using PSchunk = katana::PerSocketChunkFIFO<ASYNC_CHUNK_SIZE>;
+using PSchunk = katana::PerSocketChunkFIFO<kAsyncChunkSize>;
 using OBIM = katana::OrderedByIntegerMetric<FPWorkItemIndexer, PSchunk>;
 
 template <typename T, bool enable>
@@ -38,7 +55,9 @@ struct Counter : public T {
 
   Counter(std::string s) : name(std::move(s)) {}
 
-  ~Counter() { katana::ReportStatSingle("(NULL)", name, this->reduce()); }
+  ~Counter() {
+    katana::ReportStatSingle("BetweennessCentrality", name, this->reduce());
+  }
 };
 
 template <typename T>
@@ -49,218 +68,248 @@ struct Counter<T, false> {
   void update(Args...) {}
 };
 
-struct BetweenessCentralityAsynchronous {
-  AsynchronousGraph& graph;
+/// Asynchronous Brandes betweenness centrality (Prountzos and Pingali,
+/// "Betweenness centrality: algorithms and implementations", PPoPP 2013).
+/// The forward phase builds the shortest path DAG of a source with a
+/// worklist ordered by distance but without barriers between levels,
+/// correcting nodes whose distance drops after they joined the DAG, and the
+/// backward phase propagates dependencies from the leaves of the DAG as
+/// soon as all successors of a node are done.
+///
+/// Each of a number of slots holds the node and edge state of one source,
+/// and the sources of all slots run in the same parallel loops, so
+/// high-diameter graphs, whose DAGs are deep and narrow, still have enough
+/// work to fill the threads.
+class BCAsynchronous {
+public:
+  BCAsynchronous(BiDirView view, uint32_t num_slots)
+      : view_(std::move(view)),
+        num_nodes_(view_.num_nodes()),
+        num_edges_(view_.num_edges()),
+        num_slots_(num_slots) {
+    node_data_.allocateBlocked(num_slots_ * num_nodes_);
+    edge_data_.allocateBlocked(num_slots_ * num_edges_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_slots_ * num_nodes_),
+        [&](uint64_t i) { node_data_.constructAt(i); }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_slots_ * num_edges_),
+        [&](uint64_t i) { edge_data_.constructAt(i); }, katana::no_stats());
+  }
 
-  BetweenessCentralityAsynchronous(AsynchronousGraph& _graph) : graph(_graph) {}
+  /// Add the dependencies of sources, at most one per slot, to the
+  /// centralities
+  void Run(const std::vector<Node>& sources) {
+    KATANA_LOG_DEBUG_ASSERT(sources.size() <= num_slots_);
+    sources_ = sources;
 
-  using SumCounter =
-      Counter<katana::GAccumulator<unsigned long>, BC_COUNT_ACTIONS>;
-  SumCounter spfuCount{"SP&FU"};
-  SumCounter updateSigmaP1Count{"UpdateSigmaBefore"};
-  SumCounter updateSigmaP2Count{"RealUS"};
-  SumCounter firstUpdateCount{"First Update"};
-  SumCounter correctNodeP1Count{"CorrectNodeBefore"};
-  SumCounter correctNodeP2Count{"Real CN"};
-  SumCounter noActionCount{"NoAction"};
+    katana::InsertBag<ForwardPhaseWorkItem> forward_wl;
+    for (uint32_t slot = 0; slot < sources_.size(); ++slot) {
+      Data(slot, sources_[slot]).initAsSource();
+      forward_wl.push_back(ForwardPhaseWorkItem{sources_[slot], 0, slot});
+    }
+    DagConstruction(forward_wl);
 
-  using MaxCounter =
-      Counter<katana::GReduceMax<unsigned long>, BC_COUNT_ACTIONS>;
-  MaxCounter largestNodeDist{"Largest node distance"};
+    katana::InsertBag<BackwardPhaseWorkItem> backward_wl;
+    FindLeaves(backward_wl);
+    DependencyBackProp(backward_wl);
+  }
 
-  using LeafCounter =
-      Counter<katana::GAccumulator<unsigned long>, BC_COUNT_LEAVES>;
+  /// \returns the centrality of n summed over the slots
+  float Centrality(Node n) const {
+    double bc = 0;
+    for (uint32_t slot = 0; slot < num_slots_; ++slot) {
+      bc += node_data_[slot * num_nodes_ + n].bc;
+    }
+    return static_cast<float>(bc);
+  }
+
+private:
+  NodeType& Data(uint32_t slot, Node n) {
+    return node_data_[slot * num_nodes_ + n];
+  }
 
-  void CorrectNode(uint32_t dstID, BCEdge&) {
-    NodeType& dstData = graph.getData(dstID);
+  BCEdge& EdgeData(uint32_t slot, uint64_t property_index) {
+    return edge_data_[slot * num_edges_ + property_index];
+  }
 
-    // loop through in edges
-    for (auto e : graph.in_edges(dstID)) {
-      BCEdge& inEdgeData = graph.getInEdgeData(e);
+  /// Remove the edges into dst from nodes that are no longer closer to the
+  /// source than dst from the DAG
+  void CorrectNode(uint32_t slot, Node dst_id) {
+    NodeType& dst_data = Data(slot, dst_id);
 
-      uint32_t srcID = graph.getInEdgeDst(e);
-      if (srcID == dstID)
+    // loop through in edges
+    for (auto e : view_.in_edges(dst_id)) {
+      Node src_id = view_.in_edge_dest(e);
+      if (src_id == dst_id) {
         continue;
-
-      NodeType& srcData = graph.getData(srcID);
+      }
+      BCEdge& in_edge_data = EdgeData(slot, view_.in_edge_property_index(e));
+      NodeType& src_data = Data(slot, src_id);
 
       // lock in right order
-      if (srcID < dstID) {
-        srcData.lock();
-        dstData.lock();
+      if (src_id < dst_id) {
+        src_data.lock();
+        dst_data.lock();
       } else {
-        dstData.lock();
-        srcData.lock();
+        dst_data.lock();
+        src_data.lock();
       }
 
-      const unsigned edgeLevel = inEdgeData.level;
+      const unsigned edge_level = in_edge_data.level;
 
       // Correct Node
-      if (srcData.distance >= dstData.distance) {
-        correctNodeP1Count.update(1);
-        dstData.unlock();
-
-        if (edgeLevel != kInfinity) {
-          inEdgeData.level = kInfinity;
-          if (edgeLevel == srcData.distance) {
-            correctNodeP2Count.update(1);
-            srcData.nsuccs--;
+      if (src_data.distance >= dst_data.distance) {
+        correct_node_p1_count_.update(1);
+        dst_data.unlock();
+
+        if (edge_level != kInfinity) {
+          in_edge_data.level = kInfinity;
+          if (edge_level == src_data.distance) {
+            correct_node_p2_count_.update(1);
+            src_data.nsuccs--;
           }
         }
-        srcData.unlock();
+        src_data.unlock();
       } else {
-        srcData.unlock();
-        dstData.unlock();
+        src_data.unlock();
+        dst_data.unlock();
       }
     }
   }
 
+  /// Shortest path and first update: src gives dst a shorter distance.
+  /// Called with both locked; unlocks them.
   template <typename CTXType>
-  void SpAndFU(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
-    spfuCount.update(1);
+  void SpAndFU(
+      uint32_t slot, Node src_id, Node dst_id, BCEdge& ed, CTXType& ctx) {
+    spfu_count_.update(1);
 
-    NodeType& srcData = graph.getData(srcID);
-    NodeType& dstData = graph.getData(dstID);
+    NodeType& src_data = Data(slot, src_id);
+    NodeType& dst_data = Data(slot, dst_id);
 
     // make dst a successor of src, src predecessor of dst
-    srcData.nsuccs++;
-    const ShortPathType srcSigma = srcData.sigma;
-    KATANA_LOG_DEBUG_ASSERT(srcSigma > 0);
-    NodeType::predTY& dstPreds = dstData.preds;
-    bool dstPredsNotEmpty = !dstPreds.empty();
-    dstPreds.clear();
-    dstPreds.push_back(srcID);
-    dstData.distance = srcData.distance + 1;
-
-    largestNodeDist.update(dstData.distance);
-
-    dstData.nsuccs = 0;        // SP
-    dstData.sigma = srcSigma;  // FU
-    ed.val = srcSigma;
-    ed.level = srcData.distance;
-    srcData.unlock();
-    if (!dstData.isAlreadyIn())
-      ctx.push(ForwardPhaseWorkItem(dstID, dstData.distance));
-    dstData.unlock();
-    if (dstPredsNotEmpty) {
-      correctNode(dstID, ed);
+    src_data.nsuccs++;
+    const ShortPathType src_sigma = src_data.sigma;
+    KATANA_LOG_DEBUG_ASSERT(src_sigma > 0);
+    NodeType::predTY& dst_preds = dst_data.preds;
+    bool dst_preds_not_empty = !dst_preds.empty();
+    dst_preds.clear();
+    dst_preds.push_back(src_id);
+    dst_data.distance = src_data.distance + 1;
+
+    largest_node_dist_.update(dst_data.distance);
+
+    dst_data.nsuccs = 0;         // SP
+    dst_data.sigma = src_sigma;  // FU
+    ed.val = src_sigma;
+    ed.level = src_data.distance;
+    src_data.unlock();
+    if (!dst_data.isAlreadyIn()) {
+      ctx.push(ForwardPhaseWorkItem{dst_id, dst_data.distance, slot});
+    }
+    dst_data.unlock();
+    if (dst_preds_not_empty) {
+      CorrectNode(slot, dst_id);
     }
   }
 
+  /// Push the growth of the sigma of src along a DAG edge. Called with both
+  /// locked; unlocks them.
   template <typename CTXType>
-  void UpdateSigma(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
-    updateSigmaP1Count.update(1);
+  void UpdateSigma(
+      uint32_t slot, Node src_id, Node dst_id, BCEdge& ed, CTXType& ctx) {
+    update_sigma_p1_count_.update(1);
 
-    NodeType& srcData = graph.getData(srcID);
-    NodeType& dstData = graph.getData(dstID);
+    NodeType& src_data = Data(slot, src_id);
+    NodeType& dst_data = Data(slot, dst_id);
 
-    const ShortPathType srcSigma = srcData.sigma;
+    const ShortPathType src_sigma = src_data.sigma;
     const ShortPathType eval = ed.val;
-    const ShortPathType diff = srcSigma - eval;
+    const ShortPathType diff = src_sigma - eval;
 
-    srcData.unlock();
+    src_data.unlock();
     // greater than 0.0001 instead of 0 due to floating point imprecision
     if (diff > 0.0001) {
-      updateSigmaP2Count.update(1);
-      ed.val = srcSigma;
-
-      // ShortPathType old = dstData.sigma;
-      dstData.sigma += diff;
-
-      // if (old >= dstData.sigma) {
-      //  katana::gDebug("Overflow detected; capping at max uint64_t");
-      //  dstData.sigma = std::numeric_limits<uint64_t>::max();
-      //}
+      update_sigma_p2_count_.update(1);
+      ed.val = src_sigma;
+      dst_data.sigma += diff;
 
-      int nbsuccs = dstData.nsuccs;
-
-      if (nbsuccs > 0) {
-        if (!dstData.isAlreadyIn())
-          ctx.push(ForwardPhaseWorkItem(dstID, dstData.distance));
+      if (dst_data.nsuccs > 0 && !dst_data.isAlreadyIn()) {
+        ctx.push(ForwardPhaseWorkItem{dst_id, dst_data.distance, slot});
       }
-      dstData.unlock();
-    } else {
-      dstData.unlock();
     }
+    dst_data.unlock();
   }
 
+  /// Add an edge into a node at the next distance to the DAG. Called with
+  /// both locked; unlocks them.
   template <typename CTXType>
-  void FirstUpdate(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
-    firstUpdateCount.update(1);
-
-    NodeType& srcData = graph.getData(srcID);
-    srcData.nsuccs++;
-    const ShortPathType srcSigma = srcData.sigma;
-
-    NodeType& dstData = graph.getData(dstID);
-    dstData.preds.push_back(srcID);
-
-    const ShortPathType dstSigma = dstData.sigma;
-
-    // ShortPathType old = dstData.sigma;
-    dstData.sigma = dstSigma + srcSigma;
-    // if (old >= dstData.sigma) {
-    //  katana::gDebug("Overflow detected; capping at max uint64_t");
-    //  dstData.sigma = std::numeric_limits<uint64_t>::max();
-    //}
-
-    ed.val = srcSigma;
-    ed.level = srcData.distance;
-    srcData.unlock();
-    int nbsuccs = dstData.nsuccs;
-    if (nbsuccs > 0) {
-      if (!dstData.isAlreadyIn())
-        ctx.push(ForwardPhaseWorkItem(dstID, dstData.distance));
+  void FirstUpdate(
+      uint32_t slot, Node src_id, Node dst_id, BCEdge& ed, CTXType& ctx) {
+    first_update_count_.update(1);
+
+    NodeType& src_data = Data(slot, src_id);
+    src_data.nsuccs++;
+    const ShortPathType src_sigma = src_data.sigma;
+
+    NodeType& dst_data = Data(slot, dst_id);
+    dst_data.preds.push_back(src_id);
+    dst_data.sigma += src_sigma;
+
+    ed.val = src_sigma;
+    ed.level = src_data.distance;
+    src_data.unlock();
+    if (dst_data.nsuccs > 0 && !dst_data.isAlreadyIn()) {
+      ctx.push(ForwardPhaseWorkItem{dst_id, dst_data.distance, slot});
     }
-    dstData.unlock();
+    dst_data.unlock();
   }
 
   void DagConstruction(katana::InsertBag<ForwardPhaseWorkItem>& wl) {
     katana::for_each(
         katana::iterate(wl),
-        [&](ForwardPhaseWorkItem& wi, auto& ctx) {
-          uint32_t srcID = wi.nodeID;
-          NodeType& srcData = graph.getData(srcID);
-          srcData.markOut();
+        [&](const ForwardPhaseWorkItem& wi, auto& ctx) {
+          uint32_t slot = wi.slot;
+          Node src_id = wi.node_id;
+          NodeType& src_data = Data(slot, src_id);
+          src_data.markOut();
 
           // loop through all edges
-          for (auto e : graph.edges(srcID)) {
-            BCEdge& edgeData = graph.getEdgeData(e);
-            uint32_t dstID = graph.getEdgeDst(e);
-            NodeType& dstData = graph.getData(dstID);
-
-            if (srcID == dstID)
+          for (auto e : view_.edges(src_id)) {
+            Node dst_id = view_.edge_dest(e);
+            if (src_id == dst_id) {
               continue;  // ignore self loops
+            }
+            BCEdge& edge_data = EdgeData(slot, view_.edge_property_index(e));
+            NodeType& dst_data = Data(slot, dst_id);
 
-            // lock in set order to prevent deadlock (lower id
-            // first)
-            // TODO run even in serial version; find way to not
-            // need to run
-            if (srcID < dstID) {
-              srcData.lock();
-              dstData.lock();
+            // lock in set order to prevent deadlock (lower id first)
+            if (src_id < dst_id) {
+              src_data.lock();
+              dst_data.lock();
             } else {
-              dstData.lock();
-              srcData.lock();
+              dst_data.lock();
+              src_data.lock();
             }
 
-            const int elevel = edgeData.level;
-            const int ADist = srcData.distance;
-            const int BDist = dstData.distance;
+            const uint64_t elevel = edge_data.level;
+            const uint64_t a_dist = src_data.distance;
+            const uint64_t b_dist = dst_data.distance;
 
-            if (BDist - ADist > 1) {
+            if (b_dist > a_dist + 1) {
               // Shortest Path + First Update (and Correct Node)
-              this->spAndFU(srcID, dstID, edgeData, ctx);
-            } else if (elevel == ADist && BDist == ADist + 1) {
+              SpAndFU(slot, src_id, dst_id, edge_data, ctx);
+            } else if (elevel == a_dist && b_dist == a_dist + 1) {
               // Update Sigma
-              this->updateSigma(srcID, dstID, edgeData, ctx);
-            } else if (BDist == ADist + 1 && elevel != ADist) {
+              UpdateSigma(slot, src_id, dst_id, edge_data, ctx);
+            } else if (b_dist == a_dist + 1 && elevel != a_dist) {
               // First Update not combined with Shortest Path
-              this->firstUpdate(srcID, dstID, edgeData, ctx);
+              FirstUpdate(slot, src_id, dst_id, edge_data, ctx);
             } else {  // No Action
-              noActionCount.update(1);
-              srcData.unlock();
-              dstData.unlock();
+              no_action_count_.update(1);
+              src_data.unlock();
+              dst_data.unlock();
             }
           }
         },
@@ -268,271 +317,178 @@ struct BetweenessCentralityAsynchronous {
         katana::disable_conflict_detection(), katana::loopname("ForwardPhase"));
   }
 
-  void DependencyBackProp(katana::InsertBag<uint32_t>& wl) {
+  void DependencyBackProp(katana::InsertBag<BackwardPhaseWorkItem>& wl) {
     katana::for_each(
         katana::iterate(wl),
-        [&](uint32_t srcID, auto& ctx) {
-          NodeType& srcData = graph.getData(srcID);
-          srcData.lock();
-
-          if (srcData.nsuccs == 0) {
-            const double srcDelta = srcData.delta;
-            srcData.bc += srcDelta;
-
-            srcData.unlock();
-
-            NodeType::predTY& srcPreds = srcData.preds;
-
-            // loop through src's predecessors
-            for (unsigned i = 0; i < srcPreds.size(); i++) {
-              uint32_t predID = srcPreds[i];
-              NodeType& predData = graph.getData(predID);
-
-              KATANA_LOG_DEBUG_ASSERT(srcData.sigma >= 1);
-              const double term =
-                  (double)predData.sigma * (1.0 + srcDelta) / srcData.sigma;
-              // if (std::isnan(term)) {
-              //  katana::gPrint(predData.sigma, " ", srcDelta, "
-              //  ", srcData.sigma, "\n");
-              //}
-              predData.lock();
-              predData.delta += term;
-              const unsigned prevPdNsuccs = predData.nsuccs;
-              predData.nsuccs--;
-
-              if (prevPdNsuccs == 1) {
-                predData.unlock();
-                ctx.push(predID);
-              } else {
-                predData.unlock();
-              }
-            }
+        [&](const BackwardPhaseWorkItem& wi, auto& ctx) {
+          uint32_t slot = wi.slot;
+          Node src_id = wi.node_id;
+          NodeType& src_data = Data(slot, src_id);
+          src_data.lock();
+
+          if (src_data.nsuccs != 0) {
+            src_data.unlock();
+            return;
+          }
 
-            // reset data in preparation for next source
-            srcData.reset();
-            for (auto e : graph.edges(srcID)) {
-              graph.getEdgeData(e).reset();
+          const double src_delta = src_data.delta;
+          // the dependency of the source on itself is not a centrality
+          if (src_id != sources_[slot]) {
+            src_data.bc += src_delta;
+          }
+          src_data.unlock();
+
+          // loop through src's predecessors
+          for (Node pred_id : src_data.preds) {
+            NodeType& pred_data = Data(slot, pred_id);
+
+            KATANA_LOG_DEBUG_ASSERT(src_data.sigma >= 1);
+            const double term =
+                pred_data.sigma * (1.0 + src_delta) / src_data.sigma;
+            pred_data.lock();
+            pred_data.delta += term;
+            const unsigned prev_pd_nsuccs = pred_data.nsuccs;
+            pred_data.nsuccs--;
+            pred_data.unlock();
+
+            if (prev_pd_nsuccs == 1) {
+              ctx.push(BackwardPhaseWorkItem{pred_id, slot});
             }
-          } else {
-            srcData.unlock();
+          }
+
+          // reset data in preparation for next source
+          src_data.reset();
+          for (auto e : view_.edges(src_id)) {
+            EdgeData(slot, view_.edge_property_index(e)).reset();
           }
         },
         katana::disable_conflict_detection(),
         katana::loopname("BackwardPhase"));
   }
 
-  void FindLeaves(katana::InsertBag<uint32_t>& fringeWL, unsigned nnodes) {
-    LeafCounter leafCount{"leaf nodes in DAG"};
+  void FindLeaves(katana::InsertBag<BackwardPhaseWorkItem>& fringe_wl) {
+    LeafCounter leaf_count{"LeafNodesInDAG"};
     katana::do_all(
-        katana::iterate(0u, nnodes),
-        [&](auto i) {
-          NodeType& n = graph.getData(i);
+        katana::iterate(uint64_t{0}, sources_.size() * num_nodes_),
+        [&](uint64_t i) {
+          NodeType& n = node_data_[i];
 
           if (n.nsuccs == 0 && n.distance < kInfinity) {
-            leafCount.update(1);
-            fringeWL.push(i);
+            leaf_count.update(1);
+            fringe_wl.push(BackwardPhaseWorkItem{
+                static_cast<uint32_t>(i % num_nodes_),
+                static_cast<uint32_t>(i / num_nodes_)});
           }
         },
         katana::loopname("LeafFind"));
   }
-};
 
-void
-AsynchronousSanity(AsynchronousGraph& graph) {
-  katana::GReduceMax<float> accum_max;
-  katana::GReduceMin<float> accum_min;
-  katana::GAccumulator<float> accum_sum;
-  accum_max.reset();
-  accum_min.reset();
-  accum_sum.reset();
-
-  // get max, min, sum of BC values using accumulators and reducers
-  katana::do_all(
-      katana::iterate(graph),
-      [&](unsigned n) {
-        auto& nodeData = graph.getData(n);
-        accum_max.update(nodeData.bc);
-        accum_min.update(nodeData.bc);
-        accum_sum += nodeData.bc;
-      },
-      katana::no_stats(), katana::loopname("AsynchronousSanity"));
-
-  katana::gPrint("Max BC is ", accum_max.reduce(), "\n");
-  katana::gPrint("Min BC is ", accum_min.reduce(), "\n");
-  katana::gPrint("BC sum is ", accum_sum.reduce(), "\n");
-}
-////////////////////////////////////////////////////////////////////////////////
+  BiDirView view_;
+  uint64_t num_nodes_;
+  uint64_t num_edges_;
+  uint64_t num_slots_;
+  katana::NUMAArray<NodeType> node_data_;
+  katana::NUMAArray<BCEdge> edge_data_;
+  std::vector<Node> sources_;
 
-//! runs asynchronous BC
-void
-BetweennessCentralityAsynchronous() {
-  if (BC_CONCURRENT) {
-    katana::gInfo("Running in concurrent mode with ", numThreads, " threads");
-  } else {
-    katana::gInfo("Running in serial mode");
-  }
+  using SumCounter =
+      Counter<katana::GAccumulator<unsigned long>, BC_COUNT_ACTIONS>;
+  SumCounter spfu_count_{"SP&FU"};
+  SumCounter update_sigma_p1_count_{"UpdateSigmaBefore"};
+  SumCounter update_sigma_p2_count_{"RealUS"};
+  SumCounter first_update_count_{"First Update"};
+  SumCounter correct_node_p1_count_{"CorrectNodeBefore"};
+  SumCounter correct_node_p2_count_{"Real CN"};
+  SumCounter no_action_count_{"NoAction"};
 
-  katana::gInfo("Constructing async BC graph");
-  // create bidirectional graph
-  AsynchronousGraph bcGraph;
+  using MaxCounter =
+      Counter<katana::GReduceMax<unsigned long>, BC_COUNT_ACTIONS>;
+  MaxCounter largest_node_dist_{"Largest node distance"};
 
-  katana::StatTimer graph_construct_timer("GRAPH_CONSTRUCT");
-  graph_construct_timer.start();
+  using LeafCounter =
+      Counter<katana::GAccumulator<unsigned long>, BC_COUNT_LEAVES>;
+};
 
-  katana::FileGraph fileReader;
-  fileReader.fromFile(inputFile);
-  bcGraph.allocateFrom(fileReader.size(), fileReader.sizeEdges());
-  bcGraph.constructNodes();
+}  // namespace
 
-  katana::do_all(katana::iterate(fileReader), [&](uint32_t i) {
-    auto b = fileReader.edge_begin(i);
-    auto e = fileReader.edge_end(i);
+////////////////////////////////////////////////////////////////////////////////
 
-    bcGraph.fixEndEdge(i, *e);
+katana::Result<void>
+BetweennessCentralityAsynchronous(
+    katana::PropertyGraph* pg, BetweennessCentralitySources sources,
+    const std::string& output_property_name, BetweennessCentralityPlan plan) {
+  if (plan.concurrent_sources() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "at least one source must run at a time");
+  }
 
-    while (b < e) {
-      bcGraph.constructEdge(*b, fileReader.getEdgeDst(*b));
-      b++;
+  // sources are taken as in the level algorithm
+  std::vector<Node> source_vector;
+  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
+    source_vector = std::get<std::vector<uint32_t>>(sources);
+  } else {
+    uint64_t num_sources = sources == kBetweennessCentralityAllNodes
+                               ? pg->num_nodes()
+                               : std::min<uint64_t>(
+                                     std::get<uint32_t>(sources),
+                                     pg->num_nodes());
+    source_vector.resize(num_sources);
+    std::iota(source_vector.begin(), source_vector.end(), 0);
+  }
+  for (Node source : source_vector) {
+    if (source >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
     }
-  });
-  bcGraph.constructIncomingEdges();
-
-  graph_construct_timer.stop();
+  }
 
-  BetweenessCentralityAsynchronous bcExecutor(bcGraph);
+  BiDirView view = pg->BuildView<BiDirView>();
+  // nodes without outgoing edges have no dependencies
+  source_vector.erase(
+      std::remove_if(
+          source_vector.begin(), source_vector.end(),
+          [&](Node n) { return view.degree(n) == 0; }),
+      source_vector.end());
 
-  unsigned nnodes = bcGraph.size();
-  uint64_t nedges = bcGraph.sizeEdges();
-  katana::gInfo("Num nodes is ", nnodes, ", num edges is ", nedges);
-  katana::gInfo("Using OBIM chunk size: ", ASYNC_CHUNK_SIZE);
-  katana::gInfo(
-      "Note that optimal chunk size may differ depending on input "
-      "graph");
+  uint32_t num_slots = std::max<uint64_t>(
+      1, std::min<uint64_t>(plan.concurrent_sources(), source_vector.size()));
   katana::ReportStatSingle(
-      "BetweennessCentralityAsynchronous", "ChunkSize", ASYNC_CHUNK_SIZE);
+      "BetweennessCentrality", "ChunkSize", kAsyncChunkSize);
+  katana::ReportStatSingle(
+      "BetweennessCentrality", "ConcurrentSources", num_slots);
 
   katana::EnsurePreallocated(
       std::min(
           static_cast<uint64_t>(
               std::min(katana::getActiveThreads(), 100U) *
-              std::max((nnodes / 4500000), unsigned{5}) *
-              std::max((nedges / 30000000), uint64_t{5}) * 2.5),
+              std::max((pg->num_nodes() / 4500000), uint64_t{5}) *
+              std::max((pg->num_edges() / 30000000), uint64_t{5}) * 2.5),
           uint64_t{1500}) +
       5);
   katana::ReportPageAllocGuard page_alloc;
 
-  // reset everything in preparation for run
-  katana::do_all(
-      katana::iterate(0u, nnodes), [&](auto i) { bcGraph.getData(i).reset(); });
-  katana::do_all(katana::iterate(UINT64_C(0), nedges), [&](auto i) {
-    bcGraph.getEdgeData(i).reset();
-  });
-
-  // reading in list of sources to operate on if provided
-  std::ifstream sourceFile;
-  std::vector<uint64_t> sourceVector;
-  if (sourcesToUse != "") {
-    sourceFile.open(sourcesToUse);
-    std::vector<uint64_t> t(
-        std::istream_iterator<uint64_t>{sourceFile},
-        std::istream_iterator<uint64_t>{});
-    sourceVector = t;
-    sourceFile.close();
-  }
-
-  if (numOfSources == 0) {
-    numOfSources = nnodes;
-  }
-
-  // if user does specifes a certain number of out sources (i.e. only sources
-  // with outgoing edges), we need to loop over the entire node set to look for
-  // good sources to use
-  uint32_t goodSource = 0;
-  if (iterLimit != 0) {
-    numOfSources = nnodes;
-  }
-
-  // only use at most the number of sources in the passed in source file (if
-  // such a file was actually pass in)
-  if (sourceVector.size() != 0) {
-    if (numOfSources > sourceVector.size()) {
-      numOfSources = sourceVector.size();
-    }
-  }
-
-  katana::InsertBag<ForwardPhaseWorkItem> forwardPhaseWL;
-  katana::InsertBag<uint32_t> backwardPhaseWL;
+  BCAsynchronous bc_executor(std::move(view), num_slots);
 
-  katana::gInfo("Beginning execution");
-
-  katana::StatTimer exec_time("BetweennessCentralityAsynchronous");
+  katana::StatTimer exec_time("Asynchronous", "BetweennessCentrality");
   exec_time.start();
-  for (uint32_t i = 0; i < numOfSources; ++i) {
-    uint32_t sourceToUse = i;
-    if (sourceVector.size() != 0) {
-      sourceToUse = sourceVector[i];
-    }
-
-    // ignore nodes with no neighbors
-    if (!std::distance(
-            bcGraph.edge_begin(sourceToUse), bcGraph.edge_end(sourceToUse))) {
-      katana::gDebug(sourceToUse, " has no outgoing edges");
-      continue;
-    }
-
-    forwardPhaseWL.push_back(ForwardPhaseWorkItem(sourceToUse, 0));
-    NodeType& active = bcGraph.getData(sourceToUse);
-    active.initAsSource();
-    katana::gDebug("Source is ", sourceToUse);
-
-    bcExecutor.dagConstruction(forwardPhaseWL);
-    forwardPhaseWL.clear();
-
-    bcExecutor.findLeaves(backwardPhaseWL, nnodes);
-
-    double backupSrcBC = active.bc;
-    bcExecutor.dependencyBackProp(backwardPhaseWL);
-
-    active.bc = backupSrcBC;  // current source BC should not get updated
-
-    backwardPhaseWL.clear();
-
-    // break out once number of sources user specified to do (if any) has been
-    // reached
-    goodSource++;
-    if (iterLimit != 0 && goodSource >= iterLimit)
-      break;
+  for (size_t begin = 0; begin < source_vector.size(); begin += num_slots) {
+    size_t end = std::min(source_vector.size(), begin + num_slots);
+    bc_executor.Run(std::vector<Node>(
+        source_vector.begin() + begin, source_vector.begin() + end));
   }
   exec_time.stop();
 
-  katana::gInfo("Number of sources with outgoing edges was ", goodSource);
-
-  page_alloc.Report();
-
-  // sanity
-  AsynchronousSanity(bcGraph);
-
-  // prints out first 10 node BC values
-  if (!skipVerify) {
-    int count = 0;
-    for (unsigned i = 0; i < nnodes && count < 10; ++i, ++count) {
-      katana::gPrint(
-          count, ": ", std::setiosflags(std::ios::fixed), std::setprecision(6),
-          bcGraph.getData(i).bc, "\n");
-    }
-  }
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeBC>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED(
+      (katana::TypedPropertyGraph<std::tuple<NodeBC>, std::tuple<>>::Make(
+          pg, {output_property_name}, {})));
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) { graph.GetData<NodeBC>(n) = bc_executor.Centrality(n); },
+      katana::loopname("ExtractBC"), katana::no_stats());
 
-  if (output) {
-    std::cerr << "Writting out bc values...\n";
-    std::stringstream outfname;
-    outfname << "certificate"
-             << "_" << numThreads << ".txt";
-    std::string fname = outfname.str();
-    std::ofstream outfile(fname.c_str());
-    for (unsigned i = 0; i < nnodes; ++i) {
-      outfile << i << " " << std::setiosflags(std::ios::fixed)
-              << std::setprecision(9) << bcGraph.getData(i).bc << "\n";
-    }
-    outfile.close();
-  }
+  return katana::ResultSuccess();
 }
@@ -31,16 +31,15 @@ katana::analytics::BetweennessCentrality(
     const BetweennessCentralitySources& sources,
     BetweennessCentralityPlan plan) {
   switch (plan.algorithm()) {
-    //TODO (gill) Needs bidirectional graph (CSR_CSC)
-    //   case Asynchronous:
-    //     // see AsyncStructs.h
-    //     katana::gInfo("Running async BC");
-    //     doAsyncBC();
-    //     break;
+  case BetweennessCentralityPlan::kAsynchronous:
+    return BetweennessCentralityAsynchronous(
+        pg, sources, output_property_name, plan);
   case BetweennessCentralityPlan::kLevel:
     return BetweennessCentralityLevel(pg, sources, output_property_name, plan);
   case BetweennessCentralityPlan::kOuter:
     return BetweennessCentralityOuter(pg, sources, output_property_name, plan);
+  case BetweennessCentralityPlan::kApproximate:
+    return BetweennessCentralityApproximate(pg, output_property_name, plan);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
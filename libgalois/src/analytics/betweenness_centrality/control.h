@@ -0,0 +1,24 @@
+#ifndef KATANA_LIBGALOIS_ANALYTICS_BETWEENNESSCENTRALITY_CONTROL_H_
+#define KATANA_LIBGALOIS_ANALYTICS_BETWEENNESSCENTRALITY_CONTROL_H_
+
+#include <cstdint>
+#include <limits>
+
+// Compile-time settings of asynchronous betweenness centrality
+
+/// If set, a node is only pushed on the forward worklist if it is not
+/// already on it, which may help depending on the input graph
+#define BC_USE_MARKING true
+/// If not set, nodes are not locked; only for runs with one thread
+#define BC_CONCURRENT true
+/// If set, report the number of times each forward action runs
+#define BC_COUNT_ACTIONS false
+/// If set, report the number of leaves of each shortest path DAG
+#define BC_COUNT_LEAVES false
+
+/// type of the number of shortest paths
+using ShortPathType = double;
+
+constexpr static unsigned kInfinity = std::numeric_limits<uint32_t>::max();
+
+#endif
@@ -19,15 +19,24 @@
 
 #include "katana/analytics/bfs/bfs.h"
 
+#include <algorithm>
+#include <cstring>
 #include <deque>
 #include <type_traits>
 
+#include <arrow/builder.h>
+
+#include "../gpu/gpu.h"
 #include "katana/DynamicBitset.h"
 #include "katana/ErrorCode.h"
+#include "katana/MemoryBudget.h"
+#include "katana/Prefetch.h"
 #include "katana/Result.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/Planner.h"
+#include "multi_source_bfs.h"
 
 using namespace katana::analytics;
 
@@ -56,6 +65,14 @@ using BiDirGraphView = katana::TypedPropertyGraphView<
 
 constexpr unsigned kChunkSize = 256U;
 
+/// Slots of the objects that BFS takes from an AnalyticsWorkspace
+enum WorkspaceSlot : uint32_t {
+  kNodeDataSlot = 0,
+  kNodeDistSlot,
+  kFrontierSlot,
+  kNextFrontierSlot,
+};
+
 constexpr bool kTrackWork = BfsImplementation::kTrackWork;
 
 using UpdateRequest = BfsImplementation::UpdateRequest;
@@ -125,17 +142,12 @@ WlToBitset(const WL& wl, katana::DynamicBitset* bitset) {
       katana::chunk_size<kChunkSize>(), katana::loopname("WlToBitset"));
 }
 
-template <typename G, typename WL>
+template <typename WL>
 void
-BitsetToWl(const G& graph, const katana::DynamicBitset& bitset, WL* wl) {
+BitsetToWl(const katana::DynamicBitset& bitset, WL* wl) {
   wl->clear();
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        if (bitset.test(src)) {
-          wl->push(src);
-        }
-      },
+  bitset.ForEachSetBit(
+      [&](size_t src) { wl->push(static_cast<GNode>(src)); },
       katana::chunk_size<kChunkSize>(), katana::loopname("BitsetToWl"));
 }
 
@@ -143,7 +155,8 @@ template <bool CONCURRENT, typename T, typename P, typename R>
 void
 AsynchronousAlgo(
     const Graph& graph, const GNode source, katana::NUMAArray<Dist>* node_data,
-    const P& pushWrap, const R& edgeRange) {
+    const P& pushWrap, const R& edgeRange,
+    const katana::CancellationToken* cancellation) {
   namespace gwl = katana;
   using FIFO = gwl::PerSocketChunkFIFO<kChunkSize>;
   using BSWL = gwl::BulkSynchronous<gwl::PerSocketChunkLIFO<kChunkSize>>;
@@ -214,7 +227,8 @@ AsynchronousAlgo(
         }
       },
       katana::wl<WL>(), katana::loopname("runBFS"),
-      katana::disable_conflict_detection());
+      katana::disable_conflict_detection(),
+      katana::cancellation(cancellation));
 
   if (kTrackWork) {
     katana::ReportStatSingle("BFS", "bad_work", bad_work.reduce());
@@ -275,7 +289,8 @@ void
 SynchronousDirectOpt(
     const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
     const GNode source, const P& pushWrap, const uint32_t alpha,
-    const uint32_t beta) {
+    const uint32_t beta, const katana::CancellationToken* cancellation,
+    AnalyticsWorkspace* workspace) {
   using Cont = typename std::conditional<
       CONCURRENT, katana::InsertBag<GNode>, katana::SerStack<GNode>>::type;
   using Loop = typename std::conditional<
@@ -287,17 +302,29 @@ SynchronousDirectOpt(
 
   Loop loop;
 
-  katana::DynamicBitset front_bitset;
-  katana::DynamicBitset next_bitset;
-
   uint32_t num_nodes = bidir_view.num_nodes();
   uint64_t num_edges = bidir_view.num_edges();
 
-  front_bitset.resize(num_nodes);
-  next_bitset.resize(num_nodes);
-
-  auto frontier = std::make_unique<Cont>();
-  auto next_frontier = std::make_unique<Cont>();
+  katana::DynamicBitset local_front_bitset;
+  katana::DynamicBitset local_next_bitset;
+  Cont local_frontier;
+  Cont local_next_frontier;
+
+  katana::DynamicBitset* front_bitset = &local_front_bitset;
+  katana::DynamicBitset* next_bitset = &local_next_bitset;
+  Cont* frontier = &local_frontier;
+  Cont* next_frontier = &local_next_frontier;
+  if (workspace) {
+    front_bitset = workspace->Bitset(kFrontierSlot, num_nodes);
+    next_bitset = workspace->Bitset(kNextFrontierSlot, num_nodes);
+    frontier = workspace->Get<Cont>(kFrontierSlot);
+    next_frontier = workspace->Get<Cont>(kNextFrontierSlot);
+    frontier->clear();
+    next_frontier->clear();
+  } else {
+    front_bitset->resize(num_nodes);
+    next_bitset->resize(num_nodes);
+  }
 
   (*node_data)[source] = source;
 
@@ -317,11 +344,14 @@ SynchronousDirectOpt(
   katana::GAccumulator<uint64_t> writes_push;
 
   while (!next_frontier->empty()) {
+    if (cancellation && cancellation->IsCancelled()) {
+      return;
+    }
     std::swap(frontier, next_frontier);
     next_frontier->clear();
     if (scout_count > edges_to_check / alpha) {
       wl_to_bitset_timer.start();
-      WlToBitset(*frontier, &front_bitset);
+      WlToBitset(*frontier, front_bitset);
       wl_to_bitset_timer.stop();
       do {
         old_num_work_items = work_items.reduce();
@@ -332,27 +362,36 @@ SynchronousDirectOpt(
             [&](const GNode& dst) {
               GNode& ddata = (*node_data)[dst];
               if (ddata == BfsImplementation::kDistanceInfinity) {
-                for (auto e : bidir_view.in_edges(dst)) {
-                  auto src = bidir_view.in_edge_dest(e);
-
-                  if (front_bitset.test(src)) {
-                    // assign parents on the bfs path.
-                    ddata = src;
-                    next_bitset.set(dst);
-                    work_items += 1;
-                    break;
-                  }
-                }
+                const auto& front_words = front_bitset->get_vec();
+                bidir_view.ForEachInEdgePrefetched(
+                    dst,
+                    [&](auto, GNode src) {
+                      if (front_bitset->test(src)) {
+                        // assign parents on the bfs path.
+                        ddata = src;
+                        next_bitset->set(dst);
+                        work_items += 1;
+                        return false;
+                      }
+                      return true;
+                    },
+                    [&](GNode src) {
+                      katana::PrefetchForRead(&front_words[src / 64]);
+                    });
               }
             },
             katana::steal(), katana::chunk_size<kChunkSize>(),
-            katana::loopname(std::string("SyncDO-pull").c_str()));
+            katana::loopname(std::string("SyncDO-pull").c_str()),
+            katana::cancellation(cancellation));
         std::swap(front_bitset, next_bitset);
-        next_bitset.reset();
+        next_bitset->reset();
+        if (cancellation && cancellation->IsCancelled()) {
+          return;
+        }
       } while (work_items.reduce() >= old_num_work_items ||
                (work_items.reduce() > num_nodes / beta));
       bitset_to_wl_timer.start();
-      BitsetToWl(bidir_view, front_bitset, next_frontier.get());
+      BitsetToWl(*front_bitset, next_frontier);
       bitset_to_wl_timer.stop();
       scout_count = 1;
     } else {
@@ -375,7 +414,8 @@ SynchronousDirectOpt(
             }
           },
           katana::steal(), katana::chunk_size<kChunkSize>(),
-          katana::loopname(std::string("SyncDO-push").c_str()));
+          katana::loopname(std::string("SyncDO-push").c_str()),
+          katana::cancellation(cancellation));
       scout_count = work_items.reduce();
     }
   }
@@ -431,42 +471,55 @@ template <bool CONCURRENT>
 katana::Result<void>
 RunAlgo(
     BfsPlan algo, Graph* graph, const BiDirGraphView& bidir_view,
-    const GNode& source) {
+    const GNode& source, const katana::CancellationToken* cancellation,
+    AnalyticsWorkspace* workspace) {
   BfsImplementation impl{algo.edge_tile_size()};
   katana::StatTimer exec_time("BFS");
+  katana::MemoryPhase exec_memory("BFS");
 
   switch (algo.algorithm()) {
   case BfsPlan::kSynchronousDirectOpt: {
     // Set up node data
-    katana::NUMAArray<GNode> node_data;
-    node_data.allocateInterleaved(graph->num_nodes());
-    InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_data);
+    katana::NUMAArray<GNode> local_node_data;
+    katana::NUMAArray<GNode>* node_data = ArrayOrLocal(
+        workspace, kNodeDataSlot, graph->num_nodes(), &local_node_data);
+    InitNodeDataVec(BfsImplementation::kDistanceInfinity, node_data);
 
     exec_time.start();
     SynchronousDirectOpt<CONCURRENT>(
-        bidir_view, &node_data, source, NodePushWrap(), algo.alpha(),
-        algo.beta());
+        bidir_view, node_data, source, NodePushWrap(), algo.alpha(),
+        algo.beta(), cancellation, workspace);
     exec_time.stop();
+    if (cancellation && cancellation->IsCancelled()) {
+      return KATANA_ERROR(katana::ErrorCode::Cancelled, "bfs cancelled");
+    }
 
-    UpdateGraphNodeData(graph, node_data);
+    UpdateGraphNodeData(graph, *node_data);
     break;
   }
   case BfsPlan::kAsynchronous: {
-    katana::NUMAArray<GNode> node_parent;
-    katana::NUMAArray<Dist> node_dist;
-    node_parent.allocateInterleaved(graph->num_nodes());
-    node_dist.allocateInterleaved(graph->num_nodes());
+    katana::NUMAArray<GNode> local_node_parent;
+    katana::NUMAArray<Dist> local_node_dist;
+    katana::NUMAArray<GNode>* node_parent = ArrayOrLocal(
+        workspace, kNodeDataSlot, graph->num_nodes(), &local_node_parent);
+    katana::NUMAArray<Dist>* node_dist = ArrayOrLocal(
+        workspace, kNodeDistSlot, graph->num_nodes(), &local_node_dist);
 
-    InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_parent);
-    InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_dist);
+    InitNodeDataVec(BfsImplementation::kDistanceInfinity, node_parent);
+    InitNodeDataVec(BfsImplementation::kDistanceInfinity, node_dist);
 
     exec_time.start();
     AsynchronousAlgo<CONCURRENT, UpdateRequest>(
-        *graph, source, &node_dist, ReqPushWrap(), OutEdgeRangeFn{graph});
-    ComputeParentFromDistance(bidir_view, &node_parent, node_dist, source);
+        *graph, source, node_dist, ReqPushWrap(), OutEdgeRangeFn{graph},
+        cancellation);
+    if (cancellation && cancellation->IsCancelled()) {
+      exec_time.stop();
+      return KATANA_ERROR(katana::ErrorCode::Cancelled, "bfs cancelled");
+    }
+    ComputeParentFromDistance(bidir_view, node_parent, *node_dist, source);
     exec_time.stop();
 
-    UpdateGraphNodeData(graph, node_parent);
+    UpdateGraphNodeData(graph, *node_parent);
     break;
   }
   default:
@@ -481,7 +534,8 @@ RunAlgo(
 katana::Result<void>
 BfsImpl(
     Graph* graph, const BiDirGraphView& bidir_view, size_t start_node,
-    BfsPlan algo) {
+    BfsPlan algo, const katana::CancellationToken* cancellation,
+    AnalyticsWorkspace* workspace) {
   if (start_node >= graph->num_nodes()) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -501,7 +555,9 @@ BfsImpl(
   katana::EnsurePreallocated(8, approxNodeData);
   katana::ReportPageAllocGuard page_alloc;
 
-  if (auto res = RunAlgo<true>(algo, graph, bidir_view, source); !res) {
+  if (auto res = RunAlgo<true>(
+          algo, graph, bidir_view, source, cancellation, workspace);
+      !res) {
     return res.error();
   }
 
@@ -513,7 +569,16 @@ BfsImpl(
 katana::Result<void>
 katana::analytics::Bfs(
     PropertyGraph* pg, GNode start_node,
-    const std::string& output_property_name, BfsPlan algo) {
+    const std::string& output_property_name, BfsPlan algo,
+    const CancellationToken* cancellation, AnalyticsWorkspace* workspace) {
+  if (algo.architecture() == kGPU) {
+    return internal::GpuBfs(pg, start_node, output_property_name, cancellation);
+  }
+  katana::MemoryPhase memory("BfsTotal");
+  if (algo.algorithm() == BfsPlan::kAutomatic) {
+    algo = ChooseBfsPlan(pg->GetTopologyStatistics());
+  }
+
   if (auto result = ConstructNodeProperties<std::tuple<BfsNodeParent>>(
           pg, {output_property_name});
       !result) {
@@ -523,6 +588,8 @@ katana::analytics::Bfs(
   auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
   auto bidir_view =
       KATANA_CHECKED(BiDirGraphView::Make(pg, {output_property_name}, {}));
+  // the out edges are read in frontier order; the in edges are in memory
+  TopologyAccessGuard access(pg, GraphTopology::AccessPattern::kRandom);
 
   /*
   auto pg_result = Graph::Make(pg, {output_property_name}, {});
@@ -531,13 +598,47 @@ katana::analytics::Bfs(
   }
   */
 
-  return BfsImpl(&graph, bidir_view, start_node, algo);
+  return BfsImpl(
+      &graph, bidir_view, start_node, algo, cancellation, workspace);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::BfsBatch(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources, BfsPlan algo,
+    const CancellationToken* cancellation, AnalyticsWorkspace* workspace) {
+  katana::MemoryPhase memory("BfsBatch");
+  if (algo.algorithm() == BfsPlan::kAutomatic) {
+    algo = ChooseBfsPlan(pg->GetTopologyStatistics());
+  }
+  AnalyticsWorkspace local_workspace;
+  if (!workspace) {
+    workspace = &local_workspace;
+  }
+
+  TemporaryPropertyGuard parents{pg};
+  KATANA_CHECKED(
+      ConstructNodeProperties<std::tuple<BfsNodeParent>>(pg, {parents.name()}));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {parents.name()}, {}));
+  auto bidir_view =
+      KATANA_CHECKED(BiDirGraphView::Make(pg, {parents.name()}, {}));
+  TopologyAccessGuard access(pg, GraphTopology::AccessPattern::kRandom);
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (uint32_t source : sources) {
+    KATANA_CHECKED_CONTEXT(
+        BfsImpl(&graph, bidir_view, source, algo, cancellation, workspace),
+        "source {}", source);
+    columns.emplace_back(KATANA_CHECKED(CopyNodeProperty(pg, parents.name())));
+    fields.emplace_back(arrow::field(std::to_string(source), arrow::uint32()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, pg->num_nodes());
 }
 
-template <bool CONCURRENT, typename LevelVec>
+template <bool CONCURRENT, typename GraphTy, typename LevelVec>
 void
 ComputeLevels(
-    const Graph& graph, const GNode& source, LevelVec& levels) noexcept {
+    const GraphTy& graph, const GNode& source, LevelVec& levels) noexcept {
   using Cont = typename std::conditional<
       CONCURRENT, katana::InsertBag<GNode>, katana::SerStack<GNode>>::type;
   using Loop = typename std::conditional<
@@ -727,3 +828,171 @@ void
 katana::analytics::BfsStatistics::Print(std::ostream& os) const {
   os << "Number of reached nodes = " << n_reached_nodes << std::endl;
 }
+
+namespace {
+
+using TopologyGraph = katana::TypedPropertyGraph<std::tuple<>, std::tuple<>>;
+
+/// Traverse the graph from sources in batches and record the level of each
+/// node from each of them in levels, which has a row of sources.size()
+/// levels per node.
+katana::Result<void>
+MultiSourceBfsImpl(
+    const MultiSourceBfsView& view, const std::vector<uint32_t>& sources,
+    MultiSourceBfsPlan plan, katana::NUMAArray<uint16_t>* levels,
+    const katana::CancellationToken* cancellation) {
+  katana::StatTimer exec_time("MultiSourceBfs");
+  katana::MemoryPhase exec_memory("MultiSourceBfs");
+
+  size_t num_sources = sources.size();
+  auto record_levels = [&](GNode n, size_t first, uint64_t bits,
+                           uint32_t level) {
+    uint16_t* row = levels->data() + n * num_sources + first;
+    for (; bits != 0; bits &= bits - 1) {
+      row[__builtin_ctzll(bits)] = static_cast<uint16_t>(level);
+    }
+  };
+
+  exec_time.start();
+  auto res = RunMultiSourceBfs(
+      view, sources, plan.batch_size(), plan.alpha(),
+      kMultiSourceBfsUnreachable, record_levels, cancellation);
+  exec_time.stop();
+
+  return res;
+}
+
+/// \returns a table with one column of fixed size binary values that hold
+/// the row of levels of each node
+katana::Result<std::shared_ptr<arrow::Table>>
+MakeLevelsTable(
+    const katana::NUMAArray<uint16_t>& levels, size_t num_nodes,
+    size_t num_sources, const std::string& name) {
+  auto type_result =
+      arrow::FixedSizeBinaryType::Make(sizeof(uint16_t) * num_sources);
+  if (!type_result.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "failed to make fixed size type: {}",
+        type_result.status());
+  }
+  auto type = type_result.ValueOrDie();
+
+  arrow::FixedSizeBinaryBuilder builder(type);
+  if (auto res = builder.AppendValues(
+          reinterpret_cast<const uint8_t*>(levels.data()), num_nodes);
+      !res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "failed to append values {}", res);
+  }
+  std::shared_ptr<arrow::Array> array;
+  if (auto res = builder.Finish(&array); !res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "failed to construct arrow array {}",
+        res);
+  }
+
+  return katana::Result<std::shared_ptr<arrow::Table>>(
+      arrow::Table::Make(arrow::schema({arrow::field(name, type)}), {array}));
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& output_property_name, MultiSourceBfsPlan plan,
+    const CancellationToken* cancellation) {
+  katana::MemoryPhase memory("MultiSourceBfsTotal");
+
+  if (sources.empty()) {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "no sources");
+  }
+  for (auto source : sources) {
+    if (source >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
+    }
+  }
+  if (plan.alpha() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "alpha must be positive");
+  }
+
+  auto view = KATANA_CHECKED(MultiSourceBfsView::Make(pg, {}, {}));
+
+  katana::NUMAArray<uint16_t> levels;
+  levels.allocateInterleaved(view.num_nodes() * sources.size());
+  katana::ParallelSTL::fill(
+      levels.begin(), levels.end(), kMultiSourceBfsUnreachable);
+
+  KATANA_CHECKED(
+      MultiSourceBfsImpl(view, sources, plan, &levels, cancellation));
+
+  auto table = KATANA_CHECKED(MakeLevelsTable(
+      levels, view.num_nodes(), sources.size(), output_property_name));
+  return pg->AddNodeProperties(table);
+}
+
+katana::Result<void>
+katana::analytics::MultiSourceBfsAssertValid(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& property_name) {
+  auto graph = KATANA_CHECKED(TopologyGraph::Make(pg, {}, {}));
+
+  auto property = pg->GetNodeProperty(property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "no property {}", property_name);
+  }
+  if (property->num_chunks() != 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "property {} has {} chunks, expected 1", property_name,
+        property->num_chunks());
+  }
+  auto array = std::dynamic_pointer_cast<arrow::FixedSizeBinaryArray>(
+      property->chunk(0));
+  size_t row_size = sizeof(uint16_t) * sources.size();
+  if (!array || size_t(array->byte_width()) != row_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "property {} does not hold the levels of {} sources", property_name,
+        sources.size());
+  }
+
+  katana::NUMAArray<Dist> expected;
+  expected.allocateInterleaved(graph.num_nodes());
+
+  for (size_t i = 0; i < sources.size(); ++i) {
+    katana::ParallelSTL::fill(
+        expected.begin(), expected.end(), BfsImplementation::kDistanceInfinity);
+    ComputeLevels<true>(graph, sources[i], expected);
+
+    bool found_node_with_wrong_level = false;
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          uint16_t level;
+          std::memcpy(
+              &level, array->GetValue(n) + i * sizeof(uint16_t),
+              sizeof(level));
+          Dist want = expected[n] == BfsImplementation::kDistanceInfinity
+                          ? Dist{kMultiSourceBfsUnreachable}
+                          : expected[n];
+          if (level != want) {
+            found_node_with_wrong_level = true;
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    if (found_node_with_wrong_level) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "Found a node with wrong level from source {}", sources[i]);
+    }
+  }
+
+  return katana::ResultSuccess();
+}
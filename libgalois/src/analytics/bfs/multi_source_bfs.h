@@ -0,0 +1,261 @@
+#ifndef KATANA_LIBGALOIS_ANALYTICS_BFS_MULTISOURCEBFS_H_
+#define KATANA_LIBGALOIS_ANALYTICS_BFS_MULTISOURCEBFS_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Cancellation.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/TypedPropertyGraph.h"
+
+namespace katana::analytics {
+
+/// The graph traversed by the multi-source BFS engine: the pull rounds need
+/// the in-edges of each node.
+using MultiSourceBfsView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::BiDirectional, std::tuple<>, std::tuple<>>;
+
+/// The sources of a batch as one bit per source, following MS-BFS (Then et
+/// al., VLDB 2014). Operations are loops over the words, which the compiler
+/// vectorizes.
+template <size_t kWords>
+struct MultiSourceBfsSourceSet {
+  std::array<uint64_t, kWords> words;
+
+  void Clear() { words.fill(0); }
+
+  void Set(size_t i) { words[i / 64] |= uint64_t{1} << (i % 64); }
+
+  bool Any() const {
+    uint64_t any = 0;
+    for (size_t w = 0; w < kWords; ++w) {
+      any |= words[w];
+    }
+    return any != 0;
+  }
+
+  /// \returns true if this and other together hold every bit of all
+  bool Covers(
+      const MultiSourceBfsSourceSet& other,
+      const MultiSourceBfsSourceSet& all) const {
+    uint64_t missing = 0;
+    for (size_t w = 0; w < kWords; ++w) {
+      missing |= all.words[w] & ~(words[w] | other.words[w]);
+    }
+    return missing == 0;
+  }
+};
+
+/// The per-node source sets of a traversal, allocated once and reused by
+/// every batch
+template <size_t kWords>
+struct MultiSourceBfsState {
+  using Sources = MultiSourceBfsSourceSet<kWords>;
+
+  katana::NUMAArray<Sources> seen;
+  katana::NUMAArray<Sources> visit;
+  katana::NUMAArray<Sources> visit_next;
+
+  explicit MultiSourceBfsState(size_t num_nodes) {
+    seen.allocateInterleaved(num_nodes);
+    visit.allocateInterleaved(num_nodes);
+    visit_next.allocateInterleaved(num_nodes);
+  }
+};
+
+constexpr unsigned kMultiSourceBfsChunkSize = 256U;
+
+/// Traverse the graph from sources[batch_begin, batch_end) together.
+///
+/// Each round either pushes the frontier bits of a node along its out-edges
+/// or pulls the frontier bits of the in-neighbors of each node that some
+/// source has yet to reach, using the direction optimization of
+/// SynchronousDirectOpt.
+///
+/// When node n is reached by some sources at level l, visit(n, first, bits,
+/// l) is called once for each word of the sources: bit b of bits stands for
+/// sources[first + b]. The sources themselves are visited at level 0. The
+/// calls for a node are made by one thread, one level after the other.
+/// Traversal fails once it gets to level_limit.
+template <size_t kWords, typename Visit>
+katana::Result<void>
+MultiSourceBfsBatch(
+    const MultiSourceBfsView& view, const std::vector<uint32_t>& sources,
+    size_t batch_begin, size_t batch_end, uint32_t alpha,
+    uint32_t level_limit, MultiSourceBfsState<kWords>* state,
+    const Visit& visit, const katana::CancellationToken* cancellation) {
+  using Sources = MultiSourceBfsSourceSet<kWords>;
+  using Node = MultiSourceBfsView::Node;
+
+  size_t num_nodes = view.num_nodes();
+  size_t batch_size = batch_end - batch_begin;
+  KATANA_LOG_DEBUG_ASSERT(batch_size <= kWords * 64);
+
+  auto& seen = state->seen;
+  auto& visit_cur = state->visit;
+  auto& visit_next = state->visit_next;
+
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        seen[n].Clear();
+        visit_cur[n].Clear();
+        visit_next[n].Clear();
+      },
+      katana::no_stats());
+
+  Sources all;
+  all.Clear();
+  int64_t scout_count = 0;
+  for (size_t i = 0; i < batch_size; ++i) {
+    Node source = sources[batch_begin + i];
+    all.Set(i);
+    seen[source].Set(i);
+    visit_cur[source].Set(i);
+    visit(
+        source, batch_begin + i - i % 64, uint64_t{1} << (i % 64),
+        uint32_t{0});
+    scout_count += view.degree(source);
+  }
+
+  int64_t edges_to_check = view.num_edges();
+  uint64_t frontier_size = batch_size;
+
+  for (uint32_t level = 1; frontier_size > 0; ++level) {
+    if (cancellation && cancellation->IsCancelled()) {
+      return KATANA_ERROR(katana::ErrorCode::Cancelled, "bfs cancelled");
+    }
+    if (level == level_limit) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotImplemented,
+          "levels of {} or more do not fit in the output", level);
+    }
+
+    if (scout_count > edges_to_check / alpha) {
+      katana::do_all(
+          katana::iterate(view),
+          [&](const Node& dst) {
+            Sources& next = visit_next[dst];
+            const Sources& dst_seen = seen[dst];
+            if (dst_seen.Covers(next, all)) {
+              return;
+            }
+            for (auto e : view.in_edges(dst)) {
+              const Sources& src_visit = visit_cur[view.in_edge_dest(e)];
+              for (size_t w = 0; w < kWords; ++w) {
+                next.words[w] |= src_visit.words[w];
+              }
+              if (dst_seen.Covers(next, all)) {
+                break;
+              }
+            }
+          },
+          katana::steal(), katana::chunk_size<kMultiSourceBfsChunkSize>(),
+          katana::loopname("MultiSourceBfs-pull"),
+          katana::cancellation(cancellation));
+    } else {
+      edges_to_check -= scout_count;
+      katana::do_all(
+          katana::iterate(view),
+          [&](const Node& src) {
+            const Sources& src_visit = visit_cur[src];
+            if (!src_visit.Any()) {
+              return;
+            }
+            for (auto e : view.edges(src)) {
+              auto dst = view.edge_dest(e);
+              for (size_t w = 0; w < kWords; ++w) {
+                uint64_t bits = src_visit.words[w] & ~seen[dst].words[w];
+                uint64_t* next = &visit_next[dst].words[w];
+                if ((bits & ~__atomic_load_n(next, __ATOMIC_RELAXED)) != 0) {
+                  __atomic_fetch_or(next, bits, __ATOMIC_RELAXED);
+                }
+              }
+            }
+          },
+          katana::steal(), katana::chunk_size<kMultiSourceBfsChunkSize>(),
+          katana::loopname("MultiSourceBfs-push"),
+          katana::cancellation(cancellation));
+    }
+
+    katana::GAccumulator<uint64_t> num_visited;
+    katana::GAccumulator<int64_t> degrees;
+    katana::do_all(
+        katana::iterate(view),
+        [&](const Node& n) {
+          Sources& n_seen = seen[n];
+          Sources& n_visit = visit_cur[n];
+          Sources& n_next = visit_next[n];
+          bool visited = false;
+          for (size_t w = 0; w < kWords; ++w) {
+            uint64_t bits = n_next.words[w] & ~n_seen.words[w];
+            n_seen.words[w] |= bits;
+            n_visit.words[w] = bits;
+            n_next.words[w] = 0;
+            if (bits != 0) {
+              visited = true;
+              visit(n, batch_begin + w * 64, bits, level);
+            }
+          }
+          if (visited) {
+            num_visited += 1;
+            degrees += view.degree(n);
+          }
+        },
+        katana::steal(), katana::chunk_size<kMultiSourceBfsChunkSize>(),
+        katana::loopname("MultiSourceBfs-update"));
+
+    frontier_size = num_visited.reduce();
+    scout_count = degrees.reduce();
+  }
+
+  return katana::ResultSuccess();
+}
+
+/// Traverse the graph from all of sources, batch_size (64, 256 or 512) at a
+/// time, calling visit as MultiSourceBfsBatch does. The source sets are
+/// allocated once for all the batches.
+template <typename Visit>
+katana::Result<void>
+RunMultiSourceBfs(
+    const MultiSourceBfsView& view, const std::vector<uint32_t>& sources,
+    uint32_t batch_size, uint32_t alpha, uint32_t level_limit,
+    const Visit& visit, const katana::CancellationToken* cancellation) {
+  auto run_batches = [&](auto words) -> katana::Result<void> {
+    constexpr size_t kWords = decltype(words)::value;
+    MultiSourceBfsState<kWords> state(view.num_nodes());
+    for (size_t begin = 0; begin < sources.size(); begin += batch_size) {
+      size_t end = std::min<size_t>(begin + batch_size, sources.size());
+      KATANA_CHECKED(MultiSourceBfsBatch<kWords>(
+          view, sources, begin, end, alpha, level_limit, &state, visit,
+          cancellation));
+    }
+    return katana::ResultSuccess();
+  };
+
+  switch (batch_size) {
+  case 64:
+    return run_batches(std::integral_constant<size_t, 1>{});
+  case 256:
+    return run_batches(std::integral_constant<size_t, 4>{});
+  case 512:
+    return run_batches(std::integral_constant<size_t, 8>{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unsupported batch size {}",
+        batch_size);
+  }
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,536 @@
+#include "katana/analytics/biconnected_components/biconnected_components.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/UnionFind.h"
+#include "katana/analytics/Frontier.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+struct EdgeComponent : public katana::PODProperty<uint64_t> {};
+struct NodeArticulationPoint : public katana::PODProperty<uint8_t> {};
+
+using BiconnectedGraph = katana::TypedPropertyGraph<
+    std::tuple<NodeArticulationPoint>, std::tuple<EdgeComponent>>;
+
+constexpr Node kNoNode = std::numeric_limits<Node>::max();
+
+struct BiconnectivityNode : public katana::UnionFindNode<BiconnectivityNode> {
+  BiconnectivityNode() : katana::UnionFindNode<BiconnectivityNode>(this) {}
+};
+
+/// Finds the biconnected components of a symmetric topology from a spanning
+/// forest: every tree edge (parent, node) is named by node, and the component
+/// of the tree edge into each node is found. A non-tree edge is in the
+/// component of the tree edge into its end that comes later in the preorder
+/// of the forest (Tarjan and Vishkin), which needs no search for the edge.
+class Biconnectivity {
+public:
+  explicit Biconnectivity(const katana::GraphTopology& topology)
+      : topology_(topology), num_nodes_(topology.num_nodes()) {
+    order_.allocateBlocked(num_nodes_);
+    tree_components_.allocateBlocked(num_nodes_);
+  }
+
+  void TarjanVishkin() {
+    katana::NUMAArray<BiconnectivityNode> sets;
+    ResetSets(&sets);
+
+    // The smallest node of each connected component is the root of its tree
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) {
+          for (auto e : topology_.edges(u)) {
+            Node w = topology_.edge_dest(e);
+            if (u < w) {
+              sets[u].merge(&sets[w]);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("BiconnectedComponents-Roots"));
+
+    katana::NUMAArray<std::atomic<Node>> parents;
+    parents.allocateBlocked(num_nodes_);
+    auto current = std::make_unique<katana::analytics::Frontier>(num_nodes_);
+    auto next = std::make_unique<katana::analytics::Frontier>(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) {
+          if (sets[u].isRep()) {
+            parents[u].store(u, std::memory_order_relaxed);
+            next->Add(u);
+          } else {
+            parents[u].store(kNoNode, std::memory_order_relaxed);
+          }
+        },
+        katana::no_stats());
+    auto parent = [&](Node u) {
+      return parents[u].load(std::memory_order_relaxed);
+    };
+
+    // A breadth-first forest, level by level. Its non-tree edges join nodes
+    // of the same or adjacent levels, so neither end is an ancestor of the
+    // other.
+    std::vector<std::unique_ptr<katana::InsertBag<Node>>> levels;
+    while (!next->empty()) {
+      auto level = std::make_unique<katana::InsertBag<Node>>();
+      next->ForEach([&](Node u) { level->push(u); }, katana::no_stats());
+      levels.emplace_back(std::move(level));
+      std::swap(current, next);
+      EdgeMap(
+          topology_, topology_, current.get(), next.get(),
+          [&](Node src, Node dst) {
+            Node expected = kNoNode;
+            return parents[dst].compare_exchange_strong(
+                expected, src, std::memory_order_relaxed);
+          },
+          [&](Node dst) { return parent(dst) == kNoNode; },
+          "BiconnectedComponents-Forest");
+    }
+    katana::ReportStatSingle(
+        "BiconnectedComponents", "ForestLevels", levels.size());
+
+    // Subtree sizes, from the deepest level up
+    katana::NUMAArray<std::atomic<uint32_t>> sizes;
+    sizes.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) { sizes[u].store(1, std::memory_order_relaxed); },
+        katana::no_stats());
+    for (size_t l = levels.size(); l-- > 1;) {
+      katana::do_all(
+          katana::iterate(*levels[l]),
+          [&](Node u) {
+            sizes[parent(u)].fetch_add(
+                sizes[u].load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+          },
+          katana::no_stats());
+    }
+    auto size = [&](Node u) {
+      return sizes[u].load(std::memory_order_relaxed);
+    };
+
+    // Preorder numbers, from the roots down: the children of a node take
+    // consecutive ranges after it, in whichever order they get there
+    katana::NUMAArray<std::atomic<uint32_t>> next_orders;
+    next_orders.allocateBlocked(num_nodes_);
+    std::atomic<uint32_t> next_root_order{0};
+    for (size_t l = 0; l < levels.size(); ++l) {
+      katana::do_all(
+          katana::iterate(*levels[l]),
+          [&](Node u) {
+            std::atomic<uint32_t>& next_order =
+                l == 0 ? next_root_order : next_orders[parent(u)];
+            order_[u] =
+                next_order.fetch_add(size(u), std::memory_order_relaxed);
+            next_orders[u].store(order_[u] + 1, std::memory_order_relaxed);
+          },
+          katana::no_stats());
+    }
+
+    // The lowest and highest preorder number adjacent to each subtree
+    katana::NUMAArray<std::atomic<uint32_t>> lows;
+    katana::NUMAArray<std::atomic<uint32_t>> highs;
+    lows.allocateBlocked(num_nodes_);
+    highs.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) {
+          uint32_t low = order_[u];
+          uint32_t high = order_[u];
+          for (auto e : topology_.edges(u)) {
+            uint32_t order = order_[topology_.edge_dest(e)];
+            low = std::min(low, order);
+            high = std::max(high, order);
+          }
+          lows[u].store(low, std::memory_order_relaxed);
+          highs[u].store(high, std::memory_order_relaxed);
+        },
+        katana::steal(), katana::no_stats());
+    for (size_t l = levels.size(); l-- > 1;) {
+      katana::do_all(
+          katana::iterate(*levels[l]),
+          [&](Node u) {
+            katana::atomicMin(
+                lows[parent(u)], lows[u].load(std::memory_order_relaxed));
+            katana::atomicMax(
+                highs[parent(u)], highs[u].load(std::memory_order_relaxed));
+          },
+          katana::no_stats());
+    }
+
+    // The tree edge into u and the one into its parent p are in the same
+    // component if the subtree of u reaches out of the subtree of p, and the
+    // tree edges into the ends of a non-tree edge are
+    ResetSets(&sets);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) {
+          Node p = parent(u);
+          if (p != u && parent(p) != p &&
+              (lows[u].load(std::memory_order_relaxed) < order_[p] ||
+               highs[u].load(std::memory_order_relaxed) >=
+                   order_[p] + size(p))) {
+            sets[u].merge(&sets[p]);
+          }
+          for (auto e : topology_.edges(u)) {
+            Node w = topology_.edge_dest(e);
+            if (u < w && parent(w) != u && p != w) {
+              sets[u].merge(&sets[w]);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("BiconnectedComponents-Merge"));
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) {
+          tree_components_[u] =
+              parent(u) == u ? kNoNode : sets[u].findAndCompress() - &sets[0];
+        },
+        katana::no_stats());
+  }
+
+  /// A depth first search with a stack of the nodes whose tree edge has no
+  /// component yet (Hopcroft and Tarjan)
+  void Serial() {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) { order_[u] = kNoNode; }, katana::no_stats());
+    std::vector<uint32_t> low(num_nodes_);
+    std::vector<Node> parent(num_nodes_);
+    std::vector<Node> stack;
+
+    // The edges left to visit of each node on the path; a node skips one
+    // edge back to its parent, the tree edge itself
+    struct Frame {
+      Node node;
+      Edge next;
+      Edge end;
+      bool skipped_parent;
+    };
+    std::vector<Frame> frames;
+    uint32_t next_order = 0;
+    auto visit = [&](Node u, Node p) {
+      order_[u] = next_order;
+      low[u] = next_order;
+      next_order += 1;
+      parent[u] = p;
+      auto edges = topology_.edges(u);
+      frames.push_back(Frame{u, *edges.begin(), *edges.end(), u == p});
+    };
+
+    for (uint64_t root = 0; root < num_nodes_; ++root) {
+      if (order_[root] != kNoNode) {
+        continue;
+      }
+      tree_components_[root] = kNoNode;
+      visit(root, root);
+      while (!frames.empty()) {
+        Frame& frame = frames.back();
+        if (frame.next != frame.end) {
+          Node w = topology_.edge_dest(frame.next);
+          frame.next += 1;
+          if (w == frame.node) {
+            continue;
+          }
+          if (w == parent[frame.node] && !frame.skipped_parent) {
+            frame.skipped_parent = true;
+            continue;
+          }
+          if (order_[w] == kNoNode) {
+            stack.push_back(w);
+            visit(w, frame.node);
+          } else {
+            low[frame.node] = std::min(low[frame.node], order_[w]);
+          }
+          continue;
+        }
+
+        Node u = frame.node;
+        frames.pop_back();
+        if (frames.empty()) {
+          continue;
+        }
+        Node p = parent[u];
+        low[p] = std::min(low[p], low[u]);
+        if (low[u] >= order_[p]) {
+          // The tree edge into u closes a component with the tree edges into
+          // the nodes found after u
+          Node member = kNoNode;
+          do {
+            member = stack.back();
+            stack.pop_back();
+            tree_components_[member] = u;
+          } while (member != u);
+        }
+      }
+    }
+  }
+
+  /// Labels the edges with their components, the smallest edge of each, and
+  /// marks the nodes with edges in more than one component
+  void Finish(
+      katana::NUMAArray<uint64_t>* edge_components,
+      katana::NUMAArray<uint8_t>* articulation_points) const {
+    edge_components->allocateBlocked(topology_.num_edges());
+    articulation_points->allocateBlocked(num_nodes_);
+    katana::NUMAArray<std::atomic<uint64_t>> smallest;
+    smallest.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) {
+          smallest[u].store(
+              kNoBiconnectedComponent, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) {
+          for (auto e : topology_.edges(u)) {
+            Node w = topology_.edge_dest(e);
+            if (w == u) {
+              (*edge_components)[e] = kNoBiconnectedComponent;
+              continue;
+            }
+            Node later = order_[u] > order_[w] ? u : w;
+            Node tree_component = tree_components_[later];
+            (*edge_components)[e] = tree_component;
+            katana::atomicMin(smallest[tree_component], uint64_t{e});
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) {
+          uint64_t first = kNoBiconnectedComponent;
+          bool is_articulation_point = false;
+          for (auto e : topology_.edges(u)) {
+            uint64_t& component = (*edge_components)[e];
+            if (component == kNoBiconnectedComponent) {
+              continue;
+            }
+            component = smallest[component].load(std::memory_order_relaxed);
+            if (first == kNoBiconnectedComponent) {
+              first = component;
+            } else if (component != first) {
+              is_articulation_point = true;
+            }
+          }
+          (*articulation_points)[u] = is_articulation_point;
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+private:
+  void ResetSets(katana::NUMAArray<BiconnectivityNode>* sets) const {
+    if (sets->size() != num_nodes_) {
+      sets->allocateBlocked(num_nodes_);
+    }
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) { sets->constructAt(u); }, katana::no_stats());
+  }
+
+  const katana::GraphTopology& topology_;
+  uint64_t num_nodes_;
+  /// The preorder number of each node in the forest
+  katana::NUMAArray<uint32_t> order_;
+  /// The component of the tree edge into each node, named by a node whose
+  /// tree edge is in it, or kNoNode for the roots
+  katana::NUMAArray<Node> tree_components_;
+};
+
+void
+RunBiconnectivity(
+    const katana::GraphTopology& topology, BiconnectedComponentsPlan plan,
+    katana::NUMAArray<uint64_t>* edge_components,
+    katana::NUMAArray<uint8_t>* articulation_points) {
+  Biconnectivity biconnectivity(topology);
+  if (plan.algorithm() == BiconnectedComponentsPlan::kSerial) {
+    biconnectivity.Serial();
+  } else {
+    biconnectivity.TarjanVishkin();
+  }
+  biconnectivity.Finish(edge_components, articulation_points);
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::BiconnectedComponents(
+    PropertyGraph* pg, const std::string& edge_component_property_name,
+    const std::string& articulation_point_property_name,
+    BiconnectedComponentsPlan plan) {
+  if (plan.algorithm() != BiconnectedComponentsPlan::kTarjanVishkin &&
+      plan.algorithm() != BiconnectedComponentsPlan::kSerial) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  katana::NUMAArray<uint64_t> edge_components;
+  katana::NUMAArray<uint8_t> articulation_points;
+  katana::StatTimer exec_time("BiconnectedComponents");
+  exec_time.start();
+  RunBiconnectivity(
+      pg->topology(), plan, &edge_components, &articulation_points);
+  exec_time.stop();
+
+  KATANA_CHECKED(ConstructEdgeProperties<std::tuple<EdgeComponent>>(
+      pg, {edge_component_property_name}));
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeArticulationPoint>>(
+      pg, {articulation_point_property_name}));
+  auto graph = KATANA_CHECKED(BiconnectedGraph::Make(
+      pg, {articulation_point_property_name}, {edge_component_property_name}));
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_edges()),
+      [&](uint64_t e) {
+        graph.GetEdgeData<EdgeComponent>(e) = edge_components[e];
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const BiconnectedGraph::Node& n) {
+        graph.GetData<NodeArticulationPoint>(n) = articulation_points[n];
+      },
+      katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::BiconnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& edge_component_property_name,
+    const std::string& articulation_point_property_name) {
+  auto graph = KATANA_CHECKED(BiconnectedGraph::Make(
+      pg, {articulation_point_property_name}, {edge_component_property_name}));
+
+  katana::NUMAArray<uint64_t> edge_components;
+  katana::NUMAArray<uint8_t> articulation_points;
+  RunBiconnectivity(
+      pg->topology(), BiconnectedComponentsPlan::Serial(), &edge_components,
+      &articulation_points);
+
+  katana::GReduceMin<uint64_t> bad_edge;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_edges()),
+      [&](uint64_t e) {
+        if (graph.GetEdgeData<EdgeComponent>(e) != edge_components[e]) {
+          bad_edge.update(e);
+        }
+      },
+      katana::no_stats());
+  if (uint64_t e = bad_edge.reduce(); e < graph.num_edges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "edge {} is in component {} rather than {}", e,
+        graph.GetEdgeData<EdgeComponent>(e), edge_components[e]);
+  }
+
+  katana::GReduceMin<uint64_t> bad_node;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const BiconnectedGraph::Node& n) {
+        if ((graph.GetData<NodeArticulationPoint>(n) != 0) !=
+            (articulation_points[n] != 0)) {
+          bad_node.update(n);
+        }
+      },
+      katana::no_stats());
+  if (uint64_t n = bad_node.reduce(); n < graph.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "node {} is wrongly marked as {}an articulation point", n,
+        articulation_points[n] ? "not " : "");
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<BiconnectedComponentsStatistics>
+katana::analytics::BiconnectedComponentsStatistics::Compute(
+    PropertyGraph* pg, const std::string& edge_component_property_name,
+    const std::string& articulation_point_property_name) {
+  auto graph = KATANA_CHECKED(BiconnectedGraph::Make(
+      pg, {articulation_point_property_name}, {edge_component_property_name}));
+
+  katana::GAccumulator<uint64_t> num_articulation_points;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const BiconnectedGraph::Node& n) {
+        if (graph.GetData<NodeArticulationPoint>(n)) {
+          num_articulation_points += 1;
+        }
+      },
+      katana::no_stats());
+
+  // The number of edges of each component, both directions counted
+  using Sizes = std::unordered_map<uint64_t, uint64_t>;
+  katana::PerThreadStorage<Sizes> per_thread_sizes;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_edges()),
+      [&](uint64_t e) {
+        uint64_t component = graph.GetEdgeData<EdgeComponent>(e);
+        if (component != kNoBiconnectedComponent) {
+          (*per_thread_sizes.getLocal())[component] += 1;
+        }
+      },
+      katana::no_stats());
+  Sizes sizes;
+  for (unsigned i = 0; i < per_thread_sizes.size(); ++i) {
+    for (const auto& [component, size] : *per_thread_sizes.getRemote(i)) {
+      sizes[component] += size;
+    }
+  }
+
+  uint64_t num_bridges = 0;
+  uint64_t largest = 0;
+  for (const auto& [component, size] : sizes) {
+    if (size == 2) {
+      num_bridges += 1;
+    }
+    largest = std::max(largest, size);
+  }
+
+  return BiconnectedComponentsStatistics{
+      sizes.size(), num_articulation_points.reduce(), num_bridges,
+      largest / 2};
+}
+
+void
+katana::analytics::BiconnectedComponentsStatistics::Print(
+    std::ostream& os) const {
+  os << "Total number of components = " << total_components << std::endl;
+  os << "Number of articulation points = " << num_articulation_points
+     << std::endl;
+  os << "Number of bridges = " << num_bridges << std::endl;
+  os << "Number of edges in the largest component = "
+     << largest_component_edges << std::endl;
+}
@@ -0,0 +1,668 @@
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+#include <arrow/api.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using Node = BiDirView::Node;
+
+struct NodeMatch : public katana::PODProperty<uint32_t> {};
+
+using MatchGraph =
+    katana::TypedPropertyGraph<std::tuple<NodeMatch>, std::tuple<>>;
+
+constexpr uint32_t kUnmatched = kBipartiteMatchingUnmatched;
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+/// Set is_left from the values of a boolean or integer node property
+template <typename ArrowType>
+void
+ReadSideProperty(
+    const arrow::ChunkedArray& property,
+    katana::NUMAArray<uint8_t>* is_left) {
+  using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+  uint64_t offset = 0;
+  for (const auto& chunk : property.chunks()) {
+    const auto& array = static_cast<const ArrayType&>(*chunk);
+    katana::do_all(
+        katana::iterate(int64_t{0}, array.length()),
+        [&](int64_t i) { (*is_left)[offset + i] = array.Value(i) != 0; },
+        katana::no_stats());
+    offset += array.length();
+  }
+}
+
+/// \returns 1 for the nodes on the left side of side and 0 for the others
+katana::Result<katana::NUMAArray<uint8_t>>
+ReadSides(katana::PropertyGraph* pg, const BipartiteSide& side) {
+  katana::NUMAArray<uint8_t> is_left;
+  is_left.allocateBlocked(pg->num_nodes());
+
+  if (side.kind() == BipartiteSide::kNodeType) {
+    if (!pg->HasAtomicNodeType(side.name())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "no node type {}", side.name());
+    }
+    auto type = pg->GetNodeEntityTypeID(side.name());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, pg->num_nodes()),
+        [&](Node n) { is_left[n] = pg->DoesNodeHaveType(n, type); },
+        katana::no_stats());
+    return is_left;
+  }
+
+  if (side.kind() != BipartiteSide::kNodeProperty) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown kind of side");
+  }
+  auto property = pg->GetNodeProperty(side.name());
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no node property {}",
+        side.name());
+  }
+  if (property->null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the side property may not be null");
+  }
+  switch (property->type()->id()) {
+  case arrow::BooleanType::type_id:
+    ReadSideProperty<arrow::BooleanType>(*property, &is_left);
+    break;
+  case arrow::UInt8Type::type_id:
+    ReadSideProperty<arrow::UInt8Type>(*property, &is_left);
+    break;
+  case arrow::Int8Type::type_id:
+    ReadSideProperty<arrow::Int8Type>(*property, &is_left);
+    break;
+  case arrow::UInt32Type::type_id:
+    ReadSideProperty<arrow::UInt32Type>(*property, &is_left);
+    break;
+  case arrow::Int32Type::type_id:
+    ReadSideProperty<arrow::Int32Type>(*property, &is_left);
+    break;
+  case arrow::UInt64Type::type_id:
+    ReadSideProperty<arrow::UInt64Type>(*property, &is_left);
+    break;
+  case arrow::Int64Type::type_id:
+    ReadSideProperty<arrow::Int64Type>(*property, &is_left);
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported side property type {}",
+        property->type()->ToString());
+  }
+  return is_left;
+}
+
+/// A matching of the bipartite graph formed by the edges of a graph between
+/// its two sides, taken as undirected. The neighbors of each node across
+/// the sides are gathered into arcs, and the mate of every node is kept.
+///
+/// dist_ holds the layer of each left node in the breadth-first searches of
+/// Hopcroft-Karp, and in push-relabel the label of each right node: a lower
+/// bound on its distance to an unmatched right node, alternating between
+/// unmatched and matched edges.
+class Matcher {
+public:
+  Matcher(const BiDirView& view, katana::NUMAArray<uint8_t> is_left)
+      : num_nodes_(view.num_nodes()), is_left_(std::move(is_left)) {
+    arc_begin_.allocateBlocked(num_nodes_ + 1);
+    arc_begin_[0] = 0;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          uint64_t count = 0;
+          for (auto e : view.edges(n)) {
+            count += is_left_[view.edge_dest(e)] != is_left_[n];
+          }
+          for (auto e : view.in_edges(n)) {
+            count += is_left_[view.in_edge_dest(e)] != is_left_[n];
+          }
+          arc_begin_[n + 1] = count;
+        },
+        katana::steal(), katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        arc_begin_.begin(), arc_begin_.end(), arc_begin_.begin());
+
+    arc_dest_.allocateBlocked(arc_begin_[num_nodes_]);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          uint64_t arc = arc_begin_[n];
+          for (auto e : view.edges(n)) {
+            Node dest = view.edge_dest(e);
+            if (is_left_[dest] != is_left_[n]) {
+              arc_dest_[arc++] = dest;
+            }
+          }
+          for (auto e : view.in_edges(n)) {
+            Node dest = view.in_edge_dest(e);
+            if (is_left_[dest] != is_left_[n]) {
+              arc_dest_[arc++] = dest;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    mate_.allocateBlocked(num_nodes_);
+    dist_.allocateBlocked(num_nodes_);
+    claim_.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          mate_.constructAt(n, kUnmatched);
+          dist_.constructAt(n, kUnreached);
+          claim_.constructAt(n, 0);
+        },
+        katana::no_stats());
+  }
+
+  bool is_left(Node n) const { return is_left_[n]; }
+  uint32_t mate(Node n) const {
+    return mate_[n].load(std::memory_order_relaxed);
+  }
+  void set_mate(Node n, uint32_t m) {
+    mate_[n].store(m, std::memory_order_relaxed);
+  }
+
+  /// Match each left node to the first unmatched right neighbor it finds
+  void MatchGreedily() {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node u) {
+          if (!is_left_[u]) {
+            return;
+          }
+          for (uint64_t arc = arc_begin_[u]; arc < arc_begin_[u + 1]; ++arc) {
+            Node r = arc_dest_[arc];
+            uint32_t expected = kUnmatched;
+            if (mate(r) == kUnmatched &&
+                mate_[r].compare_exchange_strong(
+                    expected, u, std::memory_order_relaxed)) {
+              set_mate(u, r);
+              return;
+            }
+          }
+        },
+        katana::steal(), katana::loopname("BipartiteMatchingGreedy"));
+  }
+
+  /// Augment the matching with Hopcroft-Karp phases until it is maximum
+  void HopcroftKarp() {
+    for (;;) {
+      uint32_t length = ShortestAugmentingPathLayer();
+      if (length == kUnreached) {
+        return;
+      }
+      // Concurrent searches can block each other's only paths; a phase
+      // without any augmentation is redone serially, which always finds one
+      if (Augment(length, true) == 0) {
+        Augment(length, false);
+      }
+    }
+  }
+
+  /// Augment the matching by push-relabel, and then Hopcroft-Karp phases
+  void PushRelabel(uint64_t global_relabel_interval) {
+    if (global_relabel_interval == 0) {
+      global_relabel_interval = num_nodes_ + arc_begin_[num_nodes_];
+    }
+
+    katana::InsertBag<Node> active;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          if (is_left_[n] && mate(n) == kUnmatched &&
+              arc_begin_[n] != arc_begin_[n + 1]) {
+            active.push(n);
+          }
+        },
+        katana::no_stats());
+
+    while (!active.empty()) {
+      GlobalRelabel();
+      std::atomic<uint64_t> work{0};
+      katana::InsertBag<Node> next;
+      katana::do_all(
+          katana::iterate(active),
+          [&](Node u) {
+            uint64_t local_work = 0;
+            while (u != kUnmatched) {
+              if (work.load(std::memory_order_relaxed) >=
+                  global_relabel_interval) {
+                next.push(u);
+                break;
+              }
+              local_work += arc_begin_[u + 1] - arc_begin_[u] + 1;
+              u = Discharge(u);
+              if (local_work >= kWorkBatch) {
+                work.fetch_add(local_work, std::memory_order_relaxed);
+                local_work = 0;
+              }
+            }
+            work.fetch_add(local_work, std::memory_order_relaxed);
+          },
+          katana::steal(), katana::loopname("BipartiteMatchingDischarge"));
+      active.swap(next);
+    }
+
+    RebuildLeftMates();
+    HopcroftKarp();
+  }
+
+  /// \returns the layer of the left nodes at the end of the shortest
+  /// augmenting paths, or kUnreached if there are none, after setting the
+  /// layers of the left nodes up to it by a breadth-first search from the
+  /// unmatched left nodes
+  uint32_t ShortestAugmentingPathLayer() {
+    katana::InsertBag<Node> frontier;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          if (is_left_[n] && mate(n) == kUnmatched) {
+            dist_[n].store(0, std::memory_order_relaxed);
+            frontier.push(n);
+          } else {
+            dist_[n].store(kUnreached, std::memory_order_relaxed);
+          }
+        },
+        katana::no_stats());
+
+    for (uint32_t layer = 0; !frontier.empty(); ++layer) {
+      katana::GReduceLogicalOr found;
+      katana::InsertBag<Node> next;
+      katana::do_all(
+          katana::iterate(frontier),
+          [&](Node u) {
+            for (uint64_t arc = arc_begin_[u]; arc < arc_begin_[u + 1];
+                 ++arc) {
+              uint32_t w = mate(arc_dest_[arc]);
+              if (w == kUnmatched) {
+                found.update(true);
+              } else if (w != u) {
+                uint32_t expected = kUnreached;
+                if (dist_[w].load(std::memory_order_relaxed) == kUnreached &&
+                    dist_[w].compare_exchange_strong(
+                        expected, layer + 1, std::memory_order_relaxed)) {
+                  next.push(w);
+                }
+              }
+            }
+          },
+          katana::steal(), katana::loopname("BipartiteMatchingLayers"));
+      if (found.reduce()) {
+        return layer;
+      }
+      frontier.swap(next);
+    }
+    return kUnreached;
+  }
+
+private:
+  /// The work a thread does between updates of the shared work count
+  static constexpr uint64_t kWorkBatch = 1024;
+
+  struct Frame {
+    Node node;
+    uint64_t next_arc;
+  };
+
+  /// The stack of a depth-first search: the left nodes on the path and the
+  /// right nodes between them
+  struct SearchStack {
+    std::vector<Frame> frames;
+    std::vector<Node> rights;
+  };
+
+  /// Search depth-first from the unmatched left node root, along the layers
+  /// up to length, for an augmenting path made of right nodes not claimed
+  /// yet in phase, and augment the matching along it.
+  ///
+  /// \returns true if a path was found
+  bool Search(Node root, uint32_t length, uint32_t phase, SearchStack* stack) {
+    auto& frames = stack->frames;
+    auto& rights = stack->rights;
+    frames.clear();
+    rights.clear();
+    frames.push_back(Frame{root, arc_begin_[root]});
+
+    auto extends = [&](uint32_t layer, uint32_t w) {
+      return w == kUnmatched ||
+             (layer < length &&
+              dist_[w].load(std::memory_order_relaxed) == layer + 1);
+    };
+
+    while (!frames.empty()) {
+      Frame& frame = frames.back();
+      if (frame.next_arc == arc_begin_[frame.node + 1]) {
+        frames.pop_back();
+        if (!rights.empty()) {
+          rights.pop_back();
+        }
+        continue;
+      }
+      uint32_t layer = dist_[frame.node].load(std::memory_order_relaxed);
+      Node r = arc_dest_[frame.next_arc++];
+      if (!extends(layer, mate(r)) ||
+          claim_[r].load(std::memory_order_relaxed) == phase ||
+          claim_[r].exchange(phase, std::memory_order_relaxed) == phase) {
+        continue;
+      }
+      // r is ours for the rest of the phase, so its mate is stable now
+      uint32_t w = mate(r);
+      if (!extends(layer, w)) {
+        continue;
+      }
+      rights.push_back(r);
+      if (w == kUnmatched) {
+        for (size_t i = 0; i < rights.size(); ++i) {
+          set_mate(frames[i].node, rights[i]);
+          set_mate(rights[i], frames[i].node);
+        }
+        return true;
+      }
+      frames.push_back(Frame{w, arc_begin_[w]});
+    }
+    return false;
+  }
+
+  /// Augment the matching along disjoint shortest augmenting paths from all
+  /// the unmatched left nodes, in parallel or serially.
+  ///
+  /// \returns the number of paths augmented
+  uint64_t Augment(uint32_t length, bool parallel) {
+    const uint32_t phase = ++phase_;
+    katana::GAccumulator<uint64_t> augmented;
+    auto search = [&](Node n) {
+      if (is_left_[n] && dist_[n].load(std::memory_order_relaxed) == 0 &&
+          Search(n, length, phase, stacks_.getLocal())) {
+        augmented += 1;
+      }
+    };
+    if (parallel) {
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_nodes_), search, katana::steal(),
+          katana::loopname("BipartiteMatchingAugment"));
+    } else {
+      for (Node n = 0; n < num_nodes_; ++n) {
+        search(n);
+      }
+    }
+    return augmented.reduce();
+  }
+
+  /// Match the left node u to its right neighbor of the lowest label, and
+  /// raise the label of that neighbor to 2 more than the next lowest label
+  /// among the neighbors of u (a double push).
+  ///
+  /// \returns the left node displaced from that neighbor, or kUnmatched if
+  /// none was or u has no neighbor at a label below the number of nodes
+  uint32_t Discharge(Node u) {
+    const auto limit = static_cast<uint32_t>(num_nodes_);
+    uint32_t best = kUnmatched;
+    uint32_t lowest = limit;
+    uint32_t second = limit;
+    for (uint64_t arc = arc_begin_[u]; arc < arc_begin_[u + 1]; ++arc) {
+      Node r = arc_dest_[arc];
+      uint32_t label = dist_[r].load(std::memory_order_relaxed);
+      if (label < lowest) {
+        second = lowest;
+        lowest = label;
+        best = r;
+      } else if (label < second) {
+        second = label;
+      }
+    }
+    if (best == kUnmatched) {
+      return kUnmatched;
+    }
+
+    uint32_t displaced = mate_[best].exchange(u, std::memory_order_relaxed);
+    uint32_t raised = static_cast<uint32_t>(
+        std::min(uint64_t{limit}, uint64_t{second} + 2));
+    uint32_t label = dist_[best].load(std::memory_order_relaxed);
+    while (label < raised && !dist_[best].compare_exchange_weak(
+                                 label, raised, std::memory_order_relaxed)) {
+    }
+    return displaced;
+  }
+
+  /// Set the mates of the left nodes from those of the right nodes, which
+  /// are the only ones push-relabel keeps
+  void RebuildLeftMates() {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          if (is_left_[n]) {
+            set_mate(n, kUnmatched);
+          }
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          uint32_t w = mate(n);
+          if (!is_left_[n] && w != kUnmatched) {
+            set_mate(w, n);
+          }
+        },
+        katana::no_stats());
+  }
+
+  /// Set the label of every right node to its distance to an unmatched right
+  /// node, or to the number of nodes if there is no such path, by a
+  /// breadth-first search backward from the unmatched right nodes
+  void GlobalRelabel() {
+    RebuildLeftMates();
+    katana::InsertBag<Node> frontier;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          if (!is_left_[n] && mate(n) == kUnmatched) {
+            dist_[n].store(0, std::memory_order_relaxed);
+            frontier.push(n);
+          } else {
+            dist_[n].store(kUnreached, std::memory_order_relaxed);
+          }
+        },
+        katana::no_stats());
+
+    for (uint32_t distance = 0; !frontier.empty(); distance += 2) {
+      katana::InsertBag<Node> next;
+      katana::do_all(
+          katana::iterate(frontier),
+          [&](Node r) {
+            for (uint64_t arc = arc_begin_[r]; arc < arc_begin_[r + 1];
+                 ++arc) {
+              Node u = arc_dest_[arc];
+              uint32_t w = mate(u);
+              uint32_t expected = kUnreached;
+              if (w == r ||
+                  dist_[u].load(std::memory_order_relaxed) != kUnreached ||
+                  !dist_[u].compare_exchange_strong(
+                      expected, distance + 1, std::memory_order_relaxed) ||
+                  w == kUnmatched) {
+                continue;
+              }
+              expected = kUnreached;
+              if (dist_[w].compare_exchange_strong(
+                      expected, distance + 2, std::memory_order_relaxed)) {
+                next.push(w);
+              }
+            }
+          },
+          katana::steal(), katana::loopname("BipartiteMatchingRelabel"));
+      frontier.swap(next);
+    }
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          if (!is_left_[n] &&
+              dist_[n].load(std::memory_order_relaxed) == kUnreached) {
+            dist_[n].store(
+                static_cast<uint32_t>(num_nodes_), std::memory_order_relaxed);
+          }
+        },
+        katana::no_stats());
+  }
+
+  uint64_t num_nodes_;
+  katana::NUMAArray<uint8_t> is_left_;
+  katana::NUMAArray<uint64_t> arc_begin_;
+  katana::NUMAArray<Node> arc_dest_;
+  katana::NUMAArray<std::atomic<uint32_t>> mate_;
+  katana::NUMAArray<std::atomic<uint32_t>> dist_;
+  katana::NUMAArray<std::atomic<uint32_t>> claim_;
+  uint32_t phase_{0};
+  katana::PerThreadStorage<SearchStack> stacks_;
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::BipartiteMatching(
+    PropertyGraph* pg, const BipartiteSide& side,
+    const std::string& output_property_name, BipartiteMatchingPlan plan) {
+  if (plan.algorithm() != BipartiteMatchingPlan::kHopcroftKarp &&
+      plan.algorithm() != BipartiteMatchingPlan::kPushRelabel) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  if (pg->num_nodes() >= kUnmatched) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the graph has too many nodes for uint32_t matches");
+  }
+  auto is_left = KATANA_CHECKED(ReadSides(pg, side));
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeMatch>>(
+      pg, {output_property_name}));
+  auto graph =
+      KATANA_CHECKED(MatchGraph::Make(pg, {output_property_name}, {}));
+
+  katana::StatTimer exec_time("BipartiteMatching");
+  exec_time.start();
+  Matcher matcher(pg->BuildView<BiDirView>(), std::move(is_left));
+  matcher.MatchGreedily();
+  if (plan.algorithm() == BipartiteMatchingPlan::kHopcroftKarp) {
+    matcher.HopcroftKarp();
+  } else {
+    matcher.PushRelabel(plan.global_relabel_interval());
+  }
+  exec_time.stop();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](auto n) { graph.GetData<NodeMatch>(n) = matcher.mate(n); },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::BipartiteMatchingAssertValid(
+    PropertyGraph* pg, const BipartiteSide& side,
+    const std::string& property_name) {
+  auto is_left = KATANA_CHECKED(ReadSides(pg, side));
+  auto graph = KATANA_CHECKED(MatchGraph::Make(pg, {property_name}, {}));
+  auto view = pg->BuildView<BiDirView>();
+
+  katana::GReduceLogicalOr not_matching;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](auto n) {
+        uint32_t m = graph.GetData<NodeMatch>(n);
+        if (m == kUnmatched) {
+          return;
+        }
+        if (m >= graph.num_nodes() || graph.GetData<NodeMatch>(m) != n ||
+            is_left[m] == is_left[n]) {
+          not_matching.update(true);
+          return;
+        }
+        for (auto e : view.edges(n)) {
+          if (view.edge_dest(e) == m) {
+            return;
+          }
+        }
+        for (auto e : view.in_edges(n)) {
+          if (view.in_edge_dest(e) == m) {
+            return;
+          }
+        }
+        not_matching.update(true);
+      },
+      katana::steal(), katana::no_stats());
+  if (not_matching.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "some node is matched to a node that is not matched back to it "
+        "along an edge across the sides");
+  }
+
+  Matcher matcher(view, std::move(is_left));
+  katana::do_all(
+      katana::iterate(graph),
+      [&](auto n) { matcher.set_mate(n, graph.GetData<NodeMatch>(n)); },
+      katana::no_stats());
+  if (matcher.ShortestAugmentingPathLayer() != kUnreached) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "an augmenting path is left; the matching is not maximum");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<BipartiteMatchingStatistics>
+katana::analytics::BipartiteMatchingStatistics::Compute(
+    PropertyGraph* pg, const BipartiteSide& side,
+    const std::string& property_name) {
+  auto is_left = KATANA_CHECKED(ReadSides(pg, side));
+  auto graph = KATANA_CHECKED(MatchGraph::Make(pg, {property_name}, {}));
+
+  katana::GAccumulator<uint64_t> matching_size;
+  katana::GAccumulator<uint64_t> num_left_nodes;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](auto n) {
+        if (is_left[n]) {
+          num_left_nodes += 1;
+          if (graph.GetData<NodeMatch>(n) != kUnmatched) {
+            matching_size += 1;
+          }
+        }
+      },
+      katana::no_stats());
+  return BipartiteMatchingStatistics{
+      matching_size.reduce(), num_left_nodes.reduce(),
+      graph.num_nodes() - num_left_nodes.reduce()};
+}
+
+void
+katana::analytics::BipartiteMatchingStatistics::Print(std::ostream& os) const {
+  os << "Matching size = " << matching_size << std::endl;
+  os << "Left nodes = " << num_left_nodes << std::endl;
+  os << "Right nodes = " << num_right_nodes << std::endl;
+}
@@ -0,0 +1,208 @@
+#include "katana/analytics/closeness_centrality/closeness_centrality.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../bfs/multi_source_bfs.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/bfs/bfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct NodeCentrality : public katana::PODProperty<double> {};
+
+using CentralityGraph =
+    katana::TypedPropertyGraph<std::tuple<NodeCentrality>, std::tuple<>>;
+using Node = MultiSourceBfsView::Node;
+
+/// The seed of the generator that picks the sources of kSampled
+constexpr uint64_t kSeed = 0x9e3779b97f4a7c15;
+
+/// The sums, over the sources, of the distances to each node
+struct DistanceSums {
+  /// The number of sources that reach the node, itself included
+  katana::NUMAArray<uint64_t> num_reaching;
+  katana::NUMAArray<uint64_t> distance;
+  katana::NUMAArray<double> inverse_distance;
+  /// The number of nodes over the number of sources, which turns the sums
+  /// into estimates of the sums over all nodes
+  double scale = 0;
+};
+
+/// \returns all the nodes or, for kSampled, num_sources of them picked
+/// uniformly at random, in increasing order
+std::vector<uint32_t>
+PickSources(size_t num_nodes, const ClosenessCentralityPlan& plan) {
+  std::vector<uint32_t> sources(num_nodes);
+  std::iota(sources.begin(), sources.end(), uint32_t{0});
+  if (plan.algorithm() != ClosenessCentralityPlan::kSampled ||
+      plan.num_sources() >= num_nodes) {
+    return sources;
+  }
+
+  // the first num_sources steps of a Fisher-Yates shuffle
+  std::mt19937_64 gen(kSeed);
+  for (size_t i = 0; i < plan.num_sources(); ++i) {
+    size_t j = std::uniform_int_distribution<size_t>(i, num_nodes - 1)(gen);
+    std::swap(sources[i], sources[j]);
+  }
+  sources.resize(plan.num_sources());
+  std::sort(sources.begin(), sources.end());
+  return sources;
+}
+
+katana::Result<DistanceSums>
+SumDistances(katana::PropertyGraph* pg, const ClosenessCentralityPlan& plan) {
+  if (plan.algorithm() != ClosenessCentralityPlan::kExact &&
+      plan.algorithm() != ClosenessCentralityPlan::kSampled) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  if (plan.algorithm() == ClosenessCentralityPlan::kSampled &&
+      plan.num_sources() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no sources to sample");
+  }
+
+  auto view = KATANA_CHECKED(MultiSourceBfsView::Make(pg, {}, {}));
+  size_t num_nodes = view.num_nodes();
+
+  DistanceSums sums;
+  sums.num_reaching.allocateBlocked(num_nodes);
+  sums.distance.allocateBlocked(num_nodes);
+  sums.inverse_distance.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(
+      sums.num_reaching.begin(), sums.num_reaching.end(), 0);
+  katana::ParallelSTL::fill(sums.distance.begin(), sums.distance.end(), 0);
+  katana::ParallelSTL::fill(
+      sums.inverse_distance.begin(), sums.inverse_distance.end(), 0);
+
+  std::vector<uint32_t> sources = PickSources(num_nodes, plan);
+  if (sources.empty()) {
+    return sums;
+  }
+
+  // a node is visited by one thread at a time, so the sums need no atomics
+  auto accumulate = [&](Node n, size_t, uint64_t bits, uint32_t level) {
+    uint64_t count = __builtin_popcountll(bits);
+    sums.num_reaching[n] += count;
+    sums.distance[n] += count * level;
+    if (level > 0) {
+      sums.inverse_distance[n] += static_cast<double>(count) / level;
+    }
+  };
+
+  katana::StatTimer exec_time("ClosenessCentrality");
+  exec_time.start();
+  auto res = RunMultiSourceBfs(
+      view, sources, plan.batch_size(), MultiSourceBfsPlan::kDefaultAlpha,
+      std::numeric_limits<uint32_t>::max(), accumulate, nullptr);
+  exec_time.stop();
+  KATANA_CHECKED(res);
+
+  katana::ReportStatSingle(
+      "ClosenessCentrality", "Sources", sources.size());
+
+  sums.scale = static_cast<double>(num_nodes) / sources.size();
+  return sums;
+}
+
+/// Create the property output_property_name holding centrality(n) for each
+/// node n
+template <typename F>
+katana::Result<void>
+WriteCentralities(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    const F& centrality) {
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeCentrality>>(
+      pg, {output_property_name}));
+  auto graph =
+      KATANA_CHECKED(CentralityGraph::Make(pg, {output_property_name}, {}));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& n) { graph.GetData<NodeCentrality>(n) = centrality(n); },
+      katana::loopname("WriteCentralities"), katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::ClosenessCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan) {
+  auto sums = KATANA_CHECKED(SumDistances(pg, plan));
+  double num_nodes = static_cast<double>(pg->num_nodes());
+
+  return WriteCentralities(pg, output_property_name, [&](const Node& n) {
+    double distance = sums.distance[n] * sums.scale;
+    if (distance == 0) {
+      return 0.0;
+    }
+    // a source at distance > 0 was counted, so num_reaching >= 1
+    double others = sums.num_reaching[n] * sums.scale - 1;
+    return others / distance * others / (num_nodes - 1);
+  });
+}
+
+katana::Result<void>
+katana::analytics::HarmonicCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan) {
+  auto sums = KATANA_CHECKED(SumDistances(pg, plan));
+
+  return WriteCentralities(pg, output_property_name, [&](const Node& n) {
+    return sums.inverse_distance[n] * sums.scale;
+  });
+}
+
+katana::Result<ClosenessCentralityStatistics>
+katana::analytics::ClosenessCentralityStatistics::Compute(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(CentralityGraph::Make(pg, {property_name}, {}));
+
+  katana::GReduceMax<double> accum_max;
+  katana::GReduceMin<double> accum_min;
+  katana::GAccumulator<double> accum_sum;
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& n) {
+        double centrality = graph.GetData<NodeCentrality>(n);
+        accum_max.update(centrality);
+        accum_min.update(centrality);
+        accum_sum += centrality;
+      },
+      katana::loopname("ClosenessCentralityStatistics"), katana::no_stats());
+
+  if (graph.num_nodes() == 0) {
+    return ClosenessCentralityStatistics{0, 0, 0};
+  }
+  return ClosenessCentralityStatistics{
+      accum_max.reduce(), accum_min.reduce(),
+      accum_sum.reduce() / graph.num_nodes()};
+}
+
+void
+katana::analytics::ClosenessCentralityStatistics::Print(
+    std::ostream& os) const {
+  os << "Maximum centrality = " << max_centrality << std::endl;
+  os << "Minimum centrality = " << min_centrality << std::endl;
+  os << "Average centrality = " << average_centrality << std::endl;
+}
@@ -19,8 +19,12 @@
 
 #include "katana/analytics/connected_components/connected_components.h"
 
+#include "../gpu/gpu.h"
 #include "katana/ArrowRandomAccessBuilder.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Frontier.h"
+#include "katana/analytics/Planner.h"
+#include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
 
@@ -28,7 +32,6 @@ const int ConnectedComponentsPlan::kChunkSize = 1;
 
 namespace {
 
-const unsigned int kInfinity = std::numeric_limits<unsigned int>::max();
 struct ConnectedComponentsNode
     : public katana::UnionFindNode<ConnectedComponentsNode> {
   using ComponentType = ConnectedComponentsNode*;
@@ -102,46 +105,45 @@ struct ConnectedComponentsLabelPropAlgo {
   typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
   typedef typename Graph::Node GNode;
 
-  katana::NUMAArray<ComponentType> old_component_;
   ConnectedComponentsPlan& plan_;
   ConnectedComponentsLabelPropAlgo(ConnectedComponentsPlan& plan)
       : plan_(plan) {}
 
   void Initialize(Graph* graph) {
-    old_component_.allocateBlocked(graph->size());
     katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
       graph->GetData<NodeComponent>(node).store(node);
-      old_component_[node] = kInfinity;
     });
   }
 
   void Deallocate(Graph*) {}
 
+  /// Each round propagates the labels of the nodes whose label changed in
+  /// the previous round. Rounds where many labels change pull the labels of
+  /// the changed neighbors instead of pushing them.
   void operator()(Graph* graph) {
-    katana::GReduceLogicalOr changed;
-    do {
-      changed.reset();
-      katana::do_all(
-          katana::iterate(*graph),
-          [&](const GNode& src) {
-            auto& sdata_current_comp = graph->GetData<NodeComponent>(src);
-            auto& sdata_old_comp = old_component_[src];
-            if (sdata_old_comp > sdata_current_comp) {
-              sdata_old_comp = sdata_current_comp;
-
-              changed.update(true);
-
-              for (auto e : graph->edges(src)) {
-                auto dest = graph->GetEdgeDest(e);
-                auto& ddata_current_comp = graph->GetData<NodeComponent>(dest);
-                ComponentType label_new = sdata_current_comp;
-                katana::atomicMin(ddata_current_comp, label_new);
-              }
-            }
+    // The graph is symmetric, so its out-edges are its in-edges too.
+    const katana::GraphTopology& topology =
+        graph->GetPropertyGraph().topology();
+    auto current = std::make_unique<Frontier>(graph->num_nodes());
+    auto next = std::make_unique<Frontier>(graph->num_nodes());
+
+    // Every label is new at first
+    katana::do_all(
+        katana::iterate(*graph), [&](const GNode& node) { next->Add(node); },
+        katana::no_stats());
+
+    while (!next->empty()) {
+      std::swap(current, next);
+      EdgeMap(
+          topology, topology, current.get(), next.get(),
+          [&](GNode src, GNode dest) {
+            ComponentType label_new = graph->GetData<NodeComponent>(src);
+            auto& ddata_current_comp = graph->GetData<NodeComponent>(dest);
+            return katana::atomicMin(ddata_current_comp, label_new) >
+                   label_new;
           },
-          katana::disable_conflict_detection(), katana::steal(),
-          katana::loopname("ConnectedComponentsLabelPropAlgo"));
-    } while (changed.reduce());
+          [](GNode) { return true; }, "ConnectedComponentsLabelPropAlgo");
+    }
   }
 };
 
@@ -542,6 +544,8 @@ struct ConnectedComponentsEdgeTiledAsynchronousAlgo {
 
           KATANA_LOG_DEBUG_ASSERT(beg <= end);
           if ((end - beg) > plan_.edge_tile_size()) {
+            // read an out-of-core node's edges ahead of its tiles
+            graph->PrefetchEdges(src, src + 1);
             for (; beg + plan_.edge_tile_size() < end;) {
               const auto& ne = beg + plan_.edge_tile_size();
               KATANA_LOG_DEBUG_ASSERT(ne < end);
@@ -1055,6 +1059,10 @@ struct ConnectedComponentsEdgeTiledAfforestAlgo {
             return;
           auto beg = graph->edge_begin(src);
           const auto end = graph->edge_end(src);
+          // read an out-of-core node's edges ahead of its tiles
+          if ((end - beg) > plan_.edge_tile_size()) {
+            graph->PrefetchEdges(src, src + 1);
+          }
 
           for (std::advance(beg, plan_.neighbor_sample_size());
                beg + plan_.edge_tile_size() < end;) {
@@ -1138,7 +1146,25 @@ ConnectedComponentsWithWrap(
 katana::Result<void>
 katana::analytics::ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
-    ConnectedComponentsPlan plan) {
+    ConnectedComponentsPlan plan, AnalyticsResultCache* cache) {
+  if (cache) {
+    return cache->GetOrCompute(
+        pg, "ConnectedComponents",
+        fmt::format(
+            "{} {} {} {} {}", static_cast<int>(plan.architecture()),
+            static_cast<int>(plan.algorithm()), plan.edge_tile_size(),
+            plan.neighbor_sample_size(), plan.component_sample_frequency()),
+        output_property_name,
+        [&]() { return ConnectedComponents(pg, output_property_name, plan); });
+  }
+  if (plan.architecture() == kGPU) {
+    return internal::GpuConnectedComponents(pg, output_property_name, plan);
+  }
+  if (plan.algorithm() == ConnectedComponentsPlan::kAutomatic) {
+    plan = ChooseConnectedComponentsPlan(pg->GetTopologyStatistics());
+  }
+  // every algorithm sweeps all the nodes in order at least once
+  TopologyAccessGuard access(pg, GraphTopology::AccessPattern::kSequential);
   switch (plan.algorithm()) {
   case ConnectedComponentsPlan::kSerial:
     return ConnectedComponentsWithWrap<ConnectedComponentsSerialAlgo>(
@@ -1316,3 +1342,155 @@ katana::analytics::ConnectedComponentsStatistics::Print(
   os << "Ratio of nodes in the largest component = " << largest_component_ratio
      << std::endl;
 }
+
+namespace {
+
+struct IncrementalNode : public katana::UnionFindNode<IncrementalNode> {
+  IncrementalNode() : katana::UnionFindNode<IncrementalNode>(this) {}
+
+  /// The copy of old, a node of the forest at old_base, in the forest at
+  /// new_base
+  IncrementalNode(
+      const IncrementalNode& old, const IncrementalNode* old_base,
+      IncrementalNode* new_base)
+      : katana::UnionFindNode<IncrementalNode>(
+            new_base + (old.get() - old_base)) {}
+};
+
+}  // namespace
+
+struct katana::analytics::IncrementalConnectedComponents::Impl {
+  katana::NUMAArray<IncrementalNode> nodes;
+  uint64_t num_components{0};
+
+  /// Merge the components of the ends of the given edges
+  template <typename Range, typename EdgeFn>
+  void Merge(const Range& range, const EdgeFn& edge_fn, const char* name) {
+    katana::GAccumulator<uint64_t> merged;
+    katana::do_all(
+        range,
+        [&](auto item) {
+          edge_fn(item, [&](uint32_t src, uint32_t dest) {
+            if (nodes[src].merge(&nodes[dest])) {
+              merged += 1;
+            }
+          });
+        },
+        katana::steal(), katana::loopname(name));
+    num_components -= merged.reduce();
+  }
+};
+
+katana::analytics::IncrementalConnectedComponents::
+    IncrementalConnectedComponents(uint64_t num_nodes)
+    : impl_(std::make_unique<Impl>()) {
+  AddNodes(num_nodes);
+}
+
+katana::analytics::IncrementalConnectedComponents::
+    ~IncrementalConnectedComponents() = default;
+
+katana::Result<void>
+katana::analytics::IncrementalConnectedComponents::AddGraph(
+    const PropertyGraph* pg) {
+  const auto& topology = pg->topology();
+  if (topology.num_nodes() > num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "graph has {} nodes but the components have {}", topology.num_nodes(),
+        num_nodes());
+  }
+
+  impl_->Merge(
+      katana::iterate(topology),
+      [&](uint32_t src, const auto& merge) {
+        for (auto e : topology.edges(src)) {
+          merge(src, topology.edge_dest(e));
+        }
+      },
+      "IncrementalConnectedComponents-AddGraph");
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::IncrementalConnectedComponents::AddEdges(
+    const std::vector<std::pair<uint32_t, uint32_t>>& edges) {
+  for (const auto& [src, dest] : edges) {
+    if (src >= num_nodes() || dest >= num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "edge {} to {} is not on nodes",
+          src, dest);
+    }
+  }
+
+  impl_->Merge(
+      katana::iterate(size_t{0}, edges.size()),
+      [&](size_t i, const auto& merge) {
+        merge(edges[i].first, edges[i].second);
+      },
+      "IncrementalConnectedComponents-AddEdges");
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::IncrementalConnectedComponents::AddNodes(uint64_t count) {
+  auto& old_nodes = impl_->nodes;
+  uint64_t old_size = old_nodes.size();
+
+  katana::NUMAArray<IncrementalNode> nodes;
+  nodes.allocateInterleaved(old_size + count);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, old_size + count),
+      [&](uint64_t i) {
+        if (i < old_size) {
+          nodes.constructAt(i, old_nodes[i], old_nodes.data(), nodes.data());
+        } else {
+          nodes.constructAt(i);
+        }
+      },
+      katana::no_stats());
+
+  impl_->nodes = std::move(nodes);
+  impl_->num_components += count;
+}
+
+uint32_t
+katana::analytics::IncrementalConnectedComponents::Component(
+    uint32_t node) const {
+  return impl_->nodes[node].find() - impl_->nodes.data();
+}
+
+katana::Result<void>
+katana::analytics::IncrementalConnectedComponents::WriteComponents(
+    PropertyGraph* pg, const std::string& output_property_name) const {
+  struct NodeComponent : public katana::PODProperty<uint64_t> {};
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<NodeComponent>, std::tuple<>>;
+
+  if (pg->topology().num_nodes() != num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "graph has {} nodes but the components have {}",
+        pg->topology().num_nodes(), num_nodes());
+  }
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeComponent>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) { graph.GetData<NodeComponent>(n) = Component(n); },
+      katana::loopname("IncrementalConnectedComponents-Write"));
+  return katana::ResultSuccess();
+}
+
+uint64_t
+katana::analytics::IncrementalConnectedComponents::num_nodes() const {
+  return impl_->nodes.size();
+}
+
+uint64_t
+katana::analytics::IncrementalConnectedComponents::num_components() const {
+  return impl_->num_components;
+}
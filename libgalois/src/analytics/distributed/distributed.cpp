@@ -0,0 +1,245 @@
+#include "katana/analytics/distributed/distributed.h"
+
+#include <atomic>
+#include <cmath>
+#include <utility>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/DynamicBitset.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::Distribution::Node;
+using ReduceOp = katana::CommBackend::ReduceOp;
+
+struct DistributedBfsLevel : public katana::PODProperty<uint32_t> {};
+struct DistributedComponentID : public katana::PODProperty<uint64_t> {};
+struct DistributedPagerankValue : public katana::PODProperty<float> {};
+
+katana::Result<void>
+CheckPartition(
+    const katana::PropertyGraph& pg, const katana::Distribution& dist) {
+  if (pg.num_nodes() != dist.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "graph has {} nodes but its distribution has {}", pg.num_nodes(),
+        dist.num_nodes());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Create the property name of pg and set it to the values of the local
+/// nodes
+template <typename Prop, typename T>
+katana::Result<void>
+WriteOutput(
+    katana::PropertyGraph* pg, const std::string& name,
+    const katana::NUMAArray<T>& values) {
+  using Graph = katana::TypedPropertyGraph<std::tuple<Prop>, std::tuple<>>;
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<Prop>>(pg, {name}));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {name}, {}));
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) {
+        graph.template GetData<Prop>(n) =
+            katana::internal::SyncValue<T>::Load(values[n]);
+      },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+/// Lower the labels of the destinations of the edges of active nodes to
+/// relax(label of the source) until no label changes on any host. The labels
+/// of the proxies of a node must agree when this is called.
+template <typename T, typename Relax>
+katana::Result<void>
+PropagateMin(
+    const katana::PropertyGraph& pg, const katana::Distribution& dist,
+    katana::NUMAArray<std::atomic<T>>* labels, katana::DynamicBitset* active,
+    const Relax& relax, const char* loopname) {
+  const katana::GraphTopology& topo = pg.topology();
+  katana::DynamicBitset next;
+  next.resize(topo.num_nodes());
+
+  katana::StatTimer exec_time(loopname);
+  exec_time.start();
+  size_t round = 0;
+  for (;; ++round) {
+    uint64_t num_active = KATANA_CHECKED(
+        dist.comm()->AllReduce(ReduceOp::kSum, uint64_t{active->count()}));
+    if (num_active == 0) {
+      break;
+    }
+
+    next.reset();
+    katana::do_all(
+        katana::iterate(topo),
+        [&](Node src) {
+          if (!active->test(src)) {
+            return;
+          }
+          T candidate = relax((*labels)[src].load(std::memory_order_relaxed));
+          for (auto e : topo.edges(src)) {
+            Node dst = topo.edge_dest(e);
+            if (katana::atomicMin((*labels)[dst], candidate) > candidate) {
+              next.set(dst);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats(), katana::loopname(loopname));
+
+    // Mirrors that changed take part in the reduce; masters that changed
+    // here or there are then broadcast, and mirrors that the broadcast
+    // changed are active too.
+    KATANA_CHECKED(dist.ReduceToMasters(ReduceOp::kMin, labels, &next));
+    KATANA_CHECKED(dist.BroadcastToMirrors(labels, &next));
+    std::swap(*active, next);
+  }
+  exec_time.stop();
+  katana::ReportStatSingle(loopname, "Rounds", round);
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::DistributedBfs(
+    PropertyGraph* pg, const Distribution& dist, uint64_t global_source,
+    const std::string& output_property_name) {
+  KATANA_CHECKED(CheckPartition(*pg, dist));
+  if (global_source >= dist.num_global_nodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "source {} is not one of {} nodes",
+        global_source, dist.num_global_nodes());
+  }
+
+  NUMAArray<std::atomic<uint32_t>> levels;
+  levels.allocateBlocked(dist.num_nodes());
+  DynamicBitset active;
+  active.resize(dist.num_nodes());
+  katana::do_all(
+      katana::iterate(size_t{0}, dist.num_nodes()),
+      [&](Node n) {
+        if (dist.is_owned(n) && dist.local_to_global(n) == global_source) {
+          levels[n] = 0;
+          active.set(n);
+        } else {
+          levels[n] = kDistributedBfsUnreachable;
+        }
+      },
+      katana::no_stats());
+  // The mirrors of the source may have edges too
+  KATANA_CHECKED(dist.BroadcastToMirrors(&levels, &active));
+
+  KATANA_CHECKED(PropagateMin(
+      *pg, dist, &levels, &active,
+      [](uint32_t level) { return level + 1; }, "DistributedBfs"));
+  return WriteOutput<DistributedBfsLevel>(pg, output_property_name, levels);
+}
+
+katana::Result<void>
+katana::analytics::DistributedConnectedComponents(
+    PropertyGraph* pg, const Distribution& dist,
+    const std::string& output_property_name) {
+  KATANA_CHECKED(CheckPartition(*pg, dist));
+
+  NUMAArray<std::atomic<uint64_t>> components;
+  components.allocateBlocked(dist.num_nodes());
+  DynamicBitset active;
+  active.resize(dist.num_nodes());
+  katana::do_all(
+      katana::iterate(size_t{0}, dist.num_nodes()),
+      [&](Node n) {
+        components[n] = dist.local_to_global(n);
+        active.set(n);
+      },
+      katana::no_stats());
+
+  KATANA_CHECKED(PropagateMin(
+      *pg, dist, &components, &active, [](uint64_t id) { return id; },
+      "DistributedConnectedComponents"));
+  return WriteOutput<DistributedComponentID>(
+      pg, output_property_name, components);
+}
+
+katana::Result<void>
+katana::analytics::DistributedPagerank(
+    PropertyGraph* pg, const Distribution& dist,
+    const std::string& output_property_name, PagerankPlan plan) {
+  KATANA_CHECKED(CheckPartition(*pg, dist));
+  const GraphTopology& topo = pg->topology();
+  const size_t num_nodes = dist.num_nodes();
+  const double alpha = plan.alpha();
+
+  // The edges of a node may be split over its proxies, so its out degree is
+  // the sum of theirs
+  NUMAArray<uint64_t> degrees;
+  degrees.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(topo), [&](Node n) { degrees[n] = topo.degree(n); },
+      katana::no_stats());
+  KATANA_CHECKED(dist.ReduceToMasters(ReduceOp::kSum, &degrees, nullptr));
+  KATANA_CHECKED(dist.BroadcastToMirrors(&degrees, nullptr));
+
+  NUMAArray<double> ranks;
+  ranks.allocateBlocked(num_nodes);
+  NUMAArray<std::atomic<double>> sums;
+  sums.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](Node n) { ranks[n] = plan.initial_residual(); }, katana::no_stats());
+
+  katana::StatTimer exec_time("DistributedPagerank");
+  exec_time.start();
+  size_t iter = 0;
+  for (; iter < plan.max_iterations(); ++iter) {
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes), [&](Node n) { sums[n] = 0; },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(topo),
+        [&](Node src) {
+          if (degrees[src] == 0) {
+            return;
+          }
+          double contribution = ranks[src] / degrees[src];
+          for (auto e : topo.edges(src)) {
+            katana::atomicAdd(sums[topo.edge_dest(e)], contribution);
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("DistributedPagerank"));
+    KATANA_CHECKED(dist.ReduceToMasters(ReduceOp::kSum, &sums, nullptr));
+
+    katana::GReduceMax<double> max_delta;
+    katana::do_all(
+        katana::iterate(size_t{0}, dist.num_owned()),
+        [&](Node n) {
+          double rank =
+              (1 - alpha) + alpha * sums[n].load(std::memory_order_relaxed);
+          max_delta.update(std::abs(rank - ranks[n]));
+          ranks[n] = rank;
+        },
+        katana::no_stats());
+    KATANA_CHECKED(dist.BroadcastToMirrors(&ranks, nullptr));
+
+    double delta = KATANA_CHECKED(
+        dist.comm()->AllReduce(ReduceOp::kMax, max_delta.reduce()));
+    if (delta <= plan.tolerance()) {
+      ++iter;
+      break;
+    }
+  }
+  exec_time.stop();
+  katana::ReportStatSingle("DistributedPagerank", "Iterations", iter);
+
+  return WriteOutput<DistributedPagerankValue>(
+      pg, output_property_name, ranks);
+}
@@ -0,0 +1,269 @@
+#include "katana/analytics/eigenvector_centrality/eigenvector_centrality.h"
+
+#include <cmath>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/SpMV.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct NodeCentrality : public katana::PODProperty<double> {};
+
+using CentralityGraph =
+    katana::TypedPropertyGraph<std::tuple<NodeCentrality>, std::tuple<>>;
+using GNode = CentralityGraph::Node;
+
+using Centralities = katana::NUMAArray<double>;
+
+template <typename Plan>
+AdjacencyProducts::Kernel
+KernelOf(const Plan& plan) {
+  switch (plan.algorithm()) {
+  case Plan::kBlocked:
+    return AdjacencyProducts::kBlocked;
+  case Plan::kPush:
+    return AdjacencyProducts::kPush;
+  default:
+    return AdjacencyProducts::kPull;
+  }
+}
+
+/// Scale centralities to a Euclidean norm of 1, unless they are all 0
+void
+Normalize(Centralities* centralities) {
+  katana::GAccumulator<double> sum;
+  katana::do_all(
+      katana::iterate(size_t{0}, centralities->size()),
+      [&](size_t n) { sum += (*centralities)[n] * (*centralities)[n]; },
+      katana::no_stats());
+  double norm = std::sqrt(sum.reduce());
+  if (norm == 0) {
+    return;
+  }
+  katana::do_all(
+      katana::iterate(size_t{0}, centralities->size()),
+      [&](size_t n) { (*centralities)[n] /= norm; }, katana::no_stats());
+}
+
+double
+TotalChange(const Centralities& a, const Centralities& b) {
+  katana::GAccumulator<double> change;
+  katana::do_all(
+      katana::iterate(size_t{0}, a.size()),
+      [&](size_t n) { change += std::fabs(a[n] - b[n]); }, katana::no_stats());
+  return change.reduce();
+}
+
+void
+ComputeEigenvector(
+    katana::PropertyGraph* pg, EigenvectorCentralityPlan plan,
+    Centralities* centralities) {
+  size_t num_nodes = pg->num_nodes();
+  AdjacencyProducts products(pg, KernelOf(plan));
+
+  Centralities next;
+  next.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { (*centralities)[n] = 1.0 / num_nodes; },
+      katana::no_stats());
+  Normalize(centralities);
+
+  uint32_t iteration = 0;
+  while (iteration < plan.max_iterations()) {
+    products.MultiplyTransposed(
+        *centralities, &next, "EigenvectorCentrality");
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) { next[n] += (*centralities)[n]; }, katana::no_stats());
+    Normalize(&next);
+
+    double change = TotalChange(next, *centralities);
+    std::swap(*centralities, next);
+    iteration += 1;
+    if (change <= plan.tolerance()) {
+      break;
+    }
+  }
+
+  katana::ReportStatSingle("EigenvectorCentrality", "Iterations", iteration);
+}
+
+void
+ComputeKatz(
+    katana::PropertyGraph* pg, KatzCentralityPlan plan,
+    Centralities* centralities) {
+  size_t num_nodes = pg->num_nodes();
+  AdjacencyProducts products(pg, KernelOf(plan));
+
+  Centralities next;
+  next.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { (*centralities)[n] = 0; }, katana::no_stats());
+
+  uint32_t iteration = 0;
+  while (iteration < plan.max_iterations()) {
+    products.MultiplyTransposed(*centralities, &next, "KatzCentrality");
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) { next[n] = plan.alpha() * next[n] + plan.beta(); },
+        katana::no_stats());
+
+    double change = TotalChange(next, *centralities);
+    std::swap(*centralities, next);
+    iteration += 1;
+    if (change <= plan.tolerance()) {
+      break;
+    }
+  }
+  Normalize(centralities);
+
+  katana::ReportStatSingle("KatzCentrality", "Iterations", iteration);
+}
+
+katana::Result<void>
+WriteCentralities(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    const Centralities& centralities) {
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeCentrality>>(
+      pg, {output_property_name}));
+  auto graph =
+      KATANA_CHECKED(CentralityGraph::Make(pg, {output_property_name}, {}));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        graph.GetData<NodeCentrality>(n) = centralities[n];
+      },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::EigenvectorCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    EigenvectorCentralityPlan plan) {
+  if (plan.algorithm() != EigenvectorCentralityPlan::kPull &&
+      plan.algorithm() != EigenvectorCentralityPlan::kBlocked &&
+      plan.algorithm() != EigenvectorCentralityPlan::kPush) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  Centralities centralities;
+  centralities.allocateBlocked(pg->num_nodes());
+
+  katana::StatTimer exec_time("EigenvectorCentrality");
+  exec_time.start();
+  ComputeEigenvector(pg, plan, &centralities);
+  exec_time.stop();
+
+  return WriteCentralities(pg, output_property_name, centralities);
+}
+
+katana::Result<void>
+katana::analytics::KatzCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    KatzCentralityPlan plan) {
+  if (plan.algorithm() != KatzCentralityPlan::kPull &&
+      plan.algorithm() != KatzCentralityPlan::kBlocked &&
+      plan.algorithm() != KatzCentralityPlan::kPush) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  if (!(plan.alpha() > 0) || !(plan.beta() > 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "alpha and beta must be positive");
+  }
+
+  Centralities centralities;
+  centralities.allocateBlocked(pg->num_nodes());
+
+  katana::StatTimer exec_time("KatzCentrality");
+  exec_time.start();
+  ComputeKatz(pg, plan, &centralities);
+  exec_time.stop();
+
+  return WriteCentralities(pg, output_property_name, centralities);
+}
+
+katana::Result<void>
+katana::analytics::EigenvectorCentralityAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(CentralityGraph::Make(pg, {property_name}, {}));
+
+  katana::GAccumulator<double> sum;
+  katana::GReduceLogicalOr negative;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        double centrality = graph.GetData<NodeCentrality>(n);
+        sum += centrality * centrality;
+        negative.update(centrality < 0);
+      },
+      katana::no_stats());
+
+  if (negative.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "some centrality is negative");
+  }
+  double norm = std::sqrt(sum.reduce());
+  double expected = graph.num_nodes() > 0 ? 1 : 0;
+  if (std::fabs(norm - expected) > 1e-6) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "norm is {} rather than {}", norm,
+        expected);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<EigenvectorCentralityStatistics>
+katana::analytics::EigenvectorCentralityStatistics::Compute(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(CentralityGraph::Make(pg, {property_name}, {}));
+
+  katana::GReduceMax<double> accum_max;
+  katana::GReduceMin<double> accum_min;
+  katana::GAccumulator<double> accum_sum;
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        double centrality = graph.GetData<NodeCentrality>(n);
+        accum_max.update(centrality);
+        accum_min.update(centrality);
+        accum_sum += centrality;
+      },
+      katana::loopname("EigenvectorCentralityStatistics"),
+      katana::no_stats());
+
+  if (graph.num_nodes() == 0) {
+    return EigenvectorCentralityStatistics{0, 0, 0};
+  }
+  return EigenvectorCentralityStatistics{
+      accum_max.reduce(), accum_min.reduce(),
+      accum_sum.reduce() / graph.num_nodes()};
+}
+
+void
+katana::analytics::EigenvectorCentralityStatistics::Print(
+    std::ostream& os) const {
+  os << "Maximum centrality = " << max_centrality << std::endl;
+  os << "Minimum centrality = " << min_centrality << std::endl;
+  os << "Average centrality = " << average_centrality << std::endl;
+}
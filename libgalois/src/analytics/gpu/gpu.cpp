@@ -0,0 +1,250 @@
+#include "gpu.h"
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include <arrow/array.h>
+#include <arrow/type_traits.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+#include "kernels.h"
+
+namespace gpu = katana::analytics::gpu;
+
+namespace {
+
+/// The number of live GpuBackendCache scopes
+std::atomic<int> cache_scopes{0};
+
+katana::Result<void>
+ToResult(const gpu::Status& status) {
+  switch (status.code) {
+  case gpu::StatusCode::kOk:
+    return katana::ResultSuccess();
+  case gpu::StatusCode::kNotEnabled:
+    return KATANA_ERROR(
+        katana::ErrorCode::FeatureNotEnabled, "{}", status.message);
+  case gpu::StatusCode::kOutOfMemory:
+    return KATANA_ERROR(katana::ErrorCode::OutOfMemory, "{}", status.message);
+  case gpu::StatusCode::kCancelled:
+    return KATANA_ERROR(katana::ErrorCode::Cancelled, "{}", status.message);
+  case gpu::StatusCode::kFailed:
+    break;
+  }
+  return KATANA_ERROR(katana::ErrorCode::DeviceFailed, "{}", status.message);
+}
+
+gpu::HostCsr
+MakeHostCsr(const katana::GraphTopology& topo) {
+  gpu::HostCsr csr;
+  csr.num_nodes = topo.num_nodes();
+  csr.num_edges = topo.num_edges();
+  if (topo.is_compact()) {
+    csr.compact_adj_indices = topo.compact_adj_data();
+  } else {
+    csr.adj_indices = topo.adj_data();
+  }
+  csr.dests = topo.dest_data();
+  csr.cache = cache_scopes.load() > 0;
+  return csr;
+}
+
+gpu::CancelledFn
+MakeCancelledFn(const katana::CancellationToken* cancellation) {
+  if (cancellation == nullptr) {
+    return {};
+  }
+  return [cancellation]() { return cancellation->IsCancelled(); };
+}
+
+/// Check that start_node is a node of pg and that there is a device, before
+/// anything is allocated
+katana::Result<void>
+CheckStart(const katana::PropertyGraph& pg, size_t start_node) {
+  KATANA_CHECKED(ToResult(gpu::CheckDevice()));
+  if (start_node >= pg.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "start node {} is not one of {}",
+        start_node, pg.num_nodes());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Create the node property name of pg with values
+template <typename T>
+katana::Result<void>
+WriteNodeProperty(
+    katana::PropertyGraph* pg, const std::string& name,
+    const std::vector<T>& values) {
+  using Prop = katana::PODProperty<T>;
+  using Graph = katana::TypedPropertyGraph<std::tuple<Prop>, std::tuple<>>;
+  KATANA_CHECKED(
+      katana::analytics::ConstructNodeProperties<std::tuple<Prop>>(
+          pg, {name}));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {name}, {}));
+  katana::do_all(
+      katana::iterate(graph),
+      [&](auto n) { graph.template GetData<Prop>(n) = values[n]; },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<void>
+GpuSsspImpl(
+    katana::PropertyGraph* pg, size_t start_node,
+    const std::shared_ptr<arrow::ChunkedArray>& weights,
+    const std::string& output_property_name,
+    const katana::analytics::SsspPlan& plan,
+    const katana::CancellationToken* cancellation) {
+  using ArrowArray =
+      arrow::NumericArray<typename arrow::CTypeTraits<Weight>::ArrowType>;
+  // As BfsSsspImplementationBase
+  constexpr Weight kInfinity = std::numeric_limits<Weight>::max() / 4;
+
+  // The weights are uploaded from the property itself when they can be, so
+  // within a GpuBackendCache the device copy is found again by the next call
+  const Weight* host_weights = nullptr;
+  std::vector<Weight> flattened;
+  bool cache_weights = weights->num_chunks() == 1;
+  if (cache_weights) {
+    host_weights =
+        std::static_pointer_cast<ArrowArray>(weights->chunk(0))->raw_values();
+  } else {
+    flattened = KATANA_CHECKED(katana::UnmarshalVector<Weight>(weights));
+    host_weights = flattened.data();
+  }
+
+  std::vector<Weight> distances(pg->num_nodes());
+  katana::StatTimer exec_time("GpuSssp");
+  exec_time.start();
+  KATANA_CHECKED(ToResult(gpu::Sssp<Weight>(
+      MakeHostCsr(pg->topology()), host_weights, cache_weights,
+      static_cast<uint32_t>(start_node), plan.delta(), kInfinity,
+      distances.data(), MakeCancelledFn(cancellation))));
+  exec_time.stop();
+  return WriteNodeProperty(pg, output_property_name, distances);
+}
+
+}  // namespace
+
+bool
+katana::analytics::GpuBackendAvailable() {
+  return gpu::CheckDevice().ok();
+}
+
+katana::analytics::GpuBackendCache::GpuBackendCache() { ++cache_scopes; }
+
+katana::analytics::GpuBackendCache::~GpuBackendCache() {
+  if (--cache_scopes == 0) {
+    gpu::ReleaseCache();
+  }
+}
+
+void
+katana::analytics::ReleaseGpuBackendCache() {
+  gpu::ReleaseCache();
+}
+
+katana::Result<void>
+katana::analytics::internal::GpuBfs(
+    PropertyGraph* pg, uint32_t start_node,
+    const std::string& output_property_name,
+    const CancellationToken* cancellation) {
+  KATANA_CHECKED(CheckStart(*pg, start_node));
+  // As BfsSsspImplementationBase
+  constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max() / 4;
+
+  std::vector<uint32_t> parents(pg->num_nodes());
+  katana::StatTimer exec_time("GpuBfs");
+  exec_time.start();
+  KATANA_CHECKED(ToResult(gpu::Bfs(
+      MakeHostCsr(pg->topology()), start_node, kInfinity, parents.data(),
+      MakeCancelledFn(cancellation))));
+  exec_time.stop();
+  return WriteNodeProperty(pg, output_property_name, parents);
+}
+
+katana::Result<void>
+katana::analytics::internal::GpuSssp(
+    PropertyGraph* pg, size_t start_node,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, const SsspPlan& plan,
+    const CancellationToken* cancellation) {
+  KATANA_CHECKED(CheckStart(*pg, start_node));
+  std::shared_ptr<arrow::ChunkedArray> weights =
+      pg->GetEdgeProperty(edge_weight_property_name);
+  if (weights == nullptr) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return GpuSsspImpl<uint32_t>(
+        pg, start_node, weights, output_property_name, plan, cancellation);
+  case arrow::Int32Type::type_id:
+    return GpuSsspImpl<int32_t>(
+        pg, start_node, weights, output_property_name, plan, cancellation);
+  case arrow::UInt64Type::type_id:
+    return GpuSsspImpl<uint64_t>(
+        pg, start_node, weights, output_property_name, plan, cancellation);
+  case arrow::Int64Type::type_id:
+    return GpuSsspImpl<int64_t>(
+        pg, start_node, weights, output_property_name, plan, cancellation);
+  case arrow::FloatType::type_id:
+    return GpuSsspImpl<float>(
+        pg, start_node, weights, output_property_name, plan, cancellation);
+  case arrow::DoubleType::type_id:
+    return GpuSsspImpl<double>(
+        pg, start_node, weights, output_property_name, plan, cancellation);
+  default:
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "unsupported edge weight type {}",
+        weights->type()->ToString());
+  }
+}
+
+katana::Result<void>
+katana::analytics::internal::GpuConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    const ConnectedComponentsPlan& plan) {
+  KATANA_CHECKED(ToResult(gpu::CheckDevice()));
+
+  std::vector<uint64_t> components(pg->num_nodes());
+  katana::StatTimer exec_time("GpuConnectedComponents");
+  exec_time.start();
+  KATANA_CHECKED(ToResult(gpu::ConnectedComponents(
+      MakeHostCsr(pg->topology()), plan.neighbor_sample_size(),
+      plan.component_sample_frequency(), components.data())));
+  exec_time.stop();
+  return WriteNodeProperty(pg, output_property_name, components);
+}
+
+katana::Result<void>
+katana::analytics::internal::GpuPagerank(
+    PropertyGraph* pg, const std::string& output_property_name,
+    const PagerankPlan& plan, const CancellationToken* cancellation) {
+  KATANA_CHECKED(ToResult(gpu::CheckDevice()));
+
+  std::vector<float> ranks(pg->num_nodes());
+  uint32_t iterations = 0;
+  katana::StatTimer exec_time("GpuPagerank");
+  exec_time.start();
+  KATANA_CHECKED(ToResult(gpu::Pagerank(
+      MakeHostCsr(pg->topology()), plan.alpha(), plan.tolerance(),
+      plan.max_iterations(), ranks.data(), &iterations,
+      MakeCancelledFn(cancellation))));
+  exec_time.stop();
+  katana::ReportStatSingle("GpuPagerank", "Iterations", iterations);
+  return WriteNodeProperty(pg, output_property_name, ranks);
+}
@@ -0,0 +1,41 @@
+#ifndef KATANA_LIBGALOIS_ANALYTICS_GPU_GPU_H_
+#define KATANA_LIBGALOIS_ANALYTICS_GPU_GPU_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/Cancellation.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/analytics/GpuBackend.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+
+// The analytics call these for their kGPU plans; the arguments are those of
+// the analytic.
+
+namespace katana::analytics::internal {
+
+Result<void> GpuBfs(
+    PropertyGraph* pg, uint32_t start_node,
+    const std::string& output_property_name,
+    const CancellationToken* cancellation);
+
+Result<void> GpuSssp(
+    PropertyGraph* pg, size_t start_node,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, const SsspPlan& plan,
+    const CancellationToken* cancellation);
+
+Result<void> GpuConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    const ConnectedComponentsPlan& plan);
+
+Result<void> GpuPagerank(
+    PropertyGraph* pg, const std::string& output_property_name,
+    const PagerankPlan& plan, const CancellationToken* cancellation);
+
+}  // namespace katana::analytics::internal
+
+#endif
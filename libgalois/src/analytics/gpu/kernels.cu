@@ -0,0 +1,903 @@
+#include "kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cuda_runtime.h>
+
+namespace gpu = katana::analytics::gpu;
+
+using gpu::HostCsr;
+using gpu::Status;
+using gpu::StatusCode;
+
+namespace {
+
+constexpr unsigned kBlockSize = 256;
+constexpr unsigned kWarpSize = 32;
+constexpr uint64_t kMaxBlocks = 65535;
+constexpr uint32_t kNoStamp = std::numeric_limits<uint32_t>::max();
+
+#define GPU_CHECKED(expr)                                                      \
+  do {                                                                         \
+    if (Status status_ = (expr); !status_.ok()) {                              \
+      return status_;                                                          \
+    }                                                                          \
+  } while (0)
+
+#define CUDA_CHECKED(call) GPU_CHECKED(Check((call), #call))
+
+Status
+Check(cudaError_t error, const char* what) {
+  if (error == cudaSuccess) {
+    return Status{};
+  }
+  // Clear the error so that it is not reported again by later calls
+  cudaGetLastError();
+  return Status{
+      error == cudaErrorMemoryAllocation ? StatusCode::kOutOfMemory
+                                         : StatusCode::kFailed,
+      std::string(what) + ": " + cudaGetErrorString(error)};
+}
+
+/// Check the launch of the kernel named what
+Status
+Launched(const char* what) {
+  return Check(cudaGetLastError(), what);
+}
+
+Status
+Cancelled(const gpu::CancelledFn& cancelled, const char* what) {
+  if (cancelled && cancelled()) {
+    return Status{StatusCode::kCancelled, std::string(what) + " cancelled"};
+  }
+  return Status{};
+}
+
+/// The number of blocks to run num_threads threads; kernels loop over their
+/// items with the stride of the grid, so larger inputs cap it
+unsigned
+NumBlocks(uint64_t num_threads) {
+  uint64_t num_blocks = (num_threads + kBlockSize - 1) / kBlockSize;
+  return std::clamp<uint64_t>(num_blocks, 1, kMaxBlocks);
+}
+
+/// An array in device memory
+template <typename T>
+class DeviceArray {
+public:
+  DeviceArray() = default;
+  DeviceArray(const DeviceArray&) = delete;
+  DeviceArray& operator=(const DeviceArray&) = delete;
+  DeviceArray(DeviceArray&& that) noexcept
+      : data_(std::exchange(that.data_, nullptr)),
+        size_(std::exchange(that.size_, 0)) {}
+  DeviceArray& operator=(DeviceArray&& that) noexcept {
+    std::swap(data_, that.data_);
+    std::swap(size_, that.size_);
+    return *this;
+  }
+  ~DeviceArray() { Free(); }
+
+  T* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  /// Make the array hold size elements; the contents are undefined
+  Status Allocate(size_t size) {
+    if (size == size_) {
+      return Status{};
+    }
+    Free();
+    if (size > 0) {
+      CUDA_CHECKED(
+          cudaMalloc(reinterpret_cast<void**>(&data_), size * sizeof(T)));
+      size_ = size;
+    }
+    return Status{};
+  }
+
+  Status Upload(const T* host, size_t size) {
+    GPU_CHECKED(Allocate(size));
+    if (size > 0) {
+      CUDA_CHECKED(
+          cudaMemcpy(data_, host, size * sizeof(T), cudaMemcpyHostToDevice));
+    }
+    return Status{};
+  }
+
+  Status Download(T* host) const {
+    if (size_ > 0) {
+      CUDA_CHECKED(
+          cudaMemcpy(host, data_, size_ * sizeof(T), cudaMemcpyDeviceToHost));
+    }
+    return Status{};
+  }
+
+private:
+  void Free() {
+    if (data_ != nullptr) {
+      cudaFree(data_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  T* data_{nullptr};
+  size_t size_{0};
+};
+
+/// The copy of a graph in device memory; host_* identify the host arrays it
+/// was copied from
+struct DeviceGraph {
+  const void* host_adj_indices{nullptr};
+  const uint32_t* host_dests{nullptr};
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  DeviceArray<uint64_t> adj_indices;
+  DeviceArray<uint32_t> dests;
+
+  const void* host_weights{nullptr};
+  size_t weight_bytes{0};
+  DeviceArray<uint8_t> weights;
+};
+
+/// Held for the whole of each analytic, which uses the cached graph
+std::mutex cache_mutex;
+
+DeviceGraph&
+CachedGraph() {
+  // Never destroyed, since the CUDA runtime may be gone at exit
+  static DeviceGraph* graph = new DeviceGraph;
+  return *graph;
+}
+
+/// Frees the cached graph when an analytic that holds cache_mutex returns,
+/// unless its caller keeps the graph for the next call
+class CacheRelease {
+public:
+  explicit CacheRelease(bool keep) : keep_(keep) {}
+  ~CacheRelease() {
+    if (!keep_) {
+      CachedGraph() = DeviceGraph{};
+    }
+  }
+
+private:
+  bool keep_;
+};
+
+__device__ uint64_t
+ThreadIndex() {
+  return uint64_t{blockIdx.x} * blockDim.x + threadIdx.x;
+}
+
+__device__ uint64_t
+NumThreads() {
+  return uint64_t{gridDim.x} * blockDim.x;
+}
+
+__device__ uint64_t
+EdgeBegin(const uint64_t* adj_indices, uint64_t n) {
+  return n == 0 ? 0 : adj_indices[n - 1];
+}
+
+/// Read a value that other threads of the kernel may write
+__device__ uint32_t
+LoadVolatile(const uint32_t* address) {
+  return *static_cast<const volatile uint32_t*>(address);
+}
+
+__device__ uint32_t
+AtomicMin(uint32_t* address, uint32_t value) {
+  return atomicMin(address, value);
+}
+
+__device__ int32_t
+AtomicMin(int32_t* address, int32_t value) {
+  return atomicMin(address, value);
+}
+
+__device__ uint64_t
+AtomicMin(uint64_t* address, uint64_t value) {
+  return atomicMin(
+      reinterpret_cast<unsigned long long*>(address),
+      static_cast<unsigned long long>(value));
+}
+
+__device__ int64_t
+AtomicMin(int64_t* address, int64_t value) {
+  return atomicMin(
+      reinterpret_cast<long long*>(address), static_cast<long long>(value));
+}
+
+__device__ float
+AtomicMin(float* address, float value) {
+  unsigned int* bits = reinterpret_cast<unsigned int*>(address);
+  unsigned int old = *bits;
+  while (__uint_as_float(old) > value) {
+    unsigned int assumed = old;
+    old = atomicCAS(bits, assumed, __float_as_uint(value));
+    if (old == assumed) {
+      break;
+    }
+  }
+  return __uint_as_float(old);
+}
+
+__device__ double
+AtomicMin(double* address, double value) {
+  unsigned long long* bits = reinterpret_cast<unsigned long long*>(address);
+  unsigned long long old = *bits;
+  while (__longlong_as_double(static_cast<long long>(old)) > value) {
+    unsigned long long assumed = old;
+    old = atomicCAS(
+        bits, assumed,
+        static_cast<unsigned long long>(__double_as_longlong(value)));
+    if (old == assumed) {
+      break;
+    }
+  }
+  return __longlong_as_double(static_cast<long long>(old));
+}
+
+__global__ void
+Widen(const uint32_t* in, uint64_t size, uint64_t* out) {
+  for (uint64_t i = ThreadIndex(); i < size; i += NumThreads()) {
+    out[i] = in[i];
+  }
+}
+
+/// Make the cached graph the copy of csr, uploading it unless it already is
+/// and csr.cache promises that the host arrays did not change since
+Status
+UseGraph(const HostCsr& csr, DeviceGraph** out) {
+  DeviceGraph& graph = CachedGraph();
+  const void* host_adj_indices =
+      csr.adj_indices != nullptr
+          ? static_cast<const void*>(csr.adj_indices)
+          : static_cast<const void*>(csr.compact_adj_indices);
+  if (!csr.cache || graph.host_adj_indices != host_adj_indices ||
+      graph.host_dests != csr.dests || graph.num_nodes != csr.num_nodes ||
+      graph.num_edges != csr.num_edges) {
+    graph = DeviceGraph{};
+    GPU_CHECKED(graph.dests.Upload(csr.dests, csr.num_edges));
+    if (csr.adj_indices != nullptr) {
+      GPU_CHECKED(graph.adj_indices.Upload(csr.adj_indices, csr.num_nodes));
+    } else {
+      DeviceArray<uint32_t> compact;
+      GPU_CHECKED(compact.Upload(csr.compact_adj_indices, csr.num_nodes));
+      GPU_CHECKED(graph.adj_indices.Allocate(csr.num_nodes));
+      Widen<<<NumBlocks(csr.num_nodes), kBlockSize>>>(
+          compact.data(), csr.num_nodes, graph.adj_indices.data());
+      GPU_CHECKED(Launched("Widen"));
+    }
+    if (csr.cache) {
+      graph.host_adj_indices = host_adj_indices;
+      graph.host_dests = csr.dests;
+      graph.num_nodes = csr.num_nodes;
+      graph.num_edges = csr.num_edges;
+    }
+  }
+  *out = &graph;
+  return Status{};
+}
+
+/// Make the weights of graph the copy of the bytes at host
+Status
+UseWeights(DeviceGraph* graph, const void* host, size_t bytes, bool cache) {
+  if (cache && graph->host_weights == host && graph->weight_bytes == bytes) {
+    return Status{};
+  }
+  graph->host_weights = nullptr;
+  graph->weight_bytes = 0;
+  GPU_CHECKED(
+      graph->weights.Upload(static_cast<const uint8_t*>(host), bytes));
+  if (cache) {
+    graph->host_weights = host;
+    graph->weight_bytes = bytes;
+  }
+  return Status{};
+}
+
+//
+// BFS
+//
+
+__global__ void
+BfsInit(
+    uint64_t num_nodes, uint32_t source, uint32_t infinity,
+    uint32_t* parents) {
+  for (uint64_t n = ThreadIndex(); n < num_nodes; n += NumThreads()) {
+    parents[n] = n == source ? source : infinity;
+  }
+}
+
+/// Visit the unvisited neighbors of the frontier. A warp takes each
+/// frontier node and its lanes stride over the edges, so that a node of
+/// high degree is not left to one thread.
+__global__ void
+BfsExpand(
+    const uint64_t* adj_indices, const uint32_t* dests,
+    const uint32_t* frontier, uint32_t frontier_size, uint32_t infinity,
+    uint32_t* parents, uint32_t* next, uint32_t* next_size) {
+  const uint64_t lane = threadIdx.x % kWarpSize;
+  for (uint64_t i = ThreadIndex() / kWarpSize; i < frontier_size;
+       i += NumThreads() / kWarpSize) {
+    uint32_t src = frontier[i];
+    for (uint64_t e = EdgeBegin(adj_indices, src) + lane;
+         e < adj_indices[src]; e += kWarpSize) {
+      uint32_t dst = dests[e];
+      if (LoadVolatile(&parents[dst]) == infinity &&
+          atomicCAS(&parents[dst], infinity, src) == infinity) {
+        next[atomicAdd(next_size, 1u)] = dst;
+      }
+    }
+  }
+}
+
+//
+// SSSP
+//
+
+template <typename Weight>
+__global__ void
+SsspInit(
+    uint64_t num_nodes, uint32_t source, Weight infinity, Weight* distances,
+    uint32_t* stamps, uint8_t* far) {
+  for (uint64_t n = ThreadIndex(); n < num_nodes; n += NumThreads()) {
+    distances[n] = n == source ? Weight{0} : infinity;
+    stamps[n] = n == source ? 0 : kNoStamp;
+    far[n] = 0;
+  }
+}
+
+/// Relax the edges of the near queue. Destinations that improve below
+/// threshold are queued in next, once per round by their stamp; the others
+/// are marked far.
+template <typename Weight>
+__global__ void
+SsspRelax(
+    const uint64_t* adj_indices, const uint32_t* dests, const Weight* weights,
+    const uint32_t* near, uint32_t near_size, Weight threshold,
+    uint32_t next_stamp, Weight* distances, uint32_t* stamps, uint8_t* far,
+    uint32_t* next, uint32_t* next_size) {
+  const uint64_t lane = threadIdx.x % kWarpSize;
+  for (uint64_t i = ThreadIndex() / kWarpSize; i < near_size;
+       i += NumThreads() / kWarpSize) {
+    uint32_t src = near[i];
+    // A stale distance only gives worse candidates; src is queued again
+    // if it improves
+    Weight src_distance = distances[src];
+    for (uint64_t e = EdgeBegin(adj_indices, src) + lane;
+         e < adj_indices[src]; e += kWarpSize) {
+      uint32_t dst = dests[e];
+      Weight candidate = src_distance + weights[e];
+      if (AtomicMin(&distances[dst], candidate) <= candidate) {
+        continue;
+      }
+      if (candidate < threshold) {
+        if (atomicExch(&stamps[dst], next_stamp) != next_stamp) {
+          next[atomicAdd(next_size, 1u)] = dst;
+        }
+      } else {
+        far[dst] = 1;
+      }
+    }
+  }
+}
+
+/// Find the smallest distance of the far nodes that are not settled yet;
+/// those below threshold were settled by the near rounds
+template <typename Weight>
+__global__ void
+SsspFarMin(
+    uint64_t num_nodes, const Weight* distances, Weight threshold,
+    uint8_t* far, Weight* min_far) {
+  for (uint64_t n = ThreadIndex(); n < num_nodes; n += NumThreads()) {
+    if (!far[n]) {
+      continue;
+    }
+    Weight distance = distances[n];
+    if (distance < threshold) {
+      far[n] = 0;
+    } else {
+      AtomicMin(min_far, distance);
+    }
+  }
+}
+
+/// Move the far nodes below the new threshold to the near queue
+template <typename Weight>
+__global__ void
+SsspSplit(
+    uint64_t num_nodes, const Weight* distances, Weight threshold,
+    uint32_t stamp, uint8_t* far, uint32_t* stamps, uint32_t* near,
+    uint32_t* near_size) {
+  for (uint64_t n = ThreadIndex(); n < num_nodes; n += NumThreads()) {
+    if (far[n] && distances[n] < threshold) {
+      far[n] = 0;
+      stamps[n] = stamp;
+      near[atomicAdd(near_size, 1u)] = static_cast<uint32_t>(n);
+    }
+  }
+}
+
+template <typename Weight>
+Weight
+Delta(unsigned delta_shift) {
+  if constexpr (std::is_floating_point_v<Weight>) {
+    return std::ldexp(Weight{1}, delta_shift);
+  } else {
+    // Keep delta below infinity, a quarter of the largest weight, so that
+    // thresholds do not overflow
+    unsigned max_shift = std::numeric_limits<Weight>::digits - 3;
+    return Weight{1} << std::min(delta_shift, max_shift);
+  }
+}
+
+/// The end of the bucket of min_far
+template <typename Weight>
+Weight
+NextThreshold(Weight min_far, Weight delta) {
+  Weight threshold;
+  if constexpr (std::is_floating_point_v<Weight>) {
+    threshold = (std::floor(min_far / delta) + 1) * delta;
+  } else {
+    threshold = (min_far / delta + 1) * delta;
+  }
+  // Rounding may not pass large float distances
+  if (!(threshold > min_far)) {
+    threshold = std::numeric_limits<Weight>::max();
+  }
+  return threshold;
+}
+
+//
+// Connected components
+//
+
+__global__ void
+CcInit(uint64_t num_nodes, uint32_t* components) {
+  for (uint64_t n = ThreadIndex(); n < num_nodes; n += NumThreads()) {
+    components[n] = static_cast<uint32_t>(n);
+  }
+}
+
+/// Join the trees of u and v by pointing the larger root to the smaller
+__device__ void
+Link(uint32_t u, uint32_t v, uint32_t* components) {
+  uint32_t p1 = LoadVolatile(&components[u]);
+  uint32_t p2 = LoadVolatile(&components[v]);
+  while (p1 != p2) {
+    uint32_t high = max(p1, p2);
+    uint32_t low = min(p1, p2);
+    uint32_t p_high = LoadVolatile(&components[high]);
+    if (p_high == low ||
+        (p_high == high && atomicCAS(&components[high], high, low) == high)) {
+      break;
+    }
+    p1 = LoadVolatile(&components[LoadVolatile(&components[high])]);
+    p2 = LoadVolatile(&components[low]);
+  }
+}
+
+/// Link each node to its neighbor at position r
+__global__ void
+CcLinkNeighbor(
+    const uint64_t* adj_indices, const uint32_t* dests, uint64_t num_nodes,
+    uint32_t r, uint32_t* components) {
+  for (uint64_t n = ThreadIndex(); n < num_nodes; n += NumThreads()) {
+    uint64_t e = EdgeBegin(adj_indices, n) + r;
+    if (e < adj_indices[n]) {
+      Link(n, dests[e], components);
+    }
+  }
+}
+
+/// Link the nodes outside of the component largest to their neighbors from
+/// position r on
+__global__ void
+CcLinkRemaining(
+    const uint64_t* adj_indices, const uint32_t* dests, uint64_t num_nodes,
+    uint32_t r, uint32_t largest, uint32_t* components) {
+  const uint64_t lane = threadIdx.x % kWarpSize;
+  for (uint64_t n = ThreadIndex() / kWarpSize; n < num_nodes;
+       n += NumThreads() / kWarpSize) {
+    if (LoadVolatile(&components[n]) == largest) {
+      continue;
+    }
+    for (uint64_t e = EdgeBegin(adj_indices, n) + r + lane;
+         e < adj_indices[n]; e += kWarpSize) {
+      Link(n, dests[e], components);
+    }
+  }
+}
+
+/// Point each node to the root of its tree
+__global__ void
+CcCompress(uint64_t num_nodes, uint32_t* components) {
+  for (uint64_t n = ThreadIndex(); n < num_nodes; n += NumThreads()) {
+    uint32_t parent = LoadVolatile(&components[n]);
+    uint32_t grandparent = LoadVolatile(&components[parent]);
+    while (parent != grandparent) {
+      parent = grandparent;
+      grandparent = LoadVolatile(&components[parent]);
+    }
+    components[n] = parent;
+  }
+}
+
+__global__ void
+CcGather(
+    const uint32_t* components, const uint32_t* samples, uint32_t num_samples,
+    uint32_t* out) {
+  for (uint64_t i = ThreadIndex(); i < num_samples; i += NumThreads()) {
+    out[i] = components[samples[i]];
+  }
+}
+
+/// The most frequent component of num_samples random nodes
+Status
+LargestComponent(
+    const DeviceArray<uint32_t>& components, uint64_t num_nodes,
+    uint32_t num_samples, uint32_t* largest) {
+  std::mt19937 gen;
+  std::uniform_int_distribution<uint32_t> dist(0, num_nodes - 1);
+  std::vector<uint32_t> samples(num_samples);
+  for (uint32_t& sample : samples) {
+    sample = dist(gen);
+  }
+  DeviceArray<uint32_t> d_samples;
+  DeviceArray<uint32_t> d_sampled;
+  GPU_CHECKED(d_samples.Upload(samples.data(), num_samples));
+  GPU_CHECKED(d_sampled.Allocate(num_samples));
+  CcGather<<<NumBlocks(num_samples), kBlockSize>>>(
+      components.data(), d_samples.data(), num_samples, d_sampled.data());
+  GPU_CHECKED(Launched("CcGather"));
+  GPU_CHECKED(d_sampled.Download(samples.data()));
+
+  std::unordered_map<uint32_t, uint32_t> counts;
+  uint32_t max_count = 0;
+  for (uint32_t component : samples) {
+    uint32_t count = ++counts[component];
+    if (count > max_count) {
+      max_count = count;
+      *largest = component;
+    }
+  }
+  return Status{};
+}
+
+//
+// Page Rank
+//
+
+__global__ void
+PrInit(uint64_t num_nodes, float initial, float* ranks) {
+  for (uint64_t n = ThreadIndex(); n < num_nodes; n += NumThreads()) {
+    ranks[n] = initial;
+  }
+}
+
+/// Add the rank of each node divided by its degree to the sums of its
+/// neighbors, a warp per node
+__global__ void
+PrPush(
+    const uint64_t* adj_indices, const uint32_t* dests, uint64_t num_nodes,
+    const float* ranks, float* sums) {
+  const uint64_t lane = threadIdx.x % kWarpSize;
+  for (uint64_t n = ThreadIndex() / kWarpSize; n < num_nodes;
+       n += NumThreads() / kWarpSize) {
+    uint64_t begin = EdgeBegin(adj_indices, n);
+    uint64_t end = adj_indices[n];
+    if (begin == end) {
+      continue;
+    }
+    float contribution = ranks[n] / (end - begin);
+    for (uint64_t e = begin + lane; e < end; e += kWarpSize) {
+      atomicAdd(&sums[dests[e]], contribution);
+    }
+  }
+}
+
+/// Set the ranks from the sums and raise max_delta, the bits of a
+/// non-negative float, to the largest change
+__global__ void
+PrUpdate(
+    uint64_t num_nodes, const float* sums, float alpha, float* ranks,
+    unsigned int* max_delta) {
+  float local_max = 0;
+  for (uint64_t n = ThreadIndex(); n < num_nodes; n += NumThreads()) {
+    float rank = (1 - alpha) + alpha * sums[n];
+    local_max = fmaxf(local_max, fabsf(rank - ranks[n]));
+    ranks[n] = rank;
+  }
+  for (unsigned offset = kWarpSize / 2; offset > 0; offset /= 2) {
+    local_max =
+        fmaxf(local_max, __shfl_down_sync(0xffffffff, local_max, offset));
+  }
+  if (threadIdx.x % kWarpSize == 0) {
+    // Non-negative floats are ordered like their bits
+    atomicMax(max_delta, __float_as_uint(local_max));
+  }
+}
+
+}  // namespace
+
+Status
+gpu::CheckDevice() {
+  int count = 0;
+  cudaError_t error = cudaGetDeviceCount(&count);
+  if (error != cudaSuccess) {
+    return Check(error, "cudaGetDeviceCount");
+  }
+  if (count == 0) {
+    return Status{StatusCode::kFailed, "no CUDA device"};
+  }
+  return Status{};
+}
+
+void
+gpu::ReleaseCache() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  CachedGraph() = DeviceGraph{};
+}
+
+Status
+gpu::Bfs(
+    const HostCsr& csr, uint32_t source, uint32_t infinity, uint32_t* parents,
+    const CancelledFn& cancelled) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  CacheRelease release(csr.cache);
+  DeviceGraph* graph = nullptr;
+  GPU_CHECKED(UseGraph(csr, &graph));
+  const uint64_t num_nodes = csr.num_nodes;
+
+  DeviceArray<uint32_t> d_parents;
+  DeviceArray<uint32_t> frontier;
+  DeviceArray<uint32_t> next;
+  DeviceArray<uint32_t> next_size;
+  GPU_CHECKED(d_parents.Allocate(num_nodes));
+  GPU_CHECKED(frontier.Allocate(num_nodes));
+  GPU_CHECKED(next.Allocate(num_nodes));
+  GPU_CHECKED(next_size.Allocate(1));
+
+  BfsInit<<<NumBlocks(num_nodes), kBlockSize>>>(
+      num_nodes, source, infinity, d_parents.data());
+  GPU_CHECKED(Launched("BfsInit"));
+  CUDA_CHECKED(cudaMemcpy(
+      frontier.data(), &source, sizeof(source), cudaMemcpyHostToDevice));
+
+  uint32_t frontier_size = 1;
+  while (frontier_size > 0) {
+    GPU_CHECKED(Cancelled(cancelled, "bfs"));
+    CUDA_CHECKED(cudaMemset(next_size.data(), 0, sizeof(uint32_t)));
+    BfsExpand<<<NumBlocks(uint64_t{frontier_size} * kWarpSize), kBlockSize>>>(
+        graph->adj_indices.data(), graph->dests.data(), frontier.data(),
+        frontier_size, infinity, d_parents.data(), next.data(),
+        next_size.data());
+    GPU_CHECKED(Launched("BfsExpand"));
+    CUDA_CHECKED(cudaMemcpy(
+        &frontier_size, next_size.data(), sizeof(frontier_size),
+        cudaMemcpyDeviceToHost));
+    std::swap(frontier, next);
+  }
+  return d_parents.Download(parents);
+}
+
+template <typename Weight>
+Status
+gpu::Sssp(
+    const HostCsr& csr, const Weight* weights, bool cache_weights,
+    uint32_t source, unsigned delta_shift, Weight infinity, Weight* distances,
+    const CancelledFn& cancelled) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  CacheRelease release(csr.cache);
+  DeviceGraph* graph = nullptr;
+  GPU_CHECKED(UseGraph(csr, &graph));
+  GPU_CHECKED(UseWeights(
+      graph, weights, csr.num_edges * sizeof(Weight),
+      csr.cache && cache_weights));
+  const uint64_t num_nodes = csr.num_nodes;
+  const Weight* d_weights =
+      reinterpret_cast<const Weight*>(graph->weights.data());
+
+  DeviceArray<Weight> d_distances;
+  DeviceArray<uint32_t> stamps;
+  DeviceArray<uint8_t> far;
+  DeviceArray<uint32_t> near;
+  DeviceArray<uint32_t> next;
+  DeviceArray<uint32_t> next_size;
+  DeviceArray<Weight> min_far;
+  GPU_CHECKED(d_distances.Allocate(num_nodes));
+  GPU_CHECKED(stamps.Allocate(num_nodes));
+  GPU_CHECKED(far.Allocate(num_nodes));
+  GPU_CHECKED(near.Allocate(num_nodes));
+  GPU_CHECKED(next.Allocate(num_nodes));
+  GPU_CHECKED(next_size.Allocate(1));
+  GPU_CHECKED(min_far.Allocate(1));
+
+  SsspInit<<<NumBlocks(num_nodes), kBlockSize>>>(
+      num_nodes, source, infinity, d_distances.data(), stamps.data(),
+      far.data());
+  GPU_CHECKED(Launched("SsspInit"));
+  CUDA_CHECKED(cudaMemcpy(
+      near.data(), &source, sizeof(source), cudaMemcpyHostToDevice));
+
+  const Weight delta = Delta<Weight>(delta_shift);
+  Weight threshold = delta;
+  uint32_t near_size = 1;
+  uint32_t round = 0;
+  for (;;) {
+    while (near_size > 0) {
+      GPU_CHECKED(Cancelled(cancelled, "sssp"));
+      CUDA_CHECKED(cudaMemset(next_size.data(), 0, sizeof(uint32_t)));
+      SsspRelax<<<NumBlocks(uint64_t{near_size} * kWarpSize), kBlockSize>>>(
+          graph->adj_indices.data(), graph->dests.data(), d_weights,
+          near.data(), near_size, threshold, round + 1, d_distances.data(),
+          stamps.data(), far.data(), next.data(), next_size.data());
+      GPU_CHECKED(Launched("SsspRelax"));
+      ++round;
+      CUDA_CHECKED(cudaMemcpy(
+          &near_size, next_size.data(), sizeof(near_size),
+          cudaMemcpyDeviceToHost));
+      std::swap(near, next);
+    }
+
+    Weight next_min = infinity;
+    GPU_CHECKED(min_far.Upload(&next_min, 1));
+    SsspFarMin<<<NumBlocks(num_nodes), kBlockSize>>>(
+        num_nodes, d_distances.data(), threshold, far.data(), min_far.data());
+    GPU_CHECKED(Launched("SsspFarMin"));
+    GPU_CHECKED(min_far.Download(&next_min));
+    if (!(next_min < infinity)) {
+      break;
+    }
+
+    // Skip the empty buckets up to that of the nearest far node
+    threshold = NextThreshold(next_min, delta);
+    CUDA_CHECKED(cudaMemset(next_size.data(), 0, sizeof(uint32_t)));
+    SsspSplit<<<NumBlocks(num_nodes), kBlockSize>>>(
+        num_nodes, d_distances.data(), threshold, round, far.data(),
+        stamps.data(), near.data(), next_size.data());
+    GPU_CHECKED(Launched("SsspSplit"));
+    CUDA_CHECKED(cudaMemcpy(
+        &near_size, next_size.data(), sizeof(near_size),
+        cudaMemcpyDeviceToHost));
+  }
+  return d_distances.Download(distances);
+}
+
+Status
+gpu::ConnectedComponents(
+    const HostCsr& csr, uint32_t neighbor_sample_size,
+    uint32_t component_sample_frequency, uint64_t* components) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  CacheRelease release(csr.cache);
+  DeviceGraph* graph = nullptr;
+  GPU_CHECKED(UseGraph(csr, &graph));
+  const uint64_t num_nodes = csr.num_nodes;
+  if (num_nodes == 0) {
+    return Status{};
+  }
+  const uint64_t* adj_indices = graph->adj_indices.data();
+  const uint32_t* dests = graph->dests.data();
+
+  DeviceArray<uint32_t> d_components;
+  GPU_CHECKED(d_components.Allocate(num_nodes));
+  CcInit<<<NumBlocks(num_nodes), kBlockSize>>>(
+      num_nodes, d_components.data());
+  GPU_CHECKED(Launched("CcInit"));
+
+  // Link a few neighbors of every node, which joins most of the largest
+  // component
+  for (uint32_t r = 0; r < neighbor_sample_size; ++r) {
+    CcLinkNeighbor<<<NumBlocks(num_nodes), kBlockSize>>>(
+        adj_indices, dests, num_nodes, r, d_components.data());
+    GPU_CHECKED(Launched("CcLinkNeighbor"));
+    CcCompress<<<NumBlocks(num_nodes), kBlockSize>>>(
+        num_nodes, d_components.data());
+    GPU_CHECKED(Launched("CcCompress"));
+  }
+
+  // The edges of the nodes of the largest component can then be skipped:
+  // the graph is symmetric, so the nodes outside of it link to it
+  uint32_t largest = kNoStamp;
+  if (component_sample_frequency > 0) {
+    GPU_CHECKED(LargestComponent(
+        d_components, num_nodes, component_sample_frequency, &largest));
+  }
+  CcLinkRemaining<<<NumBlocks(num_nodes * kWarpSize), kBlockSize>>>(
+      adj_indices, dests, num_nodes, neighbor_sample_size, largest,
+      d_components.data());
+  GPU_CHECKED(Launched("CcLinkRemaining"));
+  CcCompress<<<NumBlocks(num_nodes), kBlockSize>>>(
+      num_nodes, d_components.data());
+  GPU_CHECKED(Launched("CcCompress"));
+
+  DeviceArray<uint64_t> wide;
+  GPU_CHECKED(wide.Allocate(num_nodes));
+  Widen<<<NumBlocks(num_nodes), kBlockSize>>>(
+      d_components.data(), num_nodes, wide.data());
+  GPU_CHECKED(Launched("Widen"));
+  return wide.Download(components);
+}
+
+Status
+gpu::Pagerank(
+    const HostCsr& csr, float alpha, float tolerance, uint32_t max_iterations,
+    float* ranks, uint32_t* iterations, const CancelledFn& cancelled) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  CacheRelease release(csr.cache);
+  DeviceGraph* graph = nullptr;
+  GPU_CHECKED(UseGraph(csr, &graph));
+  const uint64_t num_nodes = csr.num_nodes;
+  *iterations = 0;
+  if (num_nodes == 0) {
+    return Status{};
+  }
+
+  DeviceArray<float> d_ranks;
+  DeviceArray<float> sums;
+  DeviceArray<unsigned int> max_delta;
+  GPU_CHECKED(d_ranks.Allocate(num_nodes));
+  GPU_CHECKED(sums.Allocate(num_nodes));
+  GPU_CHECKED(max_delta.Allocate(1));
+  PrInit<<<NumBlocks(num_nodes), kBlockSize>>>(
+      num_nodes, 1 - alpha, d_ranks.data());
+  GPU_CHECKED(Launched("PrInit"));
+
+  while (*iterations < max_iterations) {
+    GPU_CHECKED(Cancelled(cancelled, "pagerank"));
+    CUDA_CHECKED(cudaMemset(sums.data(), 0, num_nodes * sizeof(float)));
+    CUDA_CHECKED(cudaMemset(max_delta.data(), 0, sizeof(unsigned int)));
+    PrPush<<<NumBlocks(num_nodes * kWarpSize), kBlockSize>>>(
+        graph->adj_indices.data(), graph->dests.data(), num_nodes,
+        d_ranks.data(), sums.data());
+    GPU_CHECKED(Launched("PrPush"));
+    PrUpdate<<<NumBlocks(num_nodes), kBlockSize>>>(
+        num_nodes, sums.data(), alpha, d_ranks.data(), max_delta.data());
+    GPU_CHECKED(Launched("PrUpdate"));
+    ++*iterations;
+
+    unsigned int delta_bits = 0;
+    GPU_CHECKED(max_delta.Download(&delta_bits));
+    float delta;
+    std::memcpy(&delta, &delta_bits, sizeof(delta));
+    if (delta <= tolerance) {
+      break;
+    }
+  }
+  return d_ranks.Download(ranks);
+}
+
+namespace katana::analytics::gpu {
+
+template Status Sssp<uint32_t>(
+    const HostCsr&, const uint32_t*, bool, uint32_t, unsigned, uint32_t,
+    uint32_t*, const CancelledFn&);
+template Status Sssp<int32_t>(
+    const HostCsr&, const int32_t*, bool, uint32_t, unsigned, int32_t,
+    int32_t*, const CancelledFn&);
+template Status Sssp<uint64_t>(
+    const HostCsr&, const uint64_t*, bool, uint32_t, unsigned, uint64_t,
+    uint64_t*, const CancelledFn&);
+template Status Sssp<int64_t>(
+    const HostCsr&, const int64_t*, bool, uint32_t, unsigned, int64_t,
+    int64_t*, const CancelledFn&);
+template Status Sssp<float>(
+    const HostCsr&, const float*, bool, uint32_t, unsigned, float, float*,
+    const CancelledFn&);
+template Status Sssp<double>(
+    const HostCsr&, const double*, bool, uint32_t, unsigned, double, double*,
+    const CancelledFn&);
+
+}  // namespace katana::analytics::gpu
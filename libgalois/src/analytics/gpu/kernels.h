@@ -0,0 +1,88 @@
+#ifndef KATANA_LIBGALOIS_ANALYTICS_GPU_KERNELS_H_
+#define KATANA_LIBGALOIS_ANALYTICS_GPU_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// The device side of the GPU backend of the analytics. It is compiled by
+// nvcc, so it only sees plain arrays and reports failures with Status rather
+// than katana::Result; see gpu.cpp for the host side. Without
+// KATANA_ENABLE_CUDA these functions come from kernels_unavailable.cpp and
+// fail with StatusCode::kNotEnabled.
+
+namespace katana::analytics::gpu {
+
+enum class StatusCode {
+  kOk,
+  kNotEnabled,
+  kOutOfMemory,
+  kCancelled,
+  kFailed,
+};
+
+struct Status {
+  StatusCode code{StatusCode::kOk};
+  std::string message;
+
+  bool ok() const { return code == StatusCode::kOk; }
+};
+
+/// The host arrays of a CSR: edge e of node n is in [adj_indices[n - 1],
+/// adj_indices[n]), and exactly one of adj_indices and compact_adj_indices
+/// is set. If cache, the device copy is kept for the next call and found
+/// again by the addresses and sizes of the arrays, so the caller promises
+/// that they do not change in between; otherwise it is uploaded by every
+/// call and freed when the call returns.
+struct HostCsr {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  const uint64_t* adj_indices{nullptr};
+  const uint32_t* compact_adj_indices{nullptr};
+  const uint32_t* dests{nullptr};
+  bool cache{false};
+};
+
+/// Returns true if cancelled; may be empty
+using CancelledFn = std::function<bool()>;
+
+/// \returns kOk if there is a device to run on
+Status CheckDevice();
+
+/// Free the cached device copies of the last graph and edge weights
+void ReleaseCache();
+
+/// Level synchronous BFS from source. parents[n] is set to a node one level
+/// closer to source, source itself for source and infinity for the nodes
+/// that are not reached.
+Status Bfs(
+    const HostCsr& csr, uint32_t source, uint32_t infinity, uint32_t* parents,
+    const CancelledFn& cancelled);
+
+/// Near-far SSSP (Davidson et al., IPDPS 2014) from source with buckets of
+/// width 2^delta_shift. weights are the host weights of the edges of csr;
+/// they are kept on the device for the next call only if csr.cache and
+/// cache_weights, i.e., if they are not a temporary copy.
+template <typename Weight>
+Status Sssp(
+    const HostCsr& csr, const Weight* weights, bool cache_weights,
+    uint32_t source, unsigned delta_shift, Weight infinity, Weight* distances,
+    const CancelledFn& cancelled);
+
+/// Afforest connected components of a symmetric graph. components[n] is set
+/// to a node of the component of n.
+Status ConnectedComponents(
+    const HostCsr& csr, uint32_t neighbor_sample_size,
+    uint32_t component_sample_frequency, uint64_t* components);
+
+/// Topology driven Page Rank: rank = (1 - alpha) + alpha * (sum of rank /
+/// out degree of the in neighbors), from rank = 1 - alpha, until no rank
+/// changes more than tolerance or after max_iterations
+Status Pagerank(
+    const HostCsr& csr, float alpha, float tolerance, uint32_t max_iterations,
+    float* ranks, uint32_t* iterations, const CancelledFn& cancelled);
+
+}  // namespace katana::analytics::gpu
+
+#endif
@@ -0,0 +1,74 @@
+#include "kernels.h"
+
+namespace gpu = katana::analytics::gpu;
+
+using gpu::HostCsr;
+using gpu::Status;
+using gpu::StatusCode;
+
+namespace {
+
+Status
+NotEnabled() {
+  return Status{
+      StatusCode::kNotEnabled, "GPU analytics need KATANA_ENABLE_CUDA"};
+}
+
+}  // namespace
+
+Status
+gpu::CheckDevice() {
+  return NotEnabled();
+}
+
+void
+gpu::ReleaseCache() {}
+
+Status
+gpu::Bfs(
+    const HostCsr&, uint32_t, uint32_t, uint32_t*, const CancelledFn&) {
+  return NotEnabled();
+}
+
+template <typename Weight>
+Status
+gpu::Sssp(
+    const HostCsr&, const Weight*, bool, uint32_t, unsigned, Weight, Weight*,
+    const CancelledFn&) {
+  return NotEnabled();
+}
+
+Status
+gpu::ConnectedComponents(const HostCsr&, uint32_t, uint32_t, uint64_t*) {
+  return NotEnabled();
+}
+
+Status
+gpu::Pagerank(
+    const HostCsr&, float, float, uint32_t, float*, uint32_t*,
+    const CancelledFn&) {
+  return NotEnabled();
+}
+
+namespace katana::analytics::gpu {
+
+template Status Sssp<uint32_t>(
+    const HostCsr&, const uint32_t*, bool, uint32_t, unsigned, uint32_t,
+    uint32_t*, const CancelledFn&);
+template Status Sssp<int32_t>(
+    const HostCsr&, const int32_t*, bool, uint32_t, unsigned, int32_t,
+    int32_t*, const CancelledFn&);
+template Status Sssp<uint64_t>(
+    const HostCsr&, const uint64_t*, bool, uint32_t, unsigned, uint64_t,
+    uint64_t*, const CancelledFn&);
+template Status Sssp<int64_t>(
+    const HostCsr&, const int64_t*, bool, uint32_t, unsigned, int64_t,
+    int64_t*, const CancelledFn&);
+template Status Sssp<float>(
+    const HostCsr&, const float*, bool, uint32_t, unsigned, float, float*,
+    const CancelledFn&);
+template Status Sssp<double>(
+    const HostCsr&, const double*, bool, uint32_t, unsigned, double, double*,
+    const CancelledFn&);
+
+}  // namespace katana::analytics::gpu
@@ -0,0 +1,202 @@
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../independent_set/priority.h"
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct NodeColor : public katana::PODProperty<uint32_t> {};
+
+using ColorGraph =
+    katana::TypedPropertyGraph<std::tuple<NodeColor>, std::tuple<>>;
+using GNode = ColorGraph::Node;
+
+constexpr uint32_t kUncolored = std::numeric_limits<uint32_t>::max();
+
+/// Rounds over the uncolored nodes in two phases: first the nodes that beat
+/// all of their uncolored neighbors are picked, then they take the smallest
+/// color none of their neighbors has. The picked nodes are not neighbors, so
+/// the colors a picked node reads do not change during the second phase.
+void
+ColorByPriority(ColorGraph* graph, GraphColoringPlan::Algorithm algorithm) {
+  using Bag = katana::InsertBag<GNode>;
+
+  katana::NUMAArray<uint64_t> priority;
+  priority.allocateBlocked(graph->size());
+
+  auto cur = std::make_unique<Bag>();
+  auto next = std::make_unique<Bag>();
+  Bag picked;
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& src) {
+        uint32_t key = 0;
+        if (algorithm == GraphColoringPlan::kLargestDegreeFirst) {
+          key = std::min<uint64_t>(
+              graph->edges(src).size(), std::numeric_limits<uint32_t>::max());
+        }
+        priority[src] = NodePriority(key, src);
+        graph->GetData<NodeColor>(src) = kUncolored;
+        cur->push(src);
+      },
+      katana::loopname("GraphColoring-init-prio"));
+
+  // marks of the colors of the neighbors of a node, reset after each use
+  katana::PerThreadStorage<std::vector<uint8_t>> neighbor_colors;
+
+  size_t rounds = 0;
+  while (!cur->empty()) {
+    katana::do_all(
+        katana::iterate(*cur),
+        [&](const GNode& src) {
+          for (auto edge : graph->edges(src)) {
+            auto dest = graph->GetEdgeDest(edge);
+            if (*dest != src &&
+                graph->GetData<NodeColor>(dest) == kUncolored &&
+                priority[*dest] > priority[src]) {
+              next->push(src);
+              return;
+            }
+          }
+          picked.push(src);
+        },
+        katana::loopname("GraphColoring-pick"), katana::steal());
+
+    katana::do_all(
+        katana::iterate(picked),
+        [&](const GNode& src) {
+          std::vector<uint8_t>& used = *neighbor_colors.getLocal();
+          // a node of degree d has a free color among the first d + 1
+          size_t num_candidates = graph->edges(src).size() + 1;
+          if (used.size() < num_candidates) {
+            used.resize(num_candidates);
+          }
+          auto mark = [&](uint8_t value) {
+            for (auto edge : graph->edges(src)) {
+              auto dest = graph->GetEdgeDest(edge);
+              uint32_t color = graph->GetData<NodeColor>(dest);
+              if (color < num_candidates) {
+                used[color] = value;
+              }
+            }
+          };
+          mark(1);
+          graph->GetData<NodeColor>(src) =
+              std::find(used.begin(), used.begin() + num_candidates, 0) -
+              used.begin();
+          mark(0);
+        },
+        katana::loopname("GraphColoring-color"), katana::steal());
+
+    picked.clear();
+    cur->clear();
+    std::swap(cur, next);
+    rounds += 1;
+  }
+
+  katana::ReportStatSingle("GraphColoring", "rounds", rounds);
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::GraphColoring(
+    PropertyGraph* pg, const std::string& output_property_name,
+    GraphColoringPlan plan) {
+  if (plan.algorithm() != GraphColoringPlan::kJonesPlassmann &&
+      plan.algorithm() != GraphColoringPlan::kLargestDegreeFirst) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeColor>>(
+      pg, {output_property_name}));
+  auto graph =
+      KATANA_CHECKED(ColorGraph::Make(pg, {output_property_name}, {}));
+
+  katana::StatTimer exec_time("GraphColoring");
+  exec_time.start();
+  ColorByPriority(&graph, plan.algorithm());
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::GraphColoringAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(ColorGraph::Make(pg, {property_name}, {}));
+
+  auto is_bad = [&](const GNode& src) {
+    uint32_t color = graph.GetData<NodeColor>(src);
+    for (auto edge : graph.edges(src)) {
+      auto dest = graph.GetEdgeDest(edge);
+      if (*dest != src && graph.GetData<NodeColor>(dest) == color) {
+        return true;
+      }
+    }
+    return false;
+  };
+  if (katana::ParallelSTL::find_if(graph.begin(), graph.end(), is_bad) !=
+      graph.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "some edge joins two nodes of the same color");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<GraphColoringStatistics>
+katana::analytics::GraphColoringStatistics::Compute(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(ColorGraph::Make(pg, {property_name}, {}));
+
+  // a proper coloring needs no more colors than there are nodes
+  std::vector<uint64_t> class_sizes(graph.num_nodes());
+  uint32_t num_colors = 0;
+  for (const GNode& n : graph) {
+    uint32_t color = graph.GetData<NodeColor>(n);
+    if (color >= class_sizes.size()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "color {} of node {} is not less than the number of nodes", color,
+          n);
+    }
+    class_sizes[color] += 1;
+    num_colors = std::max(num_colors, color + 1);
+  }
+
+  uint64_t largest_color_class_size = 0;
+  for (uint64_t size : class_sizes) {
+    largest_color_class_size = std::max(largest_color_class_size, size);
+  }
+  return GraphColoringStatistics{num_colors, largest_color_class_size};
+}
+
+void
+katana::analytics::GraphColoringStatistics::Print(std::ostream& os) const {
+  os << "Number of colors = " << num_colors << std::endl;
+  os << "Largest color class size = " << largest_color_class_size
+     << std::endl;
+}
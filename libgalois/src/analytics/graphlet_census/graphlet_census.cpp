@@ -0,0 +1,246 @@
+#include "katana/analytics/graphlet_census/graphlet_census.h"
+
+#include <atomic>
+#include <tuple>
+#include <vector>
+
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/SetIntersection.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/k_clique/k_clique.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using EdgesSortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
+using Node = EdgesSortedGraphView::Node;
+
+struct NodeFourCycleCount : public katana::PODProperty<uint64_t> {};
+
+using CountGraph =
+    katana::TypedPropertyGraph<std::tuple<NodeFourCycleCount>, std::tuple<>>;
+
+constexpr static const unsigned kChunkSize = 64U;
+
+/// The number of paths of 2 edges from a node to each other node, and the
+/// nodes with any
+struct WedgeCounts {
+  std::vector<uint32_t> counts;
+  std::vector<Node> touched;
+};
+
+const Node*
+EdgeDests(const EdgesSortedGraphView& view, Node n) {
+  return view.dest_data() + *view.edges(n).begin();
+}
+
+uint64_t
+Choose2(uint64_t n) {
+  return n * (n - 1) / 2;
+}
+
+uint64_t
+Choose3(uint64_t n) {
+  return n < 3 ? 0 : n * (n - 1) * (n - 2) / 6;
+}
+
+/// \returns the number of cycles of 4 edges and, if counts is not null, adds
+/// to the count of each node the cycles through it. A cycle is counted at
+/// its node u of highest degree: the other nodes are of lower degree, so it
+/// is a pair of paths u, v, w of 2 edges to the node w opposite u.
+uint64_t
+CountFourCycles(
+    const EdgesSortedGraphView& view,
+    katana::NUMAArray<std::atomic<uint64_t>>* counts) {
+  auto higher = [&](Node a, Node b) {
+    size_t a_degree = view.degree(a);
+    size_t b_degree = view.degree(b);
+    return a_degree > b_degree || (a_degree == b_degree && a > b);
+  };
+  // Calls fn(v, w) for each path u, v, w whose nodes u is higher than
+  auto for_each_wedge = [&](Node u, auto fn) {
+    for (auto e : view.edges(u)) {
+      Node v = view.edge_dest(e);
+      if (!higher(u, v)) {
+        continue;
+      }
+      for (auto f : view.edges(v)) {
+        Node w = view.edge_dest(f);
+        if (w != u && higher(u, w)) {
+          fn(v, w);
+        }
+      }
+    }
+  };
+
+  katana::GAccumulator<uint64_t> total;
+  katana::PerThreadStorage<WedgeCounts> per_thread_wedges;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, view.num_nodes()),
+      [&](uint64_t u) {
+        WedgeCounts& wedges = *per_thread_wedges.getLocal();
+        if (wedges.counts.size() < view.num_nodes()) {
+          wedges.counts.resize(view.num_nodes());
+        }
+        for_each_wedge(u, [&](Node, Node w) {
+          if (wedges.counts[w]++ == 0) {
+            wedges.touched.push_back(w);
+          }
+        });
+
+        uint64_t cycles = 0;
+        for (Node w : wedges.touched) {
+          uint64_t w_cycles = Choose2(wedges.counts[w]);
+          cycles += w_cycles;
+          if (counts && w_cycles) {
+            (*counts)[w].fetch_add(w_cycles, std::memory_order_relaxed);
+          }
+        }
+        if (counts && cycles) {
+          (*counts)[u].fetch_add(cycles, std::memory_order_relaxed);
+          // v is on a cycle with each other path to w
+          for_each_wedge(u, [&](Node v, Node w) {
+            if (wedges.counts[w] > 1) {
+              (*counts)[v].fetch_add(
+                  wedges.counts[w] - 1, std::memory_order_relaxed);
+            }
+          });
+        }
+
+        for (Node w : wedges.touched) {
+          wedges.counts[w] = 0;
+        }
+        wedges.touched.clear();
+        total += cycles;
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("GraphletCensus-FourCycles"));
+  return total.reduce();
+}
+
+}  // namespace
+
+katana::Result<FourNodeGraphletCensus>
+katana::analytics::FourNodeGraphletCensus::Compute(PropertyGraph* pg) {
+  EdgesSortedGraphView view = pg->BuildView<EdgesSortedGraphView>();
+
+  katana::StatTimer exec_time("FourNodeGraphletCensus");
+  exec_time.start();
+
+  // Twice the triangles at each node, one for each of its two edges
+  katana::NUMAArray<std::atomic<uint64_t>> triangles;
+  triangles.allocateBlocked(view.num_nodes());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, view.num_nodes()),
+      [&](uint64_t u) { triangles[u].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+
+  katana::GAccumulator<uint64_t> stars;
+  katana::GAccumulator<uint64_t> edge_paths;
+  katana::GAccumulator<uint64_t> edge_triangles;
+  katana::GAccumulator<uint64_t> diamonds;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, view.num_nodes()),
+      [&](uint64_t u) {
+        uint64_t u_degree = view.degree(u);
+        stars += Choose3(u_degree);
+        for (auto e : view.edges(u)) {
+          Node v = view.edge_dest(e);
+          if (v <= u) {
+            continue;
+          }
+          uint64_t v_degree = view.degree(v);
+          uint64_t t = katana::IntersectionSize(
+              EdgeDests(view, u), u_degree, EdgeDests(view, v), v_degree);
+          edge_paths += (u_degree - 1) * (v_degree - 1);
+          edge_triangles += t;
+          diamonds += Choose2(t);
+          if (t) {
+            triangles[u].fetch_add(t, std::memory_order_relaxed);
+            triangles[v].fetch_add(t, std::memory_order_relaxed);
+          }
+        }
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("GraphletCensus-Triangles"));
+
+  katana::GAccumulator<uint64_t> tailed_triangles;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, view.num_nodes()),
+      [&](uint64_t u) {
+        uint64_t u_triangles = triangles[u].load(std::memory_order_relaxed) / 2;
+        if (u_triangles) {
+          tailed_triangles += u_triangles * (view.degree(u) - 2);
+        }
+      },
+      katana::no_stats());
+
+  uint64_t cycles = CountFourCycles(view, nullptr);
+  exec_time.stop();
+  uint64_t cliques = KATANA_CHECKED(KCliqueCount(pg, 4));
+
+  // The counts so far are of the graphlets as subgraphs, not necessarily
+  // induced; take out the copies of each in the denser ones. A 4-clique has
+  // 6 diamonds, 3 cycles, 12 tailed triangles, 4 stars and 12 paths, a
+  // diamond 1 cycle, 4 tailed triangles, 2 stars and 6 paths, a tailed
+  // triangle 1 star and 2 paths, and a cycle 4 paths. A path in which
+  // edge_paths counts a triangle is not a path; each triangle is counted
+  // once for each of its edges.
+  FourNodeGraphletCensus census{};
+  census.cliques = cliques;
+  census.diamonds = diamonds.reduce() - 6 * cliques;
+  census.cycles = cycles - census.diamonds - 3 * cliques;
+  census.tailed_triangles =
+      tailed_triangles.reduce() - 4 * census.diamonds - 12 * cliques;
+  census.stars = stars.reduce() - census.tailed_triangles -
+                 2 * census.diamonds - 4 * cliques;
+  census.paths = edge_paths.reduce() - edge_triangles.reduce() -
+                 2 * census.tailed_triangles - 4 * census.cycles -
+                 6 * census.diamonds - 12 * cliques;
+  return census;
+}
+
+void
+katana::analytics::FourNodeGraphletCensus::Print(std::ostream& os) const {
+  os << "Number of paths = " << paths << std::endl;
+  os << "Number of stars = " << stars << std::endl;
+  os << "Number of cycles = " << cycles << std::endl;
+  os << "Number of tailed triangles = " << tailed_triangles << std::endl;
+  os << "Number of diamonds = " << diamonds << std::endl;
+  os << "Number of cliques = " << cliques << std::endl;
+}
+
+katana::Result<void>
+katana::analytics::FourCycleCountPerNode(
+    PropertyGraph* pg, const std::string& output_property_name) {
+  EdgesSortedGraphView view = pg->BuildView<EdgesSortedGraphView>();
+
+  katana::NUMAArray<std::atomic<uint64_t>> counts;
+  counts.allocateBlocked(view.num_nodes());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, view.num_nodes()),
+      [&](uint64_t u) { counts[u].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::StatTimer exec_time("FourCycleCountPerNode");
+  exec_time.start();
+  CountFourCycles(view, &counts);
+  exec_time.stop();
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeFourCycleCount>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED(CountGraph::Make(pg, {output_property_name}, {}));
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const CountGraph::Node& u) {
+        graph.GetData<NodeFourCycleCount>(u) =
+            counts[u].load(std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  return katana::ResultSuccess();
+}
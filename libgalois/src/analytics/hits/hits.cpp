@@ -0,0 +1,208 @@
+#include "katana/analytics/hits/hits.h"
+
+#include <cmath>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/SpMV.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct NodeHub : public katana::PODProperty<double> {};
+struct NodeAuthority : public katana::PODProperty<double> {};
+
+using HitsGraph = katana::TypedPropertyGraph<
+    std::tuple<NodeHub, NodeAuthority>, std::tuple<>>;
+using GNode = HitsGraph::Node;
+
+using Scores = katana::NUMAArray<double>;
+
+/// Scale scores to sum to 1, unless they are all 0
+void
+Normalize(Scores* scores) {
+  katana::GAccumulator<double> sum;
+  katana::do_all(
+      katana::iterate(size_t{0}, scores->size()),
+      [&](size_t n) { sum += (*scores)[n]; }, katana::no_stats());
+  double total = sum.reduce();
+  if (total == 0) {
+    return;
+  }
+  katana::do_all(
+      katana::iterate(size_t{0}, scores->size()),
+      [&](size_t n) { (*scores)[n] /= total; }, katana::no_stats());
+}
+
+AdjacencyProducts::Kernel
+KernelOf(HitsPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case HitsPlan::kBlocked:
+    return AdjacencyProducts::kBlocked;
+  case HitsPlan::kPush:
+    return AdjacencyProducts::kPush;
+  default:
+    return AdjacencyProducts::kPull;
+  }
+}
+
+void
+ComputeHits(
+    katana::PropertyGraph* pg, HitsPlan plan, Scores* hub, Scores* authority) {
+  size_t num_nodes = pg->num_nodes();
+  AdjacencyProducts products(pg, KernelOf(plan.algorithm()));
+
+  Scores next_hub;
+  next_hub.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { (*hub)[n] = 1.0 / num_nodes; }, katana::no_stats());
+
+  uint32_t iteration = 0;
+  while (iteration < plan.max_iterations()) {
+    products.MultiplyTransposed(*hub, authority, "Hits-authority");
+    Normalize(authority);
+    products.Multiply(*authority, &next_hub, "Hits-hub");
+    Normalize(&next_hub);
+
+    katana::GAccumulator<double> change;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) { change += std::fabs(next_hub[n] - (*hub)[n]); },
+        katana::no_stats());
+    std::swap(*hub, next_hub);
+    iteration += 1;
+    if (change.reduce() <= plan.tolerance()) {
+      break;
+    }
+  }
+
+  katana::ReportStatSingle("Hits", "Iterations", iteration);
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::Hits(
+    PropertyGraph* pg, const std::string& hub_property_name,
+    const std::string& authority_property_name, HitsPlan plan) {
+  if (plan.algorithm() != HitsPlan::kPull &&
+      plan.algorithm() != HitsPlan::kBlocked &&
+      plan.algorithm() != HitsPlan::kPush) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  Scores hub;
+  Scores authority;
+  hub.allocateBlocked(pg->num_nodes());
+  authority.allocateBlocked(pg->num_nodes());
+
+  katana::StatTimer exec_time("Hits");
+  exec_time.start();
+  ComputeHits(pg, plan, &hub, &authority);
+  exec_time.stop();
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeHub, NodeAuthority>>(
+      pg, {hub_property_name, authority_property_name}));
+  auto graph = KATANA_CHECKED(HitsGraph::Make(
+      pg, {hub_property_name, authority_property_name}, {}));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        graph.GetData<NodeHub>(n) = hub[n];
+        graph.GetData<NodeAuthority>(n) = authority[n];
+      },
+      katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::HitsAssertValid(
+    PropertyGraph* pg, const std::string& hub_property_name,
+    const std::string& authority_property_name) {
+  auto graph = KATANA_CHECKED(HitsGraph::Make(
+      pg, {hub_property_name, authority_property_name}, {}));
+
+  katana::GAccumulator<double> hub_sum;
+  katana::GAccumulator<double> authority_sum;
+  katana::GReduceLogicalOr negative;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        double hub = graph.GetData<NodeHub>(n);
+        double authority = graph.GetData<NodeAuthority>(n);
+        hub_sum += hub;
+        authority_sum += authority;
+        negative.update(hub < 0 || authority < 0);
+      },
+      katana::no_stats());
+
+  if (negative.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "some score is negative");
+  }
+  double expected = graph.num_edges() > 0 ? 1 : 0;
+  for (double sum : {hub_sum.reduce(), authority_sum.reduce()}) {
+    if (std::fabs(sum - expected) > 1e-6) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "scores sum to {} rather than {}", sum, expected);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<HitsStatistics>
+katana::analytics::HitsStatistics::Compute(
+    PropertyGraph* pg, const std::string& hub_property_name,
+    const std::string& authority_property_name) {
+  auto graph = KATANA_CHECKED(HitsGraph::Make(
+      pg, {hub_property_name, authority_property_name}, {}));
+
+  katana::GReduceMax<double> max_hub;
+  katana::GReduceMax<double> max_authority;
+  katana::GAccumulator<uint64_t> num_hubs;
+  katana::GAccumulator<uint64_t> num_authorities;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        double hub = graph.GetData<NodeHub>(n);
+        double authority = graph.GetData<NodeAuthority>(n);
+        max_hub.update(hub);
+        max_authority.update(authority);
+        if (hub > 0) {
+          num_hubs += 1;
+        }
+        if (authority > 0) {
+          num_authorities += 1;
+        }
+      },
+      katana::no_stats());
+
+  if (graph.num_nodes() == 0) {
+    return HitsStatistics{0, 0, 0, 0};
+  }
+  return HitsStatistics{
+      max_hub.reduce(), max_authority.reduce(), num_hubs.reduce(),
+      num_authorities.reduce()};
+}
+
+void
+katana::analytics::HitsStatistics::Print(std::ostream& os) const {
+  os << "Maximum hub score = " << max_hub_score << std::endl;
+  os << "Maximum authority score = " << max_authority_score << std::endl;
+  os << "Number of hubs = " << num_hubs << std::endl;
+  os << "Number of authorities = " << num_authorities << std::endl;
+}
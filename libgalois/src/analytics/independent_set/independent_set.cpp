@@ -19,19 +19,23 @@
 
 #include "katana/analytics/independent_set/independent_set.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "katana/Bag.h"
 #include "katana/Galois.h"
+#include "katana/NUMAArray.h"
 #include "katana/ParallelSTL.h"
 #include "katana/Properties.h"
 #include "katana/Reduction.h"
 #include "katana/Timer.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
+#include "priority.h"
 
 namespace {
 
@@ -40,13 +44,6 @@ using namespace katana::analytics;
 constexpr int kChunkSize = 64;
 constexpr float kHashScale = 1.0 / std::numeric_limits<unsigned int>::max();
 
-unsigned int
-hash(unsigned int val) {
-  val = ((val >> 16) ^ val) * 0x45d9f3b;
-  val = ((val >> 16) ^ val) * 0x45d9f3b;
-  return (val >> 16) ^ val;
-}
-
 enum MatchFlag : char {
   KOtherMatched = false,
   kMatched = true,
@@ -101,96 +98,6 @@ struct SerialAlgo {
   }
 };
 
-template <IndependentSetPlan::Algorithm algo>
-struct TransactionalAlgo {
-  struct NodeFlag : public katana::PODProperty<uint8_t, MatchFlag> {};
-  using NodeData = std::tuple<NodeFlag>;
-  using EdgeData = std::tuple<>;
-
-  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
-  typedef typename Graph::Node GNode;
-
-  void Initialize(Graph* graph) {
-    for (auto n : *graph) {
-      graph->template GetData<NodeFlag>(n) = MatchFlag::KUnMatched;
-    }
-  }
-
-  struct LocalState {
-    bool mod{false};
-    explicit LocalState() = default;
-  };
-
-  bool build(const Graph& graph, GNode src) {
-    auto& src_flag = graph.template GetData<NodeFlag>(src);
-    if (src_flag != MatchFlag::KUnMatched) {
-      return false;
-    }
-
-    for (auto ii : graph.edges(src)) {
-      auto dest = graph.GetEdgeDest(ii);
-      auto& dest_flag = graph.template GetData<NodeFlag>(dest);
-      if (dest_flag == MatchFlag::kMatched) {
-        return false;
-      }
-    }
-    return true;
-  }
-
-  void modify(Graph* graph, GNode src) {
-    auto& src_flag = graph->template GetData<NodeFlag>(src);
-    for (auto ii : graph->edges(src)) {
-      auto dest = graph->GetEdgeDest(ii);
-      auto& dest_flag = graph->template GetData<NodeFlag>(dest);
-      dest_flag = MatchFlag::KOtherMatched;
-    }
-    src_flag = MatchFlag::kMatched;
-  }
-
-  template <typename C>
-  void processNode(Graph* graph, const GNode& src, C& ctx) {
-    bool mod = build(*graph, src);
-    [[maybe_unused]] auto& src_flag = graph->template GetData<NodeFlag>(src);
-    ctx.cautiousPoint();  // Failsafe point
-
-    if (mod) {
-      modify(graph, src);
-    }
-  }
-
-  template <typename WL, typename... Args>
-  void run(Graph* graph, Args&&... args) {
-    auto detID = [](const GNode& x) { return x; };
-
-    katana::for_each(
-        katana::iterate(*graph),
-        [&, this](const GNode& src, auto& ctx) {
-          this->processNode(graph, src, ctx);
-        },
-        katana::no_pushes(), katana::wl<WL>(), katana::loopname("DefaultAlgo"),
-        katana::det_id<decltype(detID)>(detID),
-        katana::local_state<LocalState>(), std::forward<Args>(args)...);
-  }
-
-  void operator()(Graph* graph [[maybe_unused]]) {
-    //    using DWL = katana::Deterministic<>;
-    //
-    //    using BSWL = katana::BulkSynchronous<
-    //        typename katana::PerSocketChunkFIFO<kChunkSize>>;
-
-    switch (algo) {
-      //    case kNondeterministic:
-      //      run<BSWL>(graph);
-      //      break;
-      //    case kDeterministicBase:
-      //      run<DWL>(graph);
-      //      break;
-    default:
-      static_assert(algo == -1, "Unknown algorithm");
-    }
-  }
-};
-
 struct PullAlgo {
   struct NodeFlag : public katana::PODProperty<uint8_t, MatchFlag> {};
   using NodeData = std::tuple<NodeFlag>;
@@ -351,7 +258,7 @@ struct PrioAlgo {
         [&](const GNode& src) {
           auto& src_flag = graph->GetData<NodeFlag>(src);
           float degree = graph->edges(src).size();
-          float x = degree - hash(src) * kHashScale;
+          float x = degree - PriorityHash(src) * kHashScale;
           int res = round(scale_avg / (avg_degree + x));
           uint8_t val = (res + res) | 1;
           src_flag = val;
@@ -451,7 +358,7 @@ struct EdgeTiledPrioAlgo {
           const auto end = graph->edge_end(src);
 
           float degree = float(graph->edges(src).size());
-          float x = degree - hash(src) * kHashScale;
+          float x = degree - PriorityHash(src) * kHashScale;
           int res = round(scale_avg / (avg_degree + x));
           uint8_t val = (res + res) | 0x03;
 
@@ -561,6 +468,94 @@ struct EdgeTiledPrioAlgo {
   }
 };
 
+/// Rounds over the undecided nodes in two phases, so that the reads of a
+/// round only see the flags of the previous one: first the nodes that beat
+/// all of their undecided neighbors are picked, then they join the set and
+/// their neighbors leave it. The priorities are those of NodePriority, with
+/// the nodes of lower degree first, so the set found is the one the serial
+/// greedy algorithm finds by visiting the nodes in order of priority,
+/// whatever the number of threads.
+struct DeterministicPrioAlgo {
+  struct NodeFlag : public katana::PODProperty<uint8_t, MatchFlag> {};
+  using NodeData = std::tuple<NodeFlag>;
+  using EdgeData = std::tuple<>;
+
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+  typedef typename Graph::Node GNode;
+
+  using Bag = katana::InsertBag<GNode>;
+
+  void Initialize(Graph* graph) {
+    for (auto n : *graph) {
+      graph->GetData<NodeFlag>(n) = MatchFlag::KUnMatched;
+    }
+  }
+
+  void operator()(Graph* graph) {
+    katana::NUMAArray<uint64_t> priority;
+    priority.allocateBlocked(graph->size());
+
+    auto cur = std::make_unique<Bag>();
+    auto next = std::make_unique<Bag>();
+    Bag picked;
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& src) {
+          uint64_t degree = graph->edges(src).size();
+          uint32_t key = std::numeric_limits<uint32_t>::max() -
+                         std::min<uint64_t>(
+                             degree, std::numeric_limits<uint32_t>::max());
+          priority[src] = NodePriority(key, src);
+          cur->push(src);
+        },
+        katana::loopname("IndependentSet-init-prio"));
+
+    size_t rounds = 0;
+    while (!cur->empty()) {
+      katana::do_all(
+          katana::iterate(*cur),
+          [&](const GNode& src) {
+            if (graph->GetData<NodeFlag>(src) != MatchFlag::KUnMatched) {
+              return;
+            }
+            for (auto edge : graph->edges(src)) {
+              auto dest = graph->GetEdgeDest(edge);
+              if (*dest != src &&
+                  graph->GetData<NodeFlag>(dest) == MatchFlag::KUnMatched &&
+                  priority[*dest] > priority[src]) {
+                next->push(src);
+                return;
+              }
+            }
+            picked.push(src);
+          },
+          katana::loopname("IndependentSet-pick"), katana::steal());
+
+      katana::do_all(
+          katana::iterate(picked),
+          [&](const GNode& src) {
+            graph->GetData<NodeFlag>(src) = MatchFlag::kMatched;
+            for (auto edge : graph->edges(src)) {
+              auto dest = graph->GetEdgeDest(edge);
+              if (*dest != src) {
+                graph->GetData<NodeFlag>(dest) = MatchFlag::KOtherMatched;
+              }
+            }
+          },
+          katana::loopname("IndependentSet-match"), katana::steal());
+
+      picked.clear();
+      cur->clear();
+      std::swap(cur, next);
+      rounds += 1;
+    }
+
+    katana::ReportStatSingle(
+        "IndependentSet-DeterministicPrioAlgo", "rounds", rounds);
+  }
+};
+
 struct IsBad {
   struct NodeFlag : public katana::PODProperty<uint8_t> {};
   using NodeData = std::tuple<NodeFlag>;
@@ -672,6 +667,8 @@ katana::analytics::IndependentSet(
     return Run<PrioAlgo>(pg, output_property_name);
   case IndependentSetPlan::kEdgeTiledPriority:
     return Run<EdgeTiledPrioAlgo>(pg, output_property_name);
+  case IndependentSetPlan::kDeterministicPriority:
+    return Run<DeterministicPrioAlgo>(pg, output_property_name);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
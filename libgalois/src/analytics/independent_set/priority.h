@@ -0,0 +1,30 @@
+#ifndef KATANA_LIBGALOIS_ANALYTICS_INDEPENDENTSET_PRIORITY_H_
+#define KATANA_LIBGALOIS_ANALYTICS_INDEPENDENTSET_PRIORITY_H_
+
+#include <cstdint>
+
+namespace katana::analytics {
+
+/// Mix the bits of val. Each step (a xor with a shift, or a product with an
+/// odd number) is invertible, so distinct values have distinct hashes, which
+/// order nodes in a way that looks random but only depends on their ids.
+inline uint32_t
+PriorityHash(uint32_t val) {
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  return (val >> 16) ^ val;
+}
+
+/// The priority of node in the algorithms that pick the nodes that beat all
+/// their undecided neighbors: nodes of a greater key win, and ties are broken
+/// by PriorityHash. As that is a bijection, no two nodes have the same
+/// priority, and the nodes picked depend only on the graph, not on the
+/// schedule of the threads.
+inline uint64_t
+NodePriority(uint32_t key, uint32_t node) {
+  return (uint64_t{key} << 32) | PriorityHash(node);
+}
+
+}  // namespace katana::analytics
+
+#endif
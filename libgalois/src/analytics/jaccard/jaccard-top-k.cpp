@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/EpochArray.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "katana/analytics/jaccard/jaccard.h"
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using Node = BiDirView::Node;
+using Candidate = std::pair<uint32_t, double>;
+using TopK = std::vector<Candidate>;
+
+/// Hash functions of the signatures are Mix(node ^ Mix(kSeed + i))
+constexpr uint64_t kSeed = 0x9e3779b97f4a7c15;
+
+/// The finalizer of splitmix64
+uint64_t
+Mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+/// Orders candidates by decreasing similarity and then by increasing node id
+bool
+Better(const Candidate& a, const Candidate& b) {
+  return a.second != b.second ? a.second > b.second : a.first < b.first;
+}
+
+/// The best k candidates pushed so far, in a heap whose top is the worst of
+/// them
+class BoundedHeap {
+public:
+  void Reset(size_t k) {
+    k_ = k;
+    heap_.clear();
+  }
+
+  void Push(uint32_t node, double similarity) {
+    Candidate c{node, similarity};
+    if (heap_.size() < k_) {
+      heap_.emplace_back(c);
+      std::push_heap(heap_.begin(), heap_.end(), Better);
+    } else if (Better(c, heap_.front())) {
+      std::pop_heap(heap_.begin(), heap_.end(), Better);
+      heap_.back() = c;
+      std::push_heap(heap_.begin(), heap_.end(), Better);
+    }
+  }
+
+  /// \returns the candidates from best to worst
+  TopK Sorted() {
+    std::sort_heap(heap_.begin(), heap_.end(), Better);
+    return TopK(heap_.begin(), heap_.end());
+  }
+
+private:
+  size_t k_{0};
+  TopK heap_;
+};
+
+/// The state of a node's search, kept by each thread across nodes. The
+/// arrays are EpochArrays, so starting a search does not touch them.
+struct Scratch {
+  /// The number of neighbors shared with the node, for each candidate
+  katana::EpochArray<uint32_t> shared;
+  /// The nodes already looked at by this search
+  katana::EpochArray<uint8_t> seen;
+  std::vector<Node> candidates;
+  BoundedHeap heap;
+
+  void Begin(size_t num_nodes, size_t k) {
+    if (shared.size() != num_nodes) {
+      shared.Resize(num_nodes);
+      seen.Resize(num_nodes);
+    } else {
+      shared.Reset();
+      seen.Reset();
+    }
+    candidates.clear();
+    heap.Reset(k);
+  }
+};
+
+/// Count the neighbors that n shares with each node that shares one, by
+/// walking the in-edges of the neighbors of n, and keep the k most similar
+/// nodes. Repeated edges of n are counted once, as Jaccard does.
+TopK
+ExactTopK(const BiDirView& view, Node n, size_t k, Scratch* sc) {
+  sc->Begin(view.num_nodes(), k);
+  for (auto e : view.edges(n)) {
+    Node v = view.edge_dest(e);
+    if (sc->seen.IsSet(v)) {
+      continue;
+    }
+    sc->seen.Set(v, 1);
+    for (auto in_e : view.in_edges(v)) {
+      Node w = view.in_edge_dest(in_e);
+      if (w == n) {
+        continue;
+      }
+      if (!sc->shared.IsSet(w)) {
+        sc->candidates.emplace_back(w);
+      }
+      sc->shared.Set(w, sc->shared.Get(w) + 1);
+    }
+  }
+
+  uint32_t n_size = view.degree(n);
+  for (Node w : sc->candidates) {
+    uint32_t intersection_size = sc->shared.Get(w);
+    uint32_t union_size = n_size + view.degree(w) - intersection_size;
+    sc->heap.Push(w, static_cast<double>(intersection_size) / union_size);
+  }
+  return sc->heap.Sorted();
+}
+
+/// MinHash signatures of the nodes and a locality-sensitive hash table of
+/// them: for each band of rows_per_band hashes, the hash of the band of
+/// each node with an edge, sorted, so that the nodes whose bands are equal
+/// are adjacent
+class MinHashIndex {
+public:
+  MinHashIndex(
+      const katana::GraphTopology& topology, uint32_t num_hashes,
+      uint32_t rows_per_band)
+      : topology_(topology),
+        num_hashes_(num_hashes),
+        rows_per_band_(rows_per_band),
+        num_bands_(num_hashes / rows_per_band),
+        tables_(num_bands_) {
+    std::vector<uint64_t> seeds(num_hashes_);
+    for (uint32_t i = 0; i < num_hashes_; ++i) {
+      seeds[i] = Mix(kSeed + i);
+    }
+
+    const size_t num_nodes = topology_.num_nodes();
+    signatures_.allocateBlocked(num_nodes * num_hashes_);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          uint32_t* signature = &signatures_[n * num_hashes_];
+          std::fill(
+              signature, signature + num_hashes_,
+              std::numeric_limits<uint32_t>::max());
+          for (auto e : topology_.edges(n)) {
+            uint64_t dest = topology_.edge_dest(e);
+            for (uint32_t i = 0; i < num_hashes_; ++i) {
+              uint32_t h = Mix(dest ^ seeds[i]) >> 32;
+              signature[i] = std::min(signature[i], h);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("JaccardMinHashSignatures"));
+
+    for (uint32_t band = 0; band < num_bands_; ++band) {
+      auto& table = tables_[band];
+      table.resize(num_nodes);
+      katana::do_all(
+          katana::iterate(size_t{0}, num_nodes),
+          [&](size_t n) { table[n] = {BandKey(n, band), n}; },
+          katana::no_stats());
+      table.erase(
+          std::remove_if(
+              table.begin(), table.end(),
+              [&](const auto& entry) {
+                return topology_.degree(entry.second) == 0;
+              }),
+          table.end());
+      katana::ParallelSTL::sort(table.begin(), table.end());
+    }
+  }
+
+  /// Estimate the similarity of n to the nodes that it collides with in
+  /// some band and keep the k most similar
+  TopK ApproximateTopK(Node n, size_t k, Scratch* sc) const {
+    sc->Begin(topology_.num_nodes(), k);
+    if (topology_.degree(n) == 0) {
+      return {};
+    }
+    sc->seen.Set(n, 1);
+    for (uint32_t band = 0; band < num_bands_; ++band) {
+      const auto& table = tables_[band];
+      uint64_t key = BandKey(n, band);
+      auto it = std::lower_bound(
+          table.begin(), table.end(), std::make_pair(key, Node{0}));
+      for (; it != table.end() && it->first == key; ++it) {
+        Node w = it->second;
+        if (sc->seen.IsSet(w)) {
+          continue;
+        }
+        sc->seen.Set(w, 1);
+        sc->heap.Push(w, Estimate(n, w));
+      }
+    }
+    return sc->heap.Sorted();
+  }
+
+private:
+  uint64_t BandKey(Node n, uint32_t band) const {
+    const uint32_t* rows =
+        &signatures_[size_t{n} * num_hashes_ + band * rows_per_band_];
+    uint64_t key = band;
+    for (uint32_t r = 0; r < rows_per_band_; ++r) {
+      key = Mix(key ^ rows[r]);
+    }
+    return key;
+  }
+
+  /// \returns the fraction of equal entries of the signatures of a and b
+  double Estimate(Node a, Node b) const {
+    const uint32_t* a_signature = &signatures_[size_t{a} * num_hashes_];
+    const uint32_t* b_signature = &signatures_[size_t{b} * num_hashes_];
+    uint32_t equal = 0;
+    for (uint32_t i = 0; i < num_hashes_; ++i) {
+      equal += a_signature[i] == b_signature[i];
+    }
+    return static_cast<double>(equal) / num_hashes_;
+  }
+
+  const katana::GraphTopology& topology_;
+  const uint32_t num_hashes_;
+  const uint32_t rows_per_band_;
+  const uint32_t num_bands_;
+  katana::NUMAArray<uint32_t> signatures_;
+  std::vector<std::vector<std::pair<uint64_t, Node>>> tables_;
+};
+
+}  // namespace
+
+katana::Result<std::vector<std::vector<std::pair<uint32_t, double>>>>
+katana::analytics::JaccardTopK(
+    PropertyGraph* pg, size_t k, JaccardPlan plan) {
+  if (k == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "k must be positive");
+  }
+
+  const size_t num_nodes = pg->num_nodes();
+  std::vector<TopK> results(num_nodes);
+  katana::PerThreadStorage<Scratch> scratch;
+
+  katana::StatTimer exec_time("JaccardTopK");
+  exec_time.start();
+
+  switch (plan.algorithm()) {
+  case JaccardPlan::kExact: {
+    BiDirView view = pg->BuildView<BiDirView>();
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          results[n] = ExactTopK(view, n, k, scratch.getLocal());
+        },
+        katana::steal(), katana::loopname("JaccardTopK"));
+    break;
+  }
+  case JaccardPlan::kMinHash: {
+    if (plan.rows_per_band() == 0 ||
+        plan.num_hashes() < plan.rows_per_band() ||
+        plan.num_hashes() % plan.rows_per_band() != 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "the number of hashes {} must be a positive multiple of the rows "
+          "per band {}",
+          plan.num_hashes(), plan.rows_per_band());
+    }
+    MinHashIndex index(
+        pg->topology(), plan.num_hashes(), plan.rows_per_band());
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          results[n] = index.ApproximateTopK(n, k, scratch.getLocal());
+        },
+        katana::steal(), katana::loopname("JaccardTopKMinHash"));
+    break;
+  }
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  exec_time.stop();
+
+  return results;
+}
@@ -19,6 +19,7 @@
 
 #include "katana/analytics/jaccard/jaccard.h"
 
+#include "katana/SetIntersection.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
@@ -33,63 +34,61 @@ typedef typename Graph::Node GNode;
 
 namespace {
 
+/// \returns the destinations of the edges of n
+const GNode*
+EdgeDests(const katana::GraphTopology& topology, GNode n) {
+  return topology.dest_data() + *topology.edges(n).begin();
+}
+
 struct IntersectWithSortedEdgeList {
 private:
-  const GNode base_;
-  const Graph& graph_;
+  const katana::GraphTopology& topology_;
+  const GNode* base_dests_;
+  const size_t base_size_;
+  // the neighbors of a hub base, which every node is intersected with
+  katana::SetBitmap base_bitmap_;
+  const bool use_bitmap_;
 
 public:
-  IntersectWithSortedEdgeList(const Graph& graph, GNode base)
-      : base_(base), graph_(graph) {}
+  IntersectWithSortedEdgeList(
+      const katana::GraphTopology& topology, GNode base)
+      : topology_(topology),
+        base_dests_(EdgeDests(topology, base)),
+        base_size_(topology.degree(base)),
+        use_bitmap_(base_size_ >= katana::kBitmapMinSize) {
+    if (use_bitmap_) {
+      base_bitmap_.Resize(topology.num_nodes());
+      base_bitmap_.Insert(base_dests_, base_size_);
+    }
+  }
 
   uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    // Iterate over the edges of both n2 and base in sync, based on the
-    // assumption that edges lists are sorted.
-    auto edges_n2_iter = graph_.edge_begin(n2);
-    auto edges_n2_end = graph_.edge_end(n2);
-    auto edges_base_iter = graph_.edge_begin(base_);
-    auto edges_base_end = graph_.edge_end(base_);
-    while (edges_n2_iter != edges_n2_end && edges_base_iter != edges_base_end) {
-      auto edge_n2_dst = graph_.GetEdgeDest(*edges_n2_iter);
-      auto edge_base_dst = graph_.GetEdgeDest(*edges_base_iter);
-      if (edge_n2_dst == edge_base_dst) {
-        intersection_size++;
-        edges_n2_iter++;
-        edges_base_iter++;
-      } else if (edge_n2_dst > edge_base_dst) {
-        edges_base_iter++;
-      } else if (edge_n2_dst < edge_base_dst) {
-        edges_n2_iter++;
-      }
+    const GNode* n2_dests = EdgeDests(topology_, n2);
+    size_t n2_size = topology_.degree(n2);
+    if (use_bitmap_) {
+      return base_bitmap_.IntersectionSize(n2_dests, n2_size);
     }
-    return intersection_size;
+    return katana::IntersectionSize(
+        base_dests_, base_size_, n2_dests, n2_size);
   }
 };
 
 struct IntersectWithUnsortedEdgeList {
 private:
-  std::unordered_set<GNode> base_neighbors;
-  const Graph& graph_;
+  // the neighbors of the base node, which need not be sorted
+  katana::SetBitmap base_neighbors_;
+  const katana::GraphTopology& topology_;
 
 public:
-  IntersectWithUnsortedEdgeList(const Graph& graph, GNode base)
-      : graph_(graph) {
-    // Collect all the neighbors of the base node into a hash set.
-    for (const auto& e : graph.edges(base)) {
-      auto dest = graph.GetEdgeDest(e);
-      base_neighbors.emplace(*dest);
-    }
+  IntersectWithUnsortedEdgeList(
+      const katana::GraphTopology& topology, GNode base)
+      : base_neighbors_(topology.num_nodes()), topology_(topology) {
+    base_neighbors_.Insert(EdgeDests(topology, base), topology.degree(base));
   }
 
   uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    for (const auto& e : graph_.edges(n2)) {
-      auto neighbor = graph_.GetEdgeDest(e);
-      if (base_neighbors.count(*neighbor) > 0)
-        intersection_size++;
-    }
-    return intersection_size;
+    return base_neighbors_.IntersectionSize(
+        EdgeDests(topology_, n2), topology_.degree(n2));
   }
 };
 
@@ -98,7 +97,8 @@ katana::Result<void>
 JaccardImpl(
     katana::TypedPropertyGraph<std::tuple<JaccardSimilarity>, std::tuple<>>&
         graph,
-    size_t compare_node, JaccardPlan /*plan*/) {
+    const katana::GraphTopology& topology, size_t compare_node,
+    JaccardPlan /*plan*/) {
   if (compare_node >= graph.size()) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -114,7 +114,7 @@ JaccardImpl(
 
   uint32_t base_size = graph.edges(base).size();
 
-  IntersectAlgorithm intersect_with_base{graph, base};
+  IntersectAlgorithm intersect_with_base{topology, base};
 
   // Compute the similarity for each node
   katana::do_all(katana::iterate(graph), [&](const GNode& n2) {
@@ -160,11 +160,11 @@ katana::analytics::Jaccard(
     //  fail to the unsorted case if unsorted nodes are detected.
   case JaccardPlan::kUnsorted:
     r = JaccardImpl<IntersectWithUnsortedEdgeList>(
-        pg_result.value(), compare_node, plan);
+        pg_result.value(), pg->topology(), compare_node, plan);
     break;
   case JaccardPlan::kSorted:
     r = JaccardImpl<IntersectWithSortedEdgeList>(
-        pg_result.value(), compare_node, plan);
+        pg_result.value(), pg->topology(), compare_node, plan);
     break;
   }
 
@@ -0,0 +1,315 @@
+#include "katana/analytics/k_clique/k_clique.h"
+
+#include <atomic>
+#include <tuple>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/SetIntersection.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using EdgesSortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
+using Node = EdgesSortedGraphView::Node;
+
+struct NodeColor : public katana::PODProperty<uint32_t> {};
+struct NodeCliqueCount : public katana::PODProperty<uint64_t> {};
+
+using ColorGraph =
+    katana::TypedPropertyGraph<std::tuple<NodeColor>, std::tuple<>>;
+using CountGraph =
+    katana::TypedPropertyGraph<std::tuple<NodeCliqueCount>, std::tuple<>>;
+
+constexpr static const unsigned kChunkSize = 64U;
+
+/// The edges of a symmetric graph directed from each node to its neighbors
+/// of lower rank, which is the order of (key, node id), without self loops or
+/// parallel edges. The destinations of each node are sorted by id.
+class DirectedGraph {
+public:
+  DirectedGraph(
+      const EdgesSortedGraphView& view, const katana::NUMAArray<uint64_t>& keys)
+      : num_nodes_(view.num_nodes()) {
+    auto lower = [&](Node w, Node u) {
+      return keys[w] < keys[u] || (keys[w] == keys[u] && w < u);
+    };
+    // Calls fn(w) for each distinct destination w of u of lower rank
+    auto for_each_lower = [&](Node u, auto fn) {
+      const Node* dests = view.dest_data() + *view.edges(u).begin();
+      size_t degree = view.degree(u);
+      for (size_t i = 0; i < degree; ++i) {
+        if ((i == 0 || dests[i] != dests[i - 1]) && lower(dests[i], u)) {
+          fn(dests[i]);
+        }
+      }
+    };
+
+    offsets_.allocateBlocked(num_nodes_ + 1);
+    offsets_[0] = 0;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) {
+          uint64_t degree = 0;
+          for_each_lower(u, [&](Node) { degree += 1; });
+          offsets_[u + 1] = degree;
+        },
+        katana::steal(), katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        offsets_.begin() + 1, offsets_.end(), offsets_.begin() + 1);
+
+    dests_.allocateBlocked(offsets_[num_nodes_]);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t u) {
+          uint64_t next = offsets_[u];
+          for_each_lower(u, [&](Node w) { dests_[next++] = w; });
+        },
+        katana::steal(), katana::loopname("KClique-Direct"));
+  }
+
+  uint64_t num_nodes() const { return num_nodes_; }
+
+  const Node* dests(Node u) const { return dests_.data() + offsets_[u]; }
+
+  size_t degree(Node u) const { return offsets_[u + 1] - offsets_[u]; }
+
+private:
+  uint64_t num_nodes_;
+  katana::NUMAArray<uint64_t> offsets_;
+  katana::NUMAArray<Node> dests_;
+};
+
+/// What one thread needs to extend cliques: the candidates of each depth
+/// and the nodes of the clique so far
+struct CliqueScratch {
+  katana::SetBitmap bitmap;
+  std::vector<std::vector<Node>> candidates;
+  std::vector<Node> clique;
+};
+
+/// Counts the cliques of k nodes of a directed graph, each from its highest
+/// node. The candidates to extend a clique are the common destinations of its
+/// nodes, so the next node of the clique is one of them and the candidates
+/// after it are those that are also its destinations.
+class CliqueCounter {
+public:
+  CliqueCounter(
+      const DirectedGraph& graph, uint32_t k,
+      const katana::NUMAArray<uint32_t>* colors,
+      katana::NUMAArray<std::atomic<uint64_t>>* counts)
+      : graph_(graph), k_(k), colors_(colors), counts_(counts) {}
+
+  uint64_t Count() const {
+    katana::GAccumulator<uint64_t> total;
+    katana::PerThreadStorage<CliqueScratch> scratches;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, graph_.num_nodes()),
+        [&](uint64_t u) { total += CountFrom(u, scratches.getLocal()); },
+        katana::chunk_size<kChunkSize>(), katana::steal(),
+        katana::loopname("KClique-Count"));
+    return total.reduce();
+  }
+
+private:
+  /// \returns the number of cliques whose highest node is u
+  uint64_t CountFrom(Node u, CliqueScratch* scratch) const {
+    if (k_ == 1) {
+      if (counts_) {
+        (*counts_)[u].fetch_add(1, std::memory_order_relaxed);
+      }
+      return 1;
+    }
+    if (Pruned(u, k_)) {
+      return 0;
+    }
+    if (scratch->clique.size() < k_) {
+      scratch->candidates.resize(k_);
+      scratch->clique.resize(k_);
+    }
+
+    const Node* dests = graph_.dests(u);
+    size_t degree = graph_.degree(u);
+    bool use_bitmap = degree >= katana::kBitmapMinSize;
+    if (use_bitmap) {
+      if (scratch->bitmap.universe() < graph_.num_nodes()) {
+        scratch->bitmap.Resize(graph_.num_nodes());
+      }
+      scratch->bitmap.Insert(dests, degree);
+    }
+    scratch->clique[0] = u;
+    uint64_t count = Extend(
+        dests, degree, use_bitmap ? &scratch->bitmap : nullptr, k_ - 1, 1,
+        scratch);
+    if (use_bitmap) {
+      scratch->bitmap.Erase(dests, degree);
+    }
+    return count;
+  }
+
+  /// \returns the number of ways to add l nodes of candidates, which
+  /// are also in bitmap if it is not null, to the depth nodes of the clique
+  uint64_t Extend(
+      const Node* candidates, size_t size, const katana::SetBitmap* bitmap,
+      uint32_t l, uint32_t depth, CliqueScratch* scratch) const {
+    if (size < l) {
+      return 0;
+    }
+    if (l == 1) {
+      if (counts_) {
+        for (uint32_t i = 0; i < depth; ++i) {
+          (*counts_)[scratch->clique[i]].fetch_add(
+              size, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < size; ++i) {
+          (*counts_)[candidates[i]].fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+      return size;
+    }
+
+    uint64_t count = 0;
+    std::vector<Node>& next = scratch->candidates[depth];
+    for (size_t i = 0; i < size; ++i) {
+      Node v = candidates[i];
+      if (Pruned(v, l)) {
+        continue;
+      }
+      const Node* v_dests = graph_.dests(v);
+      size_t v_degree = graph_.degree(v);
+      if (l == 2 && !counts_) {
+        count += bitmap ? bitmap->IntersectionSize(v_dests, v_degree)
+                        : katana::IntersectionSize(
+                              candidates, size, v_dests, v_degree);
+        continue;
+      }
+
+      next.clear();
+      if (bitmap) {
+        for (size_t j = 0; j < v_degree; ++j) {
+          if (bitmap->Contains(v_dests[j])) {
+            next.push_back(v_dests[j]);
+          }
+        }
+      } else {
+        katana::ForEachIntersection(
+            candidates, size, v_dests, v_degree, [&](size_t j, size_t) {
+              next.push_back(candidates[j]);
+              return true;
+            });
+      }
+      scratch->clique[depth] = v;
+      count += Extend(
+          next.data(), next.size(), nullptr, l - 1, depth + 1, scratch);
+    }
+    return count;
+  }
+
+  /// Whether v, with colors, starts no clique of l nodes: the colors along a
+  /// clique strictly decrease, so v needs a color of at least l - 1
+  bool Pruned(Node v, uint32_t l) const {
+    return colors_ && (*colors_)[v] + 1 < l;
+  }
+
+  const DirectedGraph& graph_;
+  uint32_t k_;
+  const katana::NUMAArray<uint32_t>* colors_;
+  katana::NUMAArray<std::atomic<uint64_t>>* counts_;
+};
+
+/// Counts the cliques of k nodes of pg and, if counts is not null, adds to
+/// the count of each node the cliques that contain it
+katana::Result<uint64_t>
+CountCliques(
+    katana::PropertyGraph* pg, uint32_t k, KCliquePlan plan,
+    katana::NUMAArray<std::atomic<uint64_t>>* counts) {
+  if (k == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "cliques need at least one node");
+  }
+  if (plan.algorithm() != KCliquePlan::kDegreeOrdered &&
+      plan.algorithm() != KCliquePlan::kColorOrdered) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  EdgesSortedGraphView view = pg->BuildView<EdgesSortedGraphView>();
+  uint64_t num_nodes = view.num_nodes();
+  katana::NUMAArray<uint64_t> keys;
+  keys.allocateBlocked(num_nodes);
+  katana::NUMAArray<uint32_t> colors;
+  if (plan.algorithm() == KCliquePlan::kColorOrdered) {
+    TemporaryPropertyGuard color_property{pg};
+    KATANA_CHECKED(GraphColoring(
+        pg, color_property.name(), GraphColoringPlan::LargestDegreeFirst()));
+    auto graph =
+        KATANA_CHECKED(ColorGraph::Make(pg, {color_property.name()}, {}));
+    colors.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t u) {
+          colors[u] = graph.GetData<NodeColor>(u);
+          keys[u] = colors[u];
+        },
+        katana::no_stats());
+  } else {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t u) { keys[u] = view.degree(u); }, katana::no_stats());
+  }
+
+  katana::StatTimer exec_time("KCliqueCount");
+  exec_time.start();
+  DirectedGraph directed(view, keys);
+  CliqueCounter counter(
+      directed, k,
+      plan.algorithm() == KCliquePlan::kColorOrdered ? &colors : nullptr,
+      counts);
+  uint64_t total = counter.Count();
+  exec_time.stop();
+
+  return total;
+}
+
+}  // namespace
+
+katana::Result<uint64_t>
+katana::analytics::KCliqueCount(
+    PropertyGraph* pg, uint32_t k, KCliquePlan plan) {
+  return CountCliques(pg, k, plan, nullptr);
+}
+
+katana::Result<void>
+katana::analytics::KCliqueCountPerNode(
+    PropertyGraph* pg, uint32_t k, const std::string& output_property_name,
+    KCliquePlan plan) {
+  katana::NUMAArray<std::atomic<uint64_t>> counts;
+  counts.allocateBlocked(pg->num_nodes());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_nodes()),
+      [&](uint64_t u) { counts[u].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  KATANA_CHECKED(CountCliques(pg, k, plan, &counts));
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeCliqueCount>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED(CountGraph::Make(pg, {output_property_name}, {}));
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const CountGraph::Node& u) {
+        graph.GetData<NodeCliqueCount>(u) =
+            counts[u].load(std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  return katana::ResultSuccess();
+}
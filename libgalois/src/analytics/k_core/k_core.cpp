@@ -19,9 +19,15 @@
 
 #include "katana/analytics/k_core/k_core.h"
 
+#include <array>
+#include <limits>
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/NUMAArray.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Frontier.h"
 
 using namespace katana::analytics;
 
@@ -36,6 +42,8 @@ struct KCoreNodeCurrentDegree : public katana::AtomicPODProperty<uint32_t> {};
 
 struct KCoreNodeAlive : public katana::PODProperty<uint32_t> {};
 
+struct KCoreNodeCoreNumber : public katana::PODProperty<uint32_t> {};
+
 using NodeData = std::tuple<KCoreNodeCurrentDegree>;
 using EdgeData = std::tuple<>;
 typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
@@ -85,45 +93,52 @@ SetupInitialWorklist(
 }
 
 /**
- * Starting with initial dead nodes as current worklist; decrement degree;
- * add to next worklist; switch next with current and repeat until worklist
- * is empty (i.e. no more dead nodes).
+ * Starting with initial dead nodes as current frontier; decrement degree;
+ * add to next frontier; switch next with current and repeat until frontier
+ * is empty (i.e. no more dead nodes). Rounds that kill many nodes pull the
+ * decrements from the dead neighbors instead of pushing them.
  *
  * @param graph Graph to operate on
  * @param k_core_number Each node in the core is expected to have degree <= k_core_number
  */
 void
 SyncCascadeKCore(Graph* graph, uint32_t k_core_number) {
-  auto current = std::make_unique<katana::InsertBag<GNode>>();
-  auto next = std::make_unique<katana::InsertBag<GNode>>();
+  //! The graph is symmetric, so its out-edges are its in-edges too.
+  const katana::GraphTopology& topology =
+      graph->GetPropertyGraph().topology();
+  auto current = std::make_unique<Frontier>(graph->num_nodes());
+  auto next = std::make_unique<Frontier>(graph->num_nodes());
 
-  //! Setup worklist.
-  SetupInitialWorklist(*graph, *next, k_core_number);
+  //! Setup frontier.
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& node) {
+        if (graph->GetData<KCoreNodeCurrentDegree>(node) < k_core_number) {
+          //! Dead node, add to frontier for processing later.
+          next->Add(node);
+        }
+      },
+      katana::loopname("InitialWorklistSetup"), katana::no_stats());
 
   while (!next->empty()) {
     //! Make "next" into current.
     std::swap(current, next);
-    next->clear();
 
-    katana::do_all(
-        katana::iterate(*current),
-        [&](const GNode& dead_node) {
-          //! Decrement degree of all neighbors.
-          for (auto e : graph->edges(dead_node)) {
-            auto dest = graph->GetEdgeDest(e);
-            auto& dest_current_degree =
-                graph->GetData<KCoreNodeCurrentDegree>(dest);
-            uint32_t old_degree = katana::atomicSub(dest_current_degree, 1u);
-
-            if (old_degree == k_core_number) {
-              //! This thread was responsible for putting degree of destination
-              //! below threshold; add to worklist.
-              next->emplace(*dest);
-            }
-          }
+    //! Decrement degree of all live neighbors.
+    EdgeMap(
+        topology, topology, current.get(), next.get(),
+        [&](GNode, GNode dest) {
+          auto& dest_current_degree =
+              graph->GetData<KCoreNodeCurrentDegree>(dest);
+          uint32_t old_degree = katana::atomicSub(dest_current_degree, 1u);
+          //! This thread was responsible for putting degree of destination
+          //! below threshold; add to next frontier.
+          return old_degree == k_core_number;
         },
-        katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
-        katana::loopname("KCore Synchronous"));
+        [&](GNode dest) {
+          return graph->GetData<KCoreNodeCurrentDegree>(dest) >= k_core_number;
+        },
+        "KCore Synchronous");
   }
 }
 
@@ -261,6 +276,177 @@ katana::analytics::KCore(
   return KCoreMarkAliveNodes(&graph_final, k_core_number);
 }
 
+//! The number of buckets of degrees materialized at a time.
+constexpr static const uint32_t kNumOpenBuckets = 128;
+
+//! The core number of a node that is not peeled yet.
+constexpr static const uint32_t kNotPeeled =
+    std::numeric_limits<uint32_t>::max();
+
+using CoreGraph =
+    katana::TypedPropertyGraph<std::tuple<KCoreNodeCoreNumber>, std::tuple<>>;
+
+/**
+ * Peel nodes in increasing order of their current degree. Each bucket holds
+ * the nodes whose degree was some value when they were put in it, so a
+ * bucket may hold nodes whose degree has dropped since; these are skipped.
+ * Only kNumOpenBuckets buckets starting at the smallest degree of the
+ * nodes left are materialized; the nodes of higher degree are put in
+ * buckets once those buckets are opened.
+ *
+ * @param graph Graph to operate on, with the core numbers to compute
+ */
+void
+BucketedPeeling(CoreGraph* graph) {
+  const uint64_t num_nodes = graph->num_nodes();
+  katana::NUMAArray<std::atomic<uint32_t>> degree;
+  degree.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& node) {
+        uint32_t node_degree =
+            std::distance(graph->edge_begin(node), graph->edge_end(node));
+        degree.constructAt(node, node_degree);
+        graph->GetData<KCoreNodeCoreNumber>(node) = kNotPeeled;
+      },
+      katana::loopname("DegreeCounting"), katana::no_stats());
+
+  auto peeled = [&](GNode node) {
+    return graph->GetData<KCoreNodeCoreNumber>(node) != kNotPeeled;
+  };
+
+  std::vector<katana::InsertBag<GNode>> buckets(kNumOpenBuckets);
+  std::array<katana::InsertBag<GNode>, 2> frontiers;
+  uint64_t num_peeled = 0;
+  while (num_peeled < num_nodes) {
+    //! Open the buckets from the smallest degree of the nodes left.
+    katana::GReduceMin<uint32_t> min_degree;
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& node) {
+          if (!peeled(node)) {
+            min_degree.update(degree[node].load(std::memory_order_relaxed));
+          }
+        },
+        katana::loopname("KCore Min Degree"), katana::no_stats());
+    const uint32_t base = min_degree.reduce();
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& node) {
+          uint32_t d = degree[node].load(std::memory_order_relaxed);
+          if (!peeled(node) && d - base < kNumOpenBuckets) {
+            buckets[d - base].push(node);
+          }
+        },
+        katana::loopname("KCore Open Buckets"), katana::no_stats());
+
+    for (uint32_t b = 0; b < kNumOpenBuckets && num_peeled < num_nodes; ++b) {
+      const uint32_t k = base + b;
+      size_t current = 0;
+      frontiers[current].clear();
+      katana::do_all(
+          katana::iterate(buckets[b]),
+          [&](const GNode& node) {
+            if (!peeled(node) &&
+                degree[node].load(std::memory_order_relaxed) == k) {
+              frontiers[current].push(node);
+            }
+          },
+          katana::loopname("KCore Bucket"), katana::no_stats());
+      buckets[b].clear();
+
+      //! Peel the nodes of degree k, and then the nodes that they bring
+      //! down to degree k, until none are left.
+      while (!frontiers[current].empty()) {
+        katana::GAccumulator<uint64_t> num_peeled_now;
+        katana::do_all(
+            katana::iterate(frontiers[current]),
+            [&](const GNode& node) {
+              graph->GetData<KCoreNodeCoreNumber>(node) = k;
+              num_peeled_now += 1;
+            },
+            katana::loopname("KCore Peel"), katana::no_stats());
+        num_peeled += num_peeled_now.reduce();
+
+        auto& next = frontiers[1 - current];
+        next.clear();
+        katana::do_all(
+            katana::iterate(frontiers[current]),
+            [&](const GNode& node) {
+              for (auto e : graph->edges(node)) {
+                auto dest = *graph->GetEdgeDest(e);
+                if (peeled(dest)) {
+                  continue;
+                }
+                //! Degrees do not drop below the core being peeled.
+                uint32_t d = degree[dest].load(std::memory_order_relaxed);
+                while (d > k && !degree[dest].compare_exchange_weak(
+                                    d, d - 1, std::memory_order_relaxed)) {
+                }
+                if (d <= k) {
+                  continue;
+                }
+                if (d - 1 == k) {
+                  next.push(dest);
+                } else if (d - 1 - base < kNumOpenBuckets) {
+                  buckets[d - 1 - base].push(dest);
+                }
+              }
+            },
+            katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
+            katana::loopname("KCore Decrement"), katana::no_stats());
+        current = 1 - current;
+      }
+    }
+    for (auto& bucket : buckets) {
+      bucket.clear();
+    }
+  }
+}
+
+katana::Result<void>
+katana::analytics::KCoreDecomposition(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<KCoreNodeCoreNumber>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED(CoreGraph::Make(pg, {output_property_name}, {}));
+
+  size_t approxNodeData = 4 * (graph.num_nodes() + graph.num_edges());
+  katana::EnsurePreallocated(8, approxNodeData);
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::StatTimer exec_time("KCoreDecomposition");
+  exec_time.start();
+  BucketedPeeling(&graph);
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::KCoreBatch(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& k_core_numbers) {
+  TemporaryPropertyGuard core_numbers{pg};
+  KATANA_CHECKED(KCoreDecomposition(pg, core_numbers.name()));
+  auto graph = KATANA_CHECKED(CoreGraph::Make(pg, {core_numbers.name()}, {}));
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (uint32_t k : k_core_numbers) {
+    katana::ArrowRandomAccessBuilder<arrow::UInt32Type> builder(
+        graph.num_nodes());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& node) {
+          builder[node] = graph.GetData<KCoreNodeCoreNumber>(node) >= k ? 1 : 0;
+        },
+        katana::no_stats());
+    columns.emplace_back(KATANA_CHECKED(builder.Finalize()));
+    fields.emplace_back(arrow::field(std::to_string(k), arrow::uint32()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, pg->num_nodes());
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
@@ -300,6 +486,34 @@ katana::analytics::KCoreStatistics::Compute(
 
   return KCoreStatistics{alive_nodes.reduce()};
 }
+
+katana::Result<KCoreDecompositionStatistics>
+katana::analytics::KCoreDecompositionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(CoreGraph::Make(pg, {property_name}, {}));
+
+  katana::GReduceMax<uint32_t> max_core_number;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        max_core_number.update(graph.GetData<KCoreNodeCoreNumber>(node));
+      },
+      katana::loopname("KCoreDecomposition max core"), katana::no_stats());
+  uint32_t max_core = max_core_number.reduce();
+
+  katana::GAccumulator<uint64_t> nodes_in_max_core;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        if (graph.GetData<KCoreNodeCoreNumber>(node) == max_core) {
+          nodes_in_max_core += 1;
+        }
+      },
+      katana::loopname("KCoreDecomposition max core size"),
+      katana::no_stats());
+
+  return KCoreDecompositionStatistics{max_core, nodes_in_max_core.reduce()};
+}
 /// \endcond DO_NOT_DOCUMENT
 
 void
@@ -307,3 +521,10 @@ katana::analytics::KCoreStatistics::Print(std::ostream& os) const {
   os << "Number of nodes in the core = " << number_of_nodes_in_kcore
      << std::endl;
 }
+
+void
+katana::analytics::KCoreDecompositionStatistics::Print(std::ostream& os) const {
+  os << "Largest core number = " << max_core_number << std::endl;
+  os << "Number of nodes in the largest core = "
+     << number_of_nodes_in_max_core << std::endl;
+}
@@ -0,0 +1,514 @@
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <set>
+#include <tuple>
+#include <type_traits>
+
+#include "katana/Allocators.h"
+#include "katana/EpochArray.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "katana/ScratchArena.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using Node = BiDirView::Node;
+
+/// A node of a path. The path is the chain of parents from a node, so paths
+/// with a common prefix can share the nodes of the prefix.
+struct PathNode {
+  Node node;
+  /// The weight of the path up to this node
+  double dist;
+  const PathNode* parent;
+  /// The node allocated before this one from the same pool
+  PathNode* prev_allocated;
+};
+
+/// The nodes of the paths of a query. Nodes may be allocated concurrently
+/// and are freed with the pool.
+class PathPool {
+public:
+  PathPool() = default;
+  PathPool(const PathPool&) = delete;
+  PathPool& operator=(const PathPool&) = delete;
+
+  ~PathPool() {
+    PathNode* p = last_.load(std::memory_order_relaxed);
+    while (p) {
+      PathNode* prev = p->prev_allocated;
+      allocator_.destroy(p);
+      allocator_.deallocate(p, 1);
+      p = prev;
+    }
+  }
+
+  /// \returns the path of parent followed by node
+  const PathNode* Extend(const PathNode* parent, Node node, double dist) {
+    PathNode* p = allocator_.allocate(1);
+    allocator_.construct(p, PathNode{node, dist, parent, nullptr});
+    p->prev_allocated = last_.load(std::memory_order_relaxed);
+    while (!last_.compare_exchange_weak(p->prev_allocated, p)) {
+    }
+    return p;
+  }
+
+private:
+  katana::FixedSizeAllocator<PathNode> allocator_;
+  std::atomic<PathNode*> last_{nullptr};
+};
+
+/// \returns the nodes of the path ending at last, from the first
+std::vector<const PathNode*>
+Positions(const PathNode* last) {
+  std::vector<const PathNode*> positions;
+  for (const PathNode* p = last; p; p = p->parent) {
+    positions.emplace_back(p);
+  }
+  std::reverse(positions.begin(), positions.end());
+  return positions;
+}
+
+WeightedPath
+MakeWeightedPath(const PathNode* last) {
+  WeightedPath path{{}, last->dist};
+  for (const PathNode* p = last; p; p = p->parent) {
+    path.nodes.emplace_back(p->node);
+  }
+  std::reverse(path.nodes.begin(), path.nodes.end());
+  return path;
+}
+
+/// The state of the searches of a query, kept by each thread across
+/// queries. The arrays are EpochArrays, so starting a search does not touch
+/// them.
+struct Scratch {
+  /// The distances to the target of the query of this thread, which guide
+  /// the searches of the query on every thread
+  katana::EpochArray<double> to_target;
+
+  katana::EpochArray<double> dist;
+  katana::EpochArray<Node> pred;
+  katana::EpochArray<uint8_t> blocked;
+  katana::EpochArray<uint32_t> times_settled;
+  std::vector<std::pair<double, Node>> heap;
+
+  void BeginQuery(size_t num_nodes) {
+    if (to_target.size() != num_nodes) {
+      to_target.Resize(num_nodes);
+    } else {
+      to_target.Reset();
+    }
+  }
+
+  void BeginSearch(size_t num_nodes) {
+    if (dist.size() != num_nodes) {
+      dist.Resize(num_nodes);
+      pred.Resize(num_nodes);
+      blocked.Resize(num_nodes);
+      times_settled.Resize(num_nodes);
+    } else {
+      dist.Reset();
+      pred.Reset();
+      blocked.Reset();
+      times_settled.Reset();
+    }
+    heap.clear();
+  }
+};
+
+using MinHeapOrder = std::greater<std::pair<double, Node>>;
+
+/// A path that Yen's algorithm may accept next. Candidates of equal weight
+/// are accepted in the order in which they were found.
+struct Candidate {
+  double weight;
+  uint64_t order;
+  const PathNode* last;
+  /// The index of the node of last at which it deviates from its parent
+  size_t deviation;
+
+  bool operator>(const Candidate& o) const {
+    return std::tie(weight, order) > std::tie(o.weight, o.order);
+  }
+};
+
+class PathFinder {
+public:
+  PathFinder(BiDirView view, katana::NUMAArray<double> weights)
+      : view_(std::move(view)), weights_(std::move(weights)) {}
+
+  std::vector<WeightedPath> Yen(Node source, Node target, size_t k) {
+    Scratch& sc = *scratch_.getLocal();
+    if (!ComputeDistancesToTarget(&sc, source, target)) {
+      return {};
+    }
+    const katana::EpochArray<double>& to_target = sc.to_target;
+
+    PathPool pool;
+    sc.BeginSearch(view_.num_nodes());
+    const PathNode* root = pool.Extend(nullptr, source, 0);
+    const PathNode* first = SpurPath(to_target, root, target, {}, &sc, &pool);
+
+    std::vector<std::vector<const PathNode*>> accepted{Positions(first)};
+    std::vector<size_t> deviations{0};
+    std::vector<Candidate> candidates;
+    std::set<std::vector<Node>> seen{MakeWeightedPath(first).nodes};
+    uint64_t order = 0;
+
+    while (accepted.size() < k) {
+      const auto& prev = accepted.back();
+      const size_t first_spur = deviations.back();
+      const size_t num_spurs = prev.size() - 1 - first_spur;
+
+      // Spur from each node of prev from its deviation on, avoiding the
+      // nodes before the spur node and the next nodes of accepted paths
+      // through the same nodes up to the spur node
+      std::vector<const PathNode*> spurs(num_spurs);
+      katana::do_all(
+          katana::iterate(size_t{0}, num_spurs),
+          [&](size_t s) {
+            size_t i = first_spur + s;
+            katana::ScratchScope scope;
+            katana::ScratchVector<Node> excluded;
+            for (const auto& path : accepted) {
+              if (path.size() > i + 1 && SamePrefix(path, prev, i)) {
+                excluded.emplace_back(path[i + 1]->node);
+              }
+            }
+            Scratch* spur_sc = scratch_.getLocal();
+            spur_sc->BeginSearch(view_.num_nodes());
+            for (size_t j = 0; j < i; ++j) {
+              spur_sc->blocked.Set(prev[j]->node, 1);
+            }
+            spurs[s] =
+                SpurPath(to_target, prev[i], target, excluded, spur_sc, &pool);
+          },
+          katana::steal(), katana::loopname("KShortestPathsSpur"));
+
+      for (size_t s = 0; s < num_spurs; ++s) {
+        if (spurs[s] && seen.emplace(MakeWeightedPath(spurs[s]).nodes).second) {
+          candidates.emplace_back(
+              Candidate{spurs[s]->dist, order++, spurs[s], first_spur + s});
+          std::push_heap(
+              candidates.begin(), candidates.end(), std::greater<Candidate>());
+        }
+      }
+
+      if (candidates.empty()) {
+        break;
+      }
+      std::pop_heap(
+          candidates.begin(), candidates.end(), std::greater<Candidate>());
+      accepted.emplace_back(Positions(candidates.back().last));
+      deviations.emplace_back(candidates.back().deviation);
+      candidates.pop_back();
+    }
+
+    std::vector<WeightedPath> paths;
+    for (const auto& path : accepted) {
+      paths.emplace_back(MakeWeightedPath(path.back()));
+    }
+    return paths;
+  }
+
+  std::vector<WeightedPath> LabelSetting(Node source, Node target, size_t k) {
+    Scratch& sc = *scratch_.getLocal();
+    if (!ComputeDistancesToTarget(&sc, source, target)) {
+      return {};
+    }
+    sc.BeginSearch(view_.num_nodes());
+
+    // labels of equal priority are settled in the order in which they were
+    // found
+    using Label = std::tuple<double, uint64_t, const PathNode*>;
+    std::vector<Label> heap;
+    PathPool pool;
+    uint64_t order = 0;
+    heap.emplace_back(
+        sc.to_target.Get(source), order++, pool.Extend(nullptr, source, 0));
+
+    std::vector<WeightedPath> paths;
+    while (!heap.empty() && paths.size() < k) {
+      std::pop_heap(heap.begin(), heap.end(), std::greater<Label>());
+      const PathNode* label = std::get<2>(heap.back());
+      heap.pop_back();
+
+      Node u = label->node;
+      uint32_t times_settled = sc.times_settled.Get(u);
+      if (times_settled == k) {
+        continue;
+      }
+      sc.times_settled.Set(u, times_settled + 1);
+      if (u == target) {
+        paths.emplace_back(MakeWeightedPath(label));
+      }
+
+      for (auto e : view_.edges(u)) {
+        Node v = view_.edge_dest(e);
+        if (!sc.to_target.IsSet(v) || sc.times_settled.Get(v) == k) {
+          continue;
+        }
+        double v_dist = label->dist + weights_[view_.edge_property_index(e)];
+        heap.emplace_back(
+            v_dist + sc.to_target.Get(v), order++,
+            pool.Extend(label, v, v_dist));
+        std::push_heap(heap.begin(), heap.end(), std::greater<Label>());
+      }
+    }
+    return paths;
+  }
+
+private:
+  /// Run Dijkstra's algorithm from target along in-edges into
+  /// sc->to_target. \returns whether target is reachable from source.
+  bool ComputeDistancesToTarget(Scratch* sc, Node source, Node target) {
+    sc->BeginQuery(view_.num_nodes());
+    auto& heap = sc->heap;
+    heap.clear();
+    sc->to_target.Set(target, 0);
+    heap.emplace_back(0, target);
+    while (!heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end(), MinHeapOrder());
+      auto [u_dist, u] = heap.back();
+      heap.pop_back();
+      if (u_dist > sc->to_target.Get(u)) {
+        continue;
+      }
+      for (auto e : view_.in_edges(u)) {
+        Node v = view_.in_edge_dest(e);
+        double v_dist = u_dist + weights_[view_.in_edge_property_index(e)];
+        if (!sc->to_target.IsSet(v) || v_dist < sc->to_target.Get(v)) {
+          sc->to_target.Set(v, v_dist);
+          heap.emplace_back(v_dist, v);
+          std::push_heap(heap.begin(), heap.end(), MinHeapOrder());
+        }
+      }
+    }
+    return sc->to_target.IsSet(source);
+  }
+
+  /// \returns whether the first i + 1 nodes of a and b are the same
+  static bool SamePrefix(
+      const std::vector<const PathNode*>& a,
+      const std::vector<const PathNode*>& b, size_t i) {
+    for (size_t j = i + 1; j-- > 0;) {
+      if (a[j] == b[j]) {
+        // the paths share the nodes up to a shared node
+        return true;
+      }
+      if (a[j]->node != b[j]->node) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Find a shortest path from the last node of root to target by A*, with
+  /// the distances to target as the potential, avoiding the nodes blocked in
+  /// sc and the edges from the spur node to the excluded nodes. Removing
+  /// nodes and edges only makes distances longer, so the potential stays
+  /// consistent. \returns root followed by the path, or nullptr if target
+  /// is unreachable.
+  const PathNode* SpurPath(
+      const katana::EpochArray<double>& to_target, const PathNode* root,
+      Node target, const katana::ScratchVector<Node>& excluded, Scratch* sc,
+      PathPool* pool) {
+    Node spur = root->node;
+    auto& heap = sc->heap;
+    sc->dist.Set(spur, 0);
+    heap.emplace_back(to_target.Get(spur), spur);
+    bool found = false;
+    while (!heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end(), MinHeapOrder());
+      auto [u_priority, u] = heap.back();
+      heap.pop_back();
+      double u_dist = sc->dist.Get(u);
+      if (u_priority > u_dist + to_target.Get(u)) {
+        continue;
+      }
+      if (u == target) {
+        found = true;
+        break;
+      }
+      for (auto e : view_.edges(u)) {
+        Node v = view_.edge_dest(e);
+        if (!to_target.IsSet(v) || sc->blocked.IsSet(v) ||
+            (u == spur && std::find(excluded.begin(), excluded.end(), v) !=
+                              excluded.end())) {
+          continue;
+        }
+        double v_dist = u_dist + weights_[view_.edge_property_index(e)];
+        if (!sc->dist.IsSet(v) || v_dist < sc->dist.Get(v)) {
+          sc->dist.Set(v, v_dist);
+          sc->pred.Set(v, u);
+          heap.emplace_back(v_dist + to_target.Get(v), v);
+          std::push_heap(heap.begin(), heap.end(), MinHeapOrder());
+        }
+      }
+    }
+    heap.clear();
+    if (!found) {
+      return nullptr;
+    }
+
+    std::vector<Node> spur_nodes;
+    for (Node v = target; v != spur; v = sc->pred.Get(v)) {
+      spur_nodes.emplace_back(v);
+    }
+    const PathNode* last = root;
+    for (auto it = spur_nodes.rbegin(); it != spur_nodes.rend(); ++it) {
+      last = pool->Extend(last, *it, root->dist + sc->dist.Get(*it));
+    }
+    return last;
+  }
+
+  BiDirView view_;
+  /// The weights by edge property index
+  katana::NUMAArray<double> weights_;
+  katana::PerThreadStorage<Scratch> scratch_;
+};
+
+template <typename Weight>
+katana::Result<void>
+CopyWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    katana::NUMAArray<double>* weights) {
+  auto typed_weights = KATANA_CHECKED_CONTEXT(
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name),
+      "edge weight property {}", edge_weight_property_name);
+  if (typed_weights->null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "edge weights may not be null");
+  }
+
+  katana::GReduceLogicalOr found_negative_weight;
+  katana::do_all(
+      katana::iterate(int64_t{0}, typed_weights->length()),
+      [&](int64_t i) {
+        double weight = static_cast<double>(typed_weights->Value(i));
+        // also catches NaN
+        if (!(weight >= 0)) {
+          found_negative_weight.update(true);
+        }
+        (*weights)[i] = weight;
+      },
+      katana::no_stats());
+  if (found_negative_weight.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge weights must be non-negative numbers");
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+struct katana::analytics::KShortestPathsQuery::Impl {
+  std::unique_ptr<PathFinder> finder;
+  KShortestPathsPlan plan;
+  uint64_t num_nodes;
+};
+
+katana::analytics::KShortestPathsQuery::KShortestPathsQuery(
+    std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+
+katana::analytics::KShortestPathsQuery::~KShortestPathsQuery() = default;
+
+katana::Result<std::unique_ptr<KShortestPathsQuery>>
+katana::analytics::KShortestPathsQuery::Make(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    KShortestPathsPlan plan) {
+  if (plan.algorithm() != KShortestPathsPlan::kYen &&
+      plan.algorithm() != KShortestPathsPlan::kLabelSetting) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  katana::NUMAArray<double> weights;
+  weights.allocateInterleaved(pg->num_edges());
+  if (edge_weight_property_name.empty()) {
+    katana::ParallelSTL::fill(weights.begin(), weights.end(), 1.0);
+  } else {
+    auto property = pg->GetEdgeProperty(edge_weight_property_name);
+    if (!property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no edge property {}",
+          edge_weight_property_name);
+    }
+    switch (property->type()->id()) {
+    case arrow::UInt32Type::type_id:
+      KATANA_CHECKED(
+          CopyWeights<uint32_t>(pg, edge_weight_property_name, &weights));
+      break;
+    case arrow::Int32Type::type_id:
+      KATANA_CHECKED(
+          CopyWeights<int32_t>(pg, edge_weight_property_name, &weights));
+      break;
+    case arrow::UInt64Type::type_id:
+      KATANA_CHECKED(
+          CopyWeights<uint64_t>(pg, edge_weight_property_name, &weights));
+      break;
+    case arrow::Int64Type::type_id:
+      KATANA_CHECKED(
+          CopyWeights<int64_t>(pg, edge_weight_property_name, &weights));
+      break;
+    case arrow::FloatType::type_id:
+      KATANA_CHECKED(
+          CopyWeights<float>(pg, edge_weight_property_name, &weights));
+      break;
+    case arrow::DoubleType::type_id:
+      KATANA_CHECKED(
+          CopyWeights<double>(pg, edge_weight_property_name, &weights));
+      break;
+    default:
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "unsupported edge weight type {}",
+          property->type()->ToString());
+    }
+  }
+
+  auto impl = std::make_unique<Impl>(Impl{
+      std::make_unique<PathFinder>(
+          pg->BuildView<BiDirView>(), std::move(weights)),
+      plan, pg->num_nodes()});
+  return std::unique_ptr<KShortestPathsQuery>(
+      new KShortestPathsQuery(std::move(impl)));
+}
+
+katana::Result<std::vector<WeightedPath>>
+katana::analytics::KShortestPathsQuery::Paths(
+    uint32_t source, uint32_t target, size_t k) const {
+  if (source >= impl_->num_nodes || target >= impl_->num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "query {} to {} is not on nodes",
+        source, target);
+  }
+  if (k == 0) {
+    return std::vector<WeightedPath>{};
+  }
+  if (impl_->plan.algorithm() == KShortestPathsPlan::kLabelSetting) {
+    return impl_->finder->LabelSetting(source, target, k);
+  }
+  return impl_->finder->Yen(source, target, k);
+}
+
+katana::Result<std::vector<WeightedPath>>
+katana::analytics::KShortestPaths(
+    PropertyGraph* pg, uint32_t source, uint32_t target, size_t k,
+    const std::string& edge_weight_property_name, KShortestPathsPlan plan) {
+  auto query = KATANA_CHECKED(
+      KShortestPathsQuery::Make(pg, edge_weight_property_name, plan));
+  return query->Paths(source, target, k);
+}
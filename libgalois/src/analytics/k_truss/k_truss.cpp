@@ -19,8 +19,17 @@
 
 #include "katana/analytics/k_truss/k_truss.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/MemoryBudget.h"
+#include "katana/SetIntersection.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/TriangleEnumeration.h"
 
 using namespace katana::analytics;
 
@@ -96,37 +105,18 @@ bool
 IsSupportNoLessThanJ(
     const SortedGraphView& g, GNode src, GNode dest, unsigned int j) {
   size_t numValidEqual = 0;
-  auto srcI = g.edges(src).begin(), srcE = g.edges(src).end(),
-       dstI = g.edges(dest).begin(), dstE = g.edges(dest).end();
-
-  while (true) {
-    //! Find the first valid edge.
-    while (srcI != srcE && (g.GetEdgeData<EdgeFlag>(*srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.GetEdgeData<EdgeFlag>(*dstI) & removed)) {
-      ++dstI;
-    }
-
-    if (srcI == srcE || dstI == dstE) {
-      return numValidEqual >= j;
-    }
-
-    //! Check for intersection.
-    auto sN = g.edge_dest(*srcI), dN = g.edge_dest(*dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
-      numValidEqual += 1;
-      if (numValidEqual >= j) {
-        return true;
-      }
-      ++srcI;
-      ++dstI;
-    }
-  }
+  auto src_first = *g.edges(src).begin();
+  auto dest_first = *g.edges(dest).begin();
+  katana::ForEachIntersection(
+      g.dest_data() + src_first, g.degree(src), g.dest_data() + dest_first,
+      g.degree(dest), [&](size_t i, size_t k) {
+        //! Count the common neighbors whose edges are both valid.
+        if (!(g.GetEdgeData<EdgeFlag>(src_first + i) & removed) &&
+            !(g.GetEdgeData<EdgeFlag>(dest_first + k) & removed)) {
+          numValidEqual += 1;
+        }
+        return numValidEqual < j;
+      });
 
   return numValidEqual >= j;
 }
@@ -327,8 +317,11 @@ BSPCoreThenTrussAlgo(SortedGraphView* g, uint32_t k) {
   katana::StatTimer TCore("Reduce_to_(k-1)-core");
   TCore.start();
 
-  if (auto r = BSPCoreAlgo(g, k - 1); !r) {
-    return r.error();
+  {
+    katana::MemoryPhase core_memory("Reduce_to_(k-1)-core");
+    if (auto r = BSPCoreAlgo(g, k - 1); !r) {
+      return r.error();
+    }
   }
 
   TCore.stop();
@@ -336,8 +329,11 @@ BSPCoreThenTrussAlgo(SortedGraphView* g, uint32_t k) {
   katana::StatTimer TTruss("Reduce_to_k-truss");
   TTruss.start();
 
-  if (auto r = BSPTrussAlgo(g, k); !r) {
-    return r.error();
+  {
+    katana::MemoryPhase truss_memory("Reduce_to_k-truss");
+    if (auto r = BSPTrussAlgo(g, k); !r) {
+      return r.error();
+    }
   }
 
   TTruss.stop();
@@ -349,6 +345,7 @@ katana::analytics::KTruss(
     katana::PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& output_property_name, KTrussPlan plan) {
   katana::ReportPageAllocGuard page_alloc;
+  katana::MemoryPhase memory("KTrussTotal");
 
   if (auto result =
           ConstructEdgeProperties<EdgeData>(pg, {output_property_name});
@@ -379,6 +376,7 @@ katana::analytics::KTruss(
 
   katana::StatTimer exec_time("KTruss");
   exec_time.start();
+  katana::MemoryPhase exec_memory("KTruss");
 
   switch (plan.algorithm()) {
   case KTrussPlan::kBsp:
@@ -392,6 +390,284 @@ katana::analytics::KTruss(
   }
 }
 
+struct KTrussEdgeTrussness : public katana::PODProperty<uint32_t> {};
+
+using TrussGraphView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::EdgesSortedByDestID, std::tuple<>,
+    std::tuple<KTrussEdgeTrussness>>;
+using TrussEdge = typename TrussGraphView::Edge;
+
+//! An edge (src, dest) with src < dest, which stands for both directions.
+using PeelEdge = std::pair<GNode, TrussEdge>;
+
+//! The number of buckets of supports materialized at a time.
+constexpr static const uint32_t kNumOpenBuckets = 128;
+
+//! The trussness of an edge that is not peeled yet.
+constexpr static const uint32_t kNotPeeled =
+    std::numeric_limits<uint32_t>::max();
+
+/**
+ * Peel edges in increasing order of their support, the number of triangles
+ * they are in with edges not peeled yet. An edge peeled at support s has
+ * trussness s + 2. Each bucket holds the edges whose support was some value
+ * when they were put in it, so a bucket may hold edges whose support has
+ * dropped since; these are skipped. Only kNumOpenBuckets buckets starting at
+ * the smallest support of the edges left are materialized.
+ *
+ * Only the direction from the smaller node of an edge holds its state;
+ * reverse maps every edge to its other direction.
+ *
+ * @param g Graph to operate on, with the trussness to compute
+ */
+katana::Result<void>
+BucketedEdgePeeling(TrussGraphView* g) {
+  const uint64_t num_edges = g->num_edges();
+  const GNode* dests = g->dest_data();
+  auto first_edge = [&](GNode n) -> TrussEdge { return *g->edges(n).begin(); };
+
+  katana::NUMAArray<TrussEdge> reverse;
+  reverse.allocateBlocked(num_edges);
+  katana::NUMAArray<std::atomic<uint32_t>> support;
+  support.allocateBlocked(num_edges);
+  katana::NUMAArray<uint32_t> trussness;
+  trussness.allocateBlocked(num_edges);
+  katana::NUMAArray<uint8_t> in_frontier;
+  in_frontier.allocateBlocked(num_edges);
+
+  //! Pair the two directions of every edge.
+  std::atomic<bool> symmetric{true};
+  katana::GAccumulator<uint64_t> num_peel_edges;
+  katana::GAccumulator<uint64_t> num_loops;
+  katana::do_all(
+      katana::iterate(*g),
+      [&](GNode n) {
+        for (auto e : g->edges(n)) {
+          GNode dest = dests[e];
+          trussness[e] = kNotPeeled;
+          in_frontier[e] = 0;
+          support[e].store(0, std::memory_order_relaxed);
+          if (dest == n) {
+            reverse[e] = e;
+            num_loops += 1;
+          } else if (n < dest) {
+            const GNode* begin = dests + first_edge(dest);
+            const GNode* end = begin + g->degree(dest);
+            const GNode* it = std::lower_bound(begin, end, n);
+            if (it == end || *it != n) {
+              symmetric = false;
+              continue;
+            }
+            TrussEdge r = first_edge(dest) + (it - begin);
+            reverse[e] = r;
+            reverse[r] = e;
+            num_peel_edges += 1;
+          }
+        }
+      },
+      katana::steal(), katana::loopname("KTrussDecomposition Pair Edges"),
+      katana::no_stats());
+  const uint64_t num_to_peel = num_peel_edges.reduce();
+  if (!symmetric || 2 * num_to_peel + num_loops.reduce() != num_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "graph must be symmetric");
+  }
+
+  //! Count the support of every edge, once for each triangle from its
+  //! highest node.
+  katana::PerThreadStorage<katana::SetBitmap> bitmaps;
+  katana::do_all(
+      katana::iterate(*g),
+      [&](GNode n) {
+        ForEachOrderedTriangle(
+            *g, n, bitmaps.getLocal(),
+            [&](TrussEdge nv, TrussEdge nw, TrussEdge vw) {
+              //! The edges go down, and their reverses hold their state.
+              support[reverse[nv]].fetch_add(1, std::memory_order_relaxed);
+              support[reverse[nw]].fetch_add(1, std::memory_order_relaxed);
+              support[reverse[vw]].fetch_add(1, std::memory_order_relaxed);
+            });
+      },
+      katana::chunk_size<64>(), katana::steal(),
+      katana::loopname("KTrussDecomposition Support"), katana::no_stats());
+
+  //! The direction of the edge e from n that holds its state.
+  auto canonical = [&](GNode n, TrussEdge e) {
+    return n < dests[e] ? PeelEdge{n, e} : PeelEdge{dests[e], reverse[e]};
+  };
+  auto peeled = [&](TrussEdge e) { return trussness[e] != kNotPeeled; };
+
+  //! Calls fn(e) for every edge e from the smaller node of an edge.
+  auto for_each_peel_edge = [&](auto fn, const char* loopname) {
+    katana::do_all(
+        katana::iterate(*g),
+        [&](GNode n) {
+          for (auto e : g->edges(n)) {
+            if (n < dests[e]) {
+              fn(PeelEdge{n, e});
+            }
+          }
+        },
+        katana::steal(), katana::loopname(loopname), katana::no_stats());
+  };
+
+  std::vector<katana::InsertBag<PeelEdge>> buckets(kNumOpenBuckets);
+  std::array<katana::InsertBag<PeelEdge>, 2> frontiers;
+  uint64_t num_peeled = 0;
+  while (num_peeled < num_to_peel) {
+    //! Open the buckets from the smallest support of the edges left.
+    katana::GReduceMin<uint32_t> min_support;
+    for_each_peel_edge(
+        [&](const PeelEdge& pe) {
+          if (!peeled(pe.second)) {
+            min_support.update(
+                support[pe.second].load(std::memory_order_relaxed));
+          }
+        },
+        "KTrussDecomposition Min Support");
+    const uint32_t base = min_support.reduce();
+    for_each_peel_edge(
+        [&](const PeelEdge& pe) {
+          uint32_t s = support[pe.second].load(std::memory_order_relaxed);
+          if (!peeled(pe.second) && s - base < kNumOpenBuckets) {
+            buckets[s - base].push(pe);
+          }
+        },
+        "KTrussDecomposition Open Buckets");
+
+    for (uint32_t b = 0; b < kNumOpenBuckets && num_peeled < num_to_peel;
+         ++b) {
+      const uint32_t s = base + b;
+      size_t current = 0;
+      frontiers[current].clear();
+      katana::do_all(
+          katana::iterate(buckets[b]),
+          [&](const PeelEdge& pe) {
+            if (!peeled(pe.second) &&
+                support[pe.second].load(std::memory_order_relaxed) == s) {
+              frontiers[current].push(pe);
+            }
+          },
+          katana::loopname("KTrussDecomposition Bucket"), katana::no_stats());
+      buckets[b].clear();
+
+      //! Peel the edges of support s, and then the edges that they bring
+      //! down to support s, until none are left.
+      while (!frontiers[current].empty()) {
+        katana::GAccumulator<uint64_t> num_peeled_now;
+        katana::do_all(
+            katana::iterate(frontiers[current]),
+            [&](const PeelEdge& pe) {
+              trussness[pe.second] = s + 2;
+              in_frontier[pe.second] = 1;
+              num_peeled_now += 1;
+            },
+            katana::loopname("KTrussDecomposition Peel"), katana::no_stats());
+        num_peeled += num_peeled_now.reduce();
+
+        //! Lower the support of an edge of a triangle of a peeled edge, but
+        //! not below the support being peeled.
+        auto& next = frontiers[1 - current];
+        auto decrement = [&](const PeelEdge& pe) {
+          uint32_t d = support[pe.second].load(std::memory_order_relaxed);
+          while (d > s && !support[pe.second].compare_exchange_weak(
+                              d, d - 1, std::memory_order_relaxed)) {
+          }
+          if (d <= s) {
+            return;
+          }
+          if (d - 1 == s) {
+            next.push(pe);
+          } else if (d - 1 - base < kNumOpenBuckets) {
+            buckets[d - 1 - base].push(pe);
+          }
+        };
+
+        next.clear();
+        katana::do_all(
+            katana::iterate(frontiers[current]),
+            [&](const PeelEdge& pe) {
+              GNode u = pe.first;
+              GNode v = dests[pe.second];
+              TrussEdge u_first = first_edge(u);
+              TrussEdge v_first = first_edge(v);
+              katana::ForEachIntersection(
+                  dests + u_first, g->degree(u), dests + v_first,
+                  g->degree(v), [&](size_t i, size_t j) {
+                    GNode w = dests[u_first + i];
+                    if (w == u || w == v) {
+                      return true;
+                    }
+                    PeelEdge uw = canonical(u, u_first + i);
+                    PeelEdge vw = canonical(v, v_first + j);
+                    bool uw_now = in_frontier[uw.second];
+                    bool vw_now = in_frontier[vw.second];
+                    //! The triangle is gone if an edge was peeled before.
+                    if ((peeled(uw.second) && !uw_now) ||
+                        (peeled(vw.second) && !vw_now)) {
+                      return true;
+                    }
+                    //! Of the edges of the triangle peeled now, the one
+                    //! with the smallest id lowers the others.
+                    if (!uw_now && !vw_now) {
+                      decrement(uw);
+                      decrement(vw);
+                    } else if (!vw_now && pe.second < uw.second) {
+                      decrement(vw);
+                    } else if (!uw_now && pe.second < vw.second) {
+                      decrement(uw);
+                    }
+                    return true;
+                  });
+            },
+            katana::steal(), katana::chunk_size<64>(),
+            katana::loopname("KTrussDecomposition Decrement"),
+            katana::no_stats());
+
+        katana::do_all(
+            katana::iterate(frontiers[current]),
+            [&](const PeelEdge& pe) { in_frontier[pe.second] = 0; },
+            katana::no_stats());
+        current = 1 - current;
+      }
+    }
+    for (auto& bucket : buckets) {
+      bucket.clear();
+    }
+  }
+
+  //! Copy the trussness to both directions of every edge.
+  katana::do_all(
+      katana::iterate(*g),
+      [&](GNode n) {
+        for (auto e : g->edges(n)) {
+          g->template GetEdgeData<KTrussEdgeTrussness>(e) =
+              dests[e] == n ? 0 : trussness[canonical(n, e).second];
+        }
+      },
+      katana::loopname("KTrussDecomposition Output"), katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::KTrussDecomposition(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  katana::ReportPageAllocGuard page_alloc;
+  katana::MemoryPhase memory("KTrussDecompositionTotal");
+
+  KATANA_CHECKED(ConstructEdgeProperties<std::tuple<KTrussEdgeTrussness>>(
+      pg, {output_property_name}));
+  auto graph =
+      KATANA_CHECKED(TrussGraphView::Make(pg, {}, {output_property_name}));
+
+  katana::StatTimer exec_time("KTrussDecomposition");
+  exec_time.start();
+  KATANA_CHECKED(BucketedEdgePeeling(&graph));
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
@@ -433,9 +709,54 @@ katana::analytics::KTrussStatistics::Compute(
 
   return KTrussStatistics{alive_edges.reduce()};
 }
+
+katana::Result<KTrussDecompositionStatistics>
+katana::analytics::KTrussDecompositionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(
+      (katana::TypedPropertyGraph<
+          std::tuple<>, std::tuple<KTrussEdgeTrussness>>::Make(
+          pg, {}, {property_name})));
+
+  katana::GReduceMax<uint32_t> max_trussness;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        for (auto e : graph.edges(node)) {
+          max_trussness.update(graph.GetEdgeData<KTrussEdgeTrussness>(e));
+        }
+      },
+      katana::loopname("KTrussDecomposition max truss"), katana::no_stats());
+  uint32_t max_truss = max_trussness.reduce();
+
+  katana::GAccumulator<uint64_t> edges_in_max_truss;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        for (auto e : graph.edges(node)) {
+          if (node < *graph.GetEdgeDest(e) &&
+              graph.GetEdgeData<KTrussEdgeTrussness>(e) == max_truss) {
+            edges_in_max_truss += 1;
+          }
+        }
+      },
+      katana::loopname("KTrussDecomposition max truss size"),
+      katana::no_stats());
+
+  return KTrussDecompositionStatistics{
+      max_truss, edges_in_max_truss.reduce()};
+}
 /// \endcond DO_NOT_DOCUMENT
 
 void
 katana::analytics::KTrussStatistics::Print(std::ostream& os) const {
   os << "Number of nodes in the core = " << number_of_edges_left << std::endl;
 }
+
+void
+katana::analytics::KTrussDecompositionStatistics::Print(
+    std::ostream& os) const {
+  os << "Largest trussness = " << max_trussness << std::endl;
+  os << "Number of edges in the largest truss = "
+     << number_of_edges_in_max_truss << std::endl;
+}
@@ -0,0 +1,355 @@
+#include "katana/analytics/label_propagation/label_propagation.h"
+
+#include <arrow/api.h>
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/ConcurrentHashMap.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/ClusteringImplementationBase.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// Call fn with a value of the type of the edge weights
+template <typename F>
+std::invoke_result_t<F, uint32_t>
+VisitEdgeWeightType(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    F fn) {
+  auto property = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return fn(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return fn(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return fn(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return fn(int64_t{});
+  case arrow::FloatType::type_id:
+    return fn(float{});
+  case arrow::DoubleType::type_id:
+    return fn(double{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported edge weight type {}",
+        property->type()->ToString());
+  }
+}
+
+template <typename EdgeWeightType>
+using LabelGraph = katana::TypedPropertyGraph<
+    std::tuple<CurrentCommunityId>, std::tuple<EdgeWeight<EdgeWeightType>>>;
+
+template <typename EdgeWeightType>
+struct LabelPropagationImplementation
+    : public ClusteringImplementationBase<
+          LabelGraph<EdgeWeightType>, EdgeWeightType,
+          CommunityType<EdgeWeightType>> {
+  using Graph = LabelGraph<EdgeWeightType>;
+  using GNode = typename Graph::Node;
+  using Base = ClusteringImplementationBase<
+      Graph, EdgeWeightType, CommunityType<EdgeWeightType>>;
+  using ClusterWeightMap = typename Base::ClusterWeightMap;
+
+  Graph* graph_;
+  katana::PerThreadStorage<ClusterWeightMap> label_weights_;
+
+  explicit LabelPropagationImplementation(Graph* graph) : graph_(graph) {}
+
+  /**
+   * \returns the label of the largest total edge weight among the neighbors
+   * of n, other than n itself. The current label of n wins ties, and
+   * otherwise the smallest label does.
+   */
+  uint64_t BestLabel(GNode n) {
+    ClusterWeightMap& weights = *label_weights_.getLocal();
+    EdgeWeightType self_loop_wt = 0;
+    // the current label of n comes first
+    this->template FindNeighboringClusters<EdgeWeightType>(
+        *graph_, n, weights, self_loop_wt);
+    weights.begin()->second -= self_loop_wt;
+
+    auto best = weights.begin();
+    for (auto it = std::next(weights.begin()); it != weights.end(); ++it) {
+      if (it->second > best->second ||
+          (it->second == best->second && best != weights.begin() &&
+           it->first < best->first)) {
+        best = it;
+      }
+    }
+    uint64_t label = best->first;
+    weights.Clear();
+    return label;
+  }
+
+  void Synchronous(uint32_t max_iterations) {
+    katana::NUMAArray<uint64_t> next_labels;
+    next_labels.allocateBlocked(graph_->num_nodes());
+
+    uint32_t iterations = 0;
+    while (iterations < max_iterations) {
+      katana::GAccumulator<uint64_t> changed;
+      katana::do_all(
+          katana::iterate(*graph_),
+          [&](GNode n) {
+            next_labels[n] = BestLabel(n);
+            if (next_labels[n] !=
+                graph_->template GetData<CurrentCommunityId>(n)) {
+              changed += 1;
+            }
+          },
+          katana::steal(), katana::loopname("LabelPropagation-Synchronous"));
+      katana::do_all(
+          katana::iterate(*graph_),
+          [&](GNode n) {
+            graph_->template GetData<CurrentCommunityId>(n) = next_labels[n];
+          },
+          katana::no_stats());
+      iterations += 1;
+      if (changed.reduce() == 0) {
+        break;
+      }
+    }
+    katana::ReportStatSingle(
+        "LabelPropagation-Synchronous", "iterations", iterations);
+  }
+
+  void Asynchronous(uint32_t max_iterations) {
+    using Bag = katana::InsertBag<GNode>;
+
+    // nodes already pushed to the next frontier
+    katana::NUMAArray<std::atomic<uint8_t>> queued;
+    queued.allocateBlocked(graph_->num_nodes());
+
+    auto cur = std::make_unique<Bag>();
+    auto next = std::make_unique<Bag>();
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](GNode n) {
+          queued[n].store(0, std::memory_order_relaxed);
+          cur->push(n);
+        },
+        katana::no_stats());
+
+    uint32_t iterations = 0;
+    while (iterations < max_iterations && !cur->empty()) {
+      katana::do_all(
+          katana::iterate(*cur),
+          [&](GNode n) { queued[n].store(0, std::memory_order_relaxed); },
+          katana::no_stats());
+      katana::do_all(
+          katana::iterate(*cur),
+          [&](GNode n) {
+            uint64_t label = BestLabel(n);
+            auto& current = graph_->template GetData<CurrentCommunityId>(n);
+            if (label == current) {
+              return;
+            }
+            current = label;
+            for (auto e : graph_->edges(n)) {
+              auto dest = *graph_->GetEdgeDest(e);
+              if (dest != n &&
+                  queued[dest].exchange(1, std::memory_order_relaxed) == 0) {
+                next->push(dest);
+              }
+            }
+          },
+          katana::steal(), katana::loopname("LabelPropagation-Asynchronous"));
+      cur->clear();
+      std::swap(cur, next);
+      iterations += 1;
+    }
+    katana::ReportStatSingle(
+        "LabelPropagation-Asynchronous", "iterations", iterations);
+  }
+
+  /**
+   * Renames every label to the smallest id of a node that has it.
+   */
+  void RenameLabels() {
+    katana::NUMAArray<std::atomic<uint64_t>> smallest;
+    smallest.allocateBlocked(graph_->num_nodes());
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](GNode n) {
+          smallest[n].store(
+              std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](GNode n) {
+          auto& s = smallest[graph_->template GetData<CurrentCommunityId>(n)];
+          uint64_t old = s.load(std::memory_order_relaxed);
+          while (n < old &&
+                 !s.compare_exchange_weak(old, n, std::memory_order_relaxed)) {
+          }
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](GNode n) {
+          auto& label = graph_->template GetData<CurrentCommunityId>(n);
+          label = smallest[label].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+
+  void Run(LabelPropagationPlan plan) {
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](GNode n) { graph_->template GetData<CurrentCommunityId>(n) = n; },
+        katana::no_stats());
+
+    if (plan.algorithm() == LabelPropagationPlan::kSynchronous) {
+      Synchronous(plan.max_iterations());
+    } else {
+      Asynchronous(plan.max_iterations());
+    }
+    RenameLabels();
+  }
+};
+
+using CommunityGraph =
+    katana::TypedPropertyGraph<std::tuple<CurrentCommunityId>, std::tuple<>>;
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::LabelPropagation(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, LabelPropagationPlan plan) {
+  if (plan.algorithm() != LabelPropagationPlan::kSynchronous &&
+      plan.algorithm() != LabelPropagationPlan::kAsynchronous) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  return VisitEdgeWeightType(
+      pg, edge_weight_property_name,
+      [&](auto weight) -> katana::Result<void> {
+        using EdgeWeightType = decltype(weight);
+        using Impl = LabelPropagationImplementation<EdgeWeightType>;
+
+        KATANA_CHECKED(ConstructNodeProperties<std::tuple<CurrentCommunityId>>(
+            pg, {output_property_name}));
+        auto graph = KATANA_CHECKED(LabelGraph<EdgeWeightType>::Make(
+            pg, {output_property_name}, {edge_weight_property_name}));
+
+        katana::StatTimer exec_time("LabelPropagation");
+        exec_time.start();
+        Impl impl(&graph);
+        impl.Run(plan);
+        exec_time.stop();
+        return katana::ResultSuccess();
+      });
+}
+
+katana::Result<void>
+katana::analytics::LabelPropagationAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(CommunityGraph::Make(pg, {property_name}, {}));
+
+  katana::GReduceLogicalOr bad_id;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) {
+        uint64_t id = graph.GetData<CurrentCommunityId>(n);
+        if (id > n || graph.GetData<CurrentCommunityId>(id) != id) {
+          bad_id.update(true);
+        }
+      },
+      katana::no_stats());
+  if (bad_id.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "some community ID is not the smallest node id of its community");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<LabelPropagationStatistics>
+katana::analytics::LabelPropagationStatistics::Compute(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  auto graph = KATANA_CHECKED(CommunityGraph::Make(pg, {property_name}, {}));
+
+  // Community IDs are node ids, so the number of nodes is free to mark empty
+  // slots
+  katana::ConcurrentHashMap<uint64_t, uint64_t> community_sizes(
+      graph.num_nodes() + 1, graph.num_nodes());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) {
+        community_sizes.FindOrInsert(graph.GetData<CurrentCommunityId>(n))
+            .fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::loopname("CountCommunities"));
+
+  katana::GReduceMax<uint64_t> largest;
+  katana::GAccumulator<uint64_t> non_trivial;
+  community_sizes.ForEach([&](uint64_t, uint64_t size) {
+    largest.update(size);
+    if (size > 1) {
+      non_trivial += 1;
+    }
+  });
+
+  uint64_t largest_community_size = largest.reduce();
+  double largest_community_proportion = 0;
+  if (!graph.empty()) {
+    largest_community_proportion =
+        double(largest_community_size) / graph.size();
+  }
+
+  double modularity = KATANA_CHECKED(VisitEdgeWeightType(
+      pg, edge_weight_property_name,
+      [&](auto weight) -> katana::Result<double> {
+        using EdgeWeightType = decltype(weight);
+        using Graph = LabelGraph<EdgeWeightType>;
+        using ClusterBase = ClusteringImplementationBase<
+            Graph, EdgeWeightType, CommunityType<EdgeWeightType>>;
+        auto weighted_graph = KATANA_CHECKED(
+            Graph::Make(pg, {property_name}, {edge_weight_property_name}));
+        return ClusterBase::template CalModularityFinal<
+            Graph, EdgeWeightType, CurrentCommunityId>(weighted_graph);
+      }));
+
+  return LabelPropagationStatistics{
+      community_sizes.size(), non_trivial.reduce(), largest_community_size,
+      largest_community_proportion, modularity};
+}
+
+void
+katana::analytics::LabelPropagationStatistics::Print(std::ostream& os) const {
+  os << "Total number of communities = " << n_communities << std::endl;
+  os << "Total number of non trivial communities = "
+     << n_non_trivial_communities << std::endl;
+  os << "Number of nodes in the largest community = "
+     << largest_community_size << std::endl;
+  os << "Ratio of nodes in the largest community = "
+     << largest_community_proportion << std::endl;
+  os << "Modularity = " << modularity << std::endl;
+}
@@ -19,7 +19,11 @@
 
 #include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
 
+#include <algorithm>
+
 #include "katana/AtomicHelpers.h"
+#include "katana/SetIntersection.h"
+#include "katana/analytics/TriangleEnumeration.h"
 
 using namespace katana::analytics;
 
@@ -35,7 +39,14 @@ using SortedPropertyGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 using SortedGraphView =
     katana::TypedPropertyGraphView<SortedPropertyGraphView, NodeData, EdgeData>;
 using Node = SortedGraphView::Node;
+using Edge = SortedGraphView::Edge;
 
+/**
+ * Calls fn(v, w) for each triangle n > v > w, found by intersecting the
+ * neighbors of n and v below v. The neighbors of a hub n go in a bitmap
+ * instead, so that each intersection takes one pass over the neighbors of
+ * v. It assumes that edgelist of each node is sorted.
+ */
 struct LocalClusteringCoefficientAtomics {
   /**
    * Counts the number of triangles for each node
@@ -47,30 +58,14 @@ struct LocalClusteringCoefficientAtomics {
    */
   template <typename CountVec>
   void OrderedCountFunc(
-      const SortedGraphView& graph, Node n, CountVec* count_vec) {
+      const SortedGraphView& graph, Node n, katana::SetBitmap* bitmap,
+      CountVec* count_vec) {
     // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.edges(n)) {
-      auto v = graph.edge_dest(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.edges(n).begin();
-
-      for (auto edges_v : graph.edges(v)) {
-        auto dst_v = graph.edge_dest(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.edge_dest(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.edge_dest(*e_it_n)) {
-          __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[dst_v], uint32_t{1});
-        }
-      }
-    }
+    ForEachOrderedTriangle(graph, n, bitmap, [&](Edge nv, Edge, Edge vw) {
+      __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
+      __sync_fetch_and_add(&(*count_vec)[graph.edge_dest(nv)], uint32_t{1});
+      __sync_fetch_and_add(&(*count_vec)[graph.edge_dest(vw)], uint32_t{1});
+    });
   }
 
   void ComputeLocalClusteringCoefficient(SortedGraphView* graph) {
@@ -81,10 +76,11 @@ struct LocalClusteringCoefficientAtomics {
         per_node_triangles.begin(), per_node_triangles.end(), uint32_t{0});
 
     // Count triangles
+    katana::PerThreadStorage<katana::SetBitmap> bitmaps;
     katana::do_all(
         katana::iterate(*graph),
         [&](const Node& n) {
-          OrderedCountFunc(*graph, n, &per_node_triangles);
+          OrderedCountFunc(*graph, n, bitmaps.getLocal(), &per_node_triangles);
         },
         katana::chunk_size<kChunkSize>(), katana::steal(),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
@@ -132,30 +128,14 @@ struct LocalClusteringCoefficientPerThread {
  * is sorted.
  */
   void OrderedCountFunc(
-      const SortedGraphView& graph, Node n, IterPair per_thread_count_range) {
+      const SortedGraphView& graph, Node n, katana::SetBitmap* bitmap,
+      IterPair per_thread_count_range) {
     // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.edges(n)) {
-      auto v = graph.edge_dest(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.edges(n).begin();
-
-      for (auto edges_v : graph.edges(v)) {
-        auto dst_v = graph.edge_dest(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.edge_dest(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.edge_dest(*e_it_n)) {
-          *(per_thread_count_range.first + n) += 1;
-          *(per_thread_count_range.first + v) += 1;
-          *(per_thread_count_range.first + dst_v) += 1;
-        }
-      }
-    }
+    ForEachOrderedTriangle(graph, n, bitmap, [&](Edge nv, Edge, Edge vw) {
+      *(per_thread_count_range.first + n) += 1;
+      *(per_thread_count_range.first + graph.edge_dest(nv)) += 1;
+      *(per_thread_count_range.first + graph.edge_dest(vw)) += 1;
+    });
   }
 
   /*
@@ -180,11 +160,13 @@ struct LocalClusteringCoefficientPerThread {
           all_thread_count_vec.begin(), all_thread_count_vec.end(), tid, numT);
     });
 
+    katana::PerThreadStorage<katana::SetBitmap> bitmaps;
     katana::do_all(
         katana::iterate(graph),
         [&](const Node& n) {
           OrderedCountFunc(
-              graph, n, *per_thread_node_triangle_count.getLocal());
+              graph, n, bitmaps.getLocal(),
+              *per_thread_node_triangle_count.getLocal());
         },
         katana::chunk_size<kChunkSize>(), katana::steal(),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
@@ -22,6 +22,8 @@
 #include <deque>
 #include <type_traits>
 
+#include "katana/ConcurrentHashMap.h"
+#include "katana/MemoryBudget.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/ClusteringImplementationBase.h"
 
@@ -49,11 +51,37 @@ struct LouvainClusteringImplementation
   using Base = katana::analytics::ClusteringImplementationBase<
       Graph, EdgeWeightType, CommTy>;
 
+  /**
+   * Assigns each node to its own cluster, or to the cluster in its
+   * PreviousCommunityId if start_from_previous, and sums up the degree
+   * weight of each vertex and cluster.
+   */
+  void InitializeClusters(
+      Graph* graph, CommunityArray& c_info, bool start_from_previous) {
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      if (start_from_previous) {
+        graph->template GetData<CurrentCommunityId>(n) =
+            graph->template GetData<PreviousCommunityId>(n);
+      } else {
+        graph->template GetData<CurrentCommunityId>(n) = n;
+        graph->template GetData<PreviousCommunityId>(n) = n;
+      }
+    });
+
+    /* Calculate the weighted degree sum for each vertex */
+    Base::template SumVertexDegreeWeight<EdgeWeightType>(graph, c_info);
+    if (start_from_previous) {
+      Base::template SumClusterDegreeWeight<EdgeWeightType>(*graph, c_info);
+    }
+  }
+
   katana::Result<double> LouvainWithoutLockingDoAll(
       katana::PropertyGraph* pfg, double lower,
-      double modularity_threshold_per_round, uint32_t& iter) {
+      double modularity_threshold_per_round, uint32_t& iter,
+      bool start_from_previous) {
     katana::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
     TimerClusteringTotal.start();
+    katana::MemoryPhase clustering_memory("Timer_Clustering_Total");
 
     auto graph_result = Graph::Make(pfg);
     if (!graph_result) {
@@ -74,19 +102,17 @@ struct LouvainClusteringImplementation
     c_info.allocateBlocked(graph.num_nodes());
     c_update.allocateBlocked(graph.num_nodes());
 
-    /* Initialization each node to its own cluster */
-    katana::do_all(katana::iterate(graph), [&](GNode n) {
-      graph.template GetData<CurrentCommunityId>(n) = n;
-      graph.template GetData<PreviousCommunityId>(n) = n;
-    });
-
-    /* Calculate the weighted degree sum for each vertex */
-    Base::template SumVertexDegreeWeight<EdgeWeightType>(&graph, c_info);
+    InitializeClusters(&graph, c_info, start_from_previous);
 
     /* Compute the total weight (2m) and 1/2m terms */
     constant_for_second_term =
         Base::template CalConstantForSecondTerm<EdgeWeightType>(graph);
 
+    // Map each neighbor's cluster to the weight of the edges to it:
+    // Community --> Weight; reused across nodes to avoid allocating
+    katana::PerThreadStorage<typename Base::ClusterWeightMap>
+        cluster_local_maps;
+
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
     while (true) {
@@ -108,19 +134,16 @@ struct LouvainClusteringImplementation
             uint64_t degree =
                 std::distance(graph.edge_begin(n), graph.edge_end(n));
             uint64_t local_target = Base::UNASSIGNED;
-            std::map<uint64_t, uint64_t>
-                cluster_local_map;  // Map each neighbor's cluster to local number:
-                                    // Community --> Index
-            std::vector<EdgeWeightType>
-                counter;  // Number of edges to each unique cluster
+            auto& cluster_local_map = *cluster_local_maps.getLocal();
+            cluster_local_map.Clear();
             EdgeWeightType self_loop_wt = 0;
 
             if (degree > 0) {
               Base::template FindNeighboringClusters<EdgeWeightType>(
-                  graph, n, cluster_local_map, counter, self_loop_wt);
+                  graph, n, cluster_local_map, self_loop_wt);
               // Find the max gain in modularity
               local_target = Base::MaxModularityWithoutSwaps(
-                  cluster_local_map, counter, self_loop_wt, c_info,
+                  cluster_local_map, self_loop_wt, c_info,
                   n_data_degree_wt, n_data_curr_comm_id,
                   constant_for_second_term);
 
@@ -173,24 +196,32 @@ struct LouvainClusteringImplementation
     return prev_mod;
   }
 
+  /**
+   * Deterministic local moving: the nodes move in Base::kNumRounds rounds
+   * by node id, each node picking its cluster from the clusters as they
+   * were at the start of the round, and the moves of a round are applied
+   * after it in sorted order. The modularity is summed up in fixed blocks,
+   * so the clusters do not depend on the number of threads.
+   */
   // TODO The function arguments are  similar to
   // the non-deterministic one. Need to figure how to
   // do remove duplication
   katana::Result<double> LouvainDeterministic(
       katana::PropertyGraph* pfg, double lower,
-      double modularity_threshold_per_round, uint32_t& iter) {
+      double modularity_threshold_per_round, uint32_t& iter,
+      bool start_from_previous) {
     katana::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
     katana::TimerGuard TimerClusteringGuard(TimerClusteringTotal);
+    katana::MemoryPhase clustering_memory("Timer_Clustering_Total");
 
     auto graph_result = Graph::Make(pfg);
     if (!graph_result) {
       return graph_result.error();
     }
     Graph graph = graph_result.value();
+    const uint64_t num_nodes = graph.num_nodes();
 
-    CommunityArray c_info;        // Community info
-    CommunityArray c_update_add;  // Used for updating community
-    CommunityArray c_update_subtract;
+    CommunityArray c_info;  // Community info
 
     /* Variables needed for Modularity calculation */
     double constant_for_second_term;
@@ -199,46 +230,30 @@ struct LouvainClusteringImplementation
     uint32_t num_iter = iter;
 
     /*** Initialization ***/
-    c_info.allocateBlocked(graph.num_nodes());
-    c_update_add.allocateBlocked(graph.num_nodes());
-    c_update_subtract.allocateBlocked(graph.num_nodes());
-
-    /* Initialization each node to its own cluster */
-    katana::do_all(katana::iterate(graph), [&](GNode n) {
-      graph.template GetData<CurrentCommunityId>(n) = n;
-      graph.template GetData<PreviousCommunityId>(n) = n;
-    });
+    c_info.allocateBlocked(num_nodes);
 
-    /* Calculate the weighted degree sum for each vertex */
-    Base::template SumVertexDegreeWeight<EdgeWeightType>(&graph, c_info);
+    InitializeClusters(&graph, c_info, start_from_previous);
 
     /* Compute the total weight (2m) and 1/2m terms */
     constant_for_second_term =
         Base::template CalConstantForSecondTerm<EdgeWeightType>(graph);
 
     katana::NUMAArray<uint64_t> local_target;
-    local_target.allocateBlocked(graph.num_nodes());
-
-    // partition nodes
-    std::vector<katana::InsertBag<GNode>> bag(16);
-
-    katana::InsertBag<GNode> to_process;
-    katana::NUMAArray<bool> in_bag;
-    in_bag.allocateBlocked(graph.num_nodes());
-
+    local_target.allocateBlocked(num_nodes);
     katana::do_all(katana::iterate(graph), [&](GNode n) {
-      uint64_t idx = n % 16;
-      bag[idx].push(n);
-      in_bag[n] = false;
       local_target[n] = Base::UNASSIGNED;
     });
 
-    katana::do_all(katana::iterate(graph), [&](GNode n) {
-      c_update_add[n].degree_wt = 0;
-      c_update_add[n].size = 0;
-      c_update_subtract[n].degree_wt = 0;
-      c_update_subtract[n].size = 0;
-    });
+    // The moves of a round, out of and into clusters
+    katana::NUMAArray<uint64_t> move_offsets;
+    katana::NUMAArray<ClusterMove> moves;
+    move_offsets.allocateInterleaved(Base::RoundSize(num_nodes, 0));
+    moves.allocateInterleaved(2 * Base::RoundSize(num_nodes, 0));
+
+    // Map each neighbor's cluster to the weight of the edges to it:
+    // Community --> Weight; reused across nodes to avoid allocating
+    katana::PerThreadStorage<typename Base::ClusterWeightMap>
+        cluster_local_maps;
 
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
@@ -246,12 +261,13 @@ struct LouvainClusteringImplementation
     while (true) {
       num_iter++;
 
-      for (uint64_t idx = 0; idx <= 15; idx++) {
-        katana::GAccumulator<uint32_t> sync_round;
+      for (uint64_t round = 0; round < Base::kNumRounds; ++round) {
+        const uint64_t round_size = Base::RoundSize(num_nodes, round);
 
         katana::do_all(
-            katana::iterate(bag[idx]),
-            [&](GNode n) {
+            katana::iterate(uint64_t{0}, round_size),
+            [&](uint64_t i) {
+              GNode n = round + i * Base::kNumRounds;
               auto& n_data_curr_comm_id =
                   graph.template GetData<CurrentCommunityId>(n);
               auto& n_data_degree_wt =
@@ -260,73 +276,41 @@ struct LouvainClusteringImplementation
               uint64_t degree =
                   std::distance(graph.edge_begin(n), graph.edge_end(n));
 
-              std::map<uint64_t, uint64_t>
-                  cluster_local_map;  // Map each neighbor's cluster to local number:
-                                      // Community --> Index
-              std::vector<EdgeWeightType>
-                  counter;  // Number of edges to each unique cluster
+              auto& cluster_local_map = *cluster_local_maps.getLocal();
+              cluster_local_map.Clear();
               EdgeWeightType self_loop_wt = 0;
 
               if (degree > 0) {
                 Base::template FindNeighboringClusters<EdgeWeightType>(
-                    graph, n, cluster_local_map, counter, self_loop_wt);
+                    graph, n, cluster_local_map, self_loop_wt);
                 // Find the max gain in modularity
                 local_target[n] = Base::MaxModularityWithoutSwaps(
-                    cluster_local_map, counter, self_loop_wt, c_info,
+                    cluster_local_map, self_loop_wt, c_info,
                     n_data_degree_wt, n_data_curr_comm_id,
                     constant_for_second_term);
 
               } else {
                 local_target[n] = Base::UNASSIGNED;
               }
-
-              /* Update cluster info */
-              if (local_target[n] != n_data_curr_comm_id &&
-                  local_target[n] != Base::UNASSIGNED) {
-                katana::atomicAdd(
-                    c_update_add[local_target[n]].degree_wt, n_data_degree_wt);
-                katana::atomicAdd(
-                    c_update_add[local_target[n]].size, (uint64_t)1);
-                katana::atomicAdd(
-                    c_update_subtract[n_data_curr_comm_id].degree_wt,
-                    n_data_degree_wt);
-                katana::atomicAdd(
-                    c_update_subtract[n_data_curr_comm_id].size, (uint64_t)1);
-
-                if (!in_bag[local_target[n]]) {
-                  to_process.push(local_target[n]);
-                  in_bag[local_target[n]] = true;
-                }
-
-                if (!in_bag[n_data_curr_comm_id]) {
-                  to_process.push(n_data_curr_comm_id);
-                  in_bag[n_data_curr_comm_id] = true;
-                }
-              }
             },
-            katana::loopname("louvain algo: Phase 1"));
+            katana::steal(), katana::loopname("louvain algo: Phase 1"));
 
-        katana::do_all(katana::iterate(bag[idx]), [&](GNode n) {
-          graph.template GetData<CurrentCommunityId>(n) = local_target[n];
+        /* Update cluster info */
+        uint64_t num_moves = Base::GatherMoves(
+            num_nodes, round, local_target,
+            [&](uint64_t n) {
+              return graph.template GetData<CurrentCommunityId>(n);
+            },
+            move_offsets, moves);
+        Base::ApplyClusterMoves(moves, num_moves, c_info, [&](uint64_t n) {
+          return graph.template GetData<DegreeWeight<EdgeWeightType>>(n);
         });
 
-        for (auto n : to_process) {
-          if (in_bag[n]) {
-            katana::atomicAdd(c_info[n].size, c_update_add[n].size.load());
-            katana::atomicAdd(
-                c_info[n].degree_wt, c_update_add[n].degree_wt.load());
-
-            katana::atomicSub(c_info[n].size, c_update_subtract[n].size.load());
-            katana::atomicSub(
-                c_info[n].degree_wt, c_update_subtract[n].degree_wt.load());
-            c_update_add[n].size = 0;
-            c_update_add[n].degree_wt = 0;
-            c_update_subtract[n].size = 0;
-            c_update_subtract[n].degree_wt = 0;
-            in_bag[n] = false;
-          }
-        }
-
+        katana::do_all(
+            katana::iterate(uint64_t{0}, round_size), [&](uint64_t i) {
+              GNode n = round + i * Base::kNumRounds;
+              graph.template GetData<CurrentCommunityId>(n) = local_target[n];
+            });
       }  // end for
 
       /* Calculate the overall modularity */
@@ -438,12 +422,15 @@ public:
         return graph_result.error();
       }
       Graph graph_curr = graph_result.value();
+      // Past the first level, the nodes are refined clusters and the
+      // clusters they were refined from are the starting point
+      bool start_from_previous = plan.enable_refinement() && phase > 1;
       if (graph_curr.num_nodes() > plan.min_graph_size()) {
         switch (plan.algorithm()) {
         case LouvainClusteringPlan::kDoAll: {
           auto curr_mod_result = LouvainWithoutLockingDoAll(
               pfg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
-              iter);
+              iter, start_from_previous);
           if (!curr_mod_result) {
             return curr_mod_result.error();
           }
@@ -453,7 +440,7 @@ public:
         case LouvainClusteringPlan::kDeterministic: {
           auto curr_mod_result = LouvainDeterministic(
               pfg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
-              iter);
+              iter, start_from_previous);
           if (!curr_mod_result) {
             return curr_mod_result.error();
           }
@@ -472,6 +459,11 @@ public:
 
       if (iter < plan.max_iterations() &&
           (curr_mod - prev_mod) > plan.modularity_threshold_total()) {
+        if (plan.enable_refinement()) {
+          Base::template RefineClusters<EdgeWeightType>(&graph_curr);
+          num_unique_clusters = Base::RenumberClustersContiguously(&graph_curr);
+        }
+
         if (!plan.enable_vf() && phase == 1) {
           KATANA_LOG_DEBUG_ASSERT(num_nodes_orig == graph_curr.num_nodes());
           katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
@@ -491,6 +483,16 @@ public:
               });
         }
 
+        // The cluster of each refined cluster, which becomes a node
+        katana::NUMAArray<uint64_t> clusters_next;
+        if (plan.enable_refinement()) {
+          clusters_next.allocateBlocked(num_unique_clusters);
+          katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+            clusters_next[graph_curr.template GetData<CurrentCommunityId>(n)] =
+                graph_curr.template GetData<PreviousCommunityId>(n);
+          });
+        }
+
         auto coarsened_graph_result =
             Base::template GraphCoarsening<NodeData, EdgeData, EdgeWeightType>(
                 graph_curr, pfg_curr.get(), num_unique_clusters,
@@ -501,11 +503,33 @@ public:
 
         pfg_curr = std::move(coarsened_graph_result.value());
 
+        if (plan.enable_refinement()) {
+          auto graph_next = KATANA_CHECKED(Graph::Make(pfg_curr.get()));
+          katana::do_all(katana::iterate(graph_next), [&](GNode n) {
+            graph_next.template GetData<PreviousCommunityId>(n) =
+                clusters_next[n];
+          });
+        }
+
         prev_mod = curr_mod;
       } else {
         break;
       }
     }
+
+    // The nodes of a coarsened graph are refined clusters; report the
+    // clusters they were refined from
+    if (plan.enable_refinement() && phase > 1) {
+      auto graph_last = KATANA_CHECKED(Graph::Make(pfg_curr.get()));
+      katana::do_all(
+          katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
+            if (clusters_orig[n] != Base::UNASSIGNED) {
+              clusters_orig[n] =
+                  graph_last.template GetData<PreviousCommunityId>(
+                      clusters_orig[n]);
+            }
+          });
+    }
     return katana::ResultSuccess();
   }
 };
@@ -519,6 +543,8 @@ LouvainClusteringWithWrap(
       std::is_integral_v<EdgeWeightType> ||
       std::is_floating_point_v<EdgeWeightType>);
 
+  katana::MemoryPhase memory("LouvainClusteringTotal");
+
   std::vector<TemporaryPropertyGuard> temp_node_properties(3);
   std::generate_n(
       temp_node_properties.begin(), temp_node_properties.size(),
@@ -662,37 +688,20 @@ katana::analytics::LouvainClusteringStatistics::Compute(
   }
   auto graph = graph_result.value();
 
-  using Map = katana::gstl::Map<uint64_t, uint64_t>;
-
-  auto reduce = [](Map& lhs, Map&& rhs) -> Map& {
-    Map v{std::move(rhs)};
-
-    for (auto& kv : v) {
-      if (lhs.count(kv.first) == 0) {
-        lhs[kv.first] = 0;
-      }
-      lhs[kv.first] += kv.second;
-    }
-
-    return lhs;
-  };
-
-  auto mapIdentity = []() { return Map(); };
-
-  auto accumMap = katana::make_reducible(reduce, mapIdentity);
-
-  katana::GAccumulator<size_t> accumReps;
+  // Cluster ids are node ids or UNASSIGNED, so the number of nodes is free
+  // to mark empty slots
+  katana::ConcurrentHashMap<uint64_t, uint64_t> cluster_sizes(
+      graph.num_nodes() + 1, graph.num_nodes());
 
   katana::do_all(
       katana::iterate(graph),
       [&](const uint32_t& x) {
         auto& n = graph.template GetData<PreviousCommunityId>(x);
-        accumMap.update(Map{std::make_pair(n, uint64_t{1})});
+        cluster_sizes.FindOrInsert(n).fetch_add(1, std::memory_order_relaxed);
       },
       katana::loopname("CountLargest"));
 
-  Map& map = accumMap.reduce();
-  size_t reps = map.size();
+  size_t reps = cluster_sizes.size();
 
   using ClusterSizePair = std::pair<uint32_t, uint32_t>;
 
@@ -708,7 +717,8 @@ katana::analytics::LouvainClusteringStatistics::Compute(
   auto maxComp = katana::make_reducible(sizeMax, identity);
 
   katana::GAccumulator<uint64_t> non_trivial_clusters;
-  katana::do_all(katana::iterate(map), [&](const ClusterSizePair& x) {
+  cluster_sizes.ForEach([&](uint64_t cluster, uint64_t size) {
+    ClusterSizePair x(cluster, size);
     maxComp.update(x);
     if (x.second > 1) {
       non_trivial_clusters += 1;
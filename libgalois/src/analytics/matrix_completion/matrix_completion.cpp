@@ -0,0 +1,560 @@
+#include "katana/analytics/matrix_completion/matrix_completion.h"
+
+#include <arrow/api.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using Node = BiDirView::Node;
+
+template <typename Rating>
+struct EdgeRating : public katana::PODProperty<Rating> {};
+
+template <typename Rating>
+using RatingGraph =
+    katana::TypedPropertyGraph<std::tuple<>, std::tuple<EdgeRating<Rating>>>;
+
+/// The latent vectors are kept padded with zeros to a multiple of this many
+/// floats (a cache line), so each vector is aligned and the loops over them
+/// run in whole vector registers
+constexpr uint32_t kLanes = 16;
+
+/// Call fn with a value of the type of the edge ratings
+template <typename F>
+std::invoke_result_t<F, float>
+VisitRatingType(
+    katana::PropertyGraph* pg, const std::string& edge_rating_property_name,
+    F fn) {
+  auto property = pg->GetEdgeProperty(edge_rating_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_rating_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::FloatType::type_id:
+    return fn(float{});
+  case arrow::DoubleType::type_id:
+    return fn(double{});
+  case arrow::UInt32Type::type_id:
+    return fn(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return fn(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return fn(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return fn(int64_t{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported edge rating type {}",
+        property->type()->ToString());
+  }
+}
+
+/// \returns the ratings as floats, by edge property index
+template <typename Rating>
+katana::Result<katana::NUMAArray<float>>
+ReadRatings(
+    katana::PropertyGraph* pg, const std::string& edge_rating_property_name) {
+  if (pg->GetEdgeProperty(edge_rating_property_name)->null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "edge ratings may not be null");
+  }
+  auto graph = KATANA_CHECKED(
+      RatingGraph<Rating>::Make(pg, {}, {edge_rating_property_name}));
+
+  katana::NUMAArray<float> ratings;
+  ratings.allocateInterleaved(graph.num_edges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_edges()),
+      [&](uint64_t e) {
+        ratings[e] = graph.template GetEdgeData<EdgeRating<Rating>>(e);
+      },
+      katana::no_stats());
+  return ratings;
+}
+
+/// \returns the dot product of the padded latent vectors a and b
+float
+Dot(const float* __restrict__ a, const float* __restrict__ b,
+    uint32_t stride) {
+  // independent sums per lane, so the loop vectorizes without reassociating
+  // floating point additions
+  float lanes[kLanes] = {};
+  for (uint32_t i = 0; i < stride; i += kLanes) {
+    for (uint32_t j = 0; j < kLanes; ++j) {
+      lanes[j] += a[i + j] * b[i + j];
+    }
+  }
+  float sum = 0;
+  for (uint32_t j = 0; j < kLanes; ++j) {
+    sum += lanes[j];
+  }
+  return sum;
+}
+
+/// \returns a hash of x, spread over all 64 bits
+uint64_t
+Mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+/// The latent vectors of the nodes of a graph, each padded to a multiple of
+/// kLanes floats
+class LatentVectors {
+public:
+  LatentVectors(size_t num_nodes, uint32_t size)
+      : size_(size), stride_((size + kLanes - 1) / kLanes * kLanes) {
+    values_.allocateInterleaved(num_nodes * stride_);
+  }
+
+  uint32_t size() const { return size_; }
+  uint32_t stride() const { return stride_; }
+
+  float* operator[](Node n) { return &values_[size_t{n} * stride_]; }
+  const float* operator[](Node n) const {
+    return &values_[size_t{n} * stride_];
+  }
+
+  /// Set every vector to values drawn from [0, 1 / sqrt(size)) by a hash of
+  /// the node and the index in the vector, the same on any thread count
+  void Initialize(size_t num_nodes) {
+    const float scale = 1 / std::sqrt(static_cast<float>(size_)) / 0x1p24f;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          float* v = (*this)[n];
+          for (uint32_t i = 0; i < stride_; ++i) {
+            v[i] = i < size_ ? (Mix(n * stride_ + i) >> 40) * scale : 0;
+          }
+        },
+        katana::no_stats());
+  }
+
+private:
+  uint32_t size_;
+  uint32_t stride_;
+  katana::NUMAArray<float> values_;
+};
+
+/// The normal equations of the least squares problem of a node
+struct NormalEquations {
+  std::vector<double> lhs;
+  std::vector<double> rhs;
+};
+
+/// Solve lhs x = rhs, for a symmetric positive definite lhs of size k of
+/// which the lower triangle is filled, by Cholesky decomposition. lhs is
+/// overwritten with its factor and rhs with x. \returns false if lhs is not
+/// positive definite.
+bool
+CholeskySolve(uint32_t k, double* lhs, double* rhs) {
+  for (uint32_t j = 0; j < k; ++j) {
+    double d = lhs[j * k + j];
+    for (uint32_t p = 0; p < j; ++p) {
+      d -= lhs[j * k + p] * lhs[j * k + p];
+    }
+    if (!(d > 0)) {
+      return false;
+    }
+    d = std::sqrt(d);
+    lhs[j * k + j] = d;
+    for (uint32_t i = j + 1; i < k; ++i) {
+      double s = lhs[i * k + j];
+      for (uint32_t p = 0; p < j; ++p) {
+        s -= lhs[i * k + p] * lhs[j * k + p];
+      }
+      lhs[i * k + j] = s / d;
+    }
+  }
+  for (uint32_t i = 0; i < k; ++i) {
+    double s = rhs[i];
+    for (uint32_t p = 0; p < i; ++p) {
+      s -= lhs[i * k + p] * rhs[p];
+    }
+    rhs[i] = s / lhs[i * k + i];
+  }
+  for (uint32_t i = k; i-- > 0;) {
+    double s = rhs[i];
+    for (uint32_t p = i + 1; p < k; ++p) {
+      s -= lhs[p * k + i] * rhs[p];
+    }
+    rhs[i] = s / lhs[i * k + i];
+  }
+  return true;
+}
+
+class Factorizer {
+public:
+  Factorizer(
+      BiDirView view, katana::NUMAArray<float> ratings,
+      const MatrixCompletionPlan& plan)
+      : view_(std::move(view)),
+        ratings_(std::move(ratings)),
+        plan_(plan),
+        vectors_(view_.num_nodes(), plan.latent_vector_size()) {
+    vectors_.Initialize(view_.num_nodes());
+  }
+
+  const LatentVectors& vectors() const { return vectors_; }
+
+  void Run() {
+    double error = RootMeanSquaredError();
+    for (uint32_t round = 0; round < plan_.max_rounds(); ++round) {
+      if (plan_.algorithm() == MatrixCompletionPlan::kSgd) {
+        SgdRound(round);
+      } else {
+        AlsRound();
+      }
+      double next_error = RootMeanSquaredError();
+      if (!std::isfinite(next_error) ||
+          error - next_error < plan_.tolerance() * error) {
+        break;
+      }
+      error = next_error;
+    }
+  }
+
+  double RootMeanSquaredError() const {
+    if (view_.num_edges() == 0) {
+      return 0;
+    }
+    katana::GAccumulator<double> squared_error;
+    katana::do_all(
+        katana::iterate(size_t{0}, view_.num_nodes()),
+        [&](Node n) {
+          double sum = 0;
+          for (auto e : view_.edges(n)) {
+            double error =
+                Dot(vectors_[n], vectors_[view_.edge_dest(e)],
+                    vectors_.stride()) -
+                ratings_[view_.edge_property_index(e)];
+            sum += error * error;
+          }
+          squared_error += sum;
+        },
+        katana::steal(), katana::no_stats());
+    return std::sqrt(squared_error.reduce() / view_.num_edges());
+  }
+
+private:
+  /// Take a gradient step for every rating. Threads update the vectors of
+  /// the items of their users without synchronization (Hogwild): with few
+  /// ratings per item, concurrent updates of a vector are rare and a lost
+  /// update slows convergence only a little.
+  void SgdRound(uint32_t round) {
+    const float step = plan_.learning_rate() * 1.5 /
+                       (1 + plan_.decay_rate() * std::pow(round + 1, 1.5));
+    const float lambda = plan_.lambda();
+    const uint32_t stride = vectors_.stride();
+    katana::do_all(
+        katana::iterate(size_t{0}, view_.num_nodes()),
+        [&](Node n) {
+          float* __restrict__ user = vectors_[n];
+          for (auto e : view_.edges(n)) {
+            float* __restrict__ item = vectors_[view_.edge_dest(e)];
+            float error = Dot(user, item, stride) -
+                          ratings_[view_.edge_property_index(e)];
+            for (uint32_t i = 0; i < stride; ++i) {
+              float u = user[i];
+              float v = item[i];
+              user[i] = u - step * (error * v + lambda * u);
+              item[i] = v - step * (error * u + lambda * v);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<16>(),
+        katana::loopname("MatrixCompletionSgd"));
+  }
+
+  /// Solve for the vectors of the users and then for those of the items
+  void AlsRound() {
+    SolveSide(
+        [&](Node n) { return view_.degree(n); },
+        [&](Node n, const auto& fn) {
+          for (auto e : view_.edges(n)) {
+            fn(view_.edge_dest(e), ratings_[view_.edge_property_index(e)]);
+          }
+        },
+        "MatrixCompletionAlsUsers");
+    SolveSide(
+        [&](Node n) { return view_.in_degree(n); },
+        [&](Node n, const auto& fn) {
+          for (auto e : view_.in_edges(n)) {
+            fn(view_.in_edge_dest(e),
+               ratings_[view_.in_edge_property_index(e)]);
+          }
+        },
+        "MatrixCompletionAlsItems");
+  }
+
+  /// Set the vector x of every node n with ratings r_i of nodes with
+  /// vectors v_i to the minimizer of sum_i (x . v_i - r_i)^2 + lambda |x|^2,
+  /// which solves (sum_i v_i v_i^T + lambda I) x = sum_i r_i v_i. The nodes
+  /// rated only read the vectors of the other side, so all nodes of a side
+  /// are solved in parallel.
+  template <typename Degree, typename ForEachRating>
+  void SolveSide(
+      const Degree& degree, const ForEachRating& for_each_rating,
+      const char* loopname) {
+    const uint32_t k = vectors_.size();
+    katana::PerThreadStorage<NormalEquations> equations;
+    katana::do_all(
+        katana::iterate(size_t{0}, view_.num_nodes()),
+        [&](Node n) {
+          if (degree(n) == 0) {
+            return;
+          }
+          NormalEquations& eq = *equations.getLocal();
+          eq.lhs.assign(size_t{k} * k, 0);
+          eq.rhs.assign(k, 0);
+          for_each_rating(n, [&](Node m, float rating) {
+            const float* v = vectors_[m];
+            for (uint32_t i = 0; i < k; ++i) {
+              double* row = &eq.lhs[size_t{i} * k];
+              for (uint32_t j = 0; j <= i; ++j) {
+                row[j] += double{v[i]} * v[j];
+              }
+              eq.rhs[i] += double{rating} * v[i];
+            }
+          });
+          for (uint32_t i = 0; i < k; ++i) {
+            eq.lhs[size_t{i} * k + i] += plan_.lambda();
+          }
+          if (!CholeskySolve(k, eq.lhs.data(), eq.rhs.data())) {
+            return;
+          }
+          float* x = vectors_[n];
+          for (uint32_t i = 0; i < k; ++i) {
+            x[i] = eq.rhs[i];
+          }
+        },
+        katana::steal(), katana::loopname(loopname));
+  }
+
+  BiDirView view_;
+  /// The ratings by edge property index
+  katana::NUMAArray<float> ratings_;
+  MatrixCompletionPlan plan_;
+  LatentVectors vectors_;
+};
+
+/// \returns a table with one column of the latent vectors as fixed size
+/// lists of floats
+katana::Result<std::shared_ptr<arrow::Table>>
+MakeVectorsTable(
+    const LatentVectors& vectors, size_t num_nodes, const std::string& name) {
+  const uint32_t k = vectors.size();
+  auto buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer(num_nodes * k * sizeof(float)));
+  float* out = reinterpret_cast<float*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        std::memcpy(&out[n * k], vectors[n], k * sizeof(float));
+      },
+      katana::no_stats());
+
+  auto values = std::make_shared<arrow::FloatArray>(
+      num_nodes * k, std::shared_ptr<arrow::Buffer>(std::move(buffer)));
+  auto array = KATANA_CHECKED(arrow::FixedSizeListArray::FromArrays(values, k));
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, array->type())}), {array});
+}
+
+/// \returns the latent vectors of the property named property_name
+katana::Result<std::shared_ptr<arrow::FixedSizeListArray>>
+GetVectors(katana::PropertyGraph* pg, const std::string& property_name) {
+  auto property = pg->GetNodeProperty(property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no node property {}",
+        property_name);
+  }
+  if (property->num_chunks() != 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "property {} has {} chunks, expected 1", property_name,
+        property->num_chunks());
+  }
+  auto array =
+      std::dynamic_pointer_cast<arrow::FixedSizeListArray>(property->chunk(0));
+  if (!array || array->value_type()->id() != arrow::FloatType::type_id) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "property {} is not a fixed size list of floats", property_name);
+  }
+  return array;
+}
+
+/// \returns the latent vector of node n
+const float*
+VectorOf(const arrow::FixedSizeListArray& array, Node n) {
+  return std::static_pointer_cast<arrow::FloatArray>(array.values())
+             ->raw_values() +
+         array.value_offset(n);
+}
+
+template <typename Rating>
+katana::Result<MatrixCompletionStatistics>
+ComputeStatistics(
+    katana::PropertyGraph* pg, const std::string& edge_rating_property_name,
+    const std::string& property_name) {
+  auto ratings =
+      KATANA_CHECKED(ReadRatings<Rating>(pg, edge_rating_property_name));
+  auto array = KATANA_CHECKED(GetVectors(pg, property_name));
+  const uint32_t k = array->list_type()->list_size();
+
+  auto view = pg->BuildView<BiDirView>();
+  katana::GAccumulator<double> squared_error;
+  katana::do_all(
+      katana::iterate(size_t{0}, view.num_nodes()),
+      [&](Node n) {
+        const float* user = VectorOf(*array, n);
+        for (auto e : view.edges(n)) {
+          const float* item = VectorOf(*array, view.edge_dest(e));
+          double prediction = 0;
+          for (uint32_t i = 0; i < k; ++i) {
+            prediction += double{user[i]} * item[i];
+          }
+          double error = prediction - ratings[view.edge_property_index(e)];
+          squared_error += error * error;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  double root_mean_squared_error = 0;
+  if (view.num_edges() > 0) {
+    root_mean_squared_error =
+        std::sqrt(squared_error.reduce() / view.num_edges());
+  }
+  return MatrixCompletionStatistics{root_mean_squared_error, k};
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MatrixCompletion(
+    PropertyGraph* pg, const std::string& edge_rating_property_name,
+    const std::string& output_property_name, MatrixCompletionPlan plan) {
+  if (plan.algorithm() != MatrixCompletionPlan::kSgd &&
+      plan.algorithm() != MatrixCompletionPlan::kAls) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  if (plan.latent_vector_size() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the latent vector size must be positive");
+  }
+  if (!(plan.lambda() >= 0) ||
+      (plan.algorithm() == MatrixCompletionPlan::kAls && plan.lambda() == 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "lambda must be non-negative, and positive for ALS");
+  }
+
+  auto ratings = KATANA_CHECKED(VisitRatingType(
+      pg, edge_rating_property_name,
+      [&](auto rating) -> katana::Result<katana::NUMAArray<float>> {
+        return ReadRatings<decltype(rating)>(pg, edge_rating_property_name);
+      }));
+
+  auto view = pg->BuildView<BiDirView>();
+  katana::GReduceLogicalOr not_bipartite;
+  katana::do_all(
+      katana::iterate(size_t{0}, view.num_nodes()),
+      [&](Node n) {
+        if (view.degree(n) > 0 && view.in_degree(n) > 0) {
+          not_bipartite.update(true);
+        }
+      },
+      katana::no_stats());
+  if (not_bipartite.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "some node both rates and is rated; every edge must go from a user "
+        "to an item");
+  }
+
+  katana::StatTimer exec_time("MatrixCompletion");
+  exec_time.start();
+  Factorizer factorizer(std::move(view), std::move(ratings), plan);
+  factorizer.Run();
+  exec_time.stop();
+
+  auto table = KATANA_CHECKED(MakeVectorsTable(
+      factorizer.vectors(), pg->num_nodes(), output_property_name));
+  return pg->AddNodeProperties(table);
+}
+
+katana::Result<void>
+katana::analytics::MatrixCompletionAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto array = KATANA_CHECKED(GetVectors(pg, property_name));
+  if (static_cast<uint64_t>(array->length()) != pg->num_nodes() ||
+      array->null_count() > 0 || array->values()->null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "some node has no latent vector");
+  }
+
+  const uint32_t k = array->list_type()->list_size();
+  katana::GReduceLogicalOr not_finite;
+  katana::do_all(
+      katana::iterate(size_t{0}, pg->num_nodes()),
+      [&](Node n) {
+        const float* v = VectorOf(*array, n);
+        for (uint32_t i = 0; i < k; ++i) {
+          if (!std::isfinite(v[i])) {
+            not_finite.update(true);
+          }
+        }
+      },
+      katana::no_stats());
+  if (not_finite.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "some latent vector is not finite");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<MatrixCompletionStatistics>
+katana::analytics::MatrixCompletionStatistics::Compute(
+    PropertyGraph* pg, const std::string& edge_rating_property_name,
+    const std::string& property_name) {
+  return VisitRatingType(
+      pg, edge_rating_property_name,
+      [&](auto rating) -> Result<MatrixCompletionStatistics> {
+        return ComputeStatistics<decltype(rating)>(
+            pg, edge_rating_property_name, property_name);
+      });
+}
+
+void
+katana::analytics::MatrixCompletionStatistics::Print(std::ostream& os) const {
+  os << "Root mean squared error = " << root_mean_squared_error << std::endl;
+  os << "Latent vector size = " << latent_vector_size << std::endl;
+}
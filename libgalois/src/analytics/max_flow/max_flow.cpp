@@ -0,0 +1,819 @@
+#include "katana/analytics/max_flow/max_flow.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using Node = BiDirView::Node;
+
+template <typename Capacity>
+struct EdgeCapacity : public katana::PODProperty<Capacity> {};
+
+template <typename Capacity>
+struct EdgeFlow : public katana::PODProperty<Capacity> {};
+
+/// The work of discharging a node and the extra work of relabeling it, which
+/// are counted against the global relabel interval
+constexpr uint64_t kDischargeWork = 1;
+constexpr uint64_t kRelabelWork = 12;
+
+/// The default global relabel interval is kAlpha times the number of nodes
+/// plus a third of the number of residual arcs, as in the preflowpush app
+constexpr uint64_t kAlpha = 6;
+
+/// An item of the discharge loop: a node to discharge if wave is 0, and
+/// otherwise a node to expand in the search of that global relabel wave
+struct FlowWork {
+  Node node;
+  uint32_t wave;
+};
+
+struct FlowNode : public katana::Lockable {
+  int64_t excess{0};
+  /// The next arc to try to push along
+  uint64_t current{0};
+  std::atomic<uint32_t> height{0};
+  /// The last global relabel wave in which an arc out of this node gained
+  /// residual capacity
+  std::atomic<uint32_t> pushed_in_wave{0};
+  /// The distance to the target found by a global relabel wave in the low
+  /// half and the number of that wave in the high half
+  std::atomic<uint64_t> wave_distance{0};
+};
+
+/// The residual network of a graph with a preflow on it. Every edge (u, v)
+/// makes a pair of twin arcs, one of u to v holding the capacity left and
+/// one of v to u holding the flow along the edge. The arcs of a node are
+/// contiguous, those of its out-edges first.
+///
+/// The preflow is found in two phases, which push excess toward a target:
+/// first the sink, then back to the source for the excess that cannot reach
+/// the sink. The other terminal of a phase is excluded: it is never pushed
+/// to nor relabeled. Heights range up to the number of nodes, at which a
+/// node is cut off from the target.
+class PreflowPush {
+public:
+  template <typename CapacityFn>
+  PreflowPush(
+      BiDirView view, Node source, Node sink, uint64_t global_relabel_interval,
+      const CapacityFn& capacity)
+      : view_(std::move(view)),
+        num_nodes_(view_.num_nodes()),
+        source_(source),
+        sink_(sink),
+        global_relabel_interval_(global_relabel_interval) {
+    const uint64_t num_edges = view_.num_edges();
+
+    arc_begin_.allocateBlocked(num_nodes_ + 1);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          arc_begin_[n] = *view_.edges(n).begin() + *view_.in_edges(n).begin();
+        },
+        katana::no_stats());
+    arc_begin_[num_nodes_] = 2 * num_edges;
+
+    katana::NUMAArray<uint64_t> in_edge_of_property;
+    in_edge_of_property.allocateInterleaved(num_edges);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          for (auto e : view_.in_edges(n)) {
+            in_edge_of_property[view_.in_edge_property_index(e)] = e;
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    // Each out-edge fills in both of its arcs
+    arc_dest_.allocateBlocked(2 * num_edges);
+    arc_twin_.allocateBlocked(2 * num_edges);
+    residual_.allocateBlocked(2 * num_edges);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          uint64_t arc = arc_begin_[n];
+          for (auto e : view_.edges(n)) {
+            Node dest = view_.edge_dest(e);
+            auto property_index = view_.edge_property_index(e);
+            uint64_t twin = arc_begin_[dest] + view_.degree(dest) +
+                            in_edge_of_property[property_index] -
+                            *view_.in_edges(dest).begin();
+            arc_dest_[arc] = dest;
+            arc_twin_[arc] = twin;
+            residual_.constructAt(arc, capacity(property_index));
+            arc_dest_[twin] = n;
+            arc_twin_[twin] = arc;
+            residual_.constructAt(twin, 0);
+            ++arc;
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    nodes_.allocateBlocked(num_nodes_);
+    height_counts_.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          nodes_.constructAt(n);
+          height_counts_.constructAt(n, 0);
+        },
+        katana::no_stats());
+  }
+
+  void Run() {
+    ResetHeights();
+    SetHeight(source_, num_nodes_);
+    for (uint64_t arc = arc_begin_[source_]; arc < arc_begin_[source_ + 1];
+         ++arc) {
+      int64_t residual = residual_[arc].load(std::memory_order_relaxed);
+      if (residual > 0 && arc_dest_[arc] != source_) {
+        Push(source_, arc, residual);
+      }
+    }
+    Drain(sink_, source_);
+
+    ResetHeights();
+    Drain(source_, sink_);
+  }
+
+  /// Call fn with the property index and the flow of every edge
+  template <typename F>
+  void ForEachEdgeFlow(const F& fn) const {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          uint64_t arc = arc_begin_[n];
+          for (auto e : view_.edges(n)) {
+            fn(view_.edge_property_index(e),
+               residual_[arc_twin_[arc]].load(std::memory_order_relaxed));
+            ++arc;
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+private:
+  uint32_t Height(Node n) const {
+    return nodes_[n].height.load(std::memory_order_relaxed);
+  }
+
+  void SetHeight(Node n, uint32_t height) {
+    nodes_[n].height.store(height, std::memory_order_relaxed);
+  }
+
+  static uint64_t WaveDistance(uint32_t wave, uint32_t distance) {
+    return (uint64_t{wave} << 32) | distance;
+  }
+
+  void ResetHeights() {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          SetHeight(n, 0);
+          nodes_[n].current = arc_begin_[n];
+        },
+        katana::no_stats());
+  }
+
+  /// Move amount of the excess of n along arc. The new residual capacity of
+  /// the twin arc is published before the wave is read, so that a search
+  /// that started before the push either sees it or the dest is stamped.
+  void Push(Node n, uint64_t arc, int64_t amount) {
+    FlowNode& dest = nodes_[arc_dest_[arc]];
+    auto& residual = residual_[arc];
+    auto& twin_residual = residual_[arc_twin_[arc]];
+    residual.store(
+        residual.load(std::memory_order_relaxed) - amount,
+        std::memory_order_relaxed);
+    twin_residual.store(twin_residual.load(std::memory_order_relaxed) + amount);
+    dest.pushed_in_wave.store(wave_.load());
+    nodes_[n].excess -= amount;
+    dest.excess += amount;
+  }
+
+  /// Lift n to one above its lowest neighbor along a residual arc, or to the
+  /// number of nodes if there is none that low
+  void Relabel(Node n, Node excluded) {
+    uint32_t lowest = num_nodes_;
+    uint64_t lowest_arc = arc_begin_[n];
+    for (uint64_t arc = arc_begin_[n]; arc < arc_begin_[n + 1]; ++arc) {
+      Node dest = arc_dest_[arc];
+      if (dest == excluded ||
+          residual_[arc].load(std::memory_order_relaxed) == 0) {
+        continue;
+      }
+      if (Height(dest) < lowest) {
+        lowest = Height(dest);
+        lowest_arc = arc;
+      }
+    }
+    SetHeight(n, std::min<uint64_t>(uint64_t{lowest} + 1, num_nodes_));
+    nodes_[n].current = lowest_arc;
+  }
+
+  /// Push the excess of n to its neighbors one lower, relabeling n when there
+  /// are none, until it has no excess or is cut off from the target. Like the
+  /// preflowpush app, this is a cautious operator: it locks n and all of its
+  /// neighbors before changing any of them. \returns the work done
+  template <typename Context>
+  uint64_t Discharge(Node n, Node target, Node excluded, Context& ctx) {
+    katana::acquire(&nodes_[n], katana::MethodFlag::WRITE);
+    for (uint64_t arc = arc_begin_[n]; arc < arc_begin_[n + 1]; ++arc) {
+      katana::acquire(&nodes_[arc_dest_[arc]], katana::MethodFlag::WRITE);
+    }
+
+    FlowNode& node = nodes_[n];
+    uint64_t work = kDischargeWork;
+    while (node.excess > 0 && Height(n) < num_nodes_) {
+      for (; node.current < arc_begin_[n + 1]; ++node.current) {
+        uint64_t arc = node.current;
+        Node dest = arc_dest_[arc];
+        int64_t residual = residual_[arc].load(std::memory_order_relaxed);
+        if (dest == excluded || residual == 0 ||
+            Height(n) != Height(dest) + 1) {
+          continue;
+        }
+        if (dest != target && nodes_[dest].excess == 0) {
+          ctx.push(FlowWork{dest, 0});
+        }
+        Push(n, arc, std::min(node.excess, residual));
+        if (node.excess == 0) {
+          return work;
+        }
+      }
+      Relabel(n, excluded);
+      work += kRelabelWork;
+    }
+    return work;
+  }
+
+  /// Start a global relabel wave with a search from target, unless one is
+  /// already running
+  template <typename Context>
+  void StartWave(Node target, Context& ctx) {
+    bool running = false;
+    if (!wave_running_.compare_exchange_strong(running, true)) {
+      return;
+    }
+    uint32_t wave = wave_.fetch_add(1) + 1;
+    nodes_[target].wave_distance.store(
+        WaveDistance(wave, 0), std::memory_order_relaxed);
+    pending_expansions_.store(1);
+    ctx.push(FlowWork{target, wave});
+  }
+
+  /// Give the nodes with a residual arc to item.node a distance one more
+  /// than its own in the wave, if that is shorter than the one they have.
+  /// The search does not lock: the residual capacities it reads may change
+  /// under it, which ApplyWave corrects for.
+  template <typename Context>
+  void Expand(const FlowWork& item, Node target, Node excluded, Context& ctx) {
+    uint64_t distance = static_cast<uint32_t>(
+        nodes_[item.node].wave_distance.load(std::memory_order_relaxed));
+    if (distance + 1 < num_nodes_) {
+      uint64_t next = WaveDistance(item.wave, distance + 1);
+      for (uint64_t arc = arc_begin_[item.node];
+           arc < arc_begin_[item.node + 1]; ++arc) {
+        Node dest = arc_dest_[arc];
+        if (dest == target || dest == excluded ||
+            residual_[arc_twin_[arc]].load() == 0) {
+          continue;
+        }
+        auto& wave_distance = nodes_[dest].wave_distance;
+        uint64_t old = wave_distance.load(std::memory_order_relaxed);
+        while ((old >> 32) != item.wave || old > next) {
+          if (wave_distance.compare_exchange_weak(
+                  old, next, std::memory_order_relaxed)) {
+            pending_expansions_.fetch_add(1);
+            ctx.push(FlowWork{dest, item.wave});
+            break;
+          }
+        }
+      }
+    }
+    if (pending_expansions_.fetch_sub(1) == 1) {
+      wave_done_ = true;
+      ctx.breakLoop();
+    }
+  }
+
+  /// Raise the heights to the distances found by the last wave, with the
+  /// number of nodes for the nodes it did not reach.
+  ///
+  /// The distances are consistent along the arcs whose residual capacity did
+  /// not grow during the wave, and the heights along all arcs, so the larger
+  /// of each pair is consistent along the former. The arcs that gained
+  /// capacity start at nodes stamped with the wave; their heights are
+  /// lowered until they are consistent again, which never lowers them below
+  /// where they were before the wave.
+  void ApplyWave(Node target, Node excluded) {
+    const uint32_t wave = wave_.load();
+    katana::InsertBag<Node> pushed;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          if (n == target || n == excluded) {
+            return;
+          }
+          FlowNode& node = nodes_[n];
+          uint64_t wave_distance =
+              node.wave_distance.load(std::memory_order_relaxed);
+          uint32_t distance = (wave_distance >> 32) == wave
+                                  ? static_cast<uint32_t>(wave_distance)
+                                  : num_nodes_;
+          if (distance > Height(n)) {
+            SetHeight(n, distance);
+          }
+          node.current = arc_begin_[n];
+          if (node.pushed_in_wave.load(std::memory_order_relaxed) == wave) {
+            pushed.push(n);
+          }
+        },
+        katana::loopname("MaxFlowRaiseHeights"));
+
+    katana::for_each(
+        katana::iterate(pushed),
+        [&](Node n, auto& ctx) {
+          uint32_t lowest = num_nodes_;
+          for (uint64_t arc = arc_begin_[n]; arc < arc_begin_[n + 1]; ++arc) {
+            Node dest = arc_dest_[arc];
+            if (dest != excluded &&
+                residual_[arc].load(std::memory_order_relaxed) > 0) {
+              lowest = std::min(lowest, Height(dest) + 1);
+            }
+          }
+          uint32_t height = Height(n);
+          do {
+            if (lowest >= height) {
+              return;
+            }
+          } while (!nodes_[n].height.compare_exchange_weak(
+              height, lowest, std::memory_order_relaxed));
+          for (uint64_t arc = arc_begin_[n]; arc < arc_begin_[n + 1]; ++arc) {
+            Node dest = arc_dest_[arc];
+            if (dest != target && dest != excluded &&
+                residual_[arc_twin_[arc]].load(std::memory_order_relaxed) >
+                    0) {
+              ctx.push(dest);
+            }
+          }
+        },
+        katana::disable_conflict_detection(),
+        katana::loopname("MaxFlowLowerHeights"));
+
+    LiftGaps(target, excluded);
+  }
+
+  /// Gap heuristic: no residual path to the target can climb over a height
+  /// that no node has, so the nodes above the lowest such gap are cut off
+  void LiftGaps(Node target, Node excluded) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t height) {
+          height_counts_[height].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          if (n != excluded && Height(n) < num_nodes_) {
+            height_counts_[Height(n)].fetch_add(1, std::memory_order_relaxed);
+          }
+        },
+        katana::no_stats());
+
+    katana::GReduceMin<uint32_t> lowest_gap;
+    katana::do_all(
+        katana::iterate(uint64_t{1}, num_nodes_),
+        [&](uint64_t height) {
+          if (height_counts_[height].load(std::memory_order_relaxed) == 0) {
+            lowest_gap.update(height);
+          }
+        },
+        katana::no_stats());
+    uint32_t gap = lowest_gap.reduce();
+    if (gap >= num_nodes_) {
+      return;
+    }
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          if (n != target && n != excluded && Height(n) > gap &&
+              Height(n) < num_nodes_) {
+            SetHeight(n, num_nodes_);
+          }
+        },
+        katana::loopname("MaxFlowLiftGaps"));
+  }
+
+  void FindActive(
+      Node target, Node excluded, katana::InsertBag<FlowWork>* active) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          if (n != target && n != excluded && nodes_[n].excess > 0 &&
+              Height(n) < num_nodes_) {
+            active->push(FlowWork{n, 0});
+          }
+        },
+        katana::loopname("MaxFlowFindActive"));
+  }
+
+  /// Discharge the active nodes until none is left. Global relabel waves run
+  /// in the same loop; when one finishes, the loop stops to apply it and
+  /// starts again from the nodes that are still active.
+  void Drain(Node target, Node excluded) {
+    katana::InsertBag<FlowWork> active;
+    FindActive(target, excluded, &active);
+    // The first wave of a phase starts right away
+    uint64_t work_per_thread = 0;
+    while (!active.empty()) {
+      katana::GAccumulator<uint64_t> work;
+      wave_running_ = false;
+      wave_done_ = false;
+      katana::for_each(
+          katana::iterate(active),
+          [&](const FlowWork& item, auto& ctx) {
+            if (item.wave != 0) {
+              Expand(item, target, excluded, ctx);
+              return;
+            }
+            work += Discharge(item.node, target, excluded, ctx);
+            if (!wave_running_.load(std::memory_order_relaxed) &&
+                work.getLocal() >= work_per_thread) {
+              StartWave(target, ctx);
+            }
+          },
+          katana::parallel_break(),
+          katana::wl<katana::PerSocketChunkFIFO<16>>(),
+          katana::loopname("MaxFlowDischarge"));
+      work_per_thread = global_relabel_interval_ / katana::getActiveThreads();
+
+      active.clear();
+      if (wave_done_) {
+        ApplyWave(target, excluded);
+      }
+      FindActive(target, excluded, &active);
+    }
+  }
+
+  BiDirView view_;
+  uint64_t num_nodes_;
+  Node source_;
+  Node sink_;
+  uint64_t global_relabel_interval_;
+
+  katana::NUMAArray<uint64_t> arc_begin_;
+  katana::NUMAArray<Node> arc_dest_;
+  katana::NUMAArray<uint64_t> arc_twin_;
+  katana::NUMAArray<std::atomic<int64_t>> residual_;
+  katana::NUMAArray<FlowNode> nodes_;
+  katana::NUMAArray<std::atomic<uint32_t>> height_counts_;
+
+  std::atomic<uint32_t> wave_{0};
+  std::atomic<bool> wave_running_{false};
+  std::atomic<bool> wave_done_{false};
+  std::atomic<uint64_t> pending_expansions_{0};
+};
+
+/// Call fn with a value of the type of the edge capacities
+template <typename F>
+std::invoke_result_t<F, uint32_t>
+VisitCapacityType(
+    katana::PropertyGraph* pg, const std::string& edge_capacity_property_name,
+    F fn) {
+  auto property = pg->GetEdgeProperty(edge_capacity_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_capacity_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return fn(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return fn(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return fn(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return fn(int64_t{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported edge capacity type {}",
+        property->type()->ToString());
+  }
+}
+
+katana::Result<void>
+CheckTerminals(katana::PropertyGraph* pg, size_t source, size_t sink) {
+  if (source >= pg->num_nodes() || sink >= pg->num_nodes() || source == sink) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} and sink {} must be distinct nodes", source, sink);
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename Capacity>
+using CapacityGraph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<EdgeCapacity<Capacity>>>;
+
+template <typename Capacity>
+using FlowGraph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<EdgeCapacity<Capacity>, EdgeFlow<Capacity>>>;
+
+template <typename Capacity>
+katana::Result<void>
+CheckCapacities(
+    katana::PropertyGraph* pg, size_t source,
+    const std::string& edge_capacity_property_name) {
+  if (pg->GetEdgeProperty(edge_capacity_property_name)->null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "edge capacities may not be null");
+  }
+  auto graph = KATANA_CHECKED(
+      CapacityGraph<Capacity>::Make(pg, {}, {edge_capacity_property_name}));
+
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_edges()),
+      [&](uint64_t e) {
+        Capacity capacity =
+            graph.template GetEdgeData<EdgeCapacity<Capacity>>(e);
+        if constexpr (std::is_signed_v<Capacity>) {
+          if (capacity < 0) {
+            out_of_range.update(true);
+          }
+        } else if constexpr (sizeof(Capacity) == sizeof(int64_t)) {
+          if (capacity > uint64_t{std::numeric_limits<int64_t>::max()}) {
+            out_of_range.update(true);
+          }
+        }
+      },
+      katana::no_stats());
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge capacities must be non-negative int64_t values");
+  }
+
+  int64_t source_capacity = 0;
+  for (auto e : graph.edges(source)) {
+    if (__builtin_add_overflow(
+            source_capacity,
+            graph.template GetEdgeData<EdgeCapacity<Capacity>>(e),
+            &source_capacity)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "the capacity out of the source does not fit in an int64_t");
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename Capacity>
+katana::Result<void>
+MaxFlowImpl(
+    katana::PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& edge_capacity_property_name,
+    const std::string& output_property_name, MaxFlowPlan plan) {
+  static_assert(std::is_integral_v<Capacity>);
+  if (plan.algorithm() != MaxFlowPlan::kPreflowPush) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  KATANA_CHECKED(CheckTerminals(pg, source, sink));
+  KATANA_CHECKED(
+      CheckCapacities<Capacity>(pg, source, edge_capacity_property_name));
+
+  KATANA_CHECKED(ConstructEdgeProperties<std::tuple<EdgeFlow<Capacity>>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED((FlowGraph<Capacity>::Make(
+      pg, {}, {edge_capacity_property_name, output_property_name})));
+
+  uint64_t global_relabel_interval = plan.global_relabel_interval();
+  if (global_relabel_interval == MaxFlowPlan::kDefaultGlobalRelabelInterval) {
+    global_relabel_interval =
+        kAlpha * pg->num_nodes() + 2 * pg->num_edges() / 3;
+  }
+
+  katana::StatTimer exec_time("MaxFlow");
+  exec_time.start();
+
+  PreflowPush preflow_push(
+      pg->BuildView<BiDirView>(), source, sink, global_relabel_interval,
+      [&](uint64_t e) -> int64_t {
+        return graph.template GetEdgeData<EdgeCapacity<Capacity>>(e);
+      });
+  preflow_push.Run();
+
+  exec_time.stop();
+
+  preflow_push.ForEachEdgeFlow([&](uint64_t e, int64_t flow) {
+    graph.template GetEdgeData<EdgeFlow<Capacity>>(e) = flow;
+  });
+
+  return katana::ResultSuccess();
+}
+
+/// Mark the nodes that can be reached from source along edges with residual
+/// capacity: forward along edges with less flow than capacity, and backward
+/// along edges with flow
+template <typename Capacity>
+std::vector<uint8_t>
+ReachableFromSource(
+    katana::PropertyGraph* pg, const FlowGraph<Capacity>& graph,
+    size_t source) {
+  auto view = pg->BuildView<BiDirView>();
+  auto flow = [&](uint64_t e) {
+    return graph.template GetEdgeData<EdgeFlow<Capacity>>(e);
+  };
+
+  std::vector<uint8_t> reached(view.num_nodes());
+  std::vector<Node> queue{static_cast<Node>(source)};
+  reached[source] = 1;
+  for (size_t i = 0; i < queue.size(); ++i) {
+    Node n = queue[i];
+    for (auto e : view.edges(n)) {
+      auto property_index = view.edge_property_index(e);
+      Node dest = view.edge_dest(e);
+      if (!reached[dest] &&
+          flow(property_index) <
+              graph.template GetEdgeData<EdgeCapacity<Capacity>>(
+                  property_index)) {
+        reached[dest] = 1;
+        queue.push_back(dest);
+      }
+    }
+    for (auto e : view.in_edges(n)) {
+      Node dest = view.in_edge_dest(e);
+      if (!reached[dest] && flow(view.in_edge_property_index(e)) > 0) {
+        reached[dest] = 1;
+        queue.push_back(dest);
+      }
+    }
+  }
+  return reached;
+}
+
+template <typename Capacity>
+katana::Result<void>
+MaxFlowAssertValidImpl(
+    katana::PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& edge_capacity_property_name,
+    const std::string& property_name) {
+  KATANA_CHECKED(CheckTerminals(pg, source, sink));
+  auto graph = KATANA_CHECKED((FlowGraph<Capacity>::Make(
+      pg, {}, {edge_capacity_property_name, property_name})));
+
+  // the flow must be within the capacities
+  katana::NUMAArray<std::atomic<int64_t>> net_inflow;
+  net_inflow.allocateBlocked(graph.num_nodes());
+  katana::do_all(
+      katana::iterate(size_t{0}, graph.num_nodes()),
+      [&](size_t n) { net_inflow.constructAt(n, 0); }, katana::no_stats());
+  katana::GReduceLogicalOr over_capacity;
+  katana::do_all(
+      katana::iterate(size_t{0}, graph.num_nodes()),
+      [&](size_t n) {
+        for (auto e : graph.edges(n)) {
+          Capacity flow = graph.template GetEdgeData<EdgeFlow<Capacity>>(e);
+          if (flow > graph.template GetEdgeData<EdgeCapacity<Capacity>>(e)) {
+            over_capacity.update(true);
+          }
+          if constexpr (std::is_signed_v<Capacity>) {
+            if (flow < 0) {
+              over_capacity.update(true);
+            }
+          }
+          net_inflow[n].fetch_sub(flow, std::memory_order_relaxed);
+          net_inflow[*graph.GetEdgeDest(e)].fetch_add(
+              flow, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (over_capacity.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the flow along some edge is not within its capacity");
+  }
+
+  // and must be conserved at all nodes but the terminals
+  katana::GReduceLogicalOr unbalanced;
+  katana::do_all(
+      katana::iterate(size_t{0}, graph.num_nodes()),
+      [&](size_t n) {
+        if (n != source && n != sink &&
+            net_inflow[n].load(std::memory_order_relaxed) != 0) {
+          unbalanced.update(true);
+        }
+      },
+      katana::no_stats());
+  if (unbalanced.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the flow is not conserved at some node");
+  }
+
+  // and must leave no augmenting path
+  if (ReachableFromSource(pg, graph, source)[sink]) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the flow can be augmented along a path from {} to {}", source, sink);
+  }
+
+  return katana::ResultSuccess();
+}
+
+template <typename Capacity>
+katana::Result<MaxFlowStatistics>
+ComputeStatistics(
+    katana::PropertyGraph* pg, size_t source,
+    const std::string& edge_capacity_property_name,
+    const std::string& property_name) {
+  if (source >= pg->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "source {} is not a node", source);
+  }
+  auto graph = KATANA_CHECKED((FlowGraph<Capacity>::Make(
+      pg, {}, {edge_capacity_property_name, property_name})));
+
+  int64_t total_flow = 0;
+  for (auto e : graph.edges(source)) {
+    total_flow += graph.template GetEdgeData<EdgeFlow<Capacity>>(e);
+  }
+  auto view = pg->BuildView<BiDirView>();
+  for (auto e : view.in_edges(source)) {
+    total_flow -= graph.template GetEdgeData<EdgeFlow<Capacity>>(
+        view.in_edge_property_index(e));
+  }
+
+  auto reached = ReachableFromSource(pg, graph, source);
+  uint64_t source_side_size = std::count(reached.begin(), reached.end(), 1);
+
+  return MaxFlowStatistics{static_cast<uint64_t>(total_flow), source_side_size};
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MaxFlow(
+    PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& edge_capacity_property_name,
+    const std::string& output_property_name, MaxFlowPlan plan) {
+  return VisitCapacityType(
+      pg, edge_capacity_property_name, [&](auto capacity) -> Result<void> {
+        return MaxFlowImpl<decltype(capacity)>(
+            pg, source, sink, edge_capacity_property_name, output_property_name,
+            plan);
+      });
+}
+
+katana::Result<void>
+katana::analytics::MaxFlowAssertValid(
+    PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& edge_capacity_property_name,
+    const std::string& property_name) {
+  return VisitCapacityType(
+      pg, edge_capacity_property_name, [&](auto capacity) -> Result<void> {
+        return MaxFlowAssertValidImpl<decltype(capacity)>(
+            pg, source, sink, edge_capacity_property_name, property_name);
+      });
+}
+
+katana::Result<MaxFlowStatistics>
+katana::analytics::MaxFlowStatistics::Compute(
+    PropertyGraph* pg, size_t source,
+    const std::string& edge_capacity_property_name,
+    const std::string& property_name) {
+  return VisitCapacityType(
+      pg, edge_capacity_property_name,
+      [&](auto capacity) -> Result<MaxFlowStatistics> {
+        return ComputeStatistics<decltype(capacity)>(
+            pg, source, edge_capacity_property_name, property_name);
+      });
+}
+
+void
+katana::analytics::MaxFlowStatistics::Print(std::ostream& os) const {
+  os << "Total flow = " << total_flow << std::endl;
+  os << "Number of nodes on the source side of the cut = " << source_side_size
+     << std::endl;
+}
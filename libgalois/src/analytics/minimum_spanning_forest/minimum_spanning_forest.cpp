@@ -0,0 +1,402 @@
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Result.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/UnionFind.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct EdgeInMsf : public katana::PODProperty<uint8_t> {};
+
+template <typename Weight>
+struct EdgeWeight : public katana::PODProperty<Weight> {};
+
+/// The number of edges sampled to pick the pivot of Filter-Kruskal
+constexpr size_t kPivotSampleSize = 1024;
+
+/// An edge that is a candidate for the forest. Edges are ordered by weight
+/// and then by id, so that no two edges are equal and the forest is unique.
+template <typename Weight>
+struct MsfEdge {
+  Weight weight;
+  uint64_t id;
+  uint32_t src;
+  uint32_t dest;
+
+  bool operator<(const MsfEdge& o) const {
+    return weight != o.weight ? weight < o.weight : id < o.id;
+  }
+};
+
+struct MsfNode : public katana::UnionFindNode<MsfNode> {
+  MsfNode() : katana::UnionFindNode<MsfNode>(this) {}
+};
+
+template <typename Weight>
+class SpanningForest {
+  using Edge = MsfEdge<Weight>;
+
+public:
+  /// Take the edges of graph other than self loops as candidates
+  template <typename Graph>
+  explicit SpanningForest(const Graph& graph) {
+    const size_t num_nodes = graph.num_nodes();
+    const size_t num_edges = graph.num_edges();
+    nodes_.allocateBlocked(num_nodes);
+    edges_.allocateBlocked(num_edges);
+    in_msf_.allocateBlocked(num_edges);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          nodes_.constructAt(n);
+          for (auto e : graph.edges(n)) {
+            edges_[e] = Edge{
+                graph.template GetEdgeData<EdgeWeight<Weight>>(e), e,
+                static_cast<uint32_t>(n),
+                static_cast<uint32_t>(*graph.GetEdgeDest(e))};
+            in_msf_[e] = 0;
+          }
+        },
+        katana::steal(), katana::no_stats());
+    candidates_end_ = katana::ParallelSTL::partition(
+        edges_.begin(), edges_.end(),
+        [](const Edge& e) { return e.src != e.dest; });
+  }
+
+  void Boruvka() {
+    constexpr uint64_t kNone = std::numeric_limits<uint64_t>::max();
+    Edge* begin = edges_.begin();
+    Edge* end = candidates_end_;
+    const size_t num_nodes = nodes_.size();
+
+    // the position in [begin, end) of the lightest edge out of each
+    // component, kept at the representative of the component
+    katana::NUMAArray<std::atomic<uint64_t>> lightest;
+    lightest.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) { lightest.constructAt(n, kNone); }, katana::no_stats());
+
+    auto update_lightest = [&](MsfNode* rep, uint64_t i) {
+      std::atomic<uint64_t>& slot = lightest[rep - nodes_.begin()];
+      uint64_t current = slot.load(std::memory_order_relaxed);
+      while ((current == kNone || begin[i] < begin[current]) &&
+             !slot.compare_exchange_weak(current, i)) {
+      }
+    };
+
+    uint64_t rounds = 0;
+    while (begin != end) {
+      ++rounds;
+      katana::do_all(
+          katana::iterate(uint64_t{0}, static_cast<uint64_t>(end - begin)),
+          [&](uint64_t i) {
+            MsfNode* src_rep = nodes_[begin[i].src].findAndCompress();
+            MsfNode* dest_rep = nodes_[begin[i].dest].findAndCompress();
+            if (src_rep != dest_rep) {
+              update_lightest(src_rep, i);
+              update_lightest(dest_rep, i);
+            }
+          },
+          katana::steal(), katana::loopname("MinimumSpanningForestLightest"));
+
+      // The lightest edges form a forest, since the edges are totally
+      // ordered, so a merge along one fails only if the components at both
+      // of its ends picked it.
+      katana::do_all(
+          katana::iterate(size_t{0}, num_nodes),
+          [&](size_t n) {
+            uint64_t i = lightest[n].load(std::memory_order_relaxed);
+            if (i == kNone) {
+              return;
+            }
+            lightest[n].store(kNone, std::memory_order_relaxed);
+            const Edge& e = begin[i];
+            if (nodes_[e.src].merge(&nodes_[e.dest])) {
+              in_msf_[e.id] = 1;
+            }
+          },
+          katana::steal(), katana::loopname("MinimumSpanningForestMerge"));
+
+      end = FilterInternal(begin, end);
+    }
+
+    katana::ReportStatSingle("MinimumSpanningForest", "BoruvkaRounds", rounds);
+  }
+
+  void FilterKruskal(size_t base_case_size) {
+    FilterKruskal(edges_.begin(), candidates_end_, base_case_size);
+  }
+
+  const katana::NUMAArray<uint8_t>& in_msf() const { return in_msf_; }
+
+private:
+  /// Move the edges of [begin, end) between different components to the
+  /// front, in parallel, and return the end of them
+  Edge* FilterInternal(Edge* begin, Edge* end) {
+    return katana::ParallelSTL::partition(begin, end, [&](const Edge& e) {
+      return nodes_[e.src].find() != nodes_[e.dest].find();
+    });
+  }
+
+  void FilterKruskal(Edge* begin, Edge* end, size_t base_case_size) {
+    const size_t size = end - begin;
+    if (size <= std::max<size_t>(base_case_size, 1)) {
+      katana::ParallelSTL::sort(begin, end);
+      for (Edge* e = begin; e != end; ++e) {
+        if (nodes_[e->src].merge(&nodes_[e->dest])) {
+          in_msf_[e->id] = 1;
+        }
+      }
+      return;
+    }
+
+    // the lower median of evenly spaced edges, which leaves at least one
+    // edge on each side since the edges are distinct
+    const size_t sample_size = std::min(size, kPivotSampleSize);
+    std::vector<Edge> sample(sample_size);
+    for (size_t i = 0; i < sample_size; ++i) {
+      sample[i] = begin[i * size / sample_size];
+    }
+    auto median = sample.begin() + (sample_size - 1) / 2;
+    std::nth_element(sample.begin(), median, sample.end());
+    const Edge pivot = *median;
+
+    Edge* mid = katana::ParallelSTL::partition(
+        begin, end, [&](const Edge& e) { return !(pivot < e); });
+    FilterKruskal(begin, mid, base_case_size);
+    FilterKruskal(mid, FilterInternal(mid, end), base_case_size);
+  }
+
+  katana::NUMAArray<MsfNode> nodes_;
+  katana::NUMAArray<Edge> edges_;
+  katana::NUMAArray<uint8_t> in_msf_;
+  /// The end of the edges other than self loops in edges_
+  Edge* candidates_end_;
+};
+
+/// Call fn with a value of the type of the edge weights
+template <typename F>
+std::invoke_result_t<F, uint32_t>
+VisitWeightType(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    F fn) {
+  auto property = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return fn(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return fn(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return fn(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return fn(int64_t{});
+  case arrow::FloatType::type_id:
+    return fn(float{});
+  case arrow::DoubleType::type_id:
+    return fn(double{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported edge weight type {}",
+        property->type()->ToString());
+  }
+}
+
+template <typename Weight>
+using ForestGraph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<EdgeWeight<Weight>, EdgeInMsf>>;
+
+/// The number of edges marked in property_name and the sum of their weights
+template <typename Weight>
+katana::Result<std::pair<uint64_t, double>>
+ForestWeight(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  auto graph = KATANA_CHECKED((ForestGraph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, property_name})));
+
+  katana::GAccumulator<uint64_t> number_of_edges;
+  katana::GAccumulator<double> total_weight;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_edges()),
+      [&](uint64_t e) {
+        if (graph.template GetEdgeData<EdgeInMsf>(e)) {
+          number_of_edges += 1;
+          total_weight += graph.template GetEdgeData<EdgeWeight<Weight>>(e);
+        }
+      },
+      katana::no_stats());
+  return std::make_pair(number_of_edges.reduce(), total_weight.reduce());
+}
+
+template <typename Weight>
+katana::Result<void>
+MinimumSpanningForestImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MinimumSpanningForestPlan plan) {
+  static_assert(std::is_integral_v<Weight> || std::is_floating_point_v<Weight>);
+  if (plan.algorithm() != MinimumSpanningForestPlan::kBoruvka &&
+      plan.algorithm() != MinimumSpanningForestPlan::kFilterKruskal) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  KATANA_CHECKED(ConstructEdgeProperties<std::tuple<EdgeInMsf>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED((ForestGraph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, output_property_name})));
+
+  katana::StatTimer exec_time("MinimumSpanningForest");
+  exec_time.start();
+
+  SpanningForest<Weight> forest(graph);
+  if (plan.algorithm() == MinimumSpanningForestPlan::kBoruvka) {
+    forest.Boruvka();
+  } else {
+    forest.FilterKruskal(plan.base_case_size());
+  }
+
+  exec_time.stop();
+
+  const auto& in_msf = forest.in_msf();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_edges()),
+      [&](uint64_t e) { graph.template GetEdgeData<EdgeInMsf>(e) = in_msf[e]; },
+      katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<void>
+MinimumSpanningForestAssertValidImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  auto graph = KATANA_CHECKED((ForestGraph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, property_name})));
+
+  // the marked edges must not close a cycle
+  katana::NUMAArray<MsfNode> nodes;
+  nodes.allocateBlocked(graph.num_nodes());
+  katana::do_all(
+      katana::iterate(size_t{0}, graph.num_nodes()),
+      [&](size_t n) { nodes.constructAt(n); }, katana::no_stats());
+  for (size_t n = 0; n < graph.num_nodes(); ++n) {
+    for (auto e : graph.edges(n)) {
+      if (graph.template GetEdgeData<EdgeInMsf>(e) &&
+          !nodes[n].merge(&nodes[*graph.GetEdgeDest(e)])) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "edge {} closes a cycle in the forest", e);
+      }
+    }
+  }
+
+  // and must connect the ends of every edge
+  katana::GReduceLogicalOr disconnected;
+  katana::do_all(
+      katana::iterate(size_t{0}, graph.num_nodes()),
+      [&](size_t n) {
+        for (auto e : graph.edges(n)) {
+          if (nodes[n].find() != nodes[*graph.GetEdgeDest(e)].find()) {
+            disconnected.update(true);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (disconnected.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the forest does not span the components of the graph");
+  }
+
+  // and weigh no more than the forest found by Kruskal's algorithm
+  auto [number_of_edges, total_weight] = KATANA_CHECKED(ForestWeight<Weight>(
+      pg, edge_weight_property_name, property_name));
+  SpanningForest<Weight> forest(graph);
+  forest.FilterKruskal(graph.num_edges());
+  double minimum_weight = 0;
+  for (uint64_t e = 0; e < graph.num_edges(); ++e) {
+    if (forest.in_msf()[e]) {
+      minimum_weight += graph.template GetEdgeData<EdgeWeight<Weight>>(e);
+    }
+  }
+  double tolerance = std::is_floating_point_v<Weight>
+                         ? 1e-6 * std::max(1.0, std::abs(minimum_weight))
+                         : 0;
+  if (total_weight > minimum_weight + tolerance) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the forest of {} edges weighs {}, more than the minimum {}",
+        number_of_edges, total_weight, minimum_weight);
+  }
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MinimumSpanningForestPlan plan) {
+  return VisitWeightType(
+      pg, edge_weight_property_name, [&](auto weight) -> Result<void> {
+        return MinimumSpanningForestImpl<decltype(weight)>(
+            pg, edge_weight_property_name, output_property_name, plan);
+      });
+}
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  return VisitWeightType(
+      pg, edge_weight_property_name, [&](auto weight) -> Result<void> {
+        return MinimumSpanningForestAssertValidImpl<decltype(weight)>(
+            pg, edge_weight_property_name, property_name);
+      });
+}
+
+katana::Result<MinimumSpanningForestStatistics>
+katana::analytics::MinimumSpanningForestStatistics::Compute(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  return VisitWeightType(
+      pg, edge_weight_property_name,
+      [&](auto weight) -> Result<MinimumSpanningForestStatistics> {
+        auto [number_of_edges, total_weight] =
+            KATANA_CHECKED(ForestWeight<decltype(weight)>(
+                pg, edge_weight_property_name, property_name));
+        return MinimumSpanningForestStatistics{
+            number_of_edges, pg->num_nodes() - number_of_edges, total_weight};
+      });
+}
+
+void
+katana::analytics::MinimumSpanningForestStatistics::Print(
+    std::ostream& os) const {
+  os << "Number of edges in the forest = " << number_of_edges << std::endl;
+  os << "Number of trees in the forest = " << number_of_trees << std::endl;
+  os << "Total weight of the forest = " << total_weight << std::endl;
+}
@@ -0,0 +1,322 @@
+#include "katana/analytics/neighbor_sampling/neighbor_sampling.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/compute/api.h>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "katana/Threads.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// The slot of a node that no hop has sampled
+constexpr uint64_t kNone = std::numeric_limits<uint64_t>::max();
+
+/// Without replacement, fanouts up to this draw by Floyd's algorithm with a
+/// scan of the draws so far; larger ones partially shuffle the edges
+constexpr uint32_t kMaxScanFanout = 32;
+
+constexpr static const unsigned kChunkSize = 64U;
+
+/// The finalizer of splitmix64
+uint64_t
+Mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+/// splitmix64, a generator cheap enough to seed for every node
+class Generator {
+public:
+  explicit Generator(uint64_t seed) : state_(seed) {}
+
+  /// \returns a number drawn uniformly from [0, bound)
+  uint64_t Below(uint64_t bound) {
+    state_ += 0x9e3779b97f4a7c15;
+    return static_cast<uint64_t>(
+        (static_cast<__uint128_t>(Mix(state_)) * bound) >> 64);
+  }
+
+private:
+  uint64_t state_;
+};
+
+}  // namespace
+
+katana::analytics::NeighborSampler::NeighborSampler(
+    PropertyGraph* pg, std::vector<uint32_t> fanouts,
+    std::vector<std::string> feature_properties, NeighborSamplingPlan plan)
+    : pg_(pg),
+      fanouts_(std::move(fanouts)),
+      feature_properties_(std::move(feature_properties)),
+      plan_(plan) {
+  slot_.allocateBlocked(pg_->num_nodes());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg_->num_nodes()),
+      [&](uint64_t n) { slot_[n].store(kNone, std::memory_order_relaxed); },
+      katana::no_stats());
+}
+
+katana::analytics::NeighborSampler::~NeighborSampler() {
+  if (prefetched_.valid()) {
+    prefetched_.wait();
+  }
+}
+
+katana::Result<std::unique_ptr<NeighborSampler>>
+katana::analytics::NeighborSampler::Make(
+    PropertyGraph* pg, std::vector<uint32_t> fanouts,
+    std::vector<std::string> feature_properties, NeighborSamplingPlan plan) {
+  if (plan.algorithm() != NeighborSamplingPlan::kUniform) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  for (const auto& name : feature_properties) {
+    if (!pg->GetNodeProperty(name)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no property named {}", name);
+    }
+  }
+  return std::unique_ptr<NeighborSampler>(new NeighborSampler(
+      pg, std::move(fanouts), std::move(feature_properties), plan));
+}
+
+katana::Result<SampledMiniBatch>
+katana::analytics::NeighborSampler::Sample(
+    const std::vector<uint32_t>& seeds, uint64_t batch_index) {
+  if (prefetched_.valid()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AlreadyExists, "a batch is being prefetched");
+  }
+  return SampleBatch(seeds, batch_index);
+}
+
+katana::Result<void>
+katana::analytics::NeighborSampler::Prefetch(
+    std::vector<uint32_t> seeds, uint64_t batch_index) {
+  if (prefetched_.valid()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AlreadyExists, "a batch is being prefetched");
+  }
+  unsigned num_threads = katana::getActiveThreads();
+  prefetched_ = std::async(
+      std::launch::async,
+      [this, seeds = std::move(seeds), batch_index, num_threads] {
+        katana::ThreadPoolLease lease(num_threads);
+        return SampleBatch(seeds, batch_index);
+      });
+  return katana::ResultSuccess();
+}
+
+katana::Result<SampledMiniBatch>
+katana::analytics::NeighborSampler::TakePrefetched() {
+  if (!prefetched_.valid()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no batch is being prefetched");
+  }
+  return prefetched_.get();
+}
+
+katana::Result<SampledMiniBatch>
+katana::analytics::NeighborSampler::SampleBatch(
+    const std::vector<uint32_t>& seeds, uint64_t batch_index) {
+  // mark the seeds to find repeats; so few that a serial loop is enough
+  katana::Result<void> seeds_ok = katana::ResultSuccess();
+  size_t num_marked = 0;
+  for (; num_marked < seeds.size(); ++num_marked) {
+    uint32_t seed = seeds[num_marked];
+    if (seed >= pg_->num_nodes()) {
+      seeds_ok = KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "node {} is not in the graph",
+          seed);
+      break;
+    }
+    if (slot_[seed].exchange(0, std::memory_order_relaxed) != kNone) {
+      seeds_ok = KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "seed {} is repeated", seed);
+      break;
+    }
+  }
+  for (size_t i = 0; i < num_marked; ++i) {
+    slot_[seeds[i]].store(kNone, std::memory_order_relaxed);
+  }
+  if (!seeds_ok) {
+    return seeds_ok.error();
+  }
+
+  katana::StatTimer exec_time("NeighborSampler");
+  exec_time.start();
+  SampledMiniBatch batch;
+  batch.input_nodes = seeds;
+  for (uint32_t hop = 0; hop < fanouts_.size(); ++hop) {
+    batch.blocks.emplace_back(SampleHop(batch.input_nodes, batch_index, hop));
+    batch.input_nodes = batch.blocks.back().src_nodes;
+  }
+  exec_time.stop();
+
+  batch.features = KATANA_CHECKED(GatherFeatures(batch.input_nodes));
+  return batch;
+}
+
+SampledBlock
+katana::analytics::NeighborSampler::SampleHop(
+    const std::vector<uint32_t>& dst_nodes, uint64_t batch_index,
+    uint32_t hop) {
+  const katana::GraphTopology& topo = pg_->topology();
+  uint32_t fanout = fanouts_[hop];
+  bool with_replacement = plan_.with_replacement();
+  uint64_t num_dsts = dst_nodes.size();
+
+  SampledBlock block;
+  block.dst_nodes = dst_nodes;
+  block.indptr.resize(num_dsts + 1);
+  block.indptr[0] = 0;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_dsts),
+      [&](uint64_t i) {
+        uint64_t degree = topo.degree(dst_nodes[i]);
+        bool all = fanout == NeighborSampler::kAllNeighbors ||
+                   (!with_replacement && degree <= fanout);
+        block.indptr[i + 1] = all ? degree : (degree == 0 ? 0 : fanout);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      block.indptr.begin(), block.indptr.end(), block.indptr.begin());
+  uint64_t num_edges = block.indptr.back();
+
+  // Draw the edges of each destination into its slots
+  block.edge_ids.resize(num_edges);
+  std::vector<uint32_t> neighbors(num_edges);
+  katana::PerThreadStorage<std::vector<uint64_t>> per_thread_shuffle;
+  uint64_t hop_seed = Mix(Mix(plan_.seed() + batch_index) + hop);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_dsts),
+      [&](uint64_t i) {
+        auto edges = topo.edges(dst_nodes[i]);
+        uint64_t first = *edges.begin();
+        uint64_t degree = edges.size();
+        uint64_t* out = block.edge_ids.data() + block.indptr[i];
+        uint64_t count = block.indptr[i + 1] - block.indptr[i];
+        Generator gen(Mix(hop_seed + dst_nodes[i]));
+        if (fanout == NeighborSampler::kAllNeighbors ||
+            (count == degree && !with_replacement)) {
+          std::iota(out, out + count, first);
+        } else if (with_replacement) {
+          for (uint64_t k = 0; k < count; ++k) {
+            out[k] = first + gen.Below(degree);
+          }
+        } else if (count <= kMaxScanFanout) {
+          // Floyd's algorithm: a uniform subset of count of [0, degree)
+          for (uint64_t j = degree - count; j < degree; ++j) {
+            uint64_t t = first + gen.Below(j + 1);
+            uint64_t* drawn = out + (j - (degree - count));
+            *drawn = std::find(out, drawn, t) == drawn ? t : first + j;
+          }
+        } else {
+          std::vector<uint64_t>& shuffle = *per_thread_shuffle.getLocal();
+          shuffle.resize(degree);
+          std::iota(shuffle.begin(), shuffle.end(), first);
+          for (uint64_t k = 0; k < count; ++k) {
+            std::swap(shuffle[k], shuffle[k + gen.Below(degree - k)]);
+          }
+          std::copy(shuffle.begin(), shuffle.begin() + count, out);
+        }
+        // edges in order of id read the destinations in order
+        std::sort(out, out + count);
+        for (uint64_t k = 0; k < count; ++k) {
+          neighbors[block.indptr[i] + k] = topo.edge_dest(out[k]);
+        }
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("NeighborSampler-Draw"));
+
+  // Number the sources: the destinations first and then the other
+  // neighbors by the first slot that drew them
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_dsts),
+      [&](uint64_t i) {
+        slot_[dst_nodes[i]].store(i, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t p) { katana::atomicMin(slot_[neighbors[p]], num_dsts + p); },
+      katana::no_stats());
+  std::vector<uint64_t> num_new(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t p) {
+        num_new[p] = slot_[neighbors[p]].load(std::memory_order_relaxed) ==
+                     num_dsts + p;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      num_new.begin(), num_new.end(), num_new.begin());
+
+  block.src_nodes.resize(num_dsts + (num_edges ? num_new.back() : 0));
+  std::copy(dst_nodes.begin(), dst_nodes.end(), block.src_nodes.begin());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t p) {
+        if (num_new[p] != (p == 0 ? 0 : num_new[p - 1])) {
+          uint64_t index = num_dsts + num_new[p] - 1;
+          block.src_nodes[index] = neighbors[p];
+          slot_[neighbors[p]].store(index, std::memory_order_relaxed);
+        }
+      },
+      katana::no_stats());
+  block.indices.resize(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t p) {
+        block.indices[p] = slot_[neighbors[p]].load(std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(block.src_nodes),
+      [&](uint32_t n) { slot_[n].store(kNone, std::memory_order_relaxed); },
+      katana::no_stats());
+  return block;
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::NeighborSampler::GatherFeatures(
+    const std::vector<uint32_t>& nodes) const {
+  auto indices = std::make_shared<arrow::UInt32Array>(
+      nodes.size(), arrow::Buffer::Wrap(nodes));
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : feature_properties_) {
+    std::shared_ptr<arrow::ChunkedArray> property = pg_->GetNodeProperty(name);
+    if (!property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no property named {}", name);
+    }
+    auto taken = arrow::compute::Take(property, indices);
+    if (!taken.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "failed to take rows of {}: {}",
+          name, taken.status());
+    }
+    fields.emplace_back(arrow::field(name, property->type()));
+    columns.emplace_back(taken.ValueOrDie().chunked_array());
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, nodes.size());
+}
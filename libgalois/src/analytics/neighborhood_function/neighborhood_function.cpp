@@ -0,0 +1,187 @@
+#include "katana/analytics/neighborhood_function/neighborhood_function.h"
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/HyperLogLog.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+
+struct NodeHarmonicCentrality : public katana::PODProperty<double> {};
+
+using CentralityGraph = katana::TypedPropertyGraph<
+    std::tuple<NodeHarmonicCentrality>, std::tuple<>>;
+
+/// The hash of node n is Mix(n + kSeed)
+constexpr uint64_t kSeed = 0x9e3779b97f4a7c15;
+
+constexpr static const unsigned kChunkSize = 64U;
+
+/// The finalizer of splitmix64
+uint64_t
+Mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+}  // namespace
+
+double
+katana::analytics::NeighborhoodFunctionEstimate::EffectiveDiameter(
+    double fraction) const {
+  if (neighborhood_function.empty()) {
+    return 0;
+  }
+  double target = fraction * neighborhood_function.back();
+  if (neighborhood_function[0] >= target) {
+    return 0;
+  }
+  size_t t = 1;
+  while (t + 1 < neighborhood_function.size() &&
+         neighborhood_function[t] < target) {
+    ++t;
+  }
+  double below = neighborhood_function[t - 1];
+  double above = neighborhood_function[t];
+  if (above <= below) {
+    return t;
+  }
+  return (t - 1) + (target - below) / (above - below);
+}
+
+void
+katana::analytics::NeighborhoodFunctionEstimate::Print(std::ostream& os) const {
+  for (size_t t = 0; t < neighborhood_function.size(); ++t) {
+    os << "Pairs within distance " << t << " = " << neighborhood_function[t]
+       << std::endl;
+  }
+  os << "Effective diameter = " << EffectiveDiameter() << std::endl;
+}
+
+katana::Result<NeighborhoodFunctionEstimate>
+katana::analytics::EstimateNeighborhoodFunction(
+    PropertyGraph* pg, const std::string& harmonic_centrality_property_name,
+    NeighborhoodFunctionPlan plan) {
+  if (plan.algorithm() != NeighborhoodFunctionPlan::kHyperAnf) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  if (plan.log2_num_registers() <
+          katana::HyperLogLogArray::kMinLog2NumRegisters ||
+      plan.log2_num_registers() >
+          katana::HyperLogLogArray::kMaxLog2NumRegisters) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the log2 of the number of registers must be between {} and {}",
+        katana::HyperLogLogArray::kMinLog2NumRegisters,
+        katana::HyperLogLogArray::kMaxLog2NumRegisters);
+  }
+  bool want_centrality = !harmonic_centrality_property_name.empty();
+
+  auto view = pg->BuildView<BiDirView>();
+  uint64_t num_nodes = view.num_nodes();
+
+  katana::StatTimer exec_time("EstimateNeighborhoodFunction");
+  exec_time.start();
+
+  // The counters of the nodes within distance t - 1 and t of each node, and
+  // whether they grew in the last step
+  katana::HyperLogLogArray current(num_nodes, plan.log2_num_registers());
+  katana::HyperLogLogArray next(num_nodes, plan.log2_num_registers());
+  katana::NUMAArray<uint8_t> current_changed;
+  katana::NUMAArray<uint8_t> next_changed;
+  current_changed.allocateBlocked(num_nodes);
+  next_changed.allocateBlocked(num_nodes);
+  katana::NUMAArray<double> estimates;
+  estimates.allocateBlocked(num_nodes);
+  katana::NUMAArray<double> centrality;
+  if (want_centrality) {
+    centrality.allocateBlocked(num_nodes);
+  }
+
+  katana::GAccumulator<double> total;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        current.Add(n, Mix(n + kSeed));
+        current_changed[n] = true;
+        estimates[n] = current.Estimate(n);
+        total += estimates[n];
+        if (want_centrality) {
+          centrality[n] = 0;
+        }
+      },
+      katana::no_stats());
+
+  NeighborhoodFunctionEstimate result;
+  result.neighborhood_function.push_back(total.reduce());
+
+  uint32_t t = 1;
+  for (; t <= plan.max_iterations(); ++t) {
+    katana::GReduceLogicalOr any_changed;
+    total.reset();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t v) {
+          next.Copy(v, current, v);
+          bool changed = false;
+          // a counter that did not change in step t - 1 is in v already
+          for (auto e : view.in_edges(v)) {
+            auto u = view.in_edge_dest(e);
+            if (current_changed[u]) {
+              changed |= next.Merge(v, current, u);
+            }
+          }
+          next_changed[v] = changed;
+          if (changed) {
+            double estimate = next.Estimate(v);
+            if (want_centrality) {
+              centrality[v] += (estimate - estimates[v]) / t;
+            }
+            estimates[v] = estimate;
+            any_changed.update(true);
+          }
+          total += estimates[v];
+        },
+        katana::chunk_size<kChunkSize>(), katana::steal(),
+        katana::loopname("HyperAnf"));
+    if (!any_changed.reduce()) {
+      break;
+    }
+    result.neighborhood_function.push_back(total.reduce());
+    std::swap(current, next);
+    std::swap(current_changed, next_changed);
+  }
+  exec_time.stop();
+  katana::ReportStatSingle("HyperAnf", "Iterations", t);
+
+  if (want_centrality) {
+    KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeHarmonicCentrality>>(
+        pg, {harmonic_centrality_property_name}));
+    auto graph = KATANA_CHECKED(
+        CentralityGraph::Make(pg, {harmonic_centrality_property_name}, {}));
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const CentralityGraph::Node& n) {
+          graph.GetData<NodeHarmonicCentrality>(n) = centrality[n];
+        },
+        katana::no_stats());
+  }
+
+  return result;
+}
@@ -35,18 +35,35 @@ using NodeValue = katana::PODProperty<PRTy>;
 
 katana::Result<void> PagerankPullTopological(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan);
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation,
+    katana::analytics::AnalyticsWorkspace* workspace);
+
+katana::Result<void> PagerankPullBlocked(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation,
+    katana::analytics::AnalyticsWorkspace* workspace);
 
 katana::Result<void> PagerankPullResidual(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan);
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation,
+    katana::analytics::AnalyticsWorkspace* workspace);
 
 katana::Result<void> PagerankPushAsynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan);
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation);
+
+katana::Result<void> PagerankPushAsynchronousWarmStart(
+    katana::PropertyGraph* pg, const std::string& rank_property_name,
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation);
 
 katana::Result<void> PagerankPushSynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan);
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation);
 
 #endif
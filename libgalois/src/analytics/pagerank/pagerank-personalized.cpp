@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <unordered_map>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "pagerank-impl.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using TopK = std::vector<std::pair<uint32_t, double>>;
+
+/// The state of a query, kept by each thread across queries. Only the nodes
+/// that receive residual get an entry, so a query costs time and memory
+/// proportional to the part of the graph it reaches.
+struct Scratch {
+  struct Entry {
+    double rank{0};
+    double residual{0};
+    bool queued{false};
+  };
+
+  std::unordered_map<Node, Entry> entries;
+  std::vector<Node> queue;
+};
+
+/// Forward push (Andersen, Chung and Lang): a node whose residual is at
+/// least tolerance times its out degree keeps 1 - alpha of the residual as
+/// rank and spreads the rest over its out neighbors, or over the seeds if
+/// it has none
+TopK
+ForwardPush(
+    const katana::GraphTopology& topology, const std::vector<uint32_t>& seeds,
+    size_t k, const katana::analytics::PagerankPlan& plan, Scratch* sc) {
+  const double alpha = plan.alpha();
+  const double tolerance = plan.tolerance();
+
+  sc->entries.clear();
+  sc->queue.clear();
+
+  auto add_residual = [&](Node n, double residual) {
+    auto& entry = sc->entries[n];
+    entry.residual += residual;
+    double degree = std::max<size_t>(topology.degree(n), 1);
+    if (!entry.queued && entry.residual >= tolerance * degree) {
+      entry.queued = true;
+      sc->queue.push_back(n);
+    }
+  };
+
+  for (Node seed : seeds) {
+    add_residual(seed, 1.0 / seeds.size());
+  }
+
+  while (!sc->queue.empty()) {
+    Node n = sc->queue.back();
+    sc->queue.pop_back();
+
+    auto& entry = sc->entries[n];
+    double residual = entry.residual;
+    entry.residual = 0;
+    entry.queued = false;
+    entry.rank += (1 - alpha) * residual;
+
+    auto edges = topology.edges(n);
+    if (edges.empty()) {
+      for (Node seed : seeds) {
+        add_residual(seed, alpha * residual / seeds.size());
+      }
+      continue;
+    }
+    double share = alpha * residual / edges.size();
+    for (auto e : edges) {
+      add_residual(topology.edge_dest(e), share);
+    }
+  }
+
+  TopK ranks;
+  ranks.reserve(sc->entries.size());
+  for (const auto& [n, entry] : sc->entries) {
+    if (entry.rank > 0) {
+      ranks.emplace_back(n, entry.rank);
+    }
+  }
+
+  auto by_rank = [](const auto& a, const auto& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  };
+  size_t top = std::min(k, ranks.size());
+  std::partial_sort(ranks.begin(), ranks.begin() + top, ranks.end(), by_rank);
+  ranks.resize(top);
+  return ranks;
+}
+
+katana::Result<void>
+CheckQuery(
+    const katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const katana::analytics::PagerankPlan& plan) {
+  if (!(plan.tolerance() > 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "tolerance must be positive");
+  }
+  if (seeds.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no seed nodes given");
+  }
+  for (uint32_t seed : seeds) {
+    if (seed >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "seed {} is not a node", seed);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<std::vector<std::pair<uint32_t, double>>>
+katana::analytics::PersonalizedPagerank(
+    const PropertyGraph* pg, const std::vector<uint32_t>& seeds, size_t k,
+    PagerankPlan plan) {
+  KATANA_CHECKED(CheckQuery(pg, seeds, plan));
+
+  Scratch sc;
+  return ForwardPush(pg->topology(), seeds, k, plan, &sc);
+}
+
+katana::Result<std::vector<std::vector<std::pair<uint32_t, double>>>>
+katana::analytics::PersonalizedPagerankBatch(
+    const PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets, size_t k,
+    PagerankPlan plan) {
+  for (const auto& seeds : seed_sets) {
+    KATANA_CHECKED(CheckQuery(pg, seeds, plan));
+  }
+
+  std::vector<TopK> results(seed_sets.size());
+  katana::PerThreadStorage<Scratch> scratch;
+  katana::do_all(
+      katana::iterate(size_t{0}, seed_sets.size()),
+      [&](size_t i) {
+        results[i] = ForwardPush(
+            pg->topology(), seed_sets[i], k, plan, scratch.getLocal());
+      },
+      katana::steal(), katana::loopname("PersonalizedPagerank"));
+
+  return results;
+}
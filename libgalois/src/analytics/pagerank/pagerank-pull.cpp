@@ -17,12 +17,19 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <vector>
+
 #include <arrow/type.h>
 
+#include "katana/Prefetch.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/SpMV.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
 
+using katana::analytics::ArrayOrLocal;
+
 namespace {
 
 struct PagerankValueAndOutDegreeTy {
@@ -42,6 +49,14 @@ typedef typename Graph::Node GNode;
 using DeltaArray = katana::NUMAArray<PRTy>;
 using ResidualArray = katana::NUMAArray<PRTy>;
 
+/// Slots of the arrays of the same type in an AnalyticsWorkspace
+enum WorkspaceSlot : uint32_t {
+  kDeltaSlot = 0,
+  kResidualSlot,
+  kContributionSlot,
+  kSumSlot,
+};
+
 //! Initialize nodes for the topological algorithm.
 void
 InitNodeDataTopological(
@@ -79,12 +94,14 @@ InitNodeDataResidual(
 void
 ComputeOutDeg(
     const katana::PropertyGraph& graph,
-    katana::NUMAArray<PagerankValueAndOutDegreeTy>* node_data) {
+    katana::NUMAArray<PagerankValueAndOutDegreeTy>* node_data,
+    katana::analytics::AnalyticsWorkspace* workspace) {
   katana::StatTimer out_degree_timer("computeOutDegFunc");
   out_degree_timer.start();
 
-  katana::NUMAArray<std::atomic<size_t>> vec;
-  vec.allocateInterleaved(graph.size());
+  katana::NUMAArray<std::atomic<size_t>> local_vec;
+  katana::NUMAArray<std::atomic<size_t>>& vec =
+      *ArrayOrLocal(workspace, 0, graph.size(), &local_vec);
 
   katana::do_all(
       katana::iterate(graph),
@@ -111,12 +128,13 @@ ComputeOutDeg(
   out_degree_timer.stop();
 }
 void
-ComputeOutDeg(Graph* graph) {
+ComputeOutDeg(Graph* graph, katana::analytics::AnalyticsWorkspace* workspace) {
   katana::StatTimer out_degree_timer("computeOutDegFunc");
   out_degree_timer.start();
 
-  katana::NUMAArray<std::atomic<size_t>> vec;
-  vec.allocateInterleaved(graph->size());
+  katana::NUMAArray<std::atomic<size_t>> local_vec;
+  katana::NUMAArray<std::atomic<size_t>>& vec =
+      *ArrayOrLocal(workspace, 0, graph->size(), &local_vec);
 
   katana::do_all(
       katana::iterate(*graph),
@@ -157,11 +175,15 @@ ComputeOutDeg(Graph* graph) {
 void
 ComputePRResidual(
     Graph* graph, DeltaArray& delta, ResidualArray& residual,
-    katana::analytics::PagerankPlan plan) {
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation) {
   unsigned int iterations = 0;
   katana::GAccumulator<unsigned int> accum;
 
   while (true) {
+    if (cancellation && cancellation->IsCancelled()) {
+      break;
+    }
     katana::do_all(
         katana::iterate(*graph),
         [&](const GNode& src) {
@@ -186,19 +208,21 @@ ComputePRResidual(
         katana::iterate(*graph),
         [&](const GNode& src) {
           float sum = 0;
-          for (auto nbr : graph->edges(src)) {
-            auto dest = graph->GetEdgeDest(nbr);
-            if (delta[*dest] > 0) {
-              sum += delta[*dest];
-            }
-          }
+          graph->ForEachEdgePrefetched(
+              src,
+              [&](auto, GNode dest) {
+                if (delta[dest] > 0) {
+                  sum += delta[dest];
+                }
+              },
+              [&](GNode dest) { katana::PrefetchForRead(&delta[dest]); });
           if (sum > 0) {
             residual[src] = sum;
           }
         },
         katana::steal(),
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
-        katana::loopname("PageRank"));
+        katana::loopname("PageRank"), katana::cancellation(cancellation));
 
 #if DEBUG
     std::cout << "iteration: " << iterations << "\n";
@@ -219,22 +243,30 @@ ComputePRResidual(
 void
 ComputePRTopological(
     const katana::PropertyGraph& graph, katana::analytics::PagerankPlan plan,
-    katana::NUMAArray<PagerankValueAndOutDegreeTy>* node_data) {
+    katana::NUMAArray<PagerankValueAndOutDegreeTy>* node_data,
+    const katana::CancellationToken* cancellation) {
   unsigned int iteration = 0;
   katana::GAccumulator<float> accum;
 
   float base_score = (1.0f - plan.alpha()) / graph.size();
   while (true) {
+    if (cancellation && cancellation->IsCancelled()) {
+      break;
+    }
     katana::do_all(
         katana::iterate(graph),
         [&](const GNode& src) {
           float sum = 0.0;
 
-          for (auto jj : graph.edges(src)) {
-            auto dest = graph.GetEdgeDest(jj);
-            auto& ddata = (*node_data)[*dest];
-            sum += ddata.value / ddata.out;
-          }
+          graph.topology().ForEachEdgePrefetched(
+              src,
+              [&](auto, GNode dest) {
+                auto& ddata = (*node_data)[dest];
+                sum += ddata.value / ddata.out;
+              },
+              [&](GNode dest) {
+                katana::PrefetchForRead(&(*node_data)[dest]);
+              });
 
           //! New value of pagerank after computing contributions from
           //! incoming edges in the original graph.
@@ -251,7 +283,8 @@ ComputePRTopological(
         },
         katana::steal(),
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
-        katana::loopname("Pagerank Topological"));
+        katana::loopname("Pagerank Topological"),
+        katana::cancellation(cancellation));
 
 #if DEBUG
     std::cout << "iteration: " << iteration << " max delta: " << delta << "\n";
@@ -268,6 +301,67 @@ ComputePRTopological(
   katana::ReportStatSingle("PageRank", "Iterations", iteration);
 }
 
+/**
+ * PageRank pull with propagation blocking.
+ * Like the topological algorithm, but the in edges are visited block by
+ * block of the neighbors they read, so the random reads of a block hit the
+ * cache, and each round reads the ranks of the previous round.
+ */
+void
+ComputePRBlocked(
+    const katana::PropertyGraph& graph, katana::analytics::PagerankPlan plan,
+    katana::NUMAArray<PagerankValueAndOutDegreeTy>* node_data,
+    katana::analytics::AnalyticsWorkspace* workspace,
+    const katana::CancellationToken* cancellation) {
+  auto blocked = katana::analytics::BlockedMatrix::Make(graph.topology());
+
+  katana::NUMAArray<PRTy> local_contribution;
+  katana::NUMAArray<PRTy> local_sum;
+  katana::NUMAArray<PRTy>& contribution = *ArrayOrLocal(
+      workspace, kContributionSlot, graph.size(), &local_contribution);
+  katana::NUMAArray<PRTy>& sum =
+      *ArrayOrLocal(workspace, kSumSlot, graph.size(), &local_sum);
+
+  unsigned int iteration = 0;
+  katana::GAccumulator<float> accum;
+
+  float base_score = (1.0f - plan.alpha()) / graph.size();
+  while (true) {
+    if (cancellation && cancellation->IsCancelled()) {
+      break;
+    }
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          const auto& ndata = (*node_data)[n];
+          contribution[n] = ndata.out > 0 ? ndata.value / ndata.out : 0;
+        },
+        katana::loopname("Pagerank Blocked Contribution"));
+
+    blocked.Multiply(
+        contribution, &sum, "Pagerank Blocked Gather", cancellation);
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          float value = sum[n] * plan.alpha() + base_score;
+          auto& sdata = (*node_data)[n].value;
+          accum += std::fabs(value - sdata);
+          sdata = value;
+        },
+        katana::loopname("Pagerank Blocked Update"));
+
+    iteration += 1;
+    if (accum.reduce() <= plan.tolerance() ||
+        iteration >= plan.max_iterations()) {
+      break;
+    }
+    accum.reset();
+  }
+
+  katana::ReportStatSingle("PageRank", "Iterations", iteration);
+}
+
 katana::Result<void>
 ExtractValueFromTopoGraph(
     katana::PropertyGraph* pg, const std::string& output_property_name,
@@ -300,29 +394,66 @@ ExtractValueFromTopoGraph(
 katana::Result<void>
 PagerankPullTopological(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan) {
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation,
+    katana::analytics::AnalyticsWorkspace* workspace) {
   katana::EnsurePreallocated(2, 3 * pg->num_nodes() * sizeof(NodeData));
   katana::ReportPageAllocGuard page_alloc;
 
   // NUMA-awere temporary node data
-  katana::NUMAArray<PagerankValueAndOutDegreeTy> node_data;
-  node_data.allocateInterleaved(pg->num_nodes());
+  katana::NUMAArray<PagerankValueAndOutDegreeTy> local_node_data;
+  katana::NUMAArray<PagerankValueAndOutDegreeTy>& node_data =
+      *ArrayOrLocal(workspace, 0, pg->num_nodes(), &local_node_data);
 
   InitNodeDataTopological(*pg, &node_data);
-  ComputeOutDeg(*pg, &node_data);
+  ComputeOutDeg(*pg, &node_data, workspace);
 
   katana::StatTimer exec_time("PagerankPullTopological");
   exec_time.start();
-  ComputePRTopological(*pg, plan, &node_data);
+  ComputePRTopological(*pg, plan, &node_data, cancellation);
+  exec_time.stop();
+
+  if (cancellation && cancellation->IsCancelled()) {
+    return KATANA_ERROR(katana::ErrorCode::Cancelled, "pagerank cancelled");
+  }
+
+  return ExtractValueFromTopoGraph(pg, output_property_name, node_data);
+}
+
+katana::Result<void>
+PagerankPullBlocked(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation,
+    katana::analytics::AnalyticsWorkspace* workspace) {
+  katana::EnsurePreallocated(2, 5 * pg->num_nodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::NUMAArray<PagerankValueAndOutDegreeTy> local_node_data;
+  katana::NUMAArray<PagerankValueAndOutDegreeTy>& node_data =
+      *ArrayOrLocal(workspace, 0, pg->num_nodes(), &local_node_data);
+
+  InitNodeDataTopological(*pg, &node_data);
+  ComputeOutDeg(*pg, &node_data, workspace);
+
+  katana::StatTimer exec_time("PagerankPullBlocked");
+  exec_time.start();
+  ComputePRBlocked(*pg, plan, &node_data, workspace, cancellation);
   exec_time.stop();
 
+  if (cancellation && cancellation->IsCancelled()) {
+    return KATANA_ERROR(katana::ErrorCode::Cancelled, "pagerank cancelled");
+  }
+
   return ExtractValueFromTopoGraph(pg, output_property_name, node_data);
 }
 
 katana::Result<void>
 PagerankPullResidual(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan) {
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation,
+    katana::analytics::AnalyticsWorkspace* workspace) {
   katana::EnsurePreallocated(2, 3 * pg->num_nodes() * sizeof(NodeData));
   katana::ReportPageAllocGuard page_alloc;
 
@@ -338,18 +469,24 @@ PagerankPullResidual(
   }
   Graph graph = graph_result.value();
 
-  DeltaArray delta;
-  delta.allocateInterleaved(pg->num_nodes());
-  ResidualArray residual;
-  residual.allocateInterleaved(pg->num_nodes());
+  DeltaArray local_delta;
+  ResidualArray local_residual;
+  DeltaArray& delta =
+      *ArrayOrLocal(workspace, kDeltaSlot, pg->num_nodes(), &local_delta);
+  ResidualArray& residual = *ArrayOrLocal(
+      workspace, kResidualSlot, pg->num_nodes(), &local_residual);
 
   InitNodeDataResidual(&graph, delta, residual, plan);
-  ComputeOutDeg(&graph);
+  ComputeOutDeg(&graph, workspace);
 
   katana::StatTimer exec_time("PagerankPullResidual");
   exec_time.start();
-  ComputePRResidual(&graph, delta, residual, plan);
+  ComputePRResidual(&graph, delta, residual, plan, cancellation);
   exec_time.stop();
 
+  if (cancellation && cancellation->IsCancelled()) {
+    return KATANA_ERROR(katana::ErrorCode::Cancelled, "pagerank cancelled");
+  }
+
   return katana::ResultSuccess();
 }
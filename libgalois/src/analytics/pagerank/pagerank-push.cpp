@@ -17,6 +17,8 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <cmath>
+
 #include "katana/AtomicHelpers.h"
 #include "katana/Properties.h"
 #include "katana/TypedPropertyGraph.h"
@@ -45,12 +47,55 @@ InitializeNodeResidual(Graph& graph, katana::analytics::PagerankPlan plan) {
       katana::no_stats(), katana::loopname("Initialize"));
 }
 
+/// Push the residuals of the nodes of range, and those they raise above the
+/// tolerance, until no residual is above the tolerance. Residuals may be
+/// negative after the graph changed; see PagerankPushAsynchronousWarmStart.
+template <typename Range>
+void
+PushResidualsAsynchronous(
+    Graph& graph, const Range& range, katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation) {
+  typedef katana::PerSocketChunkFIFO<
+      katana::analytics::PagerankPlan::kChunkSize>
+      WL;
+  katana::for_each(
+      range,
+      [&](const GNode& src, auto& ctx) {
+        auto& src_residual = graph.GetData<NodeResidual>(src);
+        if (std::abs(src_residual.load()) > plan.tolerance()) {
+          PRTy old_residual = src_residual.exchange(0.0);
+          auto& src_value = graph.GetData<NodeValue>(src);
+          src_value += old_residual;
+          int src_nout = graph.edges(src).size();
+          if (src_nout > 0) {
+            PRTy delta = old_residual * plan.alpha() / src_nout;
+            //! For each out-going neighbors.
+            for (const auto& jj : graph.edges(src)) {
+              auto dest = graph.GetEdgeDest(jj);
+              auto& dest_residual = graph.GetData<NodeResidual>(dest);
+              if (delta != 0) {
+                auto old = atomicAdd(dest_residual, delta);
+                if ((std::abs(old) < plan.tolerance()) &&
+                    (std::abs(old + delta) >= plan.tolerance())) {
+                  ctx.push(*dest);
+                }
+              }
+            }
+          }
+        }
+      },
+      katana::loopname("PushResidualAsynchronous"),
+      katana::disable_conflict_detection(), katana::wl<WL>(),
+      katana::cancellation(cancellation));
+}
+
 }  // namespace
 
 katana::Result<void>
 PagerankPushAsynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan) {
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation) {
   katana::EnsurePreallocated(5, 5 * pg->num_nodes() * sizeof(NodeData));
   katana::ReportPageAllocGuard page_alloc;
 
@@ -71,45 +116,84 @@ PagerankPushAsynchronous(
 
   InitializeNodeResidual(graph, plan);
 
-  typedef katana::PerSocketChunkFIFO<
-      katana::analytics::PagerankPlan::kChunkSize>
-      WL;
-  katana::for_each(
+  PushResidualsAsynchronous(graph, katana::iterate(graph), plan, cancellation);
+
+  if (cancellation && cancellation->IsCancelled()) {
+    return KATANA_ERROR(katana::ErrorCode::Cancelled, "pagerank cancelled");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+PagerankPushAsynchronousWarmStart(
+    katana::PropertyGraph* pg, const std::string& rank_property_name,
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation) {
+  katana::EnsurePreallocated(5, 5 * pg->num_nodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{pg};
+
+  KATANA_CHECKED(
+      katana::analytics::ConstructNodeProperties<std::tuple<NodeResidual>>(
+          pg, {temporary_property.name()}));
+  Graph graph = KATANA_CHECKED(
+      Graph::Make(pg, {rank_property_name, temporary_property.name()}, {}));
+
+  // The residual of a node is the rank it would get from one more round of
+  // the ranks of its in neighbors minus its rank: zero everywhere for
+  // converged ranks, and non-zero only around the changes otherwise.
+  katana::do_all(
       katana::iterate(graph),
-      [&](const GNode& src, auto& ctx) {
-        auto& src_residual = graph.GetData<NodeResidual>(src);
-        if (src_residual > plan.tolerance()) {
-          PRTy old_residual = src_residual.exchange(0.0);
-          auto& src_value = graph.GetData<NodeValue>(src);
-          src_value += old_residual;
-          int src_nout = graph.edges(src).size();
-          if (src_nout > 0) {
-            PRTy delta = old_residual * plan.alpha() / src_nout;
-            //! For each out-going neighbors.
-            for (const auto& jj : graph.edges(src)) {
-              auto dest = graph.GetEdgeDest(jj);
-              auto& dest_residual = graph.GetData<NodeResidual>(dest);
-              if (delta > 0) {
-                auto old = atomicAdd(dest_residual, delta);
-                if ((old < plan.tolerance()) &&
-                    (old + delta >= plan.tolerance())) {
-                  ctx.push(*dest);
-                }
-              }
-            }
-          }
+      [&](const GNode& n) {
+        graph.GetData<NodeResidual>(n) =
+            plan.initial_residual() - graph.GetData<NodeValue>(n);
+      },
+      katana::no_stats(), katana::loopname("InitializeWarmStart"));
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& src) {
+        int src_nout = graph.edges(src).size();
+        if (src_nout == 0) {
+          return;
+        }
+        PRTy delta = graph.GetData<NodeValue>(src) * plan.alpha() / src_nout;
+        for (const auto& jj : graph.edges(src)) {
+          atomicAdd(graph.GetData<NodeResidual>(graph.GetEdgeDest(jj)), delta);
         }
       },
-      katana::loopname("PushResidualAsynchronous"),
-      katana::disable_conflict_detection(), katana::wl<WL>());
+      katana::steal(), katana::no_stats(),
+      katana::loopname("ComputeWarmStartResidual"));
 
+  katana::InsertBag<GNode> active_nodes;
+  katana::GAccumulator<uint64_t> num_active;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (std::abs(graph.GetData<NodeResidual>(n).load()) >
+            plan.tolerance()) {
+          active_nodes.push(n);
+          num_active += 1;
+        }
+      },
+      katana::no_stats(), katana::loopname("FindWarmStartActive"));
+  katana::ReportStatSingle(
+      "PagerankWarmStart", "ActiveNodes", num_active.reduce());
+
+  PushResidualsAsynchronous(
+      graph, katana::iterate(active_nodes), plan, cancellation);
+
+  if (cancellation && cancellation->IsCancelled()) {
+    return KATANA_ERROR(katana::ErrorCode::Cancelled, "pagerank cancelled");
+  }
   return katana::ResultSuccess();
 }
 
 katana::Result<void>
 PagerankPushSynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan) {
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation) {
   katana::EnsurePreallocated(5, 5 * pg->num_nodes() * sizeof(NodeData));
   katana::ReportPageAllocGuard page_alloc;
 
@@ -147,6 +231,9 @@ PagerankPushSynchronous(
 
   size_t iter = 0;
   for (; !active_nodes.empty() && iter < plan.max_iterations(); ++iter) {
+    if (cancellation && cancellation->IsCancelled()) {
+      return KATANA_ERROR(katana::ErrorCode::Cancelled, "pagerank cancelled");
+    }
     katana::do_all(
         katana::iterate(active_nodes),
         [&](const GNode& src) {
@@ -167,6 +254,8 @@ PagerankPushSynchronous(
 
             //! Edge tiling for large outdegree nodes.
             if ((end - beg) > kEdgeTileSize) {
+              //! Read an out-of-core node's edges ahead of its tiles.
+              graph.PrefetchEdges(src, src + 1);
               for (; beg + kEdgeTileSize < end;) {
                 auto ne = beg + kEdgeTileSize;
                 updates.push(Update{delta, beg, ne});
@@ -181,7 +270,8 @@ PagerankPushSynchronous(
         },
         katana::steal(),
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
-        katana::loopname("CreateEdgeTiles"), katana::no_stats());
+        katana::loopname("CreateEdgeTiles"), katana::no_stats(),
+        katana::cancellation(cancellation));
 
     active_nodes.clear();
 
@@ -204,9 +294,13 @@ PagerankPushSynchronous(
         },
         katana::steal(),
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
-        katana::loopname("PushResidualSynchronous"));
+        katana::loopname("PushResidualSynchronous"),
+        katana::cancellation(cancellation));
 
     updates.clear();
   }
+  if (cancellation && cancellation->IsCancelled()) {
+    return KATANA_ERROR(katana::ErrorCode::Cancelled, "pagerank cancelled");
+  }
   return katana::ResultSuccess();
 }
@@ -17,27 +17,73 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include "../gpu/gpu.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
 
 katana::Result<void>
 katana::analytics::Pagerank(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan) {
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation,
+    katana::analytics::AnalyticsWorkspace* workspace,
+    katana::analytics::AnalyticsResultCache* cache) {
+  if (cache) {
+    return cache->GetOrCompute(
+        pg, "Pagerank",
+        fmt::format(
+            "{} {} {} {} {}", static_cast<int>(plan.architecture()),
+            static_cast<int>(plan.algorithm()), plan.tolerance(),
+            plan.max_iterations(), plan.alpha()),
+        output_property_name, [&]() {
+          return Pagerank(
+              pg, output_property_name, plan, cancellation, workspace);
+        });
+  }
+  if (plan.architecture() == katana::analytics::kGPU) {
+    return katana::analytics::internal::GpuPagerank(
+        pg, output_property_name, plan, cancellation);
+  }
+  // Pull sweeps the nodes in order; push follows the active nodes.
+  bool is_pull = plan.algorithm() == PagerankPlan::kPullResidual ||
+                 plan.algorithm() == PagerankPlan::kPullTopological ||
+                 plan.algorithm() == PagerankPlan::kPullBlocked;
+  katana::analytics::TopologyAccessGuard access(
+      pg, is_pull ? GraphTopology::AccessPattern::kSequential
+                  : GraphTopology::AccessPattern::kRandom);
   switch (plan.algorithm()) {
   case PagerankPlan::kPullResidual:
-    return PagerankPullResidual(pg, output_property_name, plan);
+    return PagerankPullResidual(
+        pg, output_property_name, plan, cancellation, workspace);
   case PagerankPlan::kPullTopological:
-    return PagerankPullTopological(pg, output_property_name, plan);
+    return PagerankPullTopological(
+        pg, output_property_name, plan, cancellation, workspace);
+  case PagerankPlan::kPullBlocked:
+    return PagerankPullBlocked(
+        pg, output_property_name, plan, cancellation, workspace);
   case PagerankPlan::kPushAsynchronous:
-    return PagerankPushAsynchronous(pg, output_property_name, plan);
+    return PagerankPushAsynchronous(
+        pg, output_property_name, plan, cancellation);
   case PagerankPlan::kPushSynchronous:
-    return PagerankPushSynchronous(pg, output_property_name, plan);
+    return PagerankPushSynchronous(
+        pg, output_property_name, plan, cancellation);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<void>
+katana::analytics::PagerankUpdate(
+    katana::PropertyGraph* pg, const std::string& rank_property_name,
+    katana::analytics::PagerankPlan plan,
+    const katana::CancellationToken* cancellation) {
+  katana::analytics::TopologyAccessGuard access(
+      pg, GraphTopology::AccessPattern::kRandom);
+  return PagerankPushAsynchronousWarmStart(
+      pg, rank_property_name, plan, cancellation);
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::PagerankAssertValid(
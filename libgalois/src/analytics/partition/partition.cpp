@@ -0,0 +1,1341 @@
+#include "katana/analytics/partition/partition.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using Node = BiDirView::Node;
+
+struct NodePartition : public katana::PODProperty<uint32_t> {};
+
+using PartitionGraph =
+    katana::TypedPropertyGraph<std::tuple<NodePartition>, std::tuple<>>;
+
+constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+/// The rounds of proposals of a heavy edge matching
+constexpr uint32_t kMatchingRounds = 4;
+
+/// Coarsening stops at a level that keeps more than this fraction of the
+/// nodes of the level before it
+constexpr double kMinCoarseningRatio = 0.95;
+
+/// A coarse node may weigh up to this many times the average weight of a
+/// node of the coarsest level
+constexpr double kMaxCoarseNodeWeightFactor = 1.5;
+
+/// Hyperedges with more pins than this are left out of the ratings of
+/// coarsening and the clique expansion of the coarsest hypergraph: they
+/// hardly constrain a partition and would cost the square of their size
+constexpr uint64_t kMaxRatedHyperedgeSize = 1000;
+
+/// A hyperedge h adds w(h) / (|h| - 1) times this to the rating of each
+/// pair of its pins
+constexpr uint64_t kRatingScale = uint64_t{1} << 16;
+
+/// A graph of the multilevel hierarchy: undirected, with weighted nodes and
+/// edges, in CSR form with an edge each way between neighbors
+struct Level {
+  katana::NUMAArray<uint64_t> edge_begin;
+  katana::NUMAArray<uint32_t> edge_dest;
+  katana::NUMAArray<uint64_t> edge_weight;
+  katana::NUMAArray<uint64_t> node_weight;
+
+  size_t num_nodes() const { return node_weight.size(); }
+};
+
+using Neighbors = std::vector<std::pair<uint32_t, uint64_t>>;
+
+/// Build a level with the given node weights. degree_bound(n) bounds the
+/// number of edges of n, and for_each_neighbor(n, add) calls add(dest,
+/// weight) for each of them; edges to the same dest are merged into one
+/// and loops are dropped.
+template <typename DegreeBound, typename ForEachNeighbor>
+Level
+BuildLevel(
+    katana::NUMAArray<uint64_t> node_weight, const DegreeBound& degree_bound,
+    const ForEachNeighbor& for_each_neighbor) {
+  const size_t num_nodes = node_weight.size();
+
+  // merge the edges of each node into its slots of the bounded degree
+  katana::NUMAArray<uint64_t> bound_begin;
+  bound_begin.allocateBlocked(num_nodes + 1);
+  bound_begin[0] = 0;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { bound_begin[n + 1] = degree_bound(n); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      bound_begin.begin(), bound_begin.end(), bound_begin.begin());
+
+  katana::NUMAArray<uint32_t> bound_dest;
+  katana::NUMAArray<uint64_t> bound_weight;
+  bound_dest.allocateBlocked(bound_begin[num_nodes]);
+  bound_weight.allocateBlocked(bound_begin[num_nodes]);
+
+  Level level;
+  level.edge_begin.allocateBlocked(num_nodes + 1);
+  level.edge_begin[0] = 0;
+  katana::PerThreadStorage<Neighbors> neighbors;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        Neighbors& ns = *neighbors.getLocal();
+        ns.clear();
+        for_each_neighbor(n, [&](uint32_t dest, uint64_t weight) {
+          if (dest != n) {
+            ns.emplace_back(dest, weight);
+          }
+        });
+        std::sort(ns.begin(), ns.end());
+        uint64_t out = bound_begin[n];
+        for (size_t i = 0; i < ns.size(); ++i) {
+          if (i > 0 && ns[i].first == ns[i - 1].first) {
+            bound_weight[out - 1] += ns[i].second;
+          } else {
+            bound_dest[out] = ns[i].first;
+            bound_weight[out] = ns[i].second;
+            ++out;
+          }
+        }
+        level.edge_begin[n + 1] = out - bound_begin[n];
+      },
+      katana::steal(), katana::no_stats());
+
+  // and compact them
+  katana::ParallelSTL::partial_sum(
+      level.edge_begin.begin(), level.edge_begin.end(),
+      level.edge_begin.begin());
+  level.edge_dest.allocateBlocked(level.edge_begin[num_nodes]);
+  level.edge_weight.allocateBlocked(level.edge_begin[num_nodes]);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        uint64_t from = bound_begin[n];
+        for (uint64_t e = level.edge_begin[n]; e < level.edge_begin[n + 1];
+             ++e, ++from) {
+          level.edge_dest[e] = bound_dest[from];
+          level.edge_weight[e] = bound_weight[from];
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  level.node_weight = std::move(node_weight);
+  return level;
+}
+
+/// \returns the finest level: the graph of view with its edge directions
+/// dropped, where the weight of an edge is the number of edges of view
+/// between its ends, and every node weighs 1
+Level
+BaseLevel(const BiDirView& view) {
+  katana::NUMAArray<uint64_t> node_weight;
+  node_weight.allocateBlocked(view.num_nodes());
+  katana::ParallelSTL::fill(node_weight.begin(), node_weight.end(), 1);
+  return BuildLevel(
+      std::move(node_weight),
+      [&](Node n) { return view.degree(n) + view.in_degree(n); },
+      [&](Node n, const auto& add) {
+        for (auto e : view.edges(n)) {
+          add(view.edge_dest(e), 1);
+        }
+        for (auto e : view.in_edges(n)) {
+          add(view.in_edge_dest(e), 1);
+        }
+      });
+}
+
+/// \returns a hash of the edge between a and b, the same both ways, which
+/// orders edges of the same weight
+uint64_t
+EdgeHash(uint32_t a, uint32_t b, uint64_t seed) {
+  uint64_t x = (uint64_t{std::min(a, b)} << 32 | std::max(a, b)) +
+               seed * 0x9e3779b97f4a7c15;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+/// Match the nodes of a level in pairs by parallel mutual proposals. In each
+/// round, every unmatched node proposes to the unmatched neighbor it rates
+/// highest (among the neighbors it can be merged with without weighing more
+/// than max_node_weight), and the nodes that propose to each other are
+/// matched, so the pair rated highest left is matched in every round.
+/// for_each_rated(n, add) calls add(v, rating) once for each neighbor v of
+/// n. \returns the node each node is matched with, or kNone.
+template <typename ForEachRated>
+katana::NUMAArray<uint32_t>
+Match(
+    const katana::NUMAArray<uint64_t>& node_weight, uint64_t max_node_weight,
+    uint64_t seed, const ForEachRated& for_each_rated) {
+  const size_t num_nodes = node_weight.size();
+  katana::NUMAArray<uint32_t> match;
+  katana::NUMAArray<uint32_t> proposal;
+  match.allocateBlocked(num_nodes);
+  proposal.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(match.begin(), match.end(), kNone);
+
+  for (uint32_t round = 0; round < kMatchingRounds; ++round) {
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          proposal[n] = kNone;
+          if (match[n] != kNone) {
+            return;
+          }
+          std::pair<uint64_t, uint64_t> best{0, 0};
+          for_each_rated(n, [&](uint32_t v, uint64_t rating) {
+            if (match[v] != kNone ||
+                node_weight[n] + node_weight[v] > max_node_weight) {
+              return;
+            }
+            std::pair<uint64_t, uint64_t> key{rating, EdgeHash(n, v, seed)};
+            if (key > best) {
+              best = key;
+              proposal[n] = v;
+            }
+          });
+        },
+        katana::steal(), katana::no_stats());
+
+    katana::GAccumulator<size_t> matched;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          uint32_t v = proposal[n];
+          if (v != kNone && proposal[v] == n) {
+            match[n] = v;
+            matched += 1;
+          }
+        },
+        katana::no_stats());
+    if (matched.reduce() == 0) {
+      break;
+    }
+  }
+  return match;
+}
+
+/// Number the matched pairs and unmatched nodes of match by their smaller
+/// node. Sets coarse_of to the number of each node, the members of coarse
+/// node c to members[2 * c] and members[2 * c + 1] (kNone if c is a single
+/// node) and coarse_weight to the weights of the coarse nodes.
+void
+NumberPairs(
+    const katana::NUMAArray<uint32_t>& match,
+    const katana::NUMAArray<uint64_t>& node_weight,
+    katana::NUMAArray<uint32_t>* coarse_of,
+    katana::NUMAArray<uint32_t>* members,
+    katana::NUMAArray<uint64_t>* coarse_weight) {
+  const size_t num_nodes = node_weight.size();
+  auto is_representative = [&](size_t n) {
+    return match[n] == kNone || n < match[n];
+  };
+  katana::NUMAArray<uint32_t> coarse_id;
+  coarse_id.allocateBlocked(num_nodes + 1);
+  coarse_id[0] = 0;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { coarse_id[n + 1] = is_representative(n); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      coarse_id.begin(), coarse_id.end(), coarse_id.begin());
+  const size_t num_coarse = coarse_id[num_nodes];
+
+  coarse_of->allocateBlocked(num_nodes);
+  members->allocateBlocked(2 * num_coarse);
+  coarse_weight->allocateBlocked(num_coarse);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        if (is_representative(n)) {
+          uint32_t c = coarse_id[n];
+          (*coarse_of)[n] = c;
+          (*members)[2 * c] = n;
+          (*members)[2 * c + 1] = match[n];
+          (*coarse_weight)[c] =
+              node_weight[n] + (match[n] == kNone ? 0 : node_weight[match[n]]);
+        } else {
+          (*coarse_of)[n] = coarse_id[match[n]];
+        }
+      },
+      katana::no_stats());
+}
+
+/// Coarsen fine by parallel heavy edge matching, rating a neighbor by the
+/// weight of the edge to it. \returns the level of the matched pairs and
+/// unmatched nodes, and sets coarse_of to the node of that level of each
+/// node of fine.
+Level
+Coarsen(
+    const Level& fine, uint64_t max_node_weight, uint64_t seed,
+    katana::NUMAArray<uint32_t>* coarse_of) {
+  auto match = Match(
+      fine.node_weight, max_node_weight, seed,
+      [&](size_t n, const auto& add) {
+        for (uint64_t e = fine.edge_begin[n]; e < fine.edge_begin[n + 1];
+             ++e) {
+          add(fine.edge_dest[e], fine.edge_weight[e]);
+        }
+      });
+
+  katana::NUMAArray<uint32_t> members;
+  katana::NUMAArray<uint64_t> coarse_weight;
+  NumberPairs(match, fine.node_weight, coarse_of, &members, &coarse_weight);
+
+  auto fine_degree = [&](uint32_t n) {
+    return n == kNone ? 0 : fine.edge_begin[n + 1] - fine.edge_begin[n];
+  };
+  return BuildLevel(
+      std::move(coarse_weight),
+      [&](size_t c) {
+        return fine_degree(members[2 * c]) + fine_degree(members[2 * c + 1]);
+      },
+      [&](size_t c, const auto& add) {
+        for (uint32_t n : {members[2 * c], members[2 * c + 1]}) {
+          if (n == kNone) {
+            continue;
+          }
+          for (uint64_t e = fine.edge_begin[n]; e < fine.edge_begin[n + 1];
+               ++e) {
+            add((*coarse_of)[fine.edge_dest[e]], fine.edge_weight[e]);
+          }
+        }
+      });
+}
+
+/// Partition level by greedy graph growing. Each partition in turn grows
+/// from the first unassigned node in breadth-first order, adding the
+/// unassigned node with the heaviest edges into it, until it weighs its
+/// share of the weight left; the last partition takes the rest.
+katana::NUMAArray<uint32_t>
+GrowPartitions(
+    const Level& level, uint32_t num_partitions,
+    uint64_t max_partition_weight) {
+  const size_t num_nodes = level.num_nodes();
+  katana::NUMAArray<uint32_t> part;
+  part.allocateBlocked(num_nodes);
+  std::fill(part.begin(), part.end(), kNone);
+
+  std::vector<uint32_t> order;
+  order.reserve(num_nodes);
+  {
+    std::vector<uint8_t> visited(num_nodes, 0);
+    for (size_t s = 0; s < num_nodes; ++s) {
+      if (visited[s]) {
+        continue;
+      }
+      visited[s] = 1;
+      order.emplace_back(s);
+      for (size_t i = order.size() - 1; i < order.size(); ++i) {
+        uint32_t n = order[i];
+        for (uint64_t e = level.edge_begin[n]; e < level.edge_begin[n + 1];
+             ++e) {
+          uint32_t v = level.edge_dest[e];
+          if (!visited[v]) {
+            visited[v] = 1;
+            order.emplace_back(v);
+          }
+        }
+      }
+    }
+  }
+
+  uint64_t weight_left = 0;
+  for (size_t n = 0; n < num_nodes; ++n) {
+    weight_left += level.node_weight[n];
+  }
+
+  std::vector<uint64_t> connection(num_nodes, 0);
+  std::vector<uint32_t> touched;
+  std::vector<std::pair<uint64_t, uint32_t>> heap;
+  size_t next_seed = 0;
+  for (uint32_t p = 0; p + 1 < num_partitions; ++p) {
+    const uint64_t target = weight_left / (num_partitions - p);
+    uint64_t weight = 0;
+    heap.clear();
+    while (weight < target) {
+      if (heap.empty()) {
+        while (next_seed < num_nodes && part[order[next_seed]] != kNone) {
+          ++next_seed;
+        }
+        if (next_seed == num_nodes ||
+            (weight > 0 && weight + level.node_weight[order[next_seed]] >
+                               max_partition_weight)) {
+          break;
+        }
+        heap.emplace_back(0, order[next_seed]);
+      }
+      std::pop_heap(heap.begin(), heap.end());
+      auto [c, n] = heap.back();
+      heap.pop_back();
+      if (part[n] != kNone || c != connection[n] ||
+          (weight > 0 &&
+           weight + level.node_weight[n] > max_partition_weight)) {
+        continue;
+      }
+      part[n] = p;
+      weight += level.node_weight[n];
+      for (uint64_t e = level.edge_begin[n]; e < level.edge_begin[n + 1];
+           ++e) {
+        uint32_t v = level.edge_dest[e];
+        if (part[v] == kNone) {
+          if (connection[v] == 0) {
+            touched.emplace_back(v);
+          }
+          connection[v] += level.edge_weight[e];
+          heap.emplace_back(connection[v], v);
+          std::push_heap(heap.begin(), heap.end());
+        }
+      }
+    }
+    weight_left -= weight;
+    for (uint32_t v : touched) {
+      connection[v] = 0;
+    }
+    touched.clear();
+  }
+  for (size_t n = 0; n < num_nodes; ++n) {
+    if (part[n] == kNone) {
+      part[n] = num_partitions - 1;
+    }
+  }
+  return part;
+}
+
+/// Add w to *weight if the sum stays within max. \returns whether it did.
+bool
+TryAddWeight(std::atomic<uint64_t>* weight, uint64_t w, uint64_t max) {
+  uint64_t cur = weight->load(std::memory_order_relaxed);
+  while (cur + w <= max) {
+    if (weight->compare_exchange_weak(
+            cur, cur + w, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Subtract w from *weight if it is above max. \returns whether it did.
+bool
+TrySubtractOverweight(std::atomic<uint64_t>* weight, uint64_t w, uint64_t max) {
+  uint64_t cur = weight->load(std::memory_order_relaxed);
+  while (cur > max) {
+    if (weight->compare_exchange_weak(
+            cur, cur - w, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// The weights of the partitions of the nodes with the given weights
+katana::NUMAArray<std::atomic<uint64_t>>
+PartitionWeights(
+    const katana::NUMAArray<uint64_t>& node_weight, uint32_t num_partitions,
+    const katana::NUMAArray<uint32_t>& part) {
+  katana::PerThreadStorage<std::vector<uint64_t>> local_weights;
+  katana::do_all(
+      katana::iterate(size_t{0}, node_weight.size()),
+      [&](size_t n) {
+        std::vector<uint64_t>& weights = *local_weights.getLocal();
+        if (weights.empty()) {
+          weights.resize(num_partitions, 0);
+        }
+        weights[part[n]] += node_weight[n];
+      },
+      katana::no_stats());
+
+  katana::NUMAArray<std::atomic<uint64_t>> part_weight;
+  part_weight.allocateInterleaved(num_partitions);
+  for (uint32_t p = 0; p < num_partitions; ++p) {
+    uint64_t weight = 0;
+    for (const std::vector<uint64_t>& weights : local_weights) {
+      weight += weights.empty() ? 0 : weights[p];
+    }
+    part_weight.constructAt(p, weight);
+  }
+  return part_weight;
+}
+
+/// The connection of a node to each partition
+struct Connections {
+  std::vector<uint64_t> weight;
+  std::vector<uint32_t> partitions;
+
+  void Add(uint32_t p, uint64_t w) {
+    if (weight[p] == 0) {
+      partitions.emplace_back(p);
+    }
+    weight[p] += w;
+  }
+};
+
+/// Improve the partition part of the nodes with the given weights by rounds
+/// of parallel label propagation. A round has two passes: in the first nodes
+/// only move to higher partitions and in the second only to lower ones, so
+/// neighbors cannot swap partitions in the same pass. A pass decides the
+/// moves on the partition left by the pass before it, and the partition
+/// weights, updated atomically, keep every partition that a node moves into
+/// within max_partition_weight.
+///
+/// prepare(part) is called before each pass, and connect(n, from, conn)
+/// adds the connection of node n to the partitions it has neighbors in to
+/// conn and returns its connection to its own partition from, so that
+/// moving to partition p gains conn.weight[p] less that.
+template <typename Prepare, typename Connect>
+void
+RefinePartition(
+    const katana::NUMAArray<uint64_t>& node_weight, uint32_t num_partitions,
+    uint64_t max_partition_weight, uint32_t rounds,
+    katana::NUMAArray<uint32_t>* part, const Prepare& prepare,
+    const Connect& connect) {
+  const size_t num_nodes = node_weight.size();
+  auto part_weight = PartitionWeights(node_weight, num_partitions, *part);
+  katana::NUMAArray<uint32_t> next;
+  next.allocateBlocked(num_nodes);
+  katana::PerThreadStorage<Connections> connections;
+
+  for (uint32_t round = 0; round < rounds; ++round) {
+    size_t num_moved = 0;
+    for (bool up : {true, false}) {
+      auto allowed = [&](uint32_t from, uint32_t to) {
+        return up ? to > from : to < from;
+      };
+      prepare(*part);
+      katana::GAccumulator<size_t> moved;
+      katana::do_all(
+          katana::iterate(size_t{0}, num_nodes),
+          [&](size_t n) {
+            const uint32_t from = (*part)[n];
+            const uint64_t w = node_weight[n];
+            next[n] = from;
+
+            Connections& conn = *connections.getLocal();
+            if (conn.weight.empty()) {
+              conn.weight.resize(num_partitions, 0);
+            }
+            const int64_t from_connection = connect(n, from, &conn);
+
+            // a node of an overweight partition takes the best move even if
+            // it cuts more edges, and may move to a partition it has no
+            // edges to
+            const bool overweight =
+                part_weight[from].load(std::memory_order_relaxed) >
+                max_partition_weight;
+            uint32_t best = from;
+            int64_t best_gain = overweight ? -from_connection - 1 : 0;
+            for (uint32_t p : conn.partitions) {
+              int64_t gain = static_cast<int64_t>(conn.weight[p]) -
+                             from_connection;
+              if (p != from && allowed(from, p) && gain > best_gain &&
+                  part_weight[p].load(std::memory_order_relaxed) + w <=
+                      max_partition_weight) {
+                best = p;
+                best_gain = gain;
+              }
+            }
+            if (overweight && best == from) {
+              uint64_t lightest = max_partition_weight;
+              for (uint32_t p = 0; p < num_partitions; ++p) {
+                uint64_t p_weight =
+                    part_weight[p].load(std::memory_order_relaxed);
+                if (allowed(from, p) && p_weight + w <= lightest) {
+                  best = p;
+                  lightest = p_weight + w;
+                }
+              }
+            }
+
+            for (uint32_t p : conn.partitions) {
+              conn.weight[p] = 0;
+            }
+            conn.partitions.clear();
+            if (best == from) {
+              return;
+            }
+
+            if (!overweight) {
+              if (!TryAddWeight(&part_weight[best], w, max_partition_weight)) {
+                return;
+              }
+              part_weight[from].fetch_sub(w, std::memory_order_relaxed);
+            } else {
+              if (!TrySubtractOverweight(
+                      &part_weight[from], w, max_partition_weight)) {
+                return;
+              }
+              if (!TryAddWeight(&part_weight[best], w, max_partition_weight)) {
+                part_weight[from].fetch_add(w, std::memory_order_relaxed);
+                return;
+              }
+            }
+            next[n] = best;
+            moved += 1;
+          },
+          katana::steal(), katana::no_stats());
+      std::swap(*part, next);
+      num_moved += moved.reduce();
+    }
+    if (num_moved == 0) {
+      break;
+    }
+  }
+}
+
+/// Refine the partition of a graph, where the connection of a node to a
+/// partition is the weight of its edges into it, so that a move gains the
+/// reduction of the edge cut
+void
+Refine(
+    const Level& level, uint32_t num_partitions, uint64_t max_partition_weight,
+    uint32_t rounds, katana::NUMAArray<uint32_t>* part) {
+  RefinePartition(
+      level.node_weight, num_partitions, max_partition_weight, rounds, part,
+      [](const katana::NUMAArray<uint32_t>&) {},
+      [&](size_t n, uint32_t from, Connections* conn) {
+        for (uint64_t e = level.edge_begin[n]; e < level.edge_begin[n + 1];
+             ++e) {
+          conn->Add((*part)[level.edge_dest[e]], level.edge_weight[e]);
+        }
+        return static_cast<int64_t>(conn->weight[from]);
+      });
+}
+
+/// A hypergraph of the multilevel hierarchy, with weighted nodes and
+/// hyperedges: the pins of hyperedge h are hedge_pins[hedge_begin[h],
+/// hedge_begin[h + 1]) and the hyperedges of node n are
+/// node_hedges[node_begin[n], node_begin[n + 1])
+struct HyperLevel {
+  katana::NUMAArray<uint64_t> hedge_begin;
+  katana::NUMAArray<uint32_t> hedge_pins;
+  katana::NUMAArray<uint64_t> hedge_weight;
+  katana::NUMAArray<uint64_t> node_begin;
+  katana::NUMAArray<uint32_t> node_hedges;
+  katana::NUMAArray<uint64_t> node_weight;
+
+  size_t num_nodes() const { return node_weight.size(); }
+  size_t num_hedges() const { return hedge_weight.size(); }
+  uint64_t hedge_size(size_t h) const {
+    return hedge_begin[h + 1] - hedge_begin[h];
+  }
+};
+
+/// Fill in the hyperedges of each node of level from the pins of its
+/// hyperedges, in increasing order
+void
+BuildIncidence(HyperLevel* level) {
+  const size_t num_nodes = level->num_nodes();
+  const size_t num_hedges = level->num_hedges();
+  katana::NUMAArray<std::atomic<uint64_t>> cursor;
+  cursor.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { cursor.constructAt(n, 0); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(size_t{0}, num_hedges),
+      [&](size_t h) {
+        for (uint64_t i = level->hedge_begin[h]; i < level->hedge_begin[h + 1];
+             ++i) {
+          cursor[level->hedge_pins[i]].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  level->node_begin.allocateBlocked(num_nodes + 1);
+  level->node_begin[0] = 0;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { level->node_begin[n + 1] = cursor[n].load(); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      level->node_begin.begin(), level->node_begin.end(),
+      level->node_begin.begin());
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { cursor[n].store(level->node_begin[n]); },
+      katana::no_stats());
+
+  level->node_hedges.allocateBlocked(level->node_begin[num_nodes]);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_hedges),
+      [&](size_t h) {
+        for (uint64_t i = level->hedge_begin[h]; i < level->hedge_begin[h + 1];
+             ++i) {
+          uint64_t slot = cursor[level->hedge_pins[i]].fetch_add(
+              1, std::memory_order_relaxed);
+          level->node_hedges[slot] = h;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        std::sort(
+            level->node_hedges.begin() + level->node_begin[n],
+            level->node_hedges.begin() + level->node_begin[n + 1]);
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// Build a hypergraph level with the given node weights from num_hedges
+/// hyperedges. size_bound(h) bounds the number of pins of h,
+/// for_each_pin(h, add) calls add(pin) for each of them, and
+/// hedge_weight(h) is the weight of h; pins repeated in a hyperedge are
+/// merged, and hyperedges left with fewer than two pins, which no partition
+/// cuts, are dropped.
+template <typename SizeBound, typename ForEachPin, typename HedgeWeight>
+HyperLevel
+BuildHyperLevel(
+    katana::NUMAArray<uint64_t> node_weight, size_t num_hedges,
+    const SizeBound& size_bound, const ForEachPin& for_each_pin,
+    const HedgeWeight& hedge_weight) {
+  katana::NUMAArray<uint64_t> bound_begin;
+  bound_begin.allocateBlocked(num_hedges + 1);
+  bound_begin[0] = 0;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_hedges),
+      [&](size_t h) { bound_begin[h + 1] = size_bound(h); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      bound_begin.begin(), bound_begin.end(), bound_begin.begin());
+
+  // merge the pins of each hyperedge in its slots of the bounded size,
+  // counting the hyperedges kept and their pins
+  katana::NUMAArray<uint32_t> bound_pins;
+  bound_pins.allocateBlocked(bound_begin[num_hedges]);
+  katana::NUMAArray<uint64_t> kept_id;
+  katana::NUMAArray<uint64_t> pin_begin;
+  kept_id.allocateBlocked(num_hedges + 1);
+  pin_begin.allocateBlocked(num_hedges + 1);
+  kept_id[0] = 0;
+  pin_begin[0] = 0;
+  katana::PerThreadStorage<std::vector<uint32_t>> local_pins;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_hedges),
+      [&](size_t h) {
+        std::vector<uint32_t>& pins = *local_pins.getLocal();
+        pins.clear();
+        for_each_pin(h, [&](uint32_t pin) { pins.emplace_back(pin); });
+        std::sort(pins.begin(), pins.end());
+        pins.erase(std::unique(pins.begin(), pins.end()), pins.end());
+        const bool kept = pins.size() >= 2;
+        kept_id[h + 1] = kept;
+        pin_begin[h + 1] = kept ? pins.size() : 0;
+        if (kept) {
+          std::copy(
+              pins.begin(), pins.end(), bound_pins.begin() + bound_begin[h]);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      kept_id.begin(), kept_id.end(), kept_id.begin());
+  katana::ParallelSTL::partial_sum(
+      pin_begin.begin(), pin_begin.end(), pin_begin.begin());
+
+  // and compact them
+  const size_t num_kept = kept_id[num_hedges];
+  HyperLevel level;
+  level.hedge_begin.allocateBlocked(num_kept + 1);
+  level.hedge_pins.allocateBlocked(pin_begin[num_hedges]);
+  level.hedge_weight.allocateBlocked(num_kept);
+  level.hedge_begin[0] = 0;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_hedges),
+      [&](size_t h) {
+        if (kept_id[h + 1] == kept_id[h]) {
+          return;
+        }
+        const uint64_t id = kept_id[h];
+        level.hedge_begin[id + 1] = pin_begin[h + 1];
+        level.hedge_weight[id] = hedge_weight(h);
+        std::copy(
+            bound_pins.begin() + bound_begin[h],
+            bound_pins.begin() + bound_begin[h] + pin_begin[h + 1] -
+                pin_begin[h],
+            level.hedge_pins.begin() + pin_begin[h]);
+      },
+      katana::steal(), katana::no_stats());
+
+  level.node_weight = std::move(node_weight);
+  BuildIncidence(&level);
+  return level;
+}
+
+/// \returns the finest level of the hypergraph of topo whose first
+/// num_hedges nodes are hyperedges, with an edge to each of their pins,
+/// where every node and hyperedge weighs 1
+HyperLevel
+BaseHyperLevel(const katana::GraphTopology& topo, uint32_t num_hedges) {
+  katana::NUMAArray<uint64_t> node_weight;
+  node_weight.allocateBlocked(topo.num_nodes() - num_hedges);
+  katana::ParallelSTL::fill(node_weight.begin(), node_weight.end(), 1);
+  return BuildHyperLevel(
+      std::move(node_weight), num_hedges,
+      [&](Node h) { return topo.degree(h); },
+      [&](Node h, const auto& add) {
+        for (auto e : topo.edges(h)) {
+          add(topo.edge_dest(e) - num_hedges);
+        }
+      },
+      [](size_t) { return uint64_t{1}; });
+}
+
+/// Coarsen fine by parallel heavy edge matching, rating a pair of nodes by
+/// the sum of w(h) / (|h| - 1) over the hyperedges h they are both pins of,
+/// so that the pins of small and heavy hyperedges are merged first.
+/// \returns the level of the matched pairs and unmatched nodes, and sets
+/// coarse_of to the node of that level of each node of fine.
+HyperLevel
+Coarsen(
+    const HyperLevel& fine, uint64_t max_node_weight, uint64_t seed,
+    katana::NUMAArray<uint32_t>* coarse_of) {
+  katana::PerThreadStorage<Neighbors> local_ratings;
+  auto match = Match(
+      fine.node_weight, max_node_weight, seed,
+      [&](size_t n, const auto& add) {
+        Neighbors& ratings = *local_ratings.getLocal();
+        ratings.clear();
+        for (uint64_t i = fine.node_begin[n]; i < fine.node_begin[n + 1];
+             ++i) {
+          const uint32_t h = fine.node_hedges[i];
+          const uint64_t size = fine.hedge_size(h);
+          if (size > kMaxRatedHyperedgeSize) {
+            continue;
+          }
+          const uint64_t rating =
+              fine.hedge_weight[h] * kRatingScale / (size - 1);
+          for (uint64_t j = fine.hedge_begin[h]; j < fine.hedge_begin[h + 1];
+               ++j) {
+            if (fine.hedge_pins[j] != n) {
+              ratings.emplace_back(fine.hedge_pins[j], rating);
+            }
+          }
+        }
+        std::sort(ratings.begin(), ratings.end());
+        for (size_t i = 0; i < ratings.size();) {
+          const uint32_t v = ratings[i].first;
+          uint64_t rating = 0;
+          for (; i < ratings.size() && ratings[i].first == v; ++i) {
+            rating += ratings[i].second;
+          }
+          add(v, rating);
+        }
+      });
+
+  katana::NUMAArray<uint32_t> members;
+  katana::NUMAArray<uint64_t> coarse_weight;
+  NumberPairs(match, fine.node_weight, coarse_of, &members, &coarse_weight);
+
+  return BuildHyperLevel(
+      std::move(coarse_weight), fine.num_hedges(),
+      [&](size_t h) { return fine.hedge_size(h); },
+      [&](size_t h, const auto& add) {
+        for (uint64_t i = fine.hedge_begin[h]; i < fine.hedge_begin[h + 1];
+             ++i) {
+          add((*coarse_of)[fine.hedge_pins[i]]);
+        }
+      },
+      [&](size_t h) { return fine.hedge_weight[h]; });
+}
+
+/// Partition a hypergraph level by greedy graph growing on its clique
+/// expansion, where the pins of each hyperedge h have edges of weight w(h)
+/// between them
+katana::NUMAArray<uint32_t>
+GrowPartitions(
+    const HyperLevel& level, uint32_t num_partitions,
+    uint64_t max_partition_weight) {
+  auto expanded = [&](uint32_t h) {
+    return level.hedge_size(h) <= kMaxRatedHyperedgeSize;
+  };
+  katana::NUMAArray<uint64_t> node_weight;
+  node_weight.allocateBlocked(level.num_nodes());
+  katana::ParallelSTL::copy(
+      level.node_weight.begin(), level.node_weight.end(), node_weight.begin());
+  Level graph = BuildLevel(
+      std::move(node_weight),
+      [&](size_t n) {
+        uint64_t degree = 0;
+        for (uint64_t i = level.node_begin[n]; i < level.node_begin[n + 1];
+             ++i) {
+          const uint32_t h = level.node_hedges[i];
+          if (expanded(h)) {
+            degree += level.hedge_size(h) - 1;
+          }
+        }
+        return degree;
+      },
+      [&](size_t n, const auto& add) {
+        for (uint64_t i = level.node_begin[n]; i < level.node_begin[n + 1];
+             ++i) {
+          const uint32_t h = level.node_hedges[i];
+          if (!expanded(h)) {
+            continue;
+          }
+          for (uint64_t j = level.hedge_begin[h]; j < level.hedge_begin[h + 1];
+               ++j) {
+            add(level.hedge_pins[j], level.hedge_weight[h]);
+          }
+        }
+      });
+  return GrowPartitions(graph, num_partitions, max_partition_weight);
+}
+
+/// Refine the partition of a hypergraph to reduce its connectivity, the sum
+/// of w(h) (lambda(h) - 1) over the hyperedges h, where lambda(h) is the
+/// number of partitions h has pins in. Before each pass, the pins of every
+/// hyperedge in each partition are counted. The connection of a node to
+/// another partition is the weight of its hyperedges with pins there, and
+/// to its own partition the weight of its hyperedges with other pins there,
+/// so that a move gains the reduction of the connectivity.
+void
+Refine(
+    const HyperLevel& level, uint32_t num_partitions,
+    uint64_t max_partition_weight, uint32_t rounds,
+    katana::NUMAArray<uint32_t>* part) {
+  const size_t num_hedges = level.num_hedges();
+
+  // the partitions that hyperedge h has pins in and their pins in each are
+  // [count_begin[h], count_begin[h] + count_size[h]) of count_part and
+  // count
+  katana::NUMAArray<uint64_t> count_begin;
+  count_begin.allocateBlocked(num_hedges + 1);
+  count_begin[0] = 0;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_hedges),
+      [&](size_t h) {
+        count_begin[h + 1] =
+            std::min<uint64_t>(level.hedge_size(h), num_partitions);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      count_begin.begin(), count_begin.end(), count_begin.begin());
+  katana::NUMAArray<uint32_t> count_size;
+  katana::NUMAArray<uint32_t> count_part;
+  katana::NUMAArray<uint32_t> count;
+  count_size.allocateBlocked(num_hedges);
+  count_part.allocateBlocked(count_begin[num_hedges]);
+  count.allocateBlocked(count_begin[num_hedges]);
+  katana::PerThreadStorage<Connections> counters;
+
+  RefinePartition(
+      level.node_weight, num_partitions, max_partition_weight, rounds, part,
+      [&](const katana::NUMAArray<uint32_t>& current) {
+        katana::do_all(
+            katana::iterate(size_t{0}, num_hedges),
+            [&](size_t h) {
+              Connections& pins = *counters.getLocal();
+              if (pins.weight.empty()) {
+                pins.weight.resize(num_partitions, 0);
+              }
+              for (uint64_t i = level.hedge_begin[h];
+                   i < level.hedge_begin[h + 1]; ++i) {
+                pins.Add(current[level.hedge_pins[i]], 1);
+              }
+              uint64_t out = count_begin[h];
+              for (uint32_t p : pins.partitions) {
+                count_part[out] = p;
+                count[out] = pins.weight[p];
+                pins.weight[p] = 0;
+                ++out;
+              }
+              count_size[h] = pins.partitions.size();
+              pins.partitions.clear();
+            },
+            katana::steal(), katana::no_stats());
+      },
+      [&](size_t n, uint32_t from, Connections* conn) {
+        int64_t from_connection = 0;
+        for (uint64_t i = level.node_begin[n]; i < level.node_begin[n + 1];
+             ++i) {
+          const uint32_t h = level.node_hedges[i];
+          const uint64_t w = level.hedge_weight[h];
+          for (uint64_t j = count_begin[h]; j < count_begin[h] + count_size[h];
+               ++j) {
+            if (count_part[j] != from) {
+              conn->Add(count_part[j], w);
+            } else if (count[j] > 1) {
+              from_connection += w;
+            }
+          }
+        }
+        return from_connection;
+      });
+}
+
+/// \returns the partition of the nodes of a level from the partition of the
+/// next coarser level
+katana::NUMAArray<uint32_t>
+Project(
+    const katana::NUMAArray<uint32_t>& coarse_of,
+    const katana::NUMAArray<uint32_t>& coarse_part) {
+  katana::NUMAArray<uint32_t> part;
+  part.allocateBlocked(coarse_of.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, coarse_of.size()),
+      [&](size_t n) { part[n] = coarse_part[coarse_of[n]]; },
+      katana::no_stats());
+  return part;
+}
+
+/// \returns the partition of each node of base by multilevel partitioning:
+/// coarsen it, partition the coarsest level and refine the partition at
+/// each level on the way back. LevelType is Level or HyperLevel, for which
+/// Coarsen, GrowPartitions and Refine are defined.
+template <typename LevelType>
+katana::NUMAArray<uint32_t>
+MultilevelPartition(
+    LevelType base, uint64_t total_weight, uint32_t num_partitions,
+    const PartitionPlan& plan) {
+  std::vector<LevelType> levels;
+  std::vector<katana::NUMAArray<uint32_t>> coarse_of;
+  levels.emplace_back(std::move(base));
+
+  const uint64_t coarsest_size =
+      uint64_t{num_partitions} * plan.coarsest_nodes_per_partition();
+  const uint64_t max_node_weight = std::max<uint64_t>(
+      2, std::ceil(
+             kMaxCoarseNodeWeightFactor * total_weight / coarsest_size));
+  while (levels.back().num_nodes() > coarsest_size) {
+    katana::NUMAArray<uint32_t> map;
+    LevelType coarse =
+        Coarsen(levels.back(), max_node_weight, levels.size(), &map);
+    if (coarse.num_nodes() >
+        kMinCoarseningRatio * levels.back().num_nodes()) {
+      break;
+    }
+    levels.emplace_back(std::move(coarse));
+    coarse_of.emplace_back(std::move(map));
+  }
+
+  const uint64_t average_weight =
+      (total_weight + num_partitions - 1) / num_partitions;
+  const uint64_t max_partition_weight = std::max<uint64_t>(
+      average_weight, (1 + plan.max_imbalance()) * average_weight);
+
+  auto part =
+      GrowPartitions(levels.back(), num_partitions, max_partition_weight);
+  Refine(
+      levels.back(), num_partitions, max_partition_weight,
+      plan.refinement_rounds(), &part);
+  while (!coarse_of.empty()) {
+    part = Project(coarse_of.back(), part);
+    coarse_of.pop_back();
+    levels.pop_back();
+    Refine(
+        levels.back(), num_partitions, max_partition_weight,
+        plan.refinement_rounds(), &part);
+  }
+  return part;
+}
+
+/// \returns the number of nodes from first_node on in each partition
+std::vector<uint64_t>
+PartitionSizes(
+    const PartitionGraph& graph, uint32_t num_partitions,
+    Node first_node = 0) {
+  katana::PerThreadStorage<std::vector<uint64_t>> local_sizes;
+  katana::do_all(
+      katana::iterate(first_node, static_cast<Node>(graph.num_nodes())),
+      [&](Node n) {
+        std::vector<uint64_t>& sizes = *local_sizes.getLocal();
+        if (sizes.empty()) {
+          sizes.resize(num_partitions, 0);
+        }
+        ++sizes[graph.GetData<NodePartition>(n)];
+      },
+      katana::no_stats());
+
+  std::vector<uint64_t> sizes(num_partitions, 0);
+  for (const std::vector<uint64_t>& local : local_sizes) {
+    for (size_t p = 0; p < local.size(); ++p) {
+      sizes[p] += local[p];
+    }
+  }
+  return sizes;
+}
+
+/// \returns the size of the largest partition over the average partition
+/// size of num_nodes nodes, less 1
+double
+Imbalance(
+    uint64_t max_partition_size, uint32_t num_partitions, uint64_t num_nodes) {
+  if (num_nodes == 0) {
+    return 0;
+  }
+  return static_cast<double>(max_partition_size) * num_partitions / num_nodes -
+         1;
+}
+
+/// Check the arguments shared by Partition and PartitionHypergraph
+katana::Result<void>
+CheckArguments(uint32_t num_partitions, const PartitionPlan& plan) {
+  if (plan.algorithm() != PartitionPlan::kMultilevel) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  if (num_partitions == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the number of partitions must be positive");
+  }
+  if (plan.coarsest_nodes_per_partition() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the coarsest graph must have some nodes per partition");
+  }
+  if (!(plan.max_imbalance() >= 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the maximum imbalance {} is negative", plan.max_imbalance());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Check that pg holds a hypergraph whose first num_hyperedges nodes are
+/// hyperedges with edges only to the other nodes
+katana::Result<void>
+CheckHypergraph(const katana::PropertyGraph& pg, uint64_t num_hyperedges) {
+  if (num_hyperedges > pg.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} hyperedges but only {} nodes", num_hyperedges, pg.num_nodes());
+  }
+  const katana::GraphTopology& topo = pg.topology();
+  katana::GReduceLogicalOr hedge_to_hedge;
+  katana::do_all(
+      katana::iterate(Node{0}, static_cast<Node>(num_hyperedges)),
+      [&](Node h) {
+        for (auto e : topo.edges(h)) {
+          if (topo.edge_dest(e) < num_hyperedges) {
+            hedge_to_hedge.update(true);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (hedge_to_hedge.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "some hyperedge has an edge to another hyperedge");
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::Partition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, PartitionPlan plan) {
+  KATANA_CHECKED(CheckArguments(num_partitions, plan));
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodePartition>>(
+      pg, {output_property_name}));
+  auto graph =
+      KATANA_CHECKED(PartitionGraph::Make(pg, {output_property_name}, {}));
+
+  katana::StatTimer exec_time("Partition");
+  exec_time.start();
+  auto part = MultilevelPartition(
+      BaseLevel(pg->BuildView<BiDirView>()), pg->num_nodes(), num_partitions,
+      plan);
+  exec_time.stop();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](auto n) { graph.GetData<NodePartition>(n) = part[n]; },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::PartitionHypergraph(
+    PropertyGraph* pg, uint64_t num_hyperedges, uint32_t num_partitions,
+    const std::string& output_property_name, PartitionPlan plan) {
+  KATANA_CHECKED(CheckArguments(num_partitions, plan));
+  KATANA_CHECKED(CheckHypergraph(*pg, num_hyperedges));
+  const katana::GraphTopology& topo = pg->topology();
+  const Node num_hedges = num_hyperedges;
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodePartition>>(
+      pg, {output_property_name}));
+  auto graph =
+      KATANA_CHECKED(PartitionGraph::Make(pg, {output_property_name}, {}));
+
+  katana::StatTimer exec_time("PartitionHypergraph");
+  exec_time.start();
+  auto part = MultilevelPartition(
+      BaseHyperLevel(topo, num_hedges), pg->num_nodes() - num_hedges,
+      num_partitions, plan);
+  exec_time.stop();
+
+  katana::do_all(
+      katana::iterate(num_hedges, static_cast<Node>(pg->num_nodes())),
+      [&](Node n) {
+        graph.GetData<NodePartition>(n) = part[n - num_hedges];
+      },
+      katana::no_stats());
+
+  // a hyperedge goes with most of its pins
+  katana::PerThreadStorage<Connections> counters;
+  katana::do_all(
+      katana::iterate(Node{0}, num_hedges),
+      [&](Node h) {
+        Connections& pins = *counters.getLocal();
+        if (pins.weight.empty()) {
+          pins.weight.resize(num_partitions, 0);
+        }
+        for (auto e : topo.edges(h)) {
+          pins.Add(part[topo.edge_dest(e) - num_hedges], 1);
+        }
+        uint32_t best = 0;
+        uint64_t best_pins = 0;
+        for (uint32_t p : pins.partitions) {
+          if (pins.weight[p] > best_pins ||
+              (pins.weight[p] == best_pins && p < best)) {
+            best = p;
+            best_pins = pins.weight[p];
+          }
+          pins.weight[p] = 0;
+        }
+        pins.partitions.clear();
+        graph.GetData<NodePartition>(h) = best;
+      },
+      katana::steal(), katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::PartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name) {
+  auto graph = KATANA_CHECKED(PartitionGraph::Make(pg, {property_name}, {}));
+
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](auto n) {
+        if (graph.GetData<NodePartition>(n) >= num_partitions) {
+          out_of_range.update(true);
+        }
+      },
+      katana::no_stats());
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "some node is not in one of the {} partitions", num_partitions);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<PartitionStatistics>
+katana::analytics::PartitionStatistics::Compute(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name) {
+  KATANA_CHECKED(PartitionAssertValid(pg, num_partitions, property_name));
+  auto graph = KATANA_CHECKED(PartitionGraph::Make(pg, {property_name}, {}));
+
+  katana::GAccumulator<uint64_t> edge_cut;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](auto n) {
+        uint32_t p = graph.GetData<NodePartition>(n);
+        for (auto e : graph.edges(n)) {
+          if (graph.GetData<NodePartition>(*graph.GetEdgeDest(e)) != p) {
+            edge_cut += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<uint64_t> sizes = PartitionSizes(graph, num_partitions);
+  uint64_t max_partition_size = *std::max_element(sizes.begin(), sizes.end());
+  uint64_t min_partition_size = *std::min_element(sizes.begin(), sizes.end());
+  return PartitionStatistics{
+      edge_cut.reduce(), max_partition_size, min_partition_size,
+      Imbalance(max_partition_size, num_partitions, graph.num_nodes())};
+}
+
+void
+katana::analytics::PartitionStatistics::Print(std::ostream& os) const {
+  os << "Edge cut = " << edge_cut << std::endl;
+  os << "Largest partition size = " << max_partition_size << std::endl;
+  os << "Smallest partition size = " << min_partition_size << std::endl;
+  os << "Imbalance = " << imbalance << std::endl;
+}
+
+katana::Result<HypergraphPartitionStatistics>
+katana::analytics::HypergraphPartitionStatistics::Compute(
+    PropertyGraph* pg, uint64_t num_hyperedges, uint32_t num_partitions,
+    const std::string& property_name) {
+  KATANA_CHECKED(CheckHypergraph(*pg, num_hyperedges));
+  KATANA_CHECKED(PartitionAssertValid(pg, num_partitions, property_name));
+  auto graph = KATANA_CHECKED(PartitionGraph::Make(pg, {property_name}, {}));
+  const Node num_hedges = num_hyperedges;
+
+  katana::GAccumulator<uint64_t> cut_hyperedges;
+  katana::GAccumulator<uint64_t> connectivity;
+  katana::PerThreadStorage<Connections> counters;
+  katana::do_all(
+      katana::iterate(Node{0}, num_hedges),
+      [&](Node h) {
+        Connections& pins = *counters.getLocal();
+        if (pins.weight.empty()) {
+          pins.weight.resize(num_partitions, 0);
+        }
+        for (auto e : graph.edges(h)) {
+          pins.Add(graph.GetData<NodePartition>(*graph.GetEdgeDest(e)), 1);
+        }
+        if (pins.partitions.size() > 1) {
+          cut_hyperedges += 1;
+          connectivity += pins.partitions.size() - 1;
+        }
+        for (uint32_t p : pins.partitions) {
+          pins.weight[p] = 0;
+        }
+        pins.partitions.clear();
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<uint64_t> sizes =
+      PartitionSizes(graph, num_partitions, num_hedges);
+  uint64_t max_partition_size = *std::max_element(sizes.begin(), sizes.end());
+  uint64_t min_partition_size = *std::min_element(sizes.begin(), sizes.end());
+  return HypergraphPartitionStatistics{
+      cut_hyperedges.reduce(), connectivity.reduce(), max_partition_size,
+      min_partition_size,
+      Imbalance(
+          max_partition_size, num_partitions,
+          graph.num_nodes() - num_hedges)};
+}
+
+void
+katana::analytics::HypergraphPartitionStatistics::Print(
+    std::ostream& os) const {
+  os << "Cut hyperedges = " << cut_hyperedges << std::endl;
+  os << "Connectivity = " << connectivity << std::endl;
+  os << "Largest partition size = " << max_partition_size << std::endl;
+  os << "Smallest partition size = " << min_partition_size << std::endl;
+  os << "Imbalance = " << imbalance << std::endl;
+}
@@ -0,0 +1,345 @@
+#include "katana/analytics/point_to_point/point_to_point.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <type_traits>
+
+#include <arrow/type_traits.h>
+
+#include "katana/EpochArray.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using Node = BiDirView::Node;
+
+constexpr size_t kForward = 0;
+constexpr size_t kBackward = 1;
+
+/// The state of the two searches of a query, kept by each thread across
+/// queries. The distances are EpochArrays, so starting a query does not
+/// touch them.
+template <typename Dist>
+struct Scratch {
+  std::array<katana::EpochArray<Dist>, 2> dist;
+
+  std::array<std::vector<Node>, 2> frontier;
+  std::vector<Node> next;
+  std::array<std::vector<std::pair<Dist, Node>>, 2> heap;
+
+  void Begin(size_t num_nodes) {
+    for (size_t d : {kForward, kBackward}) {
+      if (dist[d].size() != num_nodes) {
+        dist[d].Resize(num_nodes);
+      } else {
+        dist[d].Reset();
+      }
+      frontier[d].clear();
+      heap[d].clear();
+    }
+  }
+
+  bool Reached(size_t d, Node n) const { return dist[d].IsSet(n); }
+
+  void Reach(size_t d, Node n, Dist value) { dist[d].Set(n, value); }
+};
+
+class Searcher {
+public:
+  virtual ~Searcher() = default;
+
+  /// \returns the distance from source to target, which are different
+  /// nodes, or PointToPointQuery::kUnreachable
+  virtual double Distance(Node source, Node target) = 0;
+};
+
+/// Bidirectional BFS: each round expands the smaller frontier by a level
+/// and the search stops after the round in which the frontiers meet
+class HopSearcher : public Searcher {
+public:
+  explicit HopSearcher(BiDirView view) : view_(std::move(view)) {}
+
+  double Distance(Node source, Node target) override {
+    Scratch<uint32_t>& sc = *scratch_.getLocal();
+    sc.Begin(view_.num_nodes());
+
+    sc.Reach(kForward, source, 0);
+    sc.Reach(kBackward, target, 0);
+    sc.frontier[kForward].push_back(source);
+    sc.frontier[kBackward].push_back(target);
+
+    uint64_t best = std::numeric_limits<uint64_t>::max();
+    while (!sc.frontier[kForward].empty() && !sc.frontier[kBackward].empty()) {
+      size_t d = sc.frontier[kForward].size() <= sc.frontier[kBackward].size()
+                     ? kForward
+                     : kBackward;
+      size_t other = 1 - d;
+
+      sc.next.clear();
+      for (Node u : sc.frontier[d]) {
+        uint32_t next_dist = sc.dist[d].Get(u) + 1;
+        auto visit = [&](Node v) {
+          if (sc.Reached(other, v)) {
+            best = std::min<uint64_t>(best, next_dist + sc.dist[other].Get(v));
+          }
+          if (!sc.Reached(d, v)) {
+            sc.Reach(d, v, next_dist);
+            sc.next.push_back(v);
+          }
+        };
+        if (d == kForward) {
+          for (auto e : view_.edges(u)) {
+            visit(view_.edge_dest(e));
+          }
+        } else {
+          for (auto e : view_.in_edges(u)) {
+            visit(view_.in_edge_dest(e));
+          }
+        }
+      }
+      std::swap(sc.frontier[d], sc.next);
+
+      if (best != std::numeric_limits<uint64_t>::max()) {
+        return best;
+      }
+    }
+    return PointToPointQuery::kUnreachable;
+  }
+
+private:
+  BiDirView view_;
+  katana::PerThreadStorage<Scratch<uint32_t>> scratch_;
+};
+
+/// Bidirectional Dijkstra: each step settles a node of the search with the
+/// smaller heap and the search stops once the sum of the smallest distances
+/// on the heaps is no less than the shortest path found so far
+template <typename Weight>
+class WeightedSearcher : public Searcher {
+  using Dist = std::conditional_t<
+      std::is_floating_point_v<Weight>, double, uint64_t>;
+  using Entry = std::pair<Dist, Node>;
+  using WeightArray = typename arrow::CTypeTraits<Weight>::ArrayType;
+
+public:
+  WeightedSearcher(BiDirView view, std::shared_ptr<WeightArray> weights)
+      : view_(std::move(view)), weights_(std::move(weights)) {}
+
+  double Distance(Node source, Node target) override {
+    Scratch<Dist>& sc = *scratch_.getLocal();
+    sc.Begin(view_.num_nodes());
+
+    sc.Reach(kForward, source, 0);
+    sc.Reach(kBackward, target, 0);
+    sc.heap[kForward].emplace_back(0, source);
+    sc.heap[kBackward].emplace_back(0, target);
+
+    bool found = false;
+    Dist best{};
+    while (!sc.heap[kForward].empty() && !sc.heap[kBackward].empty()) {
+      if (found &&
+          sc.heap[kForward].front().first + sc.heap[kBackward].front().first >=
+              best) {
+        break;
+      }
+
+      size_t d = sc.heap[kForward].size() <= sc.heap[kBackward].size()
+                     ? kForward
+                     : kBackward;
+      size_t other = 1 - d;
+      auto& heap = sc.heap[d];
+
+      std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+      auto [u_dist, u] = heap.back();
+      heap.pop_back();
+      if (u_dist > sc.dist[d].Get(u)) {
+        // a stale entry of a node reached again with a shorter distance
+        continue;
+      }
+
+      auto relax = [&](Node v, Weight weight) {
+        Dist v_dist = u_dist + static_cast<Dist>(weight);
+        if (!sc.Reached(d, v) || v_dist < sc.dist[d].Get(v)) {
+          sc.Reach(d, v, v_dist);
+          heap.emplace_back(v_dist, v);
+          std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+        }
+        if (sc.Reached(other, v)) {
+          Dist through = v_dist + sc.dist[other].Get(v);
+          if (!found || through < best) {
+            best = through;
+            found = true;
+          }
+        }
+      };
+      if (d == kForward) {
+        for (auto e : view_.edges(u)) {
+          relax(
+              view_.edge_dest(e),
+              weights_->Value(view_.edge_property_index(e)));
+        }
+      } else {
+        for (auto e : view_.in_edges(u)) {
+          relax(
+              view_.in_edge_dest(e),
+              weights_->Value(view_.in_edge_property_index(e)));
+        }
+      }
+    }
+
+    if (!found) {
+      return PointToPointQuery::kUnreachable;
+    }
+    return static_cast<double>(best);
+  }
+
+private:
+  BiDirView view_;
+  std::shared_ptr<WeightArray> weights_;
+  katana::PerThreadStorage<Scratch<Dist>> scratch_;
+};
+
+template <typename Weight>
+katana::Result<std::unique_ptr<Searcher>>
+MakeWeightedSearcher(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  auto weights = KATANA_CHECKED_CONTEXT(
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name),
+      "edge weight property {}", edge_weight_property_name);
+  if (weights->null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "edge weights may not be null");
+  }
+
+  bool found_negative_weight = false;
+  if constexpr (std::is_signed_v<Weight>) {
+    katana::do_all(
+        katana::iterate(int64_t{0}, weights->length()),
+        [&](int64_t i) {
+          // also catches NaN
+          if (!(weights->Value(i) >= 0)) {
+            found_negative_weight = true;
+          }
+        },
+        katana::no_stats());
+  }
+  if (found_negative_weight) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge weights must be non-negative numbers");
+  }
+
+  return std::unique_ptr<Searcher>(std::make_unique<WeightedSearcher<Weight>>(
+      pg->BuildView<BiDirView>(), std::move(weights)));
+}
+
+}  // namespace
+
+struct katana::analytics::PointToPointQuery::Impl {
+  std::unique_ptr<Searcher> searcher;
+  uint64_t num_nodes;
+};
+
+katana::analytics::PointToPointQuery::PointToPointQuery(
+    std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+
+katana::analytics::PointToPointQuery::~PointToPointQuery() = default;
+
+katana::Result<std::unique_ptr<PointToPointQuery>>
+katana::analytics::PointToPointQuery::Make(
+    PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  auto impl = std::make_unique<Impl>();
+  impl->num_nodes = pg->num_nodes();
+
+  if (edge_weight_property_name.empty()) {
+    impl->searcher =
+        std::make_unique<HopSearcher>(pg->BuildView<BiDirView>());
+  } else {
+    auto property = pg->GetEdgeProperty(edge_weight_property_name);
+    if (!property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no edge property {}",
+          edge_weight_property_name);
+    }
+    switch (property->type()->id()) {
+    case arrow::UInt32Type::type_id:
+      impl->searcher = KATANA_CHECKED(
+          MakeWeightedSearcher<uint32_t>(pg, edge_weight_property_name));
+      break;
+    case arrow::Int32Type::type_id:
+      impl->searcher = KATANA_CHECKED(
+          MakeWeightedSearcher<int32_t>(pg, edge_weight_property_name));
+      break;
+    case arrow::UInt64Type::type_id:
+      impl->searcher = KATANA_CHECKED(
+          MakeWeightedSearcher<uint64_t>(pg, edge_weight_property_name));
+      break;
+    case arrow::Int64Type::type_id:
+      impl->searcher = KATANA_CHECKED(
+          MakeWeightedSearcher<int64_t>(pg, edge_weight_property_name));
+      break;
+    case arrow::FloatType::type_id:
+      impl->searcher = KATANA_CHECKED(
+          MakeWeightedSearcher<float>(pg, edge_weight_property_name));
+      break;
+    case arrow::DoubleType::type_id:
+      impl->searcher = KATANA_CHECKED(
+          MakeWeightedSearcher<double>(pg, edge_weight_property_name));
+      break;
+    default:
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "unsupported edge weight type {}",
+          property->type()->ToString());
+    }
+  }
+
+  return std::unique_ptr<PointToPointQuery>(
+      new PointToPointQuery(std::move(impl)));
+}
+
+katana::Result<double>
+katana::analytics::PointToPointQuery::Distance(
+    uint32_t source, uint32_t target) const {
+  if (source >= impl_->num_nodes || target >= impl_->num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "query {} to {} is not on nodes",
+        source, target);
+  }
+  if (source == target) {
+    return 0.0;
+  }
+  return impl_->searcher->Distance(source, target);
+}
+
+katana::Result<void>
+katana::analytics::PointToPointQuery::Distances(
+    const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+    std::vector<double>* distances) const {
+  for (const auto& [source, target] : queries) {
+    if (source >= impl_->num_nodes || target >= impl_->num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "query {} to {} is not on nodes", source, target);
+    }
+  }
+
+  distances->resize(queries.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, queries.size()),
+      [&](size_t i) {
+        auto [source, target] = queries[i];
+        (*distances)[i] =
+            source == target ? 0.0 : impl_->searcher->Distance(source, target);
+      },
+      katana::steal(), katana::loopname("PointToPointDistances"));
+
+  return katana::ResultSuccess();
+}
@@ -19,6 +19,12 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "katana/Random.h"
+#include "katana/SetIntersection.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -29,146 +35,356 @@ namespace {
 
 using SortedPropertyGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 
-struct Node2VecAlgo {
-  using NodeData = std::tuple<>;
-  using EdgeData = std::tuple<>;
+/// The tables of all edges have as many entries as the sum over edges of the
+/// degree of their destinations; beyond this many entries, walks sample the
+/// second-order transitions by rejection instead
+constexpr uint64_t kMaxAliasTableEntries = uint64_t{1} << 26;
+
+/// Seed of the generators of the walks
+constexpr uint64_t kWalkSeed = 0;
+
+/// Alias tables (Walker's method, built with Vose's algorithm) to sample the
+/// next edge of a walk from its second-order transition in constant time.
+/// The table of the edge e from prev to curr is [offsets[e], offsets[e + 1])
+/// and has a column per edge of curr: column k picks the k-th edge of curr
+/// with probability probs[k] and the aliases[k]-th edge otherwise.
+struct AliasTables {
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<float> probs;
+  katana::NUMAArray<uint32_t> aliases;
+
+  bool empty() const { return offsets.size() == 0; }
+
+  /// \returns the position among the edges of curr, of which there are
+  /// degree, of the next edge of a walk that reached curr over edge e
+  uint32_t Sample(uint64_t e, uint64_t degree, double u1, double u2) const {
+    uint64_t k = std::min<uint64_t>(u1 * degree, degree - 1);
+    uint64_t entry = offsets[e] + k;
+    return u2 < probs[entry] ? k : aliases[entry];
+  }
+};
 
-  using SortedGraphView = katana::TypedPropertyGraphView<
-      SortedPropertyGraphView, NodeData, EdgeData>;
-  using GNode = typename SortedGraphView::Node;
+/// Scratch space of a thread to build alias tables
+struct AliasScratch {
+  std::vector<double> weights;
+  std::vector<uint32_t> small;
+  std::vector<uint32_t> large;
+};
 
-  const RandomWalksPlan& plan_;
-  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+/// Build the alias table of scratch->weights, whose sum is positive, into
+/// probs and aliases
+void
+BuildAliasTable(AliasScratch* scratch, float* probs, uint32_t* aliases) {
+  std::vector<double>& weights = scratch->weights;
+  size_t size = weights.size();
+  double sum = 0;
+  for (double w : weights) {
+    sum += w;
+  }
 
-  GNode FindSampleNeighbor(
-      const SortedGraphView& graph, const GNode& n,
-      const katana::NUMAArray<uint64_t>& degree, const double prob) {
-    if (degree[n] == 0) {
-      return graph.num_nodes();
+  scratch->small.clear();
+  scratch->large.clear();
+  for (size_t k = 0; k < size; ++k) {
+    weights[k] *= size / sum;
+    (weights[k] < 1.0 ? scratch->small : scratch->large).push_back(k);
+  }
+  while (!scratch->small.empty() && !scratch->large.empty()) {
+    uint32_t s = scratch->small.back();
+    scratch->small.pop_back();
+    uint32_t l = scratch->large.back();
+    probs[s] = weights[s];
+    aliases[s] = l;
+    weights[l] -= 1.0 - weights[s];
+    if (weights[l] < 1.0) {
+      scratch->large.pop_back();
+      scratch->small.push_back(l);
+    }
+  }
+  // what is left has a probability of one, up to rounding
+  for (auto* rest : {&scratch->small, &scratch->large}) {
+    for (uint32_t k : *rest) {
+      probs[k] = 1.0;
+      aliases[k] = k;
     }
-    double total_wt = degree[n];
+  }
+}
 
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.edges(n).begin() + edge_index;
-    return graph.edge_dest(*ei);
+/// Size the alias tables of graph
+///
+/// \returns false if the tables would have more than kMaxAliasTableEntries
+/// entries
+template <typename Graph>
+bool
+AllocateAliasTables(const Graph& graph, AliasTables* tables) {
+  katana::GAccumulator<uint64_t> entries;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](typename Graph::Node n) {
+        for (auto e : graph.edges(n)) {
+          entries += graph.degree(graph.edge_dest(e));
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (entries.reduce() > kMaxAliasTableEntries) {
+    return false;
   }
 
-  void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
+  uint64_t num_edges = graph.num_edges();
+  tables->offsets.allocateBlocked(num_edges + 1);
+  tables->offsets[0] = 0;
+  const auto* dests = graph.dest_data();
+  for (uint64_t e = 0; e < num_edges; ++e) {
+    tables->offsets[e + 1] = tables->offsets[e] + graph.degree(dests[e]);
+  }
+  tables->probs.allocateBlocked(entries.reduce());
+  tables->aliases.allocateBlocked(entries.reduce());
+  return true;
+}
 
-    double prob_forward = 1.0 / plan_.forward_probability();
-    double prob_backward = 1.0 / plan_.backward_probability();
+/// Fill the table of each edge e from prev to curr with the node2vec
+/// transition weights of the edges f of curr, multiplied by weight(e, f):
+/// prob_backward if f goes back to prev, 1 if f goes to a neighbor of prev
+/// and prob_forward otherwise
+template <typename Graph, typename Weight>
+void
+FillAliasTables(
+    const Graph& graph, double prob_backward, double prob_forward,
+    const Weight& weight, AliasTables* tables) {
+  katana::PerThreadStorage<AliasScratch> scratch;
+  const auto* dests = graph.dest_data();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](typename Graph::Node prev) {
+        AliasScratch& sc = *scratch.getLocal();
+        uint64_t prev_first = *graph.edges(prev).begin();
+        uint64_t prev_degree = graph.degree(prev);
+        for (auto e : graph.edges(prev)) {
+          auto curr = graph.edge_dest(e);
+          uint64_t curr_first = *graph.edges(curr).begin();
+          uint64_t curr_degree = graph.degree(curr);
+
+          sc.weights.assign(curr_degree, prob_forward);
+          katana::ForEachIntersection(
+              dests + curr_first, curr_degree, dests + prev_first, prev_degree,
+              [&](size_t k, size_t) {
+                sc.weights[k] = 1.0;
+                return true;
+              });
+          for (uint64_t k = 0; k < curr_degree; ++k) {
+            if (dests[curr_first + k] == prev) {
+              sc.weights[k] = prob_backward;
+            }
+            sc.weights[k] *= weight(e, curr_first + k);
+          }
 
-    double upper_bound = 1.0;
+          uint64_t offset = tables->offsets[e];
+          BuildAliasTable(
+              &sc, &tables->probs[offset], &tables->aliases[offset]);
+        }
+      },
+      katana::steal(), katana::loopname("RandomWalksAliasTables"));
+}
 
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
+/// The walks of a batch as they are generated: walk i of the batch is
+/// written to Walk(i), which has room for the longest walk, so that threads
+/// write walks without allocating
+class WalkBuffer {
+public:
+  WalkBuffer(uint64_t batch_size, uint32_t walk_length)
+      : stride_(std::max(walk_length, uint32_t{1}) + 1) {
+    nodes_.allocateBlocked(batch_size * stride_);
+    lengths_.allocateBlocked(batch_size);
+  }
 
-    double lower_bound = 1.0;
+  uint32_t* Walk(uint64_t i) { return &nodes_[i * stride_]; }
 
-    lower_bound = (lower_bound < prob_forward) ? lower_bound : prob_forward;
-    lower_bound = (lower_bound < prob_backward) ? lower_bound : prob_backward;
+  void SetLength(uint64_t i, uint32_t length) { lengths_[i] = length; }
 
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
+  /// Copy the non-empty walks of the first num_walks walks to batch
+  void Gather(uint64_t num_walks, RandomWalksBatch* batch) {
+    kept_.clear();
+    batch->offsets.resize(1);
+    for (uint64_t i = 0; i < num_walks; ++i) {
+      if (lengths_[i] > 0) {
+        kept_.emplace_back(i);
+        batch->offsets.emplace_back(batch->offsets.back() + lengths_[i]);
+      }
+    }
+    batch->nodes.resize(batch->offsets.back());
+    katana::do_all(
+        katana::iterate(size_t{0}, kept_.size()),
+        [&](size_t k) {
+          const uint32_t* walk = Walk(kept_[k]);
+          std::copy(
+              walk, walk + lengths_[kept_[k]],
+              batch->nodes.begin() + batch->offsets[k]);
+        },
+        katana::no_stats());
+  }
+
+private:
+  uint64_t stride_;
+  katana::NUMAArray<uint32_t> nodes_;
+  katana::NUMAArray<uint32_t> lengths_;
+  std::vector<uint64_t> kept_;
+};
 
+/// Generate walks [0, total_walks) in batches of batch_size walks and hand
+/// each batch to callback. walk_fn(idx, walk, generator) writes walk idx and
+/// returns its length, which is 0 to leave the walk out. The generator of a
+/// walk is keyed by its index and step, so the walks are the same for any
+/// number of threads.
+template <typename WalkFn>
+katana::Result<void>
+GenerateWalks(
+    uint64_t total_walks, uint32_t walk_length, uint64_t batch_size,
+    uint32_t step, const char* loopname, const WalkFn& walk_fn,
+    const RandomWalksCallback& callback) {
+  if (total_walks == 0) {
+    return katana::ResultSuccess();
+  }
+
+  WalkBuffer buffer(std::min(batch_size, total_walks), walk_length);
+  RandomWalksBatch batch;
+  for (uint64_t begin = 0; begin < total_walks; begin += batch_size) {
+    uint64_t end = std::min(total_walks, begin + batch_size);
     katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
+        katana::iterate(begin, end),
         [&](uint64_t idx) {
-          GNode n = idx % graph.size();
-
-          //check if n has no neighbor
-          if (degree[n] == 0) {
-            return;
-          }
+          katana::CounterGenerator generator(kWalkSeed, idx, step);
+          buffer.SetLength(
+              idx - begin, walk_fn(idx, buffer.Walk(idx - begin), &generator));
+        },
+        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
+        katana::loopname(loopname), katana::no_stats());
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
+    buffer.Gather(end - begin, &batch);
+    KATANA_CHECKED(callback(batch));
+  }
+  return katana::ResultSuccess();
+}
 
-          std::vector<uint32_t> walk;
-          walk.push_back(n);
+/// The node2vec biases of the plan and the bounds used to sample them by
+/// rejection
+struct Biases {
+  double prob_forward;
+  double prob_backward;
+  double upper_bound;
+  double lower_bound;
+
+  explicit Biases(const RandomWalksPlan& plan)
+      : prob_forward(1.0 / plan.forward_probability()),
+        prob_backward(1.0 / plan.backward_probability()),
+        upper_bound(std::max({1.0, prob_forward, prob_backward})),
+        lower_bound(std::min({1.0, prob_forward, prob_backward})) {}
+
+  /// \returns the bias of moving to nbr from a walk that came from prev
+  template <typename Graph>
+  double Alpha(const Graph& graph, uint32_t prev, uint32_t nbr) const {
+    //check if nbr is same as the previous node on this walk
+    if (nbr == prev) {
+      return prob_backward;
+    }
+    //check if nbr is also a neighbor of the previous node on this walk
+    if (graph.has_edge(prev, nbr)) {
+      return 1.0;
+    }
+    return prob_forward;
+  }
+};
 
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+struct Node2VecAlgo {
+  using NodeData = std::tuple<>;
+  using EdgeData = std::tuple<>;
 
-          //Assumption: All edges have weight 1
-          auto nbr = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr < graph.num_nodes());
+  using SortedGraphView = katana::TypedPropertyGraphView<
+      SortedPropertyGraphView, NodeData, EdgeData>;
+  using GNode = typename SortedGraphView::Node;
+  using Edge = typename SortedGraphView::Edge;
 
-          walk.push_back(std::move(nbr));
+  const RandomWalksPlan& plan_;
+  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
 
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[current_walk - 1];
-            uint32_t prev = walk[current_walk - 2];
+  AliasTables tables_;
 
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              break;
-            }
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              auto nbr = FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr < graph.num_nodes());
-
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
-
-              if (y <= lower_bound) {
-                //accept this sample
-                walk.push_back(std::move(nbr));
-                break;
-              } else {
-                //compute transition probability
-                double alpha;
-
-                //check if nbr is same as the previous node on this walk
-                if (nbr == prev) {
-                  alpha = prob_backward;
-                }  //check if nbr is also a neighbor of the previous node on this walk
-                else if (graph.has_edge(prev, nbr)) {
-                  alpha = 1.0;
-                } else {
-                  alpha = prob_forward;
-                }
-
-                if (y <= alpha) {
-                  //accept y
-                  walk.push_back(std::move(nbr));
-                  break;
-                }
-              }
-            }
-          }
+  /// \returns an edge of n, which has neighbors, uniformly at random
+  Edge FindSampleEdge(
+      const SortedGraphView& graph, const GNode& n,
+      const katana::NUMAArray<uint64_t>& degree, const double prob) {
+    uint64_t edge_index = std::floor(prob * degree[n]);
+    return *graph.edges(n).begin() + edge_index;
+  }
 
-          walks->push(std::move(walk));
-        },
-        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Node2vec walks"), katana::no_stats());
+  /// Write the walk from n to walk and \returns its length
+  uint32_t Walk(
+      const SortedGraphView& graph, GNode n,
+      const katana::NUMAArray<uint64_t>& degree, const Biases& biases,
+      uint32_t* walk, katana::CounterGenerator* generator) {
+    //check if n has no neighbor
+    if (degree[n] == 0) {
+      return 0;
+    }
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+    walk[0] = n;
+    //Assumption: All edges have weight 1
+    Edge edge = FindSampleEdge(graph, n, degree, dist(*generator));
+    walk[1] = graph.edge_dest(edge);
+    uint32_t length = 2;
+
+    for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
+         current_walk++) {
+      uint32_t curr = walk[length - 1];
+      uint32_t prev = walk[length - 2];
+
+      //check if n has no neighbor
+      if (degree[curr] == 0) {
+        break;
+      }
 
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      delete (*distribution.getRemote(i));
+      if (!tables_.empty()) {
+        double u1 = dist(*generator);
+        double u2 = dist(*generator);
+        edge = *graph.edges(curr).begin() +
+               tables_.Sample(edge, degree[curr], u1, u2);
+      } else {
+        //acceptance-rejection sampling
+        while (true) {
+          //sample x
+          edge = FindSampleEdge(graph, curr, degree, dist(*generator));
+          //sample y
+          double y = dist(*generator) * biases.upper_bound;
+          if (y <= biases.lower_bound ||
+              y <= biases.Alpha(graph, prev, graph.edge_dest(edge))) {
+            //accept this sample
+            break;
+          }
+        }
+      }
+      walk[length++] = graph.edge_dest(edge);
     }
+    return length;
   }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+  katana::Result<void> operator()(
+      const SortedGraphView& graph, const katana::NUMAArray<uint64_t>& degree,
+      const RandomWalksCallback& callback, uint64_t batch_size) {
+    Biases biases(plan_);
+    if (plan_.walk_length() > 1 && AllocateAliasTables(graph, &tables_)) {
+      FillAliasTables(
+          graph, biases.prob_backward, biases.prob_forward,
+          [](Edge, Edge) { return 1.0; }, &tables_);
+    }
+
+    uint64_t total_walks = graph.size() * plan_.number_of_walks();
+    return GenerateWalks(
+        total_walks, plan_.walk_length(), batch_size, 0, "Node2vec walks",
+        [&](uint64_t idx, uint32_t* walk, katana::CounterGenerator* generator) {
+          return Walk(
+              graph, idx % graph.size(), degree, biases, walk, generator);
+        },
+        callback);
   }
 };
 
@@ -181,6 +397,7 @@ struct Edge2VecAlgo {
   using SortedGraphView = katana::TypedPropertyGraphView<
       SortedPropertyGraphView, NodeData, EdgeData>;
   using GNode = typename SortedGraphView::Node;
+  using Edge = typename SortedGraphView::Edge;
 
   const RandomWalksPlan& plan_;
   Edge2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
@@ -188,6 +405,27 @@ struct Edge2VecAlgo {
   //transition matrix
   std::vector<std::vector<double>> transition_matrix_;
 
+  AliasTables tables_;
+
+  /// Sums over the walks of an iteration of the number of edges of each
+  /// type on a walk and of the products of those numbers, from which the
+  /// Pearson correlation of each pair of types follows without keeping the
+  /// walks
+  struct TypeStatistics {
+    uint64_t num_walks{0};
+    std::vector<double> sums;
+    std::vector<double> cross_sums;
+    std::vector<uint32_t> counts;
+
+    void Reset(uint32_t num_types) {
+      num_walks = 0;
+      sums.assign(num_types, 0.0);
+      cross_sums.assign(num_types * num_types, 0.0);
+    }
+  };
+
+  katana::PerThreadStorage<TypeStatistics> statistics_;
+
   void Initialize() {
     transition_matrix_.resize(plan_.number_of_edge_types() + 1);
     //initialize transition matrix
@@ -198,272 +436,169 @@ struct Edge2VecAlgo {
     }
   }
 
-  std::pair<GNode, EdgeType::ViewType::value_type> FindSampleNeighbor(
+  uint32_t Type(const SortedGraphView& graph, Edge edge) const {
+    return graph.GetEdgeData<EdgeType>(edge);
+  }
+
+  Edge FindSampleEdge(
       const SortedGraphView& graph, const GNode& n,
       const katana::NUMAArray<uint64_t>& degree, const double prob) {
-    if (degree[n] == 0) {
-      return std::make_pair(graph.num_nodes(), 1);
-    }
-    double total_wt = degree[n];
-
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.edges(n).begin() + edge_index;
-    return std::make_pair(
-        graph.edge_dest(*ei), graph.GetEdgeData<EdgeType>(*ei));
+    uint64_t edge_index = std::floor(prob * degree[n]);
+    return *graph.edges(n).begin() + edge_index;
   }
 
-  void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      katana::InsertBag<std::vector<uint32_t>>* types_walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
+  /// Write the walk from n to walk, add its edge types to statistics and
+  /// \returns its length
+  uint32_t Walk(
+      const SortedGraphView& graph, GNode n,
+      const katana::NUMAArray<uint64_t>& degree, const Biases& biases,
+      uint32_t* walk, katana::CounterGenerator* generator,
+      TypeStatistics* statistics) {
+    //check if n has no neighbor
+    if (degree[n] == 0) {
+      return 0;
     }
-
-    double prob_forward = 1.0 / plan_.forward_probability();
-    double prob_backward = 1.0 / plan_.backward_probability();
-
-    double upper_bound = 1.0;
-
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
-
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
-
-    katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
-
-          //check if n has no neighbor
-          if (degree[n] == 0) {
-            return;
-          }
-
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
-
-          std::vector<uint32_t> walk;
-          std::vector<uint32_t> types_vec;
-
-          walk.push_back(n);
-
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
-
-          //Assumption: All edges have weight 1
-          auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
-
-          walk.push_back(std::move(nbr_pair.first));
-          types_vec.push_back(nbr_pair.second);
-
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[walk.size() - 1];
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              return;
-            }
-            uint32_t prev = walk[walk.size() - 2];
-
-            uint32_t p1 = types_vec.back();  //last element of types_vec
-
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              auto nbr_type_pair =
-                  FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
-
-              GNode nbr = nbr_type_pair.first;
-              EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
-
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
-
-              //compute transition probability
-              double alpha;
-
-              //check if nbr is same as the previous node on this walk
-              if (nbr == prev) {
-                alpha = prob_backward;
-              }  //check if nbr is also a neighbor of the previous node on this walk
-              else if (graph.has_edge(prev, nbr)) {
-                alpha = 1.0;
-              } else {
-                alpha = prob_forward;
-              }
-
-              alpha = alpha * transition_matrix_[p1][p2];
-              if (alpha >= y) {
-                //accept y
-                walk.push_back(std::move(nbr));
-                types_vec.push_back(p2);
-                break;
-              }
-            }  //end while
-
-          }  //end for
-
-          (*walks).push(std::move(walk));
-          (*types_walks).push(std::move(types_vec));
-        },
-        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Edge2vec walks"), katana::no_stats());
-  }
-
-  //compute the histogram of edge types for each walk
-  std::vector<std::vector<uint32_t>> ComputeNumEdgeTypeVectors(
-      const katana::InsertBag<std::vector<uint32_t>>& types_walks) {
-    std::vector<std::vector<uint32_t>> num_edge_types_walks;
-
-    katana::PerThreadStorage<std::vector<std::vector<uint32_t>>>
-        per_thread_num_edge_types_walks;
-    katana::do_all(
-        katana::iterate(types_walks),
-        [&](const std::vector<uint32_t>& types_walk) {
-          std::vector<uint32_t> num_edge_types(
-              plan_.number_of_edge_types() + 1, 0);
-
-          for (auto type : types_walk) {
-            num_edge_types[type]++;
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    std::vector<uint32_t>& counts = statistics->counts;
+    counts.assign(plan_.number_of_edge_types() + 1, 0);
+
+    walk[0] = n;
+    //Assumption: All edges have weight 1
+    Edge edge = FindSampleEdge(graph, n, degree, dist(*generator));
+    walk[1] = graph.edge_dest(edge);
+    counts[Type(graph, edge)]++;
+    uint32_t length = 2;
+
+    for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
+         current_walk++) {
+      uint32_t curr = walk[length - 1];
+      //check if n has no neighbor
+      if (degree[curr] == 0) {
+        return 0;
+      }
+      uint32_t prev = walk[length - 2];
+      uint32_t p1 = Type(graph, edge);
+
+      if (!tables_.empty()) {
+        double u1 = dist(*generator);
+        double u2 = dist(*generator);
+        edge = *graph.edges(curr).begin() +
+               tables_.Sample(edge, degree[curr], u1, u2);
+      } else {
+        //acceptance-rejection sampling
+        while (true) {
+          //sample x
+          Edge candidate =
+              FindSampleEdge(graph, curr, degree, dist(*generator));
+          //sample y
+          double y = dist(*generator) * biases.upper_bound;
+          double alpha = biases.Alpha(graph, prev, graph.edge_dest(candidate)) *
+                         transition_matrix_[p1][Type(graph, candidate)];
+          if (alpha >= y) {
+            //accept y
+            edge = candidate;
+            break;
           }
-
-          per_thread_num_edge_types_walks.getLocal()->emplace_back(
-              std::move(num_edge_types));
-        });
-
-    for (unsigned j = 0; j < katana::getActiveThreads(); ++j) {
-      for (auto num_edge_types :
-           *per_thread_num_edge_types_walks.getRemote(j)) {
-        num_edge_types_walks.push_back(std::move(num_edge_types));
+        }
       }
+      walk[length++] = graph.edge_dest(edge);
+      counts[Type(graph, edge)]++;
     }
 
-    return num_edge_types_walks;
-  }
-
-  std::vector<std::vector<uint32_t>> TransformVectors(
-      const std::vector<std::vector<uint32_t>>& num_edge_types_walks) {
-    uint32_t rows = num_edge_types_walks.size();
-    std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks;
-    transformed_num_edge_types_walks.resize(plan_.number_of_edge_types() + 1);
-
-    katana::do_all(
-        katana::iterate(uint32_t(0), plan_.number_of_edge_types() + 1),
-        [&](uint32_t j) {
-          for (uint32_t i = 0; i < rows; i++) {
-            transformed_num_edge_types_walks[j].push_back(
-                num_edge_types_walks[i][j]);
-          }
-        });
-
-    return transformed_num_edge_types_walks;
-  }
-
-  std::vector<double> ComputeMeans(const std::vector<std::vector<uint32_t>>&
-                                       transformed_num_edge_types_walks) {
-    std::vector<double> means(plan_.number_of_edge_types() + 1);
-
-    for (uint32_t i = 1; i <= plan_.number_of_edge_types(); i++) {
-      uint32_t sum = 0;
-      for (auto n : transformed_num_edge_types_walks[i]) {
-        sum += n;
+    uint32_t num_types = counts.size();
+    statistics->num_walks += 1;
+    for (uint32_t i = 0; i < num_types; i++) {
+      statistics->sums[i] += counts[i];
+      for (uint32_t j = 0; j < num_types; j++) {
+        statistics->cross_sums[i * num_types + j] += counts[i] * counts[j];
       }
-
-      means[i] = ((double)sum) / (transformed_num_edge_types_walks[i].size());
     }
-
-    return means;
+    return length;
   }
 
   double sigmoidCal(const double pears) {
     return 1 / (1 + exp(-pears));  //exact sig
   }
 
-  double pearsonCorr(
-      const uint32_t i, const uint32_t j,
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
-      const std::vector<double>& means) {
-    const std::vector<uint32_t>& x = transformed_num_edge_types_walks[i];
-    const std::vector<uint32_t>& y = transformed_num_edge_types_walks[j];
-
-    double sum = 0.0;
-    double sig1 = 0.0;
-    double sig2 = 0.0;
-
-    for (uint32_t m = 0; m < x.size(); m++) {
-      sum += ((double)x[m] - means[i]) * ((double)y[m] - means[j]);
-      sig1 += ((double)x[m] - means[i]) * ((double)x[m] - means[i]);
-      sig2 += ((double)y[m] - means[j]) * ((double)y[m] - means[j]);
+  void ComputeTransitionMatrix() {
+    uint32_t num_types = plan_.number_of_edge_types() + 1;
+    TypeStatistics total;
+    total.Reset(num_types);
+    for (unsigned t = 0; t < statistics_.size(); ++t) {
+      const TypeStatistics& local = *statistics_.getRemote(t);
+      if (local.num_walks == 0) {
+        continue;
+      }
+      total.num_walks += local.num_walks;
+      for (uint32_t i = 0; i < num_types; i++) {
+        total.sums[i] += local.sums[i];
+      }
+      for (uint32_t i = 0; i < num_types * num_types; i++) {
+        total.cross_sums[i] += local.cross_sums[i];
+      }
+    }
+    if (total.num_walks == 0) {
+      return;
     }
 
-    sum = sum / x.size();
-
-    sig1 = sig1 / x.size();
-    sig1 = sqrt(sig1);
-
-    sig2 = sig2 / x.size();
-    sig2 = sqrt(sig2);
-
-    double corr = sum / (sig1 * sig2);
-    return corr;
-  }
-
-  void ComputeTransitionMatrix(
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
-      const std::vector<double>& means) {
-    katana::do_all(
-        katana::iterate(uint32_t(1), plan_.number_of_edge_types() + 1),
-        [&](uint32_t i) {
-          for (uint32_t j = 1; j <= plan_.number_of_edge_types(); j++) {
-            double pearson_corr =
-                pearsonCorr(i, j, transformed_num_edge_types_walks, means);
-            double sigmoid = sigmoidCal(pearson_corr);
-
-            transition_matrix_[i][j] = sigmoid;
-          }
-        });
+    double num_walks = total.num_walks;
+    auto mean = [&](uint32_t i) { return total.sums[i] / num_walks; };
+    auto covariance = [&](uint32_t i, uint32_t j) {
+      return total.cross_sums[i * num_types + j] / num_walks -
+             mean(i) * mean(j);
+    };
+    for (uint32_t i = 1; i < num_types; i++) {
+      for (uint32_t j = 1; j < num_types; j++) {
+        double pearson_corr = covariance(i, j) /
+                              (std::sqrt(covariance(i, i)) *
+                               std::sqrt(covariance(j, j)));
+        transition_matrix_[i][j] = sigmoidCal(pearson_corr);
+      }
+    }
   }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
+  katana::Result<void> operator()(
+      const SortedGraphView& graph, const katana::NUMAArray<uint64_t>& degree,
+      const RandomWalksCallback& callback, uint64_t batch_size) {
     uint32_t iterations = plan_.max_iterations();
+    uint32_t num_types = plan_.number_of_edge_types() + 1;
+    Biases biases(plan_);
 
     Initialize();
+    bool use_tables =
+        plan_.walk_length() > 1 && AllocateAliasTables(graph, &tables_);
 
+    uint64_t total_walks = graph.size() * plan_.number_of_walks();
     for (uint32_t iter = 0; iter < iterations; iter++) {
-      //E step; generate walks
-      katana::InsertBag<std::vector<uint32_t>> types_walks;
+      // the transition matrix, and so the tables, change every iteration
+      if (use_tables) {
+        FillAliasTables(
+            graph, biases.prob_backward, biases.prob_forward,
+            [&](Edge in, Edge out) {
+              return transition_matrix_[Type(graph, in)][Type(graph, out)];
+            },
+            &tables_);
+      }
+      katana::on_each([&](unsigned, unsigned) {
+        statistics_.getLocal()->Reset(num_types);
+      });
 
-      GraphRandomWalk(graph, walks, &types_walks, degree);
+      //E step; generate walks
+      KATANA_CHECKED(GenerateWalks(
+          total_walks, plan_.walk_length(), batch_size, iter,
+          "Edge2vec walks",
+          [&](uint64_t idx, uint32_t* walk,
+              katana::CounterGenerator* generator) {
+            return Walk(
+                graph, idx % graph.size(), degree, biases, walk, generator,
+                statistics_.getLocal());
+          },
+          callback));
 
       //Update transition matrix
-      std::vector<std::vector<uint32_t>> num_edge_types_walks =
-          ComputeNumEdgeTypeVectors(types_walks);
-
-      std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks =
-          TransformVectors(num_edge_types_walks);
-
-      std::vector<double> means =
-          ComputeMeans(transformed_num_edge_types_walks);
-
-      ComputeTransitionMatrix(transformed_num_edge_types_walks, means);
+      ComputeTransitionMatrix();
     }
+    return katana::ResultSuccess();
   }
 };
 
@@ -480,9 +615,10 @@ InitializeDegrees(const Graph& graph, katana::NUMAArray<uint64_t>* degree) {
 }  //namespace
 
 template <typename Algorithm>
-static katana::Result<std::vector<std::vector<uint32_t>>>
+static katana::Result<void>
 RandomWalksWithWrap(
-    const typename Algorithm::SortedGraphView& graph, RandomWalksPlan plan) {
+    const typename Algorithm::SortedGraphView& graph, RandomWalksPlan plan,
+    const RandomWalksCallback& callback, uint64_t batch_size) {
   katana::ReportPageAllocGuard page_alloc;
 
   Algorithm algo(plan);
@@ -493,35 +629,54 @@ RandomWalksWithWrap(
 
   katana::StatTimer execTime("RandomWalks");
   execTime.start();
-  katana::InsertBag<std::vector<uint32_t>> walks;
-  algo(graph, &walks, degree);
+  auto res = algo(graph, degree, callback, batch_size);
   execTime.stop();
-
-  std::vector<std::vector<uint32_t>> walks_in_vector;
-  walks_in_vector.reserve(plan.number_of_walks());
-  std::move(walks.begin(), walks.end(), std::back_inserter(walks_in_vector));
-  return walks_in_vector;
+  return res;
 }
 
-katana::Result<std::vector<std::vector<uint32_t>>>
-katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+katana::Result<void>
+katana::analytics::RandomWalksInBatches(
+    PropertyGraph* pg, const RandomWalksCallback& callback,
+    RandomWalksPlan plan, uint64_t batch_size) {
+  if (batch_size == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "batch size must be positive");
+  }
+
   switch (plan.algorithm()) {
   case RandomWalksPlan::kNode2Vec: {
     auto graph =
         KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
-    return RandomWalksWithWrap<Node2VecAlgo>(graph, plan);
+    return RandomWalksWithWrap<Node2VecAlgo>(graph, plan, callback, batch_size);
   }
   case RandomWalksPlan::kEdge2Vec: {
     TemporaryPropertyGuard tmp_edge_prop{pg};
     auto graph = KATANA_CHECKED(
         Edge2VecAlgo::SortedGraphView::Make(pg, {}, {tmp_edge_prop.name()}));
-    return RandomWalksWithWrap<Edge2VecAlgo>(graph, plan);
+    return RandomWalksWithWrap<Edge2VecAlgo>(graph, plan, callback, batch_size);
   }
   default:
     return ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<std::vector<std::vector<uint32_t>>>
+katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+  std::vector<std::vector<uint32_t>> walks;
+  KATANA_CHECKED(RandomWalksInBatches(
+      pg,
+      [&walks](const RandomWalksBatch& batch) -> katana::Result<void> {
+        for (uint64_t i = 0; i < batch.num_walks(); ++i) {
+          walks.emplace_back(
+              batch.nodes.begin() + batch.offsets[i],
+              batch.nodes.begin() + batch.offsets[i + 1]);
+        }
+        return katana::ResultSuccess();
+      },
+      plan));
+  return walks;
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::RandomWalksAssertValid([
@@ -19,10 +19,16 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include "../gpu/gpu.h"
 #include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/Planner.h"
 #include "katana/gstl.h"
 
 using namespace katana::analytics;
@@ -69,13 +75,76 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   using OBIM = katana::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
   using OBIMBarrier = typename katana::OrderedByIntegerMetric<
       UpdateRequestIndexer, PSchunk>::template with_barrier<true>::type;
+  using AdaptiveOBIM =
+      katana::AdaptiveOrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
+
+  /// The worklist for delta stepping with a delta of 2^stepShift; the
+  /// adaptive worklist buckets unshifted distances itself
+  template <typename OBIMTy>
+  static auto MakeDeltaStepWorklist(unsigned stepShift) {
+    if constexpr (std::is_same_v<OBIMTy, AdaptiveOBIM>) {
+      return katana::wl<OBIMTy>(UpdateRequestIndexer{0}, stepShift);
+    } else {
+      return katana::wl<OBIMTy>(UpdateRequestIndexer{stepShift});
+    }
+  }
+
+  /// \returns the minimum, maximum and mean of weight_of(e) over the edges
+  template <typename WeightOf>
+  static EdgeWeightStatistics WeightStatistics(
+      uint64_t num_edges, const WeightOf& weight_of) {
+    EdgeWeightStatistics weights;
+    if (num_edges == 0) {
+      return weights;
+    }
+
+    katana::GAccumulator<double> sum_weight;
+    katana::GReduceMin<double> min_weight;
+    katana::GReduceMax<double> max_weight;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_edges),
+        [&](uint64_t e) {
+          double weight = weight_of(e);
+          sum_weight += weight;
+          min_weight.update(weight);
+          max_weight.update(weight);
+        },
+        katana::no_stats(), katana::loopname("EdgeWeightStatistics"));
+
+    weights.min = min_weight.reduce();
+    weights.max = max_weight.reduce();
+    weights.mean = sum_weight.reduce() / num_edges;
+    return weights;
+  }
+
+  /// \returns the minimum, maximum and mean of the edge weights
+  static EdgeWeightStatistics WeightStatistics(
+      const katana::NUMAArray<Weight>& edge_data, const Graph& graph) {
+    return WeightStatistics(
+        graph.num_edges(), [&](uint64_t e) { return edge_data[e]; });
+  }
+
+  /// \returns the exponent of the initial delta of kDeltaStepAutoDelta.
+  /// Light edges, those shorter than delta, may be relaxed more than once
+  /// within a bucket while heavy edges are relaxed once; max_weight / degree
+  /// bounds that rework (Meyer and Sanders), and buckets narrower than the
+  /// mean weight hold too few nodes to keep the threads busy.
+  static unsigned ChooseDeltaShift(
+      const katana::NUMAArray<Weight>& edge_data, const Graph& graph) {
+    double average_degree =
+        graph.size() == 0 ? 0 : double(graph.num_edges()) / graph.size();
+    unsigned shift = katana::analytics::ChooseDeltaShift(
+        WeightStatistics(edge_data, graph), average_degree);
+    katana::ReportStatSingle("SSSP", "DeltaShift", shift);
+    return shift;
+  }
 
   template <typename T, typename OBIMTy = OBIM, typename P, typename R>
   static void DeltaStepAlgo(
       katana::NUMAArray<std::atomic<Weight>>* node_data,
       katana::NUMAArray<Weight>* edge_data, Graph* graph,
       const typename Graph::Node& source, const P& pushWrap, const R& edgeRange,
-      unsigned stepShift) {
+      unsigned stepShift, const katana::CancellationToken* cancellation) {
     //! [reducible for self-defined stats]
     katana::GAccumulator<size_t> BadWork;
     //! [reducible for self-defined stats]
@@ -114,8 +183,9 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
             }
           }
         },
-        katana::wl<OBIMTy>(UpdateRequestIndexer{stepShift}),
-        katana::disable_conflict_detection(), katana::loopname("SSSP"));
+        MakeDeltaStepWorklist<OBIMTy>(stepShift),
+        katana::disable_conflict_detection(), katana::loopname("SSSP"),
+        katana::cancellation(cancellation));
 
     if (kTrackWork) {
       //! [report self-defined stats]
@@ -125,10 +195,64 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     }
   }
 
+  /// Lower the distances of the destinations of changed_edges and of the
+  /// nodes reached through them
+  static void RepairAlgo(
+      Graph* graph,
+      const std::vector<std::pair<uint32_t, uint32_t>>& changed_edges,
+      unsigned stepShift, const katana::CancellationToken* cancellation) {
+    katana::InsertBag<UpdateRequest> init_bag;
+
+    katana::do_all(
+        katana::iterate(size_t{0}, changed_edges.size()),
+        [&](size_t i) {
+          auto [src, dst] = changed_edges[i];
+          Dist sdist = graph->template GetData<NodeDistance>(src);
+          if (sdist == kDistanceInfinity) {
+            return;
+          }
+          for (auto e : graph->edges(src)) {
+            if (*graph->GetEdgeDest(e) != dst) {
+              continue;
+            }
+            Dist new_dist =
+                sdist + graph->template GetEdgeData<EdgeWeight>(e);
+            auto& ddist = graph->template GetData<NodeDistance>(dst);
+            if (new_dist < katana::atomicMin(ddist, new_dist)) {
+              init_bag.push(UpdateRequest(dst, new_dist));
+            }
+          }
+        },
+        katana::loopname("SSSPRepairSeeds"));
+
+    katana::for_each(
+        katana::iterate(init_bag),
+        [&](const UpdateRequest& item, auto& ctx) {
+          Dist sdist = graph->template GetData<NodeDistance>(item.src);
+          if (sdist < item.dist) {
+            return;
+          }
+
+          for (auto e : graph->edges(item.src)) {
+            auto dest = graph->GetEdgeDest(e);
+            auto& ddist = graph->template GetData<NodeDistance>(*dest);
+            Dist new_dist =
+                sdist + graph->template GetEdgeData<EdgeWeight>(e);
+            if (new_dist < katana::atomicMin(ddist, new_dist)) {
+              ctx.push(UpdateRequest(*dest, new_dist));
+            }
+          }
+        },
+        MakeDeltaStepWorklist<AdaptiveOBIM>(stepShift),
+        katana::disable_conflict_detection(), katana::loopname("SSSPRepair"),
+        katana::cancellation(cancellation));
+  }
+
   static void DeltaStepFusionAlgo(
       katana::NUMAArray<std::atomic<Weight>>* node_data,
       katana::NUMAArray<Weight>* edge_data, Graph* graph,
-      const typename Graph::Node& source, unsigned stepShift) {
+      const typename Graph::Node& source, unsigned stepShift,
+      const katana::CancellationToken* cancellation) {
     constexpr size_t kMaxFusion = 1000;
 
     using Node = typename Graph::Node;
@@ -163,6 +287,9 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     size_t cur_bucket = 0;
 
     for (size_t rounds = 1; true; ++rounds) {
+      if (cancellation && cancellation->IsCancelled()) {
+        break;
+      }
       Dist cur_dist = cur_bucket * (1 << stepShift);
       katana::do_all(
           katana::iterate(wl),
@@ -172,7 +299,8 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
               relax(n, sdist, *buckets.getLocal());
             }
           },
-          katana::wl<PSchunk>, katana::steal());
+          katana::wl<PSchunk>, katana::steal(),
+          katana::cancellation(cancellation));
 
       katana::GReduceMin<size_t> least_bucket;
 
@@ -228,7 +356,8 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   template <typename T, typename P, typename R>
   static void SerDeltaAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
-      const R& edgeRange, unsigned stepShift) {
+      const R& edgeRange, unsigned stepShift,
+      const katana::CancellationToken* cancellation) {
     SerialBucketWL<T, UpdateRequestIndexer> wl(UpdateRequestIndexer{stepShift});
 
     graph->template GetData<NodeDistance>(source) = 0;
@@ -237,6 +366,9 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
 
     size_t iter = 0UL;
     while (!wl.empty()) {
+      if (cancellation && cancellation->IsCancelled()) {
+        return;
+      }
       auto& curr = wl.minBucket();
 
       while (!curr.empty()) {
@@ -275,8 +407,9 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   template <typename T, typename P, typename R>
   static void DijkstraAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
-      const R& edgeRange) {
+      const R& edgeRange, const katana::CancellationToken* cancellation) {
     using WL = katana::MinHeap<T>;
+    constexpr size_t kItersPerCheck = 1024;
 
     graph->template GetData<NodeDistance>(source) = 0;
 
@@ -287,6 +420,10 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
 
     while (!wl.empty()) {
       ++iter;
+      if (iter % kItersPerCheck == 0 && cancellation &&
+          cancellation->IsCancelled()) {
+        return;
+      }
 
       T item = wl.pop();
 
@@ -312,7 +449,9 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     katana::ReportStatSingle("SSSP-Dijkstra", "Iterations", iter);
   }
 
-  static void TopoAlgo(Graph* graph, const typename Graph::Node& source) {
+  static void TopoAlgo(
+      Graph* graph, const typename Graph::Node& source,
+      const katana::CancellationToken* cancellation) {
     katana::NUMAArray<Dist> old_dist;
     old_dist.allocateInterleaved(graph->size());
 
@@ -348,14 +487,18 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
               }
             }
           },
-          katana::steal(), katana::loopname("Update"));
+          katana::steal(), katana::loopname("Update"),
+          katana::cancellation(cancellation));
 
-    } while (changed.reduce());
+    } while (changed.reduce() &&
+             !(cancellation && cancellation->IsCancelled()));
 
     katana::ReportStatSingle("SSSP-Topo", "rounds", rounds);
   }
 
-  void TopoTileAlgo(Graph* graph, const typename Graph::Node& source) {
+  void TopoTileAlgo(
+      Graph* graph, const typename Graph::Node& source,
+      const katana::CancellationToken* cancellation) {
     katana::InsertBag<SrcEdgeTile> tiles;
 
     graph->template GetData<NodeDistance>(source) = 0;
@@ -393,15 +536,33 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
               }
             }
           },
-          katana::steal(), katana::loopname("Update"));
+          katana::steal(), katana::loopname("Update"),
+          katana::cancellation(cancellation));
 
-    } while (changed.reduce());
+    } while (changed.reduce() &&
+             !(cancellation && cancellation->IsCancelled()));
 
     katana::ReportStatSingle("SSSP-Topo", "rounds", rounds);
   }
 
 public:
-  katana::Result<void> SSSP(Graph& graph, size_t start_node, SsspPlan plan) {
+  /// \returns \param plan with kAutomatic replaced by the plan chosen for
+  /// \param graph, so that callers running many searches choose it once
+  static SsspPlan ResolvePlan(const Graph& graph, SsspPlan plan) {
+    if (plan.algorithm() != SsspPlan::kAutomatic) {
+      return plan;
+    }
+    return ChooseSsspPlan(
+        graph.GetPropertyGraph().GetTopologyStatistics(),
+        WeightStatistics(graph.num_edges(), [&](uint64_t e) {
+          return graph.template GetEdgeData<EdgeWeight>(e);
+        }));
+  }
+
+  katana::Result<void> SSSP(
+      Graph& graph, size_t start_node, SsspPlan plan,
+      const katana::CancellationToken* cancellation,
+      AnalyticsWorkspace* workspace) {
     if (start_node >= graph.size()) {
       return katana::ErrorCode::InvalidArgument;
     }
@@ -414,16 +575,23 @@ public:
     katana::EnsurePreallocated(1, approxNodeData);
     katana::ReportPageAllocGuard page_alloc;
 
-    katana::NUMAArray<std::atomic<Weight>> node_data;
-    katana::NUMAArray<Weight> edge_data;
+    katana::NUMAArray<std::atomic<Weight>> local_node_data;
+    katana::NUMAArray<Weight> local_edge_data;
+    katana::NUMAArray<std::atomic<Weight>>* node_data_ptr = &local_node_data;
+    katana::NUMAArray<Weight>* edge_data_ptr = &local_edge_data;
     bool use_block = false;
-    if (use_block) {
-      node_data.allocateBlocked(graph.size());
-      edge_data.allocateBlocked(graph.num_edges());
+    if (workspace) {
+      node_data_ptr = workspace->Array<std::atomic<Weight>>(0, graph.size());
+      edge_data_ptr = workspace->Array<Weight>(0, graph.num_edges());
+    } else if (use_block) {
+      local_node_data.allocateBlocked(graph.size());
+      local_edge_data.allocateBlocked(graph.num_edges());
     } else {
-      node_data.allocateInterleaved(graph.size());
-      edge_data.allocateInterleaved(graph.num_edges());
+      local_node_data.allocateInterleaved(graph.size());
+      local_edge_data.allocateInterleaved(graph.num_edges());
     }
+    auto& node_data = *node_data_ptr;
+    auto& edge_data = *edge_data_ptr;
 
     katana::do_all(katana::iterate(graph), [&](const typename Graph::Node& n) {
       graph.template GetData<NodeDistance>(n) = kDistanceInfinity;
@@ -436,54 +604,71 @@ public:
     graph.template GetData<NodeDistance>(source) = 0;
     node_data[source] = 0;
 
-    katana::StatTimer execTime("SSSP");
-    execTime.start();
-
     if (plan.algorithm() == SsspPlan::kAutomatic) {
-      plan = SsspPlan(&graph.GetPropertyGraph());
+      plan = ChooseSsspPlan(
+          graph.GetPropertyGraph().GetTopologyStatistics(),
+          WeightStatistics(edge_data, graph));
     }
 
+    katana::StatTimer execTime("SSSP");
+    execTime.start();
+
     switch (plan.algorithm()) {
     case SsspPlan::kDeltaTile:
       DeltaStepAlgo<SrcEdgeTile>(
           &node_data, &edge_data, &graph, source,
-          SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(), plan.delta());
+          SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(), plan.delta(),
+          cancellation);
       break;
     case SsspPlan::kDeltaStep:
       DeltaStepAlgo<UpdateRequest>(
           &node_data, &edge_data, &graph, source, ReqPushWrap(),
-          OutEdgeRangeFn{&graph}, plan.delta());
+          OutEdgeRangeFn{&graph}, plan.delta(), cancellation);
       break;
     case SsspPlan::kDeltaStepBarrier:
       DeltaStepAlgo<UpdateRequest, OBIMBarrier>(
           &node_data, &edge_data, &graph, source, ReqPushWrap(),
-          OutEdgeRangeFn{&graph}, plan.delta());
+          OutEdgeRangeFn{&graph}, plan.delta(), cancellation);
+      break;
+    case SsspPlan::kDeltaStepAdaptive:
+      DeltaStepAlgo<UpdateRequest, AdaptiveOBIM>(
+          &node_data, &edge_data, &graph, source, ReqPushWrap(),
+          OutEdgeRangeFn{&graph}, plan.delta(), cancellation);
+      break;
+    case SsspPlan::kDeltaStepAutoDelta:
+      DeltaStepAlgo<UpdateRequest, AdaptiveOBIM>(
+          &node_data, &edge_data, &graph, source, ReqPushWrap(),
+          OutEdgeRangeFn{&graph}, ChooseDeltaShift(edge_data, graph),
+          cancellation);
       break;
     case SsspPlan::kDeltaStepFusion:
-      DeltaStepFusionAlgo(&node_data, &edge_data, &graph, source, plan.delta());
+      DeltaStepFusionAlgo(
+          &node_data, &edge_data, &graph, source, plan.delta(), cancellation);
       break;
     case SsspPlan::kSerialDeltaTile:
       SerDeltaAlgo<SrcEdgeTile>(
           &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
-          plan.delta());
+          plan.delta(), cancellation);
       break;
     case SsspPlan::kSerialDelta:
       SerDeltaAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta(),
+          cancellation);
       break;
     case SsspPlan::kDijkstraTile:
       DijkstraAlgo<SrcEdgeTile>(
-          &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn());
+          &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
+          cancellation);
       break;
     case SsspPlan::kDijkstra:
       DijkstraAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph});
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, cancellation);
       break;
     case SsspPlan::kTopological:
-      TopoAlgo(&graph, source);
+      TopoAlgo(&graph, source, cancellation);
       break;
     case SsspPlan::kTopologicalTile:
-      TopoTileAlgo(&graph, source);
+      TopoTileAlgo(&graph, source, cancellation);
       break;
     default:
       return katana::ErrorCode::InvalidArgument;
@@ -491,12 +676,43 @@ public:
 
     execTime.stop();
 
+    if (cancellation && cancellation->IsCancelled()) {
+      return KATANA_ERROR(katana::ErrorCode::Cancelled, "sssp cancelled");
+    }
+
     katana::do_all(katana::iterate(graph), [&](const typename Graph::Node& n) {
       graph.template GetData<NodeDistance>(n) = node_data[n].load();
     });
 
     return katana::ResultSuccess();
   }
+
+  static katana::Result<void> Repair(
+      Graph& graph,
+      const std::vector<std::pair<uint32_t, uint32_t>>& changed_edges,
+      SsspPlan plan, const katana::CancellationToken* cancellation) {
+    for (const auto& [src, dst] : changed_edges) {
+      if (src >= graph.size() || dst >= graph.size()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "changed edge {} to {} is not on nodes", src, dst);
+      }
+    }
+
+    unsigned step_shift =
+        plan.delta() == 0 ? SsspPlan::kDefaultDelta : plan.delta();
+
+    katana::StatTimer exec_time("SSSPRepair");
+    exec_time.start();
+    RepairAlgo(&graph, changed_edges, step_shift, cancellation);
+    exec_time.stop();
+
+    if (cancellation && cancellation->IsCancelled()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::Cancelled, "sssp repair cancelled");
+    }
+    return katana::ResultSuccess();
+  }
 };
 
 template <typename Weight>
@@ -505,10 +721,12 @@ Sssp(
     katana::TypedPropertyGraph<
         std::tuple<SsspNodeDistance<Weight>>,
         std::tuple<SsspEdgeWeight<Weight>>>& pg,
-    size_t start_node, SsspPlan plan) {
+    size_t start_node, SsspPlan plan,
+    const katana::CancellationToken* cancellation,
+    AnalyticsWorkspace* workspace) {
   static_assert(std::is_integral_v<Weight> || std::is_floating_point_v<Weight>);
   SsspImplementation<Weight> impl{{plan.edge_tile_size()}};
-  return impl.SSSP(pg, start_node, plan);
+  return impl.SSSP(pg, start_node, plan, cancellation, workspace);
 }
 
 template <typename Weight>
@@ -516,7 +734,9 @@ static katana::Result<void>
 SSSPWithWrap(
     katana::PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
-    const std::string& output_property_name, SsspPlan plan) {
+    const std::string& output_property_name, SsspPlan plan,
+    const katana::CancellationToken* cancellation,
+    AnalyticsWorkspace* workspace) {
   if (auto r = ConstructNodeProperties<std::tuple<SsspNodeDistance<Weight>>>(
           pg, {output_property_name});
       !r) {
@@ -535,7 +755,7 @@ SSSPWithWrap(
     return graph.error();
   }
 
-  return Sssp(graph.value(), start_node, plan);
+  return Sssp(graph.value(), start_node, plan, cancellation, workspace);
 }
 
 }  // namespace
@@ -544,26 +764,38 @@ katana::Result<void>
 katana::analytics::Sssp(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
-    const std::string& output_property_name, SsspPlan plan) {
+    const std::string& output_property_name, SsspPlan plan,
+    const CancellationToken* cancellation, AnalyticsWorkspace* workspace) {
+  if (plan.architecture() == kGPU) {
+    return internal::GpuSssp(
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        cancellation);
+  }
   switch (pg->GetEdgeProperty(edge_weight_property_name)->type()->id()) {
   case arrow::UInt32Type::type_id:
     return SSSPWithWrap<uint32_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        cancellation, workspace);
   case arrow::Int32Type::type_id:
     return SSSPWithWrap<int32_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        cancellation, workspace);
   case arrow::UInt64Type::type_id:
     return SSSPWithWrap<uint64_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        cancellation, workspace);
   case arrow::Int64Type::type_id:
     return SSSPWithWrap<int64_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        cancellation, workspace);
   case arrow::FloatType::type_id:
     return SSSPWithWrap<float>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        cancellation, workspace);
   case arrow::DoubleType::type_id:
     return SSSPWithWrap<double>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        cancellation, workspace);
   default:
     return katana::ErrorCode::TypeError;
   }
@@ -571,6 +803,141 @@ katana::analytics::Sssp(
 
 namespace {
 
+template <typename Weight>
+static katana::Result<std::shared_ptr<arrow::Table>>
+SsspBatchImpl(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name, SsspPlan plan,
+    const katana::CancellationToken* cancellation,
+    AnalyticsWorkspace* workspace) {
+  TemporaryPropertyGuard distances{pg};
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<SsspNodeDistance<Weight>>>(
+      pg, {distances.name()}));
+  using Graph = katana::TypedPropertyGraph<
+      std::tuple<SsspNodeDistance<Weight>>, std::tuple<SsspEdgeWeight<Weight>>>;
+  auto graph = KATANA_CHECKED(
+      Graph::Make(pg, {distances.name()}, {edge_weight_property_name}));
+  // choose the plan once rather than for every source
+  plan = SsspImplementation<Weight>::ResolvePlan(graph, plan);
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (uint32_t source : sources) {
+    KATANA_CHECKED_CONTEXT(
+        Sssp(graph, source, plan, cancellation, workspace), "source {}",
+        source);
+    auto column = KATANA_CHECKED(CopyNodeProperty(pg, distances.name()));
+    fields.emplace_back(arrow::field(std::to_string(source), column->type()));
+    columns.emplace_back(std::move(column));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, pg->num_nodes());
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::SsspBatch(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name, SsspPlan plan,
+    const CancellationToken* cancellation, AnalyticsWorkspace* workspace) {
+  AnalyticsWorkspace local_workspace;
+  if (!workspace) {
+    workspace = &local_workspace;
+  }
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return SsspBatchImpl<uint32_t>(
+        pg, sources, edge_weight_property_name, plan, cancellation, workspace);
+  case arrow::Int32Type::type_id:
+    return SsspBatchImpl<int32_t>(
+        pg, sources, edge_weight_property_name, plan, cancellation, workspace);
+  case arrow::UInt64Type::type_id:
+    return SsspBatchImpl<uint64_t>(
+        pg, sources, edge_weight_property_name, plan, cancellation, workspace);
+  case arrow::Int64Type::type_id:
+    return SsspBatchImpl<int64_t>(
+        pg, sources, edge_weight_property_name, plan, cancellation, workspace);
+  case arrow::FloatType::type_id:
+    return SsspBatchImpl<float>(
+        pg, sources, edge_weight_property_name, plan, cancellation, workspace);
+  case arrow::DoubleType::type_id:
+    return SsspBatchImpl<double>(
+        pg, sources, edge_weight_property_name, plan, cancellation, workspace);
+  default:
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "unsupported edge weight type {}",
+        weights->type()->ToString());
+  }
+}
+
+namespace {
+
+template <typename Weight>
+static katana::Result<void>
+SsspRepairImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& distance_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& changed_edges,
+    SsspPlan plan, const katana::CancellationToken* cancellation) {
+  using Impl = SsspImplementation<Weight>;
+  auto graph = KATANA_CHECKED(Impl::Graph::Make(
+      pg, {distance_property_name}, {edge_weight_property_name}));
+  return Impl::Repair(graph, changed_edges, plan, cancellation);
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::SsspRepair(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& distance_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& changed_edges,
+    SsspPlan plan, const CancellationToken* cancellation) {
+  auto property = pg->GetNodeProperty(distance_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no node property {}",
+        distance_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return SsspRepairImpl<uint32_t>(
+        pg, edge_weight_property_name, distance_property_name, changed_edges,
+        plan, cancellation);
+  case arrow::Int32Type::type_id:
+    return SsspRepairImpl<int32_t>(
+        pg, edge_weight_property_name, distance_property_name, changed_edges,
+        plan, cancellation);
+  case arrow::UInt64Type::type_id:
+    return SsspRepairImpl<uint64_t>(
+        pg, edge_weight_property_name, distance_property_name, changed_edges,
+        plan, cancellation);
+  case arrow::Int64Type::type_id:
+    return SsspRepairImpl<int64_t>(
+        pg, edge_weight_property_name, distance_property_name, changed_edges,
+        plan, cancellation);
+  case arrow::FloatType::type_id:
+    return SsspRepairImpl<float>(
+        pg, edge_weight_property_name, distance_property_name, changed_edges,
+        plan, cancellation);
+  case arrow::DoubleType::type_id:
+    return SsspRepairImpl<double>(
+        pg, edge_weight_property_name, distance_property_name, changed_edges,
+        plan, cancellation);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported distance type {}",
+        property->type()->ToString());
+  }
+}
+
+namespace {
+
 template <typename Weight>
 static katana::Result<void>
 SsspValidateImpl(
@@ -0,0 +1,630 @@
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Frontier.h"
+#include "katana/analytics/SpMV.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using InEdges = InEdgeTopology<BiDirView>;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+struct NodeComponent : public katana::PODProperty<uint64_t> {};
+
+using SccGraph =
+    katana::TypedPropertyGraph<std::tuple<NodeComponent>, std::tuple<>>;
+
+/// The component of the nodes that have none yet
+constexpr uint64_t kUnassigned = std::numeric_limits<uint64_t>::max();
+
+/// Marks in visited the nodes reachable from the nodes of next along the
+/// edges of out. An edge (src, dst) is followed if follow(src, dst) holds and
+/// dst is allowed(dst). The rounds push or pull as EdgeMap decides, so in
+/// must hold the in-edges of out.
+template <
+    typename OutTopo, typename InTopo, typename FollowFn, typename AllowedFn>
+void
+Search(
+    const OutTopo& out, const InTopo& in, std::unique_ptr<Frontier> next,
+    const FollowFn& follow, const AllowedFn& allowed,
+    katana::DynamicBitset* visited, const char* loopname) {
+  next->ForEach([&](Node n) { visited->set(n); }, katana::no_stats());
+  auto current = std::make_unique<Frontier>(next->num_nodes());
+  while (!next->empty()) {
+    std::swap(current, next);
+    EdgeMap(
+        out, in, current.get(), next.get(),
+        [&](Node src, Node dst) {
+          return follow(src, dst) && !visited->set(dst);
+        },
+        [&](Node dst) { return !visited->test(dst) && allowed(dst); },
+        loopname);
+  }
+}
+
+/// Takes strongly connected components out of the remaining nodes, the
+/// nodes without a component yet, until none remain
+class ComponentFinder {
+public:
+  explicit ComponentFinder(const BiDirView& view)
+      : view_(view), in_(&view), num_nodes_(view.num_nodes()) {
+    components_.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) { components_[n] = kUnassigned; }, katana::no_stats());
+  }
+
+  const katana::NUMAArray<uint64_t>& components() const { return components_; }
+
+  bool Remains(Node n) const { return components_[n] == kUnassigned; }
+
+  uint64_t NumRemaining() const {
+    katana::GAccumulator<uint64_t> remaining;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) {
+          if (Remains(n)) {
+            remaining += 1;
+          }
+        },
+        katana::no_stats());
+    return remaining.reduce();
+  }
+
+  /// Gives the remaining nodes without a remaining in-neighbor or
+  /// out-neighbor other than themselves a component of their own, until
+  /// there are none. Each round only rechecks the neighbors of the nodes
+  /// trimmed by the round before.
+  void Trim() {
+    auto candidates = std::make_unique<Frontier>(num_nodes_);
+    auto next = std::make_unique<Frontier>(num_nodes_);
+    candidates->ToDense();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) { candidates->Add(n); }, katana::no_stats());
+
+    katana::InsertBag<Node> trimmed;
+    katana::GAccumulator<uint64_t> num_trimmed;
+    while (!candidates->empty()) {
+      candidates->ForEach(
+          [&](Node n) {
+            if (Remains(n) && (!HasRemainingNeighbor(view_, n) ||
+                               !HasRemainingNeighbor(in_, n))) {
+              trimmed.push(n);
+              num_trimmed += 1;
+            }
+          },
+          katana::loopname("StronglyConnectedComponents-Trim"));
+      katana::do_all(
+          katana::iterate(trimmed), [&](Node n) { components_[n] = n; },
+          katana::no_stats());
+
+      next->Clear();
+      next->ToSparse();
+      katana::do_all(
+          katana::iterate(trimmed),
+          [&](Node n) {
+            AddRemainingNeighbors(view_, n, next.get());
+            AddRemainingNeighbors(in_, n, next.get());
+          },
+          katana::steal(), katana::no_stats());
+      trimmed.clear();
+      std::swap(candidates, next);
+    }
+    katana::ReportStatSingle(
+        "StronglyConnectedComponents", "Trimmed", num_trimmed.reduce());
+  }
+
+  /// Takes out the component of the remaining node with the largest product
+  /// of in- and out-degree: the nodes reached from it by a forward search
+  /// that are reached back by a backward search
+  void ForwardBackward() {
+    katana::GReduceMax<uint64_t> max_product;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) {
+          if (Remains(n)) {
+            max_product.update(DegreeProduct(n));
+          }
+        },
+        katana::no_stats());
+    uint64_t best = max_product.reduce();
+    katana::GReduceMin<uint64_t> pivot_reduce;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) {
+          if (Remains(n) && DegreeProduct(n) == best) {
+            pivot_reduce.update(n);
+          }
+        },
+        katana::no_stats());
+    uint64_t pivot = pivot_reduce.reduce();
+    if (pivot == kUnassigned) {
+      return;
+    }
+
+    katana::DynamicBitset forward;
+    forward.resize(num_nodes_);
+    auto sources = std::make_unique<Frontier>(num_nodes_);
+    sources->Add(pivot);
+    Search(
+        view_, in_, std::move(sources), [](Node, Node) { return true; },
+        [&](Node dst) { return Remains(dst); }, &forward,
+        "StronglyConnectedComponents-Forward");
+
+    katana::DynamicBitset backward;
+    backward.resize(num_nodes_);
+    sources = std::make_unique<Frontier>(num_nodes_);
+    sources->Add(pivot);
+    Search(
+        in_, view_, std::move(sources), [](Node, Node) { return true; },
+        [&](Node dst) { return forward.test(dst); }, &backward,
+        "StronglyConnectedComponents-Backward");
+
+    backward.ForEachSetBit(
+        [&](size_t n) { components_[n] = pivot; }, katana::no_stats());
+    katana::ReportStatSingle(
+        "StronglyConnectedComponents", "ForwardBackwardSize",
+        backward.count());
+  }
+
+  /// Takes out components by rounds of coloring until at most
+  /// serial_threshold nodes remain, and the rest with Serial
+  void Coloring(uint64_t serial_threshold) {
+    katana::NUMAArray<std::atomic<Node>> colors;
+    colors.allocateBlocked(num_nodes_);
+    katana::DynamicBitset members;
+    members.resize(num_nodes_);
+
+    uint32_t rounds = 0;
+    while (NumRemaining() > serial_threshold) {
+      // Propagate the largest id forward: the color of a node is then the
+      // largest node that reaches it
+      auto current = std::make_unique<Frontier>(num_nodes_);
+      auto next = std::make_unique<Frontier>(num_nodes_);
+      next->ToDense();
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_nodes_),
+          [&](uint64_t n) {
+            if (Remains(n)) {
+              colors[n].store(static_cast<Node>(n), std::memory_order_relaxed);
+              next->Add(n);
+            }
+          },
+          katana::no_stats());
+      while (!next->empty()) {
+        std::swap(current, next);
+        EdgeMap(
+            view_, in_, current.get(), next.get(),
+            [&](Node src, Node dst) {
+              Node color = colors[src].load(std::memory_order_relaxed);
+              return katana::atomicMax(colors[dst], color) < color;
+            },
+            [&](Node dst) { return Remains(dst); },
+            "StronglyConnectedComponents-Color");
+      }
+
+      // A node whose color is its own id is the largest of its component,
+      // which is the nodes of its color it reaches backward
+      auto roots = std::make_unique<Frontier>(num_nodes_);
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_nodes_),
+          [&](uint64_t n) {
+            if (Remains(n) && colors[n].load(std::memory_order_relaxed) == n) {
+              roots->Add(n);
+            }
+          },
+          katana::no_stats());
+      members.reset();
+      Search(
+          in_, view_, std::move(roots),
+          [&](Node src, Node dst) {
+            return colors[src].load(std::memory_order_relaxed) ==
+                   colors[dst].load(std::memory_order_relaxed);
+          },
+          [&](Node dst) { return Remains(dst); }, &members,
+          "StronglyConnectedComponents-ColorBackward");
+      members.ForEachSetBit(
+          [&](size_t n) {
+            components_[n] = colors[n].load(std::memory_order_relaxed);
+          },
+          katana::no_stats());
+      rounds += 1;
+    }
+    katana::ReportStatSingle(
+        "StronglyConnectedComponents", "ColoringRounds", rounds);
+
+    Serial();
+  }
+
+  /// Tarjan's algorithm on the remaining nodes
+  void Serial() {
+    std::vector<Node> nodes;
+    for (uint64_t n = 0; n < num_nodes_; ++n) {
+      if (Remains(n)) {
+        nodes.push_back(n);
+      }
+    }
+    // The position of a remaining node in nodes
+    bool all_remain = nodes.size() == num_nodes_;
+    auto local = [&](Node n) -> uint64_t {
+      if (all_remain) {
+        return n;
+      }
+      return std::lower_bound(nodes.begin(), nodes.end(), n) - nodes.begin();
+    };
+
+    constexpr uint64_t kUnvisited = std::numeric_limits<uint64_t>::max();
+    std::vector<uint64_t> index(nodes.size(), kUnvisited);
+    std::vector<uint64_t> low(nodes.size());
+    std::vector<uint8_t> on_stack(nodes.size(), 0);
+    std::vector<uint64_t> stack;
+
+    // The depth first search is kept on an explicit stack of frames, the
+    // edges left to visit of each node on the path
+    struct Frame {
+      uint64_t node;
+      Edge next;
+      Edge end;
+    };
+    std::vector<Frame> frames;
+    uint64_t next_index = 0;
+    auto visit = [&](uint64_t l) {
+      index[l] = next_index;
+      low[l] = next_index;
+      next_index += 1;
+      stack.push_back(l);
+      on_stack[l] = 1;
+      auto edges = view_.edges(nodes[l]);
+      frames.push_back(Frame{l, *edges.begin(), *edges.end()});
+    };
+
+    for (uint64_t root = 0; root < nodes.size(); ++root) {
+      if (index[root] != kUnvisited) {
+        continue;
+      }
+      visit(root);
+      while (!frames.empty()) {
+        Frame& frame = frames.back();
+        if (frame.next != frame.end) {
+          Node dst = view_.edge_dest(frame.next);
+          frame.next += 1;
+          if (!Remains(dst)) {
+            continue;
+          }
+          uint64_t d = local(dst);
+          if (index[d] == kUnvisited) {
+            visit(d);
+          } else if (on_stack[d]) {
+            low[frame.node] = std::min(low[frame.node], index[d]);
+          }
+          continue;
+        }
+
+        uint64_t l = frame.node;
+        frames.pop_back();
+        if (!frames.empty()) {
+          uint64_t parent = frames.back().node;
+          low[parent] = std::min(low[parent], low[l]);
+        }
+        if (low[l] == index[l]) {
+          uint64_t member = 0;
+          do {
+            member = stack.back();
+            stack.pop_back();
+            on_stack[member] = 0;
+            components_[nodes[member]] = nodes[l];
+          } while (member != l);
+        }
+      }
+    }
+  }
+
+  /// Labels each component with its smallest node
+  void Canonicalize() {
+    katana::NUMAArray<std::atomic<uint64_t>> smallest;
+    smallest.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) {
+          smallest[n].store(kUnassigned, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) { katana::atomicMin(smallest[components_[n]], n); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) {
+          components_[n] =
+              smallest[components_[n]].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+
+private:
+  uint64_t DegreeProduct(Node n) const {
+    return uint64_t{view_.degree(n)} * in_.degree(n);
+  }
+
+  template <typename Topo>
+  bool HasRemainingNeighbor(const Topo& topo, Node n) const {
+    for (auto e : topo.edges(n)) {
+      Node dst = topo.edge_dest(e);
+      if (dst != n && Remains(dst)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template <typename Topo>
+  void AddRemainingNeighbors(const Topo& topo, Node n, Frontier* next) const {
+    for (auto e : topo.edges(n)) {
+      Node dst = topo.edge_dest(e);
+      if (Remains(dst)) {
+        next->Add(dst);
+      }
+    }
+  }
+
+  const BiDirView& view_;
+  InEdges in_;
+  uint64_t num_nodes_;
+  katana::NUMAArray<uint64_t> components_;
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    StronglyConnectedComponentsPlan plan) {
+  if (plan.algorithm() != StronglyConnectedComponentsPlan::kMultistep &&
+      plan.algorithm() != StronglyConnectedComponentsPlan::kColoring &&
+      plan.algorithm() != StronglyConnectedComponentsPlan::kSerial) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  auto view = pg->BuildView<BiDirView>();
+
+  katana::StatTimer exec_time("StronglyConnectedComponents");
+  exec_time.start();
+  ComponentFinder finder(view);
+  switch (plan.algorithm()) {
+  case StronglyConnectedComponentsPlan::kMultistep:
+    finder.Trim();
+    finder.ForwardBackward();
+    finder.Coloring(plan.serial_threshold());
+    break;
+  case StronglyConnectedComponentsPlan::kColoring:
+    finder.Trim();
+    finder.Coloring(plan.serial_threshold());
+    break;
+  default:
+    finder.Serial();
+    break;
+  }
+  finder.Canonicalize();
+  exec_time.stop();
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeComponent>>(
+      pg, {output_property_name}));
+  auto graph =
+      KATANA_CHECKED(SccGraph::Make(pg, {output_property_name}, {}));
+
+  const auto& components = finder.components();
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const SccGraph::Node& n) {
+        graph.GetData<NodeComponent>(n) = components[n];
+      },
+      katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(SccGraph::Make(pg, {property_name}, {}));
+  auto view = pg->BuildView<BiDirView>();
+  InEdges in(&view);
+  uint64_t num_nodes = graph.num_nodes();
+  auto component = [&](Node n) -> uint64_t {
+    return graph.GetData<NodeComponent>(n);
+  };
+
+  katana::GReduceLogicalOr bad_label;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t c = component(n);
+        bad_label.update(c > n || component(c) != c);
+      },
+      katana::no_stats());
+  if (bad_label.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "some component is not labeled with its smallest node");
+  }
+
+  // Every node is reached from, and reaches, the label of its component
+  // without leaving the component
+  auto same_component = [&](Node src, Node dst) {
+    return component(src) == component(dst);
+  };
+  for (bool backward : {false, true}) {
+    auto reps = std::make_unique<Frontier>(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          if (component(n) == n) {
+            reps->Add(n);
+          }
+        },
+        katana::no_stats());
+    katana::DynamicBitset reached;
+    reached.resize(num_nodes);
+    if (backward) {
+      Search(
+          in, view, std::move(reps), same_component, [](Node) { return true; },
+          &reached, "StronglyConnectedComponentsAssertValid");
+    } else {
+      Search(
+          view, in, std::move(reps), same_component, [](Node) { return true; },
+          &reached, "StronglyConnectedComponentsAssertValid");
+    }
+    if (reached.count() != num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "some component is not strongly connected");
+    }
+  }
+
+  // The components are maximal if the edges between them form no cycle,
+  // which topological sorting by Kahn's algorithm finds
+  std::vector<uint64_t> member_begin(num_nodes + 1, 0);
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    member_begin[component(n) + 1] += 1;
+  }
+  std::partial_sum(
+      member_begin.begin(), member_begin.end(), member_begin.begin());
+  std::vector<Node> members(num_nodes);
+  std::vector<uint64_t> cursor(member_begin.begin(), member_begin.end() - 1);
+  std::vector<uint64_t> pending(num_nodes, 0);
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    members[cursor[component(n)]++] = n;
+    for (auto e : view.edges(n)) {
+      uint64_t c = component(view.edge_dest(e));
+      if (c != component(n)) {
+        pending[c] += 1;
+      }
+    }
+  }
+
+  std::vector<uint64_t> ready;
+  uint64_t num_components = 0;
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    if (component(n) == n) {
+      num_components += 1;
+      if (pending[n] == 0) {
+        ready.push_back(n);
+      }
+    }
+  }
+  uint64_t num_sorted = 0;
+  while (!ready.empty()) {
+    uint64_t c = ready.back();
+    ready.pop_back();
+    num_sorted += 1;
+    for (uint64_t i = member_begin[c]; i < member_begin[c + 1]; ++i) {
+      for (auto e : view.edges(members[i])) {
+        uint64_t dst = component(view.edge_dest(e));
+        if (dst != c && --pending[dst] == 0) {
+          ready.push_back(dst);
+        }
+      }
+    }
+  }
+  if (num_sorted != num_components) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the edges between components form a cycle");
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<StronglyConnectedComponentsStatistics>
+katana::analytics::StronglyConnectedComponentsStatistics::Compute(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto graph = KATANA_CHECKED(SccGraph::Make(pg, {property_name}, {}));
+  uint64_t num_nodes = graph.num_nodes();
+
+  katana::NUMAArray<std::atomic<uint64_t>> sizes;
+  sizes.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { sizes[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::GReduceLogicalOr bad_label;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const SccGraph::Node& n) {
+        uint64_t c = graph.GetData<NodeComponent>(n);
+        if (c >= num_nodes) {
+          bad_label.update(true);
+          return;
+        }
+        sizes[c].fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  if (bad_label.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "property {} does not hold components", property_name);
+  }
+
+  katana::GAccumulator<uint64_t> total_components;
+  katana::GAccumulator<uint64_t> non_trivial_components;
+  katana::GReduceMax<uint64_t> largest;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t size = sizes[n].load(std::memory_order_relaxed);
+        if (size > 0) {
+          total_components += 1;
+        }
+        if (size > 1) {
+          non_trivial_components += 1;
+        }
+        largest.update(size);
+      },
+      katana::no_stats());
+
+  uint64_t largest_component_size = largest.reduce();
+  double largest_component_ratio = 0;
+  if (num_nodes != 0) {
+    largest_component_ratio = double(largest_component_size) / num_nodes;
+  }
+  return StronglyConnectedComponentsStatistics{
+      total_components.reduce(), non_trivial_components.reduce(),
+      largest_component_size, largest_component_ratio};
+}
+
+void
+katana::analytics::StronglyConnectedComponentsStatistics::Print(
+    std::ostream& os) const {
+  os << "Total number of components = " << total_components << std::endl;
+  os << "Total number of non trivial components = "
+     << total_non_trivial_components << std::endl;
+  os << "Number of nodes in the largest component = " << largest_component_size
+     << std::endl;
+  os << "Ratio of nodes in the largest component = " << largest_component_ratio
+     << std::endl;
+}
@@ -19,8 +19,14 @@
 
 #include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
 
+#include <algorithm>
 #include <iostream>
+#include <unordered_set>
 
+#include <arrow/compute/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/PropertyGraph.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
@@ -28,85 +34,172 @@
 namespace {
 
 using namespace katana::analytics;
-using edge_iterator = boost::counting_iterator<uint64_t>;
 
 using SortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 using Node = SortedGraphView::Node;
 using Edge = SortedGraphView::Edge;
 
-katana::Result<std::unique_ptr<katana::PropertyGraph>>
+/// The nodes of a sub-graph by their ids in the graph, with their ids in the
+/// sub-graph
+using NodeIndex = std::vector<std::pair<Node, Node>>;
+
+/// Call fn(m, e) for each edge e of src whose destination is node m of the
+/// sub-graph, by binary search of the smaller of the edges of src and the
+/// nodes of the sub-graph in the larger. Both are sorted by node id, so each
+/// search starts where the last one ended.
+template <typename F>
+void
+ForEachSubGraphEdge(
+    const SortedGraphView& graph, const NodeIndex& index, Node src, F fn) {
+  const Node* dests = graph.dest_data();
+  Edge first = *graph.edges(src).begin();
+  Edge last = *graph.edges(src).end();
+  if (last - first <= index.size()) {
+    auto it = index.begin();
+    for (Edge e = first; e < last; ++e) {
+      it = std::lower_bound(it, index.end(), std::make_pair(dests[e], Node{0}));
+      if (it != index.end() && it->first == dests[e]) {
+        fn(it->second, e);
+      }
+    }
+  } else {
+    const Node* it = dests + first;
+    for (const auto& [dest, m] : index) {
+      it = std::lower_bound(it, dests + last, dest);
+      for (const Node* match = it; match != dests + last && *match == dest;
+           ++match) {
+        fn(m, match - dests);
+      }
+    }
+  }
+}
+
+/// The sub-graph induced by node_set, with only the edges in edge_selection
+/// if it is not null
+katana::Result<SubGraphSelection>
 SubGraphNodeSet(
-    const SortedGraphView& graph, const std::vector<Node>& node_set) {
-  uint64_t num_nodes = node_set.size();
-  // Subgraph topology : out indices
-  katana::NUMAArray<Edge> out_indices;
-  out_indices.allocateInterleaved(num_nodes);
+    const SortedGraphView& graph, std::vector<Node> node_set,
+    const katana::DynamicBitset* edge_selection) {
+  auto is_selected = [&](Edge e) {
+    return !edge_selection ||
+           edge_selection->test(graph.edge_property_index(e));
+  };
 
-  katana::gstl::Vector<katana::gstl::Vector<Node>> subgraph_edges;
-  subgraph_edges.resize(num_nodes);
+  uint64_t num_nodes = node_set.size();
+  NodeIndex index(num_nodes);
+  katana::do_all(
+      katana::iterate(Node(0), Node(num_nodes)),
+      [&](const Node& n) { index[n] = {node_set[n], n}; }, katana::no_stats());
+  katana::ParallelSTL::sort(index.begin(), index.end());
 
+  SubGraphSelection selection;
+  auto& offsets = selection.edge_offsets;
+  offsets.resize(num_nodes + 1);
   katana::do_all(
       katana::iterate(Node(0), Node(num_nodes)),
       [&](const Node& n) {
-        Node src = node_set[n];
-
-        auto last = graph.edges(src).end();
-        for (Node m = 0; m < num_nodes; ++m) {
-          auto dest = node_set[m];
-          // Binary search on the edges sorted by destination id
-          for (auto edge_it = graph.find_edge(src, dest);
-               edge_it != last && graph.edge_dest(*edge_it) == dest;
-               ++edge_it) {
-            subgraph_edges[n].push_back(m);
-          }
-        }
-        out_indices[n] = subgraph_edges[n].size();
+        uint64_t num_edges = 0;
+        ForEachSubGraphEdge(graph, index, node_set[n], [&](Node, Edge e) {
+          num_edges += is_selected(e);
+        });
+        offsets[n + 1] = num_edges;
       },
       katana::steal(), katana::loopname("SubgraphExtraction"));
 
   // Prefix sum
   katana::ParallelSTL::partial_sum(
-      out_indices.begin(), out_indices.end(), out_indices.begin());
-  uint64_t num_edges = out_indices[num_nodes - 1];
-
-  // Subgraph topology : out dests
-  katana::NUMAArray<Node> out_dests;
-  out_dests.allocateInterleaved(num_edges);
+      offsets.begin() + 1, offsets.end(), offsets.begin() + 1);
+  uint64_t num_edges = offsets[num_nodes];
 
+  selection.edges.resize(num_edges);
+  selection.edge_dests.resize(num_edges);
+  katana::PerThreadStorage<std::vector<std::pair<Node, Edge>>> found_edges;
   katana::do_all(
       katana::iterate(Node(0), Node(num_nodes)),
       [&](const Node& n) {
-        uint64_t offset = n == 0 ? 0 : out_indices[n - 1];
-        for (Node dest : subgraph_edges[n]) {
-          out_dests[offset] = dest;
+        auto& found = *found_edges.getLocal();
+        found.clear();
+        ForEachSubGraphEdge(graph, index, node_set[n], [&](Node m, Edge e) {
+          if (is_selected(e)) {
+            found.emplace_back(m, e);
+          }
+        });
+        std::sort(found.begin(), found.end());
+        uint64_t offset = offsets[n];
+        for (const auto& [m, e] : found) {
+          selection.edge_dests[offset] = m;
+          selection.edges[offset] = graph.edge_property_index(e);
           offset++;
         }
       },
       katana::steal(), katana::loopname("ConstructTopology"));
 
+  selection.nodes = std::move(node_set);
+  return selection;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+MakeSubGraph(const SubGraphSelection& selection) {
+  // Subgraph topology : out indices
+  katana::NUMAArray<Edge> out_indices;
+  out_indices.allocateInterleaved(selection.num_nodes());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, selection.num_nodes()),
+      [&](uint64_t n) { out_indices[n] = selection.edge_offsets[n + 1]; },
+      katana::no_stats());
+
+  // Subgraph topology : out dests
+  katana::NUMAArray<Node> out_dests;
+  out_dests.allocateInterleaved(selection.num_edges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, selection.num_edges()),
+      [&](uint64_t e) { out_dests[e] = selection.edge_dests[e]; },
+      katana::no_stats());
+
   katana::GraphTopology sub_g_topo{
       std::move(out_indices), std::move(out_dests)};
-  auto sub_g_res = katana::PropertyGraph::Make(std::move(sub_g_topo));
-
-  return sub_g_res;
+  return katana::PropertyGraph::Make(std::move(sub_g_topo));
 }
-}  // namespace
 
-katana::Result<std::unique_ptr<katana::PropertyGraph>>
-katana::analytics::SubGraphExtraction(
-    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
-    SubGraphExtractionPlan plan) {
-  // Remove duplicates from the node vector
-  std::unordered_set<uint32_t> set;
-  std::vector<uint32_t> dedup_node_vec;
-  for (auto n : node_vec) {
-    if (set.insert(n).second) {  // If n wasn't already present.
-      dedup_node_vec.push_back(n);
+/// Gather the rows at ids of the properties named names, which
+/// get_property looks up, into a table
+template <typename T, typename GetProperty>
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeProperties(
+    const std::vector<std::string>& names, GetProperty get_property,
+    const std::vector<T>& ids) {
+  using IdArray = typename arrow::CTypeTraits<T>::ArrayType;
+  auto indices =
+      std::make_shared<IdArray>(ids.size(), arrow::Buffer::Wrap(ids));
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : names) {
+    std::shared_ptr<arrow::ChunkedArray> property = get_property(name);
+    if (!property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no property named {}", name);
+    }
+    auto taken = arrow::compute::Take(property, indices);
+    if (!taken.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "failed to take rows of {}: {}",
+          name, taken.status());
     }
+    fields.emplace_back(arrow::field(name, property->type()));
+    columns.emplace_back(taken.ValueOrDie().chunked_array());
   }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
 
-  if (dedup_node_vec.empty()) {
-    return std::make_unique<katana::PropertyGraph>();
+/// Select the sub-graph induced by the distinct nodes node_vec
+katana::Result<SubGraphSelection>
+SelectDistinct(
+    katana::PropertyGraph* pg, std::vector<Node> node_vec,
+    const katana::DynamicBitset* edge_selection,
+    SubGraphExtractionPlan plan) {
+  if (node_vec.empty()) {
+    return SubGraphSelection{{}, {0}, {}, {}};
   }
 
   SortedGraphView sg = pg->BuildView<SortedGraphView>();
@@ -115,12 +208,118 @@ katana::analytics::SubGraphExtraction(
   switch (plan.algorithm()) {
   case SubGraphExtractionPlan::kNodeSet: {
     execTime.start();
-    auto subgraph = SubGraphNodeSet(sg, dedup_node_vec);
+    auto selection = SubGraphNodeSet(sg, std::move(node_vec), edge_selection);
     execTime.stop();
-    KATANA_LOG_DEBUG_ASSERT(subgraph);
-    return std::move(subgraph.value());
+    return selection;
   }
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
+
+katana::Result<void>
+CheckSelections(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& nodes,
+    const katana::DynamicBitset* edges) {
+  if (nodes.size() != pg->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the node selection has {} nodes but the graph has {}", nodes.size(),
+        pg->num_nodes());
+  }
+  if (edges && edges->size() != pg->num_edges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the edge selection has {} edges but the graph has {}", edges->size(),
+        pg->num_edges());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Construct the sub-graph selection of pg with the named properties
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+Extract(
+    katana::PropertyGraph* pg, const SubGraphSelection& selection,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties) {
+  if (selection.num_nodes() == 0) {
+    return std::make_unique<katana::PropertyGraph>();
+  }
+
+  auto subgraph = KATANA_CHECKED(MakeSubGraph(selection));
+
+  if (!node_properties.empty()) {
+    auto table = KATANA_CHECKED(TakeProperties(
+        node_properties,
+        [&](const std::string& name) { return pg->GetNodeProperty(name); },
+        selection.nodes));
+    KATANA_CHECKED(subgraph->AddNodeProperties(table));
+  }
+  if (!edge_properties.empty()) {
+    auto table = KATANA_CHECKED(TakeProperties(
+        edge_properties,
+        [&](const std::string& name) { return pg->GetEdgeProperty(name); },
+        selection.edges));
+    KATANA_CHECKED(subgraph->AddEdgeProperties(table));
+  }
+  return subgraph;
+}
+
+}  // namespace
+
+katana::Result<SubGraphSelection>
+katana::analytics::SubGraphSelect(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
+    SubGraphExtractionPlan plan) {
+  // Remove duplicates from the node vector
+  std::unordered_set<uint32_t> set;
+  std::vector<uint32_t> dedup_node_vec;
+  for (auto n : node_vec) {
+    if (n >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "node {} is not in the graph",
+          n);
+    }
+    if (set.insert(n).second) {  // If n wasn't already present.
+      dedup_node_vec.push_back(n);
+    }
+  }
+
+  return SelectDistinct(pg, std::move(dedup_node_vec), nullptr, plan);
+}
+
+katana::Result<SubGraphSelection>
+katana::analytics::SubGraphSelect(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& nodes,
+    const katana::DynamicBitset* edges, SubGraphExtractionPlan plan) {
+  KATANA_CHECKED(CheckSelections(pg, nodes, edges));
+  return SelectDistinct(pg, nodes.GetOffsets<Node>(), edges, plan);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
+    SubGraphExtractionPlan plan) {
+  return SubGraphExtraction(pg, node_vec, {}, {}, plan);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties,
+    SubGraphExtractionPlan plan) {
+  auto selection = KATANA_CHECKED(SubGraphSelect(pg, node_vec, plan));
+  return Extract(pg, selection, node_properties, edge_properties);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& nodes,
+    const katana::DynamicBitset* edges,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties,
+    SubGraphExtractionPlan plan) {
+  auto selection = KATANA_CHECKED(SubGraphSelect(pg, nodes, edges, plan));
+  return Extract(pg, selection, node_properties, edge_properties);
+}
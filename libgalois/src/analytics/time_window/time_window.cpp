@@ -0,0 +1,234 @@
+#include "katana/analytics/time_window/time_window.h"
+
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/UnionFind.h"
+#include "katana/analytics/Frontier.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+
+struct ComponentNode : public katana::UnionFindNode<ComponentNode> {
+  ComponentNode() : katana::UnionFindNode<ComponentNode>(this) {}
+};
+
+}  // namespace
+
+struct katana::analytics::TimeWindowedGraph::Impl {
+  Impl(
+      katana::TemporalTopology&& out_edges,
+      katana::TemporalTopology&& in_edges)
+      : out(std::move(out_edges)),
+        in(std::move(in_edges)),
+        out_window(&out),
+        in_window(&in) {}
+
+  katana::TemporalTopology out;
+  katana::TemporalTopology in;
+  katana::TimeWindowTopology out_window;
+  katana::TimeWindowTopology in_window;
+  /// The forest of the components of the edges in components_window
+  katana::NUMAArray<ComponentNode> components;
+  std::optional<katana::TimeWindow> components_window;
+  /// The ranks of the last call of Pagerank, empty before it
+  katana::NUMAArray<double> ranks;
+
+  /// Merge the components of the ends of the out-edges in window of every
+  /// node
+  void Merge(const katana::TimeWindow& window) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, out.num_nodes()),
+        [&](Node src) {
+          for (auto e : out.window_edges(src, window)) {
+            components[src].merge(&components[out.edge_dest(e)]);
+          }
+        },
+        katana::steal(),
+        katana::loopname("TimeWindowedGraph-ConnectedComponents"));
+  }
+};
+
+katana::analytics::TimeWindowedGraph::TimeWindowedGraph(
+    std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+
+katana::analytics::TimeWindowedGraph::~TimeWindowedGraph() = default;
+
+katana::Result<std::unique_ptr<TimeWindowedGraph>>
+katana::analytics::TimeWindowedGraph::Make(
+    const PropertyGraph* pg, const std::string& timestamp_property_name) {
+  auto out =
+      KATANA_CHECKED(TemporalTopology::Make(pg, timestamp_property_name));
+  auto in = KATANA_CHECKED(TemporalTopology::Make(
+      pg, timestamp_property_name, /*transpose=*/true));
+
+  std::unique_ptr<TimeWindowedGraph> graph(new TimeWindowedGraph(
+      std::make_unique<Impl>(std::move(out), std::move(in))));
+  if (graph->min_time() <= graph->max_time()) {
+    KATANA_CHECKED(
+        graph->SetWindow({graph->min_time(), graph->max_time() + 1}));
+  }
+  return graph;
+}
+
+katana::Result<void>
+katana::analytics::TimeWindowedGraph::SetWindow(const TimeWindow& window) {
+  if (window.begin > window.end) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the window begins at {}, after its end at {}", window.begin,
+        window.end);
+  }
+  impl_->out_window.SetWindow(window);
+  impl_->in_window.SetWindow(window);
+  return katana::ResultSuccess();
+}
+
+const katana::TimeWindow&
+katana::analytics::TimeWindowedGraph::window() const {
+  return impl_->out_window.window();
+}
+
+uint64_t
+katana::analytics::TimeWindowedGraph::num_nodes() const {
+  return impl_->out.num_nodes();
+}
+
+uint64_t
+katana::analytics::TimeWindowedGraph::num_edges() const {
+  return impl_->out_window.num_edges();
+}
+
+int64_t
+katana::analytics::TimeWindowedGraph::min_time() const {
+  return impl_->out.min_time();
+}
+
+int64_t
+katana::analytics::TimeWindowedGraph::max_time() const {
+  return impl_->out.max_time();
+}
+
+katana::Result<std::vector<uint32_t>>
+katana::analytics::TimeWindowedGraph::Bfs(uint32_t source) {
+  uint64_t num_nodes = this->num_nodes();
+  if (source >= num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} is not a node of the {} nodes", source, num_nodes);
+  }
+
+  std::vector<uint32_t> distances(num_nodes, kUnreachable);
+  distances[source] = 0;
+  auto current = std::make_unique<Frontier>(num_nodes);
+  auto next = std::make_unique<Frontier>(num_nodes);
+  current->Add(source);
+  for (uint32_t level = 1; !current->empty(); ++level) {
+    EdgeMap(
+        impl_->out_window, impl_->in_window, current.get(), next.get(),
+        [&](Node, Node dst) {
+          return __sync_bool_compare_and_swap(
+              &distances[dst], kUnreachable, level);
+        },
+        [&](Node dst) { return distances[dst] == kUnreachable; },
+        "TimeWindowedGraph-Bfs");
+    std::swap(current, next);
+  }
+  return distances;
+}
+
+std::vector<uint32_t>
+katana::analytics::TimeWindowedGraph::ConnectedComponents() {
+  auto& impl = *impl_;
+  uint64_t num_nodes = this->num_nodes();
+  const TimeWindow& window = this->window();
+
+  // Edges only join components, so a window that contains the last one
+  // merges just the edges it adds
+  const auto& last = impl.components_window;
+  if (last && window.begin <= last->begin && last->end <= window.end) {
+    impl.Merge({window.begin, last->begin});
+    impl.Merge({last->end, window.end});
+  } else {
+    if (impl.components.size() != num_nodes) {
+      impl.components.allocateBlocked(num_nodes);
+    }
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) { impl.components.constructAt(n); },
+        katana::no_stats());
+    impl.Merge(window);
+  }
+  impl.components_window = window;
+
+  // The root of a tree is its smallest node, since merge hooks the greater
+  // root under the smaller
+  std::vector<uint32_t> components(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        components[n] =
+            impl.components[n].findAndCompress() - impl.components.data();
+      },
+      katana::no_stats());
+  return components;
+}
+
+std::vector<double>
+katana::analytics::TimeWindowedGraph::Pagerank(PagerankPlan plan) {
+  auto& impl = *impl_;
+  uint64_t num_nodes = this->num_nodes();
+  if (num_nodes == 0) {
+    return {};
+  }
+  if (impl.ranks.size() != num_nodes) {
+    impl.ranks.allocateBlocked(num_nodes);
+    katana::ParallelSTL::fill(
+        impl.ranks.begin(), impl.ranks.end(), 1.0 / num_nodes);
+  }
+
+  double base_score = (1.0 - plan.alpha()) / num_nodes;
+  unsigned int iteration = 0;
+  katana::GAccumulator<double> accum;
+  while (true) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t dst) {
+          double sum = 0;
+          // every in-neighbor in the window has an out-edge in it
+          for (auto e : impl.in_window.edges(dst)) {
+            auto src = impl.in_window.edge_dest(e);
+            sum += impl.ranks[src] / impl.out_window.degree(src);
+          }
+          double value = sum * plan.alpha() + base_score;
+          accum += std::fabs(value - impl.ranks[dst]);
+          impl.ranks[dst] = value;
+        },
+        katana::steal(), katana::chunk_size<PagerankPlan::kChunkSize>(),
+        katana::loopname("TimeWindowedGraph-Pagerank"));
+
+    iteration += 1;
+    if (accum.reduce() <= plan.tolerance() ||
+        iteration >= plan.max_iterations()) {
+      break;
+    }
+    accum.reset();
+  }
+  katana::ReportStatSingle(
+      "TimeWindowedGraph-Pagerank", "Iterations", iteration);
+
+  return std::vector<double>(impl.ranks.begin(), impl.ranks.end());
+}
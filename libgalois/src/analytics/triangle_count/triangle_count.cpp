@@ -19,17 +19,42 @@
 
 #include "katana/analytics/triangle_count/triangle_count.h"
 
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+#include <vector>
+
+#include "katana/HubAdjacency.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/SetIntersection.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Planner.h"
+#include "katana/analytics/TriangleEnumeration.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
 
 using SortedGraphView =
     katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+using EdgesSortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 using Node = SortedGraphView::Node;
+using Edge = SortedGraphView::Edge;
 using edge_iterator = SortedGraphView::edge_iterator;
 
+struct NodeTriangleCount : public katana::PODProperty<uint64_t> {};
+struct EdgeTriangleCount : public katana::PODProperty<uint64_t> {};
+
+using NodeCountGraph =
+    katana::TypedPropertyGraph<std::tuple<NodeTriangleCount>, std::tuple<>>;
+using EdgeCountGraph =
+    katana::TypedPropertyGraph<std::tuple<>, std::tuple<EdgeTriangleCount>>;
+
 constexpr static const unsigned kChunkSize = 64U;
 
+/// The memory for the bitmaps of the hubs of NodeIteratingAlgo
+constexpr static const size_t kHubBitmapBytes = size_t{1} << 28;
+
 /**
  * Like std::lower_bound but doesn't dereference iterators. Returns the first
  * element for which comp is not true.
@@ -59,31 +84,6 @@ LowerBound(Iterator first, Iterator last, Compare comp) {
   return first;
 }
 
-/**
- * std::set_intersection over edge_iterators.
- */
-template <typename G>
-size_t
-CountEqual(
-    const G& g, typename G::edge_iterator aa, typename G::edge_iterator ea,
-    typename G::edge_iterator bb, typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::Node a = g.edge_dest(*aa);
-    typename G::Node b = g.edge_dest(*bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
-}
-
 template <typename G>
 struct LessThan {
   const G& g;
@@ -114,9 +114,15 @@ struct GreaterThanOrEqual {
  * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
  * Thesis. Universitat Karlsruhe. 2007.
  */
+template <typename Graph>
 size_t
-NodeIteratingAlgo(const SortedGraphView* graph) {
+NodeIteratingAlgo(const Graph* graph) {
   katana::GAccumulator<size_t> numTriangles;
+  // Whether A has an edge to B is a bitmap probe rather than a search of its
+  // edges if A is a hub
+  katana::HubAdjacency hubs = katana::HubAdjacency::Make(
+      *graph, katana::HubAdjacency::NumHubsForBudget(
+                  graph->num_nodes(), kHubBitmapBytes));
 
   katana::do_all(
       katana::iterate(*graph),
@@ -125,19 +131,23 @@ NodeIteratingAlgo(const SortedGraphView* graph) {
         // [first, ea) [n] [bb, last)
         edge_iterator first = graph->edges(n).begin();
         edge_iterator last = graph->edges(n).end();
-        edge_iterator ea =
-            LowerBound(first, last, LessThan<SortedGraphView>(*graph, n));
+        edge_iterator ea = LowerBound(first, last, LessThan<Graph>(*graph, n));
         edge_iterator bb = LowerBound(
-            first, last, GreaterThanOrEqual<SortedGraphView>(*graph, n));
+            first, last, GreaterThanOrEqual<Graph>(*graph, n));
 
         for (; bb != last; ++bb) {
           Node B = graph->edge_dest(*bb);
           for (auto aa = first; aa != ea; ++aa) {
             Node A = graph->edge_dest(*aa);
+            if (hubs.is_hub(A)) {
+              if (hubs.HubHasEdge(A, B)) {
+                numTriangles += 1;
+              }
+              continue;
+            }
             edge_iterator vv = graph->edges(A).begin();
             edge_iterator ev = graph->edges(A).end();
-            edge_iterator it =
-                LowerBound(vv, ev, LessThan<SortedGraphView>(*graph, B));
+            edge_iterator it = LowerBound(vv, ev, LessThan<Graph>(*graph, B));
             if (it != ev && graph->edge_dest(*it) == B) {
               numTriangles += 1;
             }
@@ -151,32 +161,56 @@ NodeIteratingAlgo(const SortedGraphView* graph) {
 }
 
 /**
- * Lambda function to count triangles
+ * \returns the destinations of the edges of n, which are sorted
  */
+template <typename Graph>
+const Node*
+EdgeDests(const Graph* graph, Node n) {
+  return graph->dest_data() + *graph->edges(n).begin();
+}
+
+/**
+ * \returns the number of the sorted dests that are no greater than n
+ */
+size_t
+CountNoGreater(const Node* dests, size_t size, Node n) {
+  return std::upper_bound(dests, dests + size, n) - dests;
+}
+
+/**
+ * Counts the triangles n > v > w by intersecting the neighbors of n and v
+ * below v. The neighbors of a hub n go in a bitmap instead, so that each
+ * intersection takes one pass over the neighbors of v.
+ */
+template <typename Graph>
 void
 OrderedCountFunc(
-    const SortedGraphView* graph, Node n,
+    const Graph* graph, Node n, katana::SetBitmap* bitmap,
     katana::GAccumulator<size_t>& numTriangles) {
-  size_t numTriangles_local = 0;
-  for (auto edges_n : graph->edges(n)) {
-    Node v = graph->edge_dest(edges_n);
-    if (v > n) {
-      break;
-    }
-    edge_iterator it_n = graph->edges(n).begin();
-
-    for (auto edges_v : graph->edges(v)) {
-      auto dst_v = graph->edge_dest(edges_v);
-      if (dst_v > v) {
-        break;
-      }
-      while (graph->edge_dest(*it_n) < dst_v) {
-        it_n++;
-      }
-      if (dst_v == graph->edge_dest(*it_n)) {
-        numTriangles_local += 1;
-      }
+  const Node* n_dests = EdgeDests(graph, n);
+  size_t n_lower = CountNoGreater(n_dests, graph->degree(n), n);
+
+  bool use_bitmap = n_lower >= katana::kBitmapMinSize;
+  if (use_bitmap) {
+    if (bitmap->universe() < graph->num_nodes()) {
+      bitmap->Resize(graph->num_nodes());
     }
+    bitmap->Insert(n_dests, n_lower);
+  }
+
+  size_t numTriangles_local = 0;
+  for (size_t i = 0; i < n_lower; ++i) {
+    Node v = n_dests[i];
+    const Node* v_dests = EdgeDests(graph, v);
+    size_t v_lower = CountNoGreater(v_dests, graph->degree(v), v);
+    // the neighbors of n no greater than v are n_dests[0, i]
+    numTriangles_local +=
+        use_bitmap ? bitmap->IntersectionSize(v_dests, v_lower)
+                   : katana::IntersectionSize(n_dests, i + 1, v_dests, v_lower);
+  }
+
+  if (use_bitmap) {
+    bitmap->Erase(n_dests, n_lower);
   }
   numTriangles += numTriangles_local;
 }
@@ -184,12 +218,16 @@ OrderedCountFunc(
 /*
  * Simple counting loop, instead of binary searching.
  */
+template <typename Graph>
 size_t
-OrderedCountAlgo(const SortedGraphView* graph) {
+OrderedCountAlgo(const Graph* graph) {
   katana::GAccumulator<size_t> numTriangles;
+  katana::PerThreadStorage<katana::SetBitmap> bitmaps;
   katana::do_all(
       katana::iterate(*graph),
-      [&](const Node& n) { OrderedCountFunc(graph, n, numTriangles); },
+      [&](const Node& n) {
+        OrderedCountFunc(graph, n, bitmaps.getLocal(), numTriangles);
+      },
       katana::chunk_size<kChunkSize>(), katana::steal(),
       katana::loopname("TriangleCount_OrderedCountAlgo"));
 
@@ -209,8 +247,9 @@ OrderedCountAlgo(const SortedGraphView* graph) {
  * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
  * Thesis. Universitat Karlsruhe. 2007.
  */
+template <typename Graph>
 size_t
-EdgeIteratingAlgo(const SortedGraphView* graph) {
+EdgeIteratingAlgo(const Graph* graph) {
   struct WorkItem {
     Node src;
     Node dst;
@@ -232,8 +271,15 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
       },
       katana::loopname("TriangleCount_Initialize"));
 
+  // The cost of the intersections varies widely, so iterate over a
+  // contiguous copy of the items, whose range do_all can split and steal
+  // from, rather than over the lists of items of each thread
+  katana::NUMAArray<WorkItem> work;
+  items.compact(&work);
+  items.clear();
+
   katana::do_all(
-      katana::iterate(items),
+      katana::iterate(work),
       [&](const WorkItem& w) {
         // Compute intersection of range (w.src, w.dst) in neighbors of
         // w.src and w.dst
@@ -243,15 +289,17 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
         edge_iterator bend = graph->edges(w.dst).end();
 
         edge_iterator aa = LowerBound(
-            abegin, aend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
+            abegin, aend, GreaterThanOrEqual<Graph>(*graph, w.src));
         edge_iterator ea =
-            LowerBound(abegin, aend, LessThan<SortedGraphView>(*graph, w.dst));
+            LowerBound(abegin, aend, LessThan<Graph>(*graph, w.dst));
         edge_iterator bb = LowerBound(
-            bbegin, bend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
+            bbegin, bend, GreaterThanOrEqual<Graph>(*graph, w.src));
         edge_iterator eb =
-            LowerBound(bbegin, bend, LessThan<SortedGraphView>(*graph, w.dst));
+            LowerBound(bbegin, bend, LessThan<Graph>(*graph, w.dst));
 
-        numTriangles += CountEqual(*graph, aa, ea, bb, eb);
+        const Node* dests = graph->dest_data();
+        numTriangles += katana::IntersectionSize(
+            dests + *aa, ea - aa, dests + *bb, eb - bb);
       },
       katana::loopname("TriangleCount_EdgeIteratingAlgo"),
       katana::chunk_size<kChunkSize>(), katana::steal());
@@ -259,6 +307,33 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
   return numTriangles.reduce();
 }
 
+template <typename Graph>
+katana::Result<uint64_t>
+CountTriangles(const Graph* graph, const TriangleCountPlan& plan) {
+  katana::EnsurePreallocated(1, 16 * (graph->num_nodes() + graph->num_edges()));
+  katana::ReportPageAllocGuard page_alloc;
+
+  size_t total_count;
+  katana::StatTimer execTime("TriangleCount", "TriangleCount");
+  execTime.start();
+  switch (plan.algorithm()) {
+  case TriangleCountPlan::kNodeIteration:
+    total_count = NodeIteratingAlgo(graph);
+    break;
+  case TriangleCountPlan::kEdgeIteration:
+    total_count = EdgeIteratingAlgo(graph);
+    break;
+  case TriangleCountPlan::kOrderedCount:
+    total_count = OrderedCountAlgo(graph);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  execTime.stop();
+
+  return total_count;
+}
+
 katana::Result<uint64_t>
 katana::analytics::TriangleCount(
     katana::PropertyGraph* pg, TriangleCountPlan plan) {
@@ -267,13 +342,7 @@ katana::analytics::TriangleCount(
 
   timer_graph_read.start();
 
-  SortedGraphView sorted_view = pg->BuildView<SortedGraphView>();
-
-  // TODO(amber): Today we sort unconditionally. Figure out a way to re-enable the
-  // logic below
-#if 0
-  bool relabel = false;;
-
+  bool relabel = false;
   switch (plan.relabeling()) {
   case TriangleCountPlan::kNoRelabel:
     relabel = false;
@@ -283,63 +352,171 @@ katana::analytics::TriangleCount(
     break;
   case TriangleCountPlan::kAutoRelabel:
     timer_auto_algo.start();
-    relabel = IsApproximateDegreeDistributionPowerLaw(*pg);
+    relabel = ChooseRelabeling(pg->GetTopologyStatistics());
     timer_auto_algo.stop();
     break;
   default:
     return katana::ErrorCode::AssertionFailed;
   }
 
-  std::unique_ptr<katana::PropertyGraph> mutable_pfg;
-  if (relabel || !plan.edges_sorted()) {
-    // Copy the graph so we don't mutate the users graph.
-    auto mutable_pfg_result = pg->Copy({}, {});
-    if (!mutable_pfg_result) {
-      return mutable_pfg_result.error();
-    }
-    mutable_pfg = std::move(mutable_pfg_result.value());
-    pg = mutable_pfg.get();
-  }
-
+  // The views sort the edges (and relabel the nodes) of a copy of the
+  // topology kept with pg, so edges_sorted() is not needed to skip a sort of
+  // pg and neither relabeling changes pg
   if (relabel) {
-    katana::StatTimer timer_relabel("GraphRelabelTimer", "TriangleCount");
-    timer_relabel.start();
-    if (auto r = katana::SortNodesByDegree(pg); !r) {
-      return r.error();
-    }
-    timer_relabel.stop();
+    SortedGraphView sorted_view = pg->BuildView<SortedGraphView>();
+    timer_graph_read.stop();
+    return CountTriangles(&sorted_view, plan);
   }
+  EdgesSortedGraphView sorted_view = pg->BuildView<EdgesSortedGraphView>();
+  timer_graph_read.stop();
+  return CountTriangles(&sorted_view, plan);
+}
+
+namespace {
+
+/// The triangles one thread found and has not passed on yet
+struct TriangleBuffer {
+  katana::SetBitmap bitmap;
+  std::vector<katana::analytics::Triangle> triangles;
+};
 
-  // If we relabel we must also sort. Relabeling will break the sorting.
-  if (relabel || !plan.edges_sorted()) {
-    if (auto r = katana::SortAllEdgesByDest(pg); !r) {
-      return r.error();
+}  // namespace
+
+katana::Result<uint64_t>
+katana::analytics::EnumerateTriangles(
+    katana::PropertyGraph* pg, const TriangleBatchFn& fn) {
+  EdgesSortedGraphView view = pg->BuildView<EdgesSortedGraphView>();
+
+  katana::StatTimer exec_time("EnumerateTriangles", "TriangleCount");
+  exec_time.start();
+  katana::GAccumulator<uint64_t> num_triangles;
+  katana::PerThreadStorage<TriangleBuffer> buffers;
+  auto flush = [&](TriangleBuffer* buffer) {
+    fn(buffer->triangles.data(), buffer->triangles.size());
+    num_triangles += buffer->triangles.size();
+    buffer->triangles.clear();
+  };
+  katana::do_all(
+      katana::iterate(view),
+      [&](const Node& n) {
+        TriangleBuffer* buffer = buffers.getLocal();
+        ForEachOrderedTriangle(
+            view, n, &buffer->bitmap, [&](Edge nv, Edge nw, Edge vw) {
+              buffer->triangles.emplace_back(Triangle{
+                  n, view.edge_dest(nv), view.edge_dest(nw),
+                  view.edge_property_index(nv), view.edge_property_index(nw),
+                  view.edge_property_index(vw)});
+              if (buffer->triangles.size() == kTriangleBatchSize) {
+                flush(buffer);
+              }
+            });
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("EnumerateTriangles"));
+  katana::on_each([&](unsigned, unsigned) {
+    TriangleBuffer* buffer = buffers.getLocal();
+    if (!buffer->triangles.empty()) {
+      flush(buffer);
     }
-  }
+  });
+  exec_time.stop();
 
-  timer_graph_read.stop();
-#endif
+  return num_triangles.reduce();
+}
 
-  katana::EnsurePreallocated(1, 16 * (pg->num_nodes() + pg->num_edges()));
-  katana::ReportPageAllocGuard page_alloc;
+katana::Result<void>
+katana::analytics::LocalTriangleCount(
+    katana::PropertyGraph* pg, const std::string& node_output_property_name,
+    const std::string& edge_output_property_name) {
+  EdgesSortedGraphView view = pg->BuildView<EdgesSortedGraphView>();
+
+  katana::StatTimer exec_time("LocalTriangleCount", "TriangleCount");
+  exec_time.start();
+  katana::NUMAArray<std::atomic<uint64_t>> node_counts;
+  node_counts.allocateBlocked(view.num_nodes());
+  katana::NUMAArray<std::atomic<uint64_t>> edge_counts;
+  edge_counts.allocateBlocked(view.num_edges());
+  katana::do_all(
+      katana::iterate(view),
+      [&](const Node& n) {
+        node_counts[n].store(0, std::memory_order_relaxed);
+        for (auto e : view.edges(n)) {
+          edge_counts[e].store(0, std::memory_order_relaxed);
+        }
+      },
+      katana::no_stats());
 
-  size_t total_count;
-  katana::StatTimer execTime("TriangleCount", "TriangleCount");
-  execTime.start();
-  switch (plan.algorithm()) {
-  case TriangleCountPlan::kNodeIteration:
-    total_count = NodeIteratingAlgo(&sorted_view);
-    break;
-  case TriangleCountPlan::kEdgeIteration:
-    total_count = EdgeIteratingAlgo(&sorted_view);
-    break;
-  case TriangleCountPlan::kOrderedCount:
-    total_count = OrderedCountAlgo(&sorted_view);
-    break;
-  default:
-    return katana::ErrorCode::InvalidArgument;
+  katana::PerThreadStorage<katana::SetBitmap> bitmaps;
+  katana::do_all(
+      katana::iterate(view),
+      [&](const Node& n) {
+        ForEachOrderedTriangle(
+            view, n, bitmaps.getLocal(), [&](Edge nv, Edge nw, Edge vw) {
+              for (Node m : {n, view.edge_dest(nv), view.edge_dest(nw)}) {
+                node_counts[m].fetch_add(1, std::memory_order_relaxed);
+              }
+              for (Edge e : {nv, nw, vw}) {
+                edge_counts[e].fetch_add(1, std::memory_order_relaxed);
+              }
+            });
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("LocalTriangleCount"));
+
+  // The triangles counted only the edges down from the higher node; the
+  // edges up get the counts of their reverses
+  katana::do_all(
+      katana::iterate(view),
+      [&](const Node& n) {
+        for (auto e : view.edges(n)) {
+          Node dest = view.edge_dest(e);
+          if (dest <= n) {
+            continue;
+          }
+          const Node* begin = EdgeDests(&view, dest);
+          const Node* end = begin + view.degree(dest);
+          const Node* it = std::lower_bound(begin, end, n);
+          if (it != end && *it == n) {
+            Edge reverse = *view.edges(dest).begin() + (it - begin);
+            edge_counts[e].store(
+                edge_counts[reverse].load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  exec_time.stop();
+
+  if (!node_output_property_name.empty()) {
+    KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeTriangleCount>>(
+        pg, {node_output_property_name}));
+    auto graph = KATANA_CHECKED(
+        NodeCountGraph::Make(pg, {node_output_property_name}, {}));
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const NodeCountGraph::Node& n) {
+          graph.GetData<NodeTriangleCount>(n) =
+              node_counts[n].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
   }
-  execTime.stop();
 
-  return total_count;
+  if (!edge_output_property_name.empty()) {
+    KATANA_CHECKED(ConstructEdgeProperties<std::tuple<EdgeTriangleCount>>(
+        pg, {edge_output_property_name}));
+    auto graph = KATANA_CHECKED(
+        EdgeCountGraph::Make(pg, {}, {edge_output_property_name}));
+    katana::do_all(
+        katana::iterate(view),
+        [&](const Node& n) {
+          for (auto e : view.edges(n)) {
+            graph.GetEdgeData<EdgeTriangleCount>(
+                view.edge_property_index(e)) =
+                edge_counts[e].load(std::memory_order_relaxed);
+          }
+        },
+        katana::no_stats());
+  }
+
+  return katana::ResultSuccess();
 }
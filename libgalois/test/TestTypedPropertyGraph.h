@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBGALOIS_TESTTYPEDPROPERTYGRAPH_H_
 #define KATANA_LIBGALOIS_TESTTYPEDPROPERTYGRAPH_H_
 
+#include <memory>
+#include <vector>
+
 #include <arrow/api.h>
 #include <arrow/type_traits.h>
 
@@ -58,6 +61,36 @@ public:
   }
 };
 
+/// MakeCsrTopology makes the topology whose node n has edges to the nodes of
+/// adjacency[n], in order, e.g., sorted and distinct if they are std::sets.
+///
+/// \tparam Adjacency is a sequence of sequences of node ids
+template <typename Adjacency>
+katana::GraphTopology
+MakeCsrTopology(const Adjacency& adjacency) {
+  std::vector<katana::GraphTopology::Edge> adj_indices;
+  std::vector<katana::GraphTopology::Node> dests;
+
+  adj_indices.reserve(adjacency.size());
+  for (const auto& neighbors : adjacency) {
+    dests.insert(dests.end(), neighbors.begin(), neighbors.end());
+    adj_indices.push_back(dests.size());
+  }
+
+  return katana::GraphTopology(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+}
+
+/// MakeCsrGraph makes a property graph without properties whose topology is
+/// MakeCsrTopology(adjacency).
+template <typename Adjacency>
+std::unique_ptr<katana::PropertyGraph>
+MakeCsrGraph(const Adjacency& adjacency) {
+  auto g_res = katana::PropertyGraph::Make(MakeCsrTopology(adjacency));
+  KATANA_LOG_ASSERT(g_res);
+  return std::move(g_res.value());
+}
+
 /// MakeFileGraph makes a file graph with the specified number of nodes and
 /// properties and using the given topology policy.
 ///
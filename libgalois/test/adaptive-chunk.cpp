@@ -0,0 +1,93 @@
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+#include "katana/WorkList.h"
+
+namespace {
+
+using FIFO = katana::PerSocketAdaptiveChunkFIFO<512, int>;
+
+/// Busy-wait for about nanos nanoseconds
+void
+Spin(int64_t nanos) {
+  auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(nanos);
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+/// Pop num_items items that each take item_nanos to process
+unsigned
+ChunkSizeAfter(int num_items, int64_t item_nanos) {
+  FIFO wl;
+  for (int i = 0; i < num_items; ++i) {
+    wl.push(i);
+  }
+  int popped = 0;
+  while (auto item = wl.pop()) {
+    KATANA_LOG_ASSERT(item.value() == popped);
+    ++popped;
+    Spin(item_nanos);
+  }
+  KATANA_LOG_ASSERT(popped == num_items);
+  return wl.chunk_size();
+}
+
+/// Cheap items get larger chunks than the initial ones and expensive items
+/// smaller ones
+void
+TestAdapt() {
+  unsigned cheap = ChunkSizeAfter(100000, 0);
+  KATANA_LOG_VASSERT(
+      cheap > FIFO::kInitialChunkSize, "chunk size {} after cheap items",
+      cheap);
+  unsigned expensive = ChunkSizeAfter(2000, 5000);
+  KATANA_LOG_VASSERT(
+      expensive < FIFO::kInitialChunkSize,
+      "chunk size {} after expensive items", expensive);
+}
+
+/// Expand a complete binary tree of \param depth levels from each of
+/// \param num_roots roots
+template <typename WL>
+void
+TestForEach(uint32_t num_roots, uint32_t depth) {
+  struct Item {
+    uint32_t level;
+  };
+  std::vector<Item> roots(num_roots, Item{0});
+
+  katana::GAccumulator<uint64_t> visited;
+  katana::for_each(
+      katana::iterate(roots),
+      [&](const Item& item, katana::UserContext<Item>& ctx) {
+        visited += 1;
+        if (item.level + 1 < depth) {
+          ctx.push(Item{item.level + 1});
+          ctx.push(Item{item.level + 1});
+        }
+      },
+      katana::wl<WL>(), katana::disable_conflict_detection());
+
+  uint64_t expected = uint64_t{num_roots} * ((uint64_t{1} << depth) - 1);
+  KATANA_LOG_VASSERT(
+      visited.reduce() == expected, "visited {} expected {}", visited.reduce(),
+      expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestAdapt();
+  TestForEach<katana::PerSocketAdaptiveChunkFIFO<>>(1, 16);
+  TestForEach<katana::PerSocketAdaptiveChunkFIFO<64>>(64, 10);
+  TestForEach<katana::PerSocketAdaptiveChunkLIFO<>>(1, 16);
+
+  return 0;
+}
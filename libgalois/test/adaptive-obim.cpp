@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "katana/AdaptiveObim.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+struct Identity {
+  int operator()(int v) const { return v; }
+};
+
+template <bool Concurrent>
+using AdaptiveObim = katana::AdaptiveOrderedByIntegerMetric<
+    Identity, katana::PerSocketChunkFIFO<>, int, int, Concurrent>;
+
+/// Pop every item of wl
+std::vector<int>
+Drain(AdaptiveObim<false>* wl) {
+  std::vector<int> popped;
+  while (std::optional<int> item = wl->pop()) {
+    popped.emplace_back(*item);
+  }
+  return popped;
+}
+
+/// Items pushed before any pop come out in the order of their buckets at
+/// the initial shift, whatever the shift changes to while they are popped
+void
+TestPriorityOrder() {
+  constexpr unsigned kShift = 3;
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> dist(0, 5000);
+  std::vector<int> items(20000);
+  for (int& item : items) {
+    item = dist(gen);
+  }
+
+  AdaptiveObim<false> wl(Identity(), kShift);
+  wl.push(items.begin(), items.end());
+  std::vector<int> popped = Drain(&wl);
+
+  KATANA_LOG_ASSERT(popped.size() == items.size());
+  for (size_t i = 1; i < popped.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        (popped[i - 1] >> kShift) <= (popped[i] >> kShift),
+        "{} popped before {}", popped[i - 1], popped[i]);
+  }
+  std::sort(items.begin(), items.end());
+  std::sort(popped.begin(), popped.end());
+  KATANA_LOG_ASSERT(popped == items);
+}
+
+/// Buckets with an item each are merged
+void
+TestShiftRisesOnSparseBuckets() {
+  AdaptiveObim<false> wl(Identity(), 0);
+  for (int p = 0; p < 4000; p += 2) {
+    wl.push(p);
+  }
+  KATANA_LOG_ASSERT(Drain(&wl).size() == 2000);
+  KATANA_LOG_VASSERT(wl.shift() > 0, "shift {}", wl.shift());
+}
+
+/// Buckets with many more items than a visit should pop are split
+void
+TestShiftFallsOnDenseBuckets() {
+  constexpr unsigned kShift = 10;
+  constexpr int kNumBuckets = 2 * AdaptiveObim<false>::kAdaptPeriod;
+  constexpr int kItemsPerBucket = 2 * AdaptiveObim<false>::kMaxPopsPerVisit;
+
+  AdaptiveObim<false> wl(Identity(), kShift);
+  for (int b = 0; b < kNumBuckets; ++b) {
+    for (int i = 0; i < kItemsPerBucket; ++i) {
+      wl.push((b << kShift) + i % (1 << kShift));
+    }
+  }
+  KATANA_LOG_ASSERT(
+      Drain(&wl).size() == static_cast<size_t>(kNumBuckets * kItemsPerBucket));
+  KATANA_LOG_VASSERT(wl.shift() < kShift, "shift {}", wl.shift());
+}
+
+/// Every item pushed by a parallel loop is processed once
+void
+TestParallel() {
+  constexpr int kNumItems = 100000;
+  std::vector<int> initial;
+  for (int i = 0; i < kNumItems; i += 100) {
+    initial.emplace_back(i);
+  }
+  std::vector<std::atomic<uint32_t>> visits(kNumItems);
+  katana::for_each(
+      katana::iterate(initial),
+      [&](int item, katana::UserContext<int>& ctx) {
+        visits[item].fetch_add(1);
+        if (item % 100 != 99) {
+          ctx.push(item + 1);
+        }
+      },
+      katana::wl<AdaptiveObim<true>>(Identity(), 0),
+      katana::disable_conflict_detection(), katana::no_stats());
+
+  for (int i = 0; i < kNumItems; ++i) {
+    KATANA_LOG_VASSERT(visits[i].load() == 1, "item {}", i);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestPriorityOrder();
+  TestShiftRisesOnSparseBuckets();
+  TestShiftFallsOnDenseBuckets();
+  TestParallel();
+
+  return 0;
+}
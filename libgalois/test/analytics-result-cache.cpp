@@ -0,0 +1,110 @@
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/ResultCache.h"
+
+namespace {
+
+/// A chunked array of the uint32s 0, 1, ..., num_values - 1
+std::shared_ptr<arrow::ChunkedArray>
+MakeValues(uint32_t num_values) {
+  arrow::UInt32Builder builder;
+  for (uint32_t i = 0; i < num_values; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(i).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return std::make_shared<arrow::ChunkedArray>(array);
+}
+
+/// The least recently used values are evicted first
+void
+TestEviction() {
+  auto a = MakeValues(100);
+  auto b = MakeValues(100);
+  auto c = MakeValues(100);
+
+  // room for two of the values but not three
+  katana::analytics::AnalyticsResultCache probe;
+  probe.Insert("a", a);
+  uint64_t value_bytes = probe.size_bytes();
+  KATANA_LOG_ASSERT(value_bytes >= 400);
+  katana::analytics::AnalyticsResultCache cache(value_bytes * 5 / 2);
+
+  cache.Insert("a", a);
+  cache.Insert("b", b);
+  KATANA_LOG_ASSERT(cache.num_entries() == 2);
+  KATANA_LOG_ASSERT(cache.size_bytes() == 2 * value_bytes);
+  KATANA_LOG_ASSERT(cache.Find("a") == a);
+  KATANA_LOG_ASSERT(!cache.Find("c"));
+  KATANA_LOG_ASSERT(cache.num_hits() == 1 && cache.num_misses() == 1);
+
+  // b is now the least recently used
+  cache.Insert("c", c);
+  KATANA_LOG_ASSERT(cache.num_entries() == 2);
+  KATANA_LOG_ASSERT(!cache.Find("b"));
+  KATANA_LOG_ASSERT(cache.Find("a") == a && cache.Find("c") == c);
+
+  // replacing an entry does not count it twice
+  cache.Insert("c", b);
+  KATANA_LOG_ASSERT(cache.num_entries() == 2);
+  KATANA_LOG_ASSERT(cache.size_bytes() == 2 * value_bytes);
+  KATANA_LOG_ASSERT(cache.Find("c") == b);
+
+  // values larger than the capacity are not stored
+  cache.Insert("d", MakeValues(1000));
+  KATANA_LOG_ASSERT(!cache.Find("d"));
+  KATANA_LOG_ASSERT(cache.num_entries() == 2);
+
+  cache.Clear();
+  KATANA_LOG_ASSERT(cache.num_entries() == 0 && cache.size_bytes() == 0);
+}
+
+/// Graphs without a version are computed every time
+void
+TestUnversioned() {
+  constexpr uint32_t kNumNodes = 10;
+  auto pg = MakeCsrGraph(
+      std::vector<std::vector<katana::GraphTopology::Node>>(kNumNodes));
+  KATANA_LOG_ASSERT(!pg->rdg_version());
+  KATANA_LOG_ASSERT(!katana::analytics::AnalyticsResultCache::MakeKey(
+      pg.get(), "Test", ""));
+
+  katana::analytics::AnalyticsResultCache cache;
+  int num_computes = 0;
+  for (int i = 0; i < 2; ++i) {
+    std::string name = "out" + std::to_string(i);
+    auto res = cache.GetOrCompute(pg.get(), "Test", "", name, [&]() {
+      num_computes += 1;
+      return pg->AddNodeProperties(arrow::Table::Make(
+          arrow::schema({arrow::field(name, arrow::uint32())}),
+          {MakeValues(kNumNodes)}));
+    });
+    KATANA_LOG_ASSERT(res);
+    KATANA_LOG_ASSERT(pg->GetNodeProperty(name));
+  }
+  KATANA_LOG_ASSERT(num_computes == 2);
+  KATANA_LOG_ASSERT(cache.num_entries() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestEviction();
+  TestUnversioned();
+
+  return 0;
+}
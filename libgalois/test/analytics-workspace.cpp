@@ -0,0 +1,70 @@
+#include <cstdint>
+
+#include "katana/EpochArray.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/analytics/Workspace.h"
+
+namespace {
+
+void
+TestEpochArray() {
+  katana::EpochArray<int> array(4, -1);
+  KATANA_LOG_ASSERT(!array.IsSet(0) && array.Get(0) == -1);
+
+  array.Set(1, 5);
+  KATANA_LOG_ASSERT(array.IsSet(1) && array.Get(1) == 5);
+  KATANA_LOG_ASSERT(array.Get(2) == -1);
+
+  array.Reset(7);
+  KATANA_LOG_ASSERT(!array.IsSet(1));
+  for (size_t i = 0; i < array.size(); ++i) {
+    KATANA_LOG_ASSERT(array.Get(i) == 7);
+  }
+}
+
+/// Objects of a slot are reused across calls while slots stay apart
+void
+TestWorkspace() {
+  katana::analytics::AnalyticsWorkspace workspace;
+
+  auto* array = workspace.Array<uint32_t>(0, 100);
+  (*array)[10] = 42;
+  KATANA_LOG_ASSERT(workspace.Array<uint32_t>(0, 100) == array);
+  KATANA_LOG_ASSERT((*array)[10] == 42);
+  KATANA_LOG_ASSERT(workspace.Array<uint32_t>(1, 100) != array);
+  KATANA_LOG_ASSERT(workspace.Array<uint64_t>(0, 100)->size() == 100);
+
+  array = workspace.Array<uint32_t>(0, 200);
+  KATANA_LOG_ASSERT(array->size() == 200);
+
+  auto* bitset = workspace.Bitset(0, 64);
+  bitset->set(3);
+  bitset = workspace.Bitset(0, 64);
+  KATANA_LOG_ASSERT(bitset->size() == 64 && !bitset->test(3));
+
+  auto* cleared = workspace.ClearedArray<uint32_t>(0, 10, 9);
+  cleared->Set(2, 1);
+  cleared = workspace.ClearedArray<uint32_t>(0, 10, 8);
+  KATANA_LOG_ASSERT(cleared->Get(2) == 8);
+
+  auto* bag = workspace.Get<katana::InsertBag<uint32_t>>(0);
+  bag->push(1);
+  KATANA_LOG_ASSERT(workspace.Get<katana::InsertBag<uint32_t>>(0) == bag);
+  KATANA_LOG_ASSERT(!bag->empty());
+
+  workspace.Clear();
+  KATANA_LOG_ASSERT(workspace.Get<katana::InsertBag<uint32_t>>(0)->empty());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestEpochArray();
+  TestWorkspace();
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowParallelBuilder.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr size_t kLength = 10000;
+
+void
+TestStrings() {
+  katana::ArrowParallelStringBuilder<arrow::LargeStringType> builder(kLength);
+  katana::do_all(katana::iterate(size_t{0}, kLength), [&](size_t i) {
+    if (i % 3 != 0) {
+      builder.SetValue(i, std::string(i % 7, 'a' + i % 26));
+    }
+  });
+  KATANA_LOG_ASSERT(!builder.IsValid(0));
+  KATANA_LOG_ASSERT(builder.IsValid(1));
+
+  auto array_result = builder.Finalize();
+  KATANA_LOG_ASSERT(array_result);
+  auto array =
+      std::static_pointer_cast<arrow::LargeStringArray>(array_result.value());
+  KATANA_LOG_ASSERT(array->Validate().ok());
+  KATANA_LOG_ASSERT(array->length() == static_cast<int64_t>(kLength));
+  KATANA_LOG_ASSERT(
+      array->null_count() == static_cast<int64_t>((kLength + 2) / 3));
+  for (size_t i = 0; i < kLength; ++i) {
+    if (i % 3 == 0) {
+      KATANA_LOG_VASSERT(array->IsNull(i), "index {}", i);
+    } else {
+      KATANA_LOG_VASSERT(
+          array->GetString(i) == std::string(i % 7, 'a' + i % 26), "index {}",
+          i);
+    }
+  }
+}
+
+void
+TestLists() {
+  katana::ArrowParallelListBuilder<arrow::UInt32Type> builder(kLength);
+  katana::do_all(
+      katana::iterate(size_t{0}, kLength),
+      [&](size_t i) {
+        std::vector<uint32_t> path(i % 5);
+        for (size_t j = 0; j < path.size(); ++j) {
+          path[j] = i + j;
+        }
+        builder.SetValue(i, path);
+      },
+      katana::steal());
+
+  auto array_result = builder.Finalize();
+  KATANA_LOG_ASSERT(array_result);
+  auto array = std::static_pointer_cast<arrow::ListArray>(array_result.value());
+  KATANA_LOG_ASSERT(array->Validate().ok());
+  KATANA_LOG_ASSERT(array->null_count() == 0);
+  KATANA_LOG_ASSERT(array->value_type()->Equals(arrow::uint32()));
+  auto values = std::static_pointer_cast<arrow::UInt32Array>(array->values());
+  for (size_t i = 0; i < kLength; ++i) {
+    KATANA_LOG_VASSERT(
+        array->value_length(i) == static_cast<int32_t>(i % 5), "index {}", i);
+    for (int32_t j = 0; j < array->value_length(i); ++j) {
+      KATANA_LOG_ASSERT(values->Value(array->value_offset(i) + j) == i + j);
+    }
+  }
+}
+
+void
+TestEmpty() {
+  katana::ArrowParallelStringBuilder<arrow::StringType> builder(3);
+  builder.SetValue(1, "x");
+  builder.UnsetValue(1);
+  auto array_result = builder.Finalize();
+  KATANA_LOG_ASSERT(array_result);
+  KATANA_LOG_ASSERT(array_result.value()->Validate().ok());
+  KATANA_LOG_ASSERT(array_result.value()->null_count() == 3);
+
+  katana::ArrowParallelListBuilder<arrow::DoubleType, arrow::LargeListType>
+      empty(0);
+  auto empty_result = empty.Finalize();
+  KATANA_LOG_ASSERT(empty_result);
+  KATANA_LOG_ASSERT(empty_result.value()->length() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestStrings();
+  TestLists();
+  TestEmpty();
+
+  return 0;
+}
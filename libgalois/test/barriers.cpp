@@ -89,6 +89,7 @@ main(int argc, char** argv) {
 
   gethostname(bname, sizeof(bname));
   using namespace katana;
+  test(CreateAutoBarrier(1));
   test(CreateCountingBarrier(1));
   test(CreateMCSBarrier(1));
   test(CreateTopoBarrier(1));
@@ -0,0 +1,93 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "katana/Cancellation.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 1 << 20;
+
+/// \returns an upper bound on the items a loop that is cancelled from the
+/// start processes: at most one chunk per thread
+uint64_t
+MaxItemsAfterCancel() {
+  return katana::getActiveThreads() * katana::chunk_size<>::value;
+}
+
+template <typename... Args>
+uint64_t
+CountDoAll(const katana::CancellationToken* token, Args... args) {
+  std::atomic<uint64_t> count{0};
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t) { count.fetch_add(1, std::memory_order_relaxed); },
+      katana::cancellation(token), args...);
+  return count.load();
+}
+
+void
+TestDoAll() {
+  katana::CancellationToken token;
+  KATANA_LOG_ASSERT(!token.IsCancelled());
+  KATANA_LOG_ASSERT(CountDoAll(&token) == kNumItems);
+  KATANA_LOG_ASSERT(CountDoAll(&token, katana::steal()) == kNumItems);
+  KATANA_LOG_ASSERT(CountDoAll(nullptr, katana::steal()) == kNumItems);
+
+  token.Cancel();
+  KATANA_LOG_ASSERT(token.IsCancelled());
+  KATANA_LOG_ASSERT(CountDoAll(&token) <= MaxItemsAfterCancel());
+  KATANA_LOG_ASSERT(
+      CountDoAll(&token, katana::steal()) <= MaxItemsAfterCancel());
+}
+
+void
+TestDeadline() {
+  using Clock = katana::CancellationToken::Clock;
+
+  katana::CancellationToken future(Clock::now() + std::chrono::hours(1));
+  KATANA_LOG_ASSERT(!future.IsCancelled());
+  KATANA_LOG_ASSERT(CountDoAll(&future, katana::steal()) == kNumItems);
+
+  katana::CancellationToken past(Clock::now() - std::chrono::seconds(1));
+  KATANA_LOG_ASSERT(past.IsCancelled());
+  KATANA_LOG_ASSERT(
+      CountDoAll(&past, katana::steal()) <= MaxItemsAfterCancel());
+
+  future.SetTimeout(std::chrono::seconds(-1));
+  KATANA_LOG_ASSERT(future.IsCancelled());
+}
+
+void
+TestForEach() {
+  // an operator that would never finish on its own
+  katana::CancellationToken token;
+  std::atomic<uint64_t> count{0};
+  katana::for_each(
+      katana::iterate({uint64_t{0}}),
+      [&](uint64_t item, auto& ctx) {
+        if (count.fetch_add(1) == kNumItems) {
+          token.Cancel();
+        }
+        ctx.push(item + 1);
+      },
+      katana::disable_conflict_detection(), katana::cancellation(&token));
+  KATANA_LOG_ASSERT(token.IsCancelled());
+  KATANA_LOG_ASSERT(count.load() > kNumItems);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestDoAll();
+  TestDeadline();
+  TestForEach();
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include <cstdint>
+#include <vector>
+
+#include "katana/ChaseLevDeque.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+void
+TestDeque() {
+  constexpr int kNumItems = 1000;
+  std::vector<int> items(kNumItems);
+  katana::ChaseLevDeque<int> deque;
+  KATANA_LOG_ASSERT(deque.empty());
+  KATANA_LOG_ASSERT(!deque.Take());
+  KATANA_LOG_ASSERT(!deque.Steal());
+
+  // enough to grow the buffer several times
+  for (int& item : items) {
+    deque.Push(&item);
+  }
+  // thieves take the oldest items and the owner the newest
+  KATANA_LOG_ASSERT(deque.Steal() == &items[0]);
+  KATANA_LOG_ASSERT(deque.Steal() == &items[1]);
+  for (int i = kNumItems - 1; i >= 2; --i) {
+    KATANA_LOG_ASSERT(deque.Take() == &items[i]);
+  }
+  KATANA_LOG_ASSERT(deque.empty());
+  KATANA_LOG_ASSERT(!deque.Take());
+}
+
+/// Expand a complete binary tree of \param depth levels from each of
+/// \param num_roots roots
+void
+TestForEach(uint32_t num_roots, uint32_t depth) {
+  struct Item {
+    uint32_t level;
+  };
+  std::vector<Item> roots(num_roots, Item{0});
+
+  katana::GAccumulator<uint64_t> visited;
+  katana::for_each(
+      katana::iterate(roots),
+      [&](const Item& item, katana::UserContext<Item>& ctx) {
+        visited += 1;
+        if (item.level + 1 < depth) {
+          ctx.push(Item{item.level + 1});
+          ctx.push(Item{item.level + 1});
+        }
+      },
+      katana::wl<katana::ChunkDequeLIFO<16>>(),
+      katana::disable_conflict_detection());
+
+  uint64_t expected = uint64_t{num_roots} * ((uint64_t{1} << depth) - 1);
+  KATANA_LOG_VASSERT(
+      visited.reduce() == expected, "visited {} expected {}", visited.reduce(),
+      expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestDeque();
+  TestForEach(1, 16);
+  TestForEach(64, 10);
+
+  return 0;
+}
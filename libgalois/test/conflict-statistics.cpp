@@ -0,0 +1,99 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Statistics.h"
+
+namespace {
+
+constexpr uint32_t kNumItems = 16;
+constexpr const char* kLoop = "Conflicting";
+
+/// A StatManager that exposes the merged integer statistics
+class TestStatManager : public katana::StatManager {
+public:
+  /// \returns the total of (region, category) or 0 if it was not reported
+  int64_t Total(const std::string& region, const std::string& category) {
+    MergeStats();
+    for (auto i = int_cbegin(); i != int_cend(); ++i) {
+      Str r;
+      Str c;
+      int64_t total;
+      katana::StatTotal::Type type;
+      katana::gstl::Vector<int64_t> values;
+      ReadInt(i, r, c, total, type, values);
+      if (region == r.c_str() && category == c.c_str()) {
+        return total;
+      }
+    }
+    return 0;
+  }
+};
+
+/// Item i conflicts on its first i % 4 attempts
+void
+TestConflicts() {
+  TestStatManager sm;
+  katana::internal::setSysStatManager(nullptr);
+  katana::internal::setSysStatManager(&sm);
+
+  std::vector<std::atomic<uint32_t>> attempts(kNumItems);
+  katana::for_each(
+      katana::iterate(uint32_t{0}, kNumItems),
+      [&](uint32_t item, auto&) {
+        if (attempts[item].fetch_add(1) < item % 4) {
+          katana::signalConflict();
+        }
+      },
+      katana::loopname(kLoop));
+
+  int64_t conflicts = 0;
+  int64_t retried[4] = {};
+  for (uint32_t i = 0; i < kNumItems; ++i) {
+    conflicts += i % 4;
+    retried[i % 4] += 1;
+
+    int64_t samples =
+        sm.Total(kLoop, "ConflictSamples node " + std::to_string(i));
+    KATANA_LOG_VASSERT(
+        samples == i % 4, "node {}: {} samples, expected {}", i, samples,
+        i % 4);
+  }
+
+  KATANA_LOG_ASSERT(sm.Total(kLoop, "Conflicts") == conflicts);
+  KATANA_LOG_ASSERT(sm.Total(kLoop, "ConflictSamples") == conflicts);
+  KATANA_LOG_ASSERT(sm.Total(kLoop, "RetriedCommits1") == retried[1]);
+  KATANA_LOG_ASSERT(
+      sm.Total(kLoop, "RetriedCommits2-3") == retried[2] + retried[3]);
+  KATANA_LOG_ASSERT(sm.Total(kLoop, "RetriedCommits4-7") == 0);
+
+  katana::internal::setSysStatManager(nullptr);
+}
+
+}  // namespace
+
+int
+main() {
+  // sample every conflict
+  setenv("KATANA_CONFLICT_SAMPLING", "1", 1);
+
+  katana::SharedMemSys sys;
+  katana::StatManager* saved = katana::internal::sysStatManager();
+
+  // loops on one thread run without conflict detection
+  if (katana::setActiveThreads(2) < 2) {
+    KATANA_LOG_WARN("skipping test: needs two threads");
+    return 0;
+  }
+  TestConflicts();
+
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+  TestConflicts();
+
+  katana::internal::setSysStatManager(saved);
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/DeltaTopology.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Adjacency = std::vector<std::vector<Node>>;
+
+std::shared_ptr<const katana::GraphTopology>
+MakeTopology(const Adjacency& adj) {
+  return std::make_shared<const katana::GraphTopology>(MakeCsrTopology(adj));
+}
+
+std::vector<Node>
+Sorted(std::vector<Node> v) {
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+/// Check that \param edges_of returns the edges of \param expected, in any
+/// order per node
+template <typename EdgesOf>
+void
+CheckEdges(const Adjacency& expected, uint64_t num_edges, EdgesOf edges_of) {
+  uint64_t expected_edges = 0;
+  for (Node n = 0; n < expected.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        Sorted(edges_of(n)) == Sorted(expected[n]), "edges of {} differ", n);
+    expected_edges += expected[n].size();
+  }
+  KATANA_LOG_ASSERT(num_edges == expected_edges);
+}
+
+void
+CheckDelta(const katana::DeltaTopology& delta, const Adjacency& expected) {
+  CheckEdges(expected, delta.num_edges(), [&](Node n) {
+    auto range = delta.OutEdges(n);
+    std::vector<Node> dests(range.begin(), range.end());
+    KATANA_LOG_ASSERT(dests.size() == delta.OutDegree(n));
+    return dests;
+  });
+}
+
+void
+CheckTopology(const katana::GraphTopology& topo, const Adjacency& expected) {
+  KATANA_LOG_ASSERT(topo.num_nodes() == expected.size());
+  CheckEdges(expected, topo.num_edges(), [&](Node n) {
+    std::vector<Node> dests;
+    for (auto e : topo.edges(n)) {
+      dests.emplace_back(topo.edge_dest(e));
+    }
+    return dests;
+  });
+}
+
+/// Apply random updates to both \param delta and \param expected
+void
+RandomUpdates(
+    katana::DeltaTopology* delta, Adjacency* expected, size_t num_updates,
+    std::mt19937* gen) {
+  std::uniform_int_distribution<Node> node_dist(0, expected->size() - 1);
+  for (size_t i = 0; i < num_updates; ++i) {
+    Node src = node_dist(*gen);
+    auto& neighbors = (*expected)[src];
+    if (!neighbors.empty() && (*gen)() % 3 == 0) {
+      Node dst = neighbors[(*gen)() % neighbors.size()];
+      KATANA_LOG_ASSERT(delta->RemoveEdge(src, dst));
+      neighbors.erase(std::find(neighbors.begin(), neighbors.end(), dst));
+    } else {
+      Node dst = node_dist(*gen);
+      delta->AddEdge(src, dst);
+      neighbors.emplace_back(dst);
+    }
+  }
+}
+
+void
+TestUpdates() {
+  constexpr size_t kNumNodes = 100;
+  std::mt19937 gen(4321);
+
+  Adjacency expected(kNumNodes);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    for (Node i = 0; i < n % 5; ++i) {
+      expected[n].emplace_back((n * 7 + i) % kNumNodes);
+    }
+  }
+  katana::DeltaTopology delta(MakeTopology(expected));
+  CheckDelta(delta, expected);
+  // node 0 has no edges
+  KATANA_LOG_ASSERT(!delta.RemoveEdge(0, 1));
+  KATANA_LOG_ASSERT(delta.num_delta_edges() == 0);
+
+  RandomUpdates(&delta, &expected, 1000, &gen);
+  CheckDelta(delta, expected);
+  CheckTopology(delta.Merge(), expected);
+
+  // updates during a compaction are kept on top of the new base
+  Adjacency at_start = expected;
+  KATANA_LOG_ASSERT(delta.StartCompaction());
+  KATANA_LOG_ASSERT(delta.is_compacting());
+  KATANA_LOG_ASSERT(!delta.StartCompaction());
+  RandomUpdates(&delta, &expected, 200, &gen);
+  CheckDelta(delta, expected);
+  KATANA_LOG_ASSERT(delta.FinishCompaction());
+  KATANA_LOG_ASSERT(!delta.is_compacting());
+  CheckTopology(delta.base(), at_start);
+  CheckDelta(delta, expected);
+  KATANA_LOG_ASSERT(!delta.FinishCompaction());
+
+  // a compaction without later updates leaves an empty overlay
+  KATANA_LOG_ASSERT(delta.StartCompaction());
+  KATANA_LOG_ASSERT(delta.FinishCompaction());
+  KATANA_LOG_ASSERT(delta.num_delta_edges() == 0);
+  CheckTopology(delta.base(), expected);
+}
+
+void
+TestConcurrentAdds() {
+  constexpr size_t kNumNodes = 64;
+  constexpr size_t kEdgesPerNode = 50;
+
+  katana::DeltaTopology delta(MakeTopology(Adjacency(kNumNodes)));
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumNodes * kEdgesPerNode), [&](size_t i) {
+        delta.AddEdge(i % kNumNodes, i / kNumNodes);
+      });
+
+  Adjacency expected(kNumNodes);
+  for (size_t i = 0; i < kNumNodes * kEdgesPerNode; ++i) {
+    expected[i % kNumNodes].emplace_back(i / kNumNodes);
+  }
+  CheckDelta(delta, expected);
+  CheckTopology(delta.Merge(), expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestUpdates();
+  TestConcurrentAdds();
+
+  return 0;
+}
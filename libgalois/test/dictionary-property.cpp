@@ -0,0 +1,173 @@
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/PropertyPredicate.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+#include "tsuba/RDGPrefix.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+constexpr size_t kNumNodes = 1000;
+const std::vector<std::string> kColors{"red", "green", "blue", "black"};
+
+using ColorProperty = katana::DictionaryReadOnlyProperty<>;
+
+/// The color of a node, which is null for every 7th node
+std::optional<std::string>
+Color(size_t node) {
+  if (node % 7 == 0) {
+    return std::nullopt;
+  }
+  return kColors[node % kColors.size()];
+}
+
+/// The node property "color", dictionary-encoded as it is loaded
+std::shared_ptr<arrow::Table>
+MakeColors() {
+  arrow::LargeStringBuilder dictionary_builder;
+  for (const auto& color : kColors) {
+    KATANA_LOG_ASSERT(dictionary_builder.Append(color).ok());
+  }
+  std::shared_ptr<arrow::Array> dictionary;
+  KATANA_LOG_ASSERT(dictionary_builder.Finish(&dictionary).ok());
+
+  arrow::Int32Builder codes_builder;
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    if (Color(n)) {
+      KATANA_LOG_ASSERT(codes_builder.Append(n % kColors.size()).ok());
+    } else {
+      KATANA_LOG_ASSERT(codes_builder.AppendNull().ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> codes;
+  KATANA_LOG_ASSERT(codes_builder.Finish(&codes).ok());
+
+  auto type = arrow::dictionary(arrow::int32(), arrow::large_utf8());
+  auto colors = arrow::DictionaryArray::FromArrays(type, codes, dictionary);
+  KATANA_LOG_ASSERT(colors.ok());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field("color", type)}), {colors.ValueOrDie()});
+}
+
+katana::PropertyViewType<ColorProperty>
+MakeView(const katana::PropertyGraph& pg) {
+  auto property = pg.GetNodeProperty("color");
+  KATANA_LOG_ASSERT(property && property->num_chunks() == 1);
+  auto view = katana::ConstructPropertyView<ColorProperty>(
+      property->chunk(0).get());
+  KATANA_LOG_VASSERT(view, "viewing colors: {}", view.error());
+  return view.value();
+}
+
+void
+CheckColors(const katana::PropertyGraph& pg) {
+  auto view = MakeView(pg);
+  KATANA_LOG_ASSERT(view.num_codes() == kColors.size());
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    auto color = Color(n);
+    KATANA_LOG_ASSERT(view.IsValid(n) == color.has_value());
+    if (color) {
+      KATANA_LOG_ASSERT(view.GetValue(n) == color.value());
+    }
+  }
+}
+
+/// Filters and group-bys work on the codes of the elements
+void
+TestCodes(const katana::PropertyGraph& pg) {
+  auto view = MakeView(pg);
+  auto blue = view.FindCode("blue");
+  KATANA_LOG_ASSERT(blue && view.Decode(blue.value()) == "blue");
+  KATANA_LOG_ASSERT(!view.FindCode("white"));
+
+  std::vector<uint64_t> expected(kColors.size());
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    auto color = Color(n);
+    KATANA_LOG_ASSERT(view.HasCode(n, blue.value()) == (color == "blue"));
+    if (color) {
+      ++expected[view.GetCode(n)];
+    }
+  }
+  KATANA_LOG_ASSERT(view.CountByCode() == expected);
+
+  auto property = pg.GetNodeProperty("color");
+  KATANA_LOG_ASSERT(!katana::ConstructPropertyView<
+                     katana::DictionaryReadOnlyProperty<int8_t>>(
+      property->chunk(0).get()));
+  KATANA_LOG_ASSERT(!katana::ConstructPropertyView<
+                     katana::DictionaryReadOnlyProperty<
+                         int32_t, arrow::StringArray>>(
+      property->chunk(0).get()));
+}
+
+void
+TestSelect(const katana::PropertyGraph& pg) {
+  auto selection = katana::SelectNodes(
+      pg, {{"color", katana::CompareOp::kNotEqual,
+            std::make_shared<arrow::LargeStringScalar>(std::string("red"))}});
+  KATANA_LOG_VASSERT(selection, "selecting: {}", selection.error());
+  size_t num_selected = 0;
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    auto color = Color(n);
+    bool expected = color && color.value() != "red";
+    KATANA_LOG_ASSERT(selection.value().test(n) == expected);
+    num_selected += expected;
+  }
+  KATANA_LOG_ASSERT(selection.value().count() == num_selected);
+}
+
+/// Dictionary-encoded properties are stored and loaded encoded
+void
+TestRoundTrip(katana::PropertyGraph* pg) {
+  auto uri_res = katana::Uri::MakeRand("/tmp/dictionaryproperty");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());
+
+  auto write_result = pg->Write(rdg_dir, "dictionary-property");
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+  auto loaded = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_VASSERT(loaded, "loading: {}", loaded.error());
+
+  auto property = loaded.value()->GetNodeProperty("color");
+  KATANA_LOG_ASSERT(property);
+  KATANA_LOG_VASSERT(
+      property->type()->Equals(pg->GetNodeProperty("color")->type()),
+      "loaded type is {}", property->type()->ToString());
+  CheckColors(*loaded.value());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy policy{1};
+  auto pg = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(MakeColors()));
+
+  CheckColors(*pg);
+  TestCodes(*pg);
+  TestSelect(*pg);
+  TestRoundTrip(pg.get());
+
+  return 0;
+}
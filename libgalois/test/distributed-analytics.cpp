@@ -0,0 +1,433 @@
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/CommBackend.h"
+#include "katana/Distribution.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/distributed/distributed.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kNumNodes = 405;
+constexpr Node kSource = 7;
+
+/// An undirected random graph with components [0, 300), [300, 400) and the
+/// isolated nodes [400, kNumNodes)
+std::vector<std::set<Node>>
+MakeNeighbors() {
+  std::mt19937 gen(12345);
+  std::vector<std::set<Node>> neighbors(kNumNodes);
+  auto add_edges = [&](Node begin, Node end, size_t num_edges) {
+    std::uniform_int_distribution<Node> dist(begin, end - 1);
+    for (size_t i = 0; i < num_edges; ++i) {
+      Node a = dist(gen);
+      Node b = dist(gen);
+      neighbors[a].insert(b);
+      neighbors[b].insert(a);
+    }
+    // a chain keeps the range connected
+    for (Node n = begin + 1; n < end; ++n) {
+      neighbors[n - 1].insert(n);
+      neighbors[n].insert(n - 1);
+    }
+  };
+  add_edges(0, 300, 600);
+  add_edges(300, 400, 100);
+  return neighbors;
+}
+
+template <typename T>
+std::vector<T>
+GetValues(const katana::PropertyGraph& pg, const std::string& name) {
+  auto values = katana::UnmarshalVector<T>(pg.GetNodeProperty(name));
+  KATANA_LOG_ASSERT(values);
+  KATANA_LOG_ASSERT(values.value().size() == pg.num_nodes());
+  return std::move(values.value());
+}
+
+/// The tasks of a CommBackend as threads of this process. The tasks share
+/// the one thread pool, so each holds a ThreadPoolLease except while it
+/// waits for the others in a collective, and only one task runs at a time.
+class ThreadCommBackend : public katana::CommBackend {
+public:
+  using Buffers = std::vector<std::vector<uint8_t>>;
+
+  /// What the tasks of one run share
+  struct Group {
+    explicit Group(uint32_t num_tasks)
+        : sent(num_tasks, Buffers(num_tasks)),
+          received(num_tasks, Buffers(num_tasks)) {}
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t num_arrived{0};
+    uint64_t round{0};
+    /// sent[i][j] is what task i sends to task j in this round, and
+    /// received[j][i] what task j got from task i in the last one
+    std::vector<Buffers> sent;
+    std::vector<Buffers> received;
+  };
+
+  /// Join group as task id, which runs loops on num_threads threads
+  ThreadCommBackend(Group* group, uint32_t id, unsigned num_threads)
+      : group_(group), num_threads_(num_threads) {
+    Num = group->sent.size();
+    ID = id;
+    lease_.emplace(num_threads_);
+  }
+
+  void Barrier() override { Exchange(Buffers(Num)); }
+  void NotifyFailure() override { KATANA_LOG_FATAL("task {} failed", ID); }
+  bool Broadcast(uint32_t root, bool val) override {
+    return Exchange(Buffers(Num, std::vector<uint8_t>{val}))[root][0] != 0;
+  }
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override {
+    std::string mine = val.substr(0, max_size);
+    auto received =
+        Exchange(Buffers(Num, std::vector<uint8_t>(mine.begin(), mine.end())));
+    return std::string(received[root].begin(), received[root].end());
+  }
+
+  katana::Result<void> ReduceBuffer(
+      uint32_t root, ReduceOp op, DataType type, const void* in, void* out,
+      size_t count) override {
+    std::vector<uint8_t> result(count * sizeof(uint64_t));
+    KATANA_CHECKED(AllReduceBuffer(op, type, in, result.data(), count));
+    if (ID == root) {
+      std::memcpy(out, result.data(), result.size());
+    }
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> AllReduceBuffer(
+      ReduceOp op, DataType type, const void* in, void* out,
+      size_t count) override {
+    // every data type has 8 bytes
+    const auto* bytes = static_cast<const uint8_t*>(in);
+    auto received = Exchange(Buffers(
+        Num, std::vector<uint8_t>(bytes, bytes + count * sizeof(uint64_t))));
+    switch (type) {
+    case DataType::kInt64:
+      Combine<int64_t>(op, received, out, count);
+      break;
+    case DataType::kUInt64:
+      Combine<uint64_t>(op, received, out, count);
+      break;
+    case DataType::kDouble:
+      Combine<double>(op, received, out, count);
+      break;
+    }
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<Buffers> AllToAll(const Buffers& send) override {
+    if (send.size() != Num) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "{} buffers to send to {} tasks",
+          send.size(), Num);
+    }
+    return Exchange(send);
+  }
+
+  katana::Result<std::unique_ptr<katana::CommRequest>> ISend(
+      uint32_t, int, std::vector<uint8_t>) override {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "point to point messages");
+  }
+  katana::Result<std::unique_ptr<katana::CommRequest>> IRecv(
+      uint32_t, int) override {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "point to point messages");
+  }
+
+private:
+  template <typename T>
+  static void Combine(
+      ReduceOp op, const Buffers& values, void* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      T combined{};
+      for (size_t task = 0; task < values.size(); ++task) {
+        T v;
+        std::memcpy(&v, values[task].data() + i * sizeof(T), sizeof(T));
+        if (task == 0) {
+          combined = v;
+        } else if (op == ReduceOp::kSum) {
+          combined += v;
+        } else if (op == ReduceOp::kMin) {
+          combined = std::min(combined, v);
+        } else {
+          combined = std::max(combined, v);
+        }
+      }
+      std::memcpy(
+          static_cast<uint8_t*>(out) + i * sizeof(T), &combined, sizeof(T));
+    }
+  }
+
+  /// Send send[j] to every task j and \returns what each task sent to this
+  /// one once all of them called Exchange
+  Buffers Exchange(Buffers send) {
+    lease_.reset();
+    Buffers received;
+    {
+      std::unique_lock<std::mutex> lock(group_->mutex);
+      group_->sent[ID] = std::move(send);
+      uint64_t round = group_->round;
+      if (++group_->num_arrived == Num) {
+        for (uint32_t src = 0; src < Num; ++src) {
+          for (uint32_t dst = 0; dst < Num; ++dst) {
+            group_->received[dst][src] = std::move(group_->sent[src][dst]);
+          }
+        }
+        group_->num_arrived = 0;
+        ++group_->round;
+        group_->cv.notify_all();
+      } else {
+        group_->cv.wait(lock, [&] { return group_->round != round; });
+      }
+      // the next round cannot finish before this task joins it
+      received = std::move(group_->received[ID]);
+      group_->received[ID] = Buffers(Num);
+    }
+    lease_.emplace(num_threads_);
+    return received;
+  }
+
+  Group* group_;
+  unsigned num_threads_;
+  std::optional<katana::ThreadPoolLease> lease_;
+};
+
+/// The partitions of an outgoing edge cut of the graph of neighbors: host h
+/// owns the nodes n with n % num_hosts == h, in order, and their edges, and
+/// has mirrors of the destinations of those edges owned by other hosts
+std::vector<std::unique_ptr<katana::PropertyGraph>>
+MakePartitions(
+    const std::vector<std::set<Node>>& neighbors, uint32_t num_hosts) {
+  constexpr Node kNoNode = std::numeric_limits<Node>::max();
+  std::vector<std::unique_ptr<katana::PropertyGraph>> parts;
+  std::vector<std::vector<std::vector<Node>>> masters(
+      num_hosts, std::vector<std::vector<Node>>(num_hosts));
+  std::vector<std::vector<std::vector<Node>>> mirrors(
+      num_hosts, std::vector<std::vector<Node>>(num_hosts));
+  std::vector<std::vector<uint64_t>> local_to_global(num_hosts);
+  std::vector<size_t> num_owned(num_hosts);
+
+  for (uint32_t host = 0; host < num_hosts; ++host) {
+    std::vector<Node> local(kNumNodes, kNoNode);
+    for (Node n = host; n < kNumNodes; n += num_hosts) {
+      local[n] = local_to_global[host].size();
+      local_to_global[host].push_back(n);
+    }
+    num_owned[host] = local_to_global[host].size();
+
+    std::vector<std::vector<Node>> adj(num_owned[host]);
+    for (Node n = host; n < kNumNodes; n += num_hosts) {
+      for (Node dst : neighbors[n]) {
+        if (local[dst] == kNoNode) {
+          // the master of dst is local node dst / num_hosts of its owner
+          uint32_t owner = dst % num_hosts;
+          local[dst] = local_to_global[host].size();
+          local_to_global[host].push_back(dst);
+          mirrors[host][owner].push_back(local[dst]);
+          masters[owner][host].push_back(dst / num_hosts);
+        }
+        adj[local[n]].push_back(local[dst]);
+      }
+    }
+    adj.resize(local_to_global[host].size());
+    parts.emplace_back(MakeCsrGraph(adj));
+  }
+
+  for (uint32_t host = 0; host < num_hosts; ++host) {
+    KATANA_LOG_ASSERT(katana::Distribution::SetPartition(
+        parts[host].get(), kNumNodes, num_owned[host], local_to_global[host],
+        masters[host], mirrors[host]));
+  }
+  return parts;
+}
+
+/// Run the analytics on two partitions of the graph of neighbors, each by a
+/// host of its own, and compare every proxy with the node of single, where
+/// they ran on one host
+void
+TestTwoHosts(
+    const std::vector<std::set<Node>>& neighbors,
+    const katana::PropertyGraph& single) {
+  constexpr uint32_t kNumHosts = 2;
+  auto parts = MakePartitions(neighbors, kNumHosts);
+
+  ThreadCommBackend::Group group(kNumHosts);
+  unsigned num_threads = katana::getActiveThreads();
+  std::vector<std::thread> hosts;
+  for (uint32_t host = 0; host < kNumHosts; ++host) {
+    hosts.emplace_back([&, host] {
+      ThreadCommBackend comm(&group, host, num_threads);
+      auto dist_res = katana::Distribution::Make(parts[host].get(), &comm);
+      KATANA_LOG_VASSERT(dist_res, "host {}: {}", host, dist_res.error());
+      const katana::Distribution& dist = dist_res.value();
+      KATANA_LOG_ASSERT(dist.num_global_nodes() == kNumNodes);
+      KATANA_LOG_ASSERT(!dist.mirrors(1 - host).empty());
+
+      katana::PropertyGraph* pg = parts[host].get();
+      KATANA_LOG_ASSERT(
+          katana::analytics::DistributedBfs(pg, dist, kSource, "level"));
+      KATANA_LOG_ASSERT(katana::analytics::DistributedConnectedComponents(
+          pg, dist, "component"));
+      KATANA_LOG_ASSERT(katana::analytics::DistributedPagerank(
+          pg, dist, "rank",
+          katana::analytics::PagerankPlan::PushSynchronous(1e-6, 1000)));
+    });
+  }
+  for (auto& host : hosts) {
+    host.join();
+  }
+
+  auto levels = GetValues<uint32_t>(single, "level");
+  auto components = GetValues<uint64_t>(single, "component");
+  auto ranks = GetValues<float>(single, "rank");
+  for (uint32_t host = 0; host < kNumHosts; ++host) {
+    const katana::PropertyGraph& part = *parts[host];
+    auto global_ids =
+        katana::UnmarshalVector<uint64_t>(part.local_to_global_id());
+    KATANA_LOG_ASSERT(global_ids);
+    auto part_levels = GetValues<uint32_t>(part, "level");
+    auto part_components = GetValues<uint64_t>(part, "component");
+    auto part_ranks = GetValues<float>(part, "rank");
+    for (Node n = 0; n < part.num_nodes(); ++n) {
+      uint64_t g = global_ids.value()[n];
+      KATANA_LOG_VASSERT(
+          part_levels[n] == levels[g], "host {} node {}", host, g);
+      KATANA_LOG_VASSERT(
+          part_components[n] == components[g], "host {} node {}", host, g);
+      KATANA_LOG_VASSERT(
+          std::abs(part_ranks[n] - ranks[g]) < 1e-4,
+          "host {} node {}: {} != {}", host, g, part_ranks[n], ranks[g]);
+    }
+  }
+}
+
+void
+TestDistributedBfs(
+    katana::PropertyGraph* pg, const katana::Distribution& dist,
+    const std::vector<std::set<Node>>& neighbors) {
+  std::vector<uint32_t> expected(
+      kNumNodes, katana::analytics::kDistributedBfsUnreachable);
+  std::deque<Node> queue{kSource};
+  expected[kSource] = 0;
+  while (!queue.empty()) {
+    Node n = queue.front();
+    queue.pop_front();
+    for (Node dst : neighbors[n]) {
+      if (expected[dst] == katana::analytics::kDistributedBfsUnreachable) {
+        expected[dst] = expected[n] + 1;
+        queue.push_back(dst);
+      }
+    }
+  }
+
+  KATANA_LOG_ASSERT(
+      katana::analytics::DistributedBfs(pg, dist, kSource, "level"));
+  KATANA_LOG_ASSERT(GetValues<uint32_t>(*pg, "level") == expected);
+  KATANA_LOG_ASSERT(
+      !katana::analytics::DistributedBfs(pg, dist, kNumNodes, "level2"));
+}
+
+void
+TestDistributedConnectedComponents(
+    katana::PropertyGraph* pg, const katana::Distribution& dist) {
+  KATANA_LOG_ASSERT(
+      katana::analytics::DistributedConnectedComponents(pg, dist, "component"));
+  auto components = GetValues<uint64_t>(*pg, "component");
+  for (Node n = 0; n < kNumNodes; ++n) {
+    uint64_t expected = n < 300 ? 0 : n < 400 ? 300 : n;
+    KATANA_LOG_VASSERT(components[n] == expected, "node {}", n);
+  }
+}
+
+void
+TestDistributedPagerank(
+    katana::PropertyGraph* pg, const katana::Distribution& dist,
+    const std::vector<std::set<Node>>& neighbors) {
+  auto plan = katana::analytics::PagerankPlan::PushSynchronous(1e-6, 1000);
+  std::vector<double> expected(kNumNodes, plan.initial_residual());
+  for (unsigned iter = 0; iter < plan.max_iterations(); ++iter) {
+    std::vector<double> sums(kNumNodes);
+    for (Node n = 0; n < kNumNodes; ++n) {
+      for (Node dst : neighbors[n]) {
+        sums[dst] += expected[n] / neighbors[n].size();
+      }
+    }
+    double delta = 0;
+    for (Node n = 0; n < kNumNodes; ++n) {
+      double rank = (1 - plan.alpha()) + plan.alpha() * sums[n];
+      delta = std::max(delta, std::abs(rank - expected[n]));
+      expected[n] = rank;
+    }
+    if (delta <= plan.tolerance()) {
+      break;
+    }
+  }
+
+  KATANA_LOG_ASSERT(
+      katana::analytics::DistributedPagerank(pg, dist, "rank", plan));
+  auto ranks = GetValues<float>(*pg, "rank");
+  for (Node n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(ranks[n] - expected[n]) < 1e-4, "node {}: {} != {}", n,
+        ranks[n], expected[n]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  auto neighbors = MakeNeighbors();
+  auto pg = MakeCsrGraph(neighbors);
+
+  // A graph that is not partitioned is the only partition of one host
+  katana::NullCommBackend comm;
+  auto dist_res = katana::Distribution::Make(pg.get(), &comm);
+  KATANA_LOG_ASSERT(dist_res);
+  const katana::Distribution& dist = dist_res.value();
+  KATANA_LOG_ASSERT(dist.num_global_nodes() == kNumNodes);
+  KATANA_LOG_ASSERT(dist.num_owned() == kNumNodes);
+  KATANA_LOG_ASSERT(dist.masters(0).empty() && dist.mirrors(0).empty());
+
+  TestDistributedBfs(pg.get(), dist, neighbors);
+  TestDistributedConnectedComponents(pg.get(), dist);
+  TestDistributedPagerank(pg.get(), dist, neighbors);
+  TestTwoHosts(neighbors, *pg);
+
+  katana::NullCommBackend two_hosts;
+  two_hosts.Num = 2;
+  KATANA_LOG_ASSERT(!katana::Distribution::Make(pg.get(), &two_hosts));
+
+  return 0;
+}
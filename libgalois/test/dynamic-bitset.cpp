@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// Set every bit i of \param bitset with i % stride == 0 and \returns them
+std::vector<uint64_t>
+SetEvery(katana::DynamicBitset* bitset, size_t stride) {
+  std::vector<uint64_t> expected;
+  for (size_t i = 0; i < bitset->size(); i += stride) {
+    bitset->set(i);
+    expected.push_back(i);
+  }
+  return expected;
+}
+
+void
+TestOffsets(size_t num_bits, size_t stride) {
+  katana::DynamicBitset bitset;
+  bitset.resize(num_bits);
+  std::vector<uint64_t> expected = SetEvery(&bitset, stride);
+
+  KATANA_LOG_ASSERT(bitset.count() == expected.size());
+  KATANA_LOG_ASSERT(bitset.GetOffsets<uint64_t>() == expected);
+
+  std::vector<uint64_t> found;
+  for (size_t i = bitset.FindNextSet(0); i < bitset.size();
+       i = bitset.FindNextSet(i + 1)) {
+    found.push_back(i);
+  }
+  KATANA_LOG_ASSERT(found == expected);
+
+  katana::InsertBag<uint64_t> bag;
+  bitset.ForEachSetBit([&](size_t i) { bag.push(i); }, katana::no_stats());
+  std::vector<uint64_t> from_bag(bag.begin(), bag.end());
+  std::sort(from_bag.begin(), from_bag.end());
+  KATANA_LOG_ASSERT(from_bag == expected);
+}
+
+void
+TestTailBits() {
+  katana::DynamicBitset bitset;
+  bitset.resize(100);
+  // sets the 28 bits past the end of the last word too
+  bitset.bitwise_not();
+  KATANA_LOG_ASSERT(bitset.count() == 100);
+  KATANA_LOG_ASSERT(bitset.GetOffsets<uint32_t>().size() == 100);
+  KATANA_LOG_ASSERT(bitset.FindNextSet(99) == 99);
+
+  bitset.reset();
+  KATANA_LOG_ASSERT(bitset.count() == 0);
+  KATANA_LOG_ASSERT(bitset.FindNextSet(0) == bitset.size());
+}
+
+void
+TestAndNot() {
+  katana::DynamicBitset a;
+  katana::DynamicBitset b;
+  a.resize(1000);
+  b.resize(1000);
+  SetEvery(&a, 2);
+  SetEvery(&b, 4);
+
+  a.bitwise_andnot(b);
+  KATANA_LOG_ASSERT(a.count() == 250);
+  for (size_t i = 0; i < a.size(); ++i) {
+    KATANA_LOG_ASSERT(a.test(i) == (i % 2 == 0 && i % 4 != 0));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestOffsets(0, 1);
+  TestOffsets(1, 1);
+  TestOffsets(64, 1);
+  TestOffsets(1000, 3);
+  TestOffsets(100000, 997);
+  TestTailBits();
+  TestAndNot();
+
+  return 0;
+}
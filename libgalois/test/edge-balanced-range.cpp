@@ -0,0 +1,102 @@
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/EdgeBalancedRange.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr uint32_t kNumNodes = 3000;
+constexpr uint64_t kTileSize = 100;
+
+/// A random graph where node n has about 20000 / (n + 1) edges, so that the
+/// low ids are hubs and most of the nodes have no edges
+katana::GraphTopology
+MakePowerLawGraph() {
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<Node> dist(0, kNumNodes - 1);
+  std::vector<std::vector<Node>> adj(kNumNodes);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    for (uint32_t i = 0; i < 20000 / (n + 1); ++i) {
+      adj[n].push_back(dist(gen));
+    }
+  }
+  return MakeCsrTopology(adj);
+}
+
+/// Every node is visited once, and every edge once through edge ranges
+void
+CheckVisits(
+    const katana::GraphTopology& topo,
+    const katana::EdgeBalancedRange& range) {
+  std::vector<std::atomic<uint32_t>> node_visits(topo.num_nodes());
+  range.ForEachNode(topo, [&](Node n) { node_visits[n].fetch_add(1); });
+  for (const auto& visits : node_visits) {
+    KATANA_LOG_ASSERT(visits.load() == 1);
+  }
+
+  std::vector<std::atomic<uint32_t>> edge_visits(topo.num_edges());
+  std::vector<std::atomic<uint32_t>> empty_visits(topo.num_nodes());
+  range.ForEachEdgeRange(topo, [&](Node n, Edge begin, Edge end) {
+    KATANA_LOG_ASSERT(*topo.edges(n).begin() <= begin);
+    KATANA_LOG_ASSERT(begin <= end && end <= *topo.edges(n).end());
+    if (begin == end) {
+      empty_visits[n].fetch_add(1);
+    }
+    for (Edge e = begin; e < end; ++e) {
+      edge_visits[e].fetch_add(1);
+    }
+  });
+  for (const auto& visits : edge_visits) {
+    KATANA_LOG_ASSERT(visits.load() == 1);
+  }
+  for (Node n = 0; n < topo.num_nodes(); ++n) {
+    KATANA_LOG_ASSERT(empty_visits[n].load() == (topo.degree(n) == 0));
+  }
+}
+
+void
+TestRanges() {
+  katana::GraphTopology topo = MakePowerLawGraph();
+  const uint64_t num_items = topo.num_nodes() + topo.num_edges();
+  const uint64_t max_tiles = (num_items + kTileSize - 1) / kTileSize;
+
+  // hubs are not split, so their tiles are larger and fewer
+  auto whole = katana::EdgeBalancedRange::Make(topo, kTileSize);
+  KATANA_LOG_ASSERT(whole.num_tiles() > 1);
+  KATANA_LOG_ASSERT(whole.num_tiles() < max_tiles);
+  CheckVisits(topo, whole);
+
+  // tiles of exactly kTileSize items
+  auto split = katana::EdgeBalancedRange::Make(topo, kTileSize, true);
+  KATANA_LOG_ASSERT(split.num_tiles() == max_tiles);
+  CheckVisits(topo, split);
+
+  auto one = katana::EdgeBalancedRange::Make(topo, num_items);
+  KATANA_LOG_ASSERT(one.num_tiles() == 1);
+  CheckVisits(topo, one);
+
+  katana::GraphTopology empty;
+  KATANA_LOG_ASSERT(katana::EdgeBalancedRange::Make(empty).num_tiles() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestRanges();
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/DynamicBitset.h"
+#include "katana/EdgeLookup.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr uint32_t kNumNodes = 2000;
+
+/// A random graph where node n has about kNumNodes / (n + 1) edges, sorted
+/// by destination, so that the low ids are hubs. Every 10th node has a
+/// parallel edge to its first neighbor.
+katana::GraphTopology
+MakePowerLawGraph() {
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<Node> dist(0, kNumNodes - 1);
+  std::vector<std::vector<Node>> adj(kNumNodes);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    std::set<Node> neighbors;
+    for (uint32_t i = 0; i < kNumNodes / (n + 1); ++i) {
+      neighbors.insert(dist(gen));
+    }
+    if (n % 10 == 0) {
+      adj[n].push_back(*neighbors.begin());
+    }
+    adj[n].insert(adj[n].end(), neighbors.begin(), neighbors.end());
+  }
+  return MakeCsrTopology(adj);
+}
+
+/// The first edge from src to dst by a scan of the edges of src
+Edge
+ScanForEdge(const katana::GraphTopology& topo, Node src, Node dst) {
+  for (auto e : topo.edges(src)) {
+    if (topo.edge_dest(e) == dst) {
+      return e;
+    }
+  }
+  return katana::EdgeLookup::kNotFound;
+}
+
+void
+TestEdgeLookup(const katana::GraphTopology& topo, size_t num_hubs) {
+  auto lookup = katana::EdgeLookup::Make(topo, num_hubs, 10);
+  KATANA_LOG_ASSERT(lookup.num_hubs() == num_hubs);
+  KATANA_LOG_ASSERT((lookup.size_bytes() == 0) == (num_hubs == 0));
+
+  // every edge, repeated and shuffled, and random pairs
+  std::vector<katana::EdgeLookup::Query> queries;
+  for (Node src = 0; src < kNumNodes; ++src) {
+    for (auto e : topo.edges(src)) {
+      queries.emplace_back(src, topo.edge_dest(e));
+    }
+  }
+  std::mt19937 gen(54321);
+  std::uniform_int_distribution<Node> dist(0, kNumNodes - 1);
+  for (size_t i = 0; i < 50000; ++i) {
+    queries.emplace_back(dist(gen), dist(gen));
+  }
+  std::shuffle(queries.begin(), queries.end(), gen);
+
+  std::vector<Edge> edges;
+  lookup.FindEdges(topo, queries, &edges);
+  katana::DynamicBitset found = lookup.HasEdges(topo, queries);
+  KATANA_LOG_ASSERT(edges.size() == queries.size());
+  KATANA_LOG_ASSERT(found.size() == queries.size());
+  for (size_t i = 0; i < queries.size(); ++i) {
+    const auto& [src, dst] = queries[i];
+    Edge expected = ScanForEdge(topo, src, dst);
+    KATANA_LOG_VASSERT(
+        edges[i] == expected, "edge {} -> {}: {} != {}", src, dst, edges[i],
+        expected);
+    KATANA_LOG_ASSERT(lookup.FindEdge(topo, src, dst) == expected);
+    KATANA_LOG_ASSERT(
+        found.test(i) == (expected != katana::EdgeLookup::kNotFound));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  katana::GraphTopology topo = MakePowerLawGraph();
+  TestEdgeLookup(topo, 0);
+  TestEdgeLookup(topo, 5);
+
+  // lookups without hubs search every node
+  katana::EdgeLookup empty;
+  std::vector<Edge> none;
+  empty.FindEdges(topo, {}, &none);
+  KATANA_LOG_ASSERT(none.empty());
+  Node first_dest = topo.edge_dest(*topo.edges(0).begin());
+  KATANA_LOG_ASSERT(
+      empty.FindEdge(topo, 0, first_dest) ==
+      ScanForEdge(topo, 0, first_dest));
+
+  return 0;
+}
@@ -0,0 +1,329 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// An in-memory remote backend that counts the reads it serves so that tests
+/// can tell cache hits from fetches
+class MemStorage : public tsuba::FileStorage {
+public:
+  struct File {
+    std::vector<uint8_t> data;
+    std::string version;
+    uint64_t mtime_ns{0};
+  };
+
+  MemStorage() : tsuba::FileStorage("mem://") {}
+
+  katana::Result<void> Init() override { return katana::ResultSuccess(); }
+  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+
+  void Set(const std::string& uri, File file) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    files_[uri] = std::move(file);
+  }
+
+  uint64_t num_gets() const { return num_gets_; }
+
+  /// Make reads block until Release is called
+  void Hold() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_ = true;
+  }
+
+  void Release() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      held_ = false;
+    }
+    cv_.notify_all();
+  }
+
+  /// Block until a read is waiting on Release
+  void WaitForHeldRead() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return num_held_ > 0; });
+  }
+
+  /// Block until \param n calls to Stat have been made
+  void WaitForStats(uint64_t n) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return num_stats_ >= n; });
+  }
+
+  uint64_t num_stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_stats_;
+  }
+
+  katana::Result<void> Stat(
+      const std::string& uri, tsuba::StatBuf* s_buf) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++num_stats_;
+    cv_.notify_all();
+    auto it = files_.find(uri);
+    if (it == files_.end()) {
+      return tsuba::ErrorCode::NotFound;
+    }
+    s_buf->size = it->second.data.size();
+    s_buf->version = it->second.version;
+    s_buf->mtime_ns = it->second.mtime_ns;
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++num_gets_;
+    ++num_held_;
+    cv_.notify_all();
+    cv_.wait(lock, [this] { return !held_; });
+    --num_held_;
+    auto it = files_.find(uri);
+    if (it == files_.end()) {
+      return tsuba::ErrorCode::NotFound;
+    }
+    if (start + size > it->second.data.size()) {
+      return tsuba::ErrorCode::InvalidArgument;
+    }
+    std::memcpy(result_buf, it->second.data.data() + start, size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    Set(uri, File{std::vector<uint8_t>(data, data + size), "", 0});
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> RemoteCopy(
+      const std::string&, const std::string&, uint64_t, uint64_t) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+  std::future<katana::CopyableResult<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    Set(uri, File{std::vector<uint8_t>(data, data + size), "", 0});
+    return std::async(
+        std::launch::deferred, []() -> katana::CopyableResult<void> {
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return std::async(
+        std::launch::async, [=]() -> katana::CopyableResult<void> {
+          if (auto res = GetMultiSync(uri, start, size, result_buf); !res) {
+            return res.error();
+          }
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  std::future<katana::CopyableResult<void>> ListAsync(
+      const std::string&, std::vector<std::string>*,
+      std::vector<uint64_t>*) override {
+    return std::async(
+        std::launch::deferred, []() -> katana::CopyableResult<void> {
+          return KATANA_ERROR(
+              tsuba::ErrorCode::NotImplemented, "listing is not supported");
+        });
+  }
+
+  katana::Result<void> Delete(
+      const std::string&, const std::unordered_set<std::string>&) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::map<std::string, File> files_;
+  std::atomic<uint64_t> num_gets_{0};
+  uint64_t num_stats_{0};
+  uint64_t num_held_{0};
+  bool held_{false};
+};
+
+MemStorage mem_storage;
+
+std::vector<uint8_t>
+Bytes(const std::string& str) {
+  return std::vector<uint8_t>(str.begin(), str.end());
+}
+
+std::string
+Read(const std::string& uri, uint64_t start, uint64_t size) {
+  std::string buf(size, '\0');
+  auto res = tsuba::FileGet(uri, buf.data(), start, size);
+  KATANA_LOG_VASSERT(res, "reading {}: {}", uri, res.error());
+  return buf;
+}
+
+/// Without a version, entries are keyed by size and modification time so
+/// that rewriting a file with contents of the same size is not missed
+void
+TestModificationTime() {
+  std::string uri = "mem://mtime";
+  mem_storage.Set(uri, MemStorage::File{Bytes("aaaaaaaa"), "", 1});
+
+  tsuba::FileCacheStats before = tsuba::GetFileCacheStats();
+  uint64_t gets = mem_storage.num_gets();
+  KATANA_LOG_ASSERT(Read(uri, 0, 8) == "aaaaaaaa");
+  KATANA_LOG_ASSERT(Read(uri, 2, 4) == "aaaa");
+  tsuba::FileCacheStats after = tsuba::GetFileCacheStats();
+  KATANA_LOG_ASSERT(after.misses == before.misses + 1);
+  KATANA_LOG_ASSERT(after.hits == before.hits + 1);
+  KATANA_LOG_ASSERT(mem_storage.num_gets() == gets + 1);
+
+  mem_storage.Set(uri, MemStorage::File{Bytes("bbbbbbbb"), "", 2});
+  KATANA_LOG_ASSERT(Read(uri, 0, 8) == "bbbbbbbb");
+  tsuba::FileCacheStats changed = tsuba::GetFileCacheStats();
+  KATANA_LOG_ASSERT(changed.misses == after.misses + 1);
+  KATANA_LOG_ASSERT(changed.hits == after.hits);
+}
+
+/// A version takes precedence over the modification time
+void
+TestVersion() {
+  std::string uri = "mem://version";
+  mem_storage.Set(uri, MemStorage::File{Bytes("aaaa"), "v1", 1});
+  KATANA_LOG_ASSERT(Read(uri, 0, 4) == "aaaa");
+
+  // same version: the old contents are still served from the cache
+  tsuba::FileCacheStats before = tsuba::GetFileCacheStats();
+  mem_storage.Set(uri, MemStorage::File{Bytes("bbbb"), "v1", 2});
+  KATANA_LOG_ASSERT(Read(uri, 0, 4) == "aaaa");
+  KATANA_LOG_ASSERT(tsuba::GetFileCacheStats().hits == before.hits + 1);
+
+  mem_storage.Set(uri, MemStorage::File{Bytes("cccc"), "v2", 2});
+  KATANA_LOG_ASSERT(Read(uri, 0, 4) == "cccc");
+  KATANA_LOG_ASSERT(tsuba::GetFileCacheStats().misses == before.misses + 1);
+}
+
+/// Files whose changes cannot be detected are never cached
+void
+TestBypassUnversioned() {
+  std::string uri = "mem://unversioned";
+  mem_storage.Set(uri, MemStorage::File{Bytes("aaaa"), "", 0});
+
+  tsuba::FileCacheStats before = tsuba::GetFileCacheStats();
+  uint64_t gets = mem_storage.num_gets();
+  KATANA_LOG_ASSERT(Read(uri, 0, 4) == "aaaa");
+  mem_storage.Set(uri, MemStorage::File{Bytes("bbbb"), "", 0});
+  KATANA_LOG_ASSERT(Read(uri, 0, 4) == "bbbb");
+
+  tsuba::FileCacheStats after = tsuba::GetFileCacheStats();
+  KATANA_LOG_ASSERT(after.bypasses == before.bypasses + 2);
+  KATANA_LOG_ASSERT(after.hits == before.hits);
+  KATANA_LOG_ASSERT(after.misses == before.misses);
+  KATANA_LOG_ASSERT(mem_storage.num_gets() == gets + 2);
+}
+
+/// A reader of a file that another reader is fetching waits for that fetch;
+/// it is counted as a wait rather than a hit
+void
+TestWaitForFetch() {
+  std::string uri = "mem://shared";
+  mem_storage.Set(uri, MemStorage::File{Bytes("abcdefgh"), "v1", 1});
+
+  tsuba::FileCacheStats before = tsuba::GetFileCacheStats();
+  uint64_t gets = mem_storage.num_gets();
+  uint64_t stats = mem_storage.num_stats();
+
+  mem_storage.Hold();
+  std::thread fetcher(
+      [&] { KATANA_LOG_ASSERT(Read(uri, 0, 8) == "abcdefgh"); });
+  mem_storage.WaitForHeldRead();
+  std::thread waiter([&] { KATANA_LOG_ASSERT(Read(uri, 4, 4) == "efgh"); });
+  // the waiter registers with the fetch right after its stat
+  mem_storage.WaitForStats(stats + 2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  mem_storage.Release();
+  fetcher.join();
+  waiter.join();
+
+  tsuba::FileCacheStats after = tsuba::GetFileCacheStats();
+  KATANA_LOG_ASSERT(after.misses == before.misses + 1);
+  KATANA_LOG_ASSERT(after.waits == before.waits + 1);
+  KATANA_LOG_ASSERT(after.hits == before.hits);
+  KATANA_LOG_ASSERT(mem_storage.num_gets() == gets + 1);
+}
+
+/// Within a FileStatScope, a file is Stat'ed once however often it is read,
+/// and a change to it goes unnoticed until the scope ends
+void
+TestStatScope() {
+  std::string uri = "mem://scoped";
+  mem_storage.Set(uri, MemStorage::File{Bytes("aaaa"), "v1", 1});
+
+  uint64_t stats = mem_storage.num_stats();
+  {
+    tsuba::FileStatScope scope;
+    KATANA_LOG_ASSERT(Read(uri, 0, 4) == "aaaa");
+    KATANA_LOG_ASSERT(Read(uri, 1, 2) == "aa");
+
+    mem_storage.Set(uri, MemStorage::File{Bytes("bbbb"), "v2", 2});
+    {
+      tsuba::FileStatScope nested;
+      KATANA_LOG_ASSERT(Read(uri, 0, 4) == "aaaa");
+    }
+    KATANA_LOG_ASSERT(Read(uri, 0, 4) == "aaaa");
+    KATANA_LOG_ASSERT(mem_storage.num_stats() == stats + 1);
+  }
+
+  KATANA_LOG_ASSERT(Read(uri, 0, 4) == "bbbb");
+  KATANA_LOG_ASSERT(mem_storage.num_stats() == stats + 2);
+}
+
+}  // namespace
+
+int
+main() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/filecache");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string cache_dir(uri_res.value().path());
+  katana::SetEnv("KATANA_TSUBA_CACHE_DIR", cache_dir, true);
+
+  tsuba::RegisterFileStorage(&mem_storage);
+  {
+    katana::SharedMemSys sys;
+
+    TestModificationTime();
+    TestVersion();
+    TestBypassUnversioned();
+    TestWaitForFetch();
+    TestStatScope();
+  }
+
+  katana::UnsetEnv("KATANA_TSUBA_CACHE_DIR");
+  fs::remove_all(cache_dir);
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include <cstdio>
+#include <string>
+
+#include "katana/FileGraph.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/URI.h"
+
+namespace {
+
+constexpr size_t kNumNodes = 1000;
+
+size_t
+NumEdges(size_t node) {
+  return node % 5;
+}
+
+size_t
+EdgeDst(size_t node, size_t i) {
+  return (node + i + 1) % kNumNodes;
+}
+
+std::string
+WriteGraph() {
+  size_t num_edges = 0;
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    num_edges += NumEdges(n);
+  }
+
+  katana::FileGraphWriter writer;
+  writer.setNumNodes(kNumNodes);
+  writer.setNumEdges(num_edges);
+  writer.setSizeofEdgeData(0);
+  writer.phase1();
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    writer.incrementDegree(n, NumEdges(n));
+  }
+  writer.phase2();
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    for (size_t i = 0; i < NumEdges(n); ++i) {
+      writer.addNeighbor(n, EdgeDst(n, i));
+    }
+  }
+  writer.finish<void>();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/filegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string filename = uri_res.value().path() + ".gr";
+  writer.toFile(filename);
+  return filename;
+}
+
+void
+TestInterleaved(const std::string& filename) {
+  katana::FileGraph graph;
+  graph.fromFileInterleaved<void>(filename);
+  KATANA_LOG_ASSERT(graph.size() == kNumNodes);
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    size_t i = 0;
+    for (auto e : graph.edges(n)) {
+      KATANA_LOG_ASSERT(graph.getEdgeDst(e) == EdgeDst(n, i));
+      ++i;
+    }
+    KATANA_LOG_ASSERT(i == NumEdges(n));
+  }
+}
+
+void
+TestParts(const std::string& filename) {
+  katana::FileGraph whole;
+  whole.fromFile(filename);
+
+  constexpr size_t kNumParts = 4;
+  size_t num_nodes = 0;
+  size_t num_edges = 0;
+  for (size_t p = 0; p < kNumParts; ++p) {
+    katana::FileGraph part;
+    part.partFromFile(filename, p, kNumParts);
+    // The parts have about the same number of edges
+    KATANA_LOG_ASSERT(part.sizeEdges() >= whole.sizeEdges() / kNumParts / 2);
+    num_nodes += part.size();
+    num_edges += part.sizeEdges();
+  }
+  KATANA_LOG_ASSERT(num_nodes == kNumNodes);
+  KATANA_LOG_ASSERT(num_edges == whole.sizeEdges());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  std::string filename = WriteGraph();
+  TestInterleaved(filename);
+  TestParts(filename);
+  std::remove(filename.c_str());
+
+  return 0;
+}
@@ -17,11 +17,13 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <atomic>
 #include <iostream>
 #include <vector>
 
 #include "katana/Bag.h"
 #include "katana/Galois.h"
+#include "katana/Logging.h"
 
 void
 function_pointer(int x, katana::UserContext<int>&) {
@@ -48,5 +50,20 @@ main() {
   katana::do_all(katana::iterate(v), [&b](int x) { b.push(x); });
   katana::for_each(katana::iterate(b), function_object());
 
+  // skewed loop whose tail is balanced by hierarchical stealing
+  std::vector<std::atomic<int>> visits(1000);
+  katana::do_all(
+      katana::iterate(size_t{0}, visits.size()),
+      [&](size_t i) {
+        for (size_t j = 0; j < i; ++j) {
+          katana::asmPause();
+        }
+        visits[i].fetch_add(1);
+      },
+      katana::hierarchical_steal(), katana::loopname("hierarchical-steal"));
+  for (const auto& count : visits) {
+    KATANA_LOG_ASSERT(count.load() == 1);
+  }
+
   return 0;
 }
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/Frontier.h"
+
+namespace {
+
+using katana::analytics::Frontier;
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+
+/// A \param side x \param side grid with both directions of each edge
+katana::GraphTopology
+MakeGrid(uint32_t side) {
+  std::vector<std::vector<Node>> adj(side * side);
+  for (uint32_t r = 0; r < side; ++r) {
+    for (uint32_t c = 0; c < side; ++c) {
+      auto& neighbors = adj[r * side + c];
+      if (c > 0) {
+        neighbors.push_back(r * side + c - 1);
+      }
+      if (c + 1 < side) {
+        neighbors.push_back(r * side + c + 1);
+      }
+      if (r > 0) {
+        neighbors.push_back((r - 1) * side + c);
+      }
+      if (r + 1 < side) {
+        neighbors.push_back((r + 1) * side + c);
+      }
+    }
+  }
+  return MakeCsrTopology(adj);
+}
+
+void
+TestFrontier() {
+  Frontier frontier(1000);
+  KATANA_LOG_ASSERT(frontier.empty());
+  KATANA_LOG_ASSERT(!frontier.is_dense());
+
+  KATANA_LOG_ASSERT(frontier.Add(3));
+  KATANA_LOG_ASSERT(frontier.Add(999));
+  KATANA_LOG_ASSERT(!frontier.Add(3));
+  KATANA_LOG_ASSERT(frontier.size() == 2);
+  KATANA_LOG_ASSERT(frontier.Contains(3) && !frontier.Contains(4));
+
+  frontier.ToDense();
+  KATANA_LOG_ASSERT(frontier.is_dense());
+  KATANA_LOG_ASSERT(frontier.Add(4));
+  frontier.ToSparse();
+  std::vector<Node> nodes(frontier.sparse().begin(), frontier.sparse().end());
+  std::sort(nodes.begin(), nodes.end());
+  KATANA_LOG_ASSERT(nodes == std::vector<Node>({3, 4, 999}));
+
+  frontier.Clear();
+  KATANA_LOG_ASSERT(frontier.empty());
+  KATANA_LOG_ASSERT(!frontier.Contains(3));
+  KATANA_LOG_ASSERT(frontier.dense().count() == 0);
+}
+
+/// BFS levels on a grid, which are the Manhattan distances from the corner,
+/// with EdgeMap pushing or pulling depending on \param dense_fraction
+void
+TestEdgeMap(uint64_t dense_fraction) {
+  constexpr uint32_t kSide = 100;
+  katana::GraphTopology grid = MakeGrid(kSide);
+
+  std::vector<std::atomic<uint32_t>> level(grid.num_nodes());
+  for (auto& l : level) {
+    l = kUnvisited;
+  }
+
+  auto current = std::make_unique<Frontier>(grid.num_nodes());
+  auto next = std::make_unique<Frontier>(grid.num_nodes());
+  level[0] = 0;
+  next->Add(0);
+  uint32_t round = 0;
+  while (!next->empty()) {
+    std::swap(current, next);
+    ++round;
+    katana::analytics::EdgeMap(
+        grid, grid, current.get(), next.get(),
+        [&](Node, Node dst) {
+          uint32_t expected = kUnvisited;
+          return level[dst].compare_exchange_strong(expected, round);
+        },
+        [&](Node dst) { return level[dst] == kUnvisited; }, "EdgeMap",
+        dense_fraction);
+  }
+
+  KATANA_LOG_ASSERT(round == 2 * (kSide - 1) + 1);
+  for (uint32_t r = 0; r < kSide; ++r) {
+    for (uint32_t c = 0; c < kSide; ++c) {
+      KATANA_LOG_VASSERT(
+          level[r * kSide + c] == r + c, "level of ({}, {}) is {}", r, c,
+          level[r * kSide + c].load());
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestFrontier();
+  // only push
+  TestEdgeMap(1);
+  // only pull
+  TestEdgeMap(std::numeric_limits<uint32_t>::max());
+  // switch direction as the frontier grows and shrinks
+  TestEdgeMap(20);
+
+  return 0;
+}
@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/GpuBackend.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kNumNodes = 1000;
+constexpr Node kSource = 3;
+
+/// An undirected random graph with components [0, 700), [700, 990) and the
+/// isolated nodes [990, kNumNodes)
+std::vector<std::set<Node>>
+MakeNeighbors() {
+  std::mt19937 gen(4321);
+  std::vector<std::set<Node>> neighbors(kNumNodes);
+  auto add_edges = [&](Node begin, Node end, size_t num_edges) {
+    std::uniform_int_distribution<Node> dist(begin, end - 1);
+    for (size_t i = 0; i < num_edges; ++i) {
+      Node a = dist(gen);
+      Node b = dist(gen);
+      neighbors[a].insert(b);
+      neighbors[b].insert(a);
+    }
+    for (Node n = begin + 1; n < end; ++n) {
+      neighbors[n - 1].insert(n);
+      neighbors[n].insert(n - 1);
+    }
+  };
+  add_edges(0, 700, 3000);
+  add_edges(700, 990, 600);
+  return neighbors;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const std::vector<std::set<Node>>& neighbors) {
+  auto pg = MakeCsrGraph(neighbors);
+
+  std::vector<uint32_t> weights(pg->topology().num_edges());
+  for (size_t e = 0; e < weights.size(); ++e) {
+    weights[e] = 1 + (e * 7919) % 100;
+  }
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)})));
+  return pg;
+}
+
+template <typename T>
+std::vector<T>
+GetValues(const katana::PropertyGraph& pg, const std::string& name) {
+  auto values = katana::UnmarshalVector<T>(pg.GetNodeProperty(name));
+  KATANA_LOG_ASSERT(values);
+  KATANA_LOG_ASSERT(values.value().size() == kNumNodes);
+  return std::move(values.value());
+}
+
+/// Without a device kGPU plans fail before they create their output
+void
+TestUnavailable(katana::PropertyGraph* pg) {
+  auto res = katana::analytics::Bfs(
+      pg, kSource, "gpu-parent", katana::analytics::BfsPlan::Gpu());
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(
+      res.error() == katana::ErrorCode::FeatureNotEnabled ||
+      res.error() == katana::ErrorCode::DeviceFailed);
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty("gpu-parent"));
+
+  katana::analytics::GpuBackendCache cache;
+  auto sssp_res = katana::analytics::Sssp(
+      pg, kSource, "weight", "gpu-distance",
+      katana::analytics::SsspPlan::Gpu());
+  KATANA_LOG_ASSERT(!sssp_res);
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty("gpu-distance"));
+}
+
+void
+TestGpuBfs(katana::PropertyGraph* pg) {
+  KATANA_LOG_ASSERT(katana::analytics::Bfs(
+      pg, kSource, "gpu-parent", katana::analytics::BfsPlan::Gpu()));
+  KATANA_LOG_ASSERT(
+      katana::analytics::BfsAssertValid(pg, kSource, "gpu-parent"));
+  KATANA_LOG_ASSERT(!katana::analytics::Bfs(
+      pg, kNumNodes, "gpu-parent2", katana::analytics::BfsPlan::Gpu()));
+}
+
+void
+TestGpuSssp(katana::PropertyGraph* pg) {
+  using katana::analytics::SsspPlan;
+  KATANA_LOG_ASSERT(katana::analytics::Sssp(
+      pg, kSource, "weight", "cpu-distance", SsspPlan::Dijkstra()));
+  auto expected = GetValues<uint32_t>(*pg, "cpu-distance");
+
+  // A small delta takes many buckets, a large one a few
+  for (auto delta : {0U, 4U, unsigned{SsspPlan::kDefaultDelta}}) {
+    std::string name = "gpu-distance-" + std::to_string(delta);
+    KATANA_LOG_ASSERT(katana::analytics::Sssp(
+        pg, kSource, "weight", name, SsspPlan::Gpu(delta)));
+    KATANA_LOG_ASSERT(GetValues<uint32_t>(*pg, name) == expected);
+  }
+}
+
+/// Add one to every weight of pg in place, as a writer through the raw
+/// values of the property would, without a new address or size
+void
+BumpWeights(katana::PropertyGraph* pg) {
+  auto weights = pg->GetEdgeProperty("weight");
+  KATANA_LOG_ASSERT(weights->num_chunks() == 1);
+  auto values =
+      std::static_pointer_cast<arrow::UInt32Array>(weights->chunk(0));
+  auto* raw = const_cast<uint32_t*>(values->raw_values());
+  for (int64_t e = 0; e < values->length(); ++e) {
+    raw[e] += 1;
+  }
+}
+
+/// Without a GpuBackendCache every call sees the current host weights, and
+/// within one ReleaseGpuBackendCache makes the next call see them
+void
+TestGpuSsspReweighted(katana::PropertyGraph* pg) {
+  using katana::analytics::SsspPlan;
+  auto check = [pg](const std::string& name) {
+    KATANA_LOG_ASSERT(katana::analytics::Sssp(
+        pg, kSource, "weight", "cpu-" + name, SsspPlan::Dijkstra()));
+    KATANA_LOG_ASSERT(katana::analytics::Sssp(
+        pg, kSource, "weight", "gpu-" + name, SsspPlan::Gpu()));
+    KATANA_LOG_VASSERT(
+        GetValues<uint32_t>(*pg, "gpu-" + name) ==
+            GetValues<uint32_t>(*pg, "cpu-" + name),
+        "{}", name);
+  };
+
+  check("before");
+  BumpWeights(pg);
+  check("bumped");
+
+  katana::analytics::GpuBackendCache cache;
+  check("cached");
+  KATANA_LOG_ASSERT(katana::analytics::Sssp(
+      pg, kSource, "weight", "gpu-cached2", SsspPlan::Gpu()));
+  KATANA_LOG_ASSERT(
+      GetValues<uint32_t>(*pg, "gpu-cached2") ==
+      GetValues<uint32_t>(*pg, "cpu-cached"));
+  BumpWeights(pg);
+  katana::analytics::ReleaseGpuBackendCache();
+  check("released");
+}
+
+void
+TestGpuConnectedComponents(
+    katana::PropertyGraph* pg, const std::string& name) {
+  KATANA_LOG_ASSERT(katana::analytics::ConnectedComponents(
+      pg, name, katana::analytics::ConnectedComponentsPlan::Gpu()));
+  KATANA_LOG_ASSERT(
+      katana::analytics::ConnectedComponentsAssertValid(pg, name));
+  auto components = GetValues<uint64_t>(*pg, name);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    Node expected = n < 700 ? 0 : n < 990 ? 700 : n;
+    KATANA_LOG_VASSERT(components[n] == components[expected], "node {}", n);
+    KATANA_LOG_VASSERT(
+        (n < 700) == (components[n] == components[0]), "node {}", n);
+  }
+}
+
+void
+TestGpuPagerank(
+    katana::PropertyGraph* pg, const std::vector<std::set<Node>>& neighbors) {
+  auto plan = katana::analytics::PagerankPlan::Gpu(1e-6, 1000);
+  std::vector<double> expected(kNumNodes, plan.initial_residual());
+  for (unsigned iter = 0; iter < plan.max_iterations(); ++iter) {
+    std::vector<double> sums(kNumNodes);
+    for (Node n = 0; n < kNumNodes; ++n) {
+      for (Node dst : neighbors[n]) {
+        sums[dst] += expected[n] / neighbors[n].size();
+      }
+    }
+    double delta = 0;
+    for (Node n = 0; n < kNumNodes; ++n) {
+      double rank = (1 - plan.alpha()) + plan.alpha() * sums[n];
+      delta = std::max(delta, std::abs(rank - expected[n]));
+      expected[n] = rank;
+    }
+    if (delta <= plan.tolerance()) {
+      break;
+    }
+  }
+
+  KATANA_LOG_ASSERT(katana::analytics::Pagerank(pg, "gpu-rank", plan));
+  auto ranks = GetValues<float>(*pg, "gpu-rank");
+  for (Node n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(ranks[n] - expected[n]) < 1e-3, "node {}: {} != {}", n,
+        ranks[n], expected[n]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto neighbors = MakeNeighbors();
+  auto pg = MakeGraph(neighbors);
+
+  if (!katana::analytics::GpuBackendAvailable()) {
+    TestUnavailable(pg.get());
+    return 0;
+  }
+
+  TestGpuBfs(pg.get());
+  TestGpuSssp(pg.get());
+  TestGpuConnectedComponents(pg.get(), "gpu-component");
+  TestGpuPagerank(pg.get(), neighbors);
+
+  {
+    // The analytics upload the graph again after the cache is released
+    katana::analytics::GpuBackendCache cache;
+    TestGpuConnectedComponents(pg.get(), "gpu-component2");
+    TestGpuConnectedComponents(pg.get(), "gpu-component3");
+    katana::analytics::ReleaseGpuBackendCache();
+    TestGpuConnectedComponents(pg.get(), "gpu-component4");
+  }
+  TestGpuSsspReweighted(pg.get());
+
+  return 0;
+}
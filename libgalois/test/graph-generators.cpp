@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include <arrow/api.h>
+
+#include "katana/GraphGenerators.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint64_t kSeed = 42;
+
+/// The topology is well formed and the edges of each node are sorted,
+/// without repeats or self loops if simple
+void
+CheckTopology(const katana::GraphTopology& topo, bool simple) {
+  KATANA_LOG_ASSERT(topo.Validate());
+  for (Node n = 0; n < topo.num_nodes(); ++n) {
+    for (auto e : topo.edges(n)) {
+      if (e == *topo.edges(n).begin()) {
+        continue;
+      }
+      Node prev = topo.edge_dest(e - 1);
+      Node dst = topo.edge_dest(e);
+      KATANA_LOG_ASSERT(simple ? prev < dst : prev <= dst);
+      KATANA_LOG_ASSERT(!simple || dst != n);
+    }
+  }
+}
+
+/// The same seed gives the same graph for any number of threads
+template <typename Generate>
+void
+CheckDeterministic(const Generate& generate) {
+  katana::setActiveThreads(1);
+  uint64_t serial = generate().Fingerprint();
+  katana::setActiveThreads(4);
+  KATANA_LOG_ASSERT(generate().Fingerprint() == serial);
+}
+
+void
+TestRMAT() {
+  katana::RMATParams params;
+  params.scale = 12;
+  params.edge_factor = 8;
+  auto generate = [&]() {
+    return std::move(katana::GenerateRMAT(params, kSeed).value());
+  };
+
+  katana::GraphTopology topo = generate();
+  KATANA_LOG_ASSERT(topo.num_nodes() == 4096);
+  KATANA_LOG_ASSERT(topo.num_edges() == 4096 * 8);
+  CheckTopology(topo, false);
+  CheckDeterministic(generate);
+
+  // the degrees are skewed
+  uint64_t max_degree = 0;
+  for (Node n = 0; n < topo.num_nodes(); ++n) {
+    max_degree = std::max<uint64_t>(max_degree, topo.degree(n));
+  }
+  KATANA_LOG_VASSERT(max_degree > 20 * 8, "max degree {}", max_degree);
+
+  params.remove_duplicates = true;
+  katana::GraphTopology simple = generate();
+  KATANA_LOG_ASSERT(simple.num_edges() < topo.num_edges());
+  CheckTopology(simple, true);
+
+  params.scale = 0;
+  KATANA_LOG_ASSERT(!katana::GenerateRMAT(params, kSeed));
+}
+
+void
+TestSBM() {
+  katana::SBMParams params;
+  params.num_nodes = 10000;
+  params.num_blocks = 10;
+  params.p_in = 0.01;
+  params.p_out = 0.0001;
+  auto generate = [&]() {
+    return std::move(katana::GenerateSBM(params, kSeed).value());
+  };
+
+  katana::GraphTopology topo = generate();
+  KATANA_LOG_ASSERT(topo.num_nodes() == params.num_nodes);
+  CheckTopology(topo, true);
+  CheckDeterministic(generate);
+
+  // about 10 edges within blocks and 0.9 across blocks per node
+  uint64_t within = 0;
+  for (Node n = 0; n < topo.num_nodes(); ++n) {
+    for (auto e : topo.edges(n)) {
+      within += n / 1000 == topo.edge_dest(e) / 1000;
+    }
+  }
+  uint64_t across = topo.num_edges() - within;
+  KATANA_LOG_VASSERT(
+      within > 90000 && within < 110000, "{} edges within blocks", within);
+  KATANA_LOG_VASSERT(
+      across > 8000 && across < 10000, "{} edges across blocks", across);
+
+  params.num_blocks = 0;
+  KATANA_LOG_ASSERT(!katana::GenerateSBM(params, kSeed));
+}
+
+void
+TestRandomGeometric() {
+  katana::RandomGeometricParams params;
+  params.num_nodes = 20000;
+  params.avg_degree = 6;
+  auto generate = [&]() {
+    return std::move(katana::GenerateRandomGeometric(params, kSeed).value());
+  };
+
+  katana::GraphTopology topo = generate();
+  KATANA_LOG_ASSERT(topo.num_nodes() == params.num_nodes);
+  CheckTopology(topo, true);
+  CheckDeterministic(generate);
+
+  // fewer neighbors near the border of the square
+  double avg_degree = static_cast<double>(topo.num_edges()) / topo.num_nodes();
+  KATANA_LOG_VASSERT(
+      avg_degree > 5 && avg_degree < 6.5, "average degree {}", avg_degree);
+
+  // edges go both ways
+  for (Node n = 0; n < topo.num_nodes(); ++n) {
+    for (auto e : topo.edges(n)) {
+      Node dst = topo.edge_dest(e);
+      bool found = false;
+      for (auto back : topo.edges(dst)) {
+        found |= topo.edge_dest(back) == n;
+      }
+      KATANA_LOG_ASSERT(found);
+    }
+  }
+}
+
+void
+TestRandomProperties() {
+  auto table = katana::GenerateRandomProperties(
+                   100000, 2, "weight", arrow::int64(), kSeed)
+                   .value();
+  KATANA_LOG_ASSERT(table->num_columns() == 2);
+  KATANA_LOG_ASSERT(table->num_rows() == 100000);
+  KATANA_LOG_ASSERT(table->field(1)->name() == "weight1");
+  KATANA_LOG_ASSERT(!table->column(0)->Equals(table->column(1)));
+
+  auto again = katana::GenerateRandomProperties(
+                   100000, 2, "weight", arrow::int64(), kSeed)
+                   .value();
+  KATANA_LOG_ASSERT(table->Equals(*again));
+
+  const auto& weights =
+      static_cast<const arrow::Int64Array&>(*table->column(0)->chunk(0));
+  for (int64_t i = 0; i < weights.length(); ++i) {
+    KATANA_LOG_ASSERT(weights.Value(i) >= 1 && weights.Value(i) <= 100);
+  }
+
+  KATANA_LOG_ASSERT(!katana::GenerateRandomProperties(
+      10, 1, "name", arrow::utf8(), kSeed));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestRMAT();
+  TestSBM();
+  TestRandomGeometric();
+  TestRandomProperties();
+
+  return 0;
+}
@@ -20,6 +20,9 @@
 #include "katana/Graph.h"
 
 #include <string>
+#include <tuple>
+
+#include "katana/Logging.h"
 
 int
 useGraph(std::string inputfile) {
@@ -73,9 +76,35 @@ useGraphCxx11(std::string inputfile) {
   return sum;
 }
 
+void
+useNodeFields() {
+  using Graph = katana::LC_CSR_Graph<int, int>::with_node_fields<
+      std::tuple<uint32_t, double>>::type;
+
+  // A cycle of 4 nodes
+  Graph g(
+      4, 4, [](uint32_t) { return 1; },
+      [](uint32_t n, uint64_t) { return (n + 1) % 4; },
+      [](uint32_t n, uint64_t) { return static_cast<int>(n); });
+
+  for (Graph::GraphNode n : g) {
+    g.getData(n) = n;
+    g.getField<0>(n) = 10 * n;
+    g.getField<1>(n) = 0.5 * n;
+  }
+  for (Graph::GraphNode n : g) {
+    Graph::GraphNode dst = g.getEdgeDst(*g.edges(n).begin());
+    KATANA_LOG_ASSERT(g.getField<0>(dst) == 10 * dst);
+    KATANA_LOG_ASSERT(g.getField<1>(dst) == 0.5 * dst);
+    KATANA_LOG_ASSERT(g.getData(dst) == static_cast<int>(dst));
+  }
+  KATANA_LOG_ASSERT(g.getFieldArray<0>()[3] == 30);
+}
+
 int
 main(int argc, char** argv) {
   katana::SharedMemSys G;
+  useNodeFields();
   if (argc > 1) {
     useGraph(argv[1]);
     useGraphCxx11(argv[1]);
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "katana/ConcurrentHashMap.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Mem.h"
+#include "katana/Reduction.h"
+#include "katana/ScratchHashMap.h"
+
+namespace {
+
+void
+TestScratchHashMap() {
+  katana::ScratchHashMap<uint64_t, uint64_t> map;
+  KATANA_LOG_ASSERT(map.empty());
+  KATANA_LOG_ASSERT(!map.Find(1));
+
+  for (int round = 0; round < 3; ++round) {
+    for (uint64_t i = 0; i < 1000; ++i) {
+      map[i % 100] += i;
+    }
+    KATANA_LOG_ASSERT(map.size() == 100);
+
+    // entries are in insertion order
+    uint64_t key = 0;
+    for (const auto& [k, v] : map) {
+      KATANA_LOG_ASSERT(k == key);
+      KATANA_LOG_ASSERT(v == 10 * k + 100 * 45);
+      ++key;
+    }
+    KATANA_LOG_ASSERT(*map.Find(7) == 70 + 4500);
+    KATANA_LOG_ASSERT(!map.Find(100));
+
+    map.Clear();
+    KATANA_LOG_ASSERT(map.empty());
+    KATANA_LOG_ASSERT(!map.Find(7));
+  }
+}
+
+void
+TestScratchHashMapPerIterAlloc() {
+  std::vector<uint32_t> items(1000);
+  for (uint32_t i = 0; i < items.size(); ++i) {
+    items[i] = i;
+  }
+
+  katana::GAccumulator<uint64_t> distinct;
+  katana::for_each(
+      katana::iterate(items),
+      [&](uint32_t item, auto& ctx) {
+        katana::ScratchHashMap<
+            uint32_t, uint32_t, std::hash<uint32_t>, katana::PerIterAllocTy>
+            map(ctx.getPerIterAlloc());
+        for (uint32_t i = 0; i <= item; ++i) {
+          map[i % 64] += 1;
+        }
+        distinct += map.size();
+      },
+      katana::no_pushes(), katana::per_iter_alloc());
+
+  uint64_t expected = 0;
+  for (uint32_t item : items) {
+    expected += std::min(item + 1, 64u);
+  }
+  KATANA_LOG_ASSERT(distinct.reduce() == expected);
+}
+
+void
+TestConcurrentHashMap() {
+  constexpr uint64_t kKeys = 5000;
+  katana::ConcurrentHashMap<uint64_t, uint64_t> map(kKeys);
+  KATANA_LOG_ASSERT(map.capacity() >= 2 * kKeys);
+
+  for (int round = 0; round < 2; ++round) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, 10 * kKeys),
+        [&](uint64_t i) {
+          map.FindOrInsert(i % kKeys).fetch_add(i, std::memory_order_relaxed);
+        },
+        katana::steal());
+    KATANA_LOG_ASSERT(map.size() == kKeys);
+
+    for (uint64_t k = 0; k < kKeys; ++k) {
+      const std::atomic<uint64_t>* value = map.Find(k);
+      KATANA_LOG_ASSERT(value);
+      KATANA_LOG_ASSERT(*value == 10 * k + kKeys * 45);
+    }
+    KATANA_LOG_ASSERT(!map.Find(kKeys));
+
+    katana::GAccumulator<uint64_t> sum;
+    map.ForEach([&](uint64_t, uint64_t value) { sum += value; });
+    uint64_t n = 10 * kKeys;
+    KATANA_LOG_ASSERT(sum.reduce() == n * (n - 1) / 2);
+
+    map.Clear();
+    KATANA_LOG_ASSERT(map.empty());
+    KATANA_LOG_ASSERT(!map.Find(1));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestScratchHashMap();
+  TestScratchHashMapPerIterAlloc();
+  TestConcurrentHashMap();
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphTopology.h"
+#include "katana/HubAdjacency.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kNumNodes = 2000;
+
+/// A random graph where node n has about kNumNodes / (n + 1) edges, so that
+/// the low ids are hubs
+katana::GraphTopology
+MakePowerLawGraph(std::set<std::pair<Node, Node>>* edges) {
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<Node> dist(0, kNumNodes - 1);
+  std::vector<std::set<Node>> adj(kNumNodes);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    for (uint32_t i = 0; i < kNumNodes / (n + 1); ++i) {
+      adj[n].insert(dist(gen));
+    }
+    for (Node dst : adj[n]) {
+      edges->emplace(n, dst);
+    }
+  }
+  return MakeCsrTopology(adj);
+}
+
+void
+TestHubAdjacency() {
+  std::set<std::pair<Node, Node>> edges;
+  katana::GraphTopology topo = MakePowerLawGraph(&edges);
+
+  constexpr size_t kNumHubs = 5;
+  auto adjacency = katana::HubAdjacency::Make(topo, kNumHubs, 10);
+  KATANA_LOG_ASSERT(adjacency.num_hubs() == kNumHubs);
+
+  std::vector<Node> by_degree(kNumNodes);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    by_degree[n] = n;
+  }
+  std::sort(by_degree.begin(), by_degree.end(), [&](Node a, Node b) {
+    return topo.degree(a) > topo.degree(b) ||
+           (topo.degree(a) == topo.degree(b) && a < b);
+  });
+  by_degree.resize(kNumHubs);
+  KATANA_LOG_ASSERT(adjacency.hubs() == by_degree);
+
+  for (Node src = 0; src < kNumNodes; ++src) {
+    KATANA_LOG_ASSERT(
+        adjacency.is_hub(src) ==
+        (std::find(by_degree.begin(), by_degree.end(), src) !=
+         by_degree.end()));
+    // sample the destinations of the non-hubs to keep the test fast
+    Node step = adjacency.is_hub(src) ? 1 : 97;
+    for (Node dst = src % step; dst < kNumNodes; dst += step) {
+      KATANA_LOG_VASSERT(
+          adjacency.HasEdge(topo, src, dst) == (edges.count({src, dst}) > 0),
+          "edge {} -> {}", src, dst);
+    }
+  }
+
+  // nodes below the minimum degree are never hubs
+  auto few = katana::HubAdjacency::Make(topo, kNumNodes, kNumNodes);
+  KATANA_LOG_ASSERT(few.num_hubs() == 0);
+  KATANA_LOG_ASSERT(!few.HasEdge(topo, kNumNodes - 1, kNumNodes));
+  KATANA_LOG_ASSERT(katana::HubAdjacency::NumHubsForBudget(kNumNodes, 0) == 0);
+  KATANA_LOG_ASSERT(
+      katana::HubAdjacency::NumHubsForBudget(kNumNodes, 10 * 256) == 10);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestHubAdjacency();
+
+  return 0;
+}
@@ -32,7 +32,8 @@ printMyTopo() {
   for (unsigned i = 0; i < t.machineTopoInfo.maxThreads; ++i) {
     auto& c = t.threadTopoInfo[i];
     std::cout << "tid: " << c.tid << " leader: " << c.socketLeader
-              << " socket: " << c.socket << " numaNode: " << c.numaNode
+              << " socket: " << c.socket << " core: " << c.core
+              << " numaNode: " << c.numaNode
               << " cumulativeMaxSocket: " << c.cumulativeMaxSocket
               << " osContext: " << c.osContext
               << " osNumaNode: " << c.osNumaNode << "\n";
@@ -61,9 +62,50 @@ test(
   }
 }
 
+void
+testCores() {
+  auto t = katana::getHWTopo();
+  for (const auto& a : t.threadTopoInfo) {
+    if (a.core >= t.machineTopoInfo.maxCores) {
+      std::cerr << "test cores failed: core " << a.core << " of tid " << a.tid
+                << " out of range\n";
+      std::abort();
+    }
+    for (const auto& b : t.threadTopoInfo) {
+      if (a.core == b.core && a.socket != b.socket) {
+        std::cerr << "test cores failed: tids " << a.tid << " and " << b.tid
+                  << " share a core but not a socket\n";
+        std::abort();
+      }
+    }
+  }
+}
+
+void
+testFormat() {
+  auto t = katana::getHWTopo();
+  std::string description = katana::formatHWTopo(t, "0-3");
+
+  katana::HWTopoInfo parsed;
+  if (!katana::parseHWTopo(description, "0-3", &parsed) ||
+      katana::formatHWTopo(parsed, "0-3") != description) {
+    std::cerr << "test format failed: description does not round trip\n";
+    std::abort();
+  }
+  if (katana::parseHWTopo(description, "0-7", &parsed) ||
+      katana::parseHWTopo(
+          description.substr(0, description.size() / 2), "0-3", &parsed) ||
+      katana::parseHWTopo("", "0-3", &parsed)) {
+    std::cerr << "test format failed: accepted an invalid description\n";
+    std::abort();
+  }
+}
+
 int
 main() {
   printMyTopo();
+  testCores();
+  testFormat();
 
   using namespace katana;
 
@@ -82,5 +124,13 @@ main() {
       "parse range", parseCPUList("     0-4   \n"),
       std::vector<int>{0, 1, 2, 3, 4});
 
+  if (parseCPUQuota("250000 100000") != 3 ||
+      parseCPUQuota("100000 100000") != 1 ||
+      parseCPUQuota("max 100000") != 0 || parseCPUQuota("-1 100000") != 0 ||
+      parseCPUQuota("50000") != 0 || parseCPUQuota("") != 0) {
+    std::cerr << "test cpu quota failed\n";
+    std::abort();
+  }
+
   return 0;
 }
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "katana/HyperLogLog.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+uint64_t
+Mix(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+void
+TestEstimate() {
+  constexpr uint32_t kLog2NumRegisters = 10;
+  const std::vector<uint64_t> cardinalities = {0, 10, 1000, 100000};
+  katana::HyperLogLogArray counters(cardinalities.size(), kLog2NumRegisters);
+  for (size_t i = 0; i < cardinalities.size(); ++i) {
+    for (uint64_t v = 0; v < cardinalities[i]; ++v) {
+      // adding a value twice changes nothing
+      counters.Add(i, Mix(v));
+      counters.Add(i, Mix(v));
+    }
+  }
+
+  // 5 standard errors
+  double tolerance = 5 * 1.04 / std::sqrt(counters.num_registers());
+  KATANA_LOG_ASSERT(counters.Estimate(0) == 0);
+  for (size_t i = 1; i < cardinalities.size(); ++i) {
+    double estimate = counters.Estimate(i);
+    KATANA_LOG_VASSERT(
+        std::abs(estimate - cardinalities[i]) <= tolerance * cardinalities[i],
+        "estimate {} of {}", estimate, cardinalities[i]);
+  }
+
+  // the union of 1000 and 100000 values, of which 1000 are the same
+  katana::HyperLogLogArray merged(1, kLog2NumRegisters);
+  merged.Copy(0, counters, 2);
+  KATANA_LOG_ASSERT(merged.Merge(0, counters, 3));
+  KATANA_LOG_ASSERT(!merged.Merge(0, counters, 2));
+  KATANA_LOG_ASSERT(
+      std::equal(
+          merged.counter(0), merged.counter(0) + merged.num_registers(),
+          counters.counter(3)));
+}
+
+void
+TestMaxMerge() {
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<uint32_t> dist(0, 63);
+  // sizes around the vector widths
+  for (size_t size : {0, 1, 31, 32, 33, 64, 100, 1024}) {
+    std::vector<uint8_t> to(size);
+    std::vector<uint8_t> from(size);
+    for (size_t i = 0; i < size; ++i) {
+      to[i] = dist(gen);
+      from[i] = dist(gen);
+    }
+    std::vector<uint8_t> expected(size);
+    bool expected_changed = false;
+    for (size_t i = 0; i < size; ++i) {
+      expected[i] = std::max(to[i], from[i]);
+      expected_changed |= expected[i] != to[i];
+    }
+    KATANA_LOG_ASSERT(
+        katana::MaxMerge(to.data(), from.data(), size) == expected_changed);
+    KATANA_LOG_ASSERT(to == expected);
+    KATANA_LOG_ASSERT(!katana::MaxMerge(to.data(), from.data(), size));
+
+    // a change only in the last register
+    if (size > 0) {
+      from = to;
+      ++from[size - 1];
+      KATANA_LOG_ASSERT(katana::MaxMerge(to.data(), from.data(), size));
+      KATANA_LOG_ASSERT(to == from);
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestEstimate();
+  TestMaxMerge();
+
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+
+namespace {
+
+void
+TestCompact() {
+  katana::InsertBag<size_t> bag;
+  // Every third element twice, so that threads insert different numbers of
+  // elements
+  katana::do_all(
+      katana::iterate(size_t{0}, size_t{100000}),
+      [&](size_t i) {
+        if (i % 3 == 0) {
+          bag.push(i);
+          bag.push(i);
+        }
+      },
+      katana::steal());
+  KATANA_LOG_ASSERT(bag.size() == 2 * 33334);
+
+  katana::NUMAArray<size_t> array;
+  bag.compact(&array);
+  KATANA_LOG_ASSERT(array.size() == bag.size());
+  KATANA_LOG_ASSERT(std::equal(bag.begin(), bag.end(), array.begin()));
+
+  std::vector<size_t> sorted(array.begin(), array.end());
+  std::sort(sorted.begin(), sorted.end());
+  for (size_t k = 0; k < sorted.size(); k += 2) {
+    KATANA_LOG_ASSERT(sorted[k] == sorted[k + 1]);
+    KATANA_LOG_ASSERT(sorted[k] % 3 == 0);
+  }
+
+  // Compacting again replaces the contents of the array
+  bag.clear();
+  bag.push(7);
+  bag.compact(&array);
+  KATANA_LOG_ASSERT(array.size() == 1 && array[0] == 7);
+
+  bag.clear();
+  bag.compact(&array);
+  KATANA_LOG_ASSERT(array.size() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestCompact();
+
+  return 0;
+}
@@ -0,0 +1,40 @@
+#include <cstdlib>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/LoopStatistics.h"
+#include "katana/Reduction.h"
+
+/// Loops must run to completion with hardware counters enabled, whether or not
+/// the machine lets us open them
+int
+main() {
+  setenv("KATANA_LOOP_COUNTERS", "1", 1);
+  KATANA_LOG_ASSERT(katana::internal::LoopCountersEnabled());
+
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  constexpr uint64_t kNum = 1 << 20;
+
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNum), [&](uint64_t i) { sum += i; },
+      katana::loopname("DoAll"));
+  KATANA_LOG_ASSERT(sum.reduce() == kNum * (kNum - 1) / 2);
+
+  sum.reset();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNum), [&](uint64_t i) { sum += i; },
+      katana::steal(), katana::loopname("DoAllSteal"));
+  KATANA_LOG_ASSERT(sum.reduce() == kNum * (kNum - 1) / 2);
+
+  sum.reset();
+  katana::for_each(
+      katana::iterate(uint64_t{0}, kNum),
+      [&](uint64_t i, auto&) { sum += i; }, katana::loopname("ForEach"),
+      katana::disable_conflict_detection());
+  KATANA_LOG_ASSERT(sum.reduce() == kNum * (kNum - 1) / 2);
+
+  return 0;
+}
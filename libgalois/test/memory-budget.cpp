@@ -0,0 +1,110 @@
+#include <cstdint>
+#include <memory>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/MemoryBudget.h"
+#include "katana/NUMAArray.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr size_t kMiB = 1 << 20;
+
+void
+TestBudgetExceeded() {
+  KATANA_LOG_ASSERT(!katana::MemoryBudget::current());
+
+  int calls = 0;
+  katana::MemoryBudget budget(
+      "outer", 16 * kMiB, [&](const katana::MemoryBudget& b) {
+        KATANA_LOG_ASSERT(b.name() == "outer");
+        ++calls;
+      });
+  KATANA_LOG_ASSERT(katana::MemoryBudget::current() == &budget);
+  KATANA_LOG_ASSERT(budget.Check());
+
+  {
+    katana::NUMAArray<uint64_t> small;
+    small.allocateBlocked(kMiB / sizeof(uint64_t));
+    KATANA_LOG_ASSERT(budget.used_bytes() >= kMiB);
+    KATANA_LOG_ASSERT(!budget.exceeded());
+  }
+  KATANA_LOG_ASSERT(budget.used_bytes() == 0);
+
+  {
+    katana::MemoryBudget inner("inner", 1024 * kMiB);
+    KATANA_LOG_ASSERT(katana::MemoryBudget::current() == &inner);
+
+    katana::NUMAArray<uint64_t> interleaved;
+    interleaved.allocateInterleaved(32 * kMiB / sizeof(uint64_t));
+    katana::NUMAArray<uint64_t> blocked;
+    blocked.allocateBlocked(32 * kMiB / sizeof(uint64_t));
+    KATANA_LOG_ASSERT(inner.peak_bytes() >= 64 * kMiB);
+    KATANA_LOG_ASSERT(inner.Check());
+  }
+  KATANA_LOG_ASSERT(katana::MemoryBudget::current() == &budget);
+
+  KATANA_LOG_ASSERT(budget.exceeded());
+  KATANA_LOG_ASSERT(budget.peak_bytes() >= 64 * kMiB);
+  KATANA_LOG_ASSERT(calls == 1);
+  auto res = budget.Check();
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::OutOfMemory);
+}
+
+void
+TestPhases() {
+  KATANA_LOG_ASSERT(!katana::MemoryPhase::current());
+
+  katana::MemoryPhase outer("Outer");
+  KATANA_LOG_ASSERT(katana::MemoryPhase::current() == &outer);
+  KATANA_LOG_ASSERT(outer.region() == "(NULL)");
+
+  katana::NUMAArray<uint64_t> kept;
+  kept.allocateBlocked(kMiB / sizeof(uint64_t));
+  {
+    katana::MemoryPhase inner("Inner", "Region");
+    KATANA_LOG_ASSERT(katana::MemoryPhase::current() == &inner);
+
+    katana::NUMAArray<uint64_t> scratch;
+    scratch.allocateInterleaved(32 * kMiB / sizeof(uint64_t));
+    KATANA_LOG_ASSERT(inner.peak_bytes() >= 32 * kMiB);
+    KATANA_LOG_ASSERT(inner.peak_bytes() < outer.peak_bytes());
+  }
+  KATANA_LOG_ASSERT(katana::MemoryPhase::current() == &outer);
+
+  // the scratch array of the inner phase is freed, and the outer phase
+  // still holds the kept array
+  KATANA_LOG_ASSERT(outer.used_bytes() >= kMiB);
+  KATANA_LOG_ASSERT(outer.used_bytes() < 32 * kMiB);
+  KATANA_LOG_ASSERT(outer.peak_bytes() >= 33 * kMiB);
+
+  // phases of concurrent computations end in any order
+  auto first = std::make_unique<katana::MemoryPhase>("First");
+  auto second = std::make_unique<katana::MemoryPhase>("Second");
+  first.reset();
+  KATANA_LOG_ASSERT(katana::MemoryPhase::current() == second.get());
+  {
+    katana::NUMAArray<uint64_t> array;
+    array.allocateBlocked(kMiB / sizeof(uint64_t));
+    KATANA_LOG_ASSERT(second->used_bytes() >= kMiB);
+  }
+  second.reset();
+  KATANA_LOG_ASSERT(katana::MemoryPhase::current() == &outer);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestBudgetExceeded();
+  KATANA_LOG_ASSERT(!katana::MemoryBudget::current());
+
+  TestPhases();
+  KATANA_LOG_ASSERT(!katana::MemoryPhase::current());
+
+  return 0;
+}
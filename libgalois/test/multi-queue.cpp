@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/MultiQueue.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+void
+TestSerialOrder() {
+  katana::MultiQueue<std::less<double>, double>::rethread<false> wl;
+  std::vector<double> values{3.5, -1.0, 2.25, 0.5, 2.25, 10.0};
+  wl.push(values.begin(), values.end());
+  std::sort(values.begin(), values.end());
+  for (double v : values) {
+    auto popped = wl.pop();
+    KATANA_LOG_ASSERT(popped && *popped == v);
+  }
+  KATANA_LOG_ASSERT(!wl.pop());
+}
+
+struct Edge {
+  size_t dst;
+  double weight;
+};
+
+struct Request {
+  size_t node;
+  double dist;
+};
+
+struct RequestLess {
+  bool operator()(const Request& a, const Request& b) const {
+    return a.dist < b.dist;
+  }
+};
+
+/// Compute shortest paths from node 0 of a random graph with floating-point
+/// weights in parallel and compare them to those of a serial Dijkstra
+void
+TestShortestPaths(size_t num_nodes, size_t degree) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<size_t> node_dist(0, num_nodes - 1);
+  std::uniform_real_distribution<double> weight_dist(0.0, 1.0);
+  std::vector<std::vector<Edge>> graph(num_nodes);
+  for (auto& edges : graph) {
+    for (size_t i = 0; i < degree; ++i) {
+      edges.push_back(Edge{node_dist(rng), weight_dist(rng)});
+    }
+  }
+
+  constexpr double kInfinity = std::numeric_limits<double>::infinity();
+  std::vector<double> expected(num_nodes, kInfinity);
+  auto greater = [](const Request& a, const Request& b) {
+    return a.dist > b.dist;
+  };
+  std::priority_queue<Request, std::vector<Request>, decltype(greater)> heap(
+      greater);
+  expected[0] = 0;
+  heap.push(Request{0, 0});
+  while (!heap.empty()) {
+    Request req = heap.top();
+    heap.pop();
+    if (req.dist > expected[req.node]) {
+      continue;
+    }
+    for (const Edge& e : graph[req.node]) {
+      if (req.dist + e.weight < expected[e.dst]) {
+        expected[e.dst] = req.dist + e.weight;
+        heap.push(Request{e.dst, expected[e.dst]});
+      }
+    }
+  }
+
+  std::vector<std::atomic<double>> dists(num_nodes);
+  for (auto& d : dists) {
+    d.store(kInfinity);
+  }
+  dists[0] = 0;
+  std::vector<Request> initial{Request{0, 0}};
+  katana::for_each(
+      katana::iterate(initial),
+      [&](const Request& req, katana::UserContext<Request>& ctx) {
+        if (req.dist > dists[req.node].load(std::memory_order_relaxed)) {
+          return;
+        }
+        for (const Edge& e : graph[req.node]) {
+          double new_dist = req.dist + e.weight;
+          if (katana::atomicMin(dists[e.dst], new_dist) > new_dist) {
+            ctx.push(Request{e.dst, new_dist});
+          }
+        }
+      },
+      katana::wl<katana::MultiQueue<RequestLess>>(),
+      katana::disable_conflict_detection(), katana::no_stats());
+
+  for (size_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_VASSERT(
+        dists[n].load() == expected[n], "node {}: {} expected {}", n,
+        dists[n].load(), expected[n]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestSerialOrder();
+  TestShortestPaths(1000, 4);
+  TestShortestPaths(10000, 8);
+
+  return 0;
+}
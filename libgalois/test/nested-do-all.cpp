@@ -0,0 +1,112 @@
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint32_t kHubDegree = 1 << 20;
+constexpr uint32_t kDegree = 4;
+
+/// A star-like graph as degrees: node 0 is a hub and the others have few
+/// edges, so a thread that gets the hub holds up the loop unless others help
+std::vector<uint32_t>
+MakeDegrees(uint32_t num_nodes) {
+  std::vector<uint32_t> degrees(num_nodes, kDegree);
+  degrees[0] = kHubDegree;
+  return degrees;
+}
+
+template <typename... Args>
+void
+TestNested(Args&&... args) {
+  uint32_t num_nodes = 4 * katana::getActiveThreads();
+  std::vector<uint32_t> degrees = MakeDegrees(num_nodes);
+  std::vector<std::atomic<uint32_t>> hub_visits(kHubDegree);
+  std::atomic<uint64_t> total{0};
+
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t node) {
+        katana::do_all(
+            katana::iterate(uint32_t{0}, degrees[node]),
+            [&](uint32_t edge) {
+              if (node == 0) {
+                hub_visits[edge].fetch_add(1, std::memory_order_relaxed);
+              }
+              total.fetch_add(1, std::memory_order_relaxed);
+            },
+            katana::no_stats());
+      },
+      std::forward<Args>(args)..., katana::no_stats());
+
+  KATANA_LOG_ASSERT(total == kHubDegree + (num_nodes - 1) * kDegree);
+  for (const auto& visits : hub_visits) {
+    KATANA_LOG_ASSERT(visits == 1);
+  }
+}
+
+/// Loops nested in nested loops run serially but must still run fully
+void
+TestDeeplyNested() {
+  uint32_t num_nodes = 2 * katana::getActiveThreads();
+  std::atomic<uint64_t> total{0};
+
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t) {
+        katana::do_all(
+            katana::iterate(uint32_t{0}, uint32_t{1000}),
+            [&](uint32_t) {
+              katana::do_all(
+                  katana::iterate(uint32_t{0}, kDegree),
+                  [&](uint32_t) {
+                    total.fetch_add(1, std::memory_order_relaxed);
+                  },
+                  katana::no_stats());
+            },
+            katana::no_stats());
+      },
+      katana::no_stats());
+
+  KATANA_LOG_ASSERT(total == uint64_t{num_nodes} * 1000 * kDegree);
+}
+
+void
+TestCancelled() {
+  katana::CancellationToken token;
+  token.Cancel();
+  std::atomic<uint64_t> total{0};
+
+  katana::do_all(
+      katana::iterate(uint32_t{0}, katana::getActiveThreads()),
+      [&](uint32_t) {
+        katana::do_all(
+            katana::iterate(uint32_t{0}, kHubDegree),
+            [&](uint32_t) { total.fetch_add(1, std::memory_order_relaxed); },
+            katana::cancellation(&token), katana::no_stats());
+      },
+      katana::no_stats());
+
+  KATANA_LOG_ASSERT(total == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestNested();
+  TestNested(katana::steal());
+  TestDeeplyNested();
+  TestCancelled();
+
+  katana::setActiveThreads(1);
+  TestNested();
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/NodeOrdering.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// A \param side x \param side grid with both directions of each edge, with node ids
+/// shuffled so that the initial bandwidth is large
+katana::GraphTopology
+MakeShuffledGrid(uint32_t side, std::vector<Node>* label) {
+  uint32_t num_nodes = side * side;
+  label->resize(num_nodes);
+  std::iota(label->begin(), label->end(), 0);
+  std::mt19937 gen(12345);
+  std::shuffle(label->begin(), label->end(), gen);
+
+  std::vector<std::vector<Node>> adj(num_nodes);
+  auto connect = [&](uint32_t a, uint32_t b) {
+    adj[(*label)[a]].push_back((*label)[b]);
+    adj[(*label)[b]].push_back((*label)[a]);
+  };
+  for (uint32_t r = 0; r < side; ++r) {
+    for (uint32_t c = 0; c < side; ++c) {
+      if (c + 1 < side) {
+        connect(r * side + c, r * side + c + 1);
+      }
+      if (r + 1 < side) {
+        connect(r * side + c, (r + 1) * side + c);
+      }
+    }
+  }
+  return MakeCsrTopology(adj);
+}
+
+void
+CheckPermutation(
+    const katana::GraphTopologyTypes::PropIndexVec& order, size_t num_nodes) {
+  KATANA_LOG_ASSERT(order.size() == num_nodes);
+  std::vector<bool> seen(num_nodes);
+  for (size_t i = 0; i < order.size(); ++i) {
+    KATANA_LOG_ASSERT(order[i] < num_nodes);
+    KATANA_LOG_ASSERT(!seen[order[i]]);
+    seen[order[i]] = true;
+  }
+}
+
+/// max |new(src) - new(dst)| over all edges
+uint64_t
+Bandwidth(
+    const katana::GraphTopology& topo,
+    const katana::GraphTopologyTypes::PropIndexVec& order) {
+  std::vector<uint64_t> new_id(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    new_id[order[i]] = i;
+  }
+  uint64_t bandwidth = 0;
+  for (Node n : topo.all_nodes()) {
+    for (Edge e : topo.edges(n)) {
+      uint64_t a = new_id[n];
+      uint64_t b = new_id[topo.edge_dest(e)];
+      bandwidth = std::max(bandwidth, a > b ? a - b : b - a);
+    }
+  }
+  return bandwidth;
+}
+
+void
+TestOrderings() {
+  constexpr uint32_t kSide = 40;
+  std::vector<Node> label;
+  katana::GraphTopology topo = MakeShuffledGrid(kSide, &label);
+
+  katana::GraphTopologyTypes::PropIndexVec identity;
+  identity.allocateInterleaved(topo.num_nodes());
+  std::iota(identity.begin(), identity.end(), 0);
+  uint64_t initial = Bandwidth(topo, identity);
+
+  auto rcm = katana::ReverseCuthillMcKeeOrder(topo);
+  CheckPermutation(rcm, topo.num_nodes());
+  uint64_t rcm_bandwidth = Bandwidth(topo, rcm);
+  // a BFS order of a grid has bandwidth about the length of a diagonal
+  KATANA_LOG_VASSERT(
+      rcm_bandwidth <= 2 * kSide && rcm_bandwidth < initial,
+      "rcm bandwidth {} initial {}", rcm_bandwidth, initial);
+
+  auto bfs = katana::BreadthFirstOrder(topo);
+  CheckPermutation(bfs, topo.num_nodes());
+  uint64_t bfs_bandwidth = Bandwidth(topo, bfs);
+  KATANA_LOG_VASSERT(
+      bfs_bandwidth <= 2 * kSide, "bfs bandwidth {}", bfs_bandwidth);
+  KATANA_LOG_ASSERT(bfs[0] == 0);
+
+  auto degree = katana::DegreeOrder(topo);
+  CheckPermutation(degree, topo.num_nodes());
+  for (size_t i = 1; i < degree.size(); ++i) {
+    KATANA_LOG_ASSERT(topo.degree(degree[i - 1]) >= topo.degree(degree[i]));
+  }
+
+  auto gorder = katana::GorderOrder(topo);
+  CheckPermutation(gorder, topo.num_nodes());
+
+  auto rabbit = katana::RabbitOrder(topo);
+  CheckPermutation(rabbit, topo.num_nodes());
+
+  // orders are well defined for graphs with isolated nodes and no edges
+  katana::GraphTopology empty =
+      MakeCsrTopology(std::vector<std::vector<Node>>(7));
+  CheckPermutation(katana::ReverseCuthillMcKeeOrder(empty), 7);
+  CheckPermutation(katana::BreadthFirstOrder(empty), 7);
+  CheckPermutation(katana::DegreeOrder(empty), 7);
+  CheckPermutation(katana::GorderOrder(empty), 7);
+  CheckPermutation(katana::RabbitOrder(empty), 7);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestOrderings();
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <cstdint>
+#include <cstring>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/MemoryBudget.h"
+#include "katana/NUMAMemoryPool.h"
+#include "katana/PropertyMemoryPool.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr int64_t kMiB = 1 << 20;
+
+void
+TestAllocate() {
+  katana::NUMAMemoryPool pool(4 * kMiB);
+
+  uint8_t* small = nullptr;
+  KATANA_LOG_ASSERT(pool.Allocate(kMiB, &small).ok());
+  KATANA_LOG_ASSERT(pool.bytes_allocated() == kMiB);
+  KATANA_LOG_ASSERT(pool.page_bytes_allocated() == 0);
+
+  katana::MemoryBudget budget("pool", 1024 * kMiB);
+  uint8_t* large = nullptr;
+  KATANA_LOG_ASSERT(pool.Allocate(8 * kMiB, &large).ok());
+  KATANA_LOG_ASSERT(reinterpret_cast<uintptr_t>(large) % 64 == 0);
+  KATANA_LOG_ASSERT(pool.page_bytes_allocated() == 8 * kMiB);
+  KATANA_LOG_ASSERT(budget.used_bytes() >= 8 * kMiB);
+  std::memset(large, 1, 8 * kMiB);
+
+  // Grows a buffer from the fallback pool into pages, keeping its contents
+  std::memset(small, 2, kMiB);
+  KATANA_LOG_ASSERT(pool.Reallocate(kMiB, 16 * kMiB, &small).ok());
+  KATANA_LOG_ASSERT(small[kMiB - 1] == 2);
+  KATANA_LOG_ASSERT(pool.page_bytes_allocated() == 24 * kMiB);
+  KATANA_LOG_ASSERT(pool.bytes_allocated() == 24 * kMiB);
+  KATANA_LOG_ASSERT(pool.max_memory() == 24 * kMiB);
+
+  pool.Free(small, 16 * kMiB);
+  pool.Free(large, 8 * kMiB);
+  KATANA_LOG_ASSERT(pool.bytes_allocated() == 0);
+  KATANA_LOG_ASSERT(pool.page_bytes_allocated() == 0);
+  KATANA_LOG_ASSERT(budget.used_bytes() == 0);
+}
+
+/// Buffers too large to map fail with OutOfMemory rather than aborting
+void
+TestOutOfMemory() {
+  katana::NUMAMemoryPool pool(4 * kMiB);
+
+  uint8_t* buffer = nullptr;
+  // larger than the user address space
+  KATANA_LOG_ASSERT(pool.Allocate(INT64_C(1) << 50, &buffer).IsOutOfMemory());
+  // more pages than allocPages can count
+  KATANA_LOG_ASSERT(pool.Allocate(INT64_C(1) << 62, &buffer).IsOutOfMemory());
+  KATANA_LOG_ASSERT(pool.bytes_allocated() == 0);
+  KATANA_LOG_ASSERT(pool.page_bytes_allocated() == 0);
+
+  KATANA_LOG_ASSERT(pool.Allocate(8 * kMiB, &buffer).ok());
+  KATANA_LOG_ASSERT(
+      pool.Reallocate(8 * kMiB, INT64_C(1) << 50, &buffer).IsOutOfMemory());
+  // the buffer is kept
+  std::memset(buffer, 1, 8 * kMiB);
+  KATANA_LOG_ASSERT(pool.bytes_allocated() == 8 * kMiB);
+  pool.Free(buffer, 8 * kMiB);
+}
+
+void
+TestPropertyPool() {
+  auto* pool = katana::PropertyMemoryPool();
+  KATANA_LOG_ASSERT(pool == katana::NUMAMemoryPool::Get());
+
+  int64_t before = pool->bytes_allocated();
+  arrow::Int64Builder builder(pool);
+  KATANA_LOG_ASSERT(builder.Resize(4 * kMiB).ok());
+  for (int64_t i = 0; i < 4 * kMiB; ++i) {
+    builder.UnsafeAppend(i);
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  KATANA_LOG_ASSERT(pool->bytes_allocated() >= before + 32 * kMiB);
+  KATANA_LOG_ASSERT(
+      std::static_pointer_cast<arrow::Int64Array>(array)->Value(kMiB) == kMiB);
+  array.reset();
+  KATANA_LOG_ASSERT(pool->bytes_allocated() == before);
+}
+
+}  // namespace
+
+int
+main() {
+  {
+    katana::SharedMemSys sys;
+
+    TestAllocate();
+    TestOutOfMemory();
+    TestPropertyPool();
+  }
+  KATANA_LOG_ASSERT(
+      katana::PropertyMemoryPool() == arrow::default_memory_pool());
+
+  return 0;
+}
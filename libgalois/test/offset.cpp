@@ -65,6 +65,29 @@ TestPOD() {
   TestSliced<ViewType>(vec, array, 1, vec.size() - 6);
 }
 
+template <typename T>
+void
+TestNoNullsPOD() {
+  using VecType = std::vector<std::optional<T>>;
+  using ViewType = typename katana::NoNullsPODProperty<T>::ViewType;
+  using ArrayType = katana::PropertyArrowArrayType<katana::PODProperty<T>>;
+  VecType vec{1, 2, std::nullopt, 3, 4, 5, 6};
+  auto array = MakeArray(vec);
+  KATANA_LOG_ASSERT(!ViewType::Make(*array));
+
+  // A slice without nulls of an array with nulls
+  auto slice = std::static_pointer_cast<ArrayType>(array->Slice(3, 4));
+  auto res = ViewType::Make(*slice);
+  KATANA_LOG_ASSERT(res);
+  auto view = std::move(res.value());
+  for (size_t i = 0; i < 4; ++i) {
+    KATANA_LOG_ASSERT(view.IsValid(i));
+    KATANA_LOG_ASSERT(view[i] == *vec[i + 3]);
+  }
+  view[0] = 10;
+  KATANA_LOG_ASSERT(array->Value(3) == 10);
+}
+
 void
 TestString() {
   using VecType = std::vector<std::optional<std::string>>;
@@ -101,6 +124,9 @@ main() {
   TestPOD<uint64_t>();
   TestPOD<float>();
   TestPOD<double>();
+  TestNoNullsPOD<int32_t>();
+  TestNoNullsPOD<uint64_t>();
+  TestNoNullsPOD<double>();
   TestString();
   TestBool();
   KATANA_LOG_VERBOSE("success");
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/file.h"
+
+namespace {
+
+/// An in-memory backend that counts the calls that FileStorage::GetParallel
+/// and FileStorage::PutParallel make and can optionally do multipart uploads
+class MemStorage : public tsuba::FileStorage {
+public:
+  explicit MemStorage(bool multipart)
+      : tsuba::FileStorage("mem://"), multipart_(multipart) {}
+
+  katana::Result<void> Init() override { return katana::ResultSuccess(); }
+  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+
+  std::vector<uint8_t> Contents(const std::string& uri) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(uri);
+    KATANA_LOG_ASSERT(it != files_.end());
+    return it->second;
+  }
+
+  bool Exists(const std::string& uri) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return files_.count(uri) > 0;
+  }
+
+  /// Make the upload of part \param part_num fail
+  void FailPart(uint64_t part_num) { fail_part_ = part_num; }
+
+  uint64_t num_gets() const { return num_gets_; }
+  uint32_t max_gets_in_flight() const { return max_gets_in_flight_; }
+  uint64_t num_puts() const { return num_puts_; }
+  uint64_t num_parts() const { return num_parts_; }
+  uint64_t num_aborts() const { return num_aborts_; }
+
+  katana::Result<void> Stat(
+      const std::string& uri, tsuba::StatBuf* s_buf) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(uri);
+    if (it == files_.end()) {
+      return tsuba::ErrorCode::NotFound;
+    }
+    s_buf->size = it->second.size();
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    ++num_gets_;
+    uint32_t in_flight = ++gets_in_flight_;
+    uint32_t max = max_gets_in_flight_;
+    while (in_flight > max &&
+           !max_gets_in_flight_.compare_exchange_weak(max, in_flight)) {
+    }
+    // give the other parts a chance to overlap with this one
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    --gets_in_flight_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(uri);
+    if (it == files_.end()) {
+      return tsuba::ErrorCode::NotFound;
+    }
+    if (start + size > it->second.size()) {
+      return tsuba::ErrorCode::InvalidArgument;
+    }
+    std::memcpy(result_buf, it->second.data() + start, size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    ++num_puts_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    files_[uri] = std::vector<uint8_t>(data, data + size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> RemoteCopy(
+      const std::string&, const std::string&, uint64_t, uint64_t) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+  katana::Result<std::string> BeginMultipartPut(
+      const std::string& uri) override {
+    if (!multipart_) {
+      return tsuba::FileStorage::BeginMultipartPut(uri);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string upload_id = std::to_string(next_upload_id_++);
+    uploads_[upload_id];
+    return upload_id;
+  }
+
+  std::future<katana::CopyableResult<void>> PutPartAsync(
+      const std::string&, const std::string& upload_id, uint64_t part_num,
+      const uint8_t* data, uint64_t size) override {
+    return std::async(
+        std::launch::async, [=]() -> katana::CopyableResult<void> {
+          ++num_parts_;
+          if (part_num == fail_part_) {
+            return KATANA_ERROR(
+                tsuba::ErrorCode::S3Error, "part {} failed", part_num);
+          }
+          std::lock_guard<std::mutex> lock(mutex_);
+          auto it = uploads_.find(upload_id);
+          if (it == uploads_.end()) {
+            return KATANA_ERROR(
+                tsuba::ErrorCode::InvalidArgument, "no upload {}", upload_id);
+          }
+          it->second[part_num] = std::vector<uint8_t>(data, data + size);
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  katana::Result<void> CompleteMultipartPut(
+      const std::string& uri, const std::string& upload_id,
+      uint64_t num_parts) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = uploads_.find(upload_id);
+    if (it == uploads_.end() || it->second.size() != num_parts) {
+      return tsuba::ErrorCode::InvalidArgument;
+    }
+    std::vector<uint8_t> contents;
+    for (const auto& [part_num, part] : it->second) {
+      contents.insert(contents.end(), part.begin(), part.end());
+    }
+    files_[uri] = std::move(contents);
+    uploads_.erase(it);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> AbortMultipartPut(
+      const std::string&, const std::string& upload_id) override {
+    ++num_aborts_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    uploads_.erase(upload_id);
+    return katana::ResultSuccess();
+  }
+
+  std::future<katana::CopyableResult<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    return std::async(
+        std::launch::deferred, [=]() -> katana::CopyableResult<void> {
+          if (auto res = PutMultiSync(uri, data, size); !res) {
+            return res.error();
+          }
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return std::async(
+        std::launch::async, [=]() -> katana::CopyableResult<void> {
+          if (auto res = GetMultiSync(uri, start, size, result_buf); !res) {
+            return res.error();
+          }
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  std::future<katana::CopyableResult<void>> ListAsync(
+      const std::string&, std::vector<std::string>*,
+      std::vector<uint64_t>*) override {
+    return std::async(
+        std::launch::deferred, []() -> katana::CopyableResult<void> {
+          return KATANA_ERROR(
+              tsuba::ErrorCode::NotImplemented, "listing is not supported");
+        });
+  }
+
+  katana::Result<void> Delete(
+      const std::string&, const std::unordered_set<std::string>&) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+private:
+  bool multipart_;
+  std::mutex mutex_;
+  std::map<std::string, std::vector<uint8_t>> files_;
+  std::map<std::string, std::map<uint64_t, std::vector<uint8_t>>> uploads_;
+  uint64_t next_upload_id_{0};
+  std::atomic<uint64_t> fail_part_{UINT64_MAX};
+  std::atomic<uint64_t> num_gets_{0};
+  std::atomic<uint32_t> gets_in_flight_{0};
+  std::atomic<uint32_t> max_gets_in_flight_{0};
+  std::atomic<uint64_t> num_puts_{0};
+  std::atomic<uint64_t> num_parts_{0};
+  std::atomic<uint64_t> num_aborts_{0};
+};
+
+std::vector<uint8_t>
+Data(uint64_t size) {
+  std::vector<uint8_t> data(size);
+  for (uint64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + i / 256);
+  }
+  return data;
+}
+
+tsuba::TransferOpts
+Opts(uint64_t part_size, uint32_t max_parallel_parts) {
+  tsuba::TransferOpts opts;
+  opts.part_size = part_size;
+  opts.max_parallel_parts = max_parallel_parts;
+  return opts;
+}
+
+/// Large reads are split into ranged gets with a bounded number in flight
+void
+TestGetParallel() {
+  MemStorage storage(false);
+  std::string uri = "mem://get";
+  std::vector<uint8_t> data = Data(10000);
+  KATANA_LOG_ASSERT(storage.PutMultiSync(uri, data.data(), data.size()));
+
+  std::vector<uint8_t> buf(8000);
+  auto res =
+      storage.GetParallel(uri, 500, buf.size(), buf.data(), Opts(1000, 3));
+  KATANA_LOG_VASSERT(res, "reading {}: {}", uri, res.error());
+  KATANA_LOG_ASSERT(std::equal(buf.begin(), buf.end(), data.begin() + 500));
+  KATANA_LOG_ASSERT(storage.num_gets() == 8);
+  KATANA_LOG_ASSERT(storage.max_gets_in_flight() <= 3);
+
+  // the last part is short
+  buf.assign(2500, 0);
+  KATANA_LOG_ASSERT(
+      storage.GetParallel(uri, 7500, buf.size(), buf.data(), Opts(1000, 3)));
+  KATANA_LOG_ASSERT(std::equal(buf.begin(), buf.end(), data.begin() + 7500));
+  KATANA_LOG_ASSERT(storage.num_gets() == 11);
+
+  // small reads and a parallelism of 1 are not split
+  KATANA_LOG_ASSERT(
+      storage.GetParallel(uri, 0, 1000, buf.data(), Opts(1000, 3)));
+  KATANA_LOG_ASSERT(
+      storage.GetParallel(uri, 0, 2500, buf.data(), Opts(1000, 1)));
+  KATANA_LOG_ASSERT(storage.num_gets() == 13);
+
+  // an error in one part fails the read
+  KATANA_LOG_ASSERT(
+      !storage.GetParallel(uri, 5000, 6000, buf.data(), Opts(1000, 3)));
+}
+
+/// Backends without multipart uploads get the whole object in one put
+void
+TestPutFallback() {
+  MemStorage storage(false);
+  std::string uri = "mem://fallback";
+  std::vector<uint8_t> data = Data(10000);
+
+  auto res = storage.PutParallel(uri, data.data(), data.size(), Opts(1000, 4));
+  KATANA_LOG_VASSERT(res, "writing {}: {}", uri, res.error());
+  KATANA_LOG_ASSERT(storage.Contents(uri) == data);
+  KATANA_LOG_ASSERT(storage.num_puts() == 1);
+  KATANA_LOG_ASSERT(storage.num_parts() == 0);
+}
+
+void
+TestPutMultipart() {
+  MemStorage storage(true);
+  std::string uri = "mem://multipart";
+  std::vector<uint8_t> data = Data(10500);
+
+  auto res = storage.PutParallel(uri, data.data(), data.size(), Opts(1000, 4));
+  KATANA_LOG_VASSERT(res, "writing {}: {}", uri, res.error());
+  KATANA_LOG_ASSERT(storage.Contents(uri) == data);
+  KATANA_LOG_ASSERT(storage.num_puts() == 0);
+  KATANA_LOG_ASSERT(storage.num_parts() == 11);
+
+  // small writes are not split
+  KATANA_LOG_ASSERT(
+      storage.PutParallel(uri, data.data(), 1000, Opts(1000, 4)));
+  KATANA_LOG_ASSERT(storage.num_puts() == 1);
+  KATANA_LOG_ASSERT(storage.num_parts() == 11);
+
+  // parts grow so that there are at most kMaxParts
+  uint64_t size = 2 * tsuba::TransferOpts::kMaxParts + 1;
+  std::vector<uint8_t> many = Data(size);
+  KATANA_LOG_ASSERT(storage.PutParallel(uri, many.data(), size, Opts(1, 16)));
+  KATANA_LOG_ASSERT(storage.Contents(uri) == many);
+  KATANA_LOG_ASSERT(
+      storage.num_parts() - 11 <= tsuba::TransferOpts::kMaxParts);
+}
+
+/// A failed part aborts the upload and leaves no object behind
+void
+TestPutAbort() {
+  MemStorage storage(true);
+  std::string uri = "mem://abort";
+  std::vector<uint8_t> data = Data(10000);
+
+  storage.FailPart(2);
+  KATANA_LOG_ASSERT(
+      !storage.PutParallel(uri, data.data(), data.size(), Opts(1000, 2)));
+  KATANA_LOG_ASSERT(storage.num_aborts() == 1);
+  KATANA_LOG_ASSERT(!storage.Exists(uri));
+  // no parts are started after the error is seen
+  KATANA_LOG_ASSERT(storage.num_parts() < 10);
+}
+
+}  // namespace
+
+int
+main() {
+  TestGetParallel();
+  TestPutFallback();
+  TestPutMultipart();
+  TestPutAbort();
+
+  return 0;
+}
@@ -0,0 +1,190 @@
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/TopologyStatistics.h"
+#include "katana/analytics/Planner.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// An undirected random graph of num_nodes nodes and about 2 * num_edges
+/// edges, with a chain that keeps it connected
+std::vector<std::set<Node>>
+MakeRandomNeighbors(uint32_t num_nodes, size_t num_edges) {
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<Node> dist(0, num_nodes - 1);
+  std::vector<std::set<Node>> neighbors(num_nodes);
+  for (size_t i = 0; i < num_edges; ++i) {
+    Node a = dist(gen);
+    Node b = dist(gen);
+    if (a != b) {
+      neighbors[a].insert(b);
+      neighbors[b].insert(a);
+    }
+  }
+  for (Node n = 1; n < num_nodes; ++n) {
+    neighbors[n - 1].insert(n);
+    neighbors[n].insert(n - 1);
+  }
+  return neighbors;
+}
+
+void
+TestPathStatistics() {
+  constexpr uint32_t kNumNodes = 20000;
+  std::vector<std::set<Node>> neighbors(kNumNodes);
+  for (Node n = 0; n + 1 < kNumNodes; ++n) {
+    neighbors[n].insert(n + 1);
+  }
+  auto stats = katana::TopologyStatistics::Compute(MakeCsrTopology(neighbors));
+  KATANA_LOG_ASSERT(stats.num_nodes == kNumNodes);
+  KATANA_LOG_ASSERT(stats.num_edges == kNumNodes - 1);
+  KATANA_LOG_ASSERT(stats.max_degree == 1);
+  KATANA_LOG_ASSERT(stats.estimated_diameter == kNumNodes - 1);
+  KATANA_LOG_ASSERT(!stats.is_power_law());
+
+  // A round per level is far more than the edges of a path
+  katana::analytics::PlanCostModel model;
+  model.num_threads = 1;
+  KATANA_LOG_ASSERT(
+      katana::analytics::ChooseBfsPlan(stats, model).algorithm() ==
+      katana::analytics::BfsPlan::kAsynchronous);
+}
+
+void
+TestStarStatistics() {
+  constexpr uint32_t kNumNodes = 1000;
+  std::vector<std::set<Node>> neighbors(kNumNodes);
+  for (Node n = 1; n < kNumNodes; ++n) {
+    neighbors[0].insert(n);
+    neighbors[n].insert(0);
+  }
+  auto stats = katana::TopologyStatistics::Compute(MakeCsrTopology(neighbors));
+  KATANA_LOG_ASSERT(stats.max_degree == kNumNodes - 1);
+  KATANA_LOG_ASSERT(stats.estimated_diameter == 2);
+  KATANA_LOG_ASSERT(stats.sampled_median_degree == 1);
+}
+
+void
+TestDenseStatistics() {
+  auto stats = katana::TopologyStatistics::Compute(
+      MakeCsrTopology(MakeRandomNeighbors(2000, 40000)));
+  KATANA_LOG_ASSERT(stats.estimated_diameter < 10);
+  KATANA_LOG_ASSERT(!stats.is_power_law());
+
+  // The rework of an asynchronous traversal costs more than a few rounds
+  katana::analytics::PlanCostModel model;
+  model.num_threads = 1;
+  KATANA_LOG_ASSERT(
+      katana::analytics::ChooseBfsPlan(stats, model).algorithm() ==
+      katana::analytics::BfsPlan::kSynchronousDirectOpt);
+  KATANA_LOG_ASSERT(
+      katana::analytics::ChooseConnectedComponentsPlan(stats, model)
+          .algorithm() ==
+      katana::analytics::ConnectedComponentsPlan::kAfforest);
+}
+
+void
+TestSmallGraphPlans() {
+  katana::TopologyStatistics stats;
+  stats.num_nodes = 10;
+  stats.num_edges = 20;
+  stats.estimated_diameter = 5;
+  KATANA_LOG_ASSERT(
+      katana::analytics::ChooseSsspPlan(stats, {1, 10, 5}).algorithm() ==
+      katana::analytics::SsspPlan::kDijkstra);
+  KATANA_LOG_ASSERT(
+      katana::analytics::ChooseConnectedComponentsPlan(stats).algorithm() ==
+      katana::analytics::ConnectedComponentsPlan::kSerial);
+}
+
+void
+TestDeltaShift() {
+  using katana::analytics::ChooseDeltaShift;
+  KATANA_LOG_ASSERT(ChooseDeltaShift({0, 0, 0}, 10) == 0);
+  KATANA_LOG_ASSERT(ChooseDeltaShift({1, 1, 1}, 10) == 0);
+  // max / average degree = 10 rounds down to 2^3
+  KATANA_LOG_ASSERT(ChooseDeltaShift({1, 100, 5}, 10) == 3);
+  // the mean weight bounds delta from below
+  KATANA_LOG_ASSERT(ChooseDeltaShift({1, 100, 40}, 10) == 5);
+  KATANA_LOG_ASSERT(ChooseDeltaShift({1, 1e12, 1}, 1) == 31);
+}
+
+void
+TestAutomaticAnalytics() {
+  auto neighbors = MakeRandomNeighbors(500, 3000);
+  auto pg = MakeCsrGraph(neighbors);
+
+  size_t num_edges = pg->topology().num_edges();
+  std::vector<uint32_t> weights(num_edges);
+  for (size_t e = 0; e < num_edges; ++e) {
+    weights[e] = 1 + (e * 7919) % 100;
+  }
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)})));
+
+  // The statistics are kept with the graph
+  const auto& stats = pg->GetTopologyStatistics();
+  KATANA_LOG_ASSERT(&stats == &pg->GetTopologyStatistics());
+  KATANA_LOG_ASSERT(stats.num_edges == num_edges);
+
+  constexpr uint32_t kSource = 3;
+  KATANA_LOG_ASSERT(katana::analytics::Bfs(pg.get(), kSource, "parent"));
+  KATANA_LOG_ASSERT(
+      katana::analytics::BfsAssertValid(pg.get(), kSource, "parent"));
+  KATANA_LOG_ASSERT(
+      katana::analytics::Sssp(pg.get(), kSource, "weight", "distance"));
+  KATANA_LOG_ASSERT(katana::analytics::SsspAssertValid(
+      pg.get(), kSource, "weight", "distance"));
+  KATANA_LOG_ASSERT(
+      katana::analytics::ConnectedComponents(pg.get(), "component"));
+  KATANA_LOG_ASSERT(
+      katana::analytics::ConnectedComponentsAssertValid(pg.get(), "component"));
+
+  using katana::analytics::TriangleCountPlan;
+  auto count = [&](TriangleCountPlan::Relabeling relabeling) {
+    auto res = katana::analytics::TriangleCount(
+        pg.get(), TriangleCountPlan::OrderedCount(false, relabeling));
+    KATANA_LOG_ASSERT(res);
+    return res.value();
+  };
+  uint64_t expected = count(TriangleCountPlan::kNoRelabel);
+  KATANA_LOG_ASSERT(count(TriangleCountPlan::kRelabel) == expected);
+  KATANA_LOG_ASSERT(count(TriangleCountPlan::kAutoRelabel) == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestPathStatistics();
+  TestStarStatistics();
+  TestDenseStatistics();
+  TestSmallGraphPlans();
+  TestDeltaShift();
+  TestAutomaticAnalytics();
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include <cstdint>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Prefetch.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// Node n has an edge to each of 0, ..., n - 1
+katana::GraphTopology
+MakeTriangle(Node num_nodes) {
+  std::vector<std::vector<Node>> adj(num_nodes);
+  for (Node n = 0; n < num_nodes; ++n) {
+    for (Node dst = 0; dst < n; ++dst) {
+      adj[n].push_back(dst);
+    }
+  }
+  return MakeCsrTopology(adj);
+}
+
+/// Every edge is visited in order and the destination of every edge is
+/// prefetched once, before its edge is visited
+void
+TestVisits(const katana::GraphTopology& topo, size_t distance) {
+  std::vector<float> values(topo.num_nodes());
+  for (Node n = 0; n < topo.num_nodes(); ++n) {
+    std::vector<Node> visited;
+    std::vector<Node> prefetched;
+    Edge next = *topo.edges(n).begin();
+    topo.ForEachEdgePrefetched(
+        n,
+        [&](Edge e, Node dst) {
+          KATANA_LOG_ASSERT(e == next++);
+          KATANA_LOG_ASSERT(dst == topo.edge_dest(e));
+          KATANA_LOG_ASSERT(prefetched.size() > visited.size());
+          visited.push_back(dst);
+        },
+        [&](Node dst) {
+          katana::PrefetchForRead(&values[dst]);
+          prefetched.push_back(dst);
+        },
+        distance);
+    KATANA_LOG_ASSERT(next == *topo.edges(n).end());
+    KATANA_LOG_ASSERT(visited == prefetched);
+  }
+}
+
+/// A visit that returns false ends the loop
+void
+TestStop(const katana::GraphTopology& topo) {
+  Node last = topo.num_nodes() - 1;
+  std::vector<Node> visited;
+  topo.ForEachEdgePrefetched(
+      last,
+      [&](Edge, Node dst) {
+        visited.push_back(dst);
+        return dst < 3;
+      },
+      [](Node) {});
+  KATANA_LOG_ASSERT(visited == std::vector<Node>({0, 1, 2, 3}));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  katana::GraphTopology topo = MakeTriangle(50);
+  TestVisits(topo, katana::kDefaultPrefetchDistance);
+  TestVisits(topo, 1);
+  TestVisits(topo, 0);
+  TestStop(topo);
+
+  return 0;
+}
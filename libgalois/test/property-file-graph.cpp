@@ -1,11 +1,32 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
 #include <arrow/api.h>
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/Metapath.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
 #include "katana/URI.h"
+#include "tsuba/CSRTopology.h"
+#include "tsuba/Errors.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/RDGPrefix.h"
+#include "tsuba/WriteGroup.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
 
 namespace {
 
@@ -227,6 +248,1793 @@ TestTopologyAccess() {
   }
   KATANA_LOG_ASSERT(n_nodes == 10);
 }
+
+void
+TestCompressedTopologyRoundTrip() {
+  // enough nodes to span several compressed blocks
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(200, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  katana::SetEnv("KATANA_COMPRESS_TOPOLOGY", "true", true);
+  auto write_result = g->Write(rdg_dir, command_line);
+  katana::UnsetEnv("KATANA_COMPRESS_TOPOLOGY");
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g2->num_nodes() == 200);
+  KATANA_LOG_ASSERT(g2->num_edges() == 600);
+  KATANA_LOG_ASSERT(g->topology().Equals(g2->topology()));
+}
+
+/// Write g with a version 3 topology to a new directory
+std::string
+WriteCompressed(katana::PropertyGraph* g) {
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  katana::SetEnv("KATANA_COMPRESS_TOPOLOGY", "true", true);
+  auto write_result = g->Write(rdg_dir, command_line);
+  katana::UnsetEnv("KATANA_COMPRESS_TOPOLOGY");
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+  return rdg_dir;
+}
+
+/// Overwrite the encoded edges of the version 3 topology in rdg_dir with
+/// byte
+void
+CorruptCompressedEdges(const std::string& rdg_dir, char byte) {
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().find("topology") != 0) {
+      continue;
+    }
+    std::fstream file(
+        entry.path().string(),
+        std::ios::in | std::ios::out | std::ios::binary);
+    tsuba::CSRTopologyHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    KATANA_LOG_ASSERT(header.version == tsuba::kCSRTopologyCompressedVersion);
+    uint64_t begin = tsuba::CSRCompressedEdgesOffset(header);
+    uint64_t end = fs::file_size(entry.path());
+    file.seekp(begin);
+    std::string bytes(end - begin, byte);
+    file.write(bytes.data(), bytes.size());
+    return;
+  }
+  KATANA_LOG_FATAL("no topology in {}", rdg_dir);
+}
+
+/// Corrupt compressed edges fail the load rather than producing
+/// destinations outside of the graph or reading past their block
+void
+TestCompressedTopologyCorrupt() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(200, 0, &policy);
+
+  // 0xff never ends a varint; 0x7e adds 63 to every destination
+  for (char byte : {'\xff', '\x7e'}) {
+    std::string rdg_dir = WriteCompressed(g.get());
+    CorruptCompressedEdges(rdg_dir, byte);
+    auto make_result =
+        katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_VASSERT(!make_result, "byte {:#x}", byte & 0xff);
+  }
+}
+
+/// Slices read the destinations of a version 1 file in place, so they
+/// refuse compressed topologies
+void
+TestCompressedTopologySlice() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(200, 0, &policy);
+  std::string rdg_dir = WriteCompressed(g.get());
+
+  auto handle_res = tsuba::Open(rdg_dir, tsuba::kReadOnly);
+  KATANA_LOG_ASSERT(handle_res);
+  tsuba::RDGSlice::SliceArg slice{
+      .node_range = {0, 10},
+      .edge_range = {0, 30},
+      .topo_off = sizeof(tsuba::CSRTopologyHeader) + 200 * sizeof(uint64_t),
+      .topo_size = 30 * sizeof(uint32_t),
+  };
+  auto slice_res = tsuba::RDGSlice::Make(handle_res.value(), slice);
+  KATANA_LOG_ASSERT(tsuba::Close(handle_res.value()));
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(!slice_res);
+  KATANA_LOG_ASSERT(slice_res.error() == tsuba::ErrorCode::NotImplemented);
+}
+
+void
+TestOutOfCoreTopology() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(200, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  tsuba::RDGLoadOptions opts;
+  opts.out_of_core_topology = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+
+  // local files are mapped in place
+  const katana::GraphTopology& topo = make_result.value()->topology();
+  KATANA_LOG_ASSERT(topo.is_out_of_core());
+  topo.AdviseAccess(katana::GraphTopology::AccessPattern::kSequential);
+  topo.PrefetchEdges(0, topo.num_nodes());
+  KATANA_LOG_ASSERT(g->topology().Equals(topo));
+
+  katana::GraphTopology copy = katana::GraphTopology::Copy(topo);
+  KATANA_LOG_ASSERT(!copy.is_out_of_core());
+  KATANA_LOG_ASSERT(copy.Equals(topo));
+}
+
+void
+TestSortOutOfCoreTopology() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(200, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  tsuba::RDGLoadOptions opts;
+  opts.out_of_core_topology = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> sorted =
+      std::move(make_result.value());
+  KATANA_LOG_ASSERT(sorted->topology().is_out_of_core());
+
+  // the mapping is read-only, so sorting in place would fault
+  auto perm_result = katana::SortAllEdgesByDest(sorted.get());
+  KATANA_LOG_VASSERT(perm_result, "sorting: {}", perm_result.error());
+  const katana::GraphTopology& topo = sorted->topology();
+  KATANA_LOG_ASSERT(!topo.is_out_of_core());
+  KATANA_LOG_ASSERT(topo.num_nodes() == g->topology().num_nodes());
+  KATANA_LOG_ASSERT(topo.num_edges() == g->topology().num_edges());
+  for (auto n : topo.all_nodes()) {
+    auto edges = topo.edges(n);
+    KATANA_LOG_ASSERT(std::is_sorted(
+        edges.begin(), edges.end(), [&](auto a, auto b) {
+          return topo.edge_dest(a) < topo.edge_dest(b);
+        }));
+  }
+
+  auto reloaded = katana::PropertyGraph::Make(rdg_dir, opts);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(reloaded);
+  KATANA_LOG_ASSERT(reloaded.value()->topology().is_out_of_core());
+  auto degree_result = katana::SortNodesByDegree(reloaded.value().get());
+  KATANA_LOG_VASSERT(degree_result, "sorting: {}", degree_result.error());
+  KATANA_LOG_ASSERT(!reloaded.value()->topology().is_out_of_core());
+  KATANA_LOG_ASSERT(
+      reloaded.value()->topology().num_edges() == g->topology().num_edges());
+}
+
+void
+TestNUMAPartitionedTopology() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(500, 0, &policy);
+  KATANA_LOG_ASSERT(!g->topology().is_numa_partitioned());
+
+  auto check = [&](katana::GraphTopology* topo) {
+    topo->PartitionForNUMA();
+    KATANA_LOG_ASSERT(topo->is_numa_partitioned());
+    KATANA_LOG_ASSERT(topo->Equals(g->topology()));
+
+    const auto& ranges = topo->thread_ranges();
+    KATANA_LOG_ASSERT(ranges.size() == katana::getActiveThreads() + 1);
+    KATANA_LOG_ASSERT(std::is_sorted(ranges.begin(), ranges.end()));
+    KATANA_LOG_ASSERT(ranges.back() == topo->num_nodes());
+
+    std::vector<std::atomic<uint32_t>> visits(topo->num_nodes());
+    katana::do_all(
+        topo->local_nodes(), [&](auto n) { ++visits[n]; },
+        katana::socket_steal(), katana::no_stats());
+    for (const auto& v : visits) {
+      KATANA_LOG_ASSERT(v == 1);
+    }
+  };
+
+  katana::GraphTopology wide = katana::GraphTopology::Copy(g->topology());
+  check(&wide);
+  // compacting keeps the placement
+  wide.Compact();
+  KATANA_LOG_ASSERT(wide.is_compact() && wide.is_numa_partitioned());
+  KATANA_LOG_ASSERT(wide.Equals(g->topology()));
+
+  katana::GraphTopology compact = katana::GraphTopology::Copy(g->topology());
+  compact.Compact();
+  check(&compact);
+  KATANA_LOG_ASSERT(compact.is_compact());
+}
+
+void
+TestCompactTopology() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(200, 0, &policy);
+  KATANA_LOG_ASSERT(!g->topology().is_compact());
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  const katana::GraphTopology& topo = g2->topology();
+  KATANA_LOG_ASSERT(topo.is_compact());
+  KATANA_LOG_ASSERT(g->topology().Equals(topo));
+  KATANA_LOG_ASSERT(topo.Equals(g->topology()));
+  for (auto n : topo.all_nodes()) {
+    KATANA_LOG_ASSERT(
+        *topo.edges(n).begin() == *g->topology().edges(n).begin() &&
+        *topo.edges(n).end() == *g->topology().edges(n).end());
+  }
+
+  // compact topologies are stored with 64-bit offsets like any other
+  uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  rdg_dir = uri_res.value().path();
+  write_result = g2->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::SetEnv("KATANA_COMPACT_TOPOLOGY", "false", true);
+  make_result = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  katana::UnsetEnv("KATANA_COMPACT_TOPOLOGY");
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  KATANA_LOG_ASSERT(!make_result.value()->topology().is_compact());
+  KATANA_LOG_ASSERT(g->topology().Equals(make_result.value()->topology()));
+
+  katana::GraphTopology copy = katana::GraphTopology::Copy(topo);
+  KATANA_LOG_ASSERT(copy.is_compact());
+  KATANA_LOG_ASSERT(copy.Equals(topo));
+}
+
+void
+TestLazyLoad() {
+  constexpr size_t test_length = 10;
+  using ValueType = int32_t;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<ValueType>("node-name", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddEdgeProperties(MakeProps<ValueType>("edge-name", test_length)));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  tsuba::RDGLoadOptions opts;
+  opts.lazy_properties = true;
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(g2->GetNumNodeProperties() == 0);
+  KATANA_LOG_ASSERT(g2->GetNumEdgeProperties() == 0);
+  KATANA_LOG_ASSERT(g2->full_node_schema()->num_fields() == 1);
+
+  // The const accessors only see what is loaded
+  KATANA_LOG_ASSERT(!g2->GetNodeProperty("node-name"));
+  KATANA_LOG_ASSERT(
+      g2->LoadLazyNodeProperties({"node-name", "no-such-property"}));
+  auto node_prop = g2->GetNodeProperty("node-name");
+  KATANA_LOG_ASSERT(node_prop);
+  KATANA_LOG_ASSERT(node_prop->Equals(*g->GetNodeProperty("node-name")));
+  KATANA_LOG_ASSERT(g2->GetNumNodeProperties() == 1);
+  KATANA_LOG_ASSERT(!g2->GetNodeProperty("no-such-property"));
+
+  KATANA_LOG_ASSERT(g2->PrefetchEdgeProperties({"edge-name"}));
+  auto edge_prop = g2->GetEdgePropertyTyped<ValueType>("edge-name");
+  KATANA_LOG_ASSERT(edge_prop);
+  KATANA_LOG_ASSERT(edge_prop.value()->length() == int64_t{test_length});
+  KATANA_LOG_ASSERT(g2->GetNumEdgeProperties() == 1);
+  auto missing = g2->GetEdgePropertyTyped<ValueType>("no-such-property");
+  KATANA_LOG_ASSERT(!missing);
+  KATANA_LOG_ASSERT(missing.error() == katana::ErrorCode::PropertyNotFound);
+
+  // A property that cannot be read fails the load rather than looking absent
+  auto g3_res = katana::PropertyGraph::Make(rdg_dir, opts);
+  KATANA_LOG_ASSERT(g3_res);
+  std::unique_ptr<katana::PropertyGraph> g3 = std::move(g3_res.value());
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().find("node-name") == 0) {
+      fs::remove(entry.path());
+    }
+  }
+  KATANA_LOG_ASSERT(!g3->LoadLazyNodeProperties({"node-name"}));
+  auto unreadable = g3->GetNodePropertyTyped<ValueType>("node-name");
+  KATANA_LOG_ASSERT(!unreadable);
+  KATANA_LOG_ASSERT(unreadable.error() != katana::ErrorCode::PropertyNotFound);
+
+  fs::remove_all(rdg_dir);
+}
+
+/// Predicates prune the row groups of the property they name; a later
+/// store to another location keeps the stored data of the pruned property
+/// rather than its nulls
+void
+TestPredicateLoad() {
+  constexpr size_t test_length = 10;
+  using ValueType = int32_t;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<ValueType>("node-name", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<ValueType>("node-other", test_length)));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // No value of node-name is this large, so its only row group is skipped
+  tsuba::RDGLoadOptions opts;
+  opts.node_predicates = {tsuba::PropertyPredicate::Range(
+      "node-name", arrow::MakeScalar(ValueType{1000}), nullptr)};
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  auto pruned = g2->GetNodeProperty("node-name");
+  KATANA_LOG_ASSERT(pruned);
+  KATANA_LOG_ASSERT(pruned->length() == int64_t{test_length});
+  KATANA_LOG_ASSERT(pruned->null_count() == int64_t{test_length});
+  KATANA_LOG_ASSERT(g2->GetNodeProperty("node-other")->Equals(
+      *g->GetNodeProperty("node-other")));
+
+  auto uri_res2 = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res2);
+  std::string rdg_dir2(uri_res2.value().path());  // path() because local
+  write_result = g2->Write(rdg_dir2, command_line);
+  fs::remove_all(rdg_dir);
+  if (!write_result) {
+    fs::remove_all(rdg_dir2);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  make_result = katana::PropertyGraph::Make(rdg_dir2, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir2);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g3 = std::move(make_result.value());
+  for (const char* name : {"node-name", "node-other"}) {
+    KATANA_LOG_VASSERT(
+        g3->GetNodeProperty(name)->Equals(*g->GetNodeProperty(name)), "{}",
+        name);
+  }
+}
+
+/// \returns the names of the files in dir that start with prefix
+std::vector<std::string>
+FilesWithPrefix(const std::string& dir, const std::string& prefix) {
+  std::vector<std::string> names;
+  for (const auto& entry : fs::directory_iterator(dir)) {
+    std::string name = entry.path().filename().string();
+    if (name.find(prefix) == 0) {
+      names.emplace_back(std::move(name));
+    }
+  }
+  return names;
+}
+
+/// Flip a bit in the middle of each file in \p dir whose name starts with
+/// \p prefix
+void
+CorruptFiles(const std::string& dir, const std::string& prefix) {
+  for (const std::string& name : FilesWithPrefix(dir, prefix)) {
+    std::string path = dir + "/" + name;
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    auto middle = static_cast<std::streamoff>(fs::file_size(path) / 2);
+    file.seekg(middle);
+    char c = static_cast<char>(file.get() ^ 1);
+    file.seekp(middle);
+    file.put(c);
+  }
+}
+
+std::shared_ptr<arrow::Table>
+ReadParquet(const katana::Uri& uri) {
+  auto reader_res = tsuba::ParquetReader::Make();
+  KATANA_LOG_ASSERT(reader_res);
+  auto table_res = reader_res.value()->ReadTable(uri);
+  if (!table_res) {
+    KATANA_LOG_FATAL("reading {}: {}", uri, table_res.error());
+  }
+  return std::move(table_res.value());
+}
+
+/// A table larger than mbs_per_block is one file unless streaming is
+/// requested. The parts of a streamed table are stored through the write
+/// group, which checksums them along with their index.
+void
+TestParquetStreamWriter() {
+  constexpr size_t kRows = size_t{1} << 18;  // 2 MB of int64 values
+  auto table = MakeProps<int64_t>("value", kRows);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  katana::Uri dir = uri_res.value();
+  fs::create_directories(dir.path());
+
+  tsuba::ParquetWriter::WriteOpts opts;
+  opts.mbs_per_block = 1;
+  auto writer_res = tsuba::ParquetWriter::Make(table, opts);
+  KATANA_LOG_ASSERT(writer_res);
+  KATANA_LOG_ASSERT(writer_res.value()->WriteToUri(dir.Join("single")));
+  KATANA_LOG_ASSERT(FilesWithPrefix(dir.path(), "single").size() == 1);
+  KATANA_LOG_ASSERT(ReadParquet(dir.Join("single"))->Equals(*table));
+
+  katana::SetEnv("KATANA_TSUBA_CHECKSUMS", "true", true);
+  auto group_res = tsuba::WriteGroup::Make();
+  katana::UnsetEnv("KATANA_TSUBA_CHECKSUMS");
+  KATANA_LOG_ASSERT(group_res);
+  std::unique_ptr<tsuba::WriteGroup> group = std::move(group_res.value());
+
+  opts.stream = true;
+  writer_res = tsuba::ParquetWriter::Make(table, opts);
+  KATANA_LOG_ASSERT(writer_res);
+  KATANA_LOG_ASSERT(
+      writer_res.value()->WriteToUri(dir.Join("streamed"), group.get()));
+  KATANA_LOG_ASSERT(group->Finish());
+
+  KATANA_LOG_ASSERT(FilesWithPrefix(dir.path(), "streamed.part_").size() > 1);
+  auto checksums = group->checksums();
+  for (const std::string& name : FilesWithPrefix(dir.path(), "streamed")) {
+    KATANA_LOG_VASSERT(checksums.count(name) == 1, "{}", name);
+  }
+  KATANA_LOG_ASSERT(ReadParquet(dir.Join("streamed"))->Equals(*table));
+
+  // the parts are checked against those checksums when read in full
+  auto read_opts = tsuba::ParquetReader::ReadOpts::Defaults();
+  read_opts.checksums = std::make_shared<const std::map<std::string, uint32_t>>(
+      checksums.begin(), checksums.end());
+  auto reader_res = tsuba::ParquetReader::Make(read_opts);
+  KATANA_LOG_ASSERT(reader_res);
+  std::unique_ptr<tsuba::ParquetReader> reader = std::move(reader_res.value());
+  KATANA_LOG_ASSERT(reader->ReadTable(dir.Join("streamed")));
+
+  CorruptFiles(dir.path(), "streamed.part_000000000");
+  auto corrupt_res = reader->ReadTable(dir.Join("streamed"));
+  fs::remove_all(dir.path());
+  KATANA_LOG_ASSERT(
+      !corrupt_res &&
+      corrupt_res.error() == tsuba::ErrorCode::ChecksumMismatch);
+}
+
+void
+TestPlanningOpen() {
+  LinePolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(100, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto prefix_res = tsuba::RDGPrefix::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  if (!prefix_res) {
+    KATANA_LOG_FATAL("making prefix: {}", prefix_res.error());
+  }
+  const tsuba::RDGPrefix& prefix = prefix_res.value();
+  KATANA_LOG_ASSERT(prefix.num_nodes() == g->num_nodes());
+  KATANA_LOG_ASSERT(prefix.num_edges() == g->num_edges());
+
+  tsuba::RDGPrefix::DegreeStats stats = prefix.ComputeDegreeStats();
+  KATANA_LOG_ASSERT(stats.max_degree <= 3);
+  KATANA_LOG_ASSERT(stats.mean_degree * 100 == g->num_edges());
+
+  auto slices_res = prefix.BalancedSlices(7);
+  KATANA_LOG_ASSERT(slices_res);
+  const auto& slices = slices_res.value();
+  KATANA_LOG_ASSERT(slices.size() == 7);
+  uint64_t next_node = 0;
+  uint64_t next_edge = 0;
+  for (const auto& slice : slices) {
+    KATANA_LOG_ASSERT(slice.node_range.first == next_node);
+    KATANA_LOG_ASSERT(slice.edge_range.first == next_edge);
+    KATANA_LOG_ASSERT(slice.node_range.second > slice.node_range.first);
+    next_node = slice.node_range.second;
+    next_edge = slice.edge_range.second;
+  }
+  KATANA_LOG_ASSERT(next_node == g->num_nodes());
+  KATANA_LOG_ASSERT(next_edge == g->num_edges());
+}
+
+void
+TestSliceStream() {
+  constexpr size_t test_length = 100;
+  LinePolicy policy{2};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int32_t>("node-name", test_length)));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      MakeProps<int32_t>("edge-name", g->num_edges())));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto prefix_res = tsuba::RDGPrefix::Make(rdg_dir);
+  KATANA_LOG_ASSERT(prefix_res);
+  auto slices_res = prefix_res.value().BalancedSlices(5);
+  KATANA_LOG_ASSERT(slices_res);
+  std::vector<tsuba::RDGSlice::SliceArg> slices = slices_res.value();
+
+  auto handle_res = tsuba::Open(rdg_dir, tsuba::kReadOnly);
+  KATANA_LOG_ASSERT(handle_res);
+  auto stream_res = tsuba::RDGSliceStream::Make(handle_res.value(), slices);
+  KATANA_LOG_ASSERT(tsuba::Close(handle_res.value()));
+  if (!stream_res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making slice stream: {}", stream_res.error());
+  }
+  tsuba::RDGSliceStream stream = std::move(stream_res.value());
+  KATANA_LOG_ASSERT(stream.size() == slices.size());
+
+  size_t num_slices = 0;
+  int64_t num_nodes = 0;
+  int64_t num_edges = 0;
+  for (;;) {
+    auto next_res = stream.Next();
+    if (!next_res) {
+      fs::remove_all(rdg_dir);
+      KATANA_LOG_FATAL("loading slice: {}", next_res.error());
+    }
+    const tsuba::RDGSlice* slice = next_res.value();
+    if (slice == nullptr) {
+      break;
+    }
+    const auto& arg = slices[num_slices++];
+    int64_t slice_nodes = arg.node_range.second - arg.node_range.first;
+    int64_t slice_edges = arg.edge_range.second - arg.edge_range.first;
+    KATANA_LOG_ASSERT(slice->node_properties()->num_rows() == slice_nodes);
+    KATANA_LOG_ASSERT(slice->edge_properties()->num_rows() == slice_edges);
+    num_nodes += slice_nodes;
+    num_edges += slice_edges;
+  }
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(num_slices == slices.size());
+  KATANA_LOG_ASSERT(num_nodes == int64_t{test_length});
+  KATANA_LOG_ASSERT(num_edges == static_cast<int64_t>(g->num_edges()));
+}
+
+void
+TestMakePartitions() {
+  auto rdg_file = MakePFGFile("n1");
+  KATANA_LOG_ASSERT(!rdg_file.empty());
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_file, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(make_result);
+  std::unique_ptr<katana::PropertyGraph> expected =
+      std::move(make_result.value());
+
+  // the graph has one partition; loading it several times at once should
+  // give the same graph each time
+  auto parts_result = katana::PropertyGraph::MakePartitions(
+      rdg_file, {0, 0, 0}, tsuba::RDGLoadOptions(), 2);
+  fs::remove_all(rdg_file);
+  if (!parts_result) {
+    KATANA_LOG_FATAL("making partitions: {}", parts_result.error());
+  }
+  KATANA_LOG_ASSERT(parts_result.value().size() == 3);
+  for (const auto& part : parts_result.value()) {
+    KATANA_LOG_ASSERT(part->partition_id() == 0);
+    KATANA_LOG_ASSERT(part->Equals(expected.get()));
+  }
+}
+
+void
+TestColumnStats() {
+  constexpr size_t test_length = 100;
+  LinePolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int32_t>("node-name", test_length)));
+
+  auto unstored = g->GetNodePropertyStats("node-name");
+  KATANA_LOG_ASSERT(
+      !unstored && unstored.error() == tsuba::ErrorCode::NotFound);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+
+  // statistics are available without loading the property
+  auto stats_res = make_result.value()->GetNodePropertyStats("node-name");
+  if (!stats_res) {
+    KATANA_LOG_FATAL("getting stats: {}", stats_res.error());
+  }
+  const tsuba::ColumnStats& stats = stats_res.value();
+  KATANA_LOG_ASSERT(stats.num_rows == int64_t{test_length});
+  KATANA_LOG_ASSERT(stats.null_count == 0);
+  KATANA_LOG_ASSERT(stats.min && stats.max);
+  KATANA_LOG_ASSERT(stats.min->Equals(arrow::Int64Scalar(0)));
+  KATANA_LOG_ASSERT(stats.max->Equals(arrow::Int64Scalar(test_length - 1)));
+  KATANA_LOG_ASSERT(stats.distinct_estimate);
+  KATANA_LOG_VASSERT(
+      stats.distinct_estimate.value() >= test_length * 95 / 100 &&
+          stats.distinct_estimate.value() <= test_length * 105 / 100,
+      "estimated {} distinct values", stats.distinct_estimate.value());
+
+  KATANA_LOG_ASSERT(!make_result.value()->GetNodePropertyStats("no-such"));
+}
+
+std::shared_ptr<arrow::Array>
+MakeDoubles(const std::vector<double>& values) {
+  arrow::DoubleBuilder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(values).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+std::shared_ptr<arrow::Array>
+MakeStrings(const std::vector<std::string>& values) {
+  arrow::StringBuilder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(values).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+/// Values that JSON cannot hold do not keep the graph from being reopened
+void
+TestColumnStatsSpecialValues() {
+  constexpr double kInf = std::numeric_limits<double>::infinity();
+  LinePolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(4, 0, &policy);
+
+  auto doubles = MakeDoubles({-kInf, 1.5, kInf, std::nan("")});
+  auto infinite = MakeDoubles({kInf, kInf, -kInf, kInf});
+  std::string long_string(300, 'a');
+  auto long_min = MakeStrings({long_string, "b", "c", "d"});
+  auto long_max = MakeStrings({"a", std::string(300, 'z'), "b", "c"});
+  auto not_utf8 = MakeStrings({"\xff\xfe", "a", "b", "c"});
+
+  auto schema = arrow::schema({
+      arrow::field("doubles", arrow::float64()),
+      arrow::field("infinite", arrow::float64()),
+      arrow::field("long_min", arrow::utf8()),
+      arrow::field("long_max", arrow::utf8()),
+      arrow::field("not_utf8", arrow::utf8()),
+  });
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      schema, {doubles, infinite, long_min, long_max, not_utf8})));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  auto stats = [&](const std::string& name) {
+    auto res = make_result.value()->GetNodePropertyStats(name);
+    if (!res) {
+      KATANA_LOG_FATAL("getting stats of {}: {}", name, res.error());
+    }
+    return res.value();
+  };
+
+  // infinities count as distinct values but are not a min or max
+  tsuba::ColumnStats double_stats = stats("doubles");
+  KATANA_LOG_ASSERT(double_stats.min && double_stats.max);
+  KATANA_LOG_ASSERT(double_stats.min->Equals(arrow::DoubleScalar(1.5)));
+  KATANA_LOG_ASSERT(double_stats.max->Equals(arrow::DoubleScalar(1.5)));
+  KATANA_LOG_ASSERT(double_stats.distinct_estimate.value() == 3);
+
+  tsuba::ColumnStats infinite_stats = stats("infinite");
+  KATANA_LOG_ASSERT(!infinite_stats.min && !infinite_stats.max);
+  KATANA_LOG_ASSERT(infinite_stats.distinct_estimate.value() == 2);
+
+  tsuba::ColumnStats long_min_stats = stats("long_min");
+  KATANA_LOG_ASSERT(long_min_stats.min && long_min_stats.max);
+  KATANA_LOG_ASSERT(long_min_stats.min->Equals(
+      arrow::StringScalar(long_string.substr(0, 256))));
+  KATANA_LOG_ASSERT(long_min_stats.max->Equals(arrow::StringScalar("d")));
+
+  tsuba::ColumnStats long_max_stats = stats("long_max");
+  KATANA_LOG_ASSERT(!long_max_stats.min && !long_max_stats.max);
+  KATANA_LOG_ASSERT(long_max_stats.num_rows == 4);
+
+  tsuba::ColumnStats not_utf8_stats = stats("not_utf8");
+  KATANA_LOG_ASSERT(!not_utf8_stats.min && !not_utf8_stats.max);
+  KATANA_LOG_ASSERT(not_utf8_stats.distinct_estimate.value() == 4);
+}
+
+void
+TestCollectGarbage() {
+  constexpr size_t test_length = 10;
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int32_t>("node-name", test_length)));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // the next version replaces the edge properties but shares the node
+  // properties and topology with the first
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(make_result);
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(
+      g2->AddEdgeProperties(MakeProps<int64_t>("edge-name", test_length)));
+  auto commit_result = g2->Commit(command_line);
+  if (!commit_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing: {}", commit_result.error());
+  }
+
+  tsuba::GarbageCollectOptions opts;
+  opts.dry_run = true;
+  auto dry_run_res = tsuba::CollectGarbage(rdg_dir, opts);
+  KATANA_LOG_ASSERT(dry_run_res);
+  KATANA_LOG_ASSERT(dry_run_res.value().files_deleted > 0);
+
+  auto gc_res = tsuba::CollectGarbage(rdg_dir);
+  if (!gc_res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("collecting garbage: {}", gc_res.error());
+  }
+  KATANA_LOG_ASSERT(gc_res.value().versions_retained == 1);
+  KATANA_LOG_ASSERT(gc_res.value().versions_removed > 0);
+  KATANA_LOG_ASSERT(
+      gc_res.value().files_deleted == dry_run_res.value().files_deleted);
+
+  // everything the retained version needs is still there
+  make_result = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  KATANA_LOG_ASSERT(make_result.value()->Equals(g2.get()));
+
+  auto again_res = tsuba::CollectGarbage(rdg_dir);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(again_res);
+  KATANA_LOG_ASSERT(again_res.value().files_deleted == 0);
+}
+
+template <typename View>
+bool
+ViewsEqual(const View& v1, const View& v2) {
+  if (v1.num_nodes() != v2.num_nodes() || v1.num_edges() != v2.num_edges()) {
+    return false;
+  }
+  for (auto n : v1.all_nodes()) {
+    if (v1.node_property_index(n) != v2.node_property_index(n) ||
+        *v1.edges(n).begin() != *v2.edges(n).begin() ||
+        v1.degree(n) != v2.degree(n)) {
+      return false;
+    }
+    for (auto e : v1.edges(n)) {
+      if (v1.edge_dest(e) != v2.edge_dest(e) ||
+          v1.edge_property_index(e) != v2.edge_property_index(e)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void
+TestPersistViewTopologies() {
+  using View =
+      katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(200, 0, &policy);
+  View view = g->BuildView<View>();
+  KATANA_LOG_ASSERT(g->PersistViewTopologies());
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  size_t num_derived = 0;
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().find("derived_topology") == 0) {
+      ++num_derived;
+    }
+  }
+  // the node sorted topology and the edge sorted topology it was made from
+  KATANA_LOG_ASSERT(num_derived == 2);
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  View loaded_view = make_result.value()->BuildView<View>();
+  KATANA_LOG_ASSERT(ViewsEqual(view, loaded_view));
+}
+
+std::shared_ptr<arrow::Table>
+MakeEdgeTypes(size_t num_edges, size_t heavy_stride) {
+  arrow::BooleanBuilder heavy;
+  arrow::BooleanBuilder light;
+  for (size_t e = 0; e < num_edges; ++e) {
+    KATANA_LOG_ASSERT(heavy.Append(e % heavy_stride == 0).ok());
+    KATANA_LOG_ASSERT(light.Append(e % heavy_stride != 0).ok());
+  }
+  std::shared_ptr<arrow::Array> heavy_array;
+  std::shared_ptr<arrow::Array> light_array;
+  KATANA_LOG_ASSERT(heavy.Finish(&heavy_array).ok());
+  KATANA_LOG_ASSERT(light.Finish(&light_array).ok());
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("heavy", arrow::boolean()),
+           arrow::field("light", arrow::boolean())}),
+      {heavy_array, light_array});
+}
+
+template <typename View>
+bool
+EdgeTypeViewsEqual(const View& v1, const View& v2) {
+  if (v1.num_nodes() != v2.num_nodes() || v1.num_edges() != v2.num_edges()) {
+    return false;
+  }
+  for (auto n : v1.all_nodes()) {
+    for (auto type : v1.GetDistinctEdgeTypes()) {
+      auto out1 = v1.edges(n, type);
+      auto out2 = v2.edges(n, type);
+      auto in1 = v1.in_edges(n, type);
+      auto in2 = v2.in_edges(n, type);
+      if (out1.size() != out2.size() || in1.size() != in2.size()) {
+        return false;
+      }
+      for (auto e1 = out1.begin(), e2 = out2.begin(); e1 != out1.end();
+           ++e1, ++e2) {
+        if (v1.edge_dest(*e1) != v2.edge_dest(*e2)) {
+          return false;
+        }
+      }
+      for (auto e1 = in1.begin(), e2 = in2.begin(); e1 != in1.end();
+           ++e1, ++e2) {
+        if (v1.in_edge_dest(*e1) != v2.in_edge_dest(*e2)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void
+TestUpdateViewEntityTypes() {
+  using View = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
+
+  LinePolicy policy{5};
+  auto g = MakeFileGraph<uint32_t>(200, 0, &policy);
+  size_t num_edges = g->num_edges();
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(MakeEdgeTypes(num_edges, 3)));
+  KATANA_LOG_ASSERT(g->ConstructEntityTypeIDs());
+  View view = g->BuildView<View>();
+
+  // retype some of the edges
+  KATANA_LOG_ASSERT(g->UpsertEdgeProperties(MakeEdgeTypes(num_edges, 7)));
+  KATANA_LOG_ASSERT(g->ConstructEntityTypeIDs());
+
+  LinePolicy fresh_policy{5};
+  auto fresh = MakeFileGraph<uint32_t>(200, 0, &fresh_policy);
+  KATANA_LOG_ASSERT(fresh->AddEdgeProperties(MakeEdgeTypes(num_edges, 7)));
+  KATANA_LOG_ASSERT(fresh->ConstructEntityTypeIDs());
+  View fresh_view = fresh->BuildView<View>();
+
+  // the view built before the update was patched in place
+  KATANA_LOG_ASSERT(EdgeTypeViewsEqual(view, fresh_view));
+  KATANA_LOG_ASSERT(EdgeTypeViewsEqual(g->BuildView<View>(), fresh_view));
+}
+
+void
+TestPipelinedLoad() {
+  using View = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
+
+  LinePolicy policy{5};
+  auto g = MakeFileGraph<uint32_t>(200, 0, &policy);
+  size_t num_edges = g->num_edges();
+  // the types are between other properties, which must keep their places
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int32_t>("node-name", g->num_nodes())));
+  KATANA_LOG_ASSERT(
+      g->AddEdgeProperties(MakeProps<int32_t>("edge-before", num_edges)));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(MakeEdgeTypes(num_edges, 3)));
+  KATANA_LOG_ASSERT(
+      g->AddEdgeProperties(MakeProps<int64_t>("edge-after", num_edges)));
+  KATANA_LOG_ASSERT(g->ConstructEntityTypeIDs());
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  tsuba::RDGLoadOptions opts;
+  opts.pipelined = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+  KATANA_LOG_ASSERT(
+      g2->loaded_node_schema()->Equals(*g->loaded_node_schema()));
+  KATANA_LOG_ASSERT(
+      g2->loaded_edge_schema()->Equals(*g->loaded_edge_schema()));
+  KATANA_LOG_ASSERT(g2->node_properties()->Equals(*g->node_properties()));
+  KATANA_LOG_ASSERT(g2->edge_properties()->Equals(*g->edge_properties()));
+  // the entity types were constructed by Make
+  KATANA_LOG_ASSERT(g2->GetNumEdgeEntityTypes() == g->GetNumEdgeEntityTypes());
+  KATANA_LOG_ASSERT(
+      EdgeTypeViewsEqual(g2->BuildView<View>(), g->BuildView<View>()));
+
+  // a selection keeps its order
+  opts.node_properties = std::vector<std::string>();
+  opts.edge_properties =
+      std::vector<std::string>{"edge-after", "light", "edge-before"};
+  make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  KATANA_LOG_ASSERT(make_result);
+  std::unique_ptr<katana::PropertyGraph> g3 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g3->GetNumNodeProperties() == 0);
+  KATANA_LOG_ASSERT(
+      g3->loaded_edge_schema()->field_names() ==
+      opts.edge_properties.value());
+  KATANA_LOG_ASSERT(
+      g3->GetEdgeEntityTypeID("light") != katana::kUnknownEntityType);
+
+  // lazily, only the types are loaded by Make and the others arrive later
+  opts = tsuba::RDGLoadOptions();
+  opts.pipelined = true;
+  opts.lazy_properties = true;
+  make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g4 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g4->GetNumNodeProperties() == 0);
+  KATANA_LOG_ASSERT(g4->GetNumEdgeProperties() == 2);
+  KATANA_LOG_ASSERT(
+      EdgeTypeViewsEqual(g4->BuildView<View>(), g->BuildView<View>()));
+  auto edge_prop = g4->GetEdgeProperty("edge-after");
+  KATANA_LOG_ASSERT(edge_prop);
+  KATANA_LOG_ASSERT(edge_prop->Equals(*g->GetEdgeProperty("edge-after")));
+  KATANA_LOG_ASSERT(g4->GetNumEdgeProperties() == 3);
+
+  // destroying the graph waits for the reads still in flight, which must
+  // finish before their files are removed
+  g4.reset();
+  fs::remove_all(rdg_dir);
+}
+
+/// Edge e has the type column (e + shift) % num_types
+std::shared_ptr<arrow::Table>
+MakeManyEdgeTypes(size_t num_edges, size_t num_types, size_t shift) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (size_t t = 0; t < num_types; ++t) {
+    arrow::BooleanBuilder builder;
+    for (size_t e = 0; e < num_edges; ++e) {
+      KATANA_LOG_ASSERT(builder.Append((e + shift) % num_types == t).ok());
+    }
+    std::shared_ptr<arrow::Array> array;
+    KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+    fields.emplace_back(
+        arrow::field(fmt::format("type-{}", t), arrow::boolean()));
+    columns.emplace_back(array);
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+void
+TestSparseEdgeTypeIndex() {
+  using View = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
+  constexpr size_t kNumNodes = 1000;
+  // few types per node out of many, so that the directory of type runs is
+  // used
+  constexpr size_t kNumTypes = 16;
+
+  LinePolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  size_t num_edges = g->num_edges();
+  KATANA_LOG_ASSERT(
+      g->AddEdgeProperties(MakeManyEdgeTypes(num_edges, kNumTypes, 0)));
+  KATANA_LOG_ASSERT(g->ConstructEntityTypeIDs());
+  View view = g->BuildView<View>();
+
+  for (auto n : view.all_nodes()) {
+    size_t num_typed = 0;
+    for (auto type : view.GetDistinctEdgeTypes()) {
+      for (auto e : view.edges(n, type)) {
+        KATANA_LOG_ASSERT(
+            g->GetTypeOfEdge(view.edge_property_index(e)) == type);
+        ++num_typed;
+      }
+    }
+    KATANA_LOG_VASSERT(num_typed == view.degree(n), "node {}", n);
+  }
+
+  // retype all of the edges
+  KATANA_LOG_ASSERT(
+      g->UpsertEdgeProperties(MakeManyEdgeTypes(num_edges, kNumTypes, 5)));
+  KATANA_LOG_ASSERT(g->ConstructEntityTypeIDs());
+
+  LinePolicy fresh_policy{3};
+  auto fresh = MakeFileGraph<uint32_t>(kNumNodes, 0, &fresh_policy);
+  KATANA_LOG_ASSERT(fresh->AddEdgeProperties(
+      MakeManyEdgeTypes(num_edges, kNumTypes, 5)));
+  KATANA_LOG_ASSERT(fresh->ConstructEntityTypeIDs());
+  KATANA_LOG_ASSERT(EdgeTypeViewsEqual(view, fresh->BuildView<View>()));
+}
+
+/// Count the instances of path from sources by going over all of the edges
+/// of the graph at each step
+std::vector<uint64_t>
+CountMetapathInstancesSerially(
+    const katana::PropertyGraph& g,
+    const std::vector<katana::GraphTopology::Node>& sources,
+    const katana::Metapath& path) {
+  const katana::GraphTopology& topo = g.topology();
+  std::vector<uint64_t> counts(topo.num_nodes());
+  for (auto source : sources) {
+    counts[source] += 1;
+  }
+  for (const katana::MetapathStep& step : path) {
+    std::vector<uint64_t> next(topo.num_nodes());
+    for (auto src : topo.all_nodes()) {
+      for (auto e : topo.edges(src)) {
+        if (g.GetTypeOfEdge(e) != step.edge_type) {
+          continue;
+        }
+        auto dst = topo.edge_dest(e);
+        if (step.direction == katana::MetapathStep::Direction::kOut) {
+          next[dst] += counts[src];
+        } else {
+          next[src] += counts[dst];
+        }
+      }
+    }
+    counts = std::move(next);
+  }
+  return counts;
+}
+
+void
+TestMetapath() {
+  using View = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
+  using Direction = katana::MetapathStep::Direction;
+  constexpr size_t kNumNodes = 200;
+
+  LinePolicy policy{5};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(MakeEdgeTypes(g->num_edges(), 3)));
+  KATANA_LOG_ASSERT(g->ConstructEntityTypeIDs());
+  View view = g->BuildView<View>();
+  auto heavy = g->GetEdgeEntityTypeID("heavy");
+  auto light = g->GetEdgeEntityTypeID("light");
+
+  std::vector<katana::GraphTopology::Node> sources{0, 7, 7, 150};
+  katana::Metapath path{
+      {heavy, Direction::kOut},
+      {light, Direction::kIn},
+      {light, Direction::kOut}};
+  auto expected = CountMetapathInstancesSerially(*g, sources, path);
+  auto counts_res = katana::CountMetapathInstances(view, sources, path);
+  KATANA_LOG_ASSERT(counts_res);
+  const auto& counts = counts_res.value();
+  KATANA_LOG_ASSERT(counts.size() == kNumNodes);
+  std::vector<katana::GraphTopology::Node> expected_endpoints;
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_VASSERT(counts[n] == expected[n], "node {}", n);
+    if (expected[n] > 0) {
+      expected_endpoints.emplace_back(n);
+    }
+  }
+  KATANA_LOG_ASSERT(!expected_endpoints.empty());
+  auto endpoints_res = katana::MetapathEndpoints(view, sources, path);
+  KATANA_LOG_ASSERT(endpoints_res);
+  KATANA_LOG_ASSERT(endpoints_res.value() == expected_endpoints);
+
+  katana::Metapath symmetric{
+      {heavy, Direction::kOut},
+      {light, Direction::kOut},
+      {light, Direction::kIn},
+      {heavy, Direction::kIn}};
+  constexpr katana::GraphTopology::Node kSource = 7;
+  auto scores_res = katana::PathSim(view, kSource, symmetric);
+  KATANA_LOG_ASSERT(scores_res);
+  auto from_source = CountMetapathInstancesSerially(*g, {kSource}, symmetric);
+  size_t num_reached = std::count_if(
+      from_source.begin(), from_source.end(), [](uint64_t c) { return c > 0; });
+  KATANA_LOG_ASSERT(num_reached > 1);
+  KATANA_LOG_ASSERT(scores_res.value().size() == num_reached);
+  for (const auto& [y, score] : scores_res.value()) {
+    auto from_y = CountMetapathInstancesSerially(*g, {y}, symmetric);
+    double expected_score =
+        2.0 * from_source[y] / (from_source[kSource] + from_y[y]);
+    KATANA_LOG_VASSERT(
+        std::abs(score - expected_score) < 1e-9, "node {}: {} != {}", y,
+        score, expected_score);
+  }
+
+  // PathSim needs a symmetric metapath and sources must be nodes
+  KATANA_LOG_ASSERT(!katana::PathSim(view, kSource, path));
+  KATANA_LOG_ASSERT(!katana::MetapathEndpoints(view, {kNumNodes}, path));
+}
+
+void
+TestEntityTypeIndex() {
+  LinePolicy policy{5};
+  auto g = MakeFileGraph<uint32_t>(200, 0, &policy);
+  size_t num_edges = g->num_edges();
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(MakeEdgeTypes(num_edges, 3)));
+
+  // overlaps both heavy and light
+  arrow::BooleanBuilder marked;
+  for (size_t e = 0; e < num_edges; ++e) {
+    KATANA_LOG_ASSERT(marked.Append(e % 2 == 0).ok());
+  }
+  std::shared_ptr<arrow::Array> marked_array;
+  KATANA_LOG_ASSERT(marked.Finish(&marked_array).ok());
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("marked", arrow::boolean())}),
+      {marked_array})));
+  KATANA_LOG_ASSERT(g->ConstructEntityTypeIDs());
+
+  for (katana::EntityTypeID type = 0; type < g->GetNumEdgeEntityTypes();
+       ++type) {
+    std::vector<katana::GraphTopology::Edge> expected;
+    for (auto e : g->topology().all_edges()) {
+      if (g->IsEdgeSubtypeOf(type, g->GetTypeOfEdge(e))) {
+        expected.emplace_back(e);
+      }
+    }
+    KATANA_LOG_ASSERT(g->GetNumEdgesOfType(type) == expected.size());
+    KATANA_LOG_ASSERT(g->GetEdgesOfType(type) == expected);
+    for (auto e : g->topology().all_edges()) {
+      KATANA_LOG_ASSERT(
+          g->DoesEdgeHaveType(e, type) ==
+          g->IsEdgeSubtypeOf(type, g->GetTypeOfEdge(e)));
+    }
+  }
+
+  auto heavy = g->GetEdgeEntityTypeID("heavy");
+  KATANA_LOG_ASSERT(g->GetNumEdgesOfType(heavy) == (num_edges + 2) / 3);
+  KATANA_LOG_ASSERT(g->GetNumNodesOfType(katana::kUnknownEntityType) == 200);
+  KATANA_LOG_ASSERT(
+      g->GetNodesOfType(katana::kUnknownEntityType).size() == 200);
+}
+
+template <typename Index>
+bool
+IndexesEqual(const Index& a, const Index& b) {
+  return a.kind() == b.kind() && a.size() == b.size() &&
+         std::equal(a.begin(), a.end(), b.begin());
+}
+
+void
+TestPersistIndexes() {
+  constexpr size_t test_length = 100;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("node-name", test_length)));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      MakeProps<int64_t>("edge-name", g->topology().num_edges())));
+
+  KATANA_LOG_ASSERT(
+      g->MakeNodeIndex("node-name", katana::PropertyIndexKind::kHash));
+  KATANA_LOG_ASSERT(g->MakeEdgeIndex("edge-name"));
+  KATANA_LOG_ASSERT(g->PersistIndexes());
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  size_t num_stored = 0;
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().find("property_index") == 0) {
+      ++num_stored;
+    }
+  }
+  KATANA_LOG_ASSERT(num_stored == 2);
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(g2->node_indexes().size() == 1);
+  KATANA_LOG_ASSERT(g2->edge_indexes().size() == 1);
+  KATANA_LOG_ASSERT(g2->node_indexes()[0]->is_from_file());
+  KATANA_LOG_ASSERT(g2->edge_indexes()[0]->is_from_file());
+  KATANA_LOG_ASSERT(
+      IndexesEqual(*g->node_indexes()[0], *g2->node_indexes()[0]));
+  KATANA_LOG_ASSERT(
+      IndexesEqual(*g->edge_indexes()[0], *g2->edge_indexes()[0]));
+
+  using NodeIndex =
+      katana::PrimitivePropertyIndex<katana::GraphTopology::Node, int64_t>;
+  auto* node_index = static_cast<NodeIndex*>(g2->node_indexes()[0].get());
+  auto node_prop = std::static_pointer_cast<arrow::Int64Array>(
+      g2->GetNodeProperty("node-name")->chunk(0));
+  for (size_t node = 0; node < test_length; ++node) {
+    auto it = node_index->Find(node_prop->Value(node));
+    KATANA_LOG_ASSERT(it != node_index->end());
+    KATANA_LOG_ASSERT(node_prop->Value(*it) == node_prop->Value(node));
+  }
+
+  // asking for another kind than the stored one rebuilds the index
+  tsuba::RDGLoadOptions opts;
+  opts.lazy_properties = true;
+  make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g3 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g3->node_indexes().empty());
+  KATANA_LOG_ASSERT(
+      g3->MakeNodeIndex("node-name", katana::PropertyIndexKind::kSorted));
+  KATANA_LOG_ASSERT(!g3->node_indexes()[0]->is_from_file());
+  KATANA_LOG_ASSERT(
+      g3->node_indexes()[0]->kind() == katana::PropertyIndexKind::kSorted);
+  KATANA_LOG_ASSERT(g3->MakeEdgeIndex("edge-name"));
+  KATANA_LOG_ASSERT(g3->edge_indexes()[0]->is_from_file());
+}
+
+/// Reads of local files that span several io_uring chunks return the file
+/// contents, and reads past the end of the file fail
+void
+TestLocalReads() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string path(uri_res.value().path());  // path() because local
+
+  // a little over three 1 MiB chunks
+  std::vector<uint8_t> data((UINT64_C(3) << 20) + 17);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 31 + (i >> 20));
+  }
+  auto store_res = tsuba::FileStore(path, data.data(), data.size());
+  KATANA_LOG_VASSERT(store_res, "storing {}: {}", path, store_res.error());
+
+  std::vector<uint8_t> whole(data.size());
+  auto get_res = tsuba::FileGet(path, whole.data(), 0, whole.size());
+  KATANA_LOG_VASSERT(get_res, "reading {}: {}", path, get_res.error());
+  KATANA_LOG_ASSERT(whole == data);
+
+  // unaligned range across chunk boundaries
+  uint64_t begin = (UINT64_C(1) << 20) - 5;
+  std::vector<uint8_t> part((UINT64_C(2) << 20) + 9);
+  auto async_res =
+      tsuba::FileGetAsync(path, part.data(), begin, part.size()).get();
+  KATANA_LOG_ASSERT(async_res);
+  KATANA_LOG_ASSERT(std::equal(
+      part.begin(), part.end(), data.begin() + static_cast<ptrdiff_t>(begin)));
+
+  // the last chunk of this read starts at the end of the file
+  std::vector<uint8_t> past(data.size() + (UINT64_C(1) << 20));
+  auto past_res = tsuba::FileGet(path, past.data(), 0, past.size());
+  KATANA_LOG_ASSERT(!past_res);
+
+  fs::remove(path);
+}
+
+/// \returns the directory that g was written to with checksums
+std::string
+WriteWithChecksums(katana::PropertyGraph* g) {
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  katana::SetEnv("KATANA_TSUBA_CHECKSUMS", "true", true);
+  auto write_result = g->Write(rdg_dir, command_line);
+  katana::UnsetEnv("KATANA_TSUBA_CHECKSUMS");
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+  return rdg_dir;
+}
+
+void
+TestChecksums() {
+  LinePolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(100, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("node-name", 100)));
+
+  std::string rdg_dir = WriteWithChecksums(g.get());
+
+  tsuba::RDGLoadOptions opts;
+  opts.verify_checksums = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  KATANA_LOG_ASSERT(g->topology().Equals(make_result.value()->topology()));
+
+  // flip a bit of the last destination in the topology file
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().find("topology") == 0) {
+      std::fstream topo(
+          entry.path().string(),
+          std::ios::in | std::ios::out | std::ios::binary);
+      topo.seekg(-1, std::ios::end);
+      char c = static_cast<char>(topo.get() ^ 1);
+      topo.seekp(-1, std::ios::end);
+      topo.put(c);
+    }
+  }
+
+  auto corrupt_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  KATANA_LOG_ASSERT(
+      !corrupt_result &&
+      corrupt_result.error() == tsuba::ErrorCode::ChecksumMismatch);
+
+  // an out-of-core topology is read through once to check it
+  tsuba::RDGLoadOptions ooc_opts = opts;
+  ooc_opts.out_of_core_topology = true;
+  corrupt_result = katana::PropertyGraph::Make(rdg_dir, ooc_opts);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(
+      !corrupt_result &&
+      corrupt_result.error() == tsuba::ErrorCode::ChecksumMismatch);
+
+  // property files are checked when they are loaded in full, whether by Make
+  // or later
+  rdg_dir = WriteWithChecksums(g.get());
+  CorruptFiles(rdg_dir, "node-name");
+  corrupt_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  KATANA_LOG_ASSERT(
+      !corrupt_result &&
+      corrupt_result.error() == tsuba::ErrorCode::ChecksumMismatch);
+
+  tsuba::RDGLoadOptions lazy_opts = opts;
+  lazy_opts.lazy_properties = true;
+  auto lazy_result = katana::PropertyGraph::Make(rdg_dir, lazy_opts);
+  if (!lazy_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making lazy result: {}", lazy_result.error());
+  }
+  auto load_result =
+      lazy_result.value()->LoadLazyNodeProperties({"node-name"});
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(
+      !load_result &&
+      load_result.error() == tsuba::ErrorCode::ChecksumMismatch);
+}
+
+/// The number of files in \p dir whose names start with \p prefix
+size_t
+CountFiles(const std::string& dir, const std::string& prefix) {
+  size_t count = 0;
+  for (const auto& entry : fs::directory_iterator(dir)) {
+    if (entry.path().filename().string().rfind(prefix, 0) == 0) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void
+TestReplaceTopology() {
+  constexpr size_t test_length = 10;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int32_t>("node-name", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddEdgeProperties(MakeProps<int32_t>("edge-name", test_length)));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(make_result);
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  // add an edge from node 0 to node 1 after the edge of node 0
+  const katana::GraphTopology& topo = g2->topology();
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  arrow::Int32Builder values;
+  for (auto n : topo.all_nodes()) {
+    for (auto e : topo.edges(n)) {
+      dests.emplace_back(topo.edge_dest(e));
+      KATANA_LOG_ASSERT(values.Append(static_cast<int32_t>(e)).ok());
+    }
+    if (n == 0) {
+      dests.emplace_back(1);
+      KATANA_LOG_ASSERT(values.Append(100).ok());
+    }
+    indices.emplace_back(dests.size());
+  }
+  std::shared_ptr<arrow::Array> edge_values;
+  KATANA_LOG_ASSERT(values.Finish(&edge_values).ok());
+  auto edge_props = arrow::Table::Make(
+      arrow::schema({arrow::field("edge-name", arrow::int32())}),
+      {edge_values});
+
+  // edge properties must be replaced since there is a new edge
+  KATANA_LOG_ASSERT(!g2->ReplaceTopology(
+      katana::GraphTopology{
+          indices.data(), indices.size(), dests.data(), dests.size()},
+      nullptr, nullptr));
+  auto replace_result = g2->ReplaceTopology(
+      katana::GraphTopology{
+          indices.data(), indices.size(), dests.data(), dests.size()},
+      nullptr, edge_props);
+  if (!replace_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("replacing topology: {}", replace_result.error());
+  }
+  KATANA_LOG_ASSERT(g2->num_edges() == test_length + 1);
+  auto commit_result = g2->Commit(command_line);
+  if (!commit_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing: {}", commit_result.error());
+  }
+
+  // only the edge property was written again
+  KATANA_LOG_ASSERT(CountFiles(rdg_dir, "node-name") == 1);
+  KATANA_LOG_ASSERT(CountFiles(rdg_dir, "edge-name") == 2);
+
+  make_result = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g3 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g3->topology().Equals(g2->topology()));
+  KATANA_LOG_ASSERT(g3->Equals(g2.get()));
+  KATANA_LOG_ASSERT(g3->GetNodeProperty("node-name")->Equals(
+      *g->GetNodeProperty("node-name")));
+}
+void
+TestReorderNodes() {
+  constexpr size_t test_length = 10;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int32_t>("node-name", test_length)));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      MakeProps<int32_t>("edge-name", g->topology().num_edges())));
+
+  // the node value, edge destinations and edge values of each node
+  auto node_values = [](katana::PropertyGraph* pg) {
+    auto values = pg->GetNodeProperty("node-name");
+    auto edge_values = pg->GetEdgeProperty("edge-name");
+    const katana::GraphTopology& topo = pg->topology();
+    std::vector<std::vector<int64_t>> rows;
+    for (auto n : topo.all_nodes()) {
+      auto value = std::static_pointer_cast<arrow::Int32Scalar>(
+          values->GetScalar(n).ValueOrDie());
+      std::vector<int64_t> row{value->value};
+      for (auto e : topo.edges(n)) {
+        auto edge_value = std::static_pointer_cast<arrow::Int32Scalar>(
+            edge_values->GetScalar(e).ValueOrDie());
+        row.emplace_back(topo.edge_dest(e));
+        row.emplace_back(edge_value->value);
+      }
+      rows.emplace_back(row);
+    }
+    return rows;
+  };
+  auto before = node_values(g.get());
+
+  katana::GraphTopologyTypes::PropIndexVec order;
+  order.allocateInterleaved(test_length);
+  for (size_t i = 0; i < test_length; ++i) {
+    order[i] = 0;
+  }
+  KATANA_LOG_ASSERT(!katana::ReorderNodes(g.get(), order));
+
+  // reverse the nodes
+  for (size_t i = 0; i < test_length; ++i) {
+    order[i] = test_length - 1 - i;
+  }
+  auto reorder_result = katana::ReorderNodes(g.get(), order);
+  if (!reorder_result) {
+    KATANA_LOG_FATAL("reordering: {}", reorder_result.error());
+  }
+  auto after = node_values(g.get());
+  for (size_t i = 0; i < test_length; ++i) {
+    std::vector<int64_t> expected = before[order[i]];
+    for (size_t j = 1; j < expected.size(); j += 2) {
+      expected[j] = test_length - 1 - expected[j];
+    }
+    KATANA_LOG_VASSERT(after[i] == expected, "node {}", i);
+  }
+}
+
+void
+TestShallowCopy() {
+  constexpr size_t test_length = 10;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int32_t>("node-name", test_length)));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      MakeProps<int32_t>("edge-name", g->topology().num_edges())));
+
+  auto copy_result = g->ShallowCopy();
+  if (!copy_result) {
+    KATANA_LOG_FATAL("copying: {}", copy_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> copy = std::move(copy_result.value());
+  KATANA_LOG_ASSERT(copy->topology().Equals(g->topology()));
+  // the columns are the same arrays, not copies of them
+  KATANA_LOG_ASSERT(
+      copy->GetNodeProperty("node-name") == g->GetNodeProperty("node-name"));
+  KATANA_LOG_ASSERT(
+      copy->GetEdgeProperty("edge-name") == g->GetEdgeProperty("edge-name"));
+
+  // updating the copy leaves the original alone
+  auto original = g->GetNodeProperty("node-name");
+  KATANA_LOG_ASSERT(
+      copy->UpsertNodeProperties(MakeProps<int32_t>("node-name", test_length)));
+  KATANA_LOG_ASSERT(g->GetNodeProperty("node-name") == original);
+  KATANA_LOG_ASSERT(copy->GetNodeProperty("node-name") != original);
+
+  auto subset = g->ShallowCopy({"node-name"}, {});
+  KATANA_LOG_ASSERT(subset);
+  KATANA_LOG_ASSERT(subset.value()->GetNumNodeProperties() == 1);
+  KATANA_LOG_ASSERT(subset.value()->GetNumEdgeProperties() == 0);
+
+  KATANA_LOG_ASSERT(!g->ShallowCopy({"no-such-property"}, {}));
+}
+
+void
+TestUndirectedViews() {
+  constexpr size_t test_length = 100;
+
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  const katana::GraphTopology& topo = g->topology();
+
+  // the neighbors of each node, either end of its edges
+  std::vector<std::vector<uint32_t>> expected(test_length);
+  for (auto n : topo.all_nodes()) {
+    for (auto e : topo.edges(n)) {
+      expected[n].push_back(topo.edge_dest(e));
+      expected[topo.edge_dest(e)].push_back(n);
+    }
+  }
+
+  auto view = g->BuildView<katana::PropertyGraphViews::Undirected>();
+  KATANA_LOG_ASSERT(view.num_edges() == 2 * topo.num_edges());
+  for (auto n : view.all_nodes()) {
+    std::vector<uint32_t> neighbors;
+    for (auto e : view.edges(n)) {
+      neighbors.push_back(view.edge_dest(e));
+      if (view.is_out_edge(e)) {
+        KATANA_LOG_ASSERT(view.edge_property_index(e) == e);
+      }
+    }
+    KATANA_LOG_ASSERT(neighbors.size() == view.degree(n));
+    std::sort(neighbors.begin(), neighbors.end());
+    std::sort(expected[n].begin(), expected[n].end());
+    KATANA_LOG_VASSERT(neighbors == expected[n], "node {}", n);
+  }
+
+  auto sorted_view = g->BuildView<
+      katana::PropertyGraphViews::UndirectedEdgesSortedByDestID>();
+  for (auto n : sorted_view.all_nodes()) {
+    std::vector<uint32_t> unique = expected[n];
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+    std::vector<uint32_t> neighbors;
+    sorted_view.ForEachUniqueNeighbor(
+        n, [&](uint32_t m) { neighbors.push_back(m); });
+    KATANA_LOG_VASSERT(neighbors == unique, "node {}", n);
+    KATANA_LOG_ASSERT(sorted_view.unique_degree(n) == unique.size());
+    for (auto m : unique) {
+      KATANA_LOG_ASSERT(sorted_view.IsConnected(n, m));
+      KATANA_LOG_ASSERT(sorted_view.IsConnected(m, n));
+    }
+  }
+}
+
+void
+TestSortAllEdgesAndPropertiesByDest() {
+  constexpr size_t test_length = 100;
+
+  RandomPolicy policy{8};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      MakeProps<int32_t>("edge-name", g->topology().num_edges())));
+
+  // the sorted <destination, value> pairs of the edges of each node
+  auto edge_values = [](katana::PropertyGraph* pg) {
+    auto values = pg->GetEdgeProperty("edge-name");
+    const katana::GraphTopology& topo = pg->topology();
+    std::vector<std::vector<std::pair<uint32_t, int32_t>>> rows;
+    for (auto n : topo.all_nodes()) {
+      std::vector<std::pair<uint32_t, int32_t>> row;
+      for (auto e : topo.edges(n)) {
+        auto value = std::static_pointer_cast<arrow::Int32Scalar>(
+            values->GetScalar(e).ValueOrDie());
+        row.emplace_back(topo.edge_dest(e), value->value);
+      }
+      rows.emplace_back(row);
+    }
+    return rows;
+  };
+  auto before = edge_values(g.get());
+
+  auto sort_result = katana::SortAllEdgesAndPropertiesByDest(g.get());
+  if (!sort_result) {
+    KATANA_LOG_FATAL("sorting: {}", sort_result.error());
+  }
+  auto after = edge_values(g.get());
+  for (size_t n = 0; n < test_length; ++n) {
+    auto dest_less = [](const auto& a, const auto& b) {
+      return a.first < b.first;
+    };
+    KATANA_LOG_VASSERT(
+        std::is_sorted(after[n].begin(), after[n].end(), dest_less), "node {}",
+        n);
+    std::sort(before[n].begin(), before[n].end());
+    std::sort(after[n].begin(), after[n].end());
+    KATANA_LOG_VASSERT(after[n] == before[n], "node {}", n);
+  }
+}
+
 }  // namespace
 
 int
@@ -245,6 +2053,36 @@ main(int argc, char** argv) {
   TestGarbageMetadata();
   TestSimplePGs();
   TestTopologyAccess();
+  TestCompressedTopologyRoundTrip();
+  TestCompressedTopologyCorrupt();
+  TestCompressedTopologySlice();
+  TestOutOfCoreTopology();
+  TestSortOutOfCoreTopology();
+  TestCompactTopology();
+  TestNUMAPartitionedTopology();
+  TestLazyLoad();
+  TestPredicateLoad();
+  TestParquetStreamWriter();
+  TestPlanningOpen();
+  TestSliceStream();
+  TestMakePartitions();
+  TestColumnStats();
+  TestColumnStatsSpecialValues();
+  TestCollectGarbage();
+  TestLocalReads();
+  TestChecksums();
+  TestPersistViewTopologies();
+  TestPersistIndexes();
+  TestUpdateViewEntityTypes();
+  TestPipelinedLoad();
+  TestEntityTypeIndex();
+  TestReplaceTopology();
+  TestReorderNodes();
+  TestSortAllEdgesAndPropertiesByDest();
+  TestUndirectedViews();
+  TestShallowCopy();
+  TestSparseEdgeTypeIndex();
+  TestMetapath();
 
   return 0;
 }
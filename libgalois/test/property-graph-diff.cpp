@@ -1,6 +1,9 @@
+#include <vector>
+
 #include <arrow/api.h>
 
 #include "katana/BuildGraph.h"
+#include "katana/GraphTopology.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
@@ -201,6 +204,31 @@ CreateGraph3() {
   return std::move(graph_result.value());
 }
 
+/// A destination that is not a node and offsets that decrease are errors
+void
+TestValidateTopology() {
+  using Node = katana::GraphTopology::Node;
+  using Edge = katana::GraphTopology::Edge;
+
+  std::vector<Edge> adj_indices{2, 3, 3};
+  std::vector<Node> dests{1, 2, 0};
+  katana::GraphTopology good(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+  KATANA_LOG_ASSERT(good.Validate());
+
+  std::vector<Node> bad_dests{1, 3, 0};
+  katana::GraphTopology bad_dest(
+      adj_indices.data(), adj_indices.size(), bad_dests.data(),
+      bad_dests.size());
+  KATANA_LOG_ASSERT(!bad_dest.Validate());
+  KATANA_LOG_ASSERT(bad_dest.Fingerprint() != good.Fingerprint());
+
+  std::vector<Edge> bad_indices{2, 1, 3};
+  katana::GraphTopology bad_offsets(
+      bad_indices.data(), bad_indices.size(), dests.data(), dests.size());
+  KATANA_LOG_ASSERT(!bad_offsets.Validate());
+}
+
 int
 main() {
   katana::SharedMemSys sys;
@@ -280,5 +308,15 @@ main() {
   KATANA_LOG_VASSERT(
       g1->ReportDiff(g3.get()) == out3, "{}{}", g1->ReportDiff(g3.get()), out3);
 
+  KATANA_LOG_ASSERT(g1->Validate());
+  auto g1_again = CreateGraph1();
+  KATANA_LOG_ASSERT(g1->Equals(g1_again.get()));
+  auto fingerprint1 = g1->Fingerprint().value();
+  KATANA_LOG_ASSERT(g1_again->Fingerprint().value() == fingerprint1);
+  KATANA_LOG_ASSERT(g2->Fingerprint().value() != fingerprint1);
+  KATANA_LOG_ASSERT(g3->Fingerprint().value() != fingerprint1);
+
+  TestValidateTopology();
+
   return 0;
 }
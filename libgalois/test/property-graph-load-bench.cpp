@@ -0,0 +1,295 @@
+/// Benchmarks loading a property graph from storage and committing it back,
+/// one phase at a time: reading the manifest, fetching the topology,
+/// fetching and decoding the properties, making the graph from the RDG,
+/// constructing its entity types and building a view, then committing it
+/// unchanged and with a modified property. Loads a generated R-MAT graph
+/// unless -rdg is given and writes the median time of each phase as JSON.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+#include <llvm/Support/CommandLine.h>
+#include <nlohmann/json.hpp>
+
+#include "katana/Galois.h"
+#include "katana/GraphGenerators.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/Time.h"
+#include "katana/URI.h"
+#include "tsuba/RDG.h"
+#include "tsuba/tsuba.h"
+
+namespace cll = llvm::cl;
+namespace fs = boost::filesystem;
+
+static cll::opt<std::string> rdgName(
+    "rdg",
+    cll::desc("RDG to load instead of a generated one; it is committed to "
+              "unless -noCommit is given"),
+    cll::init(""));
+static cll::opt<uint32_t> scale(
+    "scale", cll::desc("log2 of the number of nodes (default value 16)"),
+    cll::init(16));
+static cll::opt<uint32_t> edgeFactor(
+    "edgeFactor", cll::desc("edges per node (default value 8)"),
+    cll::init(8));
+static cll::opt<int> numNodeProperties(
+    "nodeProperties", cll::desc("node properties (default value 4)"),
+    cll::init(4));
+static cll::opt<int> numEdgeProperties(
+    "edgeProperties", cll::desc("edge properties (default value 4)"),
+    cll::init(4));
+static cll::opt<int> numTypeProperties(
+    "typeProperties",
+    cll::desc("boolean node properties that are node types (default value 2)"),
+    cll::init(2));
+static cll::opt<unsigned> samples(
+    "samples", cll::desc("loads of the graph (default value 3)"),
+    cll::init(3));
+static cll::opt<bool> noCommit(
+    "noCommit", cll::desc("only time loading"), cll::init(false));
+static cll::opt<int> numThreads(
+    "t", cll::desc("number of threads (default value: all)"), cll::init(0));
+static cll::opt<std::string> jsonFile(
+    "json", cll::desc("file to write results to (default value: stdout)"),
+    cll::init(""));
+
+namespace {
+
+/// Seconds spent in each phase of one sample, in the order of the phases
+class PhaseTimer {
+public:
+  /// End the current phase, if any, and start phase \param name
+  void Next(const std::string& name) {
+    Stop();
+    name_ = name;
+    start_ = katana::Now();
+  }
+
+  /// End the current phase
+  void Stop() {
+    if (name_.empty()) {
+      return;
+    }
+    std::chrono::duration<double> elapsed = katana::Now() - start_;
+    seconds_.emplace_back(name_, elapsed.count());
+    name_.clear();
+  }
+
+  const std::vector<std::pair<std::string, double>>& seconds() const {
+    return seconds_;
+  }
+
+private:
+  std::string name_;
+  katana::TimePoint start_;
+  std::vector<std::pair<std::string, double>> seconds_;
+};
+
+/// Node types are derived from boolean node properties
+katana::Result<std::shared_ptr<arrow::Table>>
+MakeTypeProperties(uint64_t num_nodes, int num_types) {
+  arrow::FieldVector fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (int t = 0; t < num_types; ++t) {
+    arrow::BooleanBuilder builder;
+    KATANA_CHECKED(builder.Reserve(num_nodes));
+    for (uint64_t n = 0; n < num_nodes; ++n) {
+      builder.UnsafeAppend(n % num_types == static_cast<uint64_t>(t));
+    }
+    columns.emplace_back(KATANA_CHECKED(builder.Finish()));
+    fields.emplace_back(
+        arrow::field(fmt::format("type{}", t), arrow::boolean()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+katana::Result<void>
+GenerateRDG(const std::string& rdg_dir) {
+  katana::RMATParams params;
+  params.scale = scale;
+  params.edge_factor = edgeFactor;
+  auto pg = KATANA_CHECKED(katana::PropertyGraph::Make(
+      KATANA_CHECKED(katana::GenerateRMAT(params, 0))));
+
+  if (numNodeProperties > 0) {
+    KATANA_CHECKED(pg->AddNodeProperties(
+        KATANA_CHECKED(katana::GenerateRandomProperties(
+            pg->num_nodes(), numNodeProperties, "node", arrow::int64(), 1))));
+  }
+  if (numTypeProperties > 0) {
+    auto types =
+        KATANA_CHECKED(MakeTypeProperties(pg->num_nodes(), numTypeProperties));
+    KATANA_CHECKED(pg->AddNodeProperties(types));
+  }
+  if (numEdgeProperties > 0) {
+    KATANA_CHECKED(pg->AddEdgeProperties(
+        KATANA_CHECKED(katana::GenerateRandomProperties(
+            pg->num_edges(), numEdgeProperties, "edge", arrow::int64(), 2))));
+  }
+
+  KATANA_CHECKED_CONTEXT(
+      pg->Write(rdg_dir, "property-graph-load-bench"), "writing {}", rdg_dir);
+  katana::gInfo(
+      "Generated ", pg->num_nodes(), " nodes and ", pg->num_edges(),
+      " edges in ", rdg_dir);
+  return katana::ResultSuccess();
+}
+
+/// Load the graph phase by phase, the way PropertyGraph::Make does, and
+/// commit it
+katana::Result<void>
+Sample(const std::string& rdg_dir, PhaseTimer* timer) {
+  timer->Next("manifest");
+  auto handle = KATANA_CHECKED(tsuba::Open(rdg_dir, tsuba::kReadWrite));
+  auto file = std::make_unique<tsuba::RDGFile>(handle);
+
+  // the part header and the topology, without any property
+  timer->Next("topology");
+  tsuba::RDGLoadOptions opts;
+  opts.node_properties = std::vector<std::string>();
+  opts.edge_properties = std::vector<std::string>();
+  tsuba::RDG rdg = KATANA_CHECKED(tsuba::RDG::Make(*file, opts));
+
+  // prefetching first reads and decodes the property files concurrently,
+  // like a load of all properties
+  timer->Next("properties");
+  std::vector<std::string> node_names = rdg.full_node_schema()->field_names();
+  std::vector<std::string> edge_names = rdg.full_edge_schema()->field_names();
+  KATANA_CHECKED(rdg.PrefetchNodeProperties(node_names));
+  KATANA_CHECKED(rdg.PrefetchEdgeProperties(edge_names));
+  for (const auto& name : node_names) {
+    KATANA_CHECKED_CONTEXT(
+        rdg.LoadNodeProperty(name), "loading node property {}", name);
+  }
+  for (const auto& name : edge_names) {
+    KATANA_CHECKED_CONTEXT(
+        rdg.LoadEdgeProperty(name), "loading edge property {}", name);
+  }
+
+  // mapping and compacting the topology
+  timer->Next("make_graph");
+  auto pg = KATANA_CHECKED(
+      katana::PropertyGraph::Make(std::move(file), std::move(rdg)));
+
+  timer->Next("entity_types");
+  KATANA_CHECKED(pg->ConstructEntityTypeIDs());
+
+  timer->Next("view");
+  pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+
+  if (noCommit) {
+    timer->Stop();
+    return katana::ResultSuccess();
+  }
+
+  // only the metadata is rewritten
+  timer->Next("commit_unchanged");
+  KATANA_CHECKED(pg->Commit("property-graph-load-bench"));
+
+  timer->Next("modify_property");
+  std::shared_ptr<arrow::Table> props;
+  if (pg->GetNumNodeProperties() > 0) {
+    props = KATANA_CHECKED(pg->node_properties()->SelectColumns({0}));
+  } else {
+    props = KATANA_CHECKED(katana::GenerateRandomProperties(
+        pg->num_nodes(), 1, "node", arrow::int64(), 1));
+  }
+  KATANA_CHECKED(pg->UpsertNodeProperties(props));
+
+  timer->Next("commit_modified");
+  KATANA_CHECKED(pg->Commit("property-graph-load-bench"));
+  timer->Stop();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<nlohmann::json>
+Run() {
+  std::string rdg_dir = rdgName;
+  if (rdg_dir.empty()) {
+    auto uri = KATANA_CHECKED(katana::Uri::MakeRand("/tmp/loadbench"));
+    rdg_dir = uri.path();  // path() because local
+    KATANA_CHECKED(GenerateRDG(rdg_dir));
+  }
+
+  std::vector<PhaseTimer> timers(samples);
+  for (auto& timer : timers) {
+    KATANA_CHECKED_CONTEXT(Sample(rdg_dir, &timer), "loading {}", rdg_dir);
+  }
+
+  if (rdgName.empty()) {
+    fs::remove_all(rdg_dir);
+  }
+
+  nlohmann::json phases = nlohmann::json::array();
+  std::vector<double> totals(samples);
+  const auto& first = timers.front().seconds();
+  for (size_t p = 0; p < first.size(); ++p) {
+    std::vector<double> seconds;
+    for (size_t s = 0; s < timers.size(); ++s) {
+      seconds.emplace_back(timers[s].seconds()[p].second);
+      totals[s] += timers[s].seconds()[p].second;
+    }
+    std::sort(seconds.begin(), seconds.end());
+    phases.emplace_back(nlohmann::json{
+        {"name", first[p].first},
+        {"median_seconds", seconds[seconds.size() / 2]},
+        {"min_seconds", seconds.front()},
+        {"max_seconds", seconds.back()},
+    });
+  }
+  std::sort(totals.begin(), totals.end());
+
+  return nlohmann::json{
+      {"rdg", rdgName.empty() ? "generated" : rdgName.getValue()},
+      {"threads", katana::getActiveThreads()},
+      {"samples", samples.getValue()},
+      {"phases", phases},
+      {"median_total_seconds", totals[totals.size() / 2]},
+  };
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+  if (numThreads > 0) {
+    katana::setActiveThreads(numThreads);
+  } else {
+    katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+  }
+  if (samples == 0) {
+    KATANA_LOG_FATAL("-samples must be positive");
+  }
+
+  auto report = Run();
+  if (!report) {
+    KATANA_LOG_FATAL("benchmark failed: {}", report.error());
+  }
+  auto json_res = katana::JsonDump(report.value());
+  KATANA_LOG_ASSERT(json_res);
+  if (jsonFile.empty()) {
+    std::cout << json_res.value() << "\n";
+  } else {
+    std::ofstream out(jsonFile);
+    out << json_res.value() << "\n";
+    KATANA_LOG_ASSERT(out);
+  }
+
+  return 0;
+}
@@ -10,7 +10,11 @@
 template <typename node_or_edge>
 struct NodeOrEdge {
   static katana::Result<katana::PropertyIndex<node_or_edge>*> MakeIndex(
-      katana::PropertyGraph* pg, const std::string& column_name);
+      katana::PropertyGraph* pg, const std::string& column_name,
+      katana::PropertyIndexKind kind);
+  static katana::Result<katana::CompositePropertyIndex<node_or_edge>*>
+  MakeCompositeIndex(
+      katana::PropertyGraph* pg, const std::vector<std::string>& column_names);
   static katana::Result<void> AddProperties(
       katana::PropertyGraph* pg, std::shared_ptr<arrow::Table> properties);
   static size_t num_entities(katana::PropertyGraph* pg);
@@ -21,8 +25,10 @@ using Edge = NodeOrEdge<katana::GraphTopology::Edge>;
 
 template <>
 katana::Result<katana::PropertyIndex<katana::GraphTopology::Node>*>
-Node::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
-  auto result = pg->MakeNodeIndex(column_name);
+Node::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& column_name,
+    katana::PropertyIndexKind kind) {
+  auto result = pg->MakeNodeIndex(column_name, kind);
   if (!result) {
     return result.error();
   }
@@ -38,8 +44,10 @@ Node::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
 
 template <>
 katana::Result<katana::PropertyIndex<katana::GraphTopology::Edge>*>
-Edge::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
-  auto result = pg->MakeEdgeIndex(column_name);
+Edge::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& column_name,
+    katana::PropertyIndexKind kind) {
+  auto result = pg->MakeEdgeIndex(column_name, kind);
   if (!result) {
     return result.error();
   }
@@ -53,6 +61,28 @@ Edge::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
   return KATANA_ERROR(katana::ErrorCode::NotFound, "Created index not found");
 }
 
+template <>
+katana::Result<katana::CompositePropertyIndex<katana::GraphTopology::Node>*>
+Node::MakeCompositeIndex(
+    katana::PropertyGraph* pg, const std::vector<std::string>& column_names) {
+  auto result = pg->MakeNodeCompositeIndex(column_names);
+  if (!result) {
+    return result.error();
+  }
+  return pg->node_composite_indexes().back().get();
+}
+
+template <>
+katana::Result<katana::CompositePropertyIndex<katana::GraphTopology::Edge>*>
+Edge::MakeCompositeIndex(
+    katana::PropertyGraph* pg, const std::vector<std::string>& column_names) {
+  auto result = pg->MakeEdgeCompositeIndex(column_names);
+  if (!result) {
+    return result.error();
+  }
+  return pg->edge_composite_indexes().back().get();
+}
+
 template <>
 size_t
 Node::num_entities(katana::PropertyGraph* pg) {
@@ -131,7 +161,8 @@ CreateStringProperty(const std::string& name, bool uniform, size_t num_rows) {
 
 template <typename node_or_edge, typename DataType>
 void
-TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
+TestPrimitiveIndex(
+    size_t num_nodes, size_t line_width, katana::PropertyIndexKind kind) {
   using IndexType = katana::PrimitivePropertyIndex<node_or_edge, DataType>;
   using ArrayType = typename arrow::CTypeTraits<DataType>::ArrayType;
 
@@ -152,12 +183,12 @@ TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
       NodeOrEdge<node_or_edge>::AddProperties(g.get(), nonuniform_prop));
 
   auto uniform_index_result =
-      NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "uniform");
+      NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "uniform", kind);
   KATANA_LOG_VASSERT(
       uniform_index_result, "Could not create index: {}",
       uniform_index_result.error());
   auto nonuniform_index_result =
-      NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "nonuniform");
+      NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "nonuniform", kind);
   KATANA_LOG_VASSERT(
       nonuniform_index_result, "Could not create index: {}",
       nonuniform_index_result.error());
@@ -189,6 +220,12 @@ TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
   // The non-uniform index starts at 42 and increases by 2.
   auto typed_prop =
       std::static_pointer_cast<ArrayType>(nonuniform_prop->column(0)->chunk(0));
+  KATANA_LOG_ASSERT(nonuniform_index->size() == num_entities);
+  for (node_or_edge id = 0; id < num_entities; ++id) {
+    it = nonuniform_index->Find(typed_prop->Value(id));
+    KATANA_LOG_VASSERT(
+        it != nonuniform_index->end() && *it == id, "Not found: {}", id);
+  }
   it = nonuniform_index->Find(43);
   KATANA_LOG_ASSERT(it == nonuniform_index->end());
   it = nonuniform_index->LowerBound(43);
@@ -201,7 +238,8 @@ TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
 
 template <typename node_or_edge>
 void
-TestStringIndex(size_t num_nodes, size_t line_width) {
+TestStringIndex(
+    size_t num_nodes, size_t line_width, katana::PropertyIndexKind kind) {
   using IndexType = katana::StringPropertyIndex<node_or_edge>;
   using ArrayType = arrow::LargeStringArray;
 
@@ -220,12 +258,12 @@ TestStringIndex(size_t num_nodes, size_t line_width) {
       NodeOrEdge<node_or_edge>::AddProperties(g.get(), nonuniform_prop));
 
   auto uniform_index_result =
-      NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "uniform");
+      NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "uniform", kind);
   KATANA_LOG_VASSERT(
       uniform_index_result, "Could not create index: {}",
       uniform_index_result.error());
   auto nonuniform_index_result =
-      NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "nonuniform");
+      NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "nonuniform", kind);
   KATANA_LOG_VASSERT(
       nonuniform_index_result, "Could not create index: {}",
       nonuniform_index_result.error());
@@ -265,17 +303,112 @@ TestStringIndex(size_t num_nodes, size_t line_width) {
   KATANA_LOG_ASSERT(typed_prop->GetView(*it) == "aaam");
 }
 
+template <typename node_or_edge>
+std::vector<node_or_edge>
+ToVector(
+    const katana::Result<
+        typename katana::CompositePropertyIndex<node_or_edge>::IdRange>& res) {
+  KATANA_LOG_VASSERT(res, "range failed: {}", res.error());
+  auto range = res.value();
+  return std::vector<node_or_edge>(range.begin(), range.end());
+}
+
+template <typename node_or_edge>
+void
+TestCompositeIndex(size_t num_nodes, size_t line_width) {
+  LinePolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int>(num_nodes, 0, &policy);
+  size_t num_entities = NodeOrEdge<node_or_edge>::num_entities(g.get());
+  KATANA_LOG_ASSERT(num_entities > 10);
+
+  // group is id % 3 and rank is id, except that entity 1 has no rank
+  arrow::Int64Builder group_builder;
+  arrow::DoubleBuilder rank_builder;
+  for (size_t i = 0; i < num_entities; ++i) {
+    KATANA_LOG_ASSERT(group_builder.Append(i % 3).ok());
+    if (i == 1) {
+      KATANA_LOG_ASSERT(rank_builder.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(rank_builder.Append(i).ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> group;
+  std::shared_ptr<arrow::Array> rank;
+  KATANA_LOG_ASSERT(group_builder.Finish(&group).ok());
+  KATANA_LOG_ASSERT(rank_builder.Finish(&rank).ok());
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(), arrow::Table::Make(
+                   arrow::schema(
+                       {arrow::field("group", arrow::int64()),
+                        arrow::field("rank", arrow::float64())}),
+                   {group, rank})));
+
+  auto index_result = NodeOrEdge<node_or_edge>::MakeCompositeIndex(
+      g.get(), {"group", "rank"});
+  KATANA_LOG_VASSERT(
+      index_result, "Could not create index: {}", index_result.error());
+  auto* index = index_result.value();
+  KATANA_LOG_ASSERT(index->column_name() == "group,rank");
+  KATANA_LOG_ASSERT(index->size() == num_entities - 1);
+
+  auto scalar = [](auto value) { return arrow::MakeScalar(value); };
+
+  // entities of group 1 in order of rank; 1 is not indexed
+  std::vector<node_or_edge> group_one =
+      ToVector<node_or_edge>(index->EqualRange({scalar(int64_t{1})}));
+  std::vector<node_or_edge> expected;
+  for (size_t i = 4; i < num_entities; i += 3) {
+    expected.emplace_back(i);
+  }
+  KATANA_LOG_ASSERT(group_one == expected);
+
+  // integer keys are cast to the type of rank
+  KATANA_LOG_ASSERT(
+      ToVector<node_or_edge>(index->Range(
+          {scalar(int64_t{1})}, scalar(int64_t{4}), scalar(10.0))) ==
+      std::vector<node_or_edge>({4, 7, 10}));
+  KATANA_LOG_ASSERT(
+      ToVector<node_or_edge>(
+          index->Range({scalar(int64_t{2})}, nullptr, scalar(5.5))) ==
+      std::vector<node_or_edge>({2, 5}));
+  KATANA_LOG_ASSERT(
+      ToVector<node_or_edge>(
+          index->EqualRange({scalar(int64_t{0}), scalar(6.0)})) ==
+      std::vector<node_or_edge>({6}));
+  KATANA_LOG_ASSERT(ToVector<node_or_edge>(
+                        index->Range(
+                            {scalar(int64_t{0})}, scalar(6.0), scalar(3.0)))
+                        .empty());
+  KATANA_LOG_ASSERT(
+      ToVector<node_or_edge>(index->EqualRange({})).size() == index->size());
+
+  KATANA_LOG_ASSERT(!index->EqualRange(
+      {scalar(int64_t{0}), scalar(6.0), scalar(int64_t{0})}));
+  KATANA_LOG_ASSERT(!index->Range(
+      {scalar(int64_t{0}), scalar(6.0)}, nullptr, nullptr));
+  KATANA_LOG_ASSERT(!NodeOrEdge<node_or_edge>::MakeCompositeIndex(
+      g.get(), {"group", "rank"}));
+}
+
 int
 main() {
   katana::SharedMemSys S;
 
-  TestPrimitiveIndex<katana::GraphTopology::Node, int64_t>(10, 3);
-  TestPrimitiveIndex<katana::GraphTopology::Edge, int64_t>(10, 3);
-  TestPrimitiveIndex<katana::GraphTopology::Node, double_t>(10, 3);
-  TestPrimitiveIndex<katana::GraphTopology::Edge, double_t>(10, 3);
+  for (auto kind :
+       {katana::PropertyIndexKind::kSorted, katana::PropertyIndexKind::kHash}) {
+    TestPrimitiveIndex<katana::GraphTopology::Node, int64_t>(10, 3, kind);
+    TestPrimitiveIndex<katana::GraphTopology::Edge, int64_t>(10, 3, kind);
+    TestPrimitiveIndex<katana::GraphTopology::Node, double_t>(10, 3, kind);
+    TestPrimitiveIndex<katana::GraphTopology::Edge, double_t>(10, 3, kind);
+
+    TestStringIndex<katana::GraphTopology::Node>(10, 3, kind);
+    TestStringIndex<katana::GraphTopology::Edge>(10, 3, kind);
+  }
 
-  TestStringIndex<katana::GraphTopology::Node>(10, 3);
-  TestStringIndex<katana::GraphTopology::Edge>(10, 3);
+  TestCompositeIndex<katana::GraphTopology::Node>(20, 3);
+  TestCompositeIndex<katana::GraphTopology::Edge>(20, 3);
 
   return 0;
 }
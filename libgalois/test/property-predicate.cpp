@@ -0,0 +1,208 @@
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/PropertyPredicate.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
+
+namespace {
+
+// More than one block of rows
+constexpr size_t kNumNodes = 150000;
+
+/// The score of a node, which is null for every 13th node
+std::optional<int64_t>
+Score(size_t node) {
+  if (node % 13 == 0) {
+    return std::nullopt;
+  }
+  return static_cast<int64_t>(node % 100);
+}
+
+/// Node properties "score" and "rank", where "rank" is in two chunks
+std::shared_ptr<arrow::Table>
+MakeNodeProperties() {
+  arrow::Int64Builder score;
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    if (auto value = Score(n)) {
+      KATANA_LOG_ASSERT(score.Append(value.value()).ok());
+    } else {
+      KATANA_LOG_ASSERT(score.AppendNull().ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> score_array;
+  KATANA_LOG_ASSERT(score.Finish(&score_array).ok());
+
+  std::vector<std::shared_ptr<arrow::Array>> rank_chunks;
+  for (size_t begin : {size_t{0}, kNumNodes / 3}) {
+    size_t end = begin == 0 ? kNumNodes / 3 : kNumNodes;
+    arrow::UInt32Builder rank;
+    for (size_t n = begin; n < end; ++n) {
+      KATANA_LOG_ASSERT(rank.Append(n).ok());
+    }
+    std::shared_ptr<arrow::Array> rank_array;
+    KATANA_LOG_ASSERT(rank.Finish(&rank_array).ok());
+    rank_chunks.emplace_back(rank_array);
+  }
+
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("score", arrow::int64()),
+           arrow::field("rank", arrow::uint32())}),
+      {std::make_shared<arrow::ChunkedArray>(score_array),
+       std::make_shared<arrow::ChunkedArray>(rank_chunks)});
+}
+
+/// Edge properties "heavy", which is set on every third edge, and "light"
+std::shared_ptr<arrow::Table>
+MakeEdgeProperties(size_t num_edges) {
+  arrow::BooleanBuilder heavy;
+  arrow::BooleanBuilder light;
+  for (size_t e = 0; e < num_edges; ++e) {
+    KATANA_LOG_ASSERT(heavy.Append(e % 3 == 0).ok());
+    KATANA_LOG_ASSERT(light.Append(e % 3 != 0).ok());
+  }
+  std::shared_ptr<arrow::Array> heavy_array;
+  std::shared_ptr<arrow::Array> light_array;
+  KATANA_LOG_ASSERT(heavy.Finish(&heavy_array).ok());
+  KATANA_LOG_ASSERT(light.Finish(&light_array).ok());
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("heavy", arrow::boolean()),
+           arrow::field("light", arrow::boolean())}),
+      {heavy_array, light_array});
+}
+
+template <typename Expected>
+void
+CheckSelection(
+    const katana::DynamicBitset& selection, size_t size,
+    const Expected& expected) {
+  KATANA_LOG_ASSERT(selection.size() == size);
+  size_t num_selected = 0;
+  for (size_t i = 0; i < size; ++i) {
+    KATANA_LOG_VASSERT(
+        selection.test(i) == expected(i), "row {} is selected wrongly", i);
+    num_selected += expected(i);
+  }
+  KATANA_LOG_ASSERT(selection.count() == num_selected);
+}
+
+void
+TestSelectNodes(const katana::PropertyGraph& pg) {
+  auto selection = katana::SelectNodes(
+      pg, {{"score", katana::CompareOp::kGreaterEqual,
+            arrow::MakeScalar(int64_t{50})},
+           {"score", katana::CompareOp::kLess, arrow::MakeScalar(int64_t{80})},
+           {"rank", katana::CompareOp::kNotEqual,
+            arrow::MakeScalar(uint32_t{kNumNodes / 3 + 1})}});
+  KATANA_LOG_VASSERT(selection, "selecting: {}", selection.error());
+  CheckSelection(selection.value(), kNumNodes, [](size_t n) {
+    auto score = Score(n);
+    return score && score.value() >= 50 && score.value() < 80 &&
+           n != kNumNodes / 3 + 1;
+  });
+
+  auto all = katana::SelectNodes(pg, {});
+  KATANA_LOG_ASSERT(all && all.value().count() == kNumNodes);
+
+  auto missing = katana::SelectNodes(
+      pg, {{"missing", katana::CompareOp::kEqual,
+            arrow::MakeScalar(int64_t{0})}});
+  KATANA_LOG_ASSERT(
+      !missing && missing.error() == katana::ErrorCode::PropertyNotFound);
+  auto mistyped = katana::SelectNodes(
+      pg, {{"score", katana::CompareOp::kEqual,
+            arrow::MakeScalar(std::string("high"))}});
+  KATANA_LOG_ASSERT(!mistyped);
+}
+
+void
+TestSelectEdges(const katana::PropertyGraph& pg) {
+  auto heavy = katana::SelectEdges(
+      pg, {{"heavy", katana::CompareOp::kEqual, arrow::MakeScalar(true)}});
+  KATANA_LOG_ASSERT(heavy);
+  auto is_heavy = [](size_t e) { return e % 3 == 0; };
+  CheckSelection(heavy.value(), pg.num_edges(), is_heavy);
+
+  auto heavy_id = pg.GetEdgeTypeManager().GetEntityTypeID("heavy");
+  CheckSelection(
+      katana::SelectEdgesOfType(pg, heavy_id), pg.num_edges(), is_heavy);
+}
+
+/// Selections give the same sub-graphs as the node ids they select
+void
+TestSubGraph(katana::PropertyGraph* pg) {
+  auto nodes = katana::SelectNodes(
+      *pg,
+      {{"rank", katana::CompareOp::kLess, arrow::MakeScalar(uint32_t{1000})}});
+  KATANA_LOG_ASSERT(nodes);
+  std::vector<uint32_t> node_vec;
+  for (uint32_t n = 0; n < 1000; ++n) {
+    node_vec.emplace_back(n);
+  }
+
+  auto expected = katana::analytics::SubGraphSelect(pg, node_vec);
+  auto selected =
+      katana::analytics::SubGraphSelect(pg, nodes.value(), nullptr);
+  KATANA_LOG_ASSERT(expected && selected);
+  KATANA_LOG_ASSERT(selected.value().nodes == expected.value().nodes);
+  KATANA_LOG_ASSERT(selected.value().edges == expected.value().edges);
+
+  // only the selected edges are in the sub-graph
+  auto edges = katana::SelectEdges(
+      *pg,
+      {{"light", katana::CompareOp::kEqual, arrow::MakeScalar(true)}});
+  KATANA_LOG_ASSERT(edges);
+  auto light =
+      katana::analytics::SubGraphSelect(pg, nodes.value(), &edges.value());
+  KATANA_LOG_ASSERT(light);
+  KATANA_LOG_ASSERT(light.value().num_edges() > 0);
+  KATANA_LOG_ASSERT(
+      light.value().num_edges() < expected.value().num_edges());
+  for (auto e : light.value().edges) {
+    KATANA_LOG_ASSERT(e % 3 != 0);
+  }
+
+  auto subgraph = katana::analytics::SubGraphExtraction(
+      pg, nodes.value(), &edges.value(), {"score"}, {"heavy"});
+  KATANA_LOG_ASSERT(subgraph);
+  KATANA_LOG_ASSERT(subgraph.value()->num_nodes() == 1000);
+  KATANA_LOG_ASSERT(
+      subgraph.value()->num_edges() == light.value().num_edges());
+
+  katana::DynamicBitset wrong_size;
+  wrong_size.resize(10);
+  KATANA_LOG_ASSERT(
+      !katana::analytics::SubGraphSelect(pg, wrong_size, nullptr));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy policy{2};
+  auto pg = MakeFileGraph<uint32_t>(kNumNodes, 1, &policy);
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(MakeNodeProperties()));
+  KATANA_LOG_ASSERT(
+      pg->AddEdgeProperties(MakeEdgeProperties(pg->num_edges())));
+  KATANA_LOG_ASSERT(pg->ConstructEntityTypeIDs());
+
+  TestSelectNodes(*pg);
+  TestSelectEdges(*pg);
+  TestSubGraph(pg.get());
+
+  return 0;
+}
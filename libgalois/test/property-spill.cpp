@@ -0,0 +1,78 @@
+#include <cstdlib>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+// Each int64_t column is 2 MiB, and graphs keep 3 MiB in memory
+constexpr size_t kNumNodes = 256 << 10;
+
+std::shared_ptr<arrow::Table>
+MakeProps(const std::string& name) {
+  katana::TableBuilder builder{kNumNodes};
+
+  katana::ColumnOptions options;
+  options.name = name;
+  options.ascending_values = true;
+  builder.AddColumn<int64_t>(options);
+  return builder.Finish();
+}
+
+void
+TestSpillLeastRecentlyUsed(const std::string& spill_dir) {
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  auto a = MakeProps("a");
+  KATANA_LOG_ASSERT(g->AddNodeProperties(a));
+  KATANA_LOG_ASSERT(!g->IsNodePropertySpilled("a"));
+
+  KATANA_LOG_ASSERT(g->AddNodeProperties(MakeProps("b")));
+  KATANA_LOG_ASSERT(g->IsNodePropertySpilled("a"));
+  KATANA_LOG_ASSERT(!g->IsNodePropertySpilled("b"));
+  KATANA_LOG_ASSERT(g->GetNodeProperty("a")->Equals(*a->column(0)));
+
+  // a is used after b, so b is spilled next
+  KATANA_LOG_ASSERT(g->EnsureNodePropertyLoaded("a"));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(MakeProps("c")));
+  KATANA_LOG_ASSERT(g->IsNodePropertySpilled("b"));
+  KATANA_LOG_ASSERT(!g->IsNodePropertySpilled("c"));
+
+  // Upserting brings a back into memory
+  KATANA_LOG_ASSERT(g->UpsertNodeProperties(MakeProps("a")));
+  KATANA_LOG_ASSERT(!g->IsNodePropertySpilled("a"));
+  KATANA_LOG_ASSERT(g->IsNodePropertySpilled("c"));
+  KATANA_LOG_ASSERT(g->GetNumNodeProperties() == 3);
+
+  // Spill files are unlinked once mapped
+  KATANA_LOG_ASSERT(fs::is_empty(spill_dir));
+}
+
+}  // namespace
+
+int
+main() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyspill");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string spill_dir(uri_res.value().path());
+  setenv("KATANA_TSUBA_SPILL_DIR", spill_dir.c_str(), 1);
+  setenv("KATANA_TSUBA_SPILL_MEMORY_MB", "3", 1);
+
+  {
+    katana::SharedMemSys sys;
+
+    TestSpillLeastRecentlyUsed(spill_dir);
+  }
+
+  fs::remove_all(spill_dir);
+  return 0;
+}
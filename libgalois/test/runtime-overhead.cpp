@@ -0,0 +1,280 @@
+/// Benchmarks the fixed cost of the runtime: empty loops, with the threads
+/// of the pool sleeping or spinning between them, barriers and waking the
+/// thread pool, at 1 to N threads. Writes the median time of each operation
+/// as JSON and fails if one exceeds its threshold, to catch regressions of
+/// services that run many small loops per second.
+///
+/// The thresholds are wall-clock times, so this is registered as a
+/// NOT_QUICK test, which the quick set run by CI excludes.
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <llvm/Support/CommandLine.h>
+#include <nlohmann/json.hpp>
+
+#include "katana/Barrier.h"
+#include "katana/Galois.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/StableIterator.h"
+#include "katana/ThreadPool.h"
+#include "katana/Time.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<unsigned> rounds(
+    "rounds", cll::desc("operations per sample (default value 1000)"),
+    cll::init(1000));
+static cll::opt<unsigned> samples(
+    "samples", cll::desc("samples of each operation (default value 5)"),
+    cll::init(5));
+static cll::opt<unsigned> maxThreads(
+    "maxThreads",
+    cll::desc("largest thread count (default value: usable threads)"),
+    cll::init(0));
+static cll::opt<unsigned> sleepUs(
+    "sleepUs",
+    cll::desc("idle time before waking the thread pool (default value 2000)"),
+    cll::init(2000));
+static cll::opt<double> maxLoopUs(
+    "maxLoopUs",
+    cll::desc("threshold for an empty loop in microseconds (default value "
+              "1000)"),
+    cll::init(1000));
+static cll::opt<double> maxBarrierUs(
+    "maxBarrierUs",
+    cll::desc("threshold for a barrier wait in microseconds (default value "
+              "1000)"),
+    cll::init(1000));
+static cll::opt<double> maxWakeupUs(
+    "maxWakeupUs",
+    cll::desc("threshold for waking the thread pool in microseconds (default "
+              "value 10000)"),
+    cll::init(10000));
+static cll::opt<std::string> jsonFile(
+    "json", cll::desc("file to write results to (default value: stdout)"),
+    cll::init(""));
+
+namespace {
+
+/// Empty loop bodies that the compiler cannot remove
+struct Empty {
+  template <typename T>
+  void operator()(const T&) const {
+    katana::compilerBarrier();
+  }
+  template <typename T, typename C>
+  void operator()(const T&, const C&) const {
+    katana::compilerBarrier();
+  }
+};
+
+/// \returns the nanoseconds \param fn takes
+uint64_t
+TimeNs(const std::function<void()>& fn) {
+  katana::TimePoint start = katana::Now();
+  fn();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             katana::Now() - start)
+      .count();
+}
+
+class Suite {
+public:
+  /// Take samples of \param ops operations each and record the median time
+  /// per operation. \param sample returns the nanoseconds it spent on the
+  /// operations.
+  void Measure(
+      const std::string& name, unsigned threads, double threshold_us,
+      uint64_t ops, const std::function<uint64_t()>& sample) {
+    std::vector<double> ns_per_op;
+    for (unsigned s = 0; s < samples; ++s) {
+      ns_per_op.emplace_back(static_cast<double>(sample()) / ops);
+    }
+    std::sort(ns_per_op.begin(), ns_per_op.end());
+    double median_ns = ns_per_op[ns_per_op.size() / 2];
+
+    bool passed = median_ns <= threshold_us * 1000;
+    if (!passed) {
+      KATANA_LOG_ERROR(
+          "{} with {} threads took {:.0f} ns, over threshold of {} us", name,
+          threads, median_ns, threshold_us);
+      failed_ = true;
+    }
+    results_.emplace_back(nlohmann::json{
+        {"name", name},
+        {"threads", threads},
+        {"median_ns", median_ns},
+        {"min_ns", ns_per_op.front()},
+        {"max_ns", ns_per_op.back()},
+        {"threshold_ns", threshold_us * 1000},
+        {"passed", passed},
+    });
+  }
+
+  /// Like Measure for samples that are timed as a whole
+  void MeasureLoop(
+      const std::string& name, unsigned threads, double threshold_us,
+      const std::function<void()>& op) {
+    Measure(name, threads, threshold_us, rounds, [&] {
+      return TimeNs([&] {
+        for (unsigned r = 0; r < rounds; ++r) {
+          op();
+        }
+      });
+    });
+  }
+
+  bool failed() const { return failed_; }
+  const nlohmann::json& results() const { return results_; }
+
+private:
+  nlohmann::json results_ = nlohmann::json::array();
+  bool failed_{false};
+};
+
+void
+MeasureLoops(Suite* suite, unsigned threads) {
+  suite->MeasureLoop("do_all", threads, maxLoopUs, [&] {
+    katana::do_all(katana::iterate(0U, threads), Empty(), katana::no_stats());
+  });
+
+  suite->MeasureLoop("do_all_steal", threads, maxLoopUs, [&] {
+    katana::do_all(
+        katana::iterate(0U, threads), Empty(), katana::steal(),
+        katana::no_stats());
+  });
+
+  suite->MeasureLoop("for_each", threads, maxLoopUs, [&] {
+    katana::for_each(
+        katana::iterate(0U, threads), Empty(), katana::no_pushes(),
+        katana::disable_conflict_detection(), katana::no_stats());
+  });
+
+  suite->MeasureLoop("for_each_stable", threads, maxLoopUs, [&] {
+    katana::for_each(
+        katana::iterate(0U, threads), Empty(), katana::no_pushes(),
+        katana::disable_conflict_detection(),
+        katana::wl<katana::StableIterator<>>(), katana::no_stats());
+  });
+
+  suite->MeasureLoop("on_each", threads, maxLoopUs, [] {
+    katana::on_each([](unsigned, unsigned) { katana::compilerBarrier(); });
+  });
+}
+
+/// Like MeasureLoops while the threads of the pool spin between loops
+/// instead of waiting to be woken up
+void
+MeasureBurningLoops(Suite* suite, unsigned threads) {
+  katana::GetThreadPool().burnPower(threads);
+
+  suite->MeasureLoop("do_all_burn", threads, maxLoopUs, [&] {
+    katana::do_all(katana::iterate(0U, threads), Empty(), katana::no_stats());
+  });
+
+  suite->MeasureLoop("for_each_burn", threads, maxLoopUs, [&] {
+    katana::for_each(
+        katana::iterate(0U, threads), Empty(), katana::no_pushes(),
+        katana::disable_conflict_detection(), katana::no_stats());
+  });
+
+  katana::GetThreadPool().beKind();
+}
+
+void
+MeasureBarrier(
+    Suite* suite, unsigned threads, std::unique_ptr<katana::Barrier> barrier) {
+  if (!barrier) {
+    return;
+  }
+  barrier->Reinit(threads);
+  katana::Barrier& b = *barrier;
+  std::string name = std::string("barrier_") + b.name();
+  suite->Measure(name, threads, maxBarrierUs, rounds, [&] {
+    return TimeNs([&] {
+      katana::on_each([&](unsigned, unsigned) {
+        for (unsigned r = 0; r < rounds; ++r) {
+          b.Wait();
+        }
+      });
+    });
+  });
+}
+
+/// Threads of the pool sleep on a condition variable between loops unless
+/// the pool burns power, so the first loop after a pause pays to wake them
+void
+MeasureWakeup(Suite* suite, unsigned threads) {
+  unsigned wakeups = std::max(1U, rounds / 100);
+  suite->Measure("thread_pool_wakeup", threads, maxWakeupUs, wakeups, [&] {
+    uint64_t ns = 0;
+    for (unsigned r = 0; r < wakeups; ++r) {
+      std::this_thread::sleep_for(std::chrono::microseconds(sleepUs));
+      ns += TimeNs([] {
+        katana::on_each([](unsigned, unsigned) { katana::compilerBarrier(); });
+      });
+    }
+    return ns;
+  });
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+
+  unsigned max_threads = maxThreads;
+  if (max_threads == 0) {
+    max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  }
+  std::vector<unsigned> thread_counts;
+  for (unsigned t = 1; t < max_threads; t *= 2) {
+    thread_counts.emplace_back(t);
+  }
+  thread_counts.emplace_back(max_threads);
+
+  Suite suite;
+  for (unsigned threads : thread_counts) {
+    katana::setActiveThreads(threads);
+
+    MeasureLoops(&suite, threads);
+    MeasureBurningLoops(&suite, threads);
+
+    MeasureBarrier(&suite, threads, katana::CreateAutoBarrier(threads));
+    MeasureBarrier(&suite, threads, katana::CreateCountingBarrier(threads));
+    MeasureBarrier(&suite, threads, katana::CreateMCSBarrier(threads));
+    MeasureBarrier(&suite, threads, katana::CreateTopoBarrier(threads));
+    MeasureBarrier(
+        &suite, threads, katana::CreateDisseminationBarrier(threads));
+
+    MeasureWakeup(&suite, threads);
+  }
+
+  nlohmann::json report = {
+      {"rounds", rounds.getValue()},
+      {"samples", samples.getValue()},
+      {"results", suite.results()},
+  };
+  auto json_res = katana::JsonDump(report);
+  KATANA_LOG_ASSERT(json_res);
+  if (jsonFile.empty()) {
+    std::cout << json_res.value() << "\n";
+  } else {
+    std::ofstream out(jsonFile);
+    out << json_res.value() << "\n";
+    KATANA_LOG_ASSERT(out);
+  }
+
+  return suite.failed() ? 1 : 0;
+}
@@ -0,0 +1,87 @@
+#include "katana/ScratchArena.h"
+
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+void
+TestReleaseReusesBlocks() {
+  katana::ScratchArena arena;
+
+  auto* a = static_cast<uint64_t*>(arena.Allocate(100 * sizeof(uint64_t)));
+  a[99] = 1;
+  katana::ScratchArena::Mark mark = arena.GetMark();
+
+  void* big = arena.Allocate(4 * katana::ScratchArena::kBlockSize, 4096);
+  KATANA_LOG_ASSERT(reinterpret_cast<uintptr_t>(big) % 4096 == 0);
+  size_t reserved = arena.bytes_reserved();
+  KATANA_LOG_ASSERT(reserved >= 5 * katana::ScratchArena::kBlockSize);
+
+  arena.Release(mark);
+  KATANA_LOG_ASSERT(a[99] == 1);
+  // The released block is reused rather than allocated again
+  void* again = arena.Allocate(4 * katana::ScratchArena::kBlockSize, 4096);
+  KATANA_LOG_ASSERT(again != nullptr);
+  KATANA_LOG_ASSERT(arena.bytes_reserved() == reserved);
+
+  arena.Reset();
+  KATANA_LOG_ASSERT(arena.GetMark().block == 0);
+  KATANA_LOG_ASSERT(arena.bytes_reserved() == reserved);
+}
+
+void
+TestScopedVectors() {
+  constexpr uint32_t kNumItems = 1000;
+  std::atomic<uint64_t> total{0};
+
+  for (int round = 0; round < 2; ++round) {
+    katana::do_all(katana::iterate(uint32_t{0}, kNumItems), [&](uint32_t i) {
+      katana::ScratchScope scope;
+      katana::ScratchVector<uint32_t> items;
+      for (uint32_t j = 0; j <= i % 100; ++j) {
+        items.emplace_back(j);
+      }
+      total += std::accumulate(items.begin(), items.end(), uint64_t{0});
+    });
+  }
+
+  uint64_t expected = 0;
+  for (uint32_t i = 0; i < kNumItems; ++i) {
+    uint64_t n = i % 100;
+    expected += n * (n + 1) / 2;
+  }
+  KATANA_LOG_ASSERT(total == 2 * expected);
+
+  katana::ScratchArena& arena = katana::ScratchArena::Local();
+  {
+    katana::ScratchScope scope;
+    katana::ScratchVector<uint64_t> items(1000, 7);
+    KATANA_LOG_ASSERT(items.get_allocator().arena() == &arena);
+  }
+  size_t reserved = arena.bytes_reserved();
+  {
+    katana::ScratchScope scope;
+    katana::ScratchVector<uint64_t> items(1000, 7);
+  }
+  KATANA_LOG_ASSERT(arena.bytes_reserved() == reserved);
+  KATANA_LOG_ASSERT(arena.GetMark().block == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestReleaseReusesBlocks();
+  TestScopedVectors();
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include "katana/SetIntersection.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "katana/Logging.h"
+
+namespace {
+
+/// \returns size distinct sorted values less than universe
+std::vector<uint32_t>
+RandomSet(std::mt19937* gen, size_t size, uint32_t universe) {
+  std::vector<uint32_t> values(universe);
+  for (uint32_t i = 0; i < universe; ++i) {
+    values[i] = i;
+  }
+  std::shuffle(values.begin(), values.end(), *gen);
+  values.resize(size);
+  std::sort(values.begin(), values.end());
+  return values;
+}
+
+std::vector<uint32_t>
+Expected(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  std::vector<uint32_t> common;
+  std::set_intersection(
+      a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(common));
+  return common;
+}
+
+/// Sizes of similar sets, which are merged in blocks with leftovers, and of
+/// sets whose sizes differ enough for galloping
+void
+TestIntersections() {
+  std::mt19937 gen(7);
+  const size_t sizes[] = {0, 1, 7, 8, 15, 16, 17, 100, 1000, 3000};
+  for (size_t a_size : sizes) {
+    for (size_t b_size : sizes) {
+      auto a = RandomSet(&gen, a_size, 4000);
+      auto b = RandomSet(&gen, b_size, 4000);
+      auto expected = Expected(a, b);
+
+      uint64_t count =
+          katana::IntersectionSize(a.data(), a.size(), b.data(), b.size());
+      KATANA_LOG_VASSERT(
+          count == expected.size(), "sizes {} and {}: {} common, expected {}",
+          a_size, b_size, count, expected.size());
+
+      std::vector<uint32_t> common;
+      katana::ForEachIntersection(
+          a.data(), a.size(), b.data(), b.size(), [&](size_t i, size_t j) {
+            KATANA_LOG_ASSERT(a[i] == b[j]);
+            common.emplace_back(a[i]);
+            return true;
+          });
+      KATANA_LOG_ASSERT(common == expected);
+
+      katana::SetBitmap bitmap(4000);
+      bitmap.Insert(a.data(), a.size());
+      KATANA_LOG_ASSERT(
+          bitmap.IntersectionSize(b.data(), b.size()) == expected.size());
+      bitmap.Erase(a.data(), a.size());
+      KATANA_LOG_ASSERT(bitmap.IntersectionSize(b.data(), b.size()) == 0);
+    }
+  }
+}
+
+/// Identical sets match in every block
+void
+TestIdentical() {
+  std::vector<uint32_t> a(1000);
+  for (uint32_t i = 0; i < a.size(); ++i) {
+    a[i] = 3 * i;
+  }
+  KATANA_LOG_ASSERT(
+      katana::IntersectionSize(a.data(), a.size(), a.data(), a.size()) ==
+      a.size());
+}
+
+/// ForEachIntersection stops once its function returns false
+void
+TestStop() {
+  std::vector<uint32_t> a{1, 2, 3, 4, 5};
+  std::vector<uint32_t> b{2, 3, 4};
+  size_t calls = 0;
+  katana::ForEachIntersection(
+      a.data(), a.size(), b.data(), b.size(), [&](size_t, size_t) {
+        return ++calls < 2;
+      });
+  KATANA_LOG_ASSERT(calls == 2);
+}
+
+}  // namespace
+
+int
+main() {
+  TestIntersections();
+  TestIdentical();
+  TestStop();
+  return 0;
+}
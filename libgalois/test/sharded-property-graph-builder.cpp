@@ -0,0 +1,146 @@
+#include <arrow/api.h>
+
+#include "katana/BuildGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr int kNumNodes = 100;
+constexpr unsigned kNumShards = 2;
+
+katana::ImportData
+Int64Value(int64_t value) {
+  katana::ImportData data(katana::ImportDataType::kInt64, false);
+  data.value = value;
+  return data;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+ToGraph(katana::Result<katana::GraphComponents> components_result) {
+  if (!components_result) {
+    KATANA_LOG_FATAL(
+        "Failed to construct graph: {}", components_result.error());
+  }
+  auto graph_result =
+      katana::ConvertToPropertyGraph(std::move(components_result.value()));
+  if (!graph_result) {
+    KATANA_LOG_FATAL("Failed to construct graph: {}", graph_result.error());
+  }
+  return std::move(graph_result.value());
+}
+
+/// Shard s has the nodes with IDs s mod kNumShards and their out-edges
+std::unique_ptr<katana::PropertyGraph>
+CreateSerialGraph() {
+  katana::PropertyGraphBuilder pgb(16);
+  using katana::PropertyKey;
+  PropertyKey node_pk(
+      "n0", true, false, "n0", katana::ImportDataType::kInt64, false);
+  PropertyKey edge_pk(
+      "rank", false, true, "rank", katana::ImportDataType::kInt64, false);
+
+  for (unsigned s = 0; s < kNumShards; ++s) {
+    for (int i = s; i < kNumNodes; i += kNumShards) {
+      KATANA_LOG_ASSERT(pgb.StartNode(std::to_string(i)));
+      pgb.AddValue(
+          "n0", [&]() { return node_pk; },
+          [i](katana::ImportDataType, bool) { return Int64Value(i); });
+      pgb.FinishNode();
+    }
+  }
+  for (unsigned s = 0; s < kNumShards; ++s) {
+    for (int i = s; i < kNumNodes; i += kNumShards) {
+      for (int j = (i * 7) % kNumNodes; j < kNumNodes; j += 13) {
+        KATANA_LOG_ASSERT(
+            pgb.StartEdge(std::to_string(i), std::to_string(j)));
+        pgb.AddValue(
+            "rank", [&]() { return edge_pk; },
+            [i, j](katana::ImportDataType, bool) {
+              return Int64Value(i * j);
+            });
+        pgb.FinishEdge();
+      }
+    }
+  }
+  return ToGraph(pgb.Finish(false));
+}
+
+/// The same graph, but each shard adds its edges before its nodes
+std::unique_ptr<katana::PropertyGraph>
+CreateShardedGraph() {
+  katana::ShardedPropertyGraphBuilder builder(kNumShards, 16);
+
+  katana::on_each([&](unsigned tid, unsigned) {
+    auto* shard = builder.GetLocalShard();
+    for (int i = tid; i < kNumNodes; i += kNumShards) {
+      for (int j = (i * 7) % kNumNodes; j < kNumNodes; j += 13) {
+        shard->AddEdge(std::to_string(i), std::to_string(j));
+        KATANA_LOG_ASSERT(shard->AddEdgeValue("rank", Int64Value(i * j)));
+      }
+    }
+    for (int i = tid; i < kNumNodes; i += kNumShards) {
+      shard->AddNode(std::to_string(i));
+      KATANA_LOG_ASSERT(shard->AddNodeValue("n0", Int64Value(i)));
+    }
+  });
+  return ToGraph(builder.Finish(false));
+}
+
+void
+TestMatchesSerial() {
+  auto serial = CreateSerialGraph();
+  auto sharded = CreateShardedGraph();
+  KATANA_LOG_VASSERT(
+      serial->Equals(sharded.get()), "{}", serial->ReportDiff(sharded.get()));
+}
+
+void
+TestPlaceholders() {
+  katana::ShardedPropertyGraphBuilder builder(kNumShards, 16);
+  auto* first = builder.GetShard(0);
+  auto* second = builder.GetShard(1);
+  first->AddEdge("a", "missing");
+  KATANA_LOG_ASSERT(first->AddEdgeType("knows"));
+  second->AddNode("a");
+  KATANA_LOG_ASSERT(second->AddNodeLabel("person"));
+  first->AddEdge("missing", "a");
+
+  // a value of another type for the same property is an error
+  KATANA_LOG_ASSERT(first->AddEdgeValue("weight", Int64Value(1)));
+  katana::ImportData value(katana::ImportDataType::kDouble, false);
+  value.value = 1.0;
+  KATANA_LOG_ASSERT(!first->AddEdgeValue("weight", value));
+
+  auto components_result = builder.Finish(false);
+  KATANA_LOG_ASSERT(components_result);
+  const auto& components = components_result.value();
+  const auto& topology = components.topology;
+  KATANA_LOG_VASSERT(topology.num_nodes() == 2, "{}", topology.num_nodes());
+  KATANA_LOG_ASSERT(topology.num_edges() == 2);
+  // "a" is node 0, the placeholder for "missing" node 1
+  KATANA_LOG_ASSERT(topology.edge_dest(*topology.edges(0).begin()) == 1);
+  KATANA_LOG_ASSERT(topology.edge_dest(*topology.edges(1).begin()) == 0);
+  KATANA_LOG_ASSERT(components.nodes.labels->num_rows() == 2);
+  KATANA_LOG_ASSERT(components.edges.labels->num_columns() == 1);
+
+  auto weight = components.edges.properties->GetColumnByName("weight");
+  KATANA_LOG_ASSERT(weight && weight->length() == 2);
+  // only the edge from the placeholder has a weight
+  KATANA_LOG_ASSERT(weight->null_count() == 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(kNumShards);
+
+  TestMatchesSerial();
+  TestPlaceholders();
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+const std::string kName = "test-graph";
+
+std::shared_ptr<arrow::Table>
+MakeEdgeTypes(size_t num_edges) {
+  arrow::BooleanBuilder heavy;
+  arrow::BooleanBuilder light;
+  for (size_t e = 0; e < num_edges; ++e) {
+    KATANA_LOG_ASSERT(heavy.Append(e % 3 == 0).ok());
+    KATANA_LOG_ASSERT(light.Append(e % 3 != 0).ok());
+  }
+  std::shared_ptr<arrow::Array> heavy_array;
+  std::shared_ptr<arrow::Array> light_array;
+  KATANA_LOG_ASSERT(heavy.Finish(&heavy_array).ok());
+  KATANA_LOG_ASSERT(light.Finish(&light_array).ok());
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("heavy", arrow::boolean()),
+           arrow::field("light", arrow::boolean())}),
+      {heavy_array, light_array});
+}
+
+std::vector<uint64_t>
+Versions() {
+  auto res = katana::SharedGraphVersions(kName);
+  KATANA_LOG_ASSERT(res);
+  return res.value();
+}
+
+std::unique_ptr<katana::PropertyGraph>
+Attach(std::optional<uint64_t> version = std::nullopt) {
+  auto res = katana::AttachSharedGraph(kName, version);
+  KATANA_LOG_VASSERT(res, "attaching: {}", res.error());
+  return std::move(res.value());
+}
+
+void
+CheckEqual(const katana::PropertyGraph& pg, const katana::PropertyGraph& g) {
+  KATANA_LOG_ASSERT(g.topology().is_out_of_core());
+  KATANA_LOG_ASSERT(pg.topology().Equals(g.topology()));
+  KATANA_LOG_ASSERT(pg.node_properties()->Equals(*g.node_properties()));
+  KATANA_LOG_ASSERT(pg.edge_properties()->Equals(*g.edge_properties()));
+
+  const auto& types = g.GetEdgeTypeManager();
+  KATANA_LOG_ASSERT(
+      types.GetNumEntityTypes() ==
+      pg.GetEdgeTypeManager().GetNumEntityTypes());
+  KATANA_LOG_ASSERT(types.HasAtomicType("heavy"));
+  for (uint64_t e = 0; e < pg.num_edges(); ++e) {
+    KATANA_LOG_ASSERT(pg.GetTypeOfEdge(e) == g.GetTypeOfEdge(e));
+  }
+}
+
+/// Attached graphs share the files of their version
+void
+TestAttach(const katana::PropertyGraph& pg) {
+  auto version = katana::PublishSharedGraph(pg, kName);
+  KATANA_LOG_ASSERT(version);
+  KATANA_LOG_ASSERT(Versions() == std::vector<uint64_t>{version.value()});
+
+  CheckEqual(pg, *Attach());
+  CheckEqual(pg, *Attach(version.value()));
+
+  // changing an attached graph changes only that graph
+  auto attached = Attach();
+  KATANA_LOG_ASSERT(attached->RemoveNodeProperty(0));
+  CheckEqual(pg, *Attach());
+}
+
+/// Attached versions stay until they are released while new processes get
+/// the latest version
+void
+TestPinning(const katana::PropertyGraph& pg) {
+  uint64_t first_version = Versions().back();
+  auto first = Attach();
+  auto copy = Attach()->ShallowCopy();
+  KATANA_LOG_ASSERT(copy);
+
+  auto version = katana::PublishSharedGraph(pg, kName);
+  KATANA_LOG_ASSERT(version && version.value() > first_version);
+  KATANA_LOG_ASSERT(
+      Versions() == (std::vector<uint64_t>{first_version, version.value()}));
+  CheckEqual(pg, *Attach());
+  CheckEqual(pg, *first);
+
+  // the copy shares the topology, and so the version, of its graph
+  first.reset();
+  auto num_removed = katana::RemoveUnusedSharedGraphs(kName);
+  KATANA_LOG_ASSERT(num_removed && num_removed.value() == 0);
+
+  copy.value().reset();
+  num_removed = katana::RemoveUnusedSharedGraphs(kName);
+  KATANA_LOG_ASSERT(num_removed && num_removed.value() == 1);
+  KATANA_LOG_ASSERT(Versions() == std::vector<uint64_t>{version.value()});
+  KATANA_LOG_ASSERT(!katana::AttachSharedGraph(kName, first_version));
+
+  // versions are not reused once removed
+  num_removed = katana::RemoveUnusedSharedGraphs(kName, false);
+  KATANA_LOG_ASSERT(num_removed && num_removed.value() == 1);
+  KATANA_LOG_ASSERT(Versions().empty());
+  KATANA_LOG_ASSERT(!katana::AttachSharedGraph(kName));
+  auto next = katana::PublishSharedGraph(pg, kName);
+  KATANA_LOG_ASSERT(next && next.value() > version.value());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto dir = boost::filesystem::temp_directory_path() /
+             boost::filesystem::unique_path("shared-graph-%%%%-%%%%");
+  KATANA_LOG_ASSERT(setenv("KATANA_SHARED_GRAPH_DIR", dir.c_str(), 1) == 0);
+
+  LinePolicy policy{5};
+  auto pg = MakeFileGraph<uint32_t>(200, 2, &policy);
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(MakeEdgeTypes(pg->num_edges())));
+  KATANA_LOG_ASSERT(pg->ConstructEntityTypeIDs());
+
+  TestAttach(*pg);
+  TestPinning(*pg);
+
+  KATANA_LOG_ASSERT(!katana::PublishSharedGraph(*pg, "../escape"));
+  KATANA_LOG_ASSERT(!katana::AttachSharedGraph(""));
+
+  boost::filesystem::remove_all(dir);
+  return 0;
+}
@@ -0,0 +1,167 @@
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/SpeculativeFor.h"
+
+namespace {
+
+using Edge = std::pair<size_t, size_t>;
+
+std::vector<Edge>
+RandomEdges(size_t num_nodes, size_t num_edges) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<size_t> node_dist(0, num_nodes - 1);
+  std::vector<Edge> edges(num_edges);
+  for (Edge& e : edges) {
+    e = Edge{node_dist(rng), node_dist(rng)};
+  }
+  return edges;
+}
+
+/// Greedy maximal matching which takes the edges in order
+struct MatchingStep {
+  const std::vector<Edge>& edges;
+  std::vector<uint8_t>& matched;
+  std::vector<katana::Reservation>& reservations;
+  std::vector<uint8_t>& in_matching;
+
+  bool Reserve(size_t i) {
+    auto [u, v] = edges[i];
+    if (u == v || matched[u] || matched[v]) {
+      return false;
+    }
+    reservations[u].Reserve(i);
+    reservations[v].Reserve(i);
+    return true;
+  }
+
+  bool Commit(size_t i) {
+    auto [u, v] = edges[i];
+    bool holds_u = reservations[u].CheckReset(i);
+    bool holds_v = reservations[v].CheckReset(i);
+    if (holds_u && holds_v) {
+      matched[u] = matched[v] = 1;
+      in_matching[i] = 1;
+      return true;
+    }
+    return false;
+  }
+};
+
+std::vector<uint8_t>
+ParallelMatching(
+    const std::vector<Edge>& edges, size_t num_nodes, size_t granularity) {
+  std::vector<uint8_t> matched(num_nodes);
+  std::vector<katana::Reservation> reservations(num_nodes);
+  std::vector<uint8_t> in_matching(edges.size());
+  MatchingStep step{edges, matched, reservations, in_matching};
+  size_t rounds =
+      katana::speculative_for(step, 0, edges.size(), granularity, "matching");
+  KATANA_LOG_ASSERT(rounds > 0);
+  return in_matching;
+}
+
+void
+TestMatching() {
+  constexpr size_t kNumNodes = 10000;
+  std::vector<Edge> edges = RandomEdges(kNumNodes, 5 * kNumNodes);
+
+  std::vector<uint8_t> matched(kNumNodes);
+  std::vector<uint8_t> expected(edges.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    auto [u, v] = edges[i];
+    if (u != v && !matched[u] && !matched[v]) {
+      matched[u] = matched[v] = 1;
+      expected[i] = 1;
+    }
+  }
+
+  for (unsigned threads : {1, 4}) {
+    katana::setActiveThreads(threads);
+    for (size_t granularity : {1, 10, 100}) {
+      KATANA_LOG_ASSERT(
+          ParallelMatching(edges, kNumNodes, granularity) == expected);
+    }
+  }
+}
+
+/// Greedy maximal independent set which takes the nodes in order: a node has
+/// to wait for its lesser neighbors to be decided
+struct IndependentSetStep {
+  const std::vector<std::vector<size_t>>& neighbors;
+  std::vector<uint8_t>& state;
+  std::vector<uint8_t>& decision;
+
+  static constexpr uint8_t kUndecided = 0;
+  static constexpr uint8_t kIn = 1;
+  static constexpr uint8_t kOut = 2;
+
+  bool Reserve(size_t i) {
+    decision[i] = kIn;
+    for (size_t j : neighbors[i]) {
+      if (j >= i) {
+        continue;
+      }
+      if (state[j] == kIn) {
+        decision[i] = kOut;
+        break;
+      }
+      if (state[j] == kUndecided) {
+        decision[i] = kUndecided;
+      }
+    }
+    return true;
+  }
+
+  bool Commit(size_t i) {
+    if (decision[i] == kUndecided) {
+      return false;
+    }
+    state[i] = decision[i];
+    return true;
+  }
+};
+
+void
+TestIndependentSet() {
+  constexpr size_t kNumNodes = 10000;
+  std::vector<std::vector<size_t>> neighbors(kNumNodes);
+  for (auto [u, v] : RandomEdges(kNumNodes, 4 * kNumNodes)) {
+    neighbors[u].push_back(v);
+    neighbors[v].push_back(u);
+  }
+
+  std::vector<uint8_t> expected(kNumNodes);
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    expected[i] = IndependentSetStep::kIn;
+    for (size_t j : neighbors[i]) {
+      if (j < i && expected[j] == IndependentSetStep::kIn) {
+        expected[i] = IndependentSetStep::kOut;
+      }
+    }
+  }
+
+  katana::setActiveThreads(4);
+  std::vector<uint8_t> state(kNumNodes);
+  std::vector<uint8_t> decision(kNumNodes);
+  IndependentSetStep step{neighbors, state, decision};
+  katana::speculative_for(step, 0, kNumNodes, 10);
+  KATANA_LOG_ASSERT(state == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestMatching();
+  TestIndependentSet();
+
+  return 0;
+}
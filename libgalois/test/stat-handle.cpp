@@ -0,0 +1,148 @@
+#include <cstdint>
+#include <string>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Statistics.h"
+
+namespace {
+
+constexpr int64_t kNum = 10000;
+
+/// A StatManager that exposes the merged integer statistics
+class TestStatManager : public katana::StatManager {
+public:
+  /// \returns the total of (region, category) or -1 if it was not reported
+  int64_t Total(const std::string& region, const std::string& category) {
+    MergeStats();
+    for (auto i = int_cbegin(); i != int_cend(); ++i) {
+      Str r;
+      Str c;
+      int64_t total;
+      katana::StatTotal::Type type;
+      katana::gstl::Vector<int64_t> values;
+      ReadInt(i, r, c, total, type, values);
+      if (region == r.c_str() && category == c.c_str()) {
+        return total;
+      }
+    }
+    return -1;
+  }
+};
+
+/// Installs a TestStatManager in place of the one of SharedMemSys
+class ScopedStatManager {
+public:
+  ScopedStatManager() : saved_(katana::internal::sysStatManager()) {
+    katana::internal::setSysStatManager(nullptr);
+    katana::internal::setSysStatManager(&manager_);
+  }
+  ~ScopedStatManager() {
+    katana::internal::setSysStatManager(nullptr);
+    katana::internal::setSysStatManager(saved_);
+  }
+
+  TestStatManager* operator->() { return &manager_; }
+
+private:
+  katana::StatManager* saved_;
+  TestStatManager manager_;
+};
+
+void
+TestAdd() {
+  ScopedStatManager sm;
+
+  katana::StatHandle count("Region", "Count");
+  katana::StatHandle max("Region", "Max", katana::StatTotal::TMAX);
+  katana::do_all(
+      katana::iterate(int64_t{0}, kNum),
+      [&](int64_t i) {
+        count.Add(1);
+        max.Add(i % 2);
+      },
+      katana::no_stats());
+
+  // handles and names of the same statistic go to the same place
+  katana::ReportStatSum("Region", "Count", 5);
+
+  KATANA_LOG_ASSERT(sm->Total("Region", "Count") == kNum + 5);
+  // the values of a thread are summed, and max takes the largest thread
+  KATANA_LOG_ASSERT(sm->Total("Region", "Max") > 0);
+  KATANA_LOG_ASSERT(sm->Total("Region", "Max") <= kNum / 2);
+}
+
+void
+TestLoopIterations() {
+  ScopedStatManager sm;
+
+  katana::do_all(
+      katana::iterate(int64_t{0}, kNum), [](int64_t) {},
+      katana::loopname("Blocked"));
+  katana::do_all(
+      katana::iterate(int64_t{0}, kNum), [](int64_t) {}, katana::steal(),
+      katana::loopname("Stealing"));
+
+  KATANA_LOG_ASSERT(sm->Total("Blocked", "Iterations") == kNum);
+  KATANA_LOG_ASSERT(sm->Total("Stealing", "Iterations") == kNum);
+}
+
+void
+TestOutlivesManager() {
+  katana::StatHandle handle("Region", "Outliving");
+  for (int round = 0; round < 2; ++round) {
+    ScopedStatManager sm;
+    katana::do_all(
+        katana::iterate(int64_t{0}, kNum), [&](int64_t) { handle.Add(1); },
+        katana::no_stats());
+    KATANA_LOG_ASSERT(sm->Total("Region", "Outliving") == kNum);
+  }
+}
+
+void
+TestSnapshot() {
+  ScopedStatManager sm;
+
+  katana::StatHandle count("Region", "Count");
+  katana::do_all(
+      katana::iterate(int64_t{0}, kNum), [&](int64_t) { count.Add(1); },
+      katana::no_stats());
+  katana::ReportStatSingle("Region", "Ratio", 0.5);
+  katana::ReportParam("Region", "Name", "value");
+
+  katana::StatSnapshot snapshot = katana::GetStatSnapshot();
+  KATANA_LOG_ASSERT(snapshot.ints.size() == 1);
+  const katana::StatRecord<int64_t>& record = snapshot.ints[0];
+  KATANA_LOG_ASSERT(record.region == "Region");
+  KATANA_LOG_ASSERT(record.category == "Count");
+  KATANA_LOG_ASSERT(record.type == katana::StatTotal::TSUM);
+  KATANA_LOG_ASSERT(record.total == kNum);
+  int64_t sum = 0;
+  for (int64_t v : record.thread_values) {
+    sum += v;
+  }
+  KATANA_LOG_ASSERT(sum == kNum);
+  KATANA_LOG_ASSERT(snapshot.fps.size() == 1 && snapshot.fps[0].total == 0.5);
+  KATANA_LOG_ASSERT(
+      snapshot.params.size() == 1 && snapshot.params[0].total == "value");
+
+  // taking a snapshot does not lose what is reported before or after it
+  count.Add(1);
+  KATANA_LOG_ASSERT(katana::GetStatSnapshot().ints[0].total == kNum + 1);
+  KATANA_LOG_ASSERT(sm->Total("Region", "Count") == kNum + 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestAdd();
+  TestLoopIterations();
+  TestOutlivesManager();
+  TestSnapshot();
+
+  return 0;
+}
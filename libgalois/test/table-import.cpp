@@ -0,0 +1,170 @@
+#include <fstream>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TableImport.h"
+#include "katana/URI.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+void
+WriteFile(const fs::path& path, const std::string& contents) {
+  fs::create_directories(path.parent_path());
+  std::ofstream out(path.string());
+  out << contents;
+}
+
+/// Write node tables person (two files) and city, and edge tables knows and
+/// lives_in, whose endpoints are IDs of both tables
+void
+WriteTables(const fs::path& dir) {
+  WriteFile(dir / "nodes/person/part-0.csv", "id,name,age\n1,alice,30\n");
+  WriteFile(dir / "nodes/person/part-1.csv", "id,name\n2,bob\n3,carol\n");
+  WriteFile(dir / "nodes/city/part-0.csv", "id,name\n10,austin\n");
+  WriteFile(
+      dir / "edges/knows/part-0.csv",
+      "source,target,since\n3,1,2015\n1,2,2010\n2,3,2012\n");
+  WriteFile(dir / "edges/knows/part-1.csv", "source,target,since\n1,3,2011\n");
+  WriteFile(dir / "edges/lives_in/part-0.csv", "source,target\n1,10\n2,10\n");
+}
+
+katana::GraphComponents
+Convert(const fs::path& dir) {
+  auto node_tables_result =
+      katana::ListTableSources((dir / "nodes").string());
+  KATANA_LOG_ASSERT(node_tables_result);
+  auto edge_tables_result =
+      katana::ListTableSources((dir / "edges").string());
+  KATANA_LOG_ASSERT(edge_tables_result);
+  KATANA_LOG_ASSERT(node_tables_result.value().size() == 2);
+  KATANA_LOG_ASSERT(node_tables_result.value()[1].files.size() == 2);
+
+  auto components_result = katana::ConvertTables(
+      node_tables_result.value(), edge_tables_result.value());
+  if (!components_result) {
+    KATANA_LOG_FATAL("converting tables: {}", components_result.error());
+  }
+  return std::move(components_result.value());
+}
+
+void
+TestConvert(const fs::path& dir) {
+  katana::GraphComponents components = Convert(dir);
+  const auto& topology = components.topology;
+
+  // tables are listed by name, so the city comes first
+  KATANA_LOG_VASSERT(topology.num_nodes() == 4, "{}", topology.num_nodes());
+  KATANA_LOG_VASSERT(topology.num_edges() == 6, "{}", topology.num_edges());
+  std::vector<std::vector<uint32_t>> expected{{}, {2, 3, 0}, {3, 0}, {1}};
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    std::vector<uint32_t> dests;
+    for (auto e : topology.edges(n)) {
+      dests.emplace_back(topology.edge_dest(e));
+    }
+    KATANA_LOG_VASSERT(dests == expected[n], "node {}", n);
+  }
+
+  const auto& nodes = components.nodes;
+  KATANA_LOG_ASSERT(nodes.properties->num_columns() == 3);
+  auto age = nodes.properties->GetColumnByName("age");
+  KATANA_LOG_ASSERT(age && age->null_count() == 3);
+  KATANA_LOG_ASSERT(nodes.labels->num_columns() == 2);
+  auto person = nodes.labels->GetColumnByName("person");
+  KATANA_LOG_ASSERT(person);
+  auto is_person = std::static_pointer_cast<arrow::BooleanScalar>(
+      person->GetScalar(0).ValueOrDie());
+  KATANA_LOG_ASSERT(!is_person->value);
+
+  // the edges of a node keep the order of the tables
+  const auto& edges = components.edges;
+  KATANA_LOG_ASSERT(edges.properties->num_columns() == 1);
+  auto since = edges.properties->GetColumnByName("since");
+  KATANA_LOG_ASSERT(since && since->null_count() == 2);
+  auto first = std::static_pointer_cast<arrow::Int64Scalar>(
+      since->GetScalar(0).ValueOrDie());
+  KATANA_LOG_VASSERT(first->value == 2010, "{}", first->value);
+  auto lives_in = edges.labels->GetColumnByName("lives_in");
+  KATANA_LOG_ASSERT(lives_in && lives_in->num_chunks() > 0);
+  auto is_lives_in = std::static_pointer_cast<arrow::BooleanScalar>(
+      lives_in->GetScalar(2).ValueOrDie());
+  KATANA_LOG_ASSERT(is_lives_in->value);
+}
+
+void
+TestMissingNode(const fs::path& dir) {
+  WriteFile(dir / "edges/knows/part-2.csv", "source,target\n1,4\n");
+  auto node_tables_result =
+      katana::ListTableSources((dir / "nodes").string());
+  auto edge_tables_result =
+      katana::ListTableSources((dir / "edges").string());
+  KATANA_LOG_ASSERT(node_tables_result && edge_tables_result);
+  KATANA_LOG_ASSERT(!katana::ConvertTables(
+      node_tables_result.value(), edge_tables_result.value()));
+}
+
+void
+TestConvertEdgeArrays() {
+  arrow::Int64Builder sources_builder;
+  KATANA_LOG_ASSERT(sources_builder.AppendValues({2, 0, 2, 0}).ok());
+  arrow::UInt32Builder destinations_builder;
+  KATANA_LOG_ASSERT(destinations_builder.AppendValues({0, 1, 1, 2}).ok());
+  arrow::Int64Builder weights_builder;
+  KATANA_LOG_ASSERT(weights_builder.AppendValues({10, 11, 12, 13}).ok());
+  auto sources = std::make_shared<arrow::ChunkedArray>(
+      sources_builder.Finish().ValueOrDie());
+  auto destinations = std::make_shared<arrow::ChunkedArray>(
+      destinations_builder.Finish().ValueOrDie());
+  auto edge_properties = arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::int64())}),
+      {weights_builder.Finish().ValueOrDie()});
+
+  auto components_result = katana::ConvertEdgeArrays(
+      sources, destinations, 0, nullptr, edge_properties);
+  if (!components_result) {
+    KATANA_LOG_FATAL("converting arrays: {}", components_result.error());
+  }
+  const auto& components = components_result.value();
+  const auto& topology = components.topology;
+  KATANA_LOG_VASSERT(topology.num_nodes() == 3, "{}", topology.num_nodes());
+  std::vector<std::vector<uint32_t>> expected{{1, 2}, {}, {0, 1}};
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    std::vector<uint32_t> dests;
+    for (auto e : topology.edges(n)) {
+      dests.emplace_back(topology.edge_dest(e));
+    }
+    KATANA_LOG_VASSERT(dests == expected[n], "node {}", n);
+  }
+  auto weight = std::static_pointer_cast<arrow::Int64Scalar>(
+      components.edges.properties->column(0)->GetScalar(1).ValueOrDie());
+  KATANA_LOG_VASSERT(weight->value == 13, "{}", weight->value);
+  KATANA_LOG_ASSERT(components.nodes.properties->num_rows() == 3);
+
+  KATANA_LOG_ASSERT(!katana::ConvertEdgeArrays(sources, destinations, 2));
+  KATANA_LOG_ASSERT(!katana::ConvertEdgeArrays(sources, sources->Slice(1)));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(2);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/tableimport");
+  KATANA_LOG_ASSERT(uri_res);
+  fs::path dir(uri_res.value().path());
+  WriteTables(dir);
+
+  TestConvert(dir);
+  TestMissingNode(dir);
+  TestConvertEdgeArrays();
+
+  fs::remove_all(dir);
+  return 0;
+}
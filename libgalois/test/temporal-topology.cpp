@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TemporalTopology.h"
+#include "katana/analytics/time_window/time_window.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kNumNodes = 300;
+constexpr uint32_t kNumEdges = 3000;
+constexpr int64_t kNumHours = 48;
+constexpr int64_t kHour = 3600;
+constexpr uint32_t kUnreachable =
+    katana::analytics::TimeWindowedGraph::kUnreachable;
+
+/// An edge of the test graph; null times are kNoTime
+struct TimedEdge {
+  Node src;
+  Node dst;
+  int64_t time;
+};
+
+std::vector<TimedEdge>
+MakeEdges() {
+  std::mt19937 gen(2718);
+  std::uniform_int_distribution<Node> node_dist(0, kNumNodes - 1);
+  std::uniform_int_distribution<int64_t> time_dist(0, kNumHours * kHour - 1);
+  std::vector<TimedEdge> edges;
+  for (uint32_t i = 0; i < kNumEdges; ++i) {
+    int64_t time = i % 97 == 0 ? katana::TemporalTopology::kNoTime
+                               : time_dist(gen);
+    edges.push_back({node_dist(gen), node_dist(gen), time});
+  }
+  std::sort(edges.begin(), edges.end(), [](const auto& a, const auto& b) {
+    return a.src < b.src;
+  });
+  return edges;
+}
+
+/// The graph of edges with their times in a timestamp property "time"
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const std::vector<TimedEdge>& edges) {
+  // edges are sorted by source, so their properties stay in edge order
+  std::vector<std::vector<Node>> adj(kNumNodes);
+  for (const auto& edge : edges) {
+    adj[edge.src].push_back(edge.dst);
+  }
+  auto pg = MakeCsrGraph(adj);
+
+  auto type = arrow::timestamp(arrow::TimeUnit::SECOND);
+  arrow::TimestampBuilder builder(type, arrow::default_memory_pool());
+  for (const auto& edge : edges) {
+    if (edge.time == katana::TemporalTopology::kNoTime) {
+      KATANA_LOG_ASSERT(builder.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(builder.Append(edge.time).ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> times;
+  KATANA_LOG_ASSERT(builder.Finish(&times).ok());
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("time", type)}), {times})));
+  return pg;
+}
+
+std::vector<TimedEdge>
+InWindow(const std::vector<TimedEdge>& edges, const katana::TimeWindow& w) {
+  std::vector<TimedEdge> in_window;
+  for (const auto& edge : edges) {
+    if (w.Contains(edge.time)) {
+      in_window.push_back(edge);
+    }
+  }
+  return in_window;
+}
+
+void
+TestSorted(
+    const katana::PropertyGraph& pg, const std::vector<TimedEdge>& edges,
+    bool transpose) {
+  auto res = katana::TemporalTopology::Make(&pg, "time", transpose);
+  KATANA_LOG_ASSERT(res);
+  const auto& temporal = res.value();
+  KATANA_LOG_ASSERT(temporal.num_nodes() == kNumNodes);
+  KATANA_LOG_ASSERT(temporal.num_edges() == kNumEdges);
+
+  for (Node n = 0; n < kNumNodes; ++n) {
+    int64_t last_time = std::numeric_limits<int64_t>::min();
+    for (auto e : temporal.edges(n)) {
+      const auto& edge = edges[temporal.edge_property_index(e)];
+      KATANA_LOG_ASSERT(temporal.edge_time(e) == edge.time);
+      KATANA_LOG_ASSERT((transpose ? edge.dst : edge.src) == n);
+      KATANA_LOG_ASSERT(
+          temporal.edge_dest(e) == (transpose ? edge.src : edge.dst));
+      KATANA_LOG_ASSERT(last_time <= edge.time);
+      last_time = edge.time;
+    }
+  }
+}
+
+void
+TestWindows(
+    const katana::PropertyGraph& pg, const std::vector<TimedEdge>& edges) {
+  auto res = katana::TemporalTopology::Make(&pg, "time");
+  KATANA_LOG_ASSERT(res);
+  const auto& temporal = res.value();
+  katana::TimeWindowTopology window_topology(&temporal);
+
+  auto check = [&](const katana::TimeWindow& window) {
+    window_topology.SetWindow(window);
+    std::vector<uint64_t> degrees(kNumNodes, 0);
+    for (const auto& edge : InWindow(edges, window)) {
+      degrees[edge.src] += 1;
+    }
+    uint64_t num_edges = 0;
+    for (Node n = 0; n < kNumNodes; ++n) {
+      KATANA_LOG_VASSERT(
+          window_topology.degree(n) == degrees[n], "node {}: {} != {}", n,
+          window_topology.degree(n), degrees[n]);
+      auto range = temporal.window_edges(n, window);
+      KATANA_LOG_ASSERT(*range.begin() == *window_topology.edges(n).begin());
+      KATANA_LOG_ASSERT(*range.end() == *window_topology.edges(n).end());
+      for (auto e : window_topology.edges(n)) {
+        KATANA_LOG_ASSERT(window.Contains(temporal.edge_time(e)));
+      }
+      num_edges += degrees[n];
+    }
+    KATANA_LOG_ASSERT(window_topology.num_edges() == num_edges);
+  };
+
+  // slide in steps smaller and larger than the window, then jump back
+  for (int64_t hour = 0; hour < kNumHours; ++hour) {
+    check({hour * kHour, (hour + 3) * kHour});
+  }
+  for (int64_t hour = 0; hour < kNumHours; hour += 10) {
+    check({hour * kHour, (hour + 1) * kHour});
+  }
+  check({5 * kHour, 20 * kHour});
+  check({-kHour, kNumHours * kHour});
+  check({kHour, kHour});
+}
+
+std::vector<uint32_t>
+ExpectedBfs(const std::vector<TimedEdge>& edges, Node source) {
+  std::vector<std::vector<Node>> out(kNumNodes);
+  for (const auto& edge : edges) {
+    out[edge.src].push_back(edge.dst);
+  }
+  std::vector<uint32_t> distances(kNumNodes, kUnreachable);
+  std::deque<Node> queue{source};
+  distances[source] = 0;
+  while (!queue.empty()) {
+    Node n = queue.front();
+    queue.pop_front();
+    for (Node m : out[n]) {
+      if (distances[m] == kUnreachable) {
+        distances[m] = distances[n] + 1;
+        queue.push_back(m);
+      }
+    }
+  }
+  return distances;
+}
+
+std::vector<uint32_t>
+ExpectedComponents(const std::vector<TimedEdge>& edges) {
+  std::vector<uint32_t> parent(kNumNodes);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&](uint32_t n) {
+    while (parent[n] != n) {
+      n = parent[n];
+    }
+    return n;
+  };
+  for (const auto& edge : edges) {
+    uint32_t a = find(edge.src);
+    uint32_t b = find(edge.dst);
+    parent[std::max(a, b)] = std::min(a, b);
+  }
+  std::vector<uint32_t> components(kNumNodes);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    components[n] = find(n);
+  }
+  return components;
+}
+
+std::vector<double>
+ExpectedPagerank(const std::vector<TimedEdge>& edges, double alpha) {
+  std::vector<uint64_t> out_degrees(kNumNodes, 0);
+  for (const auto& edge : edges) {
+    out_degrees[edge.src] += 1;
+  }
+  std::vector<double> ranks(kNumNodes, 1.0 / kNumNodes);
+  for (int i = 0; i < 200; ++i) {
+    std::vector<double> next(kNumNodes, (1 - alpha) / kNumNodes);
+    for (const auto& edge : edges) {
+      next[edge.dst] += alpha * ranks[edge.src] / out_degrees[edge.src];
+    }
+    ranks = next;
+  }
+  return ranks;
+}
+
+void
+TestAnalytics(
+    const katana::PropertyGraph& pg, const std::vector<TimedEdge>& edges) {
+  auto res = katana::analytics::TimeWindowedGraph::Make(&pg, "time");
+  KATANA_LOG_ASSERT(res);
+  auto& graph = *res.value();
+  KATANA_LOG_ASSERT(graph.num_nodes() == kNumNodes);
+  KATANA_LOG_ASSERT(
+      graph.num_edges() == InWindow(edges, graph.window()).size());
+  KATANA_LOG_ASSERT(!graph.SetWindow({kHour, 0}));
+
+  auto plan = katana::analytics::PagerankPlan::PullTopological(1e-9);
+  auto check = [&](const katana::TimeWindow& window) {
+    KATANA_LOG_ASSERT(graph.SetWindow(window));
+    auto in_window = InWindow(edges, window);
+    KATANA_LOG_ASSERT(graph.num_edges() == in_window.size());
+
+    auto distances = graph.Bfs(0);
+    KATANA_LOG_ASSERT(distances);
+    KATANA_LOG_ASSERT(distances.value() == ExpectedBfs(in_window, 0));
+
+    KATANA_LOG_ASSERT(
+        graph.ConnectedComponents() == ExpectedComponents(in_window));
+
+    auto ranks = graph.Pagerank(plan);
+    auto expected = ExpectedPagerank(in_window, plan.alpha());
+    for (Node n = 0; n < kNumNodes; ++n) {
+      KATANA_LOG_VASSERT(
+          std::abs(ranks[n] - expected[n]) < 1e-6, "node {}: {} != {}", n,
+          ranks[n], expected[n]);
+    }
+  };
+
+  // sliding windows, growing windows that extend the components, and a jump
+  for (int64_t hour = 0; hour < kNumHours; hour += 4) {
+    check({hour * kHour, (hour + 12) * kHour});
+  }
+  for (int64_t hour = 1; hour < kNumHours; hour += 8) {
+    check({0, hour * kHour});
+  }
+  check({10 * kHour, 11 * kHour});
+
+  KATANA_LOG_ASSERT(!graph.Bfs(kNumNodes));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto edges = MakeEdges();
+  auto pg = MakeGraph(edges);
+
+  TestSorted(*pg, edges, false);
+  TestSorted(*pg, edges, true);
+  TestWindows(*pg, edges);
+  TestAnalytics(*pg, edges);
+
+  KATANA_LOG_ASSERT(!katana::TemporalTopology::Make(pg.get(), "missing"));
+
+  return 0;
+}
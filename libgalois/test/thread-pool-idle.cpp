@@ -0,0 +1,62 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+/// Run loops back to back and after pauses long enough for idle threads to
+/// park
+void
+RunLoops(unsigned max_threads) {
+  for (unsigned i = 0; i < 200; ++i) {
+    unsigned num_threads = katana::setActiveThreads(1 + i % max_threads);
+
+    std::atomic<unsigned> threads_seen{0};
+    katana::on_each([&](unsigned, unsigned) { threads_seen.fetch_add(1); });
+    KATANA_LOG_ASSERT(threads_seen.load() == num_threads);
+
+    katana::GAccumulator<uint64_t> sum;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{1000}),
+        [&](uint64_t j) { sum += j; });
+    KATANA_LOG_ASSERT(sum.reduce() == 1000 * 999 / 2);
+
+    if (i % 50 == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::ThreadPool& pool = katana::GetThreadPool();
+  unsigned max_threads = pool.getMaxUsableThreads();
+
+  katana::ThreadPool::IdlePolicy policies[] = {
+      {0, 0},
+      {1000, 0},
+      {0, 1},
+      {100, max_threads},
+  };
+  for (const auto& policy : policies) {
+    pool.SetIdlePolicy(policy);
+    KATANA_LOG_ASSERT(pool.GetIdlePolicy().spin_us == policy.spin_us);
+    KATANA_LOG_ASSERT(
+        pool.GetIdlePolicy().warm_threads == policy.warm_threads);
+    RunLoops(max_threads);
+  }
+
+  // threads that spun forever park again under the default policy
+  pool.SetIdlePolicy({});
+  RunLoops(max_threads);
+
+  return 0;
+}
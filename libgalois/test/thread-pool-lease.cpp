@@ -0,0 +1,60 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+/// Run loops on \param num_threads threads from the calling thread
+void
+RunQuery(unsigned num_threads, uint64_t num_items) {
+  katana::ThreadPoolLease lease(num_threads);
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == lease.num_threads());
+
+  std::atomic<unsigned> threads_seen{0};
+  katana::on_each([&](unsigned tid, unsigned total) {
+    KATANA_LOG_ASSERT(tid < total);
+    KATANA_LOG_ASSERT(total == lease.num_threads());
+    threads_seen.fetch_add(1);
+  });
+  KATANA_LOG_ASSERT(threads_seen.load() == lease.num_threads());
+
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_items), [&](uint64_t i) { sum += i; },
+      katana::steal());
+  KATANA_LOG_ASSERT(sum.reduce() == num_items * (num_items - 1) / 2);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  unsigned max_threads =
+      katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  std::vector<std::thread> clients;
+  for (unsigned i = 0; i < 4; ++i) {
+    clients.emplace_back([=] {
+      for (unsigned j = 0; j < 10; ++j) {
+        RunQuery(1 + (i + j) % max_threads, 1000 * (i + 1));
+      }
+    });
+  }
+  // the thread that created the pool needs a lease too while clients run
+  RunQuery(max_threads, 5000);
+  for (auto& client : clients) {
+    client.join();
+  }
+
+  // leases restore the active threads when released
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == max_threads);
+  RunQuery(max_threads, 100);
+
+  return 0;
+}
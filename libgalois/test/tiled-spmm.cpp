@@ -0,0 +1,95 @@
+#include "katana/TiledSpMM.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "katana/GraphGenerators.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// Features and weights are small integers so that sums are exact in any
+/// order
+void
+TestAggregate(
+    const katana::GraphTopology& topo, uint32_t width, size_t tile_bytes,
+    bool weighted) {
+  auto spmm = katana::TiledSpMM::Make(topo, width, tile_bytes);
+  KATANA_LOG_ASSERT(spmm.width() == width);
+
+  std::vector<float> in(topo.num_nodes() * width);
+  for (size_t i = 0; i < in.size(); ++i) {
+    in[i] = static_cast<float>(i % 7);
+  }
+  std::vector<float> weights(topo.num_edges());
+  for (size_t e = 0; e < weights.size(); ++e) {
+    weights[e] = static_cast<float>(e % 3 + 1);
+  }
+
+  std::vector<float> expected(topo.num_nodes() * width, 0.0f);
+  for (Node n = 0; n < topo.num_nodes(); ++n) {
+    for (auto e : topo.edges(n)) {
+      float w = weighted ? weights[e] : 1.0f;
+      Node dst = topo.edge_dest(e);
+      for (uint32_t j = 0; j < width; ++j) {
+        expected[n * width + j] += w * in[dst * width + j];
+      }
+    }
+  }
+
+  // out is overwritten, not accumulated into
+  std::vector<float> out(topo.num_nodes() * width, -1.0f);
+  spmm.Aggregate(in.data(), out.data(), weighted ? weights.data() : nullptr);
+  KATANA_LOG_VASSERT(
+      out == expected, "width {} tile bytes {} weighted {}", width,
+      tile_bytes, weighted);
+}
+
+void
+TestTiles() {
+  katana::RMATParams params;
+  params.scale = 10;
+  params.edge_factor = 8;
+  katana::GraphTopology topo =
+      std::move(katana::GenerateRMAT(params, 7).value());
+
+  // 64 nodes per block: 16 row blocks, each with some of 16 column tiles
+  auto spmm = katana::TiledSpMM::Make(topo, 4, 64 * 4 * sizeof(float));
+  KATANA_LOG_ASSERT(spmm.rows_per_block() == 64);
+  KATANA_LOG_ASSERT(spmm.num_row_blocks() == 16);
+  KATANA_LOG_ASSERT(spmm.num_tiles() > 16 && spmm.num_tiles() <= 16 * 16);
+
+  for (uint32_t width : {1U, 3U, 16U}) {
+    for (size_t tile_bytes : {size_t{0}, size_t{256}, size_t{4096}}) {
+      TestAggregate(topo, width, tile_bytes, false);
+      TestAggregate(topo, width, tile_bytes, true);
+    }
+  }
+}
+
+void
+TestEmpty() {
+  katana::GraphTopology topo;
+  auto spmm = katana::TiledSpMM::Make(topo, 8);
+  KATANA_LOG_ASSERT(spmm.num_tiles() == 0);
+  spmm.Aggregate(nullptr, nullptr);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestTiles();
+  TestEmpty();
+
+  return 0;
+}
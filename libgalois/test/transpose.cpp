@@ -0,0 +1,120 @@
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphGenerators.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using Algorithm = katana::EdgeShuffleTopology::TransposeAlgorithm;
+
+/// The in-edges of every node are expected in the order of their edge ids
+void
+CheckTranspose(const katana::PropertyGraph& pg, Algorithm algo) {
+  const katana::GraphTopology& topo = pg.topology();
+  std::vector<std::vector<std::pair<Node, Edge>>> in_edges(topo.num_nodes());
+  for (Node n = 0; n < topo.num_nodes(); ++n) {
+    for (Edge e : topo.edges(n)) {
+      in_edges[topo.edge_dest(e)].emplace_back(n, e);
+    }
+  }
+
+  auto transpose = katana::EdgeShuffleTopology::MakeTransposeCopy(&pg, algo);
+  KATANA_LOG_ASSERT(transpose->is_transposed());
+  KATANA_LOG_ASSERT(transpose->num_nodes() == topo.num_nodes());
+  KATANA_LOG_ASSERT(transpose->num_edges() == topo.num_edges());
+  for (Node n = 0; n < topo.num_nodes(); ++n) {
+    auto edges = transpose->edges(n);
+    KATANA_LOG_VASSERT(
+        edges.size() == in_edges[n].size(), "algorithm {} node {}",
+        static_cast<int>(algo), n);
+    size_t i = 0;
+    for (Edge e : edges) {
+      KATANA_LOG_VASSERT(
+          transpose->edge_dest(e) == in_edges[n][i].first &&
+              transpose->edge_property_index(e) == in_edges[n][i].second,
+          "algorithm {} node {} in-edge {}", static_cast<int>(algo), n, i);
+      ++i;
+    }
+  }
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(katana::GraphTopology&& topo) {
+  auto g_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(g_res);
+  return std::move(g_res.value());
+}
+
+void
+CheckAllAlgorithms(const katana::PropertyGraph& pg) {
+  for (Algorithm algo :
+       {Algorithm::kAuto, Algorithm::kRadix, Algorithm::kLowMemory}) {
+    CheckTranspose(pg, algo);
+  }
+}
+
+void
+TestRMAT() {
+  // enough nodes for several destination blocks
+  katana::RMATParams params;
+  params.scale = 16;
+  params.edge_factor = 4;
+  auto topo_res = katana::GenerateRMAT(params, 3);
+  KATANA_LOG_ASSERT(topo_res);
+  auto pg = MakeGraph(std::move(topo_res.value()));
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+    CheckAllAlgorithms(*pg);
+  }
+}
+
+void
+TestSkewed() {
+  // a hub with most of the edges and nodes without in-edges
+  constexpr Node kNumNodes = 40000;
+  std::vector<std::vector<Node>> adj(kNumNodes);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    adj[n].emplace_back(kNumNodes - 1);
+    if (n % 3 == 0) {
+      adj[n].emplace_back(n / 2);
+    }
+  }
+  auto pg = MakeCsrGraph(adj);
+  CheckAllAlgorithms(*pg);
+}
+
+void
+TestEmpty() {
+  auto pg = MakeGraph(katana::GraphTopology());
+  auto transpose = katana::EdgeShuffleTopology::MakeTransposeCopy(pg.get());
+  KATANA_LOG_ASSERT(transpose->is_transposed());
+  KATANA_LOG_ASSERT(transpose->num_nodes() == 0);
+
+  // nodes without edges
+  auto edgeless = MakeCsrGraph(std::vector<std::vector<Node>>(5));
+  CheckAllAlgorithms(*edgeless);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestRMAT();
+  TestSkewed();
+  TestEmpty();
+
+  return 0;
+}
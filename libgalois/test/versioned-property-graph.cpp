@@ -0,0 +1,144 @@
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/VersionedPropertyGraph.h"
+
+namespace {
+
+constexpr uint64_t kNumUpdates = 200;
+constexpr int kNumReaders = 4;
+
+/// The properties "first" and "second" of every node, which an update sets
+/// to the same value
+std::shared_ptr<arrow::Table>
+MakeValues(size_t num_nodes, uint64_t value) {
+  arrow::UInt64Builder builder;
+  for (size_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_ASSERT(builder.Append(value + n).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("first", arrow::uint64()),
+           arrow::field("second", arrow::uint64())}),
+      {array, array});
+}
+
+uint64_t
+GetValue(const katana::PropertyGraph& g, const std::string& name, size_t n) {
+  auto property = g.GetNodeProperty(name);
+  KATANA_LOG_ASSERT(property && property->num_chunks() == 1);
+  auto array =
+      std::static_pointer_cast<arrow::UInt64Array>(property->chunk(0));
+  return array->Value(n);
+}
+
+katana::Result<uint64_t>
+SetValues(katana::VersionedPropertyGraph* graph, uint64_t value) {
+  return graph->Update([value](katana::PropertyGraph* head) {
+    return head->UpsertNodeProperties(MakeValues(head->num_nodes(), value));
+  });
+}
+
+/// Versions share the topology and keep their properties while the head
+/// changes
+void
+TestSharing(katana::VersionedPropertyGraph* graph) {
+  auto first = graph->Pin();
+  KATANA_LOG_ASSERT(first.graph);
+
+  auto version = SetValues(graph, 100);
+  KATANA_LOG_ASSERT(version && version.value() == first.version + 1);
+  auto second = graph->Pin();
+  KATANA_LOG_ASSERT(second.version == version.value());
+  KATANA_LOG_ASSERT(
+      first.graph->topology().dest_data() ==
+      second.graph->topology().dest_data());
+  KATANA_LOG_ASSERT(GetValue(*second.graph, "first", 1) == 101);
+
+  KATANA_LOG_ASSERT(SetValues(graph, 200));
+  KATANA_LOG_ASSERT(GetValue(*second.graph, "first", 1) == 101);
+  KATANA_LOG_ASSERT(GetValue(*graph->Pin().graph, "first", 1) == 201);
+
+  // failed updates are not published
+  auto failed =
+      graph->Update([](katana::PropertyGraph*) -> katana::Result<void> {
+        return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "rejected");
+      });
+  KATANA_LOG_ASSERT(!failed);
+  KATANA_LOG_ASSERT(graph->Pin().version == version.value() + 1);
+
+  // pinned graphs are copied to add properties to them
+  auto copy = graph->Pin().graph->ShallowCopy();
+  KATANA_LOG_ASSERT(copy);
+  KATANA_LOG_ASSERT(copy.value()->UpsertNodeProperties(
+      MakeValues(copy.value()->num_nodes(), 300)));
+  KATANA_LOG_ASSERT(GetValue(*graph->Pin().graph, "first", 1) == 201);
+}
+
+/// Readers see every property of a version from the same update while the
+/// writer publishes new ones
+void
+TestConcurrentReaders(katana::VersionedPropertyGraph* graph) {
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kNumReaders; ++i) {
+    readers.emplace_back([graph, &done]() {
+      uint64_t last_version = 0;
+      while (!done.load()) {
+        auto snapshot = graph->Pin();
+        KATANA_LOG_ASSERT(snapshot.version >= last_version);
+        last_version = snapshot.version;
+        const katana::PropertyGraph& g = *snapshot.graph;
+        for (size_t n = 0; n < g.num_nodes(); n += 7) {
+          KATANA_LOG_ASSERT(
+              GetValue(g, "first", n) == GetValue(g, "second", n));
+        }
+      }
+    });
+  }
+
+  for (uint64_t i = 0; i < kNumUpdates; ++i) {
+    KATANA_LOG_ASSERT(SetValues(graph, i * 1000));
+  }
+  done.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  auto latest = graph->Pin();
+  KATANA_LOG_ASSERT(
+      GetValue(*latest.graph, "first", 0) == (kNumUpdates - 1) * 1000);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy policy{3};
+  auto pg = MakeFileGraph<uint32_t>(500, 1, &policy);
+  KATANA_LOG_ASSERT(pg->UpsertNodeProperties(MakeValues(pg->num_nodes(), 0)));
+
+  KATANA_LOG_ASSERT(!katana::VersionedPropertyGraph::Make(nullptr));
+  auto graph = katana::VersionedPropertyGraph::Make(std::move(pg));
+  KATANA_LOG_ASSERT(graph);
+  KATANA_LOG_ASSERT(graph.value()->Pin().version == 1);
+
+  TestSharing(graph.value().get());
+  TestConcurrentReaders(graph.value().get());
+
+  return 0;
+}
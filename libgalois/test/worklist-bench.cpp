@@ -0,0 +1,160 @@
+/// Benchmarks the scheduling policies of for_each at 1 to N threads. Each
+/// run processes a binary tree of tasks, where task i pushes tasks 2i + 1
+/// and 2i + 2, so every task is pushed and popped once through the
+/// worklist. Workloads:
+///
+///  - uniform: every task is cheap, which measures the push and pop
+///    throughput of the worklist
+///  - skewed: one task in 64 is 256 times as expensive as the others, which
+///    measures how well the worklist balances load
+///  - priority: tasks have one of 1024 priorities in a random order, which
+///    stresses the buckets of OrderedByIntegerMetric; other worklists ignore
+///    priorities
+///
+/// Items per second are the tasks processed per second.
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+#include "katana/WorkList.h"
+
+namespace {
+
+constexpr uint32_t kNumTasks = 1 << 18;
+constexpr uint32_t kSkewPeriod = 64;
+constexpr uint32_t kSkewCost = 256;
+constexpr uint32_t kNumPriorities = 1024;
+
+enum Workload : int64_t { kUniform = 0, kSkewed = 1, kPriority = 2 };
+
+uint32_t
+Hash(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7feb352d;
+  x ^= x >> 15;
+  x *= 0x846ca68b;
+  x ^= x >> 16;
+  return x;
+}
+
+/// Priority of a task for OrderedByIntegerMetric: its depth in the tree,
+/// or a random one of kNumPriorities for the priority workload
+struct Priority {
+  Workload workload{kUniform};
+
+  unsigned operator()(uint32_t task) const {
+    if (workload == kPriority) {
+      return Hash(task) % kNumPriorities;
+    }
+    unsigned depth = 0;
+    for (uint32_t i = task + 1; i > 1; i >>= 1) {
+      ++depth;
+    }
+    return depth;
+  }
+};
+
+/// Owner of a task for OwnerComputes, spreading tasks over all threads
+struct Owner {
+  unsigned operator()(uint32_t task) const {
+    return task % katana::getActiveThreads();
+  }
+};
+
+void
+Spin(uint32_t iterations) {
+  for (uint32_t i = 0; i < iterations; ++i) {
+    katana::asmPause();
+  }
+}
+
+void
+ThreadArguments(benchmark::internal::Benchmark* b) {
+  // benchmarks are registered before the runtime starts
+  unsigned max_threads = std::max(1U, std::thread::hardware_concurrency());
+  std::vector<unsigned> thread_counts;
+  for (unsigned t = 1; t < max_threads; t *= 2) {
+    thread_counts.emplace_back(t);
+  }
+  thread_counts.emplace_back(max_threads);
+
+  for (int64_t workload : {kUniform, kSkewed, kPriority}) {
+    for (unsigned t : thread_counts) {
+      b->Args({static_cast<int64_t>(t), workload});
+    }
+  }
+  b->ArgNames({"threads", "workload"});
+  b->UseRealTime();
+  b->Unit(benchmark::kMillisecond);
+}
+
+template <typename WL>
+void
+ProcessTree(benchmark::State& state, const WL& worklist) {
+  auto workload = static_cast<Workload>(state.range(1));
+  katana::setActiveThreads(state.range(0));
+
+  for (auto _ : state) {
+    katana::GAccumulator<uint64_t> processed;
+    katana::for_each(
+        katana::iterate({uint32_t{0}}),
+        [&](uint32_t task, katana::UserContext<uint32_t>& ctx) {
+          if (workload == kSkewed && Hash(task) % kSkewPeriod == 0) {
+            Spin(kSkewCost);
+          } else {
+            Spin(1);
+          }
+          processed += 1;
+          for (uint32_t child = 2 * task + 1;
+               child <= 2 * task + 2 && child < kNumTasks; ++child) {
+            ctx.push(child);
+          }
+        },
+        worklist, katana::disable_conflict_detection(), katana::no_stats());
+    KATANA_LOG_VASSERT(
+        processed.reduce() == kNumTasks, "processed {} tasks",
+        processed.reduce());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumTasks);
+}
+
+template <typename WL>
+void
+Run(benchmark::State& state) {
+  ProcessTree(state, katana::wl<WL>());
+}
+
+void
+RunObim(benchmark::State& state) {
+  using WL =
+      katana::OrderedByIntegerMetric<Priority, katana::PerSocketChunkFIFO<>>;
+  Priority indexer{static_cast<Workload>(state.range(1))};
+  ProcessTree(state, katana::wl<WL>(indexer));
+}
+
+BENCHMARK_TEMPLATE(Run, katana::PerSocketChunkFIFO<>)->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(Run, katana::PerSocketChunkLIFO<>)->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(Run, katana::PerSocketAdaptiveChunkFIFO<>)
+    ->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(Run, katana::ChunkDequeLIFO<>)->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(Run, katana::StableIterator<true>)->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(Run, katana::BulkSynchronous<>)->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(Run, katana::OwnerComputes<Owner>)->Apply(ThreadArguments);
+BENCHMARK(RunObim)->Apply(ThreadArguments);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys G;
+  ::benchmark::Initialize(&argc, argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -6,6 +6,7 @@
 
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
+#include "katana/PropertyMemoryPool.h"
 #include "katana/Result.h"
 
 /// We have two strategies for Arrow conversion.  One uses
@@ -103,7 +104,7 @@ katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 MarshalVector(const std::vector<T>& source) {
   using Row = std::tuple<T>;
 
-  auto* pool = arrow::default_memory_pool();
+  auto* pool = katana::PropertyMemoryPool();
 
   const std::vector<Row>* source_view = TupleView(&source);
 
@@ -122,7 +123,7 @@ katana::Result<std::shared_ptr<arrow::Table>>
 VectorToArrowTable(const std::string& name, const std::vector<T>& source) {
   using Row = std::tuple<T>;
 
-  auto* pool = arrow::default_memory_pool();
+  auto* pool = katana::PropertyMemoryPool();
 
   const std::vector<Row>* source_view = TupleView(&source);
 
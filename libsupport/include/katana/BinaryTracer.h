@@ -0,0 +1,228 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_BINARYTRACER_H_
+#define KATANA_LIBSUPPORT_KATANA_BINARYTRACER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "katana/ProgressTracer.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The fixed-size record written by BinaryTracer for every event. Strings
+/// longer than the text field are truncated.
+///
+/// The layout is the file format read by scripts/binary_trace_to_chrome.py;
+/// change both together and bump kBinaryTraceVersion.
+struct BinaryTraceRecord {
+  enum Kind : uint8_t {
+    /// text is the span name; value is the trace id
+    kStart = 1,
+    kFinish = 2,
+    /// text is the message
+    kLog = 3,
+    /// a tag of the span; text is "key=" followed by the value for strings
+    kTag = 4,
+    /// a tag of the last log record of the thread, formatted like kTag
+    kLogTag = 5,
+    /// value is the number of records a thread dropped because its buffer
+    /// was full
+    kDropped = 6,
+  };
+
+  enum ValueType : uint8_t {
+    kNone = 0,
+    kInt = 1,
+    kUInt = 2,
+    kDouble = 3,
+    kBool = 4,
+    kString = 5,
+  };
+
+  static constexpr size_t kTextSize = 88;
+
+  uint64_t timestamp_ns;
+  uint64_t span_id;
+  uint64_t parent_id;
+  /// int64_t, uint64_t, double or bool by value_type, or the trace id
+  uint64_t value;
+  uint32_t thread_id;
+  Kind kind;
+  ValueType value_type;
+  uint16_t text_length;
+  char text[kTextSize];
+};
+
+static_assert(sizeof(BinaryTraceRecord) == 128);
+
+constexpr char kBinaryTraceMagic[8] = {'K', 'T', 'R', 'A', 'C', 'E', 0, 0};
+constexpr uint32_t kBinaryTraceVersion = 1;
+
+/// The header of a binary trace file, which is followed by records in no
+/// particular order
+struct BinaryTraceHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t host_id;
+  uint32_t num_hosts;
+  /// wall clock minus steady clock when the tracer was made; added to the
+  /// timestamps of records to line up the traces of several hosts
+  uint64_t epoch_offset_ns;
+};
+
+/// A tracer cheap enough to leave on in production: events are copied as
+/// fixed-size records into a lock-free ring buffer of the thread that emits
+/// them, and a background thread writes the buffers to a file. Nothing is
+/// formatted and no lock is taken on the tracing path. If a buffer fills up
+/// faster than it is written, new records are dropped and counted.
+///
+/// Turn the file into a Chrome trace, viewable in chrome://tracing or the
+/// Perfetto UI, with scripts/binary_trace_to_chrome.py.
+///
+/// Unlike JSONTracer and TextTracer, logs do not record memory usage; tag
+/// a span with it if needed.
+///
+/// \code
+/// katana::SharedMemSys sys(
+///     KATANA_CHECKED(katana::BinaryTracer::Make("/tmp/trace.bin")));
+/// \endcode
+class KATANA_EXPORT BinaryTracer : public ProgressTracer {
+public:
+  static constexpr size_t kDefaultRecordsPerThread = 1 << 14;
+  static constexpr uint32_t kDefaultFlushIntervalMs = 100;
+
+  /// Create a tracer that writes to \param path. \param records_per_thread
+  /// is rounded up to a power of two.
+  static Result<std::unique_ptr<BinaryTracer>> Make(
+      const std::string& path, uint32_t host_id = 0, uint32_t num_hosts = 1,
+      size_t records_per_thread = kDefaultRecordsPerThread,
+      uint32_t flush_interval_ms = kDefaultFlushIntervalMs);
+
+  ~BinaryTracer() override;
+
+  std::shared_ptr<ProgressSpan> StartSpan(
+      const std::string& span_name, const ProgressContext& child_of) override;
+
+  std::string Inject(const ProgressContext& ctx) override;
+  std::unique_ptr<ProgressContext> Extract(const std::string& carrier) override;
+
+  /// \returns the number of records dropped so far because buffers were full
+  uint64_t dropped_records() const;
+
+private:
+  friend class BinarySpan;
+
+  class Ring;
+
+  BinaryTracer(
+      uint32_t host_id, uint32_t num_hosts, FILE* file,
+      size_t records_per_thread, uint32_t flush_interval_ms);
+
+  std::shared_ptr<ProgressSpan> StartSpan(
+      const std::string& span_name,
+      std::shared_ptr<ProgressSpan> child_of) override;
+
+  std::shared_ptr<ProgressSpan> StartSpan(
+      const std::string& span_name, uint64_t trace_id, uint64_t parent_id);
+
+  void Close() override;
+
+  /// \returns a new span id, unique in this tracer
+  uint64_t NextSpanID();
+
+  /// \returns the ring buffer of the calling thread, creating it if needed
+  Ring& LocalRing();
+
+  /// Append a record whose text is the concatenation of \param text to the
+  /// ring buffer of the calling thread
+  void Emit(
+      BinaryTraceRecord::Kind kind, uint64_t span_id, uint64_t parent_id,
+      BinaryTraceRecord::ValueType value_type, uint64_t value,
+      std::initializer_list<std::string_view> text);
+  void EmitTags(
+      BinaryTraceRecord::Kind kind, uint64_t span_id, const Tags& tags);
+
+  void FlushLoop();
+  void Drain();
+
+  /// distinguishes tracers in the thread-local ring caches, which must not
+  /// be fooled by a new tracer at the address of a destroyed one
+  const uint64_t instance_;
+  FILE* file_;
+  const size_t records_per_thread_;
+  const uint32_t flush_interval_ms_;
+
+  /// guards rings_, file_ and closed_; taken when a thread first traces and
+  /// by the flusher, never per event
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Ring>> rings_;
+  std::condition_variable flush_cv_;
+  bool closed_{false};
+  std::thread flusher_;
+};
+
+class KATANA_EXPORT BinaryContext : public ProgressContext {
+public:
+  std::unique_ptr<ProgressContext> Clone() const noexcept override;
+  std::string GetTraceID() const noexcept override;
+  std::string GetSpanID() const noexcept override;
+
+private:
+  friend class BinaryTracer;
+  friend class BinarySpan;
+
+  BinaryContext(uint64_t trace_id, uint64_t span_id)
+      : trace_id_(trace_id), span_id_(span_id) {}
+
+  uint64_t trace_id_;
+  uint64_t span_id_;
+};
+
+class KATANA_EXPORT BinarySpan : public ProgressSpan {
+  friend BinaryTracer;
+
+  /// Lets std::make_shared, and only BinaryTracer, create spans so that a
+  /// span takes one allocation
+  class Token {
+    friend BinaryTracer;
+    Token() = default;
+  };
+
+public:
+  BinarySpan(
+      Token, BinaryTracer* tracer, std::shared_ptr<ProgressSpan> parent,
+      uint64_t trace_id, uint64_t span_id)
+      : ProgressSpan(std::move(parent)),
+        tracer_(tracer),
+        context_(trace_id, span_id) {}
+  ~BinarySpan() override { Finish(); }
+
+  void SetTags(const Tags& tags) override;
+
+  void Log(const std::string& message, const Tags& tags = {}) override;
+
+  const ProgressContext& GetContext() const noexcept override {
+    return context_;
+  }
+
+private:
+  void Close() override;
+
+  BinaryTracer* tracer_;
+  BinaryContext context_;
+};
+
+}  // namespace katana
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_BITMATH_H_
 #define KATANA_LIBSUPPORT_KATANA_BITMATH_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 namespace katana {
 
@@ -36,6 +38,63 @@ AlignDown(U val) {
   return mod == 0 ? val : val - mod;
 }
 
+/// Map signed integers to unsigned ones so that values of small magnitude
+/// (positive or negative) become small: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+constexpr uint64_t
+ZigZagEncode(int64_t val) {
+  return (static_cast<uint64_t>(val) << 1) ^ static_cast<uint64_t>(val >> 63);
+}
+
+constexpr int64_t
+ZigZagDecode(uint64_t val) {
+  return static_cast<int64_t>(val >> 1) ^ -static_cast<int64_t>(val & 1);
+}
+
+/// Number of bytes needed to store \param val as a LEB128 varint
+constexpr size_t
+VarintSize(uint64_t val) {
+  size_t size = 1;
+  while (val >= 0x80) {
+    val >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+/// Store \param val as a LEB128 varint at \param out
+/// \returns the number of bytes written
+inline size_t
+EncodeVarint(uint64_t val, uint8_t* out) {
+  size_t i = 0;
+  while (val >= 0x80) {
+    out[i++] = static_cast<uint8_t>(val) | 0x80;
+    val >>= 7;
+  }
+  out[i++] = static_cast<uint8_t>(val);
+  return i;
+}
+
+/// Read a LEB128 varint in [\param in, \param end) into \param val
+/// \returns the number of bytes read, or 0 if the varint runs past end or
+///     is longer than any encoded uint64_t
+inline size_t
+DecodeVarint(const uint8_t* in, const uint8_t* end, uint64_t* val) {
+  uint64_t result = 0;
+  size_t i = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (in + i >= end) {
+      return 0;
+    }
+    uint8_t byte = in[i++];
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *val = result;
+      return i;
+    }
+  }
+  return 0;
+}
+
 }  // namespace katana
 
 #endif
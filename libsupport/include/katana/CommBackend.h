@@ -2,7 +2,12 @@
 #define KATANA_LIBSUPPORT_KATANA_COMMBACKEND_H_
 
 #include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -10,8 +15,28 @@
 
 namespace katana {
 
+/// A nonblocking send or receive started by a CommBackend
+class KATANA_EXPORT CommRequest {
+public:
+  CommRequest() = default;
+  CommRequest(const CommRequest& other) = delete;
+  CommRequest(CommRequest&& other) = delete;
+  CommRequest& operator=(const CommRequest& other) = delete;
+  CommRequest& operator=(CommRequest&& other) = delete;
+  virtual ~CommRequest();
+
+  /// \returns whether the operation is done, i.e., Wait would not block
+  virtual Result<bool> Test() = 0;
+  /// Wait for the operation to be done; returns the message of a receive and
+  /// nothing for a send
+  virtual Result<std::vector<uint8_t>> Wait() = 0;
+};
+
 class KATANA_EXPORT CommBackend {
 public:
+  enum class ReduceOp { kSum, kMin, kMax };
+  enum class DataType { kInt64, kUInt64, kDouble };
+
   CommBackend() = default;
   CommBackend(const CommBackend& other) = delete;
   CommBackend(CommBackend&& other) = delete;
@@ -29,6 +54,46 @@ public:
   /// Notify other tasks that there was a failure; e.g., with MPI_Abort
   virtual void NotifyFailure() = 0;
 
+  /// Combine the count values of in of every task elementwise with op into
+  /// out of root; out is only written on root and may be in
+  virtual Result<void> ReduceBuffer(
+      uint32_t root, ReduceOp op, DataType type, const void* in, void* out,
+      size_t count) = 0;
+  /// Like ReduceBuffer, but every task gets the result
+  virtual Result<void> AllReduceBuffer(
+      ReduceOp op, DataType type, const void* in, void* out,
+      size_t count) = 0;
+  /// Send send[i] to task i; element i of the result is what task i sent to
+  /// this one. send must have Num buffers.
+  virtual Result<std::vector<std::vector<uint8_t>>> AllToAll(
+      const std::vector<std::vector<uint8_t>>& send) = 0;
+  /// Start sending buffer to task dest. Messages from one task to another
+  /// with the same tag are received in the order they were sent.
+  virtual Result<std::unique_ptr<CommRequest>> ISend(
+      uint32_t dest, int tag, std::vector<uint8_t> buffer) = 0;
+  /// Start receiving a message with tag from task source
+  virtual Result<std::unique_ptr<CommRequest>> IRecv(
+      uint32_t source, int tag) = 0;
+
+  template <typename T>
+  Result<void> Reduce(
+      uint32_t root, ReduceOp op, const T* in, T* out, size_t count) {
+    return ReduceBuffer(root, op, DataTypeOf<T>(), in, out, count);
+  }
+
+  template <typename T>
+  Result<void> AllReduce(ReduceOp op, const T* in, T* out, size_t count) {
+    return AllReduceBuffer(op, DataTypeOf<T>(), in, out, count);
+  }
+
+  /// \returns val combined over all tasks with op
+  template <typename T>
+  Result<T> AllReduce(ReduceOp op, T val) {
+    T out{};
+    KATANA_CHECKED(AllReduce(op, &val, &out, 1));
+    return out;
+  }
+
   // TODO(thunt): Num and ID were chosen because of NetworkInterface. Changing
   // them is very disruptive so I'll defer for a time in the future where we're
   // not worried about upstream and can global replace.
@@ -37,8 +102,26 @@ public:
   uint32_t Num{1};
   /// The id number of this task
   uint32_t ID{0};
+
+private:
+  template <typename T>
+  static constexpr DataType DataTypeOf() {
+    static_assert(
+        (std::is_integral_v<T> && sizeof(T) == 8) ||
+            std::is_same_v<T, double>,
+        "only 64-bit integers and doubles can be reduced");
+    if constexpr (std::is_same_v<T, double>) {
+      return DataType::kDouble;
+    } else if constexpr (std::is_signed_v<T>) {
+      return DataType::kInt64;
+    } else {
+      return DataType::kUInt64;
+    }
+  }
 };
 
+/// The backend of a single task: collectives copy their input and messages
+/// can only be sent to the task itself
 class KATANA_EXPORT NullCommBackend : public CommBackend {
 public:
   void Barrier() override {}
@@ -51,6 +134,23 @@ public:
       uint64_t max_size) override {
     return val.substr(0, max_size);
   }
+
+  Result<void> ReduceBuffer(
+      uint32_t root, ReduceOp op, DataType type, const void* in, void* out,
+      size_t count) override;
+  Result<void> AllReduceBuffer(
+      ReduceOp op, DataType type, const void* in, void* out,
+      size_t count) override;
+  Result<std::vector<std::vector<uint8_t>>> AllToAll(
+      const std::vector<std::vector<uint8_t>>& send) override;
+  Result<std::unique_ptr<CommRequest>> ISend(
+      uint32_t dest, int tag, std::vector<uint8_t> buffer) override;
+  Result<std::unique_ptr<CommRequest>> IRecv(
+      uint32_t source, int tag) override;
+
+private:
+  /// messages sent to self by tag, oldest first
+  std::map<int, std::deque<std::vector<uint8_t>>> mailbox_;
 };
 
 }  // namespace katana
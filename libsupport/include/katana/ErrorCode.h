@@ -66,6 +66,10 @@ enum class ErrorCode {
   AssertionFailed = 12,
   GraphUpdateFailed = 13,
   FeatureNotEnabled = 14,
+  Cancelled = 15,
+  OutOfMemory = 16,
+  CommFailed = 17,
+  DeviceFailed = 18,
 };
 
 }  // namespace katana
@@ -108,6 +112,14 @@ public:
       return "graph update failed";
     case ErrorCode::FeatureNotEnabled:
       return "not built with this feature";
+    case ErrorCode::Cancelled:
+      return "operation cancelled";
+    case ErrorCode::OutOfMemory:
+      return "out of memory";
+    case ErrorCode::CommFailed:
+      return "communication failed";
+    case ErrorCode::DeviceFailed:
+      return "device operation failed";
     default:
       return "unknown error";
     }
@@ -133,7 +145,13 @@ public:
     case ErrorCode::PropertyNotFound:
       return make_error_condition(std::errc::no_such_file_or_directory);
     case ErrorCode::HTTPError:
+    case ErrorCode::CommFailed:
+    case ErrorCode::DeviceFailed:
       return make_error_condition(std::errc::io_error);
+    case ErrorCode::Cancelled:
+      return make_error_condition(std::errc::operation_canceled);
+    case ErrorCode::OutOfMemory:
+      return make_error_condition(std::errc::not_enough_memory);
     default:
       return std::error_condition(c, *this);
     }
@@ -8,6 +8,11 @@ namespace katana {
 
 KATANA_EXPORT Result<void> HttpInit();
 
+// The requests below are thread-safe. They share a pool of connections that
+// are kept alive between requests, use HTTP/2 over TLS where the server
+// supports it, and share DNS lookups and TLS sessions, so that many small
+// requests to the same host skip connection setup.
+
 /// Perform an HTTP get request on url and fill buffer with the result on success
 KATANA_EXPORT Result<void> HttpGet(
     const std::string& url, std::vector<char>* response);
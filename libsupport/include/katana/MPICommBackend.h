@@ -0,0 +1,57 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_MPICOMMBACKEND_H_
+#define KATANA_LIBSUPPORT_KATANA_MPICOMMBACKEND_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A CommBackend over MPI_COMM_WORLD with one task per MPI rank. It is only
+/// built if KATANA_ENABLE_MPI is set, which then is also defined for users of
+/// the library.
+///
+/// MPI errors are returned as CommFailed errors rather than aborting. MPI is
+/// initialized with MPI_THREAD_FUNNELED, so only the thread that made the
+/// backend may call it.
+class KATANA_EXPORT MPICommBackend : public CommBackend {
+public:
+  /// Initialize MPI if it is not already initialized
+  static Result<std::unique_ptr<MPICommBackend>> Make();
+
+  /// Finalizes MPI if Make initialized it
+  ~MPICommBackend() override;
+
+  void Barrier() override;
+  bool Broadcast(uint32_t root, bool val) override;
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override;
+  void NotifyFailure() override;
+
+  Result<void> ReduceBuffer(
+      uint32_t root, ReduceOp op, DataType type, const void* in, void* out,
+      size_t count) override;
+  Result<void> AllReduceBuffer(
+      ReduceOp op, DataType type, const void* in, void* out,
+      size_t count) override;
+  Result<std::vector<std::vector<uint8_t>>> AllToAll(
+      const std::vector<std::vector<uint8_t>>& send) override;
+  Result<std::unique_ptr<CommRequest>> ISend(
+      uint32_t dest, int tag, std::vector<uint8_t> buffer) override;
+  Result<std::unique_ptr<CommRequest>> IRecv(
+      uint32_t source, int tag) override;
+
+private:
+  explicit MPICommBackend(bool finalize) : finalize_(finalize) {}
+
+  bool finalize_;
+};
+
+}  // namespace katana
+
+#endif
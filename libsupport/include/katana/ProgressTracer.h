@@ -115,6 +115,12 @@ public:
   ProgressScope StartActiveSpan(
       const std::string& span_name, const ProgressContext& child_of);
 
+  /// StartActiveSpan for callers which cannot hold a ProgressScope, such as
+  /// the Python bindings. The span is active until it is closed with
+  /// ProgressSpan::MarkScopeClosed, which is what closing its scope would do.
+  std::shared_ptr<ProgressSpan> StartActiveSpanUnscoped(
+      const std::string& span_name);
+
   /// Create a new top level span if ignore_active_span=true and
   /// no child_of value is given
   /// Otherwise creates a child span of the child_of span or active span
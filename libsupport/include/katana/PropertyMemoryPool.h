@@ -0,0 +1,23 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_PROPERTYMEMORYPOOL_H_
+#define KATANA_LIBSUPPORT_KATANA_PROPERTYMEMORYPOOL_H_
+
+#include <arrow/memory_pool.h>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// \returns the memory pool for the Arrow buffers of properties, e.g., those
+/// read by tsuba::ParquetReader or built by ArrowRandomAccessBuilder.
+/// SharedMemSys sets it to a NUMAMemoryPool for as long as it is alive; it is
+/// arrow::default_memory_pool() otherwise.
+KATANA_EXPORT arrow::MemoryPool* PropertyMemoryPool();
+
+/// Set the pool returned by PropertyMemoryPool, or restore the default pool
+/// if \param pool is null. Buffers keep the pool they were allocated from, so
+/// \param pool must outlive them.
+KATANA_EXPORT void SetPropertyMemoryPool(arrow::MemoryPool* pool);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_TASKSCHEDULER_H_
+#define KATANA_LIBSUPPORT_KATANA_TASKSCHEDULER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Runs the stages of a pipeline, e.g., the I/O and the property conversion
+/// of loading a graph, as tasks on the calling thread so that stages that
+/// wait for futures do not hold up stages that are ready.
+///
+/// A task runs to completion; it may run parallel loops, which use the
+/// thread pool as usual, and add more tasks. Instead of blocking on a
+/// future, a task hands what depends on the future to Then. Run blocks only
+/// when every remaining task waits for a future.
+///
+/// Tasks are added and run by the thread that calls Run.
+class KATANA_EXPORT TaskScheduler {
+public:
+  using Task = std::function<CopyableResult<void>()>;
+
+  TaskScheduler() = default;
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+  TaskScheduler(TaskScheduler&&) = delete;
+  TaskScheduler& operator=(TaskScheduler&&) = delete;
+
+  /// Run \param task after the tasks that are ready before it
+  void Post(Task task);
+
+  /// Run \param fn with the value of \param future once the future is ready,
+  /// or with no arguments if the value is void. If the future holds an
+  /// error, fn is not run and the error counts as the error of the task.
+  /// Futures from std::launch::deferred count as ready.
+  template <typename T, typename F>
+  void Then(std::future<CopyableResult<T>> future, F fn) {
+    auto shared =
+        std::make_shared<std::future<CopyableResult<T>>>(std::move(future));
+    AddWaiting(Waiting{
+        .ready =
+            [shared] {
+              return shared->wait_for(std::chrono::seconds(0)) !=
+                     std::future_status::timeout;
+            },
+        .wait = [shared] { shared->wait(); },
+        .task = [shared, fn]() mutable -> CopyableResult<void> {
+          auto res = shared->get();
+          if (!res) {
+            return res.error();
+          }
+          if constexpr (std::is_void_v<T>) {
+            return fn();
+          } else {
+            return fn(std::move(res.value()));
+          }
+        },
+    });
+  }
+
+  /// Post \param fn, which returns a CopyableResult, and \returns a future
+  /// of its result for other tasks to wait for with Then. An error of fn
+  /// only goes to the future.
+  template <typename F>
+  auto Spawn(F fn) -> std::future<decltype(fn())> {
+    using R = decltype(fn());
+    auto promise = std::make_shared<std::promise<R>>();
+    std::future<R> future = promise->get_future();
+    Post([promise, fn]() mutable -> CopyableResult<void> {
+      promise->set_value(fn());
+      return CopyableResultSuccess();
+    });
+    return future;
+  }
+
+  /// Run tasks until none are left
+  ///
+  /// \returns the last error of a task, with the number of tasks that
+  /// failed; tasks keep running after an error
+  Result<void> Run();
+
+  /// number of tasks that have been added but not yet run
+  uint64_t num_pending() const { return ready_.size() + waiting_.size(); }
+
+private:
+  struct Waiting {
+    std::function<bool()> ready;
+    std::function<void()> wait;
+    Task task;
+  };
+
+  void AddWaiting(Waiting waiting);
+
+  /// Move the tasks whose futures are ready to the ready queue, in the order
+  /// they were added
+  void PollWaiting();
+
+  std::list<Task> ready_;
+  std::list<Waiting> waiting_;
+  uint64_t errors_{0};
+  uint64_t total_{0};
+  CopyableErrorInfo last_error_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,415 @@
+#include "katana/BinaryTracer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "katana/Logging.h"
+
+namespace {
+
+uint64_t
+NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint64_t
+NextInstance() {
+  static std::atomic<uint64_t> next_instance{1};
+  return next_instance.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// \returns the type and bits of the value of a tag, or kString and the
+/// string
+std::pair<katana::BinaryTraceRecord::ValueType, uint64_t>
+EncodeValue(const katana::Value& value, std::string_view* str) {
+  using katana::BinaryTraceRecord;
+  return std::visit(
+      [&](const auto& v) -> std::pair<BinaryTraceRecord::ValueType, uint64_t> {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, bool>) {
+          return {BinaryTraceRecord::kBool, v};
+        } else if constexpr (std::is_same_v<T, double>) {
+          uint64_t bits;
+          std::memcpy(&bits, &v, sizeof(bits));
+          return {BinaryTraceRecord::kDouble, bits};
+        } else if constexpr (std::is_same_v<T, float>) {
+          double d = v;
+          uint64_t bits;
+          std::memcpy(&bits, &d, sizeof(bits));
+          return {BinaryTraceRecord::kDouble, bits};
+        } else if constexpr (std::is_same_v<T, std::string>) {
+          *str = v;
+          return {BinaryTraceRecord::kString, 0};
+        } else if constexpr (std::is_same_v<T, const char*>) {
+          *str = v;
+          return {BinaryTraceRecord::kString, 0};
+        } else if constexpr (std::is_signed_v<T>) {
+          return {BinaryTraceRecord::kInt, static_cast<uint64_t>(v)};
+        } else {
+          return {BinaryTraceRecord::kUInt, v};
+        }
+      },
+      static_cast<const katana::variant_type&>(value));
+}
+
+}  // namespace
+
+/// A single-producer single-consumer ring of records: the thread that owns
+/// it appends and the flusher drains
+class katana::BinaryTracer::Ring {
+public:
+  Ring(size_t capacity, uint32_t thread_id, std::thread::id owner)
+      : records_(capacity),
+        mask_(capacity - 1),
+        thread_id_(thread_id),
+        owner_(owner) {}
+
+  /// \returns the slot of the next record, or null if the ring is full;
+  /// publish the record with Commit
+  BinaryTraceRecord* Reserve() {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) > mask_) {
+      dropped_.store(
+          dropped_.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+      return nullptr;
+    }
+    return &records_[head & mask_];
+  }
+
+  void Commit() {
+    head_.store(
+        head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /// Write the committed records to \param file
+  ///
+  /// \returns false if writing failed; the records are dropped regardless
+  bool Drain(FILE* file) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    bool ok = true;
+    while (ok && tail != head) {
+      size_t begin = tail & mask_;
+      size_t n = std::min<uint64_t>(head - tail, records_.size() - begin);
+      ok = std::fwrite(&records_[begin], sizeof(records_[0]), n, file) == n;
+      tail += n;
+    }
+    tail_.store(head, std::memory_order_release);
+    return ok;
+  }
+
+  uint64_t NextSpanID() {
+    return (static_cast<uint64_t>(thread_id_ + 1) << 40) | ++next_span_;
+  }
+
+  uint32_t thread_id() const { return thread_id_; }
+  std::thread::id owner() const { return owner_; }
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  std::vector<BinaryTraceRecord> records_;
+  const size_t mask_;
+  const uint32_t thread_id_;
+  const std::thread::id owner_;
+  uint64_t next_span_{0};
+
+  // keep the indices of the producer and the consumer on separate lines
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  alignas(64) std::atomic<uint64_t> dropped_{0};
+};
+
+katana::Result<std::unique_ptr<katana::BinaryTracer>>
+katana::BinaryTracer::Make(
+    const std::string& path, uint32_t host_id, uint32_t num_hosts,
+    size_t records_per_thread, uint32_t flush_interval_ms) {
+  size_t capacity = 2;
+  while (capacity < records_per_thread) {
+    capacity *= 2;
+  }
+
+  FILE* file = std::fopen(path.c_str(), "wb");
+  if (!file) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening trace file {}", path);
+  }
+
+  BinaryTraceHeader header{};
+  std::memcpy(header.magic, kBinaryTraceMagic, sizeof(header.magic));
+  header.version = kBinaryTraceVersion;
+  header.record_size = sizeof(BinaryTraceRecord);
+  header.host_id = host_id;
+  header.num_hosts = num_hosts;
+  uint64_t wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+  header.epoch_offset_ns = wall_ns - NowNs();
+  if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+    auto err = katana::ResultErrno();
+    std::fclose(file);
+    return KATANA_ERROR(err, "writing header of trace file {}", path);
+  }
+
+  return std::unique_ptr<BinaryTracer>(new BinaryTracer(
+      host_id, num_hosts, file, capacity, flush_interval_ms));
+}
+
+katana::BinaryTracer::BinaryTracer(
+    uint32_t host_id, uint32_t num_hosts, FILE* file,
+    size_t records_per_thread, uint32_t flush_interval_ms)
+    : ProgressTracer(host_id, num_hosts),
+      instance_(NextInstance()),
+      file_(file),
+      records_per_thread_(records_per_thread),
+      flush_interval_ms_(flush_interval_ms) {
+  flusher_ = std::thread([this] { FlushLoop(); });
+}
+
+katana::BinaryTracer::~BinaryTracer() { Close(); }
+
+std::shared_ptr<katana::ProgressSpan>
+katana::BinaryTracer::StartSpan(
+    const std::string& span_name, const katana::ProgressContext& child_of) {
+  const auto* ctx = dynamic_cast<const BinaryContext*>(&child_of);
+  if (!ctx) {
+    return StartSpan(span_name, 0, 0);
+  }
+  return StartSpan(span_name, ctx->trace_id_, ctx->span_id_);
+}
+
+std::shared_ptr<katana::ProgressSpan>
+katana::BinaryTracer::StartSpan(
+    const std::string& span_name,
+    std::shared_ptr<katana::ProgressSpan> child_of) {
+  if (!child_of) {
+    return StartSpan(span_name, 0, 0);
+  }
+  // this tracer only makes BinarySpans
+  const auto& ctx = static_cast<const BinaryContext&>(child_of->GetContext());
+  uint64_t trace_id = ctx.trace_id_;
+  uint64_t span_id = NextSpanID();
+  Emit(
+      BinaryTraceRecord::kStart, span_id, ctx.span_id_,
+      BinaryTraceRecord::kNone, trace_id, {span_name});
+  return std::make_shared<BinarySpan>(
+      BinarySpan::Token(), this, std::move(child_of), trace_id, span_id);
+}
+
+std::shared_ptr<katana::ProgressSpan>
+katana::BinaryTracer::StartSpan(
+    const std::string& span_name, uint64_t trace_id, uint64_t parent_id) {
+  uint64_t span_id = NextSpanID();
+  if (trace_id == 0) {
+    trace_id = span_id;
+  }
+  Emit(
+      BinaryTraceRecord::kStart, span_id, parent_id, BinaryTraceRecord::kNone,
+      trace_id, {span_name});
+  return std::make_shared<BinarySpan>(
+      BinarySpan::Token(), this, nullptr, trace_id, span_id);
+}
+
+std::string
+katana::BinaryTracer::Inject(const katana::ProgressContext& ctx) {
+  return ctx.GetTraceID() + "," + ctx.GetSpanID();
+}
+
+std::unique_ptr<katana::ProgressContext>
+katana::BinaryTracer::Extract(const std::string& carrier) {
+  size_t split = carrier.find(',');
+  if (split == std::string::npos) {
+    return nullptr;
+  }
+  const char* begin = carrier.data();
+  const char* end = begin + carrier.size();
+  uint64_t trace_id = 0;
+  uint64_t span_id = 0;
+  auto trace_res = std::from_chars(begin, begin + split, trace_id, 16);
+  auto span_res = std::from_chars(begin + split + 1, end, span_id, 16);
+  if (trace_res.ec != std::errc() || trace_res.ptr != begin + split ||
+      span_res.ec != std::errc() || span_res.ptr != end) {
+    return nullptr;
+  }
+  return std::unique_ptr<BinaryContext>(new BinaryContext(trace_id, span_id));
+}
+
+uint64_t
+katana::BinaryTracer::dropped_records() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t dropped = 0;
+  for (const auto& ring : rings_) {
+    dropped += ring->dropped();
+  }
+  return dropped;
+}
+
+uint64_t
+katana::BinaryTracer::NextSpanID() {
+  return LocalRing().NextSpanID();
+}
+
+katana::BinaryTracer::Ring&
+katana::BinaryTracer::LocalRing() {
+  thread_local uint64_t cached_instance = 0;
+  thread_local Ring* cached_ring = nullptr;
+  if (cached_instance == instance_) {
+    return *cached_ring;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // a thread may come back to a tracer after tracing with another one
+  std::thread::id self = std::this_thread::get_id();
+  Ring* ring = nullptr;
+  for (const auto& r : rings_) {
+    if (r->owner() == self) {
+      ring = r.get();
+    }
+  }
+  if (!ring) {
+    rings_.emplace_back(
+        std::make_unique<Ring>(records_per_thread_, rings_.size(), self));
+    ring = rings_.back().get();
+  }
+  cached_instance = instance_;
+  cached_ring = ring;
+  return *ring;
+}
+
+void
+katana::BinaryTracer::Emit(
+    BinaryTraceRecord::Kind kind, uint64_t span_id, uint64_t parent_id,
+    BinaryTraceRecord::ValueType value_type, uint64_t value,
+    std::initializer_list<std::string_view> text) {
+  Ring& ring = LocalRing();
+  BinaryTraceRecord* record = ring.Reserve();
+  if (!record) {
+    return;
+  }
+  record->timestamp_ns = NowNs();
+  record->span_id = span_id;
+  record->parent_id = parent_id;
+  record->value = value;
+  record->thread_id = ring.thread_id();
+  record->kind = kind;
+  record->value_type = value_type;
+  size_t length = 0;
+  for (std::string_view part : text) {
+    size_t n = std::min(part.size(), BinaryTraceRecord::kTextSize - length);
+    std::memcpy(record->text + length, part.data(), n);
+    length += n;
+  }
+  record->text_length = length;
+  ring.Commit();
+}
+
+void
+katana::BinaryTracer::EmitTags(
+    BinaryTraceRecord::Kind kind, uint64_t span_id, const katana::Tags& tags) {
+  for (const auto& [key, value] : tags) {
+    std::string_view str;
+    auto [value_type, bits] = EncodeValue(value, &str);
+    Emit(kind, span_id, 0, value_type, bits, {key, "=", str});
+  }
+}
+
+void
+katana::BinaryTracer::FlushLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!closed_) {
+    flush_cv_.wait_for(
+        lock, std::chrono::milliseconds(flush_interval_ms_),
+        [this] { return closed_; });
+    Drain();
+  }
+}
+
+void
+katana::BinaryTracer::Drain() {
+  if (!file_) {
+    return;
+  }
+  bool ok = true;
+  for (const auto& ring : rings_) {
+    ok &= ring->Drain(file_);
+  }
+  ok &= std::fflush(file_) == 0;
+  if (!ok) {
+    KATANA_WARN_ONCE("writing trace file: {}", katana::ResultErrno());
+  }
+}
+
+void
+katana::BinaryTracer::Close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+  }
+  flush_cv_.notify_all();
+  flusher_.join();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Drain();
+  for (const auto& ring : rings_) {
+    if (ring->dropped() == 0) {
+      continue;
+    }
+    BinaryTraceRecord record{};
+    record.timestamp_ns = NowNs();
+    record.value = ring->dropped();
+    record.thread_id = ring->thread_id();
+    record.kind = BinaryTraceRecord::kDropped;
+    record.value_type = BinaryTraceRecord::kUInt;
+    std::fwrite(&record, sizeof(record), 1, file_);
+    KATANA_LOG_WARN(
+        "trace buffer of thread {} was full; dropped {} records",
+        ring->thread_id(), ring->dropped());
+  }
+  std::fclose(file_);
+  file_ = nullptr;
+}
+
+std::unique_ptr<katana::ProgressContext>
+katana::BinaryContext::Clone() const noexcept {
+  return std::unique_ptr<BinaryContext>(new BinaryContext(trace_id_, span_id_));
+}
+
+std::string
+katana::BinaryContext::GetTraceID() const noexcept {
+  return fmt::format("{:x}", trace_id_);
+}
+
+std::string
+katana::BinaryContext::GetSpanID() const noexcept {
+  return fmt::format("{:x}", span_id_);
+}
+
+void
+katana::BinarySpan::SetTags(const katana::Tags& tags) {
+  tracer_->EmitTags(BinaryTraceRecord::kTag, context_.span_id_, tags);
+}
+
+void
+katana::BinarySpan::Log(const std::string& message, const katana::Tags& tags) {
+  tracer_->Emit(
+      BinaryTraceRecord::kLog, context_.span_id_, 0, BinaryTraceRecord::kNone,
+      0, {message});
+  tracer_->EmitTags(BinaryTraceRecord::kLogTag, context_.span_id_, tags);
+}
+
+void
+katana::BinarySpan::Close() {
+  tracer_->Emit(
+      BinaryTraceRecord::kFinish, context_.span_id_, 0,
+      BinaryTraceRecord::kNone, 0, {});
+}
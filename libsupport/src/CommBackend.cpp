@@ -1,8 +1,130 @@
 #include "katana/CommBackend.h"
 
+#include <cstring>
+#include <utility>
+
+#include "katana/ErrorCode.h"
+
+namespace {
+
+size_t
+SizeOf(katana::CommBackend::DataType type) {
+  switch (type) {
+  case katana::CommBackend::DataType::kInt64:
+    return sizeof(int64_t);
+  case katana::CommBackend::DataType::kUInt64:
+    return sizeof(uint64_t);
+  case katana::CommBackend::DataType::kDouble:
+    return sizeof(double);
+  }
+  KATANA_LOG_FATAL("unknown data type");
+}
+
+/// A request that is done when it is made
+class DoneRequest : public katana::CommRequest {
+public:
+  katana::Result<bool> Test() override { return true; }
+  katana::Result<std::vector<uint8_t>> Wait() override {
+    return std::vector<uint8_t>();
+  }
+};
+
+/// A receive from the mailbox of a NullCommBackend; it takes the oldest
+/// message with its tag once one has been sent
+class MailboxRecvRequest : public katana::CommRequest {
+public:
+  MailboxRecvRequest(std::deque<std::vector<uint8_t>>* messages, int tag)
+      : messages_(messages), tag_(tag) {}
+
+  katana::Result<bool> Test() override { return TryTake(); }
+
+  katana::Result<std::vector<uint8_t>> Wait() override {
+    if (!TryTake()) {
+      // There is only one task, so no message could arrive while waiting
+      return KATANA_ERROR(
+          katana::ErrorCode::CommFailed,
+          "no message with tag {} was sent; waiting would never end", tag_);
+    }
+    return std::move(message_);
+  }
+
+private:
+  bool TryTake() {
+    if (!taken_ && !messages_->empty()) {
+      message_ = std::move(messages_->front());
+      messages_->pop_front();
+      taken_ = true;
+    }
+    return taken_;
+  }
+
+  std::deque<std::vector<uint8_t>>* messages_;
+  int tag_;
+  bool taken_{false};
+  std::vector<uint8_t> message_;
+};
+
+katana::Result<void>
+CheckTask(uint32_t task, uint32_t num) {
+  if (task >= num) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "task {} is not one of {} tasks",
+        task, num);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
 // Anchor vtables
 
+katana::CommRequest::~CommRequest() = default;
+
 katana::CommBackend::~CommBackend() = default;
 
 void
 katana::NullCommBackend::NotifyFailure() {}
+
+katana::Result<void>
+katana::NullCommBackend::ReduceBuffer(
+    uint32_t root, ReduceOp op, DataType type, const void* in, void* out,
+    size_t count) {
+  KATANA_CHECKED(CheckTask(root, Num));
+  return AllReduceBuffer(op, type, in, out, count);
+}
+
+katana::Result<void>
+katana::NullCommBackend::AllReduceBuffer(
+    [[maybe_unused]] ReduceOp op, DataType type, const void* in, void* out,
+    size_t count) {
+  if (in != out && count > 0) {
+    std::memmove(out, in, count * SizeOf(type));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::vector<std::vector<uint8_t>>>
+katana::NullCommBackend::AllToAll(
+    const std::vector<std::vector<uint8_t>>& send) {
+  if (send.size() != Num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} buffers to send to {} tasks",
+        send.size(), Num);
+  }
+  return send;
+}
+
+katana::Result<std::unique_ptr<katana::CommRequest>>
+katana::NullCommBackend::ISend(
+    uint32_t dest, int tag, std::vector<uint8_t> buffer) {
+  KATANA_CHECKED(CheckTask(dest, Num));
+  mailbox_[tag].emplace_back(std::move(buffer));
+  return std::unique_ptr<CommRequest>(std::make_unique<DoneRequest>());
+}
+
+katana::Result<std::unique_ptr<katana::CommRequest>>
+katana::NullCommBackend::IRecv(uint32_t source, int tag) {
+  KATANA_CHECKED(CheckTask(source, Num));
+  return std::unique_ptr<CommRequest>(
+      std::make_unique<MailboxRecvRequest>(&mailbox_[tag], tag));
+}
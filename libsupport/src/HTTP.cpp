@@ -1,5 +1,9 @@
 #include "katana/HTTP.h"
 
+#include <array>
+#include <mutex>
+#include <vector>
+
 #include <curl/curl.h>
 
 #include "katana/ErrorCode.h"
@@ -8,6 +12,101 @@
 
 namespace {
 
+/// Handles kept for reuse. Each keeps the connections it opened alive, so
+/// later requests to the same host skip the TCP and TLS handshakes.
+constexpr size_t kMaxIdleHandles = 64;
+
+/// A thread-safe pool of curl handles that share their DNS cache, TLS
+/// sessions and, with libcurl 7.57 or later, their connections. Requests ask
+/// for HTTP/2 over TLS so that a connection to a host carries many streams
+/// where the server supports it, and fall back to HTTP/1.1 with keep-alive
+/// otherwise.
+class CurlPool {
+public:
+  /// The pool of the process. It is never destroyed since handles may be
+  /// released while static objects are destroyed.
+  static CurlPool& Get() {
+    static auto* pool = new CurlPool();
+    return *pool;
+  }
+
+  /// \returns a handle configured with the shared state, or nullptr
+  CURL* Acquire() {
+    CURL* handle = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!idle_.empty()) {
+        handle = idle_.back();
+        idle_.pop_back();
+      }
+    }
+    if (handle == nullptr) {
+      handle = curl_easy_init();
+      if (handle == nullptr) {
+        return nullptr;
+      }
+    }
+    // curl_easy_reset clears options but keeps the connections and caches
+    // of the handle
+    if (share_ != nullptr) {
+      curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+    }
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    return handle;
+  }
+
+  void Release(CURL* handle) {
+    curl_easy_reset(handle);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (idle_.size() < kMaxIdleHandles) {
+        idle_.emplace_back(handle);
+        return;
+      }
+    }
+    curl_easy_cleanup(handle);
+  }
+
+private:
+  CurlPool() {
+    share_ = curl_share_init();
+    if (share_ == nullptr) {
+      KATANA_LOG_WARN("could not share curl state between requests");
+      return;
+    }
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, LockShared);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, UnlockShared);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+  }
+
+  static void LockShared(
+      CURL*, curl_lock_data data, curl_lock_access, void* user_data) {
+    static_cast<CurlPool*>(user_data)->LockFor(data).lock();
+  }
+
+  static void UnlockShared(CURL*, curl_lock_data data, void* user_data) {
+    static_cast<CurlPool*>(user_data)->LockFor(data).unlock();
+  }
+
+  std::mutex& LockFor(curl_lock_data data) {
+    return share_locks_[static_cast<size_t>(data) % share_locks_.size()];
+  }
+
+  std::mutex mutex_;
+  std::vector<CURL*> idle_;
+  CURLSH* share_{nullptr};
+  /// one lock for each kind of shared data
+  std::array<std::mutex, CURL_LOCK_DATA_LAST> share_locks_;
+};
+
 class CurlHandle {
   CURL* handle_{};
   struct curl_slist* headers_{};
@@ -38,7 +137,7 @@ public:
 
   static katana::Result<CurlHandle> Make(
       const std::string& url, std::vector<char>* response) {
-    CURL* curl = curl_easy_init();
+    CURL* curl = CurlPool::Get().Acquire();
     if (!curl) {
       return katana::ErrorCode::HTTPError;
     }
@@ -51,12 +150,13 @@ public:
 
   CURL* handle() { return handle_; }
   ~CurlHandle() {
+    // release first so that the handle no longer refers to the headers
+    if (handle_ != nullptr) {
+      CurlPool::Get().Release(handle_);
+    }
     if (headers_ != nullptr) {
       curl_slist_free_all(headers_);
     }
-    if (handle_ != nullptr) {
-      curl_easy_cleanup(handle_);
-    }
   }
 
   void SetHeader(const std::string& header) {
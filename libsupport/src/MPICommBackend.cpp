@@ -0,0 +1,371 @@
+#include "katana/MPICommBackend.h"
+
+#include <limits>
+#include <utility>
+
+#include <mpi.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace {
+
+katana::Result<void>
+MPICheck(int rc, const char* what) {
+  if (rc == MPI_SUCCESS) {
+    return katana::ResultSuccess();
+  }
+  char message[MPI_MAX_ERROR_STRING];
+  int length = 0;
+  MPI_Error_string(rc, message, &length);
+  return KATANA_ERROR(
+      katana::ErrorCode::CommFailed, "{}: {}", what,
+      std::string(message, length));
+}
+
+/// For the operations of CommBackend that cannot return an error
+void
+MPICheckFatal(int rc, const char* what) {
+  if (auto res = MPICheck(rc, what); !res) {
+    KATANA_LOG_FATAL("{}", res.error());
+  }
+}
+
+MPI_Datatype
+ToMPIType(katana::CommBackend::DataType type) {
+  switch (type) {
+  case katana::CommBackend::DataType::kInt64:
+    return MPI_INT64_T;
+  case katana::CommBackend::DataType::kUInt64:
+    return MPI_UINT64_T;
+  case katana::CommBackend::DataType::kDouble:
+    return MPI_DOUBLE;
+  }
+  KATANA_LOG_FATAL("unknown data type");
+}
+
+MPI_Op
+ToMPIOp(katana::CommBackend::ReduceOp op) {
+  switch (op) {
+  case katana::CommBackend::ReduceOp::kSum:
+    return MPI_SUM;
+  case katana::CommBackend::ReduceOp::kMin:
+    return MPI_MIN;
+  case katana::CommBackend::ReduceOp::kMax:
+    return MPI_MAX;
+  }
+  KATANA_LOG_FATAL("unknown reduce op");
+}
+
+/// MPI counts are ints
+katana::Result<int>
+ToMPICount(size_t count) {
+  if (count > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "{} elements do not fit in an MPI count", count);
+  }
+  return static_cast<int>(count);
+}
+
+katana::Result<void>
+CheckPeer(uint32_t task, int tag, uint32_t num) {
+  if (task >= num) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "task {} is not one of {} tasks",
+        task, num);
+  }
+  if (tag < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "tags cannot be negative: {}",
+        tag);
+  }
+  return katana::ResultSuccess();
+}
+
+class MPISendRequest : public katana::CommRequest {
+public:
+  explicit MPISendRequest(std::vector<uint8_t> buffer)
+      : buffer_(std::move(buffer)) {}
+
+  // The buffer must outlive the send
+  ~MPISendRequest() override {
+    if (request_ != MPI_REQUEST_NULL) {
+      MPI_Wait(&request_, MPI_STATUS_IGNORE);
+    }
+  }
+
+  katana::Result<void> Start(uint32_t dest, int tag) {
+    int count = KATANA_CHECKED(ToMPICount(buffer_.size()));
+    return MPICheck(
+        MPI_Isend(
+            buffer_.data(), count, MPI_BYTE, dest, tag, MPI_COMM_WORLD,
+            &request_),
+        "MPI_Isend");
+  }
+
+  katana::Result<bool> Test() override {
+    int done = 0;
+    KATANA_CHECKED(
+        MPICheck(MPI_Test(&request_, &done, MPI_STATUS_IGNORE), "MPI_Test"));
+    return done != 0;
+  }
+
+  katana::Result<std::vector<uint8_t>> Wait() override {
+    KATANA_CHECKED(
+        MPICheck(MPI_Wait(&request_, MPI_STATUS_IGNORE), "MPI_Wait"));
+    return std::vector<uint8_t>();
+  }
+
+private:
+  std::vector<uint8_t> buffer_;
+  MPI_Request request_{MPI_REQUEST_NULL};
+};
+
+/// A receive of a message of unknown size: the message is matched with a
+/// (nonblocking) matched probe, which gives its size, and then received
+class MPIRecvRequest : public katana::CommRequest {
+public:
+  MPIRecvRequest(uint32_t source, int tag) : source_(source), tag_(tag) {}
+
+  ~MPIRecvRequest() override {
+    if (request_ != MPI_REQUEST_NULL) {
+      MPI_Wait(&request_, MPI_STATUS_IGNORE);
+    }
+  }
+
+  katana::Result<bool> Test() override {
+    KATANA_CHECKED(Match(false));
+    if (!matched_) {
+      return false;
+    }
+    int done = 0;
+    KATANA_CHECKED(
+        MPICheck(MPI_Test(&request_, &done, MPI_STATUS_IGNORE), "MPI_Test"));
+    return done != 0;
+  }
+
+  katana::Result<std::vector<uint8_t>> Wait() override {
+    KATANA_CHECKED(Match(true));
+    KATANA_CHECKED(
+        MPICheck(MPI_Wait(&request_, MPI_STATUS_IGNORE), "MPI_Wait"));
+    return std::move(buffer_);
+  }
+
+private:
+  katana::Result<void> Match(bool block) {
+    if (matched_) {
+      return katana::ResultSuccess();
+    }
+    MPI_Message message;
+    MPI_Status status;
+    int found = 1;
+    if (block) {
+      KATANA_CHECKED(MPICheck(
+          MPI_Mprobe(source_, tag_, MPI_COMM_WORLD, &message, &status),
+          "MPI_Mprobe"));
+    } else {
+      KATANA_CHECKED(MPICheck(
+          MPI_Improbe(
+              source_, tag_, MPI_COMM_WORLD, &found, &message, &status),
+          "MPI_Improbe"));
+    }
+    if (!found) {
+      return katana::ResultSuccess();
+    }
+
+    int count = 0;
+    KATANA_CHECKED(
+        MPICheck(MPI_Get_count(&status, MPI_BYTE, &count), "MPI_Get_count"));
+    buffer_.resize(count);
+    KATANA_CHECKED(MPICheck(
+        MPI_Imrecv(buffer_.data(), count, MPI_BYTE, &message, &request_),
+        "MPI_Imrecv"));
+    matched_ = true;
+    return katana::ResultSuccess();
+  }
+
+  int source_;
+  int tag_;
+  bool matched_{false};
+  std::vector<uint8_t> buffer_;
+  MPI_Request request_{MPI_REQUEST_NULL};
+};
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::MPICommBackend>>
+katana::MPICommBackend::Make() {
+  int initialized = 0;
+  KATANA_CHECKED(MPICheck(MPI_Initialized(&initialized), "MPI_Initialized"));
+  if (!initialized) {
+    int provided = 0;
+    KATANA_CHECKED(MPICheck(
+        MPI_Init_thread(nullptr, nullptr, MPI_THREAD_FUNNELED, &provided),
+        "MPI_Init_thread"));
+    if (provided < MPI_THREAD_FUNNELED) {
+      return KATANA_ERROR(
+          ErrorCode::FeatureNotEnabled,
+          "MPI does not support MPI_THREAD_FUNNELED");
+    }
+  }
+  KATANA_CHECKED(MPICheck(
+      MPI_Comm_set_errhandler(MPI_COMM_WORLD, MPI_ERRORS_RETURN),
+      "MPI_Comm_set_errhandler"));
+
+  std::unique_ptr<MPICommBackend> comm(new MPICommBackend(!initialized));
+  int rank = 0;
+  int size = 0;
+  KATANA_CHECKED(
+      MPICheck(MPI_Comm_rank(MPI_COMM_WORLD, &rank), "MPI_Comm_rank"));
+  KATANA_CHECKED(
+      MPICheck(MPI_Comm_size(MPI_COMM_WORLD, &size), "MPI_Comm_size"));
+  comm->ID = rank;
+  comm->Num = size;
+  return comm;
+}
+
+katana::MPICommBackend::~MPICommBackend() {
+  if (finalize_) {
+    MPI_Finalize();
+  }
+}
+
+void
+katana::MPICommBackend::Barrier() {
+  MPICheckFatal(MPI_Barrier(MPI_COMM_WORLD), "MPI_Barrier");
+}
+
+bool
+katana::MPICommBackend::Broadcast(uint32_t root, bool val) {
+  uint8_t byte = val;
+  MPICheckFatal(
+      MPI_Bcast(&byte, 1, MPI_UINT8_T, root, MPI_COMM_WORLD), "MPI_Bcast");
+  return byte != 0;
+}
+
+std::string
+katana::MPICommBackend::Broadcast(
+    uint32_t root, const std::string& val, uint64_t max_size) {
+  std::string str;
+  if (ID == root) {
+    str = val.substr(0, max_size);
+  }
+  uint64_t size = str.size();
+  MPICheckFatal(
+      MPI_Bcast(&size, 1, MPI_UINT64_T, root, MPI_COMM_WORLD), "MPI_Bcast");
+  str.resize(size);
+  auto count_res = ToMPICount(size);
+  if (!count_res) {
+    KATANA_LOG_FATAL("{}", count_res.error());
+  }
+  MPICheckFatal(
+      MPI_Bcast(
+          str.data(), count_res.value(), MPI_CHAR, root, MPI_COMM_WORLD),
+      "MPI_Bcast");
+  return str;
+}
+
+void
+katana::MPICommBackend::NotifyFailure() {
+  MPI_Abort(MPI_COMM_WORLD, 1);
+}
+
+katana::Result<void>
+katana::MPICommBackend::ReduceBuffer(
+    uint32_t root, ReduceOp op, DataType type, const void* in, void* out,
+    size_t count) {
+  int mpi_count = KATANA_CHECKED(ToMPICount(count));
+  const void* send = (in == out && ID == root) ? MPI_IN_PLACE : in;
+  return MPICheck(
+      MPI_Reduce(
+          send, out, mpi_count, ToMPIType(type), ToMPIOp(op), root,
+          MPI_COMM_WORLD),
+      "MPI_Reduce");
+}
+
+katana::Result<void>
+katana::MPICommBackend::AllReduceBuffer(
+    ReduceOp op, DataType type, const void* in, void* out, size_t count) {
+  int mpi_count = KATANA_CHECKED(ToMPICount(count));
+  const void* send = in == out ? MPI_IN_PLACE : in;
+  return MPICheck(
+      MPI_Allreduce(
+          send, out, mpi_count, ToMPIType(type), ToMPIOp(op), MPI_COMM_WORLD),
+      "MPI_Allreduce");
+}
+
+katana::Result<std::vector<std::vector<uint8_t>>>
+katana::MPICommBackend::AllToAll(
+    const std::vector<std::vector<uint8_t>>& send) {
+  if (send.size() != Num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} buffers to send to {} tasks",
+        send.size(), Num);
+  }
+
+  // exchange the sizes first so that each task can place what it receives
+  std::vector<uint64_t> send_sizes(Num);
+  std::vector<uint64_t> recv_sizes(Num);
+  for (uint32_t i = 0; i < Num; ++i) {
+    send_sizes[i] = send[i].size();
+  }
+  KATANA_CHECKED(MPICheck(
+      MPI_Alltoall(
+          send_sizes.data(), 1, MPI_UINT64_T, recv_sizes.data(), 1,
+          MPI_UINT64_T, MPI_COMM_WORLD),
+      "MPI_Alltoall"));
+
+  std::vector<int> send_counts(Num);
+  std::vector<int> send_offsets(Num);
+  std::vector<int> recv_counts(Num);
+  std::vector<int> recv_offsets(Num);
+  uint64_t send_total = 0;
+  uint64_t recv_total = 0;
+  for (uint32_t i = 0; i < Num; ++i) {
+    send_offsets[i] = KATANA_CHECKED(ToMPICount(send_total));
+    recv_offsets[i] = KATANA_CHECKED(ToMPICount(recv_total));
+    send_counts[i] = KATANA_CHECKED(ToMPICount(send_sizes[i]));
+    recv_counts[i] = KATANA_CHECKED(ToMPICount(recv_sizes[i]));
+    send_total += send_sizes[i];
+    recv_total += recv_sizes[i];
+  }
+  KATANA_CHECKED(ToMPICount(send_total));
+  KATANA_CHECKED(ToMPICount(recv_total));
+
+  std::vector<uint8_t> send_buffer;
+  send_buffer.reserve(send_total);
+  for (const auto& buffer : send) {
+    send_buffer.insert(send_buffer.end(), buffer.begin(), buffer.end());
+  }
+  std::vector<uint8_t> recv_buffer(recv_total);
+  KATANA_CHECKED(MPICheck(
+      MPI_Alltoallv(
+          send_buffer.data(), send_counts.data(), send_offsets.data(),
+          MPI_BYTE, recv_buffer.data(), recv_counts.data(),
+          recv_offsets.data(), MPI_BYTE, MPI_COMM_WORLD),
+      "MPI_Alltoallv"));
+
+  std::vector<std::vector<uint8_t>> received(Num);
+  for (uint32_t i = 0; i < Num; ++i) {
+    auto begin = recv_buffer.begin() + recv_offsets[i];
+    received[i].assign(begin, begin + recv_counts[i]);
+  }
+  return received;
+}
+
+katana::Result<std::unique_ptr<katana::CommRequest>>
+katana::MPICommBackend::ISend(
+    uint32_t dest, int tag, std::vector<uint8_t> buffer) {
+  KATANA_CHECKED(CheckPeer(dest, tag, Num));
+  auto request = std::make_unique<MPISendRequest>(std::move(buffer));
+  KATANA_CHECKED(request->Start(dest, tag));
+  return std::unique_ptr<CommRequest>(std::move(request));
+}
+
+katana::Result<std::unique_ptr<katana::CommRequest>>
+katana::MPICommBackend::IRecv(uint32_t source, int tag) {
+  KATANA_CHECKED(CheckPeer(source, tag, Num));
+  return std::unique_ptr<CommRequest>(
+      std::make_unique<MPIRecvRequest>(source, tag));
+}
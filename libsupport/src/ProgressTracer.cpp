@@ -119,6 +119,12 @@ katana::ProgressTracer::StartActiveSpan(
   return SetActiveSpan(StartSpan(span_name, child_of));
 }
 
+std::shared_ptr<katana::ProgressSpan>
+katana::ProgressTracer::StartActiveSpanUnscoped(const std::string& span_name) {
+  active_span_ = StartSpan(span_name, active_span_);
+  return active_span_;
+}
+
 void
 katana::ProgressTracer::FinishActiveSpan() {
   if (active_span_ != nullptr) {
@@ -0,0 +1,21 @@
+#include "katana/PropertyMemoryPool.h"
+
+#include <atomic>
+
+namespace {
+
+std::atomic<arrow::MemoryPool*> property_memory_pool{nullptr};
+
+}  // namespace
+
+arrow::MemoryPool*
+katana::PropertyMemoryPool() {
+  arrow::MemoryPool* pool =
+      property_memory_pool.load(std::memory_order_acquire);
+  return pool != nullptr ? pool : arrow::default_memory_pool();
+}
+
+void
+katana::SetPropertyMemoryPool(arrow::MemoryPool* pool) {
+  property_memory_pool.store(pool, std::memory_order_release);
+}
@@ -64,6 +64,41 @@ MakeSystemGenerator() {
 
 thread_local std::unique_ptr<katana::RandGenerator> kRNG;
 
+constexpr uint64_t kLanes = 16;
+
+/// The Philox4x32 blocks of kLanes consecutive items, one array per word of
+/// the block so that each round is a loop over lanes that the compiler
+/// vectorizes
+struct PhiloxLanes {
+  std::array<uint32_t, kLanes> words[4];
+
+  void Generate(uint64_t seed, uint64_t first_item, uint32_t step) {
+    using katana::Philox4x32;
+    for (uint64_t l = 0; l < kLanes; ++l) {
+      uint64_t item = first_item + l;
+      words[0][l] = static_cast<uint32_t>(item);
+      words[1][l] = static_cast<uint32_t>(item >> 32);
+      words[2][l] = step;
+      words[3][l] = 0;
+    }
+    Philox4x32::Key key = Philox4x32::MakeKey(seed);
+    for (int r = 0; r < Philox4x32::kRounds; ++r) {
+      for (uint64_t l = 0; l < kLanes; ++l) {
+        uint64_t p0 = uint64_t{Philox4x32::kMultiplier0} * words[0][l];
+        uint64_t p1 = uint64_t{Philox4x32::kMultiplier1} * words[2][l];
+        uint32_t c1 = words[1][l];
+        uint32_t c3 = words[3][l];
+        words[0][l] = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ key[0];
+        words[1][l] = static_cast<uint32_t>(p1);
+        words[2][l] = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ key[1];
+        words[3][l] = static_cast<uint32_t>(p0);
+      }
+      key[0] += Philox4x32::kWeyl0;
+      key[1] += Philox4x32::kWeyl1;
+    }
+  }
+};
+
 }  // namespace
 
 katana::RandGenerator&
@@ -81,6 +116,14 @@ katana::GetGenerator() {
   return *kRNG;
 }
 
+katana::RandGenerator
+katana::MakeStreamGenerator(uint64_t seed, uint64_t stream) {
+  std::seed_seq seq{
+      static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+      static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)};
+  return RandGenerator(seq);
+}
+
 std::string
 katana::RandomAlphanumericString(uint64_t len, RandGenerator* gen) {
   if (gen == nullptr) {
@@ -95,3 +138,35 @@ katana::RandomAlphanumericString(uint64_t len, RandGenerator* gen) {
   std::generate_n(std::begin(result), len, [&]() { return chars[dist(*gen)]; });
   return result;
 }
+
+void
+katana::FillCounterRandom(
+    uint64_t seed, uint64_t first_item, uint32_t step, uint64_t num,
+    uint32_t* out) {
+  uint64_t i = 0;
+  PhiloxLanes lanes;
+  for (; i + kLanes <= num; i += kLanes) {
+    lanes.Generate(seed, first_item + i, step);
+    std::copy(lanes.words[0].begin(), lanes.words[0].end(), out + i);
+  }
+  for (; i < num; ++i) {
+    out[i] = CounterRandom(seed, first_item + i, step);
+  }
+}
+
+void
+katana::FillCounterUniform(
+    uint64_t seed, uint64_t first_item, uint32_t step, uint64_t num,
+    double* out) {
+  uint64_t i = 0;
+  PhiloxLanes lanes;
+  for (; i + kLanes <= num; i += kLanes) {
+    lanes.Generate(seed, first_item + i, step);
+    for (uint64_t l = 0; l < kLanes; ++l) {
+      out[i + l] = ToUniformDouble(lanes.words[0][l], lanes.words[1][l]);
+    }
+  }
+  for (; i < num; ++i) {
+    out[i] = CounterUniform(seed, first_item + i, step);
+  }
+}
@@ -0,0 +1,57 @@
+#include "katana/TaskScheduler.h"
+
+#include "katana/Logging.h"
+
+void
+katana::TaskScheduler::Post(Task task) {
+  ready_.emplace_back(std::move(task));
+  total_ += 1;
+}
+
+void
+katana::TaskScheduler::AddWaiting(Waiting waiting) {
+  waiting_.emplace_back(std::move(waiting));
+  total_ += 1;
+}
+
+void
+katana::TaskScheduler::PollWaiting() {
+  for (auto it = waiting_.begin(); it != waiting_.end();) {
+    if (it->ready()) {
+      ready_.emplace_back(std::move(it->task));
+      it = waiting_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+katana::Result<void>
+katana::TaskScheduler::Run() {
+  while (!ready_.empty() || !waiting_.empty()) {
+    PollWaiting();
+    if (ready_.empty()) {
+      waiting_.front().wait();
+      continue;
+    }
+
+    Task task = std::move(ready_.front());
+    ready_.pop_front();
+    auto res = task();
+    if (!res) {
+      KATANA_LOG_ERROR("task returned {}", res.error());
+      errors_ += 1;
+      last_error_ = res.error();
+    }
+  }
+
+  uint64_t errors = errors_;
+  uint64_t total = total_;
+  errors_ = 0;
+  total_ = 0;
+  if (errors > 0) {
+    return last_error_.WithContext(
+        "{} of {} tasks returned errors", errors, total);
+  }
+  return ResultSuccess();
+}
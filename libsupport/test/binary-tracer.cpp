@@ -0,0 +1,132 @@
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "katana/BinaryTracer.h"
+#include "katana/Logging.h"
+#include "katana/URI.h"
+
+namespace {
+
+constexpr int kNumThreads = 4;
+constexpr int kLogsPerThread = 100;
+
+std::vector<katana::BinaryTraceRecord>
+ReadTrace(const std::string& path, katana::BinaryTraceHeader* header) {
+  FILE* file = std::fopen(path.c_str(), "rb");
+  KATANA_LOG_ASSERT(file);
+  KATANA_LOG_ASSERT(std::fread(header, sizeof(*header), 1, file) == 1);
+
+  std::vector<katana::BinaryTraceRecord> records;
+  katana::BinaryTraceRecord record;
+  while (std::fread(&record, sizeof(record), 1, file) == 1) {
+    records.emplace_back(record);
+  }
+  std::fclose(file);
+  return records;
+}
+
+void
+TestTrace(const std::string& path) {
+  auto tracer_res = katana::BinaryTracer::Make(path, 1, 2);
+  KATANA_LOG_ASSERT(tracer_res);
+  katana::ProgressTracer::Set(std::move(tracer_res.value()));
+  auto& tracer = katana::GetTracer();
+
+  {
+    auto scope = tracer.StartActiveSpan("root");
+    scope.span().SetTags({{"answer", 42}, {"kind", "test"}, {"ok", true}});
+
+    auto child = tracer.StartActiveSpan("child");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+      threads.emplace_back([&] {
+        for (int j = 0; j < kLogsPerThread; ++j) {
+          child.span().Log("working", {{"iteration", j}});
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+
+    std::string carrier = tracer.Inject(child.span().GetContext());
+    auto ctx = tracer.Extract(carrier);
+    KATANA_LOG_ASSERT(ctx);
+    KATANA_LOG_ASSERT(
+        ctx->GetSpanID() == child.span().GetContext().GetSpanID());
+    KATANA_LOG_ASSERT(!tracer.Extract("not a carrier"));
+  }
+  tracer.Finish();
+
+  katana::BinaryTraceHeader header;
+  std::vector<katana::BinaryTraceRecord> records = ReadTrace(path, &header);
+  KATANA_LOG_ASSERT(
+      std::memcmp(
+          header.magic, katana::kBinaryTraceMagic, sizeof(header.magic)) == 0);
+  KATANA_LOG_ASSERT(header.version == katana::kBinaryTraceVersion);
+  KATANA_LOG_ASSERT(header.record_size == sizeof(katana::BinaryTraceRecord));
+  KATANA_LOG_ASSERT(header.host_id == 1 && header.num_hosts == 2);
+
+  std::map<int, int> kinds;
+  std::map<std::string, katana::BinaryTraceRecord> starts;
+  for (const auto& record : records) {
+    kinds[record.kind] += 1;
+    if (record.kind == katana::BinaryTraceRecord::kStart) {
+      starts[std::string(record.text, record.text_length)] = record;
+    }
+  }
+  KATANA_LOG_ASSERT(kinds[katana::BinaryTraceRecord::kStart] == 2);
+  KATANA_LOG_ASSERT(kinds[katana::BinaryTraceRecord::kFinish] == 2);
+  KATANA_LOG_ASSERT(
+      kinds[katana::BinaryTraceRecord::kLog] == kNumThreads * kLogsPerThread);
+  KATANA_LOG_ASSERT(kinds[katana::BinaryTraceRecord::kTag] == 3);
+  KATANA_LOG_ASSERT(
+      kinds[katana::BinaryTraceRecord::kLogTag] ==
+      kNumThreads * kLogsPerThread);
+  KATANA_LOG_ASSERT(kinds[katana::BinaryTraceRecord::kDropped] == 0);
+
+  KATANA_LOG_ASSERT(starts.count("root") && starts.count("child"));
+  KATANA_LOG_ASSERT(starts["child"].parent_id == starts["root"].span_id);
+  KATANA_LOG_ASSERT(starts["child"].value == starts["root"].value);
+}
+
+void
+TestDropped(const std::string& path) {
+  auto tracer_res = katana::BinaryTracer::Make(path, 0, 1, 8, 60 * 1000);
+  KATANA_LOG_ASSERT(tracer_res);
+  std::unique_ptr<katana::BinaryTracer> tracer = std::move(tracer_res.value());
+  katana::BinaryTracer* binary_tracer = tracer.get();
+  katana::ProgressTracer::Set(std::move(tracer));
+
+  {
+    auto scope = katana::GetTracer().StartActiveSpan("overflowing");
+    for (int i = 0; i < 100; ++i) {
+      scope.span().Log("too fast to flush");
+    }
+    KATANA_LOG_ASSERT(binary_tracer->dropped_records() > 0);
+  }
+  katana::GetTracer().Finish();
+
+  katana::BinaryTraceHeader header;
+  std::vector<katana::BinaryTraceRecord> records = ReadTrace(path, &header);
+  KATANA_LOG_ASSERT(records.size() == 9);
+  KATANA_LOG_ASSERT(records.back().kind == katana::BinaryTraceRecord::kDropped);
+}
+
+}  // namespace
+
+int
+main() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/binarytracer");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string path(uri_res.value().path());
+
+  TestTrace(path);
+  TestDropped(path);
+
+  std::remove(path.c_str());
+  return 0;
+}
@@ -1,5 +1,8 @@
 #include "katana/BitMath.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "katana/Logging.h"
 
 int
@@ -27,4 +30,40 @@ main() {
   KATANA_LOG_ASSERT(katana::AlignUp<StrangeSize>(1) == 37);
   KATANA_LOG_ASSERT(katana::AlignUp<StrangeSize>(1024) == 1036);
   KATANA_LOG_ASSERT(katana::AlignDown<StrangeSize>(1024) == 999);
+
+  KATANA_LOG_ASSERT(katana::ZigZagEncode(0) == 0);
+  KATANA_LOG_ASSERT(katana::ZigZagEncode(-1) == 1);
+  KATANA_LOG_ASSERT(katana::ZigZagEncode(1) == 2);
+  KATANA_LOG_ASSERT(katana::ZigZagEncode(-2) == 3);
+  for (int64_t v : {INT64_MIN, INT64_C(-300), INT64_C(0), INT64_C(127),
+                    INT64_C(1) << 40, INT64_MAX}) {
+    KATANA_LOG_ASSERT(katana::ZigZagDecode(katana::ZigZagEncode(v)) == v);
+  }
+
+  KATANA_LOG_ASSERT(katana::VarintSize(0) == 1);
+  KATANA_LOG_ASSERT(katana::VarintSize(127) == 1);
+  KATANA_LOG_ASSERT(katana::VarintSize(128) == 2);
+  KATANA_LOG_ASSERT(katana::VarintSize(UINT64_MAX) == 10);
+
+  uint8_t buf[10];
+  for (uint64_t v : {UINT64_C(0), UINT64_C(1), UINT64_C(300),
+                     UINT64_C(1) << 35, UINT64_MAX}) {
+    size_t written = katana::EncodeVarint(v, buf);
+    KATANA_LOG_ASSERT(written == katana::VarintSize(v));
+    uint64_t decoded = 0;
+    KATANA_LOG_ASSERT(
+        katana::DecodeVarint(buf, buf + written, &decoded) == written);
+    KATANA_LOG_ASSERT(decoded == v);
+    // Truncated
+    KATANA_LOG_ASSERT(
+        katana::DecodeVarint(buf, buf + written - 1, &decoded) == 0);
+  }
+
+  // More continuation bytes than any uint64_t needs
+  uint8_t overlong[11];
+  std::fill(std::begin(overlong), std::end(overlong), 0x80);
+  overlong[10] = 0;
+  uint64_t decoded = 0;
+  KATANA_LOG_ASSERT(
+      katana::DecodeVarint(overlong, std::end(overlong), &decoded) == 0);
 }
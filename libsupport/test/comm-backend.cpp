@@ -0,0 +1,85 @@
+#include "katana/CommBackend.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace {
+
+void
+TestCollectives(katana::CommBackend* comm) {
+  using ReduceOp = katana::CommBackend::ReduceOp;
+
+  auto sum = comm->AllReduce(ReduceOp::kSum, uint64_t{42});
+  KATANA_LOG_ASSERT(sum && sum.value() == 42);
+  auto min = comm->AllReduce(ReduceOp::kMin, -1.5);
+  KATANA_LOG_ASSERT(min && min.value() == -1.5);
+
+  std::vector<int64_t> in{1, -2, 3};
+  std::vector<int64_t> out(in.size());
+  KATANA_LOG_ASSERT(
+      comm->Reduce(0, ReduceOp::kMax, in.data(), out.data(), in.size()));
+  KATANA_LOG_ASSERT(out == in);
+  // in place
+  KATANA_LOG_ASSERT(
+      comm->AllReduce(ReduceOp::kSum, in.data(), in.data(), in.size()));
+  KATANA_LOG_ASSERT(in == out);
+  KATANA_LOG_ASSERT(!comm->Reduce(1, ReduceOp::kMax, in.data(), out.data(), 1));
+
+  std::vector<std::vector<uint8_t>> send{{1, 2, 3}};
+  auto received = comm->AllToAll(send);
+  KATANA_LOG_ASSERT(received && received.value() == send);
+  auto too_many = comm->AllToAll({{1}, {2}});
+  KATANA_LOG_ASSERT(
+      !too_many && too_many.error() == katana::ErrorCode::InvalidArgument);
+}
+
+void
+TestPointToPoint(katana::CommBackend* comm) {
+  // a receive posted before the send finishes once the send is made
+  auto early = comm->IRecv(0, 7);
+  KATANA_LOG_ASSERT(early);
+  auto early_done = early.value()->Test();
+  KATANA_LOG_ASSERT(early_done && !early_done.value());
+
+  for (uint8_t i = 0; i < 3; ++i) {
+    auto send = comm->ISend(0, 7, {i, i});
+    KATANA_LOG_ASSERT(send);
+    KATANA_LOG_ASSERT(send.value()->Wait());
+  }
+  KATANA_LOG_ASSERT(comm->ISend(0, 8, {9}));
+
+  // messages with a tag arrive in order
+  auto first = early.value()->Wait();
+  KATANA_LOG_ASSERT(first && first.value() == std::vector<uint8_t>({0, 0}));
+  for (uint8_t i = 1; i < 3; ++i) {
+    auto recv = comm->IRecv(0, 7);
+    KATANA_LOG_ASSERT(recv);
+    auto message = recv.value()->Wait();
+    KATANA_LOG_ASSERT(
+        message && message.value() == std::vector<uint8_t>({i, i}));
+  }
+  auto other = comm->IRecv(0, 8);
+  KATANA_LOG_ASSERT(other);
+  auto other_message = other.value()->Wait();
+  KATANA_LOG_ASSERT(
+      other_message && other_message.value() == std::vector<uint8_t>({9}));
+
+  // nothing more was sent, so there is nothing to wait for
+  auto none = comm->IRecv(0, 7);
+  KATANA_LOG_ASSERT(none);
+  KATANA_LOG_ASSERT(!none.value()->Wait());
+  KATANA_LOG_ASSERT(!comm->ISend(1, 7, {}));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::NullCommBackend comm;
+  TestCollectives(&comm);
+  TestPointToPoint(&comm);
+  return 0;
+}
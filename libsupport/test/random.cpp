@@ -1,10 +1,98 @@
 #include "katana/Random.h"
 
+#include <array>
+#include <cstdint>
 #include <thread>
 #include <vector>
 
 #include "katana/Logging.h"
 
+namespace {
+
+void
+TestPhiloxKnownAnswers() {
+  // from the known answer tests of the Random123 library
+  using katana::Philox4x32;
+  KATANA_LOG_ASSERT(
+      Philox4x32::Generate({0, 0, 0, 0}, {0, 0}) ==
+      (Philox4x32::Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+  KATANA_LOG_ASSERT(
+      Philox4x32::Generate(
+          {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+          {0xffffffff, 0xffffffff}) ==
+      (Philox4x32::Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+  KATANA_LOG_ASSERT(
+      Philox4x32::Generate(
+          {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+          {0xa4093822, 0x299f31d0}) ==
+      (Philox4x32::Counter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+void
+TestCounterGenerator() {
+  // the same (seed, item, step) gives the same sequence on any thread
+  constexpr int kItems = 64;
+  std::vector<std::array<uint32_t, 8>> results(kItems);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kItems; ++i) {
+    threads.emplace_back([&results, i]() {
+      katana::CounterGenerator gen(8675309, i % 4, 3);
+      for (auto& val : results[i]) {
+        val = gen();
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  for (int i = 0; i < kItems; ++i) {
+    KATANA_LOG_ASSERT(results[i] == results[i % 4]);
+  }
+  KATANA_LOG_ASSERT(results[0] != results[1]);
+  KATANA_LOG_ASSERT(results[1][0] == katana::CounterRandom(8675309, 1, 3));
+
+  // any change of the key gives different values
+  uint32_t val = katana::CounterRandom(1, 2, 3);
+  KATANA_LOG_ASSERT(val != katana::CounterRandom(0, 2, 3));
+  KATANA_LOG_ASSERT(val != katana::CounterRandom(1, 1, 3));
+  KATANA_LOG_ASSERT(val != katana::CounterRandom(1, 2, 4));
+  KATANA_LOG_ASSERT(
+      val != katana::CounterRandom(1, 2 + (uint64_t{1} << 32), 3));
+
+  katana::CounterGenerator skipped(1, 2);
+  katana::CounterGenerator drawn(1, 2);
+  for (int i = 0; i < 13; ++i) {
+    drawn();
+  }
+  skipped.discard(13);
+  KATANA_LOG_ASSERT(skipped() == drawn());
+
+  katana::CounterGenerator gen(1, 2);
+  for (int i = 0; i < 1000; ++i) {
+    double u = gen.NextDouble();
+    KATANA_LOG_ASSERT(u >= 0.0 && u < 1.0);
+  }
+}
+
+void
+TestFill() {
+  // sizes around the batch size, which must not change the values
+  for (uint64_t num : {0U, 1U, 15U, 16U, 17U, 100U}) {
+    std::vector<uint32_t> ints(num);
+    std::vector<double> doubles(num);
+    katana::FillCounterRandom(42, 1000, 7, num, ints.data());
+    katana::FillCounterUniform(42, 1000, 7, num, doubles.data());
+    for (uint64_t i = 0; i < num; ++i) {
+      KATANA_LOG_ASSERT(ints[i] == katana::CounterRandom(42, 1000 + i, 7));
+      katana::CounterGenerator gen(42, 1000 + i, 7);
+      KATANA_LOG_ASSERT(doubles[i] == gen.NextDouble());
+      KATANA_LOG_ASSERT(doubles[i] == katana::CounterUniform(42, 1000 + i, 7));
+    }
+  }
+}
+
+}  // namespace
+
 int
 main() {
   // test to make sure we have enough randomness
@@ -48,5 +136,9 @@ main() {
         first_val, val);
   }
 
+  TestPhiloxKnownAnswers();
+  TestCounterGenerator();
+  TestFill();
+
   return 0;
 }
@@ -0,0 +1,107 @@
+#include "katana/TaskScheduler.h"
+
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// Tasks that are ready run while another task waits for I/O
+void
+TestOverlap() {
+  katana::TaskScheduler scheduler;
+  std::vector<std::string> order;
+
+  std::promise<katana::CopyableResult<int>> io;
+  std::thread io_thread;
+
+  scheduler.Then(io.get_future(), [&](int value) {
+    order.emplace_back("io " + std::to_string(value));
+    return katana::CopyableResultSuccess();
+  });
+  scheduler.Post([&]() -> katana::CopyableResult<void> {
+    order.emplace_back("cpu");
+    // finish the I/O only once the task that does not wait for it has run
+    io_thread = std::thread([&] { io.set_value(42); });
+    return katana::CopyableResultSuccess();
+  });
+
+  auto res = scheduler.Run();
+  io_thread.join();
+  KATANA_LOG_ASSERT(res);
+  KATANA_LOG_ASSERT(order == std::vector<std::string>({"cpu", "io 42"}));
+  KATANA_LOG_ASSERT(scheduler.num_pending() == 0);
+}
+
+/// Spawned tasks and the tasks that wait for them, added from tasks
+void
+TestSpawn() {
+  katana::TaskScheduler scheduler;
+  int sum = 0;
+
+  scheduler.Post([&]() -> katana::CopyableResult<void> {
+    for (int i = 1; i <= 3; ++i) {
+      auto future =
+          scheduler.Spawn([i]() -> katana::CopyableResult<int> { return i; });
+      scheduler.Then(std::move(future), [&](int value) {
+        sum += value;
+        return katana::CopyableResultSuccess();
+      });
+    }
+    return katana::CopyableResultSuccess();
+  });
+
+  // deferred futures run when their task does
+  auto deferred = std::async(
+      std::launch::deferred, []() -> katana::CopyableResult<int> { return 4; });
+  scheduler.Then(std::move(deferred), [&](int value) {
+    sum += value;
+    return katana::CopyableResultSuccess();
+  });
+
+  KATANA_LOG_ASSERT(scheduler.Run());
+  KATANA_LOG_ASSERT(sum == 10);
+}
+
+/// Errors of futures skip their tasks but not the others
+void
+TestErrors() {
+  katana::TaskScheduler scheduler;
+  bool ran_failed = false;
+  bool ran_other = false;
+
+  std::promise<katana::CopyableResult<void>> failed;
+  failed.set_value(katana::CopyableErrorInfo(
+      std::error_code(katana::ErrorCode::NotFound)));
+  scheduler.Then(failed.get_future(), [&] {
+    ran_failed = true;
+    return katana::CopyableResultSuccess();
+  });
+  scheduler.Post([&]() -> katana::CopyableResult<void> {
+    ran_other = true;
+    return katana::CopyableResultSuccess();
+  });
+
+  auto res = scheduler.Run();
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::NotFound);
+  KATANA_LOG_ASSERT(!ran_failed && ran_other);
+
+  // the errors of a run do not carry over to the next
+  KATANA_LOG_ASSERT(scheduler.Run());
+}
+
+}  // namespace
+
+int
+main() {
+  TestOverlap();
+  TestSpawn();
+  TestErrors();
+
+  return 0;
+}
@@ -26,6 +26,48 @@ struct CSRTopologyPrefix {
   uint64_t out_indexes[];  // NOLINT needed for layout
 };
 
+/// Version 3 files store destinations compressed. The layout is
+///
+///   CSRTopologyHeader (version 3, edge_type_size 0)
+///   uint64_t[num_nodes] out_indexes (as in version 1)
+///   uint64_t[num_blocks + 1] block_offsets: byte offset into the encoded
+///     edges of the first edge of nodes 0, kCSRCompressedBlockNodes,
+///     2 * kCSRCompressedBlockNodes, ...; the last entry is the total size
+///   uint8_t[] encoded edges
+///
+/// Each destination is a LEB128 varint of the zigzag encoded difference from
+/// the previous destination of the same node, or from the node itself for its
+/// first edge. Edge order is preserved so edge property indexes do not
+/// change; sorted adjacency lists compress best. block_offsets lets blocks be
+/// decoded independently and in parallel.
+///
+/// The compression is on disk only. Loading decodes every block into an
+/// uncompressed GraphTopology, so it saves storage and I/O but not memory,
+/// and nothing iterates over the encoded edges in place.
+constexpr uint64_t kCSRTopologyCompressedVersion = 3;
+constexpr uint64_t kCSRCompressedBlockNodes = 64;
+
+constexpr uint64_t
+CSRCompressedNumBlocks(uint64_t num_nodes) {
+  return (num_nodes + kCSRCompressedBlockNodes - 1) / kCSRCompressedBlockNodes;
+}
+
+/// Offset of block_offsets in a version 3 file
+constexpr uint64_t
+CSRCompressedBlockOffsetsOffset(const CSRTopologyHeader& header) {
+  return sizeof(header) + header.num_nodes * sizeof(uint64_t);
+}
+
+/// Offset of the encoded edges in a version 3 file
+constexpr uint64_t
+CSRCompressedEdgesOffset(const CSRTopologyHeader& header) {
+  return CSRCompressedBlockOffsetsOffset(header) +
+         (CSRCompressedNumBlocks(header.num_nodes) + 1) * sizeof(uint64_t);
+}
+
+/// Size of an uncompressed (version 1 or 2) topology file. The size of a
+/// version 3 file depends on its contents; it is CSRCompressedEdgesOffset
+/// plus the last entry of block_offsets.
 constexpr uint64_t
 CSRTopologyFileSize(const CSRTopologyHeader& header) {
   uint64_t edge_size =
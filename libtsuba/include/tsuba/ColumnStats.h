@@ -0,0 +1,40 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_COLUMNSTATS_H_
+#define KATANA_LIBTSUBA_TSUBA_COLUMNSTATS_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include <arrow/api.h>
+
+#include "katana/config.h"
+
+namespace tsuba {
+
+/// Summary of the values of one property, recorded when the property is
+/// stored so that readers can choose how to use a property before scanning
+/// it.
+struct KATANA_EXPORT ColumnStats {
+  int64_t num_rows{0};
+  int64_t null_count{0};
+
+  /// Smallest and largest non-null values, widened to int64, uint64, double,
+  /// boolean or string. Null if the column has no non-null values or its
+  /// type is not one of the integer, floating point, boolean, string or
+  /// temporal types. NaNs and infinities are ignored. For strings, both are
+  /// null if either is not valid UTF-8 or max is longer than 256 bytes, and
+  /// a longer min is cut to a prefix of at most 256 bytes, which is still a
+  /// lower bound.
+  std::shared_ptr<arrow::Scalar> min;
+  std::shared_ptr<arrow::Scalar> max;
+
+  /// HyperLogLog estimate of the number of distinct non-null values, with a
+  /// standard error of about 1.6%. Unset for the same types as min and max.
+  std::optional<uint64_t> distinct_estimate;
+
+  static ColumnStats Compute(const arrow::ChunkedArray& column);
+};
+
+}  // namespace tsuba
+
+#endif
@@ -70,6 +70,8 @@ public:
   std::future<katana::CopyableResult<void>> PersistAsync();
 
   uint64_t map_size() const { return map_size_; }
+  /// the number of bytes written, which is what Persist stores
+  uint64_t size() const { return cursor_; }
 
   template <typename T>
   katana::Result<T*> ptr() const {
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <future>
+#include <string>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
@@ -14,6 +15,24 @@ namespace tsuba {
 
 struct StatBuf;
 
+/// How FileStorage::GetParallel and FileStorage::PutParallel split large
+/// transfers so that they are not limited by the throughput of one connection
+struct KATANA_EXPORT TransferOpts {
+  static constexpr uint64_t kDefaultPartSize = UINT64_C(64) << 20;
+  static constexpr uint32_t kDefaultMaxParallelParts = 16;
+  /// most backends limit the number of parts in one upload
+  static constexpr uint64_t kMaxParts = 10000;
+
+  /// transfers larger than this are split into parts of about this size
+  uint64_t part_size{kDefaultPartSize};
+  /// bound on the parts of one transfer in flight at once; 1 disables
+  /// splitting
+  uint32_t max_parallel_parts{kDefaultMaxParallelParts};
+
+  /// Read KATANA_TSUBA_PART_SIZE_MB and KATANA_TSUBA_MAX_PARALLEL_PARTS
+  static katana::Result<TransferOpts> FromEnv();
+};
+
 class KATANA_EXPORT FileStorage {
   std::string uri_scheme_;
 
@@ -48,6 +67,47 @@ public:
   /// to the LocalStorage when no protocol on the URI is provided
   virtual uint32_t Priority() const { return 0; }
 
+  /// Local backends are read directly; reads from all other backends go
+  /// through the local file cache when it is enabled (see FileCache.h)
+  virtual bool IsLocal() const { return false; }
+
+  /// Map the first \param size bytes of \param uri read-only into memory
+  /// so that callers can read it without copying. Backends that cannot do
+  /// this return ErrorCode::NotImplemented and callers should fall back to
+  /// GetAsync. Unmap the result with munmap.
+  virtual katana::Result<uint8_t*> MapReadOnly(
+      const std::string& uri, uint64_t size);
+
+  /// Multipart uploads assemble one object from parts uploaded concurrently.
+  /// Backends that cannot do this return ErrorCode::NotImplemented from
+  /// BeginMultipartPut and callers should fall back to PutMultiSync.
+  ///
+  /// \returns an identifier for the upload to pass to the other calls
+  virtual katana::Result<std::string> BeginMultipartPut(const std::string& uri);
+  /// Upload part \param part_num (counting from 0) of \param upload_id.
+  /// Parts may be uploaded in any order.
+  virtual std::future<katana::CopyableResult<void>> PutPartAsync(
+      const std::string& uri, const std::string& upload_id, uint64_t part_num,
+      const uint8_t* data, uint64_t size);
+  /// Make \param uri the concatenation of parts [0, \param num_parts)
+  virtual katana::Result<void> CompleteMultipartPut(
+      const std::string& uri, const std::string& upload_id, uint64_t num_parts);
+  /// Discard the parts uploaded so far
+  virtual katana::Result<void> AbortMultipartPut(
+      const std::string& uri, const std::string& upload_id);
+
+  /// Like GetMultiSync, but split into ranged gets of opts.part_size that
+  /// are issued concurrently
+  katana::Result<void> GetParallel(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf, const TransferOpts& opts);
+
+  /// Like PutMultiSync, but upload parts of opts.part_size concurrently if
+  /// the backend supports multipart uploads
+  katana::Result<void> PutParallel(
+      const std::string& uri, const uint8_t* data, uint64_t size,
+      const TransferOpts& opts);
+
   // get on future can potentially block (bulk synchronous parallel)
   virtual std::future<katana::CopyableResult<void>> PutAsync(
       const std::string& uri, const uint8_t* data, uint64_t size) = 0;
@@ -3,6 +3,8 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 
@@ -15,6 +17,7 @@
 namespace tsuba {
 
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
+  struct ChecksumState;
   struct FillingRange {
     uint64_t first_page;
     uint64_t last_page;
@@ -22,14 +25,24 @@ class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
   };
 
   uint8_t* map_start_{nullptr};
+  // owns the mapping at map_start_; buffers returned by Read and ReadAt share
+  // it so that they stay valid after this view is unbound or destroyed
+  std::shared_ptr<uint8_t> mapping_;
   int64_t file_size_{0};
   uint8_t page_shift_{0};
   int64_t cursor_{0};
   int64_t mem_start_{0};
   std::string filename_;
   bool valid_{false};
+  // true when map_start_ is a read-only mapping of the file itself rather
+  // than anonymous memory filled by reads from storage
+  bool file_backed_{false};
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
+  // set when bound with an expected checksum; shared with fetches in flight
+  std::shared_ptr<ChecksumState> checksum_;
+  // serializes reads, which update the bookkeeping above; not moved
+  std::mutex read_mutex_;
 
 public:
   FileView() = default;
@@ -38,14 +51,17 @@ public:
 
   FileView(FileView&& other) noexcept
       : map_start_(other.map_start_),
+        mapping_(std::move(other.mapping_)),
         file_size_(other.file_size_),
         page_shift_(other.page_shift_),
         cursor_(other.cursor_),
         mem_start_(other.mem_start_),
         filename_(std::move(other.filename_)),
         valid_(other.valid_),
+        file_backed_(other.file_backed_),
         filling_(std::move(other.filling_)),
-        fetches_(std::move(other.fetches_)) {
+        fetches_(std::move(other.fetches_)),
+        checksum_(std::move(other.checksum_)) {
     other.valid_ = false;
   }
 
@@ -55,15 +71,18 @@ public:
         KATANA_LOG_ERROR("Unbind: {}", res.error());
       }
       map_start_ = other.map_start_;
+      mapping_ = std::move(other.mapping_);
       file_size_ = other.file_size_;
       page_shift_ = other.page_shift_;
       cursor_ = other.cursor_;
       mem_start_ = other.mem_start_;
       filename_ = std::move(other.filename_);
       valid_ = other.valid_;
+      file_backed_ = other.file_backed_;
       filling_ = std::move(other.filling_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
+      checksum_ = std::move(other.checksum_);
       other.valid_ = false;
     }
     return *this;
@@ -81,8 +100,20 @@ public:
   /// Calls to Read will handle asynchronous
   /// reads internally, but if you intend to use ptr(), you should pass
   /// resolve=true.
+  ///
+  /// If the storage backend supports it (see FileMapReadOnly), the whole file
+  /// is mapped directly and no data is copied; begin and end then only serve
+  /// as readahead hints.
+  ///
+  /// If \param crc32c is given, the file is checksummed as it is read (see
+  /// Crc32c) and the fill that completes the file returns
+  /// ErrorCode::ChecksumMismatch if it does not match. Files that are never
+  /// read completely are not checked. Mapped files are checked, by reading
+  /// the mapping, on the first fill of the whole file whether or not it is
+  /// resolved.
   katana::Result<void> Bind(
-      std::string_view filename, uint64_t begin, uint64_t end, bool resolve);
+      std::string_view filename, uint64_t begin, uint64_t end, bool resolve,
+      std::optional<uint32_t> crc32c = std::nullopt);
   katana::Result<void> Bind(
       std::string_view filename, uint64_t stop, bool resolve) {
     return Bind(filename, 0, stop, resolve);
@@ -95,6 +126,13 @@ public:
 
   bool Valid() const { return valid_; }
 
+  /// \returns true if this view maps the underlying file directly
+  bool FileBacked() const { return file_backed_; }
+
+  /// \returns a reference that keeps the memory of this view mapped even
+  /// after the view is unbound or destroyed
+  std::shared_ptr<const uint8_t> mapping() const { return mapping_; }
+
   katana::Result<void> Unbind();
 
   /// Be very careful with this function. It is the caller's responsibility to
@@ -138,7 +176,15 @@ public:
   bool closed() const override;
   arrow::Status Seek(int64_t) override;
   arrow::Result<int64_t> Read(int64_t, void*) override;
+  /// The returned buffer points into the mapping of this view rather than
+  /// holding a copy, and keeps the mapping alive
   arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t) override;
+  arrow::Result<int64_t> ReadAt(int64_t, int64_t, void*) override;
+  /// Like Read, the returned buffer is a slice of the mapping. Unlike the
+  /// default implementation, this does not move the cursor.
+  arrow::Result<std::shared_ptr<arrow::Buffer>> ReadAt(
+      int64_t, int64_t) override;
+  bool supports_zero_copy() const override { return true; }
   arrow::Result<int64_t> GetSize() override;
 
   ///// End arrow::io::RandomAccessFile methods ///////
@@ -167,6 +213,16 @@ private:
   // Resolve all outstanding reads that overlap with the range [cursor_, nbytes]
   katana::Result<void> Resolve(int64_t start, int64_t size);
 
+  // Make [position, position + nbytes) present in memory and start
+  // prefetching what follows it. Returns nbytes clipped to the end of the
+  // file. Call with read_mutex_ held.
+  arrow::Result<int64_t> PrepareRead(int64_t position, int64_t nbytes);
+
+  // Fetch pages [first_page, last_page] with a window of reads in flight,
+  // checksumming each read as soon as it arrives
+  std::future<katana::CopyableResult<void>> FetchAndChecksum(
+      uint64_t first_page, uint64_t last_page);
+
   // Start asynchronously fetching data that we think we might need from storage
   // @start and @size give the location and range of the previous read
   katana::Result<void> PreFetch(int64_t start, int64_t size);
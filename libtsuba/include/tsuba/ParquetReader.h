@@ -1,12 +1,17 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_PARQUETREADER_H_
 #define KATANA_LIBTSUBA_TSUBA_PARQUETREADER_H_
 
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <optional>
+#include <string>
 
 #include <arrow/api.h>
 
 #include "katana/Result.h"
 #include "katana/URI.h"
+#include "tsuba/PropertyPredicate.h"
 
 namespace parquet::arrow {
 
@@ -32,6 +37,22 @@ public:
     /// Slice.length rows starting from Slice.offset
     std::optional<Slice> slice{std::nullopt};
 
+    /// if true, decode the columns and row groups of a file concurrently on
+    /// arrow's cpu thread pool instead of on the calling thread
+    bool use_threads{false};
+
+    /// if provided, skip fetching row groups that cannot satisfy these
+    /// predicates and fill their rows with nulls (see PropertyPredicate).
+    /// Kept row groups are returned unfiltered. Predicates naming columns not
+    /// in the file are ignored, so they never prune other properties' files.
+    PropertyPredicates predicates;
+
+    /// if provided, the CRC32C of files by name (without their directory) as
+    /// recorded when they were written (see WriteGroup). Files, or parts of
+    /// blocked files, that are read completely are checked against them and
+    /// the read fails with ErrorCode::ChecksumMismatch if they differ.
+    std::shared_ptr<const std::map<std::string, uint32_t>> checksums;
+
     static ReadOpts Defaults() { return ReadOpts{}; }
   };
 
@@ -77,8 +98,15 @@ public:
   katana::Result<int64_t> NumRows(const katana::Uri& uri);
 
 private:
-  ParquetReader(std::optional<Slice> slice, bool make_cannonical)
-      : slice_(slice), make_cannonical_{make_cannonical} {}
+  ParquetReader(
+      std::optional<Slice> slice, bool make_cannonical, bool use_threads,
+      PropertyPredicates predicates,
+      std::shared_ptr<const std::map<std::string, uint32_t>> checksums)
+      : slice_(slice),
+        make_cannonical_{make_cannonical},
+        use_threads_{use_threads},
+        predicates_(std::move(predicates)),
+        checksums_(std::move(checksums)) {}
 
   katana::Result<std::shared_ptr<arrow::Table>> ReadFromUriSliced(
       const katana::Uri& uri);
@@ -91,6 +119,9 @@ private:
 
   std::optional<Slice> slice_;
   bool make_cannonical_;
+  bool use_threads_;
+  PropertyPredicates predicates_;
+  std::shared_ptr<const std::map<std::string, uint32_t>> checksums_;
 };
 
 }  // namespace tsuba
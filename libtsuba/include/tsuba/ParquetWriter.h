@@ -1,7 +1,11 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_PARQUETWRITER_H_
 #define KATANA_LIBTSUBA_TSUBA_PARQUETWRITER_H_
 
+#include <future>
 #include <limits>
+#include <list>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include <arrow/api.h>
@@ -29,8 +33,20 @@ public:
     /// represents the ith block of the table
     bool write_blocked{false};
 
-    /// control the approximate size of blocked files when writing blocked
+    /// control the approximate size of blocked files when writing blocked,
+    /// and of the parts that streamed tables are stored in
     uint64_t mbs_per_block{256};
+
+    /// if true, tables larger than about mbs_per_block are stored in parts
+    /// as they are encoded (see ParquetStreamWriter) rather than encoded as
+    /// one file in memory. Otherwise only tables with too many rows for one
+    /// file are split.
+    bool stream{false};
+
+    /// bound on the memory that storing one table holds at once, not counting
+    /// the table itself: rows gathered for the next part plus parts being
+    /// encoded and stored
+    uint64_t max_stream_mbs{1024};
     static WriteOpts Defaults() { return WriteOpts{}; }
   };
 
@@ -77,6 +93,66 @@ private:
   WriteOpts opts_;
 };
 
+/// Store a table as it is produced, with bounded memory.
+///
+/// Appended rows are gathered into parts of about WriteOpts::mbs_per_block.
+/// Each part is encoded and stored while later rows are appended; Append
+/// waits for earlier parts when starting another would exceed
+/// WriteOpts::max_stream_mbs. A table that fits in one part is stored as a
+/// single parquet file. Otherwise the parts are stored next to a list of
+/// their row offsets, which ParquetReader reads as one table.
+class KATANA_EXPORT ParquetStreamWriter {
+public:
+  /// \returns a writer for a table with \param schema stored at \param uri.
+  /// If \param group is given, the parts are stored through it, like any
+  /// other file of the group, and counted in its outstanding size and
+  /// checksums.
+  static katana::Result<std::unique_ptr<ParquetStreamWriter>> Make(
+      const katana::Uri& uri, std::shared_ptr<arrow::Schema> schema,
+      ParquetWriter::WriteOpts opts = ParquetWriter::WriteOpts::Defaults(),
+      WriteGroup* group = nullptr);
+
+  /// Add rows to the end of the table. The writer refers to, rather than
+  /// copies, their data until it is stored.
+  katana::Result<void> Append(const std::shared_ptr<arrow::Table>& rows);
+
+  /// Store the remaining rows. Without a group, this waits until the whole
+  /// table is stored; with one, the stores still in flight are handed to it.
+  katana::Result<void> Finish();
+
+private:
+  struct PendingPart {
+    std::string path;
+    std::future<katana::CopyableResult<void>> result;
+  };
+
+  ParquetStreamWriter(
+      katana::Uri uri, std::shared_ptr<arrow::Schema> schema,
+      ParquetWriter::WriteOpts opts, WriteGroup* group);
+
+  katana::Result<std::shared_ptr<arrow::Table>> TakeBuffered(int64_t num_rows);
+  katana::Result<void> StartPart(std::shared_ptr<arrow::Table> part);
+  katana::Result<void> WaitForPart();
+
+  katana::Uri uri_;
+  std::shared_ptr<arrow::Schema> schema_;
+  ParquetWriter::WriteOpts opts_;
+  WriteGroup* group_;
+  std::shared_ptr<parquet::WriterProperties> writer_props_;
+  std::shared_ptr<parquet::ArrowWriterProperties> arrow_props_;
+
+  std::vector<std::shared_ptr<arrow::Table>> buffered_;
+  int64_t num_buffered_rows_{0};
+  int64_t rows_per_part_{0};
+  uint64_t max_pending_parts_{1};
+
+  /// first row of each part started so far
+  std::vector<int64_t> part_offsets_;
+  int64_t num_rows_started_{0};
+  std::list<PendingPart> pending_;
+  bool finished_{false};
+};
+
 }  // namespace tsuba
 
 #endif
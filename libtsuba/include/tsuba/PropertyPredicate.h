@@ -0,0 +1,63 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_PROPERTYPREDICATE_H_
+#define KATANA_LIBTSUBA_TSUBA_PROPERTYPREDICATE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/config.h"
+
+namespace tsuba {
+
+/// A simple condition on one property that is pushed down to the parquet
+/// reader. Row groups whose statistics show that no row can satisfy the
+/// condition are never fetched from storage.
+///
+/// This is a hint to reduce I/O, not an exact filter: the loaded column keeps
+/// its full length so that it stays aligned with the topology, rows in
+/// skipped row groups are null, and rows in fetched row groups are returned
+/// whether or not they match.
+///
+/// Only the column of the named property is pruned. Each property is stored
+/// in a file of its own, and the files of other properties loaded with it
+/// are read in full even where this property's rows were skipped; a caller
+/// that wants only matching rows must filter on this property itself.
+struct KATANA_EXPORT PropertyPredicate {
+  enum class Kind {
+    /// value == lower
+    kEqual,
+    /// lower <= value <= upper; a null bound is unbounded on that side
+    kRange,
+    /// value is not null
+    kIsNotNull,
+  };
+
+  std::string property;
+  Kind kind{Kind::kIsNotNull};
+  std::shared_ptr<arrow::Scalar> lower;
+  std::shared_ptr<arrow::Scalar> upper;
+
+  static PropertyPredicate Equal(
+      const std::string& property, std::shared_ptr<arrow::Scalar> value) {
+    return PropertyPredicate{property, Kind::kEqual, std::move(value), nullptr};
+  }
+
+  static PropertyPredicate Range(
+      const std::string& property, std::shared_ptr<arrow::Scalar> lower,
+      std::shared_ptr<arrow::Scalar> upper) {
+    return PropertyPredicate{
+        property, Kind::kRange, std::move(lower), std::move(upper)};
+  }
+
+  static PropertyPredicate IsNotNull(const std::string& property) {
+    return PropertyPredicate{property, Kind::kIsNotNull, nullptr, nullptr};
+  }
+};
+
+using PropertyPredicates = std::vector<PropertyPredicate>;
+
+}  // namespace tsuba
+
+#endif
@@ -5,6 +5,8 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/chunked_array.h>
@@ -13,11 +15,14 @@
 #include "katana/Result.h"
 #include "katana/URI.h"
 #include "katana/config.h"
+#include "tsuba/ColumnStats.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/FileView.h"
+#include "tsuba/ParquetReader.h"
 #include "tsuba/PartitionMetadata.h"
 #include "tsuba/RDGLineage.h"
+#include "tsuba/PropertyPredicate.h"
 #include "tsuba/ReadGroup.h"
 #include "tsuba/WriteGroup.h"
 #include "tsuba/tsuba.h"
@@ -39,6 +44,58 @@ struct KATANA_EXPORT RDGLoadOptions {
   /// List of edge properties that should be loaded
   /// nullptr means all edge properties will be loaded
   std::optional<std::vector<std::string>> edge_properties{std::nullopt};
+  /// Decode the columns and row groups of each property file in parallel
+  /// (on arrow's cpu thread pool) in addition to loading property files
+  /// concurrently
+  bool parallel_decode{true};
+  /// Upper bound on the number of bytes of topology and property files being
+  /// read at once; 0 means no bound
+  uint64_t max_in_flight_bytes{0};
+  /// Upper bound on the number of topology and property files being read at
+  /// once; 0 means no bound. Reads waiting for room start topology first,
+  /// then partition metadata, then properties.
+  uint64_t max_in_flight_ops{0};
+  /// Conditions used to skip fetching parts of node/edge property files that
+  /// cannot match. Only the file of the property a predicate names is
+  /// pruned: its surviving row groups come back unfiltered and its pruned
+  /// ones as nulls, while every other property is loaded in full (see
+  /// PropertyPredicate).
+  /// Stores keep the stored files of properties loaded this way rather than
+  /// writing their nulls, unless the property is replaced.
+  PropertyPredicates node_predicates;
+  PropertyPredicates edge_predicates;
+  /// Load no node or edge properties up front, only their schemas.
+  /// PropertyGraph then loads each property the first time it is accessed by
+  /// name. Overrides node_properties and edge_properties.
+  bool lazy_properties{false};
+  /// Load in stages that overlap instead of one after another: the selected
+  /// properties start downloading in the background as soon as the
+  /// partition header is read, RDG::Make waits only for the topology,
+  /// PropertyGraph::Make maps the topology while they are in flight and
+  /// constructs the entity types (PropertyGraph::ConstructEntityTypeIDs) as
+  /// soon as the type properties have arrived, then waits for the others.
+  /// With lazy_properties, PropertyGraph::Make returns once the topology and
+  /// entity types are ready, so views can be built and analytics started
+  /// while the other selected properties download, and the first access to
+  /// one waits only for it. Cold start is then bounded by the longest
+  /// single read rather than by their sum. Properties are read whole, so
+  /// this is ignored if there are node_predicates or edge_predicates, and
+  /// their reads are not bounded by max_in_flight_bytes or max_in_flight_ops.
+  bool pipelined{false};
+  /// Leave the topology in a mapping of its file rather than reading it
+  /// into memory. Pages are read as they are first touched and the kernel
+  /// may evict them again, so graphs larger than memory can be traversed.
+  /// Only uncompressed topology files on storage that can be mapped (see
+  /// FileMapReadOnly) are used this way; others are read as usual.
+  bool out_of_core_topology{false};
+  /// Check files against the checksums recorded when they were written (see
+  /// KATANA_TSUBA_CHECKSUMS) as they are read, failing with
+  /// ErrorCode::ChecksumMismatch if they differ. This covers the topology,
+  /// including an out-of-core one, which is read through once to check it,
+  /// and property files and their parts when they are read in full; reads
+  /// pruned by predicates are not checked. Files written without checksums
+  /// are not checked.
+  bool verify_checksums{false};
 };
 
 class KATANA_EXPORT RDG {
@@ -134,9 +191,108 @@ public:
   /// cannot be loaded more than once
   katana::Result<void> LoadEdgeProperty(const std::string& name, int i = -1);
 
+  /// Start reading node properties from storage in the background so that a
+  /// later LoadNodeProperty of the same name does not have to wait for the
+  /// whole read. Properties that are already loaded or being prefetched are
+  /// skipped.
+  katana::Result<void> PrefetchNodeProperties(
+      const std::vector<std::string>& names);
+
+  /// Start reading edge properties from storage in the background; see
+  /// PrefetchNodeProperties
+  katana::Result<void> PrefetchEdgeProperties(
+      const std::vector<std::string>& names);
+
   std::vector<std::string> ListNodeProperties() const;
   std::vector<std::string> ListEdgeProperties() const;
 
+  /// \returns true if the column of node property \param name is spilled.
+  ///
+  /// If KATANA_TSUBA_SPILL_DIR is set, an RDG whose property columns exceed
+  /// KATANA_TSUBA_SPILL_MEMORY_MB (default: half of physical memory) after
+  /// properties are added, upserted or loaded writes the least recently used
+  /// columns to files in that directory and replaces them with columns backed
+  /// by mappings of the files. Spilled columns have the same values and stay
+  /// in the property tables; the kernel pages them in as they are read.
+  bool IsNodePropertySpilled(const std::string& name) const;
+
+  /// \returns true if the column of edge property \param name is spilled;
+  /// see IsNodePropertySpilled
+  bool IsEdgePropertySpilled(const std::string& name) const;
+
+  /// Record a use of node property \param name so that it is spilled after
+  /// the properties used before it. Loading and modifying a property count
+  /// as uses.
+  void MarkNodePropertyUsed(const std::string& name);
+
+  /// Record a use of edge property \param name; see MarkNodePropertyUsed
+  void MarkEdgePropertyUsed(const std::string& name);
+
+  /// \returns the statistics recorded when the node property \param name
+  /// was last stored. Properties that have not been stored since they were
+  /// last modified, or that were stored by a version that did not record
+  /// statistics, return ErrorCode::NotFound.
+  katana::Result<ColumnStats> GetNodePropertyStats(
+      const std::string& name) const;
+
+  /// \returns the statistics of an edge property; see GetNodePropertyStats
+  katana::Result<ColumnStats> GetEdgePropertyStats(
+      const std::string& name) const;
+
+  /// Store \param ff with the next Store as a file derived from the
+  /// topology, e.g., a transposed or sorted copy, that can be found again by
+  /// \param key. Derived topologies are dropped when the topology they were
+  /// derived from is replaced or the RDG is stored in a new location.
+  void AddDerivedTopology(
+      const std::string& key, std::unique_ptr<FileFrame> ff);
+
+  /// \returns true if a topology stored under \param key and derived from
+  /// the current topology is in storage
+  bool HasDerivedTopology(const std::string& key) const;
+
+  /// Read the derived topology stored under \param key into \param fv.
+  /// Returns ErrorCode::NotFound if there is none for the current topology.
+  katana::Result<void> LoadDerivedTopology(
+      const std::string& key, FileView* fv) const;
+
+  /// Store \param ff with the next Store as an index over node property
+  /// \param name; see katana::PropertyIndex. Indexes are dropped when their
+  /// property is replaced or the RDG is stored in a new location.
+  void AddNodePropertyIndex(
+      const std::string& name, std::unique_ptr<FileFrame> ff) {
+    AddPropertyIndex(true, name, std::move(ff));
+  }
+
+  /// Like AddNodePropertyIndex for edge property \param name
+  void AddEdgePropertyIndex(
+      const std::string& name, std::unique_ptr<FileFrame> ff) {
+    AddPropertyIndex(false, name, std::move(ff));
+  }
+
+  /// \returns the node properties with an index in storage that was built
+  /// from their current value
+  std::vector<std::string> ListNodePropertyIndexes() const {
+    return ListPropertyIndexes(true);
+  }
+
+  /// Like ListNodePropertyIndexes for edge properties
+  std::vector<std::string> ListEdgePropertyIndexes() const {
+    return ListPropertyIndexes(false);
+  }
+
+  /// Read the index of node property \param name into \param fv. Returns
+  /// ErrorCode::NotFound if there is none for the current property.
+  katana::Result<void> LoadNodePropertyIndex(
+      const std::string& name, FileView* fv) const {
+    return LoadPropertyIndex(true, name, fv);
+  }
+
+  /// Like LoadNodePropertyIndex for edge property \param name
+  katana::Result<void> LoadEdgePropertyIndex(
+      const std::string& name, FileView* fv) const {
+    return LoadPropertyIndex(false, name, fv);
+  }
+
   /// Explain to graph how it is derived from previous version
   void AddLineage(const std::string& command_line);
 
@@ -152,10 +308,12 @@ public:
 
   void AddMirrorNodes(std::shared_ptr<arrow::ChunkedArray>&& a) {
     mirror_nodes_.emplace_back(std::move(a));
+    part_arrays_dirty_ = true;
   }
 
   void AddMasterNodes(std::shared_ptr<arrow::ChunkedArray>&& a) {
     master_nodes_.emplace_back(std::move(a));
+    part_arrays_dirty_ = true;
   }
 
   //
@@ -190,6 +348,7 @@ public:
   }
   void set_master_nodes(std::vector<std::shared_ptr<arrow::ChunkedArray>>&& a) {
     master_nodes_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::vector<std::shared_ptr<arrow::ChunkedArray>>& mirror_nodes()
@@ -198,6 +357,7 @@ public:
   }
   void set_mirror_nodes(std::vector<std::shared_ptr<arrow::ChunkedArray>>&& a) {
     mirror_nodes_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& host_to_owned_global_node_ids()
@@ -207,6 +367,7 @@ public:
   void set_host_to_owned_global_node_ids(
       std::shared_ptr<arrow::ChunkedArray>&& a) {
     host_to_owned_global_node_ids_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& host_to_owned_global_edge_ids()
@@ -216,6 +377,7 @@ public:
   void set_host_to_owned_global_edge_ids(
       std::shared_ptr<arrow::ChunkedArray>&& a) {
     host_to_owned_global_edge_ids_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& local_to_user_id() const {
@@ -223,6 +385,7 @@ public:
   }
   void set_local_to_user_id(std::shared_ptr<arrow::ChunkedArray>&& a) {
     local_to_user_id_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& local_to_global_id() const {
@@ -230,6 +393,7 @@ public:
   }
   void set_local_to_global_id(std::shared_ptr<arrow::ChunkedArray>&& a) {
     local_to_global_id_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const PartitionMetadata& part_metadata() const;
@@ -237,6 +401,10 @@ public:
 
   const FileView& topology_file_storage() const;
 
+  /// true if the topology file was left in place because of
+  /// RDGLoadOptions::out_of_core_topology
+  bool out_of_core_topology() const { return out_of_core_topology_; }
+
   void set_view_name(const std::string& v) { view_type_ = v; }
 
 private:
@@ -245,10 +413,15 @@ private:
 
   void InitEmptyTables();
 
+  /// Spill the least recently used property columns until those in memory
+  /// are within SpillPolicy::memory_limit. Errors are logged rather than
+  /// returned, since the properties are usable either way.
+  void SpillColdProperties();
+
   katana::Result<void> DoMake(
       const std::vector<PropStorageInfo*>& node_props_to_be_loaded,
       const std::vector<PropStorageInfo*>& edge_props_to_be_loaded,
-      const katana::Uri& metadata_dir);
+      const katana::Uri& metadata_dir, const RDGLoadOptions& opts);
 
   static katana::Result<RDG> Make(
       const RDGManifest& manifest, const RDGLoadOptions& opts);
@@ -263,6 +436,12 @@ private:
       RDGHandle handle, const std::string& command_line,
       RDGVersioningPolicy versioning_action, std::unique_ptr<WriteGroup> desc);
 
+  void AddPropertyIndex(
+      bool for_nodes, const std::string& name, std::unique_ptr<FileFrame> ff);
+  std::vector<std::string> ListPropertyIndexes(bool for_nodes) const;
+  katana::Result<void> LoadPropertyIndex(
+      bool for_nodes, const std::string& name, FileView* fv) const;
+
   //
   // Data
   //
@@ -273,10 +452,27 @@ private:
   std::vector<std::shared_ptr<arrow::ChunkedArray>> master_nodes_;
   // Called while constructing to put these arrays into a usable state for Distribution
   void InitArrowVectors();
+  /// Options for reading properties after Make, e.g., lazily
+  ParquetReader::ReadOpts LaterReadOpts() const;
   std::shared_ptr<arrow::ChunkedArray> host_to_owned_global_node_ids_;
   std::shared_ptr<arrow::ChunkedArray> host_to_owned_global_edge_ids_;
   std::shared_ptr<arrow::ChunkedArray> local_to_user_id_;
   std::shared_ptr<arrow::ChunkedArray> local_to_global_id_;
+  /// true if the partition metadata arrays above differ from the files
+  /// recorded in the part header and so must be written on the next store
+  bool part_arrays_dirty_{true};
+  bool out_of_core_topology_{false};
+  /// RDGLoadOptions::verify_checksums, also applied to later loads of
+  /// properties
+  bool verify_checksums_{false};
+  /// derived topologies to write on the next store; see AddDerivedTopology
+  std::vector<std::pair<std::string, std::unique_ptr<FileFrame>>>
+      pending_derived_topologies_;
+  /// property indexes to write on the next store by (for_nodes, property);
+  /// see AddNodePropertyIndex
+  std::vector<std::pair<
+      std::pair<bool, std::string>, std::unique_ptr<FileFrame>>>
+      pending_property_indexes_;
 
   /// name of the graph that was used to load this RDG
   katana::Uri rdg_dir_;
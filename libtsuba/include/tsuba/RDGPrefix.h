@@ -2,9 +2,12 @@
 #define KATANA_LIBTSUBA_TSUBA_RDGPREFIX_H_
 
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include "tsuba/CSRTopology.h"
 #include "tsuba/FileView.h"
+#include "tsuba/RDGSlice.h"
 #include "tsuba/tsuba.h"
 
 namespace tsuba {
@@ -16,8 +19,21 @@ class RDGManifest;
 /// partitioning decisions
 class KATANA_EXPORT RDGPrefix {
 public:
+  /// Summary of the out-degrees of the nodes of a graph
+  struct DegreeStats {
+    uint64_t min_degree{0};
+    uint64_t max_degree{0};
+    double mean_degree{0};
+    /// log2_histogram[0] is the number of nodes without edges and
+    /// log2_histogram[i] the number of nodes with degree in [2^(i-1), 2^i)
+    std::vector<uint64_t> log2_histogram;
+  };
+
   static katana::Result<RDGPrefix> Make(RDGHandle handle);
 
+  /// Open \param rdg_name read-only just long enough to read its prefix
+  static katana::Result<RDGPrefix> Make(const std::string& rdg_name);
+
   uint64_t num_nodes() const { return prefix_->header.num_nodes; }
   uint64_t num_edges() const { return prefix_->header.num_edges; }
   uint64_t version() const { return prefix_->header.version; }
@@ -37,6 +53,31 @@ public:
     return std::vector<uint64_t>(out_indexes + first, out_indexes + second);
   }
 
+  /// The index of the first edge of node \param n; edge_begin(num_nodes())
+  /// is num_edges()
+  uint64_t edge_begin(uint64_t n) const {
+    KATANA_LOG_DEBUG_ASSERT(n <= num_nodes());
+    return n == 0 ? 0 : prefix_->out_indexes[n - 1];
+  }
+
+  uint64_t degree(uint64_t n) const {
+    return edge_begin(n + 1) - edge_begin(n);
+  }
+
+  DegreeStats ComputeDegreeStats() const;
+
+  /// Split the nodes into \param num_slices contiguous ranges with about the
+  /// same number of nodes plus edges each, and return the arguments that load
+  /// each range with RDGSlice::Make. Ranges may be empty if there are more
+  /// slices than nodes.
+  katana::Result<std::vector<RDGSlice::SliceArg>> BalancedSlices(
+      uint64_t num_slices) const;
+
+  /// The arguments that load nodes [\param first_node, \param last_node)
+  /// with RDGSlice::Make
+  RDGSlice::SliceArg MakeSliceArg(
+      uint64_t first_node, uint64_t last_node) const;
+
 private:
   RDGPrefix(FileView&& prefix_storage, uint64_t view_offset)
       : prefix_storage_(std::move(prefix_storage)),
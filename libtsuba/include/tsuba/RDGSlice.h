@@ -2,6 +2,9 @@
 #define KATANA_LIBTSUBA_TSUBA_RDGSLICE_H_
 
 #include <cstdint>
+#include <future>
+#include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -10,12 +13,15 @@
 #include "katana/URI.h"
 #include "katana/config.h"
 #include "tsuba/FileView.h"
+#include "tsuba/PropertyPredicate.h"
 #include "tsuba/tsuba.h"
 
 namespace tsuba {
 
 class RDGManifest;
 class RDGCore;
+class RDGPartHeader;
+class RDGSliceStream;
 
 /// A contiguous piece of an RDG
 class KATANA_EXPORT RDGSlice {
@@ -34,10 +40,15 @@ public:
     uint64_t topo_size;
   };
 
+  /// \param node_predicates and \param edge_predicates let the reader skip
+  /// fetching parts of property files that cannot match (see
+  /// PropertyPredicate)
   static katana::Result<RDGSlice> Make(
       RDGHandle handle, const SliceArg& slice,
       const std::optional<std::vector<std::string>>& node_props = std::nullopt,
-      const std::optional<std::vector<std::string>>& edge_props = std::nullopt);
+      const std::optional<std::vector<std::string>>& edge_props = std::nullopt,
+      const PropertyPredicates& node_predicates = {},
+      const PropertyPredicates& edge_predicates = {});
 
   static katana::Result<RDGSlice> Make(
       const std::string& rdg_manifest_path, const SliceArg& slice,
@@ -49,16 +60,28 @@ public:
   const FileView& topology_file_storage() const;
 
 private:
+  friend class RDGSliceStream;
+
   static katana::Result<RDGSlice> Make(
       const RDGManifest& manifest, const std::vector<std::string>* node_props,
       const std::vector<std::string>* edge_props, const SliceArg& slice);
 
+  static katana::Result<RDGSlice> Make(
+      const RDGPartHeader& part_header, const katana::Uri& metadata_dir,
+      const SliceArg& slice,
+      const std::optional<std::vector<std::string>>& node_props,
+      const std::optional<std::vector<std::string>>& edge_props,
+      const PropertyPredicates& node_predicates,
+      const PropertyPredicates& edge_predicates);
+
   RDGSlice(std::unique_ptr<RDGCore>&& core);
 
   katana::Result<void> DoMake(
       const std::optional<std::vector<std::string>>& node_props,
       const std::optional<std::vector<std::string>>& edge_props,
-      const katana::Uri& metadata_dir, const SliceArg& slice);
+      const katana::Uri& metadata_dir, const SliceArg& slice,
+      const PropertyPredicates& node_predicates,
+      const PropertyPredicates& edge_predicates);
 
   //
   // Data
@@ -67,6 +90,64 @@ private:
   std::unique_ptr<RDGCore> core_;
 };
 
+/// Load a sequence of slices of an RDG one after another, e.g., for a scan
+/// over a graph too large to load at once. While the caller works on one
+/// slice, the next one is loaded in the background, so at most two slices
+/// are in memory at a time and loading overlaps with processing.
+///
+///     auto stream = KATANA_CHECKED(RDGSliceStream::Make(handle, slices));
+///     while (const RDGSlice* slice = KATANA_CHECKED(stream.Next())) {
+///       ...
+///     }
+class KATANA_EXPORT RDGSliceStream {
+public:
+  RDGSliceStream(const RDGSliceStream& no_copy) = delete;
+  RDGSliceStream& operator=(const RDGSliceStream& no_copy) = delete;
+
+  ~RDGSliceStream();
+  RDGSliceStream(RDGSliceStream&& other) noexcept;
+  RDGSliceStream& operator=(RDGSliceStream&& other) noexcept;
+
+  /// Stream \param slices, e.g., from RDGPrefix::BalancedSlices, in order.
+  /// The remaining arguments are as for RDGSlice::Make. The handle is only
+  /// used by Make.
+  static katana::Result<RDGSliceStream> Make(
+      RDGHandle handle, std::vector<RDGSlice::SliceArg> slices,
+      const std::optional<std::vector<std::string>>& node_props = std::nullopt,
+      const std::optional<std::vector<std::string>>& edge_props = std::nullopt,
+      const PropertyPredicates& node_predicates = {},
+      const PropertyPredicates& edge_predicates = {});
+
+  /// Release the slice returned by the previous call, wait for the next one
+  /// and start loading the one after it.
+  ///
+  /// \returns the next slice, which stays valid until the next call, or
+  /// nullptr after the last slice
+  katana::Result<const RDGSlice*> Next();
+
+  /// The number of slices in the stream
+  uint64_t size() const { return slices_.size(); }
+
+private:
+  RDGSliceStream() = default;
+
+  void StartLoad();
+
+  std::shared_ptr<const RDGPartHeader> part_header_;
+  katana::Uri metadata_dir_;
+  std::vector<RDGSlice::SliceArg> slices_;
+  std::optional<std::vector<std::string>> node_props_;
+  std::optional<std::vector<std::string>> edge_props_;
+  PropertyPredicates node_predicates_;
+  PropertyPredicates edge_predicates_;
+
+  /// the index of the next slice to start loading
+  uint64_t next_index_{0};
+  std::optional<RDGSlice> current_;
+  /// the load of slice next_index_ - 1, if any
+  std::optional<std::future<katana::Result<RDGSlice>>> pending_;
+};
+
 }  // namespace tsuba
 
 #endif
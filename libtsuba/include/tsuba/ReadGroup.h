@@ -1,9 +1,18 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_READGROUP_H_
 #define KATANA_LIBTSUBA_TSUBA_READGROUP_H_
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <future>
 #include <list>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "katana/Result.h"
 #include "tsuba/AsyncOpGroup.h"
@@ -14,14 +23,52 @@ namespace tsuba {
 /// that they have all completed
 class ReadGroup {
 public:
+  /// Ops started with StartReturnsOp that are waiting for room start in
+  /// priority order, and in the order they were started within a priority
+  enum class Priority {
+    kTopology = 0,
+    kMetadata = 1,
+    kProperty = 2,
+  };
+
+  /// Number of times an op that fails with a remote storage error is run
+  /// before its error is returned
+  static constexpr uint32_t kMaxAttempts = 5;
+  static constexpr std::chrono::milliseconds kInitialBackoff{100};
+  static constexpr std::chrono::milliseconds kMaxBackoff{5000};
+
+  ReadGroup() = default;
+
+  /// \param max_outstanding_size bounds the number of bytes that ops started
+  /// with StartReturnsOp may have in flight at once; \param
+  /// max_outstanding_ops bounds the number of those ops running at once. 0
+  /// means no bound.
+  explicit ReadGroup(
+      uint64_t max_outstanding_size, uint64_t max_outstanding_ops = 0)
+      : max_outstanding_size_(max_outstanding_size),
+        max_outstanding_ops_(max_outstanding_ops) {}
+
+  /// Ops that have not started yet are dropped; running ops are waited for
+  /// but their on_complete callbacks are not called
+  ~ReadGroup();
+
+  ReadGroup(const ReadGroup&) = delete;
+  ReadGroup& operator=(const ReadGroup&) = delete;
+  ReadGroup(ReadGroup&&) = delete;
+  ReadGroup& operator=(ReadGroup&&) = delete;
+
   static katana::Result<std::unique_ptr<ReadGroup>> Make();
 
+  uint64_t max_outstanding_size() const { return max_outstanding_size_; }
+  uint64_t max_outstanding_ops() const { return max_outstanding_ops_; }
+
   /// Wait until all operations this descriptor knows about have completed
   katana::Result<void> Finish();
 
   /// Add future to the list of futures this ReadGroup will wait for, note
   /// the file name for debugging. `on_complete` is guaranteed to be called
-  /// in FIFO order
+  /// in FIFO order. The future is already running, so it does not count
+  /// against the bounds of this group.
   void AddOp(
       std::future<katana::CopyableResult<void>> future, std::string file,
       const std::function<katana::CopyableResult<void>()>& on_complete);
@@ -55,7 +102,79 @@ public:
     AddOp(std::move(new_future), file, generic_complete_fn);
   }
 
+  /// Run fn asynchronously and consume its result with on_complete like
+  /// AddReturnsOp. If this group has bounds, fn starts once accounted_size
+  /// more bytes and one more op fit under them; the caller does not block.
+  /// fn is retried with exponential backoff if it fails with a remote storage
+  /// error (e.g., because the service is throttling requests), so it must be
+  /// safe to run more than once.
+  template <typename RetType>
+  void StartReturnsOp(
+      const std::function<katana::CopyableResult<RetType>()>& fn,
+      const std::string& file,
+      const std::function<katana::CopyableResult<void>(RetType)>& on_complete,
+      uint64_t accounted_size = 0, Priority priority = Priority::kProperty) {
+    if (max_outstanding_size_ == 0) {
+      accounted_size = 0;
+    }
+
+    auto promise =
+        std::make_shared<std::promise<katana::CopyableResult<RetType>>>();
+    AddReturnsOp<RetType>(promise->get_future(), file, on_complete);
+    Schedule(priority, accounted_size, [fn, promise]() {
+      promise->set_value(RunWithBackoff<RetType>(fn));
+    });
+  }
+
+  /// StartReturnsOp for ops that return nothing
+  void StartOp(
+      const std::function<katana::CopyableResult<void>()>& fn,
+      const std::string& file,
+      const std::function<katana::CopyableResult<void>()>& on_complete,
+      uint64_t accounted_size = 0, Priority priority = Priority::kProperty);
+
 private:
+  struct Task {
+    uint64_t accounted_size;
+    std::function<void()> run;
+  };
+
+  template <typename RetType>
+  static katana::CopyableResult<RetType> RunWithBackoff(
+      const std::function<katana::CopyableResult<RetType>()>& fn) {
+    for (uint32_t attempt = 1;; ++attempt) {
+      auto res = fn();
+      if (res || attempt >= kMaxAttempts || !IsRetryable(res.error())) {
+        return res;
+      }
+      std::this_thread::sleep_for(BackoffDelay(attempt));
+    }
+  }
+
+  static bool IsRetryable(const katana::CopyableErrorInfo& err);
+  static std::chrono::milliseconds BackoffDelay(uint32_t attempt);
+
+  void Schedule(
+      Priority priority, uint64_t accounted_size, std::function<void()> run);
+  /// Remove the tasks at the head of the queue that fit under the bounds and
+  /// count them as running. Call with mutex_ held.
+  std::vector<Task> AdmitLocked();
+  /// Run task and then as many queued tasks as become admissible, starting
+  /// extra threads when more than one is
+  void RunTasks(Task task);
+  void LaunchTasks(std::vector<Task> tasks);
+
+  uint64_t max_outstanding_size_{0};
+  uint64_t max_outstanding_ops_{0};
+
+  std::mutex mutex_;
+  std::condition_variable idle_;
+  uint64_t outstanding_size_{0};
+  uint64_t outstanding_ops_{0};
+  uint64_t next_seq_{0};
+  /// tasks waiting for room, keyed by (priority, start order)
+  std::map<std::pair<Priority, uint64_t>, Task> queue_;
+
   AsyncOpGroup async_op_group_;
 };
 
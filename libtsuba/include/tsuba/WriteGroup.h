@@ -4,6 +4,9 @@
 #include <future>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 #include "katana/Result.h"
 #include "tsuba/AsyncOpGroup.h"
@@ -14,7 +17,7 @@ namespace tsuba {
 
 /// Track multiple, outstanding async writes and provide a mechanism to ensure
 /// that they have all completed
-class WriteGroup {
+class KATANA_EXPORT WriteGroup {
   struct AsyncOp {
     std::future<katana::CopyableResult<void>> result;
     std::string location;
@@ -24,11 +27,18 @@ class WriteGroup {
   std::string tag_;
   std::atomic<uint64_t> outstanding_size_{0};
   AsyncOpGroup async_op_group_;
+  bool checksums_enabled_{false};
+  mutable std::mutex checksums_mutex_;
+  std::unordered_map<std::string, uint32_t> checksums_;
 
-  WriteGroup(std::string tag) : tag_(std::move(tag)){};
+  WriteGroup(std::string tag, bool checksums_enabled)
+      : tag_(std::move(tag)), checksums_enabled_(checksums_enabled){};
 
 public:
   static constexpr uint64_t kMaxOutstandingSize = 10ULL << 30;  // 10 GB
+  /// Bound on the number of ops in flight so that large stores do not open
+  /// enough concurrent requests to be throttled by remote storage
+  static constexpr uint64_t kMaxOutstandingOps = 256;
 
   /// Build a descriptor with a tag. If running with multiple hosts, Make should
   /// be Called BSP style and all hosts will have the same tag
@@ -44,9 +54,18 @@ public:
   void StartStore(std::shared_ptr<FileFrame> ff);
 
   /// Start async store op, caller responsible for keeping buffer live
-  void StartStore(const std::string& file, const uint8_t* buf, uint64_t size) {
-    AddOp(FileStoreAsync(file, buf, size), file);
-  }
+  void StartStore(const std::string& file, const uint8_t* buf, uint64_t size);
+
+  /// true if the stores of this group should be checksummed, which is
+  /// controlled by KATANA_TSUBA_CHECKSUMS (default false)
+  bool checksums_enabled() const { return checksums_enabled_; }
+
+  /// Note the CRC32C of stored \param file (see Crc32c)
+  void RecordChecksum(const std::string& file, uint32_t crc32c);
+
+  /// \returns the CRC32C of every file stored through this group, by file
+  /// name (the last component of its path). Only complete after Finish.
+  std::unordered_map<std::string, uint32_t> checksums() const;
 
   void AddToOutstanding(uint64_t size) { outstanding_size_ += size; }
 
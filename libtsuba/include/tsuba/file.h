@@ -30,6 +30,13 @@ RoundUpToBlock(T val) {
 
 struct StatBuf {
   uint64_t size{UINT64_C(0)};
+  /// Opaque identifier that changes whenever the contents of the file change
+  /// (e.g., an ETag or generation number); empty if the backend does not
+  /// provide one
+  std::string version;
+  /// Last modification time in nanoseconds since the epoch; 0 if the backend
+  /// does not report one
+  uint64_t mtime_ns{UINT64_C(0)};
 };
 
 // Returns an error file uri does not exist
@@ -93,6 +100,53 @@ FileGet(const StrType& uri, T* obj) {
 KATANA_EXPORT std::future<katana::CopyableResult<void>> FileGetAsync(
     const std::string& uri, void* result_buffer, uint64_t begin, uint64_t size);
 
+/// Map the first \param size bytes of a file read-only into memory if the
+/// storage backend for \param uri supports it (currently only the local file
+/// system). Returns ErrorCode::NotImplemented otherwise. The caller owns the
+/// mapping and should release it with munmap.
+KATANA_EXPORT katana::Result<uint8_t*> FileMapReadOnly(
+    const std::string& uri, uint64_t size);
+
+/// Counters for the local cache of remote files; see FileCache.h
+struct FileCacheStats {
+  /// reads served from the cache
+  uint64_t hits{0};
+  /// reads that fetched a file into the cache
+  uint64_t misses{0};
+  /// reads that waited for a fetch of the same file started by another reader
+  uint64_t waits{0};
+  /// reads that skipped the cache because the file was too large or its
+  /// backend reports neither a version nor a modification time
+  uint64_t bypasses{0};
+  /// files removed to stay under the size limit
+  uint64_t evictions{0};
+  /// bytes currently held in the cache
+  uint64_t bytes_cached{0};
+
+  double HitRate() const {
+    uint64_t total = hits + misses + waits;
+    return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+  }
+};
+
+/// Return the counters of the local file cache. All counters are zero if the
+/// cache is disabled.
+KATANA_EXPORT FileCacheStats GetFileCacheStats();
+
+/// While a FileStatScope exists, reads through the local file cache Stat
+/// each remote file once and reuse the result rather than Stat'ing it on
+/// every read, so a change to a file in the meantime goes unnoticed. Hold one
+/// for the duration of a load whose files are not rewritten while it runs,
+/// e.g., those of one manifest.
+class KATANA_EXPORT FileStatScope {
+public:
+  FileStatScope();
+  ~FileStatScope();
+
+  FileStatScope(const FileStatScope&) = delete;
+  FileStatScope& operator=(const FileStatScope&) = delete;
+};
+
 /// List the set of files in a directory
 /// \param directory is URI whose contents are listed. It can be
 /// Async return type allows this function to be called repeatedly (and
@@ -60,9 +60,17 @@ KATANA_EXPORT katana::Uri MakeTopologyFileName(RDGHandle handle);
 /// Get the storage directory associated with this handle
 KATANA_EXPORT katana::Uri GetRDGDir(RDGHandle handle);
 
+/// Get the version of the RDG that this handle was opened on or last stored
+KATANA_EXPORT uint64_t GetRDGVersion(RDGHandle handle);
+
 /// Close an RDGHandle object
 KATANA_EXPORT katana::Result<void> Close(RDGHandle handle);
 
+/// Open another handle on the same version of the RDG as handle, e.g., to
+/// load several of its partitions independently. The new handle must be
+/// closed separately.
+KATANA_EXPORT RDGHandle Duplicate(RDGHandle handle);
+
 /// Create an RDG storage location
 /// \param name is storage location prefix that will be used to store the RDG
 KATANA_EXPORT katana::Result<void> Create(const std::string& name);
@@ -93,6 +101,36 @@ KATANA_EXPORT katana::Result<RDGStat> Stat(const std::string& rdg_name);
 KATANA_EXPORT katana::Result<std::vector<RDGView>> ListAvailableViews(
     const std::string& rdg_dir);
 
+struct KATANA_EXPORT GarbageCollectOptions {
+  /// Number of versions of each view to keep, counting back from the newest
+  /// along previous versions; at least 1
+  uint64_t keep_versions{1};
+  /// Files removed per FileDelete call
+  uint64_t delete_batch_size{1000};
+  /// FileDelete calls in flight at once
+  uint32_t max_parallel_batches{8};
+  /// Report what would be deleted without deleting anything
+  bool dry_run{false};
+};
+
+struct KATANA_EXPORT GarbageCollectStats {
+  uint64_t versions_retained{0};
+  uint64_t versions_removed{0};
+  uint64_t files_deleted{0};
+  uint64_t bytes_deleted{0};
+};
+
+/// Delete the files in \param rdg_dir that no retained version of any view
+/// refers to: manifests and partition headers of older versions and the
+/// topology and property files that only they refer to. Files that are not
+/// part of an RDG are never deleted.
+///
+/// This must not run concurrently with writers to the same RDG, whose files
+/// are not referred to until they commit. Call it from one host only.
+KATANA_EXPORT katana::Result<GarbageCollectStats> CollectGarbage(
+    const std::string& rdg_dir,
+    const GarbageCollectOptions& opts = GarbageCollectOptions());
+
 // Setup and tear down
 KATANA_EXPORT katana::Result<void> Init(katana::CommBackend* comm);
 KATANA_EXPORT katana::Result<void> Init();
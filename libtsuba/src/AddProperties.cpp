@@ -1,5 +1,6 @@
 #include "AddProperties.h"
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 
@@ -9,14 +10,15 @@
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
 #include "tsuba/ParquetReader.h"
+#include "tsuba/file.h"
 
 namespace {
 
 katana::Result<std::shared_ptr<arrow::Table>>
 DoLoadProperties(
     const std::string& expected_name, const katana::Uri& file_path,
+    tsuba::ParquetReader::ReadOpts read_opts,
     std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
-  auto read_opts = tsuba::ParquetReader::ReadOpts::Defaults();
   read_opts.slice = slice;
   auto reader_res = tsuba::ParquetReader::Make(read_opts);
   if (!reader_res) {
@@ -50,9 +52,10 @@ DoLoadProperties(
 
 katana::Result<std::shared_ptr<arrow::Table>>
 tsuba::LoadProperties(
-    const std::string& expected_name, const katana::Uri& file_path) {
+    const std::string& expected_name, const katana::Uri& file_path,
+    const ParquetReader::ReadOpts& read_opts) {
   try {
-    return DoLoadProperties(expected_name, file_path);
+    return DoLoadProperties(expected_name, file_path, read_opts);
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
         tsuba::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
@@ -62,10 +65,10 @@ tsuba::LoadProperties(
 katana::Result<std::shared_ptr<arrow::Table>>
 tsuba::LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length) {
+    int64_t offset, int64_t length, const ParquetReader::ReadOpts& read_opts) {
   try {
     return DoLoadProperties(
-        expected_name, file_path,
+        expected_name, file_path, read_opts,
         tsuba::ParquetReader::Slice{.offset = offset, .length = length});
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
@@ -78,7 +81,8 @@ tsuba::AddProperties(
     const katana::Uri& uri,
     const std::vector<tsuba::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn) {
+        add_fn,
+    const ParquetReader::ReadOpts& read_opts, ReadGroup::Priority priority) {
   for (tsuba::PropStorageInfo* prop : properties) {
     if (!prop->IsAbsent()) {
       return KATANA_ERROR(
@@ -87,28 +91,42 @@ tsuba::AddProperties(
     }
     const katana::Uri& path = uri.Join(prop->path());
 
-    std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
-        std::async(
-            std::launch::async,
-            [prop,
-             path]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
-              return KATANA_CHECKED_CONTEXT(
-                  LoadProperties(prop->name(), path), "error loading {}", path);
-            });
-    auto on_complete = [add_fn,
-                        prop](const std::shared_ptr<arrow::Table>& props)
+    auto load_fn = [prop, path, read_opts]()
+        -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
+      return KATANA_CHECKED_CONTEXT(
+          LoadProperties(prop->name(), path, read_opts), "error loading {}",
+          path);
+    };
+    // Predicates prune only the row groups of the file of the property they
+    // name, and those rows are then null rather than stored data
+    bool partial = std::any_of(
+        read_opts.predicates.begin(), read_opts.predicates.end(),
+        [prop](const PropertyPredicate& pred) {
+          return pred.property == prop->name();
+        });
+    auto on_complete = [add_fn, prop,
+                        partial](const std::shared_ptr<arrow::Table>& props)
         -> katana::CopyableResult<void> {
       KATANA_CHECKED_CONTEXT(
           add_fn(props), "adding {}", std::quoted(prop->name()));
-      prop->WasLoaded(props->field(0)->type());
+      prop->WasLoaded(props->field(0)->type(), partial);
       return katana::CopyableResultSuccess();
     };
     if (grp) {
-      grp->AddReturnsOp<std::shared_ptr<arrow::Table>>(
-          std::move(future), path.string(), on_complete);
+      // Blocked property files are a small json index over several parts, so
+      // this under-counts them; that is fine for a soft bound
+      uint64_t accounted_size = 0;
+      if (grp->max_outstanding_size() > 0) {
+        StatBuf buf;
+        if (auto res = FileStat(path.string(), &buf); res) {
+          accounted_size = buf.size;
+        }
+      }
+      grp->StartReturnsOp<std::shared_ptr<arrow::Table>>(
+          load_fn, path.string(), on_complete, accounted_size, priority);
       continue;
     }
-    auto read_res = future.get();
+    auto read_res = load_fn();
     if (!read_res) {
       return read_res.error();
     }
@@ -127,7 +145,8 @@ tsuba::AddPropertySlice(
     const std::vector<tsuba::PropStorageInfo*>& properties,
     std::pair<uint64_t, uint64_t> range, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn) {
+        add_fn,
+    const ParquetReader::ReadOpts& read_opts) {
   uint64_t begin = range.first;
   uint64_t size = range.second - range.first;
   for (tsuba::PropStorageInfo* prop : properties) {
@@ -141,10 +160,10 @@ tsuba::AddPropertySlice(
     std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
         std::async(
             std::launch::async,
-            [path, prop, begin,
-             size]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
+            [path, prop, begin, size, read_opts]()
+                -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
               auto load_result =
-                  LoadPropertySlice(prop->name(), path, begin, size);
+                  LoadPropertySlice(prop->name(), path, begin, size, read_opts);
               if (!load_result) {
                 return load_result.error().WithContext(
                     "error loading {}", path);
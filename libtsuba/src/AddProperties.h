@@ -6,29 +6,43 @@
 #include "RDGPartHeader.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
+#include "tsuba/ParquetReader.h"
 #include "tsuba/ReadGroup.h"
 
 namespace tsuba {
 
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadProperties(
-    const std::string& expected_name, const katana::Uri& file_path);
+    const std::string& expected_name, const katana::Uri& file_path,
+    const ParquetReader::ReadOpts& read_opts =
+        ParquetReader::ReadOpts::Defaults());
 
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length);
-
+    int64_t offset, int64_t length,
+    const ParquetReader::ReadOpts& read_opts =
+        ParquetReader::ReadOpts::Defaults());
+
+/// Load properties and pass each one to add_fn. If grp is provided, loads
+/// happen asynchronously at \param priority and add_fn is called as they
+/// complete; if grp has a size bound, the on-storage size of each property
+/// counts against it.
 KATANA_EXPORT katana::Result<void> AddProperties(
     const katana::Uri& uri,
     const std::vector<tsuba::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn);
+        add_fn,
+    const ParquetReader::ReadOpts& read_opts =
+        ParquetReader::ReadOpts::Defaults(),
+    ReadGroup::Priority priority = ReadGroup::Priority::kProperty);
 
 KATANA_EXPORT katana::Result<void> AddPropertySlice(
     const katana::Uri& dir,
     const std::vector<tsuba::PropStorageInfo*>& properties,
     std::pair<uint64_t, uint64_t> range, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn);
+        add_fn,
+    const ParquetReader::ReadOpts& read_opts =
+        ParquetReader::ReadOpts::Defaults());
 
 }  // namespace tsuba
 
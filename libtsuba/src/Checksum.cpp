@@ -0,0 +1,158 @@
+#include "Checksum.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace {
+
+/// reflected Castagnoli polynomial
+constexpr uint32_t kPolynomial = 0x82f63b78;
+
+std::array<uint32_t, 256>
+MakeTable() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) ? kPolynomial : 0);
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+const std::array<uint32_t, 256> kTable = MakeTable();
+
+uint32_t
+UpdateSoftware(uint32_t crc, const uint8_t* data, uint64_t size) {
+  for (uint64_t i = 0; i < size; ++i) {
+    crc = kTable[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2"))) uint32_t
+UpdateHardware(uint32_t crc, const uint8_t* data, uint64_t size) {
+  uint64_t crc64 = crc;
+  for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+    data += sizeof(word);
+  }
+  auto crc32 = static_cast<uint32_t>(crc64);
+  for (; size > 0; --size) {
+    crc32 = _mm_crc32_u8(crc32, *data++);
+  }
+  return crc32;
+}
+
+const bool kHaveHardware = __builtin_cpu_supports("sse4.2");
+
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+
+uint32_t
+UpdateHardware(uint32_t crc, const uint8_t* data, uint64_t size) {
+  for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    crc = __crc32cd(crc, word);
+    data += sizeof(word);
+  }
+  for (; size > 0; --size) {
+    crc = __crc32cb(crc, *data++);
+  }
+  return crc;
+}
+
+constexpr bool kHaveHardware = true;
+
+#else
+
+uint32_t
+UpdateHardware(uint32_t crc, const uint8_t* data, uint64_t size) {
+  return UpdateSoftware(crc, data, size);
+}
+
+constexpr bool kHaveHardware = false;
+
+#endif
+
+/// Multiply vec by the 32x32 GF(2) matrix mat
+uint32_t
+MatrixTimes(const uint32_t* mat, uint32_t vec) {
+  uint32_t sum = 0;
+  for (; vec != 0; vec >>= 1, ++mat) {
+    if (vec & 1) {
+      sum ^= *mat;
+    }
+  }
+  return sum;
+}
+
+void
+MatrixSquare(uint32_t* square, const uint32_t* mat) {
+  for (int n = 0; n < 32; ++n) {
+    square[n] = MatrixTimes(mat, mat[n]);
+  }
+}
+
+}  // namespace
+
+uint32_t
+tsuba::Crc32c(const void* data, uint64_t size, uint32_t crc) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  crc = kHaveHardware ? UpdateHardware(crc, bytes, size)
+                      : UpdateSoftware(crc, bytes, size);
+  return ~crc;
+}
+
+uint32_t
+tsuba::Crc32cCombine(uint32_t crc_a, uint32_t crc_b, uint64_t size_b) {
+  // Append size_b zero bytes to a by repeated squaring of the operator that
+  // appends one zero bit, as in zlib's crc32_combine
+  if (size_b == 0) {
+    return crc_a;
+  }
+
+  uint32_t even[32];
+  uint32_t odd[32];
+
+  odd[0] = kPolynomial;
+  uint32_t row = 1;
+  for (int n = 1; n < 32; ++n) {
+    odd[n] = row;
+    row <<= 1;
+  }
+  // two zero bits, then four
+  MatrixSquare(even, odd);
+  MatrixSquare(odd, even);
+
+  do {
+    // first pass appends one zero byte
+    MatrixSquare(even, odd);
+    if (size_b & 1) {
+      crc_a = MatrixTimes(even, crc_a);
+    }
+    size_b >>= 1;
+    if (size_b == 0) {
+      break;
+    }
+    MatrixSquare(odd, even);
+    if (size_b & 1) {
+      crc_a = MatrixTimes(odd, crc_a);
+    }
+    size_b >>= 1;
+  } while (size_b != 0);
+
+  return crc_a ^ crc_b;
+}
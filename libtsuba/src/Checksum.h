@@ -0,0 +1,23 @@
+#ifndef KATANA_LIBTSUBA_CHECKSUM_H_
+#define KATANA_LIBTSUBA_CHECKSUM_H_
+
+#include <cstdint>
+
+namespace tsuba {
+
+/// CRC32C (Castagnoli) of \param size bytes at \param data, continuing from
+/// \param crc, the checksum of the bytes preceding data. That is,
+/// Crc32c(b, Crc32c(a)) is the checksum of a followed by b.
+///
+/// Uses the SSE4.2 or ARMv8 CRC instructions when the processor has them.
+uint32_t Crc32c(const void* data, uint64_t size, uint32_t crc = 0);
+
+/// \returns the checksum of a followed by b given \param crc_a, the checksum
+/// of a, and \param crc_b, the checksum of b, which is \param size_b bytes
+/// long. This lets ranges be checksummed independently, e.g., as they arrive
+/// from storage out of order.
+uint32_t Crc32cCombine(uint32_t crc_a, uint32_t crc_b, uint64_t size_b);
+
+}  // namespace tsuba
+
+#endif
@@ -0,0 +1,307 @@
+#include "tsuba/ColumnStats.h"
+
+#include <cmath>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <arrow/type_traits.h>
+
+namespace {
+
+/// String min and max longer than this are not kept in the part header
+constexpr size_t kMaxStringStatBytes = 256;
+
+/// Mix the bits of x so that nearby values have unrelated hashes
+/// (the splitmix64 finalizer)
+uint64_t
+Mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= UINT64_C(0xbf58476d1ce4e5b9);
+  x ^= x >> 27;
+  x *= UINT64_C(0x94d049bb133111eb);
+  x ^= x >> 31;
+  return x;
+}
+
+uint64_t
+HashBytes(std::string_view str) {
+  // FNV-1a
+  uint64_t hash = UINT64_C(14695981039346656037);
+  for (char c : str) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= UINT64_C(1099511628211);
+  }
+  return Mix(hash);
+}
+
+/// \returns whether str is well-formed UTF-8, without overlong forms or
+/// surrogates, which the JSON writer of the part header requires
+bool
+IsUtf8(std::string_view str) {
+  for (size_t i = 0; i < str.size();) {
+    const auto c = static_cast<uint8_t>(str[i]);
+    // the length of the character and the range of its second byte
+    size_t len = 0;
+    uint8_t lo = 0x80;
+    uint8_t hi = 0xbf;
+    if (c < 0x80) {
+      len = 1;
+    } else if (c >= 0xc2 && c <= 0xdf) {
+      len = 2;
+    } else if (c >= 0xe0 && c <= 0xef) {
+      len = 3;
+      lo = c == 0xe0 ? 0xa0 : 0x80;
+      hi = c == 0xed ? 0x9f : 0xbf;
+    } else if (c >= 0xf0 && c <= 0xf4) {
+      len = 4;
+      lo = c == 0xf0 ? 0x90 : 0x80;
+      hi = c == 0xf4 ? 0x8f : 0xbf;
+    } else {
+      return false;
+    }
+    if (i + len > str.size()) {
+      return false;
+    }
+    for (size_t j = i + 1; j < i + len; ++j) {
+      const auto b = static_cast<uint8_t>(str[j]);
+      if (b < (j == i + 1 ? lo : 0x80) || b > (j == i + 1 ? hi : 0xbf)) {
+        return false;
+      }
+    }
+    i += len;
+  }
+  return true;
+}
+
+/// \returns the longest prefix of the UTF-8 string str of at most
+/// kMaxStringStatBytes that does not split a character
+std::string_view
+TruncateUtf8(std::string_view str) {
+  if (str.size() <= kMaxStringStatBytes) {
+    return str;
+  }
+  size_t end = kMaxStringStatBytes;
+  while (end > 0 && (static_cast<uint8_t>(str[end]) & 0xc0) == 0x80) {
+    --end;
+  }
+  return str.substr(0, end);
+}
+
+class HyperLogLog {
+public:
+  static constexpr int kPrecision = 12;
+  static constexpr uint64_t kNumRegisters = UINT64_C(1) << kPrecision;
+
+  void Add(uint64_t hash) {
+    uint64_t idx = hash >> (64 - kPrecision);
+    uint64_t rest = hash << kPrecision;
+    uint8_t rank = rest == 0 ? 64 - kPrecision + 1 : __builtin_clzll(rest) + 1;
+    if (rank > registers_[idx]) {
+      registers_[idx] = rank;
+    }
+  }
+
+  uint64_t Estimate() const {
+    constexpr double m = kNumRegisters;
+    double sum = 0;
+    uint64_t zeros = 0;
+    for (uint8_t reg : registers_) {
+      sum += std::ldexp(1.0, -reg);
+      zeros += reg == 0;
+    }
+    double estimate = (0.7213 / (1 + 1.079 / m)) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros != 0) {
+      // linear counting is more accurate for small cardinalities
+      estimate = m * std::log(m / zeros);
+    }
+    return std::llround(estimate);
+  }
+
+private:
+  std::vector<uint8_t> registers_ = std::vector<uint8_t>(kNumRegisters);
+};
+
+/// Scan the non-null values of column, which has arrow type ArrowType, as
+/// Values and record them in stats as ScalarTypes
+template <
+    typename ArrowType, typename Value, typename ScalarType, typename GetValue,
+    typename Hash>
+void
+Scan(
+    const arrow::ChunkedArray& column, const GetValue& get_value,
+    const Hash& hash, tsuba::ColumnStats* stats) {
+  using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+
+  std::optional<Value> min;
+  std::optional<Value> max;
+  HyperLogLog hll;
+  for (const auto& chunk : column.chunks()) {
+    const auto& array = static_cast<const ArrayType&>(*chunk);
+    for (int64_t i = 0, n = array.length(); i < n; ++i) {
+      if (array.IsNull(i)) {
+        continue;
+      }
+      Value value = get_value(array, i);
+      if constexpr (std::is_floating_point_v<Value>) {
+        if (std::isnan(value)) {
+          continue;
+        }
+      }
+      hll.Add(hash(value));
+      if constexpr (std::is_floating_point_v<Value>) {
+        // JSON cannot hold infinities
+        if (!std::isfinite(value)) {
+          continue;
+        }
+      }
+      if (!min || value < *min) {
+        min = value;
+      }
+      if (!max || *max < value) {
+        max = value;
+      }
+    }
+  }
+
+  if (min) {
+    if constexpr (std::is_same_v<Value, std::string_view>) {
+      // a prefix of min is still a lower bound, but a prefix of max is not
+      // an upper bound
+      if (IsUtf8(*min) && IsUtf8(*max) &&
+          max->size() <= kMaxStringStatBytes) {
+        stats->min =
+            std::make_shared<ScalarType>(std::string(TruncateUtf8(*min)));
+        stats->max = std::make_shared<ScalarType>(std::string(*max));
+      }
+    } else {
+      stats->min = std::make_shared<ScalarType>(*min);
+      stats->max = std::make_shared<ScalarType>(*max);
+    }
+  }
+  stats->distinct_estimate = hll.Estimate();
+}
+
+template <typename ArrowType>
+void
+ScanSigned(const arrow::ChunkedArray& column, tsuba::ColumnStats* stats) {
+  Scan<ArrowType, int64_t, arrow::Int64Scalar>(
+      column,
+      [](const auto& array, int64_t i) {
+        return static_cast<int64_t>(array.Value(i));
+      },
+      [](int64_t v) { return Mix(static_cast<uint64_t>(v)); }, stats);
+}
+
+template <typename ArrowType>
+void
+ScanUnsigned(const arrow::ChunkedArray& column, tsuba::ColumnStats* stats) {
+  Scan<ArrowType, uint64_t, arrow::UInt64Scalar>(
+      column,
+      [](const auto& array, int64_t i) {
+        return static_cast<uint64_t>(array.Value(i));
+      },
+      [](uint64_t v) { return Mix(v); }, stats);
+}
+
+template <typename ArrowType>
+void
+ScanFloating(const arrow::ChunkedArray& column, tsuba::ColumnStats* stats) {
+  Scan<ArrowType, double, arrow::DoubleScalar>(
+      column,
+      [](const auto& array, int64_t i) {
+        return static_cast<double>(array.Value(i));
+      },
+      [](double v) {
+        // -0.0 == 0.0, so they must hash the same
+        if (v == 0) {
+          v = 0;
+        }
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return Mix(bits);
+      },
+      stats);
+}
+
+template <typename ArrowType>
+void
+ScanString(const arrow::ChunkedArray& column, tsuba::ColumnStats* stats) {
+  Scan<ArrowType, std::string_view, arrow::StringScalar>(
+      column,
+      [](const auto& array, int64_t i) {
+        auto view = array.GetView(i);
+        return std::string_view(view.data(), view.size());
+      },
+      [](std::string_view v) { return HashBytes(v); }, stats);
+}
+
+}  // namespace
+
+tsuba::ColumnStats
+tsuba::ColumnStats::Compute(const arrow::ChunkedArray& column) {
+  ColumnStats stats;
+  stats.num_rows = column.length();
+  stats.null_count = column.null_count();
+
+  switch (column.type()->id()) {
+  case arrow::Type::INT8:
+    ScanSigned<arrow::Int8Type>(column, &stats);
+    break;
+  case arrow::Type::INT16:
+    ScanSigned<arrow::Int16Type>(column, &stats);
+    break;
+  case arrow::Type::INT32:
+    ScanSigned<arrow::Int32Type>(column, &stats);
+    break;
+  case arrow::Type::INT64:
+    ScanSigned<arrow::Int64Type>(column, &stats);
+    break;
+  case arrow::Type::DATE32:
+    ScanSigned<arrow::Date32Type>(column, &stats);
+    break;
+  case arrow::Type::DATE64:
+    ScanSigned<arrow::Date64Type>(column, &stats);
+    break;
+  case arrow::Type::TIMESTAMP:
+    ScanSigned<arrow::TimestampType>(column, &stats);
+    break;
+  case arrow::Type::UINT8:
+    ScanUnsigned<arrow::UInt8Type>(column, &stats);
+    break;
+  case arrow::Type::UINT16:
+    ScanUnsigned<arrow::UInt16Type>(column, &stats);
+    break;
+  case arrow::Type::UINT32:
+    ScanUnsigned<arrow::UInt32Type>(column, &stats);
+    break;
+  case arrow::Type::UINT64:
+    ScanUnsigned<arrow::UInt64Type>(column, &stats);
+    break;
+  case arrow::Type::FLOAT:
+    ScanFloating<arrow::FloatType>(column, &stats);
+    break;
+  case arrow::Type::DOUBLE:
+    ScanFloating<arrow::DoubleType>(column, &stats);
+    break;
+  case arrow::Type::BOOL:
+    Scan<arrow::BooleanType, bool, arrow::BooleanScalar>(
+        column,
+        [](const arrow::BooleanArray& array, int64_t i) {
+          return array.Value(i);
+        },
+        [](bool v) { return Mix(v); }, &stats);
+    break;
+  case arrow::Type::STRING:
+    ScanString<arrow::StringType>(column, &stats);
+    break;
+  case arrow::Type::LARGE_STRING:
+    ScanString<arrow::LargeStringType>(column, &stats);
+    break;
+  default:
+    break;
+  }
+
+  return stats;
+}
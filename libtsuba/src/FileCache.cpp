@@ -0,0 +1,392 @@
+#include "FileCache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <ctime>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "tsuba/Errors.h"
+
+namespace {
+
+/// temporary files older than this are left over from crashed processes
+constexpr time_t kStaleTempSeconds = 60 * 60;
+
+constexpr std::string_view kTempMarker = ".tmp.";
+
+/// FNV-1a; stable across processes and builds, unlike std::hash
+uint64_t
+HashString(std::string_view str) {
+  uint64_t hash = UINT64_C(14695981039346656037);
+  for (char c : str) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= UINT64_C(1099511628211);
+  }
+  return hash;
+}
+
+/// \returns the name of the cache entry for the current contents of \param uri,
+/// or an empty string if the backend gives no way to tell when they change
+std::string
+MakeKey(const std::string& uri, const tsuba::StatBuf& stat_buf) {
+  std::string version = stat_buf.version;
+  if (version.empty()) {
+    if (stat_buf.mtime_ns == 0) {
+      return std::string();
+    }
+    version = fmt::format("{}@{}", stat_buf.size, stat_buf.mtime_ns);
+  }
+  return fmt::format(
+      "{:016x}{:016x}", HashString(uri), HashString(uri + "\n" + version));
+}
+
+}  // namespace
+
+katana::Result<void>
+tsuba::FileCache::Init() {
+  dir_.clear();
+  capacity_ = 0;
+
+  std::string dir;
+  if (!katana::GetEnv("KATANA_TSUBA_CACHE_DIR", &dir) || dir.empty()) {
+    return katana::ResultSuccess();
+  }
+
+  int size_mb = kDefaultSizeMB;
+  katana::GetEnv("KATANA_TSUBA_CACHE_SIZE_MB", &size_mb);
+  if (size_mb <= 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "cache size must be positive: {}",
+        size_mb);
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(dir, ec);
+  if (ec) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "creating cache directory {}: {}", dir,
+        ec.message());
+  }
+
+  dir_ = std::move(dir);
+  capacity_ = static_cast<uint64_t>(size_mb) << 20;
+
+  return LoadIndex();
+}
+
+katana::Result<void>
+tsuba::FileCache::Fini() {
+  if (!enabled()) {
+    return katana::ResultSuccess();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  KATANA_LOG_DEBUG(
+      "file cache {}: {} hits, {} misses, {} waits, {} bypasses, {} "
+      "evictions",
+      dir_, stats_.hits, stats_.misses, stats_.waits, stats_.bypasses,
+      stats_.evictions);
+  lru_.clear();
+  entries_.clear();
+  stats_ = FileCacheStats{};
+  scoped_stats_.clear();
+  dir_.clear();
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::FileCache::LoadIndex() {
+  DIR* dirp = opendir(dir_.c_str());
+  if (dirp == nullptr) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening cache directory {}: {}", dir_,
+        katana::ResultErrno().message());
+  }
+
+  time_t now = time(nullptr);
+  // (modification time, key, size)
+  std::vector<std::tuple<time_t, std::string, uint64_t>> found;
+  for (dirent* dp = readdir(dirp); dp != nullptr; dp = readdir(dirp)) {
+    std::string name(dp->d_name);
+    struct stat s_buf;
+    if (stat(PathOf(name).c_str(), &s_buf) != 0 || !S_ISREG(s_buf.st_mode)) {
+      continue;
+    }
+    if (name.find(kTempMarker) != std::string::npos) {
+      if (now - s_buf.st_mtime > kStaleTempSeconds) {
+        unlink(PathOf(name).c_str());
+      }
+      continue;
+    }
+    found.emplace_back(s_buf.st_mtime, std::move(name), s_buf.st_size);
+  }
+  closedir(dirp);
+
+  std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) {
+    return std::get<0>(a) > std::get<0>(b);
+  });
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& [mtime, key, size] : found) {
+    auto pos = lru_.insert(lru_.end(), key);
+    entries_.emplace(key, Entry{size, pos});
+    stats_.bytes_cached += size;
+  }
+  EvictLocked();
+
+  return katana::ResultSuccess();
+}
+
+void
+tsuba::FileCache::Touch(Entry* entry) {
+  lru_.splice(lru_.begin(), lru_, entry->lru_pos);
+}
+
+void
+tsuba::FileCache::Forget(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return;
+  }
+  stats_.bytes_cached -= it->second.size;
+  lru_.erase(it->second.lru_pos);
+  entries_.erase(it);
+}
+
+void
+tsuba::FileCache::EvictLocked() {
+  while (stats_.bytes_cached > capacity_ && !lru_.empty()) {
+    const std::string& key = lru_.back();
+    // readers that already opened the file keep reading it after unlink
+    if (unlink(PathOf(key).c_str()) != 0 && errno != ENOENT) {
+      KATANA_LOG_DEBUG(
+          "evicting {}: {}", PathOf(key), katana::ResultErrno().message());
+    }
+    auto it = entries_.find(key);
+    KATANA_LOG_DEBUG_ASSERT(it != entries_.end());
+    stats_.bytes_cached -= it->second.size;
+    entries_.erase(it);
+    lru_.pop_back();
+    ++stats_.evictions;
+  }
+}
+
+katana::Result<void>
+tsuba::FileCache::Fetch(
+    FileStorage* fs, const std::string& uri, const StatBuf& stat_buf,
+    const std::string& key, const TransferOpts& opts) {
+  std::string tmp_path = PathOf(key) + std::string(kTempMarker) + "XXXXXX";
+  int fd = mkstemp(tmp_path.data());
+  if (fd < 0) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "creating {}: {}", tmp_path,
+        katana::ResultErrno().message());
+  }
+
+  // Fetch straight into the page cache of the new file rather than through
+  // an intermediate buffer
+  auto fetch = [&]() -> katana::Result<void> {
+    if (stat_buf.size == 0) {
+      return katana::ResultSuccess();
+    }
+    if (ftruncate(fd, stat_buf.size) != 0) {
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError, "sizing {}: {}", tmp_path,
+          katana::ResultErrno().message());
+    }
+    void* ptr =
+        mmap(nullptr, stat_buf.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError, "mapping {}: {}", tmp_path,
+          katana::ResultErrno().message());
+    }
+    auto res = fs->GetParallel(
+        uri, 0, stat_buf.size, static_cast<uint8_t*>(ptr), opts);
+    munmap(ptr, stat_buf.size);
+    return res;
+  };
+
+  auto res = fetch();
+  close(fd);
+  if (res && rename(tmp_path.c_str(), PathOf(key).c_str()) != 0) {
+    res = KATANA_ERROR(
+        ErrorCode::LocalStorageError, "renaming {}: {}", tmp_path,
+        katana::ResultErrno().message());
+  }
+  if (!res) {
+    unlink(tmp_path.c_str());
+    return res.error().WithContext("caching {}", uri);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.find(key) == entries_.end()) {
+    auto pos = lru_.insert(lru_.begin(), key);
+    entries_.emplace(key, Entry{stat_buf.size, pos});
+    stats_.bytes_cached += stat_buf.size;
+    EvictLocked();
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::FileCache::ReadEntry(
+    const std::string& key, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  std::string path = PathOf(key);
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening {}: {}", path,
+        katana::ResultErrno().message());
+  }
+
+  // Like LocalStorage, tolerate callers asking for a little more than the
+  // file holds
+  uint64_t done = 0;
+  int err = 0;
+  while (done < size) {
+    ssize_t ret = pread(fd, result_buf + done, size - done, start + done);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      err = errno;
+    }
+    if (ret <= 0) {
+      break;
+    }
+    done += ret;
+  }
+  // record recency for other processes that share the cache
+  futimens(fd, nullptr);
+  close(fd);
+
+  if (err != 0) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "reading {}: {}", path,
+        std::error_code(err, std::system_category()).message());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::FileCache::Stat(
+    FileStorage* fs, const std::string& uri, StatBuf* stat_buf) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = scoped_stats_.find(uri); it != scoped_stats_.end()) {
+      *stat_buf = it->second;
+      return katana::ResultSuccess();
+    }
+  }
+
+  // concurrent first reads of a file may each Stat it; they agree
+  KATANA_CHECKED(fs->Stat(uri, stat_buf));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stat_scopes_ > 0) {
+    scoped_stats_.emplace(uri, *stat_buf);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::FileCache::Get(
+    FileStorage* fs, const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf, const TransferOpts& opts) {
+  StatBuf stat_buf;
+  if (auto res = Stat(fs, uri, &stat_buf); !res) {
+    return res.error().WithContext("checking cached file {}", uri);
+  }
+
+  std::string key = MakeKey(uri, stat_buf);
+  if (key.empty() || stat_buf.size > capacity_) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.bypasses;
+    }
+    return fs->GetParallel(uri, start, size, result_buf, opts);
+  }
+
+  std::shared_future<katana::CopyableResult<void>> pending;
+  std::promise<katana::CopyableResult<void>> promise;
+  bool is_fetcher = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = entries_.find(key); it != entries_.end()) {
+      ++stats_.hits;
+      Touch(&it->second);
+    } else if (auto fit = fetching_.find(key); fit != fetching_.end()) {
+      ++stats_.waits;
+      pending = fit->second;
+    } else {
+      ++stats_.misses;
+      pending = promise.get_future().share();
+      fetching_.emplace(key, pending);
+      is_fetcher = true;
+    }
+  }
+
+  if (is_fetcher) {
+    auto res = Fetch(fs, uri, stat_buf, key, opts);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      fetching_.erase(key);
+    }
+    if (res) {
+      promise.set_value(katana::CopyableResultSuccess());
+    } else {
+      promise.set_value(katana::CopyableErrorInfo{res.error()});
+    }
+  }
+
+  if (pending.valid()) {
+    if (const auto& res = pending.get(); !res) {
+      return res.error();
+    }
+  }
+
+  if (auto res = ReadEntry(key, start, size, result_buf); !res) {
+    // another process sharing the directory may have evicted the file
+    KATANA_LOG_DEBUG("reading {} from cache: {}", uri, res.error());
+    Forget(key);
+    return fs->GetParallel(uri, start, size, result_buf, opts);
+  }
+  return katana::ResultSuccess();
+}
+
+tsuba::FileCacheStats
+tsuba::FileCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void
+tsuba::FileCache::BeginStatScope() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stat_scopes_;
+}
+
+void
+tsuba::FileCache::EndStatScope() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  KATANA_LOG_DEBUG_ASSERT(stat_scopes_ > 0);
+  if (--stat_scopes_ == 0) {
+    scoped_stats_.clear();
+  }
+}
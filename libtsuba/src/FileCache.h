@@ -0,0 +1,104 @@
+#ifndef KATANA_LIBTSUBA_FILECACHE_H_
+#define KATANA_LIBTSUBA_FILECACHE_H_
+
+#include <cstdint>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "katana/Result.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/file.h"
+
+namespace tsuba {
+
+/// A size-bounded cache of remote files on the local file system.
+///
+/// Entries are whole files named by a hash of the file URI and its version
+/// (StatBuf::version, or the size and modification time if the backend does
+/// not report a version). A read of any range of a file that is not cached
+/// fetches the entire file; other readers of the same file wait for that fetch
+/// instead of issuing their own. Files larger than the cache, and files whose
+/// backend reports neither a version nor a modification time, are read
+/// directly from the backend since a change to them could not be detected.
+///
+/// The least recently used entries are deleted when the cache grows beyond
+/// its limit. Recency is recorded in file modification times so that it
+/// survives across processes sharing the same cache directory.
+///
+/// The cache is configured with KATANA_TSUBA_CACHE_DIR (the cache is disabled
+/// if unset) and KATANA_TSUBA_CACHE_SIZE_MB (default 10 GiB).
+class FileCache {
+public:
+  static constexpr int kDefaultSizeMB = 10 << 10;
+
+  katana::Result<void> Init();
+  katana::Result<void> Fini();
+
+  bool enabled() const { return !dir_.empty(); }
+
+  /// Read \param size bytes of \param uri starting at \param start into
+  /// \param result_buf, filling the cache from \param fs if needed. Reads
+  /// from \param fs are split according to \param opts.
+  katana::Result<void> Get(
+      FileStorage* fs, const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf, const TransferOpts& opts);
+
+  FileCacheStats stats() const;
+
+  /// Between BeginStatScope and the matching EndStatScope, Get reuses the
+  /// first Stat of each file instead of issuing one per read (see
+  /// FileStatScope). Scopes nest; the reused stats are dropped when the
+  /// outermost one ends.
+  void BeginStatScope();
+  void EndStatScope();
+
+private:
+  struct Entry {
+    uint64_t size;
+    std::list<std::string>::iterator lru_pos;
+  };
+
+  katana::Result<void> LoadIndex();
+  katana::Result<void> Stat(
+      FileStorage* fs, const std::string& uri, StatBuf* stat_buf);
+  katana::Result<void> Fetch(
+      FileStorage* fs, const std::string& uri, const StatBuf& stat_buf,
+      const std::string& key, const TransferOpts& opts);
+  katana::Result<void> ReadEntry(
+      const std::string& key, uint64_t start, uint64_t size,
+      uint8_t* result_buf);
+  /// Make key the most recently used entry. Call with mutex_ held.
+  void Touch(Entry* entry);
+  /// Drop key from the index, e.g., because another process deleted it
+  void Forget(const std::string& key);
+  /// Delete entries until the cache fits. Call with mutex_ held.
+  void EvictLocked();
+
+  std::string PathOf(const std::string& key) const {
+    return dir_ + "/" + key;
+  }
+
+  std::string dir_;
+  uint64_t capacity_{0};
+
+  mutable std::mutex mutex_;
+  /// most recently used first
+  std::list<std::string> lru_;
+  std::unordered_map<std::string, Entry> entries_;
+  /// fetches in progress; readers of the same file wait on these
+  std::unordered_map<
+      std::string, std::shared_future<katana::CopyableResult<void>>>
+      fetching_;
+  FileCacheStats stats_;
+  /// number of open stat scopes
+  uint32_t stat_scopes_{0};
+  /// stats reused while stat_scopes_ > 0, by uri
+  std::unordered_map<std::string, StatBuf> scoped_stats_;
+};
+
+}  // namespace tsuba
+
+#endif
@@ -2,8 +2,8 @@
 
 #include <sys/mman.h>
 
+#include "MemoryPolicy.h"
 #include "katana/Logging.h"
-#include "katana/Platform.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
 #include "tsuba/file.h"
@@ -32,12 +32,8 @@ katana::Result<void>
 FileFrame::Init(uint64_t reserved_size) {
   size_t size_to_reserve = reserved_size <= 0 ? 1 : reserved_size;
   uint64_t map_size = tsuba::RoundUpToBlock(size_to_reserve);
-  void* ptr = katana::MmapPopulate(
-      nullptr, map_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
-      -1, 0);
-  if (ptr == MAP_FAILED) {
-    return KATANA_ERROR(katana::ResultErrno(), "mapping buffer");
-  }
+  void* ptr = KATANA_CHECKED_CONTEXT(
+      MapAnonymous(&map_size, PROT_READ | PROT_WRITE, true), "mapping buffer");
   if (auto res = Destroy(); !res) {
     KATANA_LOG_ERROR("Destroy: {}", res.error());
   }
@@ -57,28 +53,24 @@ FileFrame::Bind(std::string_view filename) {
 
 katana::Result<void>
 FileFrame::MapContguousExtension(uint64_t new_size) {
-  void* ptr = katana::MmapPopulate(
-      map_start_ + map_size_, new_size - map_size_, PROT_READ | PROT_WRITE,
-      MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+  // the extension may be rounded up to the page size in use
+  uint64_t extension_size = new_size - map_size_;
+  void* ptr = KATANA_CHECKED_CONTEXT(
+      MapAnonymous(
+          &extension_size, PROT_READ | PROT_WRITE, true,
+          map_start_ + map_size_),
+      "mapping new memory to extend buffer");
+  new_size = map_size_ + extension_size;
   if (ptr != map_start_ + map_size_) {
-    if (ptr != MAP_FAILED) {
-      // Mapping succeeded, but not where we wanted it
-      int err = munmap(ptr, new_size - map_size_);
-      if (err) {
-        return KATANA_ERROR(katana::ResultErrno(), "unmapping buffer");
-      }
-    } else {
-      return KATANA_ERROR(
-          katana::ResultErrno(), "mapping new memory to extend buffer");
+    // Mapping succeeded, but not where we wanted it
+    int err = munmap(ptr, extension_size);
+    if (err) {
+      return KATANA_ERROR(katana::ResultErrno(), "unmapping buffer");
     }
     // Just allocate a brand new buffer :(
-    ptr = nullptr;
-    ptr = katana::MmapPopulate(
-        nullptr, new_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
-        -1, 0);
-    if (ptr == MAP_FAILED) {
-      return KATANA_ERROR(katana::ResultErrno(), "mapping new buffer");
-    }
+    ptr = KATANA_CHECKED_CONTEXT(
+        MapAnonymous(&new_size, PROT_READ | PROT_WRITE, true),
+        "mapping new buffer");
     memcpy(ptr, map_start_, cursor_);
     int err = munmap(map_start_, map_size_);
     if (err) {
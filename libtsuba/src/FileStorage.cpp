@@ -1,9 +1,195 @@
 #include "tsuba/FileStorage.h"
 
+#include <algorithm>
+#include <deque>
+
 #include "FileStorage_internal.h"
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "tsuba/Errors.h"
+
+namespace {
+
+/// Grow the part size if needed so that one transfer has at most kMaxParts
+uint64_t
+PartSize(uint64_t size, const tsuba::TransferOpts& opts) {
+  constexpr uint64_t kMaxParts = tsuba::TransferOpts::kMaxParts;
+  uint64_t min_part_size = (size + kMaxParts - 1) / kMaxParts;
+  return std::max({opts.part_size, min_part_size, UINT64_C(1)});
+}
+
+/// Call start_part(part_num, offset, part_size) for each part of a transfer
+/// of size bytes with at most max_parallel parts in flight. After the first
+/// error no more parts are started; parts in flight are waited for.
+template <typename StartPart>
+katana::Result<void>
+RunParts(
+    uint64_t size, uint64_t part_size, uint32_t max_parallel,
+    const StartPart& start_part) {
+  std::deque<std::future<katana::CopyableResult<void>>> in_flight;
+  katana::CopyableResult<void> ret = katana::CopyableResultSuccess();
+  auto wait_one = [&]() {
+    auto res = in_flight.front().get();
+    in_flight.pop_front();
+    if (!res && ret) {
+      ret = std::move(res);
+    }
+  };
+
+  uint64_t part_num = 0;
+  for (uint64_t offset = 0; offset < size && ret; offset += part_size) {
+    while (in_flight.size() >= max_parallel) {
+      wait_one();
+    }
+    if (!ret) {
+      break;
+    }
+    in_flight.emplace_back(
+        start_part(part_num++, offset, std::min(part_size, size - offset)));
+  }
+  while (!in_flight.empty()) {
+    wait_one();
+  }
+
+  if (!ret) {
+    return ret.error();
+  }
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+NotImplementedAsync(std::string_view uri_scheme) {
+  std::string scheme(uri_scheme);
+  return std::async(
+      std::launch::deferred, [scheme]() -> katana::CopyableResult<void> {
+        return KATANA_ERROR(
+            tsuba::ErrorCode::NotImplemented,
+            "{} storage does not support multipart uploads", scheme);
+      });
+}
+
+}  // namespace
+
+katana::Result<tsuba::TransferOpts>
+tsuba::TransferOpts::FromEnv() {
+  TransferOpts opts;
+
+  int part_size_mb = kDefaultPartSize >> 20;
+  katana::GetEnv("KATANA_TSUBA_PART_SIZE_MB", &part_size_mb);
+  if (part_size_mb <= 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "part size must be positive: {}",
+        part_size_mb);
+  }
+  opts.part_size = static_cast<uint64_t>(part_size_mb) << 20;
+
+  int max_parallel_parts = kDefaultMaxParallelParts;
+  katana::GetEnv("KATANA_TSUBA_MAX_PARALLEL_PARTS", &max_parallel_parts);
+  if (max_parallel_parts <= 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "parallel parts must be positive: {}",
+        max_parallel_parts);
+  }
+  opts.max_parallel_parts = max_parallel_parts;
+
+  return opts;
+}
 
 tsuba::FileStorage::~FileStorage() = default;
 
+katana::Result<uint8_t*>
+tsuba::FileStorage::MapReadOnly(const std::string&, uint64_t) {
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented, "{} storage does not support mapping",
+      uri_scheme());
+}
+
+katana::Result<std::string>
+tsuba::FileStorage::BeginMultipartPut(const std::string&) {
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented,
+      "{} storage does not support multipart uploads", uri_scheme());
+}
+
+std::future<katana::CopyableResult<void>>
+tsuba::FileStorage::PutPartAsync(
+    const std::string&, const std::string&, uint64_t, const uint8_t*,
+    uint64_t) {
+  return NotImplementedAsync(uri_scheme());
+}
+
+katana::Result<void>
+tsuba::FileStorage::CompleteMultipartPut(
+    const std::string&, const std::string&, uint64_t) {
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented,
+      "{} storage does not support multipart uploads", uri_scheme());
+}
+
+katana::Result<void>
+tsuba::FileStorage::AbortMultipartPut(const std::string&, const std::string&) {
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented,
+      "{} storage does not support multipart uploads", uri_scheme());
+}
+
+katana::Result<void>
+tsuba::FileStorage::GetParallel(
+    const std::string& uri, uint64_t start, uint64_t size, uint8_t* result_buf,
+    const TransferOpts& opts) {
+  if (opts.max_parallel_parts <= 1 || size <= opts.part_size) {
+    return GetMultiSync(uri, start, size, result_buf);
+  }
+
+  auto res = RunParts(
+      size, PartSize(size, opts), opts.max_parallel_parts,
+      [&](uint64_t, uint64_t offset, uint64_t part_size) {
+        return GetAsync(uri, start + offset, part_size, result_buf + offset);
+      });
+  if (!res) {
+    return res.error().WithContext("reading {}", uri);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::FileStorage::PutParallel(
+    const std::string& uri, const uint8_t* data, uint64_t size,
+    const TransferOpts& opts) {
+  if (opts.max_parallel_parts <= 1 || size <= opts.part_size) {
+    return PutMultiSync(uri, data, size);
+  }
+
+  auto upload_res = BeginMultipartPut(uri);
+  if (!upload_res) {
+    if (upload_res.error() == ErrorCode::NotImplemented) {
+      return PutMultiSync(uri, data, size);
+    }
+    return upload_res.error().WithContext("starting upload of {}", uri);
+  }
+  std::string upload_id = std::move(upload_res.value());
+
+  uint64_t part_size = PartSize(size, opts);
+  auto res = RunParts(
+      size, part_size, opts.max_parallel_parts,
+      [&](uint64_t part_num, uint64_t offset, uint64_t this_part_size) {
+        return PutPartAsync(
+            uri, upload_id, part_num, data + offset, this_part_size);
+      });
+  if (!res) {
+    if (auto abort_res = AbortMultipartPut(uri, upload_id); !abort_res) {
+      KATANA_LOG_DEBUG("aborting upload of {}: {}", uri, abort_res.error());
+    }
+    return res.error().WithContext("uploading {}", uri);
+  }
+
+  uint64_t num_parts = (size + part_size - 1) / part_size;
+  if (auto res = CompleteMultipartPut(uri, upload_id, num_parts); !res) {
+    return res.error().WithContext("finishing upload of {}", uri);
+  }
+  return katana::ResultSuccess();
+}
+
 std::vector<tsuba::FileStorage*>&
 tsuba::GetRegisteredFileStorages() {
   static std::vector<FileStorage*> fs;
@@ -3,10 +3,15 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <deque>
 #include <string>
 
+#include "Checksum.h"
+#include "MemoryPolicy.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
@@ -30,6 +35,99 @@
  * somehow and also tell users to not modify our files?
  */
 
+/// Checksums of the pages of a file as they are fetched; the file is checked
+/// once every page has been seen. Pages may be fetched more than once (see
+/// MustFill), so progress is counted in pages rather than bytes.
+struct tsuba::FileView::ChecksumState {
+  std::mutex mutex;
+  std::string filename;
+  uint32_t expected;
+  uint64_t file_size;
+  uint8_t page_shift;
+  std::vector<uint32_t> page_crcs;
+  std::vector<bool> page_seen;
+  uint64_t pages_seen{0};
+  bool checked{false};
+
+  ChecksumState(
+      std::string filename_, uint32_t expected_, uint64_t file_size_,
+      uint8_t page_shift_)
+      : filename(std::move(filename_)),
+        expected(expected_),
+        file_size(file_size_),
+        page_shift(page_shift_) {
+    uint64_t num_pages = ((file_size - 1) >> page_shift) + 1;
+    page_crcs.resize(num_pages);
+    page_seen.resize(num_pages);
+  }
+
+  uint64_t PageSize(uint64_t page) const {
+    return std::min<uint64_t>(
+        uint64_t{1} << page_shift, file_size - (page << page_shift));
+  }
+
+  katana::CopyableResult<void> Check(uint32_t actual) {
+    checked = true;
+    if (actual != expected) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::ChecksumMismatch,
+          "{}: expected crc32c {:08x} but found {:08x}", filename, expected,
+          actual);
+    }
+    return katana::CopyableResultSuccess();
+  }
+
+  /// Note the checksum of a fetched page, checking the file if it was the
+  /// last page missing
+  katana::CopyableResult<void> AddPage(uint64_t page, uint32_t crc) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (checked || page_seen[page]) {
+      return katana::CopyableResultSuccess();
+    }
+    page_seen[page] = true;
+    page_crcs[page] = crc;
+    if (++pages_seen < page_crcs.size()) {
+      return katana::CopyableResultSuccess();
+    }
+    uint32_t actual = 0;
+    for (uint64_t i = 0; i < page_crcs.size(); ++i) {
+      actual = tsuba::Crc32cCombine(actual, page_crcs[i], PageSize(i));
+    }
+    return Check(actual);
+  }
+};
+
+namespace {
+
+/// Pages fetched by each read while checksumming
+constexpr uint64_t kChecksumFetchPages = 8;
+/// Reads in flight per fill while checksumming
+constexpr uint64_t kChecksumFetchWindow = 8;
+
+/// A slice of a FileView mapping that keeps the mapping alive
+class MappedBuffer : public arrow::Buffer {
+public:
+  MappedBuffer(std::shared_ptr<uint8_t> mapping, int64_t offset, int64_t size)
+      : arrow::Buffer(mapping.get() + offset, size),
+        mapping_(std::move(mapping)) {}
+
+private:
+  std::shared_ptr<uint8_t> mapping_;
+};
+
+std::shared_ptr<uint8_t>
+OwnMapping(void* ptr, uint64_t size) {
+  return std::shared_ptr<uint8_t>(
+      static_cast<uint8_t*>(ptr), [size](uint8_t* p) {
+        if (munmap(p, size) != 0) {
+          KATANA_LOG_ERROR(
+              "unmapping buffer: {}", katana::ResultErrno().message());
+        }
+      });
+}
+
+}  // namespace
+
 namespace tsuba {
 
 FileView::~FileView() {
@@ -46,19 +144,19 @@ FileView::Unbind() {
     if (auto res = Resolve(0, file_size_); !res) {
       return res.error().WithContext("resolving for unmap");
     }
-    if (map_start_ != nullptr) {
-      if (int err = munmap(map_start_, file_size_); err) {
-        return KATANA_ERROR(katana::ResultErrno(), "unmapping buffer");
-      }
-    }
+    // the mapping is unmapped once no buffer returned by Read refers to it
+    mapping_.reset();
+    map_start_ = nullptr;
     valid_ = false;
+    file_backed_ = false;
   }
   return katana::ResultSuccess();
 }
 
 katana::Result<void>
 FileView::Bind(
-    std::string_view filename, uint64_t begin, uint64_t end, bool resolve) {
+    std::string_view filename, uint64_t begin, uint64_t end, bool resolve,
+    std::optional<uint32_t> crc32c) {
   StatBuf buf;
   filename_ = filename;
   if (auto res = FileStat(filename_, &buf); !res) {
@@ -78,12 +176,28 @@ FileView::Bind(
   // here.
   page_shift_ = 20; /* 1M */
   void* tmp = nullptr;
+  bool file_backed = false;
+
+  // Prefer mapping the file itself; the kernel then only reads the pages we
+  // touch and there is no second copy of the data in anonymous memory
+  if (buf.size > 0) {
+    if (auto res = FileMapReadOnly(filename_, buf.size); res) {
+      tmp = res.value();
+      file_backed = true;
+    } else if (res.error() != ErrorCode::NotImplemented) {
+      KATANA_LOG_DEBUG(
+          "falling back to reading {}: {}", filename_, res.error());
+    }
+  }
 
-  // Map enough virtual memory to hold entire file, but do not populate it
-  tmp = mmap(nullptr, buf.size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-  if (tmp == MAP_FAILED) {
-    return KATANA_ERROR(
-        katana::ResultErrno(), "reserving contiguous range {}", buf.size);
+  if (!file_backed) {
+    // Map enough virtual memory to hold entire file, but do not populate
+    // it. Fill mprotects this region at a granularity finer than explicit
+    // huge pages allow.
+    uint64_t reserve_size = buf.size;
+    tmp = KATANA_CHECKED_CONTEXT(
+        MapAnonymous(&reserve_size, PROT_NONE, false, nullptr, false),
+        "reserving contiguous range {}", buf.size);
   }
 
   if (auto res = Unbind(); !res) {
@@ -91,10 +205,17 @@ FileView::Bind(
   }
 
   map_start_ = static_cast<uint8_t*>(tmp);
-  mem_start_ = -1;
+  mapping_ = OwnMapping(tmp, buf.size);
+  file_backed_ = file_backed;
+  mem_start_ = file_backed ? 0 : -1;
   filling_.resize(page_number(buf.size) / 64 + 1, 0);
   file_size_ = buf.size;
   fetches_ = std::make_unique<std::vector<FillingRange>>();
+  checksum_.reset();
+  if (crc32c && buf.size > 0) {
+    checksum_ = std::make_shared<ChecksumState>(
+        filename_, crc32c.value(), buf.size, page_shift_);
+  }
   if (auto res = Fill(begin, in_end, resolve); !res) {
     return res.error().WithContext("reading content");
   }
@@ -118,6 +239,29 @@ FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   if (!fetches_) {
     return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
   }
+  if (file_backed_) {
+    if (checksum_ && in_begin == 0 && in_end == file_size_) {
+      std::lock_guard<std::mutex> lock(checksum_->mutex);
+      if (!checksum_->checked) {
+        // reading the mapping is reading the file; nothing is copied
+        KATANA_CHECKED(checksum_->Check(Crc32c(map_start_, file_size_)));
+      }
+      return katana::ResultSuccess();
+    }
+    // Everything is already addressable; just ask the kernel to start reading
+    // the region in the background
+    if (in_end != in_begin) {
+      uint64_t page_mask = static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) - 1;
+      uint64_t aligned_begin = in_begin & ~page_mask;
+      if (madvise(
+              map_start_ + aligned_begin, in_end - aligned_begin,
+              MADV_WILLNEED) != 0) {
+        KATANA_LOG_DEBUG(
+            "madvise {}: {}", filename_, katana::ResultErrno().message());
+      }
+    }
+    return katana::ResultSuccess();
+  }
   // Gracefully handle the fill zero case here to simplify Bind
   if (in_end != in_begin) {
     if (auto opt =
@@ -140,7 +284,9 @@ FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
       }
 
       auto peek_fut =
-          FileGetAsync(filename_, map_start_ + file_off, file_off, map_size);
+          checksum_ ? FetchAndChecksum(first_page, last_page)
+                    : FileGetAsync(
+                          filename_, map_start_ + file_off, file_off, map_size);
       KATANA_LOG_ASSERT(peek_fut.valid());
       FillingRange fetch = {first_page, last_page, std::move(peek_fut)};
       fetches_->push_back(std::move(fetch));
@@ -217,37 +363,47 @@ FileView::Seek(int64_t seek_to) {
   return arrow::Status::OK();
 }
 
-arrow::Result<std::shared_ptr<arrow::Buffer>>
-FileView::Read(int64_t nbytes) {
-  // sanitize inputs
-  if (nbytes <= 0) {
-    return std::make_shared<arrow::Buffer>(map_start_, 0);
-  }
+arrow::Result<int64_t>
+FileView::PrepareRead(int64_t position, int64_t nbytes) {
   if (!valid_) {
     return arrow::Status(arrow::StatusCode::Invalid, "Unbound FileView");
   }
+  if (position < 0 || position > file_size_) {
+    return arrow::Status::Invalid(
+        "Cannot read at ", position, " in file of size ", file_size_);
+  }
   int64_t nbytes_internal = nbytes;
-  if (cursor_ + nbytes > file_size_) {
-    nbytes_internal = file_size_ - cursor_;
+  if (position + nbytes > file_size_) {
+    nbytes_internal = file_size_ - position;
   }
   // fetch data from storage if necessary
-  if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
+  if (auto res = Fill(position, position + nbytes_internal, true); !res) {
     return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
   }
   // resolve outstanding relevant fetches
-  if (auto res = Resolve(cursor_, nbytes_internal); !res) {
+  if (auto res = Resolve(position, nbytes_internal); !res) {
     // TODO (scober): Include res.error() as part of arrow Status
     return arrow::Status(
         arrow::StatusCode::IOError, "Resolving asynchronous reads");
   }
   // prefetch
-  if (auto res = PreFetch(cursor_, nbytes_internal); !res) {
+  if (auto res = PreFetch(position, nbytes_internal); !res) {
     // TODO (scober): Include res.error() as part of arrow Status
     return arrow::Status(arrow::StatusCode::IOError, "prefetching");
   }
+  return nbytes_internal;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+FileView::Read(int64_t nbytes) {
+  // sanitize inputs
+  if (nbytes <= 0) {
+    return std::make_shared<arrow::Buffer>(map_start_, 0);
+  }
+  std::lock_guard<std::mutex> lock(read_mutex_);
+  ARROW_ASSIGN_OR_RAISE(int64_t nbytes_internal, PrepareRead(cursor_, nbytes));
   // and return the requested data
-  auto ret =
-      std::make_shared<arrow::Buffer>(map_start_ + cursor_, nbytes_internal);
+  auto ret = std::make_shared<MappedBuffer>(mapping_, cursor_, nbytes_internal);
   cursor_ += nbytes_internal;
   return ret;
 }
@@ -258,34 +414,35 @@ FileView::Read(int64_t nbytes, void* out) {
   if (nbytes <= 0) {
     return nbytes;
   }
-  if (!valid_) {
-    return arrow::Status(arrow::StatusCode::Invalid, "Unbound FileView");
-  }
-  int64_t nbytes_internal = nbytes;
-  if (cursor_ + nbytes > file_size_) {
-    nbytes_internal = file_size_ - cursor_;
-  }
-  // fetch data from storage if necessary
-  if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
-    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
-  }
-  // resolve outstanding relevant fetches
-  if (auto res = Resolve(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(
-        arrow::StatusCode::IOError, "Resolving asynchronous reads");
-  }
-  // prefetch
-  if (auto res = PreFetch(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(arrow::StatusCode::IOError, "prefetching");
-  }
+  std::lock_guard<std::mutex> lock(read_mutex_);
+  ARROW_ASSIGN_OR_RAISE(int64_t nbytes_internal, PrepareRead(cursor_, nbytes));
   // and return the requested data
   std::memcpy(out, map_start_ + cursor_, nbytes_internal);
   cursor_ += nbytes_internal;
   return nbytes_internal;
 }
 
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+FileView::ReadAt(int64_t position, int64_t nbytes) {
+  if (nbytes <= 0) {
+    return std::make_shared<arrow::Buffer>(map_start_, 0);
+  }
+  std::lock_guard<std::mutex> lock(read_mutex_);
+  ARROW_ASSIGN_OR_RAISE(int64_t nbytes_internal, PrepareRead(position, nbytes));
+  return std::make_shared<MappedBuffer>(mapping_, position, nbytes_internal);
+}
+
+arrow::Result<int64_t>
+FileView::ReadAt(int64_t position, int64_t nbytes, void* out) {
+  if (nbytes <= 0) {
+    return nbytes;
+  }
+  std::lock_guard<std::mutex> lock(read_mutex_);
+  ARROW_ASSIGN_OR_RAISE(int64_t nbytes_internal, PrepareRead(position, nbytes));
+  std::memcpy(out, map_start_ + position, nbytes_internal);
+  return nbytes_internal;
+}
+
 arrow::Result<int64_t>
 FileView::GetSize() {
   return size();
@@ -476,6 +633,61 @@ FileView::Resolve(int64_t start, int64_t size) {
   return katana::ResultSuccess();
 }
 
+std::future<katana::CopyableResult<void>>
+FileView::FetchAndChecksum(uint64_t first_page, uint64_t last_page) {
+  return std::async(
+      std::launch::async,
+      [state = checksum_, map_start = map_start_, first_page,
+       last_page]() mutable -> katana::CopyableResult<void> {
+        using Fetch = std::future<katana::CopyableResult<void>>;
+        // by first page
+        std::deque<std::pair<uint64_t, Fetch>> fetches;
+        katana::CopyableResult<void> ret = katana::CopyableResultSuccess();
+        // Fill rounds the end of the file up to a page
+        last_page = std::min<uint64_t>(last_page, state->page_crcs.size() - 1);
+        uint64_t next_page = first_page;
+        while (next_page <= last_page || !fetches.empty()) {
+          // keep a window of reads in flight while checksumming the oldest
+          while (next_page <= last_page &&
+                 fetches.size() < kChecksumFetchWindow) {
+            uint64_t end_page =
+                std::min(next_page + kChecksumFetchPages - 1, last_page);
+            uint64_t offset = next_page << state->page_shift;
+            uint64_t size = 0;
+            for (uint64_t p = next_page; p <= end_page; ++p) {
+              size += state->PageSize(p);
+            }
+            fetches.emplace_back(
+                next_page, FileGetAsync(
+                               state->filename, map_start + offset, offset,
+                               size));
+            next_page = end_page + 1;
+          }
+
+          auto [page, fetch] = std::move(fetches.front());
+          fetches.pop_front();
+          if (auto res = fetch.get(); !res) {
+            ret = res;
+          }
+          if (!ret) {
+            // keep draining; the reads in flight still write to the mapping
+            continue;
+          }
+          uint64_t end_page =
+              std::min(page + kChecksumFetchPages - 1, last_page);
+          for (uint64_t p = page; p <= end_page; ++p) {
+            // the page was just written, so this reads it from cache
+            uint32_t crc = Crc32c(
+                map_start + (p << state->page_shift), state->PageSize(p));
+            if (auto res = state->AddPage(p, crc); !res) {
+              ret = res;
+            }
+          }
+        }
+        return ret;
+      });
+}
+
 katana::Result<void>
 FileView::PreFetch(int64_t start, int64_t size) {
   // Our highly sophisticated prefetching algorithm is to crudely approximate
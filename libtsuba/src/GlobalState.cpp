@@ -16,22 +16,47 @@ tsuba::GlobalState::Comm() const {
   return comm_;
 }
 
+tsuba::FileStorage*
+tsuba::GlobalState::Initialized(Store* store) {
+  std::call_once(store->init_once, [store]() {
+    if (auto res = store->fs->Init(); !res) {
+      // Before backends were initialized on demand this failed Init, which
+      // is fatal; there is no caller to return the error to here
+      KATANA_LOG_FATAL(
+          "initializing {} storage: {}", store->fs->uri_scheme(),
+          res.error());
+    }
+    store->initialized = true;
+  });
+  return store->fs;
+}
+
 tsuba::FileStorage*
 tsuba::GlobalState::GetDefaultFS() const {
   KATANA_LOG_DEBUG_ASSERT(file_stores_.size() > 0);
-  return file_stores_[0];
+  return Initialized(file_stores_[0].get());
 }
 
 tsuba::FileStorage*
 tsuba::GlobalState::FS(std::string_view uri) const {
-  for (FileStorage* fs : file_stores_) {
-    if (uri.find(fs->uri_scheme()) == 0) {
-      return fs;
+  for (const auto& store : file_stores_) {
+    if (uri.find(store->fs->uri_scheme()) == 0) {
+      return Initialized(store.get());
     }
   }
   return GetDefaultFS();
 }
 
+tsuba::FileCache*
+tsuba::GlobalState::Cache() const {
+  return file_cache_.get();
+}
+
+const tsuba::TransferOpts&
+tsuba::GlobalState::Transfer() const {
+  return transfer_opts_;
+}
+
 katana::Result<void>
 tsuba::GlobalState::Init(katana::CommBackend* comm) {
   KATANA_LOG_DEBUG_ASSERT(ref_ == nullptr);
@@ -41,32 +66,39 @@ tsuba::GlobalState::Init(katana::CommBackend* comm) {
 
   std::vector<FileStorage*>& registered = GetRegisteredFileStorages();
   for (FileStorage* fs : registered) {
-    global_state->file_stores_.emplace_back(fs);
+    global_state->file_stores_.emplace_back(std::make_unique<Store>(fs));
   }
   registered.clear();
 
   std::sort(
       global_state->file_stores_.begin(), global_state->file_stores_.end(),
-      [](const FileStorage* lhs, const FileStorage* rhs) {
-        return lhs->Priority() > rhs->Priority();
+      [](const auto& lhs, const auto& rhs) {
+        return lhs->fs->Priority() > rhs->fs->Priority();
       });
 
-  for (FileStorage* fs : global_state->file_stores_) {
-    if (auto res = fs->Init(); !res) {
-      return res.error().WithContext("initializing backends");
-    }
+  if (auto res = global_state->file_cache_->Init(); !res) {
+    return res.error().WithContext("initializing file cache");
   }
 
+  global_state->transfer_opts_ = KATANA_CHECKED_CONTEXT(
+      TransferOpts::FromEnv(), "initializing transfer options");
+
   ref_ = std::move(global_state);
   return katana::ResultSuccess();
 }
 
 katana::Result<void>
 tsuba::GlobalState::Fini() {
-  for (FileStorage* fs : ref_->file_stores_) {
-    if (auto res = fs->Fini(); !res) {
+  if (auto res = ref_->file_cache_->Fini(); !res) {
+    return res.error().WithContext("file cache shutdown");
+  }
+  for (const auto& store : ref_->file_stores_) {
+    if (!store->initialized) {
+      continue;
+    }
+    if (auto res = store->fs->Fini(); !res) {
       return res.error().WithContext(
-          "file storage shutdown ({})", fs->uri_scheme());
+          "file storage shutdown ({})", store->fs->uri_scheme());
     }
   }
   ref_.reset(nullptr);
@@ -91,6 +123,16 @@ tsuba::FS(std::string_view uri) {
   return GlobalState::Get().FS(uri);
 }
 
+tsuba::FileCache*
+tsuba::Cache() {
+  return GlobalState::Get().Cache();
+}
+
+const tsuba::TransferOpts&
+tsuba::Transfer() {
+  return GlobalState::Get().Transfer();
+}
+
 katana::Result<void>
 tsuba::OneHostOnly(const std::function<katana::Result<void>()>& cb) {
   // Prevent a race when the callback affects a condition guarding the
@@ -2,9 +2,14 @@
 #define KATANA_LIBTSUBA_GLOBALSTATE_H_
 
 #include <memory>
+#include <mutex>
 #include <vector>
 
+#include "FileCache.h"
 #include "LocalStorage.h"
+#ifdef KATANA_USE_IO_URING
+#include "IOUringStorage.h"
+#endif
 #include "katana/CommBackend.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -15,16 +20,38 @@ namespace tsuba {
 class GlobalState {
   static std::unique_ptr<GlobalState> ref_;
 
-  std::vector<FileStorage*> file_stores_;
+  /// A backend is initialized when it is first selected by FS rather than
+  /// by Init, since some, e.g., cloud SDKs, take long to start and most
+  /// programs use only one or two backends
+  struct Store {
+    explicit Store(FileStorage* fs_) : fs(fs_) {}
+
+    FileStorage* fs;
+    std::once_flag init_once;
+    bool initialized{false};
+  };
+
+  std::vector<std::unique_ptr<Store>> file_stores_;
   katana::CommBackend* comm_;
 
   tsuba::LocalStorage local_storage_;
-
-  GlobalState(katana::CommBackend* comm) : comm_(comm) {
-    file_stores_.emplace_back(&local_storage_);
+#ifdef KATANA_USE_IO_URING
+  tsuba::IOUringStorage io_uring_storage_;
+#endif
+  std::unique_ptr<FileCache> file_cache_;
+  TransferOpts transfer_opts_;
+
+  GlobalState(katana::CommBackend* comm)
+      : comm_(comm), file_cache_(std::make_unique<FileCache>()) {
+    file_stores_.emplace_back(std::make_unique<Store>(&local_storage_));
+#ifdef KATANA_USE_IO_URING
+    file_stores_.emplace_back(std::make_unique<Store>(&io_uring_storage_));
+#endif
   }
 
   FileStorage* GetDefaultFS() const;
+  /// \returns the backend of store after initializing it if needed
+  static FileStorage* Initialized(Store* store);
 
 public:
   GlobalState(const GlobalState& no_copy) = delete;
@@ -42,10 +69,16 @@ public:
   /// s3://...    -> S3Store
   /// abfs://...  -> AzureStore
   /// gs://...    -> GSStore
-  /// file://...  -> LocalStore
-  /// {no scheme} -> LocalStore
+  /// file://...  -> IOUringStorage if available, otherwise LocalStore
+  /// {no scheme} -> IOUringStorage if available, otherwise LocalStore
   FileStorage* FS(std::string_view uri) const;
 
+  /// Local cache of remote files; check FileCache::enabled before use
+  FileCache* Cache() const;
+
+  /// How large transfers to and from remote backends are split
+  const TransferOpts& Transfer() const;
+
   static katana::Result<void> Init(katana::CommBackend* comm);
   static katana::Result<void> Fini();
   static const GlobalState& Get();
@@ -53,6 +86,8 @@ public:
 
 KATANA_EXPORT katana::CommBackend* Comm();
 FileStorage* FS(std::string_view uri);
+FileCache* Cache();
+const TransferOpts& Transfer();
 
 /// Execute cb on one host, if it succeeds return success if not print
 /// the error and return MpiError
@@ -0,0 +1,360 @@
+#include "IOUringStorage.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <limits>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "tsuba/Errors.h"
+
+/// One GetAsync call; completes when all of its chunks have completed
+struct tsuba::IOUringStorage::Request {
+  int fd{-1};
+  std::string path;
+  std::atomic<uint64_t> outstanding{0};
+  std::atomic<int> first_errno{0};
+  /// file offset at which a chunk ended early; max if none did
+  std::atomic<uint64_t> eof_offset{std::numeric_limits<uint64_t>::max()};
+  std::promise<katana::CopyableResult<void>> done;
+};
+
+/// One read submission; resubmitted in place on short reads
+struct tsuba::IOUringStorage::Chunk {
+  Request* request;
+  uint8_t* buf;
+  uint64_t offset;
+  uint32_t size;
+};
+
+tsuba::IOUringStorage::~IOUringStorage() {
+  if (ring_ready_) {
+    if (auto res = Fini(); !res) {
+      KATANA_LOG_ERROR("IOUringStorage::Fini: {}", res.error());
+    }
+  }
+}
+
+katana::Result<void>
+tsuba::IOUringStorage::Init() {
+  if (auto res = LocalStorage::Init(); !res) {
+    return res.error();
+  }
+
+  bool enabled = true;
+  katana::GetEnv("KATANA_TSUBA_IO_URING", &enabled);
+  if (!enabled) {
+    return katana::ResultSuccess();
+  }
+
+  int depth = kDefaultDepth;
+  katana::GetEnv("KATANA_TSUBA_IO_URING_DEPTH", &depth);
+  if (depth <= 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "io_uring depth must be positive: {}",
+        depth);
+  }
+
+  if (int ret = io_uring_queue_init(depth, &ring_, 0); ret < 0) {
+    // Older kernels and some sandboxes do not allow io_uring; behave like
+    // LocalStorage in that case
+    KATANA_LOG_DEBUG(
+        "io_uring unavailable, falling back to synchronous reads: {}",
+        std::error_code(-ret, std::system_category()).message());
+    return katana::ResultSuccess();
+  }
+  ring_ready_ = true;
+  reaper_ = std::thread([this]() { ReapLoop(); });
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::IOUringStorage::Fini() {
+  if (!ring_ready_) {
+    return LocalStorage::Fini();
+  }
+
+  {
+    // A no-op with no chunk attached tells the reaper to exit. All earlier
+    // submissions complete before the reaper observes it because callers do
+    // not call Fini with reads outstanding.
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+    int err = 0;
+    io_uring_sqe* sqe = GetSqe(&err);
+    if (sqe == nullptr) {
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError, "stopping io_uring reaper: {}",
+          std::error_code(err, std::system_category()).message());
+    }
+    io_uring_prep_nop(sqe);
+    io_uring_sqe_set_data(sqe, nullptr);
+    if (int ret = SubmitQueued(); ret < 0) {
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError, "stopping io_uring reaper: {}",
+          std::error_code(-ret, std::system_category()).message());
+    }
+  }
+  reaper_.join();
+  io_uring_queue_exit(&ring_);
+  ring_ready_ = false;
+
+  return LocalStorage::Fini();
+}
+
+int
+tsuba::IOUringStorage::SubmitQueued() {
+  for (;;) {
+    int ret = io_uring_submit(&ring_);
+    if (ret != -EBUSY && ret != -EAGAIN && ret != -EINTR) {
+      return ret;
+    }
+    // the completion queue is full or the kernel is short of resources;
+    // the reaper frees both as it drains completions
+    std::this_thread::yield();
+  }
+}
+
+io_uring_sqe*
+tsuba::IOUringStorage::GetSqe(int* err) {
+  io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  while (sqe == nullptr) {
+    // submission queue is full; hand what we have to the kernel
+    if (int ret = SubmitQueued(); ret < 0) {
+      *err = -ret;
+      return nullptr;
+    }
+    sqe = io_uring_get_sqe(&ring_);
+  }
+  return sqe;
+}
+
+bool
+tsuba::IOUringStorage::QueueResubmits() {
+  std::lock_guard<std::mutex> lock(resubmit_mutex_);
+  while (!resubmits_.empty()) {
+    io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+    if (sqe == nullptr) {
+      return true;
+    }
+    Chunk* chunk = resubmits_.back();
+    resubmits_.pop_back();
+    io_uring_prep_read(
+        sqe, chunk->request->fd, chunk->buf, chunk->size, chunk->offset);
+    io_uring_sqe_set_data(sqe, chunk);
+  }
+  return false;
+}
+
+void
+tsuba::IOUringStorage::Submit(Chunk* const* chunks, uint64_t num_chunks) {
+  std::lock_guard<std::mutex> lock(submit_mutex_);
+  for (uint64_t i = 0; i < num_chunks; ++i) {
+    Chunk* chunk = chunks[i];
+    int err = 0;
+    io_uring_sqe* sqe = GetSqe(&err);
+    if (sqe == nullptr) {
+      for (; i < num_chunks; ++i) {
+        FailChunk(chunks[i], err);
+      }
+      break;
+    }
+    io_uring_prep_read(
+        sqe, chunk->request->fd, chunk->buf, chunk->size, chunk->offset);
+    io_uring_sqe_set_data(sqe, chunk);
+  }
+  while (QueueResubmits()) {
+    if (int ret = SubmitQueued(); ret < 0) {
+      break;
+    }
+  }
+  if (int ret = SubmitQueued(); ret < 0) {
+    // the entries stay queued; have the reaper retry them
+    KATANA_LOG_ERROR(
+        "submitting io_uring reads: {}",
+        std::error_code(-ret, std::system_category()).message());
+    reaper_pending_ = true;
+  }
+}
+
+void
+tsuba::IOUringStorage::FailChunk(Chunk* chunk, int err) {
+  int expected = 0;
+  chunk->request->first_errno.compare_exchange_strong(expected, err);
+  CompleteChunk(chunk);
+}
+
+void
+tsuba::IOUringStorage::CompleteChunk(Chunk* chunk) {
+  Request* request = chunk->request;
+  delete chunk;
+  if (request->outstanding.fetch_sub(1) != 1) {
+    return;
+  }
+
+  if (close(request->fd) != 0) {
+    KATANA_LOG_DEBUG(
+        "closing {}: {}", request->path, katana::ResultErrno().message());
+  }
+  if (int err = request->first_errno.load(); err != 0) {
+    request->done.set_value(KATANA_ERROR(
+        ErrorCode::LocalStorageError, "reading {}: {}", request->path,
+        std::error_code(err, std::system_category()).message()));
+  } else if (uint64_t eof = request->eof_offset.load();
+             eof != std::numeric_limits<uint64_t>::max()) {
+    request->done.set_value(KATANA_ERROR(
+        ErrorCode::LocalStorageError,
+        "reading {}: unexpected end of file at offset {}", request->path,
+        eof));
+  } else {
+    request->done.set_value(katana::CopyableResultSuccess());
+  }
+  delete request;
+}
+
+void
+tsuba::IOUringStorage::ReapLoop() {
+  for (;;) {
+    if (reaper_pending_.load()) {
+      // Queue resubmissions only if no submitter is in the way; one that is
+      // queues them itself. Never wait on the kernel here since only this
+      // thread drains completions.
+      std::unique_lock<std::mutex> lock(submit_mutex_, std::try_to_lock);
+      if (lock.owns_lock()) {
+        bool left_over = QueueResubmits();
+        int ret = io_uring_submit(&ring_);
+        if (ret < 0 && ret != -EBUSY && ret != -EAGAIN && ret != -EINTR) {
+          KATANA_LOG_ERROR(
+              "resubmitting io_uring reads: {}",
+              std::error_code(-ret, std::system_category()).message());
+        }
+        reaper_pending_ = left_over || io_uring_sq_ready(&ring_) > 0;
+      }
+    }
+
+    io_uring_cqe* cqe = nullptr;
+    int ret = 0;
+    if (reaper_pending_.load()) {
+      // do not block on completions while resubmissions are waiting
+      ret = io_uring_peek_cqe(&ring_, &cqe);
+      if (ret == -EAGAIN) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        continue;
+      }
+    } else {
+      ret = io_uring_wait_cqe(&ring_, &cqe);
+    }
+    if (ret < 0) {
+      if (ret == -EINTR) {
+        continue;
+      }
+      KATANA_LOG_ERROR(
+          "waiting for io_uring completion: {}",
+          std::error_code(-ret, std::system_category()).message());
+      continue;
+    }
+    auto* chunk = static_cast<Chunk*>(io_uring_cqe_get_data(cqe));
+    int res = cqe->res;
+    io_uring_cqe_seen(&ring_, cqe);
+
+    if (chunk == nullptr) {
+      return;
+    }
+
+    if (res < 0) {
+      int expected = 0;
+      chunk->request->first_errno.compare_exchange_strong(expected, -res);
+    } else if (res == 0) {
+      // the file is shorter than the range asked for; like LocalStorage,
+      // report it rather than leave the rest of the buffer unfilled
+      uint64_t expected = std::numeric_limits<uint64_t>::max();
+      chunk->request->eof_offset.compare_exchange_strong(
+          expected, chunk->offset);
+    } else if (static_cast<uint32_t>(res) < chunk->size) {
+      // short read; ask for the rest. Submit could block on a submitter
+      // that waits for this thread to drain completions, so queue it on the
+      // side instead.
+      chunk->buf += res;
+      chunk->offset += res;
+      chunk->size -= res;
+      {
+        std::lock_guard<std::mutex> lock(resubmit_mutex_);
+        resubmits_.emplace_back(chunk);
+      }
+      reaper_pending_ = true;
+      continue;
+    }
+    CompleteChunk(chunk);
+  }
+}
+
+katana::Result<void>
+tsuba::IOUringStorage::GetMultiSync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  if (auto res = GetAsync(uri, start, size, result_buf).get(); !res) {
+    return res.error();
+  }
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+tsuba::IOUringStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  if (!ring_ready_) {
+    return LocalStorage::GetAsync(uri, start, size, result_buf);
+  }
+
+  std::string path = uri;
+  CleanUri(&path);
+
+  if (size == 0) {
+    return std::async(
+        std::launch::deferred, []() -> katana::CopyableResult<void> {
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::error_code ec = katana::ResultErrno();
+    return std::async(
+        std::launch::deferred, [ec, path]() -> katana::CopyableResult<void> {
+          return KATANA_ERROR(
+              ErrorCode::LocalStorageError, "opening {}: {}", path,
+              ec.message());
+        });
+  }
+
+  uint64_t num_chunks = (size + kChunkSize - 1) / kChunkSize;
+
+  auto* request = new Request();
+  request->fd = fd;
+  request->path = std::move(path);
+  request->outstanding = num_chunks;
+  std::future<katana::CopyableResult<void>> ret = request->done.get_future();
+
+  std::vector<Chunk*> chunks;
+  chunks.reserve(num_chunks);
+  for (uint64_t i = 0; i < num_chunks; ++i) {
+    uint64_t offset = i * kChunkSize;
+    uint32_t chunk_size =
+        static_cast<uint32_t>(std::min<uint64_t>(kChunkSize, size - offset));
+    chunks.emplace_back(
+        new Chunk{request, result_buf + offset, start + offset, chunk_size});
+  }
+  // request may be freed by the reaper as soon as its last chunk is
+  // submitted, so do not touch it after this
+  Submit(chunks.data(), chunks.size());
+
+  return ret;
+}
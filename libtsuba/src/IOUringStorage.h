@@ -0,0 +1,95 @@
+#ifndef KATANA_LIBTSUBA_IOURINGSTORAGE_H_
+#define KATANA_LIBTSUBA_IOURINGSTORAGE_H_
+
+#include <liburing.h>
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LocalStorage.h"
+#include "katana/Result.h"
+
+namespace tsuba {
+
+/// Local file system storage that services reads through io_uring. Many reads
+/// can be in flight at once, which is what a multi-device NVMe setup needs to
+/// reach full bandwidth while an RDG loads. Everything other than reads is
+/// inherited from LocalStorage.
+///
+/// If the running kernel does not support io_uring, Init succeeds anyway and
+/// reads fall back to the synchronous LocalStorage path.
+///
+/// The queue depth can be set with KATANA_TSUBA_IO_URING_DEPTH and the
+/// backend can be disabled entirely with KATANA_TSUBA_IO_URING=false.
+class IOUringStorage : public LocalStorage {
+  struct Request;
+  struct Chunk;
+
+  io_uring ring_{};
+  bool ring_ready_{false};
+  /// guards the submission queue
+  std::mutex submit_mutex_;
+  std::thread reaper_;
+
+  /// Chunks whose reads came back short, waiting to be queued again. The
+  /// reaper only ever try-locks submit_mutex_, so that it keeps draining
+  /// completions while a submitter waits for room in the queues; whoever
+  /// holds submit_mutex_ next queues these.
+  std::mutex resubmit_mutex_;
+  std::vector<Chunk*> resubmits_;
+  /// set by the reaper when it left resubmissions or queued entries for
+  /// itself to submit
+  std::atomic<bool> reaper_pending_{false};
+
+  /// Queue reads for \param num_chunks chunks and hand them to the kernel
+  /// with one system call, or more only if the submission queue fills
+  void Submit(Chunk* const* chunks, uint64_t num_chunks);
+  /// Submit the queued entries, waiting while the kernel cannot take them
+  /// yet (-EBUSY, -EAGAIN) for the reaper to drain completions. Call with
+  /// submit_mutex_ held, never from the reaper.
+  ///
+  /// \returns the result of the last io_uring_submit
+  int SubmitQueued();
+  /// \returns a free submission queue entry, submitting queued ones to make
+  /// room, or nullptr if that failed with the errno \param err
+  io_uring_sqe* GetSqe(int* err);
+  /// Queue as many resubmissions as there are free entries without waiting.
+  /// Call with submit_mutex_ held.
+  ///
+  /// \returns true if resubmissions are left over
+  bool QueueResubmits();
+  void ReapLoop();
+  static void CompleteChunk(Chunk* chunk);
+  static void FailChunk(Chunk* chunk, int err);
+
+public:
+  /// Reads are split into pieces of at most this many bytes
+  static constexpr uint32_t kChunkSize = UINT32_C(1) << 20;
+  static constexpr int kDefaultDepth = 256;
+
+  IOUringStorage() = default;
+  ~IOUringStorage() override;
+
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override;
+
+  /// Prefer this over LocalStorage for file:// URIs
+  uint32_t Priority() const override { return 2; }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+};
+
+}  // namespace tsuba
+
+#endif
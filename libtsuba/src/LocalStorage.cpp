@@ -2,6 +2,7 @@
 
 #include <dirent.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -15,7 +16,9 @@
 #include <boost/system/error_code.hpp>
 
 #include "GlobalState.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
+#include "katana/Platform.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
 #include "tsuba/Errors.h"
@@ -31,6 +34,50 @@ tsuba::LocalStorage::CleanUri(std::string* uri) {
   *uri = std::string(uri->begin() + uri_scheme().size(), uri->end());
 }
 
+katana::Result<void>
+tsuba::LocalStorage::Init() {
+  map_enabled_ = true;
+  map_populate_ = false;
+  katana::GetEnv("KATANA_TSUBA_LOCAL_MMAP", &map_enabled_);
+  katana::GetEnv("KATANA_TSUBA_LOCAL_MMAP_POPULATE", &map_populate_);
+  return katana::ResultSuccess();
+}
+
+katana::Result<uint8_t*>
+tsuba::LocalStorage::MapReadOnly(const std::string& uri, uint64_t size) {
+  if (!map_enabled_) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "mapping local files is disabled");
+  }
+  if (size == 0) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "cannot map empty region");
+  }
+  std::string filename = uri;
+  CleanUri(&filename);
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", filename);
+  }
+  void* addr = map_populate_
+                   ? katana::MmapPopulate(
+                         nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)
+                   : mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  std::error_code map_err;
+  if (addr == MAP_FAILED) {
+    map_err = katana::ResultErrno();
+  }
+  // the mapping holds its own reference to the file
+  if (close(fd) != 0) {
+    KATANA_LOG_DEBUG(
+        "closing {}: {}", filename, katana::ResultErrno().message());
+  }
+  if (map_err) {
+    return KATANA_ERROR(map_err, "mapping {}", filename);
+  }
+  return static_cast<uint8_t*>(addr);
+}
+
 katana::Result<void>
 tsuba::LocalStorage::WriteFile(
     std::string uri, const uint8_t* data, uint64_t size) {
@@ -119,6 +166,9 @@ tsuba::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
     return katana::ResultErrno();
   }
   s_buf->size = local_s_buf.st_size;
+  s_buf->mtime_ns =
+      static_cast<uint64_t>(local_s_buf.st_mtim.tv_sec) * 1000000000 +
+      local_s_buf.st_mtim.tv_nsec;
   return katana::ResultSuccess();
 }
 
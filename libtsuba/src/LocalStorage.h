@@ -16,6 +16,10 @@ namespace tsuba {
 /// Store byte arrays to the local file system; Provided as a convenience for
 /// testing only (un-optimized)
 class LocalStorage : public FileStorage {
+  bool map_enabled_{true};
+  bool map_populate_{false};
+
+protected:
   void CleanUri(std::string* uri);
   katana::Result<void> WriteFile(
       std::string, const uint8_t* data, uint64_t size);
@@ -28,12 +32,21 @@ class LocalStorage : public FileStorage {
 public:
   LocalStorage() : FileStorage("file://") {}
 
-  katana::Result<void> Init() override { return katana::ResultSuccess(); }
+  /// Reads KATANA_TSUBA_LOCAL_MMAP (default true) to decide whether
+  /// MapReadOnly hands out file-backed mappings, and
+  /// KATANA_TSUBA_LOCAL_MMAP_POPULATE (default false) to decide whether
+  /// those mappings are prefaulted.
+  katana::Result<void> Init() override;
   katana::Result<void> Fini() override { return katana::ResultSuccess(); }
   katana::Result<void> Stat(const std::string& uri, StatBuf* size) override;
 
   uint32_t Priority() const override { return 1; }
 
+  bool IsLocal() const override { return true; }
+
+  katana::Result<uint8_t*> MapReadOnly(
+      const std::string& uri, uint64_t size) override;
+
   katana::Result<void> GetMultiSync(
       const std::string& uri, uint64_t start, uint64_t size,
       uint8_t* result_buf) override {
@@ -0,0 +1,237 @@
+#include "MemoryPolicy.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/Platform.h"
+#include "tsuba/Errors.h"
+
+namespace {
+
+using HugePages = tsuba::MemoryPolicy::HugePages;
+using NUMA = tsuba::MemoryPolicy::NUMA;
+
+HugePages
+ParseHugePages(const std::string& str) {
+  if (str == "transparent") {
+    return HugePages::kTransparent;
+  }
+  if (str == "2mb") {
+    return HugePages::k2MB;
+  }
+  if (str == "1gb") {
+    return HugePages::k1GB;
+  }
+  if (!str.empty() && str != "none") {
+    KATANA_LOG_WARN("unknown KATANA_TSUBA_HUGE_PAGES value: {}", str);
+  }
+  return HugePages::kNone;
+}
+
+NUMA
+ParseNUMA(const std::string& str) {
+  if (str == "local") {
+    return NUMA::kLocal;
+  }
+  if (str == "interleaved") {
+    return NUMA::kInterleaved;
+  }
+  if (str == "blocked") {
+    return NUMA::kBlocked;
+  }
+  if (!str.empty() && str != "floating") {
+    KATANA_LOG_WARN("unknown KATANA_TSUBA_NUMA value: {}", str);
+  }
+  return NUMA::kFloating;
+}
+
+#if __linux__ && defined(SYS_mbind)
+
+constexpr uint64_t kMaxNodes = 1024;
+constexpr uint64_t kBitsPerWord = 8 * sizeof(unsigned long);
+
+/// Parse a node list like "0-3,5" from sysfs; empty if unavailable
+std::vector<uint64_t>
+OnlineNodes() {
+  std::vector<uint64_t> nodes;
+  std::ifstream in("/sys/devices/system/node/online");
+  std::string list;
+  if (!std::getline(in, list)) {
+    return nodes;
+  }
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t comma = list.find(',', pos);
+    std::string range = list.substr(pos, comma - pos);
+    size_t dash = range.find('-');
+    uint64_t first = std::stoull(range.substr(0, dash));
+    uint64_t last =
+        dash == std::string::npos ? first : std::stoull(range.substr(dash + 1));
+    for (uint64_t n = first; n <= last && n < kMaxNodes; ++n) {
+      nodes.emplace_back(n);
+    }
+    if (comma == std::string::npos) {
+      break;
+    }
+    pos = comma + 1;
+  }
+  return nodes;
+}
+
+void
+Mbind(void* ptr, uint64_t size, int mode, const std::vector<uint64_t>& nodes) {
+  unsigned long mask[kMaxNodes / kBitsPerWord] = {};
+  for (uint64_t n : nodes) {
+    mask[n / kBitsPerWord] |= 1UL << (n % kBitsPerWord);
+  }
+  // the kernel expects one more than the number of bits in mask
+  if (syscall(SYS_mbind, ptr, size, mode, mask, kMaxNodes + 1, 0) != 0) {
+    KATANA_LOG_DEBUG(
+        "setting memory policy: {}", katana::ResultErrno().message());
+  }
+}
+
+void
+ApplyNUMA(void* ptr, uint64_t size, uint64_t page_size, NUMA numa) {
+  if (numa == NUMA::kFloating) {
+    return;
+  }
+  static const std::vector<uint64_t> nodes = OnlineNodes();
+  if (nodes.size() < 2) {
+    return;
+  }
+
+  switch (numa) {
+  case NUMA::kLocal:
+    // MPOL_PREFERRED with no nodes means the node of the faulting thread
+    Mbind(ptr, size, MPOL_PREFERRED, {});
+    break;
+  case NUMA::kInterleaved:
+    Mbind(ptr, size, MPOL_INTERLEAVE, nodes);
+    break;
+  case NUMA::kBlocked: {
+    uint64_t block = (size / nodes.size() + page_size - 1) & ~(page_size - 1);
+    for (uint64_t i = 0; i < nodes.size() && i * block < size; ++i) {
+      uint64_t len = std::min(block, size - i * block);
+      Mbind(
+          static_cast<uint8_t*>(ptr) + i * block, len, MPOL_PREFERRED,
+          {nodes[i]});
+    }
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+#else
+
+void
+ApplyNUMA(
+    [[maybe_unused]] void* ptr, [[maybe_unused]] uint64_t size,
+    [[maybe_unused]] uint64_t page_size, NUMA numa) {
+  if (numa != NUMA::kFloating) {
+    KATANA_WARN_ONCE("NUMA memory policies are not supported on this platform");
+  }
+}
+
+#endif
+
+}  // namespace
+
+const tsuba::MemoryPolicy&
+tsuba::MemoryPolicy::Get() {
+  static const MemoryPolicy policy = []() {
+    MemoryPolicy ret;
+    std::string str;
+    if (katana::GetEnv("KATANA_TSUBA_HUGE_PAGES", &str)) {
+      ret.huge_pages = ParseHugePages(str);
+    }
+    str.clear();
+    if (katana::GetEnv("KATANA_TSUBA_NUMA", &str)) {
+      ret.numa = ParseNUMA(str);
+    }
+    return ret;
+  }();
+  return policy;
+}
+
+katana::Result<void*>
+tsuba::MapAnonymous(
+    uint64_t* size, int prot, bool populate, void* hint,
+    bool allow_explicit_huge_pages) {
+  const MemoryPolicy& policy = MemoryPolicy::Get();
+  int flags = MAP_ANONYMOUS | MAP_PRIVATE;
+
+  if (policy.IsDefault()) {
+    void* ptr = populate
+                    ? katana::MmapPopulate(hint, *size, prot, flags, -1, 0)
+                    : mmap(hint, *size, prot, flags, -1, 0);
+    if (ptr == MAP_FAILED) {
+      return KATANA_ERROR(katana::ResultErrno(), "mapping {} bytes", *size);
+    }
+    return ptr;
+  }
+
+  void* ptr = MAP_FAILED;
+  uint64_t page_size = sysconf(_SC_PAGESIZE);
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  if (allow_explicit_huge_pages && (policy.huge_pages == HugePages::k2MB ||
+                                    policy.huge_pages == HugePages::k1GB)) {
+    int shift = policy.huge_pages == HugePages::k2MB ? 21 : 30;
+    uint64_t huge_size = UINT64_C(1) << shift;
+    uint64_t rounded = (*size + huge_size - 1) & ~(huge_size - 1);
+    ptr = mmap(
+        hint, rounded, prot, flags | MAP_HUGETLB | (shift << MAP_HUGE_SHIFT),
+        -1, 0);
+    if (ptr != MAP_FAILED) {
+      *size = rounded;
+      page_size = huge_size;
+    } else {
+      KATANA_LOG_DEBUG(
+          "mapping {} bytes of {}-bit huge pages, falling back to transparent "
+          "huge pages: {}",
+          rounded, shift, katana::ResultErrno().message());
+    }
+  }
+#endif
+
+  if (ptr == MAP_FAILED) {
+    ptr = mmap(hint, *size, prot, flags, -1, 0);
+    if (ptr == MAP_FAILED) {
+      return KATANA_ERROR(katana::ResultErrno(), "mapping {} bytes", *size);
+    }
+#ifdef MADV_HUGEPAGE
+    if (policy.huge_pages != HugePages::kNone &&
+        madvise(ptr, *size, MADV_HUGEPAGE) != 0) {
+      KATANA_LOG_DEBUG(
+          "requesting transparent huge pages: {}",
+          katana::ResultErrno().message());
+    }
+#endif
+  }
+
+  // The policy only applies to pages faulted in after it is set, so set it
+  // before populating
+  ApplyNUMA(ptr, *size, page_size, policy.numa);
+  if (populate && (prot & PROT_WRITE)) {
+    auto* bytes = static_cast<volatile uint8_t*>(ptr);
+    for (uint64_t off = 0; off < *size; off += page_size) {
+      bytes[off] = 0;
+    }
+  }
+  return ptr;
+}
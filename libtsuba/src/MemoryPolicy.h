@@ -0,0 +1,50 @@
+#ifndef KATANA_LIBTSUBA_MEMORYPOLICY_H_
+#define KATANA_LIBTSUBA_MEMORYPOLICY_H_
+
+#include <cstdint>
+
+#include "katana/Result.h"
+
+namespace tsuba {
+
+/// How the anonymous memory behind FileFrame and FileView is backed.
+///
+/// The policy is read once from the environment:
+///
+/// - KATANA_TSUBA_HUGE_PAGES is one of "none" (the default), "transparent"
+///   (ask for transparent huge pages with madvise), "2mb" or "1gb" (map
+///   explicit huge pages, falling back to transparent huge pages if none are
+///   reserved).
+/// - KATANA_TSUBA_NUMA is one of "floating" (the default; pages go wherever
+///   they are first touched), "local" (the node of the mapping thread),
+///   "interleaved" (round robin across nodes) or "blocked" (one contiguous
+///   block per node), named after NUMAArray::AllocType.
+struct MemoryPolicy {
+  enum class HugePages { kNone, kTransparent, k2MB, k1GB };
+  enum class NUMA { kFloating, kLocal, kInterleaved, kBlocked };
+
+  HugePages huge_pages{HugePages::kNone};
+  NUMA numa{NUMA::kFloating};
+
+  bool IsDefault() const {
+    return huge_pages == HugePages::kNone && numa == NUMA::kFloating;
+  }
+
+  static const MemoryPolicy& Get();
+};
+
+/// Map \param size bytes of anonymous memory according to MemoryPolicy::Get,
+/// near \param hint if possible. \param size is rounded up to the page size
+/// actually used; unmap the region with that size. If \param populate, the
+/// pages are faulted in before returning.
+///
+/// Explicit huge pages cannot be partially mprotected, so callers that need
+/// that pass \param allow_explicit_huge_pages = false and get transparent huge
+/// pages instead.
+katana::Result<void*> MapAnonymous(
+    uint64_t* size, int prot, bool populate, void* hint = nullptr,
+    bool allow_explicit_huge_pages = true);
+
+}  // namespace tsuba
+
+#endif
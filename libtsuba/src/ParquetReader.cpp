@@ -1,16 +1,24 @@
 #include "tsuba/ParquetReader.h"
 
 #include <limits>
+#include <map>
 #include <memory>
+#include <optional>
+#include <string>
 #include <unordered_map>
 
+#include <arrow/array/array_dict.h>
 #include <arrow/array/util.h>
 #include <arrow/chunked_array.h>
 #include <arrow/type.h>
 #include <arrow/type_fwd.h>
+#include <parquet/arrow/reader.h>
 #include <parquet/arrow/schema.h>
+#include <parquet/metadata.h>
+#include <parquet/statistics.h>
 
 #include "katana/JSON.h"
+#include "katana/PropertyMemoryPool.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
 
@@ -23,7 +31,7 @@ namespace {
 
 Result<std::shared_ptr<arrow::ChunkedArray>>
 ChunkedStringToLargeString(const std::shared_ptr<arrow::ChunkedArray>& arr) {
-  arrow::LargeStringBuilder builder;
+  arrow::LargeStringBuilder builder(katana::PropertyMemoryPool());
 
   for (const auto& chunk : arr->chunks()) {
     std::shared_ptr<arrow::StringArray> string_array =
@@ -60,6 +68,39 @@ ChunkedStringToLargeString(const std::shared_ptr<arrow::ChunkedArray>& arr) {
   return maybe_res.ValueOrDie();
 }
 
+/// Dictionary-encoded columns are kept encoded, so categorical properties
+/// take a small code per row. The chunks of a column are given one
+/// dictionary so that they can be combined, and String dictionaries become
+/// LargeString ones like String columns.
+Result<std::shared_ptr<arrow::ChunkedArray>>
+UnifyDictionaries(const std::shared_ptr<arrow::ChunkedArray>& arr) {
+  std::shared_ptr<arrow::ChunkedArray> unified = arr;
+  if (arr->num_chunks() > 1) {
+    unified = KATANA_CHECKED(arrow::DictionaryUnifier::UnifyChunkedArray(
+        arr, katana::PropertyMemoryPool()));
+  }
+  const auto& type = static_cast<const arrow::DictionaryType&>(*arr->type());
+  if (type.value_type()->id() != arrow::Type::type::STRING ||
+      unified->num_chunks() == 0) {
+    return unified;
+  }
+
+  // chunks share the dictionary after unification
+  const auto& first =
+      static_cast<const arrow::DictionaryArray&>(*unified->chunk(0));
+  auto dictionary = KATANA_CHECKED(ChunkedStringToLargeString(
+      std::make_shared<arrow::ChunkedArray>(first.dictionary())));
+  auto new_type =
+      arrow::dictionary(type.index_type(), arrow::large_utf8(), type.ordered());
+  std::vector<std::shared_ptr<arrow::Array>> new_chunks;
+  for (const auto& chunk : unified->chunks()) {
+    const auto& dict_array = static_cast<const arrow::DictionaryArray&>(*chunk);
+    new_chunks.emplace_back(KATANA_CHECKED(arrow::DictionaryArray::FromArrays(
+        new_type, dict_array.indices(), dictionary->chunk(0))));
+  }
+  return KATANA_CHECKED(arrow::ChunkedArray::Make(new_chunks, new_type));
+}
+
 // HandleBadParquetTypes here and HandleBadParquetTypes in ParquetWriter.cpp
 // workaround a libarrow2.0 limitation in reading and writing LargeStrings to
 // parquet files.
@@ -69,6 +110,9 @@ HandleBadParquetTypes(std::shared_ptr<arrow::ChunkedArray> old_array) {
   case arrow::Type::type::STRING: {
     return ChunkedStringToLargeString(old_array);
   }
+  case arrow::Type::type::DICTIONARY: {
+    return UnifyDictionaries(old_array);
+  }
   default:
     return old_array;
   }
@@ -81,33 +125,236 @@ HandleBadParquetTypes(std::shared_ptr<arrow::Field> old_field) {
     return std::make_shared<arrow::Field>(
         old_field->name(), arrow::large_utf8());
   }
+  case arrow::Type::type::DICTIONARY: {
+    const auto& type =
+        static_cast<const arrow::DictionaryType&>(*old_field->type());
+    if (type.value_type()->id() != arrow::Type::type::STRING) {
+      return old_field;
+    }
+    return std::make_shared<arrow::Field>(
+        old_field->name(),
+        arrow::dictionary(
+            type.index_type(), arrow::large_utf8(), type.ordered()));
+  }
   default:
     return old_field;
   }
 }
 
+using Checksums = std::shared_ptr<const std::map<std::string, uint32_t>>;
+
+/// \returns the recorded CRC32C of the file at \param uri, if any
+std::optional<uint32_t>
+ChecksumOf(const Checksums& checksums, const std::string& uri) {
+  if (!checksums) {
+    return std::nullopt;
+  }
+  auto it = checksums->find(uri.substr(uri.find_last_of('/') + 1));
+  if (it == checksums->end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+/// If \param preload and the file has a checksum, the whole file is read and
+/// checked before parsing starts so that a mismatch is reported as such
+/// rather than as whatever parse error the corruption causes
 Result<std::unique_ptr<parquet::arrow::FileReader>>
 BuildReader(
-    const std::string& uri, bool preload,
-    std::shared_ptr<tsuba::FileView>* fv) {
+    const std::string& uri, bool preload, bool use_threads,
+    std::shared_ptr<tsuba::FileView>* fv, const Checksums& checksums = {}) {
   auto fv_tmp = std::make_shared<tsuba::FileView>();
+  std::optional<uint32_t> crc32c;
+  if (preload) {
+    crc32c = ChecksumOf(checksums, uri);
+  }
   KATANA_CHECKED_CONTEXT(
       fv_tmp->Bind(
-          uri, 0, preload ? std::numeric_limits<uint64_t>::max() : 0, false),
+          uri, 0, preload ? std::numeric_limits<uint64_t>::max() : 0,
+          crc32c.has_value(), crc32c),
       "opening {}", uri);
   *fv = fv_tmp;
 
   std::unique_ptr<parquet::arrow::FileReader> reader;
   KATANA_CHECKED(
-      parquet::arrow::OpenFile(fv_tmp, arrow::default_memory_pool(), &reader));
+      parquet::arrow::OpenFile(fv_tmp, katana::PropertyMemoryPool(), &reader));
+  reader->set_use_threads(use_threads);
 
   return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
 }
 
+/// Compare two scalars, returning <0, 0 or >0, or nullopt if they cannot be
+/// compared. Numbers are compared as doubles; rounding is monotonic so this
+/// never turns "may match" into "cannot match".
+std::optional<int>
+CompareScalars(const arrow::Scalar& a, const arrow::Scalar& b) {
+  if (!a.is_valid || !b.is_valid) {
+    return std::nullopt;
+  }
+  arrow::Type::type a_id = a.type->id();
+  arrow::Type::type b_id = b.type->id();
+  if (arrow::is_base_binary_like(a_id) && arrow::is_base_binary_like(b_id)) {
+    const auto& a_val = static_cast<const arrow::BaseBinaryScalar&>(a).value;
+    const auto& b_val = static_cast<const arrow::BaseBinaryScalar&>(b).value;
+    int cmp = a_val->ToString().compare(b_val->ToString());
+    return (cmp > 0) - (cmp < 0);
+  }
+  auto is_number = [](arrow::Type::type id) {
+    return arrow::is_integer(id) || arrow::is_floating(id);
+  };
+  if (!is_number(a_id) || !is_number(b_id)) {
+    return std::nullopt;
+  }
+  auto a_cast = a.CastTo(arrow::float64());
+  auto b_cast = b.CastTo(arrow::float64());
+  if (!a_cast.ok() || !b_cast.ok()) {
+    return std::nullopt;
+  }
+  double a_dbl =
+      std::static_pointer_cast<arrow::DoubleScalar>(a_cast.ValueOrDie())->value;
+  double b_dbl =
+      std::static_pointer_cast<arrow::DoubleScalar>(b_cast.ValueOrDie())->value;
+  return (a_dbl > b_dbl) - (a_dbl < b_dbl);
+}
+
+/// Return false only if statistics prove that no row in the row group can
+/// satisfy pred
+bool
+RowGroupMayMatch(
+    const parquet::RowGroupMetaData& rg_md, int col,
+    const tsuba::PropertyPredicate& pred) {
+  using Kind = tsuba::PropertyPredicate::Kind;
+
+  std::unique_ptr<parquet::ColumnChunkMetaData> col_md =
+      rg_md.ColumnChunk(col);
+  if (!col_md->is_stats_set()) {
+    return true;
+  }
+  std::shared_ptr<parquet::Statistics> stats = col_md->statistics();
+  if (!stats) {
+    return true;
+  }
+
+  // none of the predicates match null values
+  if (stats->HasNullCount() && stats->null_count() >= rg_md.num_rows()) {
+    return false;
+  }
+  if (pred.kind == Kind::kIsNotNull || !stats->HasMinMax()) {
+    return true;
+  }
+
+  std::shared_ptr<arrow::Scalar> min;
+  std::shared_ptr<arrow::Scalar> max;
+  if (!parquet::arrow::StatisticsAsScalars(*stats, &min, &max).ok()) {
+    return true;
+  }
+
+  auto less = [](const std::shared_ptr<arrow::Scalar>& a,
+                 const std::shared_ptr<arrow::Scalar>& b) {
+    std::optional<int> cmp = CompareScalars(*a, *b);
+    return cmp && *cmp < 0;
+  };
+
+  switch (pred.kind) {
+  case Kind::kEqual:
+    return !pred.lower || !(less(pred.lower, min) || less(max, pred.lower));
+  case Kind::kRange:
+    if (pred.lower && less(max, pred.lower)) {
+      return false;
+    }
+    if (pred.upper && less(pred.upper, min)) {
+      return false;
+    }
+    return true;
+  default:
+    return true;
+  }
+}
+
+/// Read row_groups, substituting nulls for row groups that cannot satisfy
+/// predicates on columns of this file; kept row groups are read unfiltered
+Result<std::shared_ptr<arrow::Table>>
+ReadRowGroupsPruned(
+    parquet::arrow::FileReader* reader, const std::vector<int>& row_groups,
+    const tsuba::PropertyPredicates& predicates) {
+  std::shared_ptr<parquet::FileMetaData> md =
+      reader->parquet_reader()->metadata();
+
+  std::vector<std::pair<int, const tsuba::PropertyPredicate*>> applicable;
+  for (const auto& pred : predicates) {
+    if (int col = md->schema()->ColumnIndex(pred.property); col >= 0) {
+      applicable.emplace_back(col, &pred);
+    }
+  }
+
+  std::vector<bool> keep(row_groups.size(), true);
+  bool any_pruned = false;
+  for (size_t i = 0; i < row_groups.size(); ++i) {
+    std::unique_ptr<parquet::RowGroupMetaData> rg_md =
+        md->RowGroup(row_groups[i]);
+    for (const auto& [col, pred] : applicable) {
+      if (!RowGroupMayMatch(*rg_md, col, *pred)) {
+        keep[i] = false;
+        any_pruned = true;
+        break;
+      }
+    }
+  }
+
+  std::shared_ptr<arrow::Table> out;
+  if (!any_pruned) {
+    KATANA_CHECKED(reader->ReadRowGroups(row_groups, &out));
+    return out;
+  }
+
+  std::shared_ptr<arrow::Schema> schema;
+  KATANA_CHECKED(reader->GetSchema(&schema));
+
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  for (size_t i = 0; i < row_groups.size();) {
+    // read maximal runs of kept row groups together
+    size_t run_end = i;
+    while (run_end < row_groups.size() && keep[run_end] == keep[i]) {
+      ++run_end;
+    }
+    std::vector<int> run(
+        row_groups.begin() + i, row_groups.begin() + run_end);
+    if (keep[i]) {
+      std::shared_ptr<arrow::Table> table;
+      KATANA_CHECKED(reader->ReadRowGroups(run, &table));
+      tables.emplace_back(std::move(table));
+    } else {
+      int64_t num_rows = 0;
+      for (int rg : run) {
+        num_rows += md->RowGroup(rg)->num_rows();
+      }
+      std::vector<std::shared_ptr<arrow::ChunkedArray>> cols;
+      for (const auto& field : schema->fields()) {
+        cols.emplace_back(std::make_shared<arrow::ChunkedArray>(
+            KATANA_CHECKED(arrow::MakeArrayOfNull(field->type(), num_rows))));
+      }
+      tables.emplace_back(arrow::Table::Make(schema, cols, num_rows));
+    }
+    i = run_end;
+  }
+  return KATANA_CHECKED(arrow::ConcatenateTables(tables));
+}
+
+Result<std::shared_ptr<arrow::Table>>
+ReadAllRowGroupsPruned(
+    parquet::arrow::FileReader* reader,
+    const tsuba::PropertyPredicates& predicates) {
+  std::vector<int> row_groups(reader->num_row_groups());
+  for (int i = 0, size = row_groups.size(); i < size; ++i) {
+    row_groups[i] = i;
+  }
+  return ReadRowGroupsPruned(reader, row_groups, predicates);
+}
+
 Result<std::shared_ptr<arrow::Table>>
 ReadTableSlice(
     parquet::arrow::FileReader* reader, tsuba::FileView* fv, int64_t first_row,
-    int64_t last_row) {
+    int64_t last_row, const tsuba::PropertyPredicates& predicates) {
   std::vector<int> row_groups;
   int rg_count = reader->num_row_groups();
   int64_t row_offset = 0;
@@ -130,12 +377,15 @@ ReadTableSlice(
     cumulative_bytes += new_bytes;
   }
 
-  if (auto res = fv->Fill(file_offset, cumulative_bytes, false); !res) {
-    return res.error();
+  // With predicates, let reads fault in only the row groups that survive
+  if (predicates.empty()) {
+    if (auto res = fv->Fill(file_offset, cumulative_bytes, false); !res) {
+      return res.error();
+    }
   }
 
-  std::shared_ptr<arrow::Table> out;
-  KATANA_CHECKED(reader->ReadRowGroups(row_groups, &out));
+  std::shared_ptr<arrow::Table> out =
+      KATANA_CHECKED(ReadRowGroupsPruned(reader, row_groups, predicates));
   return out->Slice(row_offset, last_row - first_row);
 }
 
@@ -151,7 +401,8 @@ public:
   /// In both cases care is taken to read as few row groups and
   /// files as possible when accessing only metadata when preload
   /// is false. Setting preload to true will provide better performance
-  /// when you know you're going to read everything.
+  /// when you know you're going to read everything. Setting use_threads to
+  /// true lets arrow decode columns and row groups in parallel.
   ///
   /// For 2) the json file contains a list of integers denoting table row
   /// offsets, indexes of this array inform the file names. For example
@@ -159,10 +410,15 @@ public:
   /// "[0, 10]" corresponds to a single logical table who's rows 0-9 are in
   /// "s3://example_file/table.parquet.part_000000000" and rows 10-end are
   /// in "s3://example_file/table.parquet.part_000000001"
+  ///
+  /// Files read completely are checked against \param checksums if they are
+  /// named there.
   static Result<std::unique_ptr<BlockedParquetReader>> Make(
-      const katana::Uri& uri, bool preload) {
+      const katana::Uri& uri, bool preload, bool use_threads = false,
+      tsuba::PropertyPredicates predicates = {}, Checksums checksums = {}) {
     std::shared_ptr<tsuba::FileView> fv;
-    auto builder_res = BuildReader(uri.string(), preload, &fv);
+    auto builder_res =
+        BuildReader(uri.string(), preload, use_threads, &fv, checksums);
 
     if (builder_res) {
       std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers;
@@ -171,7 +427,8 @@ public:
       fvs.emplace_back(std::move(fv));
 
       return std::unique_ptr<BlockedParquetReader>(new BlockedParquetReader(
-          uri.string(), std::move(fvs), std::move(readers), {0}));
+          uri.string(), std::move(fvs), std::move(readers), {0}, use_threads,
+          std::move(predicates), std::move(checksums)));
     }
 
     if (builder_res.error() != katana::ErrorCode::InvalidArgument) {
@@ -199,7 +456,8 @@ public:
 
     std::unique_ptr<BlockedParquetReader> bpr(new BlockedParquetReader(
         uri.string(), std::move(fvs), std::move(readers),
-        std::move(row_offsets)));
+        std::move(row_offsets), use_threads, std::move(predicates),
+        std::move(checksums)));
 
     if (preload) {
       for (size_t i = 0, num_files = bpr->row_offsets_.size(); i < num_files;
@@ -235,9 +493,14 @@ public:
     if (!slice) {
       std::vector<std::shared_ptr<arrow::Table>> tables;
       for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
-        KATANA_CHECKED(EnsureReader(i, true));
+        KATANA_CHECKED(EnsureReader(i, predicates_.empty()));
         std::shared_ptr<arrow::Table> table;
-        KATANA_CHECKED(readers_[i]->ReadTable(&table));
+        if (predicates_.empty()) {
+          KATANA_CHECKED(readers_[i]->ReadTable(&table));
+        } else {
+          table = KATANA_CHECKED(
+              ReadAllRowGroupsPruned(readers_[i].get(), predicates_));
+        }
         tables.emplace_back(std::move(table));
       }
       return KATANA_CHECKED(arrow::ConcatenateTables(tables));
@@ -270,8 +533,13 @@ public:
       std::shared_ptr<arrow::Table> table;
       if (curr_global_row == table_offset &&
           last_global_row >= next_table_offset) {
-        KATANA_CHECKED(EnsureReader(idx, true));
-        KATANA_CHECKED(readers_[idx]->ReadTable(&table));
+        KATANA_CHECKED(EnsureReader(idx, predicates_.empty()));
+        if (predicates_.empty()) {
+          KATANA_CHECKED(readers_[idx]->ReadTable(&table));
+        } else {
+          table = KATANA_CHECKED(
+              ReadAllRowGroupsPruned(readers_[idx].get(), predicates_));
+        }
       } else {
         KATANA_CHECKED(EnsureReader(idx, false));
         table = KATANA_CHECKED(ReadTableSlice(
@@ -279,7 +547,8 @@ public:
             curr_global_row - table_offset,
             std::min(
                 next_table_offset - table_offset,
-                last_global_row - table_offset)));
+                last_global_row - table_offset),
+            predicates_));
       }
       tables.emplace_back(std::move(table));
       curr_global_row = next_table_offset;
@@ -351,11 +620,15 @@ private:
   BlockedParquetReader(
       std::string prefix, std::vector<std::shared_ptr<tsuba::FileView>>&& fvs,
       std::vector<std::unique_ptr<parquet::arrow::FileReader>>&& readers,
-      std::vector<int64_t>&& row_offsets)
+      std::vector<int64_t>&& row_offsets, bool use_threads,
+      tsuba::PropertyPredicates&& predicates, Checksums&& checksums)
       : prefix_(std::move(prefix)),
         fvs_(std::move(fvs)),
         readers_(std::move(readers)),
-        row_offsets_(std::move(row_offsets)) {}
+        row_offsets_(std::move(row_offsets)),
+        use_threads_(use_threads),
+        predicates_(std::move(predicates)),
+        checksums_(std::move(checksums)) {}
 
   Result<void> EnsureReader(size_t idx, bool preload = false) {
     if (readers_[idx]) {
@@ -363,7 +636,8 @@ private:
       return katana::ResultSuccess();
     }
     readers_[idx] = KATANA_CHECKED(BuildReader(
-        fmt::format("{}.part_{:09}", prefix_, idx), preload, &fvs_[idx]));
+        fmt::format("{}.part_{:09}", prefix_, idx), preload, use_threads_,
+        &fvs_[idx], checksums_));
 
     return katana::ResultSuccess();
   }
@@ -372,6 +646,9 @@ private:
   std::vector<std::shared_ptr<tsuba::FileView>> fvs_;
   std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers_;
   std::vector<int64_t> row_offsets_;
+  bool use_threads_;
+  tsuba::PropertyPredicates predicates_;
+  Checksums checksums_;
 };
 
 }  // namespace
@@ -379,7 +656,9 @@ private:
 Result<std::unique_ptr<tsuba::ParquetReader>>
 tsuba::ParquetReader::Make(ReadOpts opts) {
   return std::unique_ptr<ParquetReader>(
-      new ParquetReader(opts.slice, opts.make_cannonical));
+      new ParquetReader(
+          opts.slice, opts.make_cannonical, opts.use_threads,
+          std::move(opts.predicates), std::move(opts.checksums)));
 }
 
 Result<std::shared_ptr<arrow::Table>>
@@ -393,8 +672,13 @@ tsuba::ParquetReader::ReadTable(const katana::Uri& uri) {
     }
     preload = false;
   }
+  if (!predicates_.empty()) {
+    // only fetch the row groups that survive pruning
+    preload = false;
+  }
 
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, preload));
+  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(
+      uri, preload, use_threads_, predicates_, checksums_));
   return FixTable(KATANA_CHECKED(bpr->ReadTable(slice_)));
 }
 
@@ -406,14 +690,16 @@ tsuba::ParquetReader::GetSchema(const katana::Uri& uri) {
 
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadColumn(const katana::Uri& uri, int32_t column_idx) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
   return FixTable(KATANA_CHECKED(bpr->ReadTable({column_idx})));
 }
 
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadTable(
     const katana::Uri& uri, const std::vector<int32_t>& column_indexes) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
   return FixTable(KATANA_CHECKED(bpr->ReadTable(column_indexes)));
 }
 
@@ -481,7 +767,7 @@ tsuba::ParquetReader::FixTable(std::shared_ptr<arrow::Table>&& _table) {
   // combined into a single chunk due to the fact the offset type for these
   // columns is int32_t and thus the maximum size of an arrow::Array for these
   // types is 2^31.
-  auto combine_result = table->CombineChunks(arrow::default_memory_pool());
+  auto combine_result = table->CombineChunks(katana::PropertyMemoryPool());
   if (!combine_result.ok()) {
     return KATANA_ERROR(
         ErrorCode::ArrowError, "arrow error: {}", combine_result.status());
@@ -1,5 +1,8 @@
 #include "tsuba/ParquetWriter.h"
 
+#include <algorithm>
+
+#include "Checksum.h"
 #include "katana/ArrowInterchange.h"
 #include "katana/JSON.h"
 #include "katana/Result.h"
@@ -65,12 +68,52 @@ LargeStringToChunkedString(
   return chunks;
 }
 
+/// Dictionary-encoded columns are stored encoded, but their LargeString
+/// dictionaries are stored as Strings like LargeString columns
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+LargeStringDictionaryToString(
+    const std::shared_ptr<arrow::ChunkedArray>& old_array) {
+  const auto& type =
+      static_cast<const arrow::DictionaryType&>(*old_array->type());
+  if (type.value_type()->id() != arrow::Type::type::LARGE_STRING) {
+    return old_array;
+  }
+  auto new_type =
+      arrow::dictionary(type.index_type(), arrow::utf8(), type.ordered());
+
+  std::vector<std::shared_ptr<arrow::Array>> new_chunks;
+  for (const auto& chunk : old_array->chunks()) {
+    const auto& dict_array = static_cast<const arrow::DictionaryArray&>(*chunk);
+    auto values = KATANA_CHECKED(LargeStringToChunkedString(
+        std::static_pointer_cast<arrow::LargeStringArray>(
+            dict_array.dictionary())));
+    if (values.size() > 1) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::InvalidArgument,
+          "dictionary of {} values is too large to store",
+          dict_array.dictionary()->length());
+    }
+    std::shared_ptr<arrow::Array> dictionary;
+    if (values.empty()) {
+      dictionary = KATANA_CHECKED(arrow::MakeArrayOfNull(arrow::utf8(), 0));
+    } else {
+      dictionary = values[0];
+    }
+    new_chunks.emplace_back(KATANA_CHECKED(arrow::DictionaryArray::FromArrays(
+        new_type, dict_array.indices(), dictionary)));
+  }
+  return KATANA_CHECKED(arrow::ChunkedArray::Make(new_chunks, new_type));
+}
+
 // HandleBadParquetTypes here and HandleBadParquetTypes in ParquetReader.cpp
 // workaround a libarrow2.0 limitation in reading and writing LargeStrings to
 // parquet files.
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 HandleBadParquetTypes(std::shared_ptr<arrow::ChunkedArray> old_array) {
   switch (old_array->type()->id()) {
+  case arrow::Type::type::DICTIONARY: {
+    return LargeStringDictionaryToString(old_array);
+  }
   case arrow::Type::type::LARGE_STRING: {
     std::vector<std::shared_ptr<arrow::Array>> new_chunks;
     for (const auto& chunk : old_array->chunks()) {
@@ -160,8 +203,24 @@ BlockTable(std::shared_ptr<arrow::Table> table, uint64_t mbs_per_block) {
   return blocks;
 }
 
-Result<void>
-DoStoreParquet(
+std::shared_ptr<parquet::WriterProperties>
+MakeWriterProperties(const tsuba::ParquetWriter::WriteOpts& opts) {
+  return parquet::WriterProperties::Builder()
+      .version(opts.parquet_version)
+      ->data_page_version(opts.data_page_version)
+      ->build();
+}
+
+std::shared_ptr<parquet::ArrowWriterProperties>
+MakeArrowProperties() {
+  // the arrow schema is stored so that dictionary-encoded columns are read
+  // back encoded rather than decoded
+  return parquet::ArrowWriterProperties::Builder().store_schema()->build();
+}
+
+/// Start encoding table into a new FileFrame and storing it at path
+Result<std::future<katana::CopyableResult<void>>>
+StartStoreParquet(
     const std::string& path, std::shared_ptr<arrow::Table> table,
     const std::shared_ptr<parquet::WriterProperties>& writer_props,
     const std::shared_ptr<parquet::ArrowWriterProperties>& arrow_props,
@@ -170,7 +229,7 @@ DoStoreParquet(
   KATANA_CHECKED(ff->Init());
   ff->Bind(path);
 
-  auto future = std::async(
+  return std::async(
       std::launch::async,
       [table = std::move(table), ff = std::move(ff), desc, writer_props,
        arrow_props]() mutable -> katana::CopyableResult<void> {
@@ -189,11 +248,28 @@ DoStoreParquet(
         }
 
         TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
-        if (auto res = ff->Persist(); !res) {
-          return res.error();
+        if (!desc || !desc->checksums_enabled()) {
+          if (auto res = ff->Persist(); !res) {
+            return res.error();
+          }
+          return katana::CopyableResultSuccess();
         }
-        return katana::CopyableResultSuccess();
+        auto persist = ff->PersistAsync();
+        desc->RecordChecksum(
+            ff->path(),
+            tsuba::Crc32c(KATANA_CHECKED(ff->ptr<uint8_t>()), ff->size()));
+        return persist.get();
       });
+}
+
+Result<void>
+DoStoreParquet(
+    const std::string& path, std::shared_ptr<arrow::Table> table,
+    const std::shared_ptr<parquet::WriterProperties>& writer_props,
+    const std::shared_ptr<parquet::ArrowWriterProperties>& arrow_props,
+    tsuba::WriteGroup* desc) {
+  auto future = KATANA_CHECKED(StartStoreParquet(
+      path, std::move(table), writer_props, arrow_props, desc));
 
   if (!desc) {
     auto res = future.get();
@@ -207,6 +283,20 @@ DoStoreParquet(
   return katana::ResultSuccess();
 }
 
+/// Store the row offsets of the parts of a table stored at path, checksummed
+/// like the parts if desc checksums them
+Result<void>
+StoreIndex(
+    const std::string& path, const std::vector<int64_t>& part_offsets,
+    tsuba::WriteGroup* desc) {
+  std::string index = KATANA_CHECKED(katana::JsonDump(part_offsets));
+  KATANA_CHECKED(tsuba::FileStore(path, index));
+  if (desc && desc->checksums_enabled()) {
+    desc->RecordChecksum(path, tsuba::Crc32c(index.data(), index.size()));
+  }
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 Result<std::unique_ptr<tsuba::ParquetWriter>>
@@ -242,15 +332,12 @@ tsuba::ParquetWriter::WriteToUri(const katana::Uri& uri, WriteGroup* group) {
 
 std::shared_ptr<parquet::WriterProperties>
 tsuba::ParquetWriter::StandardWriterProperties() {
-  return parquet::WriterProperties::Builder()
-      .version(opts_.parquet_version)
-      ->data_page_version(opts_.data_page_version)
-      ->build();
+  return MakeWriterProperties(opts_);
 }
 
 std::shared_ptr<parquet::ArrowWriterProperties>
 tsuba::ParquetWriter::StandardArrowProperties() {
-  return parquet::ArrowWriterProperties::Builder().build();
+  return MakeArrowProperties();
 }
 
 /// Store the arrow table in a file
@@ -258,6 +345,19 @@ katana::Result<void>
 tsuba::ParquetWriter::StoreParquet(
     std::shared_ptr<arrow::Table> table, const katana::Uri& uri,
     tsuba::WriteGroup* desc) {
+  if (opts_.stream && table->num_rows() > 1 &&
+      (table->num_rows() > kMaxRowsPerFile ||
+       EstimateRowSize(table) * table->num_rows() >
+           opts_.mbs_per_block * kMB)) {
+    // Encoding a large table as one file would hold the whole encoded file in
+    // memory before storing it, so store it in parts instead
+    auto writer = KATANA_CHECKED(
+        ParquetStreamWriter::Make(uri, table->schema(), opts_, desc));
+    KATANA_CHECKED(writer->Append(table));
+    table.reset();
+    return writer->Finish();
+  }
+
   auto writer_props = StandardWriterProperties();
   auto arrow_props = StandardArrowProperties();
   std::string prefix = uri.string();
@@ -288,8 +388,151 @@ tsuba::ParquetWriter::StoreParquet(
         fmt::format("{}.part_{:09}", prefix, table_count++), t, writer_props,
         arrow_props, desc));
   }
-  return FileStore(
-      uri.string(), KATANA_CHECKED(katana::JsonDump(table_offsets)));
+  return StoreIndex(uri.string(), table_offsets, desc);
+}
+
+tsuba::ParquetStreamWriter::ParquetStreamWriter(
+    katana::Uri uri, std::shared_ptr<arrow::Schema> schema,
+    ParquetWriter::WriteOpts opts, WriteGroup* group)
+    : uri_(std::move(uri)),
+      schema_(std::move(schema)),
+      opts_(opts),
+      group_(group),
+      writer_props_(MakeWriterProperties(opts_)),
+      arrow_props_(MakeArrowProperties()) {
+  // one part is being gathered while the others are stored
+  uint64_t mbs_per_block = std::max<uint64_t>(opts_.mbs_per_block, 1);
+  max_pending_parts_ =
+      std::max<uint64_t>(opts_.max_stream_mbs / mbs_per_block, 2) - 1;
+}
+
+Result<std::unique_ptr<tsuba::ParquetStreamWriter>>
+tsuba::ParquetStreamWriter::Make(
+    const katana::Uri& uri, std::shared_ptr<arrow::Schema> schema,
+    ParquetWriter::WriteOpts opts, WriteGroup* group) {
+  if (!schema) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "schema is required");
+  }
+  return std::unique_ptr<ParquetStreamWriter>(
+      new ParquetStreamWriter(uri, std::move(schema), opts, group));
+}
+
+katana::Result<void>
+tsuba::ParquetStreamWriter::Append(const std::shared_ptr<arrow::Table>& rows) {
+  if (finished_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "writer is finished");
+  }
+  if (!rows->schema()->Equals(*schema_)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "schema {} does not match {}",
+        rows->schema()->ToString(), schema_->ToString());
+  }
+  if (rows->num_rows() == 0) {
+    return katana::ResultSuccess();
+  }
+
+  if (rows_per_part_ == 0) {
+    // Slicing like this is necessary because of a problem with arrow<>parquet
+    // and nulls for string columns. If entries in a column are all or mostly
+    // null and greater than the element limit for a String array, you can end
+    // up in a situation where you've generated a parquet file that arrow
+    // cannot read. To make sure we don't end up in that situation, keep parts
+    // definitely smaller than the element limit.
+    uint64_t row_size = std::max<uint64_t>(EstimateRowSize(rows), 1);
+    rows_per_part_ = std::clamp<int64_t>(
+        opts_.mbs_per_block * kMB / row_size, 1, kMaxRowsPerFile);
+  }
+
+  buffered_.emplace_back(rows);
+  num_buffered_rows_ += rows->num_rows();
+  while (num_buffered_rows_ >= rows_per_part_) {
+    KATANA_CHECKED(StartPart(KATANA_CHECKED(TakeBuffered(rows_per_part_))));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+tsuba::ParquetStreamWriter::TakeBuffered(int64_t num_rows) {
+  std::shared_ptr<arrow::Table> all;
+  if (buffered_.empty()) {
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (const auto& field : schema_->fields()) {
+      columns.emplace_back(std::make_shared<arrow::ChunkedArray>(
+          arrow::ArrayVector{}, field->type()));
+    }
+    all = arrow::Table::Make(schema_, columns, 0);
+  } else if (buffered_.size() == 1) {
+    all = buffered_[0];
+  } else {
+    // zero-copy; the result refers to the chunks of each buffered table
+    all = KATANA_CHECKED(arrow::ConcatenateTables(buffered_));
+  }
+
+  buffered_.clear();
+  if (num_rows < all->num_rows()) {
+    buffered_.emplace_back(all->Slice(num_rows));
+    all = all->Slice(0, num_rows);
+  }
+  num_buffered_rows_ -= all->num_rows();
+  return all;
+}
+
+katana::Result<void>
+tsuba::ParquetStreamWriter::WaitForPart() {
+  PendingPart part = std::move(pending_.front());
+  pending_.pop_front();
+  if (auto res = part.result.get(); !res) {
+    return res.error().WithContext("storing {}", part.path);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::ParquetStreamWriter::StartPart(std::shared_ptr<arrow::Table> part) {
+  while (pending_.size() >= max_pending_parts_) {
+    KATANA_CHECKED(WaitForPart());
+  }
+
+  std::string path =
+      fmt::format("{}.part_{:09}", uri_.string(), part_offsets_.size());
+  part_offsets_.emplace_back(num_rows_started_);
+  num_rows_started_ += part->num_rows();
+  auto future = KATANA_CHECKED(StartStoreParquet(
+      path, std::move(part), writer_props_, arrow_props_, group_));
+  pending_.emplace_back(PendingPart{std::move(path), std::move(future)});
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::ParquetStreamWriter::Finish() {
+  if (finished_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "writer is finished");
+  }
+  finished_ = true;
+
+  if (part_offsets_.empty()) {
+    // small enough to be a single file
+    return DoStoreParquet(
+        uri_.string(), KATANA_CHECKED(TakeBuffered(num_buffered_rows_)),
+        writer_props_, arrow_props_, group_);
+  }
+
+  if (num_buffered_rows_ > 0) {
+    KATANA_CHECKED(StartPart(KATANA_CHECKED(TakeBuffered(num_buffered_rows_))));
+  }
+  KATANA_CHECKED(StoreIndex(uri_.string(), part_offsets_, group_));
+
+  if (group_) {
+    for (PendingPart& part : pending_) {
+      group_->AddOp(std::move(part.result), part.path);
+    }
+    pending_.clear();
+    return katana::ResultSuccess();
+  }
+  while (!pending_.empty()) {
+    KATANA_CHECKED(WaitForPart());
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
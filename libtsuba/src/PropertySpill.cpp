@@ -0,0 +1,155 @@
+#include "PropertySpill.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <limits>
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "tsuba/Errors.h"
+
+namespace {
+
+std::atomic<uint64_t> property_use_clock{0};
+std::atomic<uint64_t> spill_file_count{0};
+
+uint64_t
+DefaultMemoryLimit() {
+  long pages = sysconf(_SC_PHYS_PAGES);
+  long page_size = sysconf(_SC_PAGESIZE);
+  if (pages <= 0 || page_size <= 0) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return static_cast<uint64_t>(pages) * static_cast<uint64_t>(page_size) / 2;
+}
+
+uint64_t
+ArrayDataBytes(const arrow::ArrayData& data) {
+  uint64_t bytes = 0;
+  for (const auto& buffer : data.buffers) {
+    if (buffer) {
+      bytes += buffer->size();
+    }
+  }
+  for (const auto& child : data.child_data) {
+    bytes += ArrayDataBytes(*child);
+  }
+  if (data.dictionary) {
+    bytes += ArrayDataBytes(*data.dictionary);
+  }
+  return bytes;
+}
+
+katana::Result<void>
+WriteColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::string& path) {
+  auto schema = arrow::schema({arrow::field("spill", column->type())});
+  std::shared_ptr<arrow::io::FileOutputStream> out =
+      KATANA_CHECKED(arrow::io::FileOutputStream::Open(path));
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer =
+      KATANA_CHECKED(arrow::ipc::MakeFileWriter(out, schema));
+  for (const auto& chunk : column->chunks()) {
+    auto batch = arrow::RecordBatch::Make(schema, chunk->length(), {chunk});
+    KATANA_CHECKED(writer->WriteRecordBatch(*batch));
+  }
+  KATANA_CHECKED(writer->Close());
+  KATANA_CHECKED(out->Close());
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+MapColumn(
+    const std::string& path, const std::shared_ptr<arrow::DataType>& type) {
+  std::shared_ptr<arrow::io::MemoryMappedFile> file = KATANA_CHECKED(
+      arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ));
+  // Reading a mapped file is zero-copy: the arrays are slices of the mapping
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader =
+      KATANA_CHECKED(arrow::ipc::RecordBatchFileReader::Open(file));
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  for (int i = 0, n = reader->num_record_batches(); i < n; ++i) {
+    std::shared_ptr<arrow::RecordBatch> batch =
+        KATANA_CHECKED(reader->ReadRecordBatch(i));
+    chunks.emplace_back(batch->column(0));
+  }
+  return KATANA_CHECKED(arrow::ChunkedArray::Make(chunks, type));
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+WriteAndMapColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::string& path) {
+  KATANA_CHECKED(WriteColumn(column, path));
+  return MapColumn(path, column->type());
+}
+
+}  // namespace
+
+const tsuba::SpillPolicy&
+tsuba::SpillPolicy::Get() {
+  static const SpillPolicy policy = []() {
+    SpillPolicy ret;
+    std::string dir;
+    if (!katana::GetEnv("KATANA_TSUBA_SPILL_DIR", &dir) || dir.empty()) {
+      return ret;
+    }
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(dir, ec);
+    if (ec) {
+      KATANA_LOG_WARN(
+          "not spilling properties, cannot create {}: {}", dir, ec.message());
+      return ret;
+    }
+    ret.dir = std::move(dir);
+    ret.memory_limit = DefaultMemoryLimit();
+    int limit_mb = 0;
+    if (katana::GetEnv("KATANA_TSUBA_SPILL_MEMORY_MB", &limit_mb)) {
+      if (limit_mb > 0) {
+        ret.memory_limit = static_cast<uint64_t>(limit_mb) << 20;
+      } else {
+        KATANA_LOG_WARN(
+            "ignoring non-positive KATANA_TSUBA_SPILL_MEMORY_MB: {}", limit_mb);
+      }
+    }
+    return ret;
+  }();
+  return policy;
+}
+
+uint64_t
+tsuba::NextPropertyUse() {
+  return property_use_clock.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+uint64_t
+tsuba::ColumnBytes(const arrow::ChunkedArray& column) {
+  uint64_t bytes = 0;
+  for (const auto& chunk : column.chunks()) {
+    bytes += ArrayDataBytes(*chunk->data());
+  }
+  return bytes;
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+tsuba::SpillColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::string& dir) {
+  std::string path = fmt::format(
+      "{}/katana-spill-{}-{}", dir, getpid(),
+      spill_file_count.fetch_add(1, std::memory_order_relaxed));
+
+  auto spilled = WriteAndMapColumn(column, path);
+  // The mapping keeps the unlinked file alive
+  if (unlink(path.c_str()) != 0 && spilled) {
+    return KATANA_ERROR(katana::ResultErrno(), "unlinking {}", path);
+  }
+  if (!spilled) {
+    return spilled.error().WithContext("spilling to {}", path);
+  }
+  return spilled;
+}
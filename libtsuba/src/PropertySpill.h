@@ -0,0 +1,53 @@
+#ifndef KATANA_LIBTSUBA_PROPERTYSPILL_H_
+#define KATANA_LIBTSUBA_PROPERTYSPILL_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/Result.h"
+
+namespace tsuba {
+
+/// Where and when an RDG spills the property columns it holds in memory.
+///
+/// Spilling writes a column to a file on local storage and replaces it with
+/// a column of the same values that is backed by a mapping of the file, so
+/// the kernel pages it out and back in as it is used, like the topology of
+/// RDGLoadOptions::out_of_core_topology. Columns are spilled least recently
+/// used first once the columns in memory exceed the limit.
+///
+/// The policy is read once from the environment:
+///
+/// - KATANA_TSUBA_SPILL_DIR is a directory on a local file system, ideally
+///   an SSD. Spilling is disabled if it is unset.
+/// - KATANA_TSUBA_SPILL_MEMORY_MB is the limit on the megabytes of property
+///   columns each RDG keeps in memory (default: half of physical memory).
+struct SpillPolicy {
+  std::string dir;
+  uint64_t memory_limit{0};
+
+  bool enabled() const { return !dir.empty(); }
+
+  static const SpillPolicy& Get();
+};
+
+/// \returns a tick later than all those returned before, which orders the
+/// uses of properties for spilling
+uint64_t NextPropertyUse();
+
+/// \returns the bytes of memory held by the buffers of \param column
+uint64_t ColumnBytes(const arrow::ChunkedArray& column);
+
+/// Write \param column to a new file in \param dir and \returns a column of
+/// the same values backed by a read-only mapping of the file. The file is
+/// unlinked once it is mapped, so its space is reclaimed when the last buffer
+/// of the returned column is freed.
+katana::Result<std::shared_ptr<arrow::ChunkedArray>> SpillColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& column, const std::string& dir);
+
+}  // namespace tsuba
+
+#endif
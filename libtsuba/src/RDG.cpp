@@ -1,8 +1,11 @@
 #include "tsuba/RDG.h"
 
+#include <algorithm>
 #include <cassert>
 #include <exception>
 #include <fstream>
+#include <future>
+#include <limits>
 #include <memory>
 #include <regex>
 #include <unordered_set>
@@ -21,6 +24,7 @@
 
 #include "AddProperties.h"
 #include "GlobalState.h"
+#include "PropertySpill.h"
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
 #include "katana/ArrowInterchange.h"
@@ -94,7 +98,8 @@ WriteProperties(
     std::string path =
         KATANA_CHECKED(StoreArrowArrayAtName(props.column(i), dir, name, desc));
 
-    prop_info[i]->WasWritten(path);
+    prop_info[i]->WasWritten(
+        path, tsuba::ColumnStats::Compute(*props.column(i)));
   }
   TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
 
@@ -199,6 +204,17 @@ tsuba::RDGFile::~RDGFile() {
 
 katana::Result<std::vector<tsuba::PropStorageInfo>>
 tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
+  // Partition metadata rarely changes between versions; if none of it has
+  // changed since it was loaded or last written, keep the existing files
+  const std::vector<PropStorageInfo>& prev_properties =
+      core_->part_header().part_prop_info_list();
+  if (!part_arrays_dirty_ &&
+      std::none_of(
+          prev_properties.begin(), prev_properties.end(),
+          [](const PropStorageInfo& psi) { return psi.IsDirty(); })) {
+    return prev_properties;
+  }
+
   std::vector<tsuba::PropStorageInfo> next_properties;
 
   KATANA_LOG_DEBUG(
@@ -286,6 +302,21 @@ tsuba::RDG::DoStore(
     core_->part_header().set_topology_path(t_path.BaseName());
   }
 
+  // Derived topologies of a replaced topology are no longer usable
+  core_->part_header().PruneDerivedTopologies();
+  for (auto& [key, ff] : pending_derived_topologies_) {
+    katana::Uri path =
+        handle.impl_->rdg_manifest().dir().RandFile("derived_topology");
+    ff->Bind(path.string());
+    write_group->StartStore(std::move(ff));
+    core_->part_header().UpsertDerivedTopology(DerivedTopologyInfo{
+        .key = key,
+        .path = path.BaseName(),
+        .base_topology_path = core_->part_header().topology_path(),
+    });
+  }
+  pending_derived_topologies_.clear();
+
   std::vector<std::string> node_prop_names;
   for (const auto& field : core_->node_properties()->fields()) {
     node_prop_names.emplace_back(field->name());
@@ -314,9 +345,32 @@ tsuba::RDG::DoStore(
           handle.impl_->rdg_manifest().dir(), write_group.get()),
       "writing edge properties");
 
+  // Now that property files are known, drop indexes of replaced properties
+  // and record new ones against the files they index
+  core_->part_header().PrunePropertyIndexes();
+  for (auto& [prop, ff] : pending_property_indexes_) {
+    katana::Uri path =
+        handle.impl_->rdg_manifest().dir().RandFile("property_index");
+    ff->Bind(path.string());
+    write_group->StartStore(std::move(ff));
+    core_->part_header().UpsertPropertyIndex(PropertyIndexInfo{
+        .property = prop.second,
+        .for_nodes = prop.first,
+        .path = path.BaseName(),
+    });
+  }
+  pending_property_indexes_.clear();
+
   core_->part_header().set_part_properties(KATANA_CHECKED_CONTEXT(
       WritePartArrays(handle.impl_->rdg_manifest().dir(), write_group.get()),
       "writing partition metadata"));
+  part_arrays_dirty_ = false;
+
+  // Checksums of data files must be in the header, so wait for them
+  if (write_group->checksums_enabled()) {
+    KATANA_CHECKED_CONTEXT(write_group->Finish(), "writing data files");
+  }
+  core_->part_header().UpdateChecksums(write_group->checksums());
 
   //If a view type has been set, use it otherwise pass in the default view type
   if (view_type_.empty()) {
@@ -347,8 +401,69 @@ katana::Result<void>
 tsuba::RDG::DoMake(
     const std::vector<PropStorageInfo*>& node_props_to_be_loaded,
     const std::vector<PropStorageInfo*>& edge_props_to_be_loaded,
-    const katana::Uri& metadata_dir) {
-  ReadGroup grp;
+    const katana::Uri& metadata_dir, const RDGLoadOptions& opts) {
+  ReadGroup grp(opts.max_in_flight_bytes, opts.max_in_flight_ops);
+
+  // Start the topology first so that it is not queued behind properties
+  katana::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
+  uint64_t topology_size = 0;
+  if (grp.max_outstanding_size() > 0) {
+    StatBuf buf;
+    if (auto res = FileStat(t_path.string(), &buf); res) {
+      topology_size = buf.size;
+    }
+  }
+  bool out_of_core = opts.out_of_core_topology;
+  std::optional<uint32_t> crc32c;
+  if (opts.verify_checksums) {
+    const RDGPartHeader& header = core_->part_header();
+    crc32c = header.checksum(header.topology_path());
+  }
+  grp.StartOp(
+      [rdg = this, t_path, out_of_core,
+       crc32c]() -> katana::CopyableResult<void> {
+        FileView& fv = rdg->core_->topology_file_storage();
+        if (!out_of_core) {
+          KATANA_CHECKED_CONTEXT(
+              fv.Bind(
+                  t_path.string(), 0, std::numeric_limits<uint64_t>::max(),
+                  true, crc32c),
+              "binding topology {}", t_path);
+          return katana::CopyableResultSuccess();
+        }
+        // Map without reading ahead; fall back to reading the whole file if
+        // it cannot be mapped. A mapping can only be checked by reading all
+        // of it once; the kernel may evict those pages again afterwards.
+        KATANA_CHECKED_CONTEXT(
+            fv.Bind(t_path.string(), 0, 0, true, crc32c),
+            "binding topology {}", t_path);
+        rdg->out_of_core_topology_ = fv.FileBacked();
+        if (!fv.FileBacked() || crc32c) {
+          KATANA_CHECKED_CONTEXT(
+              fv.Fill(0, std::numeric_limits<uint64_t>::max(), true),
+              "reading topology {}", t_path);
+        }
+        return katana::CopyableResultSuccess();
+      },
+      t_path.string(),
+      []() -> katana::CopyableResult<void> {
+        return katana::CopyableResultSuccess();
+      },
+      topology_size, ReadGroup::Priority::kTopology);
+
+  auto node_read_opts = ParquetReader::ReadOpts::Defaults();
+  node_read_opts.use_threads = opts.parallel_decode;
+  node_read_opts.predicates = opts.node_predicates;
+  auto edge_read_opts = ParquetReader::ReadOpts::Defaults();
+  edge_read_opts.use_threads = opts.parallel_decode;
+  edge_read_opts.predicates = opts.edge_predicates;
+  auto part_read_opts = ParquetReader::ReadOpts::Defaults();
+  if (opts.verify_checksums) {
+    auto checksums = core_->part_header().checksums();
+    node_read_opts.checksums = checksums;
+    edge_read_opts.checksums = checksums;
+    part_read_opts.checksums = checksums;
+  }
 
   KATANA_CHECKED_CONTEXT(
       AddProperties(
@@ -369,7 +484,8 @@ tsuba::RDG::DoMake(
             }
             rdg->core_->set_node_properties(std::move(prop_table));
             return katana::ResultSuccess();
-          }),
+          },
+          node_read_opts),
       "populating node properties");
 
   KATANA_CHECKED_CONTEXT(
@@ -391,22 +507,21 @@ tsuba::RDG::DoMake(
             }
             rdg->core_->set_edge_properties(std::move(prop_table));
             return katana::ResultSuccess();
-          }),
+          },
+          edge_read_opts),
       "populating edge properties");
 
-  katana::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
-  if (auto res = core_->topology_file_storage().Bind(t_path.string(), true);
-      !res) {
-    return res.error();
-  }
-
   rdg_dir_ = metadata_dir;
 
   std::vector<PropStorageInfo*> part_info =
       KATANA_CHECKED(core_->part_header().SelectPartitionProperties());
 
   if (part_info.empty()) {
-    return grp.Finish();
+    KATANA_CHECKED(grp.Finish());
+    // the schema of properties that were not loaded is still needed
+    KATANA_CHECKED(core_->EnsureNodeTypesLoaded(rdg_dir_));
+    KATANA_CHECKED(core_->EnsureEdgeTypesLoaded(rdg_dir_));
+    return katana::ResultSuccess();
   }
 
   KATANA_CHECKED_CONTEXT(
@@ -414,10 +529,18 @@ tsuba::RDG::DoMake(
           metadata_dir, part_info, &grp,
           [rdg = this](const std::shared_ptr<arrow::Table>& props) {
             return rdg->AddPartitionMetadataArray(props);
-          }),
+          },
+          part_read_opts, ReadGroup::Priority::kMetadata),
       "populating partition metadata");
 
   KATANA_CHECKED(grp.Finish());
+  // The arrays now match the files they were loaded from, unless those files
+  // use deprecated names that the next store should replace
+  part_arrays_dirty_ = std::any_of(
+      part_info.begin(), part_info.end(), [](const PropStorageInfo* psi) {
+        return psi->name() == kDeprecatedLocalToGlobalIDPropName ||
+               psi->name() == kDeprecatedHostToOwnedGlobalNodeIDsPropName;
+      });
 
   if (local_to_user_id_->length() == 0) {
     // for backward compatibility
@@ -460,12 +583,16 @@ tsuba::RDG::DoMake(
 
   KATANA_CHECKED(core_->EnsureNodeTypesLoaded(rdg_dir_));
   KATANA_CHECKED(core_->EnsureEdgeTypesLoaded(rdg_dir_));
+  SpillColdProperties();
 
   return katana::ResultSuccess();
 }
 
 katana::Result<tsuba::RDG>
 tsuba::RDG::Make(const RDGManifest& manifest, const RDGLoadOptions& opts) {
+  // the files of a manifest do not change; check their versions once
+  FileStatScope stat_scope;
+
   uint32_t partition_id_to_load =
       opts.partition_id_to_load.value_or(Comm()->ID);
 
@@ -478,14 +605,43 @@ tsuba::RDG::Make(const RDGManifest& manifest, const RDGLoadOptions& opts) {
   }
 
   RDG rdg(std::make_unique<RDGCore>(std::move(part_header_res.value())));
+  rdg.verify_checksums_ = opts.verify_checksums;
+
+  std::optional<std::vector<std::string>> node_names = opts.node_properties;
+  std::optional<std::vector<std::string>> edge_names = opts.edge_properties;
+
+  // Pipelined loads read the selected properties in the background and
+  // only wait for the topology here
+  if (opts.pipelined && opts.node_predicates.empty() &&
+      opts.edge_predicates.empty()) {
+    auto names = [](const std::vector<PropStorageInfo*>& props) {
+      std::vector<std::string> result;
+      for (const PropStorageInfo* prop : props) {
+        result.emplace_back(prop->name());
+      }
+      return result;
+    };
+    rdg.rdg_dir_ = manifest.dir();
+    KATANA_CHECKED(rdg.PrefetchNodeProperties(names(KATANA_CHECKED(
+        rdg.core_->part_header().SelectNodeProperties(node_names)))));
+    KATANA_CHECKED(rdg.PrefetchEdgeProperties(names(KATANA_CHECKED(
+        rdg.core_->part_header().SelectEdgeProperties(edge_names)))));
+    node_names = std::vector<std::string>();
+    edge_names = std::vector<std::string>();
+  }
+  if (opts.lazy_properties) {
+    node_names = std::vector<std::string>();
+    edge_names = std::vector<std::string>();
+  }
 
   std::vector<PropStorageInfo*> node_props = KATANA_CHECKED(
-      rdg.core_->part_header().SelectNodeProperties(opts.node_properties));
+      rdg.core_->part_header().SelectNodeProperties(node_names));
 
   std::vector<PropStorageInfo*> edge_props = KATANA_CHECKED(
-      rdg.core_->part_header().SelectEdgeProperties(opts.edge_properties));
+      rdg.core_->part_header().SelectEdgeProperties(edge_names));
 
-  if (auto res = rdg.DoMake(node_props, edge_props, manifest.dir()); !res) {
+  if (auto res = rdg.DoMake(node_props, edge_props, manifest.dir(), opts);
+      !res) {
     return res.error();
   }
 
@@ -507,6 +663,85 @@ tsuba::RDG::Equals(const RDG& other) const {
   return core_->Equals(*other.core_);
 }
 
+void
+tsuba::RDG::AddDerivedTopology(
+    const std::string& key, std::unique_ptr<FileFrame> ff) {
+  for (auto& [pending_key, pending_ff] : pending_derived_topologies_) {
+    if (pending_key == key) {
+      pending_ff = std::move(ff);
+      return;
+    }
+  }
+  pending_derived_topologies_.emplace_back(key, std::move(ff));
+}
+
+bool
+tsuba::RDG::HasDerivedTopology(const std::string& key) const {
+  return core_->part_header().FindDerivedTopology(key) != nullptr;
+}
+
+katana::Result<void>
+tsuba::RDG::LoadDerivedTopology(const std::string& key, FileView* fv) const {
+  const DerivedTopologyInfo* info =
+      core_->part_header().FindDerivedTopology(key);
+  if (info == nullptr || rdg_dir_.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "no derived topology {}", std::quoted(key));
+  }
+  katana::Uri path = rdg_dir_.Join(info->path);
+  KATANA_CHECKED_CONTEXT(
+      fv->Bind(
+          path.string(), 0, std::numeric_limits<uint64_t>::max(), true,
+          core_->part_header().checksum(info->path)),
+      "binding derived topology {}", path);
+  return katana::ResultSuccess();
+}
+
+void
+tsuba::RDG::AddPropertyIndex(
+    bool for_nodes, const std::string& name, std::unique_ptr<FileFrame> ff) {
+  for (auto& [pending_prop, pending_ff] : pending_property_indexes_) {
+    if (pending_prop.first == for_nodes && pending_prop.second == name) {
+      pending_ff = std::move(ff);
+      return;
+    }
+  }
+  pending_property_indexes_.emplace_back(
+      std::make_pair(for_nodes, name), std::move(ff));
+}
+
+std::vector<std::string>
+tsuba::RDG::ListPropertyIndexes(bool for_nodes) const {
+  const RDGPartHeader& header = core_->part_header();
+  std::vector<std::string> names;
+  for (const auto& info : header.property_indexes()) {
+    if (info.for_nodes == for_nodes &&
+        header.FindPropertyIndex(for_nodes, info.property) != nullptr) {
+      names.emplace_back(info.property);
+    }
+  }
+  return names;
+}
+
+katana::Result<void>
+tsuba::RDG::LoadPropertyIndex(
+    bool for_nodes, const std::string& name, FileView* fv) const {
+  const PropertyIndexInfo* info =
+      core_->part_header().FindPropertyIndex(for_nodes, name);
+  if (info == nullptr || rdg_dir_.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "no index of {} property {}",
+        for_nodes ? "node" : "edge", std::quoted(name));
+  }
+  katana::Uri path = rdg_dir_.Join(info->path);
+  KATANA_CHECKED_CONTEXT(
+      fv->Bind(
+          path.string(), 0, std::numeric_limits<uint64_t>::max(), true,
+          core_->part_header().checksum(info->path)),
+      "binding property index {}", path);
+  return katana::ResultSuccess();
+}
+
 katana::Result<tsuba::RDG>
 tsuba::RDG::Make(RDGHandle handle, const RDGLoadOptions& opts) {
   if (!handle.impl_->AllowsRead()) {
@@ -563,6 +798,7 @@ tsuba::RDG::AddNodeProperties(const std::shared_ptr<arrow::Table>& props) {
   if (auto res = core_->AddNodeProperties(props); !res) {
     return res.error();
   }
+  SpillColdProperties();
 
   return katana::ResultSuccess();
 }
@@ -572,18 +808,23 @@ tsuba::RDG::AddEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
   if (auto res = core_->AddEdgeProperties(props); !res) {
     return res.error();
   }
+  SpillColdProperties();
 
   return katana::ResultSuccess();
 }
 
 katana::Result<void>
 tsuba::RDG::UpsertNodeProperties(const std::shared_ptr<arrow::Table>& props) {
-  return core_->UpsertNodeProperties(props);
+  KATANA_CHECKED(core_->UpsertNodeProperties(props));
+  SpillColdProperties();
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
 tsuba::RDG::UpsertEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
-  return core_->UpsertEdgeProperties(props);
+  KATANA_CHECKED(core_->UpsertEdgeProperties(props));
+  SpillColdProperties();
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -622,7 +863,7 @@ UnloadProperty(
   if (prop_info.IsDirty()) {
     std::string path = KATANA_CHECKED(
         StoreArrowArrayAtName(props->column(i), dir, name, nullptr));
-    prop_info.WasWritten(path);
+    prop_info.WasWritten(path, tsuba::ColumnStats::Compute(*props->column(i)));
   }
 
   prop_info.WasUnloaded();
@@ -633,8 +874,9 @@ UnloadProperty(
 katana::Result<std::shared_ptr<arrow::Table>>
 LoadProperty(
     const std::shared_ptr<arrow::Table>& props, const std::string name, int i,
-    std::vector<tsuba::PropStorageInfo>* prop_info_list,
-    const katana::Uri& dir) {
+    std::vector<tsuba::PropStorageInfo>* prop_info_list, const katana::Uri& dir,
+    tsuba::PropertyPrefetches* prefetches,
+    const tsuba::ParquetReader::ReadOpts& read_opts) {
   if (i < 0 || i > props->num_columns()) {
     i = props->num_columns();
   }
@@ -658,24 +900,72 @@ LoadProperty(
   }
 
   std::shared_ptr<arrow::Table> new_table;
-
-  KATANA_CHECKED(tsuba::AddProperties(
-      dir, {&prop_info}, nullptr,
+  auto add_fn =
       [&](const std::shared_ptr<arrow::Table>& col) -> katana::Result<void> {
-        if (props->num_columns() > 0) {
-          new_table = KATANA_CHECKED(
-              props->AddColumn(i, col->field(0), col->column(0)));
-        } else {
-          new_table = col;
-        }
-        return katana::ResultSuccess();
-      }));
+    if (props->num_columns() > 0) {
+      new_table =
+          KATANA_CHECKED(props->AddColumn(i, col->field(0), col->column(0)));
+    } else {
+      new_table = col;
+    }
+    return katana::ResultSuccess();
+  };
+
+  if (auto it = prefetches->find(name); it != prefetches->end()) {
+    tsuba::PropertyPrefetch prefetch = std::move(it->second);
+    prefetches->erase(it);
+    if (prefetch.path == prop_info.path()) {
+      std::shared_ptr<arrow::Table> col = KATANA_CHECKED_CONTEXT(
+          prefetch.table.get(), "waiting for prefetch of {}",
+          std::quoted(name));
+      KATANA_CHECKED(add_fn(col));
+      prop_info.WasLoaded(col->field(0)->type());
+      return new_table;
+    }
+  }
+
+  KATANA_CHECKED(
+      tsuba::AddProperties(dir, {&prop_info}, nullptr, add_fn, read_opts));
 
   KATANA_LOG_ASSERT(prop_info.IsClean());
 
   return new_table;
 }
 
+katana::Result<void>
+PrefetchProperties(
+    const std::vector<std::string>& names,
+    const std::vector<tsuba::PropStorageInfo>& prop_info_list,
+    const katana::Uri& dir, tsuba::PropertyPrefetches* prefetches,
+    const tsuba::ParquetReader::ReadOpts& read_opts) {
+  for (const std::string& name : names) {
+    auto psi_it = std::find_if(
+        prop_info_list.begin(), prop_info_list.end(),
+        [&](const tsuba::PropStorageInfo& psi) { return psi.name() == name; });
+    if (psi_it == prop_info_list.end()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::PropertyNotFound, "no property named {}",
+          std::quoted(name));
+    }
+    if (!psi_it->IsAbsent() || prefetches->count(name) > 0) {
+      continue;
+    }
+
+    katana::Uri path = dir.Join(psi_it->path());
+    auto table = std::async(
+        std::launch::async,
+        [name, path, read_opts]()
+            -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
+          return KATANA_CHECKED_CONTEXT(
+              tsuba::LoadProperties(name, path, read_opts), "error loading {}",
+              path);
+        });
+    prefetches->emplace(
+        name, tsuba::PropertyPrefetch{psi_it->path(), std::move(table)});
+  }
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -696,12 +986,22 @@ tsuba::RDG::UnloadEdgeProperty(int i) {
   return katana::ResultSuccess();
 }
 
+tsuba::ParquetReader::ReadOpts
+tsuba::RDG::LaterReadOpts() const {
+  auto read_opts = ParquetReader::ReadOpts::Defaults();
+  if (verify_checksums_) {
+    read_opts.checksums = core_->part_header().checksums();
+  }
+  return read_opts;
+}
+
 katana::Result<void>
 tsuba::RDG::LoadNodeProperty(const std::string& name, int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(LoadProperty(
       node_properties(), name, i, &core_->part_header().node_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), &core_->node_prefetches(), LaterReadOpts()));
   core_->set_node_properties(std::move(new_props));
+  SpillColdProperties();
   return katana::ResultSuccess();
 }
 
@@ -709,11 +1009,26 @@ katana::Result<void>
 tsuba::RDG::LoadEdgeProperty(const std::string& name, int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(LoadProperty(
       edge_properties(), name, i, &core_->part_header().edge_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), &core_->edge_prefetches(), LaterReadOpts()));
   core_->set_edge_properties(std::move(new_props));
+  SpillColdProperties();
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+tsuba::RDG::PrefetchNodeProperties(const std::vector<std::string>& names) {
+  return PrefetchProperties(
+      names, core_->part_header().node_prop_info_list(), rdg_dir(),
+      &core_->node_prefetches(), LaterReadOpts());
+}
+
+katana::Result<void>
+tsuba::RDG::PrefetchEdgeProperties(const std::vector<std::string>& names) {
+  return PrefetchProperties(
+      names, core_->part_header().edge_prop_info_list(), rdg_dir(),
+      &core_->edge_prefetches(), LaterReadOpts());
+}
+
 std::vector<std::string>
 tsuba::RDG::ListNodeProperties() const {
   std::vector<std::string> result;
@@ -732,6 +1047,172 @@ tsuba::RDG::ListEdgeProperties() const {
   return result;
 }
 
+namespace {
+
+katana::Result<tsuba::ColumnStats>
+FindStats(
+    const std::vector<tsuba::PropStorageInfo>& prop_info_list,
+    const std::string& name) {
+  auto it = std::find_if(
+      prop_info_list.begin(), prop_info_list.end(),
+      [&](const tsuba::PropStorageInfo& psi) { return psi.name() == name; });
+  if (it == prop_info_list.end()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+  if (!it->stats()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::NotFound, "no statistics recorded for {}",
+        std::quoted(name));
+  }
+  return it->stats().value();
+}
+
+}  // namespace
+
+katana::Result<tsuba::ColumnStats>
+tsuba::RDG::GetNodePropertyStats(const std::string& name) const {
+  return FindStats(core_->part_header().node_prop_info_list(), name);
+}
+
+katana::Result<tsuba::ColumnStats>
+tsuba::RDG::GetEdgePropertyStats(const std::string& name) const {
+  return FindStats(core_->part_header().edge_prop_info_list(), name);
+}
+
+namespace {
+
+template <typename PropStorageInfoList>
+auto*
+FindPropStorageInfo(
+    PropStorageInfoList* prop_info_list, const std::string& name) {
+  auto it = std::find_if(
+      prop_info_list->begin(), prop_info_list->end(),
+      [&](const tsuba::PropStorageInfo& psi) { return psi.name() == name; });
+  return it == prop_info_list->end() ? nullptr : &*it;
+}
+
+/// A property column held in memory that may be spilled
+struct SpillCandidate {
+  tsuba::PropStorageInfo* prop_info;
+  bool is_node_property;
+  uint64_t bytes;
+};
+
+void
+AddSpillCandidates(
+    const std::shared_ptr<arrow::Table>& props,
+    std::vector<tsuba::PropStorageInfo>* prop_info_list, bool is_node_property,
+    std::vector<SpillCandidate>* candidates, uint64_t* total_bytes) {
+  for (tsuba::PropStorageInfo& prop_info : *prop_info_list) {
+    if (prop_info.IsAbsent() || prop_info.IsSpilled()) {
+      continue;
+    }
+    std::shared_ptr<arrow::ChunkedArray> column =
+        props->GetColumnByName(prop_info.name());
+    if (!column) {
+      continue;
+    }
+    uint64_t bytes = tsuba::ColumnBytes(*column);
+    candidates->emplace_back(
+        SpillCandidate{&prop_info, is_node_property, bytes});
+    *total_bytes += bytes;
+  }
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+SpillProperty(
+    const std::shared_ptr<arrow::Table>& props,
+    tsuba::PropStorageInfo* prop_info, const std::string& dir) {
+  int i = props->schema()->GetFieldIndex(prop_info->name());
+  KATANA_LOG_ASSERT(i >= 0);
+  std::shared_ptr<arrow::ChunkedArray> spilled = KATANA_CHECKED_CONTEXT(
+      tsuba::SpillColumn(props->column(i), dir), "property {}",
+      std::quoted(prop_info->name()));
+  prop_info->WasSpilled();
+  return KATANA_CHECKED(props->SetColumn(i, props->field(i), spilled));
+}
+
+}  // namespace
+
+bool
+tsuba::RDG::IsNodePropertySpilled(const std::string& name) const {
+  const auto* prop_info =
+      FindPropStorageInfo(&core_->part_header().node_prop_info_list(), name);
+  return prop_info != nullptr && prop_info->IsSpilled();
+}
+
+bool
+tsuba::RDG::IsEdgePropertySpilled(const std::string& name) const {
+  const auto* prop_info =
+      FindPropStorageInfo(&core_->part_header().edge_prop_info_list(), name);
+  return prop_info != nullptr && prop_info->IsSpilled();
+}
+
+void
+tsuba::RDG::MarkNodePropertyUsed(const std::string& name) {
+  if (auto* prop_info = FindPropStorageInfo(
+          &core_->part_header().node_prop_info_list(), name);
+      prop_info != nullptr) {
+    prop_info->WasUsed();
+  }
+}
+
+void
+tsuba::RDG::MarkEdgePropertyUsed(const std::string& name) {
+  if (auto* prop_info = FindPropStorageInfo(
+          &core_->part_header().edge_prop_info_list(), name);
+      prop_info != nullptr) {
+    prop_info->WasUsed();
+  }
+}
+
+void
+tsuba::RDG::SpillColdProperties() {
+  const SpillPolicy& policy = SpillPolicy::Get();
+  if (!policy.enabled()) {
+    return;
+  }
+
+  std::vector<SpillCandidate> candidates;
+  uint64_t total_bytes = 0;
+  AddSpillCandidates(
+      node_properties(), &core_->part_header().node_prop_info_list(), true,
+      &candidates, &total_bytes);
+  AddSpillCandidates(
+      edge_properties(), &core_->part_header().edge_prop_info_list(), false,
+      &candidates, &total_bytes);
+  if (total_bytes <= policy.memory_limit) {
+    return;
+  }
+
+  std::sort(
+      candidates.begin(), candidates.end(),
+      [](const SpillCandidate& a, const SpillCandidate& b) {
+        return a.prop_info->last_use() < b.prop_info->last_use();
+      });
+  for (const SpillCandidate& candidate : candidates) {
+    if (total_bytes <= policy.memory_limit) {
+      break;
+    }
+    const std::shared_ptr<arrow::Table>& props = candidate.is_node_property
+                                                     ? node_properties()
+                                                     : edge_properties();
+    auto res = SpillProperty(props, candidate.prop_info, policy.dir);
+    if (!res) {
+      KATANA_LOG_WARN("not spilling properties: {}", res.error());
+      return;
+    }
+    if (candidate.is_node_property) {
+      core_->set_node_properties(std::move(res.value()));
+    } else {
+      core_->set_edge_properties(std::move(res.value()));
+    }
+    total_bytes -= candidate.bytes;
+  }
+}
+
 const tsuba::PartitionMetadata&
 tsuba::RDG::part_metadata() const {
   return core_->part_header().metadata();
@@ -1,16 +1,31 @@
 #ifndef KATANA_LIBTSUBA_RDGCORE_H_
 #define KATANA_LIBTSUBA_RDGCORE_H_
 
+#include <future>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 #include <arrow/api.h>
 
 #include "RDGPartHeader.h"
+#include "katana/Result.h"
 #include "katana/config.h"
 #include "tsuba/FileView.h"
 
 namespace tsuba {
 
+/// A property being read from storage ahead of its first use
+struct PropertyPrefetch {
+  /// file the property is read from; the prefetch is stale if the property is
+  /// stored somewhere else by the time it is loaded
+  std::string path;
+  std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> table;
+};
+
+/// Prefetches in progress by property name
+using PropertyPrefetches = std::unordered_map<std::string, PropertyPrefetch>;
+
 class KATANA_EXPORT RDGCore {
 public:
   RDGCore() { InitEmptyProperties(); }
@@ -85,6 +100,9 @@ public:
     part_header_ = std::move(part_header);
   }
 
+  PropertyPrefetches& node_prefetches() { return node_prefetches_; }
+  PropertyPrefetches& edge_prefetches() { return edge_prefetches_; }
+
   katana::Result<void> RegisterTopologyFile(const std::string& new_top) {
     part_header_.set_topology_path(new_top);
     return topology_file_storage_.Unbind();
@@ -103,6 +121,9 @@ private:
   FileView topology_file_storage_;
 
   RDGPartHeader part_header_;
+
+  PropertyPrefetches node_prefetches_;
+  PropertyPrefetches edge_prefetches_;
 };
 
 }  // namespace tsuba
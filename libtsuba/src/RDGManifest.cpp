@@ -221,27 +221,31 @@ RDGManifest::FileNames() {
 
     auto header_uri = KATANA_CHECKED(katana::Uri::Make(fmt::format(
         "{}/{}", dir(), PartitionFileName(view_specifier(), i, version()))));
-    auto header_res = RDGPartHeader::Make(header_uri);
-
-    if (!header_res) {
-      KATANA_LOG_DEBUG(
-          "problem uri: {} host: {} ver: {} view_name: {}  : {}", header_uri, i,
-          version(), view_specifier(), header_res.error());
-    } else {
-      auto header = std::move(header_res.value());
-      for (const auto& node_prop : header.node_prop_info_list()) {
-        fnames.emplace(node_prop.path());
-      }
-      for (const auto& edge_prop : header.edge_prop_info_list()) {
-        fnames.emplace(edge_prop.path());
-      }
-      for (const auto& part_prop : header.part_prop_info_list()) {
-        fnames.emplace(part_prop.path());
-      }
-      // Duplicates eliminated by set
-      fnames.emplace(header.topology_path());
+    // Callers delete files not in the result, so a header that cannot be
+    // read is an error rather than an empty set of files
+    auto header = KATANA_CHECKED_CONTEXT(
+        RDGPartHeader::Make(header_uri), "host: {} ver: {} view_name: {}", i,
+        version(), view_specifier());
+    for (const auto& node_prop : header.node_prop_info_list()) {
+      fnames.emplace(node_prop.path());
     }
+    for (const auto& edge_prop : header.edge_prop_info_list()) {
+      fnames.emplace(edge_prop.path());
+    }
+    for (const auto& part_prop : header.part_prop_info_list()) {
+      fnames.emplace(part_prop.path());
+    }
+    for (const auto& derived : header.derived_topologies()) {
+      fnames.emplace(derived.path);
+    }
+    for (const auto& index : header.property_indexes()) {
+      fnames.emplace(index.path);
+    }
+    // Duplicates eliminated by set
+    fnames.emplace(header.topology_path());
   }
+  // properties that are not stored have empty paths
+  fnames.erase("");
   return fnames;
 }
 
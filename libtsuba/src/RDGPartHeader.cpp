@@ -1,5 +1,9 @@
 #include "RDGPartHeader.h"
 
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
 #include "Constants.h"
 #include "GlobalState.h"
 #include "RDGHandleImpl.h"
@@ -19,6 +23,9 @@ const char* kNodePropertyKey = "kg.v1.node_property";
 const char* kEdgePropertyKey = "kg.v1.edge_property";
 const char* kPartPropertyFilesKey = "kg.v1.part_property_files";
 const char* kPartProperyMetaKey = "kg.v1.part_property_meta";
+const char* kChecksumsKey = "kg.v1.checksums";
+const char* kDerivedTopologiesKey = "kg.v1.derived_topologies";
+const char* kPropertyIndexesKey = "kg.v1.property_indexes";
 //
 //constexpr std::string_view  mirror_nodes_prop_name = "mirror_nodes";
 //constexpr std::string_view  master_nodes_prop_name = "master_nodes";
@@ -38,6 +45,56 @@ CopyProperty(
   return tsuba::FileStore(new_path.string(), fv.ptr<uint8_t>(), fv.size());
 }
 
+json
+ScalarToJson(const arrow::Scalar& scalar) {
+  switch (scalar.type->id()) {
+  case arrow::Type::INT64:
+    return static_cast<const arrow::Int64Scalar&>(scalar).value;
+  case arrow::Type::UINT64:
+    return static_cast<const arrow::UInt64Scalar&>(scalar).value;
+  case arrow::Type::DOUBLE: {
+    // JSON has no infinities or NaNs, and nlohmann writes them as null
+    double value = static_cast<const arrow::DoubleScalar&>(scalar).value;
+    if (!std::isfinite(value)) {
+      return nullptr;
+    }
+    return value;
+  }
+  case arrow::Type::BOOL:
+    return static_cast<const arrow::BooleanScalar&>(scalar).value;
+  case arrow::Type::STRING:
+    return static_cast<const arrow::StringScalar&>(scalar).value->ToString();
+  default:
+    return nullptr;
+  }
+}
+
+/// \returns null for types written by newer versions so that their
+/// statistics are ignored rather than rejected, and for values that were
+/// written as null, like the infinities stored before they were left out
+std::shared_ptr<arrow::Scalar>
+JsonToScalar(const json& j, const std::string& value_type) {
+  if (j.is_null()) {
+    return nullptr;
+  }
+  if (value_type == "int64") {
+    return std::make_shared<arrow::Int64Scalar>(j.get<int64_t>());
+  }
+  if (value_type == "uint64") {
+    return std::make_shared<arrow::UInt64Scalar>(j.get<uint64_t>());
+  }
+  if (value_type == "double") {
+    return std::make_shared<arrow::DoubleScalar>(j.get<double>());
+  }
+  if (value_type == "bool") {
+    return std::make_shared<arrow::BooleanScalar>(j.get<bool>());
+  }
+  if (value_type == "string") {
+    return std::make_shared<arrow::StringScalar>(j.get<std::string>());
+  }
+  return nullptr;
+}
+
 }  // namespace
 
 namespace tsuba {
@@ -107,6 +164,121 @@ RDGPartHeader::Write(
   return katana::ResultSuccess();
 }
 
+void
+RDGPartHeader::UpdateChecksums(
+    const std::unordered_map<std::string, uint32_t>& checksums) {
+  for (const auto& [name, crc] : checksums) {
+    checksums_[name] = crc;
+  }
+
+  std::unordered_set<std::string> referenced{topology_path_};
+  for (const auto* list :
+       {&node_prop_info_list_, &edge_prop_info_list_, &part_prop_info_list_}) {
+    for (const auto& prop : *list) {
+      referenced.emplace(prop.path());
+    }
+  }
+  for (const auto& info : derived_topologies_) {
+    referenced.emplace(info.path);
+  }
+  for (const auto& info : property_indexes_) {
+    referenced.emplace(info.path);
+  }
+  for (auto it = checksums_.begin(); it != checksums_.end();) {
+    const std::string& name = it->first;
+    size_t part_pos = name.rfind(".part_");
+    if (referenced.count(name) == 0 &&
+        (part_pos == std::string::npos ||
+         referenced.count(name.substr(0, part_pos)) == 0)) {
+      it = checksums_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+const DerivedTopologyInfo*
+RDGPartHeader::FindDerivedTopology(const std::string& key) const {
+  for (const auto& info : derived_topologies_) {
+    if (info.key == key && info.base_topology_path == topology_path_) {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+void
+RDGPartHeader::UpsertDerivedTopology(DerivedTopologyInfo info) {
+  for (auto& existing : derived_topologies_) {
+    if (existing.key == info.key) {
+      existing = std::move(info);
+      return;
+    }
+  }
+  derived_topologies_.emplace_back(std::move(info));
+}
+
+void
+RDGPartHeader::PruneDerivedTopologies() {
+  derived_topologies_.erase(
+      std::remove_if(
+          derived_topologies_.begin(), derived_topologies_.end(),
+          [&](const auto& info) {
+            return info.base_topology_path != topology_path_;
+          }),
+      derived_topologies_.end());
+}
+
+std::string
+RDGPartHeader::PropertyPath(bool for_nodes, const std::string& name) const {
+  const auto& list = for_nodes ? node_prop_info_list_ : edge_prop_info_list_;
+  for (const auto& prop : list) {
+    if (prop.name() == name) {
+      return prop.path();
+    }
+  }
+  return "";
+}
+
+const PropertyIndexInfo*
+RDGPartHeader::FindPropertyIndex(
+    bool for_nodes, const std::string& name) const {
+  for (const auto& info : property_indexes_) {
+    if (info.for_nodes == for_nodes && info.property == name &&
+        !info.base_property_path.empty() &&
+        info.base_property_path == PropertyPath(for_nodes, name)) {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+void
+RDGPartHeader::UpsertPropertyIndex(PropertyIndexInfo info) {
+  info.base_property_path = PropertyPath(info.for_nodes, info.property);
+  for (auto& existing : property_indexes_) {
+    if (existing.for_nodes == info.for_nodes &&
+        existing.property == info.property) {
+      existing = std::move(info);
+      return;
+    }
+  }
+  property_indexes_.emplace_back(std::move(info));
+}
+
+void
+RDGPartHeader::PrunePropertyIndexes() {
+  property_indexes_.erase(
+      std::remove_if(
+          property_indexes_.begin(), property_indexes_.end(),
+          [&](const auto& info) {
+            return info.base_property_path.empty() ||
+                   info.base_property_path !=
+                       PropertyPath(info.for_nodes, info.property);
+          }),
+      property_indexes_.end());
+}
+
 katana::Result<void>
 RDGPartHeader::Validate() const {
   for (const auto& md : node_prop_info_list_) {
@@ -138,27 +310,29 @@ katana::Result<void>
 RDGPartHeader::ChangeStorageLocation(
     const katana::Uri& old_location, const katana::Uri& new_location) {
   for (PropStorageInfo& prop : node_prop_info_list_) {
-    if (prop.IsAbsent()) {
+    if (prop.IsAbsent() || prop.IsPartial()) {
       KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
     } else {
       prop.WasModified(prop.type());
     }
   }
   for (PropStorageInfo& prop : edge_prop_info_list_) {
-    if (prop.IsAbsent()) {
+    if (prop.IsAbsent() || prop.IsPartial()) {
       KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
     } else {
       prop.WasModified(prop.type());
     }
   }
   for (PropStorageInfo& prop : part_prop_info_list_) {
-    if (prop.IsAbsent()) {
+    if (prop.IsAbsent() || prop.IsPartial()) {
       KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
     } else {
       prop.WasModified(prop.type());
     }
   }
   topology_path_ = "";
+  // indexes are not copied; properties that are copied keep their paths
+  property_indexes_.clear();
   return katana::ResultSuccess();
 }
 
@@ -182,6 +356,17 @@ tsuba::to_json(json& j, const tsuba::RDGPartHeader& header) {
       {kPartPropertyFilesKey, header.part_prop_info_list_},
       {kPartProperyMetaKey, header.metadata_},
   };
+  // omitted when empty so that headers without checksums read the same in
+  // older versions
+  if (!header.checksums_.empty()) {
+    j[kChecksumsKey] = header.checksums_;
+  }
+  if (!header.derived_topologies_.empty()) {
+    j[kDerivedTopologiesKey] = header.derived_topologies_;
+  }
+  if (!header.property_indexes_.empty()) {
+    j[kPropertyIndexesKey] = header.property_indexes_;
+  }
 }
 
 void
@@ -191,6 +376,15 @@ tsuba::from_json(const json& j, tsuba::RDGPartHeader& header) {
   j.at(kEdgePropertyKey).get_to(header.edge_prop_info_list_);
   j.at(kPartPropertyFilesKey).get_to(header.part_prop_info_list_);
   j.at(kPartProperyMetaKey).get_to(header.metadata_);
+  if (auto it = j.find(kChecksumsKey); it != j.end()) {
+    it->get_to(header.checksums_);
+  }
+  if (auto it = j.find(kDerivedTopologiesKey); it != j.end()) {
+    it->get_to(header.derived_topologies_);
+  }
+  if (auto it = j.find(kPropertyIndexesKey); it != j.end()) {
+    it->get_to(header.property_indexes_);
+  }
 }
 
 void
@@ -242,9 +436,79 @@ tsuba::from_json(const nlohmann::json& j, tsuba::PropStorageInfo& propmd) {
   j.at(0).get_to(propmd.name_);
   j.at(1).get_to(propmd.path_);
   propmd.state_ = PropStorageInfo::State::kAbsent;
+  // statistics are optional so that older readers and writers interoperate
+  if (j.size() > 2) {
+    propmd.stats_ = j.at(2).get<tsuba::ColumnStats>();
+  }
 }
 
 void
 tsuba::to_json(json& j, const tsuba::PropStorageInfo& propmd) {
   j = json{propmd.name(), propmd.path()};
+  if (propmd.stats()) {
+    j.emplace_back(propmd.stats().value());
+  }
+}
+
+void
+tsuba::to_json(json& j, const tsuba::DerivedTopologyInfo& info) {
+  j = json{
+      {"key", info.key},
+      {"path", info.path},
+      {"base_topology_path", info.base_topology_path}};
+}
+
+void
+tsuba::from_json(const json& j, tsuba::DerivedTopologyInfo& info) {
+  j.at("key").get_to(info.key);
+  j.at("path").get_to(info.path);
+  j.at("base_topology_path").get_to(info.base_topology_path);
+}
+
+void
+tsuba::to_json(json& j, const tsuba::PropertyIndexInfo& info) {
+  j = json{
+      {"property", info.property},
+      {"for_nodes", info.for_nodes},
+      {"path", info.path},
+      {"base_property_path", info.base_property_path}};
+}
+
+void
+tsuba::from_json(const json& j, tsuba::PropertyIndexInfo& info) {
+  j.at("property").get_to(info.property);
+  j.at("for_nodes").get_to(info.for_nodes);
+  j.at("path").get_to(info.path);
+  j.at("base_property_path").get_to(info.base_property_path);
+}
+
+void
+tsuba::to_json(json& j, const tsuba::ColumnStats& stats) {
+  j = json{{"num_rows", stats.num_rows}, {"null_count", stats.null_count}};
+  if (stats.min && stats.max) {
+    j["value_type"] = stats.min->type->ToString();
+    j["min"] = ScalarToJson(*stats.min);
+    j["max"] = ScalarToJson(*stats.max);
+  }
+  if (stats.distinct_estimate) {
+    j["distinct_estimate"] = stats.distinct_estimate.value();
+  }
+}
+
+void
+tsuba::from_json(const json& j, tsuba::ColumnStats& stats) {
+  j.at("num_rows").get_to(stats.num_rows);
+  j.at("null_count").get_to(stats.null_count);
+  if (auto it = j.find("value_type"); it != j.end()) {
+    std::string value_type = it->get<std::string>();
+    stats.min = JsonToScalar(j.at("min"), value_type);
+    stats.max = JsonToScalar(j.at("max"), value_type);
+    if (!stats.min || !stats.max) {
+      stats.min.reset();
+      stats.max.reset();
+    }
+  }
+  if (auto it = j.find("distinct_estimate"); it != j.end()) {
+    stats.distinct_estimate = it->get<uint64_t>();
+  }
 }
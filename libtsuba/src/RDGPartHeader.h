@@ -2,14 +2,19 @@
 #define KATANA_LIBTSUBA_RDGPARTHEADER_H_
 
 #include <cassert>
+#include <map>
+#include <memory>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include <arrow/api.h>
 
+#include "PropertySpill.h"
 #include "katana/JSON.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
+#include "tsuba/ColumnStats.h"
 #include "tsuba/Errors.h"
 #include "tsuba/PartitionMetadata.h"
 #include "tsuba/RDG.h"
@@ -43,6 +48,12 @@ namespace tsuba {
 /// Properties either start out in storage as part of an RDG on disk
 /// (EXISTING PROPERTY) or start out in memory as part of an RDG in
 /// memory (NEW PROPERTY)
+///
+/// Clean and Dirty properties may also be spilled, i.e., have their column
+/// backed by a local file rather than memory (see SpillPolicy). This does not
+/// change their state; loading or modifying a property brings it back into
+/// memory. Loads and modifications count as uses of the property for
+/// choosing which properties to spill.
 class PropStorageInfo {
   enum class State {
     kAbsent,
@@ -62,29 +73,62 @@ public:
         path_(std::move(path)),
         state_(State::kAbsent) {}
 
-  void WasLoaded(const std::shared_ptr<arrow::DataType>& type) {
+  /// \param partial if rows of the stored property were replaced by nulls
+  ///     because they could not match the load predicates; see IsPartial
+  void WasLoaded(
+      const std::shared_ptr<arrow::DataType>& type, bool partial = false) {
     KATANA_LOG_ASSERT(state_ == State::kAbsent);
     state_ = State::kClean;
     type_ = type;
+    spilled_ = false;
+    partial_ = partial;
+    WasUsed();
   }
 
   void WasModified(const std::shared_ptr<arrow::DataType>& type) {
     path_.clear();
     state_ = State::kDirty;
     type_ = type;
+    stats_.reset();
+    spilled_ = false;
+    partial_ = false;
+    WasUsed();
   }
 
-  void WasWritten(std::string_view new_path) {
+  void WasWritten(
+      std::string_view new_path,
+      std::optional<ColumnStats> stats = std::nullopt) {
     KATANA_LOG_ASSERT(state_ == State::kDirty);
     path_ = new_path;
     state_ = State::kClean;
+    stats_ = std::move(stats);
   }
 
   void WasUnloaded() {
     KATANA_LOG_ASSERT(state_ == State::kClean);
     state_ = State::kAbsent;
+    spilled_ = false;
+    partial_ = false;
+  }
+
+  void WasSpilled() {
+    KATANA_LOG_ASSERT(state_ != State::kAbsent);
+    spilled_ = true;
   }
 
+  void WasUsed() { last_use_ = NextPropertyUse(); }
+
+  bool IsSpilled() const { return spilled_; }
+
+  /// \returns true if the property in memory lacks rows of the stored one
+  /// because it was loaded with predicates (see PropertyPredicate). It is
+  /// clean, and its stored file rather than the column in memory is what a
+  /// store to another location must keep.
+  bool IsPartial() const { return partial_; }
+
+  /// \returns when the property was last used; see NextPropertyUse
+  uint64_t last_use() const { return last_use_; }
+
   bool IsAbsent() const { return state_ == State::kAbsent; }
 
   bool IsClean() const { return state_ == State::kClean; }
@@ -94,6 +138,9 @@ public:
   const std::string& name() const { return name_; }
   const std::string& path() const { return path_; }
   const std::shared_ptr<arrow::DataType>& type() const { return type_; }
+  /// Statistics recorded when the property was last written; unset for
+  /// properties written before statistics were recorded
+  const std::optional<ColumnStats>& stats() const { return stats_; }
 
   // since we don't have type info in the header don't know the
   // type when this would have been constructed. Allow others to
@@ -115,6 +162,31 @@ private:
   std::string path_;
   std::shared_ptr<arrow::DataType> type_;
   State state_;
+  std::optional<ColumnStats> stats_;
+  bool spilled_{false};
+  bool partial_{false};
+  uint64_t last_use_{0};
+};
+
+/// A file derived from the topology of a partition, e.g., a transposed or
+/// sorted copy, that can be rebuilt from the topology but is expensive to.
+/// It is only usable while the topology it was derived from is current.
+struct DerivedTopologyInfo {
+  std::string key;
+  std::string path;
+  /// topology_path() of the header when the file was written
+  std::string base_topology_path;
+};
+
+/// An index over a node or edge property, see katana::PropertyIndex. Like a
+/// derived topology, it can be rebuilt but is expensive to, and it is only
+/// usable while the property file it was built from is current.
+struct PropertyIndexInfo {
+  std::string property;
+  bool for_nodes{true};
+  std::string path;
+  /// path of the property file when the index was written
+  std::string base_property_path;
 };
 
 class KATANA_EXPORT RDGPartHeader {
@@ -253,10 +325,69 @@ public:
   const PartitionMetadata& metadata() const { return metadata_; }
   void set_metadata(const PartitionMetadata& metadata) { metadata_ = metadata; }
 
+  /// \returns the CRC32C of \param file_name, a file of this partition, if
+  /// it was recorded when the file was written
+  std::optional<uint32_t> checksum(const std::string& file_name) const {
+    auto it = checksums_.find(file_name);
+    if (it == checksums_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  /// \returns a copy of all recorded checksums (see
+  /// ParquetReader::ReadOpts::checksums)
+  std::shared_ptr<const std::map<std::string, uint32_t>> checksums() const {
+    return std::make_shared<const std::map<std::string, uint32_t>>(
+        checksums_);
+  }
+
+  /// Record \param checksums of newly written files and forget those of
+  /// files this header no longer refers to. The parts of a blocked file
+  /// (see ParquetWriter) count as referred to with the file.
+  void UpdateChecksums(
+      const std::unordered_map<std::string, uint32_t>& checksums);
+
+  const std::vector<DerivedTopologyInfo>& derived_topologies() const {
+    return derived_topologies_;
+  }
+
+  /// \returns the derived topology stored under \param key if it was
+  /// derived from the current topology, nullptr otherwise
+  const DerivedTopologyInfo* FindDerivedTopology(const std::string& key) const;
+
+  /// Record \param info, replacing any derived topology with the same key
+  void UpsertDerivedTopology(DerivedTopologyInfo info);
+
+  /// Forget derived topologies that were not derived from the current
+  /// topology
+  void PruneDerivedTopologies();
+
+  const std::vector<PropertyIndexInfo>& property_indexes() const {
+    return property_indexes_;
+  }
+
+  /// \returns the index of node property (if \param for_nodes) or edge
+  /// property \param name if it was built from the current property file,
+  /// nullptr otherwise
+  const PropertyIndexInfo* FindPropertyIndex(
+      bool for_nodes, const std::string& name) const;
+
+  /// Record \param info as built from the current file of its property,
+  /// replacing any index of the same property
+  void UpsertPropertyIndex(PropertyIndexInfo info);
+
+  /// Forget indexes that were not built from the current property files
+  void PrunePropertyIndexes();
+
   friend void to_json(nlohmann::json& j, const RDGPartHeader& header);
   friend void from_json(const nlohmann::json& j, RDGPartHeader& header);
 
 private:
+  /// \returns the file of node property (if \param for_nodes) or edge
+  /// property \param name, which is empty if it has not been stored
+  std::string PropertyPath(bool for_nodes, const std::string& name) const;
+
   static katana::Result<std::vector<PropStorageInfo*>> DoSelectProperties(
       std::vector<PropStorageInfo>* storage_info,
       const std::vector<std::string>& names) {
@@ -315,6 +446,13 @@ private:
   PartitionMetadata metadata_;
 
   std::string topology_path_;
+
+  /// CRC32C by file name; ordered so that headers serialize identically
+  std::map<std::string, uint32_t> checksums_;
+
+  std::vector<DerivedTopologyInfo> derived_topologies_;
+
+  std::vector<PropertyIndexInfo> property_indexes_;
 };
 
 void to_json(nlohmann::json& j, const RDGPartHeader& header);
@@ -326,6 +464,15 @@ void from_json(const nlohmann::json& j, PropStorageInfo& propmd);
 void to_json(nlohmann::json& j, const PartitionMetadata& propmd);
 void from_json(const nlohmann::json& j, PartitionMetadata& propmd);
 
+void to_json(nlohmann::json& j, const ColumnStats& stats);
+void from_json(const nlohmann::json& j, ColumnStats& stats);
+
+void to_json(nlohmann::json& j, const DerivedTopologyInfo& info);
+void from_json(const nlohmann::json& j, DerivedTopologyInfo& info);
+
+void to_json(nlohmann::json& j, const PropertyIndexInfo& info);
+void from_json(const nlohmann::json& j, PropertyIndexInfo& info);
+
 void to_json(
     nlohmann::json& j, const std::vector<tsuba::PropStorageInfo>& vec_pmd);
 
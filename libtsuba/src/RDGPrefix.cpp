@@ -1,5 +1,8 @@
 #include "tsuba/RDGPrefix.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "RDGHandleImpl.h"
 #include "RDGManifest.h"
 #include "RDGPartHeader.h"
@@ -52,4 +55,96 @@ RDGPrefix::Make(RDGHandle handle) {
   return DoMakePrefix(handle.impl_->rdg_manifest());
 }
 
+katana::Result<tsuba::RDGPrefix>
+RDGPrefix::Make(const std::string& rdg_name) {
+  RDGHandle handle = KATANA_CHECKED(Open(rdg_name, kReadOnly));
+  auto prefix_res = Make(handle);
+  if (auto res = Close(handle); !res) {
+    return res.error().WithContext("closing {}", rdg_name);
+  }
+  return prefix_res;
+}
+
+RDGPrefix::DegreeStats
+RDGPrefix::ComputeDegreeStats() const {
+  DegreeStats stats;
+  if (prefix_ == nullptr || num_nodes() == 0) {
+    return stats;
+  }
+
+  stats.min_degree = std::numeric_limits<uint64_t>::max();
+  for (uint64_t n = 0, num = num_nodes(); n < num; ++n) {
+    uint64_t d = degree(n);
+    stats.min_degree = std::min(stats.min_degree, d);
+    stats.max_degree = std::max(stats.max_degree, d);
+
+    size_t bucket = 0;
+    for (uint64_t v = d; v != 0; v >>= 1) {
+      ++bucket;
+    }
+    if (bucket >= stats.log2_histogram.size()) {
+      stats.log2_histogram.resize(bucket + 1, 0);
+    }
+    ++stats.log2_histogram[bucket];
+  }
+  stats.mean_degree = static_cast<double>(num_edges()) / num_nodes();
+  return stats;
+}
+
+RDGSlice::SliceArg
+RDGPrefix::MakeSliceArg(uint64_t first_node, uint64_t last_node) const {
+  uint64_t first_edge = edge_begin(first_node);
+  uint64_t last_edge = edge_begin(last_node);
+  return RDGSlice::SliceArg{
+      .node_range = {first_node, last_node},
+      .edge_range = {first_edge, last_edge},
+      .topo_off = view_offset_ + first_edge * sizeof(uint32_t),
+      .topo_size = (last_edge - first_edge) * sizeof(uint32_t),
+  };
+}
+
+katana::Result<std::vector<RDGSlice::SliceArg>>
+RDGPrefix::BalancedSlices(uint64_t num_slices) const {
+  if (num_slices == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "number of slices must be positive");
+  }
+  if (prefix_ == nullptr) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "graph has no topology");
+  }
+  if (version() == kCSRTopologyCompressedVersion) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "slices of compressed topologies are not supported");
+  }
+
+  // Each node and each edge count as one unit of work; the work before node
+  // n, n + edge_begin(n), is non-decreasing in n so each boundary can be
+  // found by binary search
+  uint64_t nodes = num_nodes();
+  uint64_t total = nodes + num_edges();
+
+  std::vector<RDGSlice::SliceArg> slices;
+  slices.reserve(num_slices);
+  uint64_t first_node = 0;
+  for (uint64_t i = 1; i <= num_slices; ++i) {
+    uint64_t target = total / num_slices * i +
+                      total % num_slices * i / num_slices;
+    uint64_t lo = first_node;
+    uint64_t hi = nodes;
+    while (lo < hi) {
+      uint64_t mid = lo + (hi - lo) / 2;
+      if (mid + edge_begin(mid) < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    uint64_t last_node = i == num_slices ? nodes : lo;
+    slices.emplace_back(MakeSliceArg(first_node, last_node));
+    first_node = last_node;
+  }
+  return slices;
+}
+
 }  // namespace tsuba
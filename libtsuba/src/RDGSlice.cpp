@@ -4,14 +4,22 @@
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
 #include "katana/Logging.h"
+#include "tsuba/CSRTopology.h"
 #include "tsuba/Errors.h"
+#include "tsuba/file.h"
 
 katana::Result<void>
 tsuba::RDGSlice::DoMake(
     const std::optional<std::vector<std::string>>& node_props,
     const std::optional<std::vector<std::string>>& edge_props,
-    const katana::Uri& metadata_dir, const SliceArg& slice) {
+    const katana::Uri& metadata_dir, const SliceArg& slice,
+    const PropertyPredicates& node_predicates,
+    const PropertyPredicates& edge_predicates) {
   ReadGroup grp;
+  auto node_read_opts = ParquetReader::ReadOpts::Defaults();
+  node_read_opts.predicates = node_predicates;
+  auto edge_read_opts = ParquetReader::ReadOpts::Defaults();
+  edge_read_opts.predicates = edge_predicates;
   katana::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
 
   if (auto res = core_->topology_file_storage().Bind(
@@ -21,6 +29,25 @@ tsuba::RDGSlice::DoMake(
     return res.error();
   }
 
+  // Slices are ranges of the uint32_t destinations of a version 1 file, so
+  // other layouts would be misread
+  FileView& topology = core_->topology_file_storage();
+  if (topology.size() < sizeof(CSRTopologyHeader)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology file {} is too small", t_path);
+  }
+  KATANA_CHECKED(topology.Fill(0, sizeof(CSRTopologyHeader), true));
+  uint64_t version = topology.ptr<CSRTopologyHeader>()->version;
+  if (version == kCSRTopologyCompressedVersion) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "slices of compressed topologies are not supported");
+  }
+  if (version != 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unknown topology version {}", version);
+  }
+
   // all of the properties
   std::vector<PropStorageInfo*> node_properties =
       KATANA_CHECKED(core_->part_header().SelectNodeProperties(node_props));
@@ -42,7 +69,8 @@ tsuba::RDGSlice::DoMake(
         }
         rdg->core_->set_node_properties(std::move(prop_table));
         return katana::ResultSuccess();
-      }));
+      },
+      node_read_opts));
 
   // all of the properties
   std::vector<PropStorageInfo*> edge_properties =
@@ -65,7 +93,8 @@ tsuba::RDGSlice::DoMake(
         }
         rdg->core_->set_edge_properties(std::move(prop_table));
         return katana::ResultSuccess();
-      });
+      },
+      edge_read_opts);
   if (!edge_result) {
     return edge_result.error();
   }
@@ -73,25 +102,35 @@ tsuba::RDGSlice::DoMake(
   return grp.Finish();
 }
 
-katana::Result<tsuba::RDGSlice>
-tsuba::RDGSlice::Make(
-    RDGHandle handle, const SliceArg& slice,
-    const std::optional<std::vector<std::string>>& node_props,
-    const std::optional<std::vector<std::string>>& edge_props) {
-  const RDGManifest& manifest = handle.impl_->rdg_manifest();
+namespace {
+
+katana::Result<tsuba::RDGPartHeader>
+MakeSinglePartHeader(const tsuba::RDGManifest& manifest) {
   if (manifest.num_hosts() != 1) {
     return KATANA_ERROR(
-        ErrorCode::NotImplemented,
+        tsuba::ErrorCode::NotImplemented,
         "cannot construct RDGSlice for partitioned graph");
   }
   katana::Uri partition_path(manifest.PartitionFileName(0));
 
-  auto part_header = KATANA_CHECKED(RDGPartHeader::Make(partition_path));
+  return tsuba::RDGPartHeader::Make(partition_path);
+}
+
+}  // namespace
 
-  RDGSlice rdg_slice(std::make_unique<RDGCore>(std::move(part_header)));
+katana::Result<tsuba::RDGSlice>
+tsuba::RDGSlice::Make(
+    const RDGPartHeader& part_header, const katana::Uri& metadata_dir,
+    const SliceArg& slice,
+    const std::optional<std::vector<std::string>>& node_props,
+    const std::optional<std::vector<std::string>>& edge_props,
+    const PropertyPredicates& node_predicates,
+    const PropertyPredicates& edge_predicates) {
+  RDGSlice rdg_slice(std::make_unique<RDGCore>(RDGPartHeader(part_header)));
 
-  if (auto res =
-          rdg_slice.DoMake(node_props, edge_props, manifest.dir(), slice);
+  if (auto res = rdg_slice.DoMake(
+          node_props, edge_props, metadata_dir, slice, node_predicates,
+          edge_predicates);
       !res) {
     return res.error();
   }
@@ -99,6 +138,24 @@ tsuba::RDGSlice::Make(
   return RDGSlice(std::move(rdg_slice));
 }
 
+katana::Result<tsuba::RDGSlice>
+tsuba::RDGSlice::Make(
+    RDGHandle handle, const SliceArg& slice,
+    const std::optional<std::vector<std::string>>& node_props,
+    const std::optional<std::vector<std::string>>& edge_props,
+    const PropertyPredicates& node_predicates,
+    const PropertyPredicates& edge_predicates) {
+  // the files of a manifest do not change; check their versions once
+  FileStatScope stat_scope;
+
+  const RDGManifest& manifest = handle.impl_->rdg_manifest();
+  auto part_header = KATANA_CHECKED(MakeSinglePartHeader(manifest));
+
+  return Make(
+      part_header, manifest.dir(), slice, node_props, edge_props,
+      node_predicates, edge_predicates);
+}
+
 const std::shared_ptr<arrow::Table>&
 tsuba::RDGSlice::node_properties() const {
   return core_->node_properties();
@@ -121,3 +178,74 @@ tsuba::RDGSlice::~RDGSlice() = default;
 tsuba::RDGSlice::RDGSlice(RDGSlice&& other) noexcept = default;
 tsuba::RDGSlice& tsuba::RDGSlice::operator=(RDGSlice&& other) noexcept =
     default;
+
+katana::Result<tsuba::RDGSliceStream>
+tsuba::RDGSliceStream::Make(
+    RDGHandle handle, std::vector<RDGSlice::SliceArg> slices,
+    const std::optional<std::vector<std::string>>& node_props,
+    const std::optional<std::vector<std::string>>& edge_props,
+    const PropertyPredicates& node_predicates,
+    const PropertyPredicates& edge_predicates) {
+  const RDGManifest& manifest = handle.impl_->rdg_manifest();
+
+  RDGSliceStream stream;
+  stream.part_header_ = std::make_shared<const RDGPartHeader>(
+      KATANA_CHECKED(MakeSinglePartHeader(manifest)));
+  stream.metadata_dir_ = manifest.dir();
+  stream.slices_ = std::move(slices);
+  stream.node_props_ = node_props;
+  stream.edge_props_ = edge_props;
+  stream.node_predicates_ = node_predicates;
+  stream.edge_predicates_ = edge_predicates;
+
+  stream.StartLoad();
+  return RDGSliceStream(std::move(stream));
+}
+
+void
+tsuba::RDGSliceStream::StartLoad() {
+  if (next_index_ >= slices_.size()) {
+    pending_.reset();
+    return;
+  }
+  // Capture copies rather than this so that the stream can be moved while
+  // the load is in flight
+  pending_ = std::async(
+      std::launch::async,
+      [part_header = part_header_, metadata_dir = metadata_dir_,
+       slice = slices_[next_index_], node_props = node_props_,
+       edge_props = edge_props_, node_predicates = node_predicates_,
+       edge_predicates = edge_predicates_]() -> katana::Result<RDGSlice> {
+        return RDGSlice::Make(
+            *part_header, metadata_dir, slice, node_props, edge_props,
+            node_predicates, edge_predicates);
+      });
+  ++next_index_;
+}
+
+katana::Result<const tsuba::RDGSlice*>
+tsuba::RDGSliceStream::Next() {
+  // The caller is done with the current slice; free it before the next load
+  // starts so that no more than two slices are ever held
+  current_.reset();
+  if (!pending_) {
+    return nullptr;
+  }
+
+  auto res = pending_->get();
+  pending_.reset();
+  if (!res) {
+    return res.error().WithContext(
+        "loading slice {} of {}", next_index_ - 1, slices_.size());
+  }
+  current_.emplace(std::move(res.value()));
+
+  StartLoad();
+  return &current_.value();
+}
+
+tsuba::RDGSliceStream::~RDGSliceStream() = default;
+tsuba::RDGSliceStream::RDGSliceStream(RDGSliceStream&& other) noexcept =
+    default;
+tsuba::RDGSliceStream& tsuba::RDGSliceStream::operator=(
+    RDGSliceStream&& other) noexcept = default;
@@ -1,5 +1,17 @@
 #include "tsuba/ReadGroup.h"
 
+#include <algorithm>
+#include <random>
+
+#include "katana/Random.h"
+#include "tsuba/Errors.h"
+
+tsuba::ReadGroup::~ReadGroup() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  queue_.clear();
+  idle_.wait(lock, [this]() { return outstanding_ops_ == 0; });
+}
+
 void
 tsuba::ReadGroup::AddOp(
     std::future<katana::CopyableResult<void>> future, std::string file,
@@ -11,3 +23,114 @@ katana::Result<void>
 tsuba::ReadGroup::Finish() {
   return async_op_group_.Finish();
 }
+
+void
+tsuba::ReadGroup::StartOp(
+    const std::function<katana::CopyableResult<void>()>& fn,
+    const std::string& file,
+    const std::function<katana::CopyableResult<void>()>& on_complete,
+    uint64_t accounted_size, Priority priority) {
+  if (max_outstanding_size_ == 0) {
+    accounted_size = 0;
+  }
+
+  auto promise = std::make_shared<std::promise<katana::CopyableResult<void>>>();
+  AddOp(promise->get_future(), file, on_complete);
+  Schedule(priority, accounted_size, [fn, promise]() {
+    promise->set_value(RunWithBackoff<void>(fn));
+  });
+}
+
+bool
+tsuba::ReadGroup::IsRetryable(const katana::CopyableErrorInfo& err) {
+  return err == ErrorCode::S3Error || err == ErrorCode::AzureError ||
+         err == ErrorCode::GSError;
+}
+
+std::chrono::milliseconds
+tsuba::ReadGroup::BackoffDelay(uint32_t attempt) {
+  int64_t ceiling = std::min<int64_t>(
+      kMaxBackoff.count(),
+      kInitialBackoff.count() << std::min<uint32_t>(attempt, 16));
+  // full jitter so that ops throttled together do not retry together
+  std::uniform_int_distribution<int64_t> dist(
+      kInitialBackoff.count(), ceiling);
+  return std::chrono::milliseconds(dist(katana::GetGenerator()));
+}
+
+std::vector<tsuba::ReadGroup::Task>
+tsuba::ReadGroup::AdmitLocked() {
+  std::vector<Task> admitted;
+  while (!queue_.empty()) {
+    Task& task = queue_.begin()->second;
+    // always admit at least one op so that a single large read can proceed;
+    // otherwise stop at the first op that does not fit so that lower
+    // priority ops cannot starve it
+    if (outstanding_ops_ > 0) {
+      if (max_outstanding_ops_ > 0 &&
+          outstanding_ops_ >= max_outstanding_ops_) {
+        break;
+      }
+      if (max_outstanding_size_ > 0 &&
+          outstanding_size_ + task.accounted_size > max_outstanding_size_) {
+        break;
+      }
+    }
+    outstanding_ops_ += 1;
+    outstanding_size_ += task.accounted_size;
+    admitted.emplace_back(std::move(task));
+    queue_.erase(queue_.begin());
+  }
+  return admitted;
+}
+
+void
+tsuba::ReadGroup::LaunchTasks(std::vector<Task> tasks) {
+  for (Task& task : tasks) {
+    std::thread([this, task = std::move(task)]() mutable {
+      RunTasks(std::move(task));
+    }).detach();
+  }
+}
+
+void
+tsuba::ReadGroup::Schedule(
+    Priority priority, uint64_t accounted_size, std::function<void()> run) {
+  std::vector<Task> admitted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.emplace(
+        std::make_pair(priority, next_seq_++),
+        Task{.accounted_size = accounted_size, .run = std::move(run)});
+    admitted = AdmitLocked();
+  }
+  LaunchTasks(std::move(admitted));
+}
+
+void
+tsuba::ReadGroup::RunTasks(Task task) {
+  for (;;) {
+    task.run();
+
+    std::vector<Task> admitted;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      outstanding_ops_ -= 1;
+      outstanding_size_ -= task.accounted_size;
+      admitted = AdmitLocked();
+      if (admitted.empty()) {
+        // notify under the lock; the destructor may run as soon as it is
+        // released
+        if (outstanding_ops_ == 0) {
+          idle_.notify_all();
+        }
+        return;
+      }
+    }
+
+    // continue with the first admitted task on this thread
+    task = std::move(admitted.front());
+    admitted.erase(admitted.begin());
+    LaunchTasks(std::move(admitted));
+  }
+}
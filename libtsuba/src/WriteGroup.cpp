@@ -1,6 +1,8 @@
 #include "tsuba/WriteGroup.h"
 
+#include "Checksum.h"
 #include "GlobalState.h"
+#include "katana/Env.h"
 #include "katana/Random.h"
 #include "katana/Result.h"
 
@@ -23,7 +25,9 @@ WriteGroup::Make() {
     tag = katana::RandomAlphanumericString(kTagLen);
   }
   tag = Comm()->Broadcast(0, tag, kTagLen);
-  return std::unique_ptr<WriteGroup>(new WriteGroup(tag));
+  bool checksums_enabled = false;
+  katana::GetEnv("KATANA_TSUBA_CHECKSUMS", &checksums_enabled);
+  return std::unique_ptr<WriteGroup>(new WriteGroup(tag, checksums_enabled));
 }
 
 Result<void>
@@ -47,6 +51,9 @@ WriteGroup::AddOp(
       }
     }
   }
+  while (async_op_group_.num_pending() >= kMaxOutstandingOps) {
+    async_op_group_.FinishOne();
+  }
   async_op_group_.AddOp(
       std::move(future), std::move(file),
       [wg = this, accounted_size]() -> katana::CopyableResult<void> {
@@ -55,6 +62,29 @@ WriteGroup::AddOp(
       });
 }
 
+void
+WriteGroup::RecordChecksum(const std::string& file, uint32_t crc32c) {
+  std::string name = file.substr(file.find_last_of('/') + 1);
+  std::lock_guard<std::mutex> lock(checksums_mutex_);
+  checksums_[name] = crc32c;
+}
+
+std::unordered_map<std::string, uint32_t>
+WriteGroup::checksums() const {
+  std::lock_guard<std::mutex> lock(checksums_mutex_);
+  return checksums_;
+}
+
+void
+WriteGroup::StartStore(
+    const std::string& file, const uint8_t* buf, uint64_t size) {
+  AddOp(FileStoreAsync(file, buf, size), file);
+  if (checksums_enabled_) {
+    // overlaps with the upload, which reads the same buffer
+    RecordChecksum(file, Crc32c(buf, size));
+  }
+}
+
 // shared pointer because FileFrames are often held that way due do the way
 // they're used with arrow
 void
@@ -63,9 +93,18 @@ WriteGroup::StartStore(std::shared_ptr<FileFrame> ff) {
   uint64_t size = ff->map_size();
 
   // wrap future to hold onto FileFrame, but free it as soon as possible
-  auto future = std::async(std::launch::async, [ff = std::move(ff)]() mutable {
-    return ff->PersistAsync().get();
-  });
+  auto future = std::async(
+      std::launch::async,
+      [wg = this, ff = std::move(ff)]() mutable
+      -> katana::CopyableResult<void> {
+        auto persist = ff->PersistAsync();
+        if (wg->checksums_enabled()) {
+          wg->RecordChecksum(
+              ff->path(),
+              Crc32c(KATANA_CHECKED(ff->ptr<uint8_t>()), ff->size()));
+        }
+        return persist.get();
+      });
   AddOp(std::move(future), file, size);
 }
 
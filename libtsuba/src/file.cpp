@@ -22,28 +22,86 @@
 
 katana::Result<void>
 tsuba::FileStore(const std::string& uri, const void* data, uint64_t size) {
-  return FS(uri)->PutMultiSync(uri, static_cast<const uint8_t*>(data), size);
+  FileStorage* fs = FS(uri);
+  if (!fs->IsLocal()) {
+    return fs->PutParallel(
+        uri, static_cast<const uint8_t*>(data), size, Transfer());
+  }
+  return fs->PutMultiSync(uri, static_cast<const uint8_t*>(data), size);
 }
 
 std::future<katana::CopyableResult<void>>
 tsuba::FileStoreAsync(const std::string& uri, const void* data, uint64_t size) {
-  return FS(uri)->PutAsync(uri, static_cast<const uint8_t*>(data), size);
+  FileStorage* fs = FS(uri);
+  if (const TransferOpts& opts = Transfer();
+      !fs->IsLocal() && size > opts.part_size) {
+    return std::async(
+        std::launch::async,
+        [=]() -> katana::CopyableResult<void> {
+          if (auto res = fs->PutParallel(
+                  uri, static_cast<const uint8_t*>(data), size, opts);
+              !res) {
+            return res.error();
+          }
+          return katana::CopyableResultSuccess();
+        });
+  }
+  return fs->PutAsync(uri, static_cast<const uint8_t*>(data), size);
 }
 
 katana::Result<void>
 tsuba::FileGet(
     const std::string& uri, void* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetMultiSync(
-      uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  FileStorage* fs = FS(uri);
+  if (fs->IsLocal()) {
+    return fs->GetMultiSync(
+        uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  }
+  if (FileCache* cache = Cache(); cache->enabled()) {
+    return cache->Get(
+        fs, uri, begin, size, static_cast<uint8_t*>(result_buffer), Transfer());
+  }
+  return fs->GetParallel(
+      uri, begin, size, static_cast<uint8_t*>(result_buffer), Transfer());
 }
 
 std::future<katana::CopyableResult<void>>
 tsuba::FileGetAsync(
     const std::string& uri, void* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetAsync(
-      uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  FileStorage* fs = FS(uri);
+  FileCache* cache = Cache();
+  const TransferOpts& opts = Transfer();
+  if (!fs->IsLocal() && (cache->enabled() || size > opts.part_size)) {
+    return std::async(
+        std::launch::async,
+        [=]() -> katana::CopyableResult<void> {
+          auto* buf = static_cast<uint8_t*>(result_buffer);
+          auto res = cache->enabled()
+                         ? cache->Get(fs, uri, begin, size, buf, opts)
+                         : fs->GetParallel(uri, begin, size, buf, opts);
+          if (!res) {
+            return res.error();
+          }
+          return katana::CopyableResultSuccess();
+        });
+  }
+  return fs->GetAsync(uri, begin, size, static_cast<uint8_t*>(result_buffer));
+}
+
+tsuba::FileCacheStats
+tsuba::GetFileCacheStats() {
+  return Cache()->stats();
+}
+
+tsuba::FileStatScope::FileStatScope() { Cache()->BeginStatScope(); }
+
+tsuba::FileStatScope::~FileStatScope() { Cache()->EndStatScope(); }
+
+katana::Result<uint8_t*>
+tsuba::FileMapReadOnly(const std::string& uri, uint64_t size) {
+  return FS(uri)->MapReadOnly(uri, size);
 }
 
 katana::Result<void>
@@ -1,5 +1,12 @@
 #include "tsuba/tsuba.h"
 
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <map>
+#include <set>
+#include <unordered_set>
+
 #include "GlobalState.h"
 #include "RDGHandleImpl.h"
 #include "katana/CommBackend.h"
@@ -99,6 +106,11 @@ tsuba::Close(RDGHandle handle) {
   return katana::ResultSuccess();
 }
 
+tsuba::RDGHandle
+tsuba::Duplicate(RDGHandle handle) {
+  return RDGHandle{.impl_ = new RDGHandleImpl(*handle.impl_)};
+}
+
 katana::Result<void>
 tsuba::Create(const std::string& name) {
   auto uri_res = katana::Uri::Make(name);
@@ -232,6 +244,171 @@ tsuba::ListAvailableViews(const std::string& rdg_dir) {
   return views_found;
 }
 
+namespace {
+
+/// Property files larger than a block are stored as "<name>.part_<n>"
+/// next to a file "<name>"; those belong to whoever refers to "<name>"
+std::string
+StoredName(const std::string& file) {
+  if (auto pos = file.rfind(".part_"); pos != std::string::npos) {
+    return file.substr(0, pos);
+  }
+  return file;
+}
+
+katana::Result<void>
+DeleteInBatches(
+    const std::string& dir, const std::vector<std::string>& files,
+    const tsuba::GarbageCollectOptions& opts) {
+  uint64_t batch_size = std::max<uint64_t>(opts.delete_batch_size, 1);
+  uint32_t max_parallel = std::max<uint32_t>(opts.max_parallel_batches, 1);
+
+  std::deque<std::future<katana::CopyableResult<void>>> in_flight;
+  katana::CopyableResult<void> ret = katana::CopyableResultSuccess();
+  auto wait_one = [&]() {
+    auto res = in_flight.front().get();
+    in_flight.pop_front();
+    if (!res && ret) {
+      ret = std::move(res);
+    }
+  };
+
+  for (uint64_t i = 0; i < files.size() && ret; i += batch_size) {
+    while (in_flight.size() >= max_parallel) {
+      wait_one();
+    }
+    // never pass an empty batch: FileDelete removes the directory then
+    std::unordered_set<std::string> batch(
+        files.begin() + i,
+        files.begin() + std::min<uint64_t>(i + batch_size, files.size()));
+    in_flight.emplace_back(std::async(
+        std::launch::async,
+        [&dir, batch = std::move(batch)]() -> katana::CopyableResult<void> {
+          if (auto res = tsuba::FileDelete(dir, batch); !res) {
+            return res.error();
+          }
+          return katana::CopyableResultSuccess();
+        }));
+  }
+  while (!in_flight.empty()) {
+    wait_one();
+  }
+
+  if (!ret) {
+    return ret.error();
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<tsuba::GarbageCollectStats>
+tsuba::CollectGarbage(
+    const std::string& rdg_dir, const GarbageCollectOptions& opts) {
+  if (opts.keep_versions == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "at least one version must be kept");
+  }
+  katana::Uri dir = KATANA_CHECKED(katana::Uri::Make(rdg_dir));
+  if (RDGManifest::IsManifestUri(dir)) {
+    dir = dir.DirName();
+  }
+
+  std::vector<std::string> files;
+  std::vector<uint64_t> sizes;
+  if (auto res = FileListAsync(dir.string(), &files, &sizes).get(); !res) {
+    return res.error().WithContext("listing {}", dir);
+  }
+
+  // view specifier -> version -> manifest file name
+  std::map<std::string, std::map<uint64_t, std::string>> manifests;
+  for (const std::string& file : files) {
+    auto version_res = RDGManifest::ParseVersionFromName(file);
+    auto view_res = RDGManifest::ParseViewNameFromName(file);
+    auto args_res = RDGManifest::ParseViewArgsFromName(file);
+    if (!version_res || !view_res || !args_res) {
+      continue;
+    }
+    std::string view = view_res.value();
+    for (const auto& arg : args_res.value()) {
+      view += "-" + arg;
+    }
+    manifests[view][version_res.value()] = file;
+  }
+
+  GarbageCollectStats stats;
+  std::set<std::string> retained;
+  std::set<std::string> garbage;
+  for (const auto& [view, versions] : manifests) {
+    // follow previous versions back from the newest
+    std::set<uint64_t> keep;
+    for (auto it = versions.rbegin(); it != versions.rend();) {
+      std::string manifest_file = it->second;
+      auto manifest = KATANA_CHECKED_CONTEXT(
+          RDGManifest::Make(dir.Join(manifest_file)), "reading retained {}",
+          manifest_file);
+      keep.emplace(it->first);
+      retained.emplace(manifest_file);
+      auto names = KATANA_CHECKED_CONTEXT(
+          manifest.FileNames(), "listing files of {}", manifest_file);
+      retained.insert(names.begin(), names.end());
+
+      uint64_t previous = manifest.previous_version();
+      if (keep.size() >= opts.keep_versions || previous >= it->first) {
+        break;
+      }
+      it = std::make_reverse_iterator(versions.upper_bound(previous));
+      if (it == versions.rend() || it->first != previous) {
+        break;
+      }
+    }
+
+    for (const auto& [version, manifest_file] : versions) {
+      if (keep.count(version) > 0) {
+        continue;
+      }
+      auto manifest_res = RDGManifest::Make(dir.Join(manifest_file));
+      if (!manifest_res) {
+        // without its manifest we cannot tell which files are its own
+        KATANA_LOG_WARN(
+            "keeping {}: {}", manifest_file, manifest_res.error());
+        continue;
+      }
+      auto names_res = manifest_res.value().FileNames();
+      if (!names_res) {
+        KATANA_LOG_WARN("keeping {}: {}", manifest_file, names_res.error());
+        continue;
+      }
+      garbage.emplace(manifest_file);
+      garbage.insert(names_res.value().begin(), names_res.value().end());
+      ++stats.versions_removed;
+    }
+    stats.versions_retained += keep.size();
+  }
+
+  std::vector<std::string> to_delete;
+  for (size_t i = 0; i < files.size(); ++i) {
+    const std::string& file = files[i];
+    std::string stored = StoredName(file);
+    if (retained.count(file) > 0 || retained.count(stored) > 0) {
+      continue;
+    }
+    if (garbage.count(file) == 0 && garbage.count(stored) == 0) {
+      continue;
+    }
+    to_delete.emplace_back(file);
+    stats.files_deleted += 1;
+    stats.bytes_deleted += i < sizes.size() ? sizes[i] : 0;
+  }
+
+  if (!opts.dry_run && !to_delete.empty()) {
+    KATANA_CHECKED_CONTEXT(
+        DeleteInBatches(dir.string(), to_delete, opts), "deleting from {}",
+        dir);
+  }
+  return stats;
+}
+
 katana::Uri
 tsuba::MakeTopologyFileName(tsuba::RDGHandle handle) {
   return GetRDGDir(handle).RandFile("topology");
@@ -242,6 +419,11 @@ tsuba::GetRDGDir(tsuba::RDGHandle handle) {
   return handle.impl_->rdg_manifest().dir();
 }
 
+uint64_t
+tsuba::GetRDGVersion(tsuba::RDGHandle handle) {
+  return handle.impl_->rdg_manifest().version();
+}
+
 katana::Result<void>
 tsuba::Init(katana::CommBackend* comm) {
   katana::InitSignalHandlers();
@@ -61,14 +61,34 @@ static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
         clEnumValN(
             BetweennessCentralityPlan::kLevel, "Level",
             "Level parallel algorithm"),
-        // clEnumValN(BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
+        clEnumValN(
+            BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(
             BetweennessCentralityPlan::kOuter, "Outer",
-            "Outer parallel algorithm")
+            "Outer parallel algorithm"),
+        clEnumValN(
+            BetweennessCentralityPlan::kApproximate, "Approximate",
+            "Sample shortest paths between random pairs of nodes")
         // clEnumValN(BetweennessCentralityPlan::kAutoAlgo, "Auto", "Auto: choose among the algorithms automatically")
         ),
     cll::init(BetweennessCentralityPlan::kLevel));
 
+static cll::opt<double> error_bound(
+    "errorBound",
+    cll::desc("Largest error of a normalized centrality for the Approximate "
+              "algorithm (default 0.01)"),
+    cll::init(BetweennessCentralityPlan::kDefaultErrorBound));
+static cll::opt<double> confidence(
+    "confidence",
+    cll::desc("Probability that every centrality of the Approximate "
+              "algorithm is within -errorBound (default 0.9)"),
+    cll::init(BetweennessCentralityPlan::kDefaultConfidence));
+static cll::opt<uint32_t> concurrent_sources(
+    "concurrentSources",
+    cll::desc("Number of sources the Async algorithm processes at once "
+              "(default 4)"),
+    cll::init(BetweennessCentralityPlan::kDefaultConcurrentSources));
+
 static cll::opt<bool> thread_spin(
     "threadSpin",
     cll::desc("If enabled, threads busy-wait for work rather than use "
@@ -102,6 +122,11 @@ main(int argc, char** argv) {
 
   BetweennessCentralityPlan plan =
       BetweennessCentralityPlan::FromAlgorithm(algo);
+  if (algo == BetweennessCentralityPlan::kApproximate) {
+    plan = BetweennessCentralityPlan::Approximate(error_bound, confidence);
+  } else if (algo == BetweennessCentralityPlan::kAsynchronous) {
+    plan = BetweennessCentralityPlan::Asynchronous(concurrent_sources);
+  }
 
   BetweennessCentralitySources sources = kBetweennessCentralityAllNodes;
   uint32_t num_sources = pg->num_nodes();
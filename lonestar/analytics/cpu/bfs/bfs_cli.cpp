@@ -70,6 +70,13 @@ static cll::opt<unsigned int> beta(
     "beta", cll::desc("Beta for direction optimization (default value: 18)"),
     cll::init(18));
 
+static cll::opt<unsigned int> batchSize(
+    "batchSize",
+    cll::desc("If 64, 256 or 512, compute the levels from all sources with "
+              "multi-source BFS in batches of this many sources (default "
+              "value 0: one BFS per source)"),
+    cll::init(0));
+
 static cll::opt<bool> thread_spin(
     "threadSpin",
     cll::desc("If enabled, threads busy-wait for rather than use "
@@ -82,7 +89,10 @@ static cll::opt<BfsPlan::Algorithm> algo(
         clEnumValN(BfsPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(
             BfsPlan::kSynchronousDirectOpt, "SyncDO",
-            "Synchronous direction optimization")),
+            "Synchronous direction optimization"),
+        clEnumValN(
+            BfsPlan::kAutomatic, "Automatic",
+            "Automatic: choose among the algorithms from the graph")),
     cll::init(BfsPlan::kSynchronousDirectOpt));
 
 std::string
@@ -98,11 +108,31 @@ AlgorithmName(BfsPlan::Algorithm algorithm) {
     return "Sync";
   case BfsPlan::kSynchronousDirectOpt:
     return "SyncDO";
+  case BfsPlan::kAutomatic:
+    return "Automatic";
   default:
     return "Unknown";
   }
 }
 
+void
+RunBatched(katana::PropertyGraph* pg, const std::vector<uint32_t>& startNodes) {
+  std::string node_level_prop = "levels";
+  auto plan = MultiSourceBfsPlan::Batched(batchSize, alpha);
+  if (auto r = MultiSourceBfs(pg, startNodes, node_level_prop, plan); !r) {
+    KATANA_LOG_FATAL("Failed to run multi-source bfs {}", r.error());
+  }
+
+  if (!skipVerify) {
+    if (auto res = MultiSourceBfsAssertValid(pg, startNodes, node_level_prop);
+        res) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed: {}", res.error());
+    }
+  }
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -125,6 +155,10 @@ main(int argc, char** argv) {
     plan = BfsPlan::SynchronousDirectOpt(alpha, beta);
     break;
   }
+  case BfsPlan::kAutomatic: {
+    plan = BfsPlan::Automatic();
+    break;
+  }
   default:
     KATANA_LOG_FATAL("Unsupported algorithm: {}", algo.getValue());
   }
@@ -160,6 +194,12 @@ main(int argc, char** argv) {
   uint32_t num_sources = startNodes.size();
   std::cout << "Running BFS for " << num_sources << " sources\n";
 
+  if (batchSize > 0) {
+    RunBatched(pg.get(), startNodes);
+    totalTime.stop();
+    return 0;
+  }
+
   for (auto start_node : startNodes) {
     if (start_node >= pg->topology().num_nodes()) {
       KATANA_LOG_FATAL("failed to set source: {}", start_node);
@@ -22,6 +22,8 @@
 #include "Helper.h"
 #include "Lonestar/BoilerPlate.h"
 #include "katana/PageAlloc.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/partition/partition.h"
 
 namespace cll = llvm::cl;
 
@@ -74,6 +76,14 @@ static cll::opt<bool> hyper_metis_graph(
         "(http://glaros.dtc.umn.edu/gkhome/fetch/sw/hmetis/manual.pdf)"),
     cll::init(false));
 
+static cll::opt<bool> kway(
+    "kway",
+    cll::desc("Partition into num_partitions parts at once with multilevel "
+              "k-way refinement instead of by recursive bisection; "
+              "max_coarse_graph_size is then the size of the coarsest graph "
+              "per partition (default false)"),
+    cll::init(false));
+
 static cll::opt<bool> skip_lone_hedges(
     "skip_lone_hedges",
     cll::desc("Specify if degree 1 hyperedges should not be included"),
@@ -564,6 +574,63 @@ CreateKPartitions(MetisGraph* metis_graph) {
       "BiPart", "Partitions", static_cast<uint32_t>(num_partitions));
 }
 
+/**
+ * Create k partitions directly, coarsening the graph once for all of them,
+ * with the multilevel k-way hypergraph partitioning of the analytics library
+ *
+ * @param metis_graph Metis graph representing the original input graph
+ */
+void
+CreateKWayPartitions(MetisGraph* metis_graph) {
+  HyperGraph* graph = &metis_graph->graph;
+  uint32_t total_num_nodes = graph->size();
+  uint32_t num_hedges = graph->GetHedges();
+
+  // The hypergraph is already stored as hyperedges with edges to their pins
+  katana::NUMAArray<katana::GraphTopology::Edge> adj_indices;
+  katana::NUMAArray<katana::GraphTopology::Node> dests;
+  adj_indices.allocateInterleaved(total_num_nodes);
+  dests.allocateInterleaved(graph->sizeEdges());
+  katana::do_all(
+      katana::iterate(uint32_t{0}, total_num_nodes),
+      [&](GNode n) {
+        adj_indices[n] = *graph->edge_end(n);
+        for (auto e : graph->edges(n)) {
+          dests[*e] = graph->getEdgeDst(e);
+        }
+      },
+      katana::steal(), katana::loopname("Build-Topology"));
+
+  auto pg_result = katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(adj_indices), std::move(dests)));
+  if (!pg_result) {
+    KATANA_LOG_FATAL("making the graph: {}", pg_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_result.value());
+
+  auto plan = katana::analytics::PartitionPlan::Multilevel(
+      max_coarse_graph_size);
+  auto partition_result = katana::analytics::PartitionHypergraph(
+      pg.get(), num_hedges, num_partitions, "partition", plan);
+  if (!partition_result) {
+    KATANA_LOG_FATAL("partitioning: {}", partition_result.error());
+  }
+
+  auto parts_result = pg->GetNodePropertyTyped<uint32_t>("partition");
+  if (!parts_result) {
+    KATANA_LOG_FATAL("reading partitions: {}", parts_result.error());
+  }
+  auto parts = parts_result.value();
+  katana::do_all(
+      katana::iterate(uint32_t{0}, total_num_nodes),
+      [&](GNode n) { graph->getData(n).partition = parts->Value(n); },
+      katana::loopname("Assign-Partition"));
+
+  katana::ReportStatSingle("BiPart", "Edge-Cut", ComputingCut(graph));
+  katana::ReportStatSingle(
+      "BiPart", "Partitions", static_cast<uint32_t>(num_partitions));
+}
+
 /**
  * Main Function
  */
@@ -597,7 +664,11 @@ main(int argc, char** argv) {
   katana::ReportPageAllocGuard page_alloc;
 
   create_partition_time.start();
-  CreateKPartitions(&metis_graph);
+  if (kway) {
+    CreateKWayPartitions(&metis_graph);
+  } else {
+    CreateKPartitions(&metis_graph);
+  }
   create_partition_time.stop();
 
   page_alloc.Report();
@@ -68,7 +68,10 @@ static cll::opt<ConnectedComponentsPlan::Algorithm> algo(
             "Afforest (edge-wise) sampling algorithm"),
         clEnumValN(
             ConnectedComponentsPlan::kEdgeTiledAfforest, "EdgeTiledAfforest",
-            "Afforest (tiled edge-wise) sampling algorithm")),
+            "Afforest (tiled edge-wise) sampling algorithm"),
+        clEnumValN(
+            ConnectedComponentsPlan::kAutomatic, "Automatic",
+            "Automatic: choose among the algorithms from the graph")),
     cll::init(ConnectedComponentsPlan::kAfforest));
 
 static cll::opt<uint32_t> edgeTileSize(
@@ -91,6 +94,37 @@ static cll::opt<uint32_t> componentSampleFrequency(
               "capture the largest intermediate component "
               "(default 1024)"),
     cll::init(1024));
+static cll::opt<uint32_t> streamBatches(
+    "streamBatches",
+    cll::desc("If nonzero, also feed the edges in this many batches to "
+              "IncrementalConnectedComponents and check that it finds the "
+              "same number of components (default 0)"),
+    cll::init(0));
+
+/// Feed the edges of pg to an IncrementalConnectedComponents in num_batches
+/// batches by source node
+static uint64_t
+StreamComponents(const katana::PropertyGraph& pg, uint32_t num_batches) {
+  katana::StatTimer timer("StreamComponents");
+  IncrementalConnectedComponents incremental(pg.num_nodes());
+  uint64_t num_nodes = pg.num_nodes();
+  std::vector<std::pair<uint32_t, uint32_t>> batch;
+  for (uint32_t b = 0; b < num_batches; ++b) {
+    batch.clear();
+    for (uint64_t n = num_nodes * b / num_batches;
+         n < num_nodes * (b + 1) / num_batches; ++n) {
+      for (auto e : pg.edges(n)) {
+        batch.emplace_back(n, pg.topology().edge_dest(e));
+      }
+    }
+    timer.start();
+    if (auto r = incremental.AddEdges(batch); !r) {
+      KATANA_LOG_FATAL("Failed to add a batch of edges: {}", r.error());
+    }
+    timer.stop();
+  }
+  return incremental.num_components();
+}
 
 std::string
 AlgorithmName(ConnectedComponentsPlan::Algorithm algorithm) {
@@ -115,6 +149,8 @@ AlgorithmName(ConnectedComponentsPlan::Algorithm algorithm) {
     return "EdgeAfforest";
   case ConnectedComponentsPlan::kEdgeTiledAfforest:
     return "EdgeTiledAfforest";
+  case ConnectedComponentsPlan::kAutomatic:
+    return "Automatic";
   default:
     return "Unknown";
   }
@@ -199,6 +235,9 @@ main(int argc, char** argv) {
     plan = ConnectedComponentsPlan::EdgeTiledAfforest(
         neighborSampleSize, componentSampleFrequency);
     break;
+  case ConnectedComponentsPlan::kAutomatic:
+    plan = ConnectedComponentsPlan::Automatic();
+    break;
   default:
     std::cerr << "Invalid algorithm\n";
     abort();
@@ -228,6 +267,17 @@ main(int argc, char** argv) {
     }
   }
 
+  if (streamBatches > 0) {
+    uint64_t num_components = StreamComponents(*pg, streamBatches);
+    std::cout << "Components found from " << streamBatches
+              << " batches = " << num_components << "\n";
+    if (!skipVerify && num_components != stats.total_components) {
+      KATANA_LOG_FATAL(
+          "streamed components {} differ from {}", num_components,
+          stats.total_components);
+    }
+  }
+
   if (output) {
     auto r = pg->GetNodePropertyTyped<uint64_t>("component");
     if (!r) {
@@ -0,0 +1,302 @@
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/JSON.h"
+#include "katana/Time.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "GAP Benchmark Suite";
+
+static const char* desc =
+    "Runs BFS, SSSP, CC, PageRank, TC and BC on an input at several thread "
+    "counts and reports load time, run time, memory high-water mark and "
+    "edges per second as JSON";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<std::string> symmetricInputFile(
+    "symmetricInput",
+    cll::desc("Symmetric graph without self loops or duplicate edges used for "
+              "cc and tc (default value: the input)"),
+    cll::init(""));
+
+static cll::opt<std::string> transposeInputFile(
+    "transposeInput",
+    cll::desc("Transpose of the input; if set, pr runs the pull algorithm on "
+              "it, otherwise the push algorithm on the input"),
+    cll::init(""));
+
+static cll::opt<std::string> graphName(
+    "graphName",
+    cll::desc("Name of the input in the report (default value: the input)"),
+    cll::init(""));
+
+static cll::list<std::string> algos(
+    "algos", cll::desc("Algorithms to run: bfs, sssp, cc, pr, tc, bc (default "
+                       "value: all)"),
+    cll::CommaSeparated);
+
+static cll::list<int> threadCounts(
+    "threadCounts",
+    cll::desc("Thread counts to run at (default value: powers of two up to "
+              "-t)"),
+    cll::CommaSeparated);
+
+static cll::opt<unsigned int> trials(
+    "trials", cll::desc("Runs of each algorithm per thread count (default "
+                        "value 3)"),
+    cll::init(3));
+
+static cll::opt<uint32_t> startNode(
+    "startNode", cll::desc("Source of bfs and sssp (default value 0)"),
+    cll::init(0));
+
+static cll::opt<unsigned int> ssspDelta(
+    "delta",
+    cll::desc("Shift value for delta stepping in sssp; 0 picks the delta "
+              "adaptively (default value 0)"),
+    cll::init(0));
+
+static cll::opt<uint32_t> bcSources(
+    "bcSources",
+    cll::desc("Number of sources for bc (default value 4)"), cll::init(4));
+
+static cll::opt<std::string> jsonFile(
+    "json",
+    cll::desc("File to write the report to (default value: standard output)"),
+    cll::init(""));
+
+namespace {
+
+const std::vector<std::string> kAllAlgos = {"bfs", "sssp", "cc",
+                                            "pr",  "tc",   "bc"};
+
+/// \returns the largest resident set size of the process so far in bytes
+uint64_t
+MaxRSSBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  return usage.ru_maxrss * 1024;
+#endif
+}
+
+struct LoadedGraph {
+  std::unique_ptr<katana::PropertyGraph> pg;
+  uint64_t load_us{0};
+};
+
+LoadedGraph
+Load(const std::string& path, const std::string& edge_property) {
+  std::cout << "Reading from file: " << path << "\n";
+  LoadedGraph loaded;
+  katana::TimePoint start = katana::Now();
+  loaded.pg = MakeFileGraph(path, edge_property);
+  loaded.load_us = katana::UsSince(start);
+  std::cout << "Read " << loaded.pg->topology().num_nodes() << " nodes, "
+            << loaded.pg->topology().num_edges() << " edges\n";
+  return loaded;
+}
+
+/// Runs one trial of an algorithm and removes its output, so that every
+/// trial starts from the same graph
+using Trial = std::function<katana::Result<void>()>;
+
+nlohmann::json
+RunTrials(
+    const std::string& algo, int threads, const LoadedGraph& graph,
+    const Trial& trial) {
+  std::vector<uint64_t> times_us;
+  for (unsigned int i = 0; i < trials; ++i) {
+    katana::TimePoint start = katana::Now();
+    if (auto res = trial(); !res) {
+      KATANA_LOG_FATAL("{} failed: {}", algo, res.error());
+    }
+    times_us.emplace_back(katana::UsSince(start));
+  }
+
+  std::vector<uint64_t> sorted = times_us;
+  std::sort(sorted.begin(), sorted.end());
+  uint64_t median_us = sorted.empty() ? 0 : sorted[sorted.size() / 2];
+  uint64_t num_edges = graph.pg->topology().num_edges();
+
+  nlohmann::json run = {
+      {"algorithm", algo},
+      {"threads", threads},
+      {"num_nodes", graph.pg->topology().num_nodes()},
+      {"num_edges", num_edges},
+      {"load_time_us", graph.load_us},
+      {"run_times_us", times_us},
+      {"median_run_time_us", median_us},
+      {"max_rss_bytes", MaxRSSBytes()},
+      {"edges_per_sec",
+       median_us == 0 ? 0.0 : num_edges * 1e6 / static_cast<double>(median_us)},
+  };
+  std::cout << algo << " threads=" << threads << " median "
+            << katana::UsToStr("{:.2f}{}", median_us) << "\n";
+  return run;
+}
+
+Trial
+MakeTrial(
+    const std::string& algo, katana::PropertyGraph* pg,
+    const std::string& edge_property, bool pull) {
+  const std::string output = "gap-output";
+  auto remove_output = [pg, output](katana::Result<void> res) {
+    if (!res) {
+      return res;
+    }
+    return pg->RemoveNodeProperty(output);
+  };
+
+  if (algo == "bfs") {
+    return [=] { return remove_output(Bfs(pg, startNode, output)); };
+  }
+  if (algo == "sssp") {
+    SsspPlan plan = ssspDelta > 0 ? SsspPlan::DeltaStep(ssspDelta)
+                                  : SsspPlan::DeltaStepAdaptive();
+    return [=] {
+      return remove_output(Sssp(pg, startNode, edge_property, output, plan));
+    };
+  }
+  if (algo == "cc") {
+    return [=] { return remove_output(ConnectedComponents(pg, output)); };
+  }
+  if (algo == "pr") {
+    PagerankPlan plan =
+        pull ? PagerankPlan::PullResidual() : PagerankPlan::PushAsynchronous();
+    return [=] { return remove_output(Pagerank(pg, output, plan)); };
+  }
+  if (algo == "tc") {
+    return [=]() -> katana::Result<void> {
+      auto res = TriangleCount(pg);
+      if (!res) {
+        return res.error();
+      }
+      return katana::ResultSuccess();
+    };
+  }
+  if (algo == "bc") {
+    BetweennessCentralitySources sources = bcSources.getValue();
+    return [=] {
+      return remove_output(BetweennessCentrality(pg, output, sources));
+    };
+  }
+  KATANA_LOG_FATAL("unknown algorithm: {}", algo);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, nullptr, &inputFile);
+
+  std::vector<std::string> to_run(algos.begin(), algos.end());
+  if (to_run.empty()) {
+    to_run = kAllAlgos;
+  }
+  for (const auto& algo : to_run) {
+    if (std::find(kAllAlgos.begin(), kAllAlgos.end(), algo) ==
+        kAllAlgos.end()) {
+      KATANA_LOG_FATAL("unknown algorithm: {}", algo);
+    }
+  }
+
+  std::vector<int> threads(threadCounts.begin(), threadCounts.end());
+  if (threads.empty()) {
+    for (int t = 1; t < numThreads; t *= 2) {
+      threads.emplace_back(t);
+    }
+    threads.emplace_back(numThreads);
+  }
+
+  auto needs = [&](std::initializer_list<const char*> names) {
+    return std::any_of(names.begin(), names.end(), [&](const char* n) {
+      return std::find(to_run.begin(), to_run.end(), n) != to_run.end();
+    });
+  };
+
+  // Load each variant of the input once; the loads are timed separately
+  LoadedGraph input = Load(inputFile, edge_property_name);
+  LoadedGraph symmetric;
+  if (!symmetricInputFile.empty() && needs({"cc", "tc"})) {
+    symmetric = Load(symmetricInputFile, "");
+  }
+  LoadedGraph transpose;
+  if (!transposeInputFile.empty() && needs({"pr"})) {
+    transpose = Load(transposeInputFile, "");
+  }
+
+  if (startNode >= input.pg->topology().num_nodes()) {
+    KATANA_LOG_FATAL("failed to set source: {}", startNode);
+  }
+  if (needs({"sssp"}) && edge_property_name.empty()) {
+    KATANA_LOG_FATAL("sssp requires -edgePropertyName");
+  }
+
+  nlohmann::json runs = nlohmann::json::array();
+  for (int t : threads) {
+    int actual = katana::setActiveThreads(t);
+    for (const auto& algo : to_run) {
+      const LoadedGraph* graph = &input;
+      if ((algo == "cc" || algo == "tc") && symmetric.pg) {
+        graph = &symmetric;
+      }
+      bool pull = algo == "pr" && transpose.pg;
+      if (pull) {
+        graph = &transpose;
+      }
+      Trial trial = MakeTrial(algo, graph->pg.get(), edge_property_name, pull);
+      runs.emplace_back(RunTrials(algo, actual, *graph, trial));
+    }
+  }
+
+  nlohmann::json report = {
+      {"graph", graphName.empty() ? inputFile.getValue() : graphName},
+      {"input", inputFile.getValue()},
+      {"version", katana::getVersion()},
+      {"revision", katana::getRevision()},
+      {"trials", trials.getValue()},
+      {"runs", runs},
+  };
+
+  auto json_res = katana::JsonDump(report);
+  if (!json_res) {
+    KATANA_LOG_FATAL("failed to format report: {}", json_res.error());
+  }
+  if (jsonFile.empty()) {
+    std::cout << json_res.value() << "\n";
+  } else {
+    std::ofstream out(jsonFile);
+    out << json_res.value() << "\n";
+    if (!out) {
+      KATANA_LOG_FATAL("failed to write file: {}", jsonFile);
+    }
+  }
+
+  return 0;
+}
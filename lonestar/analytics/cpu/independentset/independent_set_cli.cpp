@@ -49,18 +49,16 @@ cll::opt<IndependentSetPlan::Algorithm> algo(
         clEnumValN(
             IndependentSetPlan::kPull, "Pull",
             "Pull-based (node 0 is initially in the independent set)"),
-        //        clEnumValN(
-        //            IndependentSetPlan::kNondeterministic, "Nondeterministic",
-        //            "Non-deterministic, use bulk synchronous worklist"),
-        //        clEnumValN(
-        //            IndependentSetPlan::kDeterministicBase, "DeterministicBase",
-        //            "use deterministic worklist"),
         clEnumValN(
             IndependentSetPlan::kPriority, "Priority",
             "prio algo based on Martin's GPU ECL-MIS algorithm (default)"),
         clEnumValN(
             IndependentSetPlan::kEdgeTiledPriority, "EdgeTiledPriority",
-            "edge-tiled prio algo based on Martin's GPU ECL-MIS algorithm")),
+            "edge-tiled prio algo based on Martin's GPU ECL-MIS algorithm"),
+        clEnumValN(
+            IndependentSetPlan::kDeterministicPriority,
+            "DeterministicPriority",
+            "prio algo whose result does not depend on the threads")),
     cll::init(IndependentSetPlan::kPriority));
 
 }  // namespace
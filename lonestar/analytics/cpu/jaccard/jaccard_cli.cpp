@@ -44,6 +44,16 @@ static cll::opt<unsigned int> report_node(
     "reportNode",
     cll::desc("Node to report the similarity of (default value 1)"),
     cll::init(1));
+static cll::opt<unsigned int> top_k(
+    "topK",
+    cll::desc("Find the topK most similar nodes of every node instead of the "
+              "similarities to baseNode (default value 0, off)"),
+    cll::init(0));
+static cll::opt<bool> min_hash(
+    "minHash",
+    cll::desc("Estimate the topK similarities from MinHash signatures "
+              "(default false)"),
+    cll::init(false));
 
 using NodeValue = katana::PODProperty<double>;
 
@@ -76,6 +86,21 @@ main(int argc, char** argv) {
     abort();
   }
 
+  if (top_k > 0) {
+    auto plan = min_hash ? katana::analytics::JaccardPlan::MinHash()
+                         : katana::analytics::JaccardPlan();
+    auto r = katana::analytics::JaccardTopK(pg.get(), top_k, plan);
+    if (!r) {
+      KATANA_LOG_FATAL("JaccardTopK failed: {}", r.error());
+    }
+    std::cout << "Most similar nodes to node " << report_node << ":\n";
+    for (const auto& [node, similarity] : r.value()[report_node]) {
+      std::cout << "  " << node << " " << similarity << "\n";
+    }
+    totalTime.stop();
+    return 0;
+  }
+
   if (auto r = katana::analytics::Jaccard(
           pg.get(), base_node, output_property_name,
           katana::analytics::JaccardPlan());
@@ -58,6 +58,37 @@ static cll::opt<uint32_t> kCoreNumber(
               "kCoreNumber value (default value 10)"),
     cll::init(10));
 
+static cll::opt<bool> decomposition(
+    "decomposition",
+    cll::desc("Compute the core number of every node instead of the "
+              "kCoreNumber core (default false)"),
+    cll::init(false));
+
+//! Computes and prints the core numbers instead of a single core.
+void
+RunDecomposition(katana::PropertyGraph* pg) {
+  std::cout << "Running bucketed peeling\n";
+  if (auto r = KCoreDecomposition(pg, "core-number"); !r) {
+    KATANA_LOG_FATAL("Failed to compute core numbers: {}", r.error());
+  }
+
+  auto stats_result = KCoreDecompositionStatistics::Compute(pg, "core-number");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute core number statistics: {}", stats_result.error());
+  }
+  stats_result.value().Print();
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint32_t>("core-number");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+}
+
 std::string
 AlgorithmName(KCorePlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -92,6 +123,12 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
+  if (decomposition) {
+    RunDecomposition(pg.get());
+    total_timer.stop();
+    return 0;
+  }
+
   std::cout << "Running " << AlgorithmName(algo) << "\n";
 
   KCorePlan plan = KCorePlan();
@@ -24,6 +24,7 @@
 #include "katana/AtomicHelpers.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
 
 using namespace katana::analytics;
 
@@ -71,6 +72,19 @@ static cll::opt<AlgoReachability> algoReachability(
     cll::values(clEnumVal(async, "async"), clEnumVal(syncLevel, "syncLevel")),
     cll::init(syncLevel));
 
+enum QueryPlan { noQuery = 0, yen, labelSetting };
+
+static cll::opt<QueryPlan> queryPlan(
+    "queryPlan",
+    cll::desc("Also answer the query with KShortestPathsQuery of the "
+              "analytics library and check that it finds the same shortest "
+              "weight:"),
+    cll::values(
+        clEnumVal(noQuery, "Do not"),
+        clEnumVal(yen, "Yen's algorithm, simple paths only"),
+        clEnumVal(labelSetting, "Label setting, paths may repeat nodes")),
+    cll::init(noQuery));
+
 struct Path {
   uint32_t parent;
   const Path* last{nullptr};
@@ -434,6 +448,24 @@ main(int argc, char** argv) {
       it_report++;
     }
 
+    if (queryPlan != noQuery) {
+      auto query_paths = KShortestPaths(
+          pg.get(), startNode, reportNode, numPaths, edge_property_name,
+          queryPlan == yen ? KShortestPathsPlan::Yen()
+                           : KShortestPathsPlan::LabelSetting());
+      if (!query_paths) {
+        KATANA_LOG_FATAL("k shortest paths query: {}", query_paths.error());
+      }
+      for (const auto& path : query_paths.value()) {
+        katana::gPrint("Query weight: ", path.weight, "\n");
+      }
+      if (!skipVerify && !paths_map.empty() &&
+          (query_paths.value().empty() ||
+           query_paths.value()[0].weight != paths_map.begin()->first)) {
+        KATANA_LOG_FATAL("the query does not find the shortest weight");
+      }
+    }
+
     katana::do_all(katana::iterate(path_pointers), [&](Path* p) {
       path_alloc.DeletePath(p);
     });
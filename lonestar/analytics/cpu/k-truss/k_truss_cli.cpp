@@ -53,6 +53,37 @@ static cll::opt<KTrussPlan::Algorithm> algo(
             "Compute k-1 core and then k-truss")),
     cll::init(KTrussPlan::kBsp));
 
+static cll::opt<bool> decomposition(
+    "decomposition",
+    cll::desc("Compute the trussness of every edge instead of the "
+              "kTrussNumber truss (default false)"),
+    cll::init(false));
+
+//! Computes and prints the trussness of every edge instead of a single truss.
+void
+RunDecomposition(katana::PropertyGraph* pg) {
+  std::cout << "Running bucketed edge peeling\n";
+  if (auto r = KTrussDecomposition(pg, "trussness"); !r) {
+    KATANA_LOG_FATAL("Failed to compute trussness: {}", r.error());
+  }
+
+  auto stats_result = KTrussDecompositionStatistics::Compute(pg, "trussness");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute trussness statistics: {}", stats_result.error());
+  }
+  stats_result.value().Print();
+
+  if (output) {
+    auto r = pg->GetEdgePropertyTyped<uint32_t>("trussness");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get edge property {}", r.error());
+    }
+    auto results = r.value();
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+}
+
 std::string
 AlgorithmName(KTrussPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -93,6 +124,12 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
+  if (decomposition) {
+    RunDecomposition(pg.get());
+    total_timer.stop();
+    return 0;
+  }
+
   std::cout << "Running " << AlgorithmName(algo) << "\n";
 
   KTrussPlan plan = KTrussPlan();
@@ -59,6 +59,11 @@ static cll::opt<uint32_t> min_graph_size(
     "min_graph_size", cll::desc("Minimum coarsened graph size"),
     cll::init(100));
 
+static cll::opt<bool> enable_refinement(
+    "enable_refinement",
+    cll::desc("Flag to refine the clusters before coarsening, as in Leiden."),
+    cll::init(false));
+
 static cll::opt<LouvainClusteringPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm (default value DoAll):"),
     cll::values(
@@ -111,12 +116,12 @@ main(int argc, char** argv) {
   case LouvainClusteringPlan::kDoAll:
     plan = LouvainClusteringPlan::DoAll(
         enable_vf, modularity_threshold_per_round, modularity_threshold_total,
-        max_iterations, min_graph_size);
+        max_iterations, min_graph_size, enable_refinement);
     break;
   case LouvainClusteringPlan::kDeterministic:
     plan = LouvainClusteringPlan::Deterministic(
         enable_vf, modularity_threshold_per_round, modularity_threshold_total,
-        max_iterations, min_graph_size);
+        max_iterations, min_graph_size, enable_refinement);
     break;
   default:
     KATANA_LOG_FATAL("invalid algorithm");
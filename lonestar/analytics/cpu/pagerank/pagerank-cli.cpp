@@ -17,6 +17,9 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <iterator>
+#include <sstream>
+
 #include "Lonestar/BoilerPlate.h"
 #include "katana/analytics/pagerank/pagerank.h"
 
@@ -46,6 +49,7 @@ static cll::opt<PagerankPlan::Algorithm> algo(
             PagerankPlan::kPullTopological, "PullTopological",
             "PullTopological"),
         clEnumValN(PagerankPlan::kPullResidual, "PullResidual", "PullResidual"),
+        clEnumValN(PagerankPlan::kPullBlocked, "PullBlocked", "PullBlocked"),
         clEnumValN(PagerankPlan::kPushSynchronous, "PushSync", "PushSync"),
         clEnumValN(PagerankPlan::kPushAsynchronous, "PushAsync", "PushAsync")),
     cll::init(PagerankPlan::kPushAsynchronous));
@@ -56,13 +60,26 @@ static cll::opt<bool> transposedGraph(
     "transposedGraph", cll::desc("Specify that the input graph is transposed"),
     cll::init(false));
 
+static cll::opt<std::string> personalizedSeeds(
+    "personalizedSeeds",
+    cll::desc("Whitespace separated list of seed nodes; if set, also print "
+              "the -topK nodes with the highest Page Rank personalized for "
+              "these seeds (default value empty)"),
+    cll::init(""));
+static cll::opt<unsigned int> topK(
+    "topK",
+    cll::desc("Number of nodes of personalized Page Rank to print (default "
+              "value 10)"),
+    cll::init(10));
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
       LonestarStart(argc, argv, name, desc, url, &inputFile);
 
   if ((algo == PagerankPlan::kPullResidual ||
-       algo == PagerankPlan::kPullTopological) &&
+       algo == PagerankPlan::kPullTopological ||
+       algo == PagerankPlan::kPullBlocked) &&
       !transposedGraph) {
     KATANA_DIE(
         "This application requires a transposed graph input;"
@@ -106,6 +123,22 @@ main(int argc, char** argv) {
     }
   }
 
+  if (!personalizedSeeds.empty()) {
+    std::istringstream str(personalizedSeeds);
+    std::vector<uint32_t> seeds{
+        std::istream_iterator<uint32_t>{str},
+        std::istream_iterator<uint32_t>{}};
+    auto top_result = PersonalizedPagerank(pg.get(), seeds, topK, plan);
+    if (!top_result) {
+      KATANA_LOG_FATAL(
+          "Failed to run personalized Pagerank {}", top_result.error());
+    }
+    std::cout << "Personalized ranks:\n";
+    for (const auto& [node, rank] : top_result.value()) {
+      std::cout << node << " " << rank << "\n";
+    }
+  }
+
   if (output) {
     auto r = pg->GetNodePropertyTyped<float>("rank");
     if (!r) {
@@ -0,0 +1,325 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef _KATANA_BLOCKSPARSEBITVECTOR_
+#define _KATANA_BLOCKSPARSEBITVECTOR_
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace katana {
+
+/**
+ * Sparse bit vector stored as a sorted array of 256-bit blocks, each with
+ * the index of the block it holds. Unlike the linked list of SparseBitVector,
+ * the blocks are contiguous, and the words of a block are combined with
+ * fixed length loops that the compiler turns into vector instructions.
+ *
+ * Not thread safe: concurrent readers are fine, but a writer must have the
+ * vector to itself.
+ */
+class BlockSparseBitVector {
+public:
+  static const unsigned wordsPerBlock = 4;
+  static const unsigned bitsPerBlock = wordsPerBlock * 64;
+  static const unsigned noBit = ~0u;
+
+  struct alignas(32) Block {
+    uint64_t words[wordsPerBlock];
+  };
+
+private:
+  std::vector<uint32_t> bases;  // sorted indices of the blocks
+  std::vector<Block> blocks;    // blocks[i] holds bits of block bases[i]
+
+  /**
+   * @returns position of the first block whose base is not less than base
+   */
+  size_t lowerBound(uint32_t base) const {
+    return std::lower_bound(bases.begin(), bases.end(), base) - bases.begin();
+  }
+
+  /**
+   * @returns true if a block has any bit set
+   */
+  static bool any(const Block& block) {
+    uint64_t bits = 0;
+    for (unsigned i = 0; i < wordsPerBlock; ++i) {
+      bits |= block.words[i];
+    }
+    return bits != 0;
+  }
+
+  /**
+   * Or second into first.
+   *
+   * @returns true if first changed
+   */
+  static bool orInto(
+      Block& __restrict__ first, const Block& __restrict__ second) {
+    uint64_t added = 0;
+    for (unsigned i = 0; i < wordsPerBlock; ++i) {
+      added |= second.words[i] & ~first.words[i];
+      first.words[i] |= second.words[i];
+    }
+    return added != 0;
+  }
+
+public:
+  /**
+   * @returns true if no bit is set
+   */
+  bool empty() const { return bases.empty(); }
+
+  /**
+   * Unset all bits and release the memory of the blocks.
+   */
+  void clear() {
+    std::vector<uint32_t>().swap(bases);
+    std::vector<Block>().swap(blocks);
+  }
+
+  /**
+   * @param num Bit to check
+   * @returns true if bit num is set
+   */
+  bool test(unsigned num) const {
+    uint32_t base = num / bitsPerBlock;
+    size_t i = lowerBound(base);
+    if (i == bases.size() || bases[i] != base) {
+      return false;
+    }
+    unsigned offset = num % bitsPerBlock;
+    return (blocks[i].words[offset / 64] >> (offset % 64)) & 1;
+  }
+
+  /**
+   * @param num Bit to start from
+   * @returns the first set bit that is not less than num, or noBit if there
+   * is none
+   */
+  unsigned nextSetBit(unsigned num) const {
+    uint32_t base = num / bitsPerBlock;
+    size_t i = lowerBound(base);
+    unsigned offset =
+        i < bases.size() && bases[i] == base ? num % bitsPerBlock : 0;
+    for (; i < bases.size(); ++i, offset = 0) {
+      for (unsigned w = offset / 64; w < wordsPerBlock; ++w) {
+        uint64_t word = blocks[i].words[w];
+        if (w == offset / 64) {
+          word &= ~uint64_t{0} << (offset % 64);
+        }
+        if (word) {
+          return bases[i] * bitsPerBlock + w * 64 + __builtin_ctzll(word);
+        }
+      }
+    }
+    return noBit;
+  }
+
+  /**
+   * Set bit num, inserting its block in order if it is not there yet.
+   *
+   * @param num Bit to set
+   * @returns true if the bit wasn't set previously
+   */
+  bool set(unsigned num) {
+    uint32_t base = num / bitsPerBlock;
+    size_t i = lowerBound(base);
+    if (i == bases.size() || bases[i] != base) {
+      bases.insert(bases.begin() + i, base);
+      blocks.insert(blocks.begin() + i, Block{});
+    }
+    unsigned offset = num % bitsPerBlock;
+    uint64_t mask = uint64_t{1} << (offset % 64);
+    uint64_t& word = blocks[i].words[offset / 64];
+    bool changed = !(word & mask);
+    word |= mask;
+    return changed;
+  }
+
+  /**
+   * Or the bits of second into this vector. When second has no block that
+   * this vector lacks, the blocks are or'ed in place; otherwise the two
+   * arrays are merged into new ones.
+   *
+   * @param second Vector to take the bits of
+   * @returns true if something changed
+   */
+  bool unify(const BlockSparseBitVector& second) {
+    if (second.empty() || &second == this) {
+      return false;
+    }
+
+    size_t missing = 0;
+    for (size_t i = 0, j = 0; j < second.bases.size(); ++j) {
+      while (i < bases.size() && bases[i] < second.bases[j]) {
+        ++i;
+      }
+      missing += i == bases.size() || bases[i] != second.bases[j];
+    }
+
+    if (missing == 0) {
+      bool changed = false;
+      size_t i = 0;
+      for (size_t j = 0; j < second.bases.size(); ++j) {
+        while (bases[i] != second.bases[j]) {
+          ++i;
+        }
+        changed |= orInto(blocks[i], second.blocks[j]);
+      }
+      return changed;
+    }
+
+    std::vector<uint32_t> newBases;
+    std::vector<Block> newBlocks;
+    newBases.reserve(bases.size() + missing);
+    newBlocks.reserve(bases.size() + missing);
+    size_t i = 0;
+    size_t j = 0;
+    while (i < bases.size() || j < second.bases.size()) {
+      if (j == second.bases.size() ||
+          (i < bases.size() && bases[i] < second.bases[j])) {
+        newBases.push_back(bases[i]);
+        newBlocks.push_back(blocks[i++]);
+      } else if (i == bases.size() || second.bases[j] < bases[i]) {
+        newBases.push_back(second.bases[j]);
+        newBlocks.push_back(second.blocks[j++]);
+      } else {
+        newBases.push_back(bases[i]);
+        newBlocks.push_back(blocks[i++]);
+        orInto(newBlocks.back(), second.blocks[j++]);
+      }
+    }
+    bases.swap(newBases);
+    blocks.swap(newBlocks);
+    return true;
+  }
+
+  /**
+   * Make this vector the bits of first that are not in second.
+   *
+   * @param first Vector to take the bits of
+   * @param second Vector of the bits to leave out
+   */
+  void difference(
+      const BlockSparseBitVector& first, const BlockSparseBitVector& second) {
+    bases.clear();
+    blocks.clear();
+    size_t j = 0;
+    for (size_t i = 0; i < first.bases.size(); ++i) {
+      while (j < second.bases.size() && second.bases[j] < first.bases[i]) {
+        ++j;
+      }
+      Block block = first.blocks[i];
+      if (j < second.bases.size() && second.bases[j] == first.bases[i]) {
+        for (unsigned w = 0; w < wordsPerBlock; ++w) {
+          block.words[w] &= ~second.blocks[j].words[w];
+        }
+        if (!any(block)) {
+          continue;
+        }
+      }
+      bases.push_back(first.bases[i]);
+      blocks.push_back(block);
+    }
+  }
+
+  /**
+   * @param second Vector to compare against
+   * @returns true if second has all of the bits this vector has
+   */
+  bool isSubsetEq(const BlockSparseBitVector& second) const {
+    size_t j = 0;
+    for (size_t i = 0; i < bases.size(); ++i) {
+      while (j < second.bases.size() && second.bases[j] < bases[i]) {
+        ++j;
+      }
+      if (j == second.bases.size() || second.bases[j] != bases[i]) {
+        return false;
+      }
+      for (unsigned w = 0; w < wordsPerBlock; ++w) {
+        if (blocks[i].words[w] & ~second.blocks[j].words[w]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Call fn on every set bit in increasing order.
+   *
+   * @param fn Function to call with each set bit
+   */
+  template <typename F>
+  void forEach(F fn) const {
+    for (size_t i = 0; i < bases.size(); ++i) {
+      for (unsigned w = 0; w < wordsPerBlock; ++w) {
+        uint64_t word = blocks[i].words[w];
+        while (word) {
+          unsigned bit = __builtin_ctzll(word);
+          fn(bases[i] * bitsPerBlock + w * 64 + bit);
+          word &= word - 1;
+        }
+      }
+    }
+  }
+
+  /**
+   * @returns number of bits set in this bitvector
+   */
+  unsigned count() const {
+    unsigned nbits = 0;
+    for (const Block& block : blocks) {
+      for (unsigned w = 0; w < wordsPerBlock; ++w) {
+        nbits += __builtin_popcountll(block.words[w]);
+      }
+    }
+    return nbits;
+  }
+
+  /**
+   * @returns vector with all set bits in increasing order
+   */
+  std::vector<unsigned> getAllSetBits() const {
+    std::vector<unsigned> setBits;
+    forEach([&](unsigned bit) { setBits.push_back(bit); });
+    return setBits;
+  }
+
+  /**
+   * Output the bits that are set in this bitvector.
+   *
+   * @param out Stream to output to
+   * @param prefix A string to append to the set bit numbers
+   */
+  void print(std::ostream& out, std::string prefix = std::string("")) const {
+    out << "Elements(" << count() << "): ";
+    forEach([&](unsigned bit) { out << prefix << bit << ", "; });
+    out << "\n";
+  }
+};
+
+}  // namespace katana
+
+#endif
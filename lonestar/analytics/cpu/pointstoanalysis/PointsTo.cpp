@@ -22,6 +22,7 @@
 #include <iostream>
 
 #include "Lonestar/BoilerPlate.h"
+#include "BlockSparseBitVector.h"
 #include "SparseBitVector.h"
 #include "katana/Galois.h"
 #include "llvm/Support/CommandLine.h"
@@ -46,6 +47,13 @@ static cll::opt<bool> useSerial(
               "(default false)"),
     cll::init(false));
 
+static cll::opt<bool> useWave(
+    "wave",
+    cll::desc("Runs the parallel wave propagation version of the algorithm, "
+              "which collapses cycles before every wave "
+              "(default false)"),
+    cll::init(false));
+
 static cll::opt<bool> printAnswer(
     "printAnswer",
     cll::desc("If set, prints all points to facts "
@@ -125,6 +133,94 @@ public:
   }
 };
 
+/**
+ * Constraints of a points-to analysis, shared by the executors.
+ */
+class PTAConstraints {
+protected:
+  using PointsToConstraints = std::vector<PtsToCons>;
+
+  PointsToConstraints addressCopyConstraints;
+  PointsToConstraints loadStoreConstraints;
+
+  size_t numNodes = 0;
+
+public:
+  /**
+   * Read a constraint file and load its contents into memory.
+   *
+   * @param file filename to read
+   * @returns number of nodes in the constraint graph
+   */
+  unsigned readConstraints(const char* file) {
+    katana::gInfo(
+        "GEP constraints (constraint type 4) and any constraints "
+        "with offsets are ignored.");
+
+    unsigned numNodes = 0;
+    unsigned nconstraints = 0;
+
+    std::ifstream cfile(file);
+    std::string cstr;
+
+    getline(cfile, cstr);  // # of vars.
+    sscanf(cstr.c_str(), "%d", &numNodes);
+
+    getline(cfile, cstr);  // # of constraints.
+    sscanf(cstr.c_str(), "%d", &nconstraints);
+
+    addressCopyConstraints.clear();
+    loadStoreConstraints.clear();
+
+    unsigned constraintNum;
+    unsigned src;
+    unsigned dst;
+    unsigned offset;
+
+    PtsToCons::ConstraintType type;
+
+    // Create constraint objects and save them to appropriate location
+    for (unsigned ii = 0; ii < nconstraints; ++ii) {
+      getline(cfile, cstr);
+      union {
+        int as_int;
+        PtsToCons::ConstraintType as_ctype;
+      } type_converter;
+      sscanf(
+          cstr.c_str(), "%d,%d,%d,%d,%d", &constraintNum, &src, &dst,
+          &type_converter.as_int, &offset);
+
+      type = type_converter.as_ctype;
+
+      PtsToCons cc(type, src, dst);
+
+      if (type == PtsToCons::AddressOf || type == PtsToCons::Copy) {
+        addressCopyConstraints.push_back(cc);
+      } else if (type == PtsToCons::Load || type == PtsToCons::Store) {
+        if (offset == 0) {  // ignore load/stores with offsets
+          loadStoreConstraints.push_back(cc);
+        }
+      }
+      // ignore GEP constraints
+    }
+
+    cfile.close();
+
+    return numNodes;
+  }
+
+  /**
+   * Prints the constraints in the passed in vector of constraints.
+   *
+   * @param constraints vector of PtsToCons
+   */
+  void printConstraints(PointsToConstraints& constraints) {
+    for (auto ii = constraints.begin(); ii != constraints.end(); ++ii) {
+      ii->print();
+    }
+  }
+};
+
 /**
  * Points to analysis runner base class. Does not have a run method itself.
  *
@@ -132,11 +228,10 @@ public:
  * to results and outgoing edges will be thread safe
  */
 template <bool IsConcurrent>
-class PTABase {
+class PTABase : public PTAConstraints {
   // sparse bit vector is concurrent or serial based on template parameter
   using SparseBitVector = katana::SparseBitVector<IsConcurrent>;
 
-  using PointsToConstraints = std::vector<PtsToCons>;
   using PointsToInfo = std::vector<SparseBitVector>;
   using EdgeVector = std::vector<SparseBitVector>;
 
@@ -147,11 +242,6 @@ protected:
   PointsToInfo pointsToResult;  // pointsTo results for nodes
   EdgeVector outgoingEdges;     // holds outgoing edges of a node
 
-  PointsToConstraints addressCopyConstraints;
-  PointsToConstraints loadStoreConstraints;
-
-  size_t numNodes = 0;
-
   ////////////////////////////////////////////////////////////////////////////////
   /**
    * Online Cycle Detection and elimination structure + functions.
@@ -528,84 +618,10 @@ public:
     }
   }
 
-  /**
-   * Read a constraint file and load its contents into memory.
-   *
-   * @param file filename to read
-   * @returns number of nodes in the constraint graph
-   */
-  unsigned readConstraints(const char* file) {
-    katana::gInfo(
-        "GEP constraints (constraint type 4) and any constraints "
-        "with offsets are ignored.");
-
-    unsigned numNodes = 0;
-    unsigned nconstraints = 0;
-
-    std::ifstream cfile(file);
-    std::string cstr;
-
-    getline(cfile, cstr);  // # of vars.
-    sscanf(cstr.c_str(), "%d", &numNodes);
-
-    getline(cfile, cstr);  // # of constraints.
-    sscanf(cstr.c_str(), "%d", &nconstraints);
-
-    addressCopyConstraints.clear();
-    loadStoreConstraints.clear();
-
-    unsigned constraintNum;
-    unsigned src;
-    unsigned dst;
-    unsigned offset;
-
-    PtsToCons::ConstraintType type;
-
-    // Create constraint objects and save them to appropriate location
-    for (unsigned ii = 0; ii < nconstraints; ++ii) {
-      getline(cfile, cstr);
-      union {
-        int as_int;
-        PtsToCons::ConstraintType as_ctype;
-      } type_converter;
-      sscanf(
-          cstr.c_str(), "%d,%d,%d,%d,%d", &constraintNum, &src, &dst,
-          &type_converter.as_int, &offset);
-
-      type = type_converter.as_ctype;
-
-      PtsToCons cc(type, src, dst);
-
-      if (type == PtsToCons::AddressOf || type == PtsToCons::Copy) {
-        addressCopyConstraints.push_back(cc);
-      } else if (type == PtsToCons::Load || type == PtsToCons::Store) {
-        if (offset == 0) {  // ignore load/stores with offsets
-          loadStoreConstraints.push_back(cc);
-        }
-      }
-      // ignore GEP constraints
-    }
-
-    cfile.close();
-
-    return numNodes;
-  }
-
   //////////////////////////////////////////////////////////////////////////////
   // Debugging/output functions
   //////////////////////////////////////////////////////////////////////////////
 
-  /**
-   * Prints the constraints in the passed in vector of constraints.
-   *
-   * @param constraints vector of PtsToCons
-   */
-  void printConstraints(PointsToConstraints& constraints) {
-    for (auto ii = constraints.begin(); ii != constraints.end(); ++ii) {
-      ii->print();
-    }
-  }
-
   /**
    * Checks to make sure that all representative point to at LEAST
    * what the nodes that it represents are pointing to. Necessary but not
@@ -641,6 +657,14 @@ public:
     }
   }
 
+  /**
+   * Runs the checks on the representatives.
+   */
+  void verify() {
+    checkReprPointsTo();
+    checkReprEdges();
+  }
+
   /**
    * @returns The total number of points to facts in the system.
    */
@@ -771,14 +795,449 @@ public:
   }
 };
 
+/**
+ * Parallel wave propagation executor, after Pereira and Berlin, "Wave
+ * Propagation and Deep Propagation for Pointer Analysis" (CGO 2009). Every
+ * round:
+ *
+ * 1. collapses the cycles of copy edges into one representative each, with
+ *    Tarjan's algorithm, which also orders the representatives
+ *    topologically (online cycle detection, as every round finds the cycles
+ *    the new edges made),
+ * 2. sends the points-to facts each representative gained since the last
+ *    round to its successors, as a wave over the topological levels; the
+ *    nodes of a level run in parallel and pull from their predecessors, so
+ *    no two threads write the same bit vector,
+ * 3. adds, in parallel, the edges the load/store constraints imply for the
+ *    facts the wave moved, along with the facts their sources already had.
+ *
+ * It stops at the first round that adds no edge. The bit vectors are the
+ * BlockSparseBitVectors, whose unions run over contiguous blocks.
+ */
+class PTAWave : public PTAConstraints {
+  using SparseBitVector = katana::BlockSparseBitVector;
+  using Edge = std::pair<unsigned, unsigned>;
+
+  // all of these are indexed by representative, except representative
+  std::vector<SparseBitVector> pointsTo;
+  std::vector<SparseBitVector> propagated;  // facts sent to the successors
+  std::vector<SparseBitVector> delta;       // facts the current wave moves
+  std::vector<SparseBitVector> successors;
+  std::vector<SparseBitVector> predecessors;
+  std::vector<unsigned> representative;
+
+  // topological order of the representatives, by level
+  std::vector<unsigned> levelBegin;
+  std::vector<unsigned> byLevel;
+
+  // scratch of Tarjan's algorithm
+  std::vector<unsigned> index;
+  std::vector<unsigned> lowLink;
+  std::vector<bool> onStack;
+
+  /**
+   * Call fn(begin, end) in parallel on each run of edges that share their
+   * first node; edges must be sorted.
+   */
+  template <typename F>
+  void forEachGroup(const std::vector<Edge>& edges, F fn) {
+    std::vector<size_t> starts;
+    for (size_t i = 0; i < edges.size(); ++i) {
+      if (i == 0 || edges[i].first != edges[i - 1].first) {
+        starts.push_back(i);
+      }
+    }
+    starts.push_back(edges.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, starts.size() - 1),
+        [&](size_t g) {
+          fn(edges.data() + starts[g], edges.data() + starts[g + 1]);
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  /**
+   * Add the copy edges between representatives in edges, and send along
+   * each new one the facts its source has.
+   *
+   * @returns true if some edge was new
+   */
+  bool addEdges(std::vector<Edge>& edges) {
+    katana::ParallelSTL::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    std::vector<uint8_t> isNew(edges.size());
+    forEachGroup(edges, [&](const Edge* begin, const Edge* end) {
+      for (const Edge* e = begin; e != end; ++e) {
+        isNew[e - edges.data()] = successors[e->first].set(e->second);
+      }
+    });
+
+    std::vector<Edge> reversed;
+    for (size_t i = 0; i < edges.size(); ++i) {
+      if (isNew[i]) {
+        reversed.emplace_back(edges[i].second, edges[i].first);
+      }
+    }
+    if (reversed.empty()) {
+      return false;
+    }
+    katana::ParallelSTL::sort(reversed.begin(), reversed.end());
+
+    // delta is free between waves; stage the facts there since sources may
+    // be destinations too
+    forEachGroup(reversed, [&](const Edge* begin, const Edge* end) {
+      for (const Edge* e = begin; e != end; ++e) {
+        predecessors[e->first].set(e->second);
+        delta[e->first].unify(pointsTo[e->second]);
+      }
+    });
+    forEachGroup(reversed, [&](const Edge* begin, const Edge*) {
+      pointsTo[begin->first].unify(delta[begin->first]);
+      delta[begin->first].clear();
+    });
+    return true;
+  }
+
+  /**
+   * Replace the members of edges with their representatives.
+   */
+  void remapEdges(SparseBitVector& edges, unsigned self) {
+    bool stale = false;
+    edges.forEach([&](unsigned n) { stale |= representative[n] != n; });
+    if (!stale) {
+      return;
+    }
+    SparseBitVector remapped;
+    edges.forEach([&](unsigned n) {
+      if (representative[n] != self) {
+        remapped.set(representative[n]);
+      }
+    });
+    edges = std::move(remapped);
+  }
+
+  /**
+   * Find the cycles of copy edges with Tarjan's algorithm and collapse each
+   * into its root, then order the representatives by level.
+   */
+  void collapseCycles() {
+    const unsigned unvisited = ~0u;
+    std::fill(index.begin(), index.end(), unvisited);
+    unsigned counter = 0;
+
+    std::vector<unsigned> finished;  // roots of components, sinks first
+    std::vector<std::vector<unsigned>> cycles;
+    std::vector<unsigned> stack;
+    std::vector<std::pair<unsigned, unsigned>> calls;  // node, next bit
+
+    auto visit = [&](unsigned n) {
+      index[n] = lowLink[n] = counter++;
+      stack.push_back(n);
+      onStack[n] = true;
+      calls.emplace_back(n, 0);
+    };
+
+    for (unsigned root = 0; root < numNodes; ++root) {
+      if (representative[root] != root || index[root] != unvisited) {
+        continue;
+      }
+      visit(root);
+      while (!calls.empty()) {
+        unsigned v = calls.back().first;
+        unsigned w = successors[v].nextSetBit(calls.back().second);
+        if (w != SparseBitVector::noBit) {
+          calls.back().second = w + 1;
+          if (index[w] == unvisited) {
+            visit(w);
+          } else if (onStack[w]) {
+            lowLink[v] = std::min(lowLink[v], index[w]);
+          }
+          continue;
+        }
+
+        calls.pop_back();
+        if (!calls.empty()) {
+          unsigned parent = calls.back().first;
+          lowLink[parent] = std::min(lowLink[parent], lowLink[v]);
+        }
+        if (lowLink[v] != index[v]) {
+          continue;
+        }
+        std::vector<unsigned> members;
+        unsigned m;
+        do {
+          m = stack.back();
+          stack.pop_back();
+          onStack[m] = false;
+          members.push_back(m);
+        } while (m != v);
+        if (members.size() > 1) {
+          cycles.emplace_back(std::move(members));
+        }
+        finished.push_back(v);
+      }
+    }
+
+    if (!cycles.empty()) {
+      katana::do_all(
+          katana::iterate(size_t{0}, cycles.size()),
+          [&](size_t c) {
+            const std::vector<unsigned>& members = cycles[c];
+            unsigned rep = members.back();
+            for (unsigned m : members) {
+              if (m == rep) {
+                continue;
+              }
+              representative[m] = rep;
+              pointsTo[rep].unify(pointsTo[m]);
+              successors[rep].unify(successors[m]);
+              predecessors[rep].unify(predecessors[m]);
+              pointsTo[m].clear();
+              propagated[m].clear();
+              successors[m].clear();
+              predecessors[m].clear();
+            }
+            // the successors of the members have not seen all the facts
+            propagated[rep].clear();
+          },
+          katana::steal(), katana::loopname("PointsToCollapseCycles"));
+      katana::do_all(
+          katana::iterate(size_t{0}, numNodes),
+          [&](size_t n) {
+            representative[n] = representative[representative[n]];
+          },
+          katana::no_stats());
+      katana::do_all(
+          katana::iterate(size_t{0}, numNodes),
+          [&](size_t n) {
+            if (representative[n] == n) {
+              remapEdges(successors[n], n);
+              remapEdges(predecessors[n], n);
+            }
+          },
+          katana::steal(), katana::no_stats());
+    }
+
+    // level of a representative: the longest path to it from a node without
+    // predecessors
+    std::vector<unsigned> level(numNodes, 0);
+    unsigned numLevels = 0;
+    for (auto n = finished.rbegin(); n != finished.rend(); ++n) {
+      predecessors[*n].forEach(
+          [&](unsigned p) { level[*n] = std::max(level[*n], level[p] + 1); });
+      numLevels = std::max(numLevels, level[*n] + 1);
+    }
+    levelBegin.assign(numLevels + 1, 0);
+    for (unsigned n : finished) {
+      ++levelBegin[level[n] + 1];
+    }
+    std::partial_sum(levelBegin.begin(), levelBegin.end(), levelBegin.begin());
+    byLevel.resize(finished.size());
+    std::vector<unsigned> next(levelBegin.begin(), levelBegin.end() - 1);
+    for (unsigned n : finished) {
+      byLevel[next[level[n]]++] = n;
+    }
+  }
+
+  /**
+   * Send the new facts of every representative to its successors, level by
+   * level in topological order.
+   */
+  void propagateWave() {
+    for (size_t l = 0; l + 1 < levelBegin.size(); ++l) {
+      katana::do_all(
+          katana::iterate(
+              byLevel.begin() + levelBegin[l],
+              byLevel.begin() + levelBegin[l + 1]),
+          [&](unsigned n) {
+            predecessors[n].forEach(
+                [&](unsigned p) { pointsTo[n].unify(delta[p]); });
+            delta[n].difference(pointsTo[n], propagated[n]);
+            if (!delta[n].empty()) {
+              propagated[n] = pointsTo[n];
+            }
+          },
+          katana::steal(), katana::loopname("PointsToWave"));
+    }
+  }
+
+  /**
+   * @returns the copy edges the load/store constraints imply for the facts
+   * moved by the last wave
+   */
+  std::vector<Edge> processLoadStore() {
+    katana::InsertBag<Edge> edges;
+    katana::do_all(
+        katana::iterate(loadStoreConstraints),
+        [&](const PtsToCons& constraint) {
+          unsigned src;
+          unsigned dst;
+          std::tie(src, dst) = constraint.getSrcDst();
+          unsigned srcRepr = representative[src];
+          unsigned dstRepr = representative[dst];
+
+          if (constraint.getType() == PtsToCons::Load) {
+            // anything src points to must also point to dst
+            delta[srcRepr].forEach([&](unsigned pointee) {
+              unsigned pointeeRepr = representative[pointee];
+              if (pointeeRepr != dstRepr &&
+                  !successors[pointeeRepr].test(dstRepr)) {
+                edges.push(Edge(pointeeRepr, dstRepr));
+              }
+            });
+          } else {
+            // src must point to anything dst points to
+            delta[dstRepr].forEach([&](unsigned pointee) {
+              unsigned pointeeRepr = representative[pointee];
+              if (srcRepr != pointeeRepr &&
+                  !successors[srcRepr].test(pointeeRepr)) {
+                edges.push(Edge(srcRepr, pointeeRepr));
+              }
+            });
+          }
+        },
+        katana::steal(), katana::loopname("PointsToLoadStore"));
+    return std::vector<Edge>(edges.begin(), edges.end());
+  }
+
+public:
+  /**
+   * Given the number of nodes in the constraint graph, initialize the
+   * structures needed for the points-to algorithm.
+   *
+   * @param n Number of nodes in the constraint graph
+   */
+  void initialize(size_t n) {
+    numNodes = n;
+    pointsTo.resize(numNodes);
+    propagated.resize(numNodes);
+    delta.resize(numNodes);
+    successors.resize(numNodes);
+    predecessors.resize(numNodes);
+    representative.resize(numNodes);
+    std::iota(representative.begin(), representative.end(), 0);
+    index.resize(numNodes);
+    lowLink.resize(numNodes);
+    onStack.resize(numNodes);
+  }
+
+  /**
+   * Run points-to-analysis with parallel waves.
+   */
+  void run() {
+    katana::gDebug(
+        "no of addr+copy constraints = ", addressCopyConstraints.size(),
+        ", no of load+store constraints = ", loadStoreConstraints.size());
+    katana::gDebug("no of nodes = ", numNodes);
+
+    std::vector<Edge> addresses;
+    std::vector<Edge> copies;
+    for (const PtsToCons& constraint : addressCopyConstraints) {
+      unsigned src;
+      unsigned dst;
+      std::tie(src, dst) = constraint.getSrcDst();
+      if (constraint.getType() == PtsToCons::AddressOf) {
+        addresses.emplace_back(dst, src);
+      } else if (src != dst) {
+        copies.emplace_back(src, dst);
+      }
+    }
+    katana::ParallelSTL::sort(addresses.begin(), addresses.end());
+    forEachGroup(addresses, [&](const Edge* begin, const Edge* end) {
+      for (const Edge* e = begin; e != end; ++e) {
+        pointsTo[e->first].set(e->second);
+      }
+    });
+    addEdges(copies);
+
+    for (unsigned round = 1;; ++round) {
+      collapseCycles();
+      propagateWave();
+      std::vector<Edge> edges = processLoadStore();
+      katana::do_all(
+          katana::iterate(size_t{0}, numNodes),
+          [&](size_t n) { delta[n].clear(); }, katana::no_stats());
+      katana::gDebug(
+          "round ", round, ": ", byLevel.size(), " representatives in ",
+          levelBegin.size() - 1, " levels, ", edges.size(),
+          " candidate edges");
+      if (!addEdges(edges)) {
+        break;
+      }
+    }
+  }
+
+  /**
+   * Checks that the points-to facts satisfy every constraint.
+   */
+  void verify() {
+    auto pointsToOf = [&](unsigned n) -> const SparseBitVector& {
+      return pointsTo[representative[n]];
+    };
+    auto check = [&](const PtsToCons& constraint) {
+      unsigned src;
+      unsigned dst;
+      std::tie(src, dst) = constraint.getSrcDst();
+      bool satisfied = true;
+      switch (constraint.getType()) {
+      case PtsToCons::AddressOf:
+        satisfied = pointsToOf(dst).test(src);
+        break;
+      case PtsToCons::Copy:
+        satisfied = pointsToOf(src).isSubsetEq(pointsToOf(dst));
+        break;
+      case PtsToCons::Load:
+        pointsToOf(src).forEach([&](unsigned pointee) {
+          satisfied &= pointsToOf(pointee).isSubsetEq(pointsToOf(dst));
+        });
+        break;
+      default:
+        pointsToOf(dst).forEach([&](unsigned pointee) {
+          satisfied &= pointsToOf(src).isSubsetEq(pointsToOf(pointee));
+        });
+        break;
+      }
+      if (!satisfied) {
+        katana::gError("constraint is not satisfied: ");
+        constraint.print();
+      }
+    };
+    katana::do_all(katana::iterate(addressCopyConstraints), check);
+    katana::do_all(katana::iterate(loadStoreConstraints), check);
+  }
+
+  /**
+   * @returns The total number of points to facts in the system.
+   */
+  unsigned countPointsToFacts() {
+    unsigned count = 0;
+    for (unsigned n = 0; n < numNodes; ++n) {
+      count += pointsTo[representative[n]].count();
+    }
+    return count;
+  }
+
+  /**
+   * Prints out points to info for all verticies in the constraint graph.
+   */
+  void printPointsToInfo() {
+    std::string prefix = "v";
+    for (unsigned n = 0; n < numNodes; ++n) {
+      std::cerr << prefix << n << ": ";
+      pointsTo[representative[n]].print(std::cerr, prefix);
+    }
+  }
+};
+
 /**
  * Method from running PTA.
  */
-template <typename PTAClass, typename Alloc>
+template <typename PTAClass, typename... Alloc>
 void
-runPTA(PTAClass& pta, Alloc& nodeAllocator) {
+runPTA(PTAClass& pta, Alloc&... nodeAllocator) {
   size_t numNodes = pta.readConstraints(inputFile.c_str());
-  pta.initialize(numNodes, nodeAllocator);
+  pta.initialize(numNodes, nodeAllocator...);
 
   katana::StatTimer execTime("Timer_0");
 
@@ -790,8 +1249,7 @@ runPTA(PTAClass& pta, Alloc& nodeAllocator) {
 
   if (!skipVerify) {
     katana::gInfo("Doing verification step");
-    pta.checkReprPointsTo();
-    pta.checkReprEdges();
+    pta.verify();
   }
 
   if (printAnswer) {
@@ -799,7 +1257,9 @@ runPTA(PTAClass& pta, Alloc& nodeAllocator) {
   }
 
   // free everything nodeallocator allocated
-  pta.freeNodeAllocatorMemory();
+  if constexpr (sizeof...(Alloc) > 0) {
+    pta.freeNodeAllocatorMemory();
+  }
 }
 
 int
@@ -812,7 +1272,14 @@ main(int argc, char** argv) {
 
   // depending on serial or concurrent, create the correct class and pass it
   // into the run harness which takes care of the rest
-  if (!useSerial) {
+  if (useWave) {
+    katana::gInfo(
+        "-------- Parallel wave propagation version: ",
+        katana::getActiveThreads(), " threads.");
+
+    PTAWave p;
+    runPTA(p);
+  } else if (!useSerial) {
     katana::gInfo(
         "-------- Parallel version: ", katana::getActiveThreads(), " threads.");
     katana::gInfo(
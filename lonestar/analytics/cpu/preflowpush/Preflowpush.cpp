@@ -502,8 +502,14 @@ struct PreflowPush {
     katana::InsertBag<GNode> initial;
     initializePreflow(initial);
 
+    // the timers are created every round
+    katana::StatHandle discharge_time(
+        "(NULL)", "DischargeTime", katana::StatTotal::TMAX);
+    katana::StatHandle global_relabel_time(
+        "(NULL)", "GlobalRelabelTime", katana::StatTotal::TMAX);
+
     while (initial.begin() != initial.end()) {
-      katana::StatTimer T_discharge("DischargeTime");
+      katana::StatTimer T_discharge(discharge_time);
       T_discharge.start();
       Counter counter;
       switch (detAlgo) {
@@ -527,7 +533,7 @@ struct PreflowPush {
       T_discharge.stop();
 
       if (should_global_relabel) {
-        katana::StatTimer T_global_relabel("GlobalRelabelTime");
+        katana::StatTimer T_global_relabel(global_relabel_time);
         T_global_relabel.start();
         initial.clear();
         globalRelabel(initial);
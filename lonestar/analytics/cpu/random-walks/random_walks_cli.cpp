@@ -81,18 +81,19 @@ AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
   }
 }
 
-void
-PrintWalks(
-    const std::vector<std::vector<uint32_t>>& walks,
-    const std::string& output_file) {
-  std::ofstream f(output_file);
-
-  for (auto walk : walks) {
-    for (auto node : walk) {
-      f << node << " ";
+/// Write each batch of walks to f as it is generated, a walk per line
+katana::Result<void>
+PrintWalks(const RandomWalksBatch& batch, std::ofstream* f) {
+  for (uint64_t i = 0; i < batch.num_walks(); ++i) {
+    for (uint64_t k = batch.offsets[i]; k < batch.offsets[i + 1]; ++k) {
+      *f << batch.nodes[k] << " ";
     }
-    f << std::endl;
+    *f << "\n";
   }
+  if (!*f) {
+    return KATANA_ERROR(katana::ResultErrno(), "writing walks failed");
+  }
+  return katana::ResultSuccess();
 }
 
 int
@@ -134,15 +135,24 @@ main(int argc, char** argv) {
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
-  auto walks_result = RandomWalks(pg.get(), plan);
-  if (!walks_result) {
-    KATANA_LOG_FATAL("Failed to run RandomWalks: {}", walks_result.error());
-  }
-
+  std::ofstream f;
   if (output) {
     std::string output_file = outputLocation + "/" + outputFile;
     katana::gInfo("Writing random walks to a file: ", output_file);
-    PrintWalks(walks_result.value(), output_file);
+    f.open(output_file);
+  }
+
+  auto walks_result = RandomWalksInBatches(
+      pg.get(),
+      [&](const RandomWalksBatch& batch) -> katana::Result<void> {
+        if (!output) {
+          return katana::ResultSuccess();
+        }
+        return PrintWalks(batch, &f);
+      },
+      plan);
+  if (!walks_result) {
+    KATANA_LOG_FATAL("Failed to run RandomWalks: {}", walks_result.error());
   }
 
   return 0;
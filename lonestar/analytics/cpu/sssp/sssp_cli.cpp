@@ -20,6 +20,7 @@
 #include <iostream>
 
 #include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/point_to_point/point_to_point.h"
 #include "katana/analytics/sssp/sssp.h"
 
 using namespace katana::analytics;
@@ -57,6 +58,12 @@ static cll::opt<bool> persistAllDistances(
 static cll::opt<unsigned int> reportNode(
     "reportNode", cll::desc("Node to report distance to(default value 1)"),
     cll::init(1));
+static cll::opt<bool> pointToPoint(
+    "pointToPoint",
+    cll::desc("Also find the distance from each source to -reportNode with a "
+              "point-to-point query and check it against the full search "
+              "(default value false)"),
+    cll::init(false));
 static cll::opt<unsigned int> stepShift(
     "delta", cll::desc("Shift value for the deltastep (default value 13)"),
     cll::init(13));
@@ -75,6 +82,13 @@ static cll::opt<SsspPlan::Algorithm> algo(
         clEnumValN(
             SsspPlan::kDeltaStepFusion, "DeltaStepFusion",
             "Delta stepping with barrier and fused buckets"),
+        clEnumValN(
+            SsspPlan::kDeltaStepAdaptive, "DeltaStepAdaptive",
+            "Delta stepping with a delta adapted at runtime"),
+        clEnumValN(
+            SsspPlan::kDeltaStepAutoDelta, "DeltaStepAutoDelta",
+            "Delta stepping with a delta adapted at runtime, starting from "
+            "one chosen from the edge weights"),
         clEnumValN(
             SsspPlan::kSerialDelta, "SerialDelta", "Serial delta stepping"),
         clEnumValN(
@@ -109,6 +123,10 @@ AlgorithmName(SsspPlan::Algorithm algorithm) {
     return "DeltaStepBarrier";
   case SsspPlan::kDeltaStepFusion:
     return "DeltaStepFusion";
+  case SsspPlan::kDeltaStepAdaptive:
+    return "DeltaStepAdaptive";
+  case SsspPlan::kDeltaStepAutoDelta:
+    return "DeltaStepAutoDelta";
   case SsspPlan::kSerialDeltaTile:
     return "SerialDeltaTile";
   case SsspPlan::kSerialDelta:
@@ -146,6 +164,42 @@ OutputResults(
       output_filename);
 }
 
+template <typename Weight>
+static double
+NodeDistance(
+    katana::PropertyGraph* pg, const std::string& node_distance_prop,
+    uint32_t node) {
+  auto r = pg->GetNodePropertyTyped<Weight>(node_distance_prop);
+  if (!r) {
+    KATANA_LOG_FATAL("Error getting results: {}", r.error());
+  }
+  return r.value()->Value(node);
+}
+
+static double
+NodeDistance(
+    katana::PropertyGraph* pg, const std::string& node_distance_prop,
+    uint32_t node) {
+  switch (pg->GetNodeProperty(node_distance_prop)->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return NodeDistance<uint32_t>(pg, node_distance_prop, node);
+  case arrow::Int32Type::type_id:
+    return NodeDistance<int32_t>(pg, node_distance_prop, node);
+  case arrow::UInt64Type::type_id:
+    return NodeDistance<uint64_t>(pg, node_distance_prop, node);
+  case arrow::Int64Type::type_id:
+    return NodeDistance<int64_t>(pg, node_distance_prop, node);
+  case arrow::FloatType::type_id:
+    return NodeDistance<float>(pg, node_distance_prop, node);
+  case arrow::DoubleType::type_id:
+    return NodeDistance<double>(pg, node_distance_prop, node);
+  default:
+    KATANA_LOG_FATAL(
+        "Unsupported type: {}",
+        pg->GetNodeProperty(node_distance_prop)->type());
+  }
+}
+
 }  // namespace
 
 int
@@ -213,6 +267,12 @@ main(int argc, char** argv) {
   case SsspPlan::kDeltaStepFusion:
     plan = SsspPlan::DeltaStepFusion(stepShift);
     break;
+  case SsspPlan::kDeltaStepAdaptive:
+    plan = SsspPlan::DeltaStepAdaptive(stepShift);
+    break;
+  case SsspPlan::kDeltaStepAutoDelta:
+    plan = SsspPlan::DeltaStepAutoDelta();
+    break;
   case SsspPlan::kSerialDeltaTile:
     plan = SsspPlan::SerialDeltaTile(stepShift);
     break;
@@ -238,6 +298,17 @@ main(int argc, char** argv) {
     KATANA_LOG_FATAL("Invalid algorithm selected");
   }
 
+  std::unique_ptr<PointToPointQuery> query;
+  if (pointToPoint) {
+    auto query_result = PointToPointQuery::Make(pg.get(), edge_property_name);
+    if (!query_result) {
+      KATANA_LOG_FATAL(
+          "Failed to prepare point-to-point queries: {}",
+          query_result.error());
+    }
+    query = std::move(query_result.value());
+  }
+
   for (auto startNode : startNodes) {
     if (startNode >= pg->topology().num_nodes()) {
       KATANA_LOG_FATAL("failed to set source: {}", startNode);
@@ -257,6 +328,26 @@ main(int argc, char** argv) {
     auto stats = stats_result.value();
     stats.Print();
 
+    if (query) {
+      auto distance_result = query->Distance(startNode, reportNode);
+      if (!distance_result) {
+        KATANA_LOG_FATAL(
+            "Failed to run point-to-point query: {}", distance_result.error());
+      }
+      double distance = distance_result.value();
+      std::cout << "Point-to-point distance from " << startNode << " to "
+                << reportNode << " = " << distance << "\n";
+
+      double expected_distance =
+          NodeDistance(pg.get(), node_distance_prop, reportNode);
+      if (!skipVerify && distance != PointToPointQuery::kUnreachable &&
+          distance != expected_distance) {
+        KATANA_LOG_FATAL(
+            "point-to-point distance {} differs from the SSSP distance {}",
+            distance, expected_distance);
+      }
+    }
+
     if (!skipVerify) {
       if (stats.n_reached_nodes < pg->topology().num_nodes()) {
         KATANA_LOG_WARN(
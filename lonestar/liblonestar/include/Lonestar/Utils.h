@@ -26,8 +26,13 @@
 
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Utils.h"
+#include "llvm/Support/CommandLine.h"
 #include "tsuba/RDG.h"
 
+//! Map the topology of the input graph instead of reading it into memory;
+//! defined with the other global options in BoilerPlate.cpp
+extern llvm::cl::opt<bool> outOfCoreTopology;
+
 inline std::unique_ptr<katana::PropertyGraph>
 MakeFileGraph(
     const std::string& rdg_name, const std::string& edge_property_name) {
@@ -40,6 +45,7 @@ MakeFileGraph(
   tsuba::RDGLoadOptions opts;
   opts.node_properties = node_properties;
   opts.edge_properties = edge_properties;
+  opts.out_of_core_topology = outOfCoreTopology;
   auto pfg_result = katana::PropertyGraph::Make(rdg_name, opts);
   if (!pfg_result) {
     KATANA_LOG_FATAL("cannot make graph: {}", pfg_result.error());
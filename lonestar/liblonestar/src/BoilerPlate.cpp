@@ -47,6 +47,13 @@ llvm::cl::opt<std::string> edge_property_name(
     llvm::cl::desc("name of the edge property to the loaded"),
     llvm::cl::init(""));
 
+llvm::cl::opt<bool> outOfCoreTopology(
+    "outOfCoreTopology",
+    llvm::cl::desc(
+        "Map the topology of the input graph from storage instead of reading "
+        "it into memory (default value false)"),
+    llvm::cl::init(false));
+
 llvm::cl::opt<std::string> outputLocation(
     "outputLocation",
     llvm::cl::desc(
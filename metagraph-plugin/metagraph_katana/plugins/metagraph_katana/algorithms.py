@@ -5,13 +5,49 @@ from metagraph import NodeID, abstract_algorithm, concrete_algorithm
 from metagraph.plugins.core.types import Graph, Vector
 from metagraph.plugins.networkx.types import NetworkXGraph
 from metagraph.plugins.numpy.types import NumpyNodeMap, NumpyVectorType
+from metagraph.plugins.python.types import PythonNodeMapType
 
-from katana.local.analytics import bfs, jaccard, local_clustering_coefficient
+from katana.local.analytics import (
+    BfsPlan,
+    ConnectedComponentsPlan,
+    bfs_batch,
+    connected_components,
+    jaccard,
+    local_clustering_coefficient,
+)
 
 from .types import KatanaGraph
 
+# Graphs with at least this many edges per node get the plans which pay off on dense, low diameter graphs.
+DIRECTION_OPT_MIN_AVERAGE_DEGREE = 8
+AFFOREST_MIN_AVERAGE_DEGREE = 4
 
 
+def _average_degree(graph: KatanaGraph) -> float:
+    return graph.value.num_edges() / max(graph.value.num_nodes(), 1)
+
+
+def bfs_plan(graph: KatanaGraph) -> BfsPlan:
+    """
+    Choose the BFS plan for ``graph`` from its statistics: direction optimization when the frontier grows quickly
+    (dense, low diameter graphs such as social networks), and the asynchronous tiled algorithm otherwise (sparse,
+    high diameter graphs such as road networks).
+    """
+    if _average_degree(graph) >= DIRECTION_OPT_MIN_AVERAGE_DEGREE:
+        return BfsPlan.synchronous_direction_opt()
+    return BfsPlan.asynchronous_tile()
+
+
+def connected_components_plan(graph: KatanaGraph) -> ConnectedComponentsPlan:
+    """
+    Choose the connected components plan for ``graph`` from its statistics: Afforest, which finds the largest
+    component by sampling a few edges of each node, when nodes have enough edges for the sampling to pay off, and
+    the asynchronous union-find algorithm otherwise.
+    """
+    if _average_degree(graph) >= AFFOREST_MIN_AVERAGE_DEGREE:
+        return ConnectedComponentsPlan.afforest()
+    return ConnectedComponentsPlan.asynchronous()
+
 
 # breadth-first search,
 @concrete_algorithm("traversal.bfs_iter")
@@ -27,18 +63,30 @@ def kg_bfs_iter(graph: KatanaGraph, source_node: NodeID, depth_limit: int) -> Nu
     :return: the BFS traversal result in order
     :rtype: NumpyVectorType
     '''
-    bfs_prop_name = "bfs_prop_start_from_" + str(source_node)
-    start_node = source_node
-    bfs(graph.value, start_node, bfs_prop_name)
-    pg_bfs_list = graph.value.get_node_property(bfs_prop_name).to_pandas().values.tolist()
-    new_list = [[i, pg_bfs_list[i]] for i in range(len(pg_bfs_list)) if pg_bfs_list[i] < depth_limit]
-    sorted_list = sorted(new_list, key=lambda each: (each[1], each[0]))
-    bfs_arr = np.array([each[0] for each in sorted_list])
-    return bfs_arr
+    # bfs_batch returns the levels as a table instead of adding a property to the graph
+    levels = bfs_batch(graph.value, [source_node], bfs_plan(graph)).column(0).to_numpy()
+    reached = np.flatnonzero(levels < depth_limit)
+    # order the nodes by level, and by ID within a level
+    return reached[np.lexsort((reached, levels[reached]))]
+
+
+@concrete_algorithm("clustering.connected_components")
+def kg_connected_components(graph: KatanaGraph) -> PythonNodeMapType:
+    """
+    Label the nodes of an undirected graph with their components with the plan chosen by
+    `connected_components_plan`.
+    """
+    prop_name = "_metagraph_connected_components"
+    connected_components(graph.value, prop_name, connected_components_plan(graph))
+    try:
+        components = graph.value.get_node_property(prop_name).to_numpy()
+    finally:
+        graph.value.remove_node_property(prop_name)
+    return dict(enumerate(components.tolist()))
+
 
 # TODO(pengfei):
 # single-source shortest path
-# connected components
 # PageRank
 # betweenness centrality
 # triangle counting
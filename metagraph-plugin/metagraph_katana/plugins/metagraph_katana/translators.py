@@ -4,6 +4,7 @@ import numpy as np
 import pyarrow as pa
 from metagraph import translator
 from metagraph.plugins.networkx.types import NetworkXGraph
+from metagraph.plugins.scipy.types import ScipyGraph
 from scipy.sparse import csr_matrix
 
 import katana.local
@@ -12,49 +13,89 @@ from katana.local.import_data import from_csr
 
 from .types import KatanaGraph
 
+# networkx 2.7 renamed to_scipy_sparse_matrix
+_to_scipy_sparse = getattr(nx, "to_scipy_sparse_array", None) or nx.to_scipy_sparse_matrix
 
-@translator
-def networkx_to_katanagraph(x: NetworkXGraph, **props) -> KatanaGraph:
-    aprops = NetworkXGraph.Type.compute_abstract_properties(x, {"node_dtype", "node_type", "edge_type", "is_directed"})
-    is_weighted = aprops["edge_type"] == "map"
-    # get the edge list directly from the NetworkX Graph
-    elist_raw = list(x.value.edges(data=True))
-    # sort the eddge list and node list
-    if aprops["is_directed"]:
-        elist = sorted(elist_raw, key=lambda each: (each[0], each[1]))
-    else:
-        inv_elist = [(each[1], each[0], each[2]) for each in elist_raw]
-        elist = sorted(elist_raw + inv_elist, key=lambda each: (each[0], each[1]))
-    nlist = sorted(list(x.value.nodes(data=True)), key=lambda each: each[0])
-    # build the CSR format from the edge list (weight, (src, dst))
-    row = np.array([each_edge[0] for each_edge in elist])
-    col = np.array([each_edge[1] for each_edge in elist])
-    data = np.array([each_edge[2]["weight"] for each_edge in elist])
-    csr = csr_matrix((data, (row, col)), shape=(len(nlist), len(nlist)))
-    # call the katana api to build a PropertyGraph (unweighted) from the CSR format
-    # noting that the first 0 in csr.indptr is excluded
-    pg = from_csr(csr.indptr[1:], csr.indices)
-    # add the edge weight as a new property
-    t = pa.table(dict(value_from_translator=data))
-    pg.add_edge_property(t)
-    # use the metagraph's Graph warpper to wrap the PropertyGraph
+
+def _katanagraph_from_csr(matrix, is_weighted, is_directed, edge_dtype="int") -> KatanaGraph:
+    """
+    Build a KatanaGraph from a scipy CSR matrix. The edge weights (the data of the matrix) are wrapped as an Arrow
+    array without copying them, so only the topology is copied into the graph.
+    """
+    matrix = matrix.tocsr()
+    if not matrix.has_sorted_indices:
+        matrix = matrix.sorted_indices()
+    # from_csr takes the index one past the last edge of each node, so the first 0 in indptr is excluded
+    pg = from_csr(matrix.indptr[1:], matrix.indices)
+    pg.add_edge_property(pa.table(dict(value_from_translator=pa.array(matrix.data))))
     return KatanaGraph(
         pg_graph=pg,
         is_weighted=is_weighted,
         edge_weight_prop_name="value_from_translator",
-        is_directed=aprops["is_directed"],
+        is_directed=is_directed,
         node_weight_index=0,
+        edge_dtype=edge_dtype,
     )
 
 
+def _katanagraph_csr_arrays(x: KatanaGraph):
+    """
+    Return ``(indptr, indices, data)`` of the CSR matrix of a KatanaGraph. ``indices`` and ``data`` share the memory
+    of the graph (``indices`` is reinterpreted as signed, as scipy requires, which is exact since node IDs are less
+    than 2^31 whenever it is done) and ``indptr`` is the only array of the topology that is copied.
+    """
+    pg = x.value
+    adj_indices = pg.adj_indices()
+    indptr = np.empty(len(adj_indices) + 1, dtype=np.int64)
+    indptr[0] = 0
+    indptr[1:] = adj_indices
+    indices = pg.dests()
+    if pg.num_nodes() < 2 ** 31:
+        indices = indices.view(np.int32)
+    if x.is_weighted:
+        data = pg.get_edge_property(x.edge_weight_prop_name).to_numpy()
+    else:
+        data = np.ones(pg.num_edges(), dtype=bool)
+    return indptr, indices, data
+
+
+@translator
+def networkx_to_katanagraph(x: NetworkXGraph, **props) -> KatanaGraph:
+    aprops = NetworkXGraph.Type.compute_abstract_properties(x, {"node_dtype", "node_type", "edge_type", "is_directed"})
+    is_weighted = aprops["edge_type"] == "map"
+    # The adjacency matrix of an undirected graph is symmetric, so it has both directions of each edge
+    matrix = _to_scipy_sparse(x.value, nodelist=sorted(x.value.nodes()), weight="weight", format="csr")
+    return _katanagraph_from_csr(matrix, is_weighted, aprops["is_directed"])
+
+
 @translator
 def katanagraph_to_networkx(x: KatanaGraph, **props) -> NetworkXGraph:
-    elist = []
-    edge_weights = x.value.get_edge_property(x.edge_weight_prop_name).to_pandas()
-    elist = [(nid, x.value.get_edge_dest(j), edge_weights[j]) for nid in x.value for j in x.value.edges(nid)]
+    indptr, dests, edge_weights = _katanagraph_csr_arrays(x)
+    sources = np.repeat(np.arange(x.value.num_nodes()), np.diff(indptr))
     if x.is_directed:
         graph = nx.DiGraph()
     else:
         graph = nx.Graph()
-    graph.add_weighted_edges_from(elist)
+    if x.is_weighted:
+        graph.add_weighted_edges_from(zip(sources.tolist(), dests.tolist(), edge_weights.tolist()))
+    else:
+        graph.add_edges_from(zip(sources.tolist(), dests.tolist()))
     return mg.wrappers.Graph.NetworkXGraph(graph)
+
+
+@translator
+def scipygraph_to_katanagraph(x: ScipyGraph, **props) -> KatanaGraph:
+    aprops = ScipyGraph.Type.compute_abstract_properties(x, {"edge_type", "edge_dtype", "is_directed"})
+    return _katanagraph_from_csr(
+        x.value, aprops["edge_type"] == "map", aprops["is_directed"], aprops.get("edge_dtype") or "int"
+    )
+
+
+@translator
+def katanagraph_to_scipygraph(x: KatanaGraph, **props) -> ScipyGraph:
+    indptr, indices, data = _katanagraph_csr_arrays(x)
+    num_nodes = x.value.num_nodes()
+    matrix = csr_matrix((data, indices, indptr), shape=(num_nodes, num_nodes), copy=False)
+    return ScipyGraph(
+        matrix, aprops={"is_directed": x.is_directed, "edge_type": "map" if x.is_weighted else "set"}
+    )
@@ -28,6 +28,21 @@ def test_bfs(networkx_weighted_directed_8_12, kg_from_nx_di_8_12):
     assert bfs2_kg.tolist() == [2, 4, 5, 6, 7]
 
 
+def test_plan_choice(kg_from_nx_di_8_12, katanagraph_rmat15_cleaned_di):
+    from katana.local.analytics import BfsPlan, ConnectedComponentsPlan
+    from metagraph_katana.plugins.metagraph_katana.algorithms import bfs_plan, connected_components_plan
+
+    # 12 edges on 8 nodes
+    assert bfs_plan(kg_from_nx_di_8_12).algorithm == BfsPlan.asynchronous_tile().algorithm
+    assert connected_components_plan(kg_from_nx_di_8_12).algorithm == ConnectedComponentsPlan.asynchronous().algorithm
+    # about 11 edges per node
+    assert bfs_plan(katanagraph_rmat15_cleaned_di).algorithm == BfsPlan.synchronous_direction_opt().algorithm
+    assert (
+        connected_components_plan(katanagraph_rmat15_cleaned_di).algorithm
+        == ConnectedComponentsPlan.afforest().algorithm
+    )
+
+
 def test_sssp_bellman_ford(networkx_weighted_directed_8_12, kg_from_nx_di_8_12):
     src_node = 0
     sssp_nx = mg.algos.traversal.bellman_ford(networkx_weighted_directed_8_12, src_node)  # source node is 0
@@ -92,3 +92,16 @@ def test_num_edges(nx_from_kg_rmat15_cleaned_di, katanagraph_rmat15_cleaned_di):
             if (src, dest) in edge_dict_count:
                 edge_dict_count[(src, dest)] += 1
     assert sum([edge_dict_count[i] for i in edge_dict_count]) == katanagraph_rmat15_cleaned_di.value.num_edges()
+
+
+def test_scipy_round_trip(kg_from_nx_di_8_12):
+    sg = mg.translate(kg_from_nx_di_8_12, mg.wrappers.Graph.ScipyGraph)
+    matrix = sg.value
+    assert matrix.shape == (8, 8)
+    assert matrix.nnz == 12
+    assert matrix[0].indices.tolist() == [1, 3, 4]
+    assert matrix.data.tolist() == [4, 2, 7, 3, 5, 5, 2, 8, 1, 4, 4, 6]
+    kg = mg.translate(sg, mg.wrappers.Graph.KatanaGraph)
+    assert kg.value.num_edges() == 12
+    assert [kg.value.get_edge_dest(i) for i in kg.value.edges(2)] == [4, 5, 6]
+    assert kg.value.get_edge_property("value_from_translator").tolist() == matrix.data.tolist()
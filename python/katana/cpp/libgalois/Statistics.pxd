@@ -0,0 +1,26 @@
+from libc.stdint cimport int64_t
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+
+cdef extern from "katana/Statistics.h" namespace "katana" nogil:
+    cdef enum StatTotalType "katana::StatTotal::Type":
+        SINGLE "katana::StatTotal::SINGLE"
+        TMIN "katana::StatTotal::TMIN"
+        TMAX "katana::StatTotal::TMAX"
+        TSUM "katana::StatTotal::TSUM"
+        TAVG "katana::StatTotal::TAVG"
+
+    cppclass StatRecord[T]:
+        string region
+        string category
+        StatTotalType type
+        T total
+        vector[T] thread_values
+
+    cppclass StatSnapshot:
+        vector[StatRecord[int64_t]] ints
+        vector[StatRecord[double]] fps
+        vector[StatRecord[string]] params
+
+    StatSnapshot GetStatSnapshot()
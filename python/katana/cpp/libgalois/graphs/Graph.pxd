@@ -18,6 +18,7 @@ cdef extern from "tsuba/RDG.h" namespace "tsuba" nogil:
         optional[uint32_t] partition_id_to_load
         optional[vector[string]] node_properties
         optional[vector[string]] edge_properties
+        bint out_of_core_topology
 
 
 # Omit the exception specifications here to
@@ -130,6 +131,24 @@ cdef extern from "katana/Graph.h" namespace "katana" nogil:
         uint64_t num_nodes() const
         uint64_t num_edges() const
 
+        bint is_compact() const
+        const Edge* adj_data() const
+        const uint32_t* compact_adj_data() const
+        const Node* dest_data() const
+
+    cdef enum TransposeKind "katana::EdgeShuffleTopology::TransposeKind":
+        kNo "katana::EdgeShuffleTopology::TransposeKind::kNo"
+        kYes "katana::EdgeShuffleTopology::TransposeKind::kYes"
+
+    cdef enum EdgeSortKind "katana::EdgeShuffleTopology::EdgeSortKind":
+        kAny "katana::EdgeShuffleTopology::EdgeSortKind::kAny"
+        kSortedByDestID "katana::EdgeShuffleTopology::EdgeSortKind::kSortedByDestID"
+        kSortedByEdgeType "katana::EdgeShuffleTopology::EdgeSortKind::kSortedByEdgeType"
+
+    cppclass EdgeShuffleTopology(GraphTopology):
+        bint is_transposed() const
+        const uint64_t* edge_property_index_data() const
+
     cppclass _PropertyGraph "katana::PropertyGraph":
         PropertyGraph()
         PropertyGraph(GraphTopology&&)
@@ -143,6 +162,7 @@ cdef extern from "katana/Graph.h" namespace "katana" nogil:
         Result[void] Commit(string command_line)
 
         GraphTopology& topology()
+        const EdgeShuffleTopology& GetEdgeShuffleTopology(TransposeKind, EdgeSortKind)
 
         shared_ptr[CSchema] loaded_node_schema()
         shared_ptr[CSchema] loaded_edge_schema()
@@ -189,6 +209,11 @@ cdef extern from "katana/BuildGraph.h" namespace "katana" nogil:
 
         void Dump()
 
+cdef extern from "katana/TableImport.h" namespace "katana" nogil:
+    Result[GraphComponents] ConvertEdgeArrays(
+        const shared_ptr[CChunkedArray]& sources, const shared_ptr[CChunkedArray]& destinations, uint64_t num_nodes,
+        shared_ptr[CTable] node_properties, shared_ptr[CTable] edge_properties)
+
 cdef extern from "katana/GraphML.h" namespace "katana" nogil:
     Result[unique_ptr[_PropertyGraph]] ConvertToPropertyGraph(GraphComponents&& graph_comps);
 
@@ -0,0 +1,55 @@
+from libc.stdint cimport int64_t, uint64_t
+from libcpp.memory cimport shared_ptr
+from libcpp.pair cimport pair
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+
+cdef extern from "katana/ProgressTracer.h" namespace "katana" nogil:
+    cppclass Value:
+        pass
+
+    ctypedef vector[pair[string, Value]] Tags
+
+    cppclass ProgressSpan:
+        void SetTags(const Tags&)
+        void Log(const string&, const Tags&)
+        void MarkScopeClosed()
+        bint IsFinished()
+
+    cppclass ProgressTracer:
+        @staticmethod
+        ProgressTracer& Get()
+
+        @staticmethod
+        uint64_t ParseProcSelfRssBytes()
+
+        @staticmethod
+        long GetMaxMem()
+
+        shared_ptr[ProgressSpan] StartActiveSpanUnscoped(const string&)
+        bint HasActiveSpan()
+
+
+# katana::Value is a variant without a default constructor, which Cython cannot build pairs of, so tags are added here.
+cdef extern from * nogil:
+    """
+    #include "katana/ProgressTracer.h"
+
+    inline void KatanaAddBoolTag(katana::Tags* tags, const std::string& key, bool v) {
+      tags->emplace_back(key, katana::Value(v));
+    }
+    inline void KatanaAddIntTag(katana::Tags* tags, const std::string& key, int64_t v) {
+      tags->emplace_back(key, katana::Value(v));
+    }
+    inline void KatanaAddDoubleTag(katana::Tags* tags, const std::string& key, double v) {
+      tags->emplace_back(key, katana::Value(v));
+    }
+    inline void KatanaAddStringTag(katana::Tags* tags, const std::string& key, const std::string& v) {
+      tags->emplace_back(key, katana::Value(v));
+    }
+    """
+    void AddBoolTag "KatanaAddBoolTag"(Tags*, const string&, bint)
+    void AddIntTag "KatanaAddIntTag"(Tags*, const string&, int64_t)
+    void AddDoubleTag "KatanaAddDoubleTag"(Tags*, const string&, double)
+    void AddStringTag "KatanaAddStringTag"(Tags*, const string&, const string&)
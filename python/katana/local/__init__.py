@@ -1,5 +1,11 @@
 # Register numba overloads
 import katana.native_interfacing.pyarrow
+from katana.local._shared_graph import (
+    attach_shared_graph,
+    publish_shared_graph,
+    remove_unused_shared_graphs,
+    shared_graph_versions,
+)
 from katana.local._shared_mem_sys import initialize
 from katana.local.atomic import (
     ReduceLogicalAnd,
@@ -33,7 +39,11 @@ __all__ = [
     "atomic_max",
     "atomic_min",
     "atomic_sub",
+    "attach_shared_graph",
     "get_fast_barrier",
     "initialize",
+    "publish_shared_graph",
+    "remove_unused_shared_graphs",
+    "shared_graph_versions",
     "AllocationPolicy",
 ]
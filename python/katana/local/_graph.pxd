@@ -32,6 +32,8 @@ cdef class GraphBase:
 
     cpdef uint64_t get_edge_dest(PropertyGraphInterface, uint64_t)
 
+    cdef _adj_indices(self, const GraphTopology*)
+
 cdef class Graph(GraphBase):
     cdef:
         shared_ptr[_PropertyGraph] _underlying_property_graph
@@ -1,12 +1,14 @@
 import numpy
 import pyarrow
 
-from pyarrow.lib cimport pyarrow_unwrap_table, pyarrow_wrap_chunked_array, pyarrow_wrap_schema, to_shared
+from pyarrow.lib cimport pyarrow_unwrap_table, pyarrow_wrap_chunked_array, pyarrow_wrap_schema, pyarrow_wrap_table, to_shared
 
 from katana.cpp.libgalois.graphs cimport Graph as CGraph
 from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
 
 from katana.native_interfacing._pyarrow_wrappers import unchunked
+from katana.native_interfacing.interchange import ArrowStream, DLPackArray
+from katana.native_interfacing.pyarrow import array_view
 
 from . cimport datastructures
 
@@ -18,7 +20,7 @@ from libcpp.memory cimport shared_ptr, unique_ptr
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 
-from ..native_interfacing.buffer_access cimport to_pyarrow
+from ..native_interfacing.buffer_access cimport numpy_view, to_pyarrow
 
 __all__ = ["GraphBase", "Graph"]
 
@@ -58,6 +60,7 @@ cdef class GraphBase:
         if path is None:
             with nogil:
                 handle_result_void(self.underlying_property_graph().Commit(command_line_str))
+            return
         path_str = <string>bytes(str(path), "utf-8")
         with nogil:
             handle_result_void(self.underlying_property_graph().Write(path_str, command_line_str))
@@ -69,7 +72,10 @@ cdef class GraphBase:
         return self.topology().num_nodes()
 
     def __eq__(self, Graph other):
-        return self.underlying_property_graph().Equals(other.underlying_property_graph())
+        cdef bint equal
+        with nogil:
+            equal = self.underlying_property_graph().Equals(other.underlying_property_graph())
+        return equal
 
     def __len__(self):
         """
@@ -161,6 +167,55 @@ cdef class GraphBase:
             raise IndexError(e)
         return self.topology().edge_dest(e)
 
+    cdef _adj_indices(self, const GraphTopology* topo):
+        if topo.is_compact():
+            return numpy_view(topo.compact_adj_data(), topo.num_nodes(), numpy.uint32, self)
+        return numpy_view(topo.adj_data(), topo.num_nodes(), numpy.uint64, self)
+
+    def adj_indices(self):
+        """
+        Return a read-only numpy array of the index one past the last outgoing edge of each node, so that the edges
+        of node ``n`` are ``adj_indices[n-1]`` (or 0) to ``adj_indices[n]``. The array shares the memory of the graph
+        and is valid as long as the graph is alive. Its type is ``uint32`` if the topology is compact.
+        """
+        return self._adj_indices(self.topology())
+
+    def dests(self):
+        """
+        Return a read-only numpy array of the destination node ID of each edge. The array shares the memory of the
+        graph and is valid as long as the graph is alive.
+        """
+        return numpy_view(self.topology().dest_data(), self.num_edges(), numpy.uint32, self)
+
+    def shuffled_topology(self, bint transpose=False, edges_sorted_by=None):
+        """
+        Return read-only numpy arrays ``(adj_indices, dests, edge_property_indices)`` of a topology derived from this
+        one, as used by the views of this graph: its edges are reversed if ``transpose`` is true, and the edges of
+        each node are sorted by destination if ``edges_sorted_by`` is ``"dest"`` or by type if it is ``"type"``. The
+        topology is built the first time it is needed and kept with the graph; the arrays share its memory.
+
+        Node IDs are those of this graph. ``edge_property_indices`` maps the edges of the topology to the indices of
+        their edge properties.
+        """
+        cdef CGraph.EdgeSortKind sort_kind
+        cdef const CGraph.EdgeShuffleTopology* topo
+        if edges_sorted_by is None:
+            sort_kind = CGraph.kAny
+        elif edges_sorted_by == "dest":
+            sort_kind = CGraph.kSortedByDestID
+        elif edges_sorted_by == "type":
+            sort_kind = CGraph.kSortedByEdgeType
+        else:
+            raise ValueError(edges_sorted_by)
+        with nogil:
+            topo = &self.underlying_property_graph().GetEdgeShuffleTopology(
+                CGraph.kYes if transpose else CGraph.kNo, sort_kind)
+        return (
+            self._adj_indices(topo),
+            numpy_view(topo.dest_data(), topo.num_edges(), numpy.uint32, self),
+            numpy_view(topo.edge_property_index_data(), topo.num_edges(), numpy.uint64, self),
+        )
+
     def get_node_property(self, prop):
         """
         Return a `pyarrow` array or chunked array storing the data for node property `prop`.
@@ -179,6 +234,15 @@ cdef class GraphBase:
             self.underlying_property_graph().GetNodeProperty(Graph._property_name_to_id(prop, self.loaded_node_schema()))
         )
 
+    def get_node_property_view(self, prop):
+        """
+        Return a `katana.native_interfacing.pyarrow.ArrowArrayView` of node property `prop`, which must be of integers
+        or floating point numbers. Numba code, such as operators, indexes ``view.values`` directly and checks for nulls
+        with ``view.is_valid(n)``. The view shares the memory of the property unless the property has many chunks.
+        `prop` may be either a name or an index.
+        """
+        return array_view(self.get_node_property_chunked(prop))
+
     def get_edge_property(self, prop):
         """
         Return a `pyarrow` array or chunked array storing the data for edge property `prop`.
@@ -197,6 +261,42 @@ cdef class GraphBase:
             self.underlying_property_graph().GetEdgeProperty(Graph._property_name_to_id(prop, self.loaded_edge_schema()))
         )
 
+    def get_edge_property_view(self, prop):
+        """
+        Return a `katana.native_interfacing.pyarrow.ArrowArrayView` of edge property `prop`, which must be of integers
+        or floating point numbers. See `get_node_property_view`.
+        `prop` may be either a name or an index.
+        """
+        return array_view(self.get_edge_property_chunked(prop))
+
+    def export_node_properties(self, *properties):
+        """
+        Return the node properties named or indexed by ``properties`` (all loaded node properties if there are none)
+        as a `katana.native_interfacing.interchange.ArrowStream`, which libraries that support the Arrow C stream
+        interface import without copying.
+        """
+        table = pyarrow_wrap_table(self.underlying_property_graph().node_properties())
+        if properties:
+            table = table.select(list(properties))
+        return ArrowStream(table)
+
+    def export_edge_properties(self, *properties):
+        """
+        Return the edge properties named or indexed by ``properties`` (all loaded edge properties if there are none)
+        as a `katana.native_interfacing.interchange.ArrowStream`. See `export_node_properties`.
+        """
+        table = pyarrow_wrap_table(self.underlying_property_graph().edge_properties())
+        if properties:
+            table = table.select(list(properties))
+        return ArrowStream(table)
+
+    def export_topology(self):
+        """
+        Return `adj_indices` and `dests` as `katana.native_interfacing.interchange.DLPackArray` objects, which
+        ``torch.from_dlpack`` and other DLPack importers wrap without copying. They must not be written to.
+        """
+        return DLPackArray(self.adj_indices()), DLPackArray(self.dests())
+
     @staticmethod
     cdef shared_ptr[CTable] _convert_table(object table, dict kwargs) except *:
         if isinstance(table, pyarrow.Table):
@@ -222,7 +322,9 @@ cdef class GraphBase:
             length ``self.num_nodes()``. (Optional)
         :param kwargs: Properties to add. The values must be arrays or sequences of length ``self.num_nodes()``. (Optional)
         """
-        handle_result_void(self.underlying_property_graph().AddNodeProperties(GraphBase._convert_table(table, kwargs)))
+        cdef shared_ptr[CTable] properties = GraphBase._convert_table(table, kwargs)
+        with nogil:
+            handle_result_void(self.underlying_property_graph().AddNodeProperties(properties))
 
     def upsert_node_property(self, table=None, **kwargs):
         """
@@ -232,7 +334,9 @@ cdef class GraphBase:
             length ``self.num_nodes()``. (Optional)
         :param kwargs: Properties to add. The values must be arrays or sequences of length ``self.num_nodes()``. (Optional)
         """
-        handle_result_void(self.underlying_property_graph().UpsertNodeProperties(GraphBase._convert_table(table, kwargs)))
+        cdef shared_ptr[CTable] properties = GraphBase._convert_table(table, kwargs)
+        with nogil:
+            handle_result_void(self.underlying_property_graph().UpsertNodeProperties(properties))
 
     def add_edge_property(self, table=None, **kwargs):
         """
@@ -242,7 +346,9 @@ cdef class GraphBase:
             length ``self.num_edges()``. (Optional)
         :param kwargs: Properties to add. The values must be arrays or sequences of length ``self.num_edges()``. (Optional)
         """
-        handle_result_void(self.underlying_property_graph().AddEdgeProperties(GraphBase._convert_table(table, kwargs)))
+        cdef shared_ptr[CTable] properties = GraphBase._convert_table(table, kwargs)
+        with nogil:
+            handle_result_void(self.underlying_property_graph().AddEdgeProperties(properties))
 
     def upsert_edge_property(self, table=None, **kwargs):
         """
@@ -252,19 +358,25 @@ cdef class GraphBase:
             length ``self.num_edges()``. (Optional)
         :param kwargs: Properties to add. The values must be arrays or sequences of length ``self.num_edges()``. (Optional)
         """
-        handle_result_void(self.underlying_property_graph().UpsertEdgeProperties(GraphBase._convert_table(table, kwargs)))
+        cdef shared_ptr[CTable] properties = GraphBase._convert_table(table, kwargs)
+        with nogil:
+            handle_result_void(self.underlying_property_graph().UpsertEdgeProperties(properties))
 
     def remove_node_property(self, prop):
         """
         Remove a node property from the graph by name or index.
         """
-        handle_result_void(self.underlying_property_graph().RemoveNodeProperty(Graph._property_name_to_id(prop, self.loaded_node_schema())))
+        cdef int pid = Graph._property_name_to_id(prop, self.loaded_node_schema())
+        with nogil:
+            handle_result_void(self.underlying_property_graph().RemoveNodeProperty(pid))
 
     def remove_edge_property(self, prop):
         """
         Remove an edge property from the graph by name or index.
         """
-        handle_result_void(self.underlying_property_graph().RemoveEdgeProperty(Graph._property_name_to_id(prop, self.loaded_edge_schema())))
+        cdef int pid = Graph._property_name_to_id(prop, self.loaded_edge_schema())
+        with nogil:
+            handle_result_void(self.underlying_property_graph().RemoveEdgeProperty(pid))
 
     @property
     def path(self):
@@ -288,9 +400,12 @@ cdef class Graph(GraphBase):
     cdef _PropertyGraph * underlying_property_graph(self) nogil except NULL:
         return self._underlying_property_graph.get()
 
-    def __init__(self, path, node_properties=None, edge_properties=None, partition_id_to_load=None):
+    def __init__(
+        self, path, node_properties=None, edge_properties=None, partition_id_to_load=None, out_of_core_topology=False
+    ):
         """
-        __init__(self, path, node_properties=None, edge_properties=None, partition_id_to_load=None)
+        __init__(self, path, node_properties=None, edge_properties=None, partition_id_to_load=None,
+                 out_of_core_topology=False)
 
         Load a property graph.
 
@@ -302,6 +417,9 @@ cdef class Graph(GraphBase):
             properties are loaded.
         :param edge_properties: A list of edge property names to load into memory. If this is None (default), then all
             properties are loaded.
+        :param out_of_core_topology: If True, map the topology from storage instead of reading it into memory, so that
+            graphs larger than memory can be traversed. Only uncompressed topologies on local storage are mapped; others
+            are read as usual.
         """
         cdef CGraph.RDGLoadOptions opts
         cdef vector[string] node_props
@@ -318,6 +436,7 @@ cdef class Graph(GraphBase):
         if edge_properties is not None:
             edge_props = _convert_string_list(edge_properties)
             opts.edge_properties = edge_props
+        opts.out_of_core_topology = out_of_core_topology
         path_str = <string>bytes(str(path), "utf-8")
         with nogil:
             self._underlying_property_graph = handle_result_PropertyGraph(_PropertyGraph.Make(path_str, opts))
@@ -2,6 +2,7 @@ from libc.stdint cimport uint64_t
 from libcpp.memory cimport make_shared, shared_ptr, unique_ptr
 from libcpp.string cimport string
 from libcpp.utility cimport move
+from pyarrow.lib cimport CChunkedArray, CTable, pyarrow_unwrap_chunked_array
 
 from . cimport datastructures
 
@@ -9,7 +10,11 @@ from . import datastructures
 
 from katana.cpp.libgalois.graphs cimport Graph as CGraph
 from katana.cpp.libsupport.result cimport Result, raise_error_code
-from katana.local._graph cimport Graph, handle_result_PropertyGraph
+from katana.local._graph cimport Graph, GraphBase, handle_result_PropertyGraph
+
+import pyarrow
+
+from katana.native_interfacing.buffer_access import to_pyarrow
 
 
 cdef CGraph.GraphComponents handle_result_GraphComponents(Result[CGraph.GraphComponents] res) nogil except *:
@@ -47,6 +52,52 @@ def from_csr(edge_indices, edge_destinations):
     return Graph.make(pg)
 
 
+cdef shared_ptr[CChunkedArray] _to_chunked_array(object ids) except *:
+    if isinstance(ids, pyarrow.ChunkedArray):
+        return pyarrow_unwrap_chunked_array(ids)
+    return pyarrow_unwrap_chunked_array(pyarrow.chunked_array([to_pyarrow(ids)]))
+
+
+def from_edge_arrays(sources, destinations, uint64_t num_nodes=0, node_properties=None, edge_properties=None):
+    """
+    Create a new `Graph` from an edge list of parallel arrays of node IDs, edge ``e`` going from ``sources[e]`` to
+    ``destinations[e]``.
+
+    The compressed sparse row topology is built in parallel, with a counting sort of the edges by source, without
+    the GIL. The edges of a node keep the order of the arrays, and the rows of ``edge_properties`` are reordered to
+    match. Integer numpy arrays and Arrow arrays without nulls are read without a copy.
+
+    :param sources: The source node IDs of the edges.
+    :type sources: `numpy.ndarray`, `pyarrow.Array`, or `pyarrow.ChunkedArray` of integers
+    :param destinations: The destination node IDs of the edges.
+    :type destinations: `numpy.ndarray`, `pyarrow.Array`, or `pyarrow.ChunkedArray` of integers
+    :param num_nodes: The number of nodes. If it is 0, the graph has as many nodes as there are rows of
+        ``node_properties`` or, without them, one more than the largest node ID.
+    :param node_properties: Properties of the nodes, one row per node.
+    :type node_properties: `pyarrow.Table`, or anything `pyarrow.table` accepts, such as a dict or a DataFrame
+    :param edge_properties: Properties of the edges, one row per edge in the order of ``sources``.
+    :type edge_properties: `pyarrow.Table`, or anything `pyarrow.table` accepts, such as a dict or a DataFrame
+    :returns: the new :py:class:`~katana.local.Graph`
+    """
+    cdef shared_ptr[CChunkedArray] c_sources = _to_chunked_array(sources)
+    cdef shared_ptr[CChunkedArray] c_destinations = _to_chunked_array(destinations)
+    cdef shared_ptr[CTable] c_node_properties = GraphBase._convert_table(node_properties, {})
+    cdef shared_ptr[CTable] c_edge_properties = GraphBase._convert_table(edge_properties, {})
+    with nogil:
+        pg = handle_result_PropertyGraph(
+            CGraph.ConvertToPropertyGraph(
+                move(
+                    handle_result_GraphComponents(
+                        CGraph.ConvertEdgeArrays(
+                            c_sources, c_destinations, num_nodes, c_node_properties, c_edge_properties
+                        )
+                    )
+                )
+            )
+        )
+    return Graph.make(pg)
+
+
 def from_graphml(path, uint64_t chunk_size=25000):
     """
     Load a GraphML file into Katana form.
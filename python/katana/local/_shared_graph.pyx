@@ -0,0 +1,87 @@
+from libc.stdint cimport uint64_t
+from libcpp cimport bool
+from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.optional cimport nullopt, optional
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+from katana.local._graph cimport Graph, handle_result_PropertyGraph
+
+
+cdef extern from "katana/SharedGraph.h" namespace "katana" nogil:
+    Result[uint64_t] PublishSharedGraph(const _PropertyGraph& pg, const string& name)
+    Result[unique_ptr[_PropertyGraph]] AttachSharedGraph(const string& name, optional[uint64_t] version)
+    Result[vector[uint64_t]] SharedGraphVersions(const string& name)
+    Result[uint64_t] RemoveUnusedSharedGraphs(const string& name, bool keep_latest)
+
+
+cdef uint64_t handle_result_uint64(Result[uint64_t] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef vector[uint64_t] handle_result_versions(Result[vector[uint64_t]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def publish_shared_graph(Graph graph, str name) -> int:
+    """
+    Copy the topology, entity types and loaded properties of `graph` into a new version of the shared graph `name`
+    in shared memory, under ``KATANA_SHARED_GRAPH_DIR`` (default ``/dev/shm/katana-graphs``), and remove the older
+    versions that no process has attached.
+
+    :return: The new version.
+    """
+    cdef string name_str = bytes(name, "utf-8")
+    with nogil:
+        version = handle_result_uint64(PublishSharedGraph(graph.underlying_property_graph()[0], name_str))
+    return version
+
+
+def attach_shared_graph(str name, version = None) -> Graph:
+    """
+    Make a read-only graph of a version of the shared graph `name`, by default the latest one, without copying its
+    topology or properties: every process attached to a version maps the same memory. The version is kept until the
+    graph, and the graphs sharing its topology, are freed, even after newer versions are published.
+    """
+    cdef string name_str = bytes(name, "utf-8")
+    cdef optional[uint64_t] version_opt = nullopt
+    cdef uint64_t version_value
+    if version is not None:
+        version_value = version
+        version_opt = version_value
+    cdef shared_ptr[_PropertyGraph] pg
+    with nogil:
+        pg = handle_result_PropertyGraph(AttachSharedGraph(name_str, version_opt))
+    return Graph.make(pg)
+
+
+def shared_graph_versions(str name):
+    """
+    :return: The published versions of the shared graph `name` in increasing order.
+    """
+    cdef string name_str = bytes(name, "utf-8")
+    cdef vector[uint64_t] versions
+    with nogil:
+        versions = handle_result_versions(SharedGraphVersions(name_str))
+    return list(versions)
+
+
+def remove_unused_shared_graphs(str name, bool keep_latest = True) -> int:
+    """
+    Remove the versions of the shared graph `name` that no process has attached, except the latest one if
+    `keep_latest`.
+
+    :return: The number of versions removed.
+    """
+    cdef string name_str = bytes(name, "utf-8")
+    with nogil:
+        num_removed = handle_result_uint64(RemoveUnusedSharedGraphs(name_str, keep_latest))
+    return num_removed
@@ -11,6 +11,22 @@ Plans
 
 .. autoclass:: katana.local.analytics.Plan
 
+.. _Workspace:
+
+Workspaces
+----------
+
+.. autoclass:: katana.local.analytics.Workspace
+    :members:
+
+.. _ResultCache:
+
+Result Caches
+-------------
+
+.. autoclass:: katana.local.analytics.ResultCache
+    :members:
+
 .. _Statistics:
 
 Statistics
@@ -26,8 +42,22 @@ Algorithms
 
 .. automodule:: katana.local.analytics._bfs
 
+.. automodule:: katana.local.analytics._biconnected_components
+
+.. automodule:: katana.local.analytics._bipartite_matching
+
+.. automodule:: katana.local.analytics._closeness_centrality
+
 .. automodule:: katana.local.analytics._connected_components
 
+.. automodule:: katana.local.analytics._eigenvector_centrality
+
+.. automodule:: katana.local.analytics._graph_coloring
+
+.. automodule:: katana.local.analytics._graphlet_census
+
+.. automodule:: katana.local.analytics._hits
+
 .. automodule:: katana.local.analytics._independent_set
 
 .. automodule:: katana.local.analytics._louvain_clustering
@@ -38,14 +68,40 @@ Algorithms
 
 .. automodule:: katana.local.analytics._jaccard
 
+.. automodule:: katana.local.analytics._k_clique
+
 .. automodule:: katana.local.analytics._k_core
 
+.. automodule:: katana.local.analytics._k_shortest_paths
+
 .. automodule:: katana.local.analytics._k_truss
 
+.. automodule:: katana.local.analytics._label_propagation
+
+.. automodule:: katana.local.analytics._matrix_completion
+
+.. automodule:: katana.local.analytics._max_flow
+
+.. automodule:: katana.local.analytics._minimum_spanning_forest
+
+.. automodule:: katana.local.analytics._neighbor_sampling
+
+.. automodule:: katana.local.analytics._neighborhood_function
+
 .. automodule:: katana.local.analytics._pagerank
 
+.. automodule:: katana.local.analytics._partition
+
+.. automodule:: katana.local.analytics._point_to_point
+
+.. automodule:: katana.local.analytics._random_walks
+
 .. automodule:: katana.local.analytics._sssp
 
+.. automodule:: katana.local.analytics._strongly_connected_components
+
+.. automodule:: katana.local.analytics._time_window
+
 .. automodule:: katana.local.analytics._triangle_count
 
 .. automodule:: katana.local.analytics._wrappers
@@ -59,22 +115,81 @@ from katana.local.analytics._betweenness_centrality import (
     BetweennessCentralityStatistics,
     betweenness_centrality,
 )
-from katana.local.analytics._bfs import BfsPlan, BfsStatistics, bfs, bfs_assert_valid
+from katana.local.analytics._bfs import BfsPlan, BfsStatistics, bfs, bfs_assert_valid, bfs_batch
+from katana.local.analytics._biconnected_components import (
+    NO_BICONNECTED_COMPONENT,
+    BiconnectedComponentsPlan,
+    BiconnectedComponentsStatistics,
+    biconnected_components,
+    biconnected_components_assert_valid,
+)
+from katana.local.analytics._bipartite_matching import (
+    BipartiteMatchingPlan,
+    BipartiteMatchingStatistics,
+    bipartite_matching,
+    bipartite_matching_assert_valid,
+)
+from katana.local.analytics._closeness_centrality import (
+    ClosenessCentralityPlan,
+    ClosenessCentralityStatistics,
+    closeness_centrality,
+    harmonic_centrality,
+)
 from katana.local.analytics._connected_components import (
     ConnectedComponentsPlan,
     ConnectedComponentsStatistics,
+    IncrementalConnectedComponents,
     connected_components,
     connected_components_assert_valid,
 )
+from katana.local.analytics._eigenvector_centrality import (
+    EigenvectorCentralityPlan,
+    EigenvectorCentralityStatistics,
+    KatzCentralityPlan,
+    eigenvector_centrality,
+    eigenvector_centrality_assert_valid,
+    katz_centrality,
+)
+from katana.local.analytics._graph_coloring import (
+    GraphColoringPlan,
+    GraphColoringStatistics,
+    graph_coloring,
+    graph_coloring_assert_valid,
+)
+from katana.local.analytics._graphlet_census import FourNodeGraphletCensus, four_cycle_count_per_node
+from katana.local.analytics._hits import HitsPlan, HitsStatistics, hits, hits_assert_valid
 from katana.local.analytics._independent_set import (
     IndependentSetPlan,
     IndependentSetStatistics,
     independent_set,
     independent_set_assert_valid,
 )
-from katana.local.analytics._jaccard import JaccardPlan, JaccardStatistics, jaccard, jaccard_assert_valid
-from katana.local.analytics._k_core import KCorePlan, KCoreStatistics, k_core, k_core_assert_valid
-from katana.local.analytics._k_truss import KTrussPlan, KTrussStatistics, k_truss, k_truss_assert_valid
+from katana.local.analytics._jaccard import JaccardPlan, JaccardStatistics, jaccard, jaccard_assert_valid, jaccard_top_k
+from katana.local.analytics._k_clique import KCliquePlan, k_clique_count, k_clique_count_per_node
+from katana.local.analytics._k_core import (
+    KCoreDecompositionStatistics,
+    KCorePlan,
+    KCoreStatistics,
+    k_core,
+    k_core_assert_valid,
+    k_core_batch,
+    k_core_decomposition,
+)
+from katana.local.analytics._k_shortest_paths import KShortestPathsPlan, KShortestPathsQuery, k_shortest_paths
+from katana.local.analytics._k_truss import (
+    KTrussDecompositionStatistics,
+    KTrussPlan,
+    KTrussStatistics,
+    k_truss,
+    k_truss_assert_valid,
+    k_truss_decomposition,
+)
+from katana.local.analytics._label_propagation import (
+    LabelPropagationPlan,
+    LabelPropagationStatistics,
+    label_propagation,
+    label_propagation_assert_valid,
+)
 from katana.local.analytics._local_clustering_coefficient import (
     LocalClusteringCoefficientPlan,
     local_clustering_coefficient,
@@ -85,9 +200,65 @@ from katana.local.analytics._louvain_clustering import (
     louvain_clustering,
     louvain_clustering_assert_valid,
 )
-from katana.local.analytics._pagerank import PagerankPlan, PagerankStatistics, pagerank, pagerank_assert_valid
-from katana.local.analytics._sssp import SsspPlan, SsspStatistics, sssp, sssp_assert_valid
+from katana.local.analytics._matrix_completion import (
+    MatrixCompletionPlan,
+    MatrixCompletionStatistics,
+    matrix_completion,
+    matrix_completion_assert_valid,
+)
+from katana.local.analytics._max_flow import MaxFlowPlan, MaxFlowStatistics, max_flow, max_flow_assert_valid
+from katana.local.analytics._minimum_spanning_forest import (
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
+)
+from katana.local.analytics._neighbor_sampling import (
+    ALL_NEIGHBORS,
+    NeighborSampler,
+    NeighborSamplingPlan,
+    SampledBlock,
+    SampledMiniBatch,
+)
+from katana.local.analytics._neighborhood_function import (
+    NeighborhoodFunctionEstimate,
+    NeighborhoodFunctionPlan,
+    estimate_neighborhood_function,
+)
+from katana.local.analytics._pagerank import (
+    PagerankPlan,
+    PagerankStatistics,
+    pagerank,
+    pagerank_assert_valid,
+    personalized_pagerank,
+    personalized_pagerank_batch,
+)
+from katana.local.analytics._partition import (
+    HypergraphPartitionStatistics,
+    PartitionPlan,
+    PartitionStatistics,
+    partition,
+    partition_assert_valid,
+    partition_hypergraph,
+)
+from katana.local.analytics._point_to_point import PointToPointQuery
+from katana.local.analytics._random_walks import RandomWalksPlan, random_walks, random_walks_in_batches
+from katana.local.analytics._sssp import (
+    SsspPlan,
+    SsspStatistics,
+    sssp,
+    sssp_assert_valid,
+    sssp_batch,
+    sssp_repair,
+)
+from katana.local.analytics._strongly_connected_components import (
+    StronglyConnectedComponentsPlan,
+    StronglyConnectedComponentsStatistics,
+    strongly_connected_components,
+    strongly_connected_components_assert_valid,
+)
 from katana.local.analytics._subgraph_extraction import SubGraphExtractionPlan, subgraph_extraction
-from katana.local.analytics._triangle_count import TriangleCountPlan, triangle_count
+from katana.local.analytics._time_window import TimeWindowedGraph
+from katana.local.analytics._triangle_count import TriangleCountPlan, local_triangle_count, triangle_count
 from katana.local.analytics._wrappers import find_edge_sorted_by_dest, sort_all_edges_by_dest, sort_nodes_by_degree
-from katana.local.analytics.plan import Architecture, Plan, Statistics
+from katana.local.analytics.plan import Architecture, Plan, ResultCache, Statistics, Workspace
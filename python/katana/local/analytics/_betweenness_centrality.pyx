@@ -39,8 +39,13 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         enum Algorithm:
             kOuter "katana::analytics::BetweennessCentralityPlan::kOuter"
             kLevel "katana::analytics::BetweennessCentralityPlan::kLevel"
+            kApproximate "katana::analytics::BetweennessCentralityPlan::kApproximate"
+            kAsynchronous "katana::analytics::BetweennessCentralityPlan::kAsynchronous"
 
         _BetweennessCentralityPlan.Algorithm algorithm() const
+        double error_bound() const
+        double confidence() const
+        uint32_t concurrent_sources() const
 
         BetweennessCentralityPlan()
 
@@ -49,8 +54,16 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         @staticmethod
         _BetweennessCentralityPlan Outer()
         @staticmethod
+        _BetweennessCentralityPlan Approximate(double error_bound, double confidence)
+        @staticmethod
+        _BetweennessCentralityPlan Asynchronous(uint32_t concurrent_sources)
+        @staticmethod
         _BetweennessCentralityPlan FromAlgorithm(_BetweennessCentralityPlan.Algorithm algo)
 
+    double kDefaultErrorBound "katana::analytics::BetweennessCentralityPlan::kDefaultErrorBound"
+    double kDefaultConfidence "katana::analytics::BetweennessCentralityPlan::kDefaultConfidence"
+    uint32_t kDefaultConcurrentSources "katana::analytics::BetweennessCentralityPlan::kDefaultConcurrentSources"
+
     BetweennessCentralitySources kBetweennessCentralityAllNodes;
 
     Result[void] BetweennessCentrality(_PropertyGraph* pg, string output_property_name, const BetweennessCentralitySources& sources, _BetweennessCentralityPlan plan)
@@ -87,6 +100,8 @@ class _BetweennessCentralityAlgorithm(Enum):
     """
     Outer = _BetweennessCentralityPlan.Algorithm.kOuter
     Level = _BetweennessCentralityPlan.Algorithm.kLevel
+    Approximate = _BetweennessCentralityPlan.Algorithm.kApproximate
+    Asynchronous = _BetweennessCentralityPlan.Algorithm.kAsynchronous
 
 
 cdef class BetweennessCentralityPlan(Plan):
@@ -113,6 +128,18 @@ cdef class BetweennessCentralityPlan(Plan):
     def algorithm(self) -> _BetweennessCentralityAlgorithm:
         return _BetweennessCentralityAlgorithm(self.underlying_.algorithm())
 
+    @property
+    def error_bound(self) -> float:
+        return self.underlying_.error_bound()
+
+    @property
+    def confidence(self) -> float:
+        return self.underlying_.confidence()
+
+    @property
+    def concurrent_sources(self) -> int:
+        return self.underlying_.concurrent_sources()
+
     @staticmethod
     def outer():
         """
@@ -127,6 +154,29 @@ cdef class BetweennessCentralityPlan(Plan):
         """
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Level())
 
+    @staticmethod
+    def asynchronous(uint32_t concurrent_sources = kDefaultConcurrentSources):
+        """
+        Asynchronous Brandes without barriers between levels. Several sources run at once, each with its own copy of
+        the node and edge state, which keeps threads busy on high-diameter graphs.
+
+        :param concurrent_sources: The number of sources processed at once.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Asynchronous(concurrent_sources))
+
+    @staticmethod
+    def approximate(double error_bound = kDefaultErrorBound, double confidence = kDefaultConfidence):
+        """
+        Estimate the centralities from shortest paths between random pairs of nodes. The number of pairs follows
+        from the error bound and confidence, and the sampling stops early once every estimate is within the error
+        bound. The sources argument is ignored.
+
+        :param error_bound: The largest error of a centrality as a fraction of the number of ordered pairs of
+            distinct nodes.
+        :param confidence: The probability that every estimate is within the error bound.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Approximate(error_bound, confidence))
+
 
 def betweenness_centrality(Graph pg, str output_property_name, sources = None,
              BetweennessCentralityPlan plan = BetweennessCentralityPlan()):
@@ -13,6 +13,8 @@ Breadth-first Search
 
 .. autofunction:: katana.local.analytics.bfs
 
+.. autofunction:: katana.local.analytics.bfs_batch
+
 .. autoclass:: katana.local.analytics.BfsStatistics
     :members:
     :undoc-members:
@@ -22,13 +24,24 @@ Breadth-first Search
 
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint32_t, uint64_t
+from libcpp.memory cimport shared_ptr
 from libcpp.string cimport string
+from libcpp.vector cimport vector
+from pyarrow.lib cimport CTable, pyarrow_wrap_table
 
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
-from katana.local.analytics.plan cimport Plan, _Plan
+from katana.local.analytics.plan cimport (
+    Plan,
+    Workspace,
+    _AnalyticsWorkspace,
+    _CancellationToken,
+    _Plan,
+    handle_result_table,
+    workspace_pointer,
+)
 
 from enum import Enum
 
@@ -41,12 +54,16 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
             kSynchronousTile "katana::analytics::BfsPlan::kSynchronousTile"
             kSynchronous "katana::analytics::BfsPlan::kSynchronous"
             kSynchronousDirectOpt "katana::analytics::BfsPlan::kSynchronousDirectOpt"
+            kAutomatic "katana::analytics::BfsPlan::kAutomatic"
 
         _BfsPlan.Algorithm algorithm() const
         ptrdiff_t edge_tile_size() const
         uint32_t alpha() const
         uint32_t beta() const
 
+        @staticmethod
+        _BfsPlan Automatic()
+
         @staticmethod
         _BfsPlan AsynchronousTile(ptrdiff_t edge_tile_size)
 
@@ -71,6 +88,9 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
                      string output_property_name,
                      _BfsPlan algo)
 
+    Result[shared_ptr[CTable]] BfsBatch(_PropertyGraph* pg, const vector[uint32_t]& sources, _BfsPlan algo,
+                                        const _CancellationToken* cancellation, _AnalyticsWorkspace* workspace)
+
     Result[void] BfsAssertValid(_PropertyGraph* pg, uint32_t start_node,
                                 string property_name);
 
@@ -92,6 +112,7 @@ class _BfsAlgorithm(Enum):
     Synchronous = _BfsPlan.Algorithm.kSynchronous
     SynchronousDirectOpt = _BfsPlan.Algorithm.kSynchronousDirectOpt
     SynchronousTile = _BfsPlan.Algorithm.kSynchronousTile
+    Automatic = _BfsPlan.Algorithm.kAutomatic
 
 
 cdef class BfsPlan(Plan):
@@ -126,6 +147,13 @@ cdef class BfsPlan(Plan):
         """
         return self.underlying_.edge_tile_size()
 
+    @staticmethod
+    def automatic():
+        """
+        Choose the algorithm from the statistics of the graph when the BFS runs
+        """
+        return BfsPlan.make(_BfsPlan.Automatic())
+
     @staticmethod
     def asynchronous_tile(edge_tile_size=kDefaultEdgeTileSize):
         """
@@ -178,6 +206,33 @@ def bfs(Graph pg, uint32_t start_node, str output_property_name, BfsPlan plan =
     with nogil:
         handle_result_void(Bfs(pg.underlying_property_graph(), start_node, output_property_name_cstr, plan.underlying_))
 
+def bfs_batch(Graph pg, sources, BfsPlan plan = BfsPlan(), Workspace workspace = None):
+    """
+    Compute the Breadth-First Search parents on `pg` from each of `sources` in one call, without adding properties to
+    `pg`. This is much faster than calling `bfs` for each source when there are many sources, especially on small
+    graphs.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type sources: Iterable of node IDs
+    :param sources: The source nodes.
+    :type plan: BfsPlan
+    :param plan: The execution plan to use.
+    :type workspace: Workspace
+    :param workspace: The workspace the traversals take their temporary arrays from. Passing the same workspace to
+        many calls avoids allocating the arrays on each call.
+    :rtype: pyarrow.Table
+    :returns: A table with a column of parents for each source, named by the source.
+    """
+    cdef vector[uint32_t] sources_vec = sources
+    cdef _AnalyticsWorkspace* workspace_ptr = workspace_pointer(workspace)
+    cdef shared_ptr[CTable] table
+    with nogil:
+        table = handle_result_table(
+            BfsBatch(pg.underlying_property_graph(), sources_vec, plan.underlying_, NULL, workspace_ptr))
+    return pyarrow_wrap_table(table)
+
+
 def bfs_assert_valid(Graph pg, uint32_t start_node, str property_name):
     """
     Raise an exception if the BFS results in `pg` appear to be incorrect. This is not an
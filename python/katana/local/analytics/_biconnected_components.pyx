@@ -0,0 +1,218 @@
+"""
+Biconnected Components
+----------------------
+
+.. autoclass:: katana.local.analytics.BiconnectedComponentsPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._biconnected_components._BiconnectedComponentsAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.biconnected_components
+
+.. autoclass:: katana.local.analytics.BiconnectedComponentsStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.biconnected_components_assert_valid
+"""
+from enum import Enum
+
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/biconnected_components/biconnected_components.h" namespace "katana::analytics" nogil:
+    cppclass _BiconnectedComponentsPlan "katana::analytics::BiconnectedComponentsPlan" (_Plan):
+        enum Algorithm:
+            kTarjanVishkin "katana::analytics::BiconnectedComponentsPlan::kTarjanVishkin"
+            kSerial "katana::analytics::BiconnectedComponentsPlan::kSerial"
+
+        _BiconnectedComponentsPlan.Algorithm algorithm() const
+
+        _BiconnectedComponentsPlan()
+
+        @staticmethod
+        _BiconnectedComponentsPlan TarjanVishkin()
+
+        @staticmethod
+        _BiconnectedComponentsPlan Serial()
+
+    uint64_t kNoBiconnectedComponent "katana::analytics::kNoBiconnectedComponent"
+
+    Result[void] BiconnectedComponents(_PropertyGraph* pg, const string& edge_component_property_name,
+        const string& articulation_point_property_name, _BiconnectedComponentsPlan plan)
+
+    Result[void] BiconnectedComponentsAssertValid(_PropertyGraph* pg, const string& edge_component_property_name,
+        const string& articulation_point_property_name)
+
+    cppclass _BiconnectedComponentsStatistics "katana::analytics::BiconnectedComponentsStatistics":
+        uint64_t total_components
+        uint64_t num_articulation_points
+        uint64_t num_bridges
+        uint64_t largest_component_edges
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_BiconnectedComponentsStatistics] Compute(_PropertyGraph* pg, const string& edge_component_property_name,
+            const string& articulation_point_property_name)
+
+
+NO_BICONNECTED_COMPONENT = kNoBiconnectedComponent
+"""
+The component of self loops, which are in no biconnected component.
+"""
+
+
+class _BiconnectedComponentsAlgorithm(Enum):
+    """
+    The concrete algorithms available for biconnected components.
+
+    :see: :py:class:`~katana.local.analytics.BiconnectedComponentsPlan` constructors for algorithm documentation.
+    """
+    TarjanVishkin = _BiconnectedComponentsPlan.Algorithm.kTarjanVishkin
+    Serial = _BiconnectedComponentsPlan.Algorithm.kSerial
+
+
+cdef class BiconnectedComponentsPlan(Plan):
+    """
+    A computational :ref:`Plan` for biconnected components.
+
+    Static methods construct BiconnectedComponentsPlans using specific algorithms with their required parameters.
+    """
+    cdef:
+        _BiconnectedComponentsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _BiconnectedComponentsAlgorithm
+
+    @staticmethod
+    cdef BiconnectedComponentsPlan make(_BiconnectedComponentsPlan u):
+        f = <BiconnectedComponentsPlan>BiconnectedComponentsPlan.__new__(BiconnectedComponentsPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _BiconnectedComponentsAlgorithm:
+        return _BiconnectedComponentsAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def tarjan_vishkin() -> BiconnectedComponentsPlan:
+        """
+        Tarjan and Vishkin's algorithm on breadth-first spanning trees: subtree sizes, preorder numbers and the lowest
+        and highest preorder number adjacent to each subtree decide, level by level, which tree edges a union-find
+        merges into a component.
+        """
+        return BiconnectedComponentsPlan.make(_BiconnectedComponentsPlan.TarjanVishkin())
+
+    @staticmethod
+    def serial() -> BiconnectedComponentsPlan:
+        """
+        Hopcroft and Tarjan's depth-first search.
+        """
+        return BiconnectedComponentsPlan.make(_BiconnectedComponentsPlan.Serial())
+
+
+def biconnected_components(Graph pg, str edge_component_property_name, str articulation_point_property_name,
+                           BiconnectedComponentsPlan plan = BiconnectedComponentsPlan()):
+    """
+    Compute the biconnected components of the symmetric graph `pg`, the maximal sets of edges any two of which lie on
+    a common simple cycle, and its articulation points, the nodes whose removal disconnects their connected
+    component. The component of an edge is the smallest edge of its component, or `NO_BICONNECTED_COMPONENT` for self
+    loops, so every plan gives the same result.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type edge_component_property_name: str
+    :param edge_component_property_name: The output edge property holding the component of each edge (as uint64).
+        This property must not already exist.
+    :type articulation_point_property_name: str
+    :param articulation_point_property_name: The output node property holding whether each node is an articulation
+        point (as uint8). This property must not already exist.
+    :type plan: BiconnectedComponentsPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string edge_component_property_name_str = bytes(edge_component_property_name, "utf-8")
+    cdef string articulation_point_property_name_str = bytes(articulation_point_property_name, "utf-8")
+    with nogil:
+        handle_result_void(BiconnectedComponents(pg.underlying_property_graph(), edge_component_property_name_str,
+                                                 articulation_point_property_name_str, plan.underlying_))
+
+
+def biconnected_components_assert_valid(Graph pg, str edge_component_property_name,
+                                        str articulation_point_property_name):
+    """
+    Raise an exception if the properties do not hold the biconnected components and articulation points of `pg`, as
+    computed by the serial algorithm.
+
+    :raises: AssertionError
+    """
+    cdef string edge_component_property_name_str = bytes(edge_component_property_name, "utf-8")
+    cdef string articulation_point_property_name_str = bytes(articulation_point_property_name, "utf-8")
+    with nogil:
+        handle_result_assert(BiconnectedComponentsAssertValid(pg.underlying_property_graph(),
+                                                              edge_component_property_name_str,
+                                                              articulation_point_property_name_str))
+
+
+cdef _BiconnectedComponentsStatistics handle_result_BiconnectedComponentsStatistics(
+        Result[_BiconnectedComponentsStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class BiconnectedComponentsStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of a biconnected components computation on a graph.
+    """
+    cdef _BiconnectedComponentsStatistics underlying
+
+    def __init__(self, Graph pg, str edge_component_property_name, str articulation_point_property_name):
+        cdef string edge_component_property_name_str = bytes(edge_component_property_name, "utf-8")
+        cdef string articulation_point_property_name_str = bytes(articulation_point_property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_BiconnectedComponentsStatistics(
+                _BiconnectedComponentsStatistics.Compute(pg.underlying_property_graph(),
+                                                         edge_component_property_name_str,
+                                                         articulation_point_property_name_str))
+
+    @property
+    def total_components(self) -> int:
+        return self.underlying.total_components
+
+    @property
+    def num_articulation_points(self) -> int:
+        return self.underlying.num_articulation_points
+
+    @property
+    def num_bridges(self) -> int:
+        """
+        The number of components of one edge, counting both of its directions as one.
+        """
+        return self.underlying.num_bridges
+
+    @property
+    def largest_component_edges(self) -> int:
+        """
+        The number of edges of the largest component, counting both directions of an edge as one.
+        """
+        return self.underlying.largest_component_edges
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
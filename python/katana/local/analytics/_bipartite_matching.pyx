@@ -0,0 +1,233 @@
+"""
+Bipartite Matching
+------------------
+
+.. autoclass:: katana.local.analytics.BipartiteMatchingPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._bipartite_matching._BipartiteMatchingAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.bipartite_matching
+
+.. autoclass:: katana.local.analytics.BipartiteMatchingStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.bipartite_matching_assert_valid
+"""
+from enum import Enum
+
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/bipartite_matching/bipartite_matching.h" namespace "katana::analytics" nogil:
+    cppclass _BipartiteMatchingPlan "katana::analytics::BipartiteMatchingPlan" (_Plan):
+        enum Algorithm:
+            kHopcroftKarp "katana::analytics::BipartiteMatchingPlan::kHopcroftKarp"
+            kPushRelabel "katana::analytics::BipartiteMatchingPlan::kPushRelabel"
+
+        _BipartiteMatchingPlan.Algorithm algorithm() const
+        uint64_t global_relabel_interval() const
+
+        _BipartiteMatchingPlan()
+
+        @staticmethod
+        _BipartiteMatchingPlan HopcroftKarp()
+
+        @staticmethod
+        _BipartiteMatchingPlan PushRelabel(uint64_t global_relabel_interval)
+
+    uint64_t kDefaultGlobalRelabelInterval "katana::analytics::BipartiteMatchingPlan::kDefaultGlobalRelabelInterval"
+
+    cppclass _BipartiteSide "katana::analytics::BipartiteSide":
+        _BipartiteSide()
+
+        @staticmethod
+        _BipartiteSide NodeType(const string& type_name)
+
+        @staticmethod
+        _BipartiteSide NodeProperty(const string& property_name)
+
+    Result[void] BipartiteMatching(_PropertyGraph* pg, const _BipartiteSide& side, const string& output_property_name,
+        _BipartiteMatchingPlan plan)
+
+    Result[void] BipartiteMatchingAssertValid(_PropertyGraph* pg, const _BipartiteSide& side,
+        const string& property_name)
+
+    cppclass _BipartiteMatchingStatistics "katana::analytics::BipartiteMatchingStatistics":
+        uint64_t matching_size
+        uint64_t num_left_nodes
+        uint64_t num_right_nodes
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_BipartiteMatchingStatistics] Compute(_PropertyGraph* pg, const _BipartiteSide& side,
+            const string& property_name)
+
+
+class _BipartiteMatchingAlgorithm(Enum):
+    """
+    The concrete algorithms available for bipartite matching.
+
+    :see: :py:class:`~katana.local.analytics.BipartiteMatchingPlan` constructors for algorithm documentation.
+    """
+    HopcroftKarp = _BipartiteMatchingPlan.Algorithm.kHopcroftKarp
+    PushRelabel = _BipartiteMatchingPlan.Algorithm.kPushRelabel
+
+
+cdef class BipartiteMatchingPlan(Plan):
+    """
+    A computational :ref:`Plan` for bipartite matching.
+
+    Static methods construct BipartiteMatchingPlans using specific algorithms with their required parameters. All
+    parameters are optional and have reasonable defaults.
+    """
+    cdef:
+        _BipartiteMatchingPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _BipartiteMatchingAlgorithm
+
+    @staticmethod
+    cdef BipartiteMatchingPlan make(_BipartiteMatchingPlan u):
+        f = <BipartiteMatchingPlan>BipartiteMatchingPlan.__new__(BipartiteMatchingPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _BipartiteMatchingAlgorithm:
+        return _BipartiteMatchingAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def global_relabel_interval(self) -> int:
+        """
+        The number of edges scanned between global relabels, or 0 to select it from the size of the graph.
+        """
+        return self.underlying_.global_relabel_interval()
+
+    @staticmethod
+    def hopcroft_karp() -> BipartiteMatchingPlan:
+        """
+        Hopcroft and Karp's algorithm. Each phase finds the length of the shortest augmenting paths with a parallel
+        breadth-first search, and then augments along disjoint paths of that length found by parallel depth-first
+        searches.
+        """
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.HopcroftKarp())
+
+    @staticmethod
+    def push_relabel(uint64_t global_relabel_interval = kDefaultGlobalRelabelInterval) -> BipartiteMatchingPlan:
+        """
+        Goldberg and Kennedy's push-relabel algorithm with double pushes, discharging the unmatched left nodes in
+        parallel, with a global relabel after every `global_relabel_interval` edges scanned.
+        """
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.PushRelabel(global_relabel_interval))
+
+
+cdef _BipartiteSide make_side(left_node_type, left_property) except *:
+    if (left_node_type is None) == (left_property is None):
+        raise ValueError("exactly one of left_node_type and left_property must be given")
+    if left_node_type is not None:
+        return _BipartiteSide.NodeType(bytes(left_node_type, "utf-8"))
+    return _BipartiteSide.NodeProperty(bytes(left_property, "utf-8"))
+
+
+def bipartite_matching(Graph pg, str output_property_name, str left_node_type = None, str left_property = None,
+                       BipartiteMatchingPlan plan = BipartiteMatchingPlan()):
+    """
+    Compute a maximum cardinality matching of a bipartite graph. The left side is given by exactly one of
+    `left_node_type` and `left_property`; the other nodes are the right side. Edges are taken as undirected, and
+    edges between two nodes of the same side are ignored.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to match.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the node matched to each node, or 2**32 - 1 for
+        the unmatched nodes. This property must not already exist.
+    :type left_node_type: str
+    :param left_node_type: The node type of the nodes of the left side.
+    :type left_property: str
+    :param left_property: A bool or integer node property that is true or non-zero for the nodes of the left side.
+    :type plan: BipartiteMatchingPlan
+    :param plan: The execution plan to use.
+    """
+    cdef _BipartiteSide side = make_side(left_node_type, left_property)
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(BipartiteMatching(pg.underlying_property_graph(), side, output_property_name_str,
+                                             plan.underlying_))
+
+
+def bipartite_matching_assert_valid(Graph pg, str property_name, str left_node_type = None,
+                                    str left_property = None):
+    """
+    Raise an exception if `property_name` is not a matching along the edges between the sides of `pg`, or if an
+    augmenting path is left.
+
+    :raises: AssertionError
+    """
+    cdef _BipartiteSide side = make_side(left_node_type, left_property)
+    cdef string property_name_str = bytes(property_name, "utf-8")
+    with nogil:
+        handle_result_assert(BipartiteMatchingAssertValid(pg.underlying_property_graph(), side, property_name_str))
+
+
+cdef _BipartiteMatchingStatistics handle_result_BipartiteMatchingStatistics(
+        Result[_BipartiteMatchingStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class BipartiteMatchingStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of a bipartite matching.
+    """
+    cdef _BipartiteMatchingStatistics underlying
+
+    def __init__(self, Graph pg, str property_name, str left_node_type = None, str left_property = None):
+        """
+        :param pg: The graph on which `bipartite_matching` was called.
+        :param property_name: The output property name passed to `bipartite_matching`.
+        :param left_node_type: The left node type passed to `bipartite_matching`.
+        :param left_property: The left property passed to `bipartite_matching`.
+        """
+        cdef _BipartiteSide side = make_side(left_node_type, left_property)
+        cdef string property_name_str = bytes(property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_BipartiteMatchingStatistics(_BipartiteMatchingStatistics.Compute(
+                pg.underlying_property_graph(), side, property_name_str))
+
+    @property
+    def matching_size(self) -> int:
+        """
+        The number of matched pairs of nodes.
+        """
+        return self.underlying.matching_size
+
+    @property
+    def num_left_nodes(self) -> int:
+        return self.underlying.num_left_nodes
+
+    @property
+    def num_right_nodes(self) -> int:
+        return self.underlying.num_right_nodes
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,234 @@
+"""
+Closeness Centrality
+--------------------
+
+.. autoclass:: katana.local.analytics.ClosenessCentralityPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._closeness_centrality._ClosenessCentralityAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.closeness_centrality
+
+.. autofunction:: katana.local.analytics.harmonic_centrality
+
+.. autoclass:: katana.local.analytics.ClosenessCentralityStatistics
+    :members:
+    :undoc-members:
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/closeness_centrality/closeness_centrality.h" namespace "katana::analytics" nogil:
+    cppclass _ClosenessCentralityPlan "katana::analytics::ClosenessCentralityPlan" (_Plan):
+        enum Algorithm:
+            kExact "katana::analytics::ClosenessCentralityPlan::kExact"
+            kSampled "katana::analytics::ClosenessCentralityPlan::kSampled"
+
+        _ClosenessCentralityPlan.Algorithm algorithm() const
+        uint32_t num_sources() const
+        uint32_t batch_size() const
+
+        _ClosenessCentralityPlan()
+
+        @staticmethod
+        _ClosenessCentralityPlan Exact(uint32_t batch_size)
+
+        @staticmethod
+        _ClosenessCentralityPlan Sampled(uint32_t num_sources, uint32_t batch_size)
+
+    uint32_t kDefaultNumSources "katana::analytics::ClosenessCentralityPlan::kDefaultNumSources"
+    uint32_t kDefaultBatchSize "katana::analytics::ClosenessCentralityPlan::kDefaultBatchSize"
+
+    Result[void] ClosenessCentrality(_PropertyGraph* pg, const string& output_property_name,
+        _ClosenessCentralityPlan plan)
+
+    Result[void] HarmonicCentrality(_PropertyGraph* pg, const string& output_property_name,
+        _ClosenessCentralityPlan plan)
+
+    cppclass _ClosenessCentralityStatistics "katana::analytics::ClosenessCentralityStatistics":
+        double max_centrality
+        double min_centrality
+        double average_centrality
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_ClosenessCentralityStatistics] Compute(_PropertyGraph* pg, const string& property_name)
+
+
+class _ClosenessCentralityAlgorithm(Enum):
+    """
+    The concrete algorithms available for closeness and harmonic centrality.
+
+    :see: :py:class:`~katana.local.analytics.ClosenessCentralityPlan` constructors for algorithm documentation.
+    """
+    Exact = _ClosenessCentralityPlan.Algorithm.kExact
+    Sampled = _ClosenessCentralityPlan.Algorithm.kSampled
+
+
+cdef class ClosenessCentralityPlan(Plan):
+    """
+    A computational :ref:`Plan` for closeness and harmonic centrality.
+
+    Both take the distance from every source to every node from a multi-source BFS, which traverses `batch_size`
+    sources together and scans the edges of a node once per batch rather than once per source.
+
+    Static methods construct ClosenessCentralityPlans using specific algorithms.
+    """
+    cdef:
+        _ClosenessCentralityPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _ClosenessCentralityAlgorithm
+
+    @staticmethod
+    cdef ClosenessCentralityPlan make(_ClosenessCentralityPlan u):
+        f = <ClosenessCentralityPlan>ClosenessCentralityPlan.__new__(ClosenessCentralityPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _ClosenessCentralityAlgorithm:
+        return _ClosenessCentralityAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def num_sources(self) -> int:
+        """
+        The number of sources of the sampled algorithm.
+        """
+        return self.underlying_.num_sources()
+
+    @property
+    def batch_size(self) -> int:
+        """
+        The number of sources traversed together, which is 64, 256 or 512.
+        """
+        return self.underlying_.batch_size()
+
+    @staticmethod
+    def exact(uint32_t batch_size = kDefaultBatchSize) -> ClosenessCentralityPlan:
+        """
+        Every node is a source, so the centralities are exact. This takes time proportional to the number of nodes
+        times the number of edges, so it is meant for small graphs.
+        """
+        return ClosenessCentralityPlan.make(_ClosenessCentralityPlan.Exact(batch_size))
+
+    @staticmethod
+    def sampled(
+        uint32_t num_sources = kDefaultNumSources, uint32_t batch_size = kDefaultBatchSize
+    ) -> ClosenessCentralityPlan:
+        """
+        Estimate the centralities from the distances from `num_sources` pivots picked uniformly at random (Eppstein
+        and Wang, "Fast approximation of centrality", SODA 2001). The pivots are picked with a fixed seed, so the
+        estimates do not change between runs. A graph with at most `num_sources` nodes gets the exact centralities.
+        """
+        return ClosenessCentralityPlan.make(_ClosenessCentralityPlan.Sampled(num_sources, batch_size))
+
+
+def closeness_centrality(
+    Graph pg, str output_property_name, ClosenessCentralityPlan plan = ClosenessCentralityPlan()
+):
+    """
+    Compute the closeness centrality of each node v of `pg`, (r - 1) / (sum of d(u, v)) * (r - 1) / (n - 1), where
+    d(u, v) is the number of edges of a shortest path from u to v, the sum is over the r nodes u (v included) that
+    reach v, and n is the number of nodes. A node that no other node reaches has centrality 0.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the centralities as double. This property must not
+        already exist.
+    :type plan: ClosenessCentralityPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(ClosenessCentrality(pg.underlying_property_graph(), output_property_name_str,
+            plan.underlying_))
+
+
+def harmonic_centrality(
+    Graph pg, str output_property_name, ClosenessCentralityPlan plan = ClosenessCentralityPlan()
+):
+    """
+    Compute the harmonic centrality of each node v of `pg`, the sum of 1 / d(u, v) over the nodes u other than v that
+    reach v. Unlike closeness, unreachable nodes simply add nothing, which suits graphs that are not connected.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the centralities as double. This property must not
+        already exist.
+    :type plan: ClosenessCentralityPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(HarmonicCentrality(pg.underlying_property_graph(), output_property_name_str,
+            plan.underlying_))
+
+
+cdef _ClosenessCentralityStatistics handle_result_ClosenessCentralityStatistics(
+        Result[_ClosenessCentralityStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class ClosenessCentralityStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of closeness or harmonic centralities.
+    """
+    cdef _ClosenessCentralityStatistics underlying
+
+    def __init__(self, Graph pg, str property_name):
+        """
+        :param pg: The graph on which `closeness_centrality` or `harmonic_centrality` was called.
+        :param property_name: The output property name passed to it.
+        """
+        cdef string property_name_str = bytes(property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_ClosenessCentralityStatistics(_ClosenessCentralityStatistics.Compute(
+                pg.underlying_property_graph(), property_name_str))
+
+    @property
+    def max_centrality(self) -> float:
+        """
+        The maximum centrality across all nodes.
+        """
+        return self.underlying.max_centrality
+
+    @property
+    def min_centrality(self) -> float:
+        """
+        The minimum centrality across all nodes.
+        """
+        return self.underlying.min_centrality
+
+    @property
+    def average_centrality(self) -> float:
+        """
+        The average centrality across all nodes.
+        """
+        return self.underlying.average_centrality
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -22,16 +22,23 @@ Connected Components
 .. autoclass:: katana.local.analytics.ConnectedComponentsStatistics
     :members:
     :undoc-members:
+
+.. autoclass:: katana.local.analytics.IncrementalConnectedComponents
+    :members:
+    :special-members: __init__
 """
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint32_t, uint64_t
+from libcpp.memory cimport unique_ptr
 from libcpp.string cimport string
+from libcpp.utility cimport pair
+from libcpp.vector cimport vector
 
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
-from katana.local.analytics.plan cimport Plan, _Plan
+from katana.local.analytics.plan cimport Plan, ResultCache, _AnalyticsResultCache, _Plan, result_cache_pointer
 
 from enum import Enum
 
@@ -49,6 +56,7 @@ cdef extern from "katana/analytics/connected_components/connected_components.h"
             kAfforest "katana::analytics::ConnectedComponentsPlan::kAfforest"
             kEdgeAfforest "katana::analytics::ConnectedComponentsPlan::kEdgeAfforest"
             kEdgeTiledAfforest "katana::analytics::ConnectedComponentsPlan::kEdgeTiledAfforest"
+            kAutomatic "katana::analytics::ConnectedComponentsPlan::kAutomatic"
 
         _ConnectedComponentsPlan.Algorithm algorithm() const
         ptrdiff_t edge_tile_size() const
@@ -57,6 +65,9 @@ cdef extern from "katana/analytics/connected_components/connected_components.h"
 
         ConnectedComponentsPlan()
 
+        @staticmethod
+        _ConnectedComponentsPlan Automatic()
+
         @staticmethod
         _ConnectedComponentsPlan Serial()
 
@@ -93,7 +104,7 @@ cdef extern from "katana/analytics/connected_components/connected_components.h"
     uint32_t kDefaultComponentSampleFrequency "katana::analytics::ConnectedComponentsPlan::kDefaultComponentSampleFrequency"
 
     Result[void] ConnectedComponents(_PropertyGraph*pg, string output_property_name,
-                                     _ConnectedComponentsPlan plan)
+                                     _ConnectedComponentsPlan plan, _AnalyticsResultCache* cache)
 
     Result[void] ConnectedComponentsAssertValid(_PropertyGraph*pg, string output_property_name)
 
@@ -123,6 +134,7 @@ class _ConnectedComponentsPlanAlgorithm(Enum):
     Afforest = _ConnectedComponentsPlan.Algorithm.kAfforest
     EdgeAfforest = _ConnectedComponentsPlan.Algorithm.kEdgeAfforest
     EdgeTiledAfforest = _ConnectedComponentsPlan.Algorithm.kEdgeTiledAfforest
+    Automatic = _ConnectedComponentsPlan.Algorithm.kAutomatic
 
 
 cdef class ConnectedComponentsPlan(Plan):
@@ -165,6 +177,13 @@ cdef class ConnectedComponentsPlan(Plan):
     def component_sample_frequency(self) -> uint32_t:
         return self.underlying_.component_sample_frequency()
 
+    @staticmethod
+    def automatic() -> ConnectedComponentsPlan:
+        """
+        Choose the algorithm from the statistics of the graph when the components are computed.
+        """
+        return ConnectedComponentsPlan.make(_ConnectedComponentsPlan.Automatic())
+
     @staticmethod
     def serial() -> ConnectedComponentsPlan:
         """
@@ -245,7 +264,8 @@ cdef class ConnectedComponentsPlan(Plan):
 
 
 def connected_components(Graph pg, str output_property_name,
-                         ConnectedComponentsPlan plan = ConnectedComponentsPlan()) -> int:
+                         ConnectedComponentsPlan plan = ConnectedComponentsPlan(),
+                         ResultCache cache = None) -> int:
     """
     Compute the Connected-components for `pg`. `pg` must be symmetric.
 
@@ -255,10 +275,14 @@ def connected_components(Graph pg, str output_property_name,
     :param output_property_name: The output property to write path lengths into. This property must not already exist.
     :type plan: ConnectedComponentsPlan
     :param plan: The execution plan to use. Defaults to heuristically selecting the plan.
+    :type cache: ResultCache
+    :param cache: The cache of the components of committed graphs to take the components from, or to add them to.
     """
     cdef string output_property_name_str = output_property_name.encode("utf-8")
+    cdef _AnalyticsResultCache* cache_ptr = result_cache_pointer(cache)
     with nogil:
-        v = handle_result_void(ConnectedComponents(pg.underlying_property_graph(), output_property_name_str, plan.underlying_))
+        v = handle_result_void(ConnectedComponents(pg.underlying_property_graph(), output_property_name_str,
+                                                   plan.underlying_, cache_ptr))
     return v
 
 def connected_components_assert_valid(Graph pg, str output_property_name):
@@ -314,3 +338,77 @@ cdef class ConnectedComponentsStatistics:
         cdef ostringstream ss
         self.underlying.Print(ss)
         return str(ss.str(), "ascii")
+
+
+cdef extern from "katana/analytics/connected_components/connected_components.h" namespace "katana::analytics" nogil:
+    cppclass _IncrementalConnectedComponents "katana::analytics::IncrementalConnectedComponents":
+        _IncrementalConnectedComponents(uint64_t num_nodes)
+
+        Result[void] AddGraph(const _PropertyGraph* pg)
+        Result[void] AddEdges(const vector[pair[uint32_t, uint32_t]]& edges)
+        void AddNodes(uint64_t count)
+        uint32_t Component(uint32_t node) const
+        Result[void] WriteComponents(_PropertyGraph* pg, const string& output_property_name) const
+        uint64_t num_nodes() const
+        uint64_t num_components() const
+
+
+cdef class IncrementalConnectedComponents:
+    """
+    Connected components of a graph that grows by batches of edges. The components are kept between batches, so adding
+    a batch takes time proportional to the batch rather than to the graph. Edges are taken as undirected and the
+    component of a node is the smallest node of its component.
+    """
+    cdef unique_ptr[_IncrementalConnectedComponents] underlying
+
+    def __init__(self, uint64_t num_nodes):
+        """
+        :param num_nodes: The number of nodes, which start without edges.
+        """
+        self.underlying.reset(new _IncrementalConnectedComponents(num_nodes))
+
+    def add_graph(self, Graph pg):
+        """
+        Add every edge of `pg`, which may not have more nodes than this.
+        """
+        with nogil:
+            handle_result_void(self.underlying.get().AddGraph(pg.underlying_property_graph()))
+
+    def add_edges(self, edges):
+        """
+        Add a batch of edges.
+
+        :param edges: An iterable of (source, destination) node ID pairs.
+        """
+        cdef vector[pair[uint32_t, uint32_t]] edges_vec
+        for source, destination in edges:
+            edges_vec.push_back(pair[uint32_t, uint32_t](source, destination))
+        with nogil:
+            handle_result_void(self.underlying.get().AddEdges(edges_vec))
+
+    def add_nodes(self, uint64_t count):
+        """
+        Add `count` nodes without edges after the existing ones.
+        """
+        self.underlying.get().AddNodes(count)
+
+    def component(self, uint32_t node) -> int:
+        if node >= self.underlying.get().num_nodes():
+            raise IndexError(node)
+        return self.underlying.get().Component(node)
+
+    def write_components(self, Graph pg, str output_property_name):
+        """
+        Store the component of every node in the new node property `output_property_name` of `pg`, which must have as
+        many nodes as this.
+        """
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            handle_result_void(self.underlying.get().WriteComponents(pg.underlying_property_graph(),
+                                                                    output_property_name_str))
+
+    def num_nodes(self) -> int:
+        return self.underlying.get().num_nodes()
+
+    def num_components(self) -> int:
+        return self.underlying.get().num_components()
@@ -0,0 +1,395 @@
+"""
+Eigenvector and Katz Centrality
+-------------------------------
+
+.. autoclass:: katana.local.analytics.EigenvectorCentralityPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._eigenvector_centrality._EigenvectorCentralityAlgorithm
+    :members:
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics.KatzCentralityPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._eigenvector_centrality._KatzCentralityAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.eigenvector_centrality
+
+.. autofunction:: katana.local.analytics.katz_centrality
+
+.. autofunction:: katana.local.analytics.eigenvector_centrality_assert_valid
+
+.. autoclass:: katana.local.analytics.EigenvectorCentralityStatistics
+    :members:
+    :undoc-members:
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/eigenvector_centrality/eigenvector_centrality.h" namespace "katana::analytics" nogil:
+    cppclass _EigenvectorCentralityPlan "katana::analytics::EigenvectorCentralityPlan" (_Plan):
+        enum Algorithm:
+            kPull "katana::analytics::EigenvectorCentralityPlan::kPull"
+            kBlocked "katana::analytics::EigenvectorCentralityPlan::kBlocked"
+            kPush "katana::analytics::EigenvectorCentralityPlan::kPush"
+
+        _EigenvectorCentralityPlan.Algorithm algorithm() const
+        double tolerance() const
+        uint32_t max_iterations() const
+
+        _EigenvectorCentralityPlan()
+
+        @staticmethod
+        _EigenvectorCentralityPlan Pull(double tolerance, uint32_t max_iterations)
+
+        @staticmethod
+        _EigenvectorCentralityPlan Blocked(double tolerance, uint32_t max_iterations)
+
+        @staticmethod
+        _EigenvectorCentralityPlan Push(double tolerance, uint32_t max_iterations)
+
+    double kDefaultEigenvectorTolerance "katana::analytics::EigenvectorCentralityPlan::kDefaultTolerance"
+    uint32_t kDefaultEigenvectorMaxIterations "katana::analytics::EigenvectorCentralityPlan::kDefaultMaxIterations"
+
+    cppclass _KatzCentralityPlan "katana::analytics::KatzCentralityPlan" (_Plan):
+        enum Algorithm:
+            kPull "katana::analytics::KatzCentralityPlan::kPull"
+            kBlocked "katana::analytics::KatzCentralityPlan::kBlocked"
+            kPush "katana::analytics::KatzCentralityPlan::kPush"
+
+        _KatzCentralityPlan.Algorithm algorithm() const
+        double alpha() const
+        double beta() const
+        double tolerance() const
+        uint32_t max_iterations() const
+
+        _KatzCentralityPlan()
+
+        @staticmethod
+        _KatzCentralityPlan Pull(double alpha, double beta, double tolerance, uint32_t max_iterations)
+
+        @staticmethod
+        _KatzCentralityPlan Blocked(double alpha, double beta, double tolerance, uint32_t max_iterations)
+
+        @staticmethod
+        _KatzCentralityPlan Push(double alpha, double beta, double tolerance, uint32_t max_iterations)
+
+    double kDefaultKatzAlpha "katana::analytics::KatzCentralityPlan::kDefaultAlpha"
+    double kDefaultKatzBeta "katana::analytics::KatzCentralityPlan::kDefaultBeta"
+    double kDefaultKatzTolerance "katana::analytics::KatzCentralityPlan::kDefaultTolerance"
+    uint32_t kDefaultKatzMaxIterations "katana::analytics::KatzCentralityPlan::kDefaultMaxIterations"
+
+    Result[void] EigenvectorCentrality(_PropertyGraph* pg, const string& output_property_name,
+        _EigenvectorCentralityPlan plan)
+
+    Result[void] KatzCentrality(_PropertyGraph* pg, const string& output_property_name, _KatzCentralityPlan plan)
+
+    Result[void] EigenvectorCentralityAssertValid(_PropertyGraph* pg, const string& property_name)
+
+    cppclass _EigenvectorCentralityStatistics "katana::analytics::EigenvectorCentralityStatistics":
+        double max_centrality
+        double min_centrality
+        double average_centrality
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_EigenvectorCentralityStatistics] Compute(_PropertyGraph* pg, const string& property_name)
+
+
+class _EigenvectorCentralityAlgorithm(Enum):
+    """
+    The concrete algorithms available for eigenvector centrality.
+
+    :see: :py:class:`~katana.local.analytics.EigenvectorCentralityPlan` constructors for algorithm documentation.
+    """
+    Pull = _EigenvectorCentralityPlan.Algorithm.kPull
+    Blocked = _EigenvectorCentralityPlan.Algorithm.kBlocked
+    Push = _EigenvectorCentralityPlan.Algorithm.kPush
+
+
+cdef class EigenvectorCentralityPlan(Plan):
+    """
+    A computational :ref:`Plan` for eigenvector centrality.
+
+    The algorithms choose how the products with the transposed adjacency matrix are computed; they give the same
+    centralities.
+
+    Static methods construct EigenvectorCentralityPlans using specific algorithms.
+    """
+    cdef:
+        _EigenvectorCentralityPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _EigenvectorCentralityAlgorithm
+
+    @staticmethod
+    cdef EigenvectorCentralityPlan make(_EigenvectorCentralityPlan u):
+        f = <EigenvectorCentralityPlan>EigenvectorCentralityPlan.__new__(EigenvectorCentralityPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _EigenvectorCentralityAlgorithm:
+        return _EigenvectorCentralityAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def tolerance(self) -> float:
+        """
+        Stop once the centralities change by at most this much in total.
+        """
+        return self.underlying_.tolerance()
+
+    @property
+    def max_iterations(self) -> int:
+        """
+        The maximum number of iterations to execute.
+        """
+        return self.underlying_.max_iterations()
+
+    @staticmethod
+    def pull(
+        double tolerance = kDefaultEigenvectorTolerance, uint32_t max_iterations = kDefaultEigenvectorMaxIterations
+    ) -> EigenvectorCentralityPlan:
+        """
+        Gather over the in-edges of each node; no atomics, but the in-edges are built if the graph does not have them
+        yet.
+        """
+        return EigenvectorCentralityPlan.make(_EigenvectorCentralityPlan.Pull(tolerance, max_iterations))
+
+    @staticmethod
+    def blocked(
+        double tolerance = kDefaultEigenvectorTolerance, uint32_t max_iterations = kDefaultEigenvectorMaxIterations
+    ) -> EigenvectorCentralityPlan:
+        """
+        Pull with propagation blocking: the in-edges are grouped by blocks of the centralities they read so that the
+        reads of a block stay in the cache. Faster on graphs much larger than the last level cache, at the cost of 8
+        bytes per edge to hold the groups.
+        """
+        return EigenvectorCentralityPlan.make(_EigenvectorCentralityPlan.Blocked(tolerance, max_iterations))
+
+    @staticmethod
+    def push(
+        double tolerance = kDefaultEigenvectorTolerance, uint32_t max_iterations = kDefaultEigenvectorMaxIterations
+    ) -> EigenvectorCentralityPlan:
+        """
+        Centralities are pushed along the out-edges with atomic adds, so only the out-edges are needed.
+        """
+        return EigenvectorCentralityPlan.make(_EigenvectorCentralityPlan.Push(tolerance, max_iterations))
+
+
+class _KatzCentralityAlgorithm(Enum):
+    """
+    The concrete algorithms available for Katz centrality.
+
+    :see: :py:class:`~katana.local.analytics.EigenvectorCentralityPlan` constructors for algorithm documentation.
+    """
+    Pull = _KatzCentralityPlan.Algorithm.kPull
+    Blocked = _KatzCentralityPlan.Algorithm.kBlocked
+    Push = _KatzCentralityPlan.Algorithm.kPush
+
+
+cdef class KatzCentralityPlan(Plan):
+    """
+    A computational :ref:`Plan` for Katz centrality. The algorithms are those of
+    :py:class:`~katana.local.analytics.EigenvectorCentralityPlan`.
+
+    Static methods construct KatzCentralityPlans using specific algorithms.
+    """
+    cdef:
+        _KatzCentralityPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _KatzCentralityAlgorithm
+
+    @staticmethod
+    cdef KatzCentralityPlan make(_KatzCentralityPlan u):
+        f = <KatzCentralityPlan>KatzCentralityPlan.__new__(KatzCentralityPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _KatzCentralityAlgorithm:
+        return _KatzCentralityAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def alpha(self) -> float:
+        """
+        The weight of each edge of a walk.
+        """
+        return self.underlying_.alpha()
+
+    @property
+    def beta(self) -> float:
+        """
+        The centrality every node starts with.
+        """
+        return self.underlying_.beta()
+
+    @property
+    def tolerance(self) -> float:
+        """
+        Stop once the centralities change by at most this much in total.
+        """
+        return self.underlying_.tolerance()
+
+    @property
+    def max_iterations(self) -> int:
+        """
+        The maximum number of iterations to execute.
+        """
+        return self.underlying_.max_iterations()
+
+    @staticmethod
+    def pull(
+        double alpha = kDefaultKatzAlpha,
+        double beta = kDefaultKatzBeta,
+        double tolerance = kDefaultKatzTolerance,
+        uint32_t max_iterations = kDefaultKatzMaxIterations,
+    ) -> KatzCentralityPlan:
+        return KatzCentralityPlan.make(_KatzCentralityPlan.Pull(alpha, beta, tolerance, max_iterations))
+
+    @staticmethod
+    def blocked(
+        double alpha = kDefaultKatzAlpha,
+        double beta = kDefaultKatzBeta,
+        double tolerance = kDefaultKatzTolerance,
+        uint32_t max_iterations = kDefaultKatzMaxIterations,
+    ) -> KatzCentralityPlan:
+        return KatzCentralityPlan.make(_KatzCentralityPlan.Blocked(alpha, beta, tolerance, max_iterations))
+
+    @staticmethod
+    def push(
+        double alpha = kDefaultKatzAlpha,
+        double beta = kDefaultKatzBeta,
+        double tolerance = kDefaultKatzTolerance,
+        uint32_t max_iterations = kDefaultKatzMaxIterations,
+    ) -> KatzCentralityPlan:
+        return KatzCentralityPlan.make(_KatzCentralityPlan.Push(alpha, beta, tolerance, max_iterations))
+
+
+def eigenvector_centrality(
+    Graph pg, str output_property_name, EigenvectorCentralityPlan plan = EigenvectorCentralityPlan()
+):
+    """
+    Compute the eigenvector centrality of each node of `pg`: the entries of the principal eigenvector of the
+    transposed adjacency matrix, so that the centrality of a node is proportional to the sum of the centralities of the
+    nodes with an edge to it. The centralities are scaled to a Euclidean norm of 1.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the centralities as double. This property must not
+        already exist.
+    :type plan: EigenvectorCentralityPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(EigenvectorCentrality(pg.underlying_property_graph(), output_property_name_str,
+            plan.underlying_))
+
+
+def katz_centrality(Graph pg, str output_property_name, KatzCentralityPlan plan = KatzCentralityPlan()):
+    """
+    Compute the Katz centrality of each node of `pg`, the solution x of x = alpha A^T x + beta: every walk that ends at
+    a node adds alpha to the power of its length, times beta, to its centrality. The iterations only converge if alpha
+    is less than 1 over the largest eigenvalue of A. The centralities are scaled to a Euclidean norm of 1.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the centralities as double. This property must not
+        already exist.
+    :type plan: KatzCentralityPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(KatzCentrality(pg.underlying_property_graph(), output_property_name_str, plan.underlying_))
+
+
+def eigenvector_centrality_assert_valid(Graph pg, str property_name):
+    """
+    Raise an exception if the eigenvector or Katz centralities in `pg` are negative or do not have a Euclidean norm of
+    1.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to check.
+    :type property_name: str
+    :param property_name: The output property name passed to `eigenvector_centrality` or `katz_centrality`.
+    """
+    cdef string property_name_str = bytes(property_name, "utf-8")
+    with nogil:
+        handle_result_assert(EigenvectorCentralityAssertValid(pg.underlying_property_graph(), property_name_str))
+
+
+cdef _EigenvectorCentralityStatistics handle_result_EigenvectorCentralityStatistics(
+        Result[_EigenvectorCentralityStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class EigenvectorCentralityStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of eigenvector or Katz centralities.
+    """
+    cdef _EigenvectorCentralityStatistics underlying
+
+    def __init__(self, Graph pg, str property_name):
+        """
+        :param pg: The graph on which `eigenvector_centrality` or `katz_centrality` was called.
+        :param property_name: The output property name passed to it.
+        """
+        cdef string property_name_str = bytes(property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_EigenvectorCentralityStatistics(_EigenvectorCentralityStatistics.Compute(
+                pg.underlying_property_graph(), property_name_str))
+
+    @property
+    def max_centrality(self) -> float:
+        """
+        The maximum centrality across all nodes.
+        """
+        return self.underlying.max_centrality
+
+    @property
+    def min_centrality(self) -> float:
+        """
+        The minimum centrality across all nodes.
+        """
+        return self.underlying.min_centrality
+
+    @property
+    def average_centrality(self) -> float:
+        """
+        The average centrality across all nodes.
+        """
+        return self.underlying.average_centrality
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,187 @@
+"""
+Graph Coloring
+--------------
+
+.. autoclass:: katana.local.analytics.GraphColoringPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._graph_coloring._GraphColoringAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.graph_coloring
+
+.. autoclass:: katana.local.analytics.GraphColoringStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.graph_coloring_assert_valid
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/graph_coloring/graph_coloring.h" namespace "katana::analytics" nogil:
+    cppclass _GraphColoringPlan "katana::analytics::GraphColoringPlan" (_Plan):
+        enum Algorithm:
+            kJonesPlassmann "katana::analytics::GraphColoringPlan::kJonesPlassmann"
+            kLargestDegreeFirst "katana::analytics::GraphColoringPlan::kLargestDegreeFirst"
+
+        _GraphColoringPlan.Algorithm algorithm() const
+
+        _GraphColoringPlan()
+
+        @staticmethod
+        _GraphColoringPlan JonesPlassmann()
+
+        @staticmethod
+        _GraphColoringPlan LargestDegreeFirst()
+
+    Result[void] GraphColoring(_PropertyGraph* pg, const string& output_property_name, _GraphColoringPlan plan)
+
+    Result[void] GraphColoringAssertValid(_PropertyGraph* pg, const string& property_name)
+
+    cppclass _GraphColoringStatistics "katana::analytics::GraphColoringStatistics":
+        uint32_t num_colors
+        uint64_t largest_color_class_size
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_GraphColoringStatistics] Compute(_PropertyGraph* pg, const string& property_name)
+
+
+class _GraphColoringAlgorithm(Enum):
+    """
+    The concrete algorithms available for graph coloring.
+
+    :see: :py:class:`~katana.local.analytics.GraphColoringPlan` constructors for algorithm documentation.
+    """
+    JonesPlassmann = _GraphColoringPlan.Algorithm.kJonesPlassmann
+    LargestDegreeFirst = _GraphColoringPlan.Algorithm.kLargestDegreeFirst
+
+
+cdef class GraphColoringPlan(Plan):
+    """
+    A computational :ref:`Plan` for graph coloring.
+
+    Static methods construct GraphColoringPlans using specific algorithms.
+    """
+    cdef:
+        _GraphColoringPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _GraphColoringAlgorithm
+
+    @staticmethod
+    cdef GraphColoringPlan make(_GraphColoringPlan u):
+        f = <GraphColoringPlan>GraphColoringPlan.__new__(GraphColoringPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _GraphColoringAlgorithm:
+        return _GraphColoringAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def jones_plassmann() -> GraphColoringPlan:
+        """
+        Jones and Plassmann's algorithm. In each round, the uncolored nodes whose priority beats that of all their
+        uncolored neighbors take, in parallel, the smallest color none of their neighbors has. Priorities are a hash of
+        the node ids, so the coloring only depends on the graph.
+        """
+        return GraphColoringPlan.make(_GraphColoringPlan.JonesPlassmann())
+
+    @staticmethod
+    def largest_degree_first() -> GraphColoringPlan:
+        """
+        The rounds of Jones and Plassmann's algorithm, with the nodes of higher degree first and ties broken by the
+        hash. This usually takes fewer colors.
+        """
+        return GraphColoringPlan.make(_GraphColoringPlan.LargestDegreeFirst())
+
+
+def graph_coloring(Graph pg, str output_property_name, GraphColoringPlan plan = GraphColoringPlan()):
+    """
+    Color the nodes of `pg` so that no two neighbors have the same color, using at most one more color than the largest
+    degree. The graph must be symmetric; self loops are ignored.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to color.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the colors, 0, 1, ... as uint32. This property must
+        not already exist.
+    :type plan: GraphColoringPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(GraphColoring(pg.underlying_property_graph(), output_property_name_str, plan.underlying_))
+
+
+def graph_coloring_assert_valid(Graph pg, str property_name):
+    """
+    Raise an exception if an edge of `pg`, other than a self loop, joins two nodes of the same color in
+    `property_name`.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = bytes(property_name, "utf-8")
+    with nogil:
+        handle_result_assert(GraphColoringAssertValid(pg.underlying_property_graph(), property_name_str))
+
+
+cdef _GraphColoringStatistics handle_result_GraphColoringStatistics(
+        Result[_GraphColoringStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class GraphColoringStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of a graph coloring.
+    """
+    cdef _GraphColoringStatistics underlying
+
+    def __init__(self, Graph pg, str property_name):
+        """
+        :param pg: The graph on which `graph_coloring` was called.
+        :param property_name: The output property name passed to `graph_coloring`.
+        """
+        cdef string property_name_str = bytes(property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_GraphColoringStatistics(_GraphColoringStatistics.Compute(
+                pg.underlying_property_graph(), property_name_str))
+
+    @property
+    def num_colors(self) -> int:
+        """
+        The number of colors used.
+        """
+        return self.underlying.num_colors
+
+    @property
+    def largest_color_class_size(self) -> int:
+        """
+        The number of nodes of the most common color.
+        """
+        return self.underlying.largest_color_class_size
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
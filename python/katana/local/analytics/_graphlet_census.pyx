@@ -0,0 +1,118 @@
+"""
+Graphlet Census
+---------------
+
+.. autoclass:: katana.local.analytics.FourNodeGraphletCensus
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.four_cycle_count_per_node
+"""
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Statistics
+
+
+cdef extern from "katana/analytics/graphlet_census/graphlet_census.h" namespace "katana::analytics" nogil:
+    cppclass _FourNodeGraphletCensus "katana::analytics::FourNodeGraphletCensus":
+        uint64_t paths
+        uint64_t stars
+        uint64_t cycles
+        uint64_t tailed_triangles
+        uint64_t diamonds
+        uint64_t cliques
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_FourNodeGraphletCensus] Compute(_PropertyGraph* pg)
+
+    Result[void] FourCycleCountPerNode(_PropertyGraph* pg, const string& output_property_name)
+
+
+cdef _FourNodeGraphletCensus handle_result_FourNodeGraphletCensus(Result[_FourNodeGraphletCensus] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class FourNodeGraphletCensus(Statistics):
+    """
+    Count the sets of 4 nodes of the symmetric graph `pg`, without self loops or parallel edges, whose induced
+    subgraph is each of the connected graphs of 4 nodes.
+    """
+    cdef _FourNodeGraphletCensus underlying
+
+    def __init__(self, Graph pg):
+        with nogil:
+            self.underlying = handle_result_FourNodeGraphletCensus(
+                _FourNodeGraphletCensus.Compute(pg.underlying_property_graph()))
+
+    @property
+    def paths(self) -> int:
+        """
+        The number of paths of 3 edges.
+        """
+        return self.underlying.paths
+
+    @property
+    def stars(self) -> int:
+        """
+        The number of stars of 3 edges.
+        """
+        return self.underlying.stars
+
+    @property
+    def cycles(self) -> int:
+        """
+        The number of cycles of 4 edges.
+        """
+        return self.underlying.cycles
+
+    @property
+    def tailed_triangles(self) -> int:
+        """
+        The number of triangles with an edge to a fourth node.
+        """
+        return self.underlying.tailed_triangles
+
+    @property
+    def diamonds(self) -> int:
+        """
+        The number of 4-cliques less one edge.
+        """
+        return self.underlying.diamonds
+
+    @property
+    def cliques(self) -> int:
+        """
+        The number of 4-cliques.
+        """
+        return self.underlying.cliques
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
+
+
+def four_cycle_count_per_node(Graph pg, str output_property_name):
+    """
+    Count, for every node of the symmetric graph `pg`, without self loops or parallel edges, the cycles of 4 edges
+    through it, which need not be induced.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property holding the count of each node (as uint64). This property must
+        not already exist.
+    """
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(FourCycleCountPerNode(pg.underlying_property_graph(), output_property_name_str))
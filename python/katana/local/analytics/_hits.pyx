@@ -0,0 +1,254 @@
+"""
+HITS
+----
+
+.. autoclass:: katana.local.analytics.HitsPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._hits._HitsAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.hits
+
+.. autofunction:: katana.local.analytics.hits_assert_valid
+
+.. autoclass:: katana.local.analytics.HitsStatistics
+    :members:
+    :undoc-members:
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/hits/hits.h" namespace "katana::analytics" nogil:
+    cppclass _HitsPlan "katana::analytics::HitsPlan" (_Plan):
+        enum Algorithm:
+            kPull "katana::analytics::HitsPlan::kPull"
+            kBlocked "katana::analytics::HitsPlan::kBlocked"
+            kPush "katana::analytics::HitsPlan::kPush"
+
+        _HitsPlan.Algorithm algorithm() const
+        double tolerance() const
+        uint32_t max_iterations() const
+
+        _HitsPlan()
+
+        @staticmethod
+        _HitsPlan Pull(double tolerance, uint32_t max_iterations)
+
+        @staticmethod
+        _HitsPlan Blocked(double tolerance, uint32_t max_iterations)
+
+        @staticmethod
+        _HitsPlan Push(double tolerance, uint32_t max_iterations)
+
+    double kDefaultTolerance "katana::analytics::HitsPlan::kDefaultTolerance"
+    uint32_t kDefaultMaxIterations "katana::analytics::HitsPlan::kDefaultMaxIterations"
+
+    Result[void] Hits(_PropertyGraph* pg, const string& hub_property_name, const string& authority_property_name,
+        _HitsPlan plan)
+
+    Result[void] HitsAssertValid(_PropertyGraph* pg, const string& hub_property_name,
+        const string& authority_property_name)
+
+    cppclass _HitsStatistics "katana::analytics::HitsStatistics":
+        double max_hub_score
+        double max_authority_score
+        uint64_t num_hubs
+        uint64_t num_authorities
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_HitsStatistics] Compute(_PropertyGraph* pg, const string& hub_property_name,
+            const string& authority_property_name)
+
+
+class _HitsAlgorithm(Enum):
+    """
+    The concrete algorithms available for HITS.
+
+    :see: :py:class:`~katana.local.analytics.HitsPlan` constructors for algorithm documentation.
+    """
+    Pull = _HitsPlan.Algorithm.kPull
+    Blocked = _HitsPlan.Algorithm.kBlocked
+    Push = _HitsPlan.Algorithm.kPush
+
+
+cdef class HitsPlan(Plan):
+    """
+    A computational :ref:`Plan` for HITS.
+
+    The algorithms choose how the products with the adjacency matrix, and its transpose, are computed; they give the
+    same scores.
+
+    Static methods construct HitsPlans using specific algorithms.
+    """
+    cdef:
+        _HitsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _HitsAlgorithm
+
+    @staticmethod
+    cdef HitsPlan make(_HitsPlan u):
+        f = <HitsPlan>HitsPlan.__new__(HitsPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _HitsAlgorithm:
+        return _HitsAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def tolerance(self) -> float:
+        """
+        Stop once the hub scores change by at most this much in total.
+        """
+        return self.underlying_.tolerance()
+
+    @property
+    def max_iterations(self) -> int:
+        """
+        The maximum number of iterations to execute.
+        """
+        return self.underlying_.max_iterations()
+
+    @staticmethod
+    def pull(double tolerance = kDefaultTolerance, uint32_t max_iterations = kDefaultMaxIterations) -> HitsPlan:
+        """
+        Gather over the out-edges and the in-edges of each node; no atomics, but the in-edges are built if the graph
+        does not have them yet.
+        """
+        return HitsPlan.make(_HitsPlan.Pull(tolerance, max_iterations))
+
+    @staticmethod
+    def blocked(double tolerance = kDefaultTolerance, uint32_t max_iterations = kDefaultMaxIterations) -> HitsPlan:
+        """
+        Pull with propagation blocking: the edges are grouped by blocks of the scores they read so that the reads of
+        a block stay in the cache. Faster on graphs much larger than the last level cache, at the cost of 16 bytes per
+        edge to hold the groups.
+        """
+        return HitsPlan.make(_HitsPlan.Blocked(tolerance, max_iterations))
+
+    @staticmethod
+    def push(double tolerance = kDefaultTolerance, uint32_t max_iterations = kDefaultMaxIterations) -> HitsPlan:
+        """
+        Authority scores are pushed along the out-edges with atomic adds, so only the out-edges are needed.
+        """
+        return HitsPlan.make(_HitsPlan.Push(tolerance, max_iterations))
+
+
+def hits(Graph pg, str hub_property_name, str authority_property_name, HitsPlan plan = HitsPlan()):
+    """
+    Compute the hub and authority scores of each node of `pg` (Kleinberg, "Authoritative sources in a hyperlinked
+    environment", JACM 1999). The authority of a node is the sum of the hub scores of the nodes with an edge to it, and
+    the hub score of a node is the sum of the authorities of the nodes it has an edge to; both are scaled to sum to 1
+    after each iteration.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type hub_property_name: str
+    :param hub_property_name: The output node property holding the hub scores as double. This property must not
+        already exist.
+    :type authority_property_name: str
+    :param authority_property_name: The output node property holding the authority scores as double. This property
+        must not already exist.
+    :type plan: HitsPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string hub_property_name_str = bytes(hub_property_name, "utf-8")
+    cdef string authority_property_name_str = bytes(authority_property_name, "utf-8")
+    with nogil:
+        handle_result_void(Hits(pg.underlying_property_graph(), hub_property_name_str, authority_property_name_str,
+            plan.underlying_))
+
+
+def hits_assert_valid(Graph pg, str hub_property_name, str authority_property_name):
+    """
+    Raise an exception if the HITS scores in `pg` are not non-negative or do not each sum to 1.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to check.
+    :type hub_property_name: str
+    :param hub_property_name: The hub property name passed to `hits`.
+    :type authority_property_name: str
+    :param authority_property_name: The authority property name passed to `hits`.
+    """
+    cdef string hub_property_name_str = bytes(hub_property_name, "utf-8")
+    cdef string authority_property_name_str = bytes(authority_property_name, "utf-8")
+    with nogil:
+        handle_result_assert(HitsAssertValid(pg.underlying_property_graph(), hub_property_name_str,
+            authority_property_name_str))
+
+
+cdef _HitsStatistics handle_result_HitsStatistics(Result[_HitsStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class HitsStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of HITS scores.
+    """
+    cdef _HitsStatistics underlying
+
+    def __init__(self, Graph pg, str hub_property_name, str authority_property_name):
+        """
+        :param pg: The graph on which `hits` was called.
+        :param hub_property_name: The hub property name passed to it.
+        :param authority_property_name: The authority property name passed to it.
+        """
+        cdef string hub_property_name_str = bytes(hub_property_name, "utf-8")
+        cdef string authority_property_name_str = bytes(authority_property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_HitsStatistics(_HitsStatistics.Compute(
+                pg.underlying_property_graph(), hub_property_name_str, authority_property_name_str))
+
+    @property
+    def max_hub_score(self) -> float:
+        """
+        The largest hub score.
+        """
+        return self.underlying.max_hub_score
+
+    @property
+    def max_authority_score(self) -> float:
+        """
+        The largest authority score.
+        """
+        return self.underlying.max_authority_score
+
+    @property
+    def num_hubs(self) -> int:
+        """
+        The number of nodes with a hub score above 0.
+        """
+        return self.underlying.num_hubs
+
+    @property
+    def num_authorities(self) -> int:
+        """
+        The number of nodes with an authority score above 0.
+        """
+        return self.underlying.num_authorities
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -38,6 +38,7 @@ cdef extern from "katana/analytics/independent_set/independent_set.h" namespace
             kPull "katana::analytics::IndependentSetPlan::kPull"
             kPriority "katana::analytics::IndependentSetPlan::kPriority"
             kEdgeTiledPriority "katana::analytics::IndependentSetPlan::kEdgeTiledPriority"
+            kDeterministicPriority "katana::analytics::IndependentSetPlan::kDeterministicPriority"
 
         # unsigned int kChunkSize
 
@@ -56,6 +57,8 @@ cdef extern from "katana/analytics/independent_set/independent_set.h" namespace
         _IndependentSetPlan Priority()
         @staticmethod
         _IndependentSetPlan EdgeTiledPriority()
+        @staticmethod
+        _IndependentSetPlan DeterministicPriority()
 
     Result[void] IndependentSet(_PropertyGraph* pg, string output_property_name, _IndependentSetPlan plan)
 
@@ -78,6 +81,7 @@ class _IndependentSetPlanAlgorithm(Enum):
     Pull = _IndependentSetPlan.Algorithm.kPull
     Priority = _IndependentSetPlan.Algorithm.kPriority
     EdgeTiledPriority = _IndependentSetPlan.Algorithm.kEdgeTiledPriority
+    DeterministicPriority = _IndependentSetPlan.Algorithm.kDeterministicPriority
 
 
 cdef class IndependentSetPlan(Plan):
@@ -120,6 +124,14 @@ cdef class IndependentSetPlan(Plan):
     def edge_tiled_priority():
         return IndependentSetPlan.make(_IndependentSetPlan.EdgeTiledPriority())
 
+    @staticmethod
+    def deterministic_priority():
+        """
+        Rounds that add to the set the undecided nodes which beat all of their undecided neighbors, nodes of lower
+        degree first and ties broken by a hash of the node ids. The set does not depend on the number of threads.
+        """
+        return IndependentSetPlan.make(_IndependentSetPlan.DeterministicPriority())
+
 
 def independent_set(Graph pg, str output_property_name,
              IndependentSetPlan plan = IndependentSetPlan()):
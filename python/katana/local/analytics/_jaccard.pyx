@@ -11,6 +11,10 @@ Jaccard Similarity
     :members:
     :undoc-members:
 
+.. autoclass:: katana.local.analytics._jaccard._JaccardAlgorithm
+    :members:
+    :undoc-members:
+
 .. autofunction:: katana.local.analytics.jaccard
 
 .. autoclass:: katana.local.analytics.JaccardStatistics
@@ -18,9 +22,14 @@ Jaccard Similarity
     :undoc-members:
 
 .. autofunction:: katana.local.analytics.jaccard_assert_valid
+
+.. autofunction:: katana.local.analytics.jaccard_top_k
 """
 
+from libc.stdint cimport uint32_t
 from libcpp.string cimport string
+from libcpp.utility cimport pair
+from libcpp.vector cimport vector
 
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
@@ -38,8 +47,18 @@ cdef extern from "katana/analytics/jaccard/jaccard.h" namespace "katana::analyti
             kUnsorted "katana::analytics::JaccardPlan::kUnsorted"
             kUnknown "katana::analytics::JaccardPlan::kUnknown"
 
+        enum Algorithm:
+            kExact "katana::analytics::JaccardPlan::kExact"
+            kMinHash "katana::analytics::JaccardPlan::kMinHash"
+
         _JaccardPlan.EdgeSorting edge_sorting() const
 
+        _JaccardPlan.Algorithm algorithm() const
+
+        uint32_t num_hashes() const
+
+        uint32_t rows_per_band() const
+
         _JaccardPlan()
 
         @staticmethod
@@ -48,12 +67,20 @@ cdef extern from "katana/analytics/jaccard/jaccard.h" namespace "katana::analyti
         @staticmethod
         _JaccardPlan Unsorted()
 
+        @staticmethod
+        _JaccardPlan MinHash(uint32_t num_hashes, uint32_t rows_per_band)
+
+        uint32_t kDefaultNumHashes "katana::analytics::JaccardPlan::kDefaultNumHashes"
+        uint32_t kDefaultRowsPerBand "katana::analytics::JaccardPlan::kDefaultRowsPerBand"
+
     Result[void] Jaccard(_PropertyGraph* pg, size_t compare_node,
         string output_property_name, _JaccardPlan plan)
 
     Result[void] JaccardAssertValid(_PropertyGraph* pg, size_t compare_node,
         string output_property_name)
 
+    Result[vector[vector[pair[uint32_t, double]]]] JaccardTopK(_PropertyGraph* pg, size_t k, _JaccardPlan plan)
+
     cppclass _JaccardStatistics  "katana::analytics::JaccardStatistics":
         double max_similarity
         double min_similarity
@@ -76,6 +103,16 @@ class _JaccardEdgeSorting(Enum):
     Unknown = _JaccardPlan.EdgeSorting.kUnknown
 
 
+class _JaccardAlgorithm(Enum):
+    """
+    The algorithm of :py:func:`~katana.local.analytics.jaccard_top_k`.
+
+    :see: :py:class:`~katana.local.analytics.JaccardPlan` constructors for algorithm documentation.
+    """
+    Exact = _JaccardPlan.Algorithm.kExact
+    MinHash = _JaccardPlan.Algorithm.kMinHash
+
+
 cdef class JaccardPlan(Plan):
     """
     A computational :ref:`Plan` for Jaccard Similarity.
@@ -89,6 +126,7 @@ cdef class JaccardPlan(Plan):
         return &self.underlying_
 
     EdgeSorting = _JaccardEdgeSorting
+    Algorithm = _JaccardAlgorithm
 
     @staticmethod
     cdef JaccardPlan make(_JaccardPlan u):
@@ -105,6 +143,23 @@ cdef class JaccardPlan(Plan):
         """
         return _JaccardEdgeSorting(self.underlying_.edge_sorting())
 
+    @property
+    def algorithm(self) -> _JaccardAlgorithm:
+        """
+        The algorithm of :py:func:`~katana.local.analytics.jaccard_top_k`.
+
+        :rtype: Algorithm
+        """
+        return _JaccardAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def num_hashes(self) -> int:
+        return self.underlying_.num_hashes()
+
+    @property
+    def rows_per_band(self) -> int:
+        return self.underlying_.rows_per_band()
+
     def __init__(self):
         """
         May attempt sorted intersections, but will fall back on exhaustive intersections.
@@ -131,6 +186,16 @@ cdef class JaccardPlan(Plan):
         """
         return JaccardPlan.make(_JaccardPlan.Unsorted())
 
+    @staticmethod
+    def min_hash(uint32_t num_hashes = kDefaultNumHashes, uint32_t rows_per_band = kDefaultRowsPerBand):
+        """
+        Estimate the similarities of :py:func:`~katana.local.analytics.jaccard_top_k` from MinHash signatures of
+        `num_hashes` hashes, and only compare nodes whose signatures are equal in some band of `rows_per_band`
+        hashes. This does not depend on the size of 2-hop neighborhoods, so it suits graphs with nodes of very high
+        degree. :py:func:`~katana.local.analytics.jaccard` does not use this.
+        """
+        return JaccardPlan.make(_JaccardPlan.MinHash(num_hashes, rows_per_band))
+
 
 def jaccard(Graph pg, size_t compare_node, str output_property_name,
             JaccardPlan plan = JaccardPlan()):
@@ -165,6 +230,33 @@ def jaccard_assert_valid(Graph pg, size_t compare_node, str output_property_name
         handle_result_assert(JaccardAssertValid(pg.underlying_property_graph(), compare_node, output_property_name_cstr))
 
 
+cdef vector[vector[pair[uint32_t, double]]] handle_result_JaccardTopK(
+        Result[vector[vector[pair[uint32_t, double]]]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def jaccard_top_k(Graph pg, size_t k, JaccardPlan plan = JaccardPlan()):
+    """
+    Compute, for every node, the `k` other nodes with the highest Jaccard Similarity to it. With the default plan the
+    similarities are exact and the candidates are the nodes that share a neighbor with the node, so a node may have
+    fewer than `k`; with :py:meth:`JaccardPlan.min_hash` they are estimated.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :param k: The number of nodes to find for each node.
+    :type plan: JaccardPlan
+    :param plan: The execution plan to use.
+    :return: For each node, a list of (node, similarity) pairs by decreasing similarity.
+    """
+    cdef vector[vector[pair[uint32_t, double]]] res
+    with nogil:
+        res = handle_result_JaccardTopK(JaccardTopK(pg.underlying_property_graph(), k, plan.underlying_))
+    return res
+
+
 cdef _JaccardStatistics handle_result_JaccardStatistics(Result[_JaccardStatistics] res) nogil except *:
     if not res.has_value():
         with gil:
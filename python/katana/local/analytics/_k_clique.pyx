@@ -0,0 +1,143 @@
+"""
+k-Clique Counting
+-----------------
+
+.. autoclass:: katana.local.analytics.KCliquePlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._k_clique._KCliquePlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.k_clique_count
+
+.. autofunction:: katana.local.analytics.k_clique_count_per_node
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+
+cdef extern from "katana/analytics/k_clique/k_clique.h" namespace "katana::analytics" nogil:
+    cppclass _KCliquePlan "katana::analytics::KCliquePlan" (_Plan):
+        enum Algorithm:
+            kDegreeOrdered "katana::analytics::KCliquePlan::kDegreeOrdered"
+            kColorOrdered "katana::analytics::KCliquePlan::kColorOrdered"
+
+        _KCliquePlan.Algorithm algorithm() const
+
+        _KCliquePlan()
+
+        @staticmethod
+        _KCliquePlan DegreeOrdered()
+
+        @staticmethod
+        _KCliquePlan ColorOrdered()
+
+    Result[uint64_t] KCliqueCount(_PropertyGraph* pg, uint32_t k, _KCliquePlan plan)
+
+    Result[void] KCliqueCountPerNode(_PropertyGraph* pg, uint32_t k, const string& output_property_name,
+        _KCliquePlan plan)
+
+
+class _KCliquePlanAlgorithm(Enum):
+    """
+    The concrete algorithms available for k-clique counting.
+
+    :see: :py:class:`~katana.local.analytics.KCliquePlan` constructors for algorithm documentation.
+    """
+    DegreeOrdered = _KCliquePlan.Algorithm.kDegreeOrdered
+    ColorOrdered = _KCliquePlan.Algorithm.kColorOrdered
+
+
+cdef class KCliquePlan(Plan):
+    """
+    A computational :ref:`Plan` for k-clique counting.
+
+    Both algorithms direct every edge by an order of the nodes, so that each clique is found once, from its highest
+    node, and list the cliques by intersecting the sorted destinations of the directed edges.
+    """
+    cdef:
+        _KCliquePlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _KCliquePlanAlgorithm
+
+    @staticmethod
+    cdef KCliquePlan make(_KCliquePlan u):
+        f = <KCliquePlan>KCliquePlan.__new__(KCliquePlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _KCliquePlanAlgorithm:
+        return _KCliquePlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def degree_ordered() -> KCliquePlan:
+        """
+        Edges go from higher to lower degree, as in the ordered count of triangle counting.
+        """
+        return KCliquePlan.make(_KCliquePlan.DegreeOrdered())
+
+    @staticmethod
+    def color_ordered() -> KCliquePlan:
+        """
+        Edges go from higher to lower color of a graph coloring, so a node of color c starts no clique of more than
+        c + 1 nodes, which prunes most of the search for large k.
+        """
+        return KCliquePlan.make(_KCliquePlan.ColorOrdered())
+
+
+cdef uint64_t handle_result_int(Result[uint64_t] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def k_clique_count(Graph pg, uint32_t k, KCliquePlan plan = KCliquePlan()) -> int:
+    """
+    Count the cliques of `k` nodes in the symmetric graph `pg`; self loops and parallel edges are ignored.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type k: int
+    :param k: The number of nodes of the cliques.
+    :type plan: KCliquePlan
+    :param plan: The execution plan to use.
+    :return: The number of cliques found.
+    """
+    with nogil:
+        v = handle_result_int(KCliqueCount(pg.underlying_property_graph(), k, plan.underlying_))
+    return v
+
+
+def k_clique_count_per_node(Graph pg, uint32_t k, str output_property_name, KCliquePlan plan = KCliquePlan()):
+    """
+    Count, for every node of the symmetric graph `pg`, the cliques of `k` nodes that contain it.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type k: int
+    :param k: The number of nodes of the cliques.
+    :type output_property_name: str
+    :param output_property_name: The output property holding the count of each node (as uint64). This property must
+        not already exist.
+    :type plan: KCliquePlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(KCliqueCountPerNode(pg.underlying_property_graph(), k, output_property_name_str,
+                                               plan.underlying_))
@@ -18,15 +18,26 @@ k-Core
     :undoc-members:
 
 .. autofunction:: katana.local.analytics.k_core_assert_valid
+
+.. autofunction:: katana.local.analytics.k_core_decomposition
+
+.. autofunction:: katana.local.analytics.k_core_batch
+
+.. autoclass:: katana.local.analytics.KCoreDecompositionStatistics
+    :members:
+    :undoc-members:
 """
 from libc.stdint cimport uint32_t, uint64_t
+from libcpp.memory cimport shared_ptr
 from libcpp.string cimport string
+from libcpp.vector cimport vector
+from pyarrow.lib cimport CTable, pyarrow_wrap_table
 
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
-from katana.local.analytics.plan cimport Plan, _Plan
+from katana.local.analytics.plan cimport Plan, _Plan, handle_result_table
 
 from enum import Enum
 
@@ -59,6 +70,19 @@ cdef extern from "katana/analytics/k_core/k_core.h" namespace "katana::analytics
         @staticmethod
         Result[_KCoreStatistics] Compute(_PropertyGraph* pg, uint32_t k_core_number, string output_property_name)
 
+    Result[void] KCoreDecomposition(_PropertyGraph* pg, string output_property_name)
+
+    Result[shared_ptr[CTable]] KCoreBatch(_PropertyGraph* pg, const vector[uint32_t]& k_core_numbers)
+
+    cppclass _KCoreDecompositionStatistics "katana::analytics::KCoreDecompositionStatistics":
+        uint32_t max_core_number
+        uint64_t number_of_nodes_in_max_core
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_KCoreDecompositionStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
 
 class _KCorePlanAlgorithm(Enum):
     """
@@ -163,3 +187,72 @@ cdef class KCoreStatistics:
         cdef ostringstream ss
         self.underlying.Print(ss)
         return str(ss.str(), "ascii")
+
+
+def k_core_decomposition(Graph pg, str output_property_name):
+    """
+    Compute the core number of every node of pg, the largest k such that the node is in the k-core, by peeling nodes
+    from buckets of nodes by degree. The pg must be symmetric.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property holding the core number of each node. This property must not
+        already exist.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(KCoreDecomposition(pg.underlying_property_graph(), output_property_name_str))
+
+
+def k_core_batch(Graph pg, k_core_numbers):
+    """
+    Compute the k-core of pg for each k of `k_core_numbers` in one call, from the core numbers of the nodes, which are
+    computed once, without adding properties to `pg`. The pg must be symmetric.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type k_core_numbers: Iterable of int
+    :param k_core_numbers: The values of k.
+    :rtype: pyarrow.Table
+    :returns: A table with a column for each k, named by the k, holding 1 for the nodes in the k-core and 0 otherwise.
+    """
+    cdef vector[uint32_t] k_core_numbers_vec = k_core_numbers
+    cdef shared_ptr[CTable] table
+    with nogil:
+        table = handle_result_table(KCoreBatch(pg.underlying_property_graph(), k_core_numbers_vec))
+    return pyarrow_wrap_table(table)
+
+
+cdef _KCoreDecompositionStatistics handle_result_KCoreDecompositionStatistics(
+        Result[_KCoreDecompositionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class KCoreDecompositionStatistics:
+    """
+    Compute the :ref:`statistics` of a k-core decomposition result.
+    """
+    cdef _KCoreDecompositionStatistics underlying
+
+    def __init__(self, Graph pg, str output_property_name):
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_KCoreDecompositionStatistics(_KCoreDecompositionStatistics.Compute(
+                pg.underlying_property_graph(), output_property_name_str))
+
+    @property
+    def max_core_number(self) -> uint32_t:
+        return self.underlying.max_core_number
+
+    @property
+    def number_of_nodes_in_max_core(self) -> uint64_t:
+        return self.underlying.number_of_nodes_in_max_core
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
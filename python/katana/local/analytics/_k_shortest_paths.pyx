@@ -0,0 +1,174 @@
+"""
+k Shortest Paths
+----------------
+
+.. autoclass:: katana.local.analytics.KShortestPathsPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._k_shortest_paths._KShortestPathsPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics.KShortestPathsQuery
+    :members:
+    :special-members: __init__
+
+.. autofunction:: katana.local.analytics.k_shortest_paths
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t
+from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+from pyarrow.lib cimport to_shared
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+
+cdef extern from "katana/analytics/k_shortest_paths/k_shortest_paths.h" namespace "katana::analytics" nogil:
+    cppclass _KShortestPathsPlan "katana::analytics::KShortestPathsPlan" (_Plan):
+        enum Algorithm:
+            kYen "katana::analytics::KShortestPathsPlan::kYen"
+            kLabelSetting "katana::analytics::KShortestPathsPlan::kLabelSetting"
+
+        _KShortestPathsPlan.Algorithm algorithm() const
+
+        _KShortestPathsPlan()
+
+        @staticmethod
+        _KShortestPathsPlan Yen()
+
+        @staticmethod
+        _KShortestPathsPlan LabelSetting()
+
+    cppclass _WeightedPath "katana::analytics::WeightedPath":
+        vector[uint32_t] nodes
+        double weight
+
+    cppclass _KShortestPathsQuery "katana::analytics::KShortestPathsQuery":
+        @staticmethod
+        Result[unique_ptr[_KShortestPathsQuery]] Make(_PropertyGraph* pg, const string& edge_weight_property_name,
+            _KShortestPathsPlan plan)
+
+        Result[vector[_WeightedPath]] Paths(uint32_t source, uint32_t target, size_t k) const
+
+
+class _KShortestPathsPlanAlgorithm(Enum):
+    """
+    The concrete algorithms available for k shortest paths.
+
+    :see: :py:class:`~katana.local.analytics.KShortestPathsPlan` constructors for algorithm documentation.
+    """
+    Yen = _KShortestPathsPlan.Algorithm.kYen
+    LabelSetting = _KShortestPathsPlan.Algorithm.kLabelSetting
+
+
+cdef class KShortestPathsPlan(Plan):
+    """
+    A computational :ref:`Plan` for k shortest paths.
+
+    Both algorithms first compute the distances to the target along in-edges and use them to guide the searches from
+    the source.
+    """
+    cdef:
+        _KShortestPathsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _KShortestPathsPlanAlgorithm
+
+    @staticmethod
+    cdef KShortestPathsPlan make(_KShortestPathsPlan u):
+        f = <KShortestPathsPlan>KShortestPathsPlan.__new__(KShortestPathsPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _KShortestPathsPlanAlgorithm:
+        return _KShortestPathsPlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def yen() -> KShortestPathsPlan:
+        """
+        The k shortest simple paths, which visit no node twice, by Yen's algorithm with Lawler's rule; the spur
+        searches from the nodes of a path run in parallel.
+        """
+        return KShortestPathsPlan.make(_KShortestPathsPlan.Yen())
+
+    @staticmethod
+    def label_setting() -> KShortestPathsPlan:
+        """
+        The k shortest paths, which may visit nodes more than once, by a label-setting search that settles each node
+        at most k times.
+        """
+        return KShortestPathsPlan.make(_KShortestPathsPlan.LabelSetting())
+
+
+cdef shared_ptr[_KShortestPathsQuery] handle_result_k_shortest_paths_query(
+        Result[unique_ptr[_KShortestPathsQuery]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return to_shared(res.value())
+
+
+cdef vector[_WeightedPath] handle_result_paths(Result[vector[_WeightedPath]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class KShortestPathsQuery:
+    """
+    The k shortest paths between pairs of nodes of `pg`. If `edge_weight_property_name` is empty the weight of a path is
+    its number of edges; otherwise it is the sum of the (non-negative) weights of that edge property along it. Of
+    parallel edges only the lightest is used.
+    """
+    cdef shared_ptr[_KShortestPathsQuery] underlying
+    cdef Graph pg
+
+    def __init__(self, Graph pg, str edge_weight_property_name = "", KShortestPathsPlan plan = KShortestPathsPlan()):
+        """
+        :param pg: The graph, whose topology and weights must not change while this is in use.
+        :param edge_weight_property_name: An integer or floating point edge property, or "" to count edges.
+        :param plan: The execution plan to use.
+        """
+        cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+        self.pg = pg
+        with nogil:
+            self.underlying = handle_result_k_shortest_paths_query(
+                _KShortestPathsQuery.Make(pg.underlying_property_graph(), edge_weight_property_name_str,
+                                          plan.underlying_))
+
+    def paths(self, uint32_t source, uint32_t target, size_t k):
+        """
+        :return: Up to `k` shortest paths from `source` to `target` as (weight, nodes) pairs in order of weight, where
+            nodes is the list of nodes from `source` to `target`; fewer if there are not `k` paths.
+        """
+        cdef vector[_WeightedPath] paths
+        with nogil:
+            paths = handle_result_paths(self.underlying.get().Paths(source, target, k))
+        result = []
+        for i in range(paths.size()):
+            result.append((paths[i].weight, list(paths[i].nodes)))
+        return result
+
+
+def k_shortest_paths(Graph pg, uint32_t source, uint32_t target, size_t k, str edge_weight_property_name = "",
+                     KShortestPathsPlan plan = KShortestPathsPlan()):
+    """
+    Compute up to `k` shortest paths from `source` to `target`; see
+    :py:class:`~katana.local.analytics.KShortestPathsQuery`, which answers many queries on the same graph for the cost
+    of one setup.
+
+    :return: (weight, nodes) pairs in order of weight.
+    """
+    return KShortestPathsQuery(pg, edge_weight_property_name, plan).paths(source, target, k)
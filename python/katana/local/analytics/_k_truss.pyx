@@ -20,6 +20,12 @@ The k-Truss is a maximal connected subgraph in which all edges are part of at le
     :undoc-members:
 
 .. autofunction:: katana.local.analytics.k_truss_assert_valid
+
+.. autofunction:: katana.local.analytics.k_truss_decomposition
+
+.. autoclass:: katana.local.analytics.KTrussDecompositionStatistics
+    :members:
+    :undoc-members:
 """
 from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
@@ -65,6 +71,17 @@ cdef extern from "katana/analytics/k_truss/k_truss.h" namespace "katana::analyti
         Result[_KTrussStatistics] Compute(_PropertyGraph* pg, uint32_t k_truss_number,
                                           string output_property_name)
 
+    Result[void] KTrussDecomposition(_PropertyGraph* pg, string output_property_name)
+
+    cppclass _KTrussDecompositionStatistics "katana::analytics::KTrussDecompositionStatistics":
+        uint32_t max_trussness
+        uint64_t number_of_edges_in_max_truss
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_KTrussDecompositionStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
 
 class _KTrussPlanAlgorithm(Enum):
     """
@@ -178,3 +195,53 @@ cdef class KTrussStatistics:
         cdef ostringstream ss
         self.underlying.Print(ss)
         return str(ss.str(), "ascii")
+
+
+def k_truss_decomposition(Graph pg, str output_property_name):
+    """
+    Compute the trussness of every edge of pg, the largest k such that the edge is in the k-truss, by peeling edges
+    from buckets of edges by the number of triangles they are in. The pg must be symmetric.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output edge property holding the trussness of each edge. This property must not
+        already exist.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(KTrussDecomposition(pg.underlying_property_graph(), output_property_name_str))
+
+
+cdef _KTrussDecompositionStatistics handle_result_KTrussDecompositionStatistics(
+        Result[_KTrussDecompositionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class KTrussDecompositionStatistics:
+    """
+    Compute the :ref:`statistics` of a k-truss decomposition result.
+    """
+    cdef _KTrussDecompositionStatistics underlying
+
+    def __init__(self, Graph pg, str output_property_name):
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_KTrussDecompositionStatistics(_KTrussDecompositionStatistics.Compute(
+                pg.underlying_property_graph(), output_property_name_str))
+
+    @property
+    def max_trussness(self) -> uint32_t:
+        return self.underlying.max_trussness
+
+    @property
+    def number_of_edges_in_max_truss(self) -> uint64_t:
+        return self.underlying.number_of_edges_in_max_truss
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
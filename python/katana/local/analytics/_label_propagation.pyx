@@ -0,0 +1,235 @@
+"""
+Label Propagation
+-----------------
+
+.. autoclass:: katana.local.analytics.LabelPropagationPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._label_propagation._LabelPropagationAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.label_propagation
+
+.. autoclass:: katana.local.analytics.LabelPropagationStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.label_propagation_assert_valid
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/label_propagation/label_propagation.h" namespace "katana::analytics" nogil:
+    cppclass _LabelPropagationPlan "katana::analytics::LabelPropagationPlan" (_Plan):
+        enum Algorithm:
+            kSynchronous "katana::analytics::LabelPropagationPlan::kSynchronous"
+            kAsynchronous "katana::analytics::LabelPropagationPlan::kAsynchronous"
+
+        _LabelPropagationPlan.Algorithm algorithm() const
+        uint32_t max_iterations() const
+
+        _LabelPropagationPlan()
+
+        @staticmethod
+        _LabelPropagationPlan Synchronous(uint32_t max_iterations)
+
+        @staticmethod
+        _LabelPropagationPlan Asynchronous(uint32_t max_iterations)
+
+    uint32_t kDefaultMaxIterations "katana::analytics::LabelPropagationPlan::kDefaultMaxIterations"
+
+    Result[void] LabelPropagation(_PropertyGraph* pg, const string& edge_weight_property_name,
+        const string& output_property_name, _LabelPropagationPlan plan)
+
+    Result[void] LabelPropagationAssertValid(_PropertyGraph* pg, const string& property_name)
+
+    cppclass _LabelPropagationStatistics "katana::analytics::LabelPropagationStatistics":
+        uint64_t n_communities
+        uint64_t n_non_trivial_communities
+        uint64_t largest_community_size
+        double largest_community_proportion
+        double modularity
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_LabelPropagationStatistics] Compute(_PropertyGraph* pg, const string& edge_weight_property_name,
+            const string& property_name)
+
+
+class _LabelPropagationAlgorithm(Enum):
+    """
+    The concrete algorithms available for label propagation.
+
+    :see: :py:class:`~katana.local.analytics.LabelPropagationPlan` constructors for algorithm documentation.
+    """
+    Synchronous = _LabelPropagationPlan.Algorithm.kSynchronous
+    Asynchronous = _LabelPropagationPlan.Algorithm.kAsynchronous
+
+
+cdef class LabelPropagationPlan(Plan):
+    """
+    A computational :ref:`Plan` for label propagation.
+
+    Static methods construct LabelPropagationPlans using specific algorithms.
+    """
+    cdef:
+        _LabelPropagationPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _LabelPropagationAlgorithm
+
+    @staticmethod
+    cdef LabelPropagationPlan make(_LabelPropagationPlan u):
+        f = <LabelPropagationPlan>LabelPropagationPlan.__new__(LabelPropagationPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _LabelPropagationAlgorithm:
+        return _LabelPropagationAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def max_iterations(self) -> int:
+        """
+        Maximum number of iterations to execute.
+        """
+        return self.underlying_.max_iterations()
+
+    @staticmethod
+    def synchronous(uint32_t max_iterations = kDefaultMaxIterations) -> LabelPropagationPlan:
+        """
+        In each iteration, every node takes, in parallel, the label of the largest total edge weight among its neighbors
+        in the previous iteration. A node keeps its label when that is among the heaviest, and otherwise takes the
+        smallest of them, so the labels only depend on the graph. Stops after an iteration in which no label changes.
+        """
+        return LabelPropagationPlan.make(_LabelPropagationPlan.Synchronous(max_iterations))
+
+    @staticmethod
+    def asynchronous(uint32_t max_iterations = kDefaultMaxIterations) -> LabelPropagationPlan:
+        """
+        The same choice of labels, but every node reads the labels of its neighbors as they are updated, and only the
+        neighbors of the nodes whose label changed are visited in the next iteration. Usually faster, but the labels
+        depend on the schedule of the threads.
+        """
+        return LabelPropagationPlan.make(_LabelPropagationPlan.Asynchronous(max_iterations))
+
+
+def label_propagation(
+    Graph pg,
+    str edge_weight_property_name,
+    str output_property_name,
+    LabelPropagationPlan plan = LabelPropagationPlan()
+):
+    """
+    Find communities in `pg` by label propagation: every node starts with its own id as a label and repeatedly takes
+    the label most of its neighbors have. The graph must be symmetric; self loops are ignored.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The input edge property holding the weights, which may be a 32- or 64-bit signed
+        or unsigned int, or a float or a double.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the community IDs as uint64. The ID of a community
+        is the smallest id of a node in it. This property must not already exist.
+    :type plan: LabelPropagationPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(LabelPropagation(pg.underlying_property_graph(), edge_weight_property_name_str,
+            output_property_name_str, plan.underlying_))
+
+
+def label_propagation_assert_valid(Graph pg, str property_name):
+    """
+    Raise an exception if a community ID in `property_name` is not the smallest id of a node of that community.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = bytes(property_name, "utf-8")
+    with nogil:
+        handle_result_assert(LabelPropagationAssertValid(pg.underlying_property_graph(), property_name_str))
+
+
+cdef _LabelPropagationStatistics handle_result_LabelPropagationStatistics(
+        Result[_LabelPropagationStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class LabelPropagationStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of the communities found by label propagation.
+    """
+    cdef _LabelPropagationStatistics underlying
+
+    def __init__(self, Graph pg, str edge_weight_property_name, str property_name):
+        """
+        :param pg: The graph on which `label_propagation` was called.
+        :param edge_weight_property_name: The edge weight property name passed to `label_propagation`.
+        :param property_name: The output property name passed to `label_propagation`.
+        """
+        cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+        cdef string property_name_str = bytes(property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_LabelPropagationStatistics(_LabelPropagationStatistics.Compute(
+                pg.underlying_property_graph(), edge_weight_property_name_str, property_name_str))
+
+    @property
+    def n_communities(self) -> int:
+        """
+        Total number of unique communities in the graph.
+        """
+        return self.underlying.n_communities
+
+    @property
+    def n_non_trivial_communities(self) -> int:
+        """
+        Total number of communities with more than 1 node.
+        """
+        return self.underlying.n_non_trivial_communities
+
+    @property
+    def largest_community_size(self) -> int:
+        """
+        The number of nodes present in the largest community.
+        """
+        return self.underlying.largest_community_size
+
+    @property
+    def largest_community_proportion(self) -> float:
+        """
+        The proportion of nodes present in the largest community.
+        """
+        return self.underlying.largest_community_proportion
+
+    @property
+    def modularity(self) -> float:
+        """
+        Modularity of the communities.
+        """
+        return self.underlying.modularity
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -46,6 +46,7 @@ cdef extern from "katana/analytics/louvain_clustering/louvain_clustering.h" name
         double modularity_threshold_total() const
         uint32_t max_iterations() const
         uint32_t min_graph_size() const
+        bool enable_refinement() const
 
         # LouvainClusteringPlan()
 
@@ -55,7 +56,8 @@ cdef extern from "katana/analytics/louvain_clustering/louvain_clustering.h" name
                 double modularity_threshold_per_round,
                 double modularity_threshold_total,
                 uint32_t max_iterations,
-                uint32_t min_graph_size
+                uint32_t min_graph_size,
+                bool enable_refinement
             )
 
         @staticmethod
@@ -64,13 +66,15 @@ cdef extern from "katana/analytics/louvain_clustering/louvain_clustering.h" name
             double modularity_threshold_per_round,
             double modularity_threshold_total,
             uint32_t max_iterations,
-            uint32_t min_graph_size)
+            uint32_t min_graph_size,
+            bool enable_refinement)
 
     bool kDefaultEnableVF "katana::analytics::LouvainClusteringPlan::kDefaultEnableVF"
     double kDefaultModularityThresholdPerRound "katana::analytics::LouvainClusteringPlan::kDefaultModularityThresholdPerRound"
     double kDefaultModularityThresholdTotal "katana::analytics::LouvainClusteringPlan::kDefaultModularityThresholdTotal"
     uint32_t kDefaultMaxIterations "katana::analytics::LouvainClusteringPlan::kDefaultMaxIterations"
     uint32_t kDefaultMinGraphSize "katana::analytics::LouvainClusteringPlan::kDefaultMinGraphSize"
+    bool kDefaultEnableRefinement "katana::analytics::LouvainClusteringPlan::kDefaultEnableRefinement"
 
     Result[void] LouvainClustering(_PropertyGraph* pfg, const string& edge_weight_property_name,const string& output_property_name, _LouvainClusteringPlan plan)
 
@@ -142,6 +146,10 @@ cdef class LouvainClusteringPlan(Plan):
     def min_graph_size(self) -> uint32_t:
         return self.underlying_.min_graph_size()
 
+    @property
+    def enable_refinement(self) -> bool:
+        return self.underlying_.enable_refinement()
+
 
     @staticmethod
     def do_all(
@@ -149,13 +157,15 @@ cdef class LouvainClusteringPlan(Plan):
                 double modularity_threshold_per_round = kDefaultModularityThresholdPerRound,
                 double modularity_threshold_total = kDefaultModularityThresholdTotal,
                 uint32_t max_iterations = kDefaultMaxIterations,
-                uint32_t min_graph_size = kDefaultMinGraphSize
+                uint32_t min_graph_size = kDefaultMinGraphSize,
+                bool enable_refinement = kDefaultEnableRefinement
             ) -> LouvainClusteringPlan:
         """
         Nondeterministic algorithm.
         """
         return LouvainClusteringPlan.make(_LouvainClusteringPlan.DoAll(
-             enable_vf, modularity_threshold_per_round, modularity_threshold_total, max_iterations, min_graph_size))
+             enable_vf, modularity_threshold_per_round, modularity_threshold_total, max_iterations, min_graph_size,
+            enable_refinement))
 
     @staticmethod
     def deterministic(
@@ -163,13 +173,15 @@ cdef class LouvainClusteringPlan(Plan):
             double modularity_threshold_per_round = kDefaultModularityThresholdPerRound,
             double modularity_threshold_total = kDefaultModularityThresholdTotal,
             uint32_t max_iterations = kDefaultMaxIterations,
-            uint32_t min_graph_size = kDefaultMinGraphSize
+            uint32_t min_graph_size = kDefaultMinGraphSize,
+            bool enable_refinement = kDefaultEnableRefinement
     ) -> LouvainClusteringPlan:
         """
-         Deterministic algorithm using delayed updates
+         Deterministic algorithm using delayed updates. The clusters are the same for any number of threads.
         """
         return LouvainClusteringPlan.make(_LouvainClusteringPlan.Deterministic(
-            enable_vf, modularity_threshold_per_round, modularity_threshold_total, max_iterations, min_graph_size))
+            enable_vf, modularity_threshold_per_round, modularity_threshold_total, max_iterations, min_graph_size,
+            enable_refinement))
 
 def louvain_clustering(Graph pg, str edge_weight_property_name, str output_property_name, LouvainClusteringPlan plan = LouvainClusteringPlan()):
     """
@@ -0,0 +1,254 @@
+"""
+Matrix Completion
+-----------------
+
+.. autoclass:: katana.local.analytics.MatrixCompletionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._matrix_completion._MatrixCompletionAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.matrix_completion
+
+.. autoclass:: katana.local.analytics.MatrixCompletionStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.matrix_completion_assert_valid
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/matrix_completion/matrix_completion.h" namespace "katana::analytics" nogil:
+    cppclass _MatrixCompletionPlan "katana::analytics::MatrixCompletionPlan" (_Plan):
+        enum Algorithm:
+            kSgd "katana::analytics::MatrixCompletionPlan::kSgd"
+            kAls "katana::analytics::MatrixCompletionPlan::kAls"
+
+        _MatrixCompletionPlan.Algorithm algorithm() const
+        uint32_t latent_vector_size() const
+        double lambda_ "lambda"() const
+        double learning_rate() const
+        double decay_rate() const
+        uint32_t max_rounds() const
+        double tolerance() const
+
+        _MatrixCompletionPlan()
+
+        @staticmethod
+        _MatrixCompletionPlan Sgd(uint32_t latent_vector_size, double lambda_, double learning_rate, double decay_rate,
+            uint32_t max_rounds, double tolerance)
+
+        @staticmethod
+        _MatrixCompletionPlan Als(uint32_t latent_vector_size, double lambda_, uint32_t max_rounds, double tolerance)
+
+    uint32_t kDefaultLatentVectorSize "katana::analytics::MatrixCompletionPlan::kDefaultLatentVectorSize"
+    double kDefaultLambda "katana::analytics::MatrixCompletionPlan::kDefaultLambda"
+    double kDefaultLearningRate "katana::analytics::MatrixCompletionPlan::kDefaultLearningRate"
+    double kDefaultDecayRate "katana::analytics::MatrixCompletionPlan::kDefaultDecayRate"
+    uint32_t kDefaultMaxRounds "katana::analytics::MatrixCompletionPlan::kDefaultMaxRounds"
+    double kDefaultTolerance "katana::analytics::MatrixCompletionPlan::kDefaultTolerance"
+
+    Result[void] MatrixCompletion(_PropertyGraph* pg, const string& edge_rating_property_name,
+        const string& output_property_name, _MatrixCompletionPlan plan)
+
+    Result[void] MatrixCompletionAssertValid(_PropertyGraph* pg, const string& property_name)
+
+    cppclass _MatrixCompletionStatistics "katana::analytics::MatrixCompletionStatistics":
+        double root_mean_squared_error
+        uint32_t latent_vector_size
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MatrixCompletionStatistics] Compute(_PropertyGraph* pg, const string& edge_rating_property_name,
+            const string& property_name)
+
+
+class _MatrixCompletionAlgorithm(Enum):
+    """
+    The concrete algorithms available for matrix completion.
+
+    :see: :py:class:`~katana.local.analytics.MatrixCompletionPlan` constructors for algorithm documentation.
+    """
+    Sgd = _MatrixCompletionPlan.Algorithm.kSgd
+    Als = _MatrixCompletionPlan.Algorithm.kAls
+
+
+cdef class MatrixCompletionPlan(Plan):
+    """
+    A computational :ref:`Plan` for matrix completion.
+
+    Static methods construct MatrixCompletionPlans using specific algorithms with their required parameters. All
+    parameters are optional and have reasonable defaults.
+    """
+    cdef:
+        _MatrixCompletionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MatrixCompletionAlgorithm
+
+    @staticmethod
+    cdef MatrixCompletionPlan make(_MatrixCompletionPlan u):
+        f = <MatrixCompletionPlan>MatrixCompletionPlan.__new__(MatrixCompletionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _MatrixCompletionAlgorithm:
+        return _MatrixCompletionAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def latent_vector_size(self) -> int:
+        """
+        The number of floats in each latent vector.
+        """
+        return self.underlying_.latent_vector_size()
+
+    @property
+    def lambda_(self) -> float:
+        """
+        The weight of the squared norms of the latent vectors in the objective.
+        """
+        return self.underlying_.lambda_()
+
+    @property
+    def learning_rate(self) -> float:
+        return self.underlying_.learning_rate()
+
+    @property
+    def decay_rate(self) -> float:
+        return self.underlying_.decay_rate()
+
+    @property
+    def max_rounds(self) -> int:
+        return self.underlying_.max_rounds()
+
+    @property
+    def tolerance(self) -> float:
+        """
+        The relative improvement of the root mean squared error below which the rounds stop.
+        """
+        return self.underlying_.tolerance()
+
+    @staticmethod
+    def sgd(
+        uint32_t latent_vector_size = kDefaultLatentVectorSize,
+        double lambda_ = kDefaultLambda,
+        double learning_rate = kDefaultLearningRate,
+        double decay_rate = kDefaultDecayRate,
+        uint32_t max_rounds = kDefaultMaxRounds,
+        double tolerance = kDefaultTolerance,
+    ) -> MatrixCompletionPlan:
+        """
+        Stochastic gradient descent, Hogwild style: the ratings of different users are applied in parallel and the
+        latent vectors they share are updated without locks. Round `r` takes steps of
+        `learning_rate` * 1.5 / (1 + `decay_rate` * (`r` + 1)^1.5).
+        """
+        return MatrixCompletionPlan.make(
+            _MatrixCompletionPlan.Sgd(latent_vector_size, lambda_, learning_rate, decay_rate, max_rounds, tolerance)
+        )
+
+    @staticmethod
+    def als(
+        uint32_t latent_vector_size = kDefaultLatentVectorSize,
+        double lambda_ = kDefaultLambda,
+        uint32_t max_rounds = kDefaultMaxRounds,
+        double tolerance = kDefaultTolerance,
+    ) -> MatrixCompletionPlan:
+        """
+        Alternating least squares: each round solves the regularized least squares problem of every user in parallel,
+        and then that of every item.
+        """
+        return MatrixCompletionPlan.make(_MatrixCompletionPlan.Als(latent_vector_size, lambda_, max_rounds, tolerance))
+
+
+def matrix_completion(Graph pg, str edge_rating_property_name, str output_property_name,
+                      MatrixCompletionPlan plan = MatrixCompletionPlan()):
+    """
+    Factor the ratings of a bipartite graph, in which every edge goes from a user to an item, into a latent vector
+    for each node, such that the dot product of the vectors of a user and an item predicts the rating.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph of ratings.
+    :type edge_rating_property_name: str
+    :param edge_rating_property_name: The input edge property holding the ratings.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the latent vectors, as fixed size lists of floats.
+        This property must not already exist.
+    :type plan: MatrixCompletionPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string edge_rating_property_name_str = bytes(edge_rating_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(MatrixCompletion(pg.underlying_property_graph(), edge_rating_property_name_str,
+                                            output_property_name_str, plan.underlying_))
+
+
+def matrix_completion_assert_valid(Graph pg, str property_name):
+    """
+    Raise an exception if `property_name` does not hold a finite latent vector for every node.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = bytes(property_name, "utf-8")
+    with nogil:
+        handle_result_assert(MatrixCompletionAssertValid(pg.underlying_property_graph(), property_name_str))
+
+
+cdef _MatrixCompletionStatistics handle_result_MatrixCompletionStatistics(
+        Result[_MatrixCompletionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MatrixCompletionStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of a matrix completion.
+    """
+    cdef _MatrixCompletionStatistics underlying
+
+    def __init__(self, Graph pg, str edge_rating_property_name, str property_name):
+        """
+        :param pg: The graph on which `matrix_completion` was called.
+        :param edge_rating_property_name: The edge rating property name passed to `matrix_completion`.
+        :param property_name: The output property name passed to `matrix_completion`.
+        """
+        cdef string edge_rating_property_name_str = bytes(edge_rating_property_name, "utf-8")
+        cdef string property_name_str = bytes(property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_MatrixCompletionStatistics(_MatrixCompletionStatistics.Compute(
+                pg.underlying_property_graph(), edge_rating_property_name_str, property_name_str))
+
+    @property
+    def root_mean_squared_error(self) -> float:
+        """
+        The root mean squared error of the predicted ratings.
+        """
+        return self.underlying.root_mean_squared_error
+
+    @property
+    def latent_vector_size(self) -> int:
+        return self.underlying.latent_vector_size
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,201 @@
+"""
+Maximum Flow
+------------
+
+.. autoclass:: katana.local.analytics.MaxFlowPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._max_flow._MaxFlowAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.max_flow
+
+.. autoclass:: katana.local.analytics.MaxFlowStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.max_flow_assert_valid
+"""
+from enum import Enum
+
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/max_flow/max_flow.h" namespace "katana::analytics" nogil:
+    cppclass _MaxFlowPlan "katana::analytics::MaxFlowPlan" (_Plan):
+        enum Algorithm:
+            kPreflowPush "katana::analytics::MaxFlowPlan::kPreflowPush"
+
+        _MaxFlowPlan.Algorithm algorithm() const
+        uint64_t global_relabel_interval() const
+
+        _MaxFlowPlan()
+
+        @staticmethod
+        _MaxFlowPlan PreflowPush(uint64_t global_relabel_interval)
+
+    uint64_t kDefaultGlobalRelabelInterval "katana::analytics::MaxFlowPlan::kDefaultGlobalRelabelInterval"
+
+    Result[void] MaxFlow(_PropertyGraph* pg, size_t source, size_t sink, const string& edge_capacity_property_name,
+        const string& output_property_name, _MaxFlowPlan plan)
+
+    Result[void] MaxFlowAssertValid(_PropertyGraph* pg, size_t source, size_t sink,
+        const string& edge_capacity_property_name, const string& property_name)
+
+    cppclass _MaxFlowStatistics "katana::analytics::MaxFlowStatistics":
+        uint64_t total_flow
+        uint64_t source_side_size
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MaxFlowStatistics] Compute(_PropertyGraph* pg, size_t source,
+            const string& edge_capacity_property_name, const string& property_name)
+
+
+class _MaxFlowAlgorithm(Enum):
+    """
+    The concrete algorithms available for the maximum flow.
+
+    :see: :py:class:`~katana.local.analytics.MaxFlowPlan` constructors for algorithm documentation.
+    """
+    PreflowPush = _MaxFlowPlan.Algorithm.kPreflowPush
+
+
+cdef class MaxFlowPlan(Plan):
+    """
+    A computational :ref:`Plan` for the maximum flow.
+
+    Static methods construct MaxFlowPlans using specific algorithms with their required parameters. All parameters are
+    optional and have reasonable defaults.
+    """
+    cdef:
+        _MaxFlowPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MaxFlowAlgorithm
+
+    @staticmethod
+    cdef MaxFlowPlan make(_MaxFlowPlan u):
+        f = <MaxFlowPlan>MaxFlowPlan.__new__(MaxFlowPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _MaxFlowAlgorithm:
+        return _MaxFlowAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def global_relabel_interval(self) -> int:
+        """
+        The work between global relabels, or 0 to select it from the size of the graph.
+        """
+        return self.underlying_.global_relabel_interval()
+
+    @staticmethod
+    def preflow_push(uint64_t global_relabel_interval = kDefaultGlobalRelabelInterval) -> MaxFlowPlan:
+        """
+        Preflow push, discharging active nodes in parallel. Every `global_relabel_interval` units of work, a
+        breadth-first search from the sink recomputes the heights while the discharges go on, and the nodes above an
+        empty height are lifted out of reach of the sink.
+        """
+        return MaxFlowPlan.make(_MaxFlowPlan.PreflowPush(global_relabel_interval))
+
+
+def max_flow(Graph pg, size_t source, size_t sink, str edge_capacity_property_name, str output_property_name,
+             MaxFlowPlan plan = MaxFlowPlan()):
+    """
+    Compute a maximum flow from `source` to `sink` in `pg`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type source: int
+    :param source: The node the flow leaves from.
+    :type sink: int
+    :param sink: The node the flow arrives at.
+    :type edge_capacity_property_name: str
+    :param edge_capacity_property_name: The input property containing non-negative integer edge capacities.
+    :type output_property_name: str
+    :param output_property_name: The output edge property holding the flow along each edge. This property must not
+        already exist.
+    :type plan: MaxFlowPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string edge_capacity_property_name_str = bytes(edge_capacity_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(MaxFlow(pg.underlying_property_graph(), source, sink, edge_capacity_property_name_str,
+                                   output_property_name_str, plan.underlying_))
+
+
+def max_flow_assert_valid(Graph pg, size_t source, size_t sink, str edge_capacity_property_name,
+                          str property_name):
+    """
+    Raise an exception if `property_name` is not a flow from `source` to `sink` within the capacities, or if it could
+    be augmented.
+
+    :raises: AssertionError
+    """
+    cdef string edge_capacity_property_name_str = bytes(edge_capacity_property_name, "utf-8")
+    cdef string property_name_str = bytes(property_name, "utf-8")
+    with nogil:
+        handle_result_assert(MaxFlowAssertValid(pg.underlying_property_graph(), source, sink,
+                                                edge_capacity_property_name_str, property_name_str))
+
+
+cdef _MaxFlowStatistics handle_result_MaxFlowStatistics(Result[_MaxFlowStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MaxFlowStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of a maximum flow.
+    """
+    cdef _MaxFlowStatistics underlying
+
+    def __init__(self, Graph pg, size_t source, str edge_capacity_property_name, str property_name):
+        """
+        :param pg: The graph on which `max_flow` was called.
+        :param source: The source passed to `max_flow`.
+        :param edge_capacity_property_name: The edge capacity property name passed to `max_flow`.
+        :param property_name: The output property name passed to `max_flow`.
+        """
+        cdef string edge_capacity_property_name_str = bytes(edge_capacity_property_name, "utf-8")
+        cdef string property_name_str = bytes(property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_MaxFlowStatistics(_MaxFlowStatistics.Compute(
+                pg.underlying_property_graph(), source, edge_capacity_property_name_str, property_name_str))
+
+    @property
+    def total_flow(self) -> int:
+        """
+        The flow out of the source.
+        """
+        return self.underlying.total_flow
+
+    @property
+    def source_side_size(self) -> int:
+        """
+        The number of nodes on the source side of the minimum cut.
+        """
+        return self.underlying.source_side_size
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
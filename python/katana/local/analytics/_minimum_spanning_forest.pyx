@@ -0,0 +1,218 @@
+"""
+Minimum Spanning Forest
+-----------------------
+
+.. autoclass:: katana.local.analytics.MinimumSpanningForestPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._minimum_spanning_forest._MinimumSpanningForestAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.minimum_spanning_forest
+
+.. autoclass:: katana.local.analytics.MinimumSpanningForestStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.minimum_spanning_forest_assert_valid
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h" namespace "katana::analytics" nogil:
+    cppclass _MinimumSpanningForestPlan "katana::analytics::MinimumSpanningForestPlan" (_Plan):
+        enum Algorithm:
+            kBoruvka "katana::analytics::MinimumSpanningForestPlan::kBoruvka"
+            kFilterKruskal "katana::analytics::MinimumSpanningForestPlan::kFilterKruskal"
+
+        _MinimumSpanningForestPlan.Algorithm algorithm() const
+        uint32_t base_case_size() const
+
+        _MinimumSpanningForestPlan()
+
+        @staticmethod
+        _MinimumSpanningForestPlan Boruvka()
+        @staticmethod
+        _MinimumSpanningForestPlan FilterKruskal(uint32_t base_case_size)
+
+    uint32_t kDefaultBaseCaseSize "katana::analytics::MinimumSpanningForestPlan::kDefaultBaseCaseSize"
+
+    Result[void] MinimumSpanningForest(_PropertyGraph* pg, const string& edge_weight_property_name,
+        const string& output_property_name, _MinimumSpanningForestPlan plan)
+
+    Result[void] MinimumSpanningForestAssertValid(_PropertyGraph* pg, const string& edge_weight_property_name,
+        const string& output_property_name)
+
+    cppclass _MinimumSpanningForestStatistics "katana::analytics::MinimumSpanningForestStatistics":
+        uint64_t number_of_edges
+        uint64_t number_of_trees
+        double total_weight
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MinimumSpanningForestStatistics] Compute(_PropertyGraph* pg, const string& edge_weight_property_name,
+            const string& output_property_name)
+
+
+class _MinimumSpanningForestAlgorithm(Enum):
+    """
+    The concrete algorithms available for the minimum spanning forest.
+
+    :see: :py:class:`~katana.local.analytics.MinimumSpanningForestPlan` constructors for algorithm documentation.
+    """
+    Boruvka = _MinimumSpanningForestPlan.Algorithm.kBoruvka
+    FilterKruskal = _MinimumSpanningForestPlan.Algorithm.kFilterKruskal
+
+
+cdef class MinimumSpanningForestPlan(Plan):
+    """
+    A computational :ref:`Plan` for the minimum spanning forest.
+
+    Static methods construct MinimumSpanningForestPlans using specific algorithms with their required parameters. All
+    parameters are optional and have reasonable defaults.
+    """
+    cdef:
+        _MinimumSpanningForestPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MinimumSpanningForestAlgorithm
+
+    @staticmethod
+    cdef MinimumSpanningForestPlan make(_MinimumSpanningForestPlan u):
+        f = <MinimumSpanningForestPlan>MinimumSpanningForestPlan.__new__(MinimumSpanningForestPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _MinimumSpanningForestAlgorithm:
+        return _MinimumSpanningForestAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def base_case_size(self) -> int:
+        """
+        The largest number of edges that Filter-Kruskal sorts instead of partitioning.
+        """
+        return self.underlying_.base_case_size()
+
+    @staticmethod
+    def boruvka() -> MinimumSpanningForestPlan:
+        """
+        Boruvka's algorithm: every component picks its lightest edge to another component in each round, the
+        components are merged along these edges, and the edges within one component are filtered out.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.Boruvka())
+
+    @staticmethod
+    def filter_kruskal(uint32_t base_case_size = kDefaultBaseCaseSize) -> MinimumSpanningForestPlan:
+        """
+        Filter-Kruskal: the edges are partitioned around a pivot weight, and the edges heavier than the pivot within
+        one component are filtered out after the lighter ones are solved. Ranges of at most `base_case_size` edges are
+        sorted as in Kruskal's algorithm.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.FilterKruskal(base_case_size))
+
+
+def minimum_spanning_forest(Graph pg, str edge_weight_property_name, str output_property_name,
+                            MinimumSpanningForestPlan plan = MinimumSpanningForestPlan()):
+    """
+    Compute a minimum spanning forest of `pg`, taking the edges as undirected. Ties between equal weights are broken
+    by edge id, so the forest does not depend on the plan.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The input property containing edge weights.
+    :type output_property_name: str
+    :param output_property_name: The output edge property holding 1 for the edges in the forest, and 0 otherwise. Of
+        the two directions of an edge of a symmetric graph, only one is marked. This property must not already exist.
+    :type plan: MinimumSpanningForestPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(MinimumSpanningForest(pg.underlying_property_graph(), edge_weight_property_name_str,
+                                                 output_property_name_str, plan.underlying_))
+
+
+def minimum_spanning_forest_assert_valid(Graph pg, str edge_weight_property_name, str output_property_name):
+    """
+    Raise an exception if the edges marked in `output_property_name` are not a spanning forest of `pg` of minimum
+    weight.
+
+    :raises: AssertionError
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_assert(MinimumSpanningForestAssertValid(pg.underlying_property_graph(),
+                                                              edge_weight_property_name_str,
+                                                              output_property_name_str))
+
+
+cdef _MinimumSpanningForestStatistics handle_result_MinimumSpanningForestStatistics(
+        Result[_MinimumSpanningForestStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MinimumSpanningForestStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of a minimum spanning forest.
+    """
+    cdef _MinimumSpanningForestStatistics underlying
+
+    def __init__(self, Graph pg, str edge_weight_property_name, str output_property_name):
+        """
+        :param pg: The graph on which `minimum_spanning_forest` was called.
+        :param edge_weight_property_name: The edge weight property name passed to `minimum_spanning_forest`.
+        :param output_property_name: The output property name passed to `minimum_spanning_forest`.
+        """
+        cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+        cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_MinimumSpanningForestStatistics(_MinimumSpanningForestStatistics.Compute(
+                pg.underlying_property_graph(), edge_weight_property_name_str, output_property_name_str))
+
+    @property
+    def number_of_edges(self) -> int:
+        """
+        The number of edges in the forest.
+        """
+        return self.underlying.number_of_edges
+
+    @property
+    def number_of_trees(self) -> int:
+        """
+        The number of trees in the forest, including the single nodes.
+        """
+        return self.underlying.number_of_trees
+
+    @property
+    def total_weight(self) -> float:
+        """
+        The sum of the weights of the edges in the forest.
+        """
+        return self.underlying.total_weight
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
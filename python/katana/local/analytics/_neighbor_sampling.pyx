@@ -0,0 +1,295 @@
+"""
+Neighbor Sampling
+-----------------
+
+.. autoclass:: katana.local.analytics.NeighborSamplingPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._neighbor_sampling._NeighborSamplingAlgorithm
+    :members:
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics.NeighborSampler
+    :members:
+    :special-members: __init__
+
+.. autoclass:: katana.local.analytics.SampledBlock
+    :members:
+
+.. autoclass:: katana.local.analytics.SampledMiniBatch
+    :members:
+"""
+from enum import Enum
+
+import numpy as np
+
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp cimport bool
+from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+from pyarrow.lib cimport CTable, pyarrow_wrap_table, to_shared
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+
+cdef extern from "katana/analytics/neighbor_sampling/neighbor_sampling.h" namespace "katana::analytics" nogil:
+    cppclass _NeighborSamplingPlan "katana::analytics::NeighborSamplingPlan" (_Plan):
+        enum Algorithm:
+            kUniform "katana::analytics::NeighborSamplingPlan::kUniform"
+
+        _NeighborSamplingPlan.Algorithm algorithm() const
+        bool with_replacement() const
+        uint64_t seed() const
+
+        _NeighborSamplingPlan()
+
+        @staticmethod
+        _NeighborSamplingPlan Uniform(bool with_replacement, uint64_t seed)
+
+    uint64_t kDefaultSeed "katana::analytics::NeighborSamplingPlan::kDefaultSeed"
+
+    cppclass _SampledBlock "katana::analytics::SampledBlock":
+        vector[uint32_t] dst_nodes
+        vector[uint32_t] src_nodes
+        vector[uint64_t] indptr
+        vector[uint32_t] indices
+        vector[uint64_t] edge_ids
+
+    cppclass _SampledMiniBatch "katana::analytics::SampledMiniBatch":
+        vector[_SampledBlock] blocks
+        vector[uint32_t] input_nodes
+        shared_ptr[CTable] features
+
+    cppclass _NeighborSampler "katana::analytics::NeighborSampler":
+        @staticmethod
+        Result[unique_ptr[_NeighborSampler]] Make(_PropertyGraph* pg, vector[uint32_t] fanouts,
+            vector[string] feature_properties, _NeighborSamplingPlan plan)
+
+        Result[_SampledMiniBatch] Sample(const vector[uint32_t]& seeds, uint64_t batch_index)
+        Result[void] Prefetch(vector[uint32_t] seeds, uint64_t batch_index)
+        Result[_SampledMiniBatch] TakePrefetched()
+        bool is_prefetching() const
+
+    uint32_t kAllNeighbors "katana::analytics::NeighborSampler::kAllNeighbors"
+
+
+ALL_NEIGHBORS = kAllNeighbors
+
+
+class _NeighborSamplingAlgorithm(Enum):
+    """
+    The concrete algorithms available for neighbor sampling.
+
+    :see: :py:class:`~katana.local.analytics.NeighborSamplingPlan` constructors for algorithm documentation.
+    """
+    Uniform = _NeighborSamplingPlan.Algorithm.kUniform
+
+
+cdef class NeighborSamplingPlan(Plan):
+    """
+    A computational :ref:`Plan` for neighbor sampling.
+
+    Static methods construct NeighborSamplingPlans using specific algorithms.
+    """
+    cdef:
+        _NeighborSamplingPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _NeighborSamplingAlgorithm
+
+    @staticmethod
+    cdef NeighborSamplingPlan make(_NeighborSamplingPlan u):
+        f = <NeighborSamplingPlan>NeighborSamplingPlan.__new__(NeighborSamplingPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _NeighborSamplingAlgorithm:
+        return _NeighborSamplingAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def with_replacement(self) -> bool:
+        """
+        Whether a neighbor may be sampled more than once.
+        """
+        return self.underlying_.with_replacement()
+
+    @property
+    def seed(self) -> int:
+        return self.underlying_.seed()
+
+    @staticmethod
+    def uniform(bool with_replacement = False, uint64_t seed = kDefaultSeed) -> NeighborSamplingPlan:
+        """
+        Sample the fanout neighbors of each node uniformly at random, as in GraphSAGE (Hamilton et al., "Inductive
+        Representation Learning on Large Graphs", NeurIPS 2017). Without replacement, a node with at most fanout
+        neighbors keeps all of them. A batch is sampled the same way whatever the number of threads.
+        """
+        return NeighborSamplingPlan.make(_NeighborSamplingPlan.Uniform(with_replacement, seed))
+
+
+cdef _uint32_array(const vector[uint32_t]& v):
+    if v.empty():
+        return np.empty(0, dtype=np.uint32)
+    return np.array(<uint32_t[:v.size()]>(<uint32_t*>v.data()))
+
+
+cdef _uint64_array(const vector[uint64_t]& v):
+    if v.empty():
+        return np.empty(0, dtype=np.uint64)
+    return np.array(<uint64_t[:v.size()]>(<uint64_t*>v.data()))
+
+
+cdef class SampledBlock:
+    """
+    One hop of a sampled mini-batch: the sampled edges from the destination nodes to their neighbors, the source
+    nodes, in CSR by destination, as numpy arrays.
+
+    - `dst_nodes`: the nodes of the graph whose neighbors were sampled.
+    - `src_nodes`: the destination nodes followed by the other sampled neighbors, each once.
+    - `indptr`: the sampled edges of destination i are `indptr[i]` to `indptr[i + 1]`.
+    - `indices`: the index in `src_nodes` of the neighbor of each sampled edge.
+    - `edge_ids`: the id in the graph of each sampled edge.
+    """
+    cdef readonly object dst_nodes
+    cdef readonly object src_nodes
+    cdef readonly object indptr
+    cdef readonly object indices
+    cdef readonly object edge_ids
+
+    @staticmethod
+    cdef SampledBlock make(const _SampledBlock& u):
+        f = <SampledBlock>SampledBlock.__new__(SampledBlock)
+        f.dst_nodes = _uint32_array(u.dst_nodes)
+        f.src_nodes = _uint32_array(u.src_nodes)
+        f.indptr = _uint64_array(u.indptr)
+        f.indices = _uint32_array(u.indices)
+        f.edge_ids = _uint64_array(u.edge_ids)
+        return f
+
+    def num_edges(self) -> int:
+        return len(self.indices)
+
+
+cdef class SampledMiniBatch:
+    """
+    The sampled subgraphs of a batch of seed nodes and the features of the nodes they reach.
+
+    - `blocks`: a :py:class:`SampledBlock` for each fanout, from the seeds outwards.
+    - `input_nodes`: the source nodes of the last block, or the seeds if there are no fanouts.
+    - `features`: a pyarrow.Table of the feature properties of the input nodes, a row for each.
+    """
+    cdef readonly list blocks
+    cdef readonly object input_nodes
+    cdef readonly object features
+
+    @staticmethod
+    cdef SampledMiniBatch make(const _SampledMiniBatch& u):
+        f = <SampledMiniBatch>SampledMiniBatch.__new__(SampledMiniBatch)
+        f.blocks = [SampledBlock.make(b) for b in u.blocks]
+        f.input_nodes = _uint32_array(u.input_nodes)
+        f.features = pyarrow_wrap_table(u.features)
+        return f
+
+
+cdef shared_ptr[_NeighborSampler] handle_result_neighbor_sampler(
+        Result[unique_ptr[_NeighborSampler]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return to_shared(res.value())
+
+
+cdef _SampledMiniBatch handle_result_SampledMiniBatch(Result[_SampledMiniBatch] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class NeighborSampler:
+    """
+    Samples GNN mini-batches from `pg`, layer by layer: the neighbors of each seed along its out-edges, up to
+    `fanouts[0]` of them, then the neighbors of those, up to `fanouts[1]`, and so on, with the `feature_properties`
+    of the nodes reached. The sampling runs in parallel without the GIL.
+
+    :py:meth:`batches` samples each batch while the caller trains on the previous one.
+    """
+    cdef shared_ptr[_NeighborSampler] underlying
+    cdef Graph pg
+
+    def __init__(
+        self, Graph pg, fanouts, feature_properties=(), NeighborSamplingPlan plan = NeighborSamplingPlan()
+    ):
+        """
+        :param pg: The graph to sample, which must not change while the sampler is in use.
+        :param fanouts: The most neighbors to sample of each node at each hop; `ALL_NEIGHBORS` keeps them all.
+        :param feature_properties: The names of the node properties to gather for the input nodes.
+        :param plan: The execution plan to use.
+        """
+        cdef vector[uint32_t] fanouts_vec = [<uint32_t>f for f in fanouts]
+        cdef vector[string] feature_properties_vec = [bytes(name, "utf-8") for name in feature_properties]
+        self.pg = pg
+        with nogil:
+            self.underlying = handle_result_neighbor_sampler(_NeighborSampler.Make(
+                pg.underlying_property_graph(), fanouts_vec, feature_properties_vec, plan.underlying_))
+
+    def sample(self, seeds, uint64_t batch_index = 0) -> SampledMiniBatch:
+        """
+        Sample the subgraph of the distinct nodes `seeds`; `batch_index` picks the random choices, so the same seeds
+        and `batch_index` give the same batch.
+        """
+        cdef vector[uint32_t] seeds_vec = [<uint32_t>n for n in seeds]
+        cdef _SampledMiniBatch batch
+        with nogil:
+            batch = handle_result_SampledMiniBatch(self.underlying.get().Sample(seeds_vec, batch_index))
+        return SampledMiniBatch.make(batch)
+
+    def prefetch(self, seeds, uint64_t batch_index = 0):
+        """
+        Start sampling the subgraph of `seeds` on a background thread. It holds a lease of the thread pool while it
+        samples, so other threads must hold one to run parallel loops until :py:meth:`take_prefetched`
+        returns.
+        """
+        cdef vector[uint32_t] seeds_vec = [<uint32_t>n for n in seeds]
+        with nogil:
+            handle_result_void(self.underlying.get().Prefetch(seeds_vec, batch_index))
+
+    def take_prefetched(self) -> SampledMiniBatch:
+        """
+        Wait for the batch that :py:meth:`prefetch` started and return it.
+        """
+        cdef _SampledMiniBatch batch
+        with nogil:
+            batch = handle_result_SampledMiniBatch(self.underlying.get().TakePrefetched())
+        return SampledMiniBatch.make(batch)
+
+    @property
+    def is_prefetching(self) -> bool:
+        return self.underlying.get().is_prefetching()
+
+    def batches(self, seed_batches):
+        """
+        Yield the sampled batch of each batch of seeds in `seed_batches`, the i-th with batch index i. The next batch
+        is sampled in the background while the caller works on the current one.
+        """
+        iterator = iter(seed_batches)
+        seeds = next(iterator, None)
+        index = 0
+        if seeds is not None:
+            self.prefetch(seeds, index)
+        while seeds is not None:
+            batch = self.take_prefetched()
+            seeds = next(iterator, None)
+            index += 1
+            if seeds is not None:
+                self.prefetch(seeds, index)
+            yield batch
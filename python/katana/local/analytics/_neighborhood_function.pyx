@@ -0,0 +1,190 @@
+"""
+Neighborhood Function
+---------------------
+
+.. autoclass:: katana.local.analytics.NeighborhoodFunctionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._neighborhood_function._NeighborhoodFunctionAlgorithm
+    :members:
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics.NeighborhoodFunctionEstimate
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.estimate_neighborhood_function
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/neighborhood_function/neighborhood_function.h" namespace "katana::analytics" nogil:
+    cppclass _NeighborhoodFunctionPlan "katana::analytics::NeighborhoodFunctionPlan" (_Plan):
+        enum Algorithm:
+            kHyperAnf "katana::analytics::NeighborhoodFunctionPlan::kHyperAnf"
+
+        _NeighborhoodFunctionPlan.Algorithm algorithm() const
+        uint32_t log2_num_registers() const
+        uint32_t max_iterations() const
+
+        _NeighborhoodFunctionPlan()
+
+        @staticmethod
+        _NeighborhoodFunctionPlan HyperAnf(uint32_t log2_num_registers, uint32_t max_iterations)
+
+    uint32_t kDefaultLog2NumRegisters "katana::analytics::NeighborhoodFunctionPlan::kDefaultLog2NumRegisters"
+    uint32_t kDefaultMaxIterations "katana::analytics::NeighborhoodFunctionPlan::kDefaultMaxIterations"
+
+    cppclass _NeighborhoodFunctionEstimate "katana::analytics::NeighborhoodFunctionEstimate":
+        vector[double] neighborhood_function
+
+        double EffectiveDiameter(double fraction) const
+
+        void Print(ostream os)
+
+    Result[_NeighborhoodFunctionEstimate] EstimateNeighborhoodFunction(_PropertyGraph* pg,
+        const string& harmonic_centrality_property_name, _NeighborhoodFunctionPlan plan)
+
+
+class _NeighborhoodFunctionAlgorithm(Enum):
+    """
+    The concrete algorithms available for estimating the neighborhood function.
+
+    :see: :py:class:`~katana.local.analytics.NeighborhoodFunctionPlan` constructors for algorithm documentation.
+    """
+    HyperAnf = _NeighborhoodFunctionPlan.Algorithm.kHyperAnf
+
+
+cdef class NeighborhoodFunctionPlan(Plan):
+    """
+    A computational :ref:`Plan` for estimating the neighborhood function.
+
+    Static methods construct NeighborhoodFunctionPlans using specific algorithms.
+    """
+    cdef:
+        _NeighborhoodFunctionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _NeighborhoodFunctionAlgorithm
+
+    @staticmethod
+    cdef NeighborhoodFunctionPlan make(_NeighborhoodFunctionPlan u):
+        f = <NeighborhoodFunctionPlan>NeighborhoodFunctionPlan.__new__(NeighborhoodFunctionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _NeighborhoodFunctionAlgorithm:
+        return _NeighborhoodFunctionAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def log2_num_registers(self) -> int:
+        """
+        The log2 of the number of registers of the counter of each node.
+        """
+        return self.underlying_.log2_num_registers()
+
+    @property
+    def max_iterations(self) -> int:
+        """
+        The most distances the neighborhood function is estimated for.
+        """
+        return self.underlying_.max_iterations()
+
+    @staticmethod
+    def hyper_anf(
+        uint32_t log2_num_registers = kDefaultLog2NumRegisters, uint32_t max_iterations = kDefaultMaxIterations
+    ) -> NeighborhoodFunctionPlan:
+        """
+        Keep for each node a HyperLogLog counter of the nodes within distance t of it, for t = 0, 1, ..., until no
+        counter changes (Boldi et al., "HyperANF: Approximating the Neighbourhood Function of Very Large Graphs on a
+        Budget", WWW 2011). The relative standard error of each counter is about 1.04 / sqrt(2^log2_num_registers).
+        """
+        return NeighborhoodFunctionPlan.make(_NeighborhoodFunctionPlan.HyperAnf(log2_num_registers, max_iterations))
+
+
+cdef _NeighborhoodFunctionEstimate handle_result_NeighborhoodFunctionEstimate(
+        Result[_NeighborhoodFunctionEstimate] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class NeighborhoodFunctionEstimate(Statistics):
+    """
+    Estimate the neighborhood function of `pg`, the number of pairs of nodes (u, v) such that v is within distance t
+    of u, for each t, and, if `harmonic_centrality_property_name` is not empty, the harmonic centrality of each node
+    (see :py:func:`~katana.local.analytics.harmonic_centrality`).
+    """
+    cdef _NeighborhoodFunctionEstimate underlying
+
+    def __init__(
+        self,
+        Graph pg,
+        str harmonic_centrality_property_name = "",
+        NeighborhoodFunctionPlan plan = NeighborhoodFunctionPlan(),
+    ):
+        """
+        :param pg: The graph to analyze.
+        :param harmonic_centrality_property_name: The output node property holding the estimated harmonic
+            centralities as double, or empty for none. This property must not already exist.
+        :param plan: The execution plan to use.
+        """
+        cdef string property_name_str = bytes(harmonic_centrality_property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_NeighborhoodFunctionEstimate(EstimateNeighborhoodFunction(
+                pg.underlying_property_graph(), property_name_str, plan.underlying_))
+
+    @property
+    def neighborhood_function(self) -> list:
+        """
+        The estimated number of pairs within distance t for each t, from t = 0 (the number of nodes) to the distance
+        at which the estimates stop growing.
+        """
+        return list(self.underlying.neighborhood_function)
+
+    def effective_diameter(self, double fraction = 0.9) -> float:
+        """
+        The distance within which `fraction` of the pairs of connected nodes are, interpolated linearly between
+        distances.
+        """
+        return self.underlying.EffectiveDiameter(fraction)
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
+
+
+def estimate_neighborhood_function(
+    Graph pg, str harmonic_centrality_property_name = "", NeighborhoodFunctionPlan plan = NeighborhoodFunctionPlan()
+) -> NeighborhoodFunctionEstimate:
+    """
+    Estimate the neighborhood function of `pg` and, optionally, the harmonic centrality of each node, in one pass
+    over the edges per distance.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type harmonic_centrality_property_name: str
+    :param harmonic_centrality_property_name: The output node property holding the estimated harmonic centralities
+        as double, or empty for none. This property must not already exist.
+    :type plan: NeighborhoodFunctionPlan
+    :param plan: The execution plan to use.
+    :rtype: NeighborhoodFunctionEstimate
+    """
+    return NeighborhoodFunctionEstimate(pg, harmonic_centrality_property_name, plan)
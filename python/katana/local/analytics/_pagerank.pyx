@@ -17,19 +17,26 @@ Page Rank
 
 .. autofunction:: katana.local.analytics.pagerank
 
+.. autofunction:: katana.local.analytics.personalized_pagerank
+
+.. autofunction:: katana.local.analytics.personalized_pagerank_batch
+
 .. autoclass:: katana.local.analytics.PagerankStatistics
     :members:
     :undoc-members:
 
 .. autofunction:: katana.local.analytics.pagerank_assert_valid
 """
+from libc.stdint cimport uint32_t
 from libcpp.string cimport string
+from libcpp.utility cimport pair
+from libcpp.vector cimport vector
 
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
-from katana.local.analytics.plan cimport Plan, _Plan
+from katana.local.analytics.plan cimport Plan, ResultCache, _AnalyticsResultCache, _Plan, result_cache_pointer
 
 from enum import Enum
 
@@ -41,6 +48,7 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
             kPullResidual "katana::analytics::PagerankPlan::kPullResidual"
             kPushSynchronous "katana::analytics::PagerankPlan::kPushSynchronous"
             kPushAsynchronous "katana::analytics::PagerankPlan::kPushAsynchronous"
+            kPullBlocked "katana::analytics::PagerankPlan::kPullBlocked"
 
         # unsigned int kChunkSize
 
@@ -57,6 +65,8 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         @staticmethod
         _PagerankPlan PullResidual(float tolerance, unsigned int max_iterations, float alpha)
         @staticmethod
+        _PagerankPlan PullBlocked(float tolerance, unsigned int max_iterations, float alpha)
+        @staticmethod
         _PagerankPlan PushAsynchronous(float tolerance, float alpha)
         @staticmethod
         _PagerankPlan PushSynchronous(float tolerance, unsigned int max_iterations, float alpha)
@@ -65,7 +75,14 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
     int kDefaultMaxIterations "katana::analytics::PagerankPlan::kDefaultMaxIterations"
     double kDefaultAlpha "katana::analytics::PagerankPlan::kDefaultAlpha"
 
-    Result[void] Pagerank(_PropertyGraph* pg, string output_property_name, _PagerankPlan plan)
+    Result[void] Pagerank(_PropertyGraph* pg, string output_property_name, _PagerankPlan plan,
+                          _AnalyticsResultCache* cache)
+
+    Result[vector[pair[uint32_t, double]]] PersonalizedPagerank(const _PropertyGraph* pg,
+        const vector[uint32_t]& seeds, size_t k, _PagerankPlan plan)
+
+    Result[vector[vector[pair[uint32_t, double]]]] PersonalizedPagerankBatch(const _PropertyGraph* pg,
+        const vector[vector[uint32_t]]& seed_sets, size_t k, _PagerankPlan plan)
 
     Result[void] PagerankAssertValid(_PropertyGraph* pg, string output_property_name)
 
@@ -85,6 +102,7 @@ class _PagerankPlanAlgorithm(Enum):
     PullResidual = _PagerankPlan.Algorithm.kPullResidual
     PushSynchronous = _PagerankPlan.Algorithm.kPushSynchronous
     PushAsynchronous = _PagerankPlan.Algorithm.kPushAsynchronous
+    PullBlocked = _PagerankPlan.Algorithm.kPullBlocked
 
 
 cdef class PagerankPlan(Plan):
@@ -145,6 +163,15 @@ cdef class PagerankPlan(Plan):
         """
         return PagerankPlan.make(_PagerankPlan.PullResidual(tolerance, max_iterations, alpha))
 
+    @staticmethod
+    def pull_blocked(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha):
+        """
+        Topological pull algorithm with propagation blocking, for graphs much larger than the last level cache
+
+        The graph must be transposed to use this algorithm.
+        """
+        return PagerankPlan.make(_PagerankPlan.PullBlocked(tolerance, max_iterations, alpha))
+
     @staticmethod
     def push_asynchronous(float tolerance = kDefaultTolerance, float alpha = kDefaultAlpha):
         """
@@ -167,7 +194,7 @@ cdef class PagerankPlan(Plan):
         return PagerankPlan.make(_PagerankPlan.PushSynchronous(tolerance, max_iterations, alpha))
 
 
-def pagerank(Graph pg, str output_property_name, PagerankPlan plan = PagerankPlan()):
+def pagerank(Graph pg, str output_property_name, PagerankPlan plan = PagerankPlan(), ResultCache cache = None):
     """
     Compute the Page Rank of each node in the graph.
 
@@ -177,11 +204,71 @@ def pagerank(Graph pg, str output_property_name, PagerankPlan plan = PagerankPla
     :param output_property_name: The output property to store the rank. This property must not already exist.
     :type plan: PagerankPlan
     :param plan: The execution plan to use.
+    :type cache: ResultCache
+    :param cache: The cache of the ranks of committed graphs to take the ranks from, or to add them to.
     """
     output_property_name_bytes = bytes(output_property_name, "utf-8")
     output_property_name_cstr = <string>output_property_name_bytes
+    cdef _AnalyticsResultCache* cache_ptr = result_cache_pointer(cache)
+    with nogil:
+        handle_result_void(Pagerank(pg.underlying_property_graph(), output_property_name_cstr, plan.underlying_,
+                                    cache_ptr))
+
+
+cdef vector[pair[uint32_t, double]] handle_result_ranks(Result[vector[pair[uint32_t, double]]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef vector[vector[pair[uint32_t, double]]] handle_result_ranks_batch(
+        Result[vector[vector[pair[uint32_t, double]]]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def personalized_pagerank(Graph pg, seeds, size_t k, PagerankPlan plan = PagerankPlan()):
+    """
+    Compute the `k` nodes with the highest Page Rank personalized for `seeds`: the probability that a random walk that
+    starts at a seed, and returns to a seed with probability 1 - alpha at each step, is at a node. The ranks are
+    approximated by forward push, which touches only the nodes near the seeds; the rank of a node is underestimated by
+    at most the tolerance of `plan` times its out degree.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type seeds: Iterable of node IDs
+    :param seeds: The nodes the walks start from.
+    :type k: int
+    :param k: The number of nodes to return.
+    :type plan: PagerankPlan
+    :param plan: The tolerance and alpha of this plan are used; its algorithm is not.
+    :rtype: list of (int, float)
+    :returns: (node, rank) pairs by decreasing rank.
+    """
+    cdef vector[uint32_t] seeds_vec = seeds
+    cdef vector[pair[uint32_t, double]] ranks
+    with nogil:
+        ranks = handle_result_ranks(PersonalizedPagerank(pg.underlying_property_graph(), seeds_vec, k,
+                                                         plan.underlying_))
+    return [(node, rank) for node, rank in ranks]
+
+
+def personalized_pagerank_batch(Graph pg, seed_sets, size_t k, PagerankPlan plan = PagerankPlan()):
+    """
+    Compute `personalized_pagerank` for each of `seed_sets`, in parallel.
+
+    :rtype: list of list of (int, float)
+    :returns: The result for each seed set.
+    """
+    cdef vector[vector[uint32_t]] seed_sets_vec = [list(seeds) for seeds in seed_sets]
+    cdef vector[vector[pair[uint32_t, double]]] results
     with nogil:
-        handle_result_void(Pagerank(pg.underlying_property_graph(), output_property_name_cstr, plan.underlying_))
+        results = handle_result_ranks_batch(PersonalizedPagerankBatch(pg.underlying_property_graph(), seed_sets_vec,
+                                                                      k, plan.underlying_))
+    return [[(node, rank) for node, rank in ranks] for ranks in results]
 
 
 def pagerank_assert_valid(Graph pg, str output_property_name):
@@ -0,0 +1,350 @@
+"""
+Partition
+---------
+
+.. autoclass:: katana.local.analytics.PartitionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._partition._PartitionAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.partition
+
+.. autoclass:: katana.local.analytics.PartitionStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.partition_assert_valid
+
+.. autofunction:: katana.local.analytics.partition_hypergraph
+
+.. autoclass:: katana.local.analytics.HypergraphPartitionStatistics
+    :members:
+    :undoc-members:
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/partition/partition.h" namespace "katana::analytics" nogil:
+    cppclass _PartitionPlan "katana::analytics::PartitionPlan" (_Plan):
+        enum Algorithm:
+            kMultilevel "katana::analytics::PartitionPlan::kMultilevel"
+
+        _PartitionPlan.Algorithm algorithm() const
+        uint32_t coarsest_nodes_per_partition() const
+        double max_imbalance() const
+        uint32_t refinement_rounds() const
+
+        _PartitionPlan()
+
+        @staticmethod
+        _PartitionPlan Multilevel(uint32_t coarsest_nodes_per_partition, double max_imbalance,
+            uint32_t refinement_rounds)
+
+    uint32_t kDefaultCoarsestNodesPerPartition "katana::analytics::PartitionPlan::kDefaultCoarsestNodesPerPartition"
+    double kDefaultMaxImbalance "katana::analytics::PartitionPlan::kDefaultMaxImbalance"
+    uint32_t kDefaultRefinementRounds "katana::analytics::PartitionPlan::kDefaultRefinementRounds"
+
+    Result[void] Partition(_PropertyGraph* pg, uint32_t num_partitions, const string& output_property_name,
+        _PartitionPlan plan)
+
+    Result[void] PartitionHypergraph(_PropertyGraph* pg, uint64_t num_hyperedges, uint32_t num_partitions,
+        const string& output_property_name, _PartitionPlan plan)
+
+    Result[void] PartitionAssertValid(_PropertyGraph* pg, uint32_t num_partitions, const string& property_name)
+
+    cppclass _PartitionStatistics "katana::analytics::PartitionStatistics":
+        uint64_t edge_cut
+        uint64_t max_partition_size
+        uint64_t min_partition_size
+        double imbalance
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_PartitionStatistics] Compute(_PropertyGraph* pg, uint32_t num_partitions,
+            const string& property_name)
+
+    cppclass _HypergraphPartitionStatistics "katana::analytics::HypergraphPartitionStatistics":
+        uint64_t cut_hyperedges
+        uint64_t connectivity
+        uint64_t max_partition_size
+        uint64_t min_partition_size
+        double imbalance
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_HypergraphPartitionStatistics] Compute(_PropertyGraph* pg, uint64_t num_hyperedges,
+            uint32_t num_partitions, const string& property_name)
+
+
+class _PartitionAlgorithm(Enum):
+    """
+    The concrete algorithms available for partitioning.
+
+    :see: :py:class:`~katana.local.analytics.PartitionPlan` constructors for algorithm documentation.
+    """
+    Multilevel = _PartitionPlan.Algorithm.kMultilevel
+
+
+cdef class PartitionPlan(Plan):
+    """
+    A computational :ref:`Plan` for partitioning.
+
+    Static methods construct PartitionPlans using specific algorithms with their required parameters. All parameters
+    are optional and have reasonable defaults.
+    """
+    cdef:
+        _PartitionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _PartitionAlgorithm
+
+    @staticmethod
+    cdef PartitionPlan make(_PartitionPlan u):
+        f = <PartitionPlan>PartitionPlan.__new__(PartitionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _PartitionAlgorithm:
+        return _PartitionAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def coarsest_nodes_per_partition(self) -> int:
+        """
+        The number of nodes per partition at which coarsening stops.
+        """
+        return self.underlying_.coarsest_nodes_per_partition()
+
+    @property
+    def max_imbalance(self) -> float:
+        """
+        How much larger than the average a partition may grow, as a fraction of the average.
+        """
+        return self.underlying_.max_imbalance()
+
+    @property
+    def refinement_rounds(self) -> int:
+        """
+        The most rounds of label propagation at each level.
+        """
+        return self.underlying_.refinement_rounds()
+
+    @staticmethod
+    def multilevel(
+        uint32_t coarsest_nodes_per_partition = kDefaultCoarsestNodesPerPartition,
+        double max_imbalance = kDefaultMaxImbalance,
+        uint32_t refinement_rounds = kDefaultRefinementRounds,
+    ) -> PartitionPlan:
+        """
+        Multilevel k-way partitioning, as in METIS. The graph, taken as undirected, is coarsened by parallel heavy edge
+        matching, the coarsest graph is partitioned by greedy graph growing, and the partition is projected back level
+        by level, improving it at each level with rounds of parallel label propagation that keep every partition within
+        (1 + `max_imbalance`) times the average size.
+        """
+        return PartitionPlan.make(
+            _PartitionPlan.Multilevel(coarsest_nodes_per_partition, max_imbalance, refinement_rounds)
+        )
+
+
+def partition(Graph pg, uint32_t num_partitions, str output_property_name, PartitionPlan plan = PartitionPlan()):
+    """
+    Partition the nodes of `pg` into `num_partitions` parts of about the same size with few edges between them.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to partition.
+    :type num_partitions: int
+    :param num_partitions: The number of partitions.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the partition of each node. This property must not
+        already exist.
+    :type plan: PartitionPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(Partition(pg.underlying_property_graph(), num_partitions, output_property_name_str,
+                                     plan.underlying_))
+
+
+def partition_hypergraph(
+    Graph pg,
+    uint64_t num_hyperedges,
+    uint32_t num_partitions,
+    str output_property_name,
+    PartitionPlan plan = PartitionPlan(),
+):
+    """
+    Partition the nodes of a hypergraph stored in `pg` into `num_partitions` parts of about the same size with few
+    hyperedges spanning several parts. The first `num_hyperedges` nodes of `pg` are the hyperedges, with an edge to
+    each of their pins among the other nodes. All parts come out of one multilevel hierarchy, refined to reduce the
+    connectivity: the sum over hyperedges of the number of parts they have pins in, less 1.
+
+    :type pg: katana.local.Graph
+    :param pg: The hypergraph to partition.
+    :type num_hyperedges: int
+    :param num_hyperedges: The number of nodes of `pg`, from the first, that are hyperedges.
+    :type num_partitions: int
+    :param num_partitions: The number of partitions.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the partition of each node; a hyperedge gets the
+        partition of most of its pins. This property must not already exist.
+    :type plan: PartitionPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(PartitionHypergraph(pg.underlying_property_graph(), num_hyperedges, num_partitions,
+                                               output_property_name_str, plan.underlying_))
+
+
+def partition_assert_valid(Graph pg, uint32_t num_partitions, str property_name):
+    """
+    Raise an exception if `property_name` puts some node outside of the `num_partitions` partitions.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = bytes(property_name, "utf-8")
+    with nogil:
+        handle_result_assert(PartitionAssertValid(pg.underlying_property_graph(), num_partitions, property_name_str))
+
+
+cdef _PartitionStatistics handle_result_PartitionStatistics(Result[_PartitionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class PartitionStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of a partition.
+    """
+    cdef _PartitionStatistics underlying
+
+    def __init__(self, Graph pg, uint32_t num_partitions, str property_name):
+        """
+        :param pg: The graph on which `partition` was called.
+        :param num_partitions: The number of partitions passed to `partition`.
+        :param property_name: The output property name passed to `partition`.
+        """
+        cdef string property_name_str = bytes(property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_PartitionStatistics(_PartitionStatistics.Compute(
+                pg.underlying_property_graph(), num_partitions, property_name_str))
+
+    @property
+    def edge_cut(self) -> int:
+        """
+        The number of edges between nodes of different partitions.
+        """
+        return self.underlying.edge_cut
+
+    @property
+    def max_partition_size(self) -> int:
+        """
+        The number of nodes in the largest partition.
+        """
+        return self.underlying.max_partition_size
+
+    @property
+    def min_partition_size(self) -> int:
+        """
+        The number of nodes in the smallest partition.
+        """
+        return self.underlying.min_partition_size
+
+    @property
+    def imbalance(self) -> float:
+        """
+        The size of the largest partition over the average partition size, less 1.
+        """
+        return self.underlying.imbalance
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
+
+
+cdef _HypergraphPartitionStatistics handle_result_HypergraphPartitionStatistics(
+        Result[_HypergraphPartitionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class HypergraphPartitionStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of a partition of a hypergraph.
+    """
+    cdef _HypergraphPartitionStatistics underlying
+
+    def __init__(self, Graph pg, uint64_t num_hyperedges, uint32_t num_partitions, str property_name):
+        """
+        :param pg: The hypergraph on which `partition_hypergraph` was called.
+        :param num_hyperedges: The number of hyperedges passed to `partition_hypergraph`.
+        :param num_partitions: The number of partitions passed to `partition_hypergraph`.
+        :param property_name: The output property name passed to `partition_hypergraph`.
+        """
+        cdef string property_name_str = bytes(property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_HypergraphPartitionStatistics(_HypergraphPartitionStatistics.Compute(
+                pg.underlying_property_graph(), num_hyperedges, num_partitions, property_name_str))
+
+    @property
+    def cut_hyperedges(self) -> int:
+        """
+        The number of hyperedges with pins in more than one partition.
+        """
+        return self.underlying.cut_hyperedges
+
+    @property
+    def connectivity(self) -> int:
+        """
+        The sum over hyperedges of the number of partitions they have pins in, less 1.
+        """
+        return self.underlying.connectivity
+
+    @property
+    def max_partition_size(self) -> int:
+        """
+        The number of nodes, not counting hyperedges, in the largest partition.
+        """
+        return self.underlying.max_partition_size
+
+    @property
+    def min_partition_size(self) -> int:
+        """
+        The number of nodes, not counting hyperedges, in the smallest partition.
+        """
+        return self.underlying.min_partition_size
+
+    @property
+    def imbalance(self) -> float:
+        """
+        The size of the largest partition over the average partition size, less 1.
+        """
+        return self.underlying.imbalance
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
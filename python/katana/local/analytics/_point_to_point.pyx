@@ -0,0 +1,95 @@
+"""
+Point-to-Point Distances
+------------------------
+
+.. autoclass:: katana.local.analytics.PointToPointQuery
+    :members:
+    :special-members: __init__
+"""
+import numpy as np
+
+from libc.stdint cimport uint32_t
+from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
+from libcpp.utility cimport pair
+from libcpp.vector cimport vector
+from pyarrow.lib cimport to_shared
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+
+
+cdef extern from "katana/analytics/point_to_point/point_to_point.h" namespace "katana::analytics" nogil:
+    cppclass _PointToPointQuery "katana::analytics::PointToPointQuery":
+        @staticmethod
+        Result[unique_ptr[_PointToPointQuery]] Make(_PropertyGraph* pg, const string& edge_weight_property_name)
+
+        Result[double] Distance(uint32_t source, uint32_t target) const
+        Result[void] Distances(const vector[pair[uint32_t, uint32_t]]& queries, vector[double]* distances) const
+
+    double kUnreachable "katana::analytics::PointToPointQuery::kUnreachable"
+
+
+cdef shared_ptr[_PointToPointQuery] handle_result_point_to_point_query(
+        Result[unique_ptr[_PointToPointQuery]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return to_shared(res.value())
+
+
+cdef double handle_result_double(Result[double] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class PointToPointQuery:
+    """
+    Distances between pairs of nodes of `pg`, each found by searching from both ends until the searches meet rather
+    than from the source to every node. If `edge_weight_property_name` is empty the distance is the number of edges on
+    a shortest path; otherwise it is the sum of the (non-negative) weights of that edge property along one.
+    """
+    UNREACHABLE = kUnreachable
+
+    cdef shared_ptr[_PointToPointQuery] underlying
+    cdef Graph pg
+
+    def __init__(self, Graph pg, str edge_weight_property_name = ""):
+        """
+        :param pg: The graph, whose topology and weights must not change while this is in use.
+        :param edge_weight_property_name: An integer or floating point edge property, or "" to count edges.
+        """
+        cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+        self.pg = pg
+        with nogil:
+            self.underlying = handle_result_point_to_point_query(
+                _PointToPointQuery.Make(pg.underlying_property_graph(), edge_weight_property_name_str))
+
+    def distance(self, uint32_t source, uint32_t target) -> float:
+        """
+        :return: The distance from `source` to `target`, or `UNREACHABLE`.
+        """
+        cdef double distance
+        with nogil:
+            distance = handle_result_double(self.underlying.get().Distance(source, target))
+        return distance
+
+    def distances(self, queries):
+        """
+        Answer many queries in parallel.
+
+        :param queries: An iterable of (source, target) pairs.
+        :return: The distance of each query, or `UNREACHABLE`, as a numpy array.
+        """
+        cdef vector[pair[uint32_t, uint32_t]] queries_vec
+        for source, target in queries:
+            queries_vec.push_back(pair[uint32_t, uint32_t](source, target))
+        cdef vector[double] distances
+        with nogil:
+            handle_result_void(self.underlying.get().Distances(queries_vec, &distances))
+        if distances.empty():
+            return np.empty(0, dtype=np.float64)
+        return np.array(<double[:distances.size()]>(<double*>distances.data()))
@@ -0,0 +1,211 @@
+"""
+Random Walks
+------------
+
+.. autoclass:: katana.local.analytics.RandomWalksPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._random_walks._RandomWalksPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.random_walks
+
+.. autofunction:: katana.local.analytics.random_walks_in_batches
+"""
+from enum import Enum
+
+import numpy as np
+
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.vector cimport vector
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+
+cdef extern from "katana/analytics/random_walks/random_walks.h" namespace "katana::analytics" nogil:
+    cppclass _RandomWalksPlan "katana::analytics::RandomWalksPlan" (_Plan):
+        enum Algorithm:
+            kNode2Vec "katana::analytics::RandomWalksPlan::kNode2Vec"
+            kEdge2Vec "katana::analytics::RandomWalksPlan::kEdge2Vec"
+
+        _RandomWalksPlan.Algorithm algorithm() const
+        uint32_t walk_length() const
+        uint32_t number_of_walks() const
+        double backward_probability() const
+        double forward_probability() const
+
+        _RandomWalksPlan()
+
+        @staticmethod
+        _RandomWalksPlan Node2Vec(uint32_t walk_length, uint32_t number_of_walks, double backward_probability,
+                                  double forward_probability)
+
+    uint32_t kDefaultWalkLength "katana::analytics::RandomWalksPlan::kDefaultWalkLength"
+    uint32_t kDefaultNumberOfWalks "katana::analytics::RandomWalksPlan::kDefaultNumberOfWalks"
+    double kDefaultBackwardProbability "katana::analytics::RandomWalksPlan::kDefaultBackwardProbability"
+    double kDefaultForwardProbability "katana::analytics::RandomWalksPlan::kDefaultForwardProbability"
+    uint64_t kDefaultRandomWalksBatchSize "katana::analytics::kDefaultRandomWalksBatchSize"
+
+    cppclass _RandomWalksBatch "katana::analytics::RandomWalksBatch":
+        vector[uint32_t] nodes
+        vector[uint64_t] offsets
+
+        uint64_t num_walks() const
+
+    Result[vector[vector[uint32_t]]] RandomWalks(_PropertyGraph* pg, _RandomWalksPlan plan)
+
+
+cdef extern from * nogil:
+    """
+    // Adapt a C callback with a context pointer to a RandomWalksCallback; the
+    // callback returns 0 to stop the walks.
+    katana::Result<void> RandomWalksInBatchesWithContext(
+        katana::PropertyGraph* pg, void* context,
+        int (*callback)(void*, const katana::analytics::RandomWalksBatch&),
+        katana::analytics::RandomWalksPlan plan, uint64_t batch_size) {
+      return katana::analytics::RandomWalksInBatches(
+          pg,
+          [=](const katana::analytics::RandomWalksBatch& batch)
+              -> katana::Result<void> {
+            if (!callback(context, batch)) {
+              return KATANA_ERROR(
+                  katana::ErrorCode::Cancelled, "random walks callback failed");
+            }
+            return katana::ResultSuccess();
+          },
+          plan, batch_size);
+    }
+    """
+    Result[void] RandomWalksInBatchesWithContext(_PropertyGraph* pg, void* context,
+                                                 int (*callback)(void*, const _RandomWalksBatch&),
+                                                 _RandomWalksPlan plan, uint64_t batch_size)
+
+
+class _RandomWalksPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.RandomWalksPlan` constructors for algorithm documentation.
+    """
+    Node2Vec = _RandomWalksPlan.Algorithm.kNode2Vec
+    Edge2Vec = _RandomWalksPlan.Algorithm.kEdge2Vec
+
+
+cdef class RandomWalksPlan(Plan):
+    """
+    A computational :ref:`Plan` for random walks.
+
+    Static methods construct RandomWalksPlans.
+    """
+    cdef:
+        _RandomWalksPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _RandomWalksPlanAlgorithm
+
+    @staticmethod
+    cdef RandomWalksPlan make(_RandomWalksPlan u):
+        f = <RandomWalksPlan>RandomWalksPlan.__new__(RandomWalksPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _RandomWalksPlanAlgorithm:
+        return _RandomWalksPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def walk_length(self) -> int:
+        return self.underlying_.walk_length()
+
+    @property
+    def number_of_walks(self) -> int:
+        return self.underlying_.number_of_walks()
+
+    @property
+    def backward_probability(self) -> float:
+        return self.underlying_.backward_probability()
+
+    @property
+    def forward_probability(self) -> float:
+        return self.underlying_.forward_probability()
+
+    @staticmethod
+    def node2vec(uint32_t walk_length = kDefaultWalkLength, uint32_t number_of_walks = kDefaultNumberOfWalks,
+                 double backward_probability = kDefaultBackwardProbability,
+                 double forward_probability = kDefaultForwardProbability) -> RandomWalksPlan:
+        """
+        Second order walks biased by the return parameter `backward_probability` and the in-out parameter
+        `forward_probability` of node2vec. Unless both are 1, the next step of a walk is sampled from an alias table
+        of the edge it arrived over where those fit in memory.
+
+        :param walk_length: The maximum number of nodes on a walk; a walk stops early at a node without edges.
+        :param number_of_walks: The number of walks started from each node.
+        """
+        return RandomWalksPlan.make(
+            _RandomWalksPlan.Node2Vec(walk_length, number_of_walks, backward_probability, forward_probability))
+
+
+cdef vector[vector[uint32_t]] handle_result_walks(Result[vector[vector[uint32_t]]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def random_walks(Graph pg, RandomWalksPlan plan = RandomWalksPlan()):
+    """
+    Generate `plan.number_of_walks` random walks along the out-edges of `pg` from every node.
+
+    :return: A list of walks, each a list of nodes. Walk i starts at node i % pg.num_nodes().
+    """
+    cdef vector[vector[uint32_t]] walks
+    with nogil:
+        walks = handle_result_walks(RandomWalks(pg.underlying_property_graph(), plan.underlying_))
+    return [list(walk) for walk in walks]
+
+
+cdef class _BatchCallbackContext:
+    cdef object callback
+    cdef object error
+
+
+cdef int _call_batch_callback(void* context, const _RandomWalksBatch& batch) with gil:
+    cdef _BatchCallbackContext ctx = <_BatchCallbackContext>context
+    try:
+        if batch.nodes.empty():
+            nodes = np.empty(0, dtype=np.uint32)
+        else:
+            nodes = np.array(<uint32_t[:batch.nodes.size()]>(<uint32_t*>batch.nodes.data()))
+        offsets = np.array(<uint64_t[:batch.offsets.size()]>(<uint64_t*>batch.offsets.data()))
+        ctx.callback(nodes, offsets)
+    except BaseException as e:
+        ctx.error = e
+        return 0
+    return 1
+
+
+def random_walks_in_batches(Graph pg, callback, RandomWalksPlan plan = RandomWalksPlan(),
+                            uint64_t batch_size = kDefaultRandomWalksBatchSize):
+    """
+    Generate the walks of :py:func:`~katana.local.analytics.random_walks` at most `batch_size` at a time, so that
+    memory does not grow with the number of walks.
+
+    :param callback: Called in order with `(nodes, offsets)` numpy arrays for each batch; the nodes of walk i of the
+        batch are nodes[offsets[i]:offsets[i + 1]]. An exception raised by it stops the walks and is re-raised.
+    """
+    cdef _BatchCallbackContext ctx = _BatchCallbackContext()
+    ctx.callback = callback
+    try:
+        with nogil:
+            handle_result_void(RandomWalksInBatchesWithContext(pg.underlying_property_graph(), <void*>ctx,
+                                                               &_call_batch_callback, plan.underlying_, batch_size))
+    except Exception:
+        if ctx.error is not None:
+            raise ctx.error
+        raise
@@ -13,6 +13,10 @@ Single-Source Shortest Path
 
 .. autofunction:: katana.local.analytics.sssp
 
+.. autofunction:: katana.local.analytics.sssp_batch
+
+.. autofunction:: katana.local.analytics.sssp_repair
+
 .. autoclass:: katana.local.analytics.SsspStatistics
     :members:
     :undoc-members:
@@ -22,14 +26,27 @@ Single-Source Shortest Path
 from enum import Enum
 
 from libc.stddef cimport ptrdiff_t
-from libc.stdint cimport uint64_t
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.memory cimport shared_ptr
 from libcpp.string cimport string
+from libcpp.utility cimport pair
+from libcpp.vector cimport vector
+from pyarrow.lib cimport CTable, pyarrow_wrap_table
 
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
-from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+from katana.local.analytics.plan cimport (
+    Plan,
+    Statistics,
+    Workspace,
+    _AnalyticsWorkspace,
+    _CancellationToken,
+    _Plan,
+    handle_result_table,
+    workspace_pointer,
+)
 
 
 cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" nogil:
@@ -39,6 +56,8 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
             kDeltaStep "katana::analytics::SsspPlan::kDeltaStep"
             kDeltaStepBarrier "katana::analytics::SsspPlan::kDeltaStepBarrier"
             kDeltaStepFusion "katana::analytics::SsspPlan::kDeltaStepFusion"
+            kDeltaStepAdaptive "katana::analytics::SsspPlan::kDeltaStepAdaptive"
+            kDeltaStepAutoDelta "katana::analytics::SsspPlan::kDeltaStepAutoDelta"
             kSerialDeltaTile "katana::analytics::SsspPlan::kSerialDeltaTile"
             kSerialDelta "katana::analytics::SsspPlan::kSerialDelta"
             kDijkstraTile "katana::analytics::SsspPlan::kDijkstraTile"
@@ -63,6 +82,10 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
         @staticmethod
         _SsspPlan DeltaStepFusion(unsigned delta)
         @staticmethod
+        _SsspPlan DeltaStepAdaptive(unsigned initial_delta)
+        @staticmethod
+        _SsspPlan DeltaStepAutoDelta()
+        @staticmethod
         _SsspPlan SerialDeltaTile(unsigned delta, ptrdiff_t edge_tile_size)
         @staticmethod
         _SsspPlan SerialDelta(unsigned delta)
@@ -81,6 +104,13 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
     Result[void] Sssp(_PropertyGraph* pg, size_t start_node,
         const string& edge_weight_property_name, const string& output_property_name, _SsspPlan plan)
 
+    Result[shared_ptr[CTable]] SsspBatch(_PropertyGraph* pg, const vector[uint32_t]& sources,
+        const string& edge_weight_property_name, _SsspPlan plan, const _CancellationToken* cancellation,
+        _AnalyticsWorkspace* workspace)
+
+    Result[void] SsspRepair(_PropertyGraph* pg, const string& edge_weight_property_name,
+        const string& distance_property_name, const vector[pair[uint32_t, uint32_t]]& changed_edges, _SsspPlan plan)
+
     Result[void] SsspAssertValid(_PropertyGraph* pg, size_t start_node,
                                  const string& edge_weight_property_name, const string& output_property_name);
 
@@ -105,6 +135,8 @@ class _SsspAlgorithm(Enum):
     DeltaStep = _SsspPlan.Algorithm.kDeltaStep
     DeltaStepBarrier = _SsspPlan.Algorithm.kDeltaStepBarrier
     DeltaStepFusion = _SsspPlan.Algorithm.kDeltaStepFusion
+    DeltaStepAdaptive = _SsspPlan.Algorithm.kDeltaStepAdaptive
+    DeltaStepAutoDelta = _SsspPlan.Algorithm.kDeltaStepAutoDelta
     SerialDeltaTile = _SsspPlan.Algorithm.kSerialDeltaTile
     SerialDelta = _SsspPlan.Algorithm.kSerialDelta
     DijkstraTile = _SsspPlan.Algorithm.kDijkstraTile
@@ -200,6 +232,21 @@ cdef class SsspPlan(Plan):
         """
         return SsspPlan.make(_SsspPlan.DeltaStepFusion(delta))
 
+    @staticmethod
+    def delta_step_adaptive(unsigned initial_delta = kDefaultDelta) -> SsspPlan:
+        """
+        Delta stepping with a delta adapted to the work found in each bucket
+        """
+        return SsspPlan.make(_SsspPlan.DeltaStepAdaptive(initial_delta))
+
+    @staticmethod
+    def delta_step_auto_delta() -> SsspPlan:
+        """
+        Delta stepping with a delta adapted to the work found in each bucket, starting from a delta chosen from the
+        edge weights
+        """
+        return SsspPlan.make(_SsspPlan.DeltaStepAutoDelta())
+
     @staticmethod
     def serial_delta_tile(unsigned delta = kDefaultDelta, ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) -> SsspPlan:
         """
@@ -266,6 +313,65 @@ def sssp(Graph pg, size_t start_node, str edge_weight_property_name, str output_
         handle_result_void(Sssp(pg.underlying_property_graph(), start_node, edge_weight_property_name_str,
                                 output_property_name_str, plan.underlying_))
 
+def sssp_batch(Graph pg, sources, str edge_weight_property_name, SsspPlan plan = SsspPlan(),
+               Workspace workspace = None):
+    """
+    Compute the Single-Source Shortest Path lengths on `pg` from each of `sources` in one call, without adding
+    properties to `pg`. This is much faster than calling `sssp` for each source when there are many sources, especially
+    on small graphs.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type sources: Iterable of node IDs
+    :param sources: The source nodes.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The input property containing edge weights.
+    :type plan: SsspPlan
+    :param plan: The execution plan to use. Defaults to heuristically selecting the plan.
+    :type workspace: Workspace
+    :param workspace: The workspace the computations take their temporary arrays from. Passing the same workspace to
+        many calls avoids allocating the arrays on each call.
+    :rtype: pyarrow.Table
+    :returns: A table with a column of path lengths for each source, named by the source, with the type of the edge
+        weights.
+    """
+    cdef vector[uint32_t] sources_vec = sources
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef _AnalyticsWorkspace* workspace_ptr = workspace_pointer(workspace)
+    cdef shared_ptr[CTable] table
+    with nogil:
+        table = handle_result_table(
+            SsspBatch(pg.underlying_property_graph(), sources_vec, edge_weight_property_name_str, plan.underlying_,
+                      NULL, workspace_ptr))
+    return pyarrow_wrap_table(table)
+
+def sssp_repair(Graph pg, str edge_weight_property_name, str distance_property_name, changed_edges,
+                SsspPlan plan = SsspPlan()):
+    """
+    Update the path lengths in the property `distance_property_name`, computed by `sssp`, after edges were added to
+    `pg` or the weights of edges decreased. Only the nodes whose path lengths decrease are visited. Removed edges and
+    weight increases need a new `sssp`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph with the changed edges.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The input property containing the current edge weights.
+    :type distance_property_name: str
+    :param distance_property_name: The property of path lengths to update in place.
+    :type changed_edges: Iterable of (source, destination) node ID pairs
+    :param changed_edges: The end points of the added edges and of the edges whose weights decreased.
+    :type plan: SsspPlan
+    :param plan: The repair runs adaptive delta stepping starting from the delta of this plan.
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string distance_property_name_str = bytes(distance_property_name, "utf-8")
+    cdef vector[pair[uint32_t, uint32_t]] changed_edges_vec
+    for source, destination in changed_edges:
+        changed_edges_vec.push_back(pair[uint32_t, uint32_t](source, destination))
+    with nogil:
+        handle_result_void(SsspRepair(pg.underlying_property_graph(), edge_weight_property_name_str,
+                                      distance_property_name_str, changed_edges_vec, plan.underlying_))
+
 def sssp_assert_valid(Graph pg, size_t start_node, str edge_weight_property_name, str output_property_name):
     """
     Raise an exception if the SSSP results in `pg` with the given parameters appear to be incorrect. This is not an
@@ -0,0 +1,220 @@
+"""
+Strongly Connected Components
+-----------------------------
+
+.. autoclass:: katana.local.analytics.StronglyConnectedComponentsPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._strongly_connected_components._StronglyConnectedComponentsAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.strongly_connected_components
+
+.. autoclass:: katana.local.analytics.StronglyConnectedComponentsStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.strongly_connected_components_assert_valid
+"""
+from enum import Enum
+
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, Statistics, _Plan
+
+
+cdef extern from "katana/analytics/strongly_connected_components/strongly_connected_components.h" namespace "katana::analytics" nogil:
+    cppclass _StronglyConnectedComponentsPlan "katana::analytics::StronglyConnectedComponentsPlan" (_Plan):
+        enum Algorithm:
+            kMultistep "katana::analytics::StronglyConnectedComponentsPlan::kMultistep"
+            kColoring "katana::analytics::StronglyConnectedComponentsPlan::kColoring"
+            kSerial "katana::analytics::StronglyConnectedComponentsPlan::kSerial"
+
+        _StronglyConnectedComponentsPlan.Algorithm algorithm() const
+        uint32_t serial_threshold() const
+
+        _StronglyConnectedComponentsPlan()
+
+        @staticmethod
+        _StronglyConnectedComponentsPlan Multistep(uint32_t serial_threshold)
+
+        @staticmethod
+        _StronglyConnectedComponentsPlan Coloring(uint32_t serial_threshold)
+
+        @staticmethod
+        _StronglyConnectedComponentsPlan Serial()
+
+    uint32_t kDefaultSerialThreshold "katana::analytics::StronglyConnectedComponentsPlan::kDefaultSerialThreshold"
+
+    Result[void] StronglyConnectedComponents(_PropertyGraph* pg, const string& output_property_name,
+        _StronglyConnectedComponentsPlan plan)
+
+    Result[void] StronglyConnectedComponentsAssertValid(_PropertyGraph* pg, const string& property_name)
+
+    cppclass _StronglyConnectedComponentsStatistics "katana::analytics::StronglyConnectedComponentsStatistics":
+        uint64_t total_components
+        uint64_t total_non_trivial_components
+        uint64_t largest_component_size
+        double largest_component_ratio
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_StronglyConnectedComponentsStatistics] Compute(_PropertyGraph* pg, const string& property_name)
+
+
+class _StronglyConnectedComponentsAlgorithm(Enum):
+    """
+    The concrete algorithms available for strongly connected components.
+
+    :see: :py:class:`~katana.local.analytics.StronglyConnectedComponentsPlan` constructors for algorithm documentation.
+    """
+    Multistep = _StronglyConnectedComponentsPlan.Algorithm.kMultistep
+    Coloring = _StronglyConnectedComponentsPlan.Algorithm.kColoring
+    Serial = _StronglyConnectedComponentsPlan.Algorithm.kSerial
+
+
+cdef class StronglyConnectedComponentsPlan(Plan):
+    """
+    A computational :ref:`Plan` for strongly connected components.
+
+    Static methods construct StronglyConnectedComponentsPlans using specific algorithms with their required
+    parameters. All parameters are optional and have reasonable defaults.
+
+    The parallel algorithms first trim the nodes without an in-edge or an out-edge from the other remaining nodes,
+    and finish with Tarjan's algorithm once at most `serial_threshold` nodes are left.
+    """
+    cdef:
+        _StronglyConnectedComponentsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _StronglyConnectedComponentsAlgorithm
+
+    @staticmethod
+    cdef StronglyConnectedComponentsPlan make(_StronglyConnectedComponentsPlan u):
+        f = <StronglyConnectedComponentsPlan>StronglyConnectedComponentsPlan.__new__(StronglyConnectedComponentsPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _StronglyConnectedComponentsAlgorithm:
+        return _StronglyConnectedComponentsAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def serial_threshold(self) -> int:
+        """
+        The number of remaining nodes below which Tarjan's algorithm finishes.
+        """
+        return self.underlying_.serial_threshold()
+
+    @staticmethod
+    def multistep(uint32_t serial_threshold = kDefaultSerialThreshold) -> StronglyConnectedComponentsPlan:
+        """
+        Multistep (Slota, Rajamanickam and Madduri, IPDPS 2014): after trimming, a forward and a backward search from
+        the node with the largest product of in- and out-degree find the giant component, and coloring finds the
+        rest.
+        """
+        return StronglyConnectedComponentsPlan.make(_StronglyConnectedComponentsPlan.Multistep(serial_threshold))
+
+    @staticmethod
+    def coloring(uint32_t serial_threshold = kDefaultSerialThreshold) -> StronglyConnectedComponentsPlan:
+        """
+        Coloring without the forward-backward search: every round, the largest node id that reaches each node is
+        propagated forward, and backward searches from the nodes whose id is their color find the components. Better
+        than multistep on graphs without a giant component.
+        """
+        return StronglyConnectedComponentsPlan.make(_StronglyConnectedComponentsPlan.Coloring(serial_threshold))
+
+    @staticmethod
+    def serial() -> StronglyConnectedComponentsPlan:
+        """
+        Tarjan's algorithm.
+        """
+        return StronglyConnectedComponentsPlan.make(_StronglyConnectedComponentsPlan.Serial())
+
+
+def strongly_connected_components(Graph pg, str output_property_name,
+                                  StronglyConnectedComponentsPlan plan = StronglyConnectedComponentsPlan()):
+    """
+    Compute the strongly connected components of `pg`, the maximal sets of nodes that all reach each other along the
+    edges. The component of a node is the smallest node of its component, so every plan gives the same result.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property holding the component of each node (as uint64). This property
+        must not already exist.
+    :type plan: StronglyConnectedComponentsPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(StronglyConnectedComponents(pg.underlying_property_graph(), output_property_name_str,
+                                                       plan.underlying_))
+
+
+def strongly_connected_components_assert_valid(Graph pg, str property_name):
+    """
+    Raise an exception if `property_name` does not hold the strongly connected components of `pg`, each labeled with
+    its smallest node.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = bytes(property_name, "utf-8")
+    with nogil:
+        handle_result_assert(StronglyConnectedComponentsAssertValid(pg.underlying_property_graph(), property_name_str))
+
+
+cdef _StronglyConnectedComponentsStatistics handle_result_StronglyConnectedComponentsStatistics(
+        Result[_StronglyConnectedComponentsStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class StronglyConnectedComponentsStatistics(Statistics):
+    """
+    Compute the :ref:`statistics` of a strongly connected components computation on a graph.
+    """
+    cdef _StronglyConnectedComponentsStatistics underlying
+
+    def __init__(self, Graph pg, str property_name):
+        cdef string property_name_str = bytes(property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_StronglyConnectedComponentsStatistics(
+                _StronglyConnectedComponentsStatistics.Compute(pg.underlying_property_graph(), property_name_str))
+
+    @property
+    def total_components(self) -> int:
+        return self.underlying.total_components
+
+    @property
+    def total_non_trivial_components(self) -> int:
+        return self.underlying.total_non_trivial_components
+
+    @property
+    def largest_component_size(self) -> int:
+        return self.underlying.largest_component_size
+
+    @property
+    def largest_component_ratio(self) -> float:
+        """
+        The fraction of the entire graph that is part of the largest component.
+        """
+        return self.underlying.largest_component_ratio
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -11,6 +11,7 @@ Subgraph Extraction
 """
 from libc.stdint cimport uint32_t
 from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 from pyarrow.lib cimport to_shared
 
@@ -35,7 +36,8 @@ cdef extern from "katana/analytics/subgraph_extraction/subgraph_extraction.h" na
         _SubGraphExtractionPlan NodeSet(
             )
 
-    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec, _SubGraphExtractionPlan plan)
+    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec,
+        const vector[string]& node_properties, const vector[string]& edge_properties, _SubGraphExtractionPlan plan)
 
 
 class _SubGraphExtractionPlanAlgorithm(Enum):
@@ -81,12 +83,20 @@ cdef shared_ptr[_PropertyGraph] handle_result_property_graph(Result[unique_ptr[_
     return to_shared(res.value())
 
 
-def subgraph_extraction(Graph pg, node_vec, SubGraphExtractionPlan plan = SubGraphExtractionPlan()) -> Graph:
+def subgraph_extraction(Graph pg, node_vec, SubGraphExtractionPlan plan = SubGraphExtractionPlan(),
+                        node_properties=(), edge_properties=()) -> Graph:
     """
     Given a set of node ids, this algorithm constructs a new sub-graph which contains all nodes in the set and edges
-    between them.
+    between them. The node and edge properties named in `node_properties` and `edge_properties` are copied to the
+    sub-graph.
     """
     cdef vector[uint32_t] vec = [<uint32_t>n for n in node_vec]
+    cdef vector[string] node_properties_vec = [bytes(name, "utf-8") for name in node_properties]
+    cdef vector[string] edge_properties_vec = [bytes(name, "utf-8") for name in edge_properties]
     with nogil:
-        v = handle_result_property_graph(SubGraphExtraction(pg.underlying_property_graph(), vec, plan.underlying_))
+        v = handle_result_property_graph(
+            SubGraphExtraction(
+                pg.underlying_property_graph(), vec, node_properties_vec, edge_properties_vec, plan.underlying_
+            )
+        )
     return Graph.make(v)
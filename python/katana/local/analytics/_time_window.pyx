@@ -0,0 +1,192 @@
+"""
+Time Windows
+------------
+
+.. autoclass:: katana.local.analytics.TimeWindowedGraph
+    :members:
+    :special-members: __init__
+"""
+import numpy as np
+
+from libc.stdint cimport int64_t, uint32_t, uint64_t
+from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+from pyarrow.lib cimport to_shared
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+
+from katana.local.analytics._pagerank import PagerankPlan
+
+
+cdef extern from "katana/TemporalTopology.h" namespace "katana" nogil:
+    cppclass _TimeWindow "katana::TimeWindow":
+        int64_t begin
+        int64_t end
+
+
+cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analytics" nogil:
+    cppclass _PagerankPlan "katana::analytics::PagerankPlan":
+        @staticmethod
+        _PagerankPlan PullTopological(float tolerance, unsigned int max_iterations, float alpha)
+
+
+cdef extern from "katana/analytics/time_window/time_window.h" namespace "katana::analytics" nogil:
+    cppclass _TimeWindowedGraph "katana::analytics::TimeWindowedGraph":
+        @staticmethod
+        Result[unique_ptr[_TimeWindowedGraph]] Make(_PropertyGraph* pg, const string& timestamp_property_name)
+
+        Result[void] SetWindow(const _TimeWindow& window)
+        const _TimeWindow& window() const
+        uint64_t num_nodes() const
+        uint64_t num_edges() const
+        int64_t min_time() const
+        int64_t max_time() const
+
+        Result[vector[uint32_t]] Bfs(uint32_t source)
+        vector[uint32_t] ConnectedComponents()
+        vector[double] Pagerank(_PagerankPlan plan)
+
+    uint32_t kUnreachable "katana::analytics::TimeWindowedGraph::kUnreachable"
+
+
+cdef shared_ptr[_TimeWindowedGraph] handle_result_time_windowed_graph(
+        Result[unique_ptr[_TimeWindowedGraph]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return to_shared(res.value())
+
+
+cdef vector[uint32_t] handle_result_vector_uint32(Result[vector[uint32_t]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef _uint32_array(const vector[uint32_t]& v):
+    if v.empty():
+        return np.empty(0, dtype=np.uint32)
+    return np.array(<uint32_t[:v.size()]>(<uint32_t*>v.data()))
+
+
+cdef _double_array(const vector[double]& v):
+    if v.empty():
+        return np.empty(0, dtype=np.float64)
+    return np.array(<double[:v.size()]>(<double*>v.data()))
+
+
+cdef class TimeWindowedGraph:
+    """
+    BFS, connected components and PageRank of the subgraph of the edges of `pg` whose times, the edge property
+    `timestamp_property_name`, are in a window [begin, end). The edges of each node are sorted by time once, so
+    choosing a window copies no edges, and consecutive windows reuse work: sliding the window forward moves the ends
+    of the edges of each node from where they were, connected components of a window that contains the last one merge
+    only the added edges, and PageRank starts from the ranks of the last window.
+
+    Times are integers: the units since the epoch of a timestamp property, the days or milliseconds of a date property
+    or the values of an integer property. Edges with null times are in no window.
+    """
+    UNREACHABLE = kUnreachable
+
+    cdef shared_ptr[_TimeWindowedGraph] underlying
+    cdef Graph pg
+
+    def __init__(self, Graph pg, str timestamp_property_name):
+        """
+        :param pg: The graph, which must not change while this is in use.
+        :param timestamp_property_name: An integer, timestamp or date edge property.
+
+        The window starts as all times.
+        """
+        cdef string property_name_str = bytes(timestamp_property_name, "utf-8")
+        self.pg = pg
+        with nogil:
+            self.underlying = handle_result_time_windowed_graph(
+                _TimeWindowedGraph.Make(pg.underlying_property_graph(), property_name_str))
+
+    def set_window(self, int64_t begin, int64_t end):
+        """
+        Keep only the edges with times t such that begin <= t < end.
+        """
+        cdef _TimeWindow window
+        window.begin = begin
+        window.end = end
+        with nogil:
+            handle_result_void(self.underlying.get().SetWindow(window))
+
+    def sliding_windows(self, int64_t begin, int64_t end, int64_t width, int64_t step = 0):
+        """
+        Yield (begin, end) for the windows of `width` starting at `begin`, `begin + step`, ... before `end`, with each
+        window set while the caller analyzes it. `step` defaults to `width`.
+        """
+        if width <= 0 or step < 0:
+            raise ValueError("the width must be positive and the step not negative")
+        step = step or width
+        while begin < end:
+            self.set_window(begin, begin + width)
+            yield begin, begin + width
+            begin += step
+
+    @property
+    def window(self):
+        """
+        The current window as (begin, end).
+        """
+        cdef _TimeWindow window = self.underlying.get().window()
+        return window.begin, window.end
+
+    def num_nodes(self) -> int:
+        return self.underlying.get().num_nodes()
+
+    def num_edges(self) -> int:
+        """
+        The number of edges in the window.
+        """
+        return self.underlying.get().num_edges()
+
+    @property
+    def min_time(self) -> int:
+        return self.underlying.get().min_time()
+
+    @property
+    def max_time(self) -> int:
+        return self.underlying.get().max_time()
+
+    def bfs(self, uint32_t source):
+        """
+        :return: The number of edges on a shortest path in the window from `source` to each node, or `UNREACHABLE`,
+            as a numpy array.
+        """
+        cdef vector[uint32_t] distances
+        with nogil:
+            distances = handle_result_vector_uint32(self.underlying.get().Bfs(source))
+        return _uint32_array(distances)
+
+    def connected_components(self):
+        """
+        :return: The weakly connected component of each node in the window, named by its smallest node, as a numpy
+            array.
+        """
+        cdef vector[uint32_t] components
+        with nogil:
+            components = self.underlying.get().ConnectedComponents()
+        return _uint32_array(components)
+
+    def pagerank(self, plan = None):
+        """
+        :param plan: A :py:class:`~katana.local.analytics.PagerankPlan` whose tolerance, maximum iterations and alpha
+            are used; the ranks are pulled over the in-edges in the window whatever its algorithm.
+        :return: The PageRank of each node in the window, as a numpy array, starting from the ranks of the last call.
+        """
+        if plan is None:
+            plan = PagerankPlan()
+        cdef _PagerankPlan underlying_plan = _PagerankPlan.PullTopological(
+            plan.tolerance, plan.max_iterations, plan.alpha)
+        cdef vector[double] ranks
+        with nogil:
+            ranks = self.underlying.get().Pagerank(underlying_plan)
+        return _double_array(ranks)
@@ -15,9 +15,12 @@ Triangle Counting
     :undoc-members:
 
 .. autofunction:: katana.local.analytics.triangle_count
+
+.. autofunction:: katana.local.analytics.local_triangle_count
 """
 from libc.stdint cimport uint64_t
 from libcpp cimport bool
+from libcpp.string cimport string
 
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
@@ -58,6 +61,9 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
 
     Result[uint64_t] TriangleCount(_PropertyGraph* pg, _TriangleCountPlan plan)
 
+    Result[void] LocalTriangleCount(_PropertyGraph* pg, const string& node_output_property_name,
+        const string& edge_output_property_name)
+
 
 class _TriangleCountPlanAlgorithm(Enum):
     NodeIteration = _TriangleCountPlan.Algorithm.kNodeIteration
@@ -193,3 +199,24 @@ def triangle_count(Graph pg,  TriangleCountPlan plan = TriangleCountPlan()) -> i
     with nogil:
         v = handle_result_int(TriangleCount(pg.underlying_property_graph(), plan.underlying_))
     return v
+
+
+def local_triangle_count(Graph pg, str node_output_property_name, str edge_output_property_name):
+    """
+    Count, in one enumeration of the triangles of `pg`, the triangles on every node and on every edge. `pg` must be
+    symmetric, without parallel edges; both directions of an edge get its count and self loops get 0.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type node_output_property_name: str
+    :param node_output_property_name: The output node property holding the count of each node (as uint64), or an
+        empty string to skip it. This property must not already exist.
+    :type edge_output_property_name: str
+    :param edge_output_property_name: The output edge property holding the count of each edge (as uint64), or an
+        empty string to skip it. This property must not already exist.
+    """
+    cdef string node_output_property_name_str = bytes(node_output_property_name, "utf-8")
+    cdef string edge_output_property_name_str = bytes(edge_output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(LocalTriangleCount(pg.underlying_property_graph(), node_output_property_name_str,
+                                              edge_output_property_name_str))
@@ -1,3 +1,10 @@
+from libc.stdint cimport uint64_t
+from libcpp.memory cimport shared_ptr, unique_ptr
+from pyarrow.lib cimport CTable
+
+from katana.cpp.libsupport.result cimport Result
+
+
 cdef extern from "katana/analytics/Plan.h" namespace "katana::analytics" nogil:
     enum _Architecture "katana::analytics::Architecture":
         kCPU
@@ -9,9 +16,49 @@ cdef extern from "katana/analytics/Plan.h" namespace "katana::analytics" nogil:
         _Architecture architecture() const
 
 
+cdef extern from "katana/Cancellation.h" namespace "katana" nogil:
+    cppclass _CancellationToken "katana::CancellationToken":
+        pass
+
+
+cdef extern from "katana/analytics/Workspace.h" namespace "katana::analytics" nogil:
+    cppclass _AnalyticsWorkspace "katana::analytics::AnalyticsWorkspace":
+        void Clear()
+
+
+cdef extern from "katana/analytics/ResultCache.h" namespace "katana::analytics" nogil:
+    cppclass _AnalyticsResultCache "katana::analytics::AnalyticsResultCache":
+        _AnalyticsResultCache(uint64_t capacity_bytes)
+        void Clear()
+        uint64_t capacity_bytes() const
+        uint64_t size_bytes() const
+        uint64_t num_entries() const
+        uint64_t num_hits() const
+        uint64_t num_misses() const
+
+    uint64_t kDefaultCapacityBytes "katana::analytics::AnalyticsResultCache::kDefaultCapacityBytes"
+
+
 cdef class Plan:
     cdef _Plan* underlying(self) except NULL
 
 
 cdef class Statistics:
     pass
+
+
+cdef class Workspace:
+    cdef _AnalyticsWorkspace underlying_
+
+
+cdef _AnalyticsWorkspace* workspace_pointer(Workspace workspace)
+
+
+cdef class ResultCache:
+    cdef unique_ptr[_AnalyticsResultCache] underlying_
+
+
+cdef _AnalyticsResultCache* result_cache_pointer(ResultCache cache)
+
+
+cdef shared_ptr[CTable] handle_result_table(Result[shared_ptr[CTable]] res) nogil except *
@@ -1,3 +1,9 @@
+from libc.stdint cimport uint64_t
+from libcpp.memory cimport shared_ptr
+from pyarrow.lib cimport CTable
+
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+
 from enum import Enum
 
 
@@ -66,3 +72,76 @@ cdef class Statistics:
         :param args...: Additional parameters needed to compute statistics, including output property names.
         """
         raise NotImplementedError()
+
+
+cdef class Workspace:
+    """
+    Memory that analytics routines reuse across calls instead of allocating it on each call. Keep one workspace and
+    pass it to each of many calls of the batch routines, such as `bfs_batch`, on graphs of the same size. A workspace
+    may be used by one call at a time.
+    """
+
+    def clear(self):
+        """
+        Free all the memory of the workspace.
+        """
+        self.underlying_.Clear()
+
+
+cdef _AnalyticsWorkspace* workspace_pointer(Workspace workspace):
+    if workspace is None:
+        return NULL
+    return &workspace.underlying_
+
+
+cdef class ResultCache:
+    """
+    The output properties of analytics routines, kept in memory and keyed by the RDG directory and version of the
+    graph, the routine and its plan. Pass the same cache to the routines that accept one, such as `pagerank` and
+    `connected_components`, to compute each result on each committed version of a graph once; the cached values are
+    added as the output property on later calls. Graphs that have not been stored, or whose topology changed since,
+    have no version and are computed every time. The least recently used results are evicted beyond
+    `capacity_bytes`.
+    """
+
+    def __init__(self, uint64_t capacity_bytes = kDefaultCapacityBytes):
+        self.underlying_.reset(new _AnalyticsResultCache(capacity_bytes))
+
+    def clear(self):
+        """
+        Drop all the cached results.
+        """
+        self.underlying_.get().Clear()
+
+    @property
+    def capacity_bytes(self) -> int:
+        return self.underlying_.get().capacity_bytes()
+
+    @property
+    def size_bytes(self) -> int:
+        return self.underlying_.get().size_bytes()
+
+    @property
+    def num_entries(self) -> int:
+        return self.underlying_.get().num_entries()
+
+    @property
+    def num_hits(self) -> int:
+        return self.underlying_.get().num_hits()
+
+    @property
+    def num_misses(self) -> int:
+        return self.underlying_.get().num_misses()
+
+
+cdef _AnalyticsResultCache* result_cache_pointer(ResultCache cache):
+    if cache is None:
+        return NULL
+    return cache.underlying_.get()
+
+
+cdef shared_ptr[CTable] handle_result_table(Result[shared_ptr[CTable]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
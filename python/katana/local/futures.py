@@ -0,0 +1,87 @@
+"""
+Run long Katana calls in the background.
+
+The bindings release the GIL while Katana runs C++ code (analytics, loading, writing, and property updates), so other
+Python threads keep running while a call is in progress. This module runs such calls on a background thread and
+returns a :py:class:`concurrent.futures.Future` for each one:
+
+>>> from katana.local import analytics, futures
+>>> future = futures.submit(analytics.bfs, graph, 0, "bfs")
+>>> ...  # serve other requests
+>>> future.result()
+
+Katana's thread pool runs one parallel loop at a time, so calls are queued and run one after the other on a single
+thread; each of them still uses all of the active threads.
+"""
+
+import concurrent.futures
+import functools
+import threading
+
+from katana.local.graph import Graph
+
+__all__ = ["asynchronous", "load", "shutdown", "submit", "write"]
+
+_executor = None
+_executor_lock = threading.Lock()
+
+
+def _get_executor():
+    global _executor
+    with _executor_lock:
+        if _executor is None:
+            _executor = concurrent.futures.ThreadPoolExecutor(max_workers=1, thread_name_prefix="katana")
+        return _executor
+
+
+def submit(fn, *args, **kwargs) -> concurrent.futures.Future:
+    """
+    Call ``fn(*args, **kwargs)`` in the background and return a future of its result.
+
+    Calls are run in the order they were submitted. Any exception raised by ``fn`` is raised by
+    ``Future.result()``. ``fn`` should not be given a graph that is being used by another thread while it runs.
+    """
+    return _get_executor().submit(fn, *args, **kwargs)
+
+
+def asynchronous(fn):
+    """
+    Return a variant of ``fn`` which calls it in the background with :py:func:`submit` and returns the future:
+
+    >>> bfs_async = futures.asynchronous(analytics.bfs)
+    >>> bfs_async(graph, 0, "bfs").result()
+    """
+
+    @functools.wraps(fn)
+    def wrapper(*args, **kwargs):
+        return submit(fn, *args, **kwargs)
+
+    return wrapper
+
+
+def load(path, **kwargs) -> concurrent.futures.Future:
+    """
+    Load a graph in the background and return a future of the :py:class:`~katana.local.Graph`. The arguments are
+    those of :py:class:`~katana.local.Graph`.
+    """
+    return submit(Graph, path, **kwargs)
+
+
+def write(graph, path=None, command_line="katana.property_graph.Graph") -> concurrent.futures.Future:
+    """
+    Write ``graph`` in the background as :py:meth:`~katana.local.Graph.write` does and return a future which is
+    done once it has been written.
+    """
+    return submit(graph.write, path, command_line)
+
+
+def shutdown(wait=True):
+    """
+    Stop the background thread once the calls submitted so far are done, waiting for them if ``wait`` is true. Later
+    calls start a new thread.
+    """
+    global _executor
+    with _executor_lock:
+        executor, _executor = _executor, None
+    if executor is not None:
+        executor.shutdown(wait=wait)
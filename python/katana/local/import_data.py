@@ -5,16 +5,17 @@ and convert it into a Katana :py:class:`~katana.local.Graph` object.
 
 from typing import Collection, Dict, Optional, Union
 
-import numba
 import numpy as np
+import pyarrow
 
 from katana.local._graph import Graph
-from katana.local._import_data import from_csr, from_graphml
-from katana.native_interfacing.buffer_access import to_numpy
+from katana.local._import_data import from_csr, from_edge_arrays, from_graphml
+from katana.native_interfacing.buffer_access import to_numpy, to_pyarrow
 
 __all__ = [
     "from_graphml",
     "from_csr",
+    "from_edge_arrays",
     "from_adjacency_matrix",
     "from_edge_list_matrix",
     "from_edge_list_arrays",
@@ -47,34 +48,27 @@ def from_edge_list_matrix(edges: np.ndarray) -> Graph:
     return from_edge_list_arrays(edges[:, 0], edges[:, 1])
 
 
-@numba.njit()
-def _fill_indices(sort_order: np.ndarray, sources: np.ndarray, indices: np.ndarray):
-    last_source = 0
-    for source_index, edge_index in enumerate(sort_order):
-        source = sources[source_index]
-        if source != last_source:
-            for j in range(last_source, source):
-                indices[j] = edge_index
-            last_source = source
-    for j in range(last_source, len(indices)):
-        indices[j] = len(sources)
+def _to_edge_ids(ids, name):
+    if isinstance(ids, (pyarrow.Array, pyarrow.ChunkedArray)):
+        return ids
+    ids = to_numpy(ids)
+    if len(ids.shape) != 1:
+        raise TypeError(f"{name} must be a 1-d array")
+    return ids
 
 
 def from_edge_list_arrays(
-    sources: np.ndarray, destinations: np.ndarray, property_dict: Dict[str, np.ndarray] = None, **properties: np.ndarray
+    sources, destinations, property_dict: Dict[str, np.ndarray] = None, **properties: np.ndarray
 ) -> Graph:
     """
     Convert an edge list represented as two parallel arrays into a :py:class:`~katana.local.Graph`.
 
-    This preserves node IDs, but not edge IDs.
+    This preserves node IDs, but not edge IDs: the edges are sorted by source, in parallel and without the GIL, and
+    otherwise keep their order. The IDs may be numpy, pandas, or Arrow arrays of integers, which are read without a
+    copy; see :py:func:`~katana.local.import_data.from_edge_arrays`.
     """
-    sources = to_numpy(sources)
-    destinations = to_numpy(destinations)
-
-    if len(sources.shape) != 1:
-        raise TypeError("sources must be a 1-d array")
-    if len(destinations.shape) != 1:
-        raise TypeError("destinations must be a 1-d array")
+    sources = _to_edge_ids(sources, "sources")
+    destinations = _to_edge_ids(destinations, "destinations")
 
     n_edges = len(sources)
 
@@ -91,18 +85,10 @@ def from_edge_list_arrays(
         if len(prop) != n_edges:
             raise ValueError(f"{name} does not have length equal to sources.")
 
-    n_nodes = max(np.max(sources), np.max(destinations)) + 1
-
-    sort_order = sources.argsort()
-
-    csr_destinations = destinations[sort_order]
-    csr_indices = np.empty(n_nodes, dtype=np.uint64)
-    _fill_indices(sort_order, sources, csr_indices)
-
-    graph = from_csr(csr_indices, csr_destinations)
+    edge_properties = None
     if properties:
-        graph.add_edge_property(properties)
-    return graph
+        edge_properties = pyarrow.table({name: to_pyarrow(prop) for name, prop in properties.items()})
+    return from_edge_arrays(sources, destinations, edge_properties=edge_properties)
 
 
 def from_edge_list_dataframe(
@@ -6,6 +6,7 @@ import numba.types
 
 from katana.native_interfacing.closure import Closure, ClosureBuilder
 from katana.native_interfacing.katana_compiler import OperatorCompiler
+from katana.native_interfacing.operator_cache import jit_operator
 
 __all__ = [
     "do_all_operator",
@@ -32,6 +33,7 @@ def do_all_operator(typ=None, nopython=True, **kws):
     The operator is compiled using numba.
     Its argument types are inferred automatically based on the binding call.
     Multiple uses of the same operator with same type will reuse the same cached compiled copy of the function.
+    The compiled operator is also cached on disk for later processes; see `katana.native_interfacing.operator_cache`.
 
     Operators have some restrictions:
 
@@ -41,7 +43,7 @@ def do_all_operator(typ=None, nopython=True, **kws):
 
     def decorator(f):
         n_args = f.__code__.co_argcount - 1
-        f_jit = numba.jit(typ, nopython=nopython, pipeline_class=OperatorCompiler, **kws)(f)
+        f_jit = jit_operator(f, typ, nopython=nopython, pipeline_class=OperatorCompiler, **kws)
         builder = wraps(f)(ClosureBuilder(f_jit, n_unbound_arguments=1))
         if n_args == 0:
             return builder()
@@ -76,6 +78,7 @@ def for_each_operator(typ=None, nopython=True, **kws):
     The operator is compiled using numba.
     Its argument types are inferred automatically based on the binding call.
     Multiple uses of the same operator with same type will reuse the same cached compiled copy of the function.
+    The compiled operator is also cached on disk for later processes; see `katana.native_interfacing.operator_cache`.
 
     Operators have some restrictions:
 
@@ -85,7 +88,7 @@ def for_each_operator(typ=None, nopython=True, **kws):
 
     def decorator(f):
         n_args = f.__code__.co_argcount - 2
-        f_jit = numba.jit(typ, nopython=nopython, pipeline_class=OperatorCompiler, **kws)(f)
+        f_jit = jit_operator(f, typ, nopython=nopython, pipeline_class=OperatorCompiler, **kws)
         builder = wraps(f)(ClosureBuilder(f_jit, n_unbound_arguments=2))
         if n_args == 0:
             return builder()
@@ -123,7 +126,7 @@ def obim_metric(typ=None, nopython=True, **kws):
 
     def decorator(f):
         n_args = f.__code__.co_argcount - 1
-        f_jit = numba.jit(typ, nopython=nopython, pipeline_class=OperatorCompiler, **kws)(f)
+        f_jit = jit_operator(f, typ, nopython=nopython, pipeline_class=OperatorCompiler, **kws)
         builder = wraps(f)(ClosureBuilder(f_jit, return_type=numba.types.int64, n_unbound_arguments=1))
         if n_args == 0:
             return builder()
@@ -20,3 +20,4 @@ cdef class UntypedBufferAccess:
 
 cpdef to_numpy(v)
 cpdef to_pyarrow(v)
+cdef object numpy_view(const void* data, size_t length, object dtype, object owner)
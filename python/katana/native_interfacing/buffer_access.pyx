@@ -2,6 +2,7 @@ import numpy
 import pyarrow
 
 from cpython.buffer cimport PyBUF_CONTIG, PyBuffer_Release, PyObject_CheckBuffer, PyObject_GetBuffer
+from libc.stdint cimport uintptr_t
 
 
 cdef class UntypedBufferAccess:
@@ -62,3 +63,17 @@ cpdef to_pyarrow(v):
     if isinstance(v, pyarrow.Array):
         return v
     return pyarrow.array(v)
+
+
+cdef object numpy_view(const void* data, size_t length, object dtype, object owner):
+    """
+    Return a read-only numpy array of ``length`` elements of type ``dtype`` stored at ``data``, without a copy.
+
+    The array keeps ``owner``, which must keep ``data`` alive, alive. ``pyarrow.array`` wraps the result without a copy.
+    """
+    dtype = numpy.dtype(dtype)
+    if length == 0:
+        buffer = pyarrow.py_buffer(b"")
+    else:
+        buffer = pyarrow.foreign_buffer(<uintptr_t>data, length * dtype.itemsize, base=owner)
+    return numpy.frombuffer(buffer, dtype=dtype)
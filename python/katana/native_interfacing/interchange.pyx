@@ -0,0 +1,333 @@
+"""
+Zero-copy export of Katana data to other libraries.
+
+Properties are exported through the `Arrow C data and C stream interfaces
+<https://arrow.apache.org/docs/format/CDataInterface.html>`_: `ArrowArray` and `ArrowStream` implement
+``__arrow_c_array__`` and ``__arrow_c_stream__``, which return PyCapsules of the C structures, so that libraries
+which import Arrow data (pandas, Polars, DuckDB, newer pyarrow) use the memory of the properties without copying it.
+
+Topology arrays are exported through `DLPack <https://dmlc.github.io/dlpack/latest/>`_: `DLPackArray` implements
+``__dlpack__`` and ``__dlpack_device__`` for ``torch.from_dlpack`` and similar functions, and `to_dlpack` returns the
+``"dltensor"`` capsule expected by older functions such as ``torch.utils.dlpack.from_dlpack``. The topology arrays of
+a graph are read-only; DLPack cannot express this, so the importing library must not write to them.
+
+Exported data stays alive as long as the capsule or any object imported from it is alive. Arrow data is always
+exported with its own type; a ``requested_schema`` is ignored, as the interface allows, and consumers which need
+another type cast the imported data.
+"""
+
+from cpython.pycapsule cimport PyCapsule_GetPointer, PyCapsule_IsValid, PyCapsule_New
+from cpython.ref cimport Py_DECREF, Py_INCREF, PyObject
+from libc.stdint cimport int64_t, uint8_t, uint16_t, uint64_t, uintptr_t
+from libc.stdlib cimport free, malloc
+
+import numpy
+import pyarrow
+
+__all__ = ["ArrowArray", "ArrowStream", "DLPackArray", "to_dlpack"]
+
+
+# The structures are declared here, guarded as the Arrow specification requires, rather than included from Arrow,
+# so that only the pyarrow Python API is needed.
+cdef extern from *:
+    """
+    #ifndef ARROW_C_DATA_INTERFACE
+    #define ARROW_C_DATA_INTERFACE
+
+    struct ArrowSchema {
+      const char* format;
+      const char* name;
+      const char* metadata;
+      int64_t flags;
+      int64_t n_children;
+      struct ArrowSchema** children;
+      struct ArrowSchema* dictionary;
+      void (*release)(struct ArrowSchema*);
+      void* private_data;
+    };
+
+    struct ArrowArray {
+      int64_t length;
+      int64_t null_count;
+      int64_t offset;
+      int64_t n_buffers;
+      int64_t n_children;
+      const void** buffers;
+      struct ArrowArray** children;
+      struct ArrowArray* dictionary;
+      void (*release)(struct ArrowArray*);
+      void* private_data;
+    };
+
+    #endif  // ARROW_C_DATA_INTERFACE
+
+    #ifndef ARROW_C_STREAM_INTERFACE
+    #define ARROW_C_STREAM_INTERFACE
+
+    struct ArrowArrayStream {
+      int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+      int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+      const char* (*get_last_error)(struct ArrowArrayStream*);
+      void (*release)(struct ArrowArrayStream*);
+      void* private_data;
+    };
+
+    #endif  // ARROW_C_STREAM_INTERFACE
+    """
+    ctypedef struct CArrowSchema "struct ArrowSchema":
+        void (*release)(CArrowSchema*)
+
+    ctypedef struct CArrowArray "struct ArrowArray":
+        void (*release)(CArrowArray*)
+
+    ctypedef struct CArrowArrayStream "struct ArrowArrayStream":
+        void (*release)(CArrowArrayStream*)
+
+
+cdef extern from *:
+    """
+    #ifndef DLPACK_VERSION
+    #define DLPACK_VERSION 60
+
+    typedef enum { kDLCPU = 1 } DLDeviceType;
+
+    typedef struct {
+      DLDeviceType device_type;
+      int32_t device_id;
+    } DLDevice;
+
+    typedef enum { kDLInt = 0U, kDLUInt = 1U, kDLFloat = 2U } DLDataTypeCode;
+
+    typedef struct {
+      uint8_t code;
+      uint8_t bits;
+      uint16_t lanes;
+    } DLDataType;
+
+    typedef struct {
+      void* data;
+      DLDevice device;
+      int32_t ndim;
+      DLDataType dtype;
+      int64_t* shape;
+      int64_t* strides;
+      uint64_t byte_offset;
+    } DLTensor;
+
+    typedef struct DLManagedTensor {
+      DLTensor dl_tensor;
+      void* manager_ctx;
+      void (*deleter)(struct DLManagedTensor* self);
+    } DLManagedTensor;
+
+    #endif  // DLPACK_VERSION
+    """
+    ctypedef enum DLDeviceType:
+        kDLCPU
+
+    ctypedef struct DLDevice:
+        DLDeviceType device_type
+        int device_id
+
+    ctypedef struct DLDataType:
+        uint8_t code
+        uint8_t bits
+        uint16_t lanes
+
+    ctypedef struct DLTensor:
+        void* data
+        DLDevice device
+        int ndim
+        DLDataType dtype
+        int64_t* shape
+        int64_t* strides
+        uint64_t byte_offset
+
+    ctypedef struct DLManagedTensor:
+        DLTensor dl_tensor
+        void* manager_ctx
+        void (*deleter)(DLManagedTensor*)
+
+
+###### Arrow
+
+
+cdef void _release_schema_capsule(object capsule):
+    cdef CArrowSchema* schema = <CArrowSchema*>PyCapsule_GetPointer(capsule, "arrow_schema")
+    # A consumer which imported the schema has set release to NULL
+    if schema.release != NULL:
+        schema.release(schema)
+    free(schema)
+
+
+cdef void _release_array_capsule(object capsule):
+    cdef CArrowArray* array = <CArrowArray*>PyCapsule_GetPointer(capsule, "arrow_array")
+    if array.release != NULL:
+        array.release(array)
+    free(array)
+
+
+cdef void _release_stream_capsule(object capsule):
+    cdef CArrowArrayStream* stream = <CArrowArrayStream*>PyCapsule_GetPointer(capsule, "arrow_array_stream")
+    if stream.release != NULL:
+        stream.release(stream)
+    free(stream)
+
+
+cdef _new_schema_capsule(CArrowSchema** out):
+    out[0] = <CArrowSchema*>malloc(sizeof(CArrowSchema))
+    if out[0] == NULL:
+        raise MemoryError()
+    out[0].release = NULL
+    return PyCapsule_New(out[0], "arrow_schema", _release_schema_capsule)
+
+
+cdef _new_array_capsule(CArrowArray** out):
+    out[0] = <CArrowArray*>malloc(sizeof(CArrowArray))
+    if out[0] == NULL:
+        raise MemoryError()
+    out[0].release = NULL
+    return PyCapsule_New(out[0], "arrow_array", _release_array_capsule)
+
+
+cdef _new_stream_capsule(CArrowArrayStream** out):
+    out[0] = <CArrowArrayStream*>malloc(sizeof(CArrowArrayStream))
+    if out[0] == NULL:
+        raise MemoryError()
+    out[0].release = NULL
+    return PyCapsule_New(out[0], "arrow_array_stream", _release_stream_capsule)
+
+
+class ArrowArray:
+    """
+    An Arrow array, such as an unchunked property, exported with ``__arrow_c_array__``.
+    """
+
+    def __init__(self, array):
+        if isinstance(array, pyarrow.ChunkedArray):
+            if array.num_chunks != 1:
+                raise ValueError("Only chunked arrays with one chunk can be exported as arrays; use ArrowStream")
+            array = array.chunk(0)
+        self.array = array
+
+    def __arrow_c_array__(self, requested_schema=None):
+        """
+        Return PyCapsules of an ``ArrowSchema`` and an ``ArrowArray`` of the array.
+        """
+        cdef CArrowSchema* schema
+        cdef CArrowArray* array
+        schema_capsule = _new_schema_capsule(&schema)
+        array_capsule = _new_array_capsule(&array)
+        self.array._export_to_c(<uintptr_t>array, <uintptr_t>schema)
+        return schema_capsule, array_capsule
+
+
+class ArrowStream:
+    """
+    A pyarrow table, record batch, or chunked array exported as a stream of record batches with
+    ``__arrow_c_stream__``. A chunked array is a table with the single column ``name``.
+    """
+
+    def __init__(self, data, name="values"):
+        if isinstance(data, (pyarrow.ChunkedArray, pyarrow.Array)):
+            data = pyarrow.Table.from_arrays([data], names=[name])
+        elif isinstance(data, pyarrow.RecordBatch):
+            data = pyarrow.Table.from_batches([data])
+        self.table = data
+
+    def __arrow_c_stream__(self, requested_schema=None):
+        """
+        Return a PyCapsule of an ``ArrowArrayStream`` of the record batches of the table. The batches share the
+        memory of the table.
+        """
+        cdef CArrowArrayStream* stream
+        stream_capsule = _new_stream_capsule(&stream)
+        self.to_reader()._export_to_c(<uintptr_t>stream)
+        return stream_capsule
+
+    def to_reader(self):
+        """
+        Return the table as a `pyarrow.RecordBatchReader`, for consumers which take one.
+        """
+        return pyarrow.RecordBatchReader.from_batches(self.table.schema, self.table.to_batches())
+
+
+###### DLPack
+
+
+cdef struct _DLPackContext:
+    PyObject* owner
+    int64_t shape[1]
+
+
+cdef void _delete_dlpack_tensor(DLManagedTensor* tensor) with gil:
+    cdef _DLPackContext* context = <_DLPackContext*>tensor.manager_ctx
+    Py_DECREF(<object>context.owner)
+    free(context)
+    free(tensor)
+
+
+cdef void _release_dlpack_capsule(object capsule):
+    # A consumer which imported the tensor has renamed the capsule to "used_dltensor" and owns the tensor
+    if not PyCapsule_IsValid(capsule, "dltensor"):
+        return
+    cdef DLManagedTensor* tensor = <DLManagedTensor*>PyCapsule_GetPointer(capsule, "dltensor")
+    tensor.deleter(tensor)
+
+
+_dlpack_type_codes = {"i": 0, "u": 1, "f": 2}
+
+
+def to_dlpack(array):
+    """
+    Return a ``"dltensor"`` PyCapsule of a one dimensional, contiguous numpy array of integers or floating point
+    numbers, such as the topology arrays returned by `katana.local.Graph.adj_indices` and `katana.local.Graph.dests`.
+    The capsule keeps the array alive.
+    """
+    if not isinstance(array, numpy.ndarray) or array.ndim != 1 or not array.flags.c_contiguous:
+        raise ValueError("Only one dimensional, contiguous numpy arrays can be exported")
+    if array.dtype.kind not in _dlpack_type_codes:
+        raise TypeError("Cannot export arrays of {}".format(array.dtype))
+
+    cdef DLManagedTensor* tensor = <DLManagedTensor*>malloc(sizeof(DLManagedTensor))
+    cdef _DLPackContext* context = <_DLPackContext*>malloc(sizeof(_DLPackContext))
+    if tensor == NULL or context == NULL:
+        free(tensor)
+        free(context)
+        raise MemoryError()
+    Py_INCREF(array)
+    context.owner = <PyObject*>array
+    context.shape[0] = len(array)
+
+    tensor.dl_tensor.data = <void*><uintptr_t>array.ctypes.data
+    tensor.dl_tensor.device.device_type = kDLCPU
+    tensor.dl_tensor.device.device_id = 0
+    tensor.dl_tensor.ndim = 1
+    tensor.dl_tensor.dtype.code = _dlpack_type_codes[array.dtype.kind]
+    tensor.dl_tensor.dtype.bits = array.dtype.itemsize * 8
+    tensor.dl_tensor.dtype.lanes = 1
+    tensor.dl_tensor.shape = context.shape
+    # NULL strides mean a compact, row major tensor
+    tensor.dl_tensor.strides = NULL
+    tensor.dl_tensor.byte_offset = 0
+    tensor.manager_ctx = context
+    tensor.deleter = _delete_dlpack_tensor
+    return PyCapsule_New(tensor, "dltensor", _release_dlpack_capsule)
+
+
+class DLPackArray:
+    """
+    A numpy array exported with ``__dlpack__``, e.g., ``torch.from_dlpack(DLPackArray(graph.dests()))``. See
+    `to_dlpack`.
+    """
+
+    def __init__(self, array):
+        self.array = array
+
+    def __dlpack__(self, stream=None):
+        if stream is not None and stream != -1:
+            raise BufferError("Only CPU arrays can be exported, so stream must be None")
+        return to_dlpack(self.array)
+
+    def __dlpack_device__(self):
+        return (1, 0)  # kDLCPU
@@ -10,6 +10,8 @@ from numba.core import compiler, sigutils, types
 from numba.core.compiler import CompilerBase, DefaultPassBuilder
 from numba.core.imputils import lower_constant
 
+from katana.native_interfacing import operator_cache
+
 disable_nrt = True
 external_function_pointer_as_constant = True
 
@@ -54,7 +56,10 @@ def constant_function_pointer(context, builder: ir.IRBuilder, ty, pyval):
         and context.is_operator_context
     ):
         ptrty = context.get_function_pointer_type(ty)
-        return ir.Constant(ir.types.IntType(64), ty.get_pointer(pyval)).inttoptr(ptrty)
+        address = ir.Constant(ir.types.IntType(64), ty.get_pointer(pyval))
+        # The address is only valid in this process, so mark the module to keep it out of the operator cache.
+        builder.module.add_named_metadata(operator_cache.FUNCTION_POINTER_CONSTANTS_METADATA, [address])
+        return address.inttoptr(ptrty)
     # If we are not in an operator context (as defined by OperatorCompiler use) then call the numba implementation
     return numba.cpython.builtins.constant_function_pointer(context, builder, ty, pyval)
 
@@ -0,0 +1,198 @@
+"""
+A persistent on-disk cache of compiled operators.
+
+Operators declared with `do_all_operator`, `for_each_operator`, and `obim_metric` are compiled by numba the first time
+they are used with a new type signature. With the cache, the machine code of the operator is stored on disk and later
+processes load it instead of compiling again. Entries are keyed by the bytecode (including constants and nested
+functions) of the operator and by its type signature, so they are found again even for operators defined in notebooks
+or generated code, and are never used once the operator has changed. Like numba's own cache, changes to global values
+or other functions used by the operator are not detected.
+
+The cache is stored in ``$KATANA_NUMBA_CACHE_DIR``, or in ``katana`` under ``$NUMBA_CACHE_DIR`` or the user cache
+directory if it is not set. Setting ``KATANA_NUMBA_CACHE`` to ``0`` disables it. Operators which call native function
+pointers (e.g., the methods of `katana.local.Graph` in numba) embed the address of those functions in their machine
+code and are never cached.
+
+Operators can be compiled ahead of time: operators declared with type signatures (``do_all_operator("void(int64)")``)
+are compiled when their module is imported, and other operators are compiled for the signatures given to `register`.
+Running ``python -m katana.native_interfacing.operator_cache module ...`` imports the modules and compiles all of
+these into the cache, e.g., while building a container image.
+"""
+import argparse
+import hashlib
+import importlib
+import os
+import sys
+import types
+import warnings
+from pathlib import Path
+
+import numba
+from numba.core.caching import CompileResultCacheImpl, FunctionCache, _CacheLocator
+
+__all__ = ["cache_directory", "caching_enabled", "jit_operator", "precompile", "register"]
+
+# The name of the named metadata added to modules into which katana_compiler embedded function pointers.
+FUNCTION_POINTER_CONSTANTS_METADATA = "katana.function_pointer_constants"
+
+# The dispatchers of the operators and the signatures to compile them for ahead of time. See register.
+_registered = []
+
+
+def caching_enabled() -> bool:
+    return os.environ.get("KATANA_NUMBA_CACHE", "1") not in ("0", "false", "False")
+
+
+def cache_directory() -> Path:
+    if os.environ.get("KATANA_NUMBA_CACHE_DIR"):
+        return Path(os.environ["KATANA_NUMBA_CACHE_DIR"])
+    if numba.config.CACHE_DIR:
+        return Path(numba.config.CACHE_DIR) / "katana"
+    return Path(os.environ.get("XDG_CACHE_HOME", Path.home() / ".cache")) / "katana" / "numba"
+
+
+def _code_hash(code: types.CodeType) -> str:
+    """
+    Hash the bytecode of ``code`` along with its constants and names, which numba does not include in its keys.
+    """
+    hasher = hashlib.sha256()
+
+    def visit(c):
+        hasher.update(c.co_code)
+        hasher.update(repr((c.co_names, c.co_varnames, c.co_freevars, c.co_cellvars)).encode("utf-8"))
+        for const in c.co_consts:
+            if isinstance(const, types.CodeType):
+                visit(const)
+            elif isinstance(const, frozenset):
+                # the order of a frozenset depends on the hash seed of the process
+                hasher.update(repr(sorted(const, key=repr)).encode("utf-8"))
+            else:
+                hasher.update(repr(const).encode("utf-8"))
+
+    visit(code)
+    return hasher.hexdigest()
+
+
+class _OperatorCacheLocator(_CacheLocator):
+    """
+    Locate the cache of an operator in `cache_directory` whatever its source file is, with the bytecode of the
+    operator as the stamp of the cache index, so that the index is replaced when the operator changes.
+    """
+
+    def __init__(self, py_func, py_file):
+        self._py_file = py_file
+        self._code_hash = _code_hash(py_func.__code__)
+        self._cache_path = str(cache_directory())
+
+    def get_cache_path(self):
+        return self._cache_path
+
+    def get_source_stamp(self):
+        return self._code_hash
+
+    def get_disambiguator(self):
+        return hashlib.sha256(self._py_file.encode("utf-8")).hexdigest()[:10]
+
+    @classmethod
+    def from_function(cls, py_func, py_file):
+        locator = cls(py_func, py_file)
+        try:
+            locator.ensure_cache_path()
+        except OSError:
+            return None
+        return locator
+
+
+class _OperatorCacheImpl(CompileResultCacheImpl):
+    _locator_classes = [_OperatorCacheLocator]
+
+    def check_cachable(self, cres):
+        if FUNCTION_POINTER_CONSTANTS_METADATA in cres.library.get_llvm_str():
+            return False
+        return super().check_cachable(cres)
+
+
+class OperatorCache(FunctionCache):
+    """
+    A numba cache for operator dispatchers; see the module documentation.
+    """
+
+    _impl_class = _OperatorCacheImpl
+
+    def _index_key(self, sig, codegen):
+        sig, magic_tuple, (_, closure_hash) = super()._index_key(sig, codegen)
+        return sig, magic_tuple, (_code_hash(self._py_func.__code__), closure_hash)
+
+
+def jit_operator(f, typ=None, **options):
+    """
+    Compile ``f`` with `numba.jit` as an operator whose compiled code is cached on disk if `caching_enabled`. If
+    ``typ`` is a signature or a list of them, ``f`` is compiled for them now and for no others, as with `numba.jit`.
+    ``cache=False`` disables the cache for this operator.
+    """
+    cache = options.pop("cache", True) and caching_enabled()
+    dispatcher = numba.jit(**options)(f)
+    if cache:
+        try:
+            dispatcher._cache = OperatorCache(dispatcher.py_func)
+        except RuntimeError as e:
+            # The cache directory is not writable.
+            warnings.warn(f"Operators will not be cached: {e}")
+    if typ is not None:
+        for sig in typ if isinstance(typ, list) else [typ]:
+            dispatcher.compile(sig)
+        dispatcher.disable_compile()
+    return dispatcher
+
+
+def _dispatcher_of(operator):
+    # operators are ClosureBuilders, or UninstantiatedClosures if they have no bound arguments
+    builder = getattr(operator, "_builder", operator)
+    return builder._underlying_function
+
+
+def register(operator, *signatures):
+    """
+    Have `precompile` compile ``operator``, as returned by `do_all_operator` and the other operator decorators, for
+    each of ``signatures``. A signature covers all arguments of the operator, bound and unbound, e.g.,
+    ``"void(float64[:], int64)"``. Returns ``operator`` so that it can be used on operator definitions.
+    """
+    _registered.append((_dispatcher_of(operator), signatures))
+    return operator
+
+
+def precompile(modules=()):
+    """
+    Import ``modules`` and compile the operators registered with `register` for their signatures, storing them in the
+    cache. Operators declared with signatures are compiled by the import itself.
+
+    :return: The number of signatures compiled or loaded from the cache.
+    """
+    for module in modules:
+        importlib.import_module(module)
+    count = 0
+    for dispatcher, signatures in _registered:
+        for sig in signatures:
+            dispatcher.compile(sig)
+            count += 1
+    return count
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Compile the Katana operators of modules into the operator cache.")
+    parser.add_argument("--cache-dir", help="The cache directory (default: $KATANA_NUMBA_CACHE_DIR).")
+    parser.add_argument("modules", nargs="+", help="The modules declaring the operators.")
+    args = parser.parse_args(argv)
+    if args.cache_dir:
+        os.environ["KATANA_NUMBA_CACHE_DIR"] = args.cache_dir
+    if not caching_enabled():
+        parser.error("the operator cache is disabled by KATANA_NUMBA_CACHE")
+    # When run with -m this module is __main__, while operators are registered with the imported module.
+    from katana.native_interfacing import operator_cache
+
+    count = operator_cache.precompile(args.modules)
+    print(f"Compiled {count} registered signatures into {cache_directory()}")
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,7 +1,9 @@
 import ctypes
 import operator
+from typing import NamedTuple
 
 import numba.core.ccallback
+import numpy
 import numba.types
 import pyarrow
 from numba.extending import get_cython_function_address, overload, overload_method, typeof_impl
@@ -9,7 +11,7 @@ from numba.extending import get_cython_function_address, overload, overload_meth
 from . import _pyarrow_wrappers
 from .wrappers import NativeNumbaPointerWrapper
 
-__all__ = []
+__all__ = ["ArrowArrayView", "array_view"]
 
 
 ###### Wrap typed Arrow arrays for Numba
@@ -381,3 +383,86 @@ ChunkedArrayNumbaPointerWrapper(
     _pyarrow_wrappers.ChunkedArray_get_address,
     override_module_name="katana.native_interfacing._pyarrow_wrappers",
 )
+
+
+###### Direct views of Arrow arrays for Numba
+
+
+class ArrowArrayView(NamedTuple):
+    """
+    A view of a primitive Arrow array as numpy arrays, which numba code indexes directly instead of calling into
+    Arrow for each element as the wrappers above do. Create one with `array_view`.
+
+    In numba and in Python, ``view.values[i]`` is element ``i`` (whatever it is if the element is null) and
+    ``view.is_valid(i)`` and ``view.is_null(i)`` check the null bitmap.
+    """
+
+    #: The elements of the array. The array is read-only and shares the memory of the Arrow array.
+    values: numpy.ndarray
+    #: The Arrow null bitmap (a bit per element, least significant bit first), or an empty array if there are no nulls
+    validity: numpy.ndarray
+    #: The bit of element 0 in ``validity``
+    offset: int
+
+    def is_valid(self, i):
+        if len(self.validity) == 0:
+            return True
+        bit = self.offset + i
+        return (self.validity[bit >> 3] >> (bit & 7)) & 1 == 1
+
+    def is_null(self, i):
+        return not self.is_valid(i)
+
+
+def array_view(array) -> ArrowArrayView:
+    """
+    Return an `ArrowArrayView` of ``array``, a pyarrow array of integers or floating point numbers, without copying
+    it. A chunked array is viewed without a copy only if it has a single chunk; otherwise its chunks are concatenated.
+    """
+    if isinstance(array, pyarrow.ChunkedArray):
+        if array.num_chunks == 1:
+            array = array.chunk(0)
+        elif array.num_chunks == 0:
+            array = pyarrow.array([], type=array.type)
+        else:
+            array = pyarrow.concat_arrays(array.chunks)
+    if not (pyarrow.types.is_integer(array.type) or pyarrow.types.is_floating(array.type)):
+        raise TypeError("Only arrays of integers or floating point numbers can be viewed, not {}".format(array.type))
+    validity_buffer, data_buffer = array.buffers()
+    dtype = numpy.dtype(array.type.to_pandas_dtype())
+    if data_buffer is None:
+        values = numpy.empty(0, dtype=dtype)
+    else:
+        values = numpy.frombuffer(data_buffer, dtype=dtype, count=array.offset + len(array))[array.offset :]
+    if array.null_count == 0 or validity_buffer is None:
+        validity = numpy.empty(0, dtype=numpy.uint8)
+    else:
+        validity = numpy.frombuffer(validity_buffer, dtype=numpy.uint8)
+    return ArrowArrayView(values, validity, array.offset)
+
+
+@overload_method(numba.types.NamedTuple, "is_valid")
+def overload_ArrowArrayView_is_valid(v, i):
+    if v.instance_class is not ArrowArrayView:
+        return None
+    _ = i
+
+    def impl_(v, i):
+        if len(v.validity) == 0:
+            return True
+        bit = v.offset + i
+        return (v.validity[bit >> 3] >> (bit & 7)) & 1 == 1
+
+    return impl_
+
+
+@overload_method(numba.types.NamedTuple, "is_null")
+def overload_ArrowArrayView_is_null(v, i):
+    if v.instance_class is not ArrowArrayView:
+        return None
+    _ = i
+
+    def impl_(v, i):
+        return not v.is_valid(i)
+
+    return impl_
@@ -0,0 +1,252 @@
+"""
+Statistics and traces of Katana calls.
+
+Katana reports statistics of its parallel loops and algorithms, such as the time and iterations of each loop and the
+memory allocated, to its statistics registry, which prints them at exit. `get_stats` reads them while the program runs
+and `collect_stats` collects the statistics reported by a block of code:
+
+>>> from katana import profiling
+>>> with profiling.collect_stats() as profile:
+...     analytics.bfs(graph, 0, "bfs")
+>>> profile.to_dataframe()
+
+`trace` opens a span of the progress tracer around a block of code. Katana calls in the block add their spans as
+children of it, so that the slow parts of a Python pipeline can be found in the trace.
+"""
+
+import time
+from typing import Any, List, NamedTuple
+
+from libc.stdint cimport int64_t
+from libcpp.memory cimport shared_ptr
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+from katana.cpp.libgalois.Statistics cimport GetStatSnapshot, StatRecord, StatSnapshot
+from katana.cpp.libsupport.ProgressTracer cimport (
+    AddBoolTag,
+    AddDoubleTag,
+    AddIntTag,
+    AddStringTag,
+    ProgressSpan,
+    ProgressTracer,
+    Tags,
+)
+
+__all__ = ["Stat", "Profile", "collect_stats", "get_stats", "memory_usage", "stats_to_dataframe", "trace", "Span"]
+
+_total_type_names = ("SINGLE", "TMIN", "TMAX", "TSUM", "TAVG")
+
+
+class Stat(NamedTuple):
+    """
+    A statistic: ``total`` combines the ``thread_values`` reported by each thread as ``total_type`` says ("SINGLE",
+    "TMIN", "TMAX", "TSUM" or "TAVG").
+    """
+
+    region: str
+    category: str
+    total_type: str
+    total: Any
+    thread_values: List[Any]
+
+
+cdef _int_stats(vector[StatRecord[int64_t]]& records):
+    return [
+        Stat(str(r.region, "utf-8"), str(r.category, "utf-8"), _total_type_names[r.type], r.total, list(r.thread_values))
+        for r in records
+    ]
+
+
+cdef _fp_stats(vector[StatRecord[double]]& records):
+    return [
+        Stat(str(r.region, "utf-8"), str(r.category, "utf-8"), _total_type_names[r.type], r.total, list(r.thread_values))
+        for r in records
+    ]
+
+
+cdef _param_stats(vector[StatRecord[string]]& records):
+    return [
+        Stat(
+            str(r.region, "utf-8"),
+            str(r.category, "utf-8"),
+            _total_type_names[r.type],
+            str(r.total, "utf-8"),
+            [str(v, "utf-8") for v in r.thread_values],
+        )
+        for r in records
+    ]
+
+
+def get_stats() -> List[Stat]:
+    """
+    Return the statistics reported so far. This does not change what is printed at exit. Must not be called while a
+    Katana call is running in another thread.
+    """
+    cdef StatSnapshot snapshot
+    with nogil:
+        snapshot = GetStatSnapshot()
+    return _int_stats(snapshot.ints) + _fp_stats(snapshot.fps) + _param_stats(snapshot.params)
+
+
+def stats_to_dataframe(stats):
+    """
+    Return a pandas DataFrame of `Stat` objects with a row per statistic and a column per field.
+    """
+    import pandas
+
+    return pandas.DataFrame.from_records(stats, columns=Stat._fields)
+
+
+def memory_usage() -> dict:
+    """
+    Return the resident set size of this process and its maximum so far, in bytes, as ``rss_bytes`` and
+    ``max_rss_bytes``.
+    """
+    # getrusage reports kilobytes
+    return dict(rss_bytes=ProgressTracer.ParseProcSelfRssBytes(), max_rss_bytes=ProgressTracer.GetMaxMem() * 1024)
+
+
+def _difference(before: Stat, after: Stat) -> Stat:
+    # Only sums accumulate; other totals are those of the reports so far
+    if after.total_type != "TSUM" or len(before.thread_values) != len(after.thread_values):
+        return after
+    return after._replace(
+        total=after.total - before.total,
+        thread_values=[a - b for a, b in zip(after.thread_values, before.thread_values)],
+    )
+
+
+class Profile:
+    """
+    The statistics, time and memory of a block of code, as collected by `collect_stats`.
+
+    :ivar stats: The statistics reported in the block. Sums ("TSUM") are those of the reports made in the block, other
+        totals are those of all reports of the statistic so far.
+    :ivar seconds: The wall clock time of the block.
+    :ivar memory_before: `memory_usage` before the block.
+    :ivar memory_after: `memory_usage` after the block.
+    """
+
+    def __init__(self):
+        self.stats = []
+        self.seconds = None
+        self.memory_before = None
+        self.memory_after = None
+        self._stats_before = None
+        self._start = None
+
+    def to_dataframe(self):
+        """
+        Return the statistics as with `stats_to_dataframe`.
+        """
+        return stats_to_dataframe(self.stats)
+
+    def __getitem__(self, key):
+        """
+        ``profile[region, category]`` is the total of a statistic reported in the block.
+        """
+        region, category = key
+        for s in self.stats:
+            if s.region == region and s.category == category:
+                return s.total
+        raise KeyError(key)
+
+    def __enter__(self):
+        self.memory_before = memory_usage()
+        self._stats_before = {(s.region, s.category): s for s in get_stats()}
+        self._start = time.perf_counter()
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.seconds = time.perf_counter() - self._start
+        self.memory_after = memory_usage()
+        self.stats = []
+        for s in get_stats():
+            before = self._stats_before.get((s.region, s.category))
+            if before is None:
+                self.stats.append(s)
+            elif before != s:
+                self.stats.append(_difference(before, s))
+        self._stats_before = None
+
+
+def collect_stats() -> Profile:
+    """
+    Return a context manager which collects a `Profile` of its block, e.g., the time and iterations of each loop of the
+    algorithms called in it.
+    """
+    return Profile()
+
+
+cdef _to_tags(Tags* out, dict tags):
+    cdef string key
+    for k, v in tags.items():
+        key = bytes(k, "utf-8")
+        if isinstance(v, bool):
+            AddBoolTag(out, key, v)
+        elif isinstance(v, int):
+            AddIntTag(out, key, v)
+        elif isinstance(v, float):
+            AddDoubleTag(out, key, v)
+        else:
+            AddStringTag(out, key, bytes(str(v), "utf-8"))
+
+
+cdef class Span:
+    """
+    A span of the progress tracer, opened by `trace`. It is closed when its ``with`` block ends or by `close`; as with
+    scopes in C++, it is finished once its children are.
+    """
+
+    cdef shared_ptr[ProgressSpan] underlying
+
+    def __init__(self):
+        raise TypeError("Use katana.profiling.trace to open spans")
+
+    def set_tags(self, **tags):
+        """
+        Add tags to the span.
+        """
+        cdef Tags ctags
+        _to_tags(&ctags, tags)
+        self.underlying.get().SetTags(ctags)
+
+    def log(self, str message, **tags):
+        """
+        Log a message with tags in the span, along with the memory use of the process.
+        """
+        cdef Tags ctags
+        _to_tags(&ctags, tags)
+        self.underlying.get().Log(bytes(message, "utf-8"), ctags)
+
+    def close(self):
+        """
+        Close the span. Closing it again does nothing.
+        """
+        self.underlying.get().MarkScopeClosed()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        if exc_type is not None:
+            self.set_tags(error=True)
+            self.log(str(exc_val), event="error")
+        self.close()
+
+
+def trace(str name, **tags) -> Span:
+    """
+    Open a span named ``name`` with ``tags`` as a child of the active span and make it the active span:
+
+    >>> with profiling.trace("load", path=path) as span:
+    ...     graph = Graph(path)
+    ...     span.log("loaded", nodes=graph.num_nodes())
+    """
+    cdef Span span = Span.__new__(Span)
+    cdef string cname = bytes(name, "utf-8")
+    span.underlying = ProgressTracer.Get().StartActiveSpanUnscoped(cname)
+    if tags:
+        span.set_tags(**tags)
+    return span
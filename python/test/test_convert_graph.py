@@ -4,11 +4,14 @@ from tempfile import TemporaryDirectory
 
 import numpy as np
 import pandas
+import pyarrow
 import pytest
 
+from katana import GaloisError
 from katana.local import Graph
 from katana.local.import_data import (
     from_adjacency_matrix,
+    from_edge_arrays,
     from_edge_list_arrays,
     from_edge_list_dataframe,
     from_edge_list_matrix,
@@ -115,6 +118,39 @@ def test_dataframe():
     assert list(g.get_edge_property("prop").to_numpy()) == [1, 2, 3]
 
 
+def test_unsorted_arrays_properties():
+    g = from_edge_list_arrays(np.array([2, 0, 2, 0]), np.array([0, 1, 1, 2]), prop=np.array([10, 11, 12, 13]))
+    assert [g.edges(n) for n in g] == [range(0, 2), range(2, 2), range(2, 4)]
+    assert [g.get_edge_dest(i) for i in range(g.num_edges())] == [1, 2, 0, 1]
+    assert list(g.get_edge_property("prop").to_numpy()) == [11, 13, 10, 12]
+
+
+def test_edge_arrays():
+    sources = pyarrow.chunked_array([pyarrow.array([1, 0]), pyarrow.array([1])], type=pyarrow.uint32())
+    g = from_edge_arrays(
+        sources,
+        np.array([2, 1, 0], dtype=np.int16),
+        node_properties=dict(name=["a", "b", "c", "d"]),
+        edge_properties=pandas.DataFrame(dict(weight=[1.0, 2.0, 3.0])),
+    )
+    assert g.num_nodes() == 4
+    assert [g.edges(n) for n in g] == [range(0, 1), range(1, 3), range(3, 3), range(3, 3)]
+    assert [g.get_edge_dest(i) for i in range(g.num_edges())] == [1, 2, 0]
+    assert list(g.get_edge_property("weight").to_numpy()) == [2.0, 1.0, 3.0]
+    assert g.get_node_property("name").to_pylist() == ["a", "b", "c", "d"]
+
+
+def test_edge_arrays_bad_ids():
+    with pytest.raises(GaloisError):
+        from_edge_arrays(np.array([0, -1]), np.array([1, 0]))
+    with pytest.raises(GaloisError):
+        from_edge_arrays(np.array([0, 1]), np.array([1, 2]), num_nodes=2)
+    with pytest.raises(GaloisError):
+        from_edge_arrays(pyarrow.array([0, None]), pyarrow.array([1, 0]))
+    with pytest.raises(GaloisError):
+        from_edge_arrays(np.array([0.0]), np.array([1.0]))
+
+
 @pytest.mark.required_env("KATANA_SOURCE_DIR")
 def test_load_graphml():
     input_file = Path(os.environ["KATANA_SOURCE_DIR"]) / "tools" / "graph-convert" / "test-inputs" / "movies.graphml"
@@ -2,53 +2,142 @@ from test.lonestar.bfs import verify_bfs
 from test.lonestar.sssp import verify_sssp
 
 import numpy as np
-from pyarrow import Schema, table
+from pyarrow import Schema, array, table, timestamp
 from pytest import approx, raises
 
-from katana import GaloisError, set_busy_wait
+from katana import GaloisError, set_active_threads, set_busy_wait
 from katana.example_data import get_input
 from katana.local import Graph
 from katana.local.analytics import (
     BetweennessCentralityPlan,
     BetweennessCentralityStatistics,
+    BiconnectedComponentsPlan,
+    BiconnectedComponentsStatistics,
+    BipartiteMatchingPlan,
+    BipartiteMatchingStatistics,
     BfsStatistics,
+    ClosenessCentralityPlan,
+    ClosenessCentralityStatistics,
     ConnectedComponentsStatistics,
+    EigenvectorCentralityPlan,
+    EigenvectorCentralityStatistics,
+    FourNodeGraphletCensus,
+    GraphColoringPlan,
+    GraphColoringStatistics,
+    HitsPlan,
+    HitsStatistics,
+    HypergraphPartitionStatistics,
+    IncrementalConnectedComponents,
     IndependentSetPlan,
     IndependentSetStatistics,
     JaccardPlan,
     JaccardStatistics,
+    KatzCentralityPlan,
+    KCliquePlan,
+    KShortestPathsPlan,
+    KShortestPathsQuery,
+    KCoreDecompositionStatistics,
     KCoreStatistics,
+    KTrussDecompositionStatistics,
     KTrussStatistics,
+    LabelPropagationPlan,
+    LabelPropagationStatistics,
+    LouvainClusteringPlan,
     LouvainClusteringStatistics,
+    MatrixCompletionPlan,
+    MatrixCompletionStatistics,
+    MaxFlowPlan,
+    MaxFlowStatistics,
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+    NeighborhoodFunctionEstimate,
+    NeighborhoodFunctionPlan,
+    NeighborSampler,
+    NeighborSamplingPlan,
+    PagerankPlan,
     PagerankStatistics,
+    PartitionPlan,
+    PartitionStatistics,
+    PointToPointQuery,
+    RandomWalksPlan,
+    ResultCache,
+    SsspPlan,
     SsspStatistics,
+    StronglyConnectedComponentsPlan,
+    StronglyConnectedComponentsStatistics,
+    TimeWindowedGraph,
     TriangleCountPlan,
+    Workspace,
     betweenness_centrality,
     bfs,
     bfs_assert_valid,
+    bfs_batch,
+    bipartite_matching,
+    bipartite_matching_assert_valid,
+    closeness_centrality,
+    biconnected_components,
+    biconnected_components_assert_valid,
     connected_components,
     connected_components_assert_valid,
+    eigenvector_centrality,
+    eigenvector_centrality_assert_valid,
+    estimate_neighborhood_function,
     find_edge_sorted_by_dest,
+    four_cycle_count_per_node,
+    graph_coloring,
+    graph_coloring_assert_valid,
+    harmonic_centrality,
+    hits,
+    hits_assert_valid,
     independent_set,
     independent_set_assert_valid,
     jaccard,
     jaccard_assert_valid,
+    jaccard_top_k,
+    k_clique_count,
+    k_clique_count_per_node,
     k_core,
     k_core_assert_valid,
+    k_core_batch,
+    k_core_decomposition,
+    k_shortest_paths,
     k_truss,
     k_truss_assert_valid,
+    k_truss_decomposition,
+    katz_centrality,
+    label_propagation,
+    label_propagation_assert_valid,
     local_clustering_coefficient,
+    local_triangle_count,
     louvain_clustering,
     louvain_clustering_assert_valid,
+    matrix_completion,
+    matrix_completion_assert_valid,
+    max_flow,
+    max_flow_assert_valid,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
     pagerank,
     pagerank_assert_valid,
+    partition,
+    partition_assert_valid,
+    partition_hypergraph,
+    personalized_pagerank,
+    personalized_pagerank_batch,
+    random_walks,
+    random_walks_in_batches,
     sort_all_edges_by_dest,
     sort_nodes_by_degree,
     sssp,
     sssp_assert_valid,
+    sssp_batch,
+    sssp_repair,
+    strongly_connected_components,
+    strongly_connected_components_assert_valid,
     subgraph_extraction,
     triangle_count,
 )
+from katana.local.import_data import from_csr
 
 NODES_TO_SAMPLE = 10
 
@@ -148,6 +237,131 @@ def test_sssp(graph: Graph):
     verify_sssp(graph, start_node, new_property_id)
 
 
+def test_bfs_batch(graph: Graph):
+    num_node_properties = len(graph.loaded_node_schema())
+    workspace = Workspace()
+    parents = bfs_batch(graph, [0, 10], workspace=workspace)
+    assert parents.column_names == ["0", "10"]
+    assert len(graph.loaded_node_schema()) == num_node_properties
+
+    bfs(graph, 10, "parents_10")
+    assert parents.column("10").to_pylist() == graph.get_node_property("parents_10").to_pylist()
+    assert bfs_batch(graph, [10], workspace=workspace).column(0) == parents.column(1)
+
+    with raises(GaloisError):
+        bfs_batch(graph, [graph.num_nodes()])
+
+
+def test_sssp_batch(graph: Graph):
+    weight_name = "workFrom"
+    distances = sssp_batch(graph, [0, 10, 0], weight_name, workspace=Workspace())
+    assert distances.column_names == ["0", "10", "0"]
+    assert distances.column(0) == distances.column(2)
+
+    sssp(graph, 10, weight_name, "distances_10")
+    assert distances.column("10").to_pylist() == graph.get_node_property("distances_10").to_pylist()
+
+
+def test_sssp_auto_delta():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    plan = SsspPlan.delta_step_auto_delta()
+    assert plan.algorithm == SsspPlan.Algorithm.DeltaStepAutoDelta
+
+    for source in (0, 10):
+        sssp(graph, source, "value", f"auto_{source}", plan)
+        sssp_assert_valid(graph, source, "value", f"auto_{source}")
+        sssp(graph, source, "value", f"dijkstra_{source}", SsspPlan.dijkstra())
+        assert (
+            graph.get_node_property(f"auto_{source}").to_pylist()
+            == graph.get_node_property(f"dijkstra_{source}").to_pylist()
+        )
+
+    distances = sssp_batch(graph, [0, 10], "value", plan)
+    assert distances.column("0").to_pylist() == graph.get_node_property("dijkstra_0").to_pylist()
+    assert distances.column("10").to_pylist() == graph.get_node_property("dijkstra_10").to_pylist()
+
+
+def test_sssp_repair():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    source = 0
+    sssp(graph, source, "value", "distance")
+
+    # halve the weights of every 13th edge and repair the distances
+    weights = graph.get_edge_property("value").to_numpy().copy()
+    changed = np.arange(0, graph.num_edges(), 13)
+    weights[changed] //= 2
+    graph.add_edge_property(table({"decreased": weights}))
+    sources = np.searchsorted(graph.adj_indices(), changed, side="right")
+    dests = graph.dests()
+    sssp_repair(graph, "decreased", "distance", [(int(s), int(dests[e])) for s, e in zip(sources, changed)])
+
+    sssp(graph, source, "decreased", "expected")
+    assert graph.get_node_property("distance").to_pylist() == graph.get_node_property("expected").to_pylist()
+    sssp_assert_valid(graph, source, "decreased", "distance")
+
+
+def test_k_shortest_paths():
+    # 0 -> 1, 2, 3; 1 -> 3; 2 -> 3; 3 -> 0
+    diamond = from_csr(np.array([3, 4, 5, 6]), np.array([1, 2, 3, 3, 3, 0]))
+    simple = k_shortest_paths(diamond, 0, 3, 5, plan=KShortestPathsPlan.yen())
+    assert simple[0] == (1, [0, 3])
+    assert sorted(simple[1:]) == [(2, [0, 1, 3]), (2, [0, 2, 3])]
+    walks = k_shortest_paths(diamond, 0, 3, 4, plan=KShortestPathsPlan.label_setting())
+    assert sorted(walks[1:3]) == sorted(simple[1:])
+    assert walks[3] == (3, [0, 3, 0, 3])
+
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    sssp(graph, 0, "value", "distance")
+    distances = graph.get_node_property("distance").to_pylist()
+    weights = graph.get_edge_property("value").to_numpy()
+    ends = graph.adj_indices()
+    dests = graph.dests()
+
+    def edge_weight(source, dest):
+        begin = ends[source - 1] if source else 0
+        return min(weights[e] for e in range(begin, ends[source]) if dests[e] == dest)
+
+    query = KShortestPathsQuery(graph, "value")
+    for target in (7, 100, 500):
+        paths = query.paths(0, target, 4)
+        if not paths:
+            continue
+        assert paths[0][0] == approx(distances[target])
+        assert [w for w, _ in paths] == sorted(w for w, _ in paths)
+        for weight, nodes in paths:
+            assert nodes[0] == 0 and nodes[-1] == target
+            assert len(set(nodes)) == len(nodes)
+            assert weight == approx(sum(edge_weight(s, d) for s, d in zip(nodes, nodes[1:])))
+
+    with raises(GaloisError):
+        query.paths(0, graph.num_nodes(), 4)
+
+
+def test_point_to_point():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    source = 0
+    sssp(graph, source, "value", "distance")
+    reached = SsspStatistics(graph, "distance").max_distance
+    expected = graph.get_node_property("distance").to_pylist()
+
+    query = PointToPointQuery(graph, "value")
+    targets = range(0, graph.num_nodes(), 7)
+    distances = query.distances([(source, t) for t in targets])
+    for t, distance in zip(targets, distances):
+        if expected[t] <= reached:
+            assert distance == approx(expected[t])
+        else:
+            assert distance == PointToPointQuery.UNREACHABLE
+    assert query.distance(source, 7) == distances[1]
+    assert query.distance(source, source) == 0
+
+    hops = PointToPointQuery(graph)
+    assert hops.distance(3, 500) == hops.distance(500, 3)
+
+    with raises(GaloisError):
+        query.distance(source, graph.num_nodes())
+
+
 def test_jaccard(graph: Graph):
     property_name = "NewProp"
     compare_node = 0
@@ -189,6 +403,34 @@ def test_jaccard_sorted(graph: Graph):
     assert similarities[2812] == approx(0.0)
 
 
+def test_jaccard_top_k(graph: Graph):
+    property_name = "NewProp"
+    compare_node = 0
+    k = 5
+
+    jaccard(graph, compare_node, property_name)
+    similarities: np.ndarray = graph.get_node_property(property_name).to_numpy()
+    others = np.delete(similarities, compare_node)
+    expected = np.sort(others[others > 0])[::-1][:k]
+
+    top = jaccard_top_k(graph, k)
+
+    assert len(top) == graph.num_nodes()
+    assert [similarity for _, similarity in top[compare_node]] == approx(list(expected))
+    for node, similarity in top[compare_node]:
+        assert similarities[node] == approx(similarity)
+
+
+def test_jaccard_top_k_min_hash(graph: Graph):
+    top = jaccard_top_k(graph, 5, JaccardPlan.min_hash())
+
+    assert len(top) == graph.num_nodes()
+    for neighbors in top:
+        assert len(neighbors) <= 5
+        for _, similarity in neighbors:
+            assert 0 < similarity <= 1
+
+
 def test_pagerank(graph: Graph):
     property_name = "NewProp"
 
@@ -208,6 +450,59 @@ def test_pagerank(graph: Graph):
     assert stats.average_rank == approx(0.5215466022491455, abs=0.001)
 
 
+def test_pagerank_pull_blocked():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    tolerance = 1e-6
+    pagerank(graph, "topological", PagerankPlan.pull_topological(tolerance=tolerance, max_iterations=100, alpha=0.8))
+    plan = PagerankPlan.pull_blocked(tolerance=tolerance, max_iterations=100, alpha=0.8)
+    assert plan.algorithm == PagerankPlan.Algorithm.PullBlocked
+    assert plan.tolerance == approx(tolerance)
+    assert plan.max_iterations == 100
+    assert plan.alpha == approx(0.8)
+    pagerank(graph, "blocked", plan)
+
+    pagerank_assert_valid(graph, "blocked")
+    expected = graph.get_node_property("topological").to_numpy()
+    assert graph.get_node_property("blocked").to_numpy() == approx(expected, rel=1e-4, abs=1e-5)
+
+
+def test_personalized_pagerank():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    n = graph.num_nodes()
+    alpha = 0.85
+    tolerance = 1e-6
+    plan = PagerankPlan.push_asynchronous(tolerance=tolerance, alpha=alpha)
+    seeds = [0, 5]
+
+    # the exact ranks by power iteration; walks at nodes without edges return to the seeds
+    ends = graph.adj_indices().astype(np.int64)
+    degrees = np.diff(ends, prepend=0)
+    sources = np.repeat(np.arange(n), degrees)
+    restart = np.zeros(n)
+    restart[seeds] = 1 / len(seeds)
+    exact = restart.copy()
+    for _ in range(300):
+        spread = np.zeros(n)
+        np.add.at(spread, graph.dests(), (exact / np.maximum(degrees, 1))[sources])
+        dangling = exact[degrees == 0].sum()
+        exact = (1 - alpha) * restart + alpha * (spread + dangling * restart)
+
+    top = personalized_pagerank(graph, seeds, 20, plan)
+    assert len(top) == 20
+    ranks = [rank for _, rank in top]
+    assert ranks == sorted(ranks, reverse=True)
+    for node, rank in top:
+        assert rank <= exact[node] + 1e-9
+        assert exact[node] - rank <= tolerance * max(degrees[node], 1) + 1e-9
+
+    seed_sets = [seeds, [7], [3, 9, 11]]
+    batch = personalized_pagerank_batch(graph, seed_sets, 20, plan)
+    assert batch == [personalized_pagerank(graph, s, 20, plan) for s in seed_sets]
+
+    with raises(GaloisError):
+        personalized_pagerank(graph, [n], 20, plan)
+
+
 def test_betweenness_centrality_outer(graph: Graph):
     property_name = "NewProp"
 
@@ -242,6 +537,254 @@ def test_betweenness_centrality_level(graph: Graph):
     assert stats.average_centrality == approx(0.000534295046236366)
 
 
+def test_betweenness_centrality_asynchronous(graph: Graph):
+    property_name = "NewProp"
+
+    plan = BetweennessCentralityPlan.asynchronous(concurrent_sources=3)
+    assert plan.algorithm == BetweennessCentralityPlan.Algorithm.Asynchronous
+    assert plan.concurrent_sources == 3
+
+    betweenness_centrality(graph, property_name, 16, plan)
+
+    node_schema: Schema = graph.loaded_node_schema()
+    num_node_properties = len(node_schema)
+    new_property_id = num_node_properties - 1
+    assert node_schema.names[new_property_id] == property_name
+
+    stats = BetweennessCentralityStatistics(graph, property_name)
+
+    # same as the level algorithm
+    assert stats.min_centrality == 0
+    assert stats.max_centrality == approx(7.0)
+    assert stats.average_centrality == approx(0.000534295046236366)
+
+
+def test_betweenness_centrality_approximate(graph: Graph):
+    property_name = "NewProp"
+
+    plan = BetweennessCentralityPlan.approximate(error_bound=0.05, confidence=0.9)
+    assert plan.algorithm == BetweennessCentralityPlan.Algorithm.Approximate
+    assert plan.error_bound == approx(0.05)
+    assert plan.confidence == approx(0.9)
+
+    betweenness_centrality(graph, property_name, None, plan)
+
+    node_schema: Schema = graph.loaded_node_schema()
+    num_node_properties = len(node_schema)
+    new_property_id = num_node_properties - 1
+    assert node_schema.names[new_property_id] == property_name
+
+    stats = BetweennessCentralityStatistics(graph, property_name)
+
+    assert stats.min_centrality >= 0
+    assert stats.max_centrality > 0
+
+
+def test_closeness_centrality():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    closeness_centrality(graph, "closeness")
+    harmonic_centrality(graph, "harmonic")
+    # a graph with no more nodes than sources gets the exact centralities
+    closeness_centrality(graph, "closeness_all", ClosenessCentralityPlan.sampled(graph.num_nodes(), batch_size=64))
+    plan = ClosenessCentralityPlan.sampled(256, batch_size=512)
+    assert plan.algorithm == ClosenessCentralityPlan.Algorithm.Sampled
+    assert plan.num_sources == 256
+    closeness_centrality(graph, "closeness_sampled", plan)
+    harmonic_centrality(graph, "harmonic_sampled", plan)
+
+    exact = graph.get_node_property("closeness").to_numpy()
+    assert exact == approx(graph.get_node_property("closeness_all").to_numpy())
+    assert (exact >= 0).all() and (exact <= 1).all()
+    sampled = graph.get_node_property("closeness_sampled").to_numpy()
+    assert np.corrcoef(exact, sampled)[0, 1] > 0.9
+
+    stats = ClosenessCentralityStatistics(graph, "harmonic")
+    sampled_stats = ClosenessCentralityStatistics(graph, "harmonic_sampled")
+    assert 0 <= stats.min_centrality <= stats.average_centrality <= stats.max_centrality
+    assert sampled_stats.average_centrality == approx(stats.average_centrality, rel=0.2)
+
+    # the path 0 - 1 - 2
+    path = from_csr(np.array([1, 3, 4]), np.array([1, 0, 2, 1]))
+    closeness_centrality(path, "closeness")
+    harmonic_centrality(path, "harmonic")
+    assert path.get_node_property("closeness").to_numpy() == approx([2 / 3, 1, 2 / 3])
+    assert path.get_node_property("harmonic").to_numpy() == approx([1.5, 2, 1.5])
+
+    with raises(GaloisError):
+        closeness_centrality(graph, "closeness_none", ClosenessCentralityPlan.exact(batch_size=100))
+
+
+def test_estimate_neighborhood_function():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    plan = NeighborhoodFunctionPlan.hyper_anf(10)
+    assert plan.algorithm == NeighborhoodFunctionPlan.Algorithm.HyperAnf
+    assert plan.log2_num_registers == 10
+    estimate = estimate_neighborhood_function(graph, "harmonic_anf", plan)
+    assert isinstance(estimate, NeighborhoodFunctionEstimate)
+    function = np.array(estimate.neighborhood_function)
+    assert function[0] == approx(graph.num_nodes(), rel=0.1)
+    assert (np.diff(function) >= 0).all()
+    assert 0 < estimate.effective_diameter() <= len(function) - 1
+    assert estimate.effective_diameter(0.5) <= estimate.effective_diameter()
+
+    harmonic_centrality(graph, "harmonic")
+    exact = graph.get_node_property("harmonic").to_numpy()
+    estimated = graph.get_node_property("harmonic_anf").to_numpy()
+    assert np.corrcoef(exact, estimated)[0, 1] > 0.9
+    assert estimated.mean() == approx(exact.mean(), rel=0.1)
+
+    # the path 0 - 1 - 2, whose pairs within distance 0, 1 and 2 are 3, 7 and 9
+    path = from_csr(np.array([1, 3, 4]), np.array([1, 0, 2, 1]))
+    estimate = estimate_neighborhood_function(path, "harmonic", plan)
+    assert estimate.neighborhood_function == approx([3, 7, 9], rel=0.05)
+    assert estimate.effective_diameter() == approx(1 + 1.1 / 2, abs=0.1)
+    assert path.get_node_property("harmonic").to_numpy() == approx([1.5, 2, 1.5], rel=0.05)
+
+    with raises(GaloisError):
+        estimate_neighborhood_function(graph, plan=NeighborhoodFunctionPlan.hyper_anf(3))
+
+
+def test_neighbor_sampler():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    graph.add_node_property(table({"feature": np.arange(graph.num_nodes(), dtype=np.float64) * 2}))
+    ends = graph.adj_indices().astype(np.int64)
+    begins = np.concatenate(([0], ends[:-1]))
+    dests = graph.dests()
+
+    fanouts = [5, 3]
+    sampler = NeighborSampler(graph, fanouts, ["feature"])
+    seeds = list(range(0, graph.num_nodes(), 37))
+    batch = sampler.sample(seeds, 7)
+    assert len(batch.blocks) == len(fanouts)
+    dst_nodes = np.array(seeds, dtype=np.uint32)
+    for block, fanout in zip(batch.blocks, fanouts):
+        assert (block.dst_nodes == dst_nodes).all()
+        assert (block.src_nodes[: len(dst_nodes)] == dst_nodes).all()
+        assert len(np.unique(block.src_nodes)) == len(block.src_nodes)
+        assert block.indptr[-1] == block.num_edges()
+        for i, n in enumerate(block.dst_nodes):
+            edges = block.edge_ids[block.indptr[i] : block.indptr[i + 1]]
+            assert len(edges) == min(fanout, ends[n] - begins[n])
+            assert len(np.unique(edges)) == len(edges)
+            assert ((edges >= begins[n]) & (edges < ends[n])).all()
+            assert (block.src_nodes[block.indices[block.indptr[i] : block.indptr[i + 1]]] == dests[edges]).all()
+        dst_nodes = block.src_nodes
+    assert (batch.input_nodes == dst_nodes).all()
+    assert batch.features.column("feature").to_numpy() == approx(batch.input_nodes * 2.0)
+
+    # the same batch index gives the same batch, also when prefetched
+    again = sampler.sample(seeds, 7)
+    assert (again.blocks[-1].edge_ids == batch.blocks[-1].edge_ids).all()
+    batches = list(sampler.batches([seeds, seeds[:10], seeds]))
+    assert len(batches) == 3
+    assert (batches[0].blocks[0].edge_ids == sampler.sample(seeds, 0).blocks[0].edge_ids).all()
+    assert (batches[1].blocks[0].dst_nodes == seeds[:10]).all()
+    assert not sampler.is_prefetching
+
+    # with replacement, every node with neighbors gets fanout of them
+    replace = NeighborSampler(graph, [4], plan=NeighborSamplingPlan.uniform(with_replacement=True))
+    block = replace.sample(seeds).blocks[0]
+    assert (np.diff(block.indptr) == [4 if ends[n] > begins[n] else 0 for n in seeds]).all()
+
+    with raises(GaloisError):
+        sampler.sample([0, 0])
+    with raises(GaloisError):
+        NeighborSampler(graph, [5], ["no_such_property"])
+
+
+def test_time_windowed_graph():
+    # the cycle 0 -> 1 -> 2 -> 3 -> 0 with an edge each hour, and 0 -> 2 without a time
+    graph = from_csr(np.array([2, 3, 4, 5]), np.array([1, 2, 2, 3, 0]))
+    graph.add_edge_property(table({"time": array([0, None, 3600, 7200, 10800], timestamp("s"))}))
+    windowed = TimeWindowedGraph(graph, "time")
+    assert (windowed.min_time, windowed.max_time) == (0, 10800)
+    assert windowed.window == (0, 10801)
+    assert windowed.num_edges() == 4
+    assert windowed.bfs(0).tolist() == [0, 1, 2, 3]
+    assert windowed.connected_components().tolist() == [0, 0, 0, 0]
+    assert windowed.pagerank() == approx([0.25] * 4, abs=1e-3)
+
+    unreachable = TimeWindowedGraph.UNREACHABLE
+    windows = list(windowed.sliding_windows(0, 4 * 3600, 2 * 3600, 3600))
+    assert windows == [(0, 7200), (3600, 10800), (7200, 14400), (10800, 18000)]
+    windowed.set_window(3600, 10800)
+    assert windowed.num_edges() == 2
+    assert windowed.bfs(1).tolist() == [unreachable, 0, 1, 2]
+    assert windowed.connected_components().tolist() == [0, 1, 1, 1]
+    ranks = windowed.pagerank(PagerankPlan.pull_topological(tolerance=1e-9))
+    assert ranks == approx([0.0375, 0.0375, 0.0375 * 1.85, 0.0375 * (1 + 0.85 * 1.85)])
+
+    with raises(GaloisError):
+        windowed.set_window(1, 0)
+    with raises(GaloisError):
+        windowed.bfs(4)
+    with raises(GaloisError):
+        TimeWindowedGraph(graph, "no_such_property")
+
+
+def test_hits():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    hits(graph, "hub", "authority")
+    hits(graph, "hub_blocked", "authority_blocked", HitsPlan.blocked())
+    plan = HitsPlan.push(tolerance=1e-8, max_iterations=200)
+    assert plan.algorithm == HitsPlan.Algorithm.Push
+    assert plan.max_iterations == 200
+    hits(graph, "hub_push", "authority_push", plan)
+
+    hits_assert_valid(graph, "hub", "authority")
+    hits_assert_valid(graph, "hub_push", "authority_push")
+    hub = graph.get_node_property("hub").to_numpy()
+    assert hub == approx(graph.get_node_property("hub_blocked").to_numpy())
+    assert hub == approx(graph.get_node_property("hub_push").to_numpy(), abs=1e-6)
+
+    stats = HitsStatistics(graph, "hub", "authority")
+    assert stats.max_hub_score == approx(hub.max())
+    assert 0 < stats.num_authorities <= graph.num_nodes()
+
+    # the path 0 - 1 - 2
+    path = from_csr(np.array([1, 3, 4]), np.array([1, 0, 2, 1]))
+    hits(path, "hub", "authority")
+    assert path.get_node_property("hub").to_numpy() == approx([1 / 3, 1 / 3, 1 / 3])
+    assert path.get_node_property("authority").to_numpy() == approx([0.25, 0.5, 0.25])
+
+
+def test_eigenvector_centrality():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    eigenvector_centrality(graph, "eigenvector")
+    eigenvector_centrality(graph, "eigenvector_blocked", EigenvectorCentralityPlan.blocked())
+    eigenvector_centrality(graph, "eigenvector_push", EigenvectorCentralityPlan.push())
+    katz_centrality(graph, "katz", KatzCentralityPlan.pull(alpha=0.001))
+    katz_centrality(graph, "katz_push", KatzCentralityPlan.push(alpha=0.001))
+
+    for name in ["eigenvector", "eigenvector_blocked", "eigenvector_push", "katz", "katz_push"]:
+        eigenvector_centrality_assert_valid(graph, name)
+    eigenvector = graph.get_node_property("eigenvector").to_numpy()
+    assert eigenvector == approx(graph.get_node_property("eigenvector_blocked").to_numpy())
+    assert eigenvector == approx(graph.get_node_property("eigenvector_push").to_numpy())
+    katz = graph.get_node_property("katz").to_numpy()
+    assert katz == approx(graph.get_node_property("katz_push").to_numpy())
+    assert np.corrcoef(eigenvector, katz)[0, 1] > 0.5
+
+    stats = EigenvectorCentralityStatistics(graph, "eigenvector")
+    assert 0 <= stats.min_centrality <= stats.average_centrality <= stats.max_centrality
+
+    # the path 0 - 1 - 2
+    path = from_csr(np.array([1, 3, 4]), np.array([1, 0, 2, 1]))
+    eigenvector_centrality(path, "eigenvector", EigenvectorCentralityPlan.pull(tolerance=1e-10))
+    katz_centrality(path, "katz")
+    assert path.get_node_property("eigenvector").to_numpy() == approx([0.5, 2 ** -0.5, 0.5])
+    adjacency = np.array([[0, 1, 0], [1, 0, 1], [0, 1, 0]])
+    expected = np.linalg.solve(np.eye(3) - 0.1 * adjacency, np.ones(3))
+    assert path.get_node_property("katz").to_numpy() == approx(expected / np.linalg.norm(expected))
+
+    with raises(GaloisError):
+        katz_centrality(path, "katz_none", KatzCentralityPlan.pull(alpha=0))
+
+
 def test_triangle_count():
     graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
     original_first_edge_list = [graph.get_edge_dest(e) for e in graph.edges(0)]
@@ -269,6 +812,56 @@ def test_triangle_count_presorted():
     assert n == 282617
 
 
+def test_local_triangle_count():
+    graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    local_triangle_count(graph, "triangles", "support")
+    assert graph.get_node_property("triangles").to_numpy().sum() == 3 * 282617
+    assert graph.get_edge_property("support").to_numpy().sum() == 6 * 282617
+
+    # the triangles 0, 1, 2 and 0, 2, 3 sharing the edge 0 - 2
+    small = from_csr(np.array([3, 5, 8, 10]), np.array([1, 2, 3, 0, 2, 0, 1, 3, 0, 2]))
+    local_triangle_count(small, "triangles", "")
+    assert small.get_node_property("triangles").to_numpy().tolist() == [2, 1, 2, 1]
+    local_triangle_count(small, "", "support")
+    assert small.get_edge_property("support").to_numpy().tolist() == [1, 2, 1, 1, 1, 2, 1, 1, 1, 1]
+
+
+def test_k_clique_count():
+    graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    assert k_clique_count(graph, 1) == graph.num_nodes()
+    assert k_clique_count(graph, 3) == 282617
+    assert k_clique_count(graph, 3, KCliquePlan.color_ordered()) == 282617
+
+    for k in [4, 5]:
+        n = k_clique_count(graph, k)
+        assert n == k_clique_count(graph, k, KCliquePlan.color_ordered())
+        k_clique_count_per_node(graph, k, f"cliques_{k}", KCliquePlan.color_ordered())
+        assert graph.get_node_property(f"cliques_{k}").to_numpy().sum() == k * n
+
+    with raises(GaloisError):
+        k_clique_count(graph, 0)
+
+
+def test_four_node_graphlet_census():
+    graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    census = FourNodeGraphletCensus(graph)
+    assert census.cliques == k_clique_count(graph, 4)
+    four_cycle_count_per_node(graph, "cycles")
+    # every non-induced cycle is an induced cycle or in a diamond or a clique
+    cycles = census.cycles + census.diamonds + 3 * census.cliques
+    assert graph.get_node_property("cycles").to_numpy().sum() == 4 * cycles
+
+    # the 4-clique 0, 1, 2, 3 with the edge 0 - 4
+    small = from_csr(np.array([4, 7, 10, 13, 14]), np.array([1, 2, 3, 4, 0, 2, 3, 0, 1, 3, 0, 1, 2, 0]))
+    census = FourNodeGraphletCensus(small)
+    assert (census.paths, census.stars, census.cycles) == (0, 0, 0)
+    assert (census.tailed_triangles, census.diamonds, census.cliques) == (3, 0, 1)
+    four_cycle_count_per_node(small, "cycles")
+    assert small.get_node_property("cycles").to_numpy().tolist() == [3, 3, 3, 3, 0]
+    k_clique_count_per_node(small, 4, "cliques")
+    assert small.get_node_property("cliques").to_numpy().tolist() == [1, 1, 1, 1, 0]
+
+
 def test_independent_set():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -284,6 +877,25 @@ def test_independent_set():
 
     independent_set_assert_valid(graph, "output2")
 
+    independent_set(graph, "output3", IndependentSetPlan.deterministic_priority())
+    independent_set_assert_valid(graph, "output3")
+    assert IndependentSetStatistics(graph, "output3").cardinality > 0
+
+
+def test_graph_coloring():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    graph_coloring(graph, "output")
+    graph_coloring(graph, "output_jp", GraphColoringPlan.jones_plassmann())
+
+    for name in ["output", "output_jp"]:
+        graph_coloring_assert_valid(graph, name)
+        stats = GraphColoringStatistics(graph, name)
+        assert 1 < stats.num_colors
+        assert 0 < stats.largest_color_class_size < graph.num_nodes()
+        colors = graph.get_node_property(name).to_numpy()
+        assert colors.max() + 1 == stats.num_colors
+
 
 def test_connected_components():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
@@ -300,6 +912,157 @@ def test_connected_components():
     connected_components_assert_valid(graph, "output")
 
 
+def test_incremental_connected_components():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    connected_components(graph, "batch")
+
+    # stream the edges in three batches, the first before the last nodes exist
+    sources = np.searchsorted(graph.adj_indices(), np.arange(graph.num_edges()), side="right")
+    dests = graph.dests()
+    edges = sorted((int(s), int(d)) for s, d in zip(sources, dests))
+    first = [(s, d) for s, d in edges if max(s, d) < 900]
+    rest = [(s, d) for s, d in edges if max(s, d) >= 900]
+
+    incremental = IncrementalConnectedComponents(900)
+    incremental.add_edges(first)
+    incremental.add_nodes(graph.num_nodes() - 900)
+    assert incremental.num_nodes() == graph.num_nodes()
+    incremental.add_edges(rest[: len(rest) // 2])
+    incremental.add_edges(rest[len(rest) // 2 :])
+    incremental.write_components(graph, "incremental")
+
+    connected_components_assert_valid(graph, "incremental")
+    assert incremental.num_components() == ConnectedComponentsStatistics(graph, "batch").total_components
+    batch = graph.get_node_property("batch").to_pylist()
+    streamed = graph.get_node_property("incremental").to_pylist()
+    # the same partition, and each component is named by its smallest node
+    assert len(set(zip(batch, streamed))) == len(set(batch)) == len(set(streamed))
+    assert all(streamed[n] <= n for n in range(graph.num_nodes()))
+    assert [incremental.component(n) for n in range(graph.num_nodes())] == streamed
+
+    from_graph = IncrementalConnectedComponents(graph.num_nodes())
+    from_graph.add_graph(graph)
+    assert from_graph.num_components() == incremental.num_components()
+
+
+def test_out_of_core_topology():
+    path = get_input("propertygraphs/rmat10_symmetric")
+    graph = Graph(path)
+    mapped = Graph(path, out_of_core_topology=True)
+    assert mapped.num_nodes() == graph.num_nodes()
+    assert mapped.num_edges() == graph.num_edges()
+
+    for g in (graph, mapped):
+        bfs(g, 0, "bfs")
+        bfs_assert_valid(g, 0, "bfs")
+        connected_components(g, "cc")
+        pagerank(g, "rank", PagerankPlan.pull_topological())
+
+    assert BfsStatistics(mapped, "bfs").n_reached_nodes == BfsStatistics(graph, "bfs").n_reached_nodes
+    cc = ConnectedComponentsStatistics(mapped, "cc")
+    assert cc.total_components == 69
+    assert cc.largest_component_size == 957
+    rank = PagerankStatistics(mapped, "rank")
+    expected_rank = PagerankStatistics(graph, "rank")
+    assert rank.max_rank == approx(expected_rank.max_rank)
+    assert rank.average_rank == approx(expected_rank.average_rank)
+
+
+def test_result_cache():
+    path = get_input("propertygraphs/rmat10_symmetric")
+    cache = ResultCache()
+
+    graph = Graph(path)
+    connected_components(graph, "output", cache=cache)
+    assert cache.num_misses == 1
+    assert cache.num_entries == 1
+    assert cache.size_bytes > 0
+
+    # the same plan on the same version of the graph reuses the components
+    other = Graph(path)
+    connected_components(other, "output", cache=cache)
+    assert cache.num_hits == 1
+    assert other.get_node_property("output").to_pylist() == graph.get_node_property("output").to_pylist()
+    connected_components_assert_valid(other, "output")
+
+    pagerank(other, "rank", cache=cache)
+    pagerank(other, "rank_again", cache=cache)
+    assert cache.num_hits == 2
+    assert cache.num_entries == 2
+
+    cache.clear()
+    assert cache.num_entries == 0
+    assert cache.size_bytes == 0
+
+
+def test_biconnected_components():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    biconnected_components(graph, "component", "articulation_point")
+    plan = BiconnectedComponentsPlan.serial()
+    assert plan.algorithm == BiconnectedComponentsPlan.Algorithm.Serial
+    biconnected_components(graph, "component_serial", "articulation_point_serial", plan)
+
+    biconnected_components_assert_valid(graph, "component", "articulation_point")
+    component = graph.get_edge_property("component").to_numpy()
+    assert (graph.get_edge_property("component_serial").to_numpy() == component).all()
+    articulation_point = graph.get_node_property("articulation_point").to_numpy()
+    assert (graph.get_node_property("articulation_point_serial").to_numpy() == articulation_point).all()
+
+    stats = BiconnectedComponentsStatistics(graph, "component", "articulation_point")
+    assert stats.num_articulation_points == articulation_point.sum()
+    assert 0 < stats.num_bridges < stats.total_components
+    assert stats.largest_component_edges <= graph.num_edges() // 2
+
+    # the triangles 0, 1, 2 and 2, 3, 4 sharing 2, with the bridge 4 - 5
+    small = from_csr(
+        np.array([2, 4, 8, 10, 13, 14]), np.array([1, 2, 0, 2, 0, 1, 3, 4, 2, 4, 2, 3, 5, 4]),
+    )
+    for name, plan in [("tarjan_vishkin", BiconnectedComponentsPlan.tarjan_vishkin()), ("serial", plan)]:
+        biconnected_components(small, name, name + "_articulation_point", plan)
+        biconnected_components_assert_valid(small, name, name + "_articulation_point")
+        assert small.get_edge_property(name).to_numpy().tolist() == [0] * 6 + [6] * 6 + [12] * 2
+        assert small.get_node_property(name + "_articulation_point").to_numpy().tolist() == [0, 0, 1, 0, 1, 0]
+    stats = BiconnectedComponentsStatistics(small, "serial", "serial_articulation_point")
+    assert stats.total_components == 3
+    assert stats.num_articulation_points == 2
+    assert stats.num_bridges == 1
+    assert stats.largest_component_edges == 3
+
+
+def test_strongly_connected_components():
+    graph = Graph(get_input("propertygraphs/rmat10"))
+
+    strongly_connected_components(graph, "component")
+    strongly_connected_components(graph, "component_coloring", StronglyConnectedComponentsPlan.coloring(0))
+    plan = StronglyConnectedComponentsPlan.multistep(serial_threshold=0)
+    assert plan.algorithm == StronglyConnectedComponentsPlan.Algorithm.Multistep
+    assert plan.serial_threshold == 0
+    strongly_connected_components(graph, "component_multistep", plan)
+    strongly_connected_components(graph, "component_serial", StronglyConnectedComponentsPlan.serial())
+
+    for name in ["component", "component_coloring", "component_multistep", "component_serial"]:
+        strongly_connected_components_assert_valid(graph, name)
+    component = graph.get_node_property("component").to_numpy()
+    for name in ["component_coloring", "component_multistep", "component_serial"]:
+        assert (graph.get_node_property(name).to_numpy() == component).all()
+
+    stats = StronglyConnectedComponentsStatistics(graph, "component")
+    assert stats.total_components == len(np.unique(component))
+    assert stats.largest_component_size == np.bincount(component).max()
+    assert stats.largest_component_ratio == approx(stats.largest_component_size / graph.num_nodes())
+
+    # the cycle 0 -> 1 -> 2 -> 0 with the tail 2 -> 3 and the self loop 4 -> 4
+    small = from_csr(np.array([1, 2, 4, 4, 5]), np.array([1, 2, 0, 3, 4]))
+    strongly_connected_components(small, "component")
+    strongly_connected_components_assert_valid(small, "component")
+    assert small.get_node_property("component").to_numpy().tolist() == [0, 0, 0, 3, 4]
+    stats = StronglyConnectedComponentsStatistics(small, "component")
+    assert stats.total_components == 3
+    assert stats.total_non_trivial_components == 1
+    assert stats.largest_component_size == 3
+
+
 def test_k_core():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -312,6 +1075,32 @@ def test_k_core():
     k_core_assert_valid(graph, 10, "output")
 
 
+def test_k_core_decomposition():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    k_core_decomposition(graph, "core_number")
+
+    core_numbers = graph.get_node_property("core_number").to_numpy()
+    # the 10-core is the nodes with core number at least 10
+    assert np.count_nonzero(core_numbers >= 10) == 438
+
+    stats = KCoreDecompositionStatistics(graph, "core_number")
+    assert stats.max_core_number == core_numbers.max()
+    assert stats.number_of_nodes_in_max_core == np.count_nonzero(core_numbers == core_numbers.max())
+
+
+def test_k_core_batch():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    num_node_properties = len(graph.loaded_node_schema())
+
+    cores = k_core_batch(graph, [1, 10])
+
+    assert cores.column_names == ["1", "10"]
+    assert np.count_nonzero(cores.column("10").to_numpy()) == 438
+    assert len(graph.loaded_node_schema()) == num_node_properties
+
+
 def test_k_truss():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -334,6 +1123,199 @@ def test_k_truss_fail():
         k_truss(graph, 1, "output2")
 
 
+def test_k_truss_decomposition():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    k_truss_decomposition(graph, "trussness")
+
+    trussness = graph.get_edge_property("trussness").to_numpy()
+    # the 10-truss is the edges with trussness at least 10, and both directions
+    # of an edge are in it
+    assert np.count_nonzero(trussness >= 10) == 2 * 13338
+
+    stats = KTrussDecompositionStatistics(graph, "trussness")
+    assert stats.max_trussness == trussness.max()
+
+
+def test_minimum_spanning_forest():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    weights = np.random.default_rng(0).integers(1, 1000, graph.num_edges(), dtype=np.uint32)
+    graph.add_edge_property(table({"weight": weights}))
+
+    minimum_spanning_forest(graph, "weight", "in_msf")
+    minimum_spanning_forest(graph, "weight", "in_msf_kruskal", MinimumSpanningForestPlan.filter_kruskal(64))
+
+    minimum_spanning_forest_assert_valid(graph, "weight", "in_msf")
+    minimum_spanning_forest_assert_valid(graph, "weight", "in_msf_kruskal")
+
+    # ties are broken by edge id, so the forest does not depend on the plan
+    in_msf = graph.get_edge_property("in_msf").to_numpy()
+    assert np.array_equal(in_msf, graph.get_edge_property("in_msf_kruskal").to_numpy())
+
+    stats = MinimumSpanningForestStatistics(graph, "weight", "in_msf")
+    # one tree for each of the connected components
+    assert stats.number_of_trees == 69
+    assert stats.number_of_edges == graph.num_nodes() - 69
+    assert stats.total_weight == weights[in_msf == 1].sum()
+
+
+def test_max_flow():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    capacities = np.random.default_rng(0).integers(0, 100, graph.num_edges(), dtype=np.uint32)
+    graph.add_edge_property(table({"capacity": capacities}))
+    source = 0
+    sink = graph.get_edge_dest(graph.edges(graph.get_edge_dest(graph.edges(source)[0]))[-1])
+
+    max_flow(graph, source, sink, "capacity", "flow")
+    # relabel after every discharge to run many searches beside the pushes
+    max_flow(graph, source, sink, "capacity", "flow_relabeled", MaxFlowPlan.preflow_push(1))
+
+    max_flow_assert_valid(graph, source, sink, "capacity", "flow")
+    max_flow_assert_valid(graph, source, sink, "capacity", "flow_relabeled")
+
+    stats = MaxFlowStatistics(graph, source, "capacity", "flow")
+    assert stats.total_flow == MaxFlowStatistics(graph, source, "capacity", "flow_relabeled").total_flow
+    assert 0 < stats.source_side_size < graph.num_nodes()
+
+    flow = graph.get_edge_property("flow").to_numpy()
+    dests = np.array([graph.get_edge_dest(e) for e in range(graph.num_edges())])
+    assert stats.total_flow == flow[dests == sink].sum() - flow[list(graph.edges(sink))].sum()
+
+
+def test_partition():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    partition(graph, 8, "partition")
+    partition(graph, 8, "partition_loose", PartitionPlan.multilevel(max_imbalance=0.5, refinement_rounds=1))
+
+    partition_assert_valid(graph, 8, "partition")
+    partition_assert_valid(graph, 8, "partition_loose")
+
+    stats = PartitionStatistics(graph, 8, "partition")
+    assert stats.imbalance <= 0.03 + 8 / graph.num_nodes()
+    assert 0 < stats.min_partition_size <= stats.max_partition_size
+    assert PartitionStatistics(graph, 8, "partition_loose").imbalance <= 0.5 + 8 / graph.num_nodes()
+
+    parts = graph.get_node_property("partition").to_numpy()
+    dests = np.array([graph.get_edge_dest(e) for e in range(graph.num_edges())])
+    sources = np.repeat(np.arange(graph.num_nodes()), [len(graph.edges(n)) for n in range(graph.num_nodes())])
+    assert stats.edge_cut == (parts[sources] != parts[dests]).sum()
+    # much better than assigning nodes at random, which cuts 7 / 8 of the edges
+    assert stats.edge_cut < graph.num_edges() * 7 / 8
+
+    with raises(GaloisError):
+        partition(graph, 0, "partition_none")
+
+
+def test_partition_hypergraph():
+    # 2048 hyperedges of 2 to 6 pins, all but one in 10 within one of 8 groups of 128 nodes
+    rng = np.random.default_rng(0)
+    num_hyperedges, num_nodes, num_groups = 2048, 1024, 8
+    group_size = num_nodes // num_groups
+    sizes = rng.integers(2, 7, num_hyperedges)
+    groups = rng.integers(0, num_groups, num_hyperedges)
+    crossing = rng.random(num_hyperedges) < 0.1
+    pins = [
+        rng.integers(0, num_nodes, size) if cross else group * group_size + rng.integers(0, group_size, size)
+        for size, group, cross in zip(sizes, groups, crossing)
+    ]
+    edge_indices = np.concatenate([np.cumsum(sizes), np.full(num_nodes, sizes.sum())])
+    graph = from_csr(edge_indices, np.concatenate(pins) + num_hyperedges)
+
+    partition_hypergraph(graph, num_hyperedges, 8, "partition")
+    partition_assert_valid(graph, 8, "partition")
+
+    stats = HypergraphPartitionStatistics(graph, num_hyperedges, 8, "partition")
+    assert stats.imbalance <= 0.03 + 8 / num_nodes
+    assert 0 < stats.min_partition_size <= stats.max_partition_size
+
+    parts = graph.get_node_property("partition").to_numpy()
+    spans = [len(np.unique(parts[p + num_hyperedges])) for p in pins]
+    assert stats.cut_hyperedges == sum(span > 1 for span in spans)
+    assert stats.connectivity == sum(spans) - num_hyperedges
+    # the groups are found, so about the crossing hyperedges are cut, where
+    # assigning nodes at random cuts nearly all of them
+    assert stats.cut_hyperedges < 2 * crossing.sum()
+
+    with raises(GaloisError):
+        partition_hypergraph(graph, num_hyperedges, 0, "partition_none")
+    with raises(GaloisError):
+        partition_hypergraph(graph, graph.num_nodes() + 1, 8, "partition_none")
+
+
+def test_bipartite_matching():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    left = np.arange(graph.num_nodes()) % 2 == 0
+    graph.add_node_property(table({"left": left}))
+
+    bipartite_matching(graph, "match", left_property="left")
+    bipartite_matching(graph, "match_pr", left_property="left", plan=BipartiteMatchingPlan.push_relabel())
+    # relabel after every discharge
+    bipartite_matching(graph, "match_pr1", left_property="left", plan=BipartiteMatchingPlan.push_relabel(1))
+
+    for name in ["match", "match_pr", "match_pr1"]:
+        bipartite_matching_assert_valid(graph, name, left_property="left")
+
+    stats = BipartiteMatchingStatistics(graph, "match", left_property="left")
+    assert stats.num_left_nodes + stats.num_right_nodes == graph.num_nodes()
+    assert 0 < stats.matching_size <= min(stats.num_left_nodes, stats.num_right_nodes)
+    assert stats.matching_size == BipartiteMatchingStatistics(graph, "match_pr", left_property="left").matching_size
+    assert stats.matching_size == BipartiteMatchingStatistics(graph, "match_pr1", left_property="left").matching_size
+
+    match = graph.get_node_property("match").to_numpy()
+    matched = match != 2 ** 32 - 1
+    assert matched.sum() == 2 * stats.matching_size
+    assert (match[match[matched]] == np.arange(graph.num_nodes())[matched]).all()
+    assert (left[match[matched]] != left[matched]).all()
+
+    # three left nodes which all point to the same two right nodes
+    small = from_csr(np.array([2, 4, 6, 6, 6]), np.array([3, 4, 3, 4, 3, 4]))
+    small.add_node_property(table({"left": np.array([1, 1, 1, 0, 0], dtype=np.uint8)}))
+    bipartite_matching(small, "match", left_property="left")
+    bipartite_matching_assert_valid(small, "match", left_property="left")
+    assert BipartiteMatchingStatistics(small, "match", left_property="left").matching_size == 2
+
+    with raises(ValueError):
+        bipartite_matching(graph, "match_none")
+    with raises(GaloisError):
+        bipartite_matching(graph, "match_none", left_property="no_such_property")
+
+
+def test_matrix_completion():
+    rng = np.random.default_rng(0)
+    num_users, num_items, rank = 300, 200, 4
+    factors = rng.random((num_users + num_items, rank))
+    rated = rng.random((num_users, num_items)) < 0.2
+    users, items = rated.nonzero()
+    ratings = (factors[users] * factors[num_users + items]).sum(axis=1).astype(np.float32)
+    graph = from_csr(
+        np.concatenate([np.cumsum(rated.sum(axis=1)), np.full(num_items, len(users))]), num_users + items
+    )
+    graph.add_edge_property(table({"rating": ratings}))
+
+    matrix_completion(graph, "rating", "sgd")
+    matrix_completion(graph, "rating", "als", MatrixCompletionPlan.als(latent_vector_size=8))
+
+    matrix_completion_assert_valid(graph, "sgd")
+    matrix_completion_assert_valid(graph, "als")
+
+    sgd_stats = MatrixCompletionStatistics(graph, "rating", "sgd")
+    als_stats = MatrixCompletionStatistics(graph, "rating", "als")
+    assert sgd_stats.latent_vector_size == 20
+    assert als_stats.latent_vector_size == 8
+    # both fit much better than the mean rating
+    assert sgd_stats.root_mean_squared_error < ratings.std() / 2
+    assert als_stats.root_mean_squared_error < ratings.std() / 10
+
+    vectors = np.array(graph.get_node_property("als").to_pylist())
+    predictions = (vectors[users] * vectors[num_users + items]).sum(axis=1)
+    assert np.sqrt(((predictions - ratings) ** 2).mean()) == approx(als_stats.root_mean_squared_error, rel=1e-4)
+
+    # a node that both rates and is rated
+    with raises(GaloisError):
+        matrix_completion(Graph(get_input("propertygraphs/rmat10_symmetric")), "value", "vectors")
+
+
 def test_louvain_clustering():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -349,6 +1331,52 @@ def test_louvain_clustering():
     # assert stats.largest_cluster_size == 297
 
 
+def test_louvain_clustering_deterministic():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    plan = LouvainClusteringPlan.deterministic()
+
+    set_active_threads(1)
+    louvain_clustering(graph, "value", "output_1", plan)
+    set_active_threads(8)
+    louvain_clustering(graph, "value", "output_8", plan)
+    louvain_clustering(graph, "value", "output_8_again", plan)
+
+    louvain_clustering_assert_valid(graph, "value", "output_1")
+    expected = graph.get_node_property("output_1").to_pylist()
+    assert graph.get_node_property("output_8").to_pylist() == expected
+    assert graph.get_node_property("output_8_again").to_pylist() == expected
+
+
+def test_louvain_clustering_refinement():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    louvain_clustering(graph, "value", "output", LouvainClusteringPlan.do_all(enable_refinement=True))
+
+    louvain_clustering_assert_valid(graph, "value", "output")
+
+    stats = LouvainClusteringStatistics(graph, "value", "output")
+    assert stats.n_clusters > 0
+
+
+def test_label_propagation():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    label_propagation(graph, "value", "output")
+    label_propagation(graph, "value", "output_sync", LabelPropagationPlan.synchronous())
+    label_propagation(graph, "value", "output_sync2", LabelPropagationPlan.synchronous())
+
+    for name in ["output", "output_sync"]:
+        label_propagation_assert_valid(graph, name)
+        stats = LabelPropagationStatistics(graph, "value", name)
+        assert 0 < stats.n_communities < graph.num_nodes()
+        assert 0 < stats.largest_community_size <= graph.num_nodes()
+        assert -0.5 <= stats.modularity <= 1
+
+    # the synchronous labels do not depend on the schedule
+    sync = graph.get_node_property("output_sync").to_numpy()
+    assert (sync == graph.get_node_property("output_sync2").to_numpy()).all()
+
+
 def test_local_clustering_coefficient():
     graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
 
@@ -380,6 +1408,24 @@ def test_subgraph_extraction():
         assert [pg.get_edge_dest(e) for e in pg.edges(i)] == expected_edges[i]
 
 
+def test_subgraph_extraction_properties():
+    graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    sort_all_edges_by_dest(graph)
+    graph.add_node_property(table({"node_value": np.arange(len(graph), dtype=np.uint32) * 2}))
+    graph.add_edge_property(table({"edge_value": np.arange(graph.num_edges(), dtype=np.uint64)}))
+    nodes = [120, 1, 11, 3]
+
+    pg = subgraph_extraction(graph, nodes, node_properties=["node_value"], edge_properties=["edge_value"])
+
+    assert pg.get_node_property("node_value").to_numpy().tolist() == [2 * n for n in nodes]
+    # the edges of each node are ordered by the position of their destination in nodes
+    expected_edge_values = []
+    for i in nodes:
+        edges = [e for e in graph.edges(i) if graph.get_edge_dest(e) in nodes]
+        expected_edge_values += sorted(edges, key=lambda e: nodes.index(graph.get_edge_dest(e)))
+    assert pg.get_edge_property("edge_value").to_numpy().tolist() == expected_edge_values
+
+
 def test_busy_wait(graph: Graph):
     set_busy_wait()
     property_name = "NewProp"
@@ -401,3 +1447,57 @@ def test_busy_wait(graph: Graph):
     # Verify with numba implementation of verifier as well
     verify_bfs(graph, start_node, new_property_id)
     set_busy_wait(0)
+
+
+def check_random_walks(graph, walks, walk_length):
+    ends = graph.adj_indices()
+    dests = graph.dests()
+    degrees = np.diff(ends, prepend=0)
+    edges = set()
+    for source in range(graph.num_nodes()):
+        begin = ends[source - 1] if source else 0
+        edges.update((source, int(dests[e])) for e in range(begin, ends[source]))
+
+    for i, walk in enumerate(walks):
+        assert walk[0] == i % graph.num_nodes()
+        assert 1 <= len(walk) <= walk_length
+        # a walk only stops early at a node without edges
+        if len(walk) < walk_length:
+            assert degrees[walk[-1]] == 0
+        for source, dest in zip(walk, walk[1:]):
+            assert (source, dest) in edges
+
+
+def test_random_walks():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+    walk_length = 10
+    # biased walks sample their steps from the alias tables
+    plan = RandomWalksPlan.node2vec(walk_length, 2, backward_probability=0.5, forward_probability=2.0)
+    assert plan.algorithm == RandomWalksPlan.Algorithm.Node2Vec
+    assert plan.walk_length == walk_length
+    assert plan.number_of_walks == 2
+
+    walks = random_walks(graph, plan)
+    assert len(walks) == 2 * graph.num_nodes()
+    check_random_walks(graph, walks, walk_length)
+
+    batch_size = 300
+    batched_walks = []
+
+    def collect(nodes, offsets):
+        assert 1 <= len(offsets) - 1 <= batch_size
+        assert offsets[0] == 0
+        assert offsets[-1] == len(nodes)
+        batched_walks.extend(nodes[offsets[i] : offsets[i + 1]].tolist() for i in range(len(offsets) - 1))
+
+    random_walks_in_batches(graph, collect, plan, batch_size)
+    assert len(batched_walks) == len(walks)
+    check_random_walks(graph, batched_walks, walk_length)
+
+    def fail(nodes, offsets):
+        raise ValueError("stop")
+
+    with raises(ValueError):
+        random_walks_in_batches(graph, fail, plan, batch_size)
+    with raises(GaloisError):
+        random_walks_in_batches(graph, collect, plan, 0)
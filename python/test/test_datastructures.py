@@ -64,6 +64,34 @@ def test_InsertBag_parallel(typ):
     assert l == [v for i in range(1000) for v in [i, i]]
 
 
+@pytest.mark.parametrize("typ", types)
+def test_InsertBag_to_numpy(typ):
+    bag = InsertBag[typ]()
+    assert len(bag) == 0
+    assert len(bag.to_numpy()) == 0
+
+    @do_all_operator()
+    def f(bag, i):
+        bag.push(i)
+
+    do_all(range(1000), f(bag), steal=False)
+    assert len(bag) == 1000
+    arr = bag.to_numpy()
+    assert arr.dtype == np.dtype(typ)
+    assert list(arr) == list(bag)
+    assert sorted(arr) == list(range(1000))
+
+
+def test_InsertBag_to_numpy_opaque():
+    dt = np.dtype([("x", np.int8), ("y", np.int8),], align=True)
+    bag = InsertBag[dt]()
+    bag.push((1, 2))
+    bag.push((3, 4))
+    arr = bag.to_numpy()
+    assert arr.dtype == dt
+    assert sorted(zip(arr["x"], arr["y"])) == [(1, 2), (3, 4)]
+
+
 def test_InsertBag_parallel_opaque():
     dt = np.dtype([("x", np.float32), ("y", np.int16),], align=True)
     T = InsertBag[dt]
@@ -0,0 +1,38 @@
+from tempfile import TemporaryDirectory
+
+import pytest
+
+from katana.example_data import get_input
+from katana.local import Graph, futures
+from katana.local.analytics import bfs, bfs_assert_valid
+
+
+def test_submit(graph):
+    future = futures.submit(bfs, graph, 0, "bfs")
+    assert future.result() is None
+    bfs_assert_valid(graph, 0, "bfs")
+
+
+def test_submit_exception(graph):
+    future = futures.submit(graph.remove_node_property, "_mispelled")
+    with pytest.raises(KeyError):
+        future.result()
+
+
+def test_asynchronous(graph):
+    bfs_async = futures.asynchronous(bfs)
+    assert bfs_async.__name__ == bfs.__name__
+    bfs_async(graph, 0, "bfs").result()
+    bfs_assert_valid(graph, 0, "bfs")
+
+
+def test_load_write():
+    graph = futures.load(get_input("propertygraphs/ldbc_003")).result()
+    with TemporaryDirectory() as tmpdir:
+        futures.write(graph, tmpdir).result()
+        assert Graph(tmpdir) == graph
+
+
+def test_shutdown(graph):
+    futures.shutdown()
+    assert futures.submit(graph.num_nodes).result() == graph.num_nodes()
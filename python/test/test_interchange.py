@@ -0,0 +1,61 @@
+import ctypes
+
+import numpy as np
+import pyarrow
+import pytest
+
+from katana.local.import_data import from_csr
+from katana.native_interfacing.interchange import ArrowArray, ArrowStream, DLPackArray, to_dlpack
+
+_get_pointer = ctypes.pythonapi.PyCapsule_GetPointer
+_get_pointer.restype = ctypes.c_void_p
+_get_pointer.argtypes = [ctypes.py_object, ctypes.c_char_p]
+
+
+def _small_graph():
+    pg = from_csr(np.array([2, 3, 3]), np.array([1, 2, 0]))
+    pg.add_node_property(x=pyarrow.array([1, None, 3]), y=pyarrow.array([0.5, 1.5, 2.5]))
+    return pg
+
+
+def test_export_node_properties():
+    stream = _small_graph().export_node_properties("x")
+    capsule = stream.__arrow_c_stream__()
+    reader = pyarrow.RecordBatchReader._import_from_c(_get_pointer(capsule, b"arrow_array_stream"))
+    table = reader.read_all()
+    assert table.column_names == ["x"]
+    assert table.column("x").to_pylist() == [1, None, 3]
+
+
+def test_export_array_shares_memory():
+    array = pyarrow.array([1.0, 2.0, 3.0])
+    schema_capsule, array_capsule = ArrowArray(array).__arrow_c_array__()
+    imported = pyarrow.Array._import_from_c(
+        _get_pointer(array_capsule, b"arrow_array"), _get_pointer(schema_capsule, b"arrow_schema")
+    )
+    assert imported.buffers()[1].address == array.buffers()[1].address
+    assert imported.to_pylist() == [1.0, 2.0, 3.0]
+
+
+def test_unconsumed_capsules_are_released():
+    ArrowStream(pyarrow.chunked_array([[1, 2], [3]])).__arrow_c_stream__()
+    ArrowArray(pyarrow.array([1])).__arrow_c_array__()
+    to_dlpack(np.arange(3))
+
+
+def test_export_topology():
+    if not hasattr(np, "from_dlpack"):
+        pytest.skip("numpy does not import DLPack")
+    pg = _small_graph()
+    adj_indices, dests = pg.export_topology()
+    assert list(np.from_dlpack(adj_indices)) == [2, 3, 3]
+    imported = np.from_dlpack(dests)
+    del pg, dests
+    assert list(imported) == [1, 2, 0]
+
+
+def test_dlpack_rejects_non_contiguous():
+    with pytest.raises(ValueError):
+        to_dlpack(np.arange(6)[::2])
+    with pytest.raises(TypeError):
+        DLPackArray(np.array([True])).__dlpack__()
@@ -263,3 +263,47 @@ def test_closure_memory_management():
     assert w() is not None
     del c
     assert w() is None
+
+
+def _define_cached_operator():
+    @do_all_operator()
+    def f(out, i):
+        out[i] = i * 3
+
+    return f
+
+
+def test_operator_cache(tmp_path, monkeypatch):
+    from katana.native_interfacing.operator_cache import _dispatcher_of
+
+    monkeypatch.setenv("KATANA_NUMBA_CACHE_DIR", str(tmp_path))
+    out = np.zeros(10, dtype=int)
+    do_all(range(10), _define_cached_operator()(out))
+    assert np.allclose(out, np.arange(10) * 3)
+    assert any(tmp_path.glob("*.nbi"))
+
+    # A new definition of the same operator, as in a new process, is loaded from the cache.
+    f = _define_cached_operator()
+    out = np.zeros(10, dtype=int)
+    do_all(range(10), f(out))
+    assert np.allclose(out, np.arange(10) * 3)
+    assert sum(_dispatcher_of(f).stats.cache_hits.values()) == 1
+
+
+def test_operator_cache_precompile(tmp_path, monkeypatch):
+    from katana.native_interfacing import operator_cache
+
+    monkeypatch.setenv("KATANA_NUMBA_CACHE_DIR", str(tmp_path))
+    monkeypatch.setattr(operator_cache, "_registered", [])
+    f = operator_cache.register(_define_cached_operator(), "void(int64[:], int64)")
+    assert operator_cache.precompile() == 1
+    assert any(tmp_path.glob("*.nbi"))
+    assert len(operator_cache._dispatcher_of(f).signatures) == 1
+
+
+def test_operator_cache_disabled(tmp_path, monkeypatch):
+    monkeypatch.setenv("KATANA_NUMBA_CACHE_DIR", str(tmp_path))
+    monkeypatch.setenv("KATANA_NUMBA_CACHE", "0")
+    out = np.zeros(10, dtype=int)
+    do_all(range(10), _define_cached_operator()(out))
+    assert not any(tmp_path.iterdir())
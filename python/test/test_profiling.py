@@ -0,0 +1,43 @@
+import numpy as np
+import pytest
+
+from katana import do_all, do_all_operator, profiling
+
+
+def test_collect_stats(threads_many):
+    @do_all_operator()
+    def f(out, i):
+        out[i] = i
+
+    out = np.zeros(1000)
+
+    with profiling.collect_stats() as profile:
+        do_all(range(1000), f(out), loop_name="profiled")
+    assert profile["profiled", "Iterations"] == 1000
+    assert profile.seconds > 0
+    assert profile.memory_after["rss_bytes"] > 0
+
+    # only the iterations in the block are counted
+    with profiling.collect_stats() as profile:
+        do_all(range(10), f(out), loop_name="profiled")
+    assert profile["profiled", "Iterations"] == 10
+    with pytest.raises(KeyError):
+        profile["profiled", "Missing"]
+
+    df = profile.to_dataframe()
+    assert list(df.columns) == list(profiling.Stat._fields)
+
+
+def test_get_stats():
+    stats = profiling.get_stats()
+    assert all(isinstance(s, profiling.Stat) for s in stats)
+
+
+def test_trace():
+    with profiling.trace("outer", size=3, ratio=0.5, name="x", flag=True) as span:
+        span.log("message", count=1)
+        with profiling.trace("inner"):
+            pass
+    with pytest.raises(ValueError):
+        with profiling.trace("failing"):
+            raise ValueError("failure")
@@ -7,8 +7,14 @@ import pandas
 import pyarrow
 import pytest
 
-from katana import TsubaError, do_all, do_all_operator
-from katana.local import Graph
+from katana import GaloisError, TsubaError, do_all, do_all_operator
+from katana.local import (
+    Graph,
+    attach_shared_graph,
+    publish_shared_graph,
+    remove_unused_shared_graphs,
+    shared_graph_versions,
+)
 from katana.local.import_data import from_csr
 
 
@@ -66,6 +72,64 @@ def test_nodes_count_edges(graph):
     assert graph.num_edges() == total
 
 
+def test_topology_arrays(graph):
+    adj_indices = graph.adj_indices()
+    dests = graph.dests()
+    assert len(adj_indices) == graph.num_nodes()
+    assert len(dests) == graph.num_edges()
+    assert adj_indices[-1] == graph.num_edges()
+    assert list(dests[adj_indices[9] : adj_indices[10]]) == [8015]
+    assert not dests.flags.writeable
+    with pytest.raises(ValueError):
+        dests[0] = 1
+
+
+def test_topology_arrays_outlive_graph():
+    pg = from_csr(np.array([2, 4, 6]), np.array([1, 2, 0, 2, 0, 1]))
+    dests = pg.dests()
+    del pg
+    assert list(dests) == [1, 2, 0, 2, 0, 1]
+    assert pyarrow.array(dests).to_pylist() == [1, 2, 0, 2, 0, 1]
+
+
+def test_shared_graph(graph, monkeypatch):
+    with TemporaryDirectory() as tmpdir:
+        monkeypatch.setenv("KATANA_SHARED_GRAPH_DIR", tmpdir)
+        version = publish_shared_graph(graph, "test")
+        assert shared_graph_versions("test") == [version]
+
+        attached = attach_shared_graph("test")
+        assert attached.num_nodes() == graph.num_nodes()
+        assert attached.num_edges() == graph.num_edges()
+        assert attached.loaded_node_schema() == graph.loaded_node_schema()
+        assert attached.get_node_property("length") == graph.get_node_property("length")
+
+        # the attached version is kept after a newer one is published
+        newer = publish_shared_graph(graph, "test")
+        assert shared_graph_versions("test") == [version, newer]
+        del attached
+        assert remove_unused_shared_graphs("test") == 1
+        assert shared_graph_versions("test") == [newer]
+        with pytest.raises(GaloisError):
+            attach_shared_graph("test", version)
+
+        assert remove_unused_shared_graphs("test", keep_latest=False) == 1
+        assert shared_graph_versions("test") == []
+
+
+def test_shuffled_topology(graph):
+    adj_indices, dests, edge_property_indices = graph.shuffled_topology(transpose=True, edges_sorted_by="dest")
+    assert len(adj_indices) == graph.num_nodes()
+    assert adj_indices[-1] == graph.num_edges()
+    # the transpose of the edge 10 -> 8015 is an edge 8015 -> 10
+    begin = adj_indices[8014]
+    assert 10 in dests[begin : adj_indices[8015]]
+    edge = graph.edges(10)[0]
+    assert edge in edge_property_indices[begin : adj_indices[8015]]
+    with pytest.raises(ValueError):
+        graph.shuffled_topology(edges_sorted_by="color")
+
+
 def test_get_node_property_exception(graph):
     with pytest.raises(KeyError):
         graph.get_node_property("_mispelled")
@@ -132,6 +196,34 @@ def test_upsert_node_property(graph):
     assert graph.get_node_property(prop) == pyarrow.array(range(graph.num_nodes()))
 
 
+def test_node_property_view():
+    pg = from_csr(np.array([1, 2, 3]), np.array([1, 2, 0]))
+    pg.add_node_property(x=pyarrow.array([1.5, None, 3.0]))
+    view = pg.get_node_property_view("x")
+    assert view.values[0] == 1.5 and view.values[2] == 3.0
+    assert [view.is_valid(n) for n in pg] == [True, False, True]
+    assert not view.values.flags.writeable
+
+    @do_all_operator()
+    def double(view, out, n):
+        if view.is_valid(n):
+            out[n] = view.values[n] * 2
+
+    out = np.zeros(3)
+    do_all(range(3), double(view, out))
+    assert list(out) == [3.0, 0.0, 6.0]
+
+
+def test_property_view_of_slice():
+    from katana.native_interfacing.pyarrow import array_view
+
+    view = array_view(pyarrow.array([None, 1, 2, None, 4], type=pyarrow.int32())[1:])
+    assert list(view.values[[0, 1, 3]]) == [1, 2, 4]
+    assert [view.is_null(i) for i in range(4)] == [False, False, True, False]
+    with pytest.raises(TypeError):
+        array_view(pyarrow.array([True, False]))
+
+
 def test_get_edge_property(graph):
     prop1 = graph.get_edge_property(15)
     assert not prop1[10].as_py()
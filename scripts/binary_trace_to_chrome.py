@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+
+"""Convert the files written by katana::BinaryTracer to a Chrome trace.
+
+The output loads in chrome://tracing and in the Perfetto UI
+(https://ui.perfetto.dev). Pass the files of all hosts of a run to get one
+trace with a process per host.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+# Keep in sync with BinaryTraceHeader and BinaryTraceRecord in
+# libsupport/include/katana/BinaryTracer.h
+MAGIC = b"KTRACE\0\0"
+VERSION = 1
+HEADER = struct.Struct("<8sIIIIQ")
+RECORD = struct.Struct("<QQQQIBBH88s")
+
+KIND_START = 1
+KIND_FINISH = 2
+KIND_LOG = 3
+KIND_TAG = 4
+KIND_LOG_TAG = 5
+KIND_DROPPED = 6
+
+VALUE_NONE = 0
+VALUE_INT = 1
+VALUE_UINT = 2
+VALUE_DOUBLE = 3
+VALUE_BOOL = 4
+VALUE_STRING = 5
+
+
+class Record:
+    # pylint: disable=too-many-instance-attributes,too-few-public-methods
+    def __init__(self, fields, epoch_offset_ns):
+        (timestamp_ns, span_id, parent_id, value, thread_id, kind, value_type, text_length, text) = fields
+        self.timestamp_ns = timestamp_ns + epoch_offset_ns
+        self.span_id = span_id
+        self.parent_id = parent_id
+        self.value = value
+        self.thread_id = thread_id
+        self.kind = kind
+        self.value_type = value_type
+        self.text = text[:text_length].decode("utf-8", errors="replace")
+
+    def tag(self):
+        key, _, string_value = self.text.partition("=")
+        if self.value_type == VALUE_INT:
+            return key, struct.unpack("<q", struct.pack("<Q", self.value))[0]
+        if self.value_type == VALUE_UINT:
+            return key, self.value
+        if self.value_type == VALUE_DOUBLE:
+            return key, struct.unpack("<d", struct.pack("<Q", self.value))[0]
+        if self.value_type == VALUE_BOOL:
+            return key, bool(self.value)
+        return key, string_value
+
+
+class Span:
+    # pylint: disable=too-few-public-methods
+    def __init__(self, record, host_id):
+        self.name = record.text
+        self.host_id = host_id
+        self.thread_id = record.thread_id
+        self.start = record.timestamp_ns
+        self.finish = None
+        self.args = {
+            "trace_id": format(record.value, "x"),
+            "span_id": format(record.span_id, "x"),
+        }
+        if record.parent_id != 0:
+            self.args["parent_id"] = format(record.parent_id, "x")
+
+
+def read_trace(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        raise ValueError(f"{path}: too short for a trace header")
+    magic, version, record_size, host_id, _, epoch_offset_ns = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise ValueError(f"{path}: not a binary trace")
+    if version != VERSION or record_size != RECORD.size:
+        raise ValueError(f"{path}: unsupported trace version {version} with records of {record_size} bytes")
+
+    records = []
+    end = len(data) - (len(data) - HEADER.size) % RECORD.size
+    for offset in range(HEADER.size, end, RECORD.size):
+        records.append(Record(RECORD.unpack_from(data, offset), epoch_offset_ns))
+    return host_id, records
+
+
+def convert(paths):
+    # pylint: disable=too-many-branches
+    spans = dict()
+    events = []
+    threads = set()
+
+    for path in paths:
+        host_id, records = read_trace(path)
+        # records of a thread are in order, so log tags follow their log
+        last_log = dict()
+        for record in records:
+            threads.add((host_id, record.thread_id))
+            span_key = (host_id, record.span_id)
+            if record.kind == KIND_START:
+                spans[span_key] = Span(record, host_id)
+            elif record.kind == KIND_FINISH:
+                if span_key in spans:
+                    spans[span_key].finish = record.timestamp_ns
+            elif record.kind == KIND_TAG:
+                if span_key in spans:
+                    key, value = record.tag()
+                    spans[span_key].args[key] = value
+            elif record.kind == KIND_LOG:
+                event = {
+                    "name": record.text,
+                    "ph": "i",
+                    "s": "t",
+                    "ts_ns": record.timestamp_ns,
+                    "pid": host_id,
+                    "tid": record.thread_id,
+                    "args": {"span_id": format(record.span_id, "x")},
+                }
+                events.append(event)
+                last_log[record.thread_id] = event
+            elif record.kind == KIND_LOG_TAG:
+                if record.thread_id in last_log:
+                    key, value = record.tag()
+                    last_log[record.thread_id]["args"][key] = value
+            elif record.kind == KIND_DROPPED:
+                print(
+                    f"warning: host {host_id} thread {record.thread_id} dropped {record.value} records",
+                    file=sys.stderr,
+                )
+                events.append(
+                    {
+                        "name": "dropped records",
+                        "ph": "i",
+                        "s": "t",
+                        "ts_ns": record.timestamp_ns,
+                        "pid": host_id,
+                        "tid": record.thread_id,
+                        "args": {"count": record.value},
+                    }
+                )
+
+    last_ns = max([e["ts_ns"] for e in events] + [s.finish or s.start for s in spans.values()], default=0)
+    for span in spans.values():
+        args = span.args
+        finish = span.finish
+        if finish is None:
+            args["unfinished"] = True
+            finish = last_ns
+        events.append(
+            {
+                "name": span.name,
+                "ph": "X",
+                "ts_ns": span.start,
+                "dur": (finish - span.start) / 1000.0,
+                "pid": span.host_id,
+                "tid": span.thread_id,
+                "args": args,
+            }
+        )
+
+    first_ns = min([e["ts_ns"] for e in events], default=0)
+    for event in events:
+        event["ts"] = (event.pop("ts_ns") - first_ns) / 1000.0
+
+    for host_id in sorted({host for host, _ in threads}):
+        events.append({"name": "process_name", "ph": "M", "pid": host_id, "args": {"name": f"host {host_id}"}})
+    for host_id, thread_id in sorted(threads):
+        events.append(
+            {
+                "name": "thread_name",
+                "ph": "M",
+                "pid": host_id,
+                "tid": thread_id,
+                "args": {"name": f"thread {thread_id}"},
+            }
+        )
+
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("trace", metavar="FILE", nargs="+", help="Binary trace files, e.g., one per host")
+    parser.add_argument("--output", metavar="FILE", help="File to write the Chrome trace to, defaults to stdout")
+    args = parser.parse_args()
+
+    chrome_trace = convert(args.trace)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(chrome_trace, f)
+    else:
+        json.dump(chrome_trace, sys.stdout)
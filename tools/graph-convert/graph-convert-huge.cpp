@@ -18,28 +18,44 @@
  */
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
+#include <functional>
 #include <ios>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <queue>
 #include <random>
 #include <regex>
+#include <string>
+#include <tuple>
 #include <vector>
 
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/mpl/if.hpp>
 
+#include "katana/BitMath.h"
 #include "katana/FileGraph.h"
+#include "katana/Galois.h"
 #include "katana/NUMAArray.h"
 #include "katana/OfflineGraph.h"
+#include "katana/ParallelSTL.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
 #include "llvm/Support/CommandLine.h"
+#include "tsuba/CSRTopology.h"
+#include "tsuba/file.h"
 
 namespace cll = llvm::cl;
 
@@ -54,6 +70,22 @@ static cll::opt<bool> edgesSorted(
     cll::init(false));
 static cll::opt<unsigned long long> numNodes(
     "numNodes", cll::desc("Total number of nodes given."), cll::init(0));
+static cll::opt<bool> externalSort(
+    "externalSort",
+    cll::desc("Sort edges in runs on disk, for edge lists larger than memory. "
+              "The output may be a local file or a tsuba URI."),
+    cll::init(false));
+static cll::opt<unsigned long long> memoryLimit(
+    "memoryLimit",
+    cll::desc("Memory in MB for edges with -externalSort (default 4096)"),
+    cll::init(4096));
+static cll::opt<std::string> tempDir(
+    "tempDir",
+    cll::desc("Local directory for sorted runs with -externalSort (default "
+              "/tmp)"),
+    cll::init("/tmp"));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
 
 union dataTy {
   int64_t ival;
@@ -236,9 +268,346 @@ go_edgesSorted(std::istream& input, uint64_t numNodes) {
   }
 }
 
+/// An edge of an external sort. Edges are sorted by source and then by
+/// destination and data, which fixes the order of the edges of a node.
+struct SortEdge {
+  uint64_t src;
+  uint64_t dst;
+  uint64_t data;
+
+  bool operator<(const SortEdge& o) const {
+    return std::tie(src, dst, data) < std::tie(o.src, o.dst, o.data);
+  }
+  bool operator>(const SortEdge& o) const { return o < *this; }
+};
+
+/// Writes a region of a file sequentially from offset, a buffer at a time
+class RegionWriter {
+  int fd_;
+  uint64_t offset_;
+  std::vector<char> buffer_;
+  size_t size_{0};
+
+public:
+  RegionWriter(int fd, uint64_t offset, size_t buffer_size)
+      : fd_(fd), offset_(offset), buffer_(buffer_size) {}
+
+  void Write(const void* data, size_t len) {
+    if (size_ + len > buffer_.size()) {
+      Flush();
+    }
+    std::memcpy(buffer_.data() + size_, data, len);
+    size_ += len;
+  }
+
+  void Flush() {
+    size_t written = 0;
+    while (written < size_) {
+      ssize_t ret =
+          pwrite(fd_, buffer_.data() + written, size_ - written, offset_);
+      if (ret < 0) {
+        throw "Failed to write output";
+      }
+      written += ret;
+      offset_ += ret;
+    }
+    size_ = 0;
+  }
+};
+
+/// Reads the edges of a sorted run, a buffer at a time
+class RunReader {
+  std::ifstream file_;
+  std::vector<SortEdge> buffer_;
+  size_t size_{0};
+  size_t next_{0};
+
+public:
+  RunReader(const std::string& name, size_t buffer_edges)
+      : file_(name, std::ios_base::in | std::ios_base::binary),
+        buffer_(buffer_edges) {
+    if (!file_) {
+      throw "Failed to open sorted run";
+    }
+  }
+
+  /// \returns false if the run has no more edges
+  bool Next(SortEdge* edge) {
+    if (next_ == size_) {
+      file_.read(
+          reinterpret_cast<char*>(buffer_.data()),
+          buffer_.size() * sizeof(SortEdge));
+      size_ = file_.gcount() / sizeof(SortEdge);
+      next_ = 0;
+      if (size_ == 0) {
+        return false;
+      }
+    }
+    *edge = buffer_[next_++];
+    return true;
+  }
+};
+
+/// Most runs merged at once, which bounds the open files and keeps the read
+/// buffers of the runs large
+constexpr size_t kMaxMergeRuns = 256;
+
+std::string
+NewRunName() {
+  static size_t num_runs = 0;
+  return katana::Uri::JoinPath(
+      tempDir, "graph-convert-huge-" + std::to_string(getpid()) + "-run-" +
+                   std::to_string(num_runs++));
+}
+
+void
+RemoveRuns(const std::vector<std::string>& runs) {
+  for (const auto& run : runs) {
+    std::remove(run.c_str());
+  }
+}
+
+/// Sort the buffered edges and write them as a new run
+void
+WriteRun(std::vector<SortEdge>* edges, std::vector<std::string>* runs) {
+  if (edges->empty()) {
+    return;
+  }
+  katana::ParallelSTL::sort(edges->begin(), edges->end());
+  runs->emplace_back(NewRunName());
+  std::ofstream out(
+      runs->back(),
+      std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  out.write(
+      reinterpret_cast<const char*>(edges->data()),
+      edges->size() * sizeof(SortEdge));
+  if (!out) {
+    throw "Failed to write sorted run";
+  }
+  std::cout << "Wrote run " << runs->size() - 1 << " of " << edges->size()
+            << " edges\n";
+  edges->clear();
+}
+
+/// Call fn on the edges of the sorted runs in order, reading each run into a
+/// buffer of run_edges edges at a time
+template <typename Fn>
+void
+MergeSorted(const std::vector<std::string>& runs, size_t run_edges, Fn fn) {
+  std::vector<std::unique_ptr<RunReader>> readers;
+  using Head = std::pair<SortEdge, size_t>;
+  std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+  for (size_t r = 0; r < runs.size(); ++r) {
+    readers.emplace_back(std::make_unique<RunReader>(runs[r], run_edges));
+    SortEdge edge;
+    if (readers[r]->Next(&edge)) {
+      heads.emplace(edge, r);
+    }
+  }
+
+  while (!heads.empty()) {
+    auto [edge, r] = heads.top();
+    heads.pop();
+    fn(edge);
+    if (readers[r]->Next(&edge)) {
+      heads.emplace(edge, r);
+    }
+  }
+}
+
+/// Merge groups of kMaxMergeRuns runs into longer runs until at most
+/// kMaxMergeRuns are left
+void
+ReduceRuns(std::vector<std::string>* runs, size_t memory) {
+  while (runs->size() > kMaxMergeRuns) {
+    std::vector<std::string> merged;
+    for (size_t begin = 0; begin < runs->size(); begin += kMaxMergeRuns) {
+      std::vector<std::string> group(
+          runs->begin() + begin,
+          runs->begin() + std::min(runs->size(), begin + kMaxMergeRuns));
+      merged.emplace_back(NewRunName());
+      int fd = open(merged.back().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) {
+        throw "Failed to write sorted run";
+      }
+      RegionWriter out(fd, 0, std::max<size_t>(memory / 2, 1 << 20));
+      MergeSorted(
+          group,
+          std::max<size_t>(memory / 2 / sizeof(SortEdge) / group.size(), 1024),
+          [&out](const SortEdge& edge) { out.Write(&edge, sizeof(edge)); });
+      out.Flush();
+      close(fd);
+      RemoveRuns(group);
+    }
+    std::cout << "Merged " << runs->size() << " runs into " << merged.size()
+              << "\n";
+    *runs = std::move(merged);
+  }
+}
+
+/// Merge the sorted runs into a gr file, writing its out indexes,
+/// destinations and edge data sequentially, so only the read buffers of the
+/// runs and the write buffers are in memory
+void
+MergeRuns(
+    const std::vector<std::string>& runs, const std::string& output,
+    const tsuba::CSRTopologyHeader& header, size_t memory) {
+  int fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw "Bad filename";
+  }
+  uint64_t size = tsuba::CSRTopologyFileSize(header);
+  if (ftruncate(fd, size) != 0) {
+    throw "Failed to size output";
+  }
+
+  // half of memory for reading runs, half for writing the output
+  size_t write_buffer = std::max<size_t>(memory / 6, 1 << 20);
+  size_t run_edges = std::max<size_t>(
+      memory / 2 / sizeof(SortEdge) / std::max<size_t>(runs.size(), 1), 1024);
+  uint64_t dst_size = header.version == 1 ? sizeof(uint32_t) : sizeof(uint64_t);
+  uint64_t index_offset = sizeof(header);
+  uint64_t dst_offset = index_offset + header.num_nodes * sizeof(uint64_t);
+  uint64_t data_offset =
+      dst_offset + katana::AlignUp<uint64_t>(header.num_edges * dst_size);
+
+  RegionWriter header_writer(fd, 0, sizeof(header));
+  header_writer.Write(&header, sizeof(header));
+  header_writer.Flush();
+  RegionWriter indexes(fd, index_offset, write_buffer);
+  RegionWriter dsts(fd, dst_offset, write_buffer);
+  RegionWriter data(fd, data_offset, write_buffer);
+
+  uint64_t node = 0;
+  uint64_t num_edges = 0;
+  MergeSorted(runs, run_edges, [&](const SortEdge& edge) {
+    // out indexes are the ends of the edges of each node
+    for (; node < edge.src; ++node) {
+      indexes.Write(&num_edges, sizeof(num_edges));
+    }
+    if (header.version == 1) {
+      uint32_t dst32 = edge.dst;
+      dsts.Write(&dst32, sizeof(dst32));
+    } else {
+      dsts.Write(&edge.dst, sizeof(edge.dst));
+    }
+    data.Write(&edge.data, header.edge_type_size);
+    ++num_edges;
+  });
+  for (; node < header.num_nodes; ++node) {
+    indexes.Write(&num_edges, sizeof(num_edges));
+  }
+
+  indexes.Flush();
+  dsts.Flush();
+  data.Flush();
+  if (close(fd) != 0) {
+    throw "Failed to close output";
+  }
+}
+
+/// Store the local file output at outputFilename. The file is mapped rather
+/// than read so that it is paged in as it is uploaded.
+void
+StoreRemote(const std::string& output, uint64_t size) {
+  int fd = open(output.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw "Failed to open output";
+  }
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    throw "Failed to map output";
+  }
+  auto res = tsuba::FileStore(outputFilename, data, size);
+  munmap(data, size);
+  if (!res) {
+    std::cerr << "Error: storing " << outputFilename << ": " << res.error()
+              << "\n";
+    abort();
+  }
+}
+
+/// Convert an edge list larger than memory: sort memoryLimit of edges at a
+/// time into runs on local disk, then merge the runs into the output. An
+/// output that is not a local file is written locally and then copied to its
+/// URI.
+void
+go_externalSort(std::istream& input) {
+  size_t memory = std::max<size_t>(memoryLimit, 1) << 20;
+  size_t run_edges = std::max<size_t>(memory / sizeof(SortEdge), 1);
+
+  std::vector<SortEdge> edges;
+  edges.reserve(std::min<size_t>(run_edges, 1 << 20));
+  std::vector<std::string> runs;
+  uint64_t num_nodes = numNodes;
+  uint64_t num_edges = 0;
+
+  try {
+    perEdge(
+        input,
+        [&](uint64_t src, uint64_t dst, dataTy data) {
+          SortEdge edge{src, dst, 0};
+          if (useSmallData) {
+            std::memcpy(&edge.data, &data.i32val, sizeof(data.i32val));
+          } else {
+            std::memcpy(&edge.data, &data.ival, sizeof(data.ival));
+          }
+          edges.emplace_back(edge);
+          num_nodes = std::max(num_nodes, std::max(src, dst) + 1);
+          ++num_edges;
+          if (edges.size() == run_edges) {
+            WriteRun(&edges, &runs);
+          }
+        },
+        [&num_nodes](uint64_t nodes, uint64_t) {
+          num_nodes = std::max<uint64_t>(num_nodes, nodes);
+        });
+    WriteRun(&edges, &runs);
+    edges = std::vector<SortEdge>();
+
+    tsuba::CSRTopologyHeader header;
+    // nodes are greater than 2^32 so need version 2
+    header.version = num_nodes >= (uint64_t{1} << 32) ? 2 : 1;
+    header.edge_type_size = useSmallData ? sizeof(uint32_t) : sizeof(uint64_t);
+    header.num_nodes = num_nodes;
+    header.num_edges = num_edges;
+    std::cout << " NUM NODES : " << num_nodes << " NUM EDGES : " << num_edges
+              << " USING VERSION : " << header.version << "\n";
+
+    auto uri_res = katana::Uri::Make(outputFilename);
+    if (!uri_res) {
+      std::cerr << "Error: bad output " << outputFilename << ": "
+                << uri_res.error() << "\n";
+      abort();
+    }
+    bool local = uri_res.value().scheme() == katana::Uri::kFileScheme;
+    std::string output =
+        local ? uri_res.value().path()
+              : katana::Uri::JoinPath(
+                    tempDir, "graph-convert-huge-" + std::to_string(getpid()) +
+                                 ".gr");
+
+    ReduceRuns(&runs, memory);
+    MergeRuns(runs, output, header, memory);
+    RemoveRuns(runs);
+
+    if (!local) {
+      StoreRemote(output, tsuba::CSRTopologyFileSize(header));
+      std::remove(output.c_str());
+    }
+  } catch (const char* c) {
+    RemoveRuns(runs);
+    std::cerr << "Failed with: " << c << "\n";
+    abort();
+  }
+}
+
 int
 main(int argc, char** argv) {
+  katana::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(numThreads);
   std::cout << "Data will be " << (useSmallData ? 4 : 8) << " Bytes\n";
 
   std::ifstream infile(inputFilename, std::ios_base::in);
@@ -247,7 +616,9 @@ main(int argc, char** argv) {
     return 1;
   }
 
-  if (numNodes > 0 && edgesSorted) {
+  if (externalSort) {
+    go_externalSort(infile);
+  } else if (numNodes > 0 && edgesSorted) {
     go_edgesSorted(infile, numNodes);
   } else {
     go(infile);
@@ -18,14 +18,20 @@
  */
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <random>
 #include <string>
 #include <vector>
@@ -37,6 +43,7 @@
 #include "katana/FileGraph.h"
 #include "katana/Galois.h"
 #include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
 #include "katana/Strings.h"
 #include "tsuba/CSRTopology.h"
 #include "tsuba/Errors.h"
@@ -48,8 +55,11 @@ enum ConvertMode {
   bipartitegr2littlepetsc,
   bipartitegr2sorteddegreegr,
   dimacs2gr,
+  dimacs2rdg,
   edgelist2gr,
+  edgelist2rdg,
   csv2gr,
+  csv2rdg,
   gr2biggr,
   gr2binarypbbs32,
   gr2binarypbbs64,
@@ -85,6 +95,7 @@ enum ConvertMode {
   gr2neo4j,
   gr2kg,
   mtx2gr,
+  mtx2rdg,
   nodelist2gr,
   pbbs2gr,
   svmlight2gr,
@@ -136,8 +147,11 @@ static cll::opt<ConvertMode> convertMode(
             bipartitegr2sorteddegreegr,
             "Sort nodes of bipartite binary gr by degree"),
         clEnumVal(dimacs2gr, "Convert dimacs to binary gr"),
+        clEnumVal(dimacs2rdg, "Convert dimacs to an RDG in parallel"),
         clEnumVal(edgelist2gr, "Convert edge list to binary gr"),
+        clEnumVal(edgelist2rdg, "Convert edge list to an RDG in parallel"),
         clEnumVal(csv2gr, "Convert csv to binary gr"),
+        clEnumVal(csv2rdg, "Convert csv to an RDG in parallel"),
         clEnumVal(
             gr2biggr,
             "Convert binary gr with little-endian edge data to "
@@ -202,6 +216,8 @@ static cll::opt<ConvertMode> convertMode(
         clEnumVal(
             gr2kg, "Convert binary gr to a property graph for katana graph"),
         clEnumVal(mtx2gr, "Convert matrix market format to binary gr"),
+        clEnumVal(
+            mtx2rdg, "Convert matrix market format to an RDG in parallel"),
         clEnumVal(nodelist2gr, "Convert node list to binary gr"),
         clEnumVal(pbbs2gr, "Convert pbbs graph to binary gr"),
         clEnumVal(svmlight2gr, "Convert svmlight file to binary gr"),
@@ -226,6 +242,9 @@ static cll::opt<int> minValue(
     cll::init(1));
 static cll::opt<size_t> maxDegree(
     "maxDegree", cll::desc("maximum degree to keep"), cll::init(2 * 1024));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads for *2rdg conversions (default value 1)"),
+    cll::init(1));
 
 struct Conversion {};
 struct HasOnlyVoidSpecialization {};
@@ -3002,6 +3021,449 @@ struct Gr2Kg : public Conversion {
   }
 };
 
+/**
+ * How the *2rdg conversions parse a text file of edges, one per line:
+ *
+ * [header lines]
+ * [prefix] src [delim] dst [[delim] weight]
+ * ...
+ */
+struct TextEdgeFormat {
+  /// lines that start with this character are skipped
+  char comment{'\0'};
+  std::optional<char> delim;
+  bool skipFirstLine{false};
+  /// the first line that is not a comment holds the number of nodes: the
+  /// second to last token if it starts with 'p' (dimacs) and the first
+  /// otherwise (matrix market)
+  bool hasHeader{false};
+  /// edge lines start with this token, other lines are skipped
+  std::string edgePrefix;
+  bool oneIndexed{false};
+  /// edges without a weight have weight 1 instead of being skipped
+  bool optionalWeight{false};
+};
+
+/**
+ * The edges parsed from a range of lines, in order
+ */
+template <typename EdgeTy>
+struct ParsedEdges {
+  using edge_value_type = typename katana::NUMAArray<EdgeTy>::value_type;
+
+  std::vector<uint64_t> srcs;
+  std::vector<uint64_t> dsts;
+  std::vector<edge_value_type> weights;
+  uint64_t maxID{0};
+  std::optional<uint64_t> skippedOffset;
+};
+
+template <typename T>
+bool
+parseNumber(const char*& ptr, T* value) {
+  char* end;
+  if constexpr (std::is_floating_point<T>::value) {
+    *value = static_cast<T>(std::strtod(ptr, &end));
+  } else if constexpr (std::is_signed<T>::value) {
+    *value = static_cast<T>(std::strtoll(ptr, &end, 10));
+  } else {
+    if (*ptr == '-') {
+      return false;
+    }
+    *value = static_cast<T>(std::strtoull(ptr, &end, 10));
+  }
+  if (end == ptr) {
+    return false;
+  }
+  ptr = end;
+  return true;
+}
+
+bool
+parseDelim(const char*& ptr, const TextEdgeFormat& format) {
+  if (!format.delim) {
+    return true;
+  }
+  while (*ptr == ' ' || *ptr == '\t') {
+    ++ptr;
+  }
+  if (*ptr != *format.delim) {
+    return false;
+  }
+  ++ptr;
+  return true;
+}
+
+/**
+ * Parse the edge on line, if it has one, into edges
+ */
+template <typename EdgeTy>
+bool
+parseEdgeLine(
+    const std::string& line, const TextEdgeFormat& format,
+    ParsedEdges<EdgeTy>* edges) {
+  using edge_value_type = typename ParsedEdges<EdgeTy>::edge_value_type;
+
+  const char* ptr = line.c_str();
+  while (*ptr == ' ' || *ptr == '\t') {
+    ++ptr;
+  }
+  if (*ptr == '\0' || *ptr == '\r' ||
+      (format.comment != '\0' && *ptr == format.comment)) {
+    return true;
+  }
+  if (!format.edgePrefix.empty()) {
+    if (line.compare(
+            ptr - line.c_str(), format.edgePrefix.size(), format.edgePrefix) !=
+        0) {
+      return true;
+    }
+    ptr += format.edgePrefix.size();
+  }
+
+  uint64_t src;
+  uint64_t dst;
+  if (!parseNumber(ptr, &src) || !parseDelim(ptr, format) ||
+      !parseNumber(ptr, &dst)) {
+    return false;
+  }
+  edge_value_type weight{};
+  if constexpr (!std::is_same<EdgeTy, void>::value) {
+    const char* valuePtr = ptr;
+    if (!parseDelim(valuePtr, format) || !parseNumber(valuePtr, &weight)) {
+      if (!format.optionalWeight) {
+        return false;
+      }
+      weight = 1;
+    }
+  }
+  if (format.oneIndexed) {
+    if (src == 0 || dst == 0) {
+      KATANA_DIE("node ids start at 1: ", line);
+    }
+    --src;
+    --dst;
+  }
+
+  edges->srcs.emplace_back(src);
+  edges->dsts.emplace_back(dst);
+  if constexpr (!std::is_same<EdgeTy, void>::value) {
+    edges->weights.emplace_back(weight);
+  }
+  edges->maxID = std::max(edges->maxID, std::max(src, dst));
+  return true;
+}
+
+/**
+ * A read-only mapping of a local file
+ */
+class MappedFile {
+public:
+  explicit MappedFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      KATANA_DIE("failed to open ", filename);
+    }
+    struct stat buf;
+    if (fstat(fd, &buf) != 0) {
+      KATANA_DIE("failed to stat ", filename);
+    }
+    size_ = buf.st_size;
+    if (size_ > 0) {
+      void* ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (ptr == MAP_FAILED) {
+        KATANA_DIE("failed to map ", filename);
+      }
+      data_ = static_cast<const char*>(ptr);
+    }
+    close(fd);
+  }
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* data() const { return data_; }
+  uint64_t size() const { return size_; }
+
+  /// The offset of the line after the one that contains offset
+  uint64_t nextLine(uint64_t offset) const {
+    const void* newline = offset < size_
+                              ? memchr(data_ + offset, '\n', size_ - offset)
+                              : nullptr;
+    return newline ? static_cast<const char*>(newline) - data_ + 1 : size_;
+  }
+
+private:
+  const char* data_{nullptr};
+  uint64_t size_{0};
+};
+
+/**
+ * Read the header of file: skip the first line or the comments before the
+ * header if format says so.
+ *
+ * @returns the offset of the first edge line and, if the header has it, the
+ * number of nodes
+ */
+std::pair<uint64_t, std::optional<uint64_t>>
+readTextHeader(const MappedFile& file, const TextEdgeFormat& format) {
+  uint64_t offset = 0;
+  if (format.skipFirstLine) {
+    katana::gWarn(
+        "first line is assumed to contain labels and will be ignored\n");
+    offset = file.nextLine(0);
+  }
+  if (!format.hasHeader) {
+    return std::make_pair(offset, std::nullopt);
+  }
+
+  for (; offset < file.size(); offset = file.nextLine(offset)) {
+    char first = file.data()[offset];
+    if (first == '\n' || first == format.comment ||
+        (first != 'p' && !format.edgePrefix.empty())) {
+      continue;
+    }
+    uint64_t end = file.nextLine(offset);
+    std::istringstream line(
+        std::string(file.data() + offset, file.data() + end));
+    std::vector<std::string> tokens;
+    for (std::string token; line >> token;) {
+      tokens.emplace_back(token);
+    }
+    bool isDimacs = first == 'p';
+    if (tokens.size() < 3) {
+      KATANA_DIE("unknown problem specification line: ", line.str());
+    }
+    uint64_t numNodes = strtoull(
+        tokens[isDimacs ? tokens.size() - 2 : 0].c_str(), nullptr, 0);
+    return std::make_pair(end, numNodes);
+  }
+  KATANA_DIE("no problem specification line");
+}
+
+/**
+ * Convert a text file of edges to an RDG with an edge property "value" of
+ * the weights, if EdgeTy is not void.
+ *
+ * Threads parse ranges of lines of the mapped file in parallel. The CSR is
+ * then built in parallel by counting degrees, placing each edge with an
+ * atomic cursor of its source and sorting the edges of each node back into
+ * the order of the file, so the result matches the *2gr conversions'.
+ */
+template <typename EdgeTy>
+void
+convertTextToRDG(
+    const std::string& infilename, const std::string& outfilename,
+    const TextEdgeFormat& format) {
+  using Edges = ParsedEdges<EdgeTy>;
+  using edge_value_type = typename Edges::edge_value_type;
+  constexpr bool kHasValue = !std::is_same<EdgeTy, void>::value;
+  // ranges of lines parsed by a task
+  constexpr uint64_t kRangesPerThread = 4;
+
+  MappedFile file(infilename);
+  auto [begin, headerNodes] = readTextHeader(file, format);
+
+  // split at line boundaries
+  uint64_t numRanges = katana::getActiveThreads() * kRangesPerThread;
+  std::vector<uint64_t> bounds{begin};
+  for (uint64_t i = 1; i < numRanges; ++i) {
+    uint64_t offset = begin + (file.size() - begin) * i / numRanges;
+    bounds.emplace_back(
+        std::max(bounds.back(), offset == 0 ? 0 : file.nextLine(offset - 1)));
+  }
+  bounds.emplace_back(file.size());
+
+  std::vector<Edges> ranges(numRanges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, numRanges),
+      [&](uint64_t r) {
+        Edges& edges = ranges[r];
+        std::string line;
+        for (uint64_t offset = bounds[r]; offset < bounds[r + 1];) {
+          uint64_t end = file.nextLine(offset);
+          line.assign(file.data() + offset, file.data() + end);
+          if (!parseEdgeLine<EdgeTy>(line, format, &edges) &&
+              !edges.skippedOffset) {
+            edges.skippedOffset = offset;
+          }
+          offset = end;
+        }
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+  std::vector<uint64_t> rangeOffsets(numRanges + 1, 0);
+  uint64_t maxID = 0;
+  for (uint64_t r = 0; r < numRanges; ++r) {
+    rangeOffsets[r + 1] = rangeOffsets[r] + ranges[r].srcs.size();
+    maxID = std::max(maxID, ranges[r].maxID);
+    if (ranges[r].skippedOffset) {
+      katana::gWarn(
+          "ignored at least one line (at byte ", *ranges[r].skippedOffset,
+          ") because it did not match the expected format\n");
+    }
+  }
+  uint64_t numEdges = rangeOffsets[numRanges];
+  uint64_t numNodes = headerNodes ? *headerNodes : (numEdges ? maxID + 1 : 0);
+  if (numEdges > 0 && maxID >= numNodes) {
+    KATANA_DIE("node id out of range: ", maxID + format.oneIndexed);
+  }
+  if (numNodes > std::numeric_limits<uint32_t>::max()) {
+    KATANA_DIE("too many nodes: ", numNodes);
+  }
+
+  // the source of each edge, in the order of the file
+  katana::NUMAArray<uint32_t> srcs;
+  srcs.allocateInterleaved(numEdges);
+  katana::NUMAArray<uint32_t> fileDests;
+  fileDests.allocateInterleaved(numEdges);
+  katana::NUMAArray<EdgeTy> fileWeights;
+  if (kHasValue) {
+    fileWeights.allocateInterleaved(numEdges);
+  }
+  katana::do_all(
+      katana::iterate(uint64_t{0}, numRanges),
+      [&](uint64_t r) {
+        Edges& edges = ranges[r];
+        uint64_t first = rangeOffsets[r];
+        for (uint64_t i = 0; i < edges.srcs.size(); ++i) {
+          srcs[first + i] = edges.srcs[i];
+          fileDests[first + i] = edges.dsts[i];
+          if constexpr (kHasValue) {
+            fileWeights.set(first + i, edges.weights[i]);
+          }
+        }
+        edges = Edges();
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+  std::vector<std::atomic<uint64_t>> cursor(numNodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, numEdges),
+      [&](uint64_t e) {
+        cursor[srcs[e]].fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  katana::NUMAArray<uint64_t> outIndices;
+  outIndices.allocateInterleaved(numNodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, numNodes),
+      [&](uint64_t n) {
+        outIndices[n] = cursor[n].load(std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      outIndices.begin(), outIndices.end(), outIndices.begin());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, numNodes),
+      [&](uint64_t n) {
+        cursor[n].store(
+            n == 0 ? 0 : outIndices[n - 1], std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  // the file position of each edge of the CSR
+  katana::NUMAArray<uint64_t> positions;
+  positions.allocateInterleaved(numEdges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, numEdges),
+      [&](uint64_t e) {
+        positions[cursor[srcs[e]].fetch_add(1, std::memory_order_relaxed)] = e;
+      },
+      katana::no_stats());
+  srcs.destroy();
+  srcs.deallocate();
+
+  katana::NUMAArray<uint32_t> outDests;
+  outDests.allocateInterleaved(numEdges);
+  katana::NUMAArray<EdgeTy> outWeights;
+  if (kHasValue) {
+    outWeights.allocateInterleaved(numEdges);
+  }
+  katana::do_all(
+      katana::iterate(uint64_t{0}, numNodes),
+      [&](uint64_t n) {
+        uint64_t first = n == 0 ? 0 : outIndices[n - 1];
+        uint64_t last = outIndices[n];
+        std::sort(positions.begin() + first, positions.begin() + last);
+        for (uint64_t e = first; e < last; ++e) {
+          outDests[e] = fileDests[positions[e]];
+          if constexpr (kHasValue) {
+            outWeights.set(
+                e, static_cast<edge_value_type>(fileWeights[positions[e]]));
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::GraphTopology topo{std::move(outIndices), std::move(outDests)};
+  auto pgResult = katana::PropertyGraph::Make(std::move(topo));
+  if (!pgResult) {
+    KATANA_LOG_FATAL("Failed to create PropertyGraph: {}", pgResult.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pgResult.value());
+  if (kHasValue) {
+    if (auto r = AppendEdgeData<EdgeTy>(pg.get(), outWeights); !r) {
+      KATANA_LOG_FATAL("could not add edge property: {}", r.error());
+    }
+  }
+  if (auto r = pg->Write(outfilename, kCommandLine); !r) {
+    KATANA_LOG_FATAL("Failed to write property file graph: {}", r.error());
+  }
+  printStatus(numNodes, numEdges);
+}
+
+struct Edgelist2Rdg : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    convertTextToRDG<EdgeTy>(infilename, outfilename, TextEdgeFormat());
+  }
+};
+
+struct CSV2Rdg : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    TextEdgeFormat format;
+    format.delim = ',';
+    format.skipFirstLine = true;
+    convertTextToRDG<EdgeTy>(infilename, outfilename, format);
+  }
+};
+
+/**
+ * Like Dimacs2Gr, but a void edge type drops the weights
+ */
+struct Dimacs2Rdg : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    TextEdgeFormat format;
+    format.comment = 'c';
+    format.hasHeader = true;
+    format.edgePrefix = "a";
+    format.oneIndexed = true;
+    convertTextToRDG<EdgeTy>(infilename, outfilename, format);
+  }
+};
+
+/**
+ * Like Mtx2Gr, but a void edge type drops the weights
+ */
+struct Mtx2Rdg : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    TextEdgeFormat format;
+    format.comment = '%';
+    format.hasHeader = true;
+    format.oneIndexed = true;
+    format.optionalWeight = true;
+    convertTextToRDG<EdgeTy>(infilename, outfilename, format);
+  }
+};
+
 /**
  * METIS format (1-indexed). See METIS 4.10 manual, section 4.5.
  *  % comment prefix
@@ -3262,6 +3724,7 @@ main(int argc, char** argv) {
       "Converter for old graphs to gr formats for galois\n\n"
       "  For converting property graphs use graph-properties-convert\n");
   std::ios_base::sync_with_stdio(false);
+  katana::setActiveThreads(numThreads);
   switch (convertMode) {
   case bipartitegr2bigpetsc:
     convert<Bipartitegr2Petsc<double, false>>();
@@ -3275,12 +3738,21 @@ main(int argc, char** argv) {
   case dimacs2gr:
     convert<Dimacs2Gr>();
     break;
+  case dimacs2rdg:
+    convert<Dimacs2Rdg>();
+    break;
   case edgelist2gr:
     convert<Edgelist2Gr>();
     break;
+  case edgelist2rdg:
+    convert<Edgelist2Rdg>();
+    break;
   case csv2gr:
     convert<CSV2Gr>();
     break;
+  case csv2rdg:
+    convert<CSV2Rdg>();
+    break;
   case gr2biggr:
     convert<ToBigEndian>();
     break;
@@ -3386,6 +3858,9 @@ main(int argc, char** argv) {
   case mtx2gr:
     convert<Mtx2Gr>();
     break;
+  case mtx2rdg:
+    convert<Mtx2Rdg>();
+    break;
   case nodelist2gr:
     convert<Nodelist2Gr>();
     break;
@@ -8,7 +8,9 @@
 #include "katana/GraphML.h"
 #include "katana/GraphMLSchema.h"
 #include "katana/Logging.h"
+#include "katana/TableImport.h"
 #include "katana/Timer.h"
+#include "katana/URI.h"
 #include "katana/config.h"
 #include "tsuba/RDG.h"
 
@@ -36,7 +38,11 @@ cll::opt<katana::SourceType> type(
             "source file is of type GraphML"),
         clEnumValN(
             katana::SourceType::kKatana, "katana",
-            "source file is of type Katana")),
+            "source file is of type Katana"),
+        clEnumValN(
+            katana::SourceType::kTables, "tables",
+            "source directory has nodes/ and edges/ directories of CSV or "
+            "Parquet tables")),
     cll::init(katana::SourceType::kGraphml));
 cll::opt<katana::SourceDatabase> database(
     cll::desc("Database the data is from:"),
@@ -56,6 +62,28 @@ cll::opt<int> chunk_size(
               "it can be decreased to improve memory usage when "
               "converting large inputs"),
     cll::init(25000));
+cll::opt<bool> parallel(
+    "parallel",
+    cll::desc("Parse GraphML inputs with all threads, a window of the file at "
+              "a time, or scan MongoDB collections or MySQL tables with all "
+              "threads"),
+    cll::init(false));
+cll::opt<int> window_size(
+    "window-size",
+    cll::desc("Number of bytes of a GraphML input parsed at a time with "
+              "-parallel"),
+    cll::init(64 << 20));
+cll::opt<int> num_threads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
+cll::opt<std::string> id_column(
+    "id-column", cll::desc("Column of node tables with node IDs"),
+    cll::init("id"));
+cll::opt<std::string> source_column(
+    "source-column", cll::desc("Column of edge tables with source node IDs"),
+    cll::init("source"));
+cll::opt<std::string> target_column(
+    "target-column", cll::desc("Column of edge tables with target node IDs"),
+    cll::init("target"));
 cll::opt<std::string> mapping(
     "mapping",
     cll::desc("File in graphml format with a schema mapping for the database"),
@@ -90,6 +118,28 @@ cll::opt<bool> export_graphml(
               "The file is created at the output destination specified\n"),
     cll::init(false));
 
+katana::Result<katana::GraphComponents>
+ConvertGraphML() {
+  if (parallel) {
+    return katana::ConvertGraphMLParallel(
+        input_filename, window_size, chunk_size, true);
+  }
+  return katana::ConvertGraphML(input_filename, chunk_size, true);
+}
+
+katana::Result<katana::GraphComponents>
+ConvertTables() {
+  auto node_tables = KATANA_CHECKED(katana::ListTableSources(
+      katana::Uri::JoinPath(input_filename, "nodes")));
+  auto edge_tables = KATANA_CHECKED(katana::ListTableSources(
+      katana::Uri::JoinPath(input_filename, "edges")));
+  katana::TableImportOptions options;
+  options.id_column = id_column;
+  options.source_column = source_column;
+  options.target_column = target_column;
+  return katana::ConvertTables(node_tables, edge_tables, options, true);
+}
+
 std::unique_ptr<katana::PropertyGraph>
 ConvertKatana(const std::string& rdg_file) {
   auto result = katana::PropertyGraph::Make(rdg_file, tsuba::RDGLoadOptions());
@@ -138,8 +188,19 @@ void
 ParseWild() {
   switch (type) {
   case katana::SourceType::kGraphml: {
-    auto components_result =
-        katana::ConvertGraphML(input_filename, chunk_size, true);
+    auto components_result = ConvertGraphML();
+    if (!components_result) {
+      KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
+    }
+    if (auto r = katana::WritePropertyGraph(
+            std::move(components_result.value()), output_directory);
+        !r) {
+      KATANA_LOG_FATAL("Failed to convert property graph: {}", r.error());
+    }
+    return;
+  }
+  case katana::SourceType::kTables: {
+    auto components_result = ConvertTables();
     if (!components_result) {
       KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
     }
@@ -166,8 +227,7 @@ void
 ParseNeo4j() {
   switch (type) {
   case katana::SourceType::kGraphml: {
-    auto components_result =
-        katana::ConvertGraphML(input_filename, chunk_size, true);
+    auto components_result = ConvertGraphML();
     if (!components_result) {
       KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
     }
@@ -189,9 +249,12 @@ ParseMongoDB() {
   if (generate_mapping) {
     katana::GenerateMappingMongoDB(input_filename, output_directory);
   } else {
-    if (auto r = katana::WritePropertyGraph(
-            katana::ConvertMongoDB(input_filename, mapping, chunk_size),
-            output_directory);
+    auto components =
+        parallel ? katana::ConvertMongoDBParallel(
+                       input_filename, mapping, chunk_size)
+                 : katana::ConvertMongoDB(input_filename, mapping, chunk_size);
+    if (auto r =
+            katana::WritePropertyGraph(std::move(components), output_directory);
         !r) {
       KATANA_LOG_FATAL("Failed to write property graph: {}", r.error());
     }
@@ -207,10 +270,13 @@ ParseMysql() {
   if (generate_mapping) {
     katana::GenerateMappingMysql(input_filename, output_directory, host, user);
   } else {
-    if (auto r = katana::WritePropertyGraph(
-            katana::ConvertMysql(
-                input_filename, mapping, chunk_size, host, user),
-            output_directory);
+    auto components =
+        parallel ? katana::ConvertMysqlParallel(
+                       input_filename, mapping, chunk_size, host, user)
+                 : katana::ConvertMysql(
+                       input_filename, mapping, chunk_size, host, user);
+    if (auto r =
+            katana::WritePropertyGraph(std::move(components), output_directory);
         !r) {
       KATANA_LOG_FATAL("Failed to write property graph: {}", r.error());
     }
@@ -232,6 +298,10 @@ main(int argc, char** argv) {
   if (chunk_size <= 0) {
     chunk_size = 25000;
   }
+  if (window_size <= 0) {
+    window_size = 64 << 20;
+  }
+  katana::setActiveThreads(num_threads);
 
   if (export_graphml) {
     katana::graphml::ExportGraph(output_directory, input_filename);
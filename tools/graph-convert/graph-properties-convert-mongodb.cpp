@@ -5,12 +5,16 @@
 #include <cstdlib>
 #include <deque>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <random>
 #include <sstream>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -333,9 +337,10 @@ ProcessElement(const bson_value_t* elt, const std::string& name) {
 /* MongoDB functions for handling edges */
 /****************************************/
 
+template <typename Builder>
 void
 HandleEmbeddedEdgeStruct(
-    katana::PropertyGraphBuilder* builder, const bson_value_t* doc_ptr,
+    Builder* builder, const bson_value_t* doc_ptr,
     const std::string& prefix) {
   bson_t doc;
   bson_iter_t iter;
@@ -369,9 +374,14 @@ HandleEmbeddedEdgeStruct(
 /* MongoDB functions for handling nodes */
 /****************************************/
 
+template <typename Builder>
+void HandleNodeDocument(
+    Builder* builder, const bson_t* doc, const std::string& collection_name);
+
+template <typename Builder>
 void
 HandleEmbeddedDocuments(
-    katana::PropertyGraphBuilder* builder,
+    Builder* builder,
     const std::vector<std::pair<std::string, bson_value_t_wrapper>>& docs,
     const std::string& parent_name, size_t parent_index) {
   for (auto [name, elt_wrapper] : docs) {
@@ -385,7 +395,7 @@ HandleEmbeddedDocuments(
         builder->AddEdge(
             static_cast<uint32_t>(parent_index),
             static_cast<uint32_t>(builder->GetNodes()), edge_type);
-        katana::HandleNodeDocumentMongoDB(builder, &doc, name);
+        HandleNodeDocument(builder, &doc, name);
       }
     } else {
       bson_t array;
@@ -403,7 +413,7 @@ HandleEmbeddedDocuments(
                 builder->AddEdge(
                     static_cast<uint32_t>(parent_index),
                     static_cast<uint32_t>(builder->GetNodes()), name);
-                katana::HandleNodeDocumentMongoDB(builder, &doc, name);
+                HandleNodeDocument(builder, &doc, name);
               }
             }
           }
@@ -414,9 +424,10 @@ HandleEmbeddedDocuments(
   }
 }
 
+template <typename Builder>
 bool
 HandleNonPropertyNodeElement(
-    katana::PropertyGraphBuilder* builder,
+    Builder* builder,
     std::vector<std::pair<std::string, bson_value_t_wrapper>>* docs,
     const std::string& name, const bson_value_t* elt,
     const std::string& collection_name) {
@@ -463,9 +474,10 @@ HandleNonPropertyNodeElement(
   return false;
 }
 
+template <typename Builder>
 void
 HandleEmbeddedNodeStruct(
-    katana::PropertyGraphBuilder* builder,
+    Builder* builder,
     std::vector<std::pair<std::string, bson_value_t_wrapper>>* docs,
     const std::string& name, const bson_value_t* doc_ptr,
     const std::string& prefix) {
@@ -501,6 +513,93 @@ HandleEmbeddedNodeStruct(
   }
 }
 
+// for now only handle arrays and data all of same type
+template <typename Builder>
+void
+HandleEdgeDocument(
+    Builder* builder, const bson_t* doc, const std::string& collection_name) {
+  builder->StartEdge();
+
+  bool found_source = false;
+  bson_iter_t iter;
+  if (bson_iter_init(&iter, doc)) {
+    // handle document
+    while (bson_iter_next(&iter)) {
+      const bson_value_t* elt = bson_iter_value(&iter);
+      std::string name{bson_iter_key(&iter), bson_iter_key_len(&iter)};
+
+      // initialize new node
+      if (name == std::string("_id")) {
+        builder->AddEdgeId(ExtractOid(iter));
+        continue;
+      }
+      // handle src and destination node IDs
+      if (elt->value_type == BSON_TYPE_OID) {
+        if (!found_source) {
+          builder->AddEdgeSource(ExtractOid(iter));
+          found_source = true;
+        } else {
+          builder->AddEdgeTarget(ExtractOid(iter));
+        }
+        continue;
+      }
+
+      // since all edge cases have been checked, we can add this property
+      builder->AddValue(
+          name, [&]() { return ProcessElement(elt, name); },
+          [&elt](ImportDataType type, bool is_list) {
+            return ResolveValue(elt, type, is_list);
+          });
+
+      if (elt->value_type == BSON_TYPE_DOCUMENT) {
+        std::string prefix = name + std::string(".");
+        HandleEmbeddedEdgeStruct(builder, bson_iter_value(&iter), prefix);
+      }
+    }
+  }
+  builder->AddLabel(collection_name);
+  builder->FinishEdge();
+}
+
+// for now only handle arrays and data all of same type
+template <typename Builder>
+void
+HandleNodeDocument(
+    Builder* builder, const bson_t* doc, const std::string& collection_name) {
+  builder->StartNode();
+  auto node_index = builder->GetNodeIndex();
+  std::vector<std::pair<std::string, bson_value_t_wrapper>> docs;
+
+  bson_iter_t iter;
+  if (bson_iter_init(&iter, doc)) {
+    // handle document
+    while (bson_iter_next(&iter)) {
+      const bson_value_t* elt = bson_iter_value(&iter);
+      std::string name{bson_iter_key(&iter), bson_iter_key_len(&iter)};
+      if (HandleNonPropertyNodeElement(
+              builder, &docs, name, elt, collection_name)) {
+        continue;
+      }
+
+      builder->AddValue(
+          name, [&]() { return ProcessElement(elt, name); },
+          [&elt](ImportDataType type, bool is_list) {
+            return ResolveValue(elt, type, is_list);
+          });
+
+      if (elt->value_type == BSON_TYPE_DOCUMENT) {
+        std::string prefix = name + std::string(".");
+        HandleEmbeddedNodeStruct(builder, &docs, name, elt, prefix);
+      }
+    }
+  }
+  builder->AddLabel(collection_name);
+  builder->FinishNode();
+
+  // deal with embedded documents
+  HandleEmbeddedDocuments(builder, docs, collection_name, node_index);
+}
+
 /**********************************/
 /* Functions for MongoDB querying */
 /**********************************/
@@ -1003,93 +1102,374 @@ GetUserInput(
       std::move(nodes), std::move(edges));
 }
 
-}  // end of unnamed namespace
+/*****************************************/
+/* Functions for converting in parallel */
+/*****************************************/
 
-// for now only handle arrays and data all of same type
-void
-katana::HandleEdgeDocumentMongoDB(
-    katana::PropertyGraphBuilder* builder, const bson_t* doc,
-    const std::string& collection_name) {
-  builder->StartEdge();
+/// Number of documents sampled per range when splitting a collection
+constexpr int32_t kSamplesPerRange = 16;
+/// Documents returned by the server per cursor batch
+constexpr int32_t kCursorBatchSize = 1000;
+
+/// Property keys and label names of a conversion, read-only while the
+/// collections are scanned
+struct ConversionKeys {
+  std::unordered_map<std::string, PropertyKey> node_keys;
+  std::unordered_map<std::string, PropertyKey> edge_keys;
+  std::unordered_map<std::string, std::string> node_labels;
+  std::unordered_map<std::string, std::string> edge_labels;
+  /// IDs of edge documents, which foreign keys of nodes do not become edges to
+  std::unordered_set<std::string> edge_ids;
+};
 
-  bool found_source = false;
-  bson_iter_t iter;
-  if (bson_iter_init(&iter, doc)) {
-    // handle document
-    while (bson_iter_next(&iter)) {
-      const bson_value_t* elt = bson_iter_value(&iter);
-      std::string name{bson_iter_key(&iter), bson_iter_key_len(&iter)};
+/// Adapts a shard of a ShardedPropertyGraphBuilder to the part of the
+/// PropertyGraphBuilder interface that the document handlers use, so that
+/// each thread builds the documents of its range without locks. A node or
+/// edge is staged until it is finished since its ID may follow its values.
+class ShardSink {
+public:
+  ShardSink(
+      const ConversionKeys* keys,
+      katana::ShardedPropertyGraphBuilder::Shard* shard, size_t shard_index)
+      : keys_(keys), shard_(shard), shard_index_(shard_index) {}
+
+  bool StartNode() {
+    if (building_node_ || building_edge_) {
+      return false;
+    }
+    building_node_ = true;
+    return true;
+  }
 
-      // initialize new node
-      if (name == std::string("_id")) {
-        builder->AddEdgeId(ExtractOid(iter));
-        continue;
+  void AddNodeId(const std::string& id) { element_.id = id; }
+
+  void AddOutgoingEdge(const std::string& target, const std::string& label) {
+    if (!building_node_ || keys_->edge_ids.count(target) > 0) {
+      return;
+    }
+    element_.out_edges.emplace_back(target, label);
+  }
+
+  bool FinishNode() {
+    if (!building_node_) {
+      return false;
+    }
+    building_node_ = false;
+    if (element_.id.empty()) {
+      element_.id = fmt::format("embedded:{}:{}", shard_index_, nodes_);
+    }
+    shard_->AddNode(element_.id);
+    for (auto& [name, value] : element_.values) {
+      Check(shard_->AddNodeValue(name, std::move(value)));
+    }
+    for (const auto& label : element_.labels) {
+      Check(shard_->AddNodeLabel(label));
+    }
+    for (const auto& [target, label] : element_.out_edges) {
+      AddTypedEdge(element_.id, target, label);
+    }
+    // edges from the parents of an embedded document
+    if (auto it = parent_edges_.find(nodes_); it != parent_edges_.end()) {
+      for (const auto& [parent, label] : it->second) {
+        AddTypedEdge(document_ids_[parent], element_.id, label);
       }
-      // handle src and destination node IDs
-      if (elt->value_type == BSON_TYPE_OID) {
-        if (!found_source) {
-          builder->AddEdgeSource(ExtractOid(iter));
-          found_source = true;
-        } else {
-          builder->AddEdgeTarget(ExtractOid(iter));
+      parent_edges_.erase(it);
+    }
+    document_ids_.emplace(nodes_, element_.id);
+    element_ = Element();
+    ++nodes_;
+    return true;
+  }
+
+  bool StartEdge() {
+    if (building_node_ || building_edge_) {
+      return false;
+    }
+    building_edge_ = true;
+    return true;
+  }
+
+  void AddEdgeId(const std::string& id) { edge_ids_.emplace(id); }
+  void AddEdgeSource(const std::string& source) { element_.source = source; }
+  void AddEdgeTarget(const std::string& target) { element_.target = target; }
+
+  bool FinishEdge() {
+    if (!building_edge_) {
+      return false;
+    }
+    building_edge_ = false;
+    shard_->AddEdge(element_.source, element_.target);
+    for (auto& [name, value] : element_.values) {
+      Check(shard_->AddEdgeValue(name, std::move(value)));
+    }
+    for (const auto& type : element_.labels) {
+      Check(shard_->AddEdgeType(type));
+    }
+    element_ = Element();
+    return true;
+  }
+
+  /// Add an edge from an embedding node to the embedded node about to start
+  bool AddEdge(uint32_t source, uint32_t target, const std::string& label) {
+    parent_edges_[target].emplace_back(source, label);
+    return true;
+  }
+
+  void AddValue(
+      const std::string& id, std::function<PropertyKey()> process_element,
+      std::function<ImportData(ImportDataType, bool)> resolve_value) {
+    if (!building_node_ && !building_edge_) {
+      return;
+    }
+    const auto& keys = building_node_ ? keys_->node_keys : keys_->edge_keys;
+    auto key_iter = keys.find(id);
+    if (key_iter == keys.end()) {
+      // keep the type of the first value in this shard, as
+      // PropertyGraphBuilder does
+      key_iter = local_keys_.find(id);
+      if (key_iter == local_keys_.end()) {
+        auto key = process_element();
+        if (key.type == ImportDataType::kUnsupported) {
+          return;
         }
-        continue;
+        key_iter = local_keys_.emplace(id, std::move(key)).first;
       }
+    }
+    const PropertyKey& key = key_iter->second;
+    element_.values.emplace_back(
+        key.name, resolve_value(key.type, key.is_list));
+  }
 
-      // since all edge cases have been checked, we can add this property
-      builder->AddValue(
-          name, [&]() { return ProcessElement(elt, name); },
-          [&elt](ImportDataType type, bool is_list) {
-            return ResolveValue(elt, type, is_list);
-          });
+  void AddLabel(const std::string& name) {
+    if (!building_node_ && !building_edge_) {
+      return;
+    }
+    element_.labels.emplace_back(
+        Label(building_node_ ? keys_->node_labels : keys_->edge_labels, name));
+  }
 
-      if (elt->value_type == BSON_TYPE_DOCUMENT) {
-        std::string prefix = name + std::string(".");
-        HandleEmbeddedEdgeStruct(builder, bson_iter_value(&iter), prefix);
-      }
+  size_t GetNodeIndex() {
+    return building_node_ ? nodes_ : std::numeric_limits<size_t>::max();
+  }
+  size_t GetNodes() { return nodes_; }
+
+  /// Forget the nodes of the last top-level document, which is all embedded
+  /// documents may refer to
+  void FinishDocument() { document_ids_.clear(); }
+
+  const std::unordered_set<std::string>& edge_ids() const { return edge_ids_; }
+
+  /// \returns the first error adding to the shard
+  const katana::Result<void>& result() const { return result_; }
+
+private:
+  struct Element {
+    std::string id;
+    std::string source;
+    std::string target;
+    std::vector<std::pair<std::string, ImportData>> values;
+    std::vector<std::string> labels;
+    std::vector<std::pair<std::string, std::string>> out_edges;
+  };
+
+  static const std::string& Label(
+      const std::unordered_map<std::string, std::string>& labels,
+      const std::string& name) {
+    auto it = labels.find(name);
+    return it == labels.end() ? name : it->second;
+  }
+
+  void AddTypedEdge(
+      const std::string& source, const std::string& target,
+      const std::string& label) {
+    shard_->AddEdge(source, target);
+    Check(shard_->AddEdgeType(Label(keys_->edge_labels, label)));
+  }
+
+  void Check(katana::Result<void> res) {
+    if (!res && result_) {
+      result_ = res.error();
     }
   }
-  builder->AddLabel(collection_name);
-  builder->FinishEdge();
+
+  const ConversionKeys* keys_;
+  katana::ShardedPropertyGraphBuilder::Shard* shard_;
+  size_t shard_index_;
+  std::unordered_map<std::string, PropertyKey> local_keys_;
+  Element element_;
+  bool building_node_{false};
+  bool building_edge_{false};
+  size_t nodes_{0};
+  std::unordered_map<size_t, std::string> document_ids_;
+  std::unordered_map<size_t, std::vector<std::pair<size_t, std::string>>>
+      parent_edges_;
+  std::unordered_set<std::string> edge_ids_;
+  katana::Result<void> result_{katana::ResultSuccess()};
+};
+
+/// A range of the documents of a collection, scanned by one thread
+struct ScanRange {
+  std::string collection;
+  /// filter selecting the range from the collection
+  std::shared_ptr<bson_t> filter;
+};
+
+std::shared_ptr<bson_t>
+MakeFilter(bson_t* filter) {
+  return std::shared_ptr<bson_t>(filter, bson_destroy);
 }
 
-// for now only handle arrays and data all of same type
-void
-katana::HandleNodeDocumentMongoDB(
-    katana::PropertyGraphBuilder* builder, const bson_t* doc,
-    const std::string& collection_name) {
-  builder->StartNode();
-  auto node_index = builder->GetNodeIndex();
-  std::vector<std::pair<std::string, bson_value_t_wrapper>> docs;
+/// Split a collection into up to num_ranges ranges of _id values at the
+/// quantiles of a sample of its documents. The first range also has the
+/// documents whose _id is not an ObjectId, so the ranges cover the
+/// collection.
+std::vector<ScanRange>
+SplitCollection(
+    mongoc_database_t* database, const std::string& coll_name,
+    size_t num_ranges) {
+  std::vector<bson_oid_t> samples;
+  int32_t num_samples = static_cast<int32_t>(num_ranges) * kSamplesPerRange;
+  if (num_ranges > 1) {
+    auto collection =
+        mongoc_database_get_collection(database, coll_name.c_str());
+    bson_t* pipeline = BCON_NEW(
+        "pipeline", "[", "{", "$sample", "{", "size", BCON_INT32(num_samples),
+        "}", "}", "{", "$project", "{", "_id", BCON_INT32(1), "}", "}", "]");
+    auto cursor = mongoc_collection_aggregate(
+        collection, MONGOC_QUERY_NONE, pipeline, nullptr, nullptr);
+    bson_destroy(pipeline);
 
-  bson_iter_t iter;
-  if (bson_iter_init(&iter, doc)) {
-    // handle document
-    while (bson_iter_next(&iter)) {
-      const bson_value_t* elt = bson_iter_value(&iter);
-      std::string name{bson_iter_key(&iter), bson_iter_key_len(&iter)};
-      if (HandleNonPropertyNodeElement(
-              builder, &docs, name, elt, collection_name)) {
-        continue;
+    const bson_t* doc;
+    bson_iter_t iter;
+    while (mongoc_cursor_next(cursor, &doc)) {
+      if (bson_iter_init_find(&iter, doc, "_id") &&
+          BSON_ITER_HOLDS_OID(&iter)) {
+        samples.emplace_back(*bson_iter_oid(&iter));
       }
+    }
+    mongoc_cursor_destroy(cursor);
+    mongoc_collection_destroy(collection);
+  }
 
-      builder->AddValue(
-          name, [&]() { return ProcessElement(elt, name); },
-          [&elt](ImportDataType type, bool is_list) {
-            return ResolveValue(elt, type, is_list);
-          });
+  // a small collection is scanned whole
+  std::vector<ScanRange> ranges;
+  if (samples.size() < static_cast<size_t>(num_samples)) {
+    ranges.emplace_back(ScanRange{coll_name, MakeFilter(bson_new())});
+    return ranges;
+  }
+  std::sort(
+      samples.begin(), samples.end(),
+      [](const bson_oid_t& a, const bson_oid_t& b) {
+        return bson_oid_compare(&a, &b) < 0;
+      });
+  std::vector<bson_oid_t> bounds;
+  for (size_t r = 1; r < num_ranges; ++r) {
+    const bson_oid_t& bound = samples[r * samples.size() / num_ranges];
+    if (bounds.empty() || bson_oid_compare(&bounds.back(), &bound) < 0) {
+      bounds.emplace_back(bound);
+    }
+  }
 
-      if (elt->value_type == BSON_TYPE_DOCUMENT) {
-        std::string prefix = name + std::string(".");
-        HandleEmbeddedNodeStruct(builder, &docs, name, elt, prefix);
-      }
+  ranges.emplace_back(ScanRange{
+      coll_name, MakeFilter(BCON_NEW(
+                     "_id", "{", "$not", "{", "$gte", BCON_OID(&bounds[0]),
+                     "}", "}"))});
+  for (size_t b = 1; b < bounds.size(); ++b) {
+    ranges.emplace_back(ScanRange{
+        coll_name,
+        MakeFilter(BCON_NEW(
+            "_id", "{", "$gte", BCON_OID(&bounds[b - 1]), "$lt",
+            BCON_OID(&bounds[b]), "}"))});
+  }
+  ranges.emplace_back(ScanRange{
+      coll_name, MakeFilter(BCON_NEW(
+                     "_id", "{", "$gte", BCON_OID(&bounds.back()), "}"))});
+  return ranges;
+}
+
+/// Scan the ranges in parallel, each into a new shard of builder with a
+/// cursor of its own
+template <typename HandleFn>
+katana::Result<std::vector<std::unordered_set<std::string>>>
+ScanRanges(
+    mongoc_client_pool_t* pool, const std::string& db_name,
+    const std::vector<ScanRange>& ranges, const ConversionKeys& keys,
+    katana::ShardedPropertyGraphBuilder* builder, HandleFn handle) {
+  size_t first_shard = builder->AddShards(ranges.size());
+  std::vector<katana::Result<void>> results(
+      ranges.size(), katana::ResultSuccess());
+  std::vector<std::unordered_set<std::string>> edge_ids(ranges.size());
+
+  katana::do_all(
+      katana::iterate(size_t{0}, ranges.size()),
+      [&](size_t r) {
+        ShardSink sink(
+            &keys, builder->GetShard(first_shard + r), first_shard + r);
+        mongoc_client_t* client = mongoc_client_pool_pop(pool);
+        auto collection = mongoc_client_get_collection(
+            client, db_name.c_str(), ranges[r].collection.c_str());
+        bson_t* opts = BCON_NEW("batchSize", BCON_INT32(kCursorBatchSize));
+        auto cursor = mongoc_collection_find_with_opts(
+            collection, ranges[r].filter.get(), opts, nullptr);
+        bson_destroy(opts);
+
+        const bson_t* doc;
+        while (mongoc_cursor_next(cursor, &doc)) {
+          handle(&sink, doc, ranges[r].collection);
+          sink.FinishDocument();
+        }
+        bson_error_t error;
+        if (mongoc_cursor_error(cursor, &error)) {
+          results[r] = KATANA_ERROR(
+              katana::ErrorCode::InvalidArgument,
+              "scanning collection {}: {}", ranges[r].collection,
+              error.message);
+        } else {
+          results[r] = sink.result();
+        }
+        edge_ids[r] = sink.edge_ids();
+
+        mongoc_cursor_destroy(cursor);
+        mongoc_collection_destroy(collection);
+        mongoc_client_pool_push(pool, client);
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+  for (auto& res : results) {
+    if (!res) {
+      return res.error();
     }
   }
-  builder->AddLabel(collection_name);
-  builder->FinishNode();
+  return edge_ids;
+}
 
-  // deal with embedded documents
-  HandleEmbeddedDocuments(builder, docs, collection_name, node_index);
+std::vector<ScanRange>
+SplitCollections(
+    mongoc_database_t* database, const std::vector<std::string>& coll_names) {
+  std::vector<ScanRange> ranges;
+  for (const auto& coll_name : coll_names) {
+    auto coll_ranges =
+        SplitCollection(database, coll_name, katana::getActiveThreads());
+    std::move(
+        coll_ranges.begin(), coll_ranges.end(), std::back_inserter(ranges));
+  }
+  return ranges;
+}
+
+}  // end of unnamed namespace
+
+void
+katana::HandleEdgeDocumentMongoDB(
+    katana::PropertyGraphBuilder* builder, const bson_t* doc,
+    const std::string& collection_name) {
+  HandleEdgeDocument(builder, doc, collection_name);
+}
+
+void
+katana::HandleNodeDocumentMongoDB(
+    katana::PropertyGraphBuilder* builder, const bson_t* doc,
+    const std::string& collection_name) {
+  HandleNodeDocument(builder, doc, collection_name);
 }
 
 void
@@ -1160,3 +1540,137 @@ katana::ConvertMongoDB(
     return std::move(r.value());
   }
 }
+
+katana::GraphComponents
+katana::ConvertMongoDBParallel(
+    const std::string& db_name, const std::string& mapping, size_t chunk_size) {
+  const char* uri_string = "mongodb://localhost:27017";
+
+  mongoc_init();
+  bson_error_t error;
+  mongoc_uri_t* uri = mongoc_uri_new_with_error(uri_string, &error);
+  if (!uri) {
+    KATANA_LOG_FATAL(
+        "Failed to parse URI: {}\n"
+        "Error message: {}\n",
+        uri_string, error.message);
+  }
+  mongoc_client_pool_t* pool = mongoc_client_pool_new(uri);
+  mongoc_uri_destroy(uri);
+  mongoc_client_pool_set_appname(pool, "graph-properties-convert");
+  mongoc_client_t* client = mongoc_client_pool_pop(pool);
+  mongoc_database_t* database =
+      mongoc_client_get_database(client, db_name.c_str());
+  std::vector<std::string> coll_names = GetCollectionNames(database);
+
+  // get input on node/edge mappings, label names, property names and
+  // values
+  ConversionKeys keys;
+  std::vector<std::string> nodes;
+  std::vector<std::string> edges;
+  if (!mapping.empty()) {
+    auto [rules, property_keys] =
+        katana::graphml::ProcessSchemaMapping(mapping);
+    for (const LabelRule& rule : rules) {
+      bool is_collection =
+          std::find(coll_names.begin(), coll_names.end(), rule.id) !=
+          coll_names.end();
+      if (rule.for_node) {
+        keys.node_labels.emplace(rule.id, rule.label);
+        if (is_collection) {
+          nodes.emplace_back(rule.id);
+        }
+      } else if (rule.for_edge) {
+        keys.edge_labels.emplace(rule.id, rule.label);
+        if (is_collection) {
+          edges.emplace_back(rule.id);
+        }
+      }
+    }
+    for (const PropertyKey& key : property_keys) {
+      if (key.for_node) {
+        keys.node_keys.emplace(key.id, key);
+      } else if (key.for_edge) {
+        keys.edge_keys.emplace(key.id, key);
+      }
+    }
+  } else {
+    std::tie(nodes, edges) = GetUserInput(database, coll_names);
+
+    // fix the types of properties from a sample of the collections, so that
+    // all threads agree on them
+    CollectionFields node_fields;
+    CollectionFields edge_fields;
+    for (const auto& [colls, fields] :
+         {std::make_pair(&nodes, &node_fields),
+          std::make_pair(&edges, &edge_fields)}) {
+      for (const std::string& coll_name : *colls) {
+        auto collection =
+            mongoc_database_get_collection(database, coll_name.c_str());
+        ExtractCollectionFields(collection, fields, coll_name);
+        mongoc_collection_destroy(collection);
+      }
+    }
+    for (const auto& [name, key] : node_fields.property_fields) {
+      keys.node_keys.emplace(name, key);
+    }
+    for (const auto& [name, key] : edge_fields.property_fields) {
+      keys.edge_keys.emplace(name, key);
+    }
+  }
+
+  katana::ShardedPropertyGraphBuilder builder(1, chunk_size);
+  auto* first = builder.GetShard(0);
+  for (const auto& [id, key] : keys.node_keys) {
+    if (auto res = first->DeclareNodeProperty(key.name, key.type, key.is_list);
+        !res) {
+      KATANA_LOG_WARN("ignoring node property {}: {}", key.name, res.error());
+    }
+  }
+  for (const auto& [id, key] : keys.edge_keys) {
+    if (auto res = first->DeclareEdgeProperty(key.name, key.type, key.is_list);
+        !res) {
+      KATANA_LOG_WARN("ignoring edge property {}: {}", key.name, res.error());
+    }
+  }
+
+  // add all edges first, so that foreign keys of nodes that refer to edge
+  // documents can be skipped
+  auto edge_ranges = SplitCollections(database, edges);
+  std::cout << "Scanning " << edges.size() << " edge collections in "
+            << edge_ranges.size() << " ranges\n";
+  auto edge_ids_result = ScanRanges(
+      pool, db_name, edge_ranges, keys, &builder,
+      [](ShardSink* sink, const bson_t* doc, const std::string& coll_name) {
+        HandleEdgeDocument(sink, doc, coll_name);
+      });
+  if (!edge_ids_result) {
+    KATANA_LOG_FATAL("Failed to scan edges: {}", edge_ids_result.error());
+  }
+  for (auto& ids : edge_ids_result.value()) {
+    keys.edge_ids.merge(ids);
+  }
+
+  // then add all nodes
+  auto node_ranges = SplitCollections(database, nodes);
+  std::cout << "Scanning " << nodes.size() << " node collections in "
+            << node_ranges.size() << " ranges\n";
+  auto node_result = ScanRanges(
+      pool, db_name, node_ranges, keys, &builder,
+      [](ShardSink* sink, const bson_t* doc, const std::string& coll_name) {
+        HandleNodeDocument(sink, doc, coll_name);
+      });
+  if (!node_result) {
+    KATANA_LOG_FATAL("Failed to scan nodes: {}", node_result.error());
+  }
+
+  mongoc_database_destroy(database);
+  mongoc_client_pool_push(pool, client);
+  mongoc_client_pool_destroy(pool);
+  mongoc_cleanup();
+  if (auto r = builder.Finish(); !r) {
+    KATANA_LOG_FATAL("Failed to construct graph: {}", r.error());
+  } else {
+    return std::move(r.value());
+  }
+}
@@ -18,6 +18,14 @@ void HandleEdgeDocumentMongoDB(
 GraphComponents ConvertMongoDB(
     const std::string& db_name, const std::string& mapping,
     const size_t chunk_size);
+/// ConvertMongoDBParallel converts a database like ConvertMongoDB, but scans
+/// it with all active threads. Each collection is split into ranges of _id
+/// values, each scanned with a cursor and a connection of its own and built
+/// into a shard of a ShardedPropertyGraphBuilder, so decoding documents and
+/// building the graph proceed in parallel.
+GraphComponents ConvertMongoDBParallel(
+    const std::string& db_name, const std::string& mapping,
+    const size_t chunk_size);
 void GenerateMappingMongoDB(
     const std::string& db_name, const std::string& outfile);
 
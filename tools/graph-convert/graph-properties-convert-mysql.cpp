@@ -9,6 +9,7 @@
 #include <deque>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <optional>
@@ -27,6 +28,7 @@
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
 #include "katana/Threads.h"
 
 using katana::GraphComponents;
@@ -63,10 +65,28 @@ struct Relationship {
         target_field(std::move(target_field_)) {}
 };
 
+bool
+IsIntegerType(enum_field_types type) {
+  switch (type) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+  case MYSQL_TYPE_YEAR:
+    return true;
+  default:
+    return false;
+  }
+}
+
 struct TableData {
   std::string name;
   bool is_node;
   int64_t primary_key_index;
+  std::string primary_key_field;
+  size_t num_primary_keys;
+  bool integer_primary_key;
   std::vector<Relationship> out_references;
   std::vector<Relationship> in_references;
   std::vector<std::string> field_names;
@@ -77,6 +97,8 @@ struct TableData {
       : name(std::move(name_)),
         is_node(true),
         primary_key_index(-1),
+        num_primary_keys(0),
+        integer_primary_key(false),
         out_references(std::vector<Relationship>{}),
         in_references(std::vector<Relationship>{}),
         field_names(std::vector<std::string>{}),
@@ -91,6 +113,13 @@ struct TableData {
     }
   }
 
+  void SetPrimaryKey(const MYSQL_FIELD& field, size_t index) {
+    this->primary_key_index = static_cast<int64_t>(index);
+    this->primary_key_field = std::string{field.name, field.name_length};
+    this->num_primary_keys++;
+    this->integer_primary_key = IsIntegerType(field.type);
+  }
+
   bool IsValidEdge() {
     if (this->out_references.size() != 2) {
       return false;
@@ -256,6 +285,38 @@ RunQuery(MYSQL* con, const std::string& query) {
   return MysqlRes(mysql_use_result(con));
 }
 
+/// Run a query and fetch all of its result, so the server is done with the
+/// query when this returns
+MysqlRes
+StoreQuery(MYSQL* con, const std::string& query) {
+  if (mysql_real_query(con, query.c_str(), query.size())) {
+    KATANA_LOG_FATAL("Could not run query {}: {}", query, mysql_error(con));
+  }
+  MYSQL_RES* res = mysql_store_result(con);
+  if (res == nullptr && mysql_field_count(con) != 0) {
+    KATANA_LOG_FATAL(
+        "Could not fetch result of query {}: {}", query, mysql_error(con));
+  }
+  return MysqlRes(res);
+}
+
+MYSQL*
+Connect(
+    const std::string& host, const std::string& user,
+    const std::string& password, const std::string& db_name) {
+  MYSQL* con = mysql_init(NULL);
+  if (con == nullptr) {
+    KATANA_LOG_FATAL("mysql_init() failed");
+  }
+  if (mysql_real_connect(
+          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
+          NULL, 0) == NULL) {
+    KATANA_LOG_FATAL(
+        "Could not establish mysql connection: {}", mysql_error(con));
+  }
+  return con;
+}
+
 void
 AddNodeTable(
     katana::PropertyGraphBuilder* builder, MYSQL* con,
@@ -641,7 +702,7 @@ PreprocessFields(
 
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
-      table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.SetPrimaryKey(*field, index);
     } else if (
         table_iter->second.ignore_list.find(key.id) ==
         table_iter->second.ignore_list.end()) {
@@ -674,7 +735,7 @@ PreprocessFields(
 
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
-      table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.SetPrimaryKey(*field, index);
     } else if (
         table_iter->second.ignore_list.find(key.id) !=
         table_iter->second.ignore_list.end()) {
@@ -690,9 +751,12 @@ PreprocessFields(
   }
 }
 
+/// Builder is a katana::PropertyGraphBuilder, or anything else that keys and
+/// labels can be added to with AddBuilder and AddLabelBuilder
+template <typename Builder>
 std::unordered_map<std::string, TableData>
 PreprocessTables(
-    MYSQL* con, katana::PropertyGraphBuilder* builder,
+    MYSQL* con, Builder* builder,
     const std::vector<std::string>& table_names) {
   std::unordered_map<std::string, TableData> table_data;
   std::map<std::string, PropertyKey> node_fields;
@@ -730,9 +794,10 @@ PreprocessTables(
   return table_data;
 }
 
+template <typename Builder>
 std::unordered_map<std::string, TableData>
 PreprocessTables(
-    MYSQL* con, katana::PropertyGraphBuilder* builder,
+    MYSQL* con, Builder* builder,
     const std::vector<std::string>& table_names,
     const std::vector<LabelRule>& rules, const std::vector<PropertyKey>& keys) {
   std::unordered_map<std::string, TableData> table_data;
@@ -854,6 +919,329 @@ GetMappingInput(
   katana::graphml::FinishGraphmlFile(writer);
 }
 
+/****************************************/
+/* Functions for converting in parallel */
+/****************************************/
+
+/// Rows read per query by keyset pagination
+constexpr uint64_t kPageRows = 10000;
+/// Ranges each table with an integer primary key is split into per thread, so
+/// that threads that finish early can steal ranges of large tables
+constexpr size_t kRangesPerThread = 4;
+
+/// The property keys and labels of the tables, which threads converting
+/// tables in parallel look up without locks
+struct ConversionKeys {
+  std::unordered_map<std::string, PropertyKey> node_keys;
+  std::unordered_map<std::string, PropertyKey> edge_keys;
+  std::unordered_map<std::string, std::string> node_labels;
+  std::unordered_map<std::string, std::string> edge_labels;
+
+  void AddLabelBuilder(const LabelRule& rule) {
+    auto& labels = rule.for_node ? node_labels : edge_labels;
+    labels.emplace(rule.id, rule.label);
+  }
+
+  void AddBuilder(const PropertyKey& key) {
+    auto& keys = key.for_node ? node_keys : edge_keys;
+    keys.emplace(key.id, key);
+  }
+
+  static const std::string& Label(
+      const std::unordered_map<std::string, std::string>& labels,
+      const std::string& name) {
+    auto it = labels.find(name);
+    return it == labels.end() ? name : it->second;
+  }
+};
+
+/// A range of the rows of a table, in the order of its primary key
+struct KeyRange {
+  const TableData* table;
+  /// the range has the rows whose key is greater than after, if present, and
+  /// at most upto, if present
+  std::optional<int64_t> after;
+  std::optional<int64_t> upto;
+};
+
+int64_t
+OffsetKey(int64_t key, uint64_t offset) {
+  return static_cast<int64_t>(static_cast<uint64_t>(key) + offset);
+}
+
+/// Split a table into up to num_ranges ranges of its primary key, of equal
+/// width between its smallest and largest key. Tables without an integer
+/// primary key are one range.
+std::vector<KeyRange>
+SplitTable(MYSQL* con, const TableData& table, size_t num_ranges) {
+  if (table.num_primary_keys != 1 || !table.integer_primary_key) {
+    return {KeyRange{&table, std::nullopt, std::nullopt}};
+  }
+  MysqlRes bounds = RunQuery(
+      con, fmt::format(
+               "SELECT MIN({0}), MAX({0}) FROM {1};", table.primary_key_field,
+               table.name));
+  MYSQL_ROW row = mysql_fetch_row(bounds.res);
+  std::optional<std::pair<int64_t, int64_t>> min_max;
+  if (row != NULL && row[0] != NULL && row[1] != NULL) {
+    try {
+      min_max = std::make_pair(
+          boost::lexical_cast<int64_t>(row[0]),
+          boost::lexical_cast<int64_t>(row[1]));
+    } catch (const boost::bad_lexical_cast&) {
+      // unsigned keys beyond the range of int64_t are scanned as one range
+    }
+  }
+  ExhaustResultSet(&bounds);
+  if (!min_max) {
+    return {KeyRange{&table, std::nullopt, std::nullopt}};
+  }
+
+  auto [min, max] = min_max.value();
+  uint64_t width = static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+  // do not split tables into ranges much smaller than a page
+  uint64_t num = std::min<uint64_t>(num_ranges, width / kPageRows + 1);
+  uint64_t step = width / num + 1;
+
+  std::vector<KeyRange> ranges;
+  for (uint64_t begin = 0;; begin += step) {
+    KeyRange range{&table, std::nullopt, std::nullopt};
+    if (begin > 0) {
+      range.after = OffsetKey(min, begin - 1);
+    }
+    bool last = width - begin < step;
+    if (!last) {
+      range.upto = OffsetKey(min, begin + step - 1);
+    }
+    ranges.emplace_back(range);
+    if (last) {
+      break;
+    }
+  }
+  return ranges;
+}
+
+std::string
+EscapeString(MYSQL* con, const std::string& value) {
+  std::string escaped(2 * value.size() + 1, '\0');
+  escaped.resize(mysql_real_escape_string(
+      con, escaped.data(), value.c_str(), value.size()));
+  return escaped;
+}
+
+/// Generate the query for the page of range after the key last, or for its
+/// first page if last is empty. Each page is found through the index of the
+/// primary key, so unlike LIMIT and OFFSET the query does not skip rows.
+std::string
+GenerateFetchPageQuery(
+    MYSQL* con, const KeyRange& range, const std::optional<std::string>& last) {
+  const std::string& key = range.table->primary_key_field;
+  std::vector<std::string> conditions;
+  if (last && range.table->integer_primary_key) {
+    // compare integers as integers, not as doubles
+    conditions.emplace_back(fmt::format("{} > {}", key, last.value()));
+  } else if (last) {
+    conditions.emplace_back(
+        fmt::format("{} > '{}'", key, EscapeString(con, last.value())));
+  } else if (range.after) {
+    conditions.emplace_back(fmt::format("{} > {}", key, range.after.value()));
+  }
+  if (range.upto) {
+    conditions.emplace_back(fmt::format("{} <= {}", key, range.upto.value()));
+  }
+  std::string query{"SELECT * FROM " + range.table->name};
+  if (!conditions.empty()) {
+    query += " WHERE " + boost::algorithm::join(conditions, " AND ");
+  }
+  return query + fmt::format(" ORDER BY {} LIMIT {};", key, kPageRows);
+}
+
+/// Converts the rows of a table into a shard of a ShardedPropertyGraphBuilder.
+/// The fields of the table are resolved to their property keys once, so that
+/// each value is parsed straight to the type of its column.
+class RowConverter {
+public:
+  RowConverter(
+      const ConversionKeys& keys, const TableData& table,
+      katana::ShardedPropertyGraphBuilder::Shard* shard, size_t shard_index)
+      : keys_(keys), table_(table), shard_(shard), shard_index_(shard_index) {
+    const auto& table_keys = table.is_node ? keys.node_keys : keys.edge_keys;
+    for (size_t i = 0; i < table.field_names.size(); i++) {
+      auto key_iter = table_keys.find(table.field_names[i]);
+      if (key_iter != table_keys.end() &&
+          key_iter->second.type != ImportDataType::kUnsupported) {
+        fields_.emplace_back(table.field_indexes[i], &key_iter->second);
+      }
+    }
+  }
+
+  katana::Result<void> AddRow(MYSQL_ROW row, const unsigned long* lengths) {
+    if (table_.is_node) {
+      return AddNodeRow(row, lengths);
+    }
+    return AddEdgeRow(row, lengths);
+  }
+
+private:
+  static std::string Field(
+      MYSQL_ROW row, const unsigned long* lengths, size_t index) {
+    return row[index] != NULL ? std::string{row[index], lengths[index]}
+                              : std::string{};
+  }
+
+  template <typename AddValueFn>
+  katana::Result<void> AddValues(
+      MYSQL_ROW row, const unsigned long* lengths, AddValueFn add_value) {
+    for (const auto& [index, key] : fields_) {
+      // if the data is null then do not add it
+      if (row[index] == NULL) {
+        continue;
+      }
+      ImportData value =
+          ResolveValue(Field(row, lengths, index), key->type, key->is_list);
+      if (value.type != ImportDataType::kUnsupported) {
+        KATANA_CHECKED(add_value(key->name, std::move(value)));
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> AddNodeRow(MYSQL_ROW row, const unsigned long* lengths) {
+    // if table has a primary key, add it as node's ID
+    auto primary_index = table_.primary_key_index;
+    std::string id =
+        primary_index >= 0
+            ? table_.name + Field(row, lengths, primary_index)
+            : fmt::format("unkeyed:{}:{}", shard_index_, unkeyed_nodes_++);
+    shard_->AddNode(id);
+    KATANA_CHECKED(shard_->AddNodeLabel(
+        ConversionKeys::Label(keys_.node_labels, table_.name)));
+    KATANA_CHECKED(AddValues(
+        row, lengths, [this](const std::string& name, ImportData value) {
+          return shard_->AddNodeValue(name, std::move(value));
+        }));
+
+    // if table has outgoing edges, add them
+    for (const auto& relation : table_.out_references) {
+      auto foreign_index = relation.source_index;
+      // if the target is null then do not add an edge
+      if (row[foreign_index] != NULL) {
+        shard_->AddEdge(
+            id, relation.target_table + Field(row, lengths, foreign_index));
+        KATANA_CHECKED(shard_->AddEdgeType(
+            ConversionKeys::Label(keys_.edge_labels, relation.label)));
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> AddEdgeRow(MYSQL_ROW row, const unsigned long* lengths) {
+    // if the source or target is null then add a placeholder node
+    std::vector<std::string> endpoints;
+    for (const auto& relation : table_.out_references) {
+      endpoints.emplace_back(
+          relation.target_table + Field(row, lengths, relation.source_index));
+    }
+    if (endpoints.size() != 2) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge table {} has {} foreign keys instead of 2", table_.name,
+          endpoints.size());
+    }
+    shard_->AddEdge(std::move(endpoints[0]), std::move(endpoints[1]));
+    KATANA_CHECKED(shard_->AddEdgeType(
+        ConversionKeys::Label(keys_.edge_labels, table_.name)));
+    return AddValues(
+        row, lengths, [this](const std::string& name, ImportData value) {
+          return shard_->AddEdgeValue(name, std::move(value));
+        });
+  }
+
+  const ConversionKeys& keys_;
+  const TableData& table_;
+  katana::ShardedPropertyGraphBuilder::Shard* shard_;
+  size_t shard_index_;
+  /// (field index, property key) of the fields that become properties
+  std::vector<std::pair<size_t, const PropertyKey*>> fields_;
+  size_t unkeyed_nodes_{0};
+};
+
+/// Read a range of a table a page at a time into converter. Ranges of tables
+/// without a single primary key are read with one query.
+katana::Result<void>
+ScanRange(MYSQL* con, const KeyRange& range, RowConverter* converter) {
+  const TableData& table = *range.table;
+  if (table.num_primary_keys != 1) {
+    MysqlRes rows = RunQuery(con, GenerateFetchTableQuery(table.name));
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(rows.res))) {
+      KATANA_CHECKED(converter->AddRow(row, mysql_fetch_lengths(rows.res)));
+    }
+    return katana::ResultSuccess();
+  }
+
+  auto primary_index = table.primary_key_index;
+  std::optional<std::string> last;
+  while (true) {
+    MysqlRes page = StoreQuery(con, GenerateFetchPageQuery(con, range, last));
+    uint64_t num_rows = mysql_num_rows(page.res);
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(page.res))) {
+      auto lengths = mysql_fetch_lengths(page.res);
+      KATANA_CHECKED(converter->AddRow(row, lengths));
+      last = std::string{row[primary_index], lengths[primary_index]};
+    }
+    if (num_rows < kPageRows) {
+      return katana::ResultSuccess();
+    }
+  }
+}
+
+/// Scan the ranges in parallel, each into a new shard of builder. Each thread
+/// reads with a connection of its own, which it opens for its first range.
+katana::Result<void>
+ScanRanges(
+    const std::vector<KeyRange>& ranges, const ConversionKeys& keys,
+    katana::ShardedPropertyGraphBuilder* builder, const std::string& db_name,
+    const std::string& host, const std::string& user,
+    const std::string& password) {
+  size_t first_shard = builder->AddShards(ranges.size());
+  std::vector<katana::Result<void>> results(
+      ranges.size(), katana::ResultSuccess());
+  std::vector<MYSQL*> connections(katana::getActiveThreads(), nullptr);
+
+  katana::do_all(
+      katana::iterate(size_t{0}, ranges.size()),
+      [&](size_t r) {
+        MYSQL*& con = connections[katana::ThreadPool::getTID()];
+        if (con == nullptr) {
+          con = Connect(host, user, password, db_name);
+        }
+        RowConverter converter(
+            keys, *ranges[r].table, builder->GetShard(first_shard + r),
+            first_shard + r);
+        results[r] = ScanRange(con, ranges[r], &converter);
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+  katana::on_each([&](unsigned tid, unsigned) {
+    if (connections[tid] != nullptr) {
+      mysql_close(connections[tid]);
+    }
+    // the calling thread keeps using the client library
+    if (tid != 0) {
+      mysql_thread_end();
+    }
+  });
+
+  for (auto& res : results) {
+    if (!res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 }  // end of unnamed namespace
 
 GraphComponents
@@ -863,16 +1251,7 @@ katana::ConvertMysql(
   katana::PropertyGraphBuilder builder{chunk_size};
   std::string password{getpass("MySQL Password: ")};
 
-  MYSQL* con = mysql_init(NULL);
-  if (con == nullptr) {
-    KATANA_LOG_FATAL("mysql_init() failed");
-  }
-  if (mysql_real_connect(
-          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
-          NULL, 0) == NULL) {
-    KATANA_LOG_FATAL(
-        "Could not establish mysql connection: {}", mysql_error(con));
-  }
+  MYSQL* con = Connect(host, user, password, db_name);
   std::vector<std::string> table_names = FetchTableNames(con);
   std::unordered_map<std::string, TableData> table_data;
   if (!mapping.empty()) {
@@ -901,22 +1280,78 @@ katana::ConvertMysql(
   return out;
 }
 
+GraphComponents
+katana::ConvertMysqlParallel(
+    const std::string& db_name, const std::string& mapping,
+    const size_t chunk_size, const std::string& host, const std::string& user) {
+  std::string password{getpass("MySQL Password: ")};
+
+  // connecting here first also initializes the client library before other
+  // threads use it
+  MYSQL* con = Connect(host, user, password, db_name);
+  std::vector<std::string> table_names = FetchTableNames(con);
+  ConversionKeys keys;
+  std::unordered_map<std::string, TableData> table_data;
+  if (!mapping.empty()) {
+    auto [rules, property_keys] =
+        katana::graphml::ProcessSchemaMapping(mapping);
+    table_data =
+        PreprocessTables(con, &keys, table_names, rules, property_keys);
+  } else {
+    table_data = PreprocessTables(con, &keys, table_names);
+  }
+
+  katana::ShardedPropertyGraphBuilder builder(1, chunk_size);
+  auto* first = builder.GetShard(0);
+  for (const auto& [id, key] : keys.node_keys) {
+    if (auto res = first->DeclareNodeProperty(key.name, key.type, key.is_list);
+        !res) {
+      KATANA_LOG_WARN("ignoring node property {}: {}", key.name, res.error());
+    }
+  }
+  for (const auto& [id, key] : keys.edge_keys) {
+    if (auto res = first->DeclareEdgeProperty(key.name, key.type, key.is_list);
+        !res) {
+      KATANA_LOG_WARN("ignoring edge property {}: {}", key.name, res.error());
+    }
+  }
+
+  // split tables in the order of their names, so that nodes are numbered the
+  // same way by every run
+  std::vector<KeyRange> ranges;
+  for (const auto& table_name : table_names) {
+    auto table_ranges = SplitTable(
+        con, table_data.at(table_name),
+        kRangesPerThread * katana::getActiveThreads());
+    std::move(
+        table_ranges.begin(), table_ranges.end(), std::back_inserter(ranges));
+  }
+  mysql_close(con);
+
+  std::cout << "Scanning " << table_names.size() << " tables in "
+            << ranges.size() << " ranges\n";
+  if (auto res = ScanRanges(
+          ranges, keys, &builder, db_name, host, user, password);
+      !res) {
+    KATANA_LOG_FATAL("Failed to scan tables: {}", res.error());
+  }
+
+  auto out_result = builder.Finish();
+  if (!out_result) {
+    KATANA_LOG_FATAL("Failed to construct graph: {}", out_result.error());
+  }
+  katana::GraphComponents out = std::move(out_result.value());
+  out.Dump();
+  return out;
+}
+
 void
 katana::GenerateMappingMysql(
     const std::string& db_name, const std::string& outfile,
     const std::string& host, const std::string& user) {
   std::string password{getpass("MySQL Password: ")};
 
-  MYSQL* con = mysql_init(NULL);
-  if (con == nullptr) {
-    KATANA_LOG_FATAL("mysql_init() failed");
-  }
-  if (mysql_real_connect(
-          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
-          NULL, 0) == NULL) {
-    KATANA_LOG_FATAL(
-        "Could not establish mysql connection: {}", mysql_error(con));
-  }
+  MYSQL* con = Connect(host, user, password, db_name);
   std::vector<std::string> table_names = FetchTableNames(con);
 
   // get user input on node/edge mappings, label names, property names and
@@ -8,6 +8,15 @@ namespace katana {
 GraphComponents ConvertMysql(
     const std::string& db_name, const std::string& mapping,
     const size_t chunk_size, const std::string& host, const std::string& user);
+/// ConvertMysqlParallel converts a database like ConvertMysql, but reads it
+/// with all active threads, each with a connection of its own. Tables are
+/// split into ranges of their integer primary keys, and each range is read in
+/// pages ordered by the key, each page starting after the last key of the one
+/// before, so no query holds the server for a whole table. Rows are built
+/// into the shards of a ShardedPropertyGraphBuilder.
+GraphComponents ConvertMysqlParallel(
+    const std::string& db_name, const std::string& mapping,
+    const size_t chunk_size, const std::string& host, const std::string& user);
 void GenerateMappingMysql(
     const std::string& db_name, const std::string& outfile,
     const std::string& host, const std::string& user);
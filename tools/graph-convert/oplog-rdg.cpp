@@ -1,4 +1,48 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+#include <llvm/Support/CommandLine.h>
+#include <nlohmann/json.hpp>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ArrowVisitor.h"
 #include "katana/BuildGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace cll = llvm::cl;
+
+namespace {
+
+cll::opt<std::string> input_rdg(
+    cll::Positional,
+    cll::desc("<input rdg> (if absent, write a sample RDG to /tmp)"),
+    cll::init(""));
+cll::opt<std::string> oplog_file(
+    cll::Positional, cll::desc("<oplog file, or - for stdin>"), cll::init("-"));
+cll::opt<std::string> id_property(
+    "id-property",
+    cll::desc("Node property with the IDs that operations name nodes by; by "
+              "default nodes are named by their numbers"),
+    cll::init(""));
+cll::opt<int> batch_size(
+    "batch-size",
+    cll::desc("Number of operations applied and committed at a time "
+              "(default value 10000)"),
+    cll::init(10000));
+cll::opt<int> num_threads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
 
 constexpr uint64_t kNumNodes = 100;
 
@@ -89,11 +133,682 @@ ReadLog() {
   lp.CreateRDG();
 }
 
+/*********************************************/
+/* Functions for applying oplogs to an RDG   */
+/*********************************************/
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// The values a batch sets in one property column, by row. A null scalar
+/// clears the row.
+struct ColumnPatch {
+  std::shared_ptr<arrow::DataType> type;
+  std::unordered_map<uint64_t, std::shared_ptr<arrow::Scalar>> values;
+};
+
+/// Patches by property name
+using Patches = std::map<std::string, ColumnPatch>;
+
+std::string
+IdOf(const nlohmann::json& id) {
+  return id.is_string() ? id.get<std::string>() : id.dump();
+}
+
+std::shared_ptr<arrow::DataType>
+InferType(const nlohmann::json& value) {
+  if (value.is_boolean()) {
+    return arrow::boolean();
+  }
+  if (value.is_number_integer()) {
+    return arrow::int64();
+  }
+  if (value.is_number_float()) {
+    return arrow::float64();
+  }
+  if (value.is_string()) {
+    return arrow::utf8();
+  }
+  return nullptr;
+}
+
+/// Convert a JSON value to a scalar of type, or to null if the value is null
+katana::Result<std::shared_ptr<arrow::Scalar>>
+ToScalar(
+    const nlohmann::json& value, const std::shared_ptr<arrow::DataType>& type) {
+  std::shared_ptr<arrow::Scalar> scalar;
+  if (value.is_null()) {
+    return scalar;
+  } else if (value.is_boolean()) {
+    scalar = std::make_shared<arrow::BooleanScalar>(value.get<bool>());
+  } else if (value.is_number_integer()) {
+    scalar = std::make_shared<arrow::Int64Scalar>(value.get<int64_t>());
+  } else if (value.is_number_float()) {
+    scalar = std::make_shared<arrow::DoubleScalar>(value.get<double>());
+  } else if (value.is_string()) {
+    scalar = std::make_shared<arrow::StringScalar>(value.get<std::string>());
+  } else {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "unsupported value {}",
+        value.dump());
+  }
+  if (!scalar->type->Equals(type)) {
+    scalar = KATANA_CHECKED_CONTEXT(
+        scalar->CastTo(type), "converting {} to {}", value.dump(),
+        type->ToString());
+  }
+  return scalar;
+}
+
+/// Build a column with a row for each entry of origins: the value that patch
+/// sets for the origin, if any, or else row origin of column, or null if the
+/// column is shorter
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+BuildColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::shared_ptr<arrow::DataType>& type, const ColumnPatch* patch,
+    const katana::NUMAArray<uint64_t>& origins) {
+  uint64_t old_length = column ? static_cast<uint64_t>(column->length()) : 0;
+
+  // rows of the patch, after the rows of the column, or -1 to clear
+  std::unordered_map<uint64_t, int64_t> patched;
+  std::vector<std::shared_ptr<arrow::Scalar>> scalars;
+  if (patch != nullptr) {
+    for (const auto& [origin, scalar] : patch->values) {
+      if (scalar == nullptr) {
+        patched.emplace(origin, -1);
+      } else {
+        patched.emplace(origin, old_length + scalars.size());
+        scalars.emplace_back(scalar);
+      }
+    }
+  }
+
+  std::vector<int64_t> indices(origins.size());
+  std::vector<uint8_t> valid(origins.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, origins.size()),
+      [&](size_t i) {
+        uint64_t origin = origins[i];
+        int64_t index = origin < old_length ? origin : -1;
+        if (!patched.empty()) {
+          if (auto it = patched.find(origin); it != patched.end()) {
+            index = it->second;
+          }
+        }
+        indices[i] = index;
+        valid[i] = index >= 0;
+      },
+      katana::no_stats());
+
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  if (column) {
+    chunks = column->chunks();
+  }
+  if (!scalars.empty()) {
+    chunks.emplace_back(
+        KATANA_CHECKED(katana::ArrayFromScalars(scalars, type)));
+  }
+  if (chunks.empty()) {
+    return katana::NullChunkedArray(type, origins.size());
+  }
+
+  arrow::Int64Builder builder;
+  KATANA_CHECKED(
+      builder.AppendValues(indices.data(), indices.size(), valid.data()));
+  std::shared_ptr<arrow::Array> take_indices = KATANA_CHECKED(builder.Finish());
+  auto values = KATANA_CHECKED(arrow::ChunkedArray::Make(chunks, type));
+  return KATANA_CHECKED(arrow::compute::Take(values, take_indices))
+      .chunked_array();
+}
+
+/// Build the columns of properties whose rows are origins: all columns of pg
+/// if all_columns is set and otherwise the columns that patches change
+katana::Result<std::shared_ptr<arrow::Table>>
+BuildColumns(
+    const std::shared_ptr<arrow::Table>& table, const Patches& patches,
+    const katana::NUMAArray<uint64_t>& origins, bool all_columns) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  if (all_columns) {
+    for (int i = 0; i < table->num_columns(); ++i) {
+      const auto& field = table->field(i);
+      auto it = patches.find(field->name());
+      fields.emplace_back(field);
+      columns.emplace_back(KATANA_CHECKED_CONTEXT(
+          BuildColumn(
+              table->column(i), field->type(),
+              it == patches.end() ? nullptr : &it->second, origins),
+          "property {}", field->name()));
+    }
+  }
+  for (const auto& [name, patch] : patches) {
+    auto column = table->GetColumnByName(name);
+    if (all_columns && column != nullptr) {
+      continue;
+    }
+    fields.emplace_back(arrow::field(name, patch.type));
+    columns.emplace_back(KATANA_CHECKED_CONTEXT(
+        BuildColumn(column, patch.type, &patch, origins), "property {}",
+        name));
+  }
+  return arrow::Table::Make(
+      arrow::schema(fields), columns, static_cast<int64_t>(origins.size()));
+}
+
+katana::NUMAArray<uint64_t>
+IdentityOrigins(uint64_t size) {
+  katana::NUMAArray<uint64_t> origins;
+  origins.allocateInterleaved(size);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, size), [&](uint64_t i) { origins[i] = i; },
+      katana::no_stats());
+  return origins;
+}
+
+/// Applies batches of oplog operations to a graph and commits each batch as
+/// a new version of its RDG.
+///
+/// Each operation is a JSON object; "op" is "insert", "update" or "delete".
+/// Nodes are named by "node" and edges by "source" and "target" (the first
+/// such edge). "properties" maps property names to values, and the names in
+/// "labels" of a node or "type" of an edge are boolean properties that
+/// inserts and updates set. Inserted nodes are numbered after the existing
+/// ones and deleted nodes lose their edges and properties but keep their
+/// numbers, so that the other nodes keep theirs.
+///
+/// During a batch, updates of properties are kept in patches of their
+/// columns and edge insertions and deletions in an overlay of the topology.
+/// Committing rebuilds only the columns that the batch changed, or all of
+/// the columns of nodes (edges) if their number or order changed, along with
+/// the topology if it changed, so the commit writes only those.
+class OplogApplier {
+public:
+  OplogApplier(katana::PropertyGraph* pg, std::string id_property)
+      : pg_(pg),
+        id_property_(std::move(id_property)),
+        num_nodes_(pg->topology().num_nodes()) {}
+
+  /// Map the IDs of the nodes to their numbers
+  katana::Result<void> LoadIds() {
+    if (id_property_.empty()) {
+      return katana::ResultSuccess();
+    }
+    auto ids = pg_->GetNodeProperty(id_property_);
+    if (!ids) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no node property {}",
+          id_property_);
+    }
+    if (ids->type()->id() != arrow::Type::STRING) {
+      ids = KATANA_CHECKED_CONTEXT(
+                arrow::compute::Cast(ids, arrow::utf8()),
+                "casting property {} to strings", id_property_)
+                .chunked_array();
+    }
+    Node node = 0;
+    for (const auto& chunk : ids->chunks()) {
+      const auto& strings = static_cast<const arrow::StringArray&>(*chunk);
+      for (int64_t i = 0; i < strings.length(); ++i, ++node) {
+        if (strings.IsValid(i)) {
+          node_ids_.emplace(strings.GetString(i), node);
+        }
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> Apply(const nlohmann::json& op) {
+    if (!op.is_object()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "operation is not an object");
+    }
+    std::string kind = op.value("op", "");
+    nlohmann::json properties =
+        op.value("properties", nlohmann::json::object());
+    nlohmann::json labels = op.value("labels", nlohmann::json::array());
+    if (op.contains("source") || op.contains("target")) {
+      if (op.contains("type")) {
+        labels.emplace_back(op["type"]);
+      }
+      return ApplyEdge(
+          kind, op.value("source", nlohmann::json()),
+          op.value("target", nlohmann::json()), properties, labels);
+    }
+    if (!op.contains("node")) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "operation names neither a node nor an edge");
+    }
+    return ApplyNode(kind, op["node"], properties, labels);
+  }
+
+  size_t num_operations() const { return num_operations_; }
+
+  /// Write the changes of the batch as a new version of the RDG
+  katana::Result<void> Commit(const std::string& command_line) {
+    const katana::GraphTopology& topo = pg_->topology();
+    bool nodes_changed = num_nodes_ != topo.num_nodes();
+    bool topology_changed = nodes_changed || !deleted_nodes_.empty() ||
+                            !removed_edges_.empty() || !added_edges_.empty();
+
+    // deleted nodes lose all of their properties
+    if (!deleted_nodes_.empty()) {
+      for (const auto& field : pg_->loaded_node_schema()->fields()) {
+        node_patches_[field->name()].type = field->type();
+      }
+      for (auto& [name, patch] : node_patches_) {
+        for (Node n : deleted_nodes_) {
+          patch.values[n] = nullptr;
+        }
+      }
+    }
+
+    std::shared_ptr<arrow::Table> node_props;
+    if (nodes_changed || !node_patches_.empty()) {
+      node_props = KATANA_CHECKED_CONTEXT(
+          BuildColumns(
+              pg_->node_properties(), node_patches_,
+              IdentityOrigins(num_nodes_), nodes_changed),
+          "node properties");
+    }
+
+    if (topology_changed) {
+      katana::NUMAArray<uint64_t> edge_origins;
+      katana::GraphTopology next = BuildTopology(&edge_origins);
+      auto edge_props = KATANA_CHECKED_CONTEXT(
+          BuildColumns(
+              pg_->edge_properties(), edge_patches_, edge_origins, true),
+          "edge properties");
+      KATANA_CHECKED(
+          pg_->ReplaceTopology(std::move(next), node_props, edge_props));
+    } else {
+      if (node_props != nullptr) {
+        KATANA_CHECKED(pg_->UpsertNodeProperties(node_props));
+      }
+      if (!edge_patches_.empty()) {
+        auto edge_props = KATANA_CHECKED_CONTEXT(
+            BuildColumns(
+                pg_->edge_properties(), edge_patches_,
+                IdentityOrigins(topo.num_edges()), false),
+            "edge properties");
+        KATANA_CHECKED(pg_->UpsertEdgeProperties(edge_props));
+      }
+    }
+    KATANA_CHECKED(pg_->Commit(command_line));
+
+    node_patches_.clear();
+    edge_patches_.clear();
+    deleted_nodes_.clear();
+    removed_edges_.clear();
+    added_edges_.clear();
+    added_out_.clear();
+    num_operations_ = 0;
+    return katana::ResultSuccess();
+  }
+
+private:
+  /// An edge inserted by the batch
+  struct AddedEdge {
+    Node src;
+    Node dst;
+    bool removed;
+  };
+
+  katana::Result<void> ApplyNode(
+      const std::string& kind, const nlohmann::json& id,
+      const nlohmann::json& properties, const nlohmann::json& labels) {
+    ++num_operations_;
+    if (kind == "insert") {
+      if (!id_property_.empty() && node_ids_.count(IdOf(id)) > 0) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AlreadyExists, "node {} exists", IdOf(id));
+      }
+      Node n = KATANA_CHECKED(AddNode(id));
+      return SetValues(
+          &node_patches_, *pg_->loaded_node_schema(), n, properties, labels);
+    }
+    Node n = KATANA_CHECKED(FindNode(id));
+    if (kind == "update") {
+      return SetValues(
+          &node_patches_, *pg_->loaded_node_schema(), n, properties, labels);
+    }
+    if (kind == "delete") {
+      DeleteNode(n);
+      node_ids_.erase(IdOf(id));
+      return katana::ResultSuccess();
+    }
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown operation {}", kind);
+  }
+
+  katana::Result<void> ApplyEdge(
+      const std::string& kind, const nlohmann::json& source,
+      const nlohmann::json& target, const nlohmann::json& properties,
+      const nlohmann::json& labels) {
+    ++num_operations_;
+    if (kind == "insert") {
+      Node src = KATANA_CHECKED(FindOrAddNode(source));
+      Node dst = KATANA_CHECKED(FindOrAddNode(target));
+      uint64_t row = AddEdge(src, dst);
+      return SetValues(
+          &edge_patches_, *pg_->loaded_edge_schema(), row, properties, labels);
+    }
+    Node src = KATANA_CHECKED(FindNode(source));
+    Node dst = KATANA_CHECKED(FindNode(target));
+    uint64_t row = KATANA_CHECKED(FindEdge(src, dst));
+    if (kind == "update") {
+      return SetValues(
+          &edge_patches_, *pg_->loaded_edge_schema(), row, properties, labels);
+    }
+    if (kind == "delete") {
+      RemoveEdge(row);
+      return katana::ResultSuccess();
+    }
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown operation {}", kind);
+  }
+
+  katana::Result<Node> FindNode(const nlohmann::json& id) const {
+    if (id_property_.empty()) {
+      if (id.is_number_unsigned() && id.get<uint64_t>() < num_nodes_ &&
+          deleted_nodes_.count(id.get<uint64_t>()) == 0) {
+        return static_cast<Node>(id.get<uint64_t>());
+      }
+    } else if (auto it = node_ids_.find(IdOf(id)); it != node_ids_.end()) {
+      return it->second;
+    }
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "no node {}", id.dump());
+  }
+
+  /// Find a node or, like the graph builders, add a node without properties
+  /// for an edge to refer to
+  katana::Result<Node> FindOrAddNode(const nlohmann::json& id) {
+    if (id_property_.empty()) {
+      return FindNode(id);
+    }
+    if (auto it = node_ids_.find(IdOf(id)); it != node_ids_.end()) {
+      return it->second;
+    }
+    return AddNode(id);
+  }
+
+  katana::Result<Node> AddNode(const nlohmann::json& id) {
+    Node n = num_nodes_;
+    if (!id_property_.empty()) {
+      auto& patch = node_patches_[id_property_];
+      if (!patch.type) {
+        auto field = pg_->loaded_node_schema()->GetFieldByName(id_property_);
+        patch.type = field ? field->type() : arrow::utf8();
+      }
+      patch.values[n] = KATANA_CHECKED_CONTEXT(
+          ToScalar(id, patch.type), "ID of node {}", n);
+      node_ids_.emplace(IdOf(id), n);
+    }
+    ++num_nodes_;
+    return n;
+  }
+
+  void DeleteNode(Node n) {
+    deleted_nodes_.insert(n);
+    const katana::GraphTopology& topo = pg_->topology();
+    if (n < topo.num_nodes()) {
+      for (auto e : topo.edges(n)) {
+        removed_edges_.insert(e);
+      }
+    }
+    if (auto it = added_out_.find(n); it != added_out_.end()) {
+      for (size_t index : it->second) {
+        added_edges_[index].removed = true;
+      }
+    }
+    // edges to n are dropped when the topology is rebuilt
+  }
+
+  /// \returns the row of the new edge, which follows the edges of the graph
+  uint64_t AddEdge(Node src, Node dst) {
+    added_out_[src].emplace_back(added_edges_.size());
+    added_edges_.emplace_back(AddedEdge{src, dst, false});
+    return pg_->topology().num_edges() + added_edges_.size() - 1;
+  }
+
+  void RemoveEdge(uint64_t row) {
+    uint64_t num_edges = pg_->topology().num_edges();
+    if (row < num_edges) {
+      removed_edges_.insert(row);
+    } else {
+      added_edges_[row - num_edges].removed = true;
+    }
+  }
+
+  /// \returns the row of the first edge from src to dst
+  katana::Result<uint64_t> FindEdge(Node src, Node dst) const {
+    const katana::GraphTopology& topo = pg_->topology();
+    if (src < topo.num_nodes()) {
+      for (auto e : topo.edges(src)) {
+        if (topo.edge_dest(e) == dst && removed_edges_.count(e) == 0) {
+          return e;
+        }
+      }
+    }
+    if (auto it = added_out_.find(src); it != added_out_.end()) {
+      for (size_t index : it->second) {
+        if (added_edges_[index].dst == dst && !added_edges_[index].removed) {
+          return topo.num_edges() + index;
+        }
+      }
+    }
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "no edge from node {} to node {}", src,
+        dst);
+  }
+
+  katana::Result<void> SetValues(
+      Patches* patches, const arrow::Schema& schema, uint64_t row,
+      const nlohmann::json& properties, const nlohmann::json& labels) {
+    if (!properties.is_object() || !labels.is_array()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "properties must be an object and labels an array");
+    }
+    auto set = [&](const std::string& name,
+                   const nlohmann::json& value) -> katana::Result<void> {
+      auto it = patches->find(name);
+      if (it == patches->end()) {
+        auto field = schema.GetFieldByName(name);
+        std::shared_ptr<arrow::DataType> type =
+            field ? field->type() : InferType(value);
+        if (!type) {
+          // a null value of a new property changes nothing
+          if (value.is_null()) {
+            return katana::ResultSuccess();
+          }
+          return KATANA_ERROR(
+              katana::ErrorCode::NotImplemented,
+              "cannot make a property {} of {}", name, value.dump());
+        }
+        it = patches->emplace(name, ColumnPatch{type, {}}).first;
+      }
+      it->second.values[row] = KATANA_CHECKED_CONTEXT(
+          ToScalar(value, it->second.type), "property {}", name);
+      return katana::ResultSuccess();
+    };
+    for (const auto& [name, value] : properties.items()) {
+      KATANA_CHECKED(set(name, value));
+    }
+    for (const auto& label : labels) {
+      if (!label.is_string()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "label {} is not a string",
+            label.dump());
+      }
+      KATANA_CHECKED(set(label.get<std::string>(), true));
+    }
+    return katana::ResultSuccess();
+  }
+
+  /// Build the topology with the overlay applied: the remaining edges of
+  /// each node of the graph in order and then those the batch inserted.
+  /// origins gets the row of each edge before the commit.
+  katana::GraphTopology BuildTopology(katana::NUMAArray<uint64_t>* origins) {
+    const katana::GraphTopology& topo = pg_->topology();
+    uint64_t base_nodes = topo.num_nodes();
+    uint64_t base_edges = topo.num_edges();
+    auto keep = [&](uint64_t row, Node dst) {
+      if (deleted_nodes_.count(dst) > 0) {
+        return false;
+      }
+      return row < base_edges ? removed_edges_.count(row) == 0
+                              : !added_edges_[row - base_edges].removed;
+    };
+    // visit(row, dst) for each edge of n that remains
+    auto for_each_edge = [&](Node n, auto visit) {
+      if (deleted_nodes_.count(n) > 0) {
+        return;
+      }
+      if (n < base_nodes) {
+        for (auto e : topo.edges(n)) {
+          if (keep(e, topo.edge_dest(e))) {
+            visit(e, topo.edge_dest(e));
+          }
+        }
+      }
+      if (auto it = added_out_.find(n); it != added_out_.end()) {
+        for (size_t index : it->second) {
+          if (keep(base_edges + index, added_edges_[index].dst)) {
+            visit(base_edges + index, added_edges_[index].dst);
+          }
+        }
+      }
+    };
+
+    katana::NUMAArray<Edge> adj_indices;
+    adj_indices.allocateInterleaved(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          Edge degree = 0;
+          for_each_edge(n, [&](uint64_t, Node) { ++degree; });
+          adj_indices[n] = degree;
+        },
+        katana::steal(), katana::no_stats());
+    Edge num_edges = 0;
+    for (uint64_t n = 0; n < num_nodes_; ++n) {
+      num_edges += adj_indices[n];
+      adj_indices[n] = num_edges;
+    }
+
+    katana::NUMAArray<Node> dests;
+    dests.allocateInterleaved(num_edges);
+    origins->allocateInterleaved(num_edges);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          Edge e = n == 0 ? 0 : adj_indices[n - 1];
+          for_each_edge(n, [&](uint64_t row, Node dst) {
+            dests[e] = dst;
+            (*origins)[e] = row;
+            ++e;
+          });
+        },
+        katana::steal(), katana::no_stats());
+    return katana::GraphTopology(std::move(adj_indices), std::move(dests));
+  }
+
+  katana::PropertyGraph* pg_;
+  std::string id_property_;
+  std::unordered_map<std::string, Node> node_ids_;
+  /// the number of nodes with those the batch inserted
+  uint64_t num_nodes_;
+  size_t num_operations_{0};
+
+  Patches node_patches_;
+  /// patches of edges by row, where inserted edges follow those of the graph
+  Patches edge_patches_;
+  std::unordered_set<Node> deleted_nodes_;
+  std::unordered_set<Edge> removed_edges_;
+  std::vector<AddedEdge> added_edges_;
+  /// indexes in added_edges_ by source
+  std::unordered_map<Node, std::vector<size_t>> added_out_;
+};
+
+katana::Result<void>
+CommitBatch(OplogApplier* applier, const std::string& command_line) {
+  auto start = std::chrono::steady_clock::now();
+  size_t num_operations = applier->num_operations();
+  KATANA_CHECKED(applier->Commit(command_line));
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  fmt::print(
+      "committed {} operations in {:.3f}s\n", num_operations, elapsed.count());
+  return katana::ResultSuccess();
+}
+
+void
+ApplyLog(const std::string& command_line) {
+  auto pg_result = katana::PropertyGraph::Make(input_rdg);
+  if (!pg_result) {
+    KATANA_LOG_FATAL("Failed to load {}: {}", input_rdg, pg_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_result.value());
+  OplogApplier applier(pg.get(), id_property);
+  if (auto res = applier.LoadIds(); !res) {
+    KATANA_LOG_FATAL("Failed to load node IDs: {}", res.error());
+  }
+
+  std::ifstream file;
+  if (oplog_file != "-") {
+    file.open(oplog_file);
+    if (!file) {
+      KATANA_LOG_FATAL("Failed to open {}", oplog_file);
+    }
+  }
+  std::istream& in = oplog_file == "-" ? std::cin : file;
+
+  std::string line;
+  for (size_t line_number = 1; std::getline(in, line); ++line_number) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos) {
+      continue;
+    }
+    auto op = nlohmann::json::parse(line, nullptr, false);
+    if (op.is_discarded()) {
+      KATANA_LOG_FATAL("line {}: not JSON", line_number);
+    }
+    if (auto res = applier.Apply(op); !res) {
+      KATANA_LOG_FATAL("line {}: {}", line_number, res.error());
+    }
+    if (applier.num_operations() == static_cast<size_t>(batch_size)) {
+      if (auto res = CommitBatch(&applier, command_line); !res) {
+        KATANA_LOG_FATAL("Failed to commit: {}", res.error());
+      }
+    }
+  }
+  if (applier.num_operations() > 0) {
+    if (auto res = CommitBatch(&applier, command_line); !res) {
+      KATANA_LOG_FATAL("Failed to commit: {}", res.error());
+    }
+  }
+}
+
+}  // namespace
+
 int
-main() {  //int argc, char* argv[]) {
+main(int argc, char** argv) {
   katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(num_threads);
+
+  if (input_rdg.empty()) {
+    ReadLog();
+    return 0;
+  }
 
-  ReadLog();
+  std::string command_line;
+  for (int i = 0; i < argc; ++i) {
+    command_line += (i == 0 ? "" : " ") + std::string(argv[i]);
+  }
+  ApplyLog(command_line);
 
   return 0;
 }
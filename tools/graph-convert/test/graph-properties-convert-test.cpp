@@ -43,6 +43,14 @@ static cll::opt<ConvertTest> test_type(
 static cll::opt<int> chunk_size(
     "chunkSize", cll::desc("Chunk size for in memory arrow representation"),
     cll::init(25000));
+static cll::opt<bool> parallel(
+    "parallel", cll::desc("Convert GraphML inputs with all threads"),
+    cll::init(false));
+static cll::opt<int> window_size(
+    "windowSize", cll::desc("Bytes of a GraphML input parsed at a time"),
+    cll::init(64 << 20));
+static cll::opt<int> num_threads(
+    "t", cll::desc("Number of threads"), cll::init(1));
 
 namespace {
 
@@ -1268,11 +1276,17 @@ main(int argc, char** argv) {
   katana::SharedMemSys sys;
   llvm::cl::ParseCommandLineOptions(argc, argv);
 
+  katana::setActiveThreads(num_threads);
+
   katana::GraphComponents graph;
 
   switch (fileType) {
   case katana::SourceDatabase::kNeo4j:
-    if (auto r = katana::ConvertGraphML(input_filename, chunk_size, true); !r) {
+    if (auto r = parallel ? katana::ConvertGraphMLParallel(
+                                input_filename, window_size, chunk_size, true)
+                          : katana::ConvertGraphML(
+                                input_filename, chunk_size, true);
+        !r) {
       KATANA_LOG_FATAL(": {}", r.error());
     } else {
       graph = std::move(r.value());
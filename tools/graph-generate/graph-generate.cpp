@@ -0,0 +1,158 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/GraphGenerators.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+enum class Model { kRMAT, kSBM, kGeometric };
+enum class PropertyType { kInt64, kDouble };
+
+static cll::opt<std::string> outputFilename(
+    cll::Positional, cll::desc("<output RDG>"), cll::Required);
+static cll::opt<Model> model(
+    "model", cll::desc("Graph model:"),
+    cll::values(
+        clEnumValN(
+            Model::kRMAT, "rmat",
+            "R-MAT (Graph500 Kronecker with the default -a, -b and -c)"),
+        clEnumValN(Model::kSBM, "sbm", "Stochastic block model"),
+        clEnumValN(
+            Model::kGeometric, "geometric",
+            "Random geometric graph, like road networks")),
+    cll::init(Model::kRMAT));
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Random seed; the same seed gives the same graph"),
+    cll::init(0));
+
+static cll::opt<uint32_t> scale(
+    "scale", cll::desc("rmat: log2 of the number of nodes"), cll::init(20));
+static cll::opt<uint32_t> edgeFactor(
+    "edgeFactor", cll::desc("rmat: edges per node"), cll::init(16));
+static cll::opt<double> rmatA(
+    "a", cll::desc("rmat: probability of quadrant a"), cll::init(0.57));
+static cll::opt<double> rmatB(
+    "b", cll::desc("rmat: probability of quadrant b"), cll::init(0.19));
+static cll::opt<double> rmatC(
+    "c", cll::desc("rmat: probability of quadrant c"), cll::init(0.19));
+static cll::opt<bool> noPermute(
+    "noPermute", cll::desc("rmat: do not renumber the nodes randomly"),
+    cll::init(false));
+static cll::opt<bool> removeDuplicates(
+    "removeDuplicates", cll::desc("rmat: drop self loops and repeated edges"),
+    cll::init(false));
+
+static cll::opt<uint32_t> numNodes(
+    "numNodes", cll::desc("sbm, geometric: number of nodes"),
+    cll::init(1 << 20));
+static cll::opt<uint32_t> numBlocks(
+    "numBlocks", cll::desc("sbm: number of blocks"), cll::init(64));
+static cll::opt<double> pIn(
+    "pIn", cll::desc("sbm: probability of an edge within a block"),
+    cll::init(0.001));
+static cll::opt<double> pOut(
+    "pOut", cll::desc("sbm: probability of an edge across blocks"),
+    cll::init(0.00001));
+static cll::opt<double> avgDegree(
+    "avgDegree", cll::desc("geometric: expected degree"), cll::init(4));
+
+static cll::opt<int> numNodeProperties(
+    "nodeProperties", cll::desc("Number of random node properties"),
+    cll::init(0));
+static cll::opt<int> numEdgeProperties(
+    "edgeProperties", cll::desc("Number of random edge properties"),
+    cll::init(0));
+static cll::opt<PropertyType> propertyType(
+    "propertyType", cll::desc("Type of random properties:"),
+    cll::values(
+        clEnumValN(
+            PropertyType::kInt64, "int64", "Integers in [1, 100] (default)"),
+        clEnumValN(PropertyType::kDouble, "double", "Reals in [0, 1)")),
+    cll::init(PropertyType::kInt64));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
+
+katana::Result<katana::GraphTopology>
+Generate() {
+  switch (model) {
+  case Model::kRMAT: {
+    katana::RMATParams params;
+    params.scale = scale;
+    params.edge_factor = edgeFactor;
+    params.a = rmatA;
+    params.b = rmatB;
+    params.c = rmatC;
+    params.permute = !noPermute;
+    params.remove_duplicates = removeDuplicates;
+    return katana::GenerateRMAT(params, seed);
+  }
+  case Model::kSBM: {
+    katana::SBMParams params;
+    params.num_nodes = numNodes;
+    params.num_blocks = numBlocks;
+    params.p_in = pIn;
+    params.p_out = pOut;
+    return katana::GenerateSBM(params, seed);
+  }
+  case Model::kGeometric: {
+    katana::RandomGeometricParams params;
+    params.num_nodes = numNodes;
+    params.avg_degree = avgDegree;
+    return katana::GenerateRandomGeometric(params, seed);
+  }
+  default:
+    KATANA_DIE("unknown model");
+  }
+}
+
+katana::Result<void>
+GenerateRDG(const std::string& commandLine) {
+  katana::gInfo("Generating topology");
+  auto pg = KATANA_CHECKED(katana::PropertyGraph::Make(
+      KATANA_CHECKED_CONTEXT(Generate(), "generating topology")));
+  katana::gInfo(
+      "Generated ", pg->num_nodes(), " nodes and ", pg->num_edges(), " edges");
+
+  // the properties draw from other streams than the topology
+  std::shared_ptr<arrow::DataType> type =
+      propertyType == PropertyType::kInt64 ? arrow::int64() : arrow::float64();
+  if (numNodeProperties > 0) {
+    auto props = KATANA_CHECKED(katana::GenerateRandomProperties(
+        pg->num_nodes(), numNodeProperties, "node", type, seed + 1));
+    KATANA_CHECKED(pg->AddNodeProperties(props));
+  }
+  if (numEdgeProperties > 0) {
+    auto props = KATANA_CHECKED(katana::GenerateRandomProperties(
+        pg->num_edges(), numEdgeProperties, "edge", type, seed + 2));
+    KATANA_CHECKED(pg->AddEdgeProperties(props));
+  }
+
+  katana::gInfo("Writing ", outputFilename);
+  KATANA_CHECKED_CONTEXT(
+      pg->Write(outputFilename, commandLine), "writing {}", outputFilename);
+  return katana::ResultSuccess();
+}
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys G;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(numThreads);
+
+  std::string commandLine;
+  for (int i = 0; i < argc; ++i) {
+    commandLine += (i == 0 ? "" : " ") + std::string(argv[i]);
+  }
+  if (auto res = GenerateRDG(commandLine); !res) {
+    KATANA_LOG_FATAL("failed to generate graph: {}", res.error());
+  }
+
+  return 0;
+}
@@ -17,19 +17,60 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include <arrow/compute/api.h>
+
 #include "katana/BufferedGraph.h"
 #include "katana/FileGraph.h"
 #include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/NodeOrdering.h"
+#include "katana/PropertyGraph.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
 
+enum class Ordering { kFile, kDegree, kBFS, kRCM, kGorder, kRabbit, kProperty };
+
 static cll::opt<std::string> inputFilename(
     cll::Positional, cll::desc("<input file>"), cll::Required);
 static cll::opt<std::string> mappingFilename(
     cll::Positional, cll::desc("<mapping file>"), cll::Required);
 static cll::opt<std::string> outputFilename(
     cll::Positional, cll::desc("<output file>"), cll::Required);
+static cll::opt<Ordering> ordering(
+    "ordering",
+    cll::desc(
+        "How to order the nodes; computed orders are written to the mapping "
+        "file:"),
+    cll::values(
+        clEnumValN(
+            Ordering::kFile, "file",
+            "Read the order from the mapping file (default)"),
+        clEnumValN(Ordering::kDegree, "degree", "Decreasing out-degree"),
+        clEnumValN(Ordering::kBFS, "bfs", "Breadth-first"),
+        clEnumValN(Ordering::kRCM, "rcm", "Reverse Cuthill-McKee"),
+        clEnumValN(Ordering::kGorder, "gorder", "Gorder"),
+        clEnumValN(Ordering::kRabbit, "rabbit", "Rabbit order"),
+        clEnumValN(
+            Ordering::kProperty, "property",
+            "Increasing values of -orderingProperty (with -rdg)")),
+    cll::init(Ordering::kFile));
+static cll::opt<std::string> orderingProperty(
+    "orderingProperty",
+    cll::desc("Node property whose values order the nodes"), cll::init(""));
+static cll::opt<bool> rdg(
+    "rdg",
+    cll::desc(
+        "The input and output are RDGs, whose node and edge properties are "
+        "permuted with the nodes; the output may be the input to commit a "
+        "new version of it"),
+    cll::init(false));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
 
 using Writer = katana::FileGraphWriter;
 
@@ -73,18 +114,172 @@ createNodeMap() {
   return remapper;
 }
 
+/**
+ * Compute a locality-improving order of the nodes of topo
+ */
+katana::GraphTopologyTypes::PropIndexVec
+computeOrder(const katana::GraphTopology& topo) {
+  switch (ordering) {
+  case Ordering::kDegree:
+    return katana::DegreeOrder(topo);
+  case Ordering::kBFS:
+    return katana::BreadthFirstOrder(topo);
+  case Ordering::kRCM:
+    return katana::ReverseCuthillMcKeeOrder(topo);
+  case Ordering::kGorder:
+    return katana::GorderOrder(topo);
+  case Ordering::kRabbit:
+    return katana::RabbitOrder(topo);
+  default:
+    KATANA_DIE("not a computed ordering");
+  }
+}
+
+/**
+ * Write order to the mapping file in the format read by createNodeMap
+ */
+std::map<uint32_t, uint32_t>
+writeNodeMap(const katana::GraphTopologyTypes::PropIndexVec& order) {
+  std::ofstream mapFile(mappingFilename);
+  std::map<uint32_t, uint32_t> remapper;
+  for (size_t i = 0; i < order.size(); i++) {
+    mapFile << order[i] << "\n";
+    remapper[order[i]] = i;
+  }
+  if (!mapFile) {
+    KATANA_DIE("failed to write file");
+  }
+  return remapper;
+}
+
+/**
+ * Compute a locality-improving node map and write it to the mapping file in
+ * the format read by createNodeMap
+ */
+std::map<uint32_t, uint32_t>
+computeNodeMap(katana::BufferedGraph<void>& graph) {
+  katana::gInfo("Computing node map");
+  std::vector<uint64_t> outIndices(graph.size());
+  std::vector<uint32_t> dests(graph.sizeEdges());
+  for (size_t i = 0; i < graph.size(); i++) {
+    outIndices[i] = *graph.edgeEnd(i);
+    for (auto e = graph.edgeBegin(i); e < graph.edgeEnd(i); e++) {
+      dests[*e] = graph.edgeDestination(*e);
+    }
+  }
+  katana::GraphTopology topo(
+      outIndices.data(), outIndices.size(), dests.data(), dests.size());
+
+  std::map<uint32_t, uint32_t> remapper = writeNodeMap(computeOrder(topo));
+
+  katana::gInfo("Node map computed");
+
+  return remapper;
+}
+
+/**
+ * The nodes of pg by increasing value of orderingProperty, ties broken by id,
+ * with nulls last
+ */
+katana::GraphTopologyTypes::PropIndexVec
+propertyOrder(katana::PropertyGraph* pg) {
+  auto property = pg->GetNodeProperty(orderingProperty);
+  if (!property) {
+    KATANA_DIE("no node property ", orderingProperty);
+  }
+  auto sorted = arrow::compute::SortIndices(*property);
+  if (!sorted.ok()) {
+    KATANA_DIE("failed to sort ", orderingProperty, ": ", sorted.status());
+  }
+  const auto& indices =
+      static_cast<const arrow::UInt64Array&>(*sorted.ValueOrDie());
+
+  katana::GraphTopologyTypes::PropIndexVec order;
+  order.allocateInterleaved(indices.length());
+  katana::do_all(
+      katana::iterate(int64_t{0}, indices.length()),
+      [&](int64_t i) { order[i] = indices.Value(i); }, katana::no_stats());
+  return order;
+}
+
+/**
+ * Renumber the nodes of the input RDG and permute its properties to match,
+ * then write the result to the output RDG or commit it as a new version of
+ * the input
+ */
+void
+remapRDG(const std::string& commandLine) {
+  katana::gInfo("Loading RDG to remap");
+  auto pgResult = katana::PropertyGraph::Make(inputFilename);
+  if (!pgResult) {
+    KATANA_LOG_FATAL("failed to load {}: {}", inputFilename, pgResult.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pgResult.value());
+  katana::gInfo("RDG loaded");
+
+  katana::GraphTopologyTypes::PropIndexVec order;
+  if (ordering == Ordering::kFile) {
+    std::map<uint32_t, uint32_t> remapper = createNodeMap();
+    order.allocateInterleaved(remapper.size());
+    for (const auto& [oldID, newID] : remapper) {
+      order[newID] = oldID;
+    }
+  } else {
+    katana::gInfo("Computing node map");
+    order = ordering == Ordering::kProperty ? propertyOrder(pg.get())
+                                            : computeOrder(pg->topology());
+    writeNodeMap(order);
+    katana::gInfo("Node map computed");
+  }
+
+  katana::gInfo("Remapping topology and properties");
+  if (auto res = katana::ReorderNodes(pg.get(), order); !res) {
+    KATANA_LOG_FATAL("failed to remap: {}", res.error());
+  }
+
+  katana::Result<void> res = outputFilename == inputFilename
+                                 ? pg->Commit(commandLine)
+                                 : pg->Write(outputFilename, commandLine);
+  if (!res) {
+    KATANA_LOG_FATAL("failed to write {}: {}", outputFilename, res.error());
+  }
+  katana::gInfo(
+      "new size is ", pg->num_nodes(), " num edges ", pg->num_edges());
+}
+
 int
 main(int argc, char** argv) {
   katana::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(numThreads);
 
-  std::map<uint32_t, uint32_t> remapper = createNodeMap();
+  if (rdg) {
+    std::string commandLine;
+    for (int i = 0; i < argc; ++i) {
+      commandLine += (i == 0 ? "" : " ") + std::string(argv[i]);
+    }
+    remapRDG(commandLine);
+    return 0;
+  }
+  if (ordering == Ordering::kProperty) {
+    KATANA_DIE("-ordering=property needs -rdg");
+  }
 
   katana::gInfo("Loading graph to remap");
   katana::BufferedGraph<void> graphToRemap;
   graphToRemap.loadGraph(inputFilename);
   katana::gInfo("Graph loaded");
 
+  std::map<uint32_t, uint32_t> remapper = ordering == Ordering::kFile
+                                              ? createNodeMap()
+                                              : computeNodeMap(graphToRemap);
+
+  // the nodes listed in the mapping, by new id
+  std::vector<uint32_t> newToOld(remapper.size());
+  for (const auto& [oldID, newID] : remapper) {
+    newToOld[newID] = oldID;
+  }
+
   Writer graphWriter;
   graphWriter.setNumNodes(remapper.size());
   graphWriter.setNumEdges(graphToRemap.sizeEdges());
@@ -92,39 +287,25 @@ main(int argc, char** argv) {
   // phase 1: count degrees
   graphWriter.phase1();
   katana::gInfo("Starting degree counting");
-  size_t prevNumNodes = graphToRemap.size();
-  size_t nodeIDCounter = 0;
-  for (size_t i = 0; i < prevNumNodes; i++) {
-    // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
-      for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
-           e++) {
-        graphWriter.incrementDegree(nodeIDCounter);
-      }
-      nodeIDCounter++;
+  for (size_t newID = 0; newID < newToOld.size(); newID++) {
+    uint32_t i = newToOld[newID];
+    KATANA_LOG_ASSERT(i < graphToRemap.size());
+    for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i); e++) {
+      graphWriter.incrementDegree(newID);
     }
   }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
 
   // phase 2: edge construction
   graphWriter.phase2();
   katana::gInfo("Starting edge construction");
-  nodeIDCounter = 0;
-  for (size_t i = 0; i < prevNumNodes; i++) {
-    // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
-      for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
-           e++) {
-        uint32_t dst = graphToRemap.edgeDestination(*e);
-        KATANA_LOG_ASSERT(remapper.find(dst) != remapper.end());
-        graphWriter.addNeighbor(nodeIDCounter, remapper[dst]);
-      }
-      nodeIDCounter++;
+  for (size_t newID = 0; newID < newToOld.size(); newID++) {
+    uint32_t i = newToOld[newID];
+    for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i); e++) {
+      uint32_t dst = graphToRemap.edgeDestination(*e);
+      KATANA_LOG_ASSERT(remapper.find(dst) != remapper.end());
+      graphWriter.addNeighbor(newID, remapper[dst]);
     }
   }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
 
   katana::gInfo("Finishing up: outputting graph shortly");
 
@@ -17,14 +17,21 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <iostream>
+#include <map>
 #include <vector>
 
+#include "katana/ArrowInterchange.h"
 #include "katana/Galois.h"
-#include "katana/LCGraph.h"
-#include "katana/OfflineGraph.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
 #include "llvm/Support/CommandLine.h"
+#include "tsuba/RDGPrefix.h"
 
 namespace cll = llvm::cl;
 
@@ -36,11 +43,13 @@ enum StatMode {
   indegreehist,
   sortedlogoffsethist,
   sparsityPattern,
-  summary
+  summary,
+  typesummary,
+  propertysummary
 };
 
 static cll::opt<std::string> inputfilename(
-    cll::Positional, cll::desc("<graph file>"), cll::Required);
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
 static cll::list<StatMode> statModeList(
     cll::desc("Available stats:"),
     cll::values(
@@ -56,55 +65,243 @@ static cll::list<StatMode> statModeList(
             sparsityPattern,
             "Pattern of non-zeros when graph is "
             "interpreted as a sparse matrix"),
-        clEnumVal(summary, "Graph summary")));
+        clEnumVal(summary, "Graph summary"),
+        clEnumVal(typesummary, "Number of nodes and edges of each type"),
+        clEnumVal(
+            propertysummary, "Type, nulls and size of each property")));
 static cll::opt<int> numBins(
     "numBins", cll::desc("Number of bins"), cll::init(-1));
 static cll::opt<int> columns(
     "columns", cll::desc("Columns for sparsity"), cll::init(80));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
+
+typedef katana::PropertyGraph Graph;
+typedef Graph::Node GNode;
+
+/// Which statistics the fused pass over the nodes computes
+struct Requests {
+  bool degree_hist{false};
+  bool max_degree{false};
+  bool in_degrees{false};
+  bool log_offsets{false};
+  bool sparsity{false};
+  bool types{false};
+  bool properties{false};
+
+  /// Whether the out-degrees recorded by an RDGPrefix are enough
+  bool DegreesOnly() const {
+    return !in_degrees && !log_offsets && !sparsity && !types && !properties;
+  }
+};
+
+/// The statistics of the nodes that a thread visits in the fused pass,
+/// merged after it
+struct LocalStats {
+  std::map<uint64_t, uint64_t> degree_hist;
+  std::map<uint64_t, uint64_t> log_offset_hist;
+  uint64_t max_degree{0};
+  uint64_t max_degree_node{0};
+  /// out-edges of the nodes of each most specific type
+  std::vector<uint64_t> edges_by_type;
+  /// sparsity pattern, row major
+  std::vector<bool> pattern;
+  /// scratch space to sort the destinations of a node
+  std::vector<GNode> dests;
+};
+
+/// The statistics of the fused pass
+struct Stats {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  std::map<uint64_t, uint64_t> degree_hist;
+  std::map<uint64_t, uint64_t> log_offset_hist;
+  uint64_t max_degree{0};
+  uint64_t max_degree_node{0};
+  std::vector<uint64_t> edges_by_type;
+  std::vector<bool> pattern;
+  std::vector<std::atomic<uint64_t>> in_degrees;
+};
+
+/// The out-degrees of the nodes, from the RDGPrefix if only degrees are
+/// needed and otherwise from the topology of the loaded graph
+class Degrees {
+public:
+  explicit Degrees(const tsuba::RDGPrefix* prefix) : prefix_(prefix) {}
+  explicit Degrees(const Graph* graph) : graph_(graph) {}
 
-typedef katana::OfflineGraph Graph;
-typedef Graph::GraphNode GNode;
+  uint64_t num_nodes() const {
+    return graph_ ? graph_->num_nodes() : prefix_->num_nodes();
+  }
+  uint64_t num_edges() const {
+    return graph_ ? graph_->num_edges() : prefix_->num_edges();
+  }
+  uint64_t degree(uint64_t n) const {
+    return graph_ ? graph_->topology().edges(n).size() : prefix_->degree(n);
+  }
+  const Graph* graph() const { return graph_; }
+
+private:
+  const tsuba::RDGPrefix* prefix_{nullptr};
+  const Graph* graph_{nullptr};
+};
+
+int
+getLogIndex(ptrdiff_t x) {
+  int logvalue = 0;
+  int sign = x < 0 ? -1 : 1;
+
+  if (x < 0) {
+    x = -x;
+  }
+
+  while ((x >>= 1) != 0) {
+    ++logvalue;
+  }
+  return sign * logvalue;
+}
+
+uint64_t
+sparsityBlockSize(uint64_t num_nodes) {
+  return std::max<uint64_t>((num_nodes + columns - 1) / columns, 1);
+}
+
+/// Compute all of the requested statistics in one parallel pass over the
+/// nodes, with per-thread histograms
+Stats
+computeStats(const Degrees& degrees, const Requests& requests) {
+  Stats stats;
+  stats.num_nodes = degrees.num_nodes();
+  stats.num_edges = degrees.num_edges();
+  const Graph* graph = degrees.graph();
+  size_t num_types = graph ? graph->GetNumNodeEntityTypes() : 0;
+  uint64_t block_size = sparsityBlockSize(stats.num_nodes);
+  if (requests.in_degrees) {
+    stats.in_degrees = std::vector<std::atomic<uint64_t>>(stats.num_nodes);
+  }
+
+  katana::PerThreadStorage<LocalStats> local_stats;
+  katana::on_each([&](unsigned, unsigned) {
+    LocalStats& local = *local_stats.getLocal();
+    if (requests.types) {
+      local.edges_by_type.resize(num_types);
+    }
+    if (requests.sparsity) {
+      local.pattern.resize(columns * columns);
+    }
+  });
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, stats.num_nodes),
+      [&](uint64_t n) {
+        LocalStats& local = *local_stats.getLocal();
+        uint64_t degree = degrees.degree(n);
+        if (requests.degree_hist) {
+          ++local.degree_hist[degree];
+        }
+        if (requests.max_degree &&
+            (degree > local.max_degree ||
+             (degree == local.max_degree && n < local.max_degree_node))) {
+          local.max_degree = degree;
+          local.max_degree_node = n;
+        }
+        if (graph == nullptr) {
+          return;
+        }
+        if (requests.types) {
+          local.edges_by_type[graph->GetTypeOfNode(n)] += degree;
+        }
+
+        const katana::GraphTopology& topology = graph->topology();
+        if (requests.log_offsets) {
+          local.dests.clear();
+        }
+        for (auto e : topology.edges(n)) {
+          GNode dst = topology.edge_dest(e);
+          if (requests.in_degrees) {
+            stats.in_degrees[dst].fetch_add(1, std::memory_order_relaxed);
+          }
+          if (requests.sparsity) {
+            local.pattern[(n / block_size) * columns + dst / block_size] =
+                true;
+          }
+          if (requests.log_offsets) {
+            local.dests.emplace_back(dst);
+          }
+        }
+        if (requests.log_offsets && !local.dests.empty()) {
+          std::sort(local.dests.begin(), local.dests.end());
+          for (size_t i = 1; i < local.dests.size(); ++i) {
+            ptrdiff_t diff = local.dests[i] - (ptrdiff_t)local.dests[i - 1];
+            ++local.log_offset_hist[getLogIndex(diff)];
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("GraphStats"));
+
+  stats.edges_by_type.resize(num_types);
+  if (requests.sparsity) {
+    stats.pattern.resize(columns * columns);
+  }
+  for (unsigned i = 0; i < local_stats.size(); ++i) {
+    const LocalStats& local = *local_stats.getRemote(i);
+    for (const auto& [degree, count] : local.degree_hist) {
+      stats.degree_hist[degree] += count;
+    }
+    for (const auto& [index, count] : local.log_offset_hist) {
+      stats.log_offset_hist[index] += count;
+    }
+    if (local.max_degree > stats.max_degree ||
+        (local.max_degree == stats.max_degree &&
+         local.max_degree_node < stats.max_degree_node)) {
+      stats.max_degree = local.max_degree;
+      stats.max_degree_node = local.max_degree_node;
+    }
+    for (size_t type = 0; type < local.edges_by_type.size(); ++type) {
+      stats.edges_by_type[type] += local.edges_by_type[type];
+    }
+    for (size_t x = 0; x < local.pattern.size(); ++x) {
+      if (local.pattern[x]) {
+        stats.pattern[x] = true;
+      }
+    }
+  }
+  return stats;
+}
 
 void
-doSummary(Graph& graph) {
-  std::cout << "NumNodes: " << graph.size() << "\n";
-  std::cout << "NumEdges: " << graph.sizeEdges() << "\n";
-  std::cout << "SizeofEdge: " << graph.edgeSize() << "\n";
+doSummary(const Stats& stats) {
+  std::cout << "NumNodes: " << stats.num_nodes << "\n";
+  std::cout << "NumEdges: " << stats.num_edges << "\n";
 }
 
 void
-doDegrees(Graph& graph) {
-  for (auto n : graph) {
-    std::cout << graph.edges(n).size() << "\n";
+doDegrees(const Degrees& degrees) {
+  for (uint64_t n = 0; n < degrees.num_nodes(); ++n) {
+    std::cout << degrees.degree(n) << "\n";
   }
 }
 
 void
-findMaxDegreeNode(Graph& graph) {
-  uint64_t nodeId = 0;
-  size_t MaxDegree = 0;
-  uint64_t MaxDegreeNode = 0;
-  for (auto n : graph) {
-    size_t degree = graph.edges(n).size();
-    if (MaxDegree < degree) {
-      MaxDegree = degree;
-      MaxDegreeNode = nodeId;
-    }
-    ++nodeId;
-  }
-  std::cout << "MaxDegreeNode : " << MaxDegreeNode
-            << " , MaxDegree : " << MaxDegree << "\n";
+findMaxDegreeNode(const Stats& stats) {
+  std::cout << "MaxDegreeNode : " << stats.max_degree_node
+            << " , MaxDegree : " << stats.max_degree << "\n";
 }
 
 void
-printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
+printHistogram(
+    const std::string& name, const std::map<uint64_t, uint64_t>& hists) {
+  if (hists.empty()) {
+    std::cout << name << "Bin,Start,End,Count\n";
+    return;
+  }
   auto max = hists.rbegin()->first;
   if (numBins <= 0) {
     std::cout << name << "Bin,Start,End,Count\n";
-    for (unsigned x = 0; x <= max; ++x) {
+    for (uint64_t x = 0; x <= max; ++x) {
       std::cout << x << ',' << x << ',' << x + 1 << ',';
-      if (hists.count(x)) {
-        std::cout << hists[x] << '\n';
+      if (auto it = hists.find(x); it != hists.end()) {
+        std::cout << it->second << '\n';
       } else {
         std::cout << "0\n";
       }
@@ -115,7 +312,6 @@ printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
     if ((max + 1) % numBins) {
       ++bwidth;
     }
-    // std::cerr << "* " << max << " " << numBins << " " << bwidth << "\n";
     for (auto p : hists) {
       bins.at(p.first / bwidth) += p.second;
     }
@@ -129,176 +325,201 @@ printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
 
 void
 doSparsityPattern(
-    Graph& graph, std::function<void(unsigned, unsigned, bool)> printFn) {
-  unsigned blockSize = (graph.size() + columns - 1) / columns;
-
+    const Stats& stats, std::function<void(unsigned, unsigned, bool)> printFn) {
   for (int i = 0; i < columns; ++i) {
-    std::vector<bool> row(columns);
-    auto p = katana::block_range(graph.begin(), graph.end(), i, columns);
-    for (auto ii = p.first, ei = p.second; ii != ei; ++ii) {
-      for (auto jj : graph.edges(*ii)) {
-        row[graph.getEdgeDst(jj) / blockSize] = true;
-      }
-    }
     for (int x = 0; x < columns; ++x) {
-      printFn(x, i, row[x]);
+      printFn(x, i, stats.pattern[i * columns + x]);
     }
   }
 }
 
 void
-doDegreeHistogram(Graph& graph) {
+doInDegreeHistogram(const Stats& stats) {
   std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    ++hist[graph.edges(ii).size()];
+  for (const auto& n : stats.in_degrees) {
+    ++hist[n.load(std::memory_order_relaxed)];
   }
-  printHistogram("Degree", hist);
+  printHistogram("InDegree", hist);
 }
 
 void
-doInDegreeHistogram(Graph& graph) {
-  std::vector<uint64_t> inv(graph.size());
+doSortedLogOffsetHistogram(const Stats& stats) {
+  printHistogram("LogOffset", stats.log_offset_hist);
+}
+
+void
+doDestinationHistogram(const Stats& stats) {
   std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++inv[graph.getEdgeDst(jj)];
+  for (uint64_t n = 0; n < stats.in_degrees.size(); ++n) {
+    if (uint64_t count = stats.in_degrees[n].load(std::memory_order_relaxed)) {
+      hist[n] = count;
     }
   }
-  for (uint64_t n : inv) {
-    ++hist[n];
-  }
-  printHistogram("InDegree", hist);
+  printHistogram("DestinationBin", hist);
 }
 
-struct EdgeComp {
-  typedef katana::EdgeSortValue<GNode, void> Edge;
-
-  bool operator()(const Edge& a, const Edge& b) const { return a.dst < b.dst; }
-};
-
-int
-getLogIndex(ptrdiff_t x) {
-  int logvalue = 0;
-  int sign = x < 0 ? -1 : 1;
+std::string
+typeName(const katana::EntityTypeManager& manager, katana::EntityTypeID type) {
+  return manager.GetAtomicTypeName(type).value_or("");
+}
 
-  if (x < 0) {
-    x = -x;
+void
+doTypeSummary(const Graph& graph, const Stats& stats) {
+  const katana::EntityTypeManager& node_types = graph.GetNodeTypeManager();
+  std::cout << "NodeType,Nodes,OutEdges\n";
+  for (size_t type = 1; type < node_types.GetNumEntityTypes(); ++type) {
+    if (!node_types.GetAtomicTypeName(type)) {
+      continue;
+    }
+    uint64_t out_edges = 0;
+    for (size_t super = 0; super < stats.edges_by_type.size(); ++super) {
+      if (node_types.IsSubtypeOf(type, super)) {
+        out_edges += stats.edges_by_type[super];
+      }
+    }
+    std::cout << typeName(node_types, type) << ','
+              << graph.GetNumNodesOfType(type) << ',' << out_edges << '\n';
   }
 
-  while ((x >>= 1) != 0) {
-    ++logvalue;
+  const katana::EntityTypeManager& edge_types = graph.GetEdgeTypeManager();
+  std::cout << "EdgeType,Edges\n";
+  for (size_t type = 1; type < edge_types.GetNumEntityTypes(); ++type) {
+    if (edge_types.GetAtomicTypeName(type)) {
+      std::cout << typeName(edge_types, type) << ','
+                << graph.GetNumEdgesOfType(type) << '\n';
+    }
   }
-  return sign * logvalue;
 }
 
 void
-doSortedLogOffsetHistogram([[maybe_unused]] Graph& graph) {
-  // Graph copy;
-  // {
-  //   // Original FileGraph is immutable because it is backed by a file
-  //   copy = graph;
-  // }
-
-  // std::vector<std::map<int, size_t> > hists;
-  // hists.emplace_back();
-  // auto hist = &hists.back();
-  // int curHist = 0;
-  // auto p = katana::block_range(
-  //     boost::counting_iterator<size_t>(0),
-  //     boost::counting_iterator<size_t>(graph.sizeEdges()),
-  //     curHist,
-  //     numHist);
-  // for (auto ii = graph.begin(), ei = graph.end(); ii != ei; ++ii) {
-  //   copy.sortEdges<void>(*ii, EdgeComp());
-
-  //   GNode last = 0;
-  //   bool first = true;
-  //   for (auto jj = copy.edge_begin(*ii), ej = copy.edge_end(*ii); jj != ej;
-  //   ++jj) {
-  //     GNode dst = copy.getEdgeDst(jj);
-  //     ptrdiff_t diff = dst - (ptrdiff_t) last;
-
-  //     if (!first) {
-  //       int index = getLogIndex(diff);
-  //       ++(*hist)[index];
-  //     }
-  //     first = false;
-  //     last = dst;
-  //     if (++p.first == p.second) {
-  //       hists.emplace_back();
-  //       hist = &hists.back();
-  //       curHist += 1;
-  //       p = katana::block_range(
-  //           boost::counting_iterator<size_t>(0),
-  //           boost::counting_iterator<size_t>(graph.sizeEdges()),
-  //           curHist,
-  //           numHist);
-  //     }
-  //   }
-  // }
-
-  // printHistogram("LogOffset", hists);
+printProperties(
+    const std::string& name, const std::shared_ptr<arrow::Table>& table) {
+  std::cout << name << "Property,Type,Nulls,Bytes\n";
+  for (int i = 0; i < table->num_columns(); ++i) {
+    const auto& column = table->column(i);
+    uint64_t bytes = 0;
+    for (const auto& chunk : column->chunks()) {
+      bytes += katana::ApproxArrayMemUse(chunk);
+    }
+    std::cout << table->field(i)->name() << ',' << column->type()->ToString()
+              << ',' << column->null_count() << ',' << bytes << '\n';
+  }
 }
 
 void
-doDestinationHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++hist[graph.getEdgeDst(jj)];
-    }
-  }
-  printHistogram("DestinationBin", hist);
+doPropertySummary(const Graph& graph) {
+  printProperties("Node", graph.node_properties());
+  printProperties("Edge", graph.edge_properties());
 }
 
 int
 main(int argc, char** argv) {
+  katana::SharedMemSys sys;
   llvm::cl::ParseCommandLineOptions(argc, argv);
-  try {
-    Graph graph(inputfilename);
-    for (unsigned i = 0; i != statModeList.size(); ++i) {
-      switch (statModeList[i]) {
-      case degreehist:
-        doDegreeHistogram(graph);
-        break;
-      case degrees:
-        doDegrees(graph);
-        break;
-      case maxDegreeNode:
-        findMaxDegreeNode(graph);
-        break;
-      case dsthist:
-        doDestinationHistogram(graph);
-        break;
-      case indegreehist:
-        doInDegreeHistogram(graph);
-        break;
-      case sortedlogoffsethist:
-        doSortedLogOffsetHistogram(graph);
-        break;
-      case sparsityPattern: {
-        unsigned lastrow = ~0;
-        doSparsityPattern(graph, [&lastrow](unsigned, unsigned y, bool val) {
-          if (y != lastrow) {
-            lastrow = y;
-            std::cout << '\n';
-          }
-          std::cout << (val ? 'x' : '.');
-        });
-        std::cout << '\n';
-        break;
-      }
-      case summary:
-        doSummary(graph);
-        break;
-      default:
-        std::cerr << "Unknown stat requested\n";
-        break;
-      }
+  katana::setActiveThreads(numThreads);
+
+  Requests requests;
+  for (unsigned i = 0; i != statModeList.size(); ++i) {
+    switch (statModeList[i]) {
+    case degreehist:
+      requests.degree_hist = true;
+      break;
+    case maxDegreeNode:
+      requests.max_degree = true;
+      break;
+    case dsthist:
+    case indegreehist:
+      requests.in_degrees = true;
+      break;
+    case sortedlogoffsethist:
+      requests.log_offsets = true;
+      break;
+    case sparsityPattern:
+      requests.sparsity = true;
+      break;
+    case typesummary:
+      requests.types = true;
+      break;
+    case propertysummary:
+      requests.properties = true;
+      break;
+    default:
+      break;
+    }
+  }
+
+  // only the degrees are needed: read just the prefix of the topology
+  std::unique_ptr<tsuba::RDGPrefix> prefix;
+  std::unique_ptr<Graph> graph;
+  if (requests.DegreesOnly()) {
+    auto prefix_result = tsuba::RDGPrefix::Make(inputfilename);
+    if (!prefix_result) {
+      KATANA_LOG_FATAL(
+          "failed to read {}: {}", inputfilename, prefix_result.error());
+    }
+    prefix = std::make_unique<tsuba::RDGPrefix>(
+        std::move(prefix_result.value()));
+  } else {
+    tsuba::RDGLoadOptions opts;
+    if (!requests.types && !requests.properties) {
+      opts.node_properties = std::vector<std::string>();
+      opts.edge_properties = std::vector<std::string>();
+    }
+    auto graph_result = Graph::Make(inputfilename, opts);
+    if (!graph_result) {
+      KATANA_LOG_FATAL(
+          "failed to load {}: {}", inputfilename, graph_result.error());
+    }
+    graph = std::move(graph_result.value());
+  }
+  Degrees degrees = graph ? Degrees(graph.get()) : Degrees(prefix.get());
+  Stats stats = computeStats(degrees, requests);
+
+  for (unsigned i = 0; i != statModeList.size(); ++i) {
+    switch (statModeList[i]) {
+    case degreehist:
+      printHistogram("Degree", stats.degree_hist);
+      break;
+    case degrees:
+      doDegrees(degrees);
+      break;
+    case maxDegreeNode:
+      findMaxDegreeNode(stats);
+      break;
+    case dsthist:
+      doDestinationHistogram(stats);
+      break;
+    case indegreehist:
+      doInDegreeHistogram(stats);
+      break;
+    case sortedlogoffsethist:
+      doSortedLogOffsetHistogram(stats);
+      break;
+    case sparsityPattern: {
+      unsigned lastrow = ~0;
+      doSparsityPattern(stats, [&lastrow](unsigned, unsigned y, bool val) {
+        if (y != lastrow) {
+          lastrow = y;
+          std::cout << '\n';
+        }
+        std::cout << (val ? 'x' : '.');
+      });
+      std::cout << '\n';
+      break;
+    }
+    case summary:
+      doSummary(stats);
+      break;
+    case typesummary:
+      doTypeSummary(*graph, stats);
+      break;
+    case propertysummary:
+      doPropertySummary(*graph);
+      break;
+    default:
+      std::cerr << "Unknown stat requested\n";
+      break;
     }
-    return 0;
-  } catch (...) {
-    std::cerr << "failed\n";
-    return 1;
   }
+  return 0;
 }
@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/ErrorCode.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+#include "llvm/Support/CommandLine.h"
+#include "tsuba/file.h"
+
+namespace cll = llvm::cl;
+
+// Benchmark of the storage backends of tsuba. The phases mirror the access
+// patterns of loading and storing graphs: parallel stores of large files,
+// whole-file and large ranged reads of topologies and property columns,
+// many small reads of Parquet footers and directory listings. Each phase
+// runs its ops on -concurrency threads and reports its throughput and the
+// distribution of op latencies as JSON.
+
+static cll::opt<std::string> scratchDir(
+    cll::Positional,
+    cll::desc("<scratch directory URI, e.g., s3://bucket/prefix>"),
+    cll::Required);
+static cll::opt<uint64_t> fileSizeMB(
+    "fileSize", cll::desc("Size of each large file in MB"), cll::init(256));
+static cll::opt<uint64_t> numFiles(
+    "numFiles", cll::desc("Number of large files"), cll::init(8));
+static cll::opt<uint64_t> rangeSizeMB(
+    "rangeSize", cll::desc("Size of each ranged read in MB"), cll::init(16));
+static cll::opt<uint64_t> footerSizeKB(
+    "footerSize", cll::desc("Size of each footer read in KB"), cll::init(64));
+static cll::opt<uint64_t> numFooterReads(
+    "footerReads", cll::desc("Number of footer reads"), cll::init(1000));
+static cll::opt<uint64_t> numListings(
+    "listings", cll::desc("Number of listings of the scratch directory"),
+    cll::init(100));
+static cll::opt<uint32_t> concurrency(
+    "concurrency", cll::desc("Number of ops in flight at once"),
+    cll::init(16));
+static cll::opt<std::string> outputFilename(
+    "output", cll::desc("File to write the JSON report to (default stdout)"),
+    cll::init(""));
+static cll::opt<bool> keepFiles(
+    "keep", cll::desc("Do not delete the files written"), cll::init(false));
+
+namespace {
+
+constexpr uint64_t kMB = UINT64_C(1) << 20;
+constexpr uint64_t kKB = UINT64_C(1) << 10;
+
+/// An op does the i-th unit of work of a phase with a buffer of its thread
+/// and returns the number of bytes it moved
+using Op = std::function<katana::Result<uint64_t>(
+    uint64_t i, std::vector<uint8_t>* buffer)>;
+
+/// Latency of the op at quantile q by the nearest rank method
+double
+Quantile(const std::vector<double>& sorted_ms, double q) {
+  if (sorted_ms.empty()) {
+    return 0;
+  }
+  auto rank = static_cast<size_t>(q * sorted_ms.size() + 0.5);
+  return sorted_ms[std::min(std::max<size_t>(rank, 1), sorted_ms.size()) - 1];
+}
+
+/// Run num_ops ops on concurrency threads, each thread taking the next op
+/// when its last one completes, and return the report of the phase
+katana::Result<nlohmann::json>
+RunPhase(
+    const std::string& name, uint64_t num_ops, uint64_t buffer_size,
+    const Op& op) {
+  using Clock = std::chrono::steady_clock;
+
+  std::atomic<uint64_t> next{0};
+  std::atomic<uint64_t> bytes{0};
+  std::vector<std::vector<double>> latencies(concurrency);
+  std::mutex error_mutex;
+  std::optional<katana::CopyableErrorInfo> first_error;
+
+  auto start = Clock::now();
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < concurrency; ++t) {
+    threads.emplace_back([&, t]() {
+      std::vector<uint8_t> buffer(buffer_size);
+      for (uint64_t i = next++; i < num_ops; i = next++) {
+        auto op_start = Clock::now();
+        auto res = op(i, &buffer);
+        std::chrono::duration<double, std::milli> elapsed =
+            Clock::now() - op_start;
+        if (!res) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!first_error) {
+            first_error = katana::CopyableErrorInfo(res.error());
+          }
+          // stop every thread after the ops already running
+          next = num_ops;
+          return;
+        }
+        bytes += res.value();
+        latencies[t].emplace_back(elapsed.count());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> seconds = Clock::now() - start;
+
+  if (first_error) {
+    return katana::ErrorInfo(first_error.value())
+        .WithContext("running {}", name);
+  }
+
+  std::vector<double> all;
+  for (const auto& l : latencies) {
+    all.insert(all.end(), l.begin(), l.end());
+  }
+  std::sort(all.begin(), all.end());
+
+  nlohmann::json report;
+  report["phase"] = name;
+  report["ops"] = num_ops;
+  report["bytes"] = bytes.load();
+  report["seconds"] = seconds.count();
+  report["gbps"] = bytes / 1e9 / seconds.count();
+  report["ops_per_second"] = num_ops / seconds.count();
+  report["p50_ms"] = Quantile(all, 0.5);
+  report["p99_ms"] = Quantile(all, 0.99);
+  report["max_ms"] = all.empty() ? 0.0 : all.back();
+
+  katana::gInfo(
+      name, ": ", report["gbps"].get<double>(), " GB/s, p50 ",
+      report["p50_ms"].get<double>(), " ms, p99 ",
+      report["p99_ms"].get<double>(), " ms");
+  return report;
+}
+
+katana::Result<nlohmann::json>
+RunBenchmark() {
+  if (concurrency == 0 || numFiles == 0 || fileSizeMB == 0 ||
+      rangeSizeMB == 0 || footerSizeKB == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "sizes, number of files and concurrency must be positive");
+  }
+  uint64_t file_size = fileSizeMB * kMB;
+  uint64_t range_size = std::min(rangeSizeMB * kMB, file_size);
+  uint64_t footer_size = std::min(footerSizeKB * kKB, file_size);
+
+  // a fresh directory so that listings only see the files of this run
+  auto base = KATANA_CHECKED(katana::Uri::Make(scratchDir));
+  katana::Uri dir = base.RandFile("storage-bench");
+  std::vector<std::string> names;
+  for (uint64_t i = 0; i < numFiles; ++i) {
+    names.emplace_back(fmt::format("file-{}", i));
+  }
+  auto path = [&](uint64_t i) {
+    return dir.Join(names[i % numFiles]).string();
+  };
+
+  // incompressible data, so that no layer between here and the backend can
+  // make the stores cheaper
+  std::vector<uint64_t> data(file_size / sizeof(uint64_t));
+  uint64_t x = 0x9e3779b97f4a7c15;
+  for (auto& word : data) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    word = x;
+  }
+
+  nlohmann::json phases = nlohmann::json::array();
+
+  // large files are stored in multipart uploads by the remote backends
+  phases.emplace_back(KATANA_CHECKED(RunPhase(
+      "parallel_write", numFiles, 0,
+      [&](uint64_t i, std::vector<uint8_t>*) -> katana::Result<uint64_t> {
+        KATANA_CHECKED_CONTEXT(
+            tsuba::FileStore(path(i), data.data(), file_size), "storing {}",
+            path(i));
+        return file_size;
+      })));
+
+  phases.emplace_back(KATANA_CHECKED(RunPhase(
+      "sequential_read", numFiles, file_size,
+      [&](uint64_t i, std::vector<uint8_t>* buffer)
+          -> katana::Result<uint64_t> {
+        KATANA_CHECKED_CONTEXT(
+            tsuba::FileGet(path(i), buffer->data(), 0, file_size),
+            "reading {}", path(i));
+        return file_size;
+      })));
+
+  // every range of every file, interleaved across files so that concurrent
+  // ops hit different objects
+  uint64_t ranges_per_file = file_size / range_size;
+  phases.emplace_back(KATANA_CHECKED(RunPhase(
+      "ranged_read", numFiles * ranges_per_file, range_size,
+      [&](uint64_t i, std::vector<uint8_t>* buffer)
+          -> katana::Result<uint64_t> {
+        uint64_t begin = (i / numFiles) * range_size;
+        KATANA_CHECKED_CONTEXT(
+            tsuba::FileGet(path(i), buffer->data(), begin, range_size),
+            "reading {} at {}", path(i), begin);
+        return range_size;
+      })));
+
+  // Parquet readers fetch the footer at the end of the file before any data
+  phases.emplace_back(KATANA_CHECKED(RunPhase(
+      "footer_read", numFooterReads, footer_size,
+      [&](uint64_t i, std::vector<uint8_t>* buffer)
+          -> katana::Result<uint64_t> {
+        uint64_t begin = file_size - footer_size;
+        KATANA_CHECKED_CONTEXT(
+            tsuba::FileGet(path(i), buffer->data(), begin, footer_size),
+            "reading footer of {}", path(i));
+        return footer_size;
+      })));
+
+  phases.emplace_back(KATANA_CHECKED(RunPhase(
+      "list", numListings, 0,
+      [&](uint64_t, std::vector<uint8_t>*) -> katana::Result<uint64_t> {
+        std::vector<std::string> files;
+        KATANA_CHECKED_CONTEXT(
+            tsuba::FileListAsync(dir.string(), &files).get(), "listing {}",
+            dir);
+        if (files.size() != numFiles) {
+          return KATANA_ERROR(
+              katana::ErrorCode::AssertionFailed,
+              "listed {} files in {} but wrote {}", files.size(), dir,
+              numFiles);
+        }
+        return 0;
+      })));
+
+  if (!keepFiles) {
+    KATANA_CHECKED_CONTEXT(
+        tsuba::FileDelete(
+            dir.string(),
+            std::unordered_set<std::string>(names.begin(), names.end())),
+        "deleting files in {}", dir);
+  }
+
+  nlohmann::json report;
+  report["directory"] = dir.string();
+  report["concurrency"] = concurrency.getValue();
+  report["file_size"] = file_size;
+  report["num_files"] = numFiles.getValue();
+  report["range_size"] = range_size;
+  report["footer_size"] = footer_size;
+  report["phases"] = phases;
+  return report;
+}
+
+katana::Result<void>
+WriteReport(const nlohmann::json& report) {
+  std::string out = KATANA_CHECKED(katana::JsonDump(report));
+  if (outputFilename.empty()) {
+    std::cout << out << "\n";
+    return katana::ResultSuccess();
+  }
+  std::ofstream file(outputFilename);
+  file << out << "\n";
+  if (!file) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "could not write {}",
+        outputFilename);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys G;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+
+  auto report = RunBenchmark();
+  if (!report) {
+    KATANA_LOG_FATAL("benchmark failed: {}", report.error());
+  }
+  if (auto res = WriteReport(report.value()); !res) {
+    KATANA_LOG_FATAL("writing report: {}", res.error());
+  }
+
+  return 0;
+}